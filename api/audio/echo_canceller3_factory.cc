@@ -10,6 +10,7 @@
 #include "api/audio/echo_canceller3_factory.h"
 
 #include <memory>
+#include <utility>
 
 #include "modules/audio_processing/aec3/echo_canceller3.h"
 #include "rtc_base/ptr_util.h"
@@ -21,7 +22,18 @@ EchoCanceller3Factory::EchoCanceller3Factory() {}
 EchoCanceller3Factory::EchoCanceller3Factory(const EchoCanceller3Config& config)
     : config_(config) {}
 
+EchoCanceller3Factory::EchoCanceller3Factory(
+    const EchoCanceller3Config& config,
+    rtc::scoped_refptr<SharedRenderAnalyzer> render_analyzer)
+    : config_(config), render_analyzer_(std::move(render_analyzer)) {}
+
+EchoCanceller3Factory::~EchoCanceller3Factory() = default;
+
 std::unique_ptr<EchoControl> EchoCanceller3Factory::Create(int sample_rate_hz) {
+  if (render_analyzer_) {
+    return rtc::MakeUnique<EchoCanceller3>(config_, sample_rate_hz, true,
+                                           render_analyzer_);
+  }
   return rtc::MakeUnique<EchoCanceller3>(config_, sample_rate_hz, true);
 }
 }  // namespace webrtc
@@ -15,9 +15,12 @@
 
 #include "api/audio/echo_canceller3_config.h"
 #include "api/audio/echo_control.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
+class SharedRenderAnalyzer;
+
 class EchoCanceller3Factory : public EchoControlFactory {
  public:
   // Factory producing EchoCanceller3 instances with the default configuration.
@@ -27,11 +30,22 @@ class EchoCanceller3Factory : public EchoControlFactory {
   // configuration.
   explicit EchoCanceller3Factory(const EchoCanceller3Config& config);
 
+  // Factory producing EchoCanceller3 instances with the specified
+  // configuration that take the render analysis from |render_analyzer|. The
+  // analysis is shared by all instances created by factories given the same
+  // analyzer, which should only be done when they all receive the same render
+  // signal, e.g., for several microphones sharing one loudspeaker.
+  EchoCanceller3Factory(const EchoCanceller3Config& config,
+                        rtc::scoped_refptr<SharedRenderAnalyzer> render_analyzer);
+
+  ~EchoCanceller3Factory() override;
+
   // Creates an EchoCanceller3 running at the specified sampling rate.
   std::unique_ptr<EchoControl> Create(int sample_rate_hz) override;
 
  private:
   const EchoCanceller3Config config_;
+  const rtc::scoped_refptr<SharedRenderAnalyzer> render_analyzer_;
 };
 }  // namespace webrtc
 
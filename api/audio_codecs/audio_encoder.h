@@ -58,6 +58,13 @@ struct ANAStats {
   // The uplink packet loss fractions as set by the ANA FEC controller. If this
   // value is not set, it indicates that the ANA FEC controller is not active.
   rtc::Optional<float> uplink_packet_loss_fraction;
+  // Number of times the encoder complexity was changed to follow the measured
+  // encoding time since the start of the call. If this value is not set, it
+  // indicates that the complexity is not adapted to the encoding time.
+  rtc::Optional<uint32_t> complexity_action_counter;
+  // The encoder complexity currently in use, set when the complexity is
+  // adapted to the encoding time.
+  rtc::Optional<int> complexity;
 };
 
 // This is the interface class for encoders in AudioCoding module. Each codec
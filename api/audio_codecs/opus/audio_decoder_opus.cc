@@ -11,17 +11,91 @@
 #include "api/audio_codecs/opus/audio_decoder_opus.h"
 
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "common_types.h"  // NOLINT(build/include)
 #include "modules/audio_coding/codecs/opus/audio_decoder_opus.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/ptr_util.h"
+#include "rtc_base/string_to_number.h"
+#include "rtc_base/stringencode.h"
 
 namespace webrtc {
 
+namespace {
+
+// Limits of the multistream layout, see RFC 7845, section 5.1.1.
+constexpr int kMaxChannels = 255;
+constexpr unsigned char kSilentChannel = 255;
+
+rtc::Optional<std::string> GetFormatParameter(const SdpAudioFormat& format,
+                                              const std::string& param) {
+  auto it = format.parameters.find(param);
+  if (it == format.parameters.end())
+    return rtc::nullopt;
+  return it->second;
+}
+
+// Reads the config of a "multiopus" format, which carries its multistream
+// layout in the format parameters.
+rtc::Optional<AudioDecoderOpus::Config> MultistreamSdpToConfig(
+    const SdpAudioFormat& format) {
+  const auto num_streams = rtc::StringToNumber<int>(
+      GetFormatParameter(format, "num_streams").value_or(""));
+  const auto coupled_streams = rtc::StringToNumber<int>(
+      GetFormatParameter(format, "coupled_streams").value_or(""));
+  const auto channel_mapping = GetFormatParameter(format, "channel_mapping");
+  if (!num_streams || !coupled_streams || !channel_mapping) {
+    return rtc::nullopt;
+  }
+  AudioDecoderOpus::Config config;
+  config.num_channels = format.num_channels;
+  config.num_streams = *num_streams;
+  config.coupled_streams = *coupled_streams;
+  std::vector<std::string> fields;
+  rtc::split(*channel_mapping, ',', &fields);
+  for (const std::string& field : fields) {
+    const auto stream_channel = rtc::StringToNumber<unsigned char>(field);
+    if (!stream_channel) {
+      return rtc::nullopt;
+    }
+    config.channel_mapping.push_back(*stream_channel);
+  }
+  if (!config.IsOk()) {
+    return rtc::nullopt;
+  }
+  return config;
+}
+
+}  // namespace
+
+bool AudioDecoderOpus::Config::IsOk() const {
+  if (num_channels < 1 || num_channels > kMaxChannels)
+    return false;
+  if (num_channels > 2) {
+    if (num_streams < 1 || coupled_streams < 0 ||
+        coupled_streams > num_streams ||
+        num_streams + coupled_streams > kMaxChannels)
+      return false;
+    if (channel_mapping.size() != static_cast<size_t>(num_channels))
+      return false;
+    for (unsigned char stream_channel : channel_mapping) {
+      if (stream_channel != kSilentChannel &&
+          stream_channel >= num_streams + coupled_streams)
+        return false;
+    }
+  }
+  return true;
+}
+
 rtc::Optional<AudioDecoderOpus::Config> AudioDecoderOpus::SdpToConfig(
     const SdpAudioFormat& format) {
+  if (STR_CASE_CMP(format.name.c_str(), "multiopus") == 0 &&
+      format.clockrate_hz == 48000 && format.num_channels > 2) {
+    return MultistreamSdpToConfig(format);
+  }
   const auto num_channels = [&]() -> rtc::Optional<int> {
     auto stereo = format.parameters.find("stereo");
     if (stereo != format.parameters.end()) {
@@ -57,6 +131,12 @@ void AudioDecoderOpus::AppendSupportedDecoders(
 std::unique_ptr<AudioDecoder> AudioDecoderOpus::MakeAudioDecoder(
     Config config,
     rtc::Optional<AudioCodecPairId> /*codec_pair_id*/) {
+  RTC_DCHECK(config.IsOk());
+  if (config.num_channels > 2) {
+    return rtc::MakeUnique<AudioDecoderOpusImpl>(
+        config.num_channels, config.num_streams, config.coupled_streams,
+        config.channel_mapping);
+  }
   return rtc::MakeUnique<AudioDecoderOpusImpl>(config.num_channels);
 }
 
@@ -27,7 +27,13 @@ namespace webrtc {
 // NOTE: This struct is still under development and may change without notice.
 struct AudioDecoderOpus {
   struct Config {
+    bool IsOk() const;  // Checks if the values are currently OK.
     int num_channels;
+    // The multistream layout, only used if |num_channels| is more than two.
+    // See AudioEncoderOpusConfig.
+    int num_streams = 1;
+    int coupled_streams = 0;
+    std::vector<unsigned char> channel_mapping;
   };
   static rtc::Optional<Config> SdpToConfig(const SdpAudioFormat& audio_format);
   static void AppendSupportedDecoders(std::vector<AudioCodecSpec>* specs);
@@ -25,6 +25,10 @@ constexpr int kDefaultComplexity = 9;
 constexpr int kDefaultLowRateComplexity =
     WEBRTC_OPUS_VARIABLE_COMPLEXITY ? 9 : kDefaultComplexity;
 
+// Limits of the multistream layout, see RFC 7845, section 5.1.1.
+constexpr size_t kMaxChannels = 255;
+constexpr unsigned char kSilentChannel = 255;
+
 }  // namespace
 
 constexpr int AudioEncoderOpusConfig::kDefaultFrameSizeMs;
@@ -34,6 +38,8 @@ constexpr int AudioEncoderOpusConfig::kMaxBitrateBps;
 AudioEncoderOpusConfig::AudioEncoderOpusConfig()
     : frame_size_ms(kDefaultFrameSizeMs),
       num_channels(1),
+      num_streams(1),
+      coupled_streams(0),
       application(ApplicationMode::kVoip),
       bitrate_bps(32000),
       fec_enabled(false),
@@ -55,8 +61,20 @@ AudioEncoderOpusConfig& AudioEncoderOpusConfig::operator=(
 bool AudioEncoderOpusConfig::IsOk() const {
   if (frame_size_ms <= 0 || frame_size_ms % 10 != 0)
     return false;
-  if (num_channels != 1 && num_channels != 2)
+  if (num_channels == 0 || num_channels > kMaxChannels)
     return false;
+  if (num_channels > 2) {
+    if (num_streams == 0 || coupled_streams > num_streams ||
+        num_streams + coupled_streams > kMaxChannels)
+      return false;
+    if (channel_mapping.size() != num_channels)
+      return false;
+    for (unsigned char stream_channel : channel_mapping) {
+      if (stream_channel != kSilentChannel &&
+          stream_channel >= num_streams + coupled_streams)
+        return false;
+    }
+  }
   if (!bitrate_bps)
     return false;
   if (*bitrate_bps < kMinBitrateBps || *bitrate_bps > kMaxBitrateBps)
@@ -65,6 +83,8 @@ bool AudioEncoderOpusConfig::IsOk() const {
     return false;
   if (low_rate_complexity < 0 || low_rate_complexity > 10)
     return false;
+  if (max_encode_load && (*max_encode_load <= 0.f || *max_encode_load > 1.f))
+    return false;
   return true;
 }
 }  // namespace webrtc
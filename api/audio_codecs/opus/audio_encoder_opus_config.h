@@ -37,6 +37,17 @@ struct AudioEncoderOpusConfig {
 
   int frame_size_ms;
   size_t num_channels;
+
+  // The multistream layout (RFC 7845, section 5.1.1), only used if
+  // |num_channels| is more than two. The channels are coded in |num_streams|
+  // Opus streams, of which the first |coupled_streams| are stereo, and input
+  // channel i goes to stream channel |channel_mapping[i]|, or is dropped if
+  // that is 255. A layout of channel mapping family 1 (Vorbis channel order)
+  // is coded as surround sound.
+  size_t num_streams;
+  size_t coupled_streams;
+  std::vector<unsigned char> channel_mapping;
+
   enum class ApplicationMode { kVoip, kAudio };
   ApplicationMode application;
 
@@ -59,6 +70,11 @@ struct AudioEncoderOpusConfig {
   int complexity_threshold_bps;
   int complexity_threshold_window_bps;
 
+  // If set, the complexity is lowered below the values above while encoding
+  // takes more than this fraction of real time (e.g. 0.02 for 2% of a core),
+  // and raised back when the load allows it. Must be in (0, 1].
+  rtc::Optional<float> max_encode_load;
+
   bool dtx_enabled;
   std::vector<int> supported_frame_lengths_ms;
   int uplink_bandwidth_update_interval_ms;
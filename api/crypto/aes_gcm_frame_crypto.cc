@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/crypto/aes_gcm_frame_crypto.h"
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+#include <string.h>
+
+#include <limits>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+const EVP_CIPHER* CipherForKey(rtc::ArrayView<const uint8_t> key) {
+  RTC_CHECK(key.size() == 16 || key.size() == 32)
+      << "Unsupported AES key size " << key.size();
+  return key.size() == 16 ? EVP_aes_128_gcm() : EVP_aes_256_gcm();
+}
+
+// Creates a context with the key schedule set up, so that every frame only
+// has to set the IV.
+EVP_CIPHER_CTX* CreateContext(rtc::ArrayView<const uint8_t> key,
+                              bool encrypt) {
+  EVP_CIPHER_CTX* ctx = EVP_CIPHER_CTX_new();
+  RTC_CHECK(ctx);
+  RTC_CHECK_EQ(1, EVP_CipherInit_ex(ctx, CipherForKey(key), nullptr,
+                                    key.data(), nullptr, encrypt ? 1 : 0));
+  return ctx;
+}
+
+bool FitsInt(size_t size) {
+  return size <= static_cast<size_t>(std::numeric_limits<int>::max());
+}
+
+}  // namespace
+
+const size_t AesGcmFrameEncryptor::kTagSize;
+const size_t AesGcmFrameEncryptor::kIvSize;
+const size_t AesGcmFrameEncryptor::kOverhead;
+
+AesGcmFrameEncryptor::AesGcmFrameEncryptor(rtc::ArrayView<const uint8_t> key)
+    : ctx_(CreateContext(key, true)) {
+  RTC_CHECK_EQ(1, RAND_bytes(salt_, sizeof(salt_)));
+}
+
+AesGcmFrameEncryptor::~AesGcmFrameEncryptor() {
+  EVP_CIPHER_CTX_free(ctx_);
+}
+
+int AesGcmFrameEncryptor::Encrypt(
+    cricket::MediaType media_type,
+    uint32_t ssrc,
+    rtc::ArrayView<const uint8_t> additional_data,
+    rtc::ArrayView<const uint8_t> frame,
+    rtc::ArrayView<uint8_t> encrypted_frame,
+    size_t* bytes_written) {
+  if (encrypted_frame.size() < frame.size() + kOverhead ||
+      !FitsInt(frame.size()) || !FitsInt(additional_data.size())) {
+    return -1;
+  }
+  uint8_t* tag = encrypted_frame.data() + frame.size();
+  uint8_t* iv = tag + kTagSize;
+
+  rtc::CritScope cs(&crit_);
+  memcpy(iv, salt_, sizeof(salt_));
+  const uint64_t counter = frame_counter_++;
+  for (size_t i = 0; i < sizeof(counter); ++i)
+    iv[sizeof(salt_) + i] = static_cast<uint8_t>(counter >> (56 - 8 * i));
+
+  int length = 0;
+  if (EVP_EncryptInit_ex(ctx_, nullptr, nullptr, nullptr, iv) != 1 ||
+      (!additional_data.empty() &&
+       EVP_EncryptUpdate(ctx_, nullptr, &length, additional_data.data(),
+                         static_cast<int>(additional_data.size())) != 1) ||
+      EVP_EncryptUpdate(ctx_, encrypted_frame.data(), &length, frame.data(),
+                        static_cast<int>(frame.size())) != 1 ||
+      EVP_EncryptFinal_ex(ctx_, encrypted_frame.data() + length, &length) !=
+          1 ||
+      EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_GCM_GET_TAG, kTagSize, tag) != 1) {
+    return -1;
+  }
+  *bytes_written = frame.size() + kOverhead;
+  return 0;
+}
+
+size_t AesGcmFrameEncryptor::GetMaxCiphertextByteSize(
+    cricket::MediaType media_type,
+    size_t frame_size) {
+  return frame_size + kOverhead;
+}
+
+AesGcmFrameDecryptor::AesGcmFrameDecryptor(rtc::ArrayView<const uint8_t> key)
+    : ctx_(CreateContext(key, false)) {}
+
+AesGcmFrameDecryptor::~AesGcmFrameDecryptor() {
+  EVP_CIPHER_CTX_free(ctx_);
+}
+
+int AesGcmFrameDecryptor::Decrypt(
+    cricket::MediaType media_type,
+    uint32_t ssrc,
+    rtc::ArrayView<const uint8_t> additional_data,
+    rtc::ArrayView<const uint8_t> encrypted_frame,
+    rtc::ArrayView<uint8_t> frame,
+    size_t* bytes_written) {
+  if (encrypted_frame.size() < AesGcmFrameEncryptor::kOverhead ||
+      !FitsInt(encrypted_frame.size()) || !FitsInt(additional_data.size())) {
+    return -1;
+  }
+  const size_t frame_size =
+      encrypted_frame.size() - AesGcmFrameEncryptor::kOverhead;
+  if (frame.size() < frame_size)
+    return -1;
+  // Copy the tag and IV, since they may be overwritten when decrypting in
+  // place.
+  uint8_t tag[AesGcmFrameEncryptor::kTagSize];
+  uint8_t iv[AesGcmFrameEncryptor::kIvSize];
+  memcpy(tag, encrypted_frame.data() + frame_size, sizeof(tag));
+  memcpy(iv, encrypted_frame.data() + frame_size + sizeof(tag), sizeof(iv));
+
+  rtc::CritScope cs(&crit_);
+  int length = 0;
+  if (EVP_DecryptInit_ex(ctx_, nullptr, nullptr, nullptr, iv) != 1 ||
+      (!additional_data.empty() &&
+       EVP_DecryptUpdate(ctx_, nullptr, &length, additional_data.data(),
+                         static_cast<int>(additional_data.size())) != 1) ||
+      EVP_DecryptUpdate(ctx_, frame.data(), &length, encrypted_frame.data(),
+                        static_cast<int>(frame_size)) != 1 ||
+      EVP_CIPHER_CTX_ctrl(ctx_, EVP_CTRL_GCM_SET_TAG, sizeof(tag), tag) != 1 ||
+      EVP_DecryptFinal_ex(ctx_, frame.data() + length, &length) != 1) {
+    return -1;
+  }
+  *bytes_written = frame_size;
+  return 0;
+}
+
+size_t AesGcmFrameDecryptor::GetMaxPlaintextByteSize(
+    cricket::MediaType media_type,
+    size_t encrypted_frame_size) {
+  return encrypted_frame_size > AesGcmFrameEncryptor::kOverhead
+             ? encrypted_frame_size - AesGcmFrameEncryptor::kOverhead
+             : 0;
+}
+
+}  // namespace webrtc
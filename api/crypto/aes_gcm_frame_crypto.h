@@ -0,0 +1,84 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_CRYPTO_AES_GCM_FRAME_CRYPTO_H_
+#define API_CRYPTO_AES_GCM_FRAME_CRYPTO_H_
+
+#include <stdint.h>
+
+#include "api/array_view.h"
+#include "api/crypto/frame_decryptor_interface.h"
+#include "api/crypto/frame_encryptor_interface.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+typedef struct evp_cipher_ctx_st EVP_CIPHER_CTX;
+
+namespace webrtc {
+
+// Frame encryption with AES-GCM, using the AES-NI and ARMv8 crypto
+// extensions when the CPU has them. An encrypted frame is the ciphertext,
+// which is as long as the frame, followed by a 16 byte authentication tag and
+// the 12 byte IV. The IV is a random 4 byte salt chosen by the encryptor
+// followed by a 64 bit frame counter, so a key must not be shared between
+// more than a few encryptors. Keys are 16 bytes (AES-128) or 32 bytes
+// (AES-256).
+class AesGcmFrameEncryptor : public FrameEncryptorInterface {
+ public:
+  static const size_t kTagSize = 16;
+  static const size_t kIvSize = 12;
+  static const size_t kOverhead = kTagSize + kIvSize;
+
+  explicit AesGcmFrameEncryptor(rtc::ArrayView<const uint8_t> key);
+  ~AesGcmFrameEncryptor() override;
+
+  int Encrypt(cricket::MediaType media_type,
+              uint32_t ssrc,
+              rtc::ArrayView<const uint8_t> additional_data,
+              rtc::ArrayView<const uint8_t> frame,
+              rtc::ArrayView<uint8_t> encrypted_frame,
+              size_t* bytes_written) override;
+  size_t GetMaxCiphertextByteSize(cricket::MediaType media_type,
+                                  size_t frame_size) override;
+
+ private:
+  rtc::CriticalSection crit_;
+  EVP_CIPHER_CTX* const ctx_ RTC_GUARDED_BY(crit_);
+  uint8_t salt_[4];
+  uint64_t frame_counter_ RTC_GUARDED_BY(crit_) = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AesGcmFrameEncryptor);
+};
+
+class AesGcmFrameDecryptor : public FrameDecryptorInterface {
+ public:
+  explicit AesGcmFrameDecryptor(rtc::ArrayView<const uint8_t> key);
+  ~AesGcmFrameDecryptor() override;
+
+  int Decrypt(cricket::MediaType media_type,
+              uint32_t ssrc,
+              rtc::ArrayView<const uint8_t> additional_data,
+              rtc::ArrayView<const uint8_t> encrypted_frame,
+              rtc::ArrayView<uint8_t> frame,
+              size_t* bytes_written) override;
+  size_t GetMaxPlaintextByteSize(cricket::MediaType media_type,
+                                 size_t encrypted_frame_size) override;
+
+ private:
+  rtc::CriticalSection crit_;
+  EVP_CIPHER_CTX* const ctx_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AesGcmFrameDecryptor);
+};
+
+}  // namespace webrtc
+
+#endif  // API_CRYPTO_AES_GCM_FRAME_CRYPTO_H_
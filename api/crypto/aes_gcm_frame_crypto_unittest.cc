@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/crypto/aes_gcm_frame_crypto.h"
+
+#include <vector>
+
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const uint8_t kKey[] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f};
+const uint8_t kOtherKey[] = {0x0f, 0x0e, 0x0d, 0x0c, 0x0b, 0x0a, 0x09, 0x08,
+                             0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01, 0x00};
+const uint8_t kHeader[] = {0x10, 0x20, 0x30};
+const uint32_t kSsrc = 1234;
+
+std::vector<uint8_t> CreateFrame(size_t size) {
+  std::vector<uint8_t> frame(size);
+  for (size_t i = 0; i < size; ++i)
+    frame[i] = static_cast<uint8_t>(i);
+  return frame;
+}
+
+rtc::scoped_refptr<AesGcmFrameEncryptor> CreateEncryptor(
+    rtc::ArrayView<const uint8_t> key) {
+  return new rtc::RefCountedObject<AesGcmFrameEncryptor>(key);
+}
+
+rtc::scoped_refptr<AesGcmFrameDecryptor> CreateDecryptor(
+    rtc::ArrayView<const uint8_t> key) {
+  return new rtc::RefCountedObject<AesGcmFrameDecryptor>(key);
+}
+
+std::vector<uint8_t> Encrypt(AesGcmFrameEncryptor* encryptor,
+                             const std::vector<uint8_t>& frame) {
+  std::vector<uint8_t> encrypted(encryptor->GetMaxCiphertextByteSize(
+      cricket::MEDIA_TYPE_VIDEO, frame.size()));
+  size_t bytes_written = 0;
+  EXPECT_EQ(0, encryptor->Encrypt(cricket::MEDIA_TYPE_VIDEO, kSsrc, kHeader,
+                                  frame, encrypted, &bytes_written));
+  encrypted.resize(bytes_written);
+  return encrypted;
+}
+
+}  // namespace
+
+TEST(AesGcmFrameCryptoTest, EncryptAndDecrypt) {
+  auto encryptor = CreateEncryptor(kKey);
+  auto decryptor = CreateDecryptor(kKey);
+  const std::vector<uint8_t> frame = CreateFrame(1000);
+  const std::vector<uint8_t> encrypted = Encrypt(encryptor.get(), frame);
+  ASSERT_EQ(frame.size() + AesGcmFrameEncryptor::kOverhead, encrypted.size());
+  EXPECT_NE(frame, std::vector<uint8_t>(encrypted.begin(),
+                                        encrypted.begin() + frame.size()));
+
+  std::vector<uint8_t> decrypted(decryptor->GetMaxPlaintextByteSize(
+      cricket::MEDIA_TYPE_VIDEO, encrypted.size()));
+  size_t bytes_written = 0;
+  ASSERT_EQ(0, decryptor->Decrypt(cricket::MEDIA_TYPE_VIDEO, kSsrc, kHeader,
+                                 encrypted, decrypted, &bytes_written));
+  EXPECT_EQ(frame.size(), bytes_written);
+  EXPECT_EQ(frame, decrypted);
+}
+
+TEST(AesGcmFrameCryptoTest, EncryptAndDecryptInPlace) {
+  const uint8_t kKey256[32] = {1, 2, 3};
+  auto encryptor = CreateEncryptor(kKey256);
+  auto decryptor = CreateDecryptor(kKey256);
+  const std::vector<uint8_t> frame = CreateFrame(100);
+  std::vector<uint8_t> buffer = frame;
+  buffer.resize(frame.size() + AesGcmFrameEncryptor::kOverhead);
+  size_t bytes_written = 0;
+  ASSERT_EQ(0, encryptor->Encrypt(
+                   cricket::MEDIA_TYPE_AUDIO, kSsrc, nullptr,
+                   rtc::ArrayView<const uint8_t>(buffer.data(), frame.size()),
+                   buffer, &bytes_written));
+  ASSERT_EQ(buffer.size(), bytes_written);
+  ASSERT_EQ(0, decryptor->Decrypt(cricket::MEDIA_TYPE_AUDIO, kSsrc, nullptr,
+                                 buffer, buffer, &bytes_written));
+  buffer.resize(bytes_written);
+  EXPECT_EQ(frame, buffer);
+}
+
+TEST(AesGcmFrameCryptoTest, FramesUseDifferentIvs) {
+  auto encryptor = CreateEncryptor(kKey);
+  const std::vector<uint8_t> frame = CreateFrame(100);
+  EXPECT_NE(Encrypt(encryptor.get(), frame), Encrypt(encryptor.get(), frame));
+}
+
+TEST(AesGcmFrameCryptoTest, RejectsTamperedFrames) {
+  auto encryptor = CreateEncryptor(kKey);
+  auto decryptor = CreateDecryptor(kKey);
+  std::vector<uint8_t> encrypted =
+      Encrypt(encryptor.get(), CreateFrame(100));
+  encrypted[10] ^= 1;
+  std::vector<uint8_t> decrypted(encrypted.size());
+  size_t bytes_written = 0;
+  EXPECT_NE(0, decryptor->Decrypt(cricket::MEDIA_TYPE_VIDEO, kSsrc, kHeader,
+                                 encrypted, decrypted, &bytes_written));
+}
+
+TEST(AesGcmFrameCryptoTest, RejectsTamperedAdditionalData) {
+  auto encryptor = CreateEncryptor(kKey);
+  auto decryptor = CreateDecryptor(kKey);
+  const std::vector<uint8_t> encrypted =
+      Encrypt(encryptor.get(), CreateFrame(100));
+  const uint8_t kOtherHeader[] = {0x10, 0x20, 0x31};
+  std::vector<uint8_t> decrypted(encrypted.size());
+  size_t bytes_written = 0;
+  EXPECT_NE(0, decryptor->Decrypt(cricket::MEDIA_TYPE_VIDEO, kSsrc,
+                                 kOtherHeader, encrypted, decrypted,
+                                 &bytes_written));
+}
+
+TEST(AesGcmFrameCryptoTest, RejectsWrongKey) {
+  auto encryptor = CreateEncryptor(kKey);
+  auto decryptor = CreateDecryptor(kOtherKey);
+  const std::vector<uint8_t> encrypted =
+      Encrypt(encryptor.get(), CreateFrame(100));
+  std::vector<uint8_t> decrypted(encrypted.size());
+  size_t bytes_written = 0;
+  EXPECT_NE(0, decryptor->Decrypt(cricket::MEDIA_TYPE_VIDEO, kSsrc, kHeader,
+                                 encrypted, decrypted, &bytes_written));
+}
+
+TEST(AesGcmFrameCryptoTest, RejectsTruncatedFrames) {
+  auto decryptor = CreateDecryptor(kKey);
+  std::vector<uint8_t> encrypted(AesGcmFrameEncryptor::kOverhead - 1);
+  std::vector<uint8_t> decrypted(encrypted.size());
+  size_t bytes_written = 0;
+  EXPECT_NE(0, decryptor->Decrypt(cricket::MEDIA_TYPE_VIDEO, kSsrc, kHeader,
+                                 encrypted, decrypted, &bytes_written));
+}
+
+}  // namespace webrtc
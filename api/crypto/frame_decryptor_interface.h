@@ -0,0 +1,50 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_CRYPTO_FRAME_DECRYPTOR_INTERFACE_H_
+#define API_CRYPTO_FRAME_DECRYPTOR_INTERFACE_H_
+
+#include "api/array_view.h"
+#include "api/mediatypes.h"
+#include "rtc_base/refcount.h"
+
+namespace webrtc {
+
+// FrameDecryptorInterface is the receive side counterpart of
+// FrameEncryptorInterface. Decrypt is called with every assembled video frame
+// before it is decoded, and with every audio payload before it is inserted in
+// the jitter buffer.
+class FrameDecryptorInterface : public rtc::RefCountInterface {
+ public:
+  ~FrameDecryptorInterface() override {}
+
+  // Decrypts |encrypted_frame| into |frame| and verifies the authenticity of
+  // both the frame and |additional_data|, the part of the frame that was sent
+  // in the clear. |frame| is at least
+  // GetMaxPlaintextByteSize(encrypted_frame.size()) bytes, and may start at the
+  // same address as |encrypted_frame| to decrypt in place. Returns 0 on
+  // success and sets |bytes_written| to the size of the decrypted frame.
+  // Frames that fail to authenticate must be dropped by the caller.
+  virtual int Decrypt(cricket::MediaType media_type,
+                      uint32_t ssrc,
+                      rtc::ArrayView<const uint8_t> additional_data,
+                      rtc::ArrayView<const uint8_t> encrypted_frame,
+                      rtc::ArrayView<uint8_t> frame,
+                      size_t* bytes_written) = 0;
+
+  // Returns the largest possible size of a frame that is
+  // |encrypted_frame_size| bytes when encrypted.
+  virtual size_t GetMaxPlaintextByteSize(cricket::MediaType media_type,
+                                         size_t encrypted_frame_size) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // API_CRYPTO_FRAME_DECRYPTOR_INTERFACE_H_
@@ -0,0 +1,52 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_CRYPTO_FRAME_ENCRYPTOR_INTERFACE_H_
+#define API_CRYPTO_FRAME_ENCRYPTOR_INTERFACE_H_
+
+#include "api/array_view.h"
+#include "api/mediatypes.h"
+#include "rtc_base/refcount.h"
+
+namespace webrtc {
+
+// FrameEncryptorInterface allows users to provide a custom encryption
+// implementation to encrypt every outgoing encoded frame before it is
+// packetized, for end-to-end encryption through media servers that only need
+// the RTP headers. The RTP headers themselves are not encrypted; SRTP is still
+// used between the hops. Encrypt is called on the encoder thread of every
+// stream the encryptor is attached to, so an encryptor shared between streams
+// must be thread safe.
+class FrameEncryptorInterface : public rtc::RefCountInterface {
+ public:
+  ~FrameEncryptorInterface() override {}
+
+  // Encrypts |frame| into |encrypted_frame| and authenticates both |frame| and
+  // |additional_data|. |additional_data| is the part of the frame that is sent
+  // in the clear, because the packetizer or a media server must read it.
+  // |encrypted_frame| is at least GetMaxCiphertextByteSize(frame.size())
+  // bytes, and may start at the same address as |frame| to encrypt in place.
+  // Returns 0 on success and sets |bytes_written| to the size of the
+  // encrypted frame.
+  virtual int Encrypt(cricket::MediaType media_type,
+                      uint32_t ssrc,
+                      rtc::ArrayView<const uint8_t> additional_data,
+                      rtc::ArrayView<const uint8_t> frame,
+                      rtc::ArrayView<uint8_t> encrypted_frame,
+                      size_t* bytes_written) = 0;
+
+  // Returns the largest possible size of an encrypted |frame_size| byte frame.
+  virtual size_t GetMaxCiphertextByteSize(cricket::MediaType media_type,
+                                          size_t frame_size) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // API_CRYPTO_FRAME_ENCRYPTOR_INTERFACE_H_
@@ -59,6 +59,11 @@ struct DataChannelInit {
 // At the JavaScript level, data can be passed in as a string or a blob, so
 // this structure's |binary| flag tells whether the data should be interpreted
 // as binary or text.
+//
+// |data| is reference counted, so copying a DataBuffer doesn't copy the
+// payload. The payload passed to DataChannelInterface::Send is shared, not
+// copied, until it's handed to the SCTP library, and the payload delivered to
+// DataChannelObserver::OnMessage is the one created by the SCTP transport.
 struct DataBuffer {
   DataBuffer(const rtc::CopyOnWriteBuffer& data, bool binary)
       : data(data),
@@ -90,6 +95,9 @@ class DataChannelObserver {
   virtual void OnMessage(const DataBuffer& buffer) = 0;
   // The data channel's buffered_amount has changed.
   virtual void OnBufferedAmountChange(uint64_t previous_amount) {}
+  // The data channel's buffered_amount has decreased from above its
+  // buffered_amount_low_threshold to at or below it.
+  virtual void OnBufferedAmountLow() {}
 
  protected:
   virtual ~DataChannelObserver() {}
@@ -159,6 +167,14 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // the SCTP level. See comment above Send below.
   virtual uint64_t buffered_amount() const = 0;
 
+  // C++ version of:
+  // https://www.w3.org/TR/webrtc/#dom-datachannel-bufferedamountlowthreshold
+  // Lets an application keep the send queue filled without polling
+  // buffered_amount(), by sending more data from OnBufferedAmountLow.
+  // Defaults to 0.
+  virtual uint64_t buffered_amount_low_threshold() const { return 0; }
+  virtual void SetBufferedAmountLowThreshold(uint64_t threshold) {}
+
   // Begins the graceful data channel closing procedure. See:
   // https://tools.ietf.org/html/draft-ietf-rtcweb-data-channel-13#section-6.7
   virtual void Close() = 0;
@@ -168,9 +184,9 @@ class DataChannelInterface : public rtc::RefCountInterface {
   // up to a maximum of 16MB. If Send is called while this buffer is full, the
   // data channel will be closed abruptly.
   //
-  // So, it's important to use buffered_amount() and OnBufferedAmountChange to
-  // ensure the data channel is used efficiently but without filling this
-  // buffer.
+  // So, it's important to use buffered_amount() and OnBufferedAmountChange (or
+  // OnBufferedAmountLow) to ensure the data channel is used efficiently but
+  // without filling this buffer.
   virtual bool Send(const DataBuffer& buffer) = 0;
 
  protected:
@@ -70,6 +70,7 @@ BEGIN_SIGNALING_PROXY_MAP(PeerConnectionFactory)
                 CreateAudioTrack, const std::string&,  AudioSourceInterface*)
   PROXY_METHOD2(bool, StartAecDump, rtc::PlatformFile, int64_t)
   PROXY_METHOD0(void, StopAecDump)
+  PROXY_CONSTMETHOD0(std::vector<rtc::TaskStats::Entry>, GetTaskStats)
 END_PROXY_MAP()
 
 }  // namespace webrtc
@@ -89,6 +89,7 @@
 #include "api/rtptransceiverinterface.h"
 #include "api/setremotedescriptionobserverinterface.h"
 #include "api/stats/rtcstatscollectorcallback.h"
+#include "api/stats/rtcstatssubscription.h"
 #include "api/statstypes.h"
 #include "api/transport/bitrate_settings.h"
 #include "api/transport/network_control.h"
@@ -112,6 +113,7 @@
 #include "rtc_base/socketaddress.h"
 #include "rtc_base/sslcertificate.h"
 #include "rtc_base/sslstreamadapter.h"
+#include "rtc_base/task_stats.h"
 
 namespace rtc {
 class SSLIdentity;
@@ -397,6 +399,14 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     // them.
     bool enable_rtp_data_channel = false;
 
+    // If set to true, SCTP data channels are carried by unreliable, unordered
+    // datagrams on the DTLS transport instead of SCTP, for real-time data for
+    // which a late message is useless. This is experimental and not negotiated:
+    // both endpoints have to set it, and data channels should be negotiated by
+    // the application. Messages are limited to the size of a single packet.
+    // See cricket::DatagramTransport.
+    bool enable_datagram_data_channel = false;
+
     // Minimum bitrate at which screencast video tracks will be encoded at.
     // This means adding padding bits up to this bitrate, which can help
     // when switching from a static scene to one with motion.
@@ -567,6 +577,12 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
     // For all other users, specify kUnifiedPlan.
     SdpSemantics sdp_semantics = SdpSemantics::kPlanB;
 
+    // The number of milliseconds a collected stats report is reused for. All
+    // GetStats calls within this window, of both the legacy and the standard
+    // stats API, share one collection. This is useful when several consumers
+    // poll the stats of the same PeerConnection. Defaults to 50 ms if unset.
+    rtc::Optional<int> stats_cache_lifetime_ms;
+
     //
     // Don't forget to update operator== if adding something.
     //
@@ -843,6 +859,12 @@ class PeerConnectionInterface : public rtc::RefCountInterface {
   virtual void GetStats(
       rtc::scoped_refptr<RtpReceiverInterface> selector,
       rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {}
+  // Non-standard getStats() that only delivers the stats types and members of
+  // |subscription|, optionally as deltas since the previous report delivered
+  // for it. Intended for frequent polling, see RTCStatsSubscription.
+  virtual void GetStats(
+      rtc::scoped_refptr<RTCStatsSubscription> subscription,
+      rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {}
   // Clear cached stats in the RTCStatsCollector.
   // Exposed for testing while waiting for automatic cache clear to work.
   // https://bugs.webrtc.org/8693
@@ -1242,6 +1264,15 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
 
     // Sets crypto related options, e.g. enabled cipher suites.
     rtc::CryptoOptions crypto_options;
+
+    // If positive, this many certificates of the default key type are
+    // generated ahead of time for PeerConnections that are created without a
+    // certificate generator of their own, so that they don't have to wait for
+    // key generation. See rtc::RTCCertificatePool.
+    int certificate_pool_size = 0;
+
+    // Pre-generated certificates older than this are replaced instead of used.
+    int64_t certificate_pool_max_age_ms = 24 * 60 * 60 * 1000;
   };
 
   // Set the options to be used for subsequently created PeerConnections.
@@ -1358,6 +1389,13 @@ class PeerConnectionFactoryInterface : public rtc::RefCountInterface {
   // Stops logging the AEC dump.
   virtual void StopAecDump() = 0;
 
+  // Returns how long the tasks of the threads and task queues of the process
+  // waited and ran, by queue and origin. Empty unless collecting them was
+  // turned on with rtc::TaskStats::Enable().
+  virtual std::vector<rtc::TaskStats::Entry> GetTaskStats() const {
+    return {};
+  }
+
  protected:
   // Dtor and ctor protected as objects shouldn't be created or deleted via
   // this interface.
@@ -1382,7 +1420,9 @@ rtc::scoped_refptr<PeerConnectionFactoryInterface> CreatePeerConnectionFactory(
 // Create a new instance of PeerConnectionFactoryInterface.
 //
 // |network_thread|, |worker_thread| and |signaling_thread| are
-// the only mandatory parameters.
+// the only mandatory parameters. If |network_thread| and |worker_thread| are
+// the same thread, received packets go to the media engine as soon as they
+// are received, without a hop between the threads.
 //
 // If non-null, a reference is added to |default_adm|, and ownership of
 // |video_encoder_factory| and |video_decoder_factory| is transferred to the
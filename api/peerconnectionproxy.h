@@ -78,6 +78,10 @@ BEGIN_SIGNALING_PROXY_MAP(PeerConnection)
                 GetStats,
                 rtc::scoped_refptr<RtpReceiverInterface>,
                 rtc::scoped_refptr<RTCStatsCollectorCallback>);
+  PROXY_METHOD2(void,
+                GetStats,
+                rtc::scoped_refptr<RTCStatsSubscription>,
+                rtc::scoped_refptr<RTCStatsCollectorCallback>);
   PROXY_METHOD2(rtc::scoped_refptr<DataChannelInterface>,
                 CreateDataChannel,
                 const std::string&,
@@ -11,6 +11,7 @@
 #ifndef API_STATS_RTCSTATS_H_
 #define API_STATS_RTCSTATS_H_
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -75,6 +76,14 @@ class RTCStats {
   // Creates a JSON readable string representation of the stats
   // object, listing all of its members (names and values).
   std::string ToJson() const;
+  // Appends the same JSON string representation as |ToJson| to |json|. This
+  // lets callers serializing many objects reuse a single buffer.
+  void AppendJson(std::string* json) const;
+
+  // Makes the defined members for which |keep| returns false undefined. This
+  // allows for reporting a subset of the members of a stats object.
+  void RetainMembers(
+      const std::function<bool(const RTCStatsMemberInterface&)>& keep);
 
   // Downcasts the stats object to an |RTCStats| subclass |T|. DCHECKs that the
   // object is of type |T|.
@@ -228,6 +237,8 @@ class RTCStatsMemberInterface {
   // cannot be accurately represented, so we prefer to display them as doubles
   // instead.
   virtual std::string ValueToJson() const = 0;
+  // Appends the same string as |ValueToJson| to |json|.
+  virtual void AppendValueJson(std::string* json) const = 0;
 
   template<typename T>
   const T& cast_to() const {
@@ -236,6 +247,8 @@ class RTCStatsMemberInterface {
   }
 
  protected:
+  friend class RTCStats;
+
   RTCStatsMemberInterface(const char* name, bool is_defined)
       : name_(name), is_defined_(is_defined) {}
 
@@ -284,6 +297,7 @@ class RTCStatsMember : public RTCStatsMemberInterface {
   }
   std::string ValueToString() const override;
   std::string ValueToJson() const override;
+  void AppendValueJson(std::string* json) const override;
 
   // Assignment operators.
   T& operator=(const T& value) {
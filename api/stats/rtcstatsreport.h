@@ -89,6 +89,9 @@ class RTCStatsReport : public rtc::RefCountInterface {
   // Creates a JSON readable string representation of the report,
   // listing all of its stats objects.
   std::string ToJson() const;
+  // Appends the same JSON string representation as |ToJson| to |json|. Reusing
+  // |json| between reports avoids reallocating the buffer for every report.
+  void AppendJson(std::string* json) const;
 
   friend class rtc::RefCountedObject<RTCStatsReport>;
 
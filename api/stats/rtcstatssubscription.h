@@ -0,0 +1,80 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_STATS_RTCSTATSSUBSCRIPTION_H_
+#define API_STATS_RTCSTATSSUBSCRIPTION_H_
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "api/stats/rtcstatsreport.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// A subscription to a subset of the stats of a PeerConnection, for callers that
+// poll stats frequently. A report delivered for a subscription only contains
+// the stats objects of the subscribed types, and of those only the subscribed
+// members. Stats that no subscribed type depends on are not collected, which
+// avoids the corresponding thread hops.
+//
+// With |deltas|, a stats object is only included if any of its subscribed
+// members changed since the previous report delivered for the subscription,
+// and then only with the changed members defined; members that became
+// undefined are not reported. The first report contains all the subscribed
+// stats. Stats objects that disappeared since the previous report are listed
+// by |removed_ids|.
+//
+// A subscription keeps state between reports and is to be used with a single
+// PeerConnection. It is used on the signaling thread of that PeerConnection.
+class RTCStatsSubscription : public rtc::RefCountInterface {
+ public:
+  // |types| are |RTCStats::type| values, e.g. |RTCTransportStats::kType|, and
+  // |members| are member names, e.g. "bytesSent". An empty set subscribes to
+  // all types or members.
+  static rtc::scoped_refptr<RTCStatsSubscription> Create(
+      std::set<std::string> types,
+      std::set<std::string> members,
+      bool deltas);
+
+  const std::set<std::string>& types() const { return types_; }
+  const std::set<std::string>& members() const { return members_; }
+  bool deltas() const { return deltas_; }
+
+  bool IsTypeSubscribed(const std::string& type) const;
+  // The IDs of the stats objects that were part of the previous report but not
+  // of the last one. Only used with |deltas|.
+  const std::vector<std::string>& removed_ids() const { return removed_ids_; }
+
+  // Returns the subscribed subset of |report|, as described above. With
+  // |deltas|, |report| becomes the reference for the next call.
+  rtc::scoped_refptr<RTCStatsReport> FilterReport(
+      const RTCStatsReport& report);
+
+ protected:
+  RTCStatsSubscription(std::set<std::string> types,
+                       std::set<std::string> members,
+                       bool deltas);
+  ~RTCStatsSubscription() override;
+
+ private:
+  const std::set<std::string> types_;
+  const std::set<std::string> members_;
+  const bool deltas_;
+  // The subscribed subset of the previous report, before computing deltas.
+  rtc::scoped_refptr<const RTCStatsReport> previous_report_;
+  std::vector<std::string> removed_ids_;
+};
+
+}  // namespace webrtc
+
+#endif  // API_STATS_RTCSTATSSUBSCRIPTION_H_
@@ -618,6 +618,10 @@ const char* StatsReport::Value::display_name() const {
       return "googAnaFrameLengthDecreaseCounter";
     case kStatsValueNameAnaUplinkPacketLossFraction:
       return "googAnaUplinkPacketLossFraction";
+    case kStatsValueNameAnaComplexityActionCounter:
+      return "googAnaComplexityActionCounter";
+    case kStatsValueNameAnaComplexity:
+      return "googAnaComplexity";
     case kStatsValueNameRetransmitBitrate:
       return "googRetransmitBitrate";
     case kStatsValueNameRtt:
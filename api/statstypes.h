@@ -221,6 +221,8 @@ class StatsReport {
     kStatsValueNameAnaFrameLengthIncreaseCounter,
     kStatsValueNameAnaFrameLengthDecreaseCounter,
     kStatsValueNameAnaUplinkPacketLossFraction,
+    kStatsValueNameAnaComplexityActionCounter,
+    kStatsValueNameAnaComplexity,
     kStatsValueNameRetransmitBitrate,
     kStatsValueNameRtt,
     kStatsValueNameSecondaryDecodedRate,
@@ -109,6 +109,10 @@ class VideoCodecTestFixture {
     // If set to true, the encoding will run in real-time.
     bool measure_cpu = false;
 
+    // Should the PSNR and SSIM of the decoded frames be calculated? Without
+    // it, only the codecs load the CPU, as when benchmarking.
+    bool measure_quality = true;
+
     // If > 0: forces the encoder to create a keyframe every Nth frame.
     size_t keyframe_interval = 0;
 
@@ -55,8 +55,8 @@ std::vector<PacketResult> TransportPacketsFeedback::LostWithSendInfo() const {
   return res;
 }
 
-std::vector<PacketResult> TransportPacketsFeedback::PacketsWithFeedback()
-    const {
+const std::vector<PacketResult>&
+TransportPacketsFeedback::PacketsWithFeedback() const {
   return packet_feedbacks;
 }
 
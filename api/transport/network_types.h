@@ -135,7 +135,7 @@ struct TransportPacketsFeedback {
 
   std::vector<PacketResult> ReceivedWithSendInfo() const;
   std::vector<PacketResult> LostWithSendInfo() const;
-  std::vector<PacketResult> PacketsWithFeedback() const;
+  const std::vector<PacketResult>& PacketsWithFeedback() const;
 };
 
 // Network estimation
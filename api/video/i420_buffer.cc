@@ -31,6 +31,12 @@ int I420DataSize(int height, int stride_y, int stride_u, int stride_v) {
   return stride_y * height + (stride_u + stride_v) * ((height + 1) / 2);
 }
 
+uint8_t* AllocateData(size_t size, VideoFrameMemoryAllocator* allocator) {
+  if (allocator)
+    return allocator->Allocate(size, kBufferAlignment);
+  return static_cast<uint8_t*>(AlignedMalloc(size, kBufferAlignment));
+}
+
 }  // namespace
 
 I420Buffer::I420Buffer(int width, int height)
@@ -42,14 +48,24 @@ I420Buffer::I420Buffer(int width,
                        int stride_y,
                        int stride_u,
                        int stride_v)
+    : I420Buffer(width, height, stride_y, stride_u, stride_v, nullptr) {}
+
+I420Buffer::I420Buffer(int width,
+                       int height,
+                       int stride_y,
+                       int stride_u,
+                       int stride_v,
+                       VideoFrameMemoryAllocator* allocator)
     : width_(width),
       height_(height),
       stride_y_(stride_y),
       stride_u_(stride_u),
       stride_v_(stride_v),
-      data_(static_cast<uint8_t*>(AlignedMalloc(
-          I420DataSize(height, stride_y, stride_u, stride_v),
-          kBufferAlignment))) {
+      data_(AllocateData(I420DataSize(height, stride_y, stride_u, stride_v),
+                         allocator),
+            DataDeleter(allocator,
+                        I420DataSize(height, stride_y, stride_u, stride_v))) {
+  RTC_CHECK(data_);
   RTC_DCHECK_GT(width, 0);
   RTC_DCHECK_GT(height, 0);
   RTC_DCHECK_GE(stride_y, width);
@@ -60,6 +76,17 @@ I420Buffer::I420Buffer(int width,
 I420Buffer::~I420Buffer() {
 }
 
+I420Buffer::DataDeleter::DataDeleter(VideoFrameMemoryAllocator* allocator,
+                                     size_t size)
+    : allocator_(allocator), size_(size) {}
+
+void I420Buffer::DataDeleter::operator()(uint8_t* data) const {
+  if (allocator_)
+    allocator_->Free(data, size_);
+  else
+    AlignedFree(data);
+}
+
 // static
 rtc::scoped_refptr<I420Buffer> I420Buffer::Create(int width, int height) {
   return new rtc::RefCountedObject<I420Buffer>(width, height);
@@ -75,6 +102,18 @@ rtc::scoped_refptr<I420Buffer> I420Buffer::Create(int width,
       width, height, stride_y, stride_u, stride_v);
 }
 
+// static
+rtc::scoped_refptr<I420Buffer> I420Buffer::Create(
+    int width,
+    int height,
+    int stride_y,
+    int stride_u,
+    int stride_v,
+    VideoFrameMemoryAllocator* allocator) {
+  return new rtc::RefCountedObject<I420Buffer>(
+      width, height, stride_y, stride_u, stride_v, allocator);
+}
+
 // static
 rtc::scoped_refptr<I420Buffer> I420Buffer::Copy(
     const I420BufferInterface& source) {
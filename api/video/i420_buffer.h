@@ -14,6 +14,7 @@
 #include <memory>
 
 #include "api/video/video_frame_buffer.h"
+#include "api/video/video_frame_memory_allocator.h"
 #include "api/video/video_rotation.h"
 #include "rtc_base/memory/aligned_malloc.h"
 
@@ -28,6 +29,15 @@ class I420Buffer : public I420BufferInterface {
                                                int stride_y,
                                                int stride_u,
                                                int stride_v);
+  // Creates a buffer whose memory is allocated from |allocator|, which must
+  // outlive it.
+  static rtc::scoped_refptr<I420Buffer> Create(
+      int width,
+      int height,
+      int stride_y,
+      int stride_u,
+      int stride_v,
+      VideoFrameMemoryAllocator* allocator);
 
   // Create a new buffer and copy the pixel data.
   static rtc::scoped_refptr<I420Buffer> Copy(const I420BufferInterface& buffer);
@@ -94,16 +104,34 @@ class I420Buffer : public I420BufferInterface {
  protected:
   I420Buffer(int width, int height);
   I420Buffer(int width, int height, int stride_y, int stride_u, int stride_v);
+  // If |allocator| is null, the memory is allocated with AlignedMalloc.
+  I420Buffer(int width,
+             int height,
+             int stride_y,
+             int stride_u,
+             int stride_v,
+             VideoFrameMemoryAllocator* allocator);
 
   ~I420Buffer() override;
 
  private:
+  // Returns the memory to the allocator it came from.
+  class DataDeleter {
+   public:
+    DataDeleter(VideoFrameMemoryAllocator* allocator, size_t size);
+    void operator()(uint8_t* data) const;
+
+   private:
+    VideoFrameMemoryAllocator* allocator_;
+    size_t size_;
+  };
+
   const int width_;
   const int height_;
   const int stride_y_;
   const int stride_u_;
   const int stride_v_;
-  const std::unique_ptr<uint8_t, AlignedFreeDeleter> data_;
+  const std::unique_ptr<uint8_t, DataDeleter> data_;
 };
 
 }  // namespace webrtc
@@ -21,6 +21,7 @@ namespace webrtc {
 class I420BufferInterface;
 class I420ABufferInterface;
 class I444BufferInterface;
+class NV12BufferInterface;
 
 // Base class for frame buffers of different types of pixel format and storage.
 // The tag in type() indicates how the data is represented, and each type is
@@ -47,6 +48,7 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
     kI420,
     kI420A,
     kI444,
+    kNV12,
   };
 
   // This function specifies in what pixel format the data is stored in.
@@ -73,6 +75,8 @@ class VideoFrameBuffer : public rtc::RefCountInterface {
   const I420ABufferInterface* GetI420A() const;
   I444BufferInterface* GetI444();
   const I444BufferInterface* GetI444() const;
+  NV12BufferInterface* GetNV12();
+  const NV12BufferInterface* GetNV12() const;
 
  protected:
   ~VideoFrameBuffer() override {}
@@ -133,6 +137,39 @@ class I444BufferInterface : public PlanarYuvBuffer {
   ~I444BufferInterface() override {}
 };
 
+// This interface represents Type::kNV12, with a full resolution Y plane and a
+// half resolution plane of interleaved U and V samples.
+class BiplanarYuvBuffer : public VideoFrameBuffer {
+ public:
+  virtual int ChromaWidth() const = 0;
+  virtual int ChromaHeight() const = 0;
+
+  // Returns pointer to the pixel data for a given plane. The memory is owned by
+  // the VideoFrameBuffer object and must not be freed by the caller.
+  virtual const uint8_t* DataY() const = 0;
+  virtual const uint8_t* DataUV() const = 0;
+
+  // Returns the number of bytes between successive rows for a given plane.
+  virtual int StrideY() const = 0;
+  virtual int StrideUV() const = 0;
+
+ protected:
+  ~BiplanarYuvBuffer() override {}
+};
+
+// NV12 is the native output format of most cameras and hardware codecs.
+// Implementations must still provide ToI420() for sinks that only handle I420.
+class NV12BufferInterface : public BiplanarYuvBuffer {
+ public:
+  Type type() const final;
+
+  int ChromaWidth() const final;
+  int ChromaHeight() const final;
+
+ protected:
+  ~NV12BufferInterface() override {}
+};
+
 }  // namespace webrtc
 
 #endif  // API_VIDEO_VIDEO_FRAME_BUFFER_H_
@@ -0,0 +1,37 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef API_VIDEO_VIDEO_FRAME_MEMORY_ALLOCATOR_H_
+#define API_VIDEO_VIDEO_FRAME_MEMORY_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace webrtc {
+
+// Allocates the pixel memory of video frame buffers, e.g. from huge pages.
+// Buffers are freed on whichever thread releases the last reference to them,
+// so implementations must be thread safe. An allocator must outlive all
+// buffers allocated from it.
+class VideoFrameMemoryAllocator {
+ public:
+  // Returns |size| bytes aligned to |alignment|, a power of two, or nullptr
+  // on failure.
+  virtual uint8_t* Allocate(size_t size, size_t alignment) = 0;
+  // Frees |data|, which was returned by Allocate() for |size| bytes.
+  virtual void Free(uint8_t* data, size_t size) = 0;
+
+ protected:
+  virtual ~VideoFrameMemoryAllocator() {}
+};
+
+}  // namespace webrtc
+
+#endif  // API_VIDEO_VIDEO_FRAME_MEMORY_ALLOCATOR_H_
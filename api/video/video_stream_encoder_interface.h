@@ -86,6 +86,11 @@ class VideoStreamEncoderInterface : public rtc::VideoSinkInterface<VideoFrame> {
                                 uint8_t fraction_lost,
                                 int64_t round_trip_time_ms) = 0;
 
+  // Pauses the encoding of the simulcast layers that are false in
+  // |active_layers|, and resumes the others, without reconfiguring the
+  // encoder. A layer that is resumed starts with a keyframe of its own.
+  virtual void SetActiveLayers(const std::vector<bool>& active_layers) = 0;
+
   // Register observer for the bitrate allocation between the temporal
   // and spatial layers.
   virtual void SetBitrateAllocationObserver(
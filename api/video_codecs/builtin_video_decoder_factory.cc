@@ -10,13 +10,92 @@
 
 #include "api/video_codecs/builtin_video_decoder_factory.h"
 
+#include <utility>
+#include <vector>
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "media/base/codec.h"
 #include "media/engine/internaldecoderfactory.h"
+#include "media/engine/videodecodersoftwarefallbackwrapper.h"
 #include "rtc_base/ptr_util.h"
 
 namespace webrtc {
 
+namespace {
+
+bool IsFormatSupported(const std::vector<SdpVideoFormat>& supported_formats,
+                       const SdpVideoFormat& format) {
+  for (const SdpVideoFormat& supported_format : supported_formats) {
+    if (cricket::IsSameCodec(format.name, format.parameters,
+                             supported_format.name,
+                             supported_format.parameters)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// This class combines a hardware factory with the internal factory, and adds
+// SW fallback wrappers.
+class BuiltinVideoDecoderFactory : public VideoDecoderFactory {
+ public:
+  explicit BuiltinVideoDecoderFactory(
+      std::unique_ptr<VideoDecoderFactory> hardware_decoder_factory)
+      : hardware_decoder_factory_(std::move(hardware_decoder_factory)) {}
+
+  std::unique_ptr<VideoDecoder> CreateVideoDecoder(
+      const SdpVideoFormat& format) override {
+    std::unique_ptr<VideoDecoder> internal_decoder;
+    if (IsFormatSupported(internal_decoder_factory_.GetSupportedFormats(),
+                          format)) {
+      internal_decoder = internal_decoder_factory_.CreateVideoDecoder(format);
+    }
+
+    std::unique_ptr<VideoDecoder> hardware_decoder;
+    if (IsFormatSupported(hardware_decoder_factory_->GetSupportedFormats(),
+                          format)) {
+      hardware_decoder = hardware_decoder_factory_->CreateVideoDecoder(format);
+    }
+
+    if (internal_decoder && hardware_decoder) {
+      // Both hardware and internal decoder available - create fallback
+      // wrapper.
+      return rtc::MakeUnique<VideoDecoderSoftwareFallbackWrapper>(
+          std::move(internal_decoder), std::move(hardware_decoder));
+    }
+    return hardware_decoder ? std::move(hardware_decoder)
+                            : std::move(internal_decoder);
+  }
+
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    std::vector<SdpVideoFormat> formats =
+        internal_decoder_factory_.GetSupportedFormats();
+    for (const SdpVideoFormat& format :
+         hardware_decoder_factory_->GetSupportedFormats()) {
+      // Don't add same codec twice.
+      if (!IsFormatSupported(formats, format))
+        formats.push_back(format);
+    }
+    return formats;
+  }
+
+ private:
+  InternalDecoderFactory internal_decoder_factory_;
+  const std::unique_ptr<VideoDecoderFactory> hardware_decoder_factory_;
+};
+
+}  // namespace
+
 std::unique_ptr<VideoDecoderFactory> CreateBuiltinVideoDecoderFactory() {
   return rtc::MakeUnique<InternalDecoderFactory>();
 }
 
+std::unique_ptr<VideoDecoderFactory> CreateBuiltinVideoDecoderFactory(
+    std::unique_ptr<VideoDecoderFactory> hardware_decoder_factory) {
+  if (!hardware_decoder_factory)
+    return CreateBuiltinVideoDecoderFactory();
+  return rtc::MakeUnique<BuiltinVideoDecoderFactory>(
+      std::move(hardware_decoder_factory));
+}
+
 }  // namespace webrtc
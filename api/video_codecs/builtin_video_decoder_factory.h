@@ -20,6 +20,14 @@ namespace webrtc {
 // Creates a new factory that can create the built-in types of video decoders.
 std::unique_ptr<VideoDecoderFactory> CreateBuiltinVideoDecoderFactory();
 
+// Same as above, but prefers the decoders of |hardware_decoder_factory|, e.g.
+// one backed by VA-API or NVDEC, for the formats it supports. When the
+// built-in types also support the format, the hardware decoder is wrapped in
+// a VideoDecoderSoftwareFallbackWrapper. Hardware decoders may output frames
+// with kNative buffers that stay in GPU memory.
+std::unique_ptr<VideoDecoderFactory> CreateBuiltinVideoDecoderFactory(
+    std::unique_ptr<VideoDecoderFactory> hardware_decoder_factory);
+
 }  // namespace webrtc
 
 #endif  // API_VIDEO_CODECS_BUILTIN_VIDEO_DECODER_FACTORY_H_
@@ -10,12 +10,14 @@
 
 #include "api/video_codecs/builtin_video_encoder_factory.h"
 
+#include <utility>
 #include <vector>
 
 #include "api/video_codecs/sdp_video_format.h"
 #include "media/base/codec.h"
 #include "media/base/mediaconstants.h"
 #include "media/engine/internalencoderfactory.h"
+#include "media/engine/videoencodersoftwarefallbackwrapper.h"
 #include "media/engine/vp8_encoder_simulcast_proxy.h"
 #include "rtc_base/ptr_util.h"
 
@@ -35,14 +37,24 @@ bool IsFormatSupported(const std::vector<SdpVideoFormat>& supported_formats,
   return false;
 }
 
-// This class wraps the internal factory and adds simulcast.
+// This class wraps the internal factory and adds simulcast. If a hardware
+// factory is given, its encoders are preferred, with SW fallback to the
+// internal encoders.
 class BuiltinVideoEncoderFactory : public VideoEncoderFactory {
  public:
-  BuiltinVideoEncoderFactory()
-      : internal_encoder_factory_(new InternalEncoderFactory()) {}
+  explicit BuiltinVideoEncoderFactory(
+      std::unique_ptr<VideoEncoderFactory> hardware_encoder_factory)
+      : internal_encoder_factory_(new InternalEncoderFactory()),
+        hardware_encoder_factory_(std::move(hardware_encoder_factory)) {}
 
   VideoEncoderFactory::CodecInfo QueryVideoEncoder(
       const SdpVideoFormat& format) const override {
+    if (hardware_encoder_factory_ &&
+        IsFormatSupported(hardware_encoder_factory_->GetSupportedFormats(),
+                          format)) {
+      return hardware_encoder_factory_->QueryVideoEncoder(format);
+    }
+
     // Format must be one of the internal formats.
     RTC_DCHECK(IsFormatSupported(
         internal_encoder_factory_->GetSupportedFormats(), format));
@@ -68,21 +80,55 @@ class BuiltinVideoEncoderFactory : public VideoEncoderFactory {
       internal_encoder = internal_encoder_factory_->CreateVideoEncoder(format);
     }
 
-    return internal_encoder;
+    // Try creating hardware encoder.
+    std::unique_ptr<VideoEncoder> hardware_encoder;
+    if (hardware_encoder_factory_ &&
+        IsFormatSupported(hardware_encoder_factory_->GetSupportedFormats(),
+                          format)) {
+      hardware_encoder = hardware_encoder_factory_->CreateVideoEncoder(format);
+    }
+
+    if (internal_encoder && hardware_encoder) {
+      // Both internal SW encoder and HW encoder available - create fallback
+      // encoder.
+      return rtc::MakeUnique<VideoEncoderSoftwareFallbackWrapper>(
+          std::move(internal_encoder), std::move(hardware_encoder));
+    }
+    return hardware_encoder ? std::move(hardware_encoder)
+                            : std::move(internal_encoder);
   }
 
   std::vector<SdpVideoFormat> GetSupportedFormats() const override {
-    return internal_encoder_factory_->GetSupportedFormats();
+    std::vector<SdpVideoFormat> formats =
+        internal_encoder_factory_->GetSupportedFormats();
+    if (!hardware_encoder_factory_)
+      return formats;
+
+    // Add hardware codecs.
+    for (const SdpVideoFormat& format :
+         hardware_encoder_factory_->GetSupportedFormats()) {
+      // Don't add same codec twice.
+      if (!IsFormatSupported(formats, format))
+        formats.push_back(format);
+    }
+    return formats;
   }
 
  private:
   const std::unique_ptr<VideoEncoderFactory> internal_encoder_factory_;
+  const std::unique_ptr<VideoEncoderFactory> hardware_encoder_factory_;
 };
 
 }  // namespace
 
 std::unique_ptr<VideoEncoderFactory> CreateBuiltinVideoEncoderFactory() {
-  return rtc::MakeUnique<BuiltinVideoEncoderFactory>();
+  return CreateBuiltinVideoEncoderFactory(nullptr);
+}
+
+std::unique_ptr<VideoEncoderFactory> CreateBuiltinVideoEncoderFactory(
+    std::unique_ptr<VideoEncoderFactory> hardware_encoder_factory) {
+  return rtc::MakeUnique<BuiltinVideoEncoderFactory>(
+      std::move(hardware_encoder_factory));
 }
 
 }  // namespace webrtc
@@ -21,6 +21,15 @@ namespace webrtc {
 // The factory has simulcast support for VP8.
 std::unique_ptr<VideoEncoderFactory> CreateBuiltinVideoEncoderFactory();
 
+// Same as above, but prefers the encoders of |hardware_encoder_factory|, e.g.
+// one backed by VA-API or NVENC, for the formats it supports. When the
+// built-in types also support the format, the hardware encoder is wrapped in
+// a VideoEncoderSoftwareFallbackWrapper. Hardware encoders may accept frames
+// with kNative buffers to avoid copying them out of GPU memory; the software
+// encoders convert such frames with ToI420().
+std::unique_ptr<VideoEncoderFactory> CreateBuiltinVideoEncoderFactory(
+    std::unique_ptr<VideoEncoderFactory> hardware_encoder_factory);
+
 }  // namespace webrtc
 
 #endif  // API_VIDEO_CODECS_BUILTIN_VIDEO_ENCODER_FACTORY_H_
@@ -0,0 +1,75 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/video_codecs/builtin_video_decoder_factory.h"
+
+#include <memory>
+#include <vector>
+
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_decoder.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/ptr_util.h"
+#include "test/gmock.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kHardwareCodecName[] = "FakeHardwareCodec";
+
+class FakeHardwareDecoder : public VideoDecoder {
+ public:
+  int32_t InitDecode(const VideoCodec* codec_settings,
+                     int32_t number_of_cores) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Decode(const EncodedImage& input_image,
+                 bool missing_frames,
+                 const CodecSpecificInfo* codec_specific_info,
+                 int64_t render_time_ms) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t RegisterDecodeCompleteCallback(
+      DecodedImageCallback* callback) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Release() override { return WEBRTC_VIDEO_CODEC_OK; }
+  const char* ImplementationName() const override { return "FakeHardware"; }
+};
+
+class FakeHardwareDecoderFactory : public VideoDecoderFactory {
+ public:
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return {SdpVideoFormat(kHardwareCodecName)};
+  }
+  std::unique_ptr<VideoDecoder> CreateVideoDecoder(
+      const SdpVideoFormat& format) override {
+    return rtc::MakeUnique<FakeHardwareDecoder>();
+  }
+};
+
+}  // namespace
+
+TEST(BuiltinVideoDecoderFactoryTest, PrefersHardwareDecoders) {
+  std::unique_ptr<VideoDecoderFactory> factory =
+      CreateBuiltinVideoDecoderFactory(
+          rtc::MakeUnique<FakeHardwareDecoderFactory>());
+  const SdpVideoFormat hardware_format(kHardwareCodecName);
+  EXPECT_THAT(factory->GetSupportedFormats(),
+              ::testing::Contains(hardware_format));
+
+  std::unique_ptr<VideoDecoder> decoder =
+      factory->CreateVideoDecoder(hardware_format);
+  ASSERT_TRUE(decoder);
+  EXPECT_STREQ("FakeHardware", decoder->ImplementationName());
+}
+
+}  // namespace webrtc
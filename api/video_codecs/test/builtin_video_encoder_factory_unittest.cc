@@ -11,12 +11,63 @@
 #include "api/video_codecs/builtin_video_encoder_factory.h"
 
 #include <memory>
+#include <vector>
 
 #include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_encoder.h"
+#include "modules/video_coding/include/video_error_codes.h"
+#include "rtc_base/ptr_util.h"
 #include "test/gmock.h"
 
 namespace webrtc {
 
+namespace {
+
+const char kHardwareCodecName[] = "FakeHardwareCodec";
+
+class FakeHardwareEncoder : public VideoEncoder {
+ public:
+  int32_t InitEncode(const VideoCodec* codec_settings,
+                     int32_t number_of_cores,
+                     size_t max_payload_size) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t RegisterEncodeCompleteCallback(
+      EncodedImageCallback* callback) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t Release() override { return WEBRTC_VIDEO_CODEC_OK; }
+  int32_t Encode(const VideoFrame& frame,
+                 const CodecSpecificInfo* codec_specific_info,
+                 const std::vector<FrameType>* frame_types) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  int32_t SetChannelParameters(uint32_t packet_loss, int64_t rtt) override {
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+  bool SupportsNativeHandle() const override { return true; }
+  const char* ImplementationName() const override { return "FakeHardware"; }
+};
+
+class FakeHardwareEncoderFactory : public VideoEncoderFactory {
+ public:
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return {SdpVideoFormat(kHardwareCodecName)};
+  }
+  CodecInfo QueryVideoEncoder(const SdpVideoFormat& format) const override {
+    CodecInfo info;
+    info.is_hardware_accelerated = true;
+    info.has_internal_source = false;
+    return info;
+  }
+  std::unique_ptr<VideoEncoder> CreateVideoEncoder(
+      const SdpVideoFormat& format) override {
+    return rtc::MakeUnique<FakeHardwareEncoder>();
+  }
+};
+
+}  // namespace
+
 TEST(BuiltinVideoEncoderFactoryTest, AnnouncesVp9AccordingToBuildFlags) {
   std::unique_ptr<VideoEncoderFactory> factory =
       CreateBuiltinVideoEncoderFactory();
@@ -34,4 +85,20 @@ TEST(BuiltinVideoEncoderFactoryTest, AnnouncesVp9AccordingToBuildFlags) {
 #endif  // defined(RTC_DISABLE_VP9)
 }
 
+TEST(BuiltinVideoEncoderFactoryTest, PrefersHardwareEncoders) {
+  std::unique_ptr<VideoEncoderFactory> factory =
+      CreateBuiltinVideoEncoderFactory(
+          rtc::MakeUnique<FakeHardwareEncoderFactory>());
+  const SdpVideoFormat hardware_format(kHardwareCodecName);
+  EXPECT_THAT(factory->GetSupportedFormats(),
+              ::testing::Contains(hardware_format));
+  EXPECT_TRUE(
+      factory->QueryVideoEncoder(hardware_format).is_hardware_accelerated);
+
+  std::unique_ptr<VideoEncoder> encoder =
+      factory->CreateVideoEncoder(hardware_format);
+  ASSERT_TRUE(encoder);
+  EXPECT_STREQ("FakeHardware", encoder->ImplementationName());
+}
+
 }  // namespace webrtc
@@ -41,4 +41,8 @@ const char* VideoDecoder::ImplementationName() const {
   return "unknown";
 }
 
+int VideoDecoder::NumberOfThreads() const {
+  return 1;
+}
+
 }  // namespace webrtc
@@ -70,6 +70,10 @@ class VideoDecoder {
   virtual bool PrefersLateDecoding() const;
 
   virtual const char* ImplementationName() const;
+
+  // Returns the number of threads the decoder currently decodes with, for
+  // statistics.
+  virtual int NumberOfThreads() const;
 };
 
 }  // namespace webrtc
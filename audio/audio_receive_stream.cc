@@ -74,7 +74,8 @@ std::unique_ptr<voe::ChannelProxy> CreateChannelAndProxy(
       new voe::ChannelProxy(std::unique_ptr<voe::Channel>(new voe::Channel(
           module_process_thread, internal_audio_state->audio_device_module(),
           nullptr /* RtcpRttStats */, config.jitter_buffer_max_packets,
-          config.jitter_buffer_fast_accelerate, config.decoder_factory,
+          config.jitter_buffer_fast_accelerate,
+          config.jitter_buffer_low_latency, config.decoder_factory,
           config.codec_pair_id))));
 }
 }  // namespace
@@ -373,6 +374,10 @@ void AudioReceiveStream::ConfigureStream(AudioReceiveStream* stream,
   if (first_time || old_config.decoder_map != new_config.decoder_map) {
     channel_proxy->SetReceiveCodecs(new_config.decoder_map);
   }
+  if (first_time ? new_config.frame_decryptor != nullptr
+                 : new_config.frame_decryptor != old_config.frame_decryptor) {
+    channel_proxy->SetFrameDecryptor(new_config.frame_decryptor);
+  }
 
   stream->config_ = new_config;
 }
@@ -44,6 +44,13 @@ void CallEncoder(const std::unique_ptr<voe::ChannelProxy>& channel_proxy,
   });
 }
 
+// Streams that send the same audio with the same codec can share the
+// encoder, unless they adapt it to their own network.
+bool UseSharedEncoder(const webrtc::AudioSendStream::Config& config) {
+  return !config.audio_network_adaptor_config &&
+         webrtc::field_trial::IsEnabled("WebRTC-Audio-SharedEncoder");
+}
+
 std::unique_ptr<voe::ChannelProxy> CreateChannelAndProxy(
     webrtc::AudioState* audio_state,
     rtc::TaskQueue* worker_queue,
@@ -270,6 +277,11 @@ void AudioSendStream::ConfigureStream(
     channel_proxy->SetMid(new_config.rtp.mid, new_ids.mid);
   }
 
+  if (first_time ? new_config.frame_encryptor != nullptr
+                 : new_config.frame_encryptor != old_config.frame_encryptor) {
+    channel_proxy->SetFrameEncryptor(new_config.frame_encryptor);
+  }
+
   if (!ReconfigureSendCodec(stream, new_config)) {
     RTC_LOG(LS_ERROR) << "Failed to set up send codec state.";
   }
@@ -320,6 +332,12 @@ void AudioSendStream::SendAudioData(std::unique_ptr<AudioFrame> audio_frame) {
   channel_proxy_->ProcessAndEncodeAudio(std::move(audio_frame));
 }
 
+void AudioSendStream::SendAudioData(
+    rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>> audio_frame) {
+  RTC_CHECK_RUNS_SERIALIZED(&audio_capture_race_checker_);
+  channel_proxy_->ProcessAndEncodeAudio(std::move(audio_frame));
+}
+
 bool AudioSendStream::SendTelephoneEvent(int payload_type,
                                          int payload_frequency, int event,
                                          int duration_ms) {
@@ -381,9 +399,10 @@ webrtc::AudioSendStream::Stats AudioSendStream::GetStats(
 
   stats.typing_noise_detected = audio_state()->typing_noise_detected();
   stats.ana_statistics = channel_proxy_->GetANAStatistics();
-  RTC_DCHECK(audio_state_->audio_processing());
-  stats.apm_statistics =
-      audio_state_->audio_processing()->GetStatistics(has_remote_tracks);
+  if (audio_state_->audio_processing()) {
+    stats.apm_statistics =
+        audio_state_->audio_processing()->GetStatistics(has_remote_tracks);
+  }
 
   return stats;
 }
@@ -505,9 +524,32 @@ bool AudioSendStream::SetupSendCodec(AudioSendStream* stream,
   const auto& spec = *new_config.send_codec_spec;
 
   RTC_DCHECK(new_config.encoder_factory);
-  std::unique_ptr<AudioEncoder> encoder =
-      new_config.encoder_factory->MakeAudioEncoder(
-          spec.payload_type, spec.format, new_config.codec_pair_id);
+  std::unique_ptr<AudioEncoder> encoder;
+  if (UseSharedEncoder(new_config)) {
+    rtc::scoped_refptr<AudioEncoderFactory> encoder_factory =
+        new_config.encoder_factory;
+    const int payload_type = spec.payload_type;
+    const SdpAudioFormat format = spec.format;
+    const rtc::Optional<AudioCodecPairId> codec_pair_id =
+        new_config.codec_pair_id;
+    // Check that the factory can make the encoder before sharing it.
+    encoder = encoder_factory->MakeAudioEncoder(payload_type, format,
+                                                codec_pair_id);
+    if (encoder) {
+      encoder = stream->audio_state()
+                    ->GetSharedEncoder(
+                        encoder_factory.get(), payload_type, format,
+                        [encoder_factory, payload_type, format,
+                         codec_pair_id] {
+                          return encoder_factory->MakeAudioEncoder(
+                              payload_type, format, codec_pair_id);
+                        })
+                    ->CreateSubscriber();
+    }
+  } else {
+    encoder = new_config.encoder_factory->MakeAudioEncoder(
+        spec.payload_type, spec.format, new_config.codec_pair_id);
+  }
 
   if (!encoder) {
     RTC_DLOG(LS_ERROR) << "Unable to create encoder for "
@@ -575,7 +617,8 @@ bool AudioSendStream::ReconfigureSendCodec(AudioSendStream* stream,
       new_config.send_codec_spec->format !=
           old_config.send_codec_spec->format ||
       new_config.send_codec_spec->payload_type !=
-          old_config.send_codec_spec->payload_type) {
+          old_config.send_codec_spec->payload_type ||
+      UseSharedEncoder(new_config) != UseSharedEncoder(old_config)) {
     return SetupSendCodec(stream, new_config);
   }
 
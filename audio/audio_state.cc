@@ -109,6 +109,31 @@ void AudioState::RemoveSendingStream(webrtc::AudioSendStream* stream) {
   }
 }
 
+rtc::scoped_refptr<SharedAudioEncoder> AudioState::GetSharedEncoder(
+    AudioEncoderFactory* encoder_factory,
+    int payload_type,
+    const SdpAudioFormat& format,
+    SharedAudioEncoder::EncoderFactory create_encoder) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  // Drop the encoders that no stream uses any more.
+  shared_encoders_.erase(
+      std::remove_if(shared_encoders_.begin(), shared_encoders_.end(),
+                     [](const SharedEncoder& shared) {
+                       return shared.encoder->HasOneRef();
+                     }),
+      shared_encoders_.end());
+  for (const SharedEncoder& shared : shared_encoders_) {
+    if (shared.encoder_factory == encoder_factory &&
+        shared.payload_type == payload_type && shared.format == format) {
+      return shared.encoder;
+    }
+  }
+  shared_encoders_.push_back(
+      {encoder_factory, payload_type, format,
+       SharedAudioEncoder::Create(std::move(create_encoder))});
+  return shared_encoders_.back().encoder;
+}
+
 void AudioState::SetPlayout(bool enabled) {
   RTC_LOG(INFO) << "SetPlayout(" << enabled << ")";
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
@@ -14,9 +14,12 @@
 #include <map>
 #include <memory>
 #include <unordered_set>
+#include <vector>
 
+#include "api/audio_codecs/audio_encoder_factory.h"
 #include "audio/audio_transport_impl.h"
 #include "audio/null_audio_poller.h"
+#include "audio/shared_audio_encoder.h"
 #include "call/audio_state.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
@@ -36,7 +39,6 @@ class AudioState final : public webrtc::AudioState {
   ~AudioState() override;
 
   AudioProcessing* audio_processing() override {
-    RTC_DCHECK(config_.audio_processing);
     return config_.audio_processing.get();
   }
   AudioTransport* audio_transport() override {
@@ -63,6 +65,15 @@ class AudioState final : public webrtc::AudioState {
                         int sample_rate_hz, size_t num_channels);
   void RemoveSendingStream(webrtc::AudioSendStream* stream);
 
+  // Returns the encoder shared by send streams with the same encoder factory,
+  // payload type and format, creating it with |create_encoder| if there is
+  // none yet.
+  rtc::scoped_refptr<SharedAudioEncoder> GetSharedEncoder(
+      AudioEncoderFactory* encoder_factory,
+      int payload_type,
+      const SdpAudioFormat& format,
+      SharedAudioEncoder::EncoderFactory create_encoder);
+
  private:
   // rtc::RefCountInterface implementation.
   void AddRef() const override;
@@ -96,6 +107,14 @@ class AudioState final : public webrtc::AudioState {
   };
   std::map<webrtc::AudioSendStream*, StreamProperties> sending_streams_;
 
+  struct SharedEncoder {
+    AudioEncoderFactory* encoder_factory;
+    int payload_type;
+    SdpAudioFormat format;
+    rtc::scoped_refptr<SharedAudioEncoder> encoder;
+  };
+  std::vector<SharedEncoder> shared_encoders_;
+
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(AudioState);
 };
 }  // namespace internal
@@ -78,7 +78,7 @@ std::vector<int16_t> Create10msTestData(int sample_rate_hz,
   return audio_data;
 }
 
-std::vector<uint32_t> ComputeChannelLevels(AudioFrame* audio_frame) {
+std::vector<uint32_t> ComputeChannelLevels(const AudioFrame* audio_frame) {
   const size_t num_channels = audio_frame->num_channels_;
   const size_t samples_per_channel = audio_frame->samples_per_channel_;
   std::vector<uint32_t> levels(num_channels, 0);
@@ -116,7 +116,7 @@ TEST(AudioStateTest, RecordedAudioArrivesAtSingleStream) {
       testing::Field(&AudioFrame::num_channels_, testing::Eq(2u)))))
           .WillOnce(
               // Verify that channels are not swapped by default.
-              testing::Invoke([](AudioFrame* audio_frame) {
+              testing::Invoke([](const AudioFrame* audio_frame) {
                 auto levels = ComputeChannelLevels(audio_frame);
                 EXPECT_LT(0u, levels[0]);
                 EXPECT_EQ(0u, levels[1]);
@@ -149,23 +149,27 @@ TEST(AudioStateTest, RecordedAudioArrivesAtMultipleStreams) {
   audio_state->AddSendingStream(&stream_1, 8001, 2);
   audio_state->AddSendingStream(&stream_2, 32000, 1);
 
+  const AudioFrame* audio_frame_1 = nullptr;
+  const AudioFrame* audio_frame_2 = nullptr;
   EXPECT_CALL(stream_1, SendAudioDataForMock(testing::AllOf(
       testing::Field(&AudioFrame::sample_rate_hz_, testing::Eq(16000)),
       testing::Field(&AudioFrame::num_channels_, testing::Eq(1u)))))
           .WillOnce(
               // Verify that there is output signal.
-              testing::Invoke([](AudioFrame* audio_frame) {
+              testing::Invoke([&audio_frame_1](const AudioFrame* audio_frame) {
                 auto levels = ComputeChannelLevels(audio_frame);
                 EXPECT_LT(0u, levels[0]);
+                audio_frame_1 = audio_frame;
               }));
   EXPECT_CALL(stream_2, SendAudioDataForMock(testing::AllOf(
       testing::Field(&AudioFrame::sample_rate_hz_, testing::Eq(16000)),
       testing::Field(&AudioFrame::num_channels_, testing::Eq(1u)))))
           .WillOnce(
               // Verify that there is output signal.
-              testing::Invoke([](AudioFrame* audio_frame) {
+              testing::Invoke([&audio_frame_2](const AudioFrame* audio_frame) {
                 auto levels = ComputeChannelLevels(audio_frame);
                 EXPECT_LT(0u, levels[0]);
+                audio_frame_2 = audio_frame;
               }));
   MockAudioProcessing* ap =
       static_cast<MockAudioProcessing*>(audio_state->audio_processing());
@@ -181,6 +185,9 @@ TEST(AudioStateTest, RecordedAudioArrivesAtMultipleStreams) {
       &audio_data[0], kSampleRate / 100, kNumChannels * 2,
       kNumChannels, kSampleRate, 5, 0, 0, true, new_mic_level);
   EXPECT_EQ(667u, new_mic_level);
+  // The streams share the captured frame instead of receiving copies of it.
+  EXPECT_NE(nullptr, audio_frame_1);
+  EXPECT_EQ(audio_frame_1, audio_frame_2);
 
   audio_state->RemoveSendingStream(&stream_1);
   audio_state->RemoveSendingStream(&stream_2);
@@ -201,7 +208,7 @@ TEST(AudioStateTest, EnableChannelSwap) {
   EXPECT_CALL(stream, SendAudioDataForMock(testing::_))
       .WillOnce(
           // Verify that channels are swapped.
-          testing::Invoke([](AudioFrame* audio_frame) {
+          testing::Invoke([](const AudioFrame* audio_frame) {
             auto levels = ComputeChannelLevels(audio_frame);
             EXPECT_EQ(0u, levels[0]);
             EXPECT_LT(0u, levels[1]);
@@ -18,6 +18,7 @@
 #include "audio/utility/audio_frame_operations.h"
 #include "call/audio_send_stream.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/refcountedobject.h"
 
 namespace webrtc {
 
@@ -48,14 +49,15 @@ void ProcessCaptureFrame(uint32_t delay_ms,
                          bool swap_stereo_channels,
                          AudioProcessing* audio_processing,
                          AudioFrame* audio_frame) {
-  RTC_DCHECK(audio_processing);
   RTC_DCHECK(audio_frame);
-  RTC_DCHECK(
-      !audio_processing->echo_cancellation()->is_drift_compensation_enabled());
-  audio_processing->set_stream_delay_ms(delay_ms);
-  audio_processing->set_stream_key_pressed(key_pressed);
-  int error = audio_processing->ProcessStream(audio_frame);
-  RTC_DCHECK_EQ(0, error) << "ProcessStream() error: " << error;
+  if (audio_processing) {
+    RTC_DCHECK(!audio_processing->echo_cancellation()
+                    ->is_drift_compensation_enabled());
+    audio_processing->set_stream_delay_ms(delay_ms);
+    audio_processing->set_stream_key_pressed(key_pressed);
+    int error = audio_processing->ProcessStream(audio_frame);
+    RTC_DCHECK_EQ(0, error) << "ProcessStream() error: " << error;
+  }
   if (swap_stereo_channels) {
     AudioFrameOperations::SwapStereoChannels(audio_frame);
   }
@@ -86,7 +88,6 @@ AudioTransportImpl::AudioTransportImpl(AudioMixer* mixer,
     : audio_processing_(audio_processing),
       mixer_(mixer) {
   RTC_DCHECK(mixer);
-  RTC_DCHECK(audio_processing);
 }
 
 AudioTransportImpl::~AudioTransportImpl() {}
@@ -124,7 +125,8 @@ int32_t AudioTransportImpl::RecordedDataIsAvailable(
     swap_stereo_channels = swap_stereo_channels_;
   }
 
-  std::unique_ptr<AudioFrame> audio_frame(new AudioFrame());
+  rtc::scoped_refptr<rtc::RefCountedObject<AudioFrame>> audio_frame(
+      new rtc::RefCountedObject<AudioFrame>());
   InitializeCaptureFrame(sample_rate, send_sample_rate_hz,
                          number_of_channels, send_num_channels,
                          audio_frame.get());
@@ -139,7 +141,7 @@ int32_t AudioTransportImpl::RecordedDataIsAvailable(
   // if we're using this feature or not.
   // TODO(solenberg): is_enabled() takes a lock. Work around that.
   bool typing_detected = false;
-  if (audio_processing_->voice_detection()->is_enabled()) {
+  if (audio_processing_ && audio_processing_->voice_detection()->is_enabled()) {
     if (audio_frame->vad_activity_ != AudioFrame::kVadUnknown) {
       bool vad_active = audio_frame->vad_activity_ == AudioFrame::kVadActive;
       typing_detected = typing_detection_.Process(key_pressed, vad_active);
@@ -150,22 +152,19 @@ int32_t AudioTransportImpl::RecordedDataIsAvailable(
   double sample_duration = static_cast<double>(number_of_frames) / sample_rate;
   audio_level_.ComputeLevel(*audio_frame.get(), sample_duration);
 
-  // Copy frame and push to each sending stream. The copy is required since an
-  // encoding task will be posted internally to each stream.
+  // Push the frame to each sending stream. It is shared by the encoding tasks
+  // posted internally by the streams, and is not modified from here on.
   {
     rtc::CritScope lock(&capture_lock_);
     typing_noise_detected_ = typing_detected;
 
     RTC_DCHECK_GT(audio_frame->samples_per_channel_, 0);
     if (!sending_streams_.empty()) {
-      auto it = sending_streams_.begin();
-      while (++it != sending_streams_.end()) {
-        std::unique_ptr<AudioFrame> audio_frame_copy(new AudioFrame());
-        audio_frame_copy->CopyFrom(*audio_frame.get());
-        (*it)->SendAudioData(std::move(audio_frame_copy));
+      // Profile the time until the encoding tasks are executed.
+      audio_frame->UpdateProfileTimeStamp();
+      for (AudioSendStream* stream : sending_streams_) {
+        stream->SendAudioData(audio_frame);
       }
-      // Send the original frame to the first stream w/o copying.
-      (*sending_streams_.begin())->SendAudioData(std::move(audio_frame));
     }
   }
 
@@ -198,8 +197,10 @@ int32_t AudioTransportImpl::NeedMorePlayData(const size_t nSamples,
   *elapsed_time_ms = mixed_frame_.elapsed_time_ms_;
   *ntp_time_ms = mixed_frame_.ntp_time_ms_;
 
-  const auto error = audio_processing_->ProcessReverseStream(&mixed_frame_);
-  RTC_DCHECK_EQ(error, AudioProcessing::kNoError);
+  if (audio_processing_) {
+    const auto error = audio_processing_->ProcessReverseStream(&mixed_frame_);
+    RTC_DCHECK_EQ(error, AudioProcessing::kNoError);
+  }
 
   nSamplesOut = Resample(mixed_frame_, samplesPerSec, &render_resampler_,
                          static_cast<int16_t*>(audioSamples));
@@ -277,15 +277,29 @@ class Channel::ProcessAndEncodeAudioTask : public rtc::QueuedTask {
       : audio_frame_(std::move(audio_frame)), channel_(channel) {
     RTC_DCHECK(channel_);
   }
+  ProcessAndEncodeAudioTask(
+      rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>>
+          shared_audio_frame,
+      Channel* channel)
+      : shared_audio_frame_(std::move(shared_audio_frame)), channel_(channel) {
+    RTC_DCHECK(channel_);
+  }
 
  private:
   bool Run() override {
     RTC_DCHECK_RUN_ON(channel_->encoder_queue_);
-    channel_->ProcessAndEncodeAudioOnTaskQueue(audio_frame_.get());
+    if (audio_frame_) {
+      channel_->ProcessAndEncodeAudioOnTaskQueue(*audio_frame_);
+    } else {
+      channel_->ProcessAndEncodeAudioOnTaskQueue(*shared_audio_frame_);
+    }
     return true;
   }
 
+  // Only one of the frames is set.
   std::unique_ptr<AudioFrame> audio_frame_;
+  rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>>
+      shared_audio_frame_;
   Channel* const channel_;
 };
 
@@ -303,6 +317,32 @@ int32_t Channel::SendData(FrameType frameType,
     _rtpRtcpModule->SetAudioLevel(rms_level_.Average());
   }
 
+  rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor;
+  {
+    rtc::CritScope cs(&frame_crypto_lock_);
+    frame_encryptor = frame_encryptor_;
+  }
+  if (frame_encryptor && payloadSize > 0) {
+    // Each fragment would have to be encrypted on its own.
+    if (fragmentation) {
+      RTC_DLOG(LS_ERROR) << "Channel::SendData() can't encrypt RED payloads";
+      return -1;
+    }
+    encrypted_payload_.SetSize(frame_encryptor->GetMaxCiphertextByteSize(
+        cricket::MEDIA_TYPE_AUDIO, payloadSize));
+    size_t bytes_written = 0;
+    if (frame_encryptor->Encrypt(
+            cricket::MEDIA_TYPE_AUDIO, _rtpRtcpModule->SSRC(), nullptr,
+            rtc::MakeArrayView(payloadData, payloadSize), encrypted_payload_,
+            &bytes_written) != 0) {
+      RTC_DLOG(LS_ERROR) << "Channel::SendData() failed to encrypt payload";
+      return -1;
+    }
+    encrypted_payload_.SetSize(bytes_written);
+    payloadData = encrypted_payload_.data();
+    payloadSize = encrypted_payload_.size();
+  }
+
   // Push data from ACM to RTP/RTCP-module to deliver audio frame for
   // packetization.
   // This call will trigger Transport::SendPacket() from the RTP/RTCP module.
@@ -370,6 +410,29 @@ int32_t Channel::OnReceivedPayloadData(const uint8_t* payloadData,
     return 0;
   }
 
+  rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor;
+  {
+    rtc::CritScope cs(&frame_crypto_lock_);
+    frame_decryptor = frame_decryptor_;
+  }
+  if (frame_decryptor && payloadSize > 0) {
+    decrypted_payload_.SetSize(frame_decryptor->GetMaxPlaintextByteSize(
+        cricket::MEDIA_TYPE_AUDIO, payloadSize));
+    size_t bytes_written = 0;
+    if (frame_decryptor->Decrypt(
+            cricket::MEDIA_TYPE_AUDIO, rtpHeader->header.ssrc, nullptr,
+            rtc::MakeArrayView(payloadData, payloadSize), decrypted_payload_,
+            &bytes_written) != 0) {
+      // Drop the payload, like a lost packet.
+      RTC_DLOG(LS_WARNING)
+          << "Channel::OnReceivedPayloadData() failed to decrypt payload";
+      return 0;
+    }
+    decrypted_payload_.SetSize(bytes_written);
+    payloadData = decrypted_payload_.data();
+    payloadSize = decrypted_payload_.size();
+  }
+
   // Push the incoming payload (parsed and ready for decoding) into the ACM
   if (audio_coding_->IncomingPacket(payloadData, payloadSize, *rtpHeader) !=
       0) {
@@ -513,6 +576,7 @@ Channel::Channel(rtc::TaskQueue* encoder_queue,
               rtcp_rtt_stats,
               0,
               false,
+              false,
               rtc::scoped_refptr<AudioDecoderFactory>(),
               rtc::nullopt) {
   RTC_DCHECK(encoder_queue);
@@ -524,6 +588,7 @@ Channel::Channel(ProcessThread* module_process_thread,
                  RtcpRttStats* rtcp_rtt_stats,
                  size_t jitter_buffer_max_packets,
                  bool jitter_buffer_fast_playout,
+                 bool jitter_buffer_low_latency,
                  rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
                  rtc::Optional<AudioCodecPairId> codec_pair_id)
     : event_log_proxy_(new RtcEventLogProxy()),
@@ -571,7 +636,10 @@ Channel::Channel(ProcessThread* module_process_thread,
   acm_config.neteq_config.codec_pair_id = codec_pair_id;
   acm_config.neteq_config.max_packets_in_buffer = jitter_buffer_max_packets;
   acm_config.neteq_config.enable_fast_accelerate = jitter_buffer_fast_playout;
+  acm_config.neteq_config.enable_low_latency = jitter_buffer_low_latency;
   acm_config.neteq_config.enable_muted_state = true;
+  acm_config.neteq_config.enable_dtx_muted_state =
+      webrtc::field_trial::IsEnabled("WebRTC-Audio-NetEqDtxMutedState");
   audio_coding_.reset(AudioCodingModule::Create(acm_config));
 
   _outputAudioLevel.Clear();
@@ -835,6 +903,18 @@ void Channel::SetReceiveCodecs(const std::map<int, SdpAudioFormat>& codecs) {
   audio_coding_->SetReceiveCodecs(codecs);
 }
 
+void Channel::SetFrameEncryptor(
+    rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor) {
+  rtc::CritScope cs(&frame_crypto_lock_);
+  frame_encryptor_ = std::move(frame_encryptor);
+}
+
+void Channel::SetFrameDecryptor(
+    rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor) {
+  rtc::CritScope cs(&frame_crypto_lock_);
+  frame_decryptor_ = std::move(frame_decryptor);
+}
+
 bool Channel::EnableAudioNetworkAdaptor(const std::string& config_string) {
   bool success = false;
   audio_coding_->ModifyEncoder([&](std::unique_ptr<AudioEncoder>* encoder) {
@@ -1236,19 +1316,38 @@ void Channel::ProcessAndEncodeAudio(std::unique_ptr<AudioFrame> audio_frame) {
       new ProcessAndEncodeAudioTask(std::move(audio_frame), this)));
 }
 
-void Channel::ProcessAndEncodeAudioOnTaskQueue(AudioFrame* audio_input) {
+void Channel::ProcessAndEncodeAudio(
+    rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>> audio_frame) {
+  RTC_DCHECK(audio_frame);
+  // Avoid posting any new tasks if sending was already stopped in StopSend().
+  rtc::CritScope cs(&encoder_queue_lock_);
+  if (!encoder_queue_is_active_) {
+    return;
+  }
+  encoder_queue_->PostTask(std::unique_ptr<rtc::QueuedTask>(
+      new ProcessAndEncodeAudioTask(std::move(audio_frame), this)));
+}
+
+void Channel::ProcessAndEncodeAudioOnTaskQueue(const AudioFrame& audio_frame) {
   RTC_DCHECK_RUN_ON(encoder_queue_);
-  RTC_DCHECK_GT(audio_input->samples_per_channel_, 0);
-  RTC_DCHECK_LE(audio_input->num_channels_, 2);
+  RTC_DCHECK_GT(audio_frame.samples_per_channel_, 0);
+  RTC_DCHECK_LE(audio_frame.num_channels_, 2);
 
   // Measure time between when the audio frame is added to the task queue and
   // when the task is actually executed. Goal is to keep track of unwanted
   // extra latency added by the task queue.
   RTC_HISTOGRAM_COUNTS_10000("WebRTC.Audio.EncodingTaskQueueLatencyMs",
-                             audio_input->ElapsedProfileTimeMs());
+                             audio_frame.ElapsedProfileTimeMs());
 
+  // The input frame may be shared with other channels, so it is copied before
+  // it is muted, or ramped in or out of mute.
   bool is_muted = InputMute();
-  AudioFrameOperations::Mute(audio_input, previous_frame_muted_, is_muted);
+  const AudioFrame* audio_input = &audio_frame;
+  if (is_muted || previous_frame_muted_) {
+    muted_frame_.CopyFrom(audio_frame);
+    AudioFrameOperations::Mute(&muted_frame_, previous_frame_muted_, is_muted);
+    audio_input = &muted_frame_;
+  }
 
   if (_includeAudioLevelIndication) {
     size_t length =
@@ -1266,11 +1365,10 @@ void Channel::ProcessAndEncodeAudioOnTaskQueue(AudioFrame* audio_input) {
   // Add 10ms of raw (PCM) audio data to the encoder @ 32kHz.
 
   // The ACM resamples internally.
-  audio_input->timestamp_ = _timeStamp;
   // This call will trigger AudioPacketizationCallback::SendData if encoding
   // is done and payload is ready for packetization and transmission.
   // Otherwise, it will return without invoking the callback.
-  if (audio_coding_->Add10MsData(*audio_input) < 0) {
+  if (audio_coding_->Add10MsData(*audio_input, _timeStamp) < 0) {
     RTC_DLOG(LS_ERROR) << "ACM::Add10MsData() failed.";
     return;
   }
@@ -20,6 +20,8 @@
 #include "api/audio_codecs/audio_encoder.h"
 #include "api/call/audio_sink.h"
 #include "api/call/transport.h"
+#include "api/crypto/frame_decryptor_interface.h"
+#include "api/crypto/frame_encryptor_interface.h"
 #include "api/optional.h"
 #include "audio/audio_level.h"
 #include "common_types.h"  // NOLINT(build/include)
@@ -29,8 +31,10 @@
 #include "modules/rtp_rtcp/include/rtp_header_parser.h"
 #include "modules/rtp_rtcp/include/rtp_receiver.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
+#include "rtc_base/refcountedobject.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/thread_checker.h"
 
@@ -158,6 +162,7 @@ class Channel
           RtcpRttStats* rtcp_rtt_stats,
           size_t jitter_buffer_max_packets,
           bool jitter_buffer_fast_playout,
+          bool jitter_buffer_low_latency,
           rtc::scoped_refptr<AudioDecoderFactory> decoder_factory,
           rtc::Optional<AudioCodecPairId> codec_pair_id);
   virtual ~Channel();
@@ -166,6 +171,13 @@ class Channel
 
   void SetReceiveCodecs(const std::map<int, SdpAudioFormat>& codecs);
 
+  // End-to-end encryption of the audio payloads, see FrameEncryptorInterface.
+  // Null disables encryption.
+  void SetFrameEncryptor(
+      rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor);
+  void SetFrameDecryptor(
+      rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor);
+
   // Send using this encoder, with this payload type.
   bool SetEncoder(int payload_type, std::unique_ptr<AudioEncoder> encoder);
   void ModifyEncoder(
@@ -278,6 +290,11 @@ class Channel
   // can go back to sleep and be prepared to deliver an new captured audio
   // packet.
   void ProcessAndEncodeAudio(std::unique_ptr<AudioFrame> audio_frame);
+  // Same as above for a frame which is shared with other channels. It is not
+  // modified, and only copied when it has to be muted. The caller is expected
+  // to have called UpdateProfileTimeStamp() on the frame.
+  void ProcessAndEncodeAudio(
+      rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>> audio_frame);
 
   // Associate to a send channel.
   // Used for obtaining RTT for a receive-only channel.
@@ -333,7 +350,7 @@ class Channel
 
   // Called on the encoder task queue when a new input audio frame is ready
   // for encoding.
-  void ProcessAndEncodeAudioOnTaskQueue(AudioFrame* audio_input);
+  void ProcessAndEncodeAudioOnTaskQueue(const AudioFrame& audio_input);
 
   rtc::CriticalSection _callbackCritSect;
   rtc::CriticalSection volume_settings_critsect_;
@@ -378,6 +395,8 @@ class Channel
   RmsLevel rms_level_ RTC_GUARDED_BY(encoder_queue_);
   bool input_mute_ RTC_GUARDED_BY(volume_settings_critsect_);
   bool previous_frame_muted_ RTC_GUARDED_BY(encoder_queue_);
+  // Holds a copy of the input frame while it is muted or ramped.
+  AudioFrame muted_frame_ RTC_GUARDED_BY(encoder_queue_);
   float _outputGain RTC_GUARDED_BY(volume_settings_critsect_);
   // VoeRTP_RTCP
   // TODO(henrika): can today be accessed on the main thread and on the
@@ -407,6 +426,18 @@ class Channel
   rtc::CriticalSection encoder_queue_lock_;
   bool encoder_queue_is_active_ RTC_GUARDED_BY(encoder_queue_lock_) = false;
   rtc::TaskQueue* encoder_queue_ = nullptr;
+
+  // Set on the worker thread, and used on the encoder queue and the thread
+  // delivering incoming packets.
+  rtc::CriticalSection frame_crypto_lock_;
+  rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor_
+      RTC_GUARDED_BY(frame_crypto_lock_);
+  rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor_
+      RTC_GUARDED_BY(frame_crypto_lock_);
+  // Only used on the encoder queue.
+  rtc::Buffer encrypted_payload_;
+  // Only used on the thread delivering incoming packets.
+  rtc::Buffer decrypted_payload_;
 };
 
 }  // namespace voe
@@ -191,6 +191,18 @@ void ChannelProxy::SetReceiveCodecs(
   channel_->SetReceiveCodecs(codecs);
 }
 
+void ChannelProxy::SetFrameEncryptor(
+    rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor) {
+  RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  channel_->SetFrameEncryptor(std::move(frame_encryptor));
+}
+
+void ChannelProxy::SetFrameDecryptor(
+    rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor) {
+  RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  channel_->SetFrameDecryptor(std::move(frame_decryptor));
+}
+
 void ChannelProxy::SetSink(AudioSinkInterface* sink) {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
   channel_->SetSink(sink);
@@ -244,6 +256,12 @@ void ChannelProxy::ProcessAndEncodeAudio(
   return channel_->ProcessAndEncodeAudio(std::move(audio_frame));
 }
 
+void ChannelProxy::ProcessAndEncodeAudio(
+    rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>> audio_frame) {
+  RTC_DCHECK_RUNS_SERIALIZED(&audio_thread_race_checker_);
+  return channel_->ProcessAndEncodeAudio(std::move(audio_frame));
+}
+
 void ChannelProxy::SetTransportOverhead(int transport_overhead_per_packet) {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
   channel_->SetTransportOverhead(transport_overhead_per_packet);
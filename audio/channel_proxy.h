@@ -90,6 +90,10 @@ class ChannelProxy : public RtpPacketSinkInterface {
   virtual bool SendTelephoneEventOutband(int event, int duration_ms);
   virtual void SetBitrate(int bitrate_bps, int64_t probing_interval_ms);
   virtual void SetReceiveCodecs(const std::map<int, SdpAudioFormat>& codecs);
+  virtual void SetFrameEncryptor(
+      rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor);
+  virtual void SetFrameDecryptor(
+      rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor);
   virtual void SetSink(AudioSinkInterface* sink);
   virtual void SetInputMute(bool muted);
   virtual void RegisterTransport(Transport* transport);
@@ -104,6 +108,8 @@ class ChannelProxy : public RtpPacketSinkInterface {
       AudioFrame* audio_frame);
   virtual int PreferredSampleRate() const;
   virtual void ProcessAndEncodeAudio(std::unique_ptr<AudioFrame> audio_frame);
+  virtual void ProcessAndEncodeAudio(
+      rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>> audio_frame);
   virtual void SetTransportOverhead(int transport_overhead_per_packet);
   virtual void AssociateSendChannel(const ChannelProxy& send_channel_proxy);
   virtual void DisassociateSendChannel();
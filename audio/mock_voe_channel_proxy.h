@@ -79,6 +79,12 @@ class MockVoEChannelProxy : public voe::ChannelProxy {
   }
   MOCK_METHOD1(ProcessAndEncodeAudioForMock,
                void(std::unique_ptr<AudioFrame>* audio_frame));
+  virtual void ProcessAndEncodeAudio(
+      rtc::scoped_refptr<const rtc::RefCountedObject<AudioFrame>> audio_frame) {
+    ProcessAndEncodeSharedAudioForMock(audio_frame.get());
+  }
+  MOCK_METHOD1(ProcessAndEncodeSharedAudioForMock,
+               void(const AudioFrame* audio_frame));
   MOCK_METHOD1(SetTransportOverhead, void(int transport_overhead_per_packet));
   MOCK_METHOD1(AssociateSendChannel,
                void(const ChannelProxy& send_channel_proxy));
@@ -90,6 +96,10 @@ class MockVoEChannelProxy : public voe::ChannelProxy {
   MOCK_CONST_METHOD1(GetRecCodec, bool(CodecInst* codec_inst));
   MOCK_METHOD1(SetReceiveCodecs,
                void(const std::map<int, SdpAudioFormat>& codecs));
+  MOCK_METHOD1(SetFrameEncryptor,
+               void(rtc::scoped_refptr<FrameEncryptorInterface>));
+  MOCK_METHOD1(SetFrameDecryptor,
+               void(rtc::scoped_refptr<FrameDecryptorInterface>));
   MOCK_METHOD1(OnTwccBasedUplinkPacketLossRate, void(float packet_loss_rate));
   MOCK_METHOD1(OnRecoverableUplinkPacketLossRate,
                void(float recoverable_packet_loss_rate));
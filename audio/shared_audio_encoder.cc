@@ -0,0 +1,334 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/shared_audio_encoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/function_view.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+class SharedAudioEncoder::Subscriber : public AudioEncoder {
+ public:
+  explicit Subscriber(rtc::scoped_refptr<SharedAudioEncoder> shared)
+      : shared_(std::move(shared)) {
+    shared_->AddSubscriber(this);
+  }
+  ~Subscriber() override { shared_->RemoveSubscriber(this); }
+
+  int SampleRateHz() const override { return shared_->SampleRateHz(); }
+  size_t NumChannels() const override { return shared_->NumChannels(); }
+  int RtpTimestampRateHz() const override {
+    return shared_->RtpTimestampRateHz();
+  }
+  size_t Num10MsFramesInNextPacket() const override {
+    return shared_->Num10MsFramesInNextPacket();
+  }
+  size_t Max10MsFramesInAPacket() const override {
+    return shared_->Max10MsFramesInAPacket();
+  }
+  int GetTargetBitrate() const override { return shared_->GetTargetBitrate(); }
+
+  // Other streams keep using the shared encoder.
+  void Reset() override {
+    shared_->UpdateSubscriber(this, [](Subscriber* subscriber) {
+      if (subscriber->private_encoder)
+        subscriber->private_encoder->Reset();
+    });
+  }
+
+  void OnReceivedTargetAudioBitrate(int target_bps) override {
+    shared_->UpdateSubscriber(this, [target_bps](Subscriber* subscriber) {
+      subscriber->target_bitrate_bps = target_bps;
+      if (subscriber->private_encoder)
+        subscriber->private_encoder->OnReceivedTargetAudioBitrate(target_bps);
+    });
+  }
+
+  void OnReceivedUplinkBandwidth(
+      int target_audio_bitrate_bps,
+      rtc::Optional<int64_t> bwe_period_ms) override {
+    shared_->UpdateSubscriber(this, [&](Subscriber* subscriber) {
+      subscriber->uplink_bandwidth_bps = target_audio_bitrate_bps;
+      if (subscriber->private_encoder) {
+        subscriber->private_encoder->OnReceivedUplinkBandwidth(
+            target_audio_bitrate_bps, bwe_period_ms);
+      }
+    });
+  }
+
+  void OnReceivedUplinkPacketLossFraction(
+      float uplink_packet_loss_fraction) override {
+    shared_->UpdateSubscriber(this, [&](Subscriber* subscriber) {
+      subscriber->packet_loss_fraction = uplink_packet_loss_fraction;
+      if (subscriber->private_encoder) {
+        subscriber->private_encoder->OnReceivedUplinkPacketLossFraction(
+            uplink_packet_loss_fraction);
+      }
+    });
+  }
+
+  void OnReceivedOverhead(size_t overhead_bytes_per_packet) override {
+    shared_->UpdateSubscriber(this, [&](Subscriber* subscriber) {
+      subscriber->overhead_bytes_per_packet = overhead_bytes_per_packet;
+      if (subscriber->private_encoder) {
+        subscriber->private_encoder->OnReceivedOverhead(
+            overhead_bytes_per_packet);
+      }
+    });
+  }
+
+  // The fields below are guarded by the shared encoder's lock.
+
+  // The index of the chunk this subscriber expects to encode next.
+  int64_t next_chunk_index = 0;
+  // Set while the subscriber's audio differs from the shared audio.
+  bool diverged = false;
+  std::unique_ptr<AudioEncoder> private_encoder;
+
+  rtc::Optional<int> target_bitrate_bps;
+  rtc::Optional<int> uplink_bandwidth_bps;
+  rtc::Optional<float> packet_loss_fraction;
+  rtc::Optional<size_t> overhead_bytes_per_packet;
+
+ protected:
+  EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
+                         rtc::ArrayView<const int16_t> audio,
+                         rtc::Buffer* encoded) override {
+    return shared_->Encode(this, rtp_timestamp, audio, encoded);
+  }
+
+ private:
+  const rtc::scoped_refptr<SharedAudioEncoder> shared_;
+};
+
+SharedAudioEncoder::Chunk::Chunk() : index(0), rtp_timestamp(0) {}
+SharedAudioEncoder::Chunk::~Chunk() = default;
+
+rtc::scoped_refptr<SharedAudioEncoder> SharedAudioEncoder::Create(
+    EncoderFactory create_encoder) {
+  return new rtc::RefCountedObject<SharedAudioEncoder>(
+      std::move(create_encoder));
+}
+
+SharedAudioEncoder::SharedAudioEncoder(EncoderFactory create_encoder)
+    : create_encoder_(std::move(create_encoder)), encoder_(create_encoder_()) {
+  RTC_DCHECK(encoder_);
+}
+
+SharedAudioEncoder::~SharedAudioEncoder() {
+  RTC_DCHECK(subscribers_.empty());
+}
+
+std::unique_ptr<AudioEncoder> SharedAudioEncoder::CreateSubscriber() {
+  return std::unique_ptr<AudioEncoder>(new Subscriber(this));
+}
+
+int64_t SharedAudioEncoder::num_shared_chunks() const {
+  rtc::CritScope lock(&crit_);
+  return next_chunk_index_;
+}
+
+void SharedAudioEncoder::AddSubscriber(Subscriber* subscriber) {
+  rtc::CritScope lock(&crit_);
+  // A new stream joins at the next chunk.
+  subscriber->next_chunk_index = next_chunk_index_;
+  subscribers_.push_back(subscriber);
+}
+
+void SharedAudioEncoder::RemoveSubscriber(Subscriber* subscriber) {
+  rtc::CritScope lock(&crit_);
+  subscribers_.erase(
+      std::find(subscribers_.begin(), subscribers_.end(), subscriber));
+  UpdateNetworkParameters();
+}
+
+void SharedAudioEncoder::UpdateSubscriber(
+    Subscriber* subscriber,
+    rtc::FunctionView<void(Subscriber*)> update) {
+  rtc::CritScope lock(&crit_);
+  update(subscriber);
+  UpdateNetworkParameters();
+}
+
+AudioEncoder::EncodedInfo SharedAudioEncoder::Encode(
+    Subscriber* subscriber,
+    uint32_t rtp_timestamp,
+    rtc::ArrayView<const int16_t> audio,
+    rtc::Buffer* encoded) {
+  rtc::CritScope lock(&crit_);
+  // Reuse the output for the same audio, from where the subscriber left off.
+  const Chunk* shared_chunk = nullptr;
+  for (const Chunk& chunk : chunks_) {
+    if (chunk.index >= subscriber->next_chunk_index &&
+        chunk.audio.size() == audio.size() &&
+        std::equal(audio.begin(), audio.end(), chunk.audio.begin())) {
+      shared_chunk = &chunk;
+      break;
+    }
+  }
+
+  // A subscriber that is ahead of the others encodes the next chunk, unless
+  // its audio is the odd one out.
+  if (!shared_chunk && subscriber->next_chunk_index >= next_chunk_index_ &&
+      (!subscriber->diverged ||
+       std::all_of(subscribers_.begin(), subscribers_.end(),
+                   [subscriber](const Subscriber* other) {
+                     return other == subscriber || other->diverged;
+                   }))) {
+    if (chunks_.size() == kMaxCachedChunks)
+      chunks_.pop_front();
+    chunks_.emplace_back();
+    Chunk& chunk = chunks_.back();
+    chunk.index = next_chunk_index_++;
+    // The shared encoder runs on its own timeline, since the subscribers
+    // that lead alternate.
+    chunk.rtp_timestamp = next_rtp_timestamp_;
+    next_rtp_timestamp_ += static_cast<uint32_t>(
+        audio.size() / encoder_->NumChannels() *
+        encoder_->RtpTimestampRateHz() / encoder_->SampleRateHz());
+    chunk.audio.assign(audio.begin(), audio.end());
+    chunk.info = encoder_->Encode(chunk.rtp_timestamp, audio, &chunk.encoded);
+    shared_chunk = &chunk;
+  }
+
+  if (shared_chunk) {
+    Rejoin(subscriber, shared_chunk->index + 1);
+    AudioEncoder::EncodedInfo info = shared_chunk->info;
+    // Move the timestamps to the subscriber's timeline.
+    const uint32_t offset = rtp_timestamp - shared_chunk->rtp_timestamp;
+    info.encoded_timestamp += offset;
+    for (auto& leaf : info.redundant)
+      leaf.encoded_timestamp += offset;
+    encoded->AppendData(shared_chunk->encoded.data(),
+                        shared_chunk->encoded.size());
+    return info;
+  }
+
+  subscriber->diverged = true;
+  ++subscriber->next_chunk_index;
+  if (!subscriber->private_encoder)
+    subscriber->private_encoder = CreatePrivateEncoder(*subscriber);
+  return subscriber->private_encoder->Encode(rtp_timestamp, audio, encoded);
+}
+
+void SharedAudioEncoder::Rejoin(Subscriber* subscriber,
+                                int64_t next_chunk_index) {
+  subscriber->next_chunk_index = next_chunk_index;
+  subscriber->diverged = false;
+  // Audio buffered in the private encoder would come out later, mixed with
+  // new audio.
+  subscriber->private_encoder.reset();
+}
+
+std::unique_ptr<AudioEncoder> SharedAudioEncoder::CreatePrivateEncoder(
+    const Subscriber& subscriber) const {
+  std::unique_ptr<AudioEncoder> encoder = create_encoder_();
+  RTC_DCHECK(encoder);
+  if (subscriber.target_bitrate_bps)
+    encoder->OnReceivedTargetAudioBitrate(*subscriber.target_bitrate_bps);
+  if (subscriber.uplink_bandwidth_bps) {
+    encoder->OnReceivedUplinkBandwidth(*subscriber.uplink_bandwidth_bps,
+                                       rtc::nullopt);
+  }
+  if (subscriber.packet_loss_fraction) {
+    encoder->OnReceivedUplinkPacketLossFraction(
+        *subscriber.packet_loss_fraction);
+  }
+  if (subscriber.overhead_bytes_per_packet)
+    encoder->OnReceivedOverhead(*subscriber.overhead_bytes_per_packet);
+  return encoder;
+}
+
+void SharedAudioEncoder::UpdateNetworkParameters() {
+  // The shared encoder must suit the most constrained receiver.
+  NetworkParameters parameters;
+  for (const Subscriber* subscriber : subscribers_) {
+    if (subscriber->target_bitrate_bps) {
+      parameters.target_bitrate_bps =
+          std::min(*subscriber->target_bitrate_bps,
+                   parameters.target_bitrate_bps.value_or(
+                       *subscriber->target_bitrate_bps));
+    }
+    if (subscriber->uplink_bandwidth_bps) {
+      parameters.uplink_bandwidth_bps =
+          std::min(*subscriber->uplink_bandwidth_bps,
+                   parameters.uplink_bandwidth_bps.value_or(
+                       *subscriber->uplink_bandwidth_bps));
+    }
+    if (subscriber->packet_loss_fraction) {
+      parameters.packet_loss_fraction =
+          std::max(*subscriber->packet_loss_fraction,
+                   parameters.packet_loss_fraction.value_or(0.0f));
+    }
+    if (subscriber->overhead_bytes_per_packet) {
+      parameters.overhead_bytes_per_packet =
+          std::max(*subscriber->overhead_bytes_per_packet,
+                   parameters.overhead_bytes_per_packet.value_or(0));
+    }
+  }
+
+  if (parameters.target_bitrate_bps &&
+      parameters.target_bitrate_bps != applied_.target_bitrate_bps) {
+    encoder_->OnReceivedTargetAudioBitrate(*parameters.target_bitrate_bps);
+  }
+  if (parameters.uplink_bandwidth_bps &&
+      parameters.uplink_bandwidth_bps != applied_.uplink_bandwidth_bps) {
+    encoder_->OnReceivedUplinkBandwidth(*parameters.uplink_bandwidth_bps,
+                                        rtc::nullopt);
+  }
+  if (parameters.packet_loss_fraction &&
+      parameters.packet_loss_fraction != applied_.packet_loss_fraction) {
+    encoder_->OnReceivedUplinkPacketLossFraction(
+        *parameters.packet_loss_fraction);
+  }
+  if (parameters.overhead_bytes_per_packet &&
+      parameters.overhead_bytes_per_packet !=
+          applied_.overhead_bytes_per_packet) {
+    encoder_->OnReceivedOverhead(*parameters.overhead_bytes_per_packet);
+  }
+  applied_ = parameters;
+}
+
+int SharedAudioEncoder::SampleRateHz() const {
+  rtc::CritScope lock(&crit_);
+  return encoder_->SampleRateHz();
+}
+
+size_t SharedAudioEncoder::NumChannels() const {
+  rtc::CritScope lock(&crit_);
+  return encoder_->NumChannels();
+}
+
+int SharedAudioEncoder::RtpTimestampRateHz() const {
+  rtc::CritScope lock(&crit_);
+  return encoder_->RtpTimestampRateHz();
+}
+
+size_t SharedAudioEncoder::Num10MsFramesInNextPacket() const {
+  rtc::CritScope lock(&crit_);
+  return encoder_->Num10MsFramesInNextPacket();
+}
+
+size_t SharedAudioEncoder::Max10MsFramesInAPacket() const {
+  rtc::CritScope lock(&crit_);
+  return encoder_->Max10MsFramesInAPacket();
+}
+
+int SharedAudioEncoder::GetTargetBitrate() const {
+  rtc::CritScope lock(&crit_);
+  return encoder_->GetTargetBitrate();
+}
+
+}  // namespace webrtc
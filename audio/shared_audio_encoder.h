@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef AUDIO_SHARED_AUDIO_ENCODER_H_
+#define AUDIO_SHARED_AUDIO_ENCODER_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "api/audio_codecs/audio_encoder.h"
+#include "api/optional.h"
+#include "rtc_base/buffer.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/function_view.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Lets send streams that encode the same audio with the same encoder
+// configuration share one encoder, e.g. when a mix is broadcast to many
+// receivers.
+//
+// Each stream gets a subscriber AudioEncoder. The first subscriber to pass a
+// 10 ms chunk encodes it; the others get the cached output, with the
+// timestamps moved to their own RTP timeline. Sequence numbers and SSRCs are
+// set by each stream's own RTP module as usual. A subscriber whose audio
+// differs from the shared one, e.g. because its stream is muted, encodes with
+// a private encoder until its audio matches again.
+//
+// The shared encoder uses the lowest target bitrate and the highest packet
+// loss and overhead that any subscriber reports. Per-stream codec changes
+// such as SetFec() or the audio network adaptor are not supported.
+class SharedAudioEncoder : public rtc::RefCountInterface {
+ public:
+  using EncoderFactory = std::function<std::unique_ptr<AudioEncoder>()>;
+
+  // |create_encoder| creates the shared encoder now and private encoders
+  // when needed.
+  static rtc::scoped_refptr<SharedAudioEncoder> Create(
+      EncoderFactory create_encoder);
+
+  // The encoder to give to one stream. It keeps a reference to this object.
+  std::unique_ptr<AudioEncoder> CreateSubscriber();
+
+  // Number of 10 ms chunks encoded by the shared encoder.
+  int64_t num_shared_chunks() const;
+
+  // True when only the caller refers to this object, i.e. no subscriber does.
+  // Implemented by rtc::RefCountedObject.
+  virtual bool HasOneRef() const = 0;
+
+ protected:
+  explicit SharedAudioEncoder(EncoderFactory create_encoder);
+  ~SharedAudioEncoder() override;
+
+ private:
+  class Subscriber;
+
+  struct Chunk {
+    Chunk();
+    ~Chunk();
+
+    int64_t index;
+    uint32_t rtp_timestamp;
+    std::vector<int16_t> audio;
+    AudioEncoder::EncodedInfo info;
+    rtc::Buffer encoded;
+  };
+
+  struct NetworkParameters {
+    rtc::Optional<int> target_bitrate_bps;
+    rtc::Optional<int> uplink_bandwidth_bps;
+    rtc::Optional<float> packet_loss_fraction;
+    rtc::Optional<size_t> overhead_bytes_per_packet;
+  };
+
+  // A chunk stays cached for subscribers whose encoder task runs late.
+  static const size_t kMaxCachedChunks = 16;
+
+  void AddSubscriber(Subscriber* subscriber);
+  void RemoveSubscriber(Subscriber* subscriber);
+  // Runs |update| on the subscriber's state under the lock.
+  void UpdateSubscriber(Subscriber* subscriber,
+                        rtc::FunctionView<void(Subscriber*)> update);
+  AudioEncoder::EncodedInfo Encode(Subscriber* subscriber,
+                                   uint32_t rtp_timestamp,
+                                   rtc::ArrayView<const int16_t> audio,
+                                   rtc::Buffer* encoded);
+  void Rejoin(Subscriber* subscriber, int64_t next_chunk_index)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  std::unique_ptr<AudioEncoder> CreatePrivateEncoder(
+      const Subscriber& subscriber) const;
+  // Applies the subscribers' network feedback to the shared encoder.
+  void UpdateNetworkParameters() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  int SampleRateHz() const;
+  size_t NumChannels() const;
+  int RtpTimestampRateHz() const;
+  size_t Num10MsFramesInNextPacket() const;
+  size_t Max10MsFramesInAPacket() const;
+  int GetTargetBitrate() const;
+
+  const EncoderFactory create_encoder_;
+
+  rtc::CriticalSection crit_;
+  const std::unique_ptr<AudioEncoder> encoder_ RTC_GUARDED_BY(crit_);
+  std::vector<Subscriber*> subscribers_ RTC_GUARDED_BY(crit_);
+  // The most recent chunks, oldest first.
+  std::deque<Chunk> chunks_ RTC_GUARDED_BY(crit_);
+  int64_t next_chunk_index_ RTC_GUARDED_BY(crit_) = 0;
+  uint32_t next_rtp_timestamp_ RTC_GUARDED_BY(crit_) = 0;
+  // What the shared encoder was last told.
+  NetworkParameters applied_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace webrtc
+
+#endif  // AUDIO_SHARED_AUDIO_ENCODER_H_
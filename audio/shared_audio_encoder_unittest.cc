@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "audio/shared_audio_encoder.h"
+
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+const int kSampleRateHz = 16000;
+const size_t kSamplesPer10Ms = kSampleRateHz / 100;
+
+struct EncoderStats {
+  int num_encoders = 0;
+  int num_encodes = 0;
+  int target_bitrate_bps = 0;
+};
+
+// Outputs a packet every 20 ms: the first sample of each of its two chunks.
+class FakeEncoder : public AudioEncoder {
+ public:
+  explicit FakeEncoder(EncoderStats* stats) : stats_(stats) {
+    ++stats_->num_encoders;
+  }
+
+  int SampleRateHz() const override { return kSampleRateHz; }
+  size_t NumChannels() const override { return 1; }
+  size_t Num10MsFramesInNextPacket() const override { return 2; }
+  size_t Max10MsFramesInAPacket() const override { return 2; }
+  int GetTargetBitrate() const override { return stats_->target_bitrate_bps; }
+  void Reset() override { pending_.clear(); }
+  void OnReceivedTargetAudioBitrate(int target_bps) override {
+    stats_->target_bitrate_bps = target_bps;
+  }
+
+ protected:
+  EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
+                         rtc::ArrayView<const int16_t> audio,
+                         rtc::Buffer* encoded) override {
+    ++stats_->num_encodes;
+    if (pending_.empty())
+      first_timestamp_ = rtp_timestamp;
+    pending_.push_back(static_cast<uint8_t>(audio[0]));
+    EncodedInfo info;
+    if (pending_.size() == 2) {
+      encoded->AppendData(pending_.data(), pending_.size());
+      info.encoded_bytes = pending_.size();
+      info.encoded_timestamp = first_timestamp_;
+      info.payload_type = 111;
+      pending_.clear();
+    }
+    return info;
+  }
+
+ private:
+  EncoderStats* const stats_;
+  std::vector<uint8_t> pending_;
+  uint32_t first_timestamp_ = 0;
+};
+
+rtc::scoped_refptr<SharedAudioEncoder> CreateShared(EncoderStats* stats) {
+  return SharedAudioEncoder::Create([stats] {
+    return std::unique_ptr<AudioEncoder>(new FakeEncoder(stats));
+  });
+}
+
+// Encodes a chunk with all samples set to |value|.
+AudioEncoder::EncodedInfo EncodeChunk(AudioEncoder* encoder,
+                                      uint32_t rtp_timestamp,
+                                      int16_t value,
+                                      rtc::Buffer* encoded) {
+  const std::vector<int16_t> audio(kSamplesPer10Ms, value);
+  return encoder->Encode(rtp_timestamp, audio, encoded);
+}
+
+std::vector<uint8_t> Bytes(const rtc::Buffer& buffer) {
+  return std::vector<uint8_t>(buffer.begin(), buffer.end());
+}
+
+}  // namespace
+
+TEST(SharedAudioEncoderTest, EncodesIdenticalAudioOnce) {
+  EncoderStats stats;
+  auto shared = CreateShared(&stats);
+  const uint32_t kFirstTimestamps[] = {1000, 5000, 0xffffff00};
+  std::vector<std::unique_ptr<AudioEncoder>> subscribers;
+  for (size_t i = 0; i < 3; ++i)
+    subscribers.push_back(shared->CreateSubscriber());
+
+  for (int chunk = 0; chunk < 4; ++chunk) {
+    std::vector<rtc::Buffer> outputs(subscribers.size());
+    for (size_t i = 0; i < subscribers.size(); ++i) {
+      const uint32_t timestamp = kFirstTimestamps[i] + chunk * kSamplesPer10Ms;
+      AudioEncoder::EncodedInfo info = EncodeChunk(
+          subscribers[i].get(), timestamp, chunk + 1, &outputs[i]);
+      if (chunk % 2 == 1) {
+        EXPECT_EQ(2u, info.encoded_bytes);
+        EXPECT_EQ(timestamp - kSamplesPer10Ms, info.encoded_timestamp);
+        EXPECT_EQ(111, info.payload_type);
+        EXPECT_EQ(outputs[0], outputs[i]);
+      } else {
+        EXPECT_EQ(0u, info.encoded_bytes);
+      }
+    }
+  }
+  EXPECT_EQ(1, stats.num_encoders);
+  EXPECT_EQ(4, stats.num_encodes);
+  EXPECT_EQ(4, shared->num_shared_chunks());
+}
+
+TEST(SharedAudioEncoderTest, DivergedSubscriberUsesPrivateEncoder) {
+  EncoderStats stats;
+  auto shared = CreateShared(&stats);
+  std::unique_ptr<AudioEncoder> speaking = shared->CreateSubscriber();
+  std::unique_ptr<AudioEncoder> muted = shared->CreateSubscriber();
+
+  rtc::Buffer speaking_output;
+  rtc::Buffer muted_output;
+  for (int chunk = 0; chunk < 2; ++chunk) {
+    EncodeChunk(speaking.get(), chunk * kSamplesPer10Ms, chunk + 1,
+                &speaking_output);
+    EncodeChunk(muted.get(), chunk * kSamplesPer10Ms, 0, &muted_output);
+  }
+  EXPECT_EQ(2, stats.num_encoders);
+  EXPECT_EQ(std::vector<uint8_t>({1, 2}), Bytes(speaking_output));
+  EXPECT_EQ(std::vector<uint8_t>({0, 0}), Bytes(muted_output));
+
+  // Unmuted, the stream gets the shared output again.
+  speaking_output.Clear();
+  muted_output.Clear();
+  for (int chunk = 2; chunk < 4; ++chunk) {
+    EncodeChunk(speaking.get(), chunk * kSamplesPer10Ms, chunk + 1,
+                &speaking_output);
+    EncodeChunk(muted.get(), chunk * kSamplesPer10Ms, chunk + 1,
+                &muted_output);
+  }
+  EXPECT_EQ(std::vector<uint8_t>({3, 4}), Bytes(speaking_output));
+  EXPECT_EQ(speaking_output, muted_output);
+  EXPECT_EQ(6, stats.num_encodes);
+  EXPECT_EQ(4, shared->num_shared_chunks());
+}
+
+TEST(SharedAudioEncoderTest, LateSubscriberReusesCachedChunks) {
+  EncoderStats stats;
+  auto shared = CreateShared(&stats);
+  std::unique_ptr<AudioEncoder> early = shared->CreateSubscriber();
+  std::unique_ptr<AudioEncoder> late = shared->CreateSubscriber();
+
+  rtc::Buffer early_output;
+  for (int chunk = 0; chunk < 4; ++chunk)
+    EncodeChunk(early.get(), chunk * kSamplesPer10Ms, chunk + 1,
+                &early_output);
+
+  rtc::Buffer late_output;
+  AudioEncoder::EncodedInfo info;
+  for (int chunk = 0; chunk < 4; ++chunk) {
+    info = EncodeChunk(late.get(), 3000 + chunk * kSamplesPer10Ms, chunk + 1,
+                       &late_output);
+  }
+  EXPECT_EQ(3000 + 2 * kSamplesPer10Ms, info.encoded_timestamp);
+  EXPECT_EQ(early_output, late_output);
+  EXPECT_EQ(1, stats.num_encoders);
+  EXPECT_EQ(4, stats.num_encodes);
+}
+
+TEST(SharedAudioEncoderTest, UsesLowestTargetBitrate) {
+  EncoderStats stats;
+  auto shared = CreateShared(&stats);
+  std::unique_ptr<AudioEncoder> first = shared->CreateSubscriber();
+  std::unique_ptr<AudioEncoder> second = shared->CreateSubscriber();
+
+  first->OnReceivedTargetAudioBitrate(32000);
+  EXPECT_EQ(32000, stats.target_bitrate_bps);
+  second->OnReceivedTargetAudioBitrate(24000);
+  EXPECT_EQ(24000, stats.target_bitrate_bps);
+  EXPECT_EQ(24000, first->GetTargetBitrate());
+
+  second.reset();
+  EXPECT_EQ(32000, stats.target_bitrate_bps);
+}
+
+}  // namespace webrtc
@@ -18,6 +18,7 @@
 
 #include "api/audio_codecs/audio_decoder_factory.h"
 #include "api/call/transport.h"
+#include "api/crypto/frame_decryptor_interface.h"
 #include "api/optional.h"
 #include "api/rtpparameters.h"
 #include "api/rtpreceiverinterface.h"
@@ -109,6 +110,8 @@ class AudioReceiveStream {
     // NetEq settings.
     size_t jitter_buffer_max_packets = 50;
     bool jitter_buffer_fast_accelerate = false;
+    // See NetEq::Config::enable_low_latency.
+    bool jitter_buffer_low_latency = false;
 
     // Identifier for an A/V synchronization group. Empty string to disable.
     // TODO(pbos): Synchronize streams in a sync group, not just one video
@@ -121,6 +124,10 @@ class AudioReceiveStream {
     rtc::scoped_refptr<AudioDecoderFactory> decoder_factory;
 
     rtc::Optional<AudioCodecPairId> codec_pair_id;
+
+    // If set, every received audio payload is decrypted before it is inserted
+    // in the jitter buffer. See FrameDecryptorInterface.
+    rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor;
   };
 
   // Reconfigure the stream according to the Configuration.
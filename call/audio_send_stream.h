@@ -20,10 +20,12 @@
 #include "api/audio_codecs/audio_encoder_factory.h"
 #include "api/audio_codecs/audio_format.h"
 #include "api/call/transport.h"
+#include "api/crypto/frame_encryptor_interface.h"
 #include "api/optional.h"
 #include "api/rtpparameters.h"
 #include "call/rtp_config.h"
 #include "modules/audio_processing/include/audio_processing_statistics.h"
+#include "rtc_base/refcountedobject.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "typedefs.h"  // NOLINT(build/include)
 
@@ -129,6 +131,10 @@ class AudioSendStream {
 
     // Track ID as specified during track creation.
     std::string track_id;
+
+    // If set, every encoded audio frame is encrypted before it is packetized.
+    // See FrameEncryptorInterface.
+    rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor;
   };
 
   virtual ~AudioSendStream() = default;
@@ -148,6 +154,11 @@ class AudioSendStream {
   // Encode and send audio.
   virtual void SendAudioData(
       std::unique_ptr<webrtc::AudioFrame> audio_frame) = 0;
+  // Encode and send audio which may be shared with other streams, and must
+  // therefore not be modified.
+  virtual void SendAudioData(
+      rtc::scoped_refptr<const rtc::RefCountedObject<webrtc::AudioFrame>>
+          audio_frame) = 0;
 
   // TODO(solenberg): Make payload_type a config property instead.
   virtual bool SendTelephoneEvent(int payload_type, int payload_frequency,
@@ -32,7 +32,8 @@ class AudioState : public rtc::RefCountInterface {
     // AudioState.
     rtc::scoped_refptr<AudioMixer> audio_mixer;
 
-    // The audio processing module.
+    // The audio processing module. May be null for servers, which neither
+    // capture nor play out audio, in which case audio isn't processed.
     rtc::scoped_refptr<webrtc::AudioProcessing> audio_processing;
 
     // TODO(solenberg): Temporary: audio device module.
@@ -17,8 +17,11 @@
 #include <utility>
 
 #include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/refcountedobject.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
@@ -48,12 +51,41 @@ double MediaRatio(uint32_t allocated_bitrate, uint32_t protection_bitrate) {
 }
 }  // namespace
 
+BitrateAllocationSnapshot::BitrateAllocationSnapshot(int64_t version,
+                                                     uint32_t target_bitrate_bps,
+                                                     uint8_t fraction_loss,
+                                                     int64_t rtt,
+                                                     int64_t bwe_period_ms,
+                                                     Allocations allocations)
+    : version_(version),
+      target_bitrate_bps_(target_bitrate_bps),
+      fraction_loss_(fraction_loss),
+      rtt_(rtt),
+      bwe_period_ms_(bwe_period_ms),
+      allocations_(std::move(allocations)) {}
+
+BitrateAllocationSnapshot::~BitrateAllocationSnapshot() = default;
+
+uint32_t BitrateAllocationSnapshot::GetAllocatedBitrate(
+    const BitrateAllocatorObserver* observer) const {
+  auto it = std::lower_bound(
+      allocations_.begin(), allocations_.end(), observer,
+      [](const Allocations::value_type& allocation,
+         const BitrateAllocatorObserver* observer) {
+        return allocation.first < observer;
+      });
+  if (it == allocations_.end() || it->first != observer)
+    return 0;
+  return it->second;
+}
+
 BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
     : limit_observer_(limit_observer),
       last_bitrate_bps_(0),
       last_non_zero_bitrate_bps_(kDefaultBitrateBps),
       last_fraction_loss_(0),
       last_rtt_(0),
+      last_bwe_period_ms_(0),
       num_pause_events_(0),
       clock_(Clock::GetRealTimeClock()),
       last_bwe_log_time_(0),
@@ -63,13 +95,22 @@ BitrateAllocator::BitrateAllocator(LimitObserver* limit_observer)
       has_packet_feedback_(false),
       bitrate_allocation_strategy_(nullptr),
       transmission_max_bitrate_multiplier_(
-          GetTransmissionMaxBitrateMultiplier()) {
+          GetTransmissionMaxBitrateMultiplier()),
+      snapshot_(nullptr),
+      snapshot_readers_(0),
+      snapshot_version_(0) {
   sequenced_checker_.Detach();
+  snapshot_ = new rtc::RefCountedObject<BitrateAllocationSnapshot>(
+      snapshot_version_, last_bitrate_bps_, last_fraction_loss_, last_rtt_,
+      last_bwe_period_ms_, BitrateAllocationSnapshot::Allocations());
+  snapshot_->AddRef();
 }
 
 BitrateAllocator::~BitrateAllocator() {
   RTC_HISTOGRAM_COUNTS_100("WebRTC.Call.NumberOfPauseEvents",
                            num_pause_events_);
+  RTC_DCHECK_EQ(0, rtc::AtomicOps::AcquireLoad(&snapshot_readers_));
+  snapshot_->Release();
 }
 
 // static
@@ -105,41 +146,16 @@ void BitrateAllocator::OnNetworkChanged(uint32_t target_bitrate_bps,
     last_bwe_log_time_ = now;
   }
 
+  int64_t start_us = clock_->TimeInMicroseconds();
   ObserverAllocation allocation = AllocateBitrates(target_bitrate_bps);
-
-  for (auto& config : bitrate_observer_configs_) {
-    uint32_t allocated_bitrate = allocation[config.observer];
-    uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
-        allocated_bitrate, last_fraction_loss_, last_rtt_,
-        last_bwe_period_ms_);
-
-    if (allocated_bitrate == 0 && config.allocated_bitrate_bps > 0) {
-      if (target_bitrate_bps > 0)
-        ++num_pause_events_;
-      // The protection bitrate is an estimate based on the ratio between media
-      // and protection used before this observer was muted.
-      uint32_t predicted_protection_bps =
-          (1.0 - config.media_ratio) * config.min_bitrate_bps;
-      RTC_LOG(LS_INFO) << "Pausing observer " << config.observer
-                       << " with configured min bitrate "
-                       << config.min_bitrate_bps << " and current estimate of "
-                       << target_bitrate_bps << " and protection bitrate "
-                       << predicted_protection_bps;
-    } else if (allocated_bitrate > 0 && config.allocated_bitrate_bps == 0) {
-      if (target_bitrate_bps > 0)
-        ++num_pause_events_;
-      RTC_LOG(LS_INFO) << "Resuming observer " << config.observer
-                       << ", configured min bitrate " << config.min_bitrate_bps
-                       << ", current allocation " << allocated_bitrate
-                       << " and protection bitrate " << protection_bitrate;
-    }
-
-    // Only update the media ratio if the observer got an allocation.
-    if (allocated_bitrate > 0)
-      config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
-    config.allocated_bitrate_bps = allocated_bitrate;
-  }
+  // Observers adapt their protection to each network update, so all of them
+  // are notified, even if their allocation stays the same.
+  NotifyObservers(allocation, true);
   UpdateAllocationLimits();
+  PublishAllocationSnapshot();
+  // Includes the time the observers spend handling their new bitrate.
+  RTC_HISTOGRAM_COUNTS_100000("WebRTC.Call.BitrateAllocationTimeUs",
+                              clock_->TimeInMicroseconds() - start_us);
 }
 
 void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
@@ -163,28 +179,94 @@ void BitrateAllocator::AddObserver(BitrateAllocatorObserver* observer,
         config.bitrate_priority, config.has_packet_feedback));
   }
 
-  ObserverAllocation allocation;
   if (last_bitrate_bps_ > 0) {
-    // Calculate a new allocation and update all observers.
-    allocation = AllocateBitrates(last_bitrate_bps_);
-    for (auto& config : bitrate_observer_configs_) {
-      uint32_t allocated_bitrate = allocation[config.observer];
-      uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
-          allocated_bitrate, last_fraction_loss_, last_rtt_,
-          last_bwe_period_ms_);
-      config.allocated_bitrate_bps = allocated_bitrate;
-      if (allocated_bitrate > 0)
-        config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
-    }
+    // Calculate a new allocation. The network hasn't changed, so only the
+    // observers whose allocation did need to hear about it.
+    NotifyObservers(AllocateBitrates(last_bitrate_bps_), false);
   } else {
     // Currently, an encoder is not allowed to produce frames.
     // But we still have to return the initial config bitrate + let the
     // observer know that it can not produce frames.
-    allocation = AllocateBitrates(last_non_zero_bitrate_bps_);
     observer->OnBitrateUpdated(0, last_fraction_loss_, last_rtt_,
                                last_bwe_period_ms_);
   }
   UpdateAllocationLimits();
+  PublishAllocationSnapshot();
+}
+
+void BitrateAllocator::NotifyObservers(const ObserverAllocation& allocation,
+                                       bool notify_all) {
+  for (auto& config : bitrate_observer_configs_) {
+    auto allocation_it = allocation.find(config.observer);
+    uint32_t allocated_bitrate =
+        allocation_it == allocation.end() ? 0 : allocation_it->second;
+    if (!notify_all &&
+        static_cast<int64_t>(allocated_bitrate) == config.allocated_bitrate_bps)
+      continue;
+
+    uint32_t protection_bitrate = config.observer->OnBitrateUpdated(
+        allocated_bitrate, last_fraction_loss_, last_rtt_,
+        last_bwe_period_ms_);
+
+    if (allocated_bitrate == 0 && config.allocated_bitrate_bps > 0) {
+      if (last_bitrate_bps_ > 0)
+        ++num_pause_events_;
+      // The protection bitrate is an estimate based on the ratio between media
+      // and protection used before this observer was muted.
+      uint32_t predicted_protection_bps =
+          (1.0 - config.media_ratio) * config.min_bitrate_bps;
+      RTC_LOG(LS_INFO) << "Pausing observer " << config.observer
+                       << " with configured min bitrate "
+                       << config.min_bitrate_bps << " and current estimate of "
+                       << last_bitrate_bps_ << " and protection bitrate "
+                       << predicted_protection_bps;
+    } else if (allocated_bitrate > 0 && config.allocated_bitrate_bps == 0) {
+      if (last_bitrate_bps_ > 0)
+        ++num_pause_events_;
+      RTC_LOG(LS_INFO) << "Resuming observer " << config.observer
+                       << ", configured min bitrate " << config.min_bitrate_bps
+                       << ", current allocation " << allocated_bitrate
+                       << " and protection bitrate " << protection_bitrate;
+    }
+
+    // Only update the media ratio if the observer got an allocation.
+    if (allocated_bitrate > 0)
+      config.media_ratio = MediaRatio(allocated_bitrate, protection_bitrate);
+    config.allocated_bitrate_bps = allocated_bitrate;
+  }
+}
+
+void BitrateAllocator::PublishAllocationSnapshot() {
+  BitrateAllocationSnapshot::Allocations allocations;
+  allocations.reserve(bitrate_observer_configs_.size());
+  for (const auto& config : bitrate_observer_configs_) {
+    allocations.emplace_back(
+        config.observer,
+        static_cast<uint32_t>(std::max<int64_t>(0, config.allocated_bitrate_bps)));
+  }
+  std::sort(allocations.begin(), allocations.end());
+  const BitrateAllocationSnapshot* snapshot =
+      new rtc::RefCountedObject<BitrateAllocationSnapshot>(
+          ++snapshot_version_, last_bitrate_bps_, last_fraction_loss_,
+          last_rtt_, last_bwe_period_ms_, std::move(allocations));
+  snapshot->AddRef();
+  const BitrateAllocationSnapshot* old_snapshot = snapshot_;
+  rtc::AtomicOps::ReleaseStorePtr(&snapshot_, snapshot);
+  // Readers that loaded |old_snapshot| may not have taken their reference
+  // yet. They only need a moment to do so. The compare-and-swap is a full
+  // barrier, so the store above can't be reordered past the count check.
+  while (rtc::AtomicOps::CompareAndSwap(&snapshot_readers_, 0, 0) != 0)
+    rtc::YieldCurrentThread();
+  old_snapshot->Release();
+}
+
+rtc::scoped_refptr<const BitrateAllocationSnapshot>
+BitrateAllocator::GetAllocationSnapshot() const {
+  rtc::AtomicOps::Increment(&snapshot_readers_);
+  rtc::scoped_refptr<const BitrateAllocationSnapshot> snapshot(
+      rtc::AtomicOps::AcquireLoadPtr(&snapshot_));
+  rtc::AtomicOps::Decrement(&snapshot_readers_);
+  return snapshot;
 }
 
 void BitrateAllocator::UpdateAllocationLimits() {
@@ -238,6 +320,7 @@ void BitrateAllocator::RemoveObserver(BitrateAllocatorObserver* observer) {
   }
 
   UpdateAllocationLimits();
+  PublishAllocationSnapshot();
 }
 
 int BitrateAllocator::GetStartBitrate(BitrateAllocatorObserver* observer) {
@@ -20,6 +20,8 @@
 #include <vector>
 
 #include "rtc_base/bitrateallocationstrategy.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/sequenced_task_checker.h"
 
 namespace webrtc {
@@ -67,6 +69,44 @@ struct MediaStreamAllocationConfig {
   bool has_packet_feedback;
 };
 
+// The result of one bitrate allocation, together with the network state it
+// was made for. Immutable, so it can be read from any thread.
+class BitrateAllocationSnapshot : public rtc::RefCountInterface {
+ public:
+  typedef std::vector<std::pair<const BitrateAllocatorObserver*, uint32_t>>
+      Allocations;
+
+  // |allocations| must be sorted by observer.
+  BitrateAllocationSnapshot(int64_t version,
+                            uint32_t target_bitrate_bps,
+                            uint8_t fraction_loss,
+                            int64_t rtt,
+                            int64_t bwe_period_ms,
+                            Allocations allocations);
+
+  // Incremented for every new snapshot of the same allocator.
+  int64_t version() const { return version_; }
+  uint32_t target_bitrate_bps() const { return target_bitrate_bps_; }
+  uint8_t fraction_loss() const { return fraction_loss_; }
+  int64_t rtt() const { return rtt_; }
+  int64_t bwe_period_ms() const { return bwe_period_ms_; }
+  size_t num_observers() const { return allocations_.size(); }
+
+  // Returns 0 if |observer| isn't part of the allocation.
+  uint32_t GetAllocatedBitrate(const BitrateAllocatorObserver* observer) const;
+
+ protected:
+  ~BitrateAllocationSnapshot() override;
+
+ private:
+  const int64_t version_;
+  const uint32_t target_bitrate_bps_;
+  const uint8_t fraction_loss_;
+  const int64_t rtt_;
+  const int64_t bwe_period_ms_;
+  const Allocations allocations_;
+};
+
 // Interface used for mocking
 class BitrateAllocatorInterface {
  public:
@@ -107,7 +147,8 @@ class BitrateAllocator : public BitrateAllocatorInterface {
                         int64_t bwe_period_ms);
 
   // Set the configuration used by the bandwidth management.
-  // |observer| updates bitrates if already in use.
+  // |observer| updates bitrates if already in use. Of the other observers,
+  // only those whose allocation changes as a result are notified.
   // |config| is the configuration to use for allocation.
   void AddObserver(BitrateAllocatorObserver* observer,
                    MediaStreamAllocationConfig config) override;
@@ -127,6 +168,11 @@ class BitrateAllocator : public BitrateAllocatorInterface {
       std::unique_ptr<rtc::BitrateAllocationStrategy>
           bitrate_allocation_strategy);
 
+  // Returns the latest allocation, as last given to the observers. Can be
+  // called on any thread and doesn't take any lock.
+  rtc::scoped_refptr<const BitrateAllocationSnapshot> GetAllocationSnapshot()
+      const;
+
  private:
   struct ObserverConfig : rtc::BitrateAllocationStrategy::TrackConfig {
     ObserverConfig(BitrateAllocatorObserver* observer,
@@ -168,6 +214,10 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   // calls LimitObserver::OnAllocationLimitsChanged.
   void UpdateAllocationLimits() RTC_RUN_ON(&sequenced_checker_);
 
+  // Replaces the snapshot returned by GetAllocationSnapshot() with the
+  // current allocation.
+  void PublishAllocationSnapshot() RTC_RUN_ON(&sequenced_checker_);
+
   typedef std::vector<ObserverConfig> ObserverConfigs;
   ObserverConfigs::iterator FindObserverConfig(
       const BitrateAllocatorObserver* observer) RTC_RUN_ON(&sequenced_checker_);
@@ -178,6 +228,11 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   ObserverAllocation AllocateBitrates(uint32_t bitrate)
       RTC_RUN_ON(&sequenced_checker_);
 
+  // Gives the observers their share of |allocation|. Unless |notify_all|,
+  // observers whose share is what they were last given are skipped.
+  void NotifyObservers(const ObserverAllocation& allocation, bool notify_all)
+      RTC_RUN_ON(&sequenced_checker_);
+
   // Allocates zero bitrate to all observers.
   ObserverAllocation ZeroRateAllocation() RTC_RUN_ON(&sequenced_checker_);
   // Allocates bitrate to observers when there isn't enough to allocate the
@@ -247,6 +302,14 @@ class BitrateAllocator : public BitrateAllocatorInterface {
   std::unique_ptr<rtc::BitrateAllocationStrategy> bitrate_allocation_strategy_
       RTC_GUARDED_BY(&sequenced_checker_);
   const uint8_t transmission_max_bitrate_multiplier_;
+
+  // Owns a reference to the latest snapshot. Written on the allocator's
+  // sequence and read from any thread, with atomic loads that need it mutable.
+  mutable const BitrateAllocationSnapshot* volatile snapshot_;
+  // Number of GetAllocationSnapshot() calls in progress. The previous snapshot
+  // is only released once a new one is published and this drops to zero.
+  mutable volatile int snapshot_readers_;
+  int64_t snapshot_version_ RTC_GUARDED_BY(&sequenced_checker_);
 };
 
 }  // namespace webrtc
@@ -10,12 +10,15 @@
 
 #include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "call/bitrate_allocator.h"
 #include "modules/bitrate_controller/include/bitrate_controller.h"
+#include "rtc_base/timeutils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
 
 using ::testing::NiceMock;
 using ::testing::_;
@@ -52,7 +55,8 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
         last_fraction_loss_(0),
         last_rtt_ms_(0),
         last_probing_interval_ms_(0),
-        protection_ratio_(0.0) {}
+        protection_ratio_(0.0),
+        num_updates_(0) {}
 
   void SetBitrateProtectionRatio(double protection_ratio) {
     protection_ratio_ = protection_ratio;
@@ -66,6 +70,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
     last_fraction_loss_ = fraction_loss;
     last_rtt_ms_ = rtt;
     last_probing_interval_ms_ = probing_interval_ms;
+    ++num_updates_;
     return bitrate_bps * protection_ratio_;
   }
   uint32_t last_bitrate_bps_;
@@ -73,6 +78,7 @@ class TestBitrateObserver : public BitrateAllocatorObserver {
   int64_t last_rtt_ms_;
   int last_probing_interval_ms_;
   double protection_ratio_;
+  int num_updates_;
 };
 
 namespace {
@@ -849,4 +855,114 @@ TEST_F(BitrateAllocatorTest, PriorityRateThreeObserversTwoAllocatedToMax) {
   allocator_->RemoveObserver(&observer_high);
 }
 
+TEST_F(BitrateAllocatorTest, ReconfigurationNotifiesOnlyChangedObservers) {
+  TestBitrateObserver observer_1;
+  TestBitrateObserver observer_2;
+  AddObserver(&observer_1, 100000, 1000000, 0, true, "", 1.0);
+  AddObserver(&observer_2, 100000, 1000000, 0, true, "", 1.0);
+  allocator_->OnNetworkChanged(500000, 0, 0, kDefaultProbingIntervalMs);
+  EXPECT_EQ(250000u, observer_1.last_bitrate_bps_);
+  EXPECT_EQ(250000u, observer_2.last_bitrate_bps_);
+  int updates_1 = observer_1.num_updates_;
+  int updates_2 = observer_2.num_updates_;
+
+  // Reconfiguring without changing the allocation reaches no one.
+  AddObserver(&observer_2, 100000, 1000000, 0, true, "", 1.0);
+  EXPECT_EQ(updates_1, observer_1.num_updates_);
+  EXPECT_EQ(updates_2, observer_2.num_updates_);
+
+  // A lower max for one observer moves bitrate to the other.
+  AddObserver(&observer_2, 100000, 150000, 0, true, "", 1.0);
+  EXPECT_EQ(updates_1 + 1, observer_1.num_updates_);
+  EXPECT_EQ(updates_2 + 1, observer_2.num_updates_);
+  EXPECT_EQ(350000u, observer_1.last_bitrate_bps_);
+  EXPECT_EQ(150000u, observer_2.last_bitrate_bps_);
+
+  // Everyone hears about network updates, even with an unchanged allocation.
+  allocator_->OnNetworkChanged(500000, 0, 50, kDefaultProbingIntervalMs);
+  EXPECT_EQ(updates_1 + 2, observer_1.num_updates_);
+  EXPECT_EQ(updates_2 + 2, observer_2.num_updates_);
+  EXPECT_EQ(50, observer_2.last_rtt_ms_);
+
+  allocator_->RemoveObserver(&observer_1);
+  allocator_->RemoveObserver(&observer_2);
+}
+
+TEST_F(BitrateAllocatorTest, PublishesAllocationSnapshots) {
+  TestBitrateObserver observer_1;
+  TestBitrateObserver observer_2;
+  rtc::scoped_refptr<const BitrateAllocationSnapshot> initial =
+      allocator_->GetAllocationSnapshot();
+  EXPECT_EQ(0u, initial->num_observers());
+
+  AddObserver(&observer_1, 100000, 1000000, 0, true, "", 1.0);
+  AddObserver(&observer_2, 100000, 1000000, 0, true, "", 1.0);
+  allocator_->OnNetworkChanged(600000, 10, 20, kDefaultProbingIntervalMs);
+  rtc::scoped_refptr<const BitrateAllocationSnapshot> snapshot =
+      allocator_->GetAllocationSnapshot();
+  EXPECT_GT(snapshot->version(), initial->version());
+  EXPECT_EQ(600000u, snapshot->target_bitrate_bps());
+  EXPECT_EQ(10, snapshot->fraction_loss());
+  EXPECT_EQ(20, snapshot->rtt());
+  EXPECT_EQ(kDefaultProbingIntervalMs, snapshot->bwe_period_ms());
+  EXPECT_EQ(2u, snapshot->num_observers());
+  EXPECT_EQ(300000u, snapshot->GetAllocatedBitrate(&observer_1));
+  EXPECT_EQ(300000u, snapshot->GetAllocatedBitrate(&observer_2));
+
+  // Earlier snapshots stay as they were.
+  allocator_->RemoveObserver(&observer_1);
+  EXPECT_EQ(2u, snapshot->num_observers());
+  EXPECT_EQ(300000u, snapshot->GetAllocatedBitrate(&observer_1));
+  rtc::scoped_refptr<const BitrateAllocationSnapshot> latest =
+      allocator_->GetAllocationSnapshot();
+  EXPECT_EQ(0u, latest->GetAllocatedBitrate(&observer_1));
+  EXPECT_EQ(300000u, latest->GetAllocatedBitrate(&observer_2));
+
+  allocator_->RemoveObserver(&observer_2);
+}
+
+// Reports the time to allocate between many observers and notify them, for a
+// changed estimate and for one observer at a time changing its config.
+TEST_F(BitrateAllocatorTest, DISABLED_AllocationLatencyBenchmark) {
+  const int kObservers = 500;
+  const int kUpdates = 2000;
+  const uint32_t kMaxBitrateBps = 1000000;
+  std::vector<TestBitrateObserver> observers(kObservers);
+  for (TestBitrateObserver& observer : observers)
+    AddObserver(&observer, 30000, kMaxBitrateBps, 0, true, "", 1.0);
+
+  // Enough for everyone to be capped at their max.
+  const uint32_t kTargetBitrateBps = 4 * kObservers * kMaxBitrateBps;
+  int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kUpdates; ++i) {
+    allocator_->OnNetworkChanged(kTargetBitrateBps + (i % 2) * 1000, 0, 0,
+                                 kDefaultProbingIntervalMs);
+  }
+  int64_t estimate_us = rtc::TimeMicros() - start_us;
+
+  int num_updates = 0;
+  for (const TestBitrateObserver& observer : observers)
+    num_updates -= observer.num_updates_;
+  start_us = rtc::TimeMicros();
+  for (int i = 0; i < kUpdates; ++i) {
+    AddObserver(&observers[i % kObservers], 30000,
+                kMaxBitrateBps - (i / kObservers % 2) * 1000, 0, true, "", 1.0);
+  }
+  int64_t reconfigure_us = rtc::TimeMicros() - start_us;
+  for (const TestBitrateObserver& observer : observers)
+    num_updates += observer.num_updates_;
+
+  const std::string trace = std::to_string(kObservers) + "_observers";
+  test::PrintResult("bitrate_allocation_time", "_estimate", trace,
+                    static_cast<double>(estimate_us) / kUpdates, "us", false);
+  test::PrintResult("bitrate_allocation_time", "_reconfiguration", trace,
+                    static_cast<double>(reconfigure_us) / kUpdates, "us",
+                    false);
+  test::PrintResult("notified_observers", "_reconfiguration", trace,
+                    static_cast<double>(num_updates) / kUpdates, "observers",
+                    false);
+  for (TestBitrateObserver& observer : observers)
+    allocator_->RemoveObserver(&observer);
+}
+
 }  // namespace webrtc
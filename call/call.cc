@@ -49,6 +49,7 @@
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/memory_account.h"
 #include "rtc_base/numerics/safe_minmax.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/rate_limiter.h"
@@ -63,6 +64,7 @@
 #include "system_wrappers/include/metrics.h"
 #include "video/call_stats.h"
 #include "video/send_delay_stats.h"
+#include "video/shared_video_stream_encoder.h"
 #include "video/stats_counter.h"
 #include "video/video_receive_stream.h"
 #include "video/video_send_stream.h"
@@ -208,6 +210,9 @@ class Call final : public webrtc::Call,
 
   RtpTransportControllerSendInterface* GetTransportControllerSend() override;
 
+  RtpStreamReceiverControllerInterface* GetRtpStreamReceiverController(
+      MediaType media_type) override;
+
   Stats GetStats() const override;
 
   // Implements PacketReceiver.
@@ -323,6 +328,9 @@ class Call final : public webrtc::Call,
   std::map<uint32_t, VideoSendStream*> video_send_ssrcs_
       RTC_GUARDED_BY(send_crit_);
   std::set<VideoSendStream*> video_send_streams_ RTC_GUARDED_BY(send_crit_);
+  // By VideoSendStream::Config::EncoderSettings::shared_encoder_id.
+  std::map<std::string, rtc::scoped_refptr<SharedVideoStreamEncoder>>
+      shared_video_encoders_ RTC_GUARDED_BY(configuration_sequence_checker_);
 
   using RtpStateMap = std::map<uint32_t, RtpState>;
   RtpStateMap suspended_audio_send_ssrcs_
@@ -336,6 +344,10 @@ class Call final : public webrtc::Call,
 
   webrtc::RtcEventLog* event_log_;
 
+  // The buffers of the streams of the call report their memory usage here.
+  // Thread safe.
+  rtc::MemoryAccount memory_account_;
+
   // The following members are only accessed (exclusively) from one thread and
   // from the destructor, and therefore doesn't need any explicit
   // synchronization.
@@ -388,7 +400,8 @@ std::string Call::Stats::ToString(int64_t time_ms) const {
   ss << "recv_bw_bps: " << recv_bandwidth_bps << ", ";
   ss << "max_pad_bps: " << max_padding_bitrate_bps << ", ";
   ss << "pacer_delay_ms: " << pacer_delay_ms << ", ";
-  ss << "rtt_ms: " << rtt_ms;
+  ss << "rtt_ms: " << rtt_ms << ", ";
+  ss << "memory_usage_bytes: " << memory_usage_bytes;
   ss << '}';
   return ss.str();
 }
@@ -416,6 +429,11 @@ VideoSendStream* Call::CreateVideoSendStream(
   return nullptr;
 }
 
+RtpStreamReceiverControllerInterface* Call::GetRtpStreamReceiverController(
+    MediaType media_type) {
+  return nullptr;
+}
+
 namespace internal {
 
 Call::Call(const Call::Config& config,
@@ -723,16 +741,28 @@ webrtc::VideoSendStream* Call::CreateVideoSendStream(
   // Copy ssrcs from |config| since |config| is moved.
   std::vector<uint32_t> ssrcs = config.rtp.ssrcs;
 
+  rtc::scoped_refptr<SharedVideoStreamEncoder> shared_encoder;
+  if (!config.encoder_settings.shared_encoder_id.empty()) {
+    rtc::scoped_refptr<SharedVideoStreamEncoder>& encoder =
+        shared_video_encoders_[config.encoder_settings.shared_encoder_id];
+    if (!encoder) {
+      encoder = SharedVideoStreamEncoder::Create(
+          num_cpu_cores_, clock_, config, encoder_config.content_type);
+    }
+    shared_encoder = encoder;
+  }
+
   // TODO(srte): VideoSendStream should call GetWorkerQueue directly rather than
   // having it injected.
   VideoSendStream* send_stream = new VideoSendStream(
       num_cpu_cores_, module_process_thread_.get(),
       transport_send_ptr_->GetWorkerQueue(), call_stats_.get(),
       transport_send_ptr_, bitrate_allocator_.get(),
-      video_send_delay_stats_.get(), event_log_, std::move(config),
+      video_send_delay_stats_.get(), event_log_, &memory_account_,
+      std::move(config),
       std::move(encoder_config), suspended_video_send_ssrcs_,
       suspended_video_payload_states_, std::move(fec_controller),
-      &retransmission_rate_limiter_);
+      &retransmission_rate_limiter_, std::move(shared_encoder));
 
   {
     WriteLockScoped write_lock(*send_crit_);
@@ -798,6 +828,15 @@ void Call::DestroyVideoSendStream(webrtc::VideoSendStream* send_stream) {
 
   UpdateAggregateNetworkState();
   delete send_stream_impl;
+
+  // The encoders that the destroyed stream was the last to share.
+  for (auto it = shared_video_encoders_.begin();
+       it != shared_video_encoders_.end();) {
+    if (it->second->HasStreams())
+      ++it;
+    else
+      it = shared_video_encoders_.erase(it);
+  }
 }
 
 webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
@@ -808,7 +847,7 @@ webrtc::VideoReceiveStream* Call::CreateVideoReceiveStream(
   VideoReceiveStream* receive_stream = new VideoReceiveStream(
       &video_receiver_controller_, num_cpu_cores_,
       transport_send_ptr_->packet_router(), std::move(configuration),
-      module_process_thread_.get(), call_stats_.get());
+      module_process_thread_.get(), call_stats_.get(), &memory_account_);
 
   const webrtc::VideoReceiveStream::Config& config = receive_stream->config();
   {
@@ -918,6 +957,18 @@ RtpTransportControllerSendInterface* Call::GetTransportControllerSend() {
   return transport_send_ptr_;
 }
 
+RtpStreamReceiverControllerInterface* Call::GetRtpStreamReceiverController(
+    MediaType media_type) {
+  switch (media_type) {
+    case MediaType::AUDIO:
+      return &audio_receiver_controller_;
+    case MediaType::VIDEO:
+      return &video_receiver_controller_;
+    default:
+      return nullptr;
+  }
+}
+
 Call::Stats Call::GetStats() const {
   // TODO(solenberg): Some test cases in EndToEndTest use this from a different
   // thread. Re-enable once that is fixed.
@@ -948,6 +999,11 @@ Call::Stats Call::GetStats() const {
     rtc::CritScope cs(&bitrate_crit_);
     stats.max_padding_bitrate_bps = configured_max_padding_bitrate_bps_;
   }
+
+  rtc::MemoryAccount::Usage memory_usage = memory_account_.GetUsage();
+  stats.memory_usage_bytes = memory_usage.total_bytes;
+  stats.memory_usage_bytes_by_category =
+      std::move(memory_usage.bytes_by_category);
   return stats;
 }
 
@@ -1257,6 +1313,16 @@ PacketReceiver::DeliveryStatus Call::DeliverRtp(MediaType media_type,
   ReadLockScoped read_lock(*receive_crit_);
   auto it = receive_rtp_config_.find(parsed_packet.Ssrc());
   if (it == receive_rtp_config_.end()) {
+    // Streams that are only forwarded have no receive stream.
+    RtpStreamReceiverController* controller =
+        media_type == MediaType::AUDIO ? &audio_receiver_controller_
+                                       : &video_receiver_controller_;
+    if (media_type != MediaType::ANY &&
+        controller->ForwardRtpPacket(parsed_packet)) {
+      received_bytes_per_second_counter_.Add(
+          static_cast<int>(parsed_packet.size()));
+      return DELIVERY_OK;
+    }
     RTC_LOG(LS_ERROR) << "receive_rtp_config_ lookup failed for ssrc "
                       << parsed_packet.Ssrc();
     // Destruction of the receive stream, including deregistering from the
@@ -11,6 +11,7 @@
 #define CALL_CALL_H_
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -19,6 +20,7 @@
 #include "call/audio_send_stream.h"
 #include "call/call_config.h"
 #include "call/flexfec_receive_stream.h"
+#include "call/rtp_stream_receiver_controller_interface.h"
 #include "call/rtp_transport_controller_send_interface.h"
 #include "call/video_receive_stream.h"
 #include "call/video_send_stream.h"
@@ -68,6 +70,10 @@ class Call {
     int recv_bandwidth_bps = 0;       // Estimated available receive bandwidth.
     int64_t pacer_delay_ms = 0;
     int64_t rtt_ms = -1;
+    // Memory used by the buffers of the streams of the call, in total and
+    // by category, see rtc_base/memory_account.h.
+    size_t memory_usage_bytes = 0;
+    std::map<std::string, size_t> memory_usage_bytes_by_category;
   };
 
   static Call* Create(const Call::Config& config);
@@ -120,6 +126,12 @@ class Call {
   // remove this method interface.
   virtual RtpTransportControllerSendInterface* GetTransportControllerSend() = 0;
 
+  // Gives access to the demuxing of received RTP packets of |media_type|, e.g.
+  // to add forwarding sinks. Packets of ssrcs without a receive stream are
+  // delivered to their forwarding sinks. Returns null if not supported.
+  virtual RtpStreamReceiverControllerInterface* GetRtpStreamReceiverController(
+      MediaType media_type);
+
   // Returns the call statistics, such as estimated send and receive bandwidth,
   // pacing delay, etc.
   virtual Stats GetStats() const = 0;
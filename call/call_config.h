@@ -47,7 +47,9 @@ struct CallConfig {
   // FecController to use for this call.
   FecControllerFactoryInterface* fec_controller_factory = nullptr;
 
-  // Network controller factory to use for this call.
+  // Network controller factory to use for this call, e.g. a
+  // BbrNetworkControllerFactory to use BBR. Defaults to goog_cc. The pacer
+  // enforces the congestion window of the created controllers.
   NetworkControllerFactoryInterface* network_controller_factory = nullptr;
 };
 
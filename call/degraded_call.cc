@@ -136,6 +136,11 @@ DegradedCall::GetTransportControllerSend() {
   return call_->GetTransportControllerSend();
 }
 
+RtpStreamReceiverControllerInterface*
+DegradedCall::GetRtpStreamReceiverController(MediaType media_type) {
+  return call_->GetRtpStreamReceiverController(media_type);
+}
+
 Call::Stats DegradedCall::GetStats() const {
   return call_->GetStats();
 }
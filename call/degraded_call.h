@@ -59,6 +59,8 @@ class DegradedCall : public Call, private Transport, private PacketReceiver {
   PacketReceiver* Receiver() override;
 
   RtpTransportControllerSendInterface* GetTransportControllerSend() override;
+  RtpStreamReceiverControllerInterface* GetRtpStreamReceiverController(
+      MediaType media_type) override;
 
   Stats GetStats() const override;
 
@@ -214,9 +214,18 @@ bool SimulatedNetwork::EnqueuePacket(PacketInFlightInfo packet) {
 }
 
 rtc::Optional<int64_t> SimulatedNetwork::NextDeliveryTimeUs() const {
+  rtc::CritScope crit(&process_lock_);
+  rtc::Optional<int64_t> next_time_us;
   if (!delay_link_.empty())
-    return delay_link_.begin()->arrival_time_us;
-  return rtc::nullopt;
+    next_time_us = delay_link_.front().arrival_time_us;
+  // The next packet on the capacity link moves to the delay link then, and
+  // may be lost or overtake the packets on the delay link.
+  if (!capacity_link_.empty() &&
+      (!next_time_us ||
+       capacity_link_.front().arrival_time_us < *next_time_us)) {
+    next_time_us = capacity_link_.front().arrival_time_us;
+  }
+  return next_time_us;
 }
 
 FakeNetworkPipe::StoredPacket::StoredPacket(NetworkPacket&& packet)
@@ -289,8 +298,13 @@ std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
     rtc::CritScope crit(&process_lock_);
     // Check the capacity link first.
     if (!capacity_link_.empty()) {
-      int64_t last_arrival_time_us =
-          delay_link_.empty() ? -1 : delay_link_.back().arrival_time_us;
+      int64_t last_arrival_time_us = -1;
+      for (auto it = delay_link_.rbegin(); it != delay_link_.rend(); ++it) {
+        if (it->arrival_time_us != PacketDeliveryInfo::kNotReceived) {
+          last_arrival_time_us = it->arrival_time_us;
+          break;
+        }
+      }
       bool needs_sort = false;
       while (!capacity_link_.empty() &&
              time_now_us >= capacity_link_.front().arrival_time_us) {
@@ -303,6 +317,10 @@ std::vector<PacketDeliveryInfo> SimulatedNetwork::DequeueDeliverablePackets(
         if ((bursting_ && random_.Rand<double>() < prob_loss_bursting) ||
             (!bursting_ && random_.Rand<double>() < prob_start_bursting)) {
           bursting_ = true;
+          // Queued behind the packets already on the delay link, so that the
+          // loss is reported in order.
+          packet.arrival_time_us = PacketDeliveryInfo::kNotReceived;
+          delay_link_.emplace_back(std::move(packet));
           continue;
         } else {
           bursting_ = false;
@@ -106,8 +106,12 @@ class NetworkSimulationInterface {
  public:
   virtual bool EnqueuePacket(PacketInFlightInfo packet_info) = 0;
   // Retrieves all packets that should be delivered by the given receive time.
+  // Packets lost on the link are returned with a |receive_time_us| of
+  // PacketDeliveryInfo::kNotReceived.
   virtual std::vector<PacketDeliveryInfo> DequeueDeliverablePackets(
       int64_t receive_time_us) = 0;
+  // The next time DequeueDeliverablePackets() should be called, if there are
+  // packets on the link.
   virtual rtc::Optional<int64_t> NextDeliveryTimeUs() const = 0;
   virtual ~NetworkSimulationInterface() = default;
 };
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_FLAT_SSRC_MAP_H_
+#define CALL_FLAT_SSRC_MAP_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+// An open-addressing hash map keyed by SSRC, intended for per-packet lookups.
+// Entries are stored inline in a single array and found by linear probing,
+// so a lookup is usually a single cache line access, in contrast to the
+// pointer chasing of a std::map. The table is kept at most half full.
+//
+// Pointers to values are invalidated by any insertion or removal.
+template <typename Value>
+class FlatSsrcMap {
+ public:
+  FlatSsrcMap() = default;
+  FlatSsrcMap(FlatSsrcMap&&) = default;
+  FlatSsrcMap& operator=(FlatSsrcMap&&) = default;
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Returns null if |ssrc| is not in the map.
+  Value* Find(uint32_t ssrc) {
+    if (slots_.empty())
+      return nullptr;
+    for (size_t i = HomeIndex(ssrc);; i = NextIndex(i)) {
+      Slot& slot = slots_[i];
+      if (!slot.occupied)
+        return nullptr;
+      if (slot.ssrc == ssrc)
+        return &slot.value;
+    }
+  }
+  const Value* Find(uint32_t ssrc) const {
+    return const_cast<FlatSsrcMap*>(this)->Find(ssrc);
+  }
+
+  // Inserts |value| for |ssrc| unless the map already has an entry for it.
+  // Returns the entry for |ssrc| and whether an insertion took place, like
+  // std::map::emplace().
+  std::pair<Value*, bool> Emplace(uint32_t ssrc, Value value) {
+    if (Value* existing = Find(ssrc))
+      return std::make_pair(existing, false);
+    if (2 * (size_ + 1) > slots_.size())
+      Rehash(slots_.empty() ? kMinCapacity : 2 * slots_.size());
+    size_t i = HomeIndex(ssrc);
+    while (slots_[i].occupied)
+      i = NextIndex(i);
+    Slot& slot = slots_[i];
+    slot.ssrc = ssrc;
+    slot.occupied = true;
+    slot.value = std::move(value);
+    ++size_;
+    return std::make_pair(&slot.value, true);
+  }
+
+  Value& operator[](uint32_t ssrc) { return *Emplace(ssrc, Value()).first; }
+
+  // Returns true if an entry was removed.
+  bool Erase(uint32_t ssrc) {
+    if (slots_.empty())
+      return false;
+    for (size_t i = HomeIndex(ssrc);; i = NextIndex(i)) {
+      if (!slots_[i].occupied)
+        return false;
+      if (slots_[i].ssrc == ssrc) {
+        EraseSlot(i);
+        return true;
+      }
+    }
+  }
+
+  // Removes every entry for which |predicate(ssrc, value)| returns true and
+  // returns the number of entries removed.
+  template <typename Predicate>
+  size_t EraseIf(Predicate predicate) {
+    std::vector<uint32_t> erased;
+    for (const Slot& slot : slots_) {
+      if (slot.occupied && predicate(slot.ssrc, slot.value))
+        erased.push_back(slot.ssrc);
+    }
+    for (uint32_t ssrc : erased)
+      Erase(ssrc);
+    return erased.size();
+  }
+
+  void Clear() {
+    slots_.clear();
+    size_ = 0;
+    log2_capacity_ = 0;
+  }
+
+ private:
+  static constexpr size_t kMinCapacity = 16;
+
+  struct Slot {
+    uint32_t ssrc = 0;
+    bool occupied = false;
+    Value value = Value();
+  };
+
+  size_t HomeIndex(uint32_t ssrc) const {
+    // Fibonacci hashing; spreads sequential SSRCs that some endpoints use.
+    // Only the high bits of the product depend on every bit of |ssrc|.
+    return static_cast<size_t>(static_cast<uint32_t>(ssrc * 2654435769u) >>
+                               (32 - log2_capacity_));
+  }
+  size_t NextIndex(size_t index) const {
+    return (index + 1) & (slots_.size() - 1);
+  }
+
+  void Rehash(size_t capacity) {
+    RTC_DCHECK_EQ(capacity & (capacity - 1), 0);
+    RTC_DCHECK_LE(capacity, size_t{1} << 31);
+    std::vector<Slot> old_slots(capacity);
+    old_slots.swap(slots_);
+    log2_capacity_ = 0;
+    while ((size_t{1} << log2_capacity_) < capacity)
+      ++log2_capacity_;
+    for (Slot& old_slot : old_slots) {
+      if (!old_slot.occupied)
+        continue;
+      size_t i = HomeIndex(old_slot.ssrc);
+      while (slots_[i].occupied)
+        i = NextIndex(i);
+      slots_[i] = std::move(old_slot);
+    }
+  }
+
+  // Backward shift deletion: moves later entries of the probe sequence into
+  // the hole so that lookups never need tombstones.
+  void EraseSlot(size_t hole) {
+    for (size_t i = NextIndex(hole); slots_[i].occupied; i = NextIndex(i)) {
+      const size_t home = HomeIndex(slots_[i].ssrc);
+      // Move the entry unless its home lies cyclically in (hole, i].
+      const bool in_place = hole <= i ? (hole < home && home <= i)
+                                      : (hole < home || home <= i);
+      if (!in_place) {
+        slots_[hole] = std::move(slots_[i]);
+        hole = i;
+      }
+    }
+    slots_[hole] = Slot();
+    --size_;
+  }
+
+  std::vector<Slot> slots_;
+  size_t size_ = 0;
+  // log2 of slots_.size(), or 0 while the map has no slots.
+  int log2_capacity_ = 0;
+};
+
+template <typename Value>
+constexpr size_t FlatSsrcMap<Value>::kMinCapacity;
+
+}  // namespace webrtc
+
+#endif  // CALL_FLAT_SSRC_MAP_H_
@@ -0,0 +1,108 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/flat_ssrc_map.h"
+
+#include <map>
+#include <string>
+
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+TEST(FlatSsrcMapTest, FindsInsertedValues) {
+  FlatSsrcMap<int> map;
+  EXPECT_TRUE(map.empty());
+  EXPECT_EQ(nullptr, map.Find(1));
+
+  EXPECT_TRUE(map.Emplace(1, 10).second);
+  EXPECT_TRUE(map.Emplace(0, 20).second);
+  EXPECT_EQ(2u, map.size());
+  ASSERT_NE(nullptr, map.Find(1));
+  EXPECT_EQ(10, *map.Find(1));
+  ASSERT_NE(nullptr, map.Find(0));
+  EXPECT_EQ(20, *map.Find(0));
+  EXPECT_EQ(nullptr, map.Find(2));
+}
+
+TEST(FlatSsrcMapTest, EmplaceKeepsExistingValue) {
+  FlatSsrcMap<std::string> map;
+  EXPECT_TRUE(map.Emplace(5, "a").second);
+  auto result = map.Emplace(5, "b");
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ("a", *result.first);
+  map[5] = "c";
+  EXPECT_EQ("c", *map.Find(5));
+  EXPECT_EQ(1u, map.size());
+}
+
+TEST(FlatSsrcMapTest, EraseRemovesOnlyTheGivenSsrc) {
+  FlatSsrcMap<int> map;
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc)
+    map.Emplace(ssrc, ssrc);
+  EXPECT_FALSE(map.Erase(100));
+  for (uint32_t ssrc = 0; ssrc < 100; ssrc += 2)
+    EXPECT_TRUE(map.Erase(ssrc));
+  EXPECT_EQ(50u, map.size());
+  for (uint32_t ssrc = 0; ssrc < 100; ++ssrc) {
+    if (ssrc % 2 == 0) {
+      EXPECT_EQ(nullptr, map.Find(ssrc));
+    } else {
+      ASSERT_NE(nullptr, map.Find(ssrc));
+      EXPECT_EQ(static_cast<int>(ssrc), *map.Find(ssrc));
+    }
+  }
+}
+
+TEST(FlatSsrcMapTest, EraseIfRemovesMatchingValues) {
+  FlatSsrcMap<int> map;
+  for (uint32_t ssrc = 1; ssrc <= 20; ++ssrc)
+    map.Emplace(ssrc, ssrc % 3);
+  size_t removed =
+      map.EraseIf([](uint32_t ssrc, int value) { return value == 0; });
+  EXPECT_EQ(6u, removed);
+  EXPECT_EQ(14u, map.size());
+  EXPECT_EQ(nullptr, map.Find(3));
+  EXPECT_NE(nullptr, map.Find(4));
+}
+
+TEST(FlatSsrcMapTest, MatchesStdMapUnderRandomOperations) {
+  Random random(0x5eed);
+  FlatSsrcMap<uint32_t> map;
+  std::map<uint32_t, uint32_t> reference;
+  for (int i = 0; i < 20000; ++i) {
+    // A small key range so that inserts, hits and erases all happen often.
+    const uint32_t ssrc = random.Rand(0, 500) * 0x10001;
+    switch (random.Rand(0, 2)) {
+      case 0: {
+        const uint32_t value = random.Rand<uint32_t>();
+        EXPECT_EQ(reference.emplace(ssrc, value).second,
+                  map.Emplace(ssrc, value).second);
+        break;
+      }
+      case 1:
+        EXPECT_EQ(reference.erase(ssrc) > 0, map.Erase(ssrc));
+        break;
+      default: {
+        const auto it = reference.find(ssrc);
+        const uint32_t* value = map.Find(ssrc);
+        ASSERT_EQ(it != reference.end(), value != nullptr);
+        if (value)
+          EXPECT_EQ(it->second, *value);
+      }
+    }
+    ASSERT_EQ(reference.size(), map.size());
+  }
+}
+
+}  // namespace
+}  // namespace webrtc
@@ -0,0 +1,428 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/network_emulation.h"
+
+#include <algorithm>
+#include <limits>
+#include <tuple>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/ptr_util.h"
+
+namespace webrtc {
+
+namespace {
+constexpr int64_t kNoEvent = std::numeric_limits<int64_t>::max();
+// The same as the default send interval of RemoteEstimatorProxy.
+constexpr int64_t kFeedbackIntervalUs = 100000;
+// Transport feedback has a header of about 20 bytes and 2 bytes per packet.
+constexpr size_t kFeedbackHeaderSize = 20;
+constexpr size_t kFeedbackSizePerPacket = 2;
+// The lowest rate a controlled flow sends at.
+constexpr int64_t kMinRateBps = 10000;
+}  // namespace
+
+struct NetworkEmulation::Flow {
+  FlowConfig config;
+  // Null for cross traffic.
+  std::unique_ptr<NetworkControllerInterface> controller;
+  int64_t process_interval_us = 0;
+  DataRate rate = DataRate::Zero();
+  int64_t next_sequence_number = 0;
+
+  // The sender side of controlled flows: the packets without feedback yet.
+  std::map<int64_t, SentPacket> in_flight;
+  DataSize in_flight_size = DataSize::Zero();
+
+  // The receiver side of controlled flows: the receive times of the packets
+  // received since the last feedback, by sequence number.
+  int64_t next_feedback_sequence_number = 0;
+  std::map<int64_t, int64_t> received;
+  // The feedback on the return path, by packet id. Each entry is a sequence
+  // number and a receive time, or kNotReceived.
+  std::unordered_map<uint64_t, std::vector<std::pair<int64_t, int64_t>>>
+      feedback_in_flight;
+
+  // Since the last sample.
+  DataSize sent_size = DataSize::Zero();
+  DataSize received_size = DataSize::Zero();
+  int64_t received_packets = 0;
+  int64_t lost_packets = 0;
+  int64_t delay_sum_us = 0;
+
+  std::vector<Sample> samples;
+};
+
+NetworkEmulation::FlowConfig::FlowConfig() = default;
+NetworkEmulation::FlowConfig::FlowConfig(const FlowConfig&) = default;
+NetworkEmulation::FlowConfig::~FlowConfig() = default;
+
+bool NetworkEmulation::Event::operator>(const Event& other) const {
+  // Samples come after the other events at the same time, to include them.
+  const bool sample = type == EventType::kSample;
+  const bool other_sample = other.type == EventType::kSample;
+  return std::tie(time_us, sample, order) >
+         std::tie(other.time_us, other_sample, other.order);
+}
+
+NetworkEmulation::NetworkEmulation(TimeDelta sample_interval)
+    : sample_interval_(sample_interval), random_(1) {
+  RTC_DCHECK(sample_interval_ > TimeDelta::Zero());
+  PostEvent(sample_interval_.us(), EventType::kSample, 0);
+}
+
+NetworkEmulation::~NetworkEmulation() = default;
+
+int NetworkEmulation::CreateLink(const SimulatedNetwork::Config& config) {
+  // Links are seeded by their id, so that runs are reproducible.
+  links_.push_back(
+      {rtc::MakeUnique<SimulatedNetwork>(config, links_.size() + 1), kNoEvent});
+  return static_cast<int>(links_.size() - 1);
+}
+
+void NetworkEmulation::SetLinkConfig(int link,
+                                     const SimulatedNetwork::Config& config) {
+  links_[link].network->SetConfig(config);
+}
+
+int NetworkEmulation::CreateFlow(const FlowConfig& config) {
+  RTC_DCHECK(!config.path.empty());
+  RTC_DCHECK(config.rate > DataRate::Zero());
+  auto flow = rtc::MakeUnique<Flow>();
+  flow->config = config;
+  flow->rate = config.rate;
+  int id = static_cast<int>(flows_.size());
+  flows_.push_back(std::move(flow));
+  PostEvent(std::max(now_us_, config.start_time.us()), EventType::kSend, id);
+  return id;
+}
+
+int NetworkEmulation::CreateControlledFlow(
+    const FlowConfig& config,
+    NetworkControllerFactoryInterface* factory) {
+  RTC_DCHECK(!config.return_path.empty());
+  int id = CreateFlow(config);
+  Flow* flow = flows_[id].get();
+  Timestamp start_time =
+      Timestamp::us(std::max(now_us_, config.start_time.us()));
+  NetworkControllerConfig controller_config;
+  controller_config.constraints.at_time = start_time;
+  controller_config.constraints.min_data_rate = DataRate::bps(kMinRateBps);
+  controller_config.starting_bandwidth = config.rate;
+  flow->controller = factory->Create(controller_config);
+  NetworkAvailability availability;
+  availability.at_time = start_time;
+  availability.network_available = true;
+  ApplyUpdate(flow, flow->controller->OnNetworkAvailability(availability));
+
+  flow->process_interval_us = factory->GetProcessInterval().us();
+  PostEvent(start_time.us() + flow->process_interval_us, EventType::kProcess,
+            id);
+  PostEvent(start_time.us() + kFeedbackIntervalUs, EventType::kFeedback, id);
+  return id;
+}
+
+void NetworkEmulation::RunFor(TimeDelta duration) {
+  const int64_t end_time_us = now_us_ + duration.us();
+  while (!events_.empty() && events_.top().time_us <= end_time_us) {
+    Event event = events_.top();
+    events_.pop();
+    now_us_ = event.time_us;
+    HandleEvent(event);
+  }
+  now_us_ = end_time_us;
+}
+
+const std::vector<NetworkEmulation::Sample>& NetworkEmulation::samples(
+    int flow) const {
+  return flows_[flow]->samples;
+}
+
+void NetworkEmulation::PostEvent(int64_t time_us, EventType type, int id) {
+  events_.push({time_us, next_event_order_++, type, id});
+}
+
+void NetworkEmulation::HandleEvent(const Event& event) {
+  switch (event.type) {
+    case EventType::kLink:
+      // Links can have several events pending, only the earliest counts.
+      if (event.time_us == links_[event.id].next_event_us) {
+        links_[event.id].next_event_us = kNoEvent;
+        ProcessLink(event.id);
+      }
+      break;
+    case EventType::kSend:
+      SendPacket(event.id);
+      break;
+    case EventType::kProcess: {
+      Flow* flow = flows_[event.id].get();
+      ProcessInterval msg;
+      msg.at_time = Now();
+      ApplyUpdate(flow, flow->controller->OnProcessInterval(msg));
+      PostEvent(now_us_ + flow->process_interval_us, EventType::kProcess,
+                event.id);
+      break;
+    }
+    case EventType::kFeedback:
+      SendFeedback(event.id);
+      PostEvent(now_us_ + kFeedbackIntervalUs, EventType::kFeedback, event.id);
+      break;
+    case EventType::kSample:
+      TakeSamples();
+      PostEvent(now_us_ + sample_interval_.us(), EventType::kSample, 0);
+      break;
+  }
+}
+
+void NetworkEmulation::ProcessLink(int link) {
+  SimulatedNetwork* network = links_[link].network.get();
+  for (const PacketDeliveryInfo& delivery :
+       network->DequeueDeliverablePackets(now_us_)) {
+    ForwardPacket(delivery.packet_id, delivery.receive_time_us);
+  }
+  rtc::Optional<int64_t> next_us = network->NextDeliveryTimeUs();
+  if (next_us && *next_us < links_[link].next_event_us) {
+    links_[link].next_event_us = std::max(*next_us, now_us_);
+    PostEvent(links_[link].next_event_us, EventType::kLink, link);
+  }
+}
+
+void NetworkEmulation::SendPacket(int flow_id) {
+  Flow* flow = flows_[flow_id].get();
+  const FlowConfig& config = flow->config;
+  if (config.on_time.IsFinite()) {
+    const int64_t period_us = (config.on_time + config.off_time).us();
+    const int64_t phase_us = (now_us_ - config.start_time.us()) % period_us;
+    if (phase_us >= config.on_time.us()) {
+      PostEvent(now_us_ + period_us - phase_us, EventType::kSend, flow_id);
+      return;
+    }
+  }
+
+  const uint64_t packet_id = next_packet_id_++;
+  const Packet& packet =
+      packets_
+          .emplace(packet_id,
+                   Packet{flow_id, false, 0, now_us_,
+                          static_cast<size_t>(config.packet_size.bytes()),
+                          flow->next_sequence_number++})
+          .first->second;
+  flow->sent_size += config.packet_size;
+  if (flow->controller) {
+    SentPacket sent_packet;
+    sent_packet.send_time = Now();
+    sent_packet.size = config.packet_size;
+    sent_packet.sequence_number = packet.sequence_number;
+    flow->in_flight.emplace(packet.sequence_number, sent_packet);
+    flow->in_flight_size += config.packet_size;
+    ApplyUpdate(flow, flow->controller->OnSentPacket(sent_packet));
+  }
+  EnqueueOnLink(config.path[0], packet_id, packet);
+
+  int64_t interval_us = (config.packet_size / flow->rate).us();
+  if (config.poisson && !flow->controller) {
+    interval_us = static_cast<int64_t>(
+        random_.Exponential(1.0 / std::max<int64_t>(interval_us, 1)));
+  }
+  PostEvent(now_us_ + interval_us, EventType::kSend, flow_id);
+}
+
+void NetworkEmulation::SendFeedback(int flow_id) {
+  Flow* flow = flows_[flow_id].get();
+  if (flow->received.empty())
+    return;
+  // Everything up to the last received packet is reported, the packets that
+  // haven't arrived as lost.
+  const int64_t last_sequence_number = flow->received.rbegin()->first;
+  std::vector<std::pair<int64_t, int64_t>> results;
+  for (int64_t sequence_number = flow->next_feedback_sequence_number;
+       sequence_number <= last_sequence_number; ++sequence_number) {
+    auto it = flow->received.find(sequence_number);
+    results.emplace_back(sequence_number,
+                         it == flow->received.end()
+                             ? PacketDeliveryInfo::kNotReceived
+                             : it->second);
+  }
+  flow->received.clear();
+  flow->next_feedback_sequence_number = last_sequence_number + 1;
+
+  const uint64_t packet_id = next_packet_id_++;
+  const Packet& packet =
+      packets_
+          .emplace(packet_id,
+                   Packet{flow_id, true, 0, now_us_,
+                          kFeedbackHeaderSize +
+                              kFeedbackSizePerPacket * results.size(),
+                          -1})
+          .first->second;
+  flow->feedback_in_flight.emplace(packet_id, std::move(results));
+  EnqueueOnLink(flow->config.return_path[0], packet_id, packet);
+}
+
+void NetworkEmulation::ForwardPacket(uint64_t packet_id,
+                                     int64_t receive_time_us) {
+  ++link_packets_;
+  auto it = packets_.find(packet_id);
+  RTC_DCHECK(it != packets_.end());
+  Packet& packet = it->second;
+  const Flow& flow = *flows_[packet.flow];
+  const std::vector<int>& path =
+      packet.feedback ? flow.config.return_path : flow.config.path;
+  if (receive_time_us == PacketDeliveryInfo::kNotReceived) {
+    HandleLostPacket(packet_id, packet);
+  } else if (++packet.hop < path.size()) {
+    EnqueueOnLink(path[packet.hop], packet_id, packet);
+    return;
+  } else if (packet.feedback) {
+    DeliverFeedback(packet_id, packet, receive_time_us);
+  } else {
+    DeliverPacket(packet, receive_time_us);
+  }
+  packets_.erase(it);
+}
+
+void NetworkEmulation::EnqueueOnLink(int link,
+                                     uint64_t packet_id,
+                                     const Packet& packet) {
+  SimulatedNetwork* network = links_[link].network.get();
+  if (!network->EnqueuePacket(
+          PacketInFlightInfo(packet.size, now_us_, packet_id))) {
+    // The queue of the link is full.
+    ++link_packets_;
+    HandleLostPacket(packet_id, packet);
+    packets_.erase(packet_id);
+    return;
+  }
+  rtc::Optional<int64_t> next_us = network->NextDeliveryTimeUs();
+  if (next_us && *next_us < links_[link].next_event_us) {
+    links_[link].next_event_us = std::max(*next_us, now_us_);
+    PostEvent(links_[link].next_event_us, EventType::kLink, link);
+  }
+}
+
+void NetworkEmulation::DeliverPacket(const Packet& packet,
+                                     int64_t receive_time_us) {
+  Flow* flow = flows_[packet.flow].get();
+  flow->received_size += DataSize::bytes(packet.size);
+  ++flow->received_packets;
+  flow->delay_sum_us += receive_time_us - packet.send_time_us;
+  // Packets that arrive after they were reported as lost are not reported
+  // again.
+  if (flow->controller &&
+      packet.sequence_number >= flow->next_feedback_sequence_number) {
+    flow->received.emplace(packet.sequence_number, receive_time_us);
+  }
+}
+
+void NetworkEmulation::DeliverFeedback(uint64_t packet_id,
+                                       const Packet& packet,
+                                       int64_t receive_time_us) {
+  Flow* flow = flows_[packet.flow].get();
+  auto feedback_it = flow->feedback_in_flight.find(packet_id);
+  RTC_DCHECK(feedback_it != flow->feedback_in_flight.end());
+  const auto& results = feedback_it->second;
+  RTC_DCHECK(!results.empty());
+
+  // Packets from before this feedback were covered by lost feedback, and
+  // are forgotten.
+  TransportPacketsFeedback feedback;
+  feedback.feedback_time = Timestamp::us(receive_time_us);
+  feedback.prior_in_flight = flow->in_flight_size;
+  auto sent_it = flow->in_flight.begin();
+  while (sent_it != flow->in_flight.end() &&
+         sent_it->first < results.front().first) {
+    flow->in_flight_size -= sent_it->second.size;
+    sent_it = flow->in_flight.erase(sent_it);
+  }
+  TransportLossReport loss_report;
+  loss_report.receive_time = feedback.feedback_time;
+  int64_t max_rtt_us = -1;
+  for (const auto& result : results) {
+    sent_it = flow->in_flight.find(result.first);
+    if (sent_it == flow->in_flight.end())
+      continue;
+    PacketResult packet_result;
+    packet_result.sent_packet = sent_it->second;
+    if (result.second == PacketDeliveryInfo::kNotReceived) {
+      ++loss_report.packets_lost_delta;
+    } else {
+      packet_result.receive_time = Timestamp::us(result.second);
+      ++loss_report.packets_received_delta;
+      max_rtt_us = std::max(
+          max_rtt_us, receive_time_us - sent_it->second.send_time.us());
+    }
+    feedback.packet_feedbacks.push_back(packet_result);
+    flow->in_flight_size -= sent_it->second.size;
+    flow->in_flight.erase(sent_it);
+  }
+  flow->feedback_in_flight.erase(feedback_it);
+  feedback.data_in_flight = flow->in_flight_size;
+  if (feedback.packet_feedbacks.empty())
+    return;
+
+  NetworkControllerInterface* controller = flow->controller.get();
+  ApplyUpdate(flow, controller->OnTransportPacketsFeedback(feedback));
+  // The loss and round trip time are otherwise learned from RTCP.
+  ApplyUpdate(flow, controller->OnTransportLossReport(loss_report));
+  if (max_rtt_us >= 0) {
+    RoundTripTimeUpdate rtt_update;
+    rtt_update.receive_time = feedback.feedback_time;
+    rtt_update.round_trip_time = TimeDelta::us(max_rtt_us);
+    ApplyUpdate(flow, controller->OnRoundTripTimeUpdate(rtt_update));
+  }
+}
+
+void NetworkEmulation::HandleLostPacket(uint64_t packet_id,
+                                        const Packet& packet) {
+  Flow* flow = flows_[packet.flow].get();
+  if (packet.feedback) {
+    flow->feedback_in_flight.erase(packet_id);
+  } else {
+    ++flow->lost_packets;
+  }
+}
+
+void NetworkEmulation::ApplyUpdate(Flow* flow,
+                                   const NetworkControlUpdate& update) {
+  // Probes and congestion windows are not emulated, the flows are paced at the
+  // target rate.
+  if (update.target_rate) {
+    flow->rate =
+        std::max(update.target_rate->target_rate, DataRate::bps(kMinRateBps));
+  }
+}
+
+void NetworkEmulation::TakeSamples() {
+  for (const auto& flow : flows_) {
+    Sample sample;
+    sample.at_time = Now();
+    sample.send_rate = flow->sent_size / sample_interval_;
+    sample.receive_rate = flow->received_size / sample_interval_;
+    sample.target_rate = flow->rate;
+    if (flow->received_packets > 0) {
+      sample.average_delay =
+          TimeDelta::us(flow->delay_sum_us / flow->received_packets);
+    }
+    const int64_t total_packets = flow->received_packets + flow->lost_packets;
+    if (total_packets > 0) {
+      sample.loss_ratio =
+          static_cast<double>(flow->lost_packets) / total_packets;
+    }
+    flow->samples.push_back(sample);
+    flow->sent_size = DataSize::Zero();
+    flow->received_size = DataSize::Zero();
+    flow->received_packets = 0;
+    flow->lost_packets = 0;
+    flow->delay_sum_us = 0;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_NETWORK_EMULATION_H_
+#define CALL_NETWORK_EMULATION_H_
+
+#include <map>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "api/transport/network_control.h"
+#include "api/transport/network_types.h"
+#include "api/units/data_rate.h"
+#include "api/units/data_size.h"
+#include "api/units/time_delta.h"
+#include "api/units/timestamp.h"
+#include "call/fake_network_pipe.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/random.h"
+
+namespace webrtc {
+
+// Emulates many endpoints sending to each other over a network of
+// SimulatedNetwork links, in one process and on one thread. Time is simulated:
+// RunFor() jumps from event to event instead of waiting for a clock, so a
+// scenario runs as fast as the CPU allows and hundreds of flows can share the
+// bottleneck links. This is meant for benchmarks of the congestion controllers
+// and of the emulation itself.
+//
+// A flow sends packets of a fixed size from one endpoint to another over a
+// path of links. Cross traffic flows send at a constant rate, optionally
+// alternating between on and off periods. Controlled flows send at the target
+// rate of a NetworkControllerInterface and return transport feedback to it
+// over their return path, like transport-wide congestion control does. Every
+// |sample_interval| the rates, delay and loss of each flow are sampled.
+class NetworkEmulation {
+ public:
+  struct FlowConfig {
+    FlowConfig();
+    FlowConfig(const FlowConfig&);
+    ~FlowConfig();
+
+    // The links, as returned by CreateLink(), that the packets go through
+    // from the sender to the receiver.
+    std::vector<int> path;
+    // The links that transport feedback goes through from the receiver to the
+    // sender. Only used by controlled flows.
+    std::vector<int> return_path;
+    DataSize packet_size = DataSize::bytes(1200);
+    // The rate of cross traffic, and the start rate of controlled flows.
+    DataRate rate = DataRate::kbps(300);
+    Timestamp start_time = Timestamp::ms(0);
+    // Cross traffic sends for |on_time| and then pauses for |off_time|, over
+    // and over. The default sends all the time.
+    TimeDelta on_time = TimeDelta::PlusInfinity();
+    TimeDelta off_time = TimeDelta::Zero();
+    // Whether cross traffic is sent at exponentially distributed intervals,
+    // like the sum of many independent sources, instead of at a fixed one.
+    bool poisson = false;
+  };
+
+  struct Sample {
+    Timestamp at_time = Timestamp::Infinity();
+    DataRate send_rate = DataRate::Zero();
+    DataRate receive_rate = DataRate::Zero();
+    // The rate the flow was sending at, at |at_time|. For controlled flows
+    // this is the target rate of the controller.
+    DataRate target_rate = DataRate::Zero();
+    // The mean one-way delay of the packets received since the last sample.
+    TimeDelta average_delay = TimeDelta::Zero();
+    // The share of the packets lost since the last sample.
+    double loss_ratio = 0;
+  };
+
+  explicit NetworkEmulation(TimeDelta sample_interval);
+  ~NetworkEmulation();
+
+  // Returns the id of the new link.
+  int CreateLink(const SimulatedNetwork::Config& config);
+  // Changes the link for the packets that enter it from now on.
+  void SetLinkConfig(int link, const SimulatedNetwork::Config& config);
+
+  // Returns the id of a new cross traffic flow.
+  int CreateFlow(const FlowConfig& config);
+  // Returns the id of a new flow whose rate is controlled by a controller
+  // from |factory|, which must outlive the emulation.
+  int CreateControlledFlow(const FlowConfig& config,
+                           NetworkControllerFactoryInterface* factory);
+
+  // Runs the emulation until Now() + |duration|.
+  void RunFor(TimeDelta duration);
+
+  Timestamp Now() const { return Timestamp::us(now_us_); }
+  const std::vector<Sample>& samples(int flow) const;
+  // The number of packets that have gone through a link, over all links.
+  int64_t link_packets() const { return link_packets_; }
+
+ private:
+  enum class EventType { kLink, kSend, kProcess, kFeedback, kSample };
+  struct Event {
+    bool operator>(const Event& other) const;
+
+    int64_t time_us;
+    // Keeps the other events for the same time in the order they were
+    // posted.
+    uint64_t order;
+    EventType type;
+    int id;
+  };
+  struct Link {
+    std::unique_ptr<SimulatedNetwork> network;
+    // The earliest pending event for the link, or kNoEvent.
+    int64_t next_event_us;
+  };
+  struct Packet {
+    int flow;
+    bool feedback;
+    // Index into the flow's path or return path.
+    size_t hop;
+    int64_t send_time_us;
+    size_t size;
+    int64_t sequence_number;
+  };
+  struct Flow;
+
+  void PostEvent(int64_t time_us, EventType type, int id);
+  void HandleEvent(const Event& event);
+  void ProcessLink(int link);
+  void SendPacket(int flow);
+  void SendFeedback(int flow);
+  // Puts the packet on the next link of its path, or delivers it if it was
+  // the last one. A |receive_time_us| of kNotReceived means it was lost.
+  void ForwardPacket(uint64_t packet_id, int64_t receive_time_us);
+  void EnqueueOnLink(int link, uint64_t packet_id, const Packet& packet);
+  void DeliverPacket(const Packet& packet, int64_t receive_time_us);
+  void DeliverFeedback(uint64_t packet_id,
+                       const Packet& packet,
+                       int64_t receive_time_us);
+  void HandleLostPacket(uint64_t packet_id, const Packet& packet);
+  void ApplyUpdate(Flow* flow, const NetworkControlUpdate& update);
+  void TakeSamples();
+
+  const TimeDelta sample_interval_;
+  int64_t now_us_ = 0;
+  uint64_t next_event_order_ = 0;
+  uint64_t next_packet_id_ = 0;
+  int64_t link_packets_ = 0;
+  Random random_;
+  std::priority_queue<Event, std::vector<Event>, std::greater<Event>> events_;
+  std::vector<Link> links_;
+  std::vector<std::unique_ptr<Flow>> flows_;
+  std::unordered_map<uint64_t, Packet> packets_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(NetworkEmulation);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_NETWORK_EMULATION_H_
@@ -10,11 +10,18 @@
 
 #include "call/rampup_tests.h"
 
+#include "modules/congestion_controller/bbr/bbr_factory.h"
+#include "modules/congestion_controller/goog_cc/include/goog_cc_factory.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/platform_thread.h"
+#include "rtc_base/ptr_util.h"
 #include "rtc_base/stringencode.h"
 #include "test/encoder_settings.h"
+#include "test/fake_encoder.h"
+#include "test/field_trial.h"
+#include "test/function_video_encoder_factory.h"
 #include "test/gtest.h"
 #include "test/testsupport/perf_test.h"
 
@@ -58,6 +65,7 @@ RampUpTester::RampUpTester(size_t num_video_streams,
       sender_call_(nullptr),
       send_stream_(nullptr),
       send_transport_(nullptr),
+      network_controller_factory_(nullptr),
       start_bitrate_bps_(start_bitrate_bps),
       min_run_time_ms_(min_run_time_ms),
       expected_bitrate_bps_(0),
@@ -84,6 +92,7 @@ Call::Config RampUpTester::GetSenderCallConfig() {
     call_config.bitrate_config.start_bitrate_bps = start_bitrate_bps_;
   }
   call_config.bitrate_config.min_bitrate_bps = 10000;
+  call_config.network_controller_factory = network_controller_factory_;
   return call_config;
 }
 
@@ -557,6 +566,128 @@ void RampUpDownUpTester::EvolveTestState(int bitrate_bps, bool suspended) {
   }
 }
 
+// Ramps up a single stream over a bottleneck link with the given network
+// controller, to compare ramp-up time and network queue delay between
+// controllers.
+class RampUpBottleneckTester : public RampUpTester {
+ public:
+  explicit RampUpBottleneckTester(NetworkControllerFactoryInterface* factory)
+      : RampUpTester(1,
+                     0,
+                     0,
+                     0,
+                     0,
+                     RtpExtension::kTransportSequenceNumberUri,
+                     false,
+                     false,
+                     true) {
+    network_controller_factory_ = factory;
+    forward_transport_config_.link_capacity_kbps =
+        2 * kSingleStreamTargetBps / 1000;
+    forward_transport_config_.queue_delay_ms = 50;
+  }
+};
+
+// Ramps up a single stream, then caps the encoder well below the estimate for
+// a while so that the sender becomes application limited, and finally removes
+// the cap and reports how long it takes until the estimate is back at the
+// bitrate reached before the application limited period.
+class RampUpAlrRecoveryTester : public RampUpTester {
+ public:
+  explicit RampUpAlrRecoveryTester(const std::string& modifier)
+      : RampUpTester(1,
+                     0,
+                     0,
+                     0,
+                     0,
+                     RtpExtension::kTransportSequenceNumberUri,
+                     false,
+                     false,
+                     true),
+        modifier_(modifier),
+        encoder_factory_([this]() {
+          auto encoder = rtc::MakeUnique<test::FakeEncoder>(clock_);
+          rtc::CritScope lock(&crit_);
+          encoder_ = encoder.get();
+          return encoder;
+        }),
+        encoder_(nullptr),
+        test_state_(kRampUp),
+        state_start_ms_(clock_->TimeInMilliseconds()) {}
+
+ protected:
+  void ModifyVideoConfigs(
+      VideoSendStream::Config* send_config,
+      std::vector<VideoReceiveStream::Config>* receive_configs,
+      VideoEncoderConfig* encoder_config) override {
+    RampUpTester::ModifyVideoConfigs(send_config, receive_configs,
+                                     encoder_config);
+    send_config->encoder_settings.encoder_factory = &encoder_factory_;
+  }
+
+  void PollStats() override {
+    do {
+      if (sender_call_)
+        EvolveTestState(sender_call_->GetStats().send_bandwidth_bps);
+    } while (!stop_event_.Wait(kPollIntervalMs));
+  }
+
+ private:
+  enum TestStates {
+    kRampUp = 0,
+    kApplicationLimited,
+    kRecovery,
+    kTestEnd,
+  };
+
+  static const int kApplicationLimitedMaxKbps = 100;
+  static const int64_t kApplicationLimitedPeriodMs = 5000;
+
+  void SetEncoderMaxBitrate(int max_kbps) {
+    rtc::CritScope lock(&crit_);
+    if (encoder_)
+      encoder_->SetMaxBitrate(max_kbps);
+  }
+
+  void EvolveTestState(int bitrate_bps) {
+    int64_t now = clock_->TimeInMilliseconds();
+    switch (test_state_) {
+      case kRampUp:
+        if (bitrate_bps >= static_cast<int>(kSingleStreamTargetBps)) {
+          SetEncoderMaxBitrate(kApplicationLimitedMaxKbps);
+          test_state_ = kApplicationLimited;
+          state_start_ms_ = now;
+        }
+        break;
+      case kApplicationLimited:
+        if (now - state_start_ms_ >= kApplicationLimitedPeriodMs) {
+          SetEncoderMaxBitrate(-1);
+          test_state_ = kRecovery;
+          state_start_ms_ = now;
+        }
+        break;
+      case kRecovery:
+        if (bitrate_bps >= static_cast<int>(kSingleStreamTargetBps)) {
+          webrtc::test::PrintResult("ramp_up_alr_recovery", modifier_,
+                                    "time_to_quality", now - state_start_ms_,
+                                    "ms", false);
+          test_state_ = kTestEnd;
+          observation_complete_.Set();
+        }
+        break;
+      case kTestEnd:
+        break;
+    }
+  }
+
+  const std::string modifier_;
+  rtc::CriticalSection crit_;
+  test::FunctionVideoEncoderFactory encoder_factory_;
+  test::FakeEncoder* encoder_ RTC_GUARDED_BY(crit_);
+  TestStates test_state_;
+  int64_t state_start_ms_;
+};
+
 class RampUpTest : public test::CallTest {
  public:
   RampUpTest() {}
@@ -677,4 +808,28 @@ TEST_F(RampUpTest, MAYBE_AudioTransportSequenceNumber) {
                     false);
   RunBaseTest(&test);
 }
+
+TEST_F(RampUpTest, GoogCcBottleneckTransportSequenceNumber) {
+  webrtc::RtcEventLogNullImpl event_log;
+  GoogCcNetworkControllerFactory factory(&event_log);
+  RampUpBottleneckTester test(&factory);
+  RunBaseTest(&test);
+}
+
+TEST_F(RampUpTest, BbrBottleneckTransportSequenceNumber) {
+  BbrNetworkControllerFactory factory;
+  RampUpBottleneckTester test(&factory);
+  RunBaseTest(&test);
+}
+
+TEST_F(RampUpTest, AlrRecoveryTransportSequenceNumber) {
+  RampUpAlrRecoveryTester test("");
+  RunBaseTest(&test);
+}
+
+TEST_F(RampUpTest, AlrFastRecoveryTransportSequenceNumber) {
+  test::ScopedFieldTrials field_trial("WebRTC-BweAlrFastRecovery/Enabled/");
+  RampUpAlrRecoveryTester test("_fast_recovery");
+  RunBaseTest(&test);
+}
 }  // namespace webrtc
@@ -61,6 +61,10 @@ class RampUpTester : public test::EndToEndTest {
                     size_t value,
                     const std::string& units) const;
   void TriggerTestDone();
+  void ModifyVideoConfigs(
+      VideoSendStream::Config* send_config,
+      std::vector<VideoReceiveStream::Config>* receive_configs,
+      VideoEncoderConfig* encoder_config) override;
 
   webrtc::RtcEventLogNullImpl event_log_;
   rtc::Event stop_event_;
@@ -75,6 +79,8 @@ class RampUpTester : public test::EndToEndTest {
   Call* sender_call_;
   VideoSendStream* send_stream_;
   test::PacketTransport* send_transport_;
+  // Network controller of the sender call, or null for the default.
+  NetworkControllerFactoryInterface* network_controller_factory_;
 
  private:
   typedef std::map<uint32_t, uint32_t> SsrcMap;
@@ -87,10 +93,6 @@ class RampUpTester : public test::EndToEndTest {
   test::PacketTransport* CreateSendTransport(
       test::SingleThreadedTaskQueueForTesting* task_queue,
       Call* sender_call) override;
-  void ModifyVideoConfigs(
-      VideoSendStream::Config* send_config,
-      std::vector<VideoReceiveStream::Config>* receive_configs,
-      VideoEncoderConfig* encoder_config) override;
   void ModifyAudioConfigs(
       AudioSendStream::Config* send_config,
       std::vector<AudioReceiveStream::Config>* receive_configs) override;
@@ -23,7 +23,9 @@ namespace webrtc {
 RtpDemuxerCriteria::RtpDemuxerCriteria() = default;
 RtpDemuxerCriteria::~RtpDemuxerCriteria() = default;
 
-RtpDemuxer::RtpDemuxer() = default;
+RtpDemuxer::RtpDemuxer() {
+  sink_by_payload_type_.fill(nullptr);
+}
 
 RtpDemuxer::~RtpDemuxer() {
   RTC_DCHECK(sink_by_mid_.empty());
@@ -63,7 +65,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    sink_by_ssrc_.emplace(ssrc, sink);
+    sink_by_ssrc_.Emplace(ssrc, sink);
   }
 
   for (uint8_t payload_type : criteria.payload_types) {
@@ -71,6 +73,7 @@ bool RtpDemuxer::AddSink(const RtpDemuxerCriteria& criteria,
   }
 
   RefreshKnownMids();
+  RefreshPayloadTypeTable();
 
   return true;
 }
@@ -103,7 +106,7 @@ bool RtpDemuxer::CriteriaWouldConflict(
   }
 
   for (uint32_t ssrc : criteria.ssrcs) {
-    if (sink_by_ssrc_.find(ssrc) != sink_by_ssrc_.end()) {
+    if (sink_by_ssrc_.Find(ssrc)) {
       return true;
     }
   }
@@ -127,6 +130,18 @@ void RtpDemuxer::RefreshKnownMids() {
   }
 }
 
+void RtpDemuxer::RefreshPayloadTypeTable() {
+  sink_by_payload_type_.fill(nullptr);
+  for (auto it = sinks_by_pt_.begin(); it != sinks_by_pt_.end();) {
+    const auto range = sinks_by_pt_.equal_range(it->first);
+    // Ambiguous payload types are not used for demuxing.
+    if (std::next(range.first) == range.second) {
+      sink_by_payload_type_[range.first->first] = range.first->second;
+    }
+    it = range.second;
+  }
+}
+
 bool RtpDemuxer::AddSink(uint32_t ssrc, RtpPacketSinkInterface* sink) {
   RtpDemuxerCriteria criteria;
   criteria.ssrcs.insert(ssrc);
@@ -142,12 +157,16 @@ void RtpDemuxer::AddSink(const std::string& rsid,
 
 bool RtpDemuxer::RemoveSink(const RtpPacketSinkInterface* sink) {
   RTC_DCHECK(sink);
-  size_t num_removed = RemoveFromMapByValue(&sink_by_mid_, sink) +
-                       RemoveFromMapByValue(&sink_by_ssrc_, sink) +
-                       RemoveFromMultimapByValue(&sinks_by_pt_, sink) +
-                       RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
-                       RemoveFromMapByValue(&sink_by_rsid_, sink);
+  size_t num_removed =
+      RemoveFromMapByValue(&sink_by_mid_, sink) +
+      sink_by_ssrc_.EraseIf([sink](uint32_t, RtpPacketSinkInterface* bound) {
+        return bound == sink;
+      }) +
+      RemoveFromMultimapByValue(&sinks_by_pt_, sink) +
+      RemoveFromMapByValue(&sink_by_mid_and_rsid_, sink) +
+      RemoveFromMapByValue(&sink_by_rsid_, sink);
   RefreshKnownMids();
+  RefreshPayloadTypeTable();
   return num_removed > 0;
 }
 
@@ -185,30 +204,32 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
   // there isn't a rule/sink yet because we might add an MID/RSID rule after
   // learning an MID/RSID<->SSRC association.
 
+  // Latched IDs are only written when they change, since senders repeat the
+  // extensions on many packets.
   std::string* mid = nullptr;
   if (has_mid) {
-    mid_by_ssrc_[ssrc] = packet_mid;
+    std::string& latched_mid = mid_by_ssrc_[ssrc];
+    if (latched_mid != packet_mid) {
+      latched_mid = packet_mid;
+    }
     mid = &packet_mid;
   } else {
     // If the packet does not include a MID header extension, check if there is
     // a latched MID for the SSRC.
-    const auto it = mid_by_ssrc_.find(ssrc);
-    if (it != mid_by_ssrc_.end()) {
-      mid = &it->second;
-    }
+    mid = mid_by_ssrc_.Find(ssrc);
   }
 
   std::string* rsid = nullptr;
   if (has_rsid) {
-    rsid_by_ssrc_[ssrc] = packet_rsid;
+    std::string& latched_rsid = rsid_by_ssrc_[ssrc];
+    if (latched_rsid != packet_rsid) {
+      latched_rsid = packet_rsid;
+    }
     rsid = &packet_rsid;
   } else {
     // If the packet does not include an RRID/RSID header extension, check if
     // there is a latched RSID for the SSRC.
-    const auto it = rsid_by_ssrc_.find(ssrc);
-    if (it != rsid_by_ssrc_.end()) {
-      rsid = &it->second;
-    }
+    rsid = rsid_by_ssrc_.Find(ssrc);
   }
 
   // If MID and/or RSID is specified, prioritize that for demuxing the packet.
@@ -250,9 +271,9 @@ RtpPacketSinkInterface* RtpDemuxer::ResolveSink(
 
   // We trust signaled SSRC more than payload type which is likely to conflict
   // between streams.
-  const auto ssrc_sink_it = sink_by_ssrc_.find(ssrc);
-  if (ssrc_sink_it != sink_by_ssrc_.end()) {
-    return ssrc_sink_it->second;
+  RtpPacketSinkInterface* const* ssrc_sink = sink_by_ssrc_.Find(ssrc);
+  if (ssrc_sink) {
+    return *ssrc_sink;
   }
 
   // Legacy senders will only signal payload type, support that as last resort.
@@ -319,26 +340,31 @@ void RtpDemuxer::DeregisterRsidResolutionObserver(
 RtpPacketSinkInterface* RtpDemuxer::ResolveSinkByPayloadType(
     uint8_t payload_type,
     uint32_t ssrc) {
-  const auto range = sinks_by_pt_.equal_range(payload_type);
-  if (range.first != range.second) {
-    auto it = range.first;
-    const auto end = range.second;
-    if (std::next(it) == end) {
-      RtpPacketSinkInterface* sink = it->second;
-      bool notify = AddSsrcSinkBinding(ssrc, sink);
-      if (notify) {
-        for (auto* observer : ssrc_binding_observers_) {
-          observer->OnSsrcBoundToPayloadType(payload_type, ssrc);
-        }
+  RtpPacketSinkInterface* sink = sink_by_payload_type_[payload_type];
+  if (sink != nullptr) {
+    bool notify = AddSsrcSinkBinding(ssrc, sink);
+    if (notify) {
+      for (auto* observer : ssrc_binding_observers_) {
+        observer->OnSsrcBoundToPayloadType(payload_type, ssrc);
       }
-      return sink;
     }
   }
-  return nullptr;
+  return sink;
 }
 
 bool RtpDemuxer::AddSsrcSinkBinding(uint32_t ssrc,
                                     RtpPacketSinkInterface* sink) {
+  // Most packets of latched streams land here, so look for an existing
+  // binding before applying the limit to new ones.
+  RtpPacketSinkInterface** bound_sink = sink_by_ssrc_.Find(ssrc);
+  if (bound_sink != nullptr) {
+    if (*bound_sink != sink) {
+      *bound_sink = sink;
+      return true;
+    }
+    return false;
+  }
+
   if (sink_by_ssrc_.size() >= kMaxSsrcBindings) {
     RTC_LOG(LS_WARNING) << "New SSRC=" << ssrc
                         << " sink binding ignored; limit of" << kMaxSsrcBindings
@@ -346,17 +372,8 @@ bool RtpDemuxer::AddSsrcSinkBinding(uint32_t ssrc,
     return false;
   }
 
-  auto result = sink_by_ssrc_.emplace(ssrc, sink);
-  auto it = result.first;
-  bool inserted = result.second;
-  if (inserted) {
-    return true;
-  }
-  if (it->second != sink) {
-    it->second = sink;
-    return true;
-  }
-  return false;
+  sink_by_ssrc_.Emplace(ssrc, sink);
+  return true;
 }
 
 void RtpDemuxer::RegisterSsrcBindingObserver(SsrcBindingObserver* observer) {
@@ -11,12 +11,15 @@
 #ifndef CALL_RTP_DEMUXER_H_
 #define CALL_RTP_DEMUXER_H_
 
+#include <array>
 #include <map>
 #include <set>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "call/flat_ssrc_map.h"
+
 namespace webrtc {
 
 class RtpPacketReceived;
@@ -167,6 +170,9 @@ class RtpDemuxer {
   // sink_by_mid_and_rsid_ maps.
   void RefreshKnownMids();
 
+  // Regenerate sink_by_payload_type_ from sinks_by_pt_.
+  void RefreshPayloadTypeTable();
+
   // Map each sink by its component attributes to facilitate quick lookups.
   // Payload Type mapping is a multimap because if two sinks register for the
   // same payload type, both AddSinks succeed but we must know not to demux on
@@ -174,13 +180,18 @@ class RtpDemuxer {
   // Note: Mappings are only modified by AddSink/RemoveSink (except for
   // SSRC mapping which receives all MID, payload type, or RSID to SSRC bindings
   // discovered when demuxing packets).
+  // The SSRC mapping is consulted for most packets, so it is a flat hash map.
   std::map<std::string, RtpPacketSinkInterface*> sink_by_mid_;
-  std::map<uint32_t, RtpPacketSinkInterface*> sink_by_ssrc_;
+  FlatSsrcMap<RtpPacketSinkInterface*> sink_by_ssrc_;
   std::multimap<uint8_t, RtpPacketSinkInterface*> sinks_by_pt_;
   std::map<std::pair<std::string, std::string>, RtpPacketSinkInterface*>
       sink_by_mid_and_rsid_;
   std::map<std::string, RtpPacketSinkInterface*> sink_by_rsid_;
 
+  // Direct lookup table derived from sinks_by_pt_, holding the sink for each
+  // payload type that is bound to exactly one sink and null otherwise.
+  std::array<RtpPacketSinkInterface*, 256> sink_by_payload_type_;
+
   // Tracks all the MIDs that have been identified in added criteria. Used to
   // determine if a packet should be dropped right away because the MID is
   // unknown.
@@ -190,8 +201,8 @@ class RtpDemuxer {
   // received.
   // This is stored separately from the sink mappings because if a sink is
   // removed we want to still remember these associations.
-  std::map<uint32_t, std::string> mid_by_ssrc_;
-  std::map<uint32_t, std::string> rsid_by_ssrc_;
+  FlatSsrcMap<std::string> mid_by_ssrc_;
+  FlatSsrcMap<std::string> rsid_by_ssrc_;
 
   // Adds a binding from the SSRC to the given sink. Returns true if there was
   // not already a sink bound to the SSRC or if the sink replaced a different
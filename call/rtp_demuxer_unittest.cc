@@ -13,6 +13,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "call/ssrc_binding_observer.h"
 #include "call/test/mock_rtp_packet_sink_interface.h"
@@ -24,8 +25,10 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "rtc_base/ptr_util.h"
+#include "rtc_base/timeutils.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
 
 namespace webrtc {
 
@@ -1478,6 +1481,66 @@ TEST_F(RtpDemuxerTest, MaliciousPeerCannotCauseMemoryOveruse) {
   }
 }
 
+// Not a test, but a benchmark of the per-packet demux cost for sessions with
+// many streams. Sinks are either signaled by SSRC or, up to the SSRC binding
+// limit, latched from the first packet carrying their MID.
+TEST_F(RtpDemuxerTest, DISABLED_DemuxCostBySinkCount) {
+  class CountingSink : public RtpPacketSinkInterface {
+   public:
+    void OnRtpPacket(const RtpPacketReceived& packet) override { ++count_; }
+    int64_t count() const { return count_; }
+
+   private:
+    int64_t count_ = 0;
+  };
+
+  constexpr int kPacketsPerRun = 1000000;
+  for (bool by_mid : {false, true}) {
+    for (size_t num_sinks : {100, 1000, 10000}) {
+      // Every MID-bound stream needs an SSRC binding.
+      if (by_mid &&
+          num_sinks > static_cast<size_t>(RtpDemuxer::kMaxSsrcBindings))
+        continue;
+      RtpDemuxer demuxer;
+      std::vector<CountingSink> sinks(num_sinks);
+      std::vector<std::unique_ptr<RtpPacketReceived>> packets;
+      for (size_t i = 0; i < num_sinks; ++i) {
+        const uint32_t ssrc = static_cast<uint32_t>(i * 7919 + 1);
+        RtpDemuxerCriteria criteria;
+        if (by_mid) {
+          criteria.mid = "m" + std::to_string(i);
+        } else {
+          criteria.ssrcs.insert(ssrc);
+        }
+        ASSERT_TRUE(demuxer.AddSink(criteria, &sinks[i]));
+        if (by_mid) {
+          ASSERT_TRUE(demuxer.OnRtpPacket(
+              *CreatePacketWithSsrcMid(ssrc, criteria.mid)));
+        }
+        packets.push_back(CreatePacketWithSsrc(ssrc));
+      }
+
+      const int64_t start_ns = rtc::TimeNanos();
+      for (int i = 0; i < kPacketsPerRun; ++i)
+        demuxer.OnRtpPacket(*packets[i % packets.size()]);
+      const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+
+      int64_t delivered = 0;
+      for (const CountingSink& sink : sinks)
+        delivered += sink.count();
+      EXPECT_EQ(kPacketsPerRun + (by_mid ? num_sinks : 0),
+                static_cast<size_t>(delivered));
+      test::PrintResult("rtp_demuxer_time_per_packet",
+                        by_mid ? "_mid_bound" : "_ssrc_bound",
+                        std::to_string(num_sinks) + "_sinks",
+                        static_cast<double>(elapsed_ns) / kPacketsPerRun, "ns",
+                        false);
+      for (CountingSink& sink : sinks)
+        demuxer.RemoveSink(&sink);
+    }
+  }
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 
 TEST_F(RtpDemuxerTest, CriteriaMustBeNonEmpty) {
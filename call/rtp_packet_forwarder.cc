@@ -0,0 +1,154 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_packet_forwarder.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "modules/rtp_rtcp/include/rtp_rtcp.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ptr_util.h"
+
+namespace webrtc {
+namespace {
+
+const uint16_t kPictureIdMask15 = 0x7FFF;
+
+}  // namespace
+
+RtpPacketForwarder::RtpPacketForwarder(const Config& config, RtpRtcp* rtp_rtcp)
+    : extensions_(config.extensions),
+      vp8_payload_type_(config.vp8_payload_type),
+      clock_rate_hz_(config.clock_rate_hz),
+      storage_(config.storage),
+      rtp_rtcp_(rtp_rtcp),
+      new_mapping_(true),
+      new_picture_id_mapping_(true),
+      sequence_number_delta_(0),
+      timestamp_delta_(0),
+      picture_id_delta_(0),
+      has_forwarded_(false),
+      has_forwarded_picture_id_(false),
+      last_sequence_number_(0),
+      last_timestamp_(0),
+      last_picture_id_(0),
+      last_arrival_time_ms_(0) {
+  RTC_DCHECK(rtp_rtcp_);
+  RTC_DCHECK_GT(clock_rate_hz_, 0);
+}
+
+RtpPacketForwarder::~RtpPacketForwarder() = default;
+
+void RtpPacketForwarder::SwitchSource() {
+  rtc::CritScope lock(&crit_);
+  new_mapping_ = true;
+  new_picture_id_mapping_ = true;
+}
+
+void RtpPacketForwarder::OnRtpPacket(const RtpPacketReceived& packet) {
+  if (packet.payload_size() == 0)
+    return;
+
+  rtc::CopyOnWriteBuffer buffer = packet.Buffer();
+  const size_t payload_offset = packet.headers_size();
+  int picture_id_bits = 0;
+  size_t picture_id_offset = 0;
+  if (packet.PayloadType() == vp8_payload_type_) {
+    picture_id_offset =
+        FindVp8PictureId(buffer.cdata() + payload_offset,
+                         packet.payload_size(), &picture_id_bits);
+  }
+
+  uint16_t sequence_number;
+  uint32_t timestamp;
+  {
+    rtc::CritScope lock(&crit_);
+    if (new_mapping_) {
+      new_mapping_ = false;
+      if (has_forwarded_) {
+        // Advance the timestamp by the time since the last packet, and at
+        // least by one, so the receiver sees a new frame.
+        const int64_t elapsed_ms =
+            std::max<int64_t>(0, packet.arrival_time_ms() -
+                                     last_arrival_time_ms_);
+        const uint32_t timestamp_step = static_cast<uint32_t>(std::max<int64_t>(
+            1, elapsed_ms * clock_rate_hz_ / 1000));
+        sequence_number_delta_ =
+            last_sequence_number_ + 1 - packet.SequenceNumber();
+        timestamp_delta_ = last_timestamp_ + timestamp_step - packet.Timestamp();
+      }
+    }
+    sequence_number = packet.SequenceNumber() + sequence_number_delta_;
+    timestamp = packet.Timestamp() + timestamp_delta_;
+
+    if (picture_id_offset > 0) {
+      uint8_t* data = buffer.data() + payload_offset + picture_id_offset;
+      const uint16_t picture_id =
+          picture_id_bits == 15 ? ByteReader<uint16_t>::ReadBigEndian(data) &
+                                      kPictureIdMask15
+                                : data[0] & 0x7F;
+      if (new_picture_id_mapping_) {
+        new_picture_id_mapping_ = false;
+        if (has_forwarded_picture_id_)
+          picture_id_delta_ = last_picture_id_ + 1 - picture_id;
+      }
+      const uint16_t new_picture_id =
+          (picture_id + picture_id_delta_) & kPictureIdMask15;
+      if (picture_id_bits == 15) {
+        ByteWriter<uint16_t>::WriteBigEndian(data, 0x8000 | new_picture_id);
+      } else {
+        data[0] = new_picture_id & 0x7F;
+      }
+      has_forwarded_picture_id_ = true;
+      last_picture_id_ = new_picture_id;
+    }
+
+    has_forwarded_ = true;
+    last_sequence_number_ = sequence_number;
+    last_timestamp_ = timestamp;
+    last_arrival_time_ms_ = packet.arrival_time_ms();
+  }
+
+  auto send_packet = rtc::MakeUnique<RtpPacketToSend>(&extensions_);
+  if (!send_packet->Parse(std::move(buffer))) {
+    RTC_NOTREACHED();
+    return;
+  }
+  send_packet->SetSequenceNumber(sequence_number);
+  send_packet->SetTimestamp(timestamp);
+  send_packet->SetSsrc(rtp_rtcp_->SSRC());
+  send_packet->set_capture_time_ms(packet.arrival_time_ms());
+  if (!rtp_rtcp_->SendRtpPacket(std::move(send_packet), storage_)) {
+    RTC_LOG(LS_VERBOSE) << "Dropped forwarded packet, ssrc "
+                        << packet.Ssrc() << ", not sending.";
+  }
+}
+
+size_t RtpPacketForwarder::FindVp8PictureId(const uint8_t* payload,
+                                            size_t payload_size,
+                                            int* num_bits) {
+  // See RFC 7741, section 4.2: X|R|N|S|R|PID, then I|L|T|K|RSV if X.
+  if (payload_size < 3 || !(payload[0] & 0x80) || !(payload[1] & 0x80))
+    return 0;
+  const bool long_picture_id = payload[2] & 0x80;
+  if (long_picture_id && payload_size < 4)
+    return 0;
+  *num_bits = long_picture_id ? 15 : 7;
+  return 2;
+}
+
+}  // namespace webrtc
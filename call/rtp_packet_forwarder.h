@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef CALL_RTP_PACKET_FORWARDER_H_
+#define CALL_RTP_PACKET_FORWARDER_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "api/rtpparameters.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+class RtpRtcp;
+
+// Forwards received RTP packets to an RtpRtcp module without depacketizing
+// them, as an SFU does. Register it with
+// RtpStreamReceiverControllerInterface::AddForwardingSink() for the ssrc to
+// forward.
+//
+// The packets are sent on the module's SSRC() with the payload left
+// untouched, except for the VP8 PictureID which, like the sequence number and
+// the timestamp, is rewritten to continue without gaps when the forwarded
+// source changes, e.g. to another simulcast layer or another participant.
+// Header extensions are kept as is, so |extensions| must have the ids used
+// by both the incoming stream and the module.
+//
+// Padding-only packets are dropped; the module's own padding, preferably on
+// RTX, should be used for probing instead.
+class RtpPacketForwarder : public RtpPacketSinkInterface {
+ public:
+  struct Config {
+    std::vector<RtpExtension> extensions;
+    // Payload type of VP8, whose PictureID is rewritten. -1 if none.
+    int vp8_payload_type = -1;
+    int clock_rate_hz = 90000;
+    StorageType storage = kAllowRetransmission;
+  };
+
+  RtpPacketForwarder(const Config& config, RtpRtcp* rtp_rtcp);
+  ~RtpPacketForwarder() override;
+
+  // Starts a new mapping from the incoming to the outgoing sequence numbers,
+  // timestamps and PictureIDs at the next packet, which continues after the
+  // last packet forwarded. Must be called when the packets forwarded switch
+  // to another source.
+  void SwitchSource();
+
+  // Implements RtpPacketSinkInterface.
+  void OnRtpPacket(const RtpPacketReceived& packet) override;
+
+ private:
+  // Returns the offset of the PictureID in |payload| and sets |num_bits| to
+  // 7 or 15, or returns 0 if |payload| has none.
+  static size_t FindVp8PictureId(const uint8_t* payload,
+                                 size_t payload_size,
+                                 int* num_bits);
+
+  const RtpHeaderExtensionMap extensions_;
+  const int vp8_payload_type_;
+  const int clock_rate_hz_;
+  const StorageType storage_;
+  RtpRtcp* const rtp_rtcp_;
+
+  rtc::CriticalSection crit_;
+  // Whether the next packet starts a new mapping of sequence numbers and
+  // timestamps, and of PictureIDs.
+  bool new_mapping_ RTC_GUARDED_BY(crit_);
+  bool new_picture_id_mapping_ RTC_GUARDED_BY(crit_);
+  // Added to the incoming values.
+  uint16_t sequence_number_delta_ RTC_GUARDED_BY(crit_);
+  uint32_t timestamp_delta_ RTC_GUARDED_BY(crit_);
+  uint16_t picture_id_delta_ RTC_GUARDED_BY(crit_);
+  // Last packet forwarded, if any.
+  bool has_forwarded_ RTC_GUARDED_BY(crit_);
+  bool has_forwarded_picture_id_ RTC_GUARDED_BY(crit_);
+  uint16_t last_sequence_number_ RTC_GUARDED_BY(crit_);
+  uint32_t last_timestamp_ RTC_GUARDED_BY(crit_);
+  uint16_t last_picture_id_ RTC_GUARDED_BY(crit_);
+  int64_t last_arrival_time_ms_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(RtpPacketForwarder);
+};
+
+}  // namespace webrtc
+
+#endif  // CALL_RTP_PACKET_FORWARDER_H_
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/rtp_packet_forwarder.h"
+
+#include <vector>
+
+#include "call/rtp_stream_receiver_controller.h"
+#include "call/test/mock_rtp_packet_sink_interface.h"
+#include "modules/rtp_rtcp/mocks/mock_rtp_rtcp.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/random.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using ::testing::Return;
+
+constexpr int kVp8PayloadType = 100;
+constexpr uint32_t kIncomingSsrc = 0x11111111;
+constexpr uint32_t kOtherIncomingSsrc = 0x22222222;
+constexpr uint32_t kOutgoingSsrc = 0x33333333;
+constexpr int kTransportSequenceNumberId = 5;
+
+RtpPacketReceived CreateVp8Packet(uint32_t ssrc,
+                                  uint16_t sequence_number,
+                                  uint32_t timestamp,
+                                  int picture_id,
+                                  int64_t arrival_time_ms) {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransportSequenceNumber>(kTransportSequenceNumberId);
+  RtpPacketReceived packet(&extensions);
+  packet.SetPayloadType(kVp8PayloadType);
+  packet.SetSsrc(ssrc);
+  packet.SetSequenceNumber(sequence_number);
+  packet.SetTimestamp(timestamp);
+  packet.SetExtension<TransportSequenceNumber>(sequence_number);
+  uint8_t* payload = packet.AllocatePayload(5);
+  payload[0] = 0x90;  // X and S set.
+  payload[1] = 0x80;  // I set.
+  ByteWriter<uint16_t>::WriteBigEndian(payload + 2, 0x8000 | picture_id);
+  payload[4] = 0xab;
+  packet.set_arrival_time_ms(arrival_time_ms);
+  return packet;
+}
+
+uint16_t PictureId(const RtpPacketToSend& packet) {
+  return ByteReader<uint16_t>::ReadBigEndian(packet.payload().data() + 2) &
+         0x7FFF;
+}
+
+class RtpPacketForwarderTest : public ::testing::Test {
+ protected:
+  RtpPacketForwarderTest() : forwarder_(CreateConfig(), &rtp_rtcp_) {
+    ON_CALL(rtp_rtcp_, SSRC()).WillByDefault(Return(kOutgoingSsrc));
+    ON_CALL(rtp_rtcp_, SendRtpPacketMock(_, _))
+        .WillByDefault(
+            Invoke([this](RtpPacketToSend* packet, StorageType storage) {
+              sent_packets_.push_back(*packet);
+              return true;
+            }));
+  }
+
+  static RtpPacketForwarder::Config CreateConfig() {
+    RtpPacketForwarder::Config config;
+    config.extensions.emplace_back(RtpExtension::kTransportSequenceNumberUri,
+                                   kTransportSequenceNumberId);
+    config.vp8_payload_type = kVp8PayloadType;
+    return config;
+  }
+
+  NiceMock<MockRtpRtcp> rtp_rtcp_;
+  RtpPacketForwarder forwarder_;
+  std::vector<RtpPacketToSend> sent_packets_;
+};
+
+}  // namespace
+
+TEST_F(RtpPacketForwarderTest, ForwardsPacketOnModuleSsrc) {
+  forwarder_.OnRtpPacket(CreateVp8Packet(kIncomingSsrc, 1000, 5000, 10, 100));
+
+  ASSERT_EQ(1u, sent_packets_.size());
+  const RtpPacketToSend& sent = sent_packets_[0];
+  EXPECT_EQ(kOutgoingSsrc, sent.Ssrc());
+  EXPECT_EQ(1000, sent.SequenceNumber());
+  EXPECT_EQ(5000u, sent.Timestamp());
+  EXPECT_EQ(kVp8PayloadType, sent.PayloadType());
+  EXPECT_EQ(10, PictureId(sent));
+  EXPECT_EQ(0xab, sent.payload()[4]);
+  uint16_t transport_sequence_number = 0;
+  EXPECT_TRUE(
+      sent.GetExtension<TransportSequenceNumber>(&transport_sequence_number));
+  EXPECT_EQ(1000, transport_sequence_number);
+}
+
+TEST_F(RtpPacketForwarderTest, ContinuesNumberingAfterSwitchingSource) {
+  forwarder_.OnRtpPacket(CreateVp8Packet(kIncomingSsrc, 1000, 5000, 10, 100));
+  forwarder_.OnRtpPacket(CreateVp8Packet(kIncomingSsrc, 1001, 8000, 11, 133));
+
+  forwarder_.SwitchSource();
+  forwarder_.OnRtpPacket(
+      CreateVp8Packet(kOtherIncomingSsrc, 40000, 900000, 32000, 143));
+  forwarder_.OnRtpPacket(
+      CreateVp8Packet(kOtherIncomingSsrc, 40001, 903000, 32001, 176));
+
+  ASSERT_EQ(4u, sent_packets_.size());
+  EXPECT_EQ(1002, sent_packets_[2].SequenceNumber());
+  EXPECT_EQ(1003, sent_packets_[3].SequenceNumber());
+  // 10 ms after the last packet.
+  EXPECT_EQ(8000u + 900, sent_packets_[2].Timestamp());
+  EXPECT_EQ(8000u + 900 + 3000, sent_packets_[3].Timestamp());
+  EXPECT_EQ(12, PictureId(sent_packets_[2]));
+  EXPECT_EQ(13, PictureId(sent_packets_[3]));
+  for (const RtpPacketToSend& packet : sent_packets_)
+    EXPECT_EQ(kOutgoingSsrc, packet.Ssrc());
+}
+
+TEST_F(RtpPacketForwarderTest, DropsPaddingOnlyPackets) {
+  RtpPacketReceived padding;
+  padding.SetPayloadType(kVp8PayloadType);
+  padding.SetSsrc(kIncomingSsrc);
+  Random random(17);
+  padding.SetPadding(100, &random);
+  forwarder_.OnRtpPacket(padding);
+  EXPECT_TRUE(sent_packets_.empty());
+}
+
+TEST(RtpStreamReceiverControllerTest, DeliversToForwardingSinks) {
+  RtpStreamReceiverController controller;
+  MockRtpPacketSink receive_sink;
+  MockRtpPacketSink forwarding_sink;
+  MockRtpPacketSink other_forwarding_sink;
+  auto receiver = controller.CreateReceiver(kIncomingSsrc, &receive_sink);
+  controller.AddForwardingSink(kIncomingSsrc, &forwarding_sink);
+  controller.AddForwardingSink(kOtherIncomingSsrc, &forwarding_sink);
+  controller.AddForwardingSink(kOtherIncomingSsrc, &other_forwarding_sink);
+
+  EXPECT_CALL(receive_sink, OnRtpPacket(_));
+  EXPECT_CALL(forwarding_sink, OnRtpPacket(_)).Times(2);
+  EXPECT_CALL(other_forwarding_sink, OnRtpPacket(_));
+  EXPECT_TRUE(controller.OnRtpPacket(
+      CreateVp8Packet(kIncomingSsrc, 1, 1, 1, 1)));
+  // Not received, only forwarded.
+  EXPECT_TRUE(controller.ForwardRtpPacket(
+      CreateVp8Packet(kOtherIncomingSsrc, 1, 1, 1, 1)));
+
+  EXPECT_EQ(2u, controller.RemoveForwardingSink(&forwarding_sink));
+  EXPECT_EQ(0u, controller.RemoveForwardingSink(&forwarding_sink));
+  EXPECT_CALL(other_forwarding_sink, OnRtpPacket(_));
+  EXPECT_TRUE(controller.ForwardRtpPacket(
+      CreateVp8Packet(kOtherIncomingSsrc, 2, 1, 1, 1)));
+  EXPECT_FALSE(controller.ForwardRtpPacket(
+      CreateVp8Packet(kIncomingSsrc, 2, 1, 1, 1)));
+}
+
+}  // namespace webrtc
@@ -10,6 +10,9 @@
 
 #include "call/rtp_stream_receiver_controller.h"
 
+#include <algorithm>
+
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
 
@@ -52,7 +55,26 @@ RtpStreamReceiverController::CreateReceiver(
 
 bool RtpStreamReceiverController::OnRtpPacket(const RtpPacketReceived& packet) {
   rtc::CritScope cs(&lock_);
-  return demuxer_.OnRtpPacket(packet);
+  const bool forwarded = ForwardRtpPacketLocked(packet);
+  const bool demuxed = demuxer_.OnRtpPacket(packet);
+  return demuxed || forwarded;
+}
+
+bool RtpStreamReceiverController::ForwardRtpPacket(
+    const RtpPacketReceived& packet) {
+  rtc::CritScope cs(&lock_);
+  return ForwardRtpPacketLocked(packet);
+}
+
+bool RtpStreamReceiverController::ForwardRtpPacketLocked(
+    const RtpPacketReceived& packet) {
+  const std::vector<RtpPacketSinkInterface*>* sinks =
+      forwarding_sinks_by_ssrc_.Find(packet.Ssrc());
+  if (!sinks)
+    return false;
+  for (RtpPacketSinkInterface* sink : *sinks)
+    sink->OnRtpPacket(packet);
+  return true;
 }
 
 bool RtpStreamReceiverController::AddSink(uint32_t ssrc,
@@ -67,4 +89,33 @@ size_t RtpStreamReceiverController::RemoveSink(
   return demuxer_.RemoveSink(sink);
 }
 
+void RtpStreamReceiverController::AddForwardingSink(
+    uint32_t ssrc,
+    RtpPacketSinkInterface* sink) {
+  RTC_DCHECK(sink);
+  rtc::CritScope cs(&lock_);
+  forwarding_sinks_.emplace_back(ssrc, sink);
+  RebuildForwardingSinksBySsrc();
+}
+
+size_t RtpStreamReceiverController::RemoveForwardingSink(
+    const RtpPacketSinkInterface* sink) {
+  rtc::CritScope cs(&lock_);
+  const auto it = std::remove_if(
+      forwarding_sinks_.begin(), forwarding_sinks_.end(),
+      [sink](const std::pair<uint32_t, RtpPacketSinkInterface*>& entry) {
+        return entry.second == sink;
+      });
+  const size_t num_removed = std::distance(it, forwarding_sinks_.end());
+  forwarding_sinks_.erase(it, forwarding_sinks_.end());
+  RebuildForwardingSinksBySsrc();
+  return num_removed;
+}
+
+void RtpStreamReceiverController::RebuildForwardingSinksBySsrc() {
+  forwarding_sinks_by_ssrc_.Clear();
+  for (const auto& entry : forwarding_sinks_)
+    forwarding_sinks_by_ssrc_[entry.first].push_back(entry.second);
+}
+
 }  // namespace webrtc
@@ -11,7 +11,10 @@
 #define CALL_RTP_STREAM_RECEIVER_CONTROLLER_H_
 
 #include <memory>
+#include <utility>
+#include <vector>
 
+#include "call/flat_ssrc_map.h"
 #include "call/rtp_demuxer.h"
 #include "call/rtp_stream_receiver_controller_interface.h"
 #include "rtc_base/criticalsection.h"
@@ -40,10 +43,17 @@ class RtpStreamReceiverController
   // Thread-safe wrappers for the corresponding RtpDemuxer methods.
   bool AddSink(uint32_t ssrc, RtpPacketSinkInterface* sink) override;
   size_t RemoveSink(const RtpPacketSinkInterface* sink) override;
+  void AddForwardingSink(uint32_t ssrc, RtpPacketSinkInterface* sink) override;
+  size_t RemoveForwardingSink(const RtpPacketSinkInterface* sink) override;
 
   // TODO(nisse): Not yet responsible for parsing.
+  // Returns true if the packet was delivered to a demuxer or forwarding sink.
   bool OnRtpPacket(const RtpPacketReceived& packet);
 
+  // Delivers |packet| to its forwarding sinks only. For packets of ssrcs
+  // without a receive stream. Returns false if there are none.
+  bool ForwardRtpPacket(const RtpPacketReceived& packet);
+
  private:
   class Receiver : public RtpStreamReceiverInterface {
    public:
@@ -65,6 +75,16 @@ class RtpStreamReceiverController
   // using Call may have use threads differently.
   rtc::CriticalSection lock_;
   RtpDemuxer demuxer_ RTC_GUARDED_BY(&lock_);
+
+  bool ForwardRtpPacketLocked(const RtpPacketReceived& packet)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+  void RebuildForwardingSinksBySsrc() RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
+
+  std::vector<std::pair<uint32_t, RtpPacketSinkInterface*>> forwarding_sinks_
+      RTC_GUARDED_BY(&lock_);
+  // Lookup table for OnRtpPacket(), rebuilt from |forwarding_sinks_|.
+  FlatSsrcMap<std::vector<RtpPacketSinkInterface*>>
+      forwarding_sinks_by_ssrc_ RTC_GUARDED_BY(&lock_);
 };
 
 }  // namespace webrtc
@@ -40,6 +40,15 @@ class RtpStreamReceiverControllerInterface {
   // For registering additional sinks, needed for FlexFEC.
   virtual bool AddSink(uint32_t ssrc, RtpPacketSinkInterface* sink) = 0;
   virtual size_t RemoveSink(const RtpPacketSinkInterface* sink) = 0;
+
+  // For forwarding a stream without receiving it, e.g. in an SFU. Forwarding
+  // sinks get every packet with |ssrc| before, and independently of, the
+  // receive stream's sink, if there is one, so the packets don't have to go
+  // through depacketization. There may be several for each ssrc.
+  virtual void AddForwardingSink(uint32_t ssrc,
+                                 RtpPacketSinkInterface* sink) = 0;
+  // Returns the number of AddForwardingSink() registrations removed.
+  virtual size_t RemoveForwardingSink(const RtpPacketSinkInterface* sink) = 0;
 };
 
 }  // namespace webrtc
@@ -7,6 +7,8 @@
  *  in the file PATENTS.  All contributing project authors may
  *  be found in the AUTHORS file in the root of the source tree.
  */
+#include <stdio.h>
+
 #include <utility>
 
 #include "call/rtp_transport_controller_send.h"
@@ -20,6 +22,11 @@
 namespace webrtc {
 namespace {
 const char kTaskQueueExperiment[] = "WebRTC-TaskQueueCongestionControl";
+const char kSubMillisecondPacingExperiment[] =
+    "WebRTC-Pacer-SubMillisecondPacing";
+// "Enabled-<ms>" drops the upper temporal layers' packets that are still
+// queued <ms> after capture.
+const char kDropDiscardableExperiment[] = "WebRTC-Pacer-DropDiscardable";
 using TaskQueueController = webrtc::webrtc_cc::SendSideCongestionController;
 
 bool TaskQueueExperimentEnabled() {
@@ -65,19 +72,41 @@ RtpTransportControllerSend::RtpTransportControllerSend(
       observer_(nullptr),
       task_queue_("rtp_send_controller") {
   // Created after task_queue to be able to post to the task queue internally.
-  send_side_cc_ =
-      CreateController(clock, &task_queue_, event_log, &pacer_, bitrate_config,
-                       TaskQueueExperimentEnabled(), controller_factory);
+  // Only the task queue based controller can run an injected network
+  // controller, such as BBR, so it is used whenever one is given.
+  send_side_cc_ = CreateController(
+      clock, &task_queue_, event_log, &pacer_, bitrate_config,
+      TaskQueueExperimentEnabled() || controller_factory != nullptr,
+      controller_factory);
 
-  process_thread_->RegisterModule(&pacer_, RTC_FROM_HERE);
+  if (field_trial::IsEnabled(kSubMillisecondPacingExperiment)) {
+    RTC_LOG(LS_INFO) << "Using sub-millisecond pacing";
+    pacer_.SetSubMillisecondPacing(true);
+    pacer_thread_ = rtc::MakeUnique<PacerThread>(&pacer_);
+  } else {
+    process_thread_->RegisterModule(&pacer_, RTC_FROM_HERE);
+  }
+  int discardable_delay_limit_ms = 0;
+  if (sscanf(field_trial::FindFullName(kDropDiscardableExperiment).c_str(),
+             "Enabled-%d", &discardable_delay_limit_ms) == 1 &&
+      discardable_delay_limit_ms > 0) {
+    RTC_LOG(LS_INFO) << "Dropping discardable packets queued for more than "
+                     << discardable_delay_limit_ms << " ms";
+    pacer_.SetDiscardableDelayLimit(discardable_delay_limit_ms);
+  }
   process_thread_->RegisterModule(send_side_cc_.get(), RTC_FROM_HERE);
   process_thread_->Start();
+  if (pacer_thread_)
+    pacer_thread_->Start();
 }
 
 RtpTransportControllerSend::~RtpTransportControllerSend() {
+  if (pacer_thread_)
+    pacer_thread_->Stop();
   process_thread_->Stop();
   process_thread_->DeRegisterModule(send_side_cc_.get());
-  process_thread_->DeRegisterModule(&pacer_);
+  if (!pacer_thread_)
+    process_thread_->DeRegisterModule(&pacer_);
 }
 
 void RtpTransportControllerSend::OnNetworkChanged(uint32_t bitrate_bps,
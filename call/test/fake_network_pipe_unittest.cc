@@ -423,4 +423,39 @@ TEST_F(FakeNetworkPipeTest, SetReceiver) {
   pipe->Process();
 }
 
+TEST(SimulatedNetworkTest, ReportsLostPacketsAndNextProcessTime) {
+  SimulatedNetwork::Config config;
+  config.link_capacity_kbps = 80;
+  config.queue_delay_ms = 100;
+  config.loss_percent = 50;
+  SimulatedNetwork network(config);
+  EXPECT_FALSE(network.NextDeliveryTimeUs());
+
+  // A 100 byte packet takes 10 ms to go through the capacity link.
+  const int kNumPackets = 100;
+  for (int i = 0; i < kNumPackets; ++i)
+    ASSERT_TRUE(network.EnqueuePacket(PacketInFlightInfo(100, 0, i)));
+  EXPECT_EQ(10000, network.NextDeliveryTimeUs());
+
+  int received = 0;
+  int lost = 0;
+  int64_t time_us = 0;
+  while (rtc::Optional<int64_t> next_time_us = network.NextDeliveryTimeUs()) {
+    ASSERT_GE(*next_time_us, time_us);
+    time_us = *next_time_us;
+    for (const PacketDeliveryInfo& info :
+         network.DequeueDeliverablePackets(time_us)) {
+      if (info.receive_time_us == PacketDeliveryInfo::kNotReceived) {
+        ++lost;
+      } else {
+        EXPECT_EQ(static_cast<int64_t>(info.packet_id + 1) * 10000 + 100000,
+                  info.receive_time_us);
+        ++received;
+      }
+    }
+  }
+  EXPECT_EQ(kNumPackets, received + lost);
+  EXPECT_NEAR(kNumPackets / 2, lost, kNumPackets / 5);
+}
+
 }  // namespace webrtc
@@ -30,8 +30,13 @@ class MockAudioSendStream : public AudioSendStream {
       std::unique_ptr<webrtc::AudioFrame> audio_frame) {
     SendAudioDataForMock(audio_frame.get());
   }
+  virtual void SendAudioData(
+      rtc::scoped_refptr<const rtc::RefCountedObject<webrtc::AudioFrame>>
+          audio_frame) {
+    SendAudioDataForMock(audio_frame.get());
+  }
   MOCK_METHOD1(SendAudioDataForMock,
-               void(webrtc::AudioFrame* audio_frame));
+               void(const webrtc::AudioFrame* audio_frame));
   MOCK_METHOD4(SendTelephoneEvent,
                bool(int payload_type, int payload_frequency, int event,
                     int duration_ms));
@@ -0,0 +1,169 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Benchmarks of GoogCC flows competing with cross traffic over emulated
+// networks. For each scenario the total target rate, delay and loss of the
+// flows are printed as time series, together with the CPU time it took, so
+// that both congestion control and capacity regressions show up.
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "call/network_emulation.h"
+#include "logging/rtc_event_log/rtc_event_log.h"
+#include "modules/congestion_controller/goog_cc/include/goog_cc_factory.h"
+#include "rtc_base/cpu_time.h"
+#include "system_wrappers/include/field_trial.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int64_t kNanosPerSecond = 1000000000;
+const TimeDelta kSampleInterval = TimeDelta::ms(500);
+
+SimulatedNetwork::Config LinkConfig(int capacity_kbps,
+                                    int delay_ms,
+                                    size_t queue_length_packets) {
+  SimulatedNetwork::Config config;
+  config.link_capacity_kbps = capacity_kbps;
+  config.queue_delay_ms = delay_ms;
+  config.queue_length_packets = queue_length_packets;
+  return config;
+}
+
+TimeDelta Duration(int seconds) {
+  if (field_trial::IsEnabled("WebRTC-QuickPerfTest"))
+    return TimeDelta::seconds(2);
+  return TimeDelta::seconds(seconds);
+}
+
+class NetworkEmulationBenchmark : public ::testing::Test {
+ protected:
+  NetworkEmulationBenchmark()
+      : factory_(&event_log_), emulation_(kSampleInterval) {}
+
+  // Creates a GoogCC flow from a new endpoint, with its own access links,
+  // over |bottleneck|.
+  void CreateCall(int bottleneck, int access_kbps, int delay_ms) {
+    NetworkEmulation::FlowConfig config;
+    config.path = {
+        emulation_.CreateLink(LinkConfig(access_kbps, delay_ms / 2, 0)),
+        bottleneck};
+    config.return_path = {
+        emulation_.CreateLink(LinkConfig(access_kbps, delay_ms / 2, 0))};
+    config.rate = DataRate::kbps(300);
+    calls_.push_back(emulation_.CreateControlledFlow(config, &factory_));
+  }
+
+  void RunFor(TimeDelta duration) {
+    const int64_t start_cpu_ns = rtc::GetProcessCpuTimeNanos();
+    emulation_.RunFor(duration);
+    cpu_ns_ += rtc::GetProcessCpuTimeNanos() - start_cpu_ns;
+    simulated_time_ += duration;
+  }
+
+  // Prints the results of the calls so far as |scenario|.
+  void PrintResults(const std::string& scenario) {
+    std::vector<double> target_kbps;
+    std::vector<double> receive_kbps;
+    std::vector<double> delay_ms;
+    std::vector<double> loss_percent;
+    const size_t num_samples = emulation_.samples(calls_[0]).size();
+    for (size_t i = 0; i < num_samples; ++i) {
+      double target = 0;
+      double receive = 0;
+      double delay = 0;
+      double loss = 0;
+      for (int call : calls_) {
+        const NetworkEmulation::Sample& sample = emulation_.samples(call)[i];
+        target += sample.target_rate.kbps();
+        receive += sample.receive_rate.kbps();
+        delay += sample.average_delay.ms();
+        loss += sample.loss_ratio * 100;
+      }
+      target_kbps.push_back(target);
+      receive_kbps.push_back(receive);
+      delay_ms.push_back(delay / calls_.size());
+      loss_percent.push_back(loss / calls_.size());
+    }
+    test::PrintResultList("total_target_rate", "", scenario, target_kbps,
+                          "kbps", false);
+    test::PrintResultList("total_receive_rate", "", scenario, receive_kbps,
+                          "kbps", false);
+    test::PrintResultList("mean_delay", "", scenario, delay_ms, "ms", false);
+    test::PrintResultList("mean_loss", "", scenario, loss_percent, "%",
+                          false);
+    test::PrintResult("cpu_time_per_simulated_second", "", scenario,
+                      static_cast<double>(cpu_ns_) / simulated_time_.us(),
+                      "ms", true);
+    test::PrintResult("link_packets_per_cpu_second", "", scenario,
+                      static_cast<double>(emulation_.link_packets()) *
+                          kNanosPerSecond / std::max<int64_t>(cpu_ns_, 1),
+                      "packets", true);
+  }
+
+  RtcEventLogNullImpl event_log_;
+  GoogCcNetworkControllerFactory factory_;
+  NetworkEmulation emulation_;
+  std::vector<int> calls_;
+  int64_t cpu_ns_ = 0;
+  TimeDelta simulated_time_ = TimeDelta::Zero();
+};
+
+}  // namespace
+
+// Hundreds of calls behind one bottleneck, with bursty cross traffic taking
+// up to a third of it.
+TEST_F(NetworkEmulationBenchmark, ManyCallsWithCrossTraffic) {
+  const int kNumCalls = 300;
+  const int kBottleneckKbps = kNumCalls * 1000;
+  const int bottleneck =
+      emulation_.CreateLink(LinkConfig(kBottleneckKbps, 10, 1000));
+  for (int i = 0; i < kNumCalls; ++i)
+    CreateCall(bottleneck, 2500, 20 + i % 100);
+
+  NetworkEmulation::FlowConfig cross_traffic;
+  cross_traffic.path = {bottleneck};
+  cross_traffic.poisson = true;
+  cross_traffic.rate = DataRate::kbps(kBottleneckKbps / 6);
+  emulation_.CreateFlow(cross_traffic);
+  cross_traffic.on_time = TimeDelta::seconds(5);
+  cross_traffic.off_time = TimeDelta::seconds(5);
+  emulation_.CreateFlow(cross_traffic);
+
+  RunFor(Duration(30));
+  PrintResults("many_calls_with_cross_traffic");
+}
+
+// A few calls that lose half of the bottleneck for a while.
+TEST_F(NetworkEmulationBenchmark, CapacityDrop) {
+  const int kNumCalls = 10;
+  const SimulatedNetwork::Config bottleneck_config =
+      LinkConfig(kNumCalls * 1500, 25, 300);
+  const int bottleneck = emulation_.CreateLink(bottleneck_config);
+  for (int i = 0; i < kNumCalls; ++i)
+    CreateCall(bottleneck, 5000, 50);
+
+  const TimeDelta period = Duration(30) / 3;
+  RunFor(period);
+  SimulatedNetwork::Config reduced_config = bottleneck_config;
+  reduced_config.link_capacity_kbps /= 2;
+  emulation_.SetLinkConfig(bottleneck, reduced_config);
+  RunFor(period);
+  emulation_.SetLinkConfig(bottleneck, bottleneck_config);
+  RunFor(period);
+  PrintResults("capacity_drop");
+}
+
+}  // namespace webrtc
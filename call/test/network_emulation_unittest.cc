@@ -0,0 +1,205 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "call/network_emulation.h"
+
+#include <memory>
+
+#include "rtc_base/ptr_util.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+const TimeDelta kSampleInterval = TimeDelta::ms(100);
+
+SimulatedNetwork::Config LinkConfig(int capacity_kbps, int delay_ms) {
+  SimulatedNetwork::Config config;
+  config.link_capacity_kbps = capacity_kbps;
+  config.queue_delay_ms = delay_ms;
+  return config;
+}
+
+// Sends at a fixed rate once it has received feedback, and counts the
+// feedback.
+class FixedRateController : public NetworkControllerInterface {
+ public:
+  FixedRateController(DataRate rate, int* received, int* lost)
+      : rate_(rate), received_(received), lost_(lost) {}
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnProcessInterval(ProcessInterval) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnSentPacket(SentPacket) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints) override {
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTransportLossReport(
+      TransportLossReport report) override {
+    *received_ += report.packets_received_delta;
+    *lost_ += report.packets_lost_delta;
+    return NetworkControlUpdate();
+  }
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback feedback) override {
+    NetworkControlUpdate update;
+    update.target_rate.emplace();
+    update.target_rate->at_time = feedback.feedback_time;
+    update.target_rate->target_rate = rate_;
+    return update;
+  }
+
+ private:
+  const DataRate rate_;
+  int* const received_;
+  int* const lost_;
+};
+
+class FixedRateControllerFactory : public NetworkControllerFactoryInterface {
+ public:
+  explicit FixedRateControllerFactory(DataRate rate) : rate_(rate) {}
+
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return rtc::MakeUnique<FixedRateController>(rate_, &received_, &lost_);
+  }
+  TimeDelta GetProcessInterval() const override { return TimeDelta::ms(25); }
+
+  int received() const { return received_; }
+  int lost() const { return lost_; }
+
+ private:
+  const DataRate rate_;
+  int received_ = 0;
+  int lost_ = 0;
+};
+
+}  // namespace
+
+TEST(NetworkEmulationTest, CrossTrafficIsDelayedByTheLinks) {
+  NetworkEmulation emulation(kSampleInterval);
+  NetworkEmulation::FlowConfig config;
+  config.path = {emulation.CreateLink(LinkConfig(960, 20)),
+                 emulation.CreateLink(LinkConfig(0, 30))};
+  config.rate = DataRate::kbps(480);
+  int flow = emulation.CreateFlow(config);
+  emulation.RunFor(TimeDelta::seconds(2));
+
+  const auto& samples = emulation.samples(flow);
+  ASSERT_EQ(20u, samples.size());
+  EXPECT_EQ(kSampleInterval.ms(), samples[0].at_time.ms());
+  for (size_t i = 1; i < samples.size(); ++i) {
+    EXPECT_EQ(480, samples[i].send_rate.kbps());
+    EXPECT_EQ(480, samples[i].receive_rate.kbps());
+    // 50 ms on the links and 10 ms to serialize a packet at 960 kbps.
+    EXPECT_EQ(60, samples[i].average_delay.ms());
+    EXPECT_EQ(0, samples[i].loss_ratio);
+  }
+  // The packets sent in the last 30 and 60 ms haven't left the links yet.
+  EXPECT_EQ(99 + 98, emulation.link_packets());
+}
+
+TEST(NetworkEmulationTest, FlowsShareTheBottleneck) {
+  NetworkEmulation emulation(kSampleInterval);
+  SimulatedNetwork::Config link_config = LinkConfig(480, 0);
+  link_config.queue_length_packets = 10;
+  NetworkEmulation::FlowConfig config;
+  config.path = {emulation.CreateLink(link_config)};
+  config.rate = DataRate::kbps(480);
+  config.poisson = true;
+  int flow1 = emulation.CreateFlow(config);
+  int flow2 = emulation.CreateFlow(config);
+  emulation.RunFor(TimeDelta::seconds(10));
+
+  // Skips the first second, in which the queue fills.
+  const size_t kFirstSample = 10;
+  const size_t num_samples = emulation.samples(flow1).size() - kFirstSample;
+  double receive_kbps1 = 0;
+  double receive_kbps2 = 0;
+  double loss_ratio = 0;
+  double delay_ms = 0;
+  for (size_t i = kFirstSample; i < emulation.samples(flow1).size(); ++i) {
+    const NetworkEmulation::Sample& sample1 = emulation.samples(flow1)[i];
+    const NetworkEmulation::Sample& sample2 = emulation.samples(flow2)[i];
+    receive_kbps1 += sample1.receive_rate.kbps();
+    receive_kbps2 += sample2.receive_rate.kbps();
+    loss_ratio += sample1.loss_ratio + sample2.loss_ratio;
+    delay_ms += sample1.average_delay.ms();
+  }
+  EXPECT_NEAR(240, receive_kbps1 / num_samples, 24);
+  EXPECT_NEAR(240, receive_kbps2 / num_samples, 24);
+  // About half of the packets don't fit in the queue, which is mostly full.
+  // A full queue of ten packets takes 200 ms to go through the link.
+  EXPECT_LT(0.3, loss_ratio / num_samples / 2);
+  EXPECT_NEAR(200, delay_ms / num_samples, 30);
+}
+
+TEST(NetworkEmulationTest, OnOffTrafficPauses) {
+  NetworkEmulation emulation(kSampleInterval);
+  NetworkEmulation::FlowConfig config;
+  config.path = {emulation.CreateLink(LinkConfig(0, 0))};
+  config.rate = DataRate::kbps(96);
+  config.start_time = Timestamp::ms(200);
+  config.on_time = TimeDelta::ms(300);
+  config.off_time = TimeDelta::ms(200);
+  int flow = emulation.CreateFlow(config);
+  emulation.RunFor(TimeDelta::seconds(1));
+
+  const auto& samples = emulation.samples(flow);
+  ASSERT_EQ(10u, samples.size());
+  const int kExpectedKbps[] = {0, 96, 96, 96, 0, 0, 96, 96, 96, 0};
+  for (size_t i = 0; i < samples.size(); ++i) {
+    EXPECT_EQ(kExpectedKbps[i], samples[i].send_rate.kbps()) << i;
+  }
+}
+
+TEST(NetworkEmulationTest, ControlledFlowGetsFeedback) {
+  NetworkEmulation emulation(kSampleInterval);
+  SimulatedNetwork::Config lossy_config = LinkConfig(0, 25);
+  lossy_config.loss_percent = 10;
+  NetworkEmulation::FlowConfig config;
+  config.path = {emulation.CreateLink(lossy_config)};
+  config.return_path = {emulation.CreateLink(LinkConfig(0, 25))};
+  config.rate = DataRate::kbps(960);
+  FixedRateControllerFactory factory(DataRate::kbps(4800));
+  int flow = emulation.CreateControlledFlow(config, &factory);
+  emulation.RunFor(TimeDelta::seconds(10));
+
+  // The first feedback arrives after 125 ms, and then the flow sends at the
+  // rate the controller asks for.
+  const auto& samples = emulation.samples(flow);
+  EXPECT_EQ(960, samples[0].target_rate.kbps());
+  EXPECT_EQ(4800, samples.back().send_rate.kbps());
+  EXPECT_EQ(4800, samples.back().target_rate.kbps());
+  const int reported = factory.received() + factory.lost();
+  EXPECT_GT(reported, 4800);
+  EXPECT_NEAR(0.1, static_cast<double>(factory.lost()) / reported, 0.02);
+}
+
+}  // namespace webrtc
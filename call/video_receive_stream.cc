@@ -53,6 +53,7 @@ std::string VideoReceiveStream::Stats::ToString(int64_t time_ms) const {
   ss << "targ_delay_ms: " << target_delay_ms << ", ";
   ss << "jb_delay_ms: " << jitter_buffer_ms << ", ";
   ss << "min_playout_delay_ms: " << min_playout_delay_ms << ", ";
+  ss << "e2e_delay_ms: " << end_to_end_delay_ms << ", ";
   ss << "discarded: " << discarded_packets << ", ";
   ss << "sync_offset_ms: " << sync_offset_ms << ", ";
   ss << "cum_loss: " << rtcp_stats.packets_lost << ", ";
@@ -91,6 +92,11 @@ std::string VideoReceiveStream::Config::ToString() const {
   ss << ", pre_decode_callback: "
      << (pre_decode_callback ? "(EncodedFrameObserver)" : "nullptr");
   ss << ", target_delay_ms: " << target_delay_ms;
+  ss << ", max_bitrate_bps: " << max_bitrate_bps;
+  ss << ", max_decode_framerate: " << max_decode_framerate;
+  ss << ", decode_on_task_queue: " << (decode_on_task_queue ? "on" : "off");
+  ss << ", frame_decryptor: "
+     << (frame_decryptor ? "(FrameDecryptorInterface)" : "nullptr");
   ss << '}';
 
   return ss.str();
@@ -118,6 +124,9 @@ std::string VideoReceiveStream::Config::Rtp::ToString() const {
   ss << ", ulpfec_payload_type: " << ulpfec_payload_type;
   ss << ", red_type: " << red_payload_type;
   ss << ", rtx_ssrc: " << rtx_ssrc;
+  ss << ", keyframe_cache_max_bytes: " << keyframe_cache_max_bytes;
+  ss << ", min_keyframe_request_interval_ms: "
+     << min_keyframe_request_interval_ms;
   ss << ", rtx_payload_types: {";
   for (auto& kv : rtx_associated_payload_types) {
     ss << kv.first << " (pt) -> " << kv.second << " (apt), ";
@@ -18,6 +18,7 @@
 
 #include "api/rtp_headers.h"
 #include "api/call/transport.h"
+#include "api/crypto/frame_decryptor_interface.h"
 #include "api/rtpparameters.h"
 #include "api/video/video_content_type.h"
 #include "api/video/video_timing.h"
@@ -27,6 +28,7 @@
 #include "common_video/include/frame_callback.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/platform_file.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
@@ -81,6 +83,9 @@ class VideoReceiveStream {
     int min_playout_delay_ms = 0;
     int render_delay_ms = 10;
     int64_t interframe_delay_max_ms = -1;
+    // Capture-to-render delay of the last rendered frame, by the sender's NTP
+    // clock. -1 until the capture time of a frame is known.
+    int64_t end_to_end_delay_ms = -1;
     uint32_t frames_decoded = 0;
     rtc::Optional<uint64_t> qp_sum;
 
@@ -180,6 +185,18 @@ class VideoReceiveStream {
       // Set if the stream is protected using FlexFEC.
       bool protected_by_flexfec = false;
 
+      // If not 0, the packets of the last keyframe and of the frames since
+      // are kept, up to this many bytes, and given to the secondary sinks
+      // that are added later, so that a forwarding sink can start with a
+      // keyframe without asking the sender for one. Keyframe requests are
+      // then also coalesced, as below, for at least an RTT.
+      size_t keyframe_cache_max_bytes = 0;
+
+      // If not 0, a keyframe request that comes within this long of the
+      // previous one, before the keyframe arrived, isn't sent, however many
+      // of the decoder and the sinks ask for one.
+      int min_keyframe_request_interval_ms = 0;
+
       // Map from rtx payload type -> media payload type.
       // For RTX to be enabled, both an SSRC and this mapping are needed.
       std::map<int, int> rtx_associated_payload_types;
@@ -221,6 +238,27 @@ class VideoReceiveStream {
     // Target delay in milliseconds. A positive value indicates this stream is
     // used for streaming instead of a real-time call.
     int target_delay_ms = 0;
+
+    // Highest bitrate the stream is expected to be received at, 0 if unknown.
+    // Used to size the packet buffer up front instead of growing it.
+    int max_bitrate_bps = 0;
+
+    // If positive, about this many frames per second are decoded at most, for
+    // streams shown in small tiles. Only the frames of the temporal layers
+    // above the base layer are skipped, see
+    // FrameBuffer::SetMaxDecodeFramerate(), so it takes a sender that uses
+    // temporal layers.
+    int max_decode_framerate = 0;
+
+    // If set, frames are decoded in tasks on a task queue of the stream
+    // instead of on a decode thread of its own. With the pooled task queue
+    // implementation (rtc_enable_task_queue_pool) the queues of all streams
+    // share a bounded set of worker threads, in order within each stream.
+    bool decode_on_task_queue = false;
+
+    // If set, every assembled frame is decrypted before it is decoded, and
+    // frames that fail to decrypt are dropped. See FrameDecryptorInterface.
+    rtc::scoped_refptr<FrameDecryptorInterface> frame_decryptor;
   };
 
   // Starts stream activity.
@@ -233,6 +271,9 @@ class VideoReceiveStream {
   // TODO(pbos): Add info on currently-received codec to Stats.
   virtual Stats GetStats() const = 0;
 
+  // Changes the RTCP mode of a running stream, without having to recreate it.
+  virtual void SetRtcpMode(RtcpMode mode) = 0;
+
   // Takes ownership of the file, is responsible for closing it later.
   // Calling this method will close and finalize any current log.
   // Giving rtc::kInvalidPlatformFileValue disables logging.
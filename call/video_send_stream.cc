@@ -82,8 +82,12 @@ std::string VideoSendStream::Config::ToString() const {
      << (post_encode_callback ? "(EncodedFrameObserver)" : "nullptr");
   ss << ", render_delay_ms: " << render_delay_ms;
   ss << ", target_delay_ms: " << target_delay_ms;
+  ss << ", playout_delay: {min_ms: " << playout_delay.min_ms
+     << ", max_ms: " << playout_delay.max_ms << '}';
   ss << ", suspend_below_min_bitrate: "
      << (suspend_below_min_bitrate ? "on" : "off");
+  ss << ", frame_encryptor: "
+     << (frame_encryptor ? "(FrameEncryptorInterface)" : "nullptr");
   ss << '}';
   return ss.str();
 }
@@ -93,6 +97,8 @@ std::string VideoSendStream::Config::EncoderSettings::ToString() const {
   rtc::SimpleStringBuilder ss(buf);
   ss << "{encoder_factory: "
      << (encoder_factory ? "(VideoEncoderFactory)" : "(nullptr)");
+  if (!shared_encoder_id.empty())
+    ss << ", shared_encoder_id: " << shared_encoder_id;
   ss << '}';
   return ss.str();
 }
@@ -128,6 +134,8 @@ std::string VideoSendStream::Config::Rtp::ToString() const {
   ss << ']';
 
   ss << ", nack: {rtp_history_ms: " << nack.rtp_history_ms << '}';
+  ss << ", min_keyframe_request_interval_ms: "
+     << min_keyframe_request_interval_ms;
   ss << ", ulpfec: " << ulpfec.ToString();
   ss << ", payload_name: " << payload_name;
   ss << ", payload_type: " << payload_type;
@@ -17,6 +17,7 @@
 #include <vector>
 
 #include "api/call/transport.h"
+#include "api/crypto/frame_encryptor_interface.h"
 #include "api/rtp_headers.h"
 #include "api/rtpparameters.h"
 #include "api/video/video_sink_interface.h"
@@ -28,6 +29,7 @@
 #include "common_video/include/frame_callback.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/platform_file.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
@@ -119,6 +121,13 @@ class VideoSendStream {
 
       // Ownership stays with WebrtcVideoEngine (delegated from PeerConnection).
       VideoEncoderFactory* encoder_factory = nullptr;
+
+      // The send streams of a Call with the same non-empty id share one
+      // encoder, which the first of them creates and configures. For streams
+      // that send the same source at the same resolution and bitrate, such
+      // as those of an MCU's receivers in the same bitrate class. Each is
+      // still packetized with its own SSRCs.
+      std::string shared_encoder_id;
     } encoder_settings;
 
     static const size_t kDefaultMaxPacketSize = 1500 - 40;  // TCP over IPv4.
@@ -156,6 +165,11 @@ class VideoSendStream {
       // See NackConfig for description.
       NackConfig nack;
 
+      // Keyframe requests from the receivers that come within this long of
+      // the last one that a keyframe was encoded for are dropped, so that
+      // many receivers asking at once get one keyframe.
+      int min_keyframe_request_interval_ms = 300;
+
       // See UlpfecConfig for description.
       UlpfecConfig ulpfec;
 
@@ -230,6 +244,13 @@ class VideoSendStream {
     // used for streaming instead of a real-time call.
     int target_delay_ms = 0;
 
+    // Playout delay range in ms sent to the receivers in the playout-delay RTP
+    // header extension, see PlayoutDelay. Values < 0 are not sent, unless the
+    // encoder sets them. {0, 0} makes the receivers decode and render each
+    // frame as soon as it's complete, for interactive streams such as cloud
+    // gaming.
+    PlayoutDelay playout_delay = {-1, -1};
+
     // True if the stream should be suspended when the available bitrate fall
     // below the minimum configured bitrate. If this variable is false, the
     // stream may send at a rate higher than the estimated available bitrate.
@@ -241,6 +262,10 @@ class VideoSendStream {
     // Track ID as specified during track creation.
     std::string track_id;
 
+    // If set, every encoded frame is encrypted before it is packetized. See
+    // FrameEncryptorInterface.
+    rtc::scoped_refptr<FrameEncryptorInterface> frame_encryptor;
+
    private:
     // Access to the copy constructor is private to force use of the Copy()
     // method for those exceptional cases where we do use it.
@@ -273,6 +298,9 @@ class VideoSendStream {
   // with the VideoStream settings.
   virtual void ReconfigureVideoEncoder(VideoEncoderConfig config) = 0;
 
+  // Changes the RTCP mode of a running stream, without having to recreate it.
+  virtual void SetRtcpMode(RtcpMode mode) = 0;
+
   virtual Stats GetStats() = 0;
 
   // Takes ownership of each file, is responsible for closing them later.
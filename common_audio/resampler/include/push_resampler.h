@@ -12,6 +12,7 @@
 #define COMMON_AUDIO_RESAMPLER_INCLUDE_PUSH_RESAMPLER_H_
 
 #include <memory>
+#include <vector>
 
 #include "typedefs.h"  // NOLINT(build/include)
 
@@ -19,8 +20,8 @@ namespace webrtc {
 
 class PushSincResampler;
 
-// Wraps PushSincResampler to provide stereo support.
-// TODO(ajm): add support for an arbitrary number of channels.
+// Wraps PushSincResampler to provide support for interleaved audio with any
+// number of channels.
 template <typename T>
 class PushResampler {
  public:
@@ -37,15 +38,20 @@ class PushResampler {
   int Resample(const T* src, size_t src_length, T* dst, size_t dst_capacity);
 
  private:
-  std::unique_ptr<PushSincResampler> sinc_resampler_;
-  std::unique_ptr<PushSincResampler> sinc_resampler_right_;
+  struct ChannelResampler {
+    std::unique_ptr<PushSincResampler> resampler;
+    std::vector<T> source;
+    std::vector<T> destination;
+  };
+
   int src_sample_rate_hz_;
   int dst_sample_rate_hz_;
   size_t num_channels_;
-  std::unique_ptr<T[]> src_left_;
-  std::unique_ptr<T[]> src_right_;
-  std::unique_ptr<T[]> dst_left_;
-  std::unique_ptr<T[]> dst_right_;
+  std::vector<ChannelResampler> channel_resamplers_;
+  // Pointer arrays into the buffers of |channel_resamplers_|, used to
+  // deinterleave and interleave without allocating.
+  std::vector<T*> channel_sources_;
+  std::vector<T*> channel_destinations_;
 };
 
 }  // namespace webrtc
@@ -33,7 +33,6 @@ void CheckValidInitParams(int src_sample_rate_hz, int dst_sample_rate_hz,
   RTC_DCHECK_GT(src_sample_rate_hz, 0);
   RTC_DCHECK_GT(dst_sample_rate_hz, 0);
   RTC_DCHECK_GT(num_channels, 0);
-  RTC_DCHECK_LE(num_channels, 2);
 #endif
 }
 
@@ -79,8 +78,7 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
     return 0;
   }
 
-  if (src_sample_rate_hz <= 0 || dst_sample_rate_hz <= 0 || num_channels <= 0 ||
-      num_channels > 2) {
+  if (src_sample_rate_hz <= 0 || dst_sample_rate_hz <= 0 || num_channels <= 0) {
     return -1;
   }
 
@@ -92,15 +90,21 @@ int PushResampler<T>::InitializeIfNeeded(int src_sample_rate_hz,
       static_cast<size_t>(src_sample_rate_hz / 100);
   const size_t dst_size_10ms_mono =
       static_cast<size_t>(dst_sample_rate_hz / 100);
-  sinc_resampler_.reset(new PushSincResampler(src_size_10ms_mono,
-                                              dst_size_10ms_mono));
-  if (num_channels_ == 2) {
-    src_left_.reset(new T[src_size_10ms_mono]);
-    src_right_.reset(new T[src_size_10ms_mono]);
-    dst_left_.reset(new T[dst_size_10ms_mono]);
-    dst_right_.reset(new T[dst_size_10ms_mono]);
-    sinc_resampler_right_.reset(new PushSincResampler(src_size_10ms_mono,
-                                                      dst_size_10ms_mono));
+  channel_resamplers_.clear();
+  channel_sources_.clear();
+  channel_destinations_.clear();
+  for (size_t i = 0; i < num_channels_; ++i) {
+    channel_resamplers_.push_back(ChannelResampler());
+    ChannelResampler& channel_resampler = channel_resamplers_.back();
+    channel_resampler.resampler.reset(
+        new PushSincResampler(src_size_10ms_mono, dst_size_10ms_mono));
+    // Mono audio is resampled in place and needs no intermediate buffers.
+    if (num_channels_ > 1) {
+      channel_resampler.source.resize(src_size_10ms_mono);
+      channel_resampler.destination.resize(dst_size_10ms_mono);
+    }
+    channel_sources_.push_back(channel_resampler.source.data());
+    channel_destinations_.push_back(channel_resampler.destination.data());
   }
 
   return 0;
@@ -118,26 +122,25 @@ int PushResampler<T>::Resample(const T* src, size_t src_length, T* dst,
     memcpy(dst, src, src_length * sizeof(T));
     return static_cast<int>(src_length);
   }
-  if (num_channels_ == 2) {
-    const size_t src_length_mono = src_length / num_channels_;
-    const size_t dst_capacity_mono = dst_capacity / num_channels_;
-    T* deinterleaved[] = {src_left_.get(), src_right_.get()};
-    Deinterleave(src, src_length_mono, num_channels_, deinterleaved);
-
-    size_t dst_length_mono =
-        sinc_resampler_->Resample(src_left_.get(), src_length_mono,
-                                  dst_left_.get(), dst_capacity_mono);
-    sinc_resampler_right_->Resample(src_right_.get(), src_length_mono,
-                                    dst_right_.get(), dst_capacity_mono);
-
-    deinterleaved[0] = dst_left_.get();
-    deinterleaved[1] = dst_right_.get();
-    Interleave(deinterleaved, dst_length_mono, num_channels_, dst);
-    return static_cast<int>(dst_length_mono * num_channels_);
-  } else {
-    return static_cast<int>(
-        sinc_resampler_->Resample(src, src_length, dst, dst_capacity));
+  if (num_channels_ == 1) {
+    return static_cast<int>(channel_resamplers_[0].resampler->Resample(
+        src, src_length, dst, dst_capacity));
   }
+
+  const size_t src_length_mono = src_length / num_channels_;
+  const size_t dst_capacity_mono = dst_capacity / num_channels_;
+  Deinterleave(src, src_length_mono, num_channels_, channel_sources_.data());
+
+  size_t dst_length_mono = 0;
+  for (ChannelResampler& channel_resampler : channel_resamplers_) {
+    dst_length_mono = channel_resampler.resampler->Resample(
+        channel_resampler.source.data(), src_length_mono,
+        channel_resampler.destination.data(), dst_capacity_mono);
+  }
+
+  Interleave(channel_destinations_.data(), dst_length_mono, num_channels_,
+             dst);
+  return static_cast<int>(dst_length_mono * num_channels_);
 }
 
 // Explictly generate required instantiations.
@@ -9,7 +9,11 @@
  */
 
 #include "common_audio/resampler/include/push_resampler.h"
+
+#include <vector>
+
 #include "rtc_base/checks.h"  // RTC_DCHECK_IS_ON
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 // Quality testing of PushResampler is handled through output_mixer_unittest.cc.
@@ -25,6 +29,7 @@ TEST(PushResamplerTest, VerifiesInputParameters) {
   PushResampler<int16_t> resampler;
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 1));
   EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 2));
+  EXPECT_EQ(0, resampler.InitializeIfNeeded(16000, 16000, 3));
 }
 
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
@@ -44,12 +49,46 @@ TEST(PushResamplerTest, VerifiesBadInputParameters3) {
   PushResampler<int16_t> resampler;
   EXPECT_DEATH(resampler.InitializeIfNeeded(16000, 16000, 0), "num_channels");
 }
-
-TEST(PushResamplerTest, VerifiesBadInputParameters4) {
-  PushResampler<int16_t> resampler;
-  EXPECT_DEATH(resampler.InitializeIfNeeded(16000, 16000, 3), "num_channels");
-}
 #endif
 #endif
 
+// Verifies that each channel of interleaved audio is resampled the same way
+// as mono audio.
+TEST(PushResamplerTest, ResamplesEachChannelLikeMono) {
+  constexpr size_t kNumChannels = 4;
+  constexpr size_t kSrcLength = 480;
+  constexpr size_t kDstLength = 160;
+  PushResampler<float> resampler;
+  ASSERT_EQ(0, resampler.InitializeIfNeeded(48000, 16000, kNumChannels));
+  std::vector<PushResampler<float>> mono_resamplers(kNumChannels);
+  for (auto& mono_resampler : mono_resamplers) {
+    ASSERT_EQ(0, mono_resampler.InitializeIfNeeded(48000, 16000, 1));
+  }
+
+  Random random_generator(42U);
+  std::vector<float> src(kNumChannels * kSrcLength);
+  std::vector<float> dst(kNumChannels * kDstLength);
+  std::vector<float> mono_src(kSrcLength);
+  std::vector<float> mono_dst(kDstLength);
+  for (int frame = 0; frame < 10; ++frame) {
+    for (float& sample : src) {
+      sample = 32767.f * (2.f * random_generator.Rand<float>() - 1.f);
+    }
+    EXPECT_EQ(static_cast<int>(dst.size()),
+              resampler.Resample(src.data(), src.size(), dst.data(),
+                                 dst.size()));
+    for (size_t ch = 0; ch < kNumChannels; ++ch) {
+      for (size_t k = 0; k < kSrcLength; ++k) {
+        mono_src[k] = src[k * kNumChannels + ch];
+      }
+      EXPECT_EQ(static_cast<int>(kDstLength),
+                mono_resamplers[ch].Resample(mono_src.data(), kSrcLength,
+                                             mono_dst.data(), kDstLength));
+      for (size_t k = 0; k < kDstLength; ++k) {
+        EXPECT_EQ(mono_dst[k], dst[k * kNumChannels + ch]);
+      }
+    }
+  }
+}
+
 }  // namespace webrtc
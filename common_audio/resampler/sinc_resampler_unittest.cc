@@ -162,6 +162,23 @@ TEST(SincResamplerTest, Convolve) {
       resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
       resampler.kernel_storage_.get(), kKernelInterpolationFactor);
   EXPECT_NEAR(result2, result, kEpsilon);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    for (size_t offset : {0, 1}) {
+      SCOPED_TRACE(offset);
+      result = resampler.Convolve_C(resampler.kernel_storage_.get() + offset,
+                                    resampler.kernel_storage_.get(),
+                                    resampler.kernel_storage_.get(),
+                                    kKernelInterpolationFactor);
+      result2 = resampler.Convolve_AVX2(
+          resampler.kernel_storage_.get() + offset,
+          resampler.kernel_storage_.get(), resampler.kernel_storage_.get(),
+          kKernelInterpolationFactor);
+      EXPECT_NEAR(result2, result, kEpsilon);
+    }
+  }
+#endif
 }
 #endif
 
@@ -227,6 +244,24 @@ TEST(SincResamplerTest, ConvolveBenchmark) {
          total_time_c_us / total_time_optimized_aligned_us,
          total_time_optimized_unaligned_us / total_time_optimized_aligned_us);
 #endif
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) && WebRtc_GetCPUInfo(kFMA3)) {
+    // Benchmark with unaligned input pointer, the AVX2 version only uses
+    // unaligned loads.
+    start = rtc::TimeNanos();
+    for (int j = 0; j < kConvolveIterations; ++j) {
+      resampler.Convolve_AVX2(
+          resampler.kernel_storage_.get() + 1, resampler.kernel_storage_.get(),
+          resampler.kernel_storage_.get(), kKernelInterpolationFactor);
+    }
+    double total_time_avx2_us =
+        (rtc::TimeNanos() - start) / rtc::kNumNanosecsPerMicrosec;
+    printf("Convolve_AVX2 (unaligned) took %.2fms; which is %.2fx faster than "
+           "Convolve_C.\n", total_time_avx2_us / 1000,
+           total_time_c_us / total_time_avx2_us);
+  }
+#endif
 }
 
 #undef CONVOLVE_FUNC
@@ -353,7 +388,7 @@ INSTANTIATE_TEST_CASE_P(
         std::make_tuple(16000, 44100, kResamplingRMSError, -62.54),
         std::make_tuple(22050, 44100, kResamplingRMSError, -73.53),
         std::make_tuple(32000, 44100, kResamplingRMSError, -63.32),
-        std::make_tuple(44100, 44100, kResamplingRMSError, -73.53),
+        std::make_tuple(44100, 44100, kResamplingRMSError, -73.52),
         std::make_tuple(48000, 44100, -15.01, -64.04),
         std::make_tuple(96000, 44100, -18.49, -25.51),
         std::make_tuple(192000, 44100, -20.50, -13.31),
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <immintrin.h>
+
+// Same as in the SSE2 version, for sixteen products.
+static inline __m256i ShiftedProducts(__m256i a, __m256i b, __m128i shift) {
+  const __m256i low = _mm256_mullo_epi16(a, b);
+  const __m256i high = _mm256_mulhi_epi16(a, b);
+  return _mm256_add_epi32(
+      _mm256_sra_epi32(_mm256_unpacklo_epi16(low, high), shift),
+      _mm256_sra_epi32(_mm256_unpackhi_epi16(low, high), shift));
+}
+
+static inline int32_t HorizontalSum(__m256i sum256) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sum256),
+                              _mm256_extracti128_si256(sum256, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(sum);
+}
+
+/* AVX2 version of WebRtcSpl_CrossCorrelation() for x86 platforms. */
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2) {
+  const __m128i shift = _mm_cvtsi32_si128(right_shifts);
+  size_t i = 0;
+
+  for (i = 0; i < dim_cross_correlation; i++) {
+    __m256i sum = _mm256_setzero_si256();
+    size_t j = 0;
+    int32_t corr = 0;
+    if (right_shifts == 0) {
+      for (; j + 16 <= dim_seq; j += 16) {
+        sum = _mm256_add_epi32(
+            sum, _mm256_madd_epi16(
+                     _mm256_loadu_si256((const __m256i*)(seq1 + j)),
+                     _mm256_loadu_si256((const __m256i*)(seq2 + j))));
+      }
+    } else {
+      for (; j + 16 <= dim_seq; j += 16) {
+        sum = _mm256_add_epi32(
+            sum,
+            ShiftedProducts(_mm256_loadu_si256((const __m256i*)(seq1 + j)),
+                            _mm256_loadu_si256((const __m256i*)(seq2 + j)),
+                            shift));
+      }
+    }
+    corr = HorizontalSum(sum);
+    for (; j < dim_seq; j++)
+      corr += (seq1[j] * seq2[j]) >> right_shifts;
+    seq2 += step_seq2;
+    *cross_correlation++ = corr;
+  }
+}
@@ -10,8 +10,26 @@
 
 #include "common_audio/signal_processing/dot_product_with_scale.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #include "rtc_base/numerics/safe_conversions.h"
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+namespace {
+
+// Sign extends the four 32-bit lanes of |v| and adds them to the two 64-bit
+// lanes of |sum|.
+inline __m128i AddTo64(__m128i sum, __m128i v) {
+  const __m128i sign = _mm_srai_epi32(v, 31);
+  sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(v, sign));
+  return _mm_add_epi64(sum, _mm_unpackhi_epi32(v, sign));
+}
+
+}  // namespace
+#endif
+
 int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
                                       const int16_t* vector2,
                                       size_t length,
@@ -19,8 +37,30 @@ int32_t WebRtcSpl_DotProductWithScale(const int16_t* vector1,
   int64_t sum = 0;
   size_t i = 0;
 
+#if defined(WEBRTC_ARCH_X86_FAMILY) && defined(__SSE2__)
+  // Each product is shifted on its own, as below. A sum of two products may
+  // not fit in 32 bits, so the products are accumulated in 64 bits.
+  const __m128i shift = _mm_cvtsi32_si128(scaling);
+  __m128i sum64 = _mm_setzero_si128();
+  for (; i + 8 <= length; i += 8) {
+    const __m128i a =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(vector1 + i));
+    const __m128i b =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(vector2 + i));
+    const __m128i low = _mm_mullo_epi16(a, b);
+    const __m128i high = _mm_mulhi_epi16(a, b);
+    sum64 = AddTo64(sum64,
+                    _mm_sra_epi32(_mm_unpacklo_epi16(low, high), shift));
+    sum64 = AddTo64(sum64,
+                    _mm_sra_epi32(_mm_unpackhi_epi16(low, high), shift));
+  }
+  int64_t lanes[2];
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), sum64);
+  sum = lanes[0] + lanes[1];
+#endif
+
   /* Unroll the loop to improve performance. */
-  for (i = 0; i + 3 < length; i += 4) {
+  for (; i + 3 < length; i += 4) {
     sum += (vector1[i + 0] * vector2[i + 0]) >> scaling;
     sum += (vector1[i + 1] * vector2[i + 1]) >> scaling;
     sum += (vector1[i + 2] * vector2[i + 2]) >> scaling;
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+#include <stddef.h>
+#include <string.h>
+
+// Loads the two samples at |data| into one 32-bit value.
+static inline int32_t LoadPair(const int16_t* data) {
+  int32_t pair;
+  memcpy(&pair, data, sizeof(pair));
+  return pair;
+}
+
+// Two coefficients as the 16-bit halves of a 32-bit value, low one first.
+static inline int32_t CoefficientPair(int16_t low, int16_t high) {
+  return (int32_t)((uint32_t)(uint16_t)low | ((uint32_t)(uint16_t)high << 16));
+}
+
+// SSE2 version of WebRtcSpl_DownsampleFast() for x86 platforms.
+// The filters are short, so four outputs are computed at a time, two taps
+// per multiply-add.
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay) {
+  size_t i = 0;
+  size_t j = 0;
+  size_t out = 0;
+  size_t endpos = delay + factor * (data_out_length - 1) + 1;
+
+  // Return error if any of the running conditions doesn't meet.
+  if (data_out_length == 0 || coefficients_length == 0
+                           || data_in_length < endpos) {
+    return -1;
+  }
+
+  for (i = delay; out + 4 <= data_out_length; i += 4 * factor, out += 4) {
+    // As in the C version, the filters may read samples before |data_in|.
+    const int16_t* x0 = data_in + i;
+    const int16_t* x1 = x0 + factor;
+    const int16_t* x2 = x1 + factor;
+    const int16_t* x3 = x2 + factor;
+    __m128i sum = _mm_set1_epi32(2048);  // Round value, 0.5 in Q12.
+
+    for (j = 0; j + 2 <= coefficients_length; j += 2) {
+      // Each lane holds the samples at offsets -j - 1 and -j.
+      const __m128i x = _mm_set_epi32(
+          LoadPair(x3 - j - 1), LoadPair(x2 - j - 1), LoadPair(x1 - j - 1),
+          LoadPair(x0 - j - 1));
+      const __m128i c =
+          _mm_set1_epi32(CoefficientPair(coefficients[j + 1], coefficients[j]));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(x, c));
+    }
+    if (j < coefficients_length) {
+      // The last tap of an odd length filter, paired with a zero.
+      const __m128i x = _mm_set_epi32(LoadPair(x3 - j), LoadPair(x2 - j),
+                                      LoadPair(x1 - j), LoadPair(x0 - j));
+      const __m128i c = _mm_set1_epi32(CoefficientPair(coefficients[j], 0));
+      sum = _mm_add_epi32(sum, _mm_madd_epi16(x, c));
+    }
+
+    // Q12 to Q0, and saturate.
+    sum = _mm_srai_epi32(sum, 12);
+    _mm_storel_epi64((__m128i*)(data_out + out), _mm_packs_epi32(sum, sum));
+  }
+
+  for (; out < data_out_length; i += factor, out++) {
+    int32_t out_s32 = 2048;
+    for (j = 0; j < coefficients_length; j++)
+      out_s32 += coefficients[j] * data_in[(ptrdiff_t) i - (ptrdiff_t) j];
+    data_out[out] = WebRtcSpl_SatW32ToW16(out_s32 >> 12);
+  }
+
+  return 0;
+}
@@ -106,7 +106,8 @@ extern "C" {
 
 // Initialize SPL. Currently it contains only function pointer initialization.
 // If the underlying platform is known to be ARM-Neon (WEBRTC_HAS_NEON defined),
-// the pointers will be assigned to code optimized for Neon; otherwise, generic
+// the pointers will be assigned to code optimized for Neon. On x86, the SSE2
+// and AVX2 versions are used when the CPU supports them. Otherwise, generic
 // C code will be assigned.
 // Note that this function MUST be called in any application that uses SPL
 // functions.
@@ -154,6 +155,9 @@ int16_t WebRtcSpl_MaxAbsValueW16C(const int16_t* vector, size_t length);
 #if defined(WEBRTC_HAS_NEON)
 int16_t WebRtcSpl_MaxAbsValueW16Neon(const int16_t* vector, size_t length);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length);
+#endif
 #if defined(MIPS32_LE)
 int16_t WebRtcSpl_MaxAbsValueW16_mips(const int16_t* vector, size_t length);
 #endif
@@ -243,6 +247,32 @@ int32_t WebRtcSpl_MinValueW32Neon(const int32_t* vector, size_t length);
 int32_t WebRtcSpl_MinValueW32_mips(const int32_t* vector, size_t length);
 #endif
 
+// Returns the sum of the squared samples of a signed 16-bit vector, and
+// computes its largest absolute value in the same pass. This is all the
+// audio level measurements need, so they only read each frame once.
+//
+// Input:
+//      - vector : 16-bit input vector.
+//      - length : Number of samples in vector.
+//
+// Output:
+//      - max_abs_value : Maximum absolute value in vector, saturated to
+//                        32767. May be NULL.
+//
+// Return value  : Sum of the squared samples in vector.
+typedef int64_t (*SquaredSumAndMaxAbsW16)(const int16_t* vector,
+                                          size_t length,
+                                          int16_t* max_abs_value);
+extern SquaredSumAndMaxAbsW16 WebRtcSpl_SquaredSumAndMaxAbsW16;
+int64_t WebRtcSpl_SquaredSumAndMaxAbsW16C(const int16_t* vector,
+                                          size_t length,
+                                          int16_t* max_abs_value);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int64_t WebRtcSpl_SquaredSumAndMaxAbsW16SSE2(const int16_t* vector,
+                                             size_t length,
+                                             int16_t* max_abs_value);
+#endif
+
 // Returns the vector index to the largest absolute value of a 16-bit vector.
 //
 // Input:
@@ -538,6 +568,22 @@ void WebRtcSpl_CrossCorrelationNeon(int32_t* cross_correlation,
                                     int right_shifts,
                                     int step_seq2);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void WebRtcSpl_CrossCorrelationSSE2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2);
+void WebRtcSpl_CrossCorrelationAVX2(int32_t* cross_correlation,
+                                    const int16_t* seq1,
+                                    const int16_t* seq2,
+                                    size_t dim_seq,
+                                    size_t dim_cross_correlation,
+                                    int right_shifts,
+                                    int step_seq2);
+#endif
 #if defined(MIPS32_LE)
 void WebRtcSpl_CrossCorrelation_mips(int32_t* cross_correlation,
                                      const int16_t* seq1,
@@ -690,6 +736,16 @@ int WebRtcSpl_DownsampleFastNeon(const int16_t* data_in,
                                  int factor,
                                  size_t delay);
 #endif
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+int WebRtcSpl_DownsampleFastSSE2(const int16_t* data_in,
+                                 size_t data_in_length,
+                                 int16_t* data_out,
+                                 size_t data_out_length,
+                                 const int16_t* __restrict coefficients,
+                                 size_t coefficients_length,
+                                 int factor,
+                                 size_t delay);
+#endif
 #if defined(MIPS32_LE)
 int WebRtcSpl_DownsampleFast_mips(const int16_t* data_in,
                                   size_t data_in_length,
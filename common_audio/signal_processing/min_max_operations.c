@@ -16,6 +16,7 @@
  * WebRtcSpl_MaxValueW32C()
  * WebRtcSpl_MinValueW16C()
  * WebRtcSpl_MinValueW32C()
+ * WebRtcSpl_SquaredSumAndMaxAbsW16C()
  * WebRtcSpl_MaxAbsIndexW16()
  * WebRtcSpl_MaxIndexW16()
  * WebRtcSpl_MaxIndexW32()
@@ -134,6 +135,30 @@ int32_t WebRtcSpl_MinValueW32C(const int32_t* vector, size_t length) {
   return minimum;
 }
 
+// Sum of squares and maximum absolute value of word16 vector. C version for
+// generic platforms.
+int64_t WebRtcSpl_SquaredSumAndMaxAbsW16C(const int16_t* vector,
+                                          size_t length,
+                                          int16_t* max_abs_value) {
+  int64_t sum = 0;
+  int absolute = 0, maximum = 0;
+  size_t i = 0;
+
+  for (i = 0; i < length; i++) {
+    sum += vector[i] * vector[i];
+    absolute = abs((int)vector[i]);
+    if (absolute > maximum) {
+      maximum = absolute;
+    }
+  }
+
+  if (max_abs_value) {
+    // Guard the case for abs(-32768).
+    *max_abs_value = (int16_t)WEBRTC_SPL_MIN(maximum, WEBRTC_SPL_WORD16_MAX);
+  }
+  return sum;
+}
+
 // Index of maximum absolute value in a word16 vector.
 size_t WebRtcSpl_MaxAbsIndexW16(const int16_t* vector, size_t length) {
   // Use type int for local variables, to accomodate the value of abs(-32768).
@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+
+#include <emmintrin.h>
+#include <stddef.h>
+
+#include "rtc_base/checks.h"
+
+// Returns the largest of the eight 16-bit values in |v|.
+static inline int HorizontalMaxW16(__m128i v) {
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_max_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+// Returns the smallest of the eight 16-bit values in |v|.
+static inline int HorizontalMinW16(__m128i v) {
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_min_epi16(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  v = _mm_min_epi16(v, _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return (int16_t)_mm_cvtsi128_si32(v);
+}
+
+// Returns the largest absolute value given the largest and smallest samples,
+// saturated to 32767.
+static inline int16_t MaxAbsFromRange(int maximum, int minimum) {
+  int absolute = WEBRTC_SPL_MAX(maximum, -minimum);
+  return (int16_t)WEBRTC_SPL_MIN(absolute, WEBRTC_SPL_WORD16_MAX);
+}
+
+// SSE2 version of WebRtcSpl_MaxAbsValueW16() for x86 platforms.
+// The absolute value is not representable for -32768, so the largest and
+// smallest samples are tracked instead.
+int16_t WebRtcSpl_MaxAbsValueW16SSE2(const int16_t* vector, size_t length) {
+  __m128i max_value = _mm_setzero_si128();
+  __m128i min_value = _mm_setzero_si128();
+  int maximum = 0;
+  int minimum = 0;
+  size_t i = 0;
+
+  RTC_DCHECK_GT(length, 0);
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    max_value = _mm_max_epi16(max_value, v);
+    min_value = _mm_min_epi16(min_value, v);
+  }
+  maximum = HorizontalMaxW16(max_value);
+  minimum = HorizontalMinW16(min_value);
+
+  for (; i < length; i++) {
+    maximum = WEBRTC_SPL_MAX(maximum, vector[i]);
+    minimum = WEBRTC_SPL_MIN(minimum, vector[i]);
+  }
+
+  return MaxAbsFromRange(maximum, minimum);
+}
+
+// SSE2 version of WebRtcSpl_SquaredSumAndMaxAbsW16() for x86 platforms.
+// Eight samples are squared and pairwise added per multiply-add. A pair sum
+// only exceeds INT32_MAX for two samples of -32768, so it is widened as an
+// unsigned value into the 64-bit accumulators.
+int64_t WebRtcSpl_SquaredSumAndMaxAbsW16SSE2(const int16_t* vector,
+                                             size_t length,
+                                             int16_t* max_abs_value) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i sum = _mm_setzero_si128();
+  __m128i max_value = _mm_setzero_si128();
+  __m128i min_value = _mm_setzero_si128();
+  int64_t sums[2];
+  int64_t result = 0;
+  int maximum = 0;
+  int minimum = 0;
+  size_t i = 0;
+
+  for (; i + 8 <= length; i += 8) {
+    const __m128i v = _mm_loadu_si128((const __m128i*)&vector[i]);
+    const __m128i squares = _mm_madd_epi16(v, v);
+    sum = _mm_add_epi64(sum, _mm_unpacklo_epi32(squares, zero));
+    sum = _mm_add_epi64(sum, _mm_unpackhi_epi32(squares, zero));
+    max_value = _mm_max_epi16(max_value, v);
+    min_value = _mm_min_epi16(min_value, v);
+  }
+  _mm_storeu_si128((__m128i*)sums, sum);
+  result = sums[0] + sums[1];
+  maximum = HorizontalMaxW16(max_value);
+  minimum = HorizontalMinW16(min_value);
+
+  for (; i < length; i++) {
+    result += vector[i] * vector[i];
+    maximum = WEBRTC_SPL_MAX(maximum, vector[i]);
+    minimum = WEBRTC_SPL_MIN(minimum, vector[i]);
+  }
+
+  if (max_abs_value) {
+    *max_abs_value = MaxAbsFromRange(maximum, minimum);
+  }
+  return result;
+}
@@ -10,8 +10,11 @@
 
 #include <algorithm>
 #include <sstream>
+#include <vector>
 
 #include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
 
 static const size_t kVector16Size = 9;
@@ -309,6 +312,16 @@ TEST_F(SplTest, MinMaxOperationsTest) {
   EXPECT_EQ(1u, WebRtcSpl_MaxIndexW32(vector32, kVectorSize));
   EXPECT_EQ(6u, WebRtcSpl_MinIndexW16(vector16, kVectorSize));
   EXPECT_EQ(6u, WebRtcSpl_MinIndexW32(vector32, kVectorSize));
+
+  int64_t squared_sum = 0;
+  for (size_t i = 0; i < kVectorSize; ++i)
+    squared_sum += vector16[i] * vector16[i];
+  int16_t max_abs_value = 0;
+  EXPECT_EQ(squared_sum, WebRtcSpl_SquaredSumAndMaxAbsW16(
+                             vector16, kVectorSize, &max_abs_value));
+  EXPECT_EQ(WEBRTC_SPL_WORD16_MAX, max_abs_value);
+  EXPECT_EQ(0, WebRtcSpl_SquaredSumAndMaxAbsW16(vector16, 0, &max_abs_value));
+  EXPECT_EQ(0, max_abs_value);
 }
 
 TEST_F(SplTest, VectorOperationsTest) {
@@ -472,14 +485,14 @@ TEST_F(SplTest, CrossCorrelationTest) {
                              kCrossCorrelationDimension, kShift, kStep);
 
   // WebRtcSpl_CrossCorrelationC() and WebRtcSpl_CrossCorrelationNeon()
-  // are not bit-exact.
+  // are not bit-exact. The x86 versions are.
   const int32_t kExpected[kCrossCorrelationDimension] =
       {-266947903, -15579555, -171282001};
   const int32_t* expected = kExpected;
-#if !defined(MIPS32_LE)
+#if defined(WEBRTC_HAS_NEON)
   const int32_t kExpectedNeon[kCrossCorrelationDimension] =
       {-266947901, -15579553, -171281999};
-  if (WebRtcSpl_CrossCorrelation != WebRtcSpl_CrossCorrelationC) {
+  if (WebRtcSpl_CrossCorrelation == WebRtcSpl_CrossCorrelationNeon) {
     expected = kExpectedNeon;
   }
 #endif
@@ -488,6 +501,131 @@ TEST_F(SplTest, CrossCorrelationTest) {
   }
 }
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+namespace {
+
+// Includes the extreme values, whose products overflow when summed.
+std::vector<int16_t> RandomSamples(size_t size, webrtc::Random* random) {
+  std::vector<int16_t> samples(size);
+  for (int16_t& sample : samples) {
+    const int kind = random->Rand(9);
+    sample = kind == 0 ? WEBRTC_SPL_WORD16_MIN
+                       : kind == 1 ? WEBRTC_SPL_WORD16_MAX
+                                   : random->Rand<int16_t>();
+  }
+  return samples;
+}
+
+}  // namespace
+
+TEST_F(SplTest, CrossCorrelationX86MatchesC) {
+  std::vector<CrossCorrelation> versions = {WebRtcSpl_CrossCorrelationSSE2};
+  if (WebRtc_GetCPUInfo(kAVX2))
+    versions.push_back(WebRtcSpl_CrossCorrelationAVX2);
+  webrtc::Random random(0x5eed);
+  const size_t kDimCrossCorrelation = 24;
+  for (size_t dim_seq : {7, 8, 31, 60, 120}) {
+    for (int step : {-1, 1}) {
+      for (int shift = 0; shift < 4; ++shift) {
+        const std::vector<int16_t> seq1 = RandomSamples(dim_seq, &random);
+        const std::vector<int16_t> seq2 =
+            RandomSamples(dim_seq + kDimCrossCorrelation, &random);
+        // Steps backwards from the end.
+        const int16_t* start =
+            step > 0 ? seq2.data() : seq2.data() + kDimCrossCorrelation;
+        int32_t expected[kDimCrossCorrelation];
+        WebRtcSpl_CrossCorrelationC(expected, seq1.data(), start, dim_seq,
+                                    kDimCrossCorrelation, shift, step);
+        for (CrossCorrelation version : versions) {
+          int32_t actual[kDimCrossCorrelation];
+          version(actual, seq1.data(), start, dim_seq, kDimCrossCorrelation,
+                  shift, step);
+          for (size_t i = 0; i < kDimCrossCorrelation; ++i)
+            EXPECT_EQ(expected[i], actual[i]) << dim_seq << " " << shift;
+        }
+      }
+    }
+  }
+}
+
+TEST_F(SplTest, DownsampleFastX86MatchesC) {
+  webrtc::Random random(0x5eed);
+  // The filters NetEq uses to downsample to 4 kHz have 3 to 7 taps.
+  for (size_t coefficients_length = 1; coefficients_length <= 8;
+       ++coefficients_length) {
+    for (int factor : {2, 4, 8, 12}) {
+      const size_t kDelay = 0;
+      const size_t kHistory = coefficients_length;
+      const size_t data_out_length = 41;
+      const size_t data_in_length = factor * (data_out_length - 1) + 1;
+      const std::vector<int16_t> coefficients =
+          RandomSamples(coefficients_length, &random);
+      // The filters read samples before |data_in|.
+      const std::vector<int16_t> data =
+          RandomSamples(kHistory + data_in_length, &random);
+      std::vector<int16_t> expected(data_out_length);
+      std::vector<int16_t> actual(data_out_length);
+      EXPECT_EQ(0, WebRtcSpl_DownsampleFastC(
+                       data.data() + kHistory, data_in_length,
+                       expected.data(), data_out_length, coefficients.data(),
+                       coefficients_length, factor, kDelay));
+      EXPECT_EQ(0, WebRtcSpl_DownsampleFastSSE2(
+                       data.data() + kHistory, data_in_length, actual.data(),
+                       data_out_length, coefficients.data(),
+                       coefficients_length, factor, kDelay));
+      EXPECT_EQ(expected, actual) << coefficients_length << " " << factor;
+    }
+  }
+}
+
+TEST_F(SplTest, LevelOperationsX86MatchesC) {
+  webrtc::Random random(0x5eed);
+  for (size_t length : {1, 7, 8, 9, 160, 480, 1920}) {
+    for (int i = 0; i < 10; ++i) {
+      std::vector<int16_t> samples = RandomSamples(length, &random);
+      // Also cover a buffer of only the most negative value.
+      if (i == 0)
+        std::fill(samples.begin(), samples.end(), WEBRTC_SPL_WORD16_MIN);
+      int16_t expected_max_abs = 0;
+      int16_t actual_max_abs = 0;
+      EXPECT_EQ(WebRtcSpl_SquaredSumAndMaxAbsW16C(samples.data(), length,
+                                                  &expected_max_abs),
+                WebRtcSpl_SquaredSumAndMaxAbsW16SSE2(samples.data(), length,
+                                                     &actual_max_abs))
+          << length;
+      EXPECT_EQ(expected_max_abs, actual_max_abs) << length;
+      EXPECT_EQ(WebRtcSpl_MaxAbsValueW16C(samples.data(), length),
+                WebRtcSpl_MaxAbsValueW16SSE2(samples.data(), length))
+          << length;
+    }
+  }
+}
+#endif  // defined(WEBRTC_ARCH_X86_FAMILY)
+
+TEST_F(SplTest, DotProductWithScaleMatchesScalarSum) {
+  webrtc::Random random(0x5eed);
+  for (size_t length : {1, 8, 13, 64, 240}) {
+    for (int scaling = 0; scaling < 3; ++scaling) {
+      std::vector<int16_t> vector1(length, WEBRTC_SPL_WORD16_MIN);
+      std::vector<int16_t> vector2(length, WEBRTC_SPL_WORD16_MIN);
+      // Half the products are the largest possible.
+      for (size_t i = 0; i < length; i += 2) {
+        vector1[i] = random.Rand<int16_t>();
+        vector2[i] = random.Rand<int16_t>();
+      }
+      int64_t sum = 0;
+      for (size_t i = 0; i < length; ++i)
+        sum += (vector1[i] * vector2[i]) >> scaling;
+      const int32_t expected = static_cast<int32_t>(std::min<int64_t>(
+          std::max<int64_t>(sum, WEBRTC_SPL_WORD32_MIN),
+          WEBRTC_SPL_WORD32_MAX));
+      EXPECT_EQ(expected,
+                WebRtcSpl_DotProductWithScale(vector1.data(), vector2.data(),
+                                              length, scaling));
+    }
+  }
+}
+
 TEST_F(SplTest, AutoCorrelationTest) {
   int scale = 0;
   int32_t vector32[kVector16Size];
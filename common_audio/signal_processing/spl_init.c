@@ -9,7 +9,7 @@
  */
 
 /* The global function contained in this file initializes SPL function
- * pointers, currently only for ARM platforms.
+ * pointers, currently for ARM, MIPS and x86 platforms.
  *
  * Some code came from common/rtcd.c in the WebM project.
  */
@@ -24,6 +24,7 @@ MaxValueW16 WebRtcSpl_MaxValueW16;
 MaxValueW32 WebRtcSpl_MaxValueW32;
 MinValueW16 WebRtcSpl_MinValueW16;
 MinValueW32 WebRtcSpl_MinValueW32;
+SquaredSumAndMaxAbsW16 WebRtcSpl_SquaredSumAndMaxAbsW16;
 CrossCorrelation WebRtcSpl_CrossCorrelation;
 DownsampleFast WebRtcSpl_DownsampleFast;
 ScaleAndAddVectorsWithRound WebRtcSpl_ScaleAndAddVectorsWithRound;
@@ -37,6 +38,7 @@ static void InitPointersToC(void) {
   WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32C;
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16C;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32C;
+  WebRtcSpl_SquaredSumAndMaxAbsW16 = WebRtcSpl_SquaredSumAndMaxAbsW16C;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
@@ -44,6 +46,23 @@ static void InitPointersToC(void) {
 }
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+/* Override the function pointers that have SSE2 or AVX2 versions, if the CPU
+ * supports them. */
+static void InitPointersToX86(void) {
+#if !defined(__SSE2__)
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+#endif
+  WebRtcSpl_MaxAbsValueW16 = WebRtcSpl_MaxAbsValueW16SSE2;
+  WebRtcSpl_SquaredSumAndMaxAbsW16 = WebRtcSpl_SquaredSumAndMaxAbsW16SSE2;
+  WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationSSE2;
+  WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastSSE2;
+  if (WebRtc_GetCPUInfo(kAVX2))
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationAVX2;
+}
+#endif
+
 #if defined(WEBRTC_HAS_NEON)
 /* Initialize function pointers to the Neon version. */
 static void InitPointersToNeon(void) {
@@ -53,6 +72,7 @@ static void InitPointersToNeon(void) {
   WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32Neon;
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16Neon;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32Neon;
+  WebRtcSpl_SquaredSumAndMaxAbsW16 = WebRtcSpl_SquaredSumAndMaxAbsW16C;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationNeon;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastNeon;
   WebRtcSpl_ScaleAndAddVectorsWithRound =
@@ -68,6 +88,7 @@ static void InitPointersToMIPS(void) {
   WebRtcSpl_MaxValueW32 = WebRtcSpl_MaxValueW32_mips;
   WebRtcSpl_MinValueW16 = WebRtcSpl_MinValueW16_mips;
   WebRtcSpl_MinValueW32 = WebRtcSpl_MinValueW32_mips;
+  WebRtcSpl_SquaredSumAndMaxAbsW16 = WebRtcSpl_SquaredSumAndMaxAbsW16C;
   WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelation_mips;
   WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFast_mips;
 #if defined(MIPS_DSP_R1_LE)
@@ -89,6 +110,9 @@ static void InitFunctionPointers(void) {
   InitPointersToMIPS();
 #else
   InitPointersToC();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  InitPointersToX86();
+#endif
 #endif  /* WEBRTC_HAS_NEON */
 }
 
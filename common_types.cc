@@ -81,6 +81,7 @@ VideoCodec::VideoCodec()
       mode(kRealtimeVideo),
       expect_encode_from_texture(false),
       timing_frame_thresholds({0, 0}),
+      performance_profile({0, false, 0}),
       codec_specific_() {}
 
 VideoCodecVP8* VideoCodec::VP8() {
@@ -495,6 +495,21 @@ class VideoCodec {
     uint16_t outlier_ratio_percent;
   } timing_frame_thresholds;
 
+  // Encoder performance profile. With the defaults, encoders pick their
+  // thread count and speed preset from resolution, platform and number of
+  // cores.
+  struct PerformanceProfile {
+    // Upper bound on the number of encoder threads, which also bounds the
+    // number of VP9 tile columns. 0 means no bound beyond the heuristic.
+    int max_threads;
+    // If set, the encoder raises its real-time speed preset while encoding
+    // takes up too much of the frame interval, up to |max_speed|, and lowers
+    // it back to the default when there is headroom again. |max_speed| is a
+    // libvpx cpu-used magnitude; 0 means the fastest real-time preset.
+    bool adaptive_speed;
+    int max_speed;
+  } performance_profile;
+
   bool operator==(const VideoCodec& other) const = delete;
   bool operator!=(const VideoCodec& other) const = delete;
 
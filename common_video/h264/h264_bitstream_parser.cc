@@ -9,6 +9,8 @@
  */
 #include "common_video/h264/h264_bitstream_parser.h"
 
+#include <string.h>
+
 #include <memory>
 #include <vector>
 
@@ -22,6 +24,13 @@ namespace {
 const int kMaxAbsQpDeltaValue = 51;
 const int kMinQpValue = 0;
 const int kMaxQpValue = 51;
+// Slice headers are normally a few dozen bytes. Only this much of a slice is
+// unpacked from RBSP; longer headers fall back to unpacking the whole slice.
+const size_t kMaxSliceHeaderSize = 256;
+
+bool NaluEquals(const rtc::Buffer& nalu, const uint8_t* data, size_t length) {
+  return nalu.size() == length && memcmp(nalu.data(), data, length) == 0;
+}
 }
 
 namespace webrtc {
@@ -45,17 +54,32 @@ H264BitstreamParser::Result H264BitstreamParser::ParseNonParameterSetNalu(
     return kInvalidStream;
 
   last_slice_qp_delta_ = rtc::nullopt;
-  const std::vector<uint8_t> slice_rbsp =
-      H264::ParseRbsp(source, source_length);
-  if (slice_rbsp.size() < H264::kNaluTypeSize)
+  uint8_t slice_header[kMaxSliceHeaderSize];
+  const size_t slice_header_size = H264::ParseRbsp(
+      source, source_length, slice_header, sizeof(slice_header));
+  Result result = ParseSliceHeader(slice_header, slice_header_size, nalu_type);
+  if (result == kInvalidStream && slice_header_size == sizeof(slice_header)) {
+    // The header may have been cut off, retry with the whole slice.
+    const std::vector<uint8_t> slice_rbsp =
+        H264::ParseRbsp(source, source_length);
+    result = ParseSliceHeader(slice_rbsp.data(), slice_rbsp.size(), nalu_type);
+  }
+  return result;
+}
+
+H264BitstreamParser::Result H264BitstreamParser::ParseSliceHeader(
+    const uint8_t* slice_rbsp,
+    size_t slice_rbsp_length,
+    uint8_t nalu_type) {
+  if (slice_rbsp_length < H264::kNaluTypeSize)
     return kInvalidStream;
 
-  rtc::BitBuffer slice_reader(slice_rbsp.data() + H264::kNaluTypeSize,
-                              slice_rbsp.size() - H264::kNaluTypeSize);
+  rtc::BitBuffer slice_reader(slice_rbsp + H264::kNaluTypeSize,
+                              slice_rbsp_length - H264::kNaluTypeSize);
   // Check to see if this is an IDR slice, which has an extra field to parse
   // out.
-  bool is_idr = (source[0] & 0x0F) == H264::NaluType::kIdr;
-  uint8_t nal_ref_idc = (source[0] & 0x60) >> 5;
+  bool is_idr = (slice_rbsp[0] & 0x0F) == H264::NaluType::kIdr;
+  uint8_t nal_ref_idc = (slice_rbsp[0] & 0x60) >> 5;
   uint32_t golomb_tmp;
   uint32_t bits_tmp;
 
@@ -270,17 +294,26 @@ void H264BitstreamParser::ParseSlice(const uint8_t* slice, size_t length) {
   H264::NaluType nalu_type = H264::ParseNaluType(slice[0]);
   switch (nalu_type) {
     case H264::NaluType::kSps: {
+      // Encoders repeat the same SPS on every key frame, only parse changes.
+      if (sps_ && NaluEquals(last_sps_nalu_, slice, length))
+        break;
       sps_ = SpsParser::ParseSps(slice + H264::kNaluTypeSize,
                                  length - H264::kNaluTypeSize);
       if (!sps_)
         RTC_LOG(LS_WARNING) << "Unable to parse SPS from H264 bitstream.";
+      else
+        last_sps_nalu_.SetData(slice, length);
       break;
     }
     case H264::NaluType::kPps: {
+      if (pps_ && NaluEquals(last_pps_nalu_, slice, length))
+        break;
       pps_ = PpsParser::ParsePps(slice + H264::kNaluTypeSize,
                                  length - H264::kNaluTypeSize);
       if (!pps_)
         RTC_LOG(LS_WARNING) << "Unable to parse PPS from H264 bitstream.";
+      else
+        last_pps_nalu_.SetData(slice, length);
       break;
     }
     case H264::NaluType::kAud:
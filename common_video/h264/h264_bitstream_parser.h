@@ -16,6 +16,7 @@
 #include "api/optional.h"
 #include "common_video/h264/pps_parser.h"
 #include "common_video/h264/sps_parser.h"
+#include "rtc_base/buffer.h"
 
 namespace rtc {
 class BitBufferWriter;
@@ -51,10 +52,19 @@ class H264BitstreamParser {
   Result ParseNonParameterSetNalu(const uint8_t* source,
                                   size_t source_length,
                                   uint8_t nalu_type);
+  // Parses an already unpacked slice, starting with the NALU header. Only the
+  // slice header up to slice_qp_delta is needed.
+  Result ParseSliceHeader(const uint8_t* slice_rbsp,
+                          size_t slice_rbsp_length,
+                          uint8_t nalu_type);
 
   // SPS/PPS state, updated when parsing new SPS/PPS, used to parse slices.
   rtc::Optional<SpsParser::SpsState> sps_;
   rtc::Optional<PpsParser::PpsState> pps_;
+  // The NALUs |sps_| and |pps_| were parsed from, so repeated parameter sets
+  // aren't parsed again.
+  rtc::Buffer last_sps_nalu_;
+  rtc::Buffer last_pps_nalu_;
 
   // Last parsed slice QP.
   rtc::Optional<int32_t> last_slice_qp_delta_;
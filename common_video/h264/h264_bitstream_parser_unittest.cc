@@ -10,6 +10,12 @@
 
 #include "common_video/h264/h264_bitstream_parser.h"
 
+#include <string.h>
+
+#include <iterator>
+#include <vector>
+
+#include "common_video/h264/h264_common.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -85,4 +91,53 @@ TEST(H264BitstreamParserTest, ReportsLastSliceQpForCABACImageSlices) {
   EXPECT_EQ(24, qp);
 }
 
+TEST(H264BitstreamParserTest, ReportsQpWhenParameterSetsRepeat) {
+  H264BitstreamParser h264_parser;
+  int qp;
+  for (int i = 0; i < 3; ++i) {
+    h264_parser.ParseBitstream(kH264BitstreamChunk,
+                               sizeof(kH264BitstreamChunk));
+    ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+    EXPECT_EQ(35, qp);
+    h264_parser.ParseBitstream(kH264BitstreamNextImageSliceChunk,
+                               sizeof(kH264BitstreamNextImageSliceChunk));
+    ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+    EXPECT_EQ(37, qp);
+  }
+}
+
+TEST(H264BitstreamParserTest, ReportsQpForSliceLongerThanHeaderPrefix) {
+  H264BitstreamParser h264_parser;
+  h264_parser.ParseBitstream(kH264SpsPps, sizeof(kH264SpsPps));
+  // Slice data after the header, with emulation prevention bytes, must not
+  // affect the parsed QP.
+  std::vector<uint8_t> bitstream(std::begin(kH264BitstreamNextImageSliceChunk),
+                                 std::end(kH264BitstreamNextImageSliceChunk));
+  for (int i = 0; i < 1000; ++i) {
+    const uint8_t kEscapedZeros[] = {0x00, 0x00, 0x03, 0x01};
+    bitstream.insert(bitstream.end(), std::begin(kEscapedZeros),
+                     std::end(kEscapedZeros));
+  }
+  h264_parser.ParseBitstream(bitstream.data(), bitstream.size());
+  int qp;
+  ASSERT_TRUE(h264_parser.GetLastSliceQp(&qp));
+  EXPECT_EQ(37, qp);
+}
+
+TEST(H264BitstreamParserTest, ParseRbspIntoBoundedBuffer) {
+  const uint8_t kEscaped[] = {0x01, 0x00, 0x00, 0x03, 0x00, 0x00,
+                              0x00, 0x03, 0x03, 0x02};
+  const std::vector<uint8_t> unescaped =
+      H264::ParseRbsp(kEscaped, sizeof(kEscaped));
+  uint8_t buffer[sizeof(kEscaped)];
+  ASSERT_EQ(unescaped.size(),
+            H264::ParseRbsp(kEscaped, sizeof(kEscaped), buffer,
+                            sizeof(buffer)));
+  EXPECT_EQ(0, memcmp(unescaped.data(), buffer, unescaped.size()));
+
+  // Stops when the destination is full.
+  EXPECT_EQ(4u, H264::ParseRbsp(kEscaped, sizeof(kEscaped), buffer, 4));
+  EXPECT_EQ(0, memcmp(unescaped.data(), buffer, 4));
+}
+
 }  // namespace webrtc
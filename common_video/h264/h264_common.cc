@@ -83,6 +83,22 @@ std::vector<uint8_t> ParseRbsp(const uint8_t* data, size_t length) {
   return out;
 }
 
+size_t ParseRbsp(const uint8_t* data,
+                 size_t length,
+                 uint8_t* destination,
+                 size_t destination_capacity) {
+  size_t out = 0;
+  for (size_t i = 0; i < length && out < destination_capacity;) {
+    if (i >= 2 && data[i] == 3 && !data[i - 1] && !data[i - 2]) {
+      // Skip the emulation byte.
+      ++i;
+      continue;
+    }
+    destination[out++] = data[i++];
+  }
+  return out;
+}
+
 void WriteRbsp(const uint8_t* bytes, size_t length, rtc::Buffer* destination) {
   static const uint8_t kZerosInStartSequence = 2;
   static const uint8_t kEmulationByte = 0x03u;
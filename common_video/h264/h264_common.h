@@ -78,6 +78,15 @@ NaluType ParseNaluType(uint8_t data);
 // Parse the given data and remove any emulation byte escaping.
 std::vector<uint8_t> ParseRbsp(const uint8_t* data, size_t length);
 
+// Like above, but writes at most |destination_capacity| bytes to
+// |destination| and returns the number of bytes written. Stops as soon as
+// |destination| is full, so that the start of a large NALU, e.g. a slice
+// header, can be unpacked without allocating or touching the rest of it.
+size_t ParseRbsp(const uint8_t* data,
+                 size_t length,
+                 uint8_t* destination,
+                 size_t destination_capacity);
+
 // Write the given data to the destination buffer, inserting and emulation
 // bytes in order to escape any data the could be interpreted as a start
 // sequence.
@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/hugepage_frame_allocator.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/memory/aligned_malloc.h"
+
+#if defined(WEBRTC_LINUX)
+#include <sys/mman.h>
+#endif
+
+namespace webrtc {
+
+namespace {
+
+constexpr size_t kSmallPageSize = 4096;
+
+size_t RoundUp(size_t size, size_t multiple) {
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+// The offset of an allocation of |color| from the start of its mapping. A
+// multiple of both the cache line size and |alignment|.
+size_t ColorOffset(size_t color, size_t alignment) {
+  return color * std::max(alignment,
+                          HugePageFrameAllocator::kCacheLineSize);
+}
+
+#if defined(WEBRTC_LINUX)
+// Returns |length| bytes starting at a huge page boundary, or nullptr.
+uint8_t* MapAligned(size_t length) {
+  const size_t padded_length = length + HugePageFrameAllocator::kHugePageSize;
+  void* mapping = mmap(nullptr, padded_length, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (mapping == MAP_FAILED)
+    return nullptr;
+  uint8_t* start = static_cast<uint8_t*>(mapping);
+  uint8_t* aligned = reinterpret_cast<uint8_t*>(
+      RoundUp(reinterpret_cast<uintptr_t>(start),
+              HugePageFrameAllocator::kHugePageSize));
+  // Unmap the padding on both sides.
+  if (aligned > start)
+    munmap(start, aligned - start);
+  uint8_t* end = start + padded_length;
+  if (end > aligned + length)
+    munmap(aligned + length, end - (aligned + length));
+  return aligned;
+}
+#endif
+
+}  // namespace
+
+const size_t HugePageFrameAllocator::kHugePageSize;
+const size_t HugePageFrameAllocator::kMinHugePageAllocationBytes;
+const size_t HugePageFrameAllocator::kCacheLineSize;
+const size_t HugePageFrameAllocator::kNumCacheColors;
+
+HugePageFrameAllocator::HugePageFrameAllocator(Mode mode) : mode_(mode) {}
+
+HugePageFrameAllocator::~HugePageFrameAllocator() {
+  RTC_DCHECK_EQ(0, stats_.mapped_bytes);
+}
+
+uint8_t* HugePageFrameAllocator::Allocate(size_t size, size_t alignment) {
+  RTC_DCHECK_GT(alignment, 0);
+  RTC_DCHECK_EQ(0, alignment & (alignment - 1));
+#if defined(WEBRTC_LINUX)
+  if (size >= kMinHugePageAllocationBytes) {
+    size_t color;
+    {
+      rtc::CritScope cs(&crit_);
+      color = next_color_;
+      next_color_ = (next_color_ + 1) % kNumCacheColors;
+    }
+    const size_t offset = ColorOffset(color, alignment);
+    RTC_DCHECK_LT(offset, kHugePageSize);
+    const size_t length = RoundUp(offset + size, kHugePageSize);
+
+    uint8_t* mapping = nullptr;
+    bool explicit_huge_pages = false;
+    if (mode_ == Mode::kExplicit) {
+      void* huge = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (huge != MAP_FAILED) {
+        mapping = static_cast<uint8_t*>(huge);
+        explicit_huge_pages = true;
+      }
+    }
+    if (!mapping) {
+      mapping = MapAligned(length);
+      if (mapping)
+        madvise(mapping, length, MADV_HUGEPAGE);
+    }
+
+    rtc::CritScope cs(&crit_);
+    if (!mapping) {
+      ++stats_.failed_allocations;
+      return nullptr;
+    }
+    if (explicit_huge_pages)
+      ++stats_.explicit_huge_page_allocations;
+    else
+      ++stats_.transparent_huge_page_allocations;
+    stats_.mapped_bytes += length;
+    stats_.estimated_page_faults_avoided +=
+        length / kSmallPageSize - length / kHugePageSize;
+    return mapping + offset;
+  }
+#endif
+  {
+    rtc::CritScope cs(&crit_);
+    ++stats_.small_allocations;
+  }
+  return static_cast<uint8_t*>(AlignedMalloc(size, alignment));
+}
+
+void HugePageFrameAllocator::Free(uint8_t* data, size_t size) {
+  if (!data)
+    return;
+#if defined(WEBRTC_LINUX)
+  if (size >= kMinHugePageAllocationBytes) {
+    // Mappings start at a huge page boundary, and the color offset is less
+    // than a huge page.
+    uint8_t* mapping = reinterpret_cast<uint8_t*>(
+        reinterpret_cast<uintptr_t>(data) & ~(kHugePageSize - 1));
+    const size_t length = RoundUp((data - mapping) + size, kHugePageSize);
+    munmap(mapping, length);
+    rtc::CritScope cs(&crit_);
+    RTC_DCHECK_GE(stats_.mapped_bytes, length);
+    stats_.mapped_bytes -= length;
+    return;
+  }
+#endif
+  AlignedFree(data);
+}
+
+HugePageFrameAllocator::Stats HugePageFrameAllocator::GetStats() const {
+  rtc::CritScope cs(&crit_);
+  return stats_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "common_video/include/hugepage_frame_allocator.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+// A 1080p I420 frame.
+constexpr size_t kLargeSize = 1920 * 1080 * 3 / 2;
+constexpr size_t kAlignment = 64;
+}  // namespace
+
+TEST(HugePageFrameAllocatorTest, SmallAllocationsUseTheHeap) {
+  HugePageFrameAllocator allocator(HugePageFrameAllocator::Mode::kTransparent);
+  uint8_t* data = allocator.Allocate(1024, kAlignment);
+  ASSERT_TRUE(data);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % kAlignment);
+  memset(data, 0xab, 1024);
+  allocator.Free(data, 1024);
+  HugePageFrameAllocator::Stats stats = allocator.GetStats();
+  EXPECT_EQ(1u, stats.small_allocations);
+  EXPECT_EQ(0u, stats.mapped_bytes);
+}
+
+#if defined(WEBRTC_LINUX)
+TEST(HugePageFrameAllocatorTest, LargeAllocationsAreMapped) {
+  HugePageFrameAllocator allocator(HugePageFrameAllocator::Mode::kTransparent);
+  uint8_t* data = allocator.Allocate(kLargeSize, kAlignment);
+  ASSERT_TRUE(data);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(data) % kAlignment);
+  memset(data, 0xab, kLargeSize);
+  HugePageFrameAllocator::Stats stats = allocator.GetStats();
+  EXPECT_EQ(1u, stats.transparent_huge_page_allocations);
+  EXPECT_EQ(0u, stats.mapped_bytes % HugePageFrameAllocator::kHugePageSize);
+  EXPECT_GE(stats.mapped_bytes, kLargeSize);
+  EXPECT_GT(stats.estimated_page_faults_avoided, 0);
+  allocator.Free(data, kLargeSize);
+  EXPECT_EQ(0u, allocator.GetStats().mapped_bytes);
+}
+
+TEST(HugePageFrameAllocatorTest, ConsecutiveAllocationsHaveDifferentColors) {
+  HugePageFrameAllocator allocator(HugePageFrameAllocator::Mode::kTransparent);
+  uint8_t* first = allocator.Allocate(kLargeSize, kAlignment);
+  uint8_t* second = allocator.Allocate(kLargeSize, kAlignment);
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(second);
+  const uintptr_t kMask = HugePageFrameAllocator::kHugePageSize - 1;
+  EXPECT_NE(reinterpret_cast<uintptr_t>(first) & kMask,
+            reinterpret_cast<uintptr_t>(second) & kMask);
+  allocator.Free(first, kLargeSize);
+  allocator.Free(second, kLargeSize);
+}
+
+TEST(HugePageFrameAllocatorTest, ExplicitModeFallsBackToTransparent) {
+  HugePageFrameAllocator allocator(HugePageFrameAllocator::Mode::kExplicit);
+  uint8_t* data = allocator.Allocate(kLargeSize, kAlignment);
+  ASSERT_TRUE(data);
+  memset(data, 0xab, kLargeSize);
+  HugePageFrameAllocator::Stats stats = allocator.GetStats();
+  // Whether explicit huge pages are available depends on the system.
+  EXPECT_EQ(1u, stats.explicit_huge_page_allocations +
+                    stats.transparent_huge_page_allocations);
+  allocator.Free(data, kLargeSize);
+}
+#endif
+
+TEST(HugePageFrameAllocatorTest, BufferPoolReusesAllocatedFrames) {
+  HugePageFrameAllocator allocator(HugePageFrameAllocator::Mode::kTransparent);
+  {
+    I420BufferPool pool(false, 2, &allocator);
+    rtc::scoped_refptr<I420BufferInterface> buffer =
+        pool.CreateBuffer(1920, 1080);
+    ASSERT_TRUE(buffer);
+    const uint8_t* y_ptr = buffer->DataY();
+    buffer = nullptr;
+    buffer = pool.CreateBuffer(1920, 1080);
+    EXPECT_EQ(y_ptr, buffer->DataY());
+  }
+  HugePageFrameAllocator::Stats stats = allocator.GetStats();
+  EXPECT_EQ(1u, stats.small_allocations +
+                    stats.transparent_huge_page_allocations);
+  EXPECT_EQ(0u, stats.mapped_bytes);
+}
+
+}  // namespace webrtc
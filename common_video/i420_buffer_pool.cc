@@ -14,48 +14,150 @@
 
 namespace webrtc {
 
+namespace {
+
+size_t BufferSize(const I420Buffer& buffer) {
+  return buffer.StrideY() * buffer.height() +
+         (buffer.StrideU() + buffer.StrideV()) * buffer.ChromaHeight();
+}
+
+}  // namespace
+
+const size_t I420BufferPool::kMaxNumberOfResolutions;
+
+I420BufferPool::Bucket::Bucket(int width, int height)
+    : width(width), height(height) {}
+I420BufferPool::Bucket::~Bucket() = default;
+
 I420BufferPool::I420BufferPool() : I420BufferPool(false) {}
 I420BufferPool::I420BufferPool(bool zero_initialize)
     : I420BufferPool(zero_initialize, std::numeric_limits<size_t>::max()) {}
 I420BufferPool::I420BufferPool(bool zero_initialize,
                                size_t max_number_of_buffers)
+    : I420BufferPool(zero_initialize, max_number_of_buffers, nullptr) {}
+I420BufferPool::I420BufferPool(bool zero_initialize,
+                               size_t max_number_of_buffers,
+                               VideoFrameMemoryAllocator* allocator)
     : zero_initialize_(zero_initialize),
-      max_number_of_buffers_(max_number_of_buffers) {}
+      max_number_of_buffers_(max_number_of_buffers),
+      allocator_(allocator) {}
 I420BufferPool::~I420BufferPool() = default;
 
 void I420BufferPool::Release() {
-  buffers_.clear();
+  buckets_.clear();
+  num_buffers_ = 0;
+  stats_.pooled_bytes = 0;
+}
+
+void I420BufferPool::SetMaxPooledBytes(size_t max_pooled_bytes) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  max_pooled_bytes_ = max_pooled_bytes;
+  while (stats_.pooled_bytes > max_pooled_bytes_ &&
+         PurgeUnusedBuffer(nullptr)) {
+  }
+}
+
+I420BufferPool::Stats I420BufferPool::GetStats() const {
+  return stats_;
 }
 
 rtc::scoped_refptr<I420Buffer> I420BufferPool::CreateBuffer(int width,
                                                             int height) {
   RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
-  // Release buffers with wrong resolution.
-  for (auto it = buffers_.begin(); it != buffers_.end();) {
-    if ((*it)->width() != width || (*it)->height() != height)
-      it = buffers_.erase(it);
-    else
-      ++it;
-  }
-  // Look for a free buffer.
-  for (const rtc::scoped_refptr<PooledI420Buffer>& buffer : buffers_) {
-    // If the buffer is in use, the ref count will be >= 2, one from the list we
-    // are looping over and one from the application. If the ref count is 1,
-    // then the list we are looping over holds the only reference and it's safe
-    // to reuse.
-    if (buffer->HasOneRef())
-      return buffer;
-  }
-
-  if (buffers_.size() >= max_number_of_buffers_)
+  Bucket* bucket = GetBucket(width, height);
+  // Look for a free buffer. If the buffer is in use, the ref count will be
+  // >= 2, one from the bucket and one from the application. If the ref count
+  // is 1, then the bucket holds the only reference and it's safe to reuse.
+  const size_t size = bucket->buffers.size();
+  for (size_t i = 0; i < size; ++i) {
+    const size_t index = (bucket->next_index + i) % size;
+    if (bucket->buffers[index]->HasOneRef()) {
+      bucket->next_index = (index + 1) % size;
+      ++stats_.hits;
+      return bucket->buffers[index];
+    }
+  }
+
+  if (num_buffers_ >= max_number_of_buffers_ && !PurgeUnusedBuffer(bucket))
     return nullptr;
-  // Allocate new buffer.
+  ++stats_.misses;
+  bool pooled = false;
+  return AllocateBuffer(bucket, &pooled);
+}
+
+void I420BufferPool::Prewarm(int width, int height, size_t count) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  Bucket* bucket = GetBucket(width, height);
+  while (bucket->buffers.size() < count &&
+         num_buffers_ < max_number_of_buffers_) {
+    bool pooled = false;
+    AllocateBuffer(bucket, &pooled);
+    if (!pooled)
+      break;
+  }
+}
+
+I420BufferPool::Bucket* I420BufferPool::GetBucket(int width, int height) {
+  for (auto it = buckets_.begin(); it != buckets_.end(); ++it) {
+    if (it->width == width && it->height == height) {
+      buckets_.splice(buckets_.begin(), buckets_, it);
+      return &buckets_.front();
+    }
+  }
+  // Release buffers of the least recently used resolution. Buffers that are
+  // in use are freed when the application releases them.
+  if (buckets_.size() >= kMaxNumberOfResolutions) {
+    Bucket& oldest = buckets_.back();
+    while (!oldest.buffers.empty())
+      RemoveBuffer(&oldest, oldest.buffers.size() - 1);
+    buckets_.pop_back();
+  }
+  buckets_.emplace_front(width, height);
+  return &buckets_.front();
+}
+
+rtc::scoped_refptr<I420BufferPool::PooledI420Buffer>
+I420BufferPool::AllocateBuffer(Bucket* bucket, bool* pooled) {
+  const int chroma_width = (bucket->width + 1) / 2;
   rtc::scoped_refptr<PooledI420Buffer> buffer =
-      new PooledI420Buffer(width, height);
+      new PooledI420Buffer(bucket->width, bucket->height, bucket->width,
+                           chroma_width, chroma_width, allocator_);
   if (zero_initialize_)
     buffer->InitializeData();
-  buffers_.push_back(buffer);
+
+  const size_t buffer_size = BufferSize(*buffer);
+  while (stats_.pooled_bytes + buffer_size > max_pooled_bytes_ &&
+         PurgeUnusedBuffer(bucket)) {
+  }
+  *pooled = stats_.pooled_bytes + buffer_size <= max_pooled_bytes_;
+  if (*pooled) {
+    bucket->buffers.push_back(buffer);
+    ++num_buffers_;
+    stats_.pooled_bytes += buffer_size;
+  }
   return buffer;
 }
 
+bool I420BufferPool::PurgeUnusedBuffer(const Bucket* keep) {
+  for (auto it = buckets_.rbegin(); it != buckets_.rend(); ++it) {
+    if (&*it == keep)
+      continue;
+    for (size_t i = 0; i < it->buffers.size(); ++i) {
+      if (it->buffers[i]->HasOneRef()) {
+        RemoveBuffer(&*it, i);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void I420BufferPool::RemoveBuffer(Bucket* bucket, size_t index) {
+  stats_.pooled_bytes -= BufferSize(*bucket->buffers[index]);
+  --num_buffers_;
+  bucket->buffers.erase(bucket->buffers.begin() + index);
+  if (bucket->next_index >= bucket->buffers.size())
+    bucket->next_index = 0;
+}
+
 }  // namespace webrtc
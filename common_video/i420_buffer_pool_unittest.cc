@@ -70,4 +70,65 @@ TEST(TestI420BufferPool, MaxNumberOfBuffers) {
   EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
 }
 
+TEST(TestI420BufferPool, ReusesBuffersAfterResolutionSwitch) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<I420Buffer> buffer = pool.CreateBuffer(16, 16);
+  const uint8_t* y_ptr = buffer->DataY();
+  buffer = pool.CreateBuffer(32, 16);
+  buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(2u, pool.GetStats().misses);
+  EXPECT_EQ(1u, pool.GetStats().hits);
+}
+
+TEST(TestI420BufferPool, PurgesLeastRecentlyUsedResolution) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<I420Buffer> buffer = pool.CreateBuffer(16, 16);
+  const size_t buffer_size = pool.GetStats().pooled_bytes;
+  buffer = nullptr;
+  for (size_t i = 1; i <= I420BufferPool::kMaxNumberOfResolutions; ++i)
+    pool.CreateBuffer(16, 16 + 2 * i);
+  EXPECT_EQ(I420BufferPool::kMaxNumberOfResolutions + 1,
+            pool.GetStats().misses);
+  EXPECT_GT(buffer_size * (I420BufferPool::kMaxNumberOfResolutions + 1),
+            pool.GetStats().pooled_bytes);
+  pool.CreateBuffer(16, 16);
+  EXPECT_EQ(0u, pool.GetStats().hits);
+}
+
+TEST(TestI420BufferPool, PrewarmedBuffersAreHits) {
+  I420BufferPool pool;
+  pool.Prewarm(16, 16, 2);
+  EXPECT_EQ(0u, pool.GetStats().misses);
+  rtc::scoped_refptr<I420Buffer> buffer1 = pool.CreateBuffer(16, 16);
+  rtc::scoped_refptr<I420Buffer> buffer2 = pool.CreateBuffer(16, 16);
+  EXPECT_NE(buffer1->DataY(), buffer2->DataY());
+  EXPECT_EQ(2u, pool.GetStats().hits);
+  EXPECT_EQ(0u, pool.GetStats().misses);
+  pool.CreateBuffer(16, 16);
+  EXPECT_EQ(1u, pool.GetStats().misses);
+}
+
+TEST(TestI420BufferPool, MaxPooledBytes) {
+  I420BufferPool pool;
+  rtc::scoped_refptr<I420Buffer> buffer1 = pool.CreateBuffer(16, 16);
+  const size_t buffer_size = pool.GetStats().pooled_bytes;
+  pool.SetMaxPooledBytes(buffer_size);
+
+  // Buffers beyond the cap are still handed out, but not pooled.
+  rtc::scoped_refptr<I420Buffer> buffer2 = pool.CreateBuffer(16, 16);
+  EXPECT_NE(nullptr, buffer2.get());
+  EXPECT_EQ(buffer_size, pool.GetStats().pooled_bytes);
+  buffer2 = nullptr;
+  buffer2 = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(0u, pool.GetStats().hits);
+  EXPECT_EQ(3u, pool.GetStats().misses);
+
+  // Unused buffers of other resolutions are purged to make room.
+  buffer1 = nullptr;
+  buffer2 = pool.CreateBuffer(16, 8);
+  EXPECT_GT(buffer_size, pool.GetStats().pooled_bytes);
+  EXPECT_LT(0u, pool.GetStats().pooled_bytes);
+}
+
 }  // namespace webrtc
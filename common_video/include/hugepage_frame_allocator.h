@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef COMMON_VIDEO_INCLUDE_HUGEPAGE_FRAME_ALLOCATOR_H_
+#define COMMON_VIDEO_INCLUDE_HUGEPAGE_FRAME_ALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api/video/video_frame_memory_allocator.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Allocates large frames from huge pages, so that a 4K frame takes a handful
+// of page faults and TLB entries instead of thousands. Each large allocation
+// is mapped on its own, starting at a huge page boundary, and offset by a
+// varying number of cache lines ("cache coloring") so that the planes of
+// consecutive frames don't all map to the same cache sets. Allocations
+// smaller than kMinHugePageAllocationBytes use AlignedMalloc. Huge pages are
+// only used on Linux; elsewhere all allocations use AlignedMalloc. Use
+// together with a buffer pool, since mapping memory is more expensive than a
+// heap allocation.
+class HugePageFrameAllocator : public VideoFrameMemoryAllocator {
+ public:
+  enum class Mode {
+    // Transparent huge pages, requested with madvise(MADV_HUGEPAGE).
+    kTransparent,
+    // Pages from the pool reserved in /proc/sys/vm/nr_hugepages, falling
+    // back to transparent huge pages when the pool is exhausted.
+    kExplicit,
+  };
+
+  struct Stats {
+    size_t small_allocations = 0;
+    size_t explicit_huge_page_allocations = 0;
+    size_t transparent_huge_page_allocations = 0;
+    // Allocations for which no memory could be mapped.
+    size_t failed_allocations = 0;
+    // Bytes currently mapped for large allocations.
+    size_t mapped_bytes = 0;
+    // Number of 4 KB page faults avoided by the large allocations so far,
+    // assuming every huge page is granted and all memory is touched.
+    int64_t estimated_page_faults_avoided = 0;
+  };
+
+  static const size_t kHugePageSize = 2 * 1024 * 1024;
+  static const size_t kMinHugePageAllocationBytes = kHugePageSize / 2;
+  static const size_t kCacheLineSize = 64;
+  static const size_t kNumCacheColors = 32;
+
+  explicit HugePageFrameAllocator(Mode mode);
+  ~HugePageFrameAllocator() override;
+
+  uint8_t* Allocate(size_t size, size_t alignment) override;
+  void Free(uint8_t* data, size_t size) override;
+
+  Stats GetStats() const;
+
+ private:
+  const Mode mode_;
+  rtc::CriticalSection crit_;
+  size_t next_color_ RTC_GUARDED_BY(crit_) = 0;
+  Stats stats_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(HugePageFrameAllocator);
+};
+
+}  // namespace webrtc
+
+#endif  // COMMON_VIDEO_INCLUDE_HUGEPAGE_FRAME_ALLOCATOR_H_
@@ -13,6 +13,7 @@
 
 #include <list>
 #include <limits>
+#include <vector>
 
 #include "api/video/i420_buffer.h"
 #include "rtc_base/race_checker.h"
@@ -23,22 +24,49 @@ namespace webrtc {
 // Simple buffer pool to avoid unnecessary allocations of I420Buffer objects.
 // The pool manages the memory of the I420Buffer returned from CreateBuffer.
 // When the I420Buffer is destructed, the memory is returned to the pool for use
-// by subsequent calls to CreateBuffer. If the resolution passed to CreateBuffer
-// changes, old buffers will be purged from the pool.
+// by subsequent calls to CreateBuffer. Buffers are kept in one bucket per
+// resolution, so that switching back and forth between a few resolutions, as
+// with quality scaling, reuses the buffers instead of reallocating them. When
+// more than kMaxNumberOfResolutions are in use, the buffers of the least
+// recently used resolution are purged from the pool.
 // Note that CreateBuffer will crash if more than kMaxNumberOfFramesBeforeCrash
 // are created. This is to prevent memory leaks where frames are not returned.
 class I420BufferPool {
  public:
+  static const size_t kMaxNumberOfResolutions = 3;
+
+  struct Stats {
+    // Number of CreateBuffer calls served by a pooled buffer.
+    size_t hits = 0;
+    // Number of CreateBuffer calls that had to allocate a new buffer.
+    size_t misses = 0;
+    // Total size of the buffers held by the pool, in use or not.
+    size_t pooled_bytes = 0;
+  };
+
   I420BufferPool();
   explicit I420BufferPool(bool zero_initialize);
   I420BufferPool(bool zero_initialze, size_t max_number_of_buffers);
+  // Allocates the memory of the buffers from |allocator|, if not null. The
+  // allocator must outlive the pool and all buffers created by it.
+  I420BufferPool(bool zero_initialize,
+                 size_t max_number_of_buffers,
+                 VideoFrameMemoryAllocator* allocator);
   ~I420BufferPool();
 
   // Returns a buffer from the pool. If no suitable buffer exist in the pool
   // and there are less than |max_number_of_buffers| pending, a buffer is
   // created. Returns null otherwise.
   rtc::scoped_refptr<I420Buffer> CreateBuffer(int width, int height);
-  // Clears buffers_ and detaches the thread checker so that it can be reused
+  // Allocates buffers up front so that there are at least |count| buffers of
+  // the given resolution in the pool, e.g. when a stream starts.
+  void Prewarm(int width, int height, size_t count);
+  // Caps the memory held by the pool. Unused buffers of other resolutions are
+  // purged to make room for new ones, and buffers that would exceed the cap
+  // are handed out without being pooled.
+  void SetMaxPooledBytes(size_t max_pooled_bytes);
+  Stats GetStats() const;
+  // Clears the buckets and detaches the thread checker so that it can be reused
   // later from another thread.
   void Release();
 
@@ -47,8 +75,33 @@ class I420BufferPool {
   // needed by the pool to check exclusive access.
   using PooledI420Buffer = rtc::RefCountedObject<I420Buffer>;
 
+  struct Bucket {
+    Bucket(int width, int height);
+    ~Bucket();
+
+    const int width;
+    const int height;
+    // Buffers are usually returned in the order they were handed out, so the
+    // search for a free buffer starts after the one handed out last.
+    size_t next_index = 0;
+    std::vector<rtc::scoped_refptr<PooledI420Buffer>> buffers;
+  };
+
+  // Returns the bucket for the resolution and makes it the most recently used.
+  Bucket* GetBucket(int width, int height);
+  rtc::scoped_refptr<PooledI420Buffer> AllocateBuffer(Bucket* bucket,
+                                                      bool* pooled);
+  // Removes an unused buffer from the least recently used bucket other than
+  // |keep|. Returns false if all buffers are in use.
+  bool PurgeUnusedBuffer(const Bucket* keep);
+  void RemoveBuffer(Bucket* bucket, size_t index);
+
   rtc::RaceChecker race_checker_;
-  std::list<rtc::scoped_refptr<PooledI420Buffer>> buffers_;
+  // Most recently used resolution first.
+  std::list<Bucket> buckets_;
+  size_t num_buffers_ = 0;
+  size_t max_pooled_bytes_ = std::numeric_limits<size_t>::max();
+  Stats stats_;
   // If true, newly allocated buffers are zero-initialized. Note that recycled
   // buffers are not zero'd before reuse. This is required of buffers used by
   // FFmpeg according to http://crbug.com/390941, which only requires it for the
@@ -57,6 +110,7 @@ class I420BufferPool {
   const bool zero_initialize_;
   // Max number of buffers this pool can have pending.
   const size_t max_number_of_buffers_;
+  VideoFrameMemoryAllocator* const allocator_;
 };
 
 }  // namespace webrtc
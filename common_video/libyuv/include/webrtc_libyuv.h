@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "api/video/video_frame.h"
+#include "common_video/include/i420_buffer_pool.h"
 #include "common_types.h"  // NOLINT(build/include)  // VideoTypes.
 #include "typedefs.h"  // NOLINT(build/include)
 
@@ -118,6 +119,49 @@ class NV12ToI420Scaler {
   std::vector<uint8_t> tmp_uv_planes_;
 };
 
+// Helper class for adapting captured frames on send. Converting to I420,
+// cropping, scaling and rotating are done in as few passes as libyuv allows,
+// into buffers from a pool:
+// - Without scaling, the cropped area is converted and rotated in one pass.
+// - With scaling, the cropped area is converted and scaled in one pass, and
+//   the scaled frame is rotated in a second pass, if needed. Scaling first
+//   keeps the rotation to the smaller frame.
+// I420 and NV12 buffers are read directly, other types are converted with
+// ToI420() first. Like the pool, this must be used from one thread at a time.
+class I420FrameTransformer {
+ public:
+  I420FrameTransformer();
+  ~I420FrameTransformer();
+
+  // Crops the |crop_width| x |crop_height| area at (|crop_x|, |crop_y|) of
+  // |buffer|, scales it to |scaled_width| x |scaled_height| and applies
+  // |rotation|. The offset is rounded down to be even. The width and height
+  // of the result are swapped for 90 and 270 degree rotations.
+  rtc::scoped_refptr<I420BufferInterface> Transform(
+      const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+      int crop_x,
+      int crop_y,
+      int crop_width,
+      int crop_height,
+      int scaled_width,
+      int scaled_height,
+      VideoRotation rotation);
+
+  // Returns the pooled memory, e.g. when capture stops.
+  void Release();
+
+ private:
+  I420BufferPool pool_;
+  NV12ToI420Scaler nv12_scaler_;
+};
+
+// Returns |buffer| in I420 format for encoders that only take I420. NV12
+// buffers are converted into a buffer from |pool|, which saves the allocation
+// that ToI420() makes for every frame; other types fall back to ToI420().
+rtc::scoped_refptr<I420BufferInterface> ConvertToI420(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    I420BufferPool* pool);
+
 // Convert VideoType to libyuv FourCC type
 int ConvertVideoType(VideoType video_type);
 
@@ -14,6 +14,7 @@
 #include <memory>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video/video_frame.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "test/frame_utils.h"
@@ -344,4 +345,55 @@ TEST_F(TestLibYuv, NV12Scale4x4to2x2) {
               ::testing::ElementsAre(Average(0, 2, 4, 6), Average(1, 3, 5, 7)));
 }
 
+// Returns a buffer where every sample differs from its neighbours.
+static rtc::scoped_refptr<I420Buffer> CreateGradient(int width, int height) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x)
+      buffer->MutableDataY()[y * buffer->StrideY() + x] = 7 * x + 13 * y;
+  }
+  for (int y = 0; y < (height + 1) / 2; ++y) {
+    for (int x = 0; x < (width + 1) / 2; ++x) {
+      buffer->MutableDataU()[y * buffer->StrideU() + x] = 11 * x + 3 * y;
+      buffer->MutableDataV()[y * buffer->StrideV() + x] = 5 * x + 17 * y;
+    }
+  }
+  return buffer;
+}
+
+TEST_F(TestLibYuv, I420FrameTransformerMatchesSeparatePasses) {
+  rtc::scoped_refptr<I420Buffer> src = CreateGradient(64, 48);
+  I420FrameTransformer transformer;
+  for (VideoRotation rotation : {kVideoRotation_0, kVideoRotation_90,
+                                 kVideoRotation_180, kVideoRotation_270}) {
+    rtc::scoped_refptr<I420Buffer> scaled = I420Buffer::Create(20, 16);
+    scaled->CropAndScaleFrom(*src, 4, 6, 40, 32);
+    rtc::scoped_refptr<VideoFrameBuffer> expected =
+        I420Buffer::Rotate(*scaled, rotation);
+
+    EXPECT_TRUE(test::FrameBufsEqual(
+        expected,
+        transformer.Transform(src, 4, 6, 40, 32, 20, 16, rotation)));
+  }
+}
+
+TEST_F(TestLibYuv, I420FrameTransformerConvertsNV12) {
+  rtc::scoped_refptr<I420Buffer> i420 = CreateGradient(64, 48);
+  rtc::scoped_refptr<NV12Buffer> src = NV12Buffer::Copy(*i420);
+  I420FrameTransformer transformer;
+
+  // Without scaling, the NV12 buffer is cropped, converted and rotated in
+  // one pass.
+  rtc::scoped_refptr<I420Buffer> cropped = I420Buffer::Create(32, 24);
+  cropped->CropAndScaleFrom(*i420, 8, 4, 32, 24);
+  EXPECT_TRUE(test::FrameBufsEqual(
+      I420Buffer::Rotate(*cropped, kVideoRotation_90),
+      transformer.Transform(src, 8, 4, 32, 24, 32, 24, kVideoRotation_90)));
+
+  rtc::scoped_refptr<I420BufferInterface> scaled =
+      transformer.Transform(src, 0, 0, 64, 48, 32, 24, kVideoRotation_270);
+  EXPECT_EQ(24, scaled->width());
+  EXPECT_EQ(32, scaled->height());
+}
+
 }  // namespace webrtc
@@ -12,6 +12,8 @@
 
 #include <string.h>
 
+#include <utility>
+
 #include "api/video/i420_buffer.h"
 #include "common_video/include/video_frame_buffer.h"
 #include "rtc_base/bind.h"
@@ -475,4 +477,142 @@ void NV12ToI420Scaler::NV12ToI420Scale(
                     libyuv::kFilterBox);
 }
 
+I420FrameTransformer::I420FrameTransformer() = default;
+I420FrameTransformer::~I420FrameTransformer() = default;
+
+rtc::scoped_refptr<I420BufferInterface> I420FrameTransformer::Transform(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    int crop_x,
+    int crop_y,
+    int crop_width,
+    int crop_height,
+    int scaled_width,
+    int scaled_height,
+    VideoRotation rotation) {
+  RTC_CHECK_GE(crop_x, 0);
+  RTC_CHECK_GE(crop_y, 0);
+  RTC_CHECK_LE(crop_x + crop_width, buffer->width());
+  RTC_CHECK_LE(crop_y + crop_height, buffer->height());
+
+  // Make sure offset is even so that u/v plane becomes aligned.
+  const int uv_offset_x = crop_x / 2;
+  const int uv_offset_y = crop_y / 2;
+  crop_x = uv_offset_x * 2;
+  crop_y = uv_offset_y * 2;
+
+  const uint8_t* src_y;
+  const uint8_t* src_u = nullptr;
+  const uint8_t* src_v = nullptr;
+  const uint8_t* src_uv = nullptr;
+  int src_stride_y;
+  int src_stride_u = 0;
+  int src_stride_v = 0;
+  int src_stride_uv = 0;
+  // Keeps the source alive if it had to be converted.
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer;
+  if (buffer->type() == VideoFrameBuffer::Type::kNV12) {
+    const NV12BufferInterface* nv12_buffer = buffer->GetNV12();
+    src_stride_y = nv12_buffer->StrideY();
+    src_stride_uv = nv12_buffer->StrideUV();
+    src_y = nv12_buffer->DataY() + src_stride_y * crop_y + crop_x;
+    src_uv = nv12_buffer->DataUV() + src_stride_uv * uv_offset_y +
+             uv_offset_x * 2;
+  } else {
+    i420_buffer = buffer->ToI420();
+    src_stride_y = i420_buffer->StrideY();
+    src_stride_u = i420_buffer->StrideU();
+    src_stride_v = i420_buffer->StrideV();
+    src_y = i420_buffer->DataY() + src_stride_y * crop_y + crop_x;
+    src_u = i420_buffer->DataU() + src_stride_u * uv_offset_y + uv_offset_x;
+    src_v = i420_buffer->DataV() + src_stride_v * uv_offset_y + uv_offset_x;
+  }
+
+  int rotated_width = scaled_width;
+  int rotated_height = scaled_height;
+  if (rotation == kVideoRotation_90 || rotation == kVideoRotation_270) {
+    std::swap(rotated_width, rotated_height);
+  }
+  const libyuv::RotationMode rotation_mode =
+      static_cast<libyuv::RotationMode>(rotation);
+
+  if (crop_width == scaled_width && crop_height == scaled_height) {
+    // No scaling. Crop, convert and rotate in one pass.
+    rtc::scoped_refptr<I420Buffer> rotated_buffer =
+        pool_.CreateBuffer(rotated_width, rotated_height);
+    if (src_uv) {
+      libyuv::NV12ToI420Rotate(
+          src_y, src_stride_y, src_uv, src_stride_uv,
+          rotated_buffer->MutableDataY(), rotated_buffer->StrideY(),
+          rotated_buffer->MutableDataU(), rotated_buffer->StrideU(),
+          rotated_buffer->MutableDataV(), rotated_buffer->StrideV(),
+          crop_width, crop_height, rotation_mode);
+    } else {
+      libyuv::I420Rotate(
+          src_y, src_stride_y, src_u, src_stride_u, src_v, src_stride_v,
+          rotated_buffer->MutableDataY(), rotated_buffer->StrideY(),
+          rotated_buffer->MutableDataU(), rotated_buffer->StrideU(),
+          rotated_buffer->MutableDataV(), rotated_buffer->StrideV(),
+          crop_width, crop_height, rotation_mode);
+    }
+    return rotated_buffer;
+  }
+
+  rtc::scoped_refptr<I420Buffer> scaled_buffer =
+      pool_.CreateBuffer(scaled_width, scaled_height);
+  if (src_uv) {
+    nv12_scaler_.NV12ToI420Scale(
+        src_y, src_stride_y, src_uv, src_stride_uv, crop_width, crop_height,
+        scaled_buffer->MutableDataY(), scaled_buffer->StrideY(),
+        scaled_buffer->MutableDataU(), scaled_buffer->StrideU(),
+        scaled_buffer->MutableDataV(), scaled_buffer->StrideV(),
+        scaled_width, scaled_height);
+  } else {
+    libyuv::I420Scale(
+        src_y, src_stride_y, src_u, src_stride_u, src_v, src_stride_v,
+        crop_width, crop_height, scaled_buffer->MutableDataY(),
+        scaled_buffer->StrideY(), scaled_buffer->MutableDataU(),
+        scaled_buffer->StrideU(), scaled_buffer->MutableDataV(),
+        scaled_buffer->StrideV(), scaled_width, scaled_height,
+        libyuv::kFilterBox);
+  }
+  if (rotation == kVideoRotation_0)
+    return scaled_buffer;
+
+  // The scaled buffer goes back to the pool when this returns.
+  rtc::scoped_refptr<I420Buffer> rotated_buffer =
+      pool_.CreateBuffer(rotated_width, rotated_height);
+  libyuv::I420Rotate(
+      scaled_buffer->DataY(), scaled_buffer->StrideY(),
+      scaled_buffer->DataU(), scaled_buffer->StrideU(),
+      scaled_buffer->DataV(), scaled_buffer->StrideV(),
+      rotated_buffer->MutableDataY(), rotated_buffer->StrideY(),
+      rotated_buffer->MutableDataU(), rotated_buffer->StrideU(),
+      rotated_buffer->MutableDataV(), rotated_buffer->StrideV(),
+      scaled_width, scaled_height, rotation_mode);
+  return rotated_buffer;
+}
+
+void I420FrameTransformer::Release() {
+  pool_.Release();
+}
+
+rtc::scoped_refptr<I420BufferInterface> ConvertToI420(
+    const rtc::scoped_refptr<VideoFrameBuffer>& buffer,
+    I420BufferPool* pool) {
+  if (buffer->type() != VideoFrameBuffer::Type::kNV12)
+    return buffer->ToI420();
+  rtc::scoped_refptr<I420Buffer> i420_buffer =
+      pool->CreateBuffer(buffer->width(), buffer->height());
+  if (!i420_buffer)
+    return buffer->ToI420();
+  const NV12BufferInterface* nv12_buffer = buffer->GetNV12();
+  libyuv::NV12ToI420(nv12_buffer->DataY(), nv12_buffer->StrideY(),
+                     nv12_buffer->DataUV(), nv12_buffer->StrideUV(),
+                     i420_buffer->MutableDataY(), i420_buffer->StrideY(),
+                     i420_buffer->MutableDataU(), i420_buffer->StrideU(),
+                     i420_buffer->MutableDataV(), i420_buffer->StrideV(),
+                     buffer->width(), buffer->height());
+  return i420_buffer;
+}
+
 }  // namespace webrtc
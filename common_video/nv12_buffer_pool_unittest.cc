@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "common_video/include/nv12_buffer_pool.h"
+
+#include <string.h>
+
+#include "api/video/i420_buffer.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+TEST(TestNV12BufferPool, SimpleFrameReuse) {
+  NV12BufferPool pool;
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(16, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+  EXPECT_EQ(VideoFrameBuffer::Type::kNV12, buffer->type());
+  // Extract non-refcounted pointers for testing.
+  const uint8_t* y_ptr = buffer->DataY();
+  const uint8_t* uv_ptr = buffer->DataUV();
+  // Release buffer so that it is returned to the pool.
+  buffer = nullptr;
+  // Check that the memory is reused.
+  buffer = pool.CreateBuffer(16, 16);
+  EXPECT_EQ(y_ptr, buffer->DataY());
+  EXPECT_EQ(uv_ptr, buffer->DataUV());
+}
+
+TEST(TestNV12BufferPool, FailToReuseWrongSize) {
+  NV12BufferPool pool;
+  rtc::scoped_refptr<NV12Buffer> buffer = pool.CreateBuffer(16, 16);
+  const uint8_t* uv_ptr = buffer->DataUV();
+  buffer = nullptr;
+  buffer = pool.CreateBuffer(32, 16);
+  EXPECT_EQ(32, buffer->width());
+  EXPECT_EQ(16, buffer->height());
+  EXPECT_NE(uv_ptr, buffer->DataUV());
+}
+
+TEST(TestNV12BufferPool, MaxNumberOfBuffers) {
+  NV12BufferPool pool(false, 1);
+  rtc::scoped_refptr<NV12Buffer> buffer1 = pool.CreateBuffer(16, 16);
+  EXPECT_NE(nullptr, buffer1.get());
+  EXPECT_EQ(nullptr, pool.CreateBuffer(16, 16).get());
+}
+
+TEST(TestNV12BufferPool, ConvertsToAndFromI420) {
+  rtc::scoped_refptr<I420Buffer> i420 = I420Buffer::Create(16, 8);
+  memset(i420->MutableDataY(), 10, i420->StrideY() * 8);
+  memset(i420->MutableDataU(), 20, i420->StrideU() * 4);
+  memset(i420->MutableDataV(), 30, i420->StrideV() * 4);
+
+  rtc::scoped_refptr<NV12Buffer> nv12 = NV12Buffer::Copy(*i420);
+  EXPECT_EQ(8, nv12->ChromaWidth());
+  EXPECT_EQ(10, nv12->DataY()[0]);
+  EXPECT_EQ(20, nv12->DataUV()[0]);
+  EXPECT_EQ(30, nv12->DataUV()[1]);
+
+  rtc::scoped_refptr<I420BufferInterface> converted = nv12->ToI420();
+  EXPECT_EQ(16, converted->width());
+  EXPECT_EQ(8, converted->height());
+  EXPECT_EQ(10, converted->DataY()[15]);
+  EXPECT_EQ(20, converted->DataU()[7]);
+  EXPECT_EQ(30, converted->DataV()[7]);
+}
+
+TEST(TestNV12BufferPool, CropAndScaleKeepsNV12) {
+  rtc::scoped_refptr<NV12Buffer> src = NV12Buffer::Create(32, 16);
+  memset(src->MutableDataY(), 50, src->StrideY() * 16);
+  for (int i = 0; i < src->StrideUV() * 8; i += 2) {
+    src->MutableDataUV()[i] = 60;
+    src->MutableDataUV()[i + 1] = 70;
+  }
+
+  rtc::scoped_refptr<NV12Buffer> dst = NV12Buffer::Create(8, 8);
+  dst->CropAndScaleFrom(*src, 8, 0, 16, 16);
+  EXPECT_EQ(50, dst->DataY()[0]);
+  EXPECT_EQ(60, dst->DataUV()[0]);
+  EXPECT_EQ(70, dst->DataUV()[1]);
+  EXPECT_EQ(60, dst->DataUV()[6]);
+  EXPECT_EQ(70, dst->DataUV()[7]);
+}
+
+}  // namespace webrtc
@@ -41,6 +41,10 @@ VideoRenderFrames::VideoRenderFrames(uint32_t render_delay_ms)
 int32_t VideoRenderFrames::AddFrame(VideoFrame&& new_frame) {
   const int64_t time_now = rtc::TimeMillis();
 
+  // Zero render time means render immediately, see VCMTiming::RenderTimeMs().
+  if (new_frame.render_time_ms() == 0)
+    new_frame.set_timestamp_us(time_now * rtc::kNumMicrosecsPerMillisec);
+
   // Drop old frames only when there are other frames in the queue, otherwise, a
   // really slow system never renders any frames.
   if (!incoming_frames_.empty() &&
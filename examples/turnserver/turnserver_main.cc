@@ -10,9 +10,8 @@
 
 #include <iostream>  // NOLINT
 
-#include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/shardedturnserver.h"
 #include "p2p/base/turnserver.h"
-#include "rtc_base/asyncudpsocket.h"
 #include "rtc_base/optionsfile.h"
 #include "rtc_base/stringencode.h"
 #include "rtc_base/thread.h"
@@ -42,8 +41,8 @@ class TurnFileAuth : public cricket::TurnAuthInterface {
 };
 
 int main(int argc, char* argv[]) {
-  if (argc != 5) {
-    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file"
+  if (argc != 5 && argc != 6) {
+    std::cerr << "usage: turnserver int-addr ext-ip realm auth-file [shards]"
               << std::endl;
     return 1;
   }
@@ -60,26 +59,29 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
-  rtc::Thread* main = rtc::Thread::Current();
-  rtc::AsyncUDPSocket* int_socket =
-      rtc::AsyncUDPSocket::Create(main->socketserver(), int_addr);
-  if (!int_socket) {
-    std::cerr << "Failed to create a UDP socket bound at"
-              << int_addr.ToString() << std::endl;
+  // Each shard is a TurnServer on its own thread, sharing |int_addr| through
+  // SO_REUSEPORT.
+  int shards = 1;
+  if (argc == 6 && (!rtc::FromString(argv[5], &shards) || shards < 1)) {
+    std::cerr << "Invalid shard count: " << argv[5] << std::endl;
     return 1;
   }
 
-  cricket::TurnServer server(main);
   TurnFileAuth auth(argv[4]);
+  cricket::ShardedTurnServer server(shards);
   server.set_realm(argv[3]);
   server.set_software(kSoftware);
   server.set_auth_hook(&auth);
-  server.AddInternalSocket(int_socket, cricket::PROTO_UDP);
-  server.SetExternalSocketFactory(new rtc::BasicPacketSocketFactory(),
-                                  rtc::SocketAddress(ext_addr, 0));
+  if (!server.Start(int_addr, ext_addr)) {
+    std::cerr << "Failed to create UDP sockets bound at "
+              << int_addr.ToString() << std::endl;
+    return 1;
+  }
 
-  std::cout << "Listening internally at " << int_addr.ToString() << std::endl;
+  std::cout << "Listening internally at "
+            << server.internal_address().ToString() << " with " << shards
+            << " shard(s)" << std::endl;
 
-  main->Run();
+  rtc::Thread::Current()->Run();
   return 0;
 }
@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// The varint of an absent value. Present values are stored as their zigzag
+// delta plus one.
+constexpr uint64_t kAbsent = 0;
+constexpr size_t kMaxVarintBytes = 10;
+
+uint64_t Mask(size_t value_width_bits) {
+  return (uint64_t{1} << value_width_bits) - 1;
+}
+
+// Maps the delta, modulo 2^|value_width_bits|, to the signed value closest to
+// zero and then zigzags it, so that small negative deltas stay small too.
+uint64_t ZigZagDelta(uint64_t previous,
+                     uint64_t value,
+                     size_t value_width_bits) {
+  const uint64_t delta = (value - previous) & Mask(value_width_bits);
+  const uint64_t sign_bit = uint64_t{1} << (value_width_bits - 1);
+  if (delta < sign_bit)
+    return delta << 1;
+  // A negative delta of -(2^width - delta).
+  return ((Mask(value_width_bits) - delta) << 1) | 1;
+}
+
+uint64_t UnZigZagDelta(uint64_t previous,
+                       uint64_t zigzag,
+                       size_t value_width_bits) {
+  const uint64_t magnitude = zigzag >> 1;
+  const uint64_t value =
+      (zigzag & 1) ? previous - magnitude - 1 : previous + magnitude;
+  return value & Mask(value_width_bits);
+}
+
+void WriteVarint(uint64_t value, std::string* output) {
+  while (value >= 0x80) {
+    output->push_back(static_cast<char>(0x80 | (value & 0x7f)));
+    value >>= 7;
+  }
+  output->push_back(static_cast<char>(value));
+}
+
+bool ReadVarint(const std::string& input, size_t* offset, uint64_t* value) {
+  *value = 0;
+  for (size_t i = 0; i < kMaxVarintBytes && *offset < input.size(); ++i) {
+    const uint64_t byte = static_cast<uint8_t>(input[(*offset)++]);
+    *value |= (byte & 0x7f) << (7 * i);
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+std::string EncodeDeltas(rtc::Optional<uint64_t> base,
+                         const std::vector<rtc::Optional<uint64_t>>& values,
+                         size_t value_width_bits) {
+  RTC_DCHECK_GE(value_width_bits, 1);
+  RTC_DCHECK_LE(value_width_bits, 63);
+  bool all_equal_to_base = true;
+  for (const rtc::Optional<uint64_t>& value : values) {
+    RTC_DCHECK(!value || *value <= Mask(value_width_bits));
+    if (value != base) {
+      all_equal_to_base = false;
+      break;
+    }
+  }
+  if (all_equal_to_base)
+    return std::string();
+
+  std::string output;
+  output.reserve(values.size());
+  uint64_t previous = base.value_or(0);
+  for (const rtc::Optional<uint64_t>& value : values) {
+    if (!value) {
+      WriteVarint(kAbsent, &output);
+      continue;
+    }
+    WriteVarint(ZigZagDelta(previous, *value, value_width_bits) + 1, &output);
+    previous = *value;
+  }
+  return output;
+}
+
+std::vector<rtc::Optional<uint64_t>> DecodeDeltas(const std::string& input,
+                                                  rtc::Optional<uint64_t> base,
+                                                  size_t num_of_deltas,
+                                                  size_t value_width_bits) {
+  RTC_DCHECK_GE(value_width_bits, 1);
+  RTC_DCHECK_LE(value_width_bits, 63);
+  if (input.empty())
+    return std::vector<rtc::Optional<uint64_t>>(num_of_deltas, base);
+
+  std::vector<rtc::Optional<uint64_t>> values;
+  values.reserve(std::min(num_of_deltas, input.size()));
+  uint64_t previous = base.value_or(0);
+  size_t offset = 0;
+  while (offset < input.size()) {
+    uint64_t varint;
+    if (!ReadVarint(input, &offset, &varint) ||
+        varint > Mask(value_width_bits) + 1) {
+      return std::vector<rtc::Optional<uint64_t>>();
+    }
+    if (varint == kAbsent) {
+      values.emplace_back();
+      continue;
+    }
+    previous = UnZigZagDelta(previous, varint - 1, value_width_bits);
+    values.emplace_back(previous);
+  }
+  if (values.size() != num_of_deltas)
+    return std::vector<rtc::Optional<uint64_t>>();
+  return values;
+}
+
+}  // namespace webrtc
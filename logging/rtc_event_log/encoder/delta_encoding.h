@@ -0,0 +1,50 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef LOGGING_RTC_EVENT_LOG_ENCODER_DELTA_ENCODING_H_
+#define LOGGING_RTC_EVENT_LOG_ENCODER_DELTA_ENCODING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "api/optional.h"
+
+namespace webrtc {
+
+// Encodes the column of a field over a batch of events: |base| is the value
+// of the first event, which is stored as is, and |values| are those of the
+// others. Each value is stored as its difference to the last present value
+// before it, modulo 2^|value_width_bits|, so that sequence numbers and RTP
+// timestamps wrap around cheaply, as a zigzag varint. Absent values take a
+// single byte. Most deltas of RTP headers and timestamps are small, and take
+// one or two bytes instead of the four to ten of a varint of the value.
+//
+// Returns the empty string if all |values| are equal to |base|, which is
+// common for e.g. SSRCs; the decoder then needs the number of values from
+// elsewhere. |value_width_bits| must be in [1, 63] and all the values must
+// fit in it.
+std::string EncodeDeltas(rtc::Optional<uint64_t> base,
+                         const std::vector<rtc::Optional<uint64_t>>& values,
+                         size_t value_width_bits);
+
+// Decodes the |num_of_deltas| values that EncodeDeltas() encoded in |input|.
+// Returns an empty vector if |input| is malformed or doesn't hold
+// |num_of_deltas| values.
+std::vector<rtc::Optional<uint64_t>> DecodeDeltas(const std::string& input,
+                                                  rtc::Optional<uint64_t> base,
+                                                  size_t num_of_deltas,
+                                                  size_t value_width_bits);
+
+}  // namespace webrtc
+
+#endif  // LOGGING_RTC_EVENT_LOG_ENCODER_DELTA_ENCODING_H_
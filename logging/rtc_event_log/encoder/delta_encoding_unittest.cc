@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+using Values = std::vector<rtc::Optional<uint64_t>>;
+
+void TestRoundTrip(rtc::Optional<uint64_t> base,
+                   const Values& values,
+                   size_t value_width_bits) {
+  const std::string encoded = EncodeDeltas(base, values, value_width_bits);
+  EXPECT_EQ(values,
+            DecodeDeltas(encoded, base, values.size(), value_width_bits));
+}
+
+}  // namespace
+
+TEST(DeltaEncodingTest, ValuesEqualToTheBaseTakeNoSpace) {
+  const Values values(100, 0x12345678u);
+  EXPECT_EQ("", EncodeDeltas(0x12345678u, values, 32));
+  TestRoundTrip(0x12345678u, values, 32);
+  TestRoundTrip(rtc::nullopt, Values(10, rtc::nullopt), 32);
+}
+
+TEST(DeltaEncodingTest, SmallDeltasTakeOneByte) {
+  Values values;
+  for (uint64_t value = 1000; value < 1050; ++value)
+    values.push_back(value);
+  for (uint64_t value = 1050; value > 1010; --value)
+    values.push_back(value);
+  const std::string encoded = EncodeDeltas(uint64_t{999}, values, 32);
+  EXPECT_EQ(values.size(), encoded.size());
+  TestRoundTrip(uint64_t{999}, values, 32);
+}
+
+TEST(DeltaEncodingTest, WrapsAroundTheValueWidth) {
+  // A 16 bit sequence number that wraps, forwards and back.
+  const Values values = {uint64_t{0xfffe}, uint64_t{0xffff}, uint64_t{0},
+                         uint64_t{1}, uint64_t{0xffff}};
+  const std::string encoded = EncodeDeltas(uint64_t{0xfffd}, values, 16);
+  EXPECT_EQ(values.size(), encoded.size());
+  TestRoundTrip(uint64_t{0xfffd}, values, 16);
+}
+
+TEST(DeltaEncodingTest, AbsentValues) {
+  TestRoundTrip(rtc::nullopt, {rtc::nullopt, uint64_t{5}, rtc::nullopt}, 8);
+  TestRoundTrip(uint64_t{7}, {rtc::nullopt, rtc::nullopt, uint64_t{7}}, 8);
+  // The delta is to the last present value.
+  const Values values = {uint64_t{100}, rtc::nullopt, uint64_t{101}};
+  EXPECT_EQ(3u, EncodeDeltas(uint64_t{99}, values, 32).size());
+  TestRoundTrip(uint64_t{99}, values, 32);
+}
+
+TEST(DeltaEncodingTest, ExtremeDeltas) {
+  for (size_t width : {1, 7, 8, 31, 32, 63}) {
+    const uint64_t max = (uint64_t{1} << width) - 1;
+    const Values values = {max, uint64_t{0}, max / 2, max / 2 + 1, max,
+                           uint64_t{0}};
+    TestRoundTrip(uint64_t{0}, values, width);
+    TestRoundTrip(max, values, width);
+  }
+}
+
+TEST(DeltaEncodingTest, RandomValues) {
+  Random random(0x1234);
+  for (size_t width : {1, 3, 16, 32, 40, 63}) {
+    const uint64_t mask = (uint64_t{1} << width) - 1;
+    Values values;
+    for (int i = 0; i < 1000; ++i) {
+      if (random.Rand(0, 9) == 0) {
+        values.emplace_back();
+      } else {
+        const uint64_t value =
+            (uint64_t{random.Rand<uint32_t>()} << 32) | random.Rand<uint32_t>();
+        values.emplace_back(value & mask);
+      }
+    }
+    TestRoundTrip(uint64_t{random.Rand<uint32_t>()} & mask, values, width);
+  }
+}
+
+TEST(DeltaEncodingTest, RejectsMalformedInput) {
+  const Values values = {uint64_t{1}, uint64_t{2}, uint64_t{3}};
+  const std::string encoded = EncodeDeltas(uint64_t{0}, values, 8);
+  // Too few and too many values.
+  EXPECT_TRUE(DecodeDeltas(encoded, uint64_t{0}, 2, 8).empty());
+  EXPECT_TRUE(DecodeDeltas(encoded, uint64_t{0}, 4, 8).empty());
+  // A truncated varint.
+  EXPECT_TRUE(DecodeDeltas("\x80", uint64_t{0}, 1, 8).empty());
+  // A delta that doesn't fit in the width.
+  EXPECT_TRUE(DecodeDeltas("\x81\x02", uint64_t{0}, 1, 8).empty());
+}
+
+}  // namespace webrtc
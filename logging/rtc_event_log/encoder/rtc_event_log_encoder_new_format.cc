@@ -0,0 +1,969 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
+
+#include <string.h>
+
+#include <map>
+#include <vector>
+
+#include "api/rtpparameters.h"
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
+#include "logging/rtc_event_log/events/rtc_event_alr_state.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_network_adaptation.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_playout.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_receive_stream_config.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_send_stream_config.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_delay_based.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
+#include "logging/rtc_event_log/events/rtc_event_ice_candidate_pair.h"
+#include "logging/rtc_event_log/events/rtc_event_ice_candidate_pair_config.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_cluster_created.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_result_failure.h"
+#include "logging/rtc_event_log/events/rtc_event_probe_result_success.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_outgoing.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
+#include "logging/rtc_event_log/events/rtc_event_video_receive_stream_config.h"
+#include "logging/rtc_event_log/events/rtc_event_video_send_stream_config.h"
+#include "logging/rtc_event_log/rtc_stream_config.h"
+#include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor_config.h"
+#include "modules/remote_bitrate_estimator/include/bwe_defines.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/ignore_wundef.h"
+#include "rtc_base/logging.h"
+
+#ifdef ENABLE_RTC_EVENT_LOG
+
+// *.pb.h files are generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log2.pb.h"
+#else
+#include "logging/rtc_event_log/rtc_event_log2.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+namespace {
+
+// The widths of the values that are delta encoded. The timestamps are in
+// milliseconds and positive.
+constexpr size_t kTimestampWidth = 63;
+constexpr size_t k1BitWidth = 1;
+constexpr size_t k8BitWidth = 8;
+constexpr size_t k16BitWidth = 16;
+constexpr size_t k24BitWidth = 24;
+constexpr size_t k32BitWidth = 32;
+
+constexpr uint32_t kVoiceActivityFlag = 0x80;
+
+using Value = rtc::Optional<uint64_t>;
+
+// Encodes the values |get_value| returns for all but the first event in
+// |batch| as deltas from the value of the one before, see EncodeDeltas().
+template <typename Event, typename ValueGetter>
+std::string EncodeColumn(rtc::ArrayView<const Event*> batch,
+                         ValueGetter get_value,
+                         size_t value_width_bits) {
+  RTC_DCHECK(!batch.empty());
+  std::vector<Value> values;
+  values.reserve(batch.size() - 1);
+  for (size_t i = 1; i < batch.size(); ++i)
+    values.push_back(get_value(*batch[i]));
+  return EncodeDeltas(get_value(*batch[0]), values, value_width_bits);
+}
+
+uint64_t TimestampMs(const RtcEvent& event) {
+  return static_cast<uint64_t>(event.timestamp_us_ / 1000);
+}
+
+// Signed values are delta encoded as their two's complement.
+uint64_t ToUnsigned32(int32_t value) {
+  return static_cast<uint32_t>(value);
+}
+
+Value OptionalToUnsigned32(const rtc::Optional<int>& value) {
+  return value ? Value(ToUnsigned32(*value)) : rtc::nullopt;
+}
+
+Value OptionalBool(const rtc::Optional<bool>& value) {
+  return value ? Value(*value ? 1 : 0) : rtc::nullopt;
+}
+
+Value FloatBits(const rtc::Optional<float>& value) {
+  if (!value)
+    return rtc::nullopt;
+  uint32_t bits;
+  static_assert(sizeof(bits) == sizeof(*value), "");
+  memcpy(&bits, &*value, sizeof(bits));
+  return bits;
+}
+
+// The values of the header extensions of an RTP packet, or nullopt for the
+// extensions that the packet doesn't have.
+Value TransmissionTimeOffset(const RtpPacket& header) {
+  int32_t value;
+  if (!header.GetExtension<TransmissionOffset>(&value))
+    return rtc::nullopt;
+  // A 24 bit signed value.
+  return static_cast<uint64_t>(value) & 0xffffff;
+}
+
+Value AbsoluteSendTimeValue(const RtpPacket& header) {
+  uint32_t value;
+  if (!header.GetExtension<AbsoluteSendTime>(&value))
+    return rtc::nullopt;
+  return value;
+}
+
+Value TransportSequenceNumberValue(const RtpPacket& header) {
+  uint16_t value;
+  if (!header.GetExtension<TransportSequenceNumber>(&value))
+    return rtc::nullopt;
+  return value;
+}
+
+Value AudioLevelValue(const RtpPacket& header) {
+  bool voice_activity;
+  uint8_t level;
+  if (!header.GetExtension<AudioLevel>(&voice_activity, &level))
+    return rtc::nullopt;
+  RTC_DCHECK_LT(level, kVoiceActivityFlag);
+  return (voice_activity ? kVoiceActivityFlag : 0) | level;
+}
+
+int32_t SignExtend24(uint64_t value) {
+  return static_cast<int32_t>(static_cast<uint32_t>(value) << 8) >> 8;
+}
+
+// The fields that incoming and outgoing packets have in common.
+template <typename Event, typename Proto>
+void EncodeRtpPackets(rtc::ArrayView<const Event*> batch, Proto* proto) {
+  const Event& base = *batch[0];
+  const RtpPacket& header = base.header_;
+  proto->set_timestamp_ms(TimestampMs(base));
+  proto->set_marker(header.Marker());
+  proto->set_payload_type(header.PayloadType());
+  proto->set_sequence_number(header.SequenceNumber());
+  proto->set_rtp_timestamp(header.Timestamp());
+  proto->set_ssrc(header.Ssrc());
+  proto->set_packet_size(base.packet_length_);
+  if (Value value = TransmissionTimeOffset(header))
+    proto->set_transmission_time_offset(SignExtend24(*value));
+  if (Value value = AbsoluteSendTimeValue(header))
+    proto->set_absolute_send_time(*value);
+  if (Value value = TransportSequenceNumberValue(header))
+    proto->set_transport_sequence_number(*value);
+  if (Value value = AudioLevelValue(header))
+    proto->set_audio_level(*value);
+
+  if (batch.size() == 1)
+    return;
+  proto->set_number_of_deltas(batch.size() - 1);
+  std::string deltas;
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return TimestampMs(event); },
+      kTimestampWidth);
+  if (!deltas.empty())
+    proto->set_timestamp_deltas_ms(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) -> Value { return event.header_.Marker(); },
+      k1BitWidth);
+  if (!deltas.empty())
+    proto->set_marker_deltas(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) -> Value { return event.header_.PayloadType(); },
+      k8BitWidth);
+  if (!deltas.empty())
+    proto->set_payload_type_deltas(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) -> Value {
+                          return event.header_.SequenceNumber();
+                        },
+                        k16BitWidth);
+  if (!deltas.empty())
+    proto->set_sequence_number_deltas(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) -> Value { return event.header_.Timestamp(); },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_rtp_timestamp_deltas(deltas);
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return event.header_.Ssrc(); },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_ssrc_deltas(deltas);
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return event.packet_length_; },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_packet_size_deltas(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return TransmissionTimeOffset(event.header_);
+                        },
+                        k24BitWidth);
+  if (!deltas.empty())
+    proto->set_transmission_time_offset_deltas(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) { return AbsoluteSendTimeValue(event.header_); },
+      k24BitWidth);
+  if (!deltas.empty())
+    proto->set_absolute_send_time_deltas(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return TransportSequenceNumberValue(event.header_);
+                        },
+                        k16BitWidth);
+  if (!deltas.empty())
+    proto->set_transport_sequence_number_deltas(deltas);
+  deltas = EncodeColumn(
+      batch, [](const Event& event) { return AudioLevelValue(event.header_); },
+      k8BitWidth);
+  if (!deltas.empty())
+    proto->set_audio_level_deltas(deltas);
+}
+
+// Stores the other packets of |batch| each preceded by its size.
+template <typename Event>
+std::string EncodeRawPackets(rtc::ArrayView<const Event*> batch) {
+  std::string output;
+  for (size_t i = 1; i < batch.size(); ++i) {
+    const rtc::Buffer& packet = batch[i]->packet_;
+    for (size_t size = packet.size(); ; size >>= 7) {
+      if (size < 0x80) {
+        output.push_back(static_cast<char>(size));
+        break;
+      }
+      output.push_back(static_cast<char>(0x80 | (size & 0x7f)));
+    }
+    output.append(reinterpret_cast<const char*>(packet.data()), packet.size());
+  }
+  return output;
+}
+
+template <typename Event, typename Proto>
+void EncodeRtcpPackets(rtc::ArrayView<const Event*> batch, Proto* proto) {
+  const Event& base = *batch[0];
+  proto->set_timestamp_ms(TimestampMs(base));
+  proto->set_raw_packet(base.packet_.data(), base.packet_.size());
+  if (batch.size() == 1)
+    return;
+  proto->set_number_of_deltas(batch.size() - 1);
+  const std::string timestamp_deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return TimestampMs(event); },
+      kTimestampWidth);
+  if (!timestamp_deltas.empty())
+    proto->set_timestamp_deltas_ms(timestamp_deltas);
+  proto->set_raw_packet_deltas(EncodeRawPackets(batch));
+}
+
+template <typename Proto>
+void EncodeHeaderExtensions(const std::vector<RtpExtension>& extensions,
+                            Proto* proto) {
+  rtclog2::RtpHeaderExtensionConfig config;
+  bool has_extensions = false;
+  for (const RtpExtension& extension : extensions) {
+    if (extension.uri == RtpExtension::kTimestampOffsetUri) {
+      config.set_transmission_time_offset_id(extension.id);
+    } else if (extension.uri == RtpExtension::kAbsSendTimeUri) {
+      config.set_absolute_send_time_id(extension.id);
+    } else if (extension.uri == RtpExtension::kTransportSequenceNumberUri) {
+      config.set_transport_sequence_number_id(extension.id);
+    } else if (extension.uri == RtpExtension::kAudioLevelUri) {
+      config.set_audio_level_id(extension.id);
+    } else {
+      continue;
+    }
+    has_extensions = true;
+  }
+  if (has_extensions)
+    *proto->mutable_header_extensions() = config;
+}
+
+rtclog2::DelayBasedBweUpdates::DetectorState ConvertDetectorState(
+    BandwidthUsage state) {
+  switch (state) {
+    case BandwidthUsage::kBwNormal:
+      return rtclog2::DelayBasedBweUpdates::BWE_NORMAL;
+    case BandwidthUsage::kBwUnderusing:
+      return rtclog2::DelayBasedBweUpdates::BWE_UNDERUSING;
+    case BandwidthUsage::kBwOverusing:
+      return rtclog2::DelayBasedBweUpdates::BWE_OVERUSING;
+    case BandwidthUsage::kLast:
+      RTC_NOTREACHED();
+  }
+  RTC_NOTREACHED();
+  return rtclog2::DelayBasedBweUpdates::BWE_NORMAL;
+}
+
+rtclog2::BweProbeResultFailure::FailureReason ConvertProbeFailureReason(
+    ProbeFailureReason failure_reason) {
+  switch (failure_reason) {
+    case ProbeFailureReason::kInvalidSendReceiveInterval:
+      return rtclog2::BweProbeResultFailure::INVALID_SEND_RECEIVE_INTERVAL;
+    case ProbeFailureReason::kInvalidSendReceiveRatio:
+      return rtclog2::BweProbeResultFailure::INVALID_SEND_RECEIVE_RATIO;
+    case ProbeFailureReason::kTimeout:
+      return rtclog2::BweProbeResultFailure::TIMEOUT;
+    case ProbeFailureReason::kLast:
+      RTC_NOTREACHED();
+  }
+  RTC_NOTREACHED();
+  return rtclog2::BweProbeResultFailure::UNKNOWN;
+}
+
+rtclog2::IceCandidatePairConfig::IceCandidatePairConfigType
+ConvertIceCandidatePairConfigType(IceCandidatePairEventType type) {
+  switch (type) {
+    case IceCandidatePairEventType::kAdded:
+      return rtclog2::IceCandidatePairConfig::ADDED;
+    case IceCandidatePairEventType::kUpdated:
+      return rtclog2::IceCandidatePairConfig::UPDATED;
+    case IceCandidatePairEventType::kDestroyed:
+      return rtclog2::IceCandidatePairConfig::DESTROYED;
+    case IceCandidatePairEventType::kSelected:
+      return rtclog2::IceCandidatePairConfig::SELECTED;
+    default:
+      RTC_NOTREACHED();
+  }
+  return rtclog2::IceCandidatePairConfig::UNKNOWN_CONFIG_TYPE;
+}
+
+rtclog2::IceCandidatePairConfig::IceCandidateType ConvertIceCandidateType(
+    IceCandidateType type) {
+  switch (type) {
+    case IceCandidateType::kLocal:
+      return rtclog2::IceCandidatePairConfig::LOCAL;
+    case IceCandidateType::kStun:
+      return rtclog2::IceCandidatePairConfig::STUN;
+    case IceCandidateType::kPrflx:
+      return rtclog2::IceCandidatePairConfig::PRFLX;
+    case IceCandidateType::kRelay:
+      return rtclog2::IceCandidatePairConfig::RELAY;
+    case IceCandidateType::kUnknown:
+      return rtclog2::IceCandidatePairConfig::UNKNOWN_CANDIDATE_TYPE;
+  }
+  RTC_NOTREACHED();
+  return rtclog2::IceCandidatePairConfig::UNKNOWN_CANDIDATE_TYPE;
+}
+
+rtclog2::IceCandidatePairConfig::Protocol ConvertIceCandidatePairProtocol(
+    IceCandidatePairProtocol protocol) {
+  switch (protocol) {
+    case IceCandidatePairProtocol::kUdp:
+      return rtclog2::IceCandidatePairConfig::UDP;
+    case IceCandidatePairProtocol::kTcp:
+      return rtclog2::IceCandidatePairConfig::TCP;
+    case IceCandidatePairProtocol::kSsltcp:
+      return rtclog2::IceCandidatePairConfig::SSLTCP;
+    case IceCandidatePairProtocol::kTls:
+      return rtclog2::IceCandidatePairConfig::TLS;
+    case IceCandidatePairProtocol::kUnknown:
+      return rtclog2::IceCandidatePairConfig::UNKNOWN_PROTOCOL;
+  }
+  RTC_NOTREACHED();
+  return rtclog2::IceCandidatePairConfig::UNKNOWN_PROTOCOL;
+}
+
+rtclog2::IceCandidatePairConfig::AddressFamily
+ConvertIceCandidatePairAddressFamily(
+    IceCandidatePairAddressFamily address_family) {
+  switch (address_family) {
+    case IceCandidatePairAddressFamily::kIpv4:
+      return rtclog2::IceCandidatePairConfig::IPV4;
+    case IceCandidatePairAddressFamily::kIpv6:
+      return rtclog2::IceCandidatePairConfig::IPV6;
+    case IceCandidatePairAddressFamily::kUnknown:
+      return rtclog2::IceCandidatePairConfig::UNKNOWN_ADDRESS_FAMILY;
+  }
+  RTC_NOTREACHED();
+  return rtclog2::IceCandidatePairConfig::UNKNOWN_ADDRESS_FAMILY;
+}
+
+rtclog2::IceCandidatePairConfig::NetworkType ConvertIceCandidateNetworkType(
+    IceCandidateNetworkType network_type) {
+  switch (network_type) {
+    case IceCandidateNetworkType::kEthernet:
+      return rtclog2::IceCandidatePairConfig::ETHERNET;
+    case IceCandidateNetworkType::kLoopback:
+      return rtclog2::IceCandidatePairConfig::LOOPBACK;
+    case IceCandidateNetworkType::kWifi:
+      return rtclog2::IceCandidatePairConfig::WIFI;
+    case IceCandidateNetworkType::kVpn:
+      return rtclog2::IceCandidatePairConfig::VPN;
+    case IceCandidateNetworkType::kCellular:
+      return rtclog2::IceCandidatePairConfig::CELLULAR;
+    case IceCandidateNetworkType::kUnknown:
+      return rtclog2::IceCandidatePairConfig::UNKNOWN_NETWORK_TYPE;
+  }
+  RTC_NOTREACHED();
+  return rtclog2::IceCandidatePairConfig::UNKNOWN_NETWORK_TYPE;
+}
+
+rtclog2::IceCandidatePairEvent::IceCandidatePairEventType
+ConvertIceCandidatePairEventType(IceCandidatePairEventType type) {
+  switch (type) {
+    case IceCandidatePairEventType::kCheckSent:
+      return rtclog2::IceCandidatePairEvent::CHECK_SENT;
+    case IceCandidatePairEventType::kCheckReceived:
+      return rtclog2::IceCandidatePairEvent::CHECK_RECEIVED;
+    case IceCandidatePairEventType::kCheckResponseSent:
+      return rtclog2::IceCandidatePairEvent::CHECK_RESPONSE_SENT;
+    case IceCandidatePairEventType::kCheckResponseReceived:
+      return rtclog2::IceCandidatePairEvent::CHECK_RESPONSE_RECEIVED;
+    default:
+      RTC_NOTREACHED();
+  }
+  return rtclog2::IceCandidatePairEvent::UNKNOWN_CHECK_TYPE;
+}
+
+}  // namespace
+
+std::string RtcEventLogEncoderNewFormat::EncodeLogStart(int64_t timestamp_us) {
+  rtclog2::EventStream event_stream;
+  event_stream.set_version(2);
+  event_stream.add_begin_log_events()->set_timestamp_ms(timestamp_us / 1000);
+  return event_stream.SerializeAsString();
+}
+
+std::string RtcEventLogEncoderNewFormat::EncodeLogEnd(int64_t timestamp_us) {
+  rtclog2::EventStream event_stream;
+  event_stream.add_end_log_events()->set_timestamp_ms(timestamp_us / 1000);
+  return event_stream.SerializeAsString();
+}
+
+std::string RtcEventLogEncoderNewFormat::EncodeBatch(
+    std::deque<std::unique_ptr<RtcEvent>>::const_iterator begin,
+    std::deque<std::unique_ptr<RtcEvent>>::const_iterator end) {
+  std::vector<const RtcEventAlrState*> alr_state_events;
+  std::vector<const RtcEventAudioNetworkAdaptation*>
+      audio_network_adaptation_events;
+  std::vector<const RtcEventAudioPlayout*> audio_playout_events;
+  std::vector<const RtcEventAudioReceiveStreamConfig*>
+      audio_recv_stream_configs;
+  std::vector<const RtcEventAudioSendStreamConfig*> audio_send_stream_configs;
+  std::vector<const RtcEventBweUpdateDelayBased*> bwe_delay_based_updates;
+  std::vector<const RtcEventBweUpdateLossBased*> bwe_loss_based_updates;
+  std::vector<const RtcEventIceCandidatePairConfig*> ice_candidate_configs;
+  std::vector<const RtcEventIceCandidatePair*> ice_candidate_events;
+  std::vector<const RtcEventProbeClusterCreated*> probe_cluster_created_events;
+  std::vector<const RtcEventProbeResultFailure*> probe_result_failure_events;
+  std::vector<const RtcEventProbeResultSuccess*> probe_result_success_events;
+  std::vector<const RtcEventRtcpPacketIncoming*> incoming_rtcp_packets;
+  std::vector<const RtcEventRtcpPacketOutgoing*> outgoing_rtcp_packets;
+  std::map<uint32_t, std::vector<const RtcEventRtpPacketIncoming*>>
+      incoming_rtp_packets;
+  std::map<uint32_t, std::vector<const RtcEventRtpPacketOutgoing*>>
+      outgoing_rtp_packets;
+  std::vector<const RtcEventVideoReceiveStreamConfig*>
+      video_recv_stream_configs;
+  std::vector<const RtcEventVideoSendStreamConfig*> video_send_stream_configs;
+
+  for (auto it = begin; it != end; ++it) {
+    const RtcEvent* event = it->get();
+    switch (event->GetType()) {
+      case RtcEvent::Type::AlrStateEvent:
+        alr_state_events.push_back(
+            static_cast<const RtcEventAlrState*>(event));
+        break;
+      case RtcEvent::Type::AudioNetworkAdaptation:
+        audio_network_adaptation_events.push_back(
+            static_cast<const RtcEventAudioNetworkAdaptation*>(event));
+        break;
+      case RtcEvent::Type::AudioPlayout:
+        audio_playout_events.push_back(
+            static_cast<const RtcEventAudioPlayout*>(event));
+        break;
+      case RtcEvent::Type::AudioReceiveStreamConfig:
+        audio_recv_stream_configs.push_back(
+            static_cast<const RtcEventAudioReceiveStreamConfig*>(event));
+        break;
+      case RtcEvent::Type::AudioSendStreamConfig:
+        audio_send_stream_configs.push_back(
+            static_cast<const RtcEventAudioSendStreamConfig*>(event));
+        break;
+      case RtcEvent::Type::BweUpdateDelayBased:
+        bwe_delay_based_updates.push_back(
+            static_cast<const RtcEventBweUpdateDelayBased*>(event));
+        break;
+      case RtcEvent::Type::BweUpdateLossBased:
+        bwe_loss_based_updates.push_back(
+            static_cast<const RtcEventBweUpdateLossBased*>(event));
+        break;
+      case RtcEvent::Type::IceCandidatePairConfig:
+        ice_candidate_configs.push_back(
+            static_cast<const RtcEventIceCandidatePairConfig*>(event));
+        break;
+      case RtcEvent::Type::IceCandidatePairEvent:
+        ice_candidate_events.push_back(
+            static_cast<const RtcEventIceCandidatePair*>(event));
+        break;
+      case RtcEvent::Type::ProbeClusterCreated:
+        probe_cluster_created_events.push_back(
+            static_cast<const RtcEventProbeClusterCreated*>(event));
+        break;
+      case RtcEvent::Type::ProbeResultFailure:
+        probe_result_failure_events.push_back(
+            static_cast<const RtcEventProbeResultFailure*>(event));
+        break;
+      case RtcEvent::Type::ProbeResultSuccess:
+        probe_result_success_events.push_back(
+            static_cast<const RtcEventProbeResultSuccess*>(event));
+        break;
+      case RtcEvent::Type::RtcpPacketIncoming:
+        incoming_rtcp_packets.push_back(
+            static_cast<const RtcEventRtcpPacketIncoming*>(event));
+        break;
+      case RtcEvent::Type::RtcpPacketOutgoing:
+        outgoing_rtcp_packets.push_back(
+            static_cast<const RtcEventRtcpPacketOutgoing*>(event));
+        break;
+      case RtcEvent::Type::RtpPacketIncoming: {
+        auto* rtp_event = static_cast<const RtcEventRtpPacketIncoming*>(event);
+        incoming_rtp_packets[rtp_event->header_.Ssrc()].push_back(rtp_event);
+        break;
+      }
+      case RtcEvent::Type::RtpPacketOutgoing: {
+        auto* rtp_event = static_cast<const RtcEventRtpPacketOutgoing*>(event);
+        outgoing_rtp_packets[rtp_event->header_.Ssrc()].push_back(rtp_event);
+        break;
+      }
+      case RtcEvent::Type::VideoReceiveStreamConfig:
+        video_recv_stream_configs.push_back(
+            static_cast<const RtcEventVideoReceiveStreamConfig*>(event));
+        break;
+      case RtcEvent::Type::VideoSendStreamConfig:
+        video_send_stream_configs.push_back(
+            static_cast<const RtcEventVideoSendStreamConfig*>(event));
+        break;
+    }
+  }
+
+  rtclog2::EventStream event_stream;
+  EncodeAlrState(alr_state_events, &event_stream);
+  EncodeAudioNetworkAdaptation(audio_network_adaptation_events, &event_stream);
+  EncodeAudioPlayout(audio_playout_events, &event_stream);
+  EncodeAudioRecvStreamConfig(audio_recv_stream_configs, &event_stream);
+  EncodeAudioSendStreamConfig(audio_send_stream_configs, &event_stream);
+  EncodeBweUpdateDelayBased(bwe_delay_based_updates, &event_stream);
+  EncodeBweUpdateLossBased(bwe_loss_based_updates, &event_stream);
+  EncodeIceCandidatePairConfig(ice_candidate_configs, &event_stream);
+  EncodeIceCandidatePairEvent(ice_candidate_events, &event_stream);
+  EncodeProbeClusterCreated(probe_cluster_created_events, &event_stream);
+  EncodeProbeResultFailure(probe_result_failure_events, &event_stream);
+  EncodeProbeResultSuccess(probe_result_success_events, &event_stream);
+  EncodeRtcpPacketIncoming(incoming_rtcp_packets, &event_stream);
+  EncodeRtcpPacketOutgoing(outgoing_rtcp_packets, &event_stream);
+  for (auto& ssrc_and_packets : incoming_rtp_packets)
+    EncodeRtpPacketIncoming(ssrc_and_packets.second, &event_stream);
+  for (auto& ssrc_and_packets : outgoing_rtp_packets)
+    EncodeRtpPacketOutgoing(ssrc_and_packets.second, &event_stream);
+  EncodeVideoRecvStreamConfig(video_recv_stream_configs, &event_stream);
+  EncodeVideoSendStreamConfig(video_send_stream_configs, &event_stream);
+  return event_stream.SerializeAsString();
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAlrState(
+    rtc::ArrayView<const RtcEventAlrState*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventAlrState* event : batch) {
+    rtclog2::AlrState* proto = event_stream->add_alr_states();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_in_alr(event->in_alr_);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAudioNetworkAdaptation(
+    rtc::ArrayView<const RtcEventAudioNetworkAdaptation*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  using Event = RtcEventAudioNetworkAdaptation;
+  rtclog2::AudioNetworkAdaptations* proto =
+      event_stream->add_audio_network_adaptations();
+  const AudioEncoderRuntimeConfig& base = *batch[0]->config_;
+  proto->set_timestamp_ms(TimestampMs(*batch[0]));
+  if (base.bitrate_bps)
+    proto->set_bitrate_bps(*base.bitrate_bps);
+  if (base.frame_length_ms)
+    proto->set_frame_length_ms(*base.frame_length_ms);
+  if (base.uplink_packet_loss_fraction)
+    proto->set_uplink_packet_loss_fraction(*base.uplink_packet_loss_fraction);
+  if (base.enable_fec)
+    proto->set_enable_fec(*base.enable_fec);
+  if (base.enable_dtx)
+    proto->set_enable_dtx(*base.enable_dtx);
+  if (base.num_channels)
+    proto->set_num_channels(*base.num_channels);
+
+  if (batch.size() == 1)
+    return;
+  proto->set_number_of_deltas(batch.size() - 1);
+  std::string deltas;
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return TimestampMs(event); },
+      kTimestampWidth);
+  if (!deltas.empty())
+    proto->set_timestamp_deltas_ms(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return OptionalToUnsigned32(
+                              event.config_->bitrate_bps);
+                        },
+                        k32BitWidth);
+  if (!deltas.empty())
+    proto->set_bitrate_deltas_bps(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return OptionalToUnsigned32(
+                              event.config_->frame_length_ms);
+                        },
+                        k32BitWidth);
+  if (!deltas.empty())
+    proto->set_frame_length_deltas_ms(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return FloatBits(
+                              event.config_->uplink_packet_loss_fraction);
+                        },
+                        k32BitWidth);
+  if (!deltas.empty())
+    proto->set_uplink_packet_loss_fraction_deltas(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return OptionalBool(event.config_->enable_fec);
+                        },
+                        k1BitWidth);
+  if (!deltas.empty())
+    proto->set_enable_fec_deltas(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) {
+                          return OptionalBool(event.config_->enable_dtx);
+                        },
+                        k1BitWidth);
+  if (!deltas.empty())
+    proto->set_enable_dtx_deltas(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) -> Value {
+                          if (!event.config_->num_channels)
+                            return rtc::nullopt;
+                          return *event.config_->num_channels;
+                        },
+                        k32BitWidth);
+  if (!deltas.empty())
+    proto->set_num_channels_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAudioPlayout(
+    rtc::ArrayView<const RtcEventAudioPlayout*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  using Event = RtcEventAudioPlayout;
+  rtclog2::AudioPlayoutEvents* proto = event_stream->add_audio_playout_events();
+  proto->set_timestamp_ms(TimestampMs(*batch[0]));
+  proto->set_local_ssrc(batch[0]->ssrc_);
+
+  if (batch.size() == 1)
+    return;
+  proto->set_number_of_deltas(batch.size() - 1);
+  std::string deltas;
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return TimestampMs(event); },
+      kTimestampWidth);
+  if (!deltas.empty())
+    proto->set_timestamp_deltas_ms(deltas);
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return event.ssrc_; },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_local_ssrc_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAudioRecvStreamConfig(
+    rtc::ArrayView<const RtcEventAudioReceiveStreamConfig*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventAudioReceiveStreamConfig* event : batch) {
+    rtclog2::AudioRecvStreamConfig* proto =
+        event_stream->add_audio_recv_stream_configs();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_remote_ssrc(event->config_->remote_ssrc);
+    proto->set_local_ssrc(event->config_->local_ssrc);
+    if (!event->config_->rsid.empty())
+      proto->set_rsid(event->config_->rsid);
+    EncodeHeaderExtensions(event->config_->rtp_extensions, proto);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeAudioSendStreamConfig(
+    rtc::ArrayView<const RtcEventAudioSendStreamConfig*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventAudioSendStreamConfig* event : batch) {
+    rtclog2::AudioSendStreamConfig* proto =
+        event_stream->add_audio_send_stream_configs();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_ssrc(event->config_->local_ssrc);
+    if (!event->config_->rsid.empty())
+      proto->set_rsid(event->config_->rsid);
+    EncodeHeaderExtensions(event->config_->rtp_extensions, proto);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeBweUpdateDelayBased(
+    rtc::ArrayView<const RtcEventBweUpdateDelayBased*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  using Event = RtcEventBweUpdateDelayBased;
+  rtclog2::DelayBasedBweUpdates* proto =
+      event_stream->add_delay_based_bwe_updates();
+  proto->set_timestamp_ms(TimestampMs(*batch[0]));
+  proto->set_bitrate_bps(batch[0]->bitrate_bps_);
+  proto->set_detector_state(ConvertDetectorState(batch[0]->detector_state_));
+
+  if (batch.size() == 1)
+    return;
+  proto->set_number_of_deltas(batch.size() - 1);
+  std::string deltas;
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return TimestampMs(event); },
+      kTimestampWidth);
+  if (!deltas.empty())
+    proto->set_timestamp_deltas_ms(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) -> Value {
+        return ToUnsigned32(event.bitrate_bps_);
+      },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_bitrate_deltas_bps(deltas);
+  deltas = EncodeColumn(batch,
+                        [](const Event& event) -> Value {
+                          return static_cast<uint64_t>(
+                              ConvertDetectorState(event.detector_state_));
+                        },
+                        k8BitWidth);
+  if (!deltas.empty())
+    proto->set_detector_state_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeBweUpdateLossBased(
+    rtc::ArrayView<const RtcEventBweUpdateLossBased*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  using Event = RtcEventBweUpdateLossBased;
+  rtclog2::LossBasedBweUpdates* proto =
+      event_stream->add_loss_based_bwe_updates();
+  proto->set_timestamp_ms(TimestampMs(*batch[0]));
+  proto->set_bitrate_bps(batch[0]->bitrate_bps_);
+  proto->set_fraction_loss(batch[0]->fraction_loss_);
+  proto->set_total_packets(batch[0]->total_packets_);
+
+  if (batch.size() == 1)
+    return;
+  proto->set_number_of_deltas(batch.size() - 1);
+  std::string deltas;
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return TimestampMs(event); },
+      kTimestampWidth);
+  if (!deltas.empty())
+    proto->set_timestamp_deltas_ms(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) -> Value {
+        return ToUnsigned32(event.bitrate_bps_);
+      },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_bitrate_deltas_bps(deltas);
+  deltas = EncodeColumn(
+      batch, [](const Event& event) -> Value { return event.fraction_loss_; },
+      k8BitWidth);
+  if (!deltas.empty())
+    proto->set_fraction_loss_deltas(deltas);
+  deltas = EncodeColumn(
+      batch,
+      [](const Event& event) -> Value {
+        return ToUnsigned32(event.total_packets_);
+      },
+      k32BitWidth);
+  if (!deltas.empty())
+    proto->set_total_packets_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeIceCandidatePairConfig(
+    rtc::ArrayView<const RtcEventIceCandidatePairConfig*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventIceCandidatePairConfig* event : batch) {
+    rtclog2::IceCandidatePairConfig* proto =
+        event_stream->add_ice_candidate_configs();
+    const IceCandidatePairDescription& desc = event->candidate_pair_desc_;
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_config_type(ConvertIceCandidatePairConfigType(event->type_));
+    proto->set_candidate_pair_id(event->candidate_pair_id_);
+    proto->set_local_candidate_type(
+        ConvertIceCandidateType(desc.local_candidate_type));
+    proto->set_local_relay_protocol(
+        ConvertIceCandidatePairProtocol(desc.local_relay_protocol));
+    proto->set_local_network_type(
+        ConvertIceCandidateNetworkType(desc.local_network_type));
+    proto->set_local_address_family(
+        ConvertIceCandidatePairAddressFamily(desc.local_address_family));
+    proto->set_remote_candidate_type(
+        ConvertIceCandidateType(desc.remote_candidate_type));
+    proto->set_remote_address_family(
+        ConvertIceCandidatePairAddressFamily(desc.remote_address_family));
+    proto->set_candidate_pair_protocol(
+        ConvertIceCandidatePairProtocol(desc.candidate_pair_protocol));
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeIceCandidatePairEvent(
+    rtc::ArrayView<const RtcEventIceCandidatePair*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventIceCandidatePair* event : batch) {
+    rtclog2::IceCandidatePairEvent* proto =
+        event_stream->add_ice_candidate_events();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_event_type(ConvertIceCandidatePairEventType(event->type_));
+    proto->set_candidate_pair_id(event->candidate_pair_id_);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeProbeClusterCreated(
+    rtc::ArrayView<const RtcEventProbeClusterCreated*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventProbeClusterCreated* event : batch) {
+    rtclog2::BweProbeCluster* proto = event_stream->add_probe_clusters();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_id(event->id_);
+    proto->set_bitrate_bps(event->bitrate_bps_);
+    proto->set_min_packets(event->min_probes_);
+    proto->set_min_bytes(event->min_bytes_);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeProbeResultFailure(
+    rtc::ArrayView<const RtcEventProbeResultFailure*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventProbeResultFailure* event : batch) {
+    rtclog2::BweProbeResultFailure* proto = event_stream->add_probe_failure();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_id(event->id_);
+    proto->set_failure(ConvertProbeFailureReason(event->failure_reason_));
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeProbeResultSuccess(
+    rtc::ArrayView<const RtcEventProbeResultSuccess*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventProbeResultSuccess* event : batch) {
+    rtclog2::BweProbeResultSuccess* proto = event_stream->add_probe_success();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_id(event->id_);
+    proto->set_bitrate_bps(event->bitrate_bps_);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtcpPacketIncoming(
+    rtc::ArrayView<const RtcEventRtcpPacketIncoming*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (!batch.empty())
+    EncodeRtcpPackets(batch, event_stream->add_incoming_rtcp_packets());
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtcpPacketOutgoing(
+    rtc::ArrayView<const RtcEventRtcpPacketOutgoing*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (!batch.empty())
+    EncodeRtcpPackets(batch, event_stream->add_outgoing_rtcp_packets());
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtpPacketIncoming(
+    rtc::ArrayView<const RtcEventRtpPacketIncoming*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (!batch.empty())
+    EncodeRtpPackets(batch, event_stream->add_incoming_rtp_packets());
+}
+
+void RtcEventLogEncoderNewFormat::EncodeRtpPacketOutgoing(
+    rtc::ArrayView<const RtcEventRtpPacketOutgoing*> batch,
+    rtclog2::EventStream* event_stream) {
+  if (batch.empty())
+    return;
+  using Event = RtcEventRtpPacketOutgoing;
+  rtclog2::OutgoingRtpPackets* proto =
+      event_stream->add_outgoing_rtp_packets();
+  EncodeRtpPackets(batch, proto);
+  auto probe_cluster_id = [](const Event& event) -> Value {
+    if (event.probe_cluster_id_ == PacedPacketInfo::kNotAProbe)
+      return rtc::nullopt;
+    return ToUnsigned32(event.probe_cluster_id_);
+  };
+  if (batch[0]->probe_cluster_id_ != PacedPacketInfo::kNotAProbe)
+    proto->set_probe_cluster_id(batch[0]->probe_cluster_id_);
+  if (batch.size() == 1)
+    return;
+  const std::string deltas =
+      EncodeColumn(batch, probe_cluster_id, k32BitWidth);
+  if (!deltas.empty())
+    proto->set_probe_cluster_id_deltas(deltas);
+}
+
+void RtcEventLogEncoderNewFormat::EncodeVideoRecvStreamConfig(
+    rtc::ArrayView<const RtcEventVideoReceiveStreamConfig*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventVideoReceiveStreamConfig* event : batch) {
+    rtclog2::VideoRecvStreamConfig* proto =
+        event_stream->add_video_recv_stream_configs();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_remote_ssrc(event->config_->remote_ssrc);
+    proto->set_local_ssrc(event->config_->local_ssrc);
+    if (event->config_->rtx_ssrc)
+      proto->set_rtx_ssrc(event->config_->rtx_ssrc);
+    if (!event->config_->rsid.empty())
+      proto->set_rsid(event->config_->rsid);
+    EncodeHeaderExtensions(event->config_->rtp_extensions, proto);
+  }
+}
+
+void RtcEventLogEncoderNewFormat::EncodeVideoSendStreamConfig(
+    rtc::ArrayView<const RtcEventVideoSendStreamConfig*> batch,
+    rtclog2::EventStream* event_stream) {
+  for (const RtcEventVideoSendStreamConfig* event : batch) {
+    rtclog2::VideoSendStreamConfig* proto =
+        event_stream->add_video_send_stream_configs();
+    proto->set_timestamp_ms(TimestampMs(*event));
+    proto->set_ssrc(event->config_->local_ssrc);
+    if (event->config_->rtx_ssrc)
+      proto->set_rtx_ssrc(event->config_->rtx_ssrc);
+    if (!event->config_->rsid.empty())
+      proto->set_rsid(event->config_->rsid);
+    EncodeHeaderExtensions(event->config_->rtp_extensions, proto);
+  }
+}
+
+}  // namespace webrtc
+
+#endif  // ENABLE_RTC_EVENT_LOG
@@ -0,0 +1,230 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "logging/rtc_event_log/encoder/delta_encoding.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
+#include "logging/rtc_event_log/events/rtc_event_rtcp_packet_incoming.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_outgoing.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/fakeclock.h"
+#include "rtc_base/ignore_wundef.h"
+#include "rtc_base/ptr_util.h"
+#include "test/gtest.h"
+
+// *.pb.h files are generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log2.pb.h"
+#else
+#include "logging/rtc_event_log/rtc_event_log2.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kTransportSequenceNumberId = 5;
+constexpr size_t kNumPackets = 100;
+
+std::vector<rtc::Optional<uint64_t>> Decode(const std::string& deltas,
+                                            uint64_t base,
+                                            size_t num_of_deltas,
+                                            size_t value_width_bits) {
+  return DecodeDeltas(deltas, base, num_of_deltas, value_width_bits);
+}
+
+}  // namespace
+
+class RtcEventLogEncoderNewFormatTest : public testing::Test {
+ protected:
+  RtcEventLogEncoderNewFormatTest() {
+    clock_.SetTimeMicros(1000000);
+    extensions_.Register<TransportSequenceNumber>(kTransportSequenceNumberId);
+  }
+
+  // Logs |kNumPackets| packets of |ssrc|, one every 20 ms.
+  void LogRtpPackets(uint32_t ssrc, int probe_cluster_id) {
+    for (size_t i = 0; i < kNumPackets; ++i) {
+      RtpPacketToSend packet(&extensions_);
+      packet.SetSsrc(ssrc);
+      packet.SetSequenceNumber(static_cast<uint16_t>(0xffc0 + i));
+      packet.SetTimestamp(static_cast<uint32_t>(90 * 20 * i));
+      packet.SetPayloadType(111);
+      packet.SetMarker(i % 10 == 0);
+      packet.SetExtension<TransportSequenceNumber>(
+          static_cast<uint16_t>(1000 + 2 * i));
+      packet.SetPayloadSize(100 + i % 3);
+      history_.push_back(
+          rtc::MakeUnique<RtcEventRtpPacketOutgoing>(packet, probe_cluster_id));
+      clock_.AdvanceTimeMicros(20000);
+    }
+  }
+
+  rtclog2::EventStream EncodeHistory() {
+    rtclog2::EventStream event_stream;
+    EXPECT_TRUE(event_stream.ParseFromString(
+        encoder_.EncodeBatch(history_.begin(), history_.end())));
+    return event_stream;
+  }
+
+  rtc::ScopedFakeClock clock_;
+  RtpHeaderExtensionMap extensions_;
+  RtcEventLogEncoderNewFormat encoder_;
+  std::deque<std::unique_ptr<RtcEvent>> history_;
+};
+
+TEST_F(RtcEventLogEncoderNewFormatTest, LogStartAndEnd) {
+  rtclog2::EventStream event_stream;
+  ASSERT_TRUE(event_stream.ParseFromString(encoder_.EncodeLogStart(123456)));
+  EXPECT_EQ(2u, event_stream.version());
+  ASSERT_EQ(1, event_stream.begin_log_events_size());
+  EXPECT_EQ(123, event_stream.begin_log_events(0).timestamp_ms());
+
+  ASSERT_TRUE(event_stream.ParseFromString(encoder_.EncodeLogEnd(654321)));
+  ASSERT_EQ(1, event_stream.end_log_events_size());
+  EXPECT_EQ(654, event_stream.end_log_events(0).timestamp_ms());
+}
+
+TEST_F(RtcEventLogEncoderNewFormatTest, RtpPacketsOfAnSsrcAreOneMessage) {
+  LogRtpPackets(0x11111111, PacedPacketInfo::kNotAProbe);
+  const rtclog2::EventStream event_stream = EncodeHistory();
+  ASSERT_EQ(1, event_stream.outgoing_rtp_packets_size());
+  const rtclog2::OutgoingRtpPackets& proto =
+      event_stream.outgoing_rtp_packets(0);
+  const size_t num_deltas = kNumPackets - 1;
+  ASSERT_EQ(num_deltas, proto.number_of_deltas());
+
+  const RtcEventRtpPacketOutgoing& first =
+      static_cast<const RtcEventRtpPacketOutgoing&>(*history_[0]);
+  EXPECT_EQ(first.timestamp_us_ / 1000, proto.timestamp_ms());
+  EXPECT_EQ(0x11111111u, proto.ssrc());
+  EXPECT_EQ(0xffc0u, proto.sequence_number());
+  EXPECT_EQ(1000u, proto.transport_sequence_number());
+  EXPECT_FALSE(proto.has_probe_cluster_id());
+
+  // The fields that don't change aren't stored.
+  EXPECT_FALSE(proto.has_ssrc_deltas());
+  EXPECT_FALSE(proto.has_payload_type_deltas());
+  EXPECT_FALSE(proto.has_probe_cluster_id_deltas());
+  EXPECT_FALSE(proto.has_absolute_send_time_deltas());
+
+  const auto timestamps_ms = Decode(proto.timestamp_deltas_ms(),
+                                    proto.timestamp_ms(), num_deltas, 63);
+  const auto sequence_numbers = Decode(proto.sequence_number_deltas(),
+                                       proto.sequence_number(), num_deltas, 16);
+  const auto rtp_timestamps = Decode(proto.rtp_timestamp_deltas(),
+                                     proto.rtp_timestamp(), num_deltas, 32);
+  const auto markers =
+      Decode(proto.marker_deltas(), proto.marker(), num_deltas, 1);
+  const auto packet_sizes = Decode(proto.packet_size_deltas(),
+                                   proto.packet_size(), num_deltas, 32);
+  const auto transport_sequence_numbers =
+      Decode(proto.transport_sequence_number_deltas(),
+             proto.transport_sequence_number(), num_deltas, 16);
+  ASSERT_EQ(num_deltas, timestamps_ms.size());
+  ASSERT_EQ(num_deltas, sequence_numbers.size());
+  ASSERT_EQ(num_deltas, rtp_timestamps.size());
+  ASSERT_EQ(num_deltas, markers.size());
+  ASSERT_EQ(num_deltas, packet_sizes.size());
+  ASSERT_EQ(num_deltas, transport_sequence_numbers.size());
+  for (size_t i = 0; i < num_deltas; ++i) {
+    const RtcEventRtpPacketOutgoing& event =
+        static_cast<const RtcEventRtpPacketOutgoing&>(*history_[i + 1]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(event.timestamp_us_ / 1000),
+              timestamps_ms[i]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(event.header_.SequenceNumber()),
+              sequence_numbers[i]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(event.header_.Timestamp()),
+              rtp_timestamps[i]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(event.header_.Marker()), markers[i]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(event.packet_length_), packet_sizes[i]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(1000 + 2 * (i + 1)),
+              transport_sequence_numbers[i]);
+  }
+}
+
+TEST_F(RtcEventLogEncoderNewFormatTest, RtpPacketsAreGroupedBySsrc) {
+  LogRtpPackets(0x11111111, PacedPacketInfo::kNotAProbe);
+  LogRtpPackets(0x22222222, 7);
+  const rtclog2::EventStream event_stream = EncodeHistory();
+  ASSERT_EQ(2, event_stream.outgoing_rtp_packets_size());
+  EXPECT_EQ(0x11111111u, event_stream.outgoing_rtp_packets(0).ssrc());
+  EXPECT_EQ(0x22222222u, event_stream.outgoing_rtp_packets(1).ssrc());
+  EXPECT_EQ(7, event_stream.outgoing_rtp_packets(1).probe_cluster_id());
+  EXPECT_FALSE(event_stream.outgoing_rtp_packets(1).has_ssrc_deltas());
+  EXPECT_FALSE(
+      event_stream.outgoing_rtp_packets(1).has_probe_cluster_id_deltas());
+}
+
+TEST_F(RtcEventLogEncoderNewFormatTest, TakesLessSpaceThanTheLegacyFormat) {
+  LogRtpPackets(0x11111111, PacedPacketInfo::kNotAProbe);
+  RtcEventLogEncoderLegacy legacy_encoder;
+  const size_t legacy_size =
+      legacy_encoder.EncodeBatch(history_.begin(), history_.end()).size();
+  const size_t new_size =
+      encoder_.EncodeBatch(history_.begin(), history_.end()).size();
+  EXPECT_LT(4 * new_size, legacy_size);
+}
+
+TEST_F(RtcEventLogEncoderNewFormatTest, BweUpdateLossBased) {
+  for (int i = 0; i < 10; ++i) {
+    history_.push_back(rtc::MakeUnique<RtcEventBweUpdateLossBased>(
+        300000 - 1000 * i, static_cast<uint8_t>(i % 4), 1000 + i));
+    clock_.AdvanceTimeMicros(1000);
+  }
+  const rtclog2::EventStream event_stream = EncodeHistory();
+  ASSERT_EQ(1, event_stream.loss_based_bwe_updates_size());
+  const rtclog2::LossBasedBweUpdates& proto =
+      event_stream.loss_based_bwe_updates(0);
+  ASSERT_EQ(9u, proto.number_of_deltas());
+  EXPECT_EQ(300000u, proto.bitrate_bps());
+  const auto bitrates = Decode(proto.bitrate_deltas_bps(), proto.bitrate_bps(),
+                               proto.number_of_deltas(), 32);
+  const auto fraction_losses =
+      Decode(proto.fraction_loss_deltas(), proto.fraction_loss(),
+             proto.number_of_deltas(), 8);
+  ASSERT_EQ(9u, bitrates.size());
+  ASSERT_EQ(9u, fraction_losses.size());
+  for (int i = 1; i < 10; ++i) {
+    EXPECT_EQ(rtc::Optional<uint64_t>(300000 - 1000 * i), bitrates[i - 1]);
+    EXPECT_EQ(rtc::Optional<uint64_t>(i % 4), fraction_losses[i - 1]);
+  }
+}
+
+TEST_F(RtcEventLogEncoderNewFormatTest, RtcpPackets) {
+  const std::vector<std::string> packets = {"\x80\xc8\x01\x02", "abc",
+                                            std::string(200, 'x')};
+  for (const std::string& packet : packets) {
+    history_.push_back(rtc::MakeUnique<RtcEventRtcpPacketIncoming>(
+        rtc::ArrayView<const uint8_t>(
+            reinterpret_cast<const uint8_t*>(packet.data()), packet.size())));
+  }
+  const rtclog2::EventStream event_stream = EncodeHistory();
+  ASSERT_EQ(1, event_stream.incoming_rtcp_packets_size());
+  const rtclog2::IncomingRtcpPackets& proto =
+      event_stream.incoming_rtcp_packets(0);
+  EXPECT_EQ(2u, proto.number_of_deltas());
+  EXPECT_EQ(packets[0], proto.raw_packet());
+  EXPECT_EQ(std::string("\x03") + packets[1] + "\xc8\x01" + packets[2],
+            proto.raw_packet_deltas());
+}
+
+}  // namespace webrtc
@@ -29,10 +29,10 @@ class RtcEventLog {
   enum : size_t { kUnlimitedOutput = 0 };
   enum : int64_t { kImmediateOutput = 0 };
 
-  // TODO(eladalon): Two stages are upcoming.
-  // 1. Extend this to actually support the new encoding.
-  // 2. Get rid of the legacy encoding, allowing us to get rid of this enum.
-  enum class EncodingType { Legacy };
+  // TODO(eladalon): Get rid of the legacy encoding, allowing us to get rid of
+  // this enum. NewFormat writes rtc_event_log2.proto, which stores batches of
+  // the frequent events as delta encoded columns.
+  enum class EncodingType { Legacy, NewFormat };
 
   virtual ~RtcEventLog() {}
 
@@ -59,6 +59,24 @@ class RtcEventLog {
 
   // Log an RTC event (the type of event is determined by the subclass).
   virtual void Log(std::unique_ptr<RtcEvent> event) = 0;
+
+  // Starts keeping the most recent events, encoded, in memory, whether or not
+  // an output is started, so that they can be dumped after something went
+  // wrong in the call. Events older than |max_age_ms|, and the oldest events
+  // beyond |max_size_bytes| of encoded events, are dropped. Config events are
+  // always kept.
+  virtual void StartRecording(size_t max_size_bytes, int64_t max_age_ms) {}
+
+  // Writes the recorded events, and all config events, to |output| as a
+  // complete log, without waiting for it to be written. Recording continues.
+  // Nothing is written if not recording. Returns false if |output| isn't
+  // active.
+  virtual bool DumpRecording(std::unique_ptr<RtcEventLogOutput> output) {
+    return false;
+  }
+
+  // Stops recording and frees the recorded events.
+  virtual void StopRecording() {}
 };
 
 // No-op implementation is used if flag is not set, or in tests.
@@ -11,21 +11,23 @@
 #include <string.h>
 
 #include <iostream>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
 
 #include "logging/rtc_event_log/rtc_event_log.h"
-#include "logging/rtc_event_log/rtc_event_log_parser_new.h"
+#include "logging/rtc_event_log/rtc_event_log_stream_parser.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
-#include "modules/rtp_rtcp/source/rtp_utility.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/flags.h"
 #include "test/rtp_file_writer.h"
 
 namespace {
 
-using MediaType = webrtc::ParsedRtcEventLogNew::MediaType;
+enum class MediaType { ANY, AUDIO, VIDEO, DATA };
+
+constexpr size_t kMaxPacketSize = webrtc::test::RtpPacket::kMaxPacketBufferSize;
 
 DEFINE_bool(
     audio,
@@ -102,12 +104,6 @@ int main(int argc, char* argv[]) {
     RTC_CHECK(ParseSsrc(FLAG_ssrc, &ssrc_filter))
         << "Flag verification has failed.";
 
-  webrtc::ParsedRtcEventLogNew parsed_stream;
-  if (!parsed_stream.ParseFile(input_file)) {
-    std::cerr << "Error while parsing input file: " << input_file << std::endl;
-    return -1;
-  }
-
   std::unique_ptr<webrtc::test::RtpFileWriter> rtp_writer(
       webrtc::test::RtpFileWriter::Create(
           webrtc::test::RtpFileWriter::FileFormat::kRtpDump, output_file));
@@ -118,88 +114,110 @@ int main(int argc, char* argv[]) {
     return -1;
   }
 
-  std::cout << "Found " << parsed_stream.GetNumberOfEvents()
-            << " events in the input file." << std::endl;
+  // The events are converted as they are parsed, so that this runs in
+  // constant memory however long the log is. The media type of the incoming
+  // streams is taken from their configs, which are logged before their
+  // packets.
+  webrtc::RtcEventLogStreamParser parser;
+  if (strlen(FLAG_ssrc) > 0)
+    parser.AddSsrcFilter(ssrc_filter);
+  std::map<uint32_t, MediaType> incoming_media_types;
+  auto get_media_type = [&incoming_media_types](uint32_t ssrc) {
+    const auto it = incoming_media_types.find(ssrc);
+    return it == incoming_media_types.end() ? MediaType::ANY : it->second;
+  };
+  auto skip_media_type = [](MediaType media_type) {
+    return (!FLAG_audio && media_type == MediaType::AUDIO) ||
+           (!FLAG_video && media_type == MediaType::VIDEO) ||
+           (!FLAG_data && media_type == MediaType::DATA);
+  };
+
+  size_t event_counter = 0;
   int rtp_counter = 0, rtcp_counter = 0;
   bool header_only = false;
-  for (size_t i = 0; i < parsed_stream.GetNumberOfEvents(); i++) {
-    // The parsed_stream will assert if the protobuf event is missing
-    // some required fields and we attempt to access them. We could consider
-    // a softer failure option, but it does not seem useful to generate
-    // RTP dumps based on broken event logs.
-    if (FLAG_rtp && parsed_stream.GetEventType(i) ==
-                        webrtc::ParsedRtcEventLogNew::RTP_EVENT) {
-      webrtc::test::RtpPacket packet;
-      webrtc::PacketDirection direction;
-      parsed_stream.GetRtpHeader(i, &direction, packet.data, &packet.length,
-                                 &packet.original_length, nullptr);
-      if (packet.original_length > packet.length)
-        header_only = true;
-      packet.time_ms = parsed_stream.GetTimestamp(i) / 1000;
-
-      webrtc::RtpUtility::RtpHeaderParser rtp_parser(packet.data,
-                                                     packet.length);
-
-      // TODO(terelius): Maybe add a flag to dump outgoing traffic instead?
-      if (direction == webrtc::kOutgoingPacket)
-        continue;
-
-      webrtc::RTPHeader parsed_header;
-      rtp_parser.Parse(&parsed_header);
-      MediaType media_type =
-          parsed_stream.GetMediaType(parsed_header.ssrc, direction);
-      if (!FLAG_audio && media_type == MediaType::AUDIO)
-        continue;
-      if (!FLAG_video && media_type == MediaType::VIDEO)
-        continue;
-      if (!FLAG_data && media_type == MediaType::DATA)
-        continue;
-      if (strlen(FLAG_ssrc) > 0) {
-        const uint32_t packet_ssrc =
-            webrtc::ByteReader<uint32_t>::ReadBigEndian(
-                reinterpret_cast<const uint8_t*>(packet.data + 8));
-        if (packet_ssrc != ssrc_filter)
-          continue;
+  auto handle_event = [&](const webrtc::rtclog::Event& event, size_t) {
+    ++event_counter;
+    switch (event.type()) {
+      case webrtc::rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT: {
+        const webrtc::rtclog::VideoReceiveConfig& config =
+            event.video_receiver_config();
+        incoming_media_types[config.remote_ssrc()] = MediaType::VIDEO;
+        for (const webrtc::rtclog::RtxMap& rtx : config.rtx_map())
+          incoming_media_types[rtx.config().rtx_ssrc()] = MediaType::VIDEO;
+        break;
       }
+      case webrtc::rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT:
+        incoming_media_types[event.audio_receiver_config().remote_ssrc()] =
+            MediaType::AUDIO;
+        break;
+      case webrtc::rtclog::Event::RTP_EVENT: {
+        const webrtc::rtclog::RtpPacket& rtp_packet = event.rtp_packet();
+        // TODO(terelius): Maybe add a flag to dump outgoing traffic instead?
+        if (!FLAG_rtp || !rtp_packet.incoming())
+          break;
+        const std::string& header = rtp_packet.header();
+        // A malformed event. It does not seem useful to generate RTP dumps
+        // based on broken event logs.
+        RTC_CHECK_GE(header.size(), 12);
+        RTC_CHECK_LE(header.size(), kMaxPacketSize);
+        webrtc::test::RtpPacket packet;
+        memcpy(packet.data, header.data(), header.size());
+        packet.length = header.size();
+        packet.original_length = rtp_packet.packet_length();
+        if (packet.original_length > packet.length)
+          header_only = true;
+        packet.time_ms = event.timestamp_us() / 1000;
 
-      rtp_writer->WritePacket(&packet);
-      rtp_counter++;
-    }
-    if (FLAG_rtcp && parsed_stream.GetEventType(i) ==
-                         webrtc::ParsedRtcEventLogNew::RTCP_EVENT) {
-      webrtc::test::RtpPacket packet;
-      webrtc::PacketDirection direction;
-      parsed_stream.GetRtcpPacket(i, &direction, packet.data, &packet.length);
-      // For RTCP packets the original_length should be set to 0 in the
-      // RTPdump format.
-      packet.original_length = 0;
-      packet.time_ms = parsed_stream.GetTimestamp(i) / 1000;
-
-      // TODO(terelius): Maybe add a flag to dump outgoing traffic instead?
-      if (direction == webrtc::kOutgoingPacket)
-        continue;
-
-      // Note that |packet_ssrc| is the sender SSRC. An RTCP message may contain
-      // report blocks for many streams, thus several SSRCs and they doen't
-      // necessarily have to be of the same media type.
-      const uint32_t packet_ssrc = webrtc::ByteReader<uint32_t>::ReadBigEndian(
-          reinterpret_cast<const uint8_t*>(packet.data + 4));
-      MediaType media_type = parsed_stream.GetMediaType(packet_ssrc, direction);
-      if (!FLAG_audio && media_type == MediaType::AUDIO)
-        continue;
-      if (!FLAG_video && media_type == MediaType::VIDEO)
-        continue;
-      if (!FLAG_data && media_type == MediaType::DATA)
-        continue;
-      if (strlen(FLAG_ssrc) > 0) {
-        if (packet_ssrc != ssrc_filter)
-          continue;
+        const uint32_t packet_ssrc =
+            webrtc::ByteReader<uint32_t>::ReadBigEndian(packet.data + 8);
+        if (skip_media_type(get_media_type(packet_ssrc)))
+          break;
+
+        rtp_writer->WritePacket(&packet);
+        rtp_counter++;
+        break;
       }
+      case webrtc::rtclog::Event::RTCP_EVENT: {
+        const webrtc::rtclog::RtcpPacket& rtcp_packet = event.rtcp_packet();
+        // TODO(terelius): Maybe add a flag to dump outgoing traffic instead?
+        if (!FLAG_rtcp || !rtcp_packet.incoming())
+          break;
+        const std::string& data = rtcp_packet.packet_data();
+        RTC_CHECK_GE(data.size(), 8);
+        RTC_CHECK_LE(data.size(), kMaxPacketSize);
+        webrtc::test::RtpPacket packet;
+        memcpy(packet.data, data.data(), data.size());
+        packet.length = data.size();
+        // For RTCP packets the original_length should be set to 0 in the
+        // RTPdump format.
+        packet.original_length = 0;
+        packet.time_ms = event.timestamp_us() / 1000;
+
+        // Note that |packet_ssrc| is the sender SSRC. An RTCP message may
+        // contain report blocks for many streams, thus several SSRCs and they
+        // doen't necessarily have to be of the same media type.
+        const uint32_t packet_ssrc =
+            webrtc::ByteReader<uint32_t>::ReadBigEndian(packet.data + 4);
+        if (skip_media_type(get_media_type(packet_ssrc)))
+          break;
 
-      rtp_writer->WritePacket(&packet);
-      rtcp_counter++;
+        rtp_writer->WritePacket(&packet);
+        rtcp_counter++;
+        break;
+      }
+      default:
+        break;
     }
+    return true;
+  };
+
+  if (!parser.ParseFile(input_file, handle_event)) {
+    std::cerr << "Error while parsing input file: " << input_file << std::endl;
+    return -1;
   }
+
+  std::cout << "Found " << event_counter << " events in the input file."
+            << std::endl;
   std::cout << "Wrote " << rtp_counter << (header_only ? " header-only" : "")
             << " RTP packets and " << rtcp_counter << " RTCP packets to the "
             << "output file." << std::endl;
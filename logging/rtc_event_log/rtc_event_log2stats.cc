@@ -11,15 +11,12 @@
 #include <inttypes.h>
 #include <stdio.h>
 
-#include <fstream>
 #include <iostream>
 #include <map>
 #include <string>
-#include <tuple>
-#include <utility>
-#include <vector>
 
 #include "logging/rtc_event_log/rtc_event_log.h"
+#include "logging/rtc_event_log/rtc_event_log_stream_parser.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/flags.h"
 #include "rtc_base/ignore_wundef.h"
@@ -43,94 +40,6 @@ struct Stats {
   size_t total_size = 0;
 };
 
-// We are duplicating some parts of the parser here because we want to get
-// access to raw protobuf events.
-std::pair<uint64_t, bool> ParseVarInt(std::istream& stream) {
-  uint64_t varint = 0;
-  for (size_t bytes_read = 0; bytes_read < 10; ++bytes_read) {
-    // The most significant bit of each byte is 0 if it is the last byte in
-    // the varint and 1 otherwise. Thus, we take the 7 least significant bits
-    // of each byte and shift them 7 bits for each byte read previously to get
-    // the (unsigned) integer.
-    int byte = stream.get();
-    if (stream.eof()) {
-      return std::make_pair(varint, false);
-    }
-    RTC_DCHECK_GE(byte, 0);
-    RTC_DCHECK_LE(byte, 255);
-    varint |= static_cast<uint64_t>(byte & 0x7F) << (7 * bytes_read);
-    if ((byte & 0x80) == 0) {
-      return std::make_pair(varint, true);
-    }
-  }
-  return std::make_pair(varint, false);
-}
-
-bool ParseEvents(const std::string& filename,
-                 std::vector<webrtc::rtclog::Event>* events) {
-  std::ifstream stream(filename, std::ios_base::in | std::ios_base::binary);
-  if (!stream.good() || !stream.is_open()) {
-    RTC_LOG(LS_WARNING) << "Could not open file for reading.";
-    return false;
-  }
-
-  const size_t kMaxEventSize = (1u << 16) - 1;
-  std::vector<char> tmp_buffer(kMaxEventSize);
-  uint64_t tag;
-  uint64_t message_length;
-  bool success;
-
-  RTC_DCHECK(stream.good());
-
-  while (1) {
-    // Check whether we have reached end of file.
-    stream.peek();
-    if (stream.eof()) {
-      return true;
-    }
-
-    // Read the next message tag. The tag number is defined as
-    // (fieldnumber << 3) | wire_type. In our case, the field number is
-    // supposed to be 1 and the wire type for an length-delimited field is 2.
-    const uint64_t kExpectedTag = (1 << 3) | 2;
-    std::tie(tag, success) = ParseVarInt(stream);
-    if (!success) {
-      RTC_LOG(LS_WARNING)
-          << "Missing field tag from beginning of protobuf event.";
-      return false;
-    } else if (tag != kExpectedTag) {
-      RTC_LOG(LS_WARNING)
-          << "Unexpected field tag at beginning of protobuf event.";
-      return false;
-    }
-
-    // Read the length field.
-    std::tie(message_length, success) = ParseVarInt(stream);
-    if (!success) {
-      RTC_LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
-      return false;
-    } else if (message_length > kMaxEventSize) {
-      RTC_LOG(LS_WARNING) << "Protobuf message length is too large.";
-      return false;
-    }
-
-    // Read the next protobuf event to a temporary char buffer.
-    stream.read(tmp_buffer.data(), message_length);
-    if (stream.gcount() != static_cast<int>(message_length)) {
-      RTC_LOG(LS_WARNING) << "Failed to read protobuf message from file.";
-      return false;
-    }
-
-    // Parse the protobuf event from the buffer.
-    webrtc::rtclog::Event event;
-    if (!event.ParseFromArray(tmp_buffer.data(), message_length)) {
-      RTC_LOG(LS_WARNING) << "Failed to parse protobuf message.";
-      return false;
-    }
-    events->push_back(event);
-  }
-}
-
 // TODO(terelius): Should this be placed in some utility file instead?
 std::string EventTypeToString(webrtc::rtclog::Event::EventType event_type) {
   switch (event_type) {
@@ -200,43 +109,42 @@ int main(int argc, char* argv[]) {
   }
   std::string file_name = argv[1];
 
-  std::vector<webrtc::rtclog::Event> events;
-  if (!ParseEvents(file_name, &events)) {
-    RTC_LOG(LS_ERROR) << "Failed to parse event log.";
-    return -1;
-  }
-
   // Get file size
   FILE* file = fopen(file_name.c_str(), "rb");
+  if (!file) {
+    RTC_LOG(LS_ERROR) << "Failed to open event log.";
+    return -1;
+  }
   fseek(file, 0L, SEEK_END);
   int64_t file_size = ftell(file);
   fclose(file);
 
-  // We are deliberately using low level protobuf functions to get the stats
-  // since the convenience functions in the parser would CHECK that the events
-  // are well formed.
+  // We are deliberately using the raw protobuf events to get the stats since
+  // the convenience functions in the parser would CHECK that the events are
+  // well formed. The events are counted as they are parsed, and not kept, so
+  // that this runs in constant memory however long the log is.
   std::map<webrtc::rtclog::Event::EventType, Stats> stats;
   int malformed_events = 0;
   size_t malformed_event_size = 0;
   size_t accumulated_event_size = 0;
-  for (const webrtc::rtclog::Event& event : events) {
-    size_t serialized_size = event.ByteSizeLong();
-    // When the event is written on the disk, it is part of an EventStream
-    // object. The event stream will prepend a 1 byte field number/wire type,
-    // and a varint encoding (base 128) of the event length.
-    serialized_size =
-        1 + (1 + (serialized_size > 127) + (serialized_size > 16383)) +
-        serialized_size;
-
-    if (event.has_type() && event.has_timestamp_us()) {
-      stats[event.type()].count++;
-      stats[event.type()].total_size += serialized_size;
-    } else {
-      // The event is missing the type or the timestamp field.
-      malformed_events++;
-      malformed_event_size += serialized_size;
-    }
-    accumulated_event_size += serialized_size;
+  webrtc::RtcEventLogStreamParser parser;
+  const bool success = parser.ParseFile(
+      file_name,
+      [&](const webrtc::rtclog::Event& event, size_t size_in_log) {
+        if (event.has_type() && event.has_timestamp_us()) {
+          stats[event.type()].count++;
+          stats[event.type()].total_size += size_in_log;
+        } else {
+          // The event is missing the type or the timestamp field.
+          malformed_events++;
+          malformed_event_size += size_in_log;
+        }
+        accumulated_event_size += size_in_log;
+        return true;
+      });
+  if (!success) {
+    RTC_LOG(LS_ERROR) << "Failed to parse event log.";
+    return -1;
   }
 
   printf("Type                  \tCount\tTotal size\tAverage size\tPercent\n");
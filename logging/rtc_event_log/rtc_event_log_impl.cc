@@ -14,13 +14,16 @@
 #include <functional>
 #include <limits>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_new_format.h"
 #include "logging/rtc_event_log/output/rtc_event_log_output_file.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
@@ -39,6 +42,9 @@ constexpr size_t kMaxEventsInHistory = 10000;
 // The config-history is supposed to be unbounded, but needs to have some bound
 // to prevent an attack via unreasonable memory use.
 constexpr size_t kMaxEventsInConfigHistory = 1000;
+// While recording without an output, the events are encoded in batches of
+// this many, to amortize the encoding over many events.
+constexpr size_t kRecordingBatchSize = 500;
 
 // TODO(eladalon): This class exists because C++11 doesn't allow transferring a
 // unique_ptr to a lambda (a copy constructor is required). We should get
@@ -65,6 +71,8 @@ std::unique_ptr<RtcEventLogEncoder> CreateEncoder(
   switch (type) {
     case RtcEventLog::EncodingType::Legacy:
       return rtc::MakeUnique<RtcEventLogEncoderLegacy>();
+    case RtcEventLog::EncodingType::NewFormat:
+      return rtc::MakeUnique<RtcEventLogEncoderNewFormat>();
     default:
       RTC_LOG(LS_ERROR) << "Unknown RtcEventLog encoder type (" << int(type)
                         << ")";
@@ -88,7 +96,19 @@ class RtcEventLogImpl final : public RtcEventLog {
 
   void Log(std::unique_ptr<RtcEvent> event) override;
 
+  void StartRecording(size_t max_size_bytes, int64_t max_age_ms) override;
+  bool DumpRecording(std::unique_ptr<RtcEventLogOutput> output) override;
+  void StopRecording() override;
+
  private:
+  // A batch of encoded events.
+  struct RecordedBatch {
+    int64_t first_event_time_us;
+    int64_t last_event_time_us;
+    std::string encoded_events;
+  };
+
+  void LogPendingEventsToMemory() RTC_RUN_ON(task_queue_);
   void LogToMemory(std::unique_ptr<RtcEvent> event) RTC_RUN_ON(task_queue_);
   void LogEventsFromMemoryToOutput() RTC_RUN_ON(task_queue_);
 
@@ -103,6 +123,12 @@ class RtcEventLogImpl final : public RtcEventLog {
 
   void ScheduleOutput() RTC_RUN_ON(task_queue_);
 
+  // Moves the events in |history_| to |recording_|.
+  void RecordHistory() RTC_RUN_ON(task_queue_);
+  void AddToRecording(int64_t first_event_time_us,
+                      int64_t last_event_time_us,
+                      std::string encoded_events) RTC_RUN_ON(task_queue_);
+
   // Make sure that the event log is "managed" - created/destroyed, as well
   // as started/stopped - from the same thread/task-queue.
   rtc::SequencedTaskChecker owner_sequence_checker_;
@@ -126,6 +152,23 @@ class RtcEventLogImpl final : public RtcEventLog {
   int64_t last_output_ms_ RTC_GUARDED_BY(*task_queue_);
   bool output_scheduled_ RTC_GUARDED_BY(*task_queue_);
 
+  bool recording_enabled_ RTC_GUARDED_BY(*task_queue_);
+  size_t max_recording_size_bytes_ RTC_GUARDED_BY(*task_queue_);
+  int64_t max_recording_age_ms_ RTC_GUARDED_BY(*task_queue_);
+  size_t recording_size_bytes_ RTC_GUARDED_BY(*task_queue_);
+  std::deque<RecordedBatch> recording_ RTC_GUARDED_BY(*task_queue_);
+
+  // The events logged since the last task that moved them to the history.
+  // Only the first of them posts such a task, so that logging an event
+  // doesn't allocate a task and a closure, and the new events are swapped
+  // with |events_to_log_| so that neither vector is reallocated once it has
+  // grown to the usual number of events per task.
+  rtc::CriticalSection pending_events_crit_;
+  std::vector<std::unique_ptr<RtcEvent>> pending_events_
+      RTC_GUARDED_BY(pending_events_crit_);
+  std::vector<std::unique_ptr<RtcEvent>> events_to_log_
+      RTC_GUARDED_BY(*task_queue_);
+
   // Since we are posting tasks bound to |this|,  it is critical that the event
   // log and it's members outlive the |task_queue_|. Keep the "task_queue_|
   // last to ensure it destructs first, or else tasks living on the queue might
@@ -145,6 +188,10 @@ RtcEventLogImpl::RtcEventLogImpl(
       output_period_ms_(kImmediateOutput),
       last_output_ms_(rtc::TimeMillis()),
       output_scheduled_(false),
+      recording_enabled_(false),
+      max_recording_size_bytes_(0),
+      max_recording_age_ms_(0),
+      recording_size_bytes_(0),
       task_queue_(std::move(task_queue)) {
   RTC_DCHECK(task_queue_);
 }
@@ -173,13 +220,28 @@ bool RtcEventLogImpl::StartLogging(std::unique_ptr<RtcEventLogOutput> output,
   const int64_t timestamp_us = rtc::TimeMicros();
 
   // Binding to |this| is safe because |this| outlives the |task_queue_|.
-  auto start = [this, timestamp_us](std::unique_ptr<RtcEventLogOutput> output) {
+  auto start = [this, timestamp_us, output_period_ms](
+                   std::unique_ptr<RtcEventLogOutput> output) {
     RTC_DCHECK_RUN_ON(task_queue_.get());
     RTC_DCHECK(output->IsActive());
     event_output_ = std::move(output);
+    output_period_ms_ = output_period_ms;
     num_config_events_written_ = 0;
     WriteToOutput(event_encoder_->EncodeLogStart(timestamp_us));
-    LogEventsFromMemoryToOutput();
+    // While recording, the events logged before the output started have been
+    // moved from |history_| to |recording_|.
+    if (recording_enabled_ && !recording_.empty()) {
+      WriteToOutput(event_encoder_->EncodeBatch(config_history_.begin(),
+                                                config_history_.end()));
+      num_config_events_written_ = config_history_.size();
+      for (const RecordedBatch& batch : recording_) {
+        if (!event_output_)
+          break;
+        WriteToOutput(batch.encoded_events);
+      }
+    }
+    if (event_output_)
+      LogEventsFromMemoryToOutput();
   };
 
   task_queue_->PostTask(rtc::MakeUnique<ResourceOwningTask<RtcEventLogOutput>>(
@@ -214,16 +276,137 @@ void RtcEventLogImpl::StopLogging() {
 void RtcEventLogImpl::Log(std::unique_ptr<RtcEvent> event) {
   RTC_CHECK(event);
 
+  {
+    rtc::CritScope lock(&pending_events_crit_);
+    const bool task_posted = !pending_events_.empty();
+    pending_events_.push_back(std::move(event));
+    if (task_posted)
+      return;
+  }
+
   // Binding to |this| is safe because |this| outlives the |task_queue_|.
-  auto event_handler = [this](std::unique_ptr<RtcEvent> unencoded_event) {
+  task_queue_->PostTask([this]() {
     RTC_DCHECK_RUN_ON(task_queue_.get());
-    LogToMemory(std::move(unencoded_event));
-    if (event_output_)
-      ScheduleOutput();
+    LogPendingEventsToMemory();
+  });
+}
+
+void RtcEventLogImpl::StartRecording(size_t max_size_bytes,
+                                     int64_t max_age_ms) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&owner_sequence_checker_);
+  RTC_DCHECK_GT(max_size_bytes, 0);
+  RTC_DCHECK_GT(max_age_ms, 0);
+
+  // Binding to |this| is safe because |this| outlives the |task_queue_|.
+  task_queue_->PostTask([this, max_size_bytes, max_age_ms]() {
+    RTC_DCHECK_RUN_ON(task_queue_.get());
+    recording_enabled_ = true;
+    max_recording_size_bytes_ = max_size_bytes;
+    max_recording_age_ms_ = max_age_ms;
+  });
+}
+
+bool RtcEventLogImpl::DumpRecording(std::unique_ptr<RtcEventLogOutput> output) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&owner_sequence_checker_);
+  if (!output->IsActive())
+    return false;
+
+  // The dump is written from the |task_queue_|, so it doesn't wait for the
+  // events not yet logged; the caller may not be able to block.
+  // Binding to |this| is safe because |this| outlives the |task_queue_|.
+  auto dump = [this](std::unique_ptr<RtcEventLogOutput> output) {
+    RTC_DCHECK_RUN_ON(task_queue_.get());
+    if (!recording_enabled_)
+      return;
+    const int64_t start_time_us =
+        recording_.empty() ? (history_.empty() ? rtc::TimeMicros()
+                                               : history_.front()->timestamp_us_)
+                           : recording_.front().first_event_time_us;
+    bool ok = output->Write(event_encoder_->EncodeLogStart(start_time_us)) &&
+              output->Write(event_encoder_->EncodeBatch(
+                  config_history_.begin(), config_history_.end()));
+    for (const RecordedBatch& batch : recording_) {
+      if (!ok)
+        break;
+      ok = output->Write(batch.encoded_events);
+    }
+    // The events since the last batch are encoded, but kept for the next one.
+    if (ok && !history_.empty()) {
+      ok = output->Write(
+          event_encoder_->EncodeBatch(history_.begin(), history_.end()));
+    }
+    if (ok)
+      output->Write(event_encoder_->EncodeLogEnd(rtc::TimeMicros()));
+    if (!ok)
+      RTC_LOG(LS_ERROR) << "Failed to dump the RTC event log recording.";
   };
 
-  task_queue_->PostTask(rtc::MakeUnique<ResourceOwningTask<RtcEvent>>(
-      std::move(event), event_handler));
+  task_queue_->PostTask(rtc::MakeUnique<ResourceOwningTask<RtcEventLogOutput>>(
+      std::move(output), dump));
+  return true;
+}
+
+void RtcEventLogImpl::StopRecording() {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&owner_sequence_checker_);
+
+  // Binding to |this| is safe because |this| outlives the |task_queue_|.
+  task_queue_->PostTask([this]() {
+    RTC_DCHECK_RUN_ON(task_queue_.get());
+    recording_enabled_ = false;
+    recording_.clear();
+    recording_size_bytes_ = 0;
+  });
+}
+
+void RtcEventLogImpl::LogPendingEventsToMemory() {
+  RTC_DCHECK(events_to_log_.empty());
+  {
+    rtc::CritScope lock(&pending_events_crit_);
+    events_to_log_.swap(pending_events_);
+  }
+  for (std::unique_ptr<RtcEvent>& event : events_to_log_) {
+    LogToMemory(std::move(event));
+    if (event_output_ && history_.size() >= kMaxEventsInHistory) {
+      // We have to emergency drain the buffer before the history overflows.
+      LogEventsFromMemoryToOutput();
+    } else if (!event_output_ && recording_enabled_ &&
+               history_.size() >= kRecordingBatchSize) {
+      RecordHistory();
+    }
+  }
+  events_to_log_.clear();
+  if (event_output_)
+    ScheduleOutput();
+}
+
+void RtcEventLogImpl::RecordHistory() {
+  RTC_DCHECK(!event_output_);
+  if (history_.empty())
+    return;
+  AddToRecording(history_.front()->timestamp_us_,
+                 history_.back()->timestamp_us_,
+                 event_encoder_->EncodeBatch(history_.begin(), history_.end()));
+  history_.clear();
+}
+
+void RtcEventLogImpl::AddToRecording(int64_t first_event_time_us,
+                                     int64_t last_event_time_us,
+                                     std::string encoded_events) {
+  if (encoded_events.empty())
+    return;
+  recording_size_bytes_ += encoded_events.size();
+  recording_.push_back(
+      {first_event_time_us, last_event_time_us, std::move(encoded_events)});
+  // The age of a batch is that of its most recent event.
+  const int64_t oldest_time_us =
+      last_event_time_us - max_recording_age_ms_ * rtc::kNumMicrosecsPerMillisec;
+  while (recording_size_bytes_ > max_recording_size_bytes_ ||
+         recording_.front().last_event_time_us < oldest_time_us) {
+    recording_size_bytes_ -= recording_.front().encoded_events.size();
+    recording_.pop_front();
+    if (recording_.empty())
+      break;
+  }
 }
 
 void RtcEventLogImpl::ScheduleOutput() {
@@ -298,11 +481,19 @@ void RtcEventLogImpl::LogEventsFromMemoryToOutput() {
   // log is started immediately after the first one becomes full, then one
   // cannot rely on the second log to contain everything that isn't in the first
   // log; one batch of events might be missing.
+  const int64_t first_event_time_us =
+      history_.empty() ? 0 : history_.front()->timestamp_us_;
+  const int64_t last_event_time_us =
+      history_.empty() ? 0 : history_.back()->timestamp_us_;
   std::string encoded_history =
       event_encoder_->EncodeBatch(history_.begin(), history_.end());
   history_.clear();
 
   WriteConfigsAndHistoryToOutput(encoded_configs, encoded_history);
+  // The encoding written to the output is recorded as well.
+  if (recording_enabled_)
+    AddToRecording(first_event_time_us, last_event_time_us,
+                   std::move(encoded_history));
 }
 
 void RtcEventLogImpl::WriteConfigsAndHistoryToOutput(
@@ -0,0 +1,323 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/rtc_event_log_stream_parser.h"
+
+#if defined(WEBRTC_POSIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <fstream>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+
+namespace {
+
+// The events are stored as the field of number 1 and the length-delimited
+// wire type of an rtclog::EventStream, i.e. as the tag
+// (field number << 3) | wire type, the length and the event.
+constexpr uint64_t kExpectedTag = (1 << 3) | 2;
+constexpr size_t kMaxEventSize = (1u << 16) - 1;
+constexpr size_t kMaxVarintBytes = 10;
+
+// The fields of rtclog::Event that the event type is peeked from.
+constexpr uint64_t kEventTypeFieldNumber = 2;
+constexpr uint64_t kWireTypeVarint = 0;
+constexpr uint64_t kWireTypeFixed64 = 1;
+constexpr uint64_t kWireTypeLengthDelimited = 2;
+constexpr uint64_t kWireTypeFixed32 = 5;
+
+bool ReadVarint(const uint8_t* data,
+                size_t size,
+                size_t* offset,
+                uint64_t* value) {
+  *value = 0;
+  for (size_t i = 0; i < kMaxVarintBytes && *offset < size; ++i) {
+    const uint64_t byte = data[(*offset)++];
+    *value |= (byte & 0x7f) << (7 * i);
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+bool ReadVarint(std::istream& stream, size_t* bytes_read, uint64_t* value) {
+  *value = 0;
+  for (size_t i = 0; i < kMaxVarintBytes; ++i) {
+    const int byte = stream.get();
+    if (stream.eof())
+      return false;
+    ++*bytes_read;
+    *value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if (!(byte & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// Reads the type of the serialized rtclog::Event in |data| without parsing
+// the rest of it, so that the events that are filtered out by type aren't
+// parsed at all. Returns false if the type can't be found this way.
+bool PeekEventType(const uint8_t* data,
+                   size_t size,
+                   rtclog::Event::EventType* type) {
+  size_t offset = 0;
+  while (offset < size) {
+    uint64_t tag;
+    if (!ReadVarint(data, size, &offset, &tag))
+      return false;
+    uint64_t value;
+    switch (tag & 7) {
+      case kWireTypeVarint:
+        if (!ReadVarint(data, size, &offset, &value))
+          return false;
+        if ((tag >> 3) == kEventTypeFieldNumber) {
+          if (!rtclog::Event::EventType_IsValid(static_cast<int>(value)))
+            return false;
+          *type = static_cast<rtclog::Event::EventType>(value);
+          return true;
+        }
+        break;
+      case kWireTypeFixed64:
+        offset += 8;
+        break;
+      case kWireTypeLengthDelimited:
+        if (!ReadVarint(data, size, &offset, &value) || value > size)
+          return false;
+        offset += value;
+        break;
+      case kWireTypeFixed32:
+        offset += 4;
+        break;
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+RtcEventLogStreamParser::RtcEventLogStreamParser() = default;
+
+RtcEventLogStreamParser::~RtcEventLogStreamParser() = default;
+
+void RtcEventLogStreamParser::AddEventTypeFilter(
+    rtclog::Event::EventType type) {
+  event_types_.insert(type);
+}
+
+void RtcEventLogStreamParser::AddSsrcFilter(uint32_t ssrc) {
+  ssrcs_.insert(ssrc);
+}
+
+bool RtcEventLogStreamParser::ParseFile(const std::string& file_name,
+                                        const EventCallback& callback) {
+#if defined(WEBRTC_POSIX)
+  const int fd = open(file_name.c_str(), O_RDONLY);
+  if (fd < 0) {
+    RTC_LOG(LS_WARNING) << "Could not open file for reading.";
+    return false;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    RTC_LOG(LS_WARNING) << "Could not get the size of the file.";
+    close(fd);
+    return false;
+  }
+  const size_t file_size = static_cast<size_t>(file_stat.st_size);
+  if (file_size == 0) {
+    close(fd);
+    return true;
+  }
+  void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (mapping != MAP_FAILED) {
+    // The file is read once, from the beginning to the end.
+    madvise(mapping, file_size, MADV_SEQUENTIAL);
+    const bool success = ParseBuffer(
+        rtc::ArrayView<const uint8_t>(static_cast<const uint8_t*>(mapping),
+                                      file_size),
+        callback);
+    munmap(mapping, file_size);
+    return success;
+  }
+  RTC_LOG(LS_INFO) << "Could not memory map the file, reading it instead.";
+#endif  // defined(WEBRTC_POSIX)
+
+  std::ifstream file(file_name, std::ios_base::in | std::ios_base::binary);
+  if (!file.good() || !file.is_open()) {
+    RTC_LOG(LS_WARNING) << "Could not open file for reading.";
+    return false;
+  }
+  return ParseStream(file, callback);
+}
+
+bool RtcEventLogStreamParser::ParseBuffer(rtc::ArrayView<const uint8_t> buffer,
+                                          const EventCallback& callback) {
+  size_t offset = 0;
+  while (offset < buffer.size()) {
+    const size_t event_begin = offset;
+    uint64_t tag;
+    if (!ReadVarint(buffer.data(), buffer.size(), &offset, &tag)) {
+      RTC_LOG(LS_WARNING)
+          << "Missing field tag from beginning of protobuf event.";
+      return false;
+    } else if (tag != kExpectedTag) {
+      RTC_LOG(LS_WARNING)
+          << "Unexpected field tag at beginning of protobuf event.";
+      return false;
+    }
+
+    uint64_t message_length;
+    if (!ReadVarint(buffer.data(), buffer.size(), &offset, &message_length)) {
+      RTC_LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
+      return false;
+    } else if (message_length > kMaxEventSize) {
+      RTC_LOG(LS_WARNING) << "Protobuf message length is too large.";
+      return false;
+    } else if (message_length > buffer.size() - offset) {
+      RTC_LOG(LS_WARNING) << "Failed to read protobuf message from file.";
+      return false;
+    }
+
+    const uint8_t* message = buffer.data() + offset;
+    offset += message_length;
+    bool stop = false;
+    if (!HandleEvent(message, message_length, offset - event_begin, callback,
+                     &stop)) {
+      return false;
+    }
+    if (stop)
+      return true;
+  }
+  return true;
+}
+
+bool RtcEventLogStreamParser::ParseStream(std::istream& stream,
+                                          const EventCallback& callback) {
+  std::vector<uint8_t> buffer(kMaxEventSize);
+  while (true) {
+    // Check whether we have reached end of file.
+    stream.peek();
+    if (stream.eof())
+      return true;
+
+    size_t header_size = 0;
+    uint64_t tag;
+    if (!ReadVarint(stream, &header_size, &tag)) {
+      RTC_LOG(LS_WARNING)
+          << "Missing field tag from beginning of protobuf event.";
+      return false;
+    } else if (tag != kExpectedTag) {
+      RTC_LOG(LS_WARNING)
+          << "Unexpected field tag at beginning of protobuf event.";
+      return false;
+    }
+
+    uint64_t message_length;
+    if (!ReadVarint(stream, &header_size, &message_length)) {
+      RTC_LOG(LS_WARNING) << "Missing message length after protobuf field tag.";
+      return false;
+    } else if (message_length > kMaxEventSize) {
+      RTC_LOG(LS_WARNING) << "Protobuf message length is too large.";
+      return false;
+    }
+
+    stream.read(reinterpret_cast<char*>(buffer.data()), message_length);
+    if (stream.gcount() != static_cast<std::streamsize>(message_length)) {
+      RTC_LOG(LS_WARNING) << "Failed to read protobuf message from file.";
+      return false;
+    }
+
+    bool stop = false;
+    if (!HandleEvent(buffer.data(), message_length,
+                     header_size + message_length, callback, &stop)) {
+      return false;
+    }
+    if (stop)
+      return true;
+  }
+}
+
+bool RtcEventLogStreamParser::HandleEvent(const uint8_t* data,
+                                          size_t length,
+                                          size_t size_in_log,
+                                          const EventCallback& callback,
+                                          bool* stop) {
+  rtclog::Event::EventType type;
+  if (!event_types_.empty() && PeekEventType(data, length, &type) &&
+      event_types_.count(type) == 0) {
+    return true;
+  }
+
+  if (!event_.ParseFromArray(data, static_cast<int>(length))) {
+    RTC_LOG(LS_WARNING) << "Failed to parse protobuf message.";
+    return false;
+  }
+  if (PassesFilters(event_))
+    *stop = !callback(event_, size_in_log);
+  return true;
+}
+
+bool RtcEventLogStreamParser::PassesFilters(const rtclog::Event& event) const {
+  if (!event_types_.empty() && event_types_.count(event.type()) == 0)
+    return false;
+  if (ssrcs_.empty())
+    return true;
+
+  auto passes = [this](uint32_t ssrc) { return ssrcs_.count(ssrc) > 0; };
+  switch (event.type()) {
+    case rtclog::Event::RTP_EVENT: {
+      const std::string& header = event.rtp_packet().header();
+      return header.size() >= 12 &&
+             passes(ByteReader<uint32_t>::ReadBigEndian(
+                 reinterpret_cast<const uint8_t*>(header.data() + 8)));
+    }
+    case rtclog::Event::RTCP_EVENT: {
+      const std::string& packet = event.rtcp_packet().packet_data();
+      return packet.size() >= 8 &&
+             passes(ByteReader<uint32_t>::ReadBigEndian(
+                 reinterpret_cast<const uint8_t*>(packet.data() + 4)));
+    }
+    case rtclog::Event::AUDIO_PLAYOUT_EVENT:
+      return passes(event.audio_playout_event().local_ssrc());
+    case rtclog::Event::VIDEO_RECEIVER_CONFIG_EVENT:
+      return passes(event.video_receiver_config().remote_ssrc()) ||
+             passes(event.video_receiver_config().local_ssrc());
+    case rtclog::Event::VIDEO_SENDER_CONFIG_EVENT:
+      for (uint32_t ssrc : event.video_sender_config().ssrcs()) {
+        if (passes(ssrc))
+          return true;
+      }
+      for (uint32_t ssrc : event.video_sender_config().rtx_ssrcs()) {
+        if (passes(ssrc))
+          return true;
+      }
+      return false;
+    case rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT:
+      return passes(event.audio_receiver_config().remote_ssrc()) ||
+             passes(event.audio_receiver_config().local_ssrc());
+    case rtclog::Event::AUDIO_SENDER_CONFIG_EVENT:
+      return passes(event.audio_sender_config().ssrc());
+    default:
+      return true;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+#ifndef LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_STREAM_PARSER_H_
+#define LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_STREAM_PARSER_H_
+
+#include <functional>
+#include <istream>
+#include <set>
+#include <string>
+
+#include "api/array_view.h"
+#include "rtc_base/ignore_wundef.h"
+
+// Files generated at build-time by the protobuf compiler.
+RTC_PUSH_IGNORING_WUNDEF()
+#ifdef WEBRTC_ANDROID_PLATFORM_BUILD
+#include "external/webrtc/webrtc/logging/rtc_event_log/rtc_event_log.pb.h"
+#else
+#include "logging/rtc_event_log/rtc_event_log.pb.h"
+#endif
+RTC_POP_IGNORING_WUNDEF()
+
+namespace webrtc {
+
+// Reads the events of an RtcEventLog one at a time and passes each of them to
+// a callback, without keeping any of them. Unlike ParsedRtcEventLog, which
+// holds all the events of the log so that they can be accessed by index, this
+// uses a constant amount of memory however long the log is, which is what the
+// tools that go through a log once need for the logs of multi-hour calls.
+//
+// The events can be filtered by type and by SSRC before they reach the
+// callback. Files are memory mapped where that is supported.
+class RtcEventLogStreamParser {
+ public:
+  // Called for each event that passes the filters, with the number of bytes
+  // that the event took in the log. The event is only valid during the call.
+  // Returning false stops the parsing.
+  using EventCallback =
+      std::function<bool(const rtclog::Event& event, size_t size_in_log)>;
+
+  RtcEventLogStreamParser();
+  ~RtcEventLogStreamParser();
+
+  // Only passes on the events of the added types. All the types are passed on
+  // if none has been added.
+  void AddEventTypeFilter(rtclog::Event::EventType type);
+
+  // Only passes on the RTP and RTCP packets, audio playouts and stream configs
+  // of the added SSRCs; the sender SSRC is used for RTCP. The other events
+  // aren't about a stream and are always passed on. All SSRCs are passed on
+  // if none has been added.
+  void AddSsrcFilter(uint32_t ssrc);
+
+  // Each of these returns false if the log is malformed or couldn't be read,
+  // after having passed on the events before the error.
+  bool ParseFile(const std::string& file_name, const EventCallback& callback);
+  bool ParseBuffer(rtc::ArrayView<const uint8_t> buffer,
+                   const EventCallback& callback);
+  bool ParseStream(std::istream& stream, const EventCallback& callback);
+
+ private:
+  // Parses the event in |data| into |event_| and passes it to |callback| if
+  // it isn't filtered out. Sets |*stop| if the callback returned false.
+  bool HandleEvent(const uint8_t* data,
+                   size_t length,
+                   size_t size_in_log,
+                   const EventCallback& callback,
+                   bool* stop);
+  bool PassesFilters(const rtclog::Event& event) const;
+
+  std::set<rtclog::Event::EventType> event_types_;
+  std::set<uint32_t> ssrcs_;
+
+  // Reused for all the events, so that parsing one doesn't allocate once the
+  // message has grown to the size of the largest event.
+  rtclog::Event event_;
+};
+
+}  // namespace webrtc
+
+#endif  // LOGGING_RTC_EVENT_LOG_RTC_EVENT_LOG_STREAM_PARSER_H_
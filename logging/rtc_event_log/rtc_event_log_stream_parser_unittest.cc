@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "logging/rtc_event_log/rtc_event_log_stream_parser.h"
+
+#include <stdio.h>
+
+#include <deque>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "logging/rtc_event_log/encoder/rtc_event_log_encoder_legacy.h"
+#include "logging/rtc_event_log/events/rtc_event_audio_receive_stream_config.h"
+#include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
+#include "logging/rtc_event_log/events/rtc_event_rtp_packet_incoming.h"
+#include "logging/rtc_event_log/rtc_stream_config.h"
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/ptr_util.h"
+#include "test/gtest.h"
+#include "test/testsupport/fileutils.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr uint32_t kAudioSsrc = 0x1000;
+constexpr uint32_t kVideoSsrc = 0x2000;
+constexpr int kPacketsPerSsrc = 50;
+
+struct ParsedEvent {
+  rtclog::Event::EventType type;
+  uint32_t ssrc;
+};
+
+}  // namespace
+
+class RtcEventLogStreamParserTest : public testing::Test {
+ protected:
+  RtcEventLogStreamParserTest() {
+    std::deque<std::unique_ptr<RtcEvent>> events;
+    auto config = rtc::MakeUnique<rtclog::StreamConfig>();
+    config->remote_ssrc = kAudioSsrc;
+    events.push_back(
+        rtc::MakeUnique<RtcEventAudioReceiveStreamConfig>(std::move(config)));
+    for (int i = 0; i < kPacketsPerSsrc; ++i) {
+      for (uint32_t ssrc : {kAudioSsrc, kVideoSsrc}) {
+        RtpPacketReceived packet;
+        packet.SetSsrc(ssrc);
+        packet.SetSequenceNumber(i);
+        packet.SetPayloadSize(100);
+        events.push_back(rtc::MakeUnique<RtcEventRtpPacketIncoming>(packet));
+      }
+      events.push_back(
+          rtc::MakeUnique<RtcEventBweUpdateLossBased>(300000 + i, 0, 100));
+    }
+    RtcEventLogEncoderLegacy encoder;
+    log_ = encoder.EncodeLogStart(0) +
+           encoder.EncodeBatch(events.begin(), events.end()) +
+           encoder.EncodeLogEnd(0);
+  }
+
+  bool Parse(const std::string& log) {
+    parsed_events_.clear();
+    parsed_size_ = 0;
+    return parser_.ParseBuffer(
+        rtc::ArrayView<const uint8_t>(
+            reinterpret_cast<const uint8_t*>(log.data()), log.size()),
+        [this](const rtclog::Event& event, size_t size_in_log) {
+          uint32_t ssrc = 0;
+          if (event.type() == rtclog::Event::RTP_EVENT) {
+            const std::string& header = event.rtp_packet().header();
+            ssrc = ByteReader<uint32_t>::ReadBigEndian(
+                reinterpret_cast<const uint8_t*>(header.data() + 8));
+          }
+          parsed_events_.push_back({event.type(), ssrc});
+          parsed_size_ += size_in_log;
+          return true;
+        });
+  }
+
+  size_t CountEvents(rtclog::Event::EventType type) const {
+    size_t count = 0;
+    for (const ParsedEvent& event : parsed_events_)
+      count += event.type == type ? 1 : 0;
+    return count;
+  }
+
+  RtcEventLogStreamParser parser_;
+  std::string log_;
+  std::vector<ParsedEvent> parsed_events_;
+  size_t parsed_size_ = 0;
+};
+
+TEST_F(RtcEventLogStreamParserTest, PassesOnAllEventsInOrder) {
+  ASSERT_TRUE(Parse(log_));
+  ASSERT_EQ(3u + 3 * kPacketsPerSsrc, parsed_events_.size());
+  EXPECT_EQ(rtclog::Event::LOG_START, parsed_events_.front().type);
+  EXPECT_EQ(rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT,
+            parsed_events_[1].type);
+  EXPECT_EQ(kAudioSsrc, parsed_events_[2].ssrc);
+  EXPECT_EQ(kVideoSsrc, parsed_events_[3].ssrc);
+  EXPECT_EQ(rtclog::Event::LOSS_BASED_BWE_UPDATE, parsed_events_[4].type);
+  EXPECT_EQ(rtclog::Event::LOG_END, parsed_events_.back().type);
+  // The sizes of the events add up to that of the log.
+  EXPECT_EQ(log_.size(), parsed_size_);
+}
+
+TEST_F(RtcEventLogStreamParserTest, FiltersByEventType) {
+  parser_.AddEventTypeFilter(rtclog::Event::LOSS_BASED_BWE_UPDATE);
+  parser_.AddEventTypeFilter(rtclog::Event::LOG_END);
+  ASSERT_TRUE(Parse(log_));
+  EXPECT_EQ(1u + kPacketsPerSsrc, parsed_events_.size());
+  EXPECT_EQ(static_cast<size_t>(kPacketsPerSsrc),
+            CountEvents(rtclog::Event::LOSS_BASED_BWE_UPDATE));
+  EXPECT_EQ(1u, CountEvents(rtclog::Event::LOG_END));
+}
+
+TEST_F(RtcEventLogStreamParserTest, FiltersBySsrc) {
+  parser_.AddSsrcFilter(kVideoSsrc);
+  ASSERT_TRUE(Parse(log_));
+  // The config is of the audio stream, and the events that aren't of a
+  // stream are all passed on.
+  EXPECT_EQ(0u, CountEvents(rtclog::Event::AUDIO_RECEIVER_CONFIG_EVENT));
+  EXPECT_EQ(static_cast<size_t>(kPacketsPerSsrc),
+            CountEvents(rtclog::Event::RTP_EVENT));
+  EXPECT_EQ(static_cast<size_t>(kPacketsPerSsrc),
+            CountEvents(rtclog::Event::LOSS_BASED_BWE_UPDATE));
+  for (const ParsedEvent& event : parsed_events_) {
+    if (event.type == rtclog::Event::RTP_EVENT)
+      EXPECT_EQ(kVideoSsrc, event.ssrc);
+  }
+}
+
+TEST_F(RtcEventLogStreamParserTest, StopsWhenTheCallbackReturnsFalse) {
+  size_t num_events = 0;
+  EXPECT_TRUE(parser_.ParseBuffer(
+      rtc::ArrayView<const uint8_t>(
+          reinterpret_cast<const uint8_t*>(log_.data()), log_.size()),
+      [&num_events](const rtclog::Event& event, size_t size_in_log) {
+        return ++num_events < 3;
+      }));
+  EXPECT_EQ(3u, num_events);
+}
+
+TEST_F(RtcEventLogStreamParserTest, FailsOnTruncatedLog) {
+  EXPECT_FALSE(Parse(log_.substr(0, log_.size() - 1)));
+  // The events before the truncated one were passed on.
+  EXPECT_EQ(2u + 3 * kPacketsPerSsrc, parsed_events_.size());
+  EXPECT_FALSE(Parse("\x0a"));
+  EXPECT_FALSE(Parse("\x12"));
+}
+
+TEST_F(RtcEventLogStreamParserTest, ParsesStreamsAndFiles) {
+  size_t num_events = 0;
+  auto count = [&num_events](const rtclog::Event& event, size_t size_in_log) {
+    ++num_events;
+    return true;
+  };
+  std::istringstream stream(log_, std::ios_base::in | std::ios_base::binary);
+  EXPECT_TRUE(parser_.ParseStream(stream, count));
+  EXPECT_EQ(3u + 3 * kPacketsPerSsrc, num_events);
+
+  const std::string file_name =
+      test::TempFilename(test::OutputPath(), "stream_parser_test");
+  FILE* file = fopen(file_name.c_str(), "wb");
+  ASSERT_TRUE(file);
+  ASSERT_EQ(log_.size(), fwrite(log_.data(), 1, log_.size(), file));
+  fclose(file);
+  num_events = 0;
+  EXPECT_TRUE(parser_.ParseFile(file_name, count));
+  EXPECT_EQ(3u + 3 * kPacketsPerSsrc, num_events);
+  remove(file_name.c_str());
+
+  EXPECT_FALSE(parser_.ParseFile(file_name, count));
+}
+
+}  // namespace webrtc
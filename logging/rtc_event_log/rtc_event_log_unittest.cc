@@ -766,6 +766,55 @@ TEST(RtcEventLogTest, CircularBufferKeepsMostRecentEvents) {
                                            parsed_log.GetNumberOfEvents() - 1);
 }
 
+TEST(RtcEventLogTest, DumpRecordingKeepsMostRecentEvents) {
+  constexpr size_t kNumEvents = 20000;
+  constexpr int64_t kStartTime = 1000000;
+  constexpr int64_t kMaxAgeMs = 20000;
+
+  auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+  const std::string temp_filename =
+      test::OutputPath() + "RtcEventLogTest_" + test_info->name();
+
+  rtc::ScopedFakeClock fake_clock;
+  fake_clock.SetTimeMicros(kStartTime);
+
+  std::unique_ptr<RtcEventLog> log_dumper(
+      RtcEventLog::Create(RtcEventLog::EncodingType::Legacy));
+  log_dumper->StartRecording(10000000, kMaxAgeMs);
+  // The events span 200 s, of which only the last 20 s, maybe rounded up to a
+  // batch of events, are kept.
+  for (size_t i = 0; i < kNumEvents; i++) {
+    log_dumper->Log(rtc::MakeUnique<RtcEventAudioPlayout>(i));
+    fake_clock.AdvanceTimeMicros(10000);
+  }
+  ASSERT_TRUE(log_dumper->DumpRecording(
+      rtc::MakeUnique<RtcEventLogOutputFile>(temp_filename, 10000000)));
+  // Waits for the dump to be written.
+  log_dumper->StopLogging();
+
+  ParsedRtcEventLogNew parsed_log;
+  ASSERT_TRUE(parsed_log.ParseFile(temp_filename));
+  EXPECT_LT(parsed_log.GetNumberOfEvents(), kNumEvents / 2);
+  EXPECT_GT(parsed_log.GetNumberOfEvents(), 2u + kMaxAgeMs / 10);
+
+  RtcEventLogTestHelper::VerifyLogStartEvent(parsed_log, 0);
+  rtc::Optional<uint32_t> last_ssrc;
+  for (size_t i = 1; i < parsed_log.GetNumberOfEvents() - 1; i++) {
+    ASSERT_EQ(parsed_log.GetEventType(i),
+              ParsedRtcEventLogNew::EventType::AUDIO_PLAYOUT_EVENT);
+    LoggedAudioPlayoutEvent playout_event = parsed_log.GetAudioPlayout(i);
+    EXPECT_EQ(static_cast<int64_t>(kStartTime + 10000 * playout_event.ssrc),
+              playout_event.timestamp_us);
+    if (last_ssrc)
+      EXPECT_EQ(playout_event.ssrc, *last_ssrc + 1);
+    last_ssrc = playout_event.ssrc;
+  }
+  ASSERT_TRUE(last_ssrc);
+  EXPECT_EQ(kNumEvents - 1, *last_ssrc);
+  RtcEventLogTestHelper::VerifyLogEndEvent(parsed_log,
+                                           parsed_log.GetNumberOfEvents() - 1);
+}
+
 INSTANTIATE_TEST_CASE_P(
     RtcEventLogTest,
     RtcEventLogSession,
@@ -10,7 +10,6 @@
 
 #include "media/base/adaptedvideotracksource.h"
 
-#include "api/video/i420_buffer.h"
 
 namespace rtc {
 
@@ -47,16 +46,34 @@ void AdaptedVideoTrackSource::OnFrame(const webrtc::VideoFrame& frame) {
      synchronization for us in this case, by not passing the frame on
      to sinks which don't want it. */
   if (apply_rotation() && frame.rotation() != webrtc::kVideoRotation_0 &&
-      buffer->type() == webrtc::VideoFrameBuffer::Type::kI420) {
+      (buffer->type() == webrtc::VideoFrameBuffer::Type::kI420 ||
+       buffer->type() == webrtc::VideoFrameBuffer::Type::kNV12)) {
     /* Apply pending rotation. */
     broadcaster_.OnFrame(webrtc::VideoFrame(
-        webrtc::I420Buffer::Rotate(*buffer->GetI420(), frame.rotation()),
+        CropScaleAndRotate(buffer, 0, 0, buffer->width(), buffer->height(),
+                           buffer->width(), buffer->height(),
+                           frame.rotation()),
         webrtc::kVideoRotation_0, frame.timestamp_us()));
   } else {
     broadcaster_.OnFrame(frame);
   }
 }
 
+rtc::scoped_refptr<webrtc::I420BufferInterface>
+AdaptedVideoTrackSource::CropScaleAndRotate(
+    const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+    int crop_x,
+    int crop_y,
+    int crop_width,
+    int crop_height,
+    int adapted_width,
+    int adapted_height,
+    webrtc::VideoRotation rotation) {
+  return frame_transformer_.Transform(buffer, crop_x, crop_y, crop_width,
+                                      crop_height, adapted_width,
+                                      adapted_height, rotation);
+}
+
 void AdaptedVideoTrackSource::AddOrUpdateSink(
     rtc::VideoSinkInterface<webrtc::VideoFrame>* sink,
     const rtc::VideoSinkWants& wants) {
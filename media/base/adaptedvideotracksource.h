@@ -13,6 +13,7 @@
 
 #include "api/mediastreaminterface.h"
 #include "api/notifier.h"
+#include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "media/base/videoadapter.h"
 #include "media/base/videobroadcaster.h"
 
@@ -37,6 +38,20 @@ class AdaptedVideoTrackSource
   // handle apply_rotation() themselves.
   void OnFrame(const webrtc::VideoFrame& frame);
 
+  // Crops and scales |buffer| as reported by AdaptFrame() and applies
+  // |rotation|, converting it to I420 in the same pass where possible. The
+  // result is written into a pooled buffer. Must be called on the same thread
+  // as OnFrame().
+  rtc::scoped_refptr<webrtc::I420BufferInterface> CropScaleAndRotate(
+      const rtc::scoped_refptr<webrtc::VideoFrameBuffer>& buffer,
+      int crop_x,
+      int crop_y,
+      int crop_width,
+      int crop_height,
+      int adapted_width,
+      int adapted_height,
+      webrtc::VideoRotation rotation);
+
   // Reports the appropriate frame size after adaptation. Returns true
   // if a frame is wanted. Returns false if there are no interested
   // sinks, or if the VideoAdapter decides to drop the frame.
@@ -77,6 +92,9 @@ class AdaptedVideoTrackSource
   rtc::CriticalSection stats_crit_;
   rtc::Optional<Stats> stats_ RTC_GUARDED_BY(stats_crit_);
 
+  // Used on the thread that delivers frames.
+  webrtc::I420FrameTransformer frame_transformer_;
+
   VideoBroadcaster broadcaster_;
 };
 
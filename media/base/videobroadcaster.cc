@@ -10,6 +10,8 @@
 
 #include "media/base/videobroadcaster.h"
 
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 #include "api/video/i420_buffer.h"
@@ -18,6 +20,44 @@
 
 namespace rtc {
 
+namespace {
+
+// Returns |frame| downscaled to at most |max_pixel_count| pixels, keeping the
+// aspect ratio. Frames already produced for this |frame| are kept in
+// |adapted_frames|, keyed by max pixel count, so sinks with the same wants
+// share a single scaled copy. Native frames are returned as is, since they
+// can't be scaled here without a conversion.
+const webrtc::VideoFrame& AdaptFrameForSink(
+    const webrtc::VideoFrame& frame,
+    int max_pixel_count,
+    std::vector<std::pair<int, webrtc::VideoFrame>>* adapted_frames) {
+  if (frame.size() <= static_cast<uint32_t>(max_pixel_count) ||
+      frame.video_frame_buffer()->type() ==
+          webrtc::VideoFrameBuffer::Type::kNative) {
+    return frame;
+  }
+  for (const auto& adapted_frame : *adapted_frames) {
+    if (adapted_frame.first == max_pixel_count)
+      return adapted_frame.second;
+  }
+
+  const double scale = std::sqrt(static_cast<double>(max_pixel_count) /
+                                 (frame.width() * frame.height()));
+  const int width = std::max(2, static_cast<int>(frame.width() * scale) & ~1);
+  const int height =
+      std::max(2, static_cast<int>(frame.height() * scale) & ~1);
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer =
+      webrtc::I420Buffer::Create(width, height);
+  buffer->ScaleFrom(*frame.video_frame_buffer()->ToI420());
+  webrtc::VideoFrame adapted(buffer, frame.rotation(), frame.timestamp_us());
+  adapted.set_timestamp(frame.timestamp());
+  adapted.set_ntp_time_ms(frame.ntp_time_ms());
+  adapted_frames->emplace_back(max_pixel_count, std::move(adapted));
+  return adapted_frames->back().second;
+}
+
+}  // namespace
+
 VideoBroadcaster::VideoBroadcaster() {
   thread_checker_.DetachFromThread();
 }
@@ -54,6 +94,10 @@ VideoSinkWants VideoBroadcaster::wants() const {
 
 void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
   rtc::CritScope cs(&sinks_and_wants_lock_);
+  // Sinks that want fewer pixels than the source delivered, e.g. because the
+  // source doesn't adapt to wants, get a downscaled frame. It is produced
+  // once per distinct max pixel count and shared by reference.
+  std::vector<std::pair<int, webrtc::VideoFrame>> adapted_frames;
   for (auto& sink_pair : sink_pairs()) {
     if (sink_pair.wants.rotation_applied &&
         frame.rotation() != webrtc::kVideoRotation_0) {
@@ -69,7 +113,8 @@ void VideoBroadcaster::OnFrame(const webrtc::VideoFrame& frame) {
           GetBlackFrameBuffer(frame.width(), frame.height()), frame.rotation(),
           frame.timestamp_us()));
     } else {
-      sink_pair.sink->OnFrame(frame);
+      sink_pair.sink->OnFrame(AdaptFrameForSink(
+          frame, sink_pair.wants.max_pixel_count, &adapted_frames));
     }
   }
 }
@@ -29,6 +29,9 @@ namespace rtc {
 // Sinks must be added and removed on one and only one thread.
 // Video frames can be broadcasted on any thread. I.e VideoBroadcaster::OnFrame
 // can be called on any thread.
+// Sinks whose VideoSinkWants::max_pixel_count is below the size of a
+// broadcasted frame get a downscaled copy, which is shared by all sinks with
+// the same max pixel count.
 class VideoBroadcaster : public VideoSourceBase,
                          public VideoSinkInterface<webrtc::VideoFrame> {
  public:
@@ -193,3 +193,40 @@ TEST(VideoBroadcasterTest, SinkWantsBlackFrames) {
   EXPECT_TRUE(sink2.black_frame());
   EXPECT_EQ(30, sink2.timestamp_us());
 }
+
+TEST(VideoBroadcasterTest, SharesDownscaledFramesBetweenSinksWithSameWants) {
+  class BufferRecordingSink
+      : public rtc::VideoSinkInterface<webrtc::VideoFrame> {
+   public:
+    void OnFrame(const webrtc::VideoFrame& frame) override {
+      buffer = frame.video_frame_buffer();
+      timestamp_us = frame.timestamp_us();
+    }
+    rtc::scoped_refptr<webrtc::VideoFrameBuffer> buffer;
+    int64_t timestamp_us = 0;
+  };
+
+  VideoBroadcaster broadcaster;
+  BufferRecordingSink full_sink;
+  broadcaster.AddOrUpdateSink(&full_sink, VideoSinkWants());
+  VideoSinkWants quarter_wants;
+  quarter_wants.max_pixel_count = 320 * 180;
+  BufferRecordingSink quarter_sink1;
+  BufferRecordingSink quarter_sink2;
+  broadcaster.AddOrUpdateSink(&quarter_sink1, quarter_wants);
+  broadcaster.AddOrUpdateSink(&quarter_sink2, quarter_wants);
+
+  rtc::scoped_refptr<webrtc::I420Buffer> buffer(
+      webrtc::I420Buffer::Create(640, 360));
+  buffer->InitializeData();
+  broadcaster.OnFrame(
+      webrtc::VideoFrame(buffer, webrtc::kVideoRotation_0, 10));
+
+  EXPECT_EQ(buffer, full_sink.buffer);
+  ASSERT_TRUE(quarter_sink1.buffer);
+  EXPECT_EQ(320, quarter_sink1.buffer->width());
+  EXPECT_EQ(180, quarter_sink1.buffer->height());
+  EXPECT_EQ(10, quarter_sink1.timestamp_us);
+  // The downscaled frame is produced once and shared.
+  EXPECT_EQ(quarter_sink1.buffer, quarter_sink2.buffer);
+}
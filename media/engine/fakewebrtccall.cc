@@ -249,6 +249,10 @@ void FakeVideoSendStream::ReconfigureVideoEncoder(
   ++num_encoder_reconfigurations_;
 }
 
+void FakeVideoSendStream::SetRtcpMode(webrtc::RtcpMode mode) {
+  config_.rtp.rtcp_mode = mode;
+}
+
 void FakeVideoSendStream::UpdateActiveSimulcastLayers(
     const std::vector<bool> active_layers) {
   sending_ = false;
@@ -329,6 +333,10 @@ webrtc::VideoReceiveStream::Stats FakeVideoReceiveStream::GetStats() const {
   return stats_;
 }
 
+void FakeVideoReceiveStream::SetRtcpMode(webrtc::RtcpMode mode) {
+  config_.rtp.rtcp_mode = mode;
+}
+
 void FakeVideoReceiveStream::Start() {
   receiving_ = true;
 }
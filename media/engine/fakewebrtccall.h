@@ -62,6 +62,9 @@ class FakeAudioSendStream final : public webrtc::AudioSendStream {
   void Stop() override { sending_ = false; }
   void SendAudioData(std::unique_ptr<webrtc::AudioFrame> audio_frame) override {
   }
+  void SendAudioData(
+      rtc::scoped_refptr<const rtc::RefCountedObject<webrtc::AudioFrame>>
+          audio_frame) override {}
   bool SendTelephoneEvent(int payload_type, int payload_frequency, int event,
                           int duration_ms) override;
   void SetMuted(bool muted) override;
@@ -168,6 +171,7 @@ class FakeVideoSendStream final
       const webrtc::DegradationPreference& degradation_preference) override;
   webrtc::VideoSendStream::Stats GetStats() override;
   void ReconfigureVideoEncoder(webrtc::VideoEncoderConfig config) override;
+  void SetRtcpMode(webrtc::RtcpMode mode) override;
 
   bool sending_;
   webrtc::VideoSendStream::Config config_;
@@ -216,6 +220,7 @@ class FakeVideoReceiveStream final : public webrtc::VideoReceiveStream {
   void Stop() override;
 
   webrtc::VideoReceiveStream::Stats GetStats() const override;
+  void SetRtcpMode(webrtc::RtcpMode mode) override;
 
   webrtc::VideoReceiveStream::Config config_;
   bool receiving_;
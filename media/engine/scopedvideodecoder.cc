@@ -34,6 +34,7 @@ class ScopedVideoDecoder : public webrtc::VideoDecoder {
                  int64_t render_time_ms) override;
   bool PrefersLateDecoding() const override;
   const char* ImplementationName() const override;
+  int NumberOfThreads() const override;
 
   ~ScopedVideoDecoder() override;
 
@@ -77,6 +78,10 @@ const char* ScopedVideoDecoder::ImplementationName() const {
   return decoder_->ImplementationName();
 }
 
+int ScopedVideoDecoder::NumberOfThreads() const {
+  return decoder_->NumberOfThreads();
+}
+
 ScopedVideoDecoder::~ScopedVideoDecoder() {
   factory_->DestroyVideoDecoder(decoder_);
 }
@@ -12,13 +12,14 @@
 
 #include <algorithm>
 
-
 #include "api/video/i420_buffer.h"
 #include "api/video_codecs/video_encoder_factory.h"
 #include "media/engine/scopedvideoencoder.h"
 #include "modules/video_coding/codecs/vp8/screenshare_layers.h"
 #include "modules/video_coding/codecs/vp8/simulcast_rate_allocator.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
+#include "rtc_base/ptr_util.h"
 #include "system_wrappers/include/clock.h"
 #include "third_party/libyuv/include/libyuv/scale.h"
 
@@ -111,7 +112,8 @@ SimulcastEncoderAdapter::SimulcastEncoderAdapter(VideoEncoderFactory* factory)
     : inited_(0),
       factory_(factory),
       encoded_complete_callback_(nullptr),
-      implementation_name_("SimulcastEncoderAdapter") {
+      implementation_name_("SimulcastEncoderAdapter"),
+      defer_encoded_images_(false) {
   RTC_DCHECK(factory_);
 
   // The adapter is typically created on the worker thread, but operated on
@@ -129,6 +131,8 @@ SimulcastEncoderAdapter::~SimulcastEncoderAdapter() {
 int SimulcastEncoderAdapter::Release() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&encoder_queue_);
 
+  encode_queues_.clear();
+
   while (!streaminfos_.empty()) {
     std::unique_ptr<VideoEncoder> encoder =
         std::move(streaminfos_.back().encoder);
@@ -251,6 +255,13 @@ int SimulcastEncoderAdapter::InitEncode(const VideoCodec* inst,
   // To save memory, don't store encoders that we don't use.
   DestroyStoredEncoders();
 
+  const int num_encode_queues =
+      std::min(number_of_cores, number_of_streams) - 1;
+  for (int i = 0; i < num_encode_queues; ++i) {
+    encode_queues_.push_back(rtc::MakeUnique<rtc::TaskQueue>(
+        "SimulcastEncode", rtc::TaskQueue::Priority::HIGH));
+  }
+
   rtc::AtomicOps::ReleaseStore(&inited_, 1);
 
   return WEBRTC_VIDEO_CODEC_OK;
@@ -288,22 +299,121 @@ int SimulcastEncoderAdapter::Encode(
     }
   }
 
-  int src_width = input_image.width();
-  int src_height = input_image.height();
+  std::vector<rtc::Optional<VideoFrame>> scaled_frames =
+      ScaleToStreams(input_image);
+  std::vector<const VideoFrame*> stream_frames(streaminfos_.size());
+  std::vector<std::vector<FrameType>> stream_frame_types(streaminfos_.size());
+  std::vector<size_t> streams_to_encode;
   for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
     // Don't encode frames in resolutions that we don't intend to send.
     if (!streaminfos_[stream_idx].send_stream) {
       continue;
     }
-
-    std::vector<FrameType> stream_frame_types;
     if (send_key_frame) {
-      stream_frame_types.push_back(kVideoFrameKey);
+      stream_frame_types[stream_idx].push_back(kVideoFrameKey);
       streaminfos_[stream_idx].key_frame_request = false;
     } else {
-      stream_frame_types.push_back(kVideoFrameDelta);
+      stream_frame_types[stream_idx].push_back(kVideoFrameDelta);
     }
+    stream_frames[stream_idx] = scaled_frames[stream_idx]
+                                    ? &*scaled_frames[stream_idx]
+                                    : &input_image;
+    streams_to_encode.push_back(stream_idx);
+  }
+
+  if (encode_queues_.empty() || streams_to_encode.size() < 2) {
+    for (size_t stream_idx : streams_to_encode) {
+      int ret = streaminfos_[stream_idx].encoder->Encode(
+          *stream_frames[stream_idx], codec_specific_info,
+          &stream_frame_types[stream_idx]);
+      if (ret != WEBRTC_VIDEO_CODEC_OK) {
+        return ret;
+      }
+    }
+    return WEBRTC_VIDEO_CODEC_OK;
+  }
+
+  // Encode the lower resolution streams on the encode queues, and the highest
+  // resolution one here, then wait for all of them to finish. The encoders
+  // are never used concurrently with any other call into the adapter.
+  {
+    rtc::CritScope lock(&callback_crit_);
+    defer_encoded_images_ = true;
+  }
+  std::vector<int> results(streaminfos_.size(), WEBRTC_VIDEO_CODEC_OK);
+  // Counts every posted encode up front, so that an early one finishing
+  // can't signal |encodes_done| while later ones are still being posted.
+  volatile int pending_encodes = static_cast<int>(streams_to_encode.size() - 1);
+  rtc::Event encodes_done(false, false);
+  rtc::Optional<size_t> inline_stream;
+  for (size_t stream_idx : streams_to_encode) {
+    if (stream_idx == streams_to_encode.back()) {
+      inline_stream = stream_idx;
+      continue;
+    }
+    rtc::TaskQueue* queue =
+        encode_queues_[stream_idx % encode_queues_.size()].get();
+    queue->PostTask([&, stream_idx] {
+      results[stream_idx] = streaminfos_[stream_idx].encoder->Encode(
+          *stream_frames[stream_idx], codec_specific_info,
+          &stream_frame_types[stream_idx]);
+      if (rtc::AtomicOps::Decrement(&pending_encodes) == 0)
+        encodes_done.Set();
+    });
+  }
+  if (inline_stream) {
+    results[*inline_stream] = streaminfos_[*inline_stream].encoder->Encode(
+        *stream_frames[*inline_stream], codec_specific_info,
+        &stream_frame_types[*inline_stream]);
+  }
+  encodes_done.Wait(rtc::Event::kForever);
+
+  // Deliver the encoded images in stream order, regardless of which encoder
+  // finished first.
+  std::vector<DeferredEncodedImage> deferred_images;
+  {
+    rtc::CritScope lock(&callback_crit_);
+    defer_encoded_images_ = false;
+    deferred_images.swap(deferred_images_);
+  }
+  std::stable_sort(deferred_images.begin(), deferred_images.end(),
+                   [](const DeferredEncodedImage& a,
+                      const DeferredEncodedImage& b) {
+                     return a.stream_idx < b.stream_idx;
+                   });
+  for (const DeferredEncodedImage& deferred : deferred_images) {
+    encoded_complete_callback_->OnEncodedImage(deferred.encoded_image,
+                                              &deferred.codec_specific_info,
+                                              deferred.fragmentation.get());
+  }
+
+  for (size_t stream_idx : streams_to_encode) {
+    if (results[stream_idx] != WEBRTC_VIDEO_CODEC_OK) {
+      return results[stream_idx];
+    }
+  }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+std::vector<rtc::Optional<VideoFrame>> SimulcastEncoderAdapter::ScaleToStreams(
+    const VideoFrame& input_image) {
+  std::vector<rtc::Optional<VideoFrame>> scaled_frames(streaminfos_.size());
+  std::vector<size_t> streams_by_resolution;
+  for (size_t stream_idx = 0; stream_idx < streaminfos_.size(); ++stream_idx) {
+    if (streaminfos_[stream_idx].send_stream)
+      streams_by_resolution.push_back(stream_idx);
+  }
+  std::sort(streams_by_resolution.begin(), streams_by_resolution.end(),
+            [this](size_t a, size_t b) {
+              return streaminfos_[a].width * streaminfos_[a].height >
+                     streaminfos_[b].width * streaminfos_[b].height;
+            });
 
+  int src_width = input_image.width();
+  int src_height = input_image.height();
+  rtc::scoped_refptr<I420BufferInterface> src_buffer;
+  rtc::scoped_refptr<I420BufferInterface> last_scaled_buffer;
+  for (size_t stream_idx : streams_by_resolution) {
     int dst_width = streaminfos_[stream_idx].width;
     int dst_height = streaminfos_[stream_idx].height;
     // If scaling isn't required, because the input resolution
@@ -319,36 +429,36 @@ int SimulcastEncoderAdapter::Encode(
     if ((dst_width == src_width && dst_height == src_height) ||
         input_image.video_frame_buffer()->type() ==
             VideoFrameBuffer::Type::kNative) {
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          input_image, codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
-    } else {
-      rtc::scoped_refptr<I420Buffer> dst_buffer =
-          I420Buffer::Create(dst_width, dst_height);
-      rtc::scoped_refptr<I420BufferInterface> src_buffer =
-          input_image.video_frame_buffer()->ToI420();
-      libyuv::I420Scale(src_buffer->DataY(), src_buffer->StrideY(),
-                        src_buffer->DataU(), src_buffer->StrideU(),
-                        src_buffer->DataV(), src_buffer->StrideV(), src_width,
-                        src_height, dst_buffer->MutableDataY(),
-                        dst_buffer->StrideY(), dst_buffer->MutableDataU(),
-                        dst_buffer->StrideU(), dst_buffer->MutableDataV(),
-                        dst_buffer->StrideV(), dst_width, dst_height,
-                        libyuv::kFilterBilinear);
-
-      int ret = streaminfos_[stream_idx].encoder->Encode(
-          VideoFrame(dst_buffer, input_image.timestamp(),
-                     input_image.render_time_ms(), webrtc::kVideoRotation_0),
-          codec_specific_info, &stream_frame_types);
-      if (ret != WEBRTC_VIDEO_CODEC_OK) {
-        return ret;
-      }
+      continue;
     }
-  }
 
-  return WEBRTC_VIDEO_CODEC_OK;
+    if (!src_buffer)
+      src_buffer = input_image.video_frame_buffer()->ToI420();
+    // Scale from the previous layer when it covers this one, so that each
+    // layer only reads a buffer a step larger than itself.
+    rtc::scoped_refptr<I420BufferInterface> scale_from = src_buffer;
+    if (last_scaled_buffer && last_scaled_buffer->width() >= dst_width &&
+        last_scaled_buffer->height() >= dst_height) {
+      scale_from = last_scaled_buffer;
+    }
+    rtc::scoped_refptr<I420Buffer> dst_buffer =
+        scaled_buffer_pool_.CreateBuffer(dst_width, dst_height);
+    if (!dst_buffer)
+      dst_buffer = I420Buffer::Create(dst_width, dst_height);
+    libyuv::I420Scale(scale_from->DataY(), scale_from->StrideY(),
+                      scale_from->DataU(), scale_from->StrideU(),
+                      scale_from->DataV(), scale_from->StrideV(),
+                      scale_from->width(), scale_from->height(),
+                      dst_buffer->MutableDataY(), dst_buffer->StrideY(),
+                      dst_buffer->MutableDataU(), dst_buffer->StrideU(),
+                      dst_buffer->MutableDataV(), dst_buffer->StrideV(),
+                      dst_width, dst_height, libyuv::kFilterBox);
+    last_scaled_buffer = dst_buffer;
+    scaled_frames[stream_idx].emplace(dst_buffer, input_image.timestamp(),
+                                      input_image.render_time_ms(),
+                                      webrtc::kVideoRotation_0);
+  }
+  return scaled_frames;
 }
 
 int SimulcastEncoderAdapter::RegisterEncodeCompleteCallback(
@@ -431,11 +541,27 @@ EncodedImageCallback::Result SimulcastEncoderAdapter::OnEncodedImage(
     const EncodedImage& encodedImage,
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
+  rtc::CritScope lock(&callback_crit_);
   CodecSpecificInfo stream_codec_specific = *codecSpecificInfo;
   stream_codec_specific.codec_name = implementation_name_.c_str();
   CodecSpecificInfoVP8* vp8Info = &(stream_codec_specific.codecSpecific.VP8);
   vp8Info->simulcastIdx = stream_idx;
 
+  if (defer_encoded_images_) {
+    // The encoder's buffer stays valid until its next Encode call, which
+    // can't happen before the deferred images have been delivered.
+    std::unique_ptr<RTPFragmentationHeader> fragmentation_copy;
+    if (fragmentation) {
+      fragmentation_copy.reset(new RTPFragmentationHeader());
+      fragmentation_copy->CopyFrom(*fragmentation);
+    }
+    deferred_images_.push_back({stream_idx, encodedImage,
+                                stream_codec_specific,
+                                std::move(fragmentation_copy)});
+    return EncodedImageCallback::Result(EncodedImageCallback::Result::OK,
+                                        encodedImage._timeStamp);
+  }
+
   return encoded_complete_callback_->OnEncodedImage(
       encodedImage, &stream_codec_specific, fragmentation);
 }
@@ -18,10 +18,15 @@
 #include <utility>
 #include <vector>
 
+#include "api/optional.h"
+#include "common_video/include/i420_buffer_pool.h"
 #include "media/engine/webrtcvideoencoderfactory.h"
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "rtc_base/atomicops.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/sequenced_task_checker.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
@@ -92,10 +97,25 @@ class SimulcastEncoderAdapter : public VP8Encoder {
                                   bool highest_resolution_stream,
                                   webrtc::VideoCodec* stream_codec);
 
+  // An encoded image held back while layers are encoded in parallel.
+  struct DeferredEncodedImage {
+    size_t stream_idx;
+    EncodedImage encoded_image;
+    CodecSpecificInfo codec_specific_info;
+    std::unique_ptr<RTPFragmentationHeader> fragmentation;
+  };
+
   bool Initialized() const;
 
   void DestroyStoredEncoders();
 
+  // Scales |input_image| to the resolution of every stream that is sent.
+  // Streams are scaled from the highest resolution down, each one from the
+  // smallest already scaled frame that covers it. Entries are left empty for
+  // streams that take |input_image| as is, or aren't sent.
+  std::vector<rtc::Optional<VideoFrame>> ScaleToStreams(
+      const VideoFrame& input_image);
+
   volatile int inited_;  // Accessed atomically.
   VideoEncoderFactory* const factory_;
   VideoCodec codec_;
@@ -103,6 +123,23 @@ class SimulcastEncoderAdapter : public VP8Encoder {
   EncodedImageCallback* encoded_complete_callback_;
   std::string implementation_name_;
 
+  // Buffers handed to the encoders of the downscaled streams.
+  I420BufferPool scaled_buffer_pool_;
+
+  // When initialized with more than one core, the streams below the highest
+  // resolution are encoded in parallel on these queues, while the highest
+  // resolution stream is encoded on the calling queue. There is at most one
+  // queue per additional core; stream i uses queue i % encode_queues_.size().
+  std::vector<std::unique_ptr<rtc::TaskQueue>> encode_queues_;
+
+  // Serializes encoded images coming back from encoders running in parallel.
+  // While they do, the images are collected in |deferred_images_| and
+  // delivered in stream order once all streams are encoded.
+  rtc::CriticalSection callback_crit_;
+  bool defer_encoded_images_ RTC_GUARDED_BY(callback_crit_);
+  std::vector<DeferredEncodedImage> deferred_images_
+      RTC_GUARDED_BY(callback_crit_);
+
   // Used for checking the single-threaded access of the encoder interface.
   rtc::SequencedTaskChecker encoder_queue_;
 
@@ -19,6 +19,7 @@
 #include "media/engine/simulcast_encoder_adapter.h"
 #include "modules/video_coding/codecs/vp8/simulcast_test_utility.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_base/platform_thread_types.h"
 #include "rtc_base/ptr_util.h"
 #include "test/gmock.h"
 
@@ -802,6 +803,56 @@ TEST_F(TestSimulcastEncoderAdapterFake, TestFailureReturnCodesFromEncodeCalls) {
             adapter_->Encode(input_frame, nullptr, &frame_types));
 }
 
+TEST_F(TestSimulcastEncoderAdapterFake, EncodesStreamsInParallel) {
+  TestVp8Simulcast::DefaultSettings(
+      &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
+  codec_.numberOfSimulcastStreams = 3;
+  // High start bitrate, so all streams are enabled.
+  codec_.startBitrate = 3000;
+  EXPECT_EQ(0, adapter_->InitEncode(&codec_, 4, 1200));
+  adapter_->RegisterEncodeCompleteCallback(this);
+  ASSERT_EQ(3u, helper_->factory()->encoders().size());
+
+  std::vector<rtc::PlatformThreadRef> encode_threads(3);
+  for (size_t i = 0; i < 3; ++i) {
+    MockVideoEncoder* encoder = helper_->factory()->encoders()[i];
+    EXPECT_CALL(*encoder, Encode(_, _, _))
+        .WillOnce(::testing::Invoke(
+            [&encode_threads, encoder, i](const VideoFrame& frame,
+                                          const CodecSpecificInfo*,
+                                          const std::vector<FrameType>*) {
+              // Every stream gets a frame scaled to its own resolution.
+              EXPECT_EQ(encoder->codec().width, frame.width());
+              EXPECT_EQ(encoder->codec().height, frame.height());
+              encode_threads[i] = rtc::CurrentThreadRef();
+              encoder->SendEncodedImage(frame.width(), frame.height());
+              return WEBRTC_VIDEO_CODEC_OK;
+            }));
+  }
+
+  rtc::scoped_refptr<I420Buffer> input_buffer =
+      I420Buffer::Create(kDefaultWidth, kDefaultHeight);
+  input_buffer->InitializeData();
+  VideoFrame input_frame(input_buffer, 0, 0, webrtc::kVideoRotation_0);
+  std::vector<FrameType> frame_types(3, kVideoFrameKey);
+  EXPECT_EQ(0, adapter_->Encode(input_frame, nullptr, &frame_types));
+
+  // The highest resolution stream is encoded on the calling thread, the lower
+  // ones on the adapter's encode queues.
+  const rtc::PlatformThreadRef current_thread = rtc::CurrentThreadRef();
+  EXPECT_TRUE(rtc::IsThreadRefEqual(current_thread, encode_threads[2]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(current_thread, encode_threads[1]));
+  EXPECT_FALSE(rtc::IsThreadRefEqual(current_thread, encode_threads[0]));
+  int width;
+  int height;
+  int simulcast_index;
+  EXPECT_TRUE(GetLastEncodedImageInfo(&width, &height, &simulcast_index));
+  // Encoded images are delivered in stream order, so the highest resolution
+  // stream comes last.
+  EXPECT_EQ(2, simulcast_index);
+  EXPECT_EQ(codec_.width, width);
+}
+
 TEST_F(TestSimulcastEncoderAdapterFake, TestInitFailureCleansUpEncoders) {
   TestVp8Simulcast::DefaultSettings(
       &codec_, static_cast<const int*>(kTestTemporalLayerProfile));
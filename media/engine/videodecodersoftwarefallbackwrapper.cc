@@ -161,6 +161,10 @@ const char* VideoDecoderSoftwareFallbackWrapper::ImplementationName() const {
              : hw_decoder_->ImplementationName();
 }
 
+int VideoDecoderSoftwareFallbackWrapper::NumberOfThreads() const {
+  return active_decoder().NumberOfThreads();
+}
+
 VideoDecoder& VideoDecoderSoftwareFallbackWrapper::active_decoder() const {
   return decoder_type_ == DecoderType::kFallback ? *fallback_decoder_
                                                  : *hw_decoder_;
@@ -43,6 +43,7 @@ class VideoDecoderSoftwareFallbackWrapper : public VideoDecoder {
   bool PrefersLateDecoding() const override;
 
   const char* ImplementationName() const override;
+  int NumberOfThreads() const override;
 
  private:
   bool InitFallbackDecoder();
@@ -34,6 +34,7 @@
 #include "modules/video_coding/include/video_error_codes.h"
 #include "rtc_base/copyonwritebuffer.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/packetbufferallocator.h"
 #include "rtc_base/stringutils.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
@@ -1011,6 +1012,8 @@ bool WebRtcVideoChannel::SetRecvParameters(const VideoRecvParameters& params) {
 
   {
     rtc::CritScope stream_lock(&stream_crit_);
+    if (changed_params.codec_settings)
+      recycled_decoders_.clear();
     for (auto& kv : receive_streams_) {
       kv.second->SetRecvParameters(changed_params);
     }
@@ -1193,6 +1196,10 @@ void WebRtcVideoChannel::DeleteReceiveStream(
     WebRtcVideoChannel::WebRtcVideoReceiveStream* stream) {
   for (uint32_t old_ssrc : stream->GetSsrcs())
     receive_ssrcs_.erase(old_ssrc);
+  // The default stream is recreated whenever an unsignaled SSRC changes, so
+  // keep its decoders around for the next stream.
+  if (stream->IsDefaultStream())
+    stream->ReleaseDecoders(&recycled_decoders_);
   delete stream;
 }
 
@@ -1252,7 +1259,7 @@ bool WebRtcVideoChannel::AddRecvStream(const StreamParams& sp,
 
   receive_streams_[ssrc] = new WebRtcVideoReceiveStream(
       call_, sp, std::move(config), decoder_factory_, default_stream,
-      recv_codecs_, flexfec_config);
+      recv_codecs_, flexfec_config, &recycled_decoders_);
 
   return true;
 }
@@ -1548,14 +1555,18 @@ rtc::Optional<uint32_t> WebRtcVideoChannel::GetDefaultReceiveStreamSsrc() {
 bool WebRtcVideoChannel::SendRtp(const uint8_t* data,
                                  size_t len,
                                  const webrtc::PacketOptions& options) {
-  rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
+  rtc::CopyOnWriteBuffer packet =
+      rtc::PacketBufferAllocator::Allocate(std::max(len, kMaxRtpPacketLen));
+  packet.SetData(data, len);
   rtc::PacketOptions rtc_options;
   rtc_options.packet_id = options.packet_id;
   return MediaChannel::SendPacket(&packet, rtc_options);
 }
 
 bool WebRtcVideoChannel::SendRtcp(const uint8_t* data, size_t len) {
-  rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
+  rtc::CopyOnWriteBuffer packet =
+      rtc::PacketBufferAllocator::Allocate(std::max(len, kMaxRtpPacketLen));
+  packet.SetData(data, len);
   return MediaChannel::SendRtcp(&packet, rtc::PacketOptions());
 }
 
@@ -1761,7 +1772,9 @@ void WebRtcVideoChannel::WebRtcVideoSendStream::SetSendParameters(
   bool recreate_stream = false;
   if (params.rtcp_mode) {
     parameters_.config.rtp.rtcp_mode = *params.rtcp_mode;
-    recreate_stream = true;
+    // The RTCP mode can be changed without resetting the encoder.
+    if (stream_)
+      stream_->SetRtcpMode(*params.rtcp_mode);
   }
   if (params.rtp_header_extensions) {
     parameters_.config.rtp.extensions = *params.rtp_header_extensions;
@@ -2152,7 +2165,8 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::WebRtcVideoReceiveStream(
     DecoderFactoryAdapter* decoder_factory,
     bool default_stream,
     const std::vector<VideoCodecSettings>& recv_codecs,
-    const webrtc::FlexfecReceiveStream::Config& flexfec_config)
+    const webrtc::FlexfecReceiveStream::Config& flexfec_config,
+    DecoderMap* recycled_decoders)
     : call_(call),
       stream_params_(sp),
       stream_(NULL),
@@ -2165,12 +2179,12 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::WebRtcVideoReceiveStream(
       first_frame_timestamp_(-1),
       estimated_remote_start_ntp_time_ms_(0) {
   config_.renderer = this;
-  DecoderMap old_decoders;
-  ConfigureCodecs(recv_codecs, &old_decoders);
+  // Decoders that are not used by this stream are left in
+  // |recycled_decoders|.
+  ConfigureCodecs(recv_codecs, recycled_decoders);
   ConfigureFlexfecCodec(flexfec_config.payload_type);
   MaybeRecreateWebRtcFlexfecStream();
   RecreateWebRtcVideoStream();
-  RTC_DCHECK(old_decoders.empty());
 }
 
 WebRtcVideoChannel::WebRtcVideoReceiveStream::~WebRtcVideoReceiveStream() {
@@ -2178,7 +2192,25 @@ WebRtcVideoChannel::WebRtcVideoReceiveStream::~WebRtcVideoReceiveStream() {
     MaybeDissociateFlexfecFromVideo();
     call_->DestroyFlexfecReceiveStream(flexfec_stream_);
   }
-  call_->DestroyVideoReceiveStream(stream_);
+  if (stream_)
+    call_->DestroyVideoReceiveStream(stream_);
+  allocated_decoders_.clear();
+}
+
+void WebRtcVideoChannel::WebRtcVideoReceiveStream::ReleaseDecoders(
+    DecoderMap* recycled_decoders) {
+  // The decoders can't be handed out while the webrtc stream is using them.
+  if (flexfec_stream_) {
+    MaybeDissociateFlexfecFromVideo();
+    call_->DestroyFlexfecReceiveStream(flexfec_stream_);
+    flexfec_stream_ = nullptr;
+  }
+  if (stream_) {
+    call_->DestroyVideoReceiveStream(stream_);
+    stream_ = nullptr;
+  }
+  for (auto& kv : allocated_decoders_)
+    (*recycled_decoders)[kv.first] = std::move(kv.second);
   allocated_decoders_.clear();
 }
 
@@ -2205,7 +2237,9 @@ void WebRtcVideoChannel::WebRtcVideoReceiveStream::ConfigureCodecs(
     const std::vector<VideoCodecSettings>& recv_codecs,
     DecoderMap* old_decoders) {
   RTC_DCHECK(!recv_codecs.empty());
-  *old_decoders = std::move(allocated_decoders_);
+  for (auto& kv : allocated_decoders_)
+    (*old_decoders)[kv.first] = std::move(kv.second);
+  allocated_decoders_.clear();
   config_.decoders.clear();
   config_.rtp.rtx_associated_payload_types.clear();
   for (const auto& recv_codec : recv_codecs) {
@@ -2312,6 +2346,13 @@ void WebRtcVideoChannel::WebRtcVideoReceiveStream::SetFeedbackParameters(
         << ", transport_cc=" << transport_cc_enabled;
     return;
   }
+  // NACK and transport-cc are set up when the stream is created. REMB isn't
+  // used by the stream itself, and the RTCP mode can be changed in place, so
+  // changing only those preserves the decoder and jitter buffer state.
+  const bool recreate_video_stream =
+      config_.rtp.nack.rtp_history_ms != nack_history_ms ||
+      config_.rtp.transport_cc != transport_cc_enabled;
+  const bool rtcp_mode_changed = config_.rtp.rtcp_mode != rtcp_mode;
   config_.rtp.remb = remb_enabled;
   config_.rtp.nack.rtp_history_ms = nack_history_ms;
   config_.rtp.transport_cc = transport_cc_enabled;
@@ -2320,6 +2361,16 @@ void WebRtcVideoChannel::WebRtcVideoReceiveStream::SetFeedbackParameters(
   // based on the rtcp-fb for the FlexFEC codec, not the media codec.
   flexfec_config_.transport_cc = config_.rtp.transport_cc;
   flexfec_config_.rtcp_mode = config_.rtp.rtcp_mode;
+  if (!recreate_video_stream) {
+    RTC_LOG(LS_INFO)
+        << "Updating feedback parameters (recv) in place; remb="
+        << remb_enabled << ", rtcp_mode=" << static_cast<int>(rtcp_mode);
+    if (stream_ && rtcp_mode_changed)
+      stream_->SetRtcpMode(rtcp_mode);
+    if (rtcp_mode_changed)
+      MaybeRecreateWebRtcFlexfecStream();
+    return;
+  }
   RTC_LOG(LS_INFO)
       << "RecreateWebRtcStream (recv) because of SetFeedbackParameters; nack="
       << nack_enabled << ", remb=" << remb_enabled
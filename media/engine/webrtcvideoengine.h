@@ -236,6 +236,18 @@ class WebRtcVideoChannel : public VideoMediaChannel, public webrtc::Transport {
   void DeleteReceiveStream(WebRtcVideoReceiveStream* stream)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(stream_crit_);
 
+  struct SdpVideoFormatCompare {
+    bool operator()(const webrtc::SdpVideoFormat& lhs,
+                    const webrtc::SdpVideoFormat& rhs) const {
+      return std::tie(lhs.name, lhs.parameters) <
+             std::tie(rhs.name, rhs.parameters);
+    }
+  };
+  typedef std::map<webrtc::SdpVideoFormat,
+                   std::unique_ptr<webrtc::VideoDecoder>,
+                   SdpVideoFormatCompare>
+      DecoderMap;
+
   static std::string CodecSettingsVectorToString(
       const std::vector<VideoCodecSettings>& codecs);
 
@@ -354,9 +366,14 @@ class WebRtcVideoChannel : public VideoMediaChannel, public webrtc::Transport {
         DecoderFactoryAdapter* decoder_factory,
         bool default_stream,
         const std::vector<VideoCodecSettings>& recv_codecs,
-        const webrtc::FlexfecReceiveStream::Config& flexfec_config);
+        const webrtc::FlexfecReceiveStream::Config& flexfec_config,
+        DecoderMap* recycled_decoders);
     ~WebRtcVideoReceiveStream();
 
+    // Destroys the underlying webrtc streams and moves the decoders to
+    // |recycled_decoders|. The stream must be deleted afterwards.
+    void ReleaseDecoders(DecoderMap* recycled_decoders);
+
     const std::vector<uint32_t>& GetSsrcs() const;
     rtc::Optional<uint32_t> GetFirstPrimarySsrc() const;
 
@@ -376,18 +393,6 @@ class WebRtcVideoChannel : public VideoMediaChannel, public webrtc::Transport {
     VideoReceiverInfo GetVideoReceiverInfo(bool log_stats);
 
    private:
-    struct SdpVideoFormatCompare {
-      bool operator()(const webrtc::SdpVideoFormat& lhs,
-                      const webrtc::SdpVideoFormat& rhs) const {
-        return std::tie(lhs.name, lhs.parameters) <
-               std::tie(rhs.name, rhs.parameters);
-      }
-    };
-    typedef std::map<webrtc::SdpVideoFormat,
-                     std::unique_ptr<webrtc::VideoDecoder>,
-                     SdpVideoFormatCompare>
-        DecoderMap;
-
     void RecreateWebRtcVideoStream();
     void MaybeRecreateWebRtcFlexfecStream();
 
@@ -472,6 +477,10 @@ class WebRtcVideoChannel : public VideoMediaChannel, public webrtc::Transport {
       RTC_GUARDED_BY(stream_crit_);
   std::set<uint32_t> send_ssrcs_ RTC_GUARDED_BY(stream_crit_);
   std::set<uint32_t> receive_ssrcs_ RTC_GUARDED_BY(stream_crit_);
+  // Decoders of removed default receive streams, which are handed to the next
+  // receive stream instead of creating new ones. This makes switching between
+  // unsignaled SSRCs, e.g. when an SFU switches simulcast layers, cheaper.
+  DecoderMap recycled_decoders_ RTC_GUARDED_BY(stream_crit_);
 
   rtc::Optional<VideoCodecSettings> send_codec_;
   rtc::Optional<std::vector<webrtc::RtpExtension>> send_rtp_extensions_;
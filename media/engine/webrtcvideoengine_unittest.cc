@@ -886,6 +886,47 @@ TEST_F(WebRtcVideoEngineTest, RegisterDecodersIfSupported) {
   EXPECT_EQ(0u, decoder_factory_->decoders().size());
 }
 
+TEST_F(WebRtcVideoEngineTest, ReusesDecoderWhenDefaultStreamIsRecreated) {
+  encoder_factory_->AddSupportedVideoCodecType("VP8");
+  encoder_factory_->AddSupportedVideoCodecType("VP9");
+  decoder_factory_->AddSupportedVideoCodecType(webrtc::SdpVideoFormat("VP8"));
+  decoder_factory_->AddSupportedVideoCodecType(webrtc::SdpVideoFormat("VP9"));
+  std::vector<cricket::VideoCodec> codecs;
+  codecs.push_back(GetEngineCodec("VP8"));
+
+  std::unique_ptr<VideoMediaChannel> channel(
+      SetRecvParamsWithSupportedCodecs(codecs));
+  WebRtcVideoChannel* video_channel =
+      static_cast<WebRtcVideoChannel*>(channel.get());
+
+  // Replace the default stream as is done when a new unsignaled SSRC arrives.
+  EXPECT_TRUE(video_channel->AddRecvStream(
+      cricket::StreamParams::CreateLegacy(kSsrc), true));
+  EXPECT_TRUE(channel->RemoveRecvStream(kSsrc));
+  EXPECT_TRUE(video_channel->AddRecvStream(
+      cricket::StreamParams::CreateLegacy(kSsrc + 1), true));
+  EXPECT_EQ(1, decoder_factory_->GetNumCreatedDecoders());
+
+  // A signaled stream replacing the default stream reuses the decoder too.
+  EXPECT_TRUE(
+      channel->AddRecvStream(cricket::StreamParams::CreateLegacy(kSsrc + 1)));
+  EXPECT_EQ(1, decoder_factory_->GetNumCreatedDecoders());
+  EXPECT_EQ(1u, decoder_factory_->decoders().size());
+  EXPECT_TRUE(channel->RemoveRecvStream(kSsrc + 1));
+  EXPECT_EQ(0u, decoder_factory_->decoders().size());
+
+  // Recycled decoders are dropped when the receive codecs change.
+  EXPECT_TRUE(video_channel->AddRecvStream(
+      cricket::StreamParams::CreateLegacy(kSsrc + 2), true));
+  EXPECT_TRUE(channel->RemoveRecvStream(kSsrc + 2));
+  EXPECT_EQ(1u, decoder_factory_->decoders().size());
+  cricket::VideoRecvParameters parameters;
+  parameters.codecs = codecs;
+  parameters.codecs.push_back(GetEngineCodec("VP9"));
+  EXPECT_TRUE(channel->SetRecvParameters(parameters));
+  EXPECT_EQ(0u, decoder_factory_->decoders().size());
+}
+
 // Verifies that we can set up decoders.
 TEST_F(WebRtcVideoEngineTest, RegisterH264DecoderIfSupported) {
   // TODO(pbos): Do not assume that encoder/decoder support is symmetric. We
@@ -4440,9 +4481,11 @@ TEST_F(WebRtcVideoChannelTest, TestSetSendRtcpReducedSize) {
   FakeVideoSendStream* stream1 = AddSendStream();
   EXPECT_EQ(webrtc::RtcpMode::kCompound, stream1->GetConfig().rtp.rtcp_mode);
 
-  // Now enable reduced size mode.
+  // Now enable reduced size mode. This shouldn't recreate the stream.
+  const int num_created_send_streams = fake_call_->GetNumCreatedSendStreams();
   send_parameters_.rtcp.reduced_size = true;
   EXPECT_TRUE(channel_->SetSendParameters(send_parameters_));
+  EXPECT_EQ(num_created_send_streams, fake_call_->GetNumCreatedSendStreams());
   stream1 = fake_call_->GetVideoSendStreams()[0];
   EXPECT_EQ(webrtc::RtcpMode::kReducedSize, stream1->GetConfig().rtp.rtcp_mode);
 
@@ -4458,11 +4501,15 @@ TEST_F(WebRtcVideoChannelTest, TestSetRecvRtcpReducedSize) {
   FakeVideoReceiveStream* stream1 = AddRecvStream();
   EXPECT_EQ(webrtc::RtcpMode::kCompound, stream1->GetConfig().rtp.rtcp_mode);
 
-  // Now enable reduced size mode.
+  // Now enable reduced size mode. This shouldn't recreate the stream.
   // TODO(deadbeef): Once "recv_parameters" becomes "receiver_parameters",
   // the reduced_size flag should come from that.
+  const int num_created_receive_streams =
+      fake_call_->GetNumCreatedReceiveStreams();
   send_parameters_.rtcp.reduced_size = true;
   EXPECT_TRUE(channel_->SetSendParameters(send_parameters_));
+  EXPECT_EQ(num_created_receive_streams,
+            fake_call_->GetNumCreatedReceiveStreams());
   stream1 = fake_call_->GetVideoReceiveStreams()[0];
   EXPECT_EQ(webrtc::RtcpMode::kReducedSize, stream1->GetConfig().rtp.rtcp_mode);
 
@@ -42,6 +42,7 @@
 #include "rtc_base/stringencode.h"
 #include "rtc_base/strings/audio_format_to_string.h"
 #include "rtc_base/stringutils.h"
+#include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
@@ -211,7 +212,6 @@ WebRtcVoiceEngine::WebRtcVoiceEngine(
   RTC_LOG(LS_INFO) << "WebRtcVoiceEngine::WebRtcVoiceEngine";
   RTC_DCHECK(decoder_factory);
   RTC_DCHECK(encoder_factory);
-  RTC_DCHECK(audio_processing);
   // The rest of our initialization will happen in Init.
 }
 
@@ -232,10 +232,8 @@ WebRtcVoiceEngine::~WebRtcVoiceEngine() {
 void WebRtcVoiceEngine::Init() {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
   RTC_LOG(LS_INFO) << "WebRtcVoiceEngine::Init";
-
-  // TaskQueue expects to be created/destroyed on the same thread.
-  low_priority_worker_queue_.reset(
-      new rtc::TaskQueue("rtc-low-prio", rtc::TaskQueue::Priority::LOW));
+  TRACE_EVENT0("webrtc", "WebRtcVoiceEngine::Init");
+  const int64_t start_time_ms = rtc::TimeMillis();
 
   // Load our audio codec lists.
   RTC_LOG(LS_INFO) << "Supported send codecs in order of preference:";
@@ -258,8 +256,15 @@ void WebRtcVoiceEngine::Init() {
   }
 #endif  // WEBRTC_INCLUDE_INTERNAL_AUDIO_DEVICE
   RTC_CHECK(adm());
-  webrtc::adm_helpers::Init(adm());
-  webrtc::apm_helpers::Init(apm());
+  const int64_t adm_start_time_ms = rtc::TimeMillis();
+  {
+    TRACE_EVENT0("webrtc", "WebRtcVoiceEngine::Init::InitAdm");
+    webrtc::adm_helpers::Init(adm());
+  }
+  const int64_t adm_time_ms = rtc::TimeMillis() - adm_start_time_ms;
+  if (apm()) {
+    webrtc::apm_helpers::Init(apm());
+  }
 
   // Set up AudioState.
   {
@@ -279,7 +284,9 @@ void WebRtcVoiceEngine::Init() {
 
   // Save the default AGC configuration settings. This must happen before
   // calling ApplyOptions or the default will be overwritten.
-  default_agc_config_ = webrtc::apm_helpers::GetAgcConfig(apm());
+  if (apm()) {
+    default_agc_config_ = webrtc::apm_helpers::GetAgcConfig(apm());
+  }
 
   // Set default engine options.
   {
@@ -303,6 +310,9 @@ void WebRtcVoiceEngine::Init() {
   }
 
   initialized_ = true;
+  RTC_LOG(LS_INFO) << "WebRtcVoiceEngine::Init took "
+                   << rtc::TimeMillis() - start_time_ms << " ms, of which "
+                   << adm_time_ms << " ms initializing the ADM";
 }
 
 rtc::scoped_refptr<webrtc::AudioState>
@@ -325,6 +335,19 @@ bool WebRtcVoiceEngine::ApplyOptions(const AudioOptions& options_in) {
                    << options_in.ToString();
   AudioOptions options = options_in;  // The options are modified below.
 
+  // Without an APM there is no audio processing to configure, and the ADM
+  // doesn't capture, so only the options of the receive side apply.
+  if (!apm()) {
+    options.echo_cancellation.reset();
+    options.auto_gain_control.reset();
+    options.tx_agc_target_dbov.reset();
+    options.tx_agc_digital_compression_gain.reset();
+    options.tx_agc_limiter.reset();
+    options.noise_suppression.reset();
+    options.typing_detection.reset();
+    options.intelligibility_enhancer.reset();
+  }
+
   // Set and adjust echo canceller options.
   // kEcConference is AEC with high suppression.
   webrtc::EcModes ec_mode = webrtc::kEcConference;
@@ -565,6 +588,10 @@ bool WebRtcVoiceEngine::ApplyOptions(const AudioOptions& options_in) {
         new webrtc::Intelligibility(*intelligibility_enhancer_));
   }
 
+  if (!apm()) {
+    return true;
+  }
+
   webrtc::AudioProcessing::Config apm_config = apm()->GetConfig();
 
   if (options.highpass_filter) {
@@ -624,8 +651,11 @@ void WebRtcVoiceEngine::UnregisterChannel(WebRtcVoiceMediaChannel* channel) {
 bool WebRtcVoiceEngine::StartAecDump(rtc::PlatformFile file,
                                      int64_t max_size_bytes) {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  if (!apm()) {
+    return false;
+  }
   auto aec_dump = webrtc::AecDumpFactory::Create(
-      file, max_size_bytes, low_priority_worker_queue_.get());
+      file, max_size_bytes, low_priority_worker_queue());
   if (!aec_dump) {
     return false;
   }
@@ -635,17 +665,33 @@ bool WebRtcVoiceEngine::StartAecDump(rtc::PlatformFile file,
 
 void WebRtcVoiceEngine::StartAecDump(const std::string& filename) {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  if (!apm()) {
+    return;
+  }
 
   auto aec_dump = webrtc::AecDumpFactory::Create(
-      filename, -1, low_priority_worker_queue_.get());
+      filename, -1, low_priority_worker_queue());
   if (aec_dump) {
     apm()->AttachAecDump(std::move(aec_dump));
   }
 }
 
+rtc::TaskQueue* WebRtcVoiceEngine::low_priority_worker_queue() {
+  RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
+  // Only AEC dumps use the queue, so it isn't created until one is started.
+  // TaskQueue expects to be created/destroyed on the same thread.
+  if (!low_priority_worker_queue_) {
+    low_priority_worker_queue_.reset(
+        new rtc::TaskQueue("rtc-low-prio", rtc::TaskQueue::Priority::LOW));
+  }
+  return low_priority_worker_queue_.get();
+}
+
 void WebRtcVoiceEngine::StopAecDump() {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
-  apm()->DetachAecDump();
+  if (apm()) {
+    apm()->DetachAecDump();
+  }
 }
 
 webrtc::AudioDeviceModule* WebRtcVoiceEngine::adm() {
@@ -656,7 +702,6 @@ webrtc::AudioDeviceModule* WebRtcVoiceEngine::adm() {
 
 webrtc::AudioProcessing* WebRtcVoiceEngine::apm() const {
   RTC_DCHECK(worker_thread_checker_.CalledOnValidThread());
-  RTC_DCHECK(apm_);
   return apm_.get();
 }
 
@@ -2087,7 +2132,9 @@ bool WebRtcVoiceMediaChannel::MuteStream(uint32_t ssrc, bool muted) {
   for (const auto& kv : send_streams_) {
     all_muted = all_muted && kv.second->muted();
   }
-  engine()->apm()->set_output_will_be_muted(all_muted);
+  if (engine()->apm()) {
+    engine()->apm()->set_output_will_be_muted(all_muted);
+  }
 
   return true;
 }
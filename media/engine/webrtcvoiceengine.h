@@ -11,6 +11,7 @@
 #ifndef MEDIA_ENGINE_WEBRTCVOICEENGINE_H_
 #define MEDIA_ENGINE_WEBRTCVOICEENGINE_H_
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -27,6 +28,7 @@
 #include "rtc_base/buffer.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/networkroute.h"
+#include "rtc_base/packetbufferallocator.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/thread_checker.h"
@@ -43,6 +45,8 @@ class WebRtcVoiceMediaChannel;
 class WebRtcVoiceEngine final {
   friend class WebRtcVoiceMediaChannel;
  public:
+  // |audio_processing| may be null for servers, which don't capture audio,
+  // in which case the audio options that configure it are ignored.
   WebRtcVoiceEngine(
       webrtc::AudioDeviceModule* adm,
       const rtc::scoped_refptr<webrtc::AudioEncoderFactory>& encoder_factory,
@@ -91,6 +95,8 @@ class WebRtcVoiceEngine final {
   void StartAecDump(const std::string& filename);
   int CreateVoEChannel();
 
+  // Created on first use by low_priority_worker_queue().
+  rtc::TaskQueue* low_priority_worker_queue();
   std::unique_ptr<rtc::TaskQueue> low_priority_worker_queue_;
 
   webrtc::AudioDeviceModule* adm();
@@ -198,14 +204,18 @@ class WebRtcVoiceMediaChannel final : public VoiceMediaChannel,
   bool SendRtp(const uint8_t* data,
                size_t len,
                const webrtc::PacketOptions& options) override {
-    rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
+    rtc::CopyOnWriteBuffer packet =
+        rtc::PacketBufferAllocator::Allocate(std::max(len, kMaxRtpPacketLen));
+    packet.SetData(data, len);
     rtc::PacketOptions rtc_options;
     rtc_options.packet_id = options.packet_id;
     return VoiceMediaChannel::SendPacket(&packet, rtc_options);
   }
 
   bool SendRtcp(const uint8_t* data, size_t len) override {
-    rtc::CopyOnWriteBuffer packet(data, len, kMaxRtpPacketLen);
+    rtc::CopyOnWriteBuffer packet =
+        rtc::PacketBufferAllocator::Allocate(std::max(len, kMaxRtpPacketLen));
+    packet.SetData(data, len);
     rtc::PacketOptions rtc_options;
     return VoiceMediaChannel::SendRtcp(&packet, rtc_options);
   }
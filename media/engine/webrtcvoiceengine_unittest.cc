@@ -547,6 +547,8 @@ class WebRtcVoiceEngineTestFake : public testing::Test {
     stats.ana_statistics.frame_length_increase_counter = 765;
     stats.ana_statistics.frame_length_decrease_counter = 876;
     stats.ana_statistics.uplink_packet_loss_fraction = 987.0;
+    stats.ana_statistics.complexity_action_counter = 198;
+    stats.ana_statistics.complexity = 7;
     stats.typing_noise_detected = true;
     return stats;
   }
@@ -595,6 +597,10 @@ class WebRtcVoiceEngineTestFake : public testing::Test {
               stats.ana_statistics.frame_length_decrease_counter);
     EXPECT_EQ(info.ana_statistics.uplink_packet_loss_fraction,
               stats.ana_statistics.uplink_packet_loss_fraction);
+    EXPECT_EQ(info.ana_statistics.complexity_action_counter,
+              stats.ana_statistics.complexity_action_counter);
+    EXPECT_EQ(info.ana_statistics.complexity,
+              stats.ana_statistics.complexity);
     EXPECT_EQ(info.typing_noise_detected,
               stats.typing_noise_detected && is_sending);
   }
@@ -3351,6 +3357,27 @@ TEST(WebRtcVoiceEngineTest, StartupShutdown) {
   delete channel;
 }
 
+// Tests that the engine works without an APM, as servers run it.
+TEST(WebRtcVoiceEngineTest, StartupShutdownWithoutApm) {
+  testing::NiceMock<webrtc::test::MockAudioDeviceModule> adm;
+  cricket::WebRtcVoiceEngine engine(
+      &adm, webrtc::MockAudioEncoderFactory::CreateUnusedFactory(),
+      webrtc::MockAudioDecoderFactory::CreateUnusedFactory(), nullptr,
+      nullptr);
+  engine.Init();
+  webrtc::RtcEventLogNullImpl event_log;
+  std::unique_ptr<webrtc::Call> call(
+      webrtc::Call::Create(webrtc::Call::Config(&event_log)));
+  cricket::AudioOptions options;
+  options.echo_cancellation = true;
+  options.noise_suppression = true;
+  cricket::VoiceMediaChannel* channel =
+      engine.CreateChannel(call.get(), cricket::MediaConfig(), options);
+  EXPECT_TRUE(channel != nullptr);
+  EXPECT_FALSE(engine.StartAecDump(rtc::kInvalidPlatformFileValue, -1));
+  delete channel;
+}
+
 // Tests that reference counting on the external ADM is correct.
 TEST(WebRtcVoiceEngineTest, StartupShutdownWithExternalADM) {
   testing::NiceMock<webrtc::test::MockAudioDeviceModule> adm;
@@ -0,0 +1,288 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/sctp/datagramtransport.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "p2p/base/dtlstransportinternal.h"  // For PF_NORMAL
+#include "rtc_base/byteorder.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/thread_checker.h"
+#include "rtc_base/trace_event.h"
+
+namespace cricket {
+
+namespace {
+
+// Every datagram starts with a header of
+//   type (1 byte) | sid (2 bytes) | sequence number (2 bytes)
+// followed by the message payload. Data messages use the DataMessageType
+// values as type.
+constexpr size_t kHeaderSize = 5;
+// The type of a datagram that closes a stream. It has no payload.
+constexpr uint8_t kStreamResetType = 0xff;
+// The same as the largest SCTP packet in SctpTransport.
+constexpr size_t kMaxDatagramSize = 1200;
+
+bool IsDataMessageType(uint8_t type) {
+  return type == DMT_CONTROL || type == DMT_BINARY || type == DMT_TEXT;
+}
+
+}  // namespace
+
+const size_t DatagramTransport::kMaxMessageSize =
+    kMaxDatagramSize - kHeaderSize;
+
+DatagramTransport::DatagramTransport(rtc::Thread* network_thread,
+                                     rtc::PacketTransportInternal* transport)
+    : network_thread_(network_thread), transport_(transport) {
+  RTC_DCHECK(network_thread_);
+  RTC_DCHECK(transport_);
+  RTC_DCHECK_RUN_ON(network_thread_);
+  ConnectTransportSignals();
+}
+
+DatagramTransport::~DatagramTransport() {}
+
+void DatagramTransport::SetDtlsTransport(
+    rtc::PacketTransportInternal* transport) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  DisconnectTransportSignals();
+  transport_ = transport;
+  send_blocked_ = false;
+  ConnectTransportSignals();
+  UpdateReadyToSendData();
+}
+
+bool DatagramTransport::Start(int local_port, int remote_port) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  started_ = true;
+  UpdateReadyToSendData();
+  return true;
+}
+
+bool DatagramTransport::OpenStream(int sid) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (sid < kMinSctpSid || sid > kMaxSctpSid) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->OpenStream(...): "
+                        << "Not adding data stream "
+                        << "with sid=" << sid << " because sid is invalid.";
+    return false;
+  }
+  if (!open_streams_.insert(sid).second) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->OpenStream(...): "
+                        << "Not adding data stream "
+                        << "with sid=" << sid
+                        << " because stream is already open.";
+    return false;
+  }
+  next_seq_nums_[sid] = 0;
+  return true;
+}
+
+bool DatagramTransport::ResetStream(int sid) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (open_streams_.erase(sid) == 0) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->ResetStream(" << sid << "): "
+                        << "stream not found.";
+    return false;
+  }
+  next_seq_nums_.erase(sid);
+  // Best effort; if the datagram is lost, the remote stream stays open until
+  // the remote side closes it as well.
+  SendDatagram(kStreamResetType, sid, rtc::CopyOnWriteBuffer(), nullptr);
+  return true;
+}
+
+bool DatagramTransport::SendData(const SendDataParams& params,
+                                 const rtc::CopyOnWriteBuffer& payload,
+                                 SendDataResult* result) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (result) {
+    *result = SDR_ERROR;
+  }
+  if (!started_) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->SendData(...): "
+                        << "Not sending packet with sid=" << params.sid
+                        << " len=" << payload.size() << " before Start().";
+    return false;
+  }
+  if (params.type != DMT_CONTROL &&
+      open_streams_.find(params.sid) == open_streams_.end()) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->SendData(...): "
+                        << "Not sending data because sid is unknown: "
+                        << params.sid;
+    return false;
+  }
+  if (!IsDataMessageType(params.type)) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->SendData(...): "
+                        << "Not sending data with unknown type: "
+                        << params.type;
+    return false;
+  }
+  if (payload.size() > kMaxMessageSize) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->SendData(...): "
+                        << "Not sending message of " << payload.size()
+                        << " bytes, larger than the max of "
+                        << kMaxMessageSize;
+    return false;
+  }
+  return SendDatagram(static_cast<uint8_t>(params.type), params.sid, payload,
+                      result);
+}
+
+bool DatagramTransport::ReadyToSendData() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  return ready_to_send_data_;
+}
+
+void DatagramTransport::ConnectTransportSignals() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!transport_) {
+    return;
+  }
+  transport_->SignalWritableState.connect(this,
+                                          &DatagramTransport::OnWritableState);
+  transport_->SignalReadyToSend.connect(this,
+                                        &DatagramTransport::OnReadyToSend);
+  transport_->SignalReadPacket.connect(this, &DatagramTransport::OnPacketRead);
+}
+
+void DatagramTransport::DisconnectTransportSignals() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  if (!transport_) {
+    return;
+  }
+  transport_->SignalWritableState.disconnect(this);
+  transport_->SignalReadyToSend.disconnect(this);
+  transport_->SignalReadPacket.disconnect(this);
+}
+
+bool DatagramTransport::SendDatagram(uint8_t type,
+                                     int sid,
+                                     const rtc::CopyOnWriteBuffer& payload,
+                                     SendDataResult* result) {
+  if (!ready_to_send_data_) {
+    if (result) {
+      *result = SDR_BLOCK;
+    }
+    return false;
+  }
+  TRACE_EVENT0("webrtc", "DatagramTransport::SendDatagram");
+
+  uint16_t seq_num = 0;
+  auto it = next_seq_nums_.find(sid);
+  if (it != next_seq_nums_.end()) {
+    seq_num = it->second;
+  }
+  rtc::CopyOnWriteBuffer datagram(kHeaderSize + payload.size());
+  uint8_t* data = datagram.data();
+  data[0] = type;
+  rtc::SetBE16(data + 1, static_cast<uint16_t>(sid));
+  rtc::SetBE16(data + 3, seq_num);
+  if (payload.size() > 0) {
+    memcpy(data + kHeaderSize, payload.cdata(), payload.size());
+  }
+
+  int sent = transport_->SendPacket(datagram.data<char>(), datagram.size(),
+                                    rtc::PacketOptions(), PF_NORMAL);
+  if (sent < 0) {
+    if (transport_->GetError() == EWOULDBLOCK) {
+      send_blocked_ = true;
+      ready_to_send_data_ = false;
+      if (result) {
+        *result = SDR_BLOCK;
+      }
+    } else {
+      RTC_LOG(LS_WARNING) << debug_name_ << "->SendDatagram(...): "
+                          << "Failed to send datagram, error "
+                          << transport_->GetError();
+    }
+    return false;
+  }
+  if (it != next_seq_nums_.end()) {
+    ++it->second;
+  }
+  if (result) {
+    *result = SDR_SUCCESS;
+  }
+  return true;
+}
+
+void DatagramTransport::UpdateReadyToSendData() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  bool ready = started_ && transport_ && transport_->writable() &&
+               !send_blocked_;
+  if (ready == ready_to_send_data_) {
+    return;
+  }
+  ready_to_send_data_ = ready;
+  if (ready_to_send_data_) {
+    SignalReadyToSendData();
+  }
+}
+
+void DatagramTransport::OnWritableState(
+    rtc::PacketTransportInternal* transport) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK_EQ(transport_, transport);
+  UpdateReadyToSendData();
+}
+
+void DatagramTransport::OnReadyToSend(rtc::PacketTransportInternal* transport) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK_EQ(transport_, transport);
+  send_blocked_ = false;
+  UpdateReadyToSendData();
+}
+
+void DatagramTransport::OnPacketRead(rtc::PacketTransportInternal* transport,
+                                     const char* data,
+                                     size_t len,
+                                     const rtc::PacketTime& packet_time,
+                                     int flags) {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  RTC_DCHECK_EQ(transport_, transport);
+  TRACE_EVENT0("webrtc", "DatagramTransport::OnPacketRead");
+  if (flags & PF_SRTP_BYPASS) {
+    // We are only interested in datagrams sent by a DatagramTransport.
+    return;
+  }
+  if (!started_ || len < kHeaderSize) {
+    return;
+  }
+
+  const uint8_t type = static_cast<uint8_t>(data[0]);
+  const int sid = rtc::GetBE16(data + 1);
+  if (type == kStreamResetType) {
+    if (open_streams_.find(sid) != open_streams_.end()) {
+      SignalStreamClosedRemotely(sid);
+    }
+    return;
+  }
+  if (!IsDataMessageType(type)) {
+    RTC_LOG(LS_WARNING) << debug_name_ << "->OnPacketRead(...): "
+                        << "Dropping datagram with unknown type "
+                        << static_cast<int>(type);
+    return;
+  }
+  ReceiveDataParams params;
+  params.sid = sid;
+  params.seq_num = rtc::GetBE16(data + 3);
+  params.type = static_cast<DataMessageType>(type);
+  SignalDataReceived(params,
+                     rtc::CopyOnWriteBuffer(data + kHeaderSize,
+                                            len - kHeaderSize));
+}
+
+}  // namespace cricket
@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MEDIA_SCTP_DATAGRAMTRANSPORT_H_
+#define MEDIA_SCTP_DATAGRAMTRANSPORT_H_
+
+#include <map>
+#include <memory>
+#include <set>
+
+#include "media/sctp/sctptransportinternal.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/sigslot.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+// An alternative to SctpTransport for real-time data such as game input, for
+// which a late message is as useless as a lost one. Each message is sent as a
+// single datagram on the DTLS transport, without retransmissions, ordering or
+// congestion control, so no message waits behind a lost one or behind a full
+// congestion window. A message that is lost is not recovered.
+//
+// Both endpoints have to use a DatagramTransport; nothing about it is
+// negotiated in SDP. Since the OPEN handshake of a data channel isn't reliable
+// either, the data channels should be negotiated by the application. Messages
+// larger than |kMaxMessageSize| can't be sent.
+class DatagramTransport : public SctpTransportInternal,
+                          public sigslot::has_slots<> {
+ public:
+  // The largest payload that fits in a datagram with the same size as the
+  // largest SCTP packet.
+  static const size_t kMaxMessageSize;
+
+  // |network_thread| is the only thread on which public methods can be called.
+  // |transport| is required (must not be null).
+  DatagramTransport(rtc::Thread* network_thread,
+                    rtc::PacketTransportInternal* transport);
+  ~DatagramTransport() override;
+
+  // SctpTransportInternal overrides (see sctptransportinternal.h for comments).
+  // The ports are not used.
+  void SetDtlsTransport(rtc::PacketTransportInternal* transport) override;
+  bool Start(int local_port, int remote_port) override;
+  bool OpenStream(int sid) override;
+  bool ResetStream(int sid) override;
+  bool SendData(const SendDataParams& params,
+                const rtc::CopyOnWriteBuffer& payload,
+                SendDataResult* result = nullptr) override;
+  bool ReadyToSendData() override;
+  void set_debug_name_for_testing(const char* debug_name) override {
+    debug_name_ = debug_name;
+  }
+
+ private:
+  void ConnectTransportSignals();
+  void DisconnectTransportSignals();
+
+  // Sends a datagram with the given header fields and |payload|.
+  bool SendDatagram(uint8_t type,
+                    int sid,
+                    const rtc::CopyOnWriteBuffer& payload,
+                    SendDataResult* result);
+  // Updates |ready_to_send_data_| and fires SignalReadyToSendData if it became
+  // true.
+  void UpdateReadyToSendData();
+
+  // Callbacks from the DTLS transport.
+  void OnWritableState(rtc::PacketTransportInternal* transport);
+  void OnReadyToSend(rtc::PacketTransportInternal* transport);
+  void OnPacketRead(rtc::PacketTransportInternal* transport,
+                    const char* data,
+                    size_t len,
+                    const rtc::PacketTime& packet_time,
+                    int flags);
+
+  rtc::Thread* const network_thread_;
+  rtc::PacketTransportInternal* transport_ = nullptr;
+  bool started_ = false;
+  // Set when sending a datagram would block, until the DTLS transport is
+  // ready to send again.
+  bool send_blocked_ = false;
+  bool ready_to_send_data_ = false;
+  std::set<int> open_streams_;
+  // The sequence number of the next message sent on each stream.
+  std::map<int, uint16_t> next_seq_nums_;
+  const char* debug_name_ = "DatagramTransport";
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DatagramTransport);
+};
+
+class DatagramTransportFactory : public SctpTransportInternalFactory {
+ public:
+  explicit DatagramTransportFactory(rtc::Thread* network_thread)
+      : network_thread_(network_thread) {}
+
+  std::unique_ptr<SctpTransportInternal> CreateSctpTransport(
+      rtc::PacketTransportInternal* transport) override {
+    return std::unique_ptr<SctpTransportInternal>(
+        new DatagramTransport(network_thread_, transport));
+  }
+
+ private:
+  rtc::Thread* network_thread_;
+};
+
+}  // namespace cricket
+
+#endif  // MEDIA_SCTP_DATAGRAMTRANSPORT_H_
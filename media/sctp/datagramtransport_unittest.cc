@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "media/sctp/datagramtransport.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "p2p/base/fakedtlstransport.h"
+#include "rtc_base/gunit.h"
+
+namespace cricket {
+
+namespace {
+
+class DataReceiver : public sigslot::has_slots<> {
+ public:
+  void OnDataReceived(const ReceiveDataParams& params,
+                      const rtc::CopyOnWriteBuffer& data) {
+    params_.push_back(params);
+    data_.push_back(std::string(data.data<char>(), data.size()));
+  }
+  void OnStreamClosedRemotely(int sid) { closed_sids_.push_back(sid); }
+  void OnReadyToSendData() { ++ready_to_send_count_; }
+
+  const std::vector<ReceiveDataParams>& params() const { return params_; }
+  const std::vector<std::string>& data() const { return data_; }
+  const std::vector<int>& closed_sids() const { return closed_sids_; }
+  int ready_to_send_count() const { return ready_to_send_count_; }
+
+ private:
+  std::vector<ReceiveDataParams> params_;
+  std::vector<std::string> data_;
+  std::vector<int> closed_sids_;
+  int ready_to_send_count_ = 0;
+};
+
+}  // namespace
+
+class DatagramTransportTest : public testing::Test {
+ protected:
+  DatagramTransportTest()
+      : fake_dtls1_("fake dtls 1", 0),
+        fake_dtls2_("fake dtls 2", 0),
+        transport1_(rtc::Thread::Current(), &fake_dtls1_),
+        transport2_(rtc::Thread::Current(), &fake_dtls2_) {
+    Connect(&transport1_, &receiver1_);
+    Connect(&transport2_, &receiver2_);
+  }
+
+  void Connect(DatagramTransport* transport, DataReceiver* receiver) {
+    transport->SignalDataReceived.connect(receiver,
+                                          &DataReceiver::OnDataReceived);
+    transport->SignalStreamClosedRemotely.connect(
+        receiver, &DataReceiver::OnStreamClosedRemotely);
+    transport->SignalReadyToSendData.connect(receiver,
+                                             &DataReceiver::OnReadyToSendData);
+  }
+
+  void StartConnectedTransports() {
+    fake_dtls1_.SetDestination(&fake_dtls2_, false);
+    transport1_.Start(kSctpDefaultPort, kSctpDefaultPort);
+    transport2_.Start(kSctpDefaultPort, kSctpDefaultPort);
+    ASSERT_TRUE(transport1_.OpenStream(1));
+    ASSERT_TRUE(transport2_.OpenStream(1));
+  }
+
+  bool SendData(DatagramTransport* transport,
+                int sid,
+                const std::string& message,
+                SendDataResult* result) {
+    SendDataParams params;
+    params.sid = sid;
+    params.type = DMT_TEXT;
+    return transport->SendData(
+        params, rtc::CopyOnWriteBuffer(message.data(), message.size()), result);
+  }
+
+  FakeDtlsTransport fake_dtls1_;
+  FakeDtlsTransport fake_dtls2_;
+  DataReceiver receiver1_;
+  DataReceiver receiver2_;
+  DatagramTransport transport1_;
+  DatagramTransport transport2_;
+};
+
+TEST_F(DatagramTransportTest, ReadyToSendWhenStartedAndWritable) {
+  transport1_.Start(kSctpDefaultPort, kSctpDefaultPort);
+  EXPECT_FALSE(transport1_.ReadyToSendData());
+  EXPECT_EQ(0, receiver1_.ready_to_send_count());
+
+  fake_dtls1_.SetDestination(&fake_dtls2_, false);
+  EXPECT_TRUE(transport1_.ReadyToSendData());
+  EXPECT_EQ(1, receiver1_.ready_to_send_count());
+
+  fake_dtls1_.SetWritable(false);
+  EXPECT_FALSE(transport1_.ReadyToSendData());
+  SendDataResult result;
+  ASSERT_TRUE(transport1_.OpenStream(1));
+  EXPECT_FALSE(SendData(&transport1_, 1, "hello", &result));
+  EXPECT_EQ(SDR_BLOCK, result);
+}
+
+TEST_F(DatagramTransportTest, SendsDataInBothDirections) {
+  StartConnectedTransports();
+  SendDataResult result;
+  ASSERT_TRUE(SendData(&transport1_, 1, "hello", &result));
+  EXPECT_EQ(SDR_SUCCESS, result);
+  ASSERT_TRUE(SendData(&transport1_, 1, "again", &result));
+  ASSERT_EQ(2u, receiver2_.data().size());
+  EXPECT_EQ("hello", receiver2_.data()[0]);
+  EXPECT_EQ("again", receiver2_.data()[1]);
+  EXPECT_EQ(1, receiver2_.params()[1].sid);
+  EXPECT_EQ(DMT_TEXT, receiver2_.params()[1].type);
+  EXPECT_EQ(1, receiver2_.params()[1].seq_num);
+
+  ASSERT_TRUE(SendData(&transport2_, 1, "hi", &result));
+  ASSERT_EQ(1u, receiver1_.data().size());
+  EXPECT_EQ("hi", receiver1_.data()[0]);
+}
+
+TEST_F(DatagramTransportTest, RejectsUnknownStreamsAndLargeMessages) {
+  StartConnectedTransports();
+  SendDataResult result;
+  EXPECT_FALSE(SendData(&transport1_, 2, "hello", &result));
+  EXPECT_EQ(SDR_ERROR, result);
+
+  const std::string largest_message(DatagramTransport::kMaxMessageSize, 'a');
+  EXPECT_TRUE(SendData(&transport1_, 1, largest_message, &result));
+  EXPECT_FALSE(SendData(&transport1_, 1, largest_message + "a", &result));
+  EXPECT_EQ(SDR_ERROR, result);
+  EXPECT_EQ(1u, receiver2_.data().size());
+}
+
+TEST_F(DatagramTransportTest, ResetStreamClosesRemoteStream) {
+  StartConnectedTransports();
+  EXPECT_TRUE(transport1_.ResetStream(1));
+  EXPECT_FALSE(transport1_.ResetStream(1));
+  EXPECT_EQ(std::vector<int>({1}), receiver2_.closed_sids());
+
+  SendDataResult result;
+  EXPECT_FALSE(SendData(&transport1_, 1, "hello", &result));
+  // The stream can be reopened.
+  EXPECT_TRUE(transport1_.OpenStream(1));
+}
+
+}  // namespace cricket
@@ -317,13 +317,22 @@ class SctpTransport::UsrSctpWrapper {
                         << "; set_df: " << rtc::ToHex(set_df);
 
     VerboseLogPacket(data, length, SCTP_DUMP_OUTBOUND);
-    // Note: We have to copy the data; the caller will delete it.
-    rtc::CopyOnWriteBuffer buf(reinterpret_cast<uint8_t*>(data), length);
-    // TODO(deadbeef): Why do we need an AsyncInvoke here? We're already on the
-    // right thread and don't need to unwind the stack.
-    transport->invoker_.AsyncInvoke<void>(
-        RTC_FROM_HERE, transport->network_thread_,
-        rtc::Bind(&SctpTransport::OnPacketFromSctpToNetwork, transport, buf));
+    // Note: We have to copy the data; the caller will delete it. Only the
+    // first of the queued packets posts a task; it sends all of them.
+    bool post_task;
+    {
+      rtc::CritScope cs(&transport->outbound_packets_lock_);
+      post_task = transport->outbound_packets_.empty();
+      transport->outbound_packets_.emplace_back(
+          reinterpret_cast<uint8_t*>(data), length);
+    }
+    // The task is posted even when on the network thread, since usrsctp holds
+    // locks while calling this callback.
+    if (post_task) {
+      transport->invoker_.AsyncInvoke<void>(
+          RTC_FROM_HERE, transport->network_thread_,
+          rtc::Bind(&SctpTransport::SendOutboundPackets, transport));
+    }
     return 0;
   }
 
@@ -407,7 +416,13 @@ class SctpTransport::UsrSctpWrapper {
 
 SctpTransport::SctpTransport(rtc::Thread* network_thread,
                              rtc::PacketTransportInternal* transport)
+    : SctpTransport(network_thread, transport, SctpTransportConfig()) {}
+
+SctpTransport::SctpTransport(rtc::Thread* network_thread,
+                             rtc::PacketTransportInternal* transport,
+                             const SctpTransportConfig& config)
     : network_thread_(network_thread),
+      config_(config),
       transport_(transport),
       was_ever_writable_(transport->writable()) {
   RTC_DCHECK(network_thread_);
@@ -684,11 +699,15 @@ bool SctpTransport::OpenSctpSocket() {
   // If kSendBufferSize isn't reflective of reality, we log an error, but we
   // still have to do something reasonable here.  Look up what the buffer's
   // real size is and set our threshold to something reasonable.
-  static const int kSendThreshold = usrsctp_sysctl_get_sctp_sendspace() / 2;
+  static const int kDefaultSendThreshold =
+      usrsctp_sysctl_get_sctp_sendspace() / 2;
+  const int send_threshold = config_.send_buffer_size
+                                 ? *config_.send_buffer_size / 2
+                                 : kDefaultSendThreshold;
 
   sock_ = usrsctp_socket(
       AF_CONN, SOCK_STREAM, IPPROTO_SCTP, &UsrSctpWrapper::OnSctpInboundPacket,
-      &UsrSctpWrapper::SendThresholdCallback, kSendThreshold, this);
+      &UsrSctpWrapper::SendThresholdCallback, send_threshold, this);
   if (!sock_) {
     RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->OpenSctpSocket(): "
                             << "Failed to create SCTP socket.";
@@ -753,6 +772,52 @@ bool SctpTransport::ConfigureSctpSocket() {
     return false;
   }
 
+  // Buffer sizes. These have to be set before connecting, since the receive
+  // buffer determines the initial receiver window.
+  if (config_.send_buffer_size) {
+    int send_buffer_size = *config_.send_buffer_size;
+    if (usrsctp_setsockopt(sock_, SOL_SOCKET, SO_SNDBUF, &send_buffer_size,
+                           sizeof(send_buffer_size))) {
+      RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                              << "Failed to set SO_SNDBUF.";
+      return false;
+    }
+  }
+  if (config_.receive_buffer_size) {
+    int receive_buffer_size = *config_.receive_buffer_size;
+    if (usrsctp_setsockopt(sock_, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size,
+                           sizeof(receive_buffer_size))) {
+      RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                              << "Failed to set SO_RCVBUF.";
+      return false;
+    }
+  }
+
+  // I-DATA support, which usrsctp requires fragment interleave level 2 for.
+  if (config_.enable_message_interleaving) {
+#if defined(SCTP_INTERLEAVING_SUPPORTED)
+    int interleave_level = 2;
+    if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_FRAGMENT_INTERLEAVE,
+                           &interleave_level, sizeof(interleave_level))) {
+      RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                              << "Failed to set SCTP_FRAGMENT_INTERLEAVE.";
+      return false;
+    }
+    struct sctp_assoc_value interleaving;
+    interleaving.assoc_id = SCTP_FUTURE_ASSOC;
+    interleaving.assoc_value = 1;
+    if (usrsctp_setsockopt(sock_, IPPROTO_SCTP, SCTP_INTERLEAVING_SUPPORTED,
+                           &interleaving, sizeof(interleaving))) {
+      RTC_LOG_ERRNO(LS_ERROR) << debug_name_ << "->ConfigureSctpSocket(): "
+                              << "Failed to set SCTP_INTERLEAVING_SUPPORTED.";
+      return false;
+    }
+#else
+    RTC_LOG(LS_WARNING) << debug_name_ << "->ConfigureSctpSocket(): "
+                        << "Message interleaving isn't supported by usrsctp.";
+#endif
+  }
+
   // Subscribe to SCTP event notifications.
   int event_types[] = {SCTP_ASSOC_CHANGE, SCTP_PEER_ADDR_CHANGE,
                        SCTP_SEND_FAILED_EVENT, SCTP_SENDER_DRY_EVENT,
@@ -902,6 +967,18 @@ sockaddr_conn SctpTransport::GetSctpSockAddr(int port) {
   return sconn;
 }
 
+void SctpTransport::SendOutboundPackets() {
+  RTC_DCHECK_RUN_ON(network_thread_);
+  std::vector<rtc::CopyOnWriteBuffer> packets;
+  {
+    rtc::CritScope cs(&outbound_packets_lock_);
+    packets.swap(outbound_packets_);
+  }
+  for (const rtc::CopyOnWriteBuffer& packet : packets) {
+    OnPacketFromSctpToNetwork(packet);
+  }
+}
+
 void SctpTransport::OnPacketFromSctpToNetwork(
     const rtc::CopyOnWriteBuffer& buffer) {
   RTC_DCHECK_RUN_ON(network_thread_);
@@ -18,11 +18,14 @@
 #include <string>
 #include <vector>
 
+#include "api/optional.h"
 #include "rtc_base/asyncinvoker.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/sigslot.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/thread_annotations.h"
 // For SendDataParams/ReceiveDataParams.
 #include "media/base/mediachannel.h"
 #include "media/sctp/sctptransportinternal.h"
@@ -58,6 +61,21 @@ struct SctpInboundPacket;
 //  12. SctpTransport::SignalDataReceived(data)
 // [from the same thread, methods registered/connected to
 //  SctpTransport are called with the recieved data]
+// Socket options of an SctpTransport, for applications that use data channels
+// for bulk transfers.
+struct SctpTransportConfig {
+  // Sizes of the SCTP socket send and receive buffers, in bytes. The send
+  // buffer bounds the data queued before SendData returns SDR_BLOCK, and the
+  // receive buffer bounds the receiver window advertised to the peer. Unset
+  // means the usrsctp default of 256kB.
+  rtc::Optional<int> send_buffer_size;
+  rtc::Optional<int> receive_buffer_size;
+  // Whether to negotiate user message interleaving (I-DATA chunks, RFC 8260),
+  // so that a large message doesn't delay the messages of other streams until
+  // it has been sent completely. Only used if the peer supports it too.
+  bool enable_message_interleaving = false;
+};
+
 // TODO(zhihuang): Rename "channel" to "transport" on network-level.
 class SctpTransport : public SctpTransportInternal,
                       public sigslot::has_slots<> {
@@ -68,6 +86,9 @@ class SctpTransport : public SctpTransportInternal,
   // |channel| is required (must not be null).
   SctpTransport(rtc::Thread* network_thread,
                 rtc::PacketTransportInternal* channel);
+  SctpTransport(rtc::Thread* network_thread,
+                rtc::PacketTransportInternal* channel,
+                const SctpTransportConfig& config);
   ~SctpTransport() override;
 
   // SctpTransportInternal overrides (see sctptransportinternal.h for comments).
@@ -119,7 +140,9 @@ class SctpTransport : public SctpTransportInternal,
   void OnSendThresholdCallback();
   sockaddr_conn GetSctpSockAddr(int port);
 
-  // Called using |invoker_| to send packet on the network.
+  // Called using |invoker_| to send the packets in |outbound_packets_| on the
+  // network.
+  void SendOutboundPackets();
   void OnPacketFromSctpToNetwork(const rtc::CopyOnWriteBuffer& buffer);
   // Called using |invoker_| to decide what to do with the packet.
   // The |flags| parameter is used by SCTP to distinguish notification packets
@@ -139,6 +162,14 @@ class SctpTransport : public SctpTransportInternal,
   rtc::Thread* network_thread_;
   // Helps pass inbound/outbound packets asynchronously to the network thread.
   rtc::AsyncInvoker invoker_;
+  const SctpTransportConfig config_;
+  // The packets created by usrsctp that haven't been sent on the network yet.
+  // usrsctp may create several packets at once, e.g. for a large message, and
+  // they are sent by a single task on the network thread. Guarded by a lock
+  // since usrsctp also creates packets on its timer thread.
+  rtc::CriticalSection outbound_packets_lock_;
+  std::vector<rtc::CopyOnWriteBuffer> outbound_packets_
+      RTC_GUARDED_BY(outbound_packets_lock_);
   // Underlying DTLS channel.
   rtc::PacketTransportInternal* transport_ = nullptr;
   bool was_ever_writable_ = false;
@@ -176,15 +207,19 @@ class SctpTransportFactory : public SctpTransportInternalFactory {
  public:
   explicit SctpTransportFactory(rtc::Thread* network_thread)
       : network_thread_(network_thread) {}
+  SctpTransportFactory(rtc::Thread* network_thread,
+                       const SctpTransportConfig& config)
+      : network_thread_(network_thread), config_(config) {}
 
   std::unique_ptr<SctpTransportInternal> CreateSctpTransport(
       rtc::PacketTransportInternal* transport) override {
     return std::unique_ptr<SctpTransportInternal>(
-        new SctpTransport(network_thread_, transport));
+        new SctpTransport(network_thread_, transport, config_));
   }
 
  private:
   rtc::Thread* network_thread_;
+  const SctpTransportConfig config_;
 };
 
 }  // namespace cricket
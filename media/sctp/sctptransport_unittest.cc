@@ -12,6 +12,7 @@
 #include <stdarg.h>
 #include <stdio.h>
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "rtc_base/helpers.h"
 #include "rtc_base/ssladapter.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
 
 namespace {
 static const int kDefaultTimeout = 10000;  // 10 seconds.
@@ -53,16 +55,19 @@ class SctpFakeDataReceiver : public sigslot::has_slots<> {
   void OnDataReceived(const ReceiveDataParams& params,
                       const rtc::CopyOnWriteBuffer& data) {
     received_ = true;
+    bytes_received_ += data.size();
     last_data_ = std::string(data.data<char>(), data.size());
     last_params_ = params;
   }
 
   bool received() const { return received_; }
+  size_t bytes_received() const { return bytes_received_; }
   std::string last_data() const { return last_data_; }
   ReceiveDataParams last_params() const { return last_params_; }
 
  private:
   bool received_;
+  size_t bytes_received_ = 0;
   std::string last_data_;
   ReceiveDataParams last_params_;
 };
@@ -172,7 +177,7 @@ class SctpTransportTest : public testing::Test, public sigslot::has_slots<> {
   SctpTransport* CreateTransport(FakeDtlsTransport* fake_dtls,
                                  SctpFakeDataReceiver* recv) {
     SctpTransport* transport =
-        new SctpTransport(rtc::Thread::Current(), fake_dtls);
+        new SctpTransport(rtc::Thread::Current(), fake_dtls, config_);
     // When data is received, pass it to the SctpFakeDataReceiver.
     transport->SignalDataReceived.connect(
         recv, &SctpFakeDataReceiver::OnDataReceived);
@@ -208,6 +213,9 @@ class SctpTransportTest : public testing::Test, public sigslot::has_slots<> {
     return !thread->IsQuitting();
   }
 
+  // Used by the transports created after the call.
+  void set_config(const SctpTransportConfig& config) { config_ = config; }
+
   SctpTransport* transport1() { return transport1_.get(); }
   SctpTransport* transport2() { return transport2_.get(); }
   SctpFakeDataReceiver* receiver1() { return recv1_.get(); }
@@ -229,6 +237,7 @@ class SctpTransportTest : public testing::Test, public sigslot::has_slots<> {
   std::unique_ptr<SctpFakeDataReceiver> recv2_;
   std::unique_ptr<SctpTransport> transport1_;
   std::unique_ptr<SctpTransport> transport2_;
+  SctpTransportConfig config_;
 
   int transport1_ready_to_send_count_ = 0;
   int transport2_ready_to_send_count_ = 0;
@@ -452,6 +461,49 @@ TEST_F(SctpTransportTest, SendDataBlocked) {
   EXPECT_EQ(SDR_BLOCK, result);
 }
 
+// Sends a large volume of data with larger buffers and message interleaving
+// enabled, waiting whenever SDR_BLOCK is returned, and logs the throughput
+// over the fake DTLS transports.
+TEST_F(SctpTransportTest, BulkTransferWithLargeBuffersAndInterleaving) {
+  SctpTransportConfig config;
+  config.send_buffer_size = 1024 * 1024;
+  config.receive_buffer_size = 1024 * 1024;
+  config.enable_message_interleaving = true;
+  set_config(config);
+  SetupConnectedTransportsWithTwoStreams();
+  EXPECT_EQ_WAIT(1, transport1_ready_to_send_count(), kDefaultTimeout);
+
+  static const int kMessageCount = 256;
+  static const size_t kMessageSize = 64 * 1024;
+  SendDataParams params;
+  params.sid = 1;
+  rtc::CopyOnWriteBuffer buffer(kMessageSize);
+  memset(buffer.data<uint8_t>(), 0, kMessageSize);
+  const int64_t start_ms = rtc::TimeMillis();
+  for (int i = 0; i < kMessageCount;) {
+    const int ready_to_send_count = transport1_ready_to_send_count();
+    SendDataResult result;
+    if (transport1()->SendData(params, buffer, &result)) {
+      ++i;
+      continue;
+    }
+    ASSERT_EQ(SDR_BLOCK, result);
+    ASSERT_TRUE_WAIT(transport1_ready_to_send_count() > ready_to_send_count,
+                     kDefaultTimeout);
+  }
+  // A small message on another stream is still delivered.
+  SendDataResult result;
+  ASSERT_TRUE(SendData(transport1(), 2, "small message", &result));
+  EXPECT_TRUE_WAIT(kMessageCount * kMessageSize + strlen("small message") ==
+                       receiver2()->bytes_received(),
+                   kDefaultTimeout);
+  const int64_t elapsed_ms = std::max<int64_t>(rtc::TimeSince(start_ms), 1);
+  RTC_LOG(LS_INFO) << "Transferred " << receiver2()->bytes_received()
+                   << " bytes in " << elapsed_ms << " ms ("
+                   << receiver2()->bytes_received() * 8 / elapsed_ms
+                   << " kbps).";
+}
+
 // Trying to send data for a nonexistent stream should fail.
 TEST_F(SctpTransportTest, SendDataWithNonexistentStreamFails) {
   SetupConnectedTransportsWithTwoStreams();
@@ -70,6 +70,8 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
 
   // Add 10 ms of raw (PCM) audio data to the encoder.
   int Add10MsData(const AudioFrame& audio_frame) override;
+  int Add10MsData(const AudioFrame& audio_frame,
+                  uint32_t input_timestamp) override;
 
   /////////////////////////////////////////
   // (RED) Redundant Coding
@@ -233,7 +235,9 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
       rtc::FunctionView<std::unique_ptr<AudioDecoder>()> isac_factory)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
-  int Add10MsDataInternal(const AudioFrame& audio_frame, InputData* input_data)
+  int Add10MsDataInternal(const AudioFrame& audio_frame,
+                          uint32_t input_timestamp,
+                          InputData* input_data)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
   int Encode(const InputData& input_data)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
@@ -247,15 +251,22 @@ class AudioCodingModuleImpl final : public AudioCodingModule {
   // required, before pushing audio into encoder's buffer.
   //
   // in_frame: input audio-frame
+  // in_timestamp: the timestamp of |in_frame|, which is used instead of
+  //               |in_frame.timestamp_|
   // ptr_out: pointer to output audio_frame. If no preprocessing is required
   //          |ptr_out| will be pointing to |in_frame|, otherwise pointing to
   //          |preprocess_frame_|.
+  // timestamp: the timestamp of the output audio in the codec's timeline,
+  //            which isn't that of |in_frame| once the input has been
+  //            resampled.
   //
   // Return value:
   //   -1: if encountering an error.
   //    0: otherwise.
   int PreprocessToAddData(const AudioFrame& in_frame,
-                          const AudioFrame** ptr_out)
+                          uint32_t in_timestamp,
+                          const AudioFrame** ptr_out,
+                          uint32_t* timestamp)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(acm_crit_sect_);
 
   // Change required states after starting to receive the codec corresponding
@@ -655,13 +666,19 @@ int AudioCodingModuleImpl::RegisterTransportCallback(
 
 // Add 10MS of raw (PCM) audio data to the encoder.
 int AudioCodingModuleImpl::Add10MsData(const AudioFrame& audio_frame) {
+  return Add10MsData(audio_frame, audio_frame.timestamp_);
+}
+
+int AudioCodingModuleImpl::Add10MsData(const AudioFrame& audio_frame,
+                                       uint32_t input_timestamp) {
   InputData input_data;
   rtc::CritScope lock(&acm_crit_sect_);
-  int r = Add10MsDataInternal(audio_frame, &input_data);
+  int r = Add10MsDataInternal(audio_frame, input_timestamp, &input_data);
   return r < 0 ? r : Encode(input_data);
 }
 
 int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
+                                               uint32_t input_timestamp,
                                                InputData* input_data) {
   if (audio_frame.samples_per_channel_ == 0) {
     assert(false);
@@ -694,11 +711,13 @@ int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
   }
 
   const AudioFrame* ptr_frame;
+  uint32_t timestamp;
   // Perform a resampling, also down-mix if it is required and can be
   // performed before resampling (a down mix prior to resampling will take
   // place if both primary and secondary encoders are mono and input is in
   // stereo).
-  if (PreprocessToAddData(audio_frame, &ptr_frame) < 0) {
+  if (PreprocessToAddData(audio_frame, input_timestamp, &ptr_frame,
+                          &timestamp) < 0) {
     return -1;
   }
 
@@ -726,7 +745,7 @@ int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
     ptr_audio = input_data->buffer;
 
   // TODO(yujo): Skip encode of muted frames.
-  input_data->input_timestamp = ptr_frame->timestamp_;
+  input_data->input_timestamp = timestamp;
   input_data->audio = ptr_audio;
   input_data->length_per_channel = ptr_frame->samples_per_channel_;
   input_data->audio_channel = current_num_channels;
@@ -741,7 +760,9 @@ int AudioCodingModuleImpl::Add10MsDataInternal(const AudioFrame& audio_frame,
 // is required, |*ptr_out| points to |in_frame|.
 // TODO(yujo): Make this more efficient for muted frames.
 int AudioCodingModuleImpl::PreprocessToAddData(const AudioFrame& in_frame,
-                                               const AudioFrame** ptr_out) {
+                                               uint32_t in_timestamp,
+                                               const AudioFrame** ptr_out,
+                                               uint32_t* timestamp) {
   const bool resample =
       in_frame.sample_rate_hz_ != encoder_stack_->SampleRateHz();
 
@@ -753,33 +774,27 @@ int AudioCodingModuleImpl::PreprocessToAddData(const AudioFrame& in_frame,
       in_frame.num_channels_ == 2 && encoder_stack_->NumChannels() == 1;
 
   if (!first_10ms_data_) {
-    expected_in_ts_ = in_frame.timestamp_;
-    expected_codec_ts_ = in_frame.timestamp_;
+    expected_in_ts_ = in_timestamp;
+    expected_codec_ts_ = in_timestamp;
     first_10ms_data_ = true;
-  } else if (in_frame.timestamp_ != expected_in_ts_) {
-    RTC_LOG(LS_WARNING) << "Unexpected input timestamp: " << in_frame.timestamp_
+  } else if (in_timestamp != expected_in_ts_) {
+    RTC_LOG(LS_WARNING) << "Unexpected input timestamp: " << in_timestamp
                         << ", expected: " << expected_in_ts_;
     expected_codec_ts_ +=
-        (in_frame.timestamp_ - expected_in_ts_) *
+        (in_timestamp - expected_in_ts_) *
         static_cast<uint32_t>(
             static_cast<double>(encoder_stack_->SampleRateHz()) /
             static_cast<double>(in_frame.sample_rate_hz_));
-    expected_in_ts_ = in_frame.timestamp_;
+    expected_in_ts_ = in_timestamp;
   }
 
 
+  *timestamp = expected_codec_ts_;
   if (!down_mix && !resample) {
-    // No pre-processing is required.
-    if (expected_in_ts_ == expected_codec_ts_) {
-      // If we've never resampled, we can use the input frame as-is
-      *ptr_out = &in_frame;
-    } else {
-      // Otherwise we'll need to alter the timestamp. Since in_frame is const,
-      // we'll have to make a copy of it.
-      preprocess_frame_.CopyFrom(in_frame);
-      preprocess_frame_.timestamp_ = expected_codec_ts_;
-      *ptr_out = &preprocess_frame_;
-    }
+    // No pre-processing is required. The input frame is used as-is, even if
+    // its timestamp isn't that of the codec's timeline, since the timestamp
+    // is passed on separately.
+    *ptr_out = &in_frame;
 
     expected_in_ts_ += static_cast<uint32_t>(in_frame.samples_per_channel_);
     expected_codec_ts_ += static_cast<uint32_t>(in_frame.samples_per_channel_);
@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_CODING_CODECS_OPUS_AUDIO_DECODER_OPUS_H_
 #define MODULES_AUDIO_CODING_CODECS_OPUS_AUDIO_DECODER_OPUS_H_
 
+#include <vector>
+
 #include "api/audio_codecs/audio_decoder.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
 #include "rtc_base/constructormagic.h"
@@ -20,6 +22,12 @@ namespace webrtc {
 class AudioDecoderOpusImpl final : public AudioDecoder {
  public:
   explicit AudioDecoderOpusImpl(size_t num_channels);
+  // Decodes Opus multistream packets of more than two channels, see
+  // AudioEncoderOpusConfig for the layout.
+  AudioDecoderOpusImpl(size_t num_channels,
+                       size_t num_streams,
+                       size_t coupled_streams,
+                       const std::vector<unsigned char>& channel_mapping);
   ~AudioDecoderOpusImpl() override;
 
   std::vector<ParseResult> ParsePayload(rtc::Buffer&& payload,
@@ -27,6 +27,7 @@
 #include "rtc_base/protobuf_utils.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/string_to_number.h"
+#include "rtc_base/stringencode.h"
 #include "rtc_base/timeutils.h"
 #include "system_wrappers/include/field_trial.h"
 
@@ -52,6 +53,12 @@ constexpr int kOpusBitrateFbBps = 32000;
 constexpr int kSampleRateHz = 48000;
 constexpr int kDefaultMaxPlaybackRate = 48000;
 
+// Payload name of Opus multistream, used for more than two channels.
+constexpr char kMultistreamPayloadName[] = "multiopus";
+
+// The lowest complexity used when adapting to the encoding time.
+constexpr int kMinAdaptedComplexity = 0;
+
 // These two lists must be sorted from low to high
 #if WEBRTC_OPUS_SUPPORT_120MS_PTIME
 constexpr int kANASupportedFrameLengths[] = {20, 60, 120};
@@ -131,8 +138,8 @@ int CalculateDefaultBitrate(int max_playback_rate, size_t num_channels) {
     }
   }();
   RTC_DCHECK_GE(bitrate, AudioEncoderOpusConfig::kMinBitrateBps);
-  RTC_DCHECK_LE(bitrate, AudioEncoderOpusConfig::kMaxBitrateBps);
-  return bitrate;
+  // Many channels may exceed the maximum bitrate.
+  return std::min(bitrate, AudioEncoderOpusConfig::kMaxBitrateBps);
 }
 
 // Get the maxaveragebitrate parameter in string-form, so we can properly figure
@@ -171,6 +178,32 @@ int GetChannelCount(const SdpAudioFormat& format) {
   }
 }
 
+// Reads the multistream layout of a "multiopus" format. Returns false if it is
+// missing or malformed.
+bool GetMultistreamLayout(const SdpAudioFormat& format,
+                          AudioEncoderOpusConfig* config) {
+  const auto num_streams = GetFormatParameter<size_t>(format, "num_streams");
+  const auto coupled_streams =
+      GetFormatParameter<size_t>(format, "coupled_streams");
+  const auto channel_mapping = GetFormatParameter(format, "channel_mapping");
+  if (!num_streams || !coupled_streams || !channel_mapping) {
+    return false;
+  }
+  std::vector<std::string> fields;
+  rtc::split(*channel_mapping, ',', &fields);
+  config->channel_mapping.clear();
+  for (const std::string& field : fields) {
+    const auto stream_channel = rtc::StringToNumber<unsigned char>(field);
+    if (!stream_channel) {
+      return false;
+    }
+    config->channel_mapping.push_back(*stream_channel);
+  }
+  config->num_streams = *num_streams;
+  config->coupled_streams = *coupled_streams;
+  return true;
+}
+
 int GetMaxPlaybackRate(const SdpAudioFormat& format) {
   const auto param = GetFormatParameter<int>(format, "maxplaybackrate");
   if (param && *param >= 8000) {
@@ -244,6 +277,13 @@ std::unique_ptr<AudioEncoder> AudioEncoderOpusImpl::MakeAudioEncoder(
 
 rtc::Optional<AudioCodecInfo> AudioEncoderOpusImpl::QueryAudioEncoder(
     const SdpAudioFormat& format) {
+  if (STR_CASE_CMP(format.name.c_str(), kMultistreamPayloadName) == 0) {
+    const auto config = SdpToConfig(format);
+    if (config) {
+      return QueryAudioEncoder(*config);
+    }
+    return rtc::nullopt;
+  }
   if (STR_CASE_CMP(format.name.c_str(), GetPayloadName()) == 0 &&
       format.clockrate_hz == 48000 && format.num_channels == 2) {
     const size_t num_channels = GetChannelCount(format);
@@ -276,13 +316,20 @@ AudioEncoderOpusConfig AudioEncoderOpusImpl::CreateConfig(
 
 rtc::Optional<AudioEncoderOpusConfig> AudioEncoderOpusImpl::SdpToConfig(
     const SdpAudioFormat& format) {
-  if (STR_CASE_CMP(format.name.c_str(), "opus") != 0 ||
-      format.clockrate_hz != 48000 || format.num_channels != 2) {
+  AudioEncoderOpusConfig config;
+  if (STR_CASE_CMP(format.name.c_str(), "opus") == 0 &&
+      format.clockrate_hz == 48000 && format.num_channels == 2) {
+    config.num_channels = GetChannelCount(format);
+  } else if (STR_CASE_CMP(format.name.c_str(), kMultistreamPayloadName) == 0 &&
+             format.clockrate_hz == 48000 && format.num_channels > 2) {
+    config.num_channels = format.num_channels;
+    if (!GetMultistreamLayout(format, &config)) {
+      return rtc::nullopt;
+    }
+  } else {
     return rtc::nullopt;
   }
 
-  AudioEncoderOpusConfig config;
-  config.num_channels = GetChannelCount(format);
   config.frame_size_ms = GetFrameSizeMs(format);
   config.max_playback_rate_hz = GetMaxPlaybackRate(format);
   config.fec_enabled = (GetFormatParameter(format, "useinbandfec") == "1");
@@ -309,7 +356,11 @@ rtc::Optional<AudioEncoderOpusConfig> AudioEncoderOpusImpl::SdpToConfig(
 
   FindSupportedFrameLengths(min_frame_length_ms, max_frame_length_ms,
                             &config.supported_frame_lengths_ms);
-  RTC_DCHECK(config.IsOk());
+  if (!config.IsOk()) {
+    // Only a multistream layout can be invalid.
+    RTC_DCHECK_GT(config.num_channels, 2);
+    return rtc::nullopt;
+  }
   return config;
 }
 
@@ -612,6 +663,8 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
                Num10msFramesPerPacket() * SamplesPer10msFrame());
 
   const size_t max_encoded_bytes = SufficientOutputBufferSize();
+  const int64_t encode_start_us =
+      complexity_controller_ ? rtc::TimeMicros() : 0;
   EncodedInfo info;
   info.encoded_bytes =
       encoded->AppendData(
@@ -629,6 +682,13 @@ AudioEncoder::EncodedInfo AudioEncoderOpusImpl::EncodeImpl(
           });
   input_buffer_.clear();
 
+  if (complexity_controller_ &&
+      complexity_controller_->Update(rtc::TimeMicros() - encode_start_us,
+                                     config_.frame_size_ms,
+                                     applied_complexity_)) {
+    MaybeUpdateComplexity();
+  }
+
   bool dtx_frame = (info.encoded_bytes <= 2);
 
   // Will use new packet size for next encoding.
@@ -687,12 +747,18 @@ bool AudioEncoderOpusImpl::RecreateEncoderInstance(
     RTC_CHECK_EQ(0, WebRtcOpus_EncoderFree(inst_));
   input_buffer_.clear();
   input_buffer_.reserve(Num10msFramesPerPacket() * SamplesPer10msFrame());
-  RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(
-                      &inst_, config.num_channels,
-                      config.application ==
-                              AudioEncoderOpusConfig::ApplicationMode::kVoip
-                          ? 0
-                          : 1));
+  const int32_t application =
+      config.application == AudioEncoderOpusConfig::ApplicationMode::kVoip ? 0
+                                                                           : 1;
+  if (config.num_channels > 2) {
+    RTC_CHECK_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+                        &inst_, config.num_channels, application,
+                        config.num_streams, config.coupled_streams,
+                        config.channel_mapping.data()));
+  } else {
+    RTC_CHECK_EQ(0, WebRtcOpus_EncoderCreate(&inst_, config.num_channels,
+                                             application));
+  }
   RTC_CHECK_EQ(0, WebRtcOpus_SetBitRate(inst_, GetBitrateBps(config)));
   if (config.fec_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableFec(inst_));
@@ -704,7 +770,19 @@ bool AudioEncoderOpusImpl::RecreateEncoderInstance(
   // Use the default complexity if the start bitrate is within the hysteresis
   // window.
   complexity_ = GetNewComplexity(config).value_or(config.complexity);
-  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity_));
+  if (config.max_encode_load && !complexity_controller_) {
+    // Created once, so that the limit survives the encoder being reset.
+    complexity_controller_.reset(new OpusComplexityController(
+        *config.max_encode_load, kMinAdaptedComplexity,
+        std::max(config.complexity, config.low_rate_complexity)));
+  } else if (!config.max_encode_load) {
+    complexity_controller_.reset();
+  }
+  applied_complexity_ =
+      complexity_controller_
+          ? std::min(complexity_, complexity_controller_->complexity_limit())
+          : complexity_;
+  RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, applied_complexity_));
   bitrate_changed_ = true;
   if (config.dtx_enabled) {
     RTC_CHECK_EQ(0, WebRtcOpus_EnableDtx(inst_));
@@ -733,6 +811,10 @@ void AudioEncoderOpusImpl::SetNumChannelsToEncode(
   RTC_DCHECK_GT(num_channels_to_encode, 0);
   RTC_DCHECK_LE(num_channels_to_encode, config_.num_channels);
 
+  // A multistream encoder can't be switched to mono or stereo.
+  if (config_.num_channels > 2)
+    return;
+
   if (num_channels_to_encode_ == num_channels_to_encode)
     return;
 
@@ -750,6 +832,17 @@ void AudioEncoderOpusImpl::SetProjectedPacketLossRate(float fraction) {
   }
 }
 
+void AudioEncoderOpusImpl::MaybeUpdateComplexity() {
+  const int complexity =
+      complexity_controller_
+          ? std::min(complexity_, complexity_controller_->complexity_limit())
+          : complexity_;
+  if (complexity != applied_complexity_) {
+    applied_complexity_ = complexity;
+    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, applied_complexity_));
+  }
+}
+
 void AudioEncoderOpusImpl::SetTargetBitrate(int bits_per_second) {
   config_.bitrate_bps = rtc::SafeClamp<int>(
       bits_per_second, AudioEncoderOpusConfig::kMinBitrateBps,
@@ -759,7 +852,7 @@ void AudioEncoderOpusImpl::SetTargetBitrate(int bits_per_second) {
   const auto new_complexity = GetNewComplexity(config_);
   if (new_complexity && complexity_ != *new_complexity) {
     complexity_ = *new_complexity;
-    RTC_CHECK_EQ(0, WebRtcOpus_SetComplexity(inst_, complexity_));
+    MaybeUpdateComplexity();
   }
   bitrate_changed_ = true;
 }
@@ -810,10 +903,13 @@ void AudioEncoderOpusImpl::MaybeUpdateUplinkBandwidth() {
 }
 
 ANAStats AudioEncoderOpusImpl::GetANAStats() const {
-  if (audio_network_adaptor_) {
-    return audio_network_adaptor_->GetStats();
+  ANAStats stats =
+      audio_network_adaptor_ ? audio_network_adaptor_->GetStats() : ANAStats();
+  if (complexity_controller_) {
+    stats.complexity_action_counter = complexity_controller_->num_changes();
+    stats.complexity = applied_complexity_;
   }
-  return ANAStats();
+  return stats;
 }
 
 }  // namespace webrtc
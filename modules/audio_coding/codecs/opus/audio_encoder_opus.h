@@ -22,6 +22,7 @@
 #include "api/optional.h"
 #include "common_audio/smoothing_filter.h"
 #include "modules/audio_coding/audio_network_adaptor/include/audio_network_adaptor.h"
+#include "modules/audio_coding/codecs/opus/opus_complexity_controller.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/protobuf_utils.h"
@@ -116,6 +117,7 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   bool fec_enabled() const { return config_.fec_enabled; }
   size_t num_channels_to_encode() const { return num_channels_to_encode_; }
   int next_frame_length_ms() const { return next_frame_length_ms_; }
+  int complexity() const { return applied_complexity_; }
 
  protected:
   EncodedInfo EncodeImpl(uint32_t rtp_timestamp,
@@ -140,6 +142,9 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   void SetFrameLength(int frame_length_ms);
   void SetNumChannelsToEncode(size_t num_channels_to_encode);
   void SetProjectedPacketLossRate(float fraction);
+  // Applies |complexity_|, limited by |complexity_controller_|, if it differs
+  // from the complexity in use.
+  void MaybeUpdateComplexity();
 
   // TODO(minyue): remove "override" when we can deprecate
   // |AudioEncoder::SetTargetBitrate|.
@@ -163,7 +168,11 @@ class AudioEncoderOpusImpl final : public AudioEncoder {
   uint32_t first_timestamp_in_buffer_;
   size_t num_channels_to_encode_;
   int next_frame_length_ms_;
+  // The complexity chosen from the bitrate, and the one actually in use after
+  // applying the limit of |complexity_controller_|.
   int complexity_;
+  int applied_complexity_;
+  std::unique_ptr<OpusComplexityController> complexity_controller_;
   std::unique_ptr<PacketLossFractionSmoother> packet_loss_fraction_smoother_;
   const AudioNetworkAdaptorCreator audio_network_adaptor_creator_;
   std::unique_ptr<AudioNetworkAdaptor> audio_network_adaptor_;
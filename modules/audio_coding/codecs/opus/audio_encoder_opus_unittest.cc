@@ -12,6 +12,7 @@
 #include <memory>
 #include <utility>
 
+#include "api/audio_codecs/opus/audio_decoder_opus.h"
 #include "api/audio_codecs/opus/audio_encoder_opus.h"
 #include "common_audio/mocks/mock_smoothing_filter.h"
 #include "common_types.h"  // NOLINT(build/include)
@@ -469,6 +470,23 @@ TEST(AudioEncoderOpusTest, ConfigComplexityAdaptation) {
   EXPECT_EQ(6, AudioEncoderOpusImpl::GetNewComplexity(config));
 }
 
+// Verifies that the complexity in use is only reported when it is adapted to
+// the encoding time.
+TEST(AudioEncoderOpusTest, ReportsComplexityWhenAdaptedToEncodeLoad) {
+  AudioEncoderOpusConfig config = CreateConfig(kDefaultOpusSettings);
+  {
+    AudioEncoderOpusImpl encoder(config, kDefaultOpusSettings.pltype);
+    const ANAStats stats = encoder.GetANAStats();
+    EXPECT_FALSE(stats.complexity);
+    EXPECT_FALSE(stats.complexity_action_counter);
+  }
+  config.max_encode_load = 0.5f;
+  AudioEncoderOpusImpl encoder(config, kDefaultOpusSettings.pltype);
+  const ANAStats stats = encoder.GetANAStats();
+  EXPECT_EQ(encoder.complexity(), stats.complexity);
+  EXPECT_EQ(0u, stats.complexity_action_counter);
+}
+
 // Verifies that the bandwidth adaptation in the config works as intended.
 TEST(AudioEncoderOpusTest, ConfigBandwidthAdaptation) {
   AudioEncoderOpusConfig config;
@@ -869,4 +887,89 @@ TEST(AudioEncoderOpusTest, OpusFlagDtxAsNonSpeech) {
   EXPECT_GT(max_nonspeech_frames, 20);
 }
 
+// Verifies that a "multiopus" format is read into a multistream config.
+TEST(AudioEncoderOpusTest, TestMultistreamConfigFromParams) {
+  const SdpAudioFormat format("multiopus", 48000, 6,
+                              {{"num_streams", "4"},
+                               {"coupled_streams", "2"},
+                               {"channel_mapping", "0,4,1,2,3,5"}});
+  const auto config = AudioEncoderOpus::SdpToConfig(format);
+  ASSERT_TRUE(config);
+  EXPECT_EQ(6u, config->num_channels);
+  EXPECT_EQ(4u, config->num_streams);
+  EXPECT_EQ(2u, config->coupled_streams);
+  EXPECT_EQ(std::vector<unsigned char>({0, 4, 1, 2, 3, 5}),
+            config->channel_mapping);
+  EXPECT_EQ(AudioEncoderOpusConfig::ApplicationMode::kAudio,
+            config->application);
+  EXPECT_EQ(6 * 32000, config->bitrate_bps);
+  const auto info = AudioEncoderOpus::QueryAudioEncoder(*config);
+  EXPECT_EQ(6u, info.num_channels);
+
+  // More than two channels need the multistream format.
+  EXPECT_FALSE(AudioEncoderOpus::SdpToConfig(
+      {"opus", 48000, 6, format.parameters}));
+  // The layout must be given and has to be valid.
+  EXPECT_FALSE(AudioEncoderOpus::SdpToConfig({"multiopus", 48000, 6}));
+  EXPECT_FALSE(AudioEncoderOpus::SdpToConfig(
+      {"multiopus", 48000, 6,
+       {{"num_streams", "4"},
+        {"coupled_streams", "2"},
+        {"channel_mapping", "0,4,1,2,3"}}}));
+  EXPECT_FALSE(AudioEncoderOpus::SdpToConfig(
+      {"multiopus", 48000, 6,
+       {{"num_streams", "4"},
+        {"coupled_streams", "2"},
+        {"channel_mapping", "0,4,1,2,3,6"}}}));
+  EXPECT_FALSE(AudioEncoderOpus::SdpToConfig(
+      {"multiopus", 48000, 6,
+       {{"num_streams", "4"},
+        {"coupled_streams", "2"},
+        {"channel_mapping", "0,4,1,2,3,x"}}}));
+}
+
+// Verifies that 7.1 audio is sent as one multistream packet per frame and
+// decoded into all channels.
+TEST(AudioEncoderOpusTest, MultistreamEncodeDecode) {
+  constexpr size_t kChannels = 8;
+  const SdpAudioFormat format("multiopus", 48000, kChannels,
+                              {{"num_streams", "5"},
+                               {"coupled_streams", "3"},
+                               {"channel_mapping", "0,6,1,2,3,4,5,7"}});
+  const auto encoder_config = AudioEncoderOpus::SdpToConfig(format);
+  ASSERT_TRUE(encoder_config);
+  const auto decoder_config = AudioDecoderOpus::SdpToConfig(format);
+  ASSERT_TRUE(decoder_config);
+  EXPECT_EQ(static_cast<int>(kChannels), decoder_config->num_channels);
+  EXPECT_EQ(encoder_config->channel_mapping, decoder_config->channel_mapping);
+  std::unique_ptr<AudioEncoder> encoder =
+      AudioEncoderOpus::MakeAudioEncoder(*encoder_config, 100);
+  std::unique_ptr<AudioDecoder> decoder =
+      AudioDecoderOpus::MakeAudioDecoder(*decoder_config);
+  EXPECT_EQ(kChannels, encoder->NumChannels());
+  EXPECT_EQ(kChannels, decoder->Channels());
+
+  constexpr size_t kSamplesPer10Ms = 480;
+  std::vector<int16_t> audio(kSamplesPer10Ms * kChannels);
+  for (size_t i = 0; i < audio.size(); ++i) {
+    audio[i] = static_cast<int16_t>((i % 97) * 100 - 4800);
+  }
+  rtc::Buffer encoded;
+  uint32_t rtp_timestamp = 0;
+  AudioEncoder::EncodedInfo info;
+  while (encoded.size() == 0) {
+    info = encoder->Encode(rtp_timestamp, audio, &encoded);
+    rtp_timestamp += kSamplesPer10Ms;
+  }
+  EXPECT_FALSE(decoder->PacketHasFec(encoded.data(), encoded.size()));
+  EXPECT_EQ(static_cast<int>(2 * kSamplesPer10Ms),
+            decoder->PacketDuration(encoded.data(), encoded.size()));
+  std::vector<int16_t> decoded(2 * kSamplesPer10Ms * kChannels);
+  AudioDecoder::SpeechType speech_type;
+  EXPECT_EQ(static_cast<int>(decoded.size()),
+            decoder->Decode(encoded.data(), encoded.size(), 48000,
+                            decoded.size() * sizeof(int16_t), decoded.data(),
+                            &speech_type));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,77 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/codecs/opus/opus_complexity_controller.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+// The load is measured over this much audio before each decision. Long enough
+// to average out scheduling noise and to keep the complexity from toggling.
+constexpr int kMeasurementIntervalMs = 2000;
+
+// The limit is only raised while the load stays below this fraction of the
+// maximum load, which leaves room for the cost of one more complexity level.
+constexpr float kIncreaseLoadFraction = 0.7f;
+
+}  // namespace
+
+OpusComplexityController::OpusComplexityController(float max_encode_load,
+                                                   int min_complexity,
+                                                   int max_complexity)
+    : max_encode_load_(max_encode_load),
+      min_complexity_(min_complexity),
+      max_complexity_(max_complexity),
+      complexity_limit_(max_complexity) {
+  RTC_DCHECK_GT(max_encode_load_, 0.f);
+  RTC_DCHECK_LE(min_complexity_, max_complexity_);
+}
+
+OpusComplexityController::~OpusComplexityController() = default;
+
+bool OpusComplexityController::Update(int64_t encode_time_us,
+                                      int audio_duration_ms,
+                                      int complexity) {
+  RTC_DCHECK_GE(encode_time_us, 0);
+  RTC_DCHECK_GT(audio_duration_ms, 0);
+  accumulated_encode_time_us_ += encode_time_us;
+  accumulated_audio_ms_ += audio_duration_ms;
+  if (accumulated_audio_ms_ < kMeasurementIntervalMs) {
+    return false;
+  }
+
+  const float load = accumulated_encode_time_us_ /
+                     (1000.f * static_cast<float>(accumulated_audio_ms_));
+  accumulated_encode_time_us_ = 0;
+  accumulated_audio_ms_ = 0;
+
+  int new_limit = complexity_limit_;
+  if (load > max_encode_load_) {
+    // Step down from the complexity actually used, which may be below the
+    // limit because of the bitrate.
+    new_limit = std::max(std::min(complexity_limit_, complexity) - 1,
+                         min_complexity_);
+  } else if (load < kIncreaseLoadFraction * max_encode_load_) {
+    new_limit = std::min(complexity_limit_ + 1, max_complexity_);
+  }
+  if (new_limit == complexity_limit_) {
+    return false;
+  }
+  complexity_limit_ = new_limit;
+  ++num_changes_;
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,57 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_COMPLEXITY_CONTROLLER_H_
+#define MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_COMPLEXITY_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Limits the Opus encoder complexity based on the measured encoding time. The
+// limit is lowered one step below the current complexity while encoding takes
+// more than |max_encode_load| of real time, and raised one step at a time once
+// the load leaves room for the next complexity level. Since the encoding time
+// is measured as wall-clock time, contention on a loaded host also lowers the
+// complexity.
+class OpusComplexityController {
+ public:
+  OpusComplexityController(float max_encode_load,
+                           int min_complexity,
+                           int max_complexity);
+  ~OpusComplexityController();
+
+  // Reports that encoding |audio_duration_ms| of audio at |complexity| took
+  // |encode_time_us|. Returns true if the complexity limit changed.
+  bool Update(int64_t encode_time_us, int audio_duration_ms, int complexity);
+
+  // Returns the highest complexity the encoder may currently use.
+  int complexity_limit() const { return complexity_limit_; }
+
+  // Returns the number of times the complexity limit changed.
+  uint32_t num_changes() const { return num_changes_; }
+
+ private:
+  const float max_encode_load_;
+  const int min_complexity_;
+  const int max_complexity_;
+  int complexity_limit_;
+  uint32_t num_changes_ = 0;
+  int64_t accumulated_encode_time_us_ = 0;
+  int accumulated_audio_ms_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OpusComplexityController);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_CODING_CODECS_OPUS_OPUS_COMPLEXITY_CONTROLLER_H_
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/codecs/opus/opus_complexity_controller.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr float kMaxEncodeLoad = 0.1f;
+constexpr int kMinComplexity = 0;
+constexpr int kMaxComplexity = 9;
+constexpr int kFrameLengthMs = 20;
+// Enough frames to complete one measurement interval.
+constexpr int kFramesPerInterval = 100;
+
+// Encodes one measurement interval of frames at |load| and returns whether the
+// limit changed after the last frame.
+bool UpdateInterval(OpusComplexityController* controller,
+                    float load,
+                    int complexity) {
+  bool changed = false;
+  for (int i = 0; i < kFramesPerInterval; ++i) {
+    EXPECT_FALSE(changed);
+    changed = controller->Update(
+        static_cast<int64_t>(load * kFrameLengthMs * 1000), kFrameLengthMs,
+        complexity);
+  }
+  return changed;
+}
+
+}  // namespace
+
+TEST(OpusComplexityControllerTest, StartsAtMaxComplexity) {
+  OpusComplexityController controller(kMaxEncodeLoad, kMinComplexity,
+                                      kMaxComplexity);
+  EXPECT_EQ(kMaxComplexity, controller.complexity_limit());
+  EXPECT_EQ(0u, controller.num_changes());
+}
+
+TEST(OpusComplexityControllerTest, NoChangeBeforeMeasurementInterval) {
+  OpusComplexityController controller(kMaxEncodeLoad, kMinComplexity,
+                                      kMaxComplexity);
+  for (int i = 0; i < kFramesPerInterval - 1; ++i) {
+    EXPECT_FALSE(controller.Update(1000000, kFrameLengthMs, kMaxComplexity));
+  }
+  EXPECT_EQ(kMaxComplexity, controller.complexity_limit());
+  EXPECT_TRUE(controller.Update(1000000, kFrameLengthMs, kMaxComplexity));
+  EXPECT_EQ(kMaxComplexity - 1, controller.complexity_limit());
+}
+
+TEST(OpusComplexityControllerTest, LowersComplexityOnHighLoad) {
+  OpusComplexityController controller(kMaxEncodeLoad, kMinComplexity,
+                                      kMaxComplexity);
+  for (int i = 1; i <= kMaxComplexity - kMinComplexity; ++i) {
+    EXPECT_TRUE(UpdateInterval(&controller, 2 * kMaxEncodeLoad,
+                               controller.complexity_limit()));
+    EXPECT_EQ(kMaxComplexity - i, controller.complexity_limit());
+    EXPECT_EQ(static_cast<uint32_t>(i), controller.num_changes());
+  }
+  // Bounded by the minimum complexity.
+  EXPECT_FALSE(UpdateInterval(&controller, 2 * kMaxEncodeLoad,
+                              controller.complexity_limit()));
+  EXPECT_EQ(kMinComplexity, controller.complexity_limit());
+}
+
+TEST(OpusComplexityControllerTest, LowersFromComplexityInUse) {
+  OpusComplexityController controller(kMaxEncodeLoad, kMinComplexity,
+                                      kMaxComplexity);
+  // The encoder runs below the limit, e.g., because of a high bitrate.
+  EXPECT_TRUE(UpdateInterval(&controller, 2 * kMaxEncodeLoad, 5));
+  EXPECT_EQ(4, controller.complexity_limit());
+}
+
+TEST(OpusComplexityControllerTest, RaisesComplexityOnLowLoad) {
+  OpusComplexityController controller(kMaxEncodeLoad, kMinComplexity,
+                                      kMaxComplexity);
+  EXPECT_TRUE(UpdateInterval(&controller, 2 * kMaxEncodeLoad, 5));
+  EXPECT_EQ(4, controller.complexity_limit());
+  for (int i = 5; i <= kMaxComplexity; ++i) {
+    EXPECT_TRUE(
+        UpdateInterval(&controller, 0.f, controller.complexity_limit()));
+    EXPECT_EQ(i, controller.complexity_limit());
+  }
+  // Bounded by the maximum complexity.
+  EXPECT_FALSE(UpdateInterval(&controller, 0.f, kMaxComplexity));
+  EXPECT_EQ(kMaxComplexity, controller.complexity_limit());
+}
+
+TEST(OpusComplexityControllerTest, KeepsComplexityWithinHysteresis) {
+  OpusComplexityController controller(kMaxEncodeLoad, kMinComplexity,
+                                      kMaxComplexity);
+  EXPECT_TRUE(UpdateInterval(&controller, 2 * kMaxEncodeLoad, kMaxComplexity));
+  const uint32_t num_changes = controller.num_changes();
+  // Between the load for raising the complexity and the maximum load.
+  EXPECT_FALSE(UpdateInterval(&controller, 0.9f * kMaxEncodeLoad,
+                              controller.complexity_limit()));
+  EXPECT_EQ(kMaxComplexity - 1, controller.complexity_limit());
+  EXPECT_EQ(num_changes, controller.num_changes());
+}
+
+}  // namespace webrtc
@@ -37,6 +37,21 @@ enum {
   kWebRtcOpusDefaultFrameSize = 960,
 };
 
+/* The channel mapping family that multistream encoders are set up for when
+ * the layout allows it, see RFC 7845, section 5.1.1.2. */
+enum { kWebRtcOpusSurroundMappingFamily = 1 };
+
+/* Calls the right control function for the encoder or decoder in use. */
+#define ENCODER_CTL(inst, vargs)                                      \
+  ((inst)->encoder                                                    \
+       ? opus_encoder_ctl((inst)->encoder, vargs)                     \
+       : opus_multistream_encoder_ctl((inst)->multistream_encoder, vargs))
+
+#define DECODER_CTL(inst, vargs)                                      \
+  ((inst)->decoder                                                    \
+       ? opus_decoder_ctl((inst)->decoder, vargs)                     \
+       : opus_multistream_decoder_ctl((inst)->multistream_decoder, vargs))
+
 int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  size_t channels,
                                  int32_t application) {
@@ -73,9 +88,83 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
   return 0;
 }
 
+/* Creates a surround sound encoder if the layout is the one of mapping family
+ * 1 for |channels|. Returns NULL otherwise. */
+static OpusMSEncoder* CreateSurroundEncoder(size_t channels,
+                                            int opus_app,
+                                            size_t streams,
+                                            size_t coupled_streams,
+                                            const unsigned char* mapping) {
+  int family_streams, family_coupled_streams, error;
+  unsigned char family_mapping[255];
+  OpusMSEncoder* encoder = opus_multistream_surround_encoder_create(
+      48000, (int)channels, kWebRtcOpusSurroundMappingFamily, &family_streams,
+      &family_coupled_streams, family_mapping, opus_app, &error);
+  if (error != OPUS_OK || !encoder) {
+    return NULL;
+  }
+  if ((size_t)family_streams != streams ||
+      (size_t)family_coupled_streams != coupled_streams ||
+      memcmp(family_mapping, mapping, channels) != 0) {
+    opus_multistream_encoder_destroy(encoder);
+    return NULL;
+  }
+  return encoder;
+}
+
+int16_t WebRtcOpus_MultistreamEncoderCreate(
+    OpusEncInst** inst,
+    size_t channels,
+    int32_t application,
+    size_t streams,
+    size_t coupled_streams,
+    const unsigned char* channel_mapping) {
+  int opus_app;
+  if (!inst || !channel_mapping)
+    return -1;
+
+  switch (application) {
+    case 0:
+      opus_app = OPUS_APPLICATION_VOIP;
+      break;
+    case 1:
+      opus_app = OPUS_APPLICATION_AUDIO;
+      break;
+    default:
+      return -1;
+  }
+
+  OpusEncInst* state = calloc(1, sizeof(OpusEncInst));
+  RTC_DCHECK(state);
+
+  state->multistream_encoder = CreateSurroundEncoder(
+      channels, opus_app, streams, coupled_streams, channel_mapping);
+  if (!state->multistream_encoder) {
+    /* Any other layout is coded as channel mapping family 255. */
+    int error;
+    state->multistream_encoder = opus_multistream_encoder_create(
+        48000, (int)channels, (int)streams, (int)coupled_streams,
+        channel_mapping, opus_app, &error);
+    if (error != OPUS_OK || !state->multistream_encoder) {
+      WebRtcOpus_EncoderFree(state);
+      return -1;
+    }
+  }
+
+  state->in_dtx_mode = 0;
+  state->channels = channels;
+
+  *inst = state;
+  return 0;
+}
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst) {
   if (inst) {
-    opus_encoder_destroy(inst->encoder);
+    if (inst->encoder) {
+      opus_encoder_destroy(inst->encoder);
+    } else if (inst->multistream_encoder) {
+      opus_multistream_encoder_destroy(inst->multistream_encoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -94,11 +183,19 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
     return -1;
   }
 
-  res = opus_encode(inst->encoder,
-                    (const opus_int16*)audio_in,
-                    (int)samples,
-                    encoded,
-                    (opus_int32)length_encoded_buffer);
+  if (inst->encoder) {
+    res = opus_encode(inst->encoder,
+                      (const opus_int16*)audio_in,
+                      (int)samples,
+                      encoded,
+                      (opus_int32)length_encoded_buffer);
+  } else {
+    res = opus_multistream_encode(inst->multistream_encoder,
+                                  (const opus_int16*)audio_in,
+                                  (int)samples,
+                                  encoded,
+                                  (opus_int32)length_encoded_buffer);
+  }
 
   if (res <= 0) {
     return -1;
@@ -122,7 +219,7 @@ int WebRtcOpus_Encode(OpusEncInst* inst,
 
 int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BITRATE(rate));
+    return ENCODER_CTL(inst, OPUS_SET_BITRATE(rate));
   } else {
     return -1;
   }
@@ -130,8 +227,7 @@ int16_t WebRtcOpus_SetBitRate(OpusEncInst* inst, int32_t rate) {
 
 int16_t WebRtcOpus_SetPacketLossRate(OpusEncInst* inst, int32_t loss_rate) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_PACKET_LOSS_PERC(loss_rate));
+    return ENCODER_CTL(inst, OPUS_SET_PACKET_LOSS_PERC(loss_rate));
   } else {
     return -1;
   }
@@ -154,13 +250,12 @@ int16_t WebRtcOpus_SetMaxPlaybackRate(OpusEncInst* inst, int32_t frequency_hz) {
   } else {
     set_bandwidth = OPUS_BANDWIDTH_FULLBAND;
   }
-  return opus_encoder_ctl(inst->encoder,
-                          OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
+  return ENCODER_CTL(inst, OPUS_SET_MAX_BANDWIDTH(set_bandwidth));
 }
 
 int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(1));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(1));
   } else {
     return -1;
   }
@@ -168,7 +263,7 @@ int16_t WebRtcOpus_EnableFec(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableFec(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_INBAND_FEC(0));
+    return ENCODER_CTL(inst, OPUS_SET_INBAND_FEC(0));
   } else {
     return -1;
   }
@@ -184,21 +279,19 @@ int16_t WebRtcOpus_EnableDtx(OpusEncInst* inst) {
   // last long during a pure silence, if the signal type is not forced.
   // TODO(minyue): Remove the signal type forcing when Opus DTX works properly
   // without it.
-  int ret = opus_encoder_ctl(inst->encoder,
-                             OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
+  int ret = ENCODER_CTL(inst, OPUS_SET_SIGNAL(OPUS_SIGNAL_VOICE));
   if (ret != OPUS_OK)
     return ret;
 
-  return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(1));
+  return ENCODER_CTL(inst, OPUS_SET_DTX(1));
 }
 
 int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
   if (inst) {
-    int ret = opus_encoder_ctl(inst->encoder,
-                               OPUS_SET_SIGNAL(OPUS_AUTO));
+    int ret = ENCODER_CTL(inst, OPUS_SET_SIGNAL(OPUS_AUTO));
     if (ret != OPUS_OK)
       return ret;
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_DTX(0));
+    return ENCODER_CTL(inst, OPUS_SET_DTX(0));
   } else {
     return -1;
   }
@@ -206,7 +299,7 @@ int16_t WebRtcOpus_DisableDtx(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_EnableCbr(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_VBR(0));
+    return ENCODER_CTL(inst, OPUS_SET_VBR(0));
   } else {
     return -1;
   }
@@ -214,7 +307,7 @@ int16_t WebRtcOpus_EnableCbr(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_DisableCbr(OpusEncInst* inst) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_VBR(1));
+    return ENCODER_CTL(inst, OPUS_SET_VBR(1));
   } else {
     return -1;
   }
@@ -222,7 +315,7 @@ int16_t WebRtcOpus_DisableCbr(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetComplexity(OpusEncInst* inst, int32_t complexity) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_COMPLEXITY(complexity));
+    return ENCODER_CTL(inst, OPUS_SET_COMPLEXITY(complexity));
   } else {
     return -1;
   }
@@ -233,7 +326,7 @@ int32_t WebRtcOpus_GetBandwidth(OpusEncInst* inst) {
     return -1;
   }
   int32_t bandwidth;
-  if (opus_encoder_ctl(inst->encoder, OPUS_GET_BANDWIDTH(&bandwidth)) == 0) {
+  if (ENCODER_CTL(inst, OPUS_GET_BANDWIDTH(&bandwidth)) == 0) {
     return bandwidth;
   } else {
     return -1;
@@ -243,7 +336,7 @@ int32_t WebRtcOpus_GetBandwidth(OpusEncInst* inst) {
 
 int16_t WebRtcOpus_SetBandwidth(OpusEncInst* inst, int32_t bandwidth) {
   if (inst) {
-    return opus_encoder_ctl(inst->encoder, OPUS_SET_BANDWIDTH(bandwidth));
+    return ENCODER_CTL(inst, OPUS_SET_BANDWIDTH(bandwidth));
   } else {
     return -1;
   }
@@ -252,12 +345,17 @@ int16_t WebRtcOpus_SetBandwidth(OpusEncInst* inst, int32_t bandwidth) {
 int16_t WebRtcOpus_SetForceChannels(OpusEncInst* inst, size_t num_channels) {
   if (!inst)
     return -1;
+  if (inst->multistream_encoder) {
+    /* Forcing mono or stereo would apply to every stream. */
+    if (num_channels == 0 || num_channels == inst->channels) {
+      return ENCODER_CTL(inst, OPUS_SET_FORCE_CHANNELS(OPUS_AUTO));
+    }
+    return -1;
+  }
   if (num_channels == 0) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_FORCE_CHANNELS(OPUS_AUTO));
+    return ENCODER_CTL(inst, OPUS_SET_FORCE_CHANNELS(OPUS_AUTO));
   } else if (num_channels == 1 || num_channels == 2) {
-    return opus_encoder_ctl(inst->encoder,
-                            OPUS_SET_FORCE_CHANNELS(num_channels));
+    return ENCODER_CTL(inst, OPUS_SET_FORCE_CHANNELS(num_channels));
   } else {
     return -1;
   }
@@ -294,9 +392,51 @@ int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, size_t channels) {
   return -1;
 }
 
+int16_t WebRtcOpus_MultistreamDecoderCreate(
+    OpusDecInst** inst,
+    size_t channels,
+    size_t streams,
+    size_t coupled_streams,
+    const unsigned char* channel_mapping) {
+  int error;
+  OpusDecInst* state;
+
+  if (inst != NULL && channel_mapping != NULL) {
+    /* Create Opus decoder state. */
+    state = (OpusDecInst*) calloc(1, sizeof(OpusDecInst));
+    if (state == NULL) {
+      return -1;
+    }
+
+    /* Create new memory, always at 48000 Hz. */
+    state->multistream_decoder = opus_multistream_decoder_create(
+        48000, (int)channels, (int)streams, (int)coupled_streams,
+        channel_mapping, &error);
+    if (error == OPUS_OK && state->multistream_decoder != NULL) {
+      /* Creation of memory all ok. */
+      state->channels = channels;
+      state->prev_decoded_samples = kWebRtcOpusDefaultFrameSize;
+      state->in_dtx_mode = 0;
+      *inst = state;
+      return 0;
+    }
+
+    /* If memory allocation was unsuccessful, free the entire state. */
+    if (state->multistream_decoder) {
+      opus_multistream_decoder_destroy(state->multistream_decoder);
+    }
+    free(state);
+  }
+  return -1;
+}
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst) {
   if (inst) {
-    opus_decoder_destroy(inst->decoder);
+    if (inst->decoder) {
+      opus_decoder_destroy(inst->decoder);
+    } else if (inst->multistream_decoder) {
+      opus_multistream_decoder_destroy(inst->multistream_decoder);
+    }
     free(inst);
     return 0;
   } else {
@@ -309,7 +449,7 @@ size_t WebRtcOpus_DecoderChannels(OpusDecInst* inst) {
 }
 
 void WebRtcOpus_DecoderInit(OpusDecInst* inst) {
-  opus_decoder_ctl(inst->decoder, OPUS_RESET_STATE);
+  DECODER_CTL(inst, OPUS_RESET_STATE);
   inst->in_dtx_mode = 0;
 }
 
@@ -338,8 +478,16 @@ static int16_t DetermineAudioType(OpusDecInst* inst, size_t encoded_bytes) {
 static int DecodeNative(OpusDecInst* inst, const uint8_t* encoded,
                         size_t encoded_bytes, int frame_size,
                         int16_t* decoded, int16_t* audio_type, int decode_fec) {
-  int res = opus_decode(inst->decoder, encoded, (opus_int32)encoded_bytes,
-                        (opus_int16*)decoded, frame_size, decode_fec);
+  int res;
+  if (inst->decoder) {
+    res = opus_decode(inst->decoder, encoded, (opus_int32)encoded_bytes,
+                      (opus_int16*)decoded, frame_size, decode_fec);
+  } else {
+    res = opus_multistream_decode(inst->multistream_decoder, encoded,
+                                  (opus_int32)encoded_bytes,
+                                  (opus_int16*)decoded, frame_size,
+                                  decode_fec);
+  }
 
   if (res <= 0)
     return -1;
@@ -47,6 +47,42 @@ int16_t WebRtcOpus_EncoderCreate(OpusEncInst** inst,
                                  size_t channels,
                                  int32_t application);
 
+/****************************************************************************
+ * WebRtcOpus_MultistreamEncoderCreate(...)
+ *
+ * This function creates an Opus multistream encoder, which packs
+ * |streams| Opus streams, the first |coupled_streams| of them stereo, into
+ * each packet (RFC 7845, section 5.1.1). When the layout is the one of channel
+ * mapping family 1 (Vorbis channel order), the encoder is set up for
+ * surround sound, which lets it spend its bits according to the layout.
+ *
+ * Input:
+ *      - channels           : number of channels.
+ *      - application        : 0 - VOIP applications.
+ *                                 Favor speech intelligibility.
+ *                             1 - Audio applications.
+ *                                 Favor faithfulness to the original input.
+ *      - streams            : number of streams.
+ *      - coupled_streams    : number of stereo streams.
+ *      - channel_mapping    : the stream channel that each of the |channels|
+ *                             input channels is coded in, or 255 for a
+ *                             silent channel.
+ *
+ * Output:
+ *      - inst               : a pointer to Encoder context that is created
+ *                             if success.
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamEncoderCreate(
+    OpusEncInst** inst,
+    size_t channels,
+    int32_t application,
+    size_t streams,
+    size_t coupled_streams,
+    const unsigned char* channel_mapping);
+
 int16_t WebRtcOpus_EncoderFree(OpusEncInst* inst);
 
 /****************************************************************************
@@ -265,7 +301,8 @@ int16_t WebRtcOpus_SetBandwidth(OpusEncInst* inst, int32_t bandwidth);
  * in auto/mono/stereo.
  *
  * If the Encoder is initialized as a mono encoder, and one tries to force
- * stereo, the function will return an error.
+ * stereo, the function will return an error. Multistream encoders can only
+ * be set to auto or to their number of channels.
  *
  * Input:
  *      - inst               : Encoder context
@@ -279,6 +316,23 @@ int16_t WebRtcOpus_SetBandwidth(OpusEncInst* inst, int32_t bandwidth);
 int16_t WebRtcOpus_SetForceChannels(OpusEncInst* inst, size_t num_channels);
 
 int16_t WebRtcOpus_DecoderCreate(OpusDecInst** inst, size_t channels);
+
+/****************************************************************************
+ * WebRtcOpus_MultistreamDecoderCreate(...)
+ *
+ * This function creates a decoder for packets of an Opus multistream
+ * encoder with the same layout, see WebRtcOpus_MultistreamEncoderCreate().
+ *
+ * Return value              : 0 - Success
+ *                            -1 - Error
+ */
+int16_t WebRtcOpus_MultistreamDecoderCreate(
+    OpusDecInst** inst,
+    size_t channels,
+    size_t streams,
+    size_t coupled_streams,
+    const unsigned char* channel_mapping);
+
 int16_t WebRtcOpus_DecoderFree(OpusDecInst* inst);
 
 /****************************************************************************
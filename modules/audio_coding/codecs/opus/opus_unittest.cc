@@ -8,8 +8,11 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <math.h>
+
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "modules/audio_coding/codecs/opus/opus_inst.h"
 #include "modules/audio_coding/codecs/opus/opus_interface.h"
@@ -812,5 +815,119 @@ INSTANTIATE_TEST_CASE_P(VariousMode,
                         OpusTest,
                         Combine(Values(1, 2), Values(0, 1)));
 
+namespace {
+
+struct MultistreamLayout {
+  size_t streams;
+  size_t coupled_streams;
+  std::vector<unsigned char> channel_mapping;
+};
+
+// 5.1 in channel mapping family 1, which is coded as surround sound, and the
+// same channels as uncoupled streams of channel mapping family 255.
+const MultistreamLayout kSurround51Layout = {4, 2, {0, 4, 1, 2, 3, 5}};
+const MultistreamLayout kUncoupled6Layout = {6, 0, {0, 1, 2, 3, 4, 5}};
+
+// Returns |num_frames| 20 ms frames of interleaved audio with a tone of its own
+// frequency in each channel. The last channel gets a low tone, since it is the
+// low-frequency effects channel of 5.1 and 7.1.
+std::vector<int16_t> MultichannelTones(size_t num_channels,
+                                       size_t num_frames) {
+  std::vector<int16_t> audio(num_frames * kOpus20msFrameSamples *
+                             num_channels);
+  for (size_t i = 0; i < audio.size(); ++i) {
+    const size_t n = i / num_channels;
+    const size_t channel = i % num_channels;
+    const float frequency_hz =
+        channel == num_channels - 1 ? 60.f : 200.f + 300.f * channel;
+    audio[i] = static_cast<int16_t>(
+        8000 * sinf(2 * 3.1415927f * frequency_hz * n / 48000));
+  }
+  return audio;
+}
+
+}  // namespace
+
+TEST(OpusMultistreamTest, CreateRejectsInvalidLayouts) {
+  const unsigned char mapping[] = {0, 1, 2, 3, 4, 6};
+  WebRtcOpusEncInst* encoder;
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 6, 1, 4, 2,
+                                                    mapping));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 6, 1, 2, 3,
+                                                    mapping));
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamEncoderCreate(&encoder, 6, 2, 4, 2,
+                                                    mapping));
+  WebRtcOpusDecInst* decoder;
+  EXPECT_EQ(-1, WebRtcOpus_MultistreamDecoderCreate(&decoder, 6, 4, 2,
+                                                    mapping));
+}
+
+TEST(OpusMultistreamTest, CanOnlyForceAllChannels) {
+  WebRtcOpusEncInst* encoder;
+  ASSERT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+                   &encoder, 6, 1, kSurround51Layout.streams,
+                   kSurround51Layout.coupled_streams,
+                   kSurround51Layout.channel_mapping.data()));
+  EXPECT_EQ(0, WebRtcOpus_SetForceChannels(encoder, 0));
+  EXPECT_EQ(0, WebRtcOpus_SetForceChannels(encoder, 6));
+  EXPECT_EQ(-1, WebRtcOpus_SetForceChannels(encoder, 1));
+  EXPECT_EQ(-1, WebRtcOpus_SetForceChannels(encoder, 2));
+  EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+}
+
+// Verifies that every channel of a multistream packet is decoded.
+TEST(OpusMultistreamTest, EncodeDecode) {
+  constexpr size_t kChannels = 6;
+  constexpr size_t kFrames = 25;
+  const std::vector<int16_t> input = MultichannelTones(kChannels, kFrames);
+  for (const MultistreamLayout& layout :
+       {kSurround51Layout, kUncoupled6Layout}) {
+    SCOPED_TRACE(layout.streams);
+    WebRtcOpusEncInst* encoder;
+    WebRtcOpusDecInst* decoder;
+    ASSERT_EQ(0, WebRtcOpus_MultistreamEncoderCreate(
+                     &encoder, kChannels, 1, layout.streams,
+                     layout.coupled_streams, layout.channel_mapping.data()));
+    ASSERT_EQ(0, WebRtcOpus_MultistreamDecoderCreate(
+                     &decoder, kChannels, layout.streams,
+                     layout.coupled_streams, layout.channel_mapping.data()));
+    EXPECT_EQ(kChannels, WebRtcOpus_DecoderChannels(decoder));
+    EXPECT_EQ(0, WebRtcOpus_SetBitRate(encoder, 256000));
+    WebRtcOpus_DecoderInit(decoder);
+
+    uint8_t bitstream[2 * kMaxBytes];
+    std::vector<int16_t> output(kOpus20msFrameSamples * kChannels);
+    std::vector<double> energy(kChannels, 0.0);
+    for (size_t k = 0; k < kFrames; ++k) {
+      const int encoded_bytes = WebRtcOpus_Encode(
+          encoder, &input[k * kOpus20msFrameSamples * kChannels],
+          kOpus20msFrameSamples, sizeof(bitstream), bitstream);
+      ASSERT_GT(encoded_bytes, 0);
+      EXPECT_EQ(static_cast<int>(kOpus20msFrameSamples),
+                WebRtcOpus_DurationEst(decoder, bitstream, encoded_bytes));
+      int16_t audio_type;
+      ASSERT_EQ(static_cast<int>(kOpus20msFrameSamples),
+                WebRtcOpus_Decode(decoder, bitstream, encoded_bytes,
+                                  output.data(), &audio_type));
+      for (size_t i = 0; i < output.size(); ++i) {
+        energy[i % kChannels] += output[i] * output[i];
+      }
+    }
+    // Each channel gets back most of the energy of its tone.
+    const double tone_energy = kFrames * kOpus20msFrameSamples * 8000.0 *
+                               8000.0 / 2;
+    for (size_t channel = 0; channel < kChannels; ++channel) {
+      EXPECT_GT(energy[channel], 0.5 * tone_energy) << "channel " << channel;
+    }
+
+    // Loss concealment works as for a single stream.
+    EXPECT_EQ(static_cast<int>(kOpus20msFrameSamples),
+              WebRtcOpus_DecodePlc(decoder, output.data(), 1));
+
+    EXPECT_EQ(0, WebRtcOpus_EncoderFree(encoder));
+    EXPECT_EQ(0, WebRtcOpus_DecoderFree(decoder));
+  }
+}
+
 
 }  // namespace webrtc
@@ -12,11 +12,18 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "rtc_base/checks.h"
 
 namespace webrtc {
+namespace {
+// With |adapt_to_packet_loss|, one more earlier encoding is sent for each of
+// these uplink packet loss fractions that is reached.
+const float kRedundancyLossThresholds[] = {0.02f, 0.1f, 0.2f};
+}  // namespace
 
 AudioEncoderCopyRed::Config::Config() = default;
 AudioEncoderCopyRed::Config::Config(Config&&) = default;
@@ -24,7 +31,13 @@ AudioEncoderCopyRed::Config::~Config() = default;
 
 AudioEncoderCopyRed::AudioEncoderCopyRed(Config&& config)
     : speech_encoder_(std::move(config.speech_encoder)),
-      red_payload_type_(config.payload_type) {
+      red_payload_type_(config.payload_type),
+      max_redundant_encodings_(config.num_redundant_encodings),
+      adapt_to_packet_loss_(config.adapt_to_packet_loss),
+      num_redundant_encodings_(
+          adapt_to_packet_loss_
+              ? std::min<size_t>(1, config.num_redundant_encodings)
+              : config.num_redundant_encodings) {
   RTC_CHECK(speech_encoder_) << "Speech encoder not provided.";
 }
 
@@ -51,7 +64,10 @@ size_t AudioEncoderCopyRed::Max10MsFramesInAPacket() const {
 }
 
 int AudioEncoderCopyRed::GetTargetBitrate() const {
-  return speech_encoder_->GetTargetBitrate();
+  if (!adapt_to_packet_loss_)
+    return speech_encoder_->GetTargetBitrate();
+  return speech_encoder_->GetTargetBitrate() *
+         static_cast<int>(1 + num_redundant_encodings_);
 }
 
 AudioEncoder::EncodedInfo AudioEncoderCopyRed::EncodeImpl(
@@ -72,15 +88,26 @@ AudioEncoder::EncodedInfo AudioEncoderCopyRed::EncodeImpl(
     // intentional.
     info.redundant.push_back(info);
     RTC_DCHECK_EQ(info.redundant.size(), 1);
-    if (secondary_info_.encoded_bytes > 0) {
-      encoded->AppendData(secondary_encoded_);
-      info.redundant.push_back(secondary_info_);
-      RTC_DCHECK_EQ(info.redundant.size(), 2);
+    for (const auto& redundant : redundant_encodings_) {
+      if (info.redundant.size() > num_redundant_encodings_)
+        break;
+      encoded->AppendData(redundant.second);
+      info.redundant.push_back(redundant.first);
+    }
+    // Save primary as the newest redundant encoding, reusing the buffer of
+    // the oldest one once there are enough.
+    if (max_redundant_encodings_ > 0) {
+      if (redundant_encodings_.size() < max_redundant_encodings_) {
+        redundant_encodings_.emplace_front();
+      } else {
+        redundant_encodings_.splice(redundant_encodings_.begin(),
+                                    redundant_encodings_,
+                                    std::prev(redundant_encodings_.end()));
+      }
+      redundant_encodings_.front().first = info;
+      redundant_encodings_.front().second.SetData(
+          encoded->data() + primary_offset, info.encoded_bytes);
     }
-    // Save primary to secondary.
-    secondary_encoded_.SetData(encoded->data() + primary_offset,
-                               info.encoded_bytes);
-    secondary_info_ = info;
     RTC_DCHECK_EQ(info.speech, info.redundant[0].speech);
   }
   // Update main EncodedInfo.
@@ -95,12 +122,16 @@ AudioEncoder::EncodedInfo AudioEncoderCopyRed::EncodeImpl(
 
 void AudioEncoderCopyRed::Reset() {
   speech_encoder_->Reset();
-  secondary_encoded_.Clear();
-  secondary_info_.encoded_bytes = 0;
+  redundant_encodings_.clear();
 }
 
 bool AudioEncoderCopyRed::SetFec(bool enable) {
-  return speech_encoder_->SetFec(enable);
+  const bool success = speech_encoder_->SetFec(enable);
+  if (success)
+    fec_enabled_ = enable;
+  if (adapt_to_packet_loss_)
+    UpdateRedundancy();
+  return success;
 }
 
 bool AudioEncoderCopyRed::SetDtx(bool enable) {
@@ -124,6 +155,10 @@ void AudioEncoderCopyRed::OnReceivedUplinkPacketLossFraction(
     float uplink_packet_loss_fraction) {
   speech_encoder_->OnReceivedUplinkPacketLossFraction(
       uplink_packet_loss_fraction);
+  if (adapt_to_packet_loss_) {
+    packet_loss_fraction_ = uplink_packet_loss_fraction;
+    UpdateRedundancy();
+  }
 }
 
 void AudioEncoderCopyRed::OnReceivedUplinkRecoverablePacketLossFraction(
@@ -135,8 +170,39 @@ void AudioEncoderCopyRed::OnReceivedUplinkRecoverablePacketLossFraction(
 void AudioEncoderCopyRed::OnReceivedUplinkBandwidth(
     int target_audio_bitrate_bps,
     rtc::Optional<int64_t> bwe_period_ms) {
-  speech_encoder_->OnReceivedUplinkBandwidth(target_audio_bitrate_bps,
-                                             bwe_period_ms);
+  if (!adapt_to_packet_loss_) {
+    speech_encoder_->OnReceivedUplinkBandwidth(target_audio_bitrate_bps,
+                                               bwe_period_ms);
+    return;
+  }
+  target_audio_bitrate_bps_ = target_audio_bitrate_bps;
+  bwe_period_ms_ = bwe_period_ms;
+  speech_encoder_->OnReceivedUplinkBandwidth(
+      target_audio_bitrate_bps / static_cast<int>(1 + num_redundant_encodings_),
+      bwe_period_ms);
+}
+
+void AudioEncoderCopyRed::UpdateRedundancy() {
+  size_t num_redundant_encodings = 0;
+  for (float threshold : kRedundancyLossThresholds) {
+    if (packet_loss_fraction_ >= threshold)
+      ++num_redundant_encodings;
+  }
+  // In-band FEC already recovers single losses, so one earlier encoding
+  // fewer is needed for the same protection.
+  if (fec_enabled_ && num_redundant_encodings > 0)
+    --num_redundant_encodings;
+  num_redundant_encodings =
+      std::min(num_redundant_encodings, max_redundant_encodings_);
+  if (num_redundant_encodings == num_redundant_encodings_)
+    return;
+  num_redundant_encodings_ = num_redundant_encodings;
+  if (target_audio_bitrate_bps_) {
+    speech_encoder_->OnReceivedUplinkBandwidth(
+        *target_audio_bitrate_bps_ /
+            static_cast<int>(1 + num_redundant_encodings_),
+        bwe_period_ms_);
+  }
 }
 
 }  // namespace webrtc
@@ -11,7 +11,9 @@
 #ifndef MODULES_AUDIO_CODING_CODECS_RED_AUDIO_ENCODER_COPY_RED_H_
 #define MODULES_AUDIO_CODING_CODECS_RED_AUDIO_ENCODER_COPY_RED_H_
 
+#include <list>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "api/audio_codecs/audio_encoder.h"
@@ -22,8 +24,9 @@ namespace webrtc {
 
 // This class implements redundant audio coding. The class object will have an
 // underlying AudioEncoder object that performs the actual encodings. The
-// current class will gather the two latest encodings from the underlying codec
-// into one packet.
+// current class will gather the latest encoding and up to
+// |num_redundant_encodings| earlier ones from the underlying codec into one
+// packet.
 class AudioEncoderCopyRed final : public AudioEncoder {
  public:
   struct Config {
@@ -32,6 +35,13 @@ class AudioEncoderCopyRed final : public AudioEncoder {
     ~Config();
     int payload_type;
     std::unique_ptr<AudioEncoder> speech_encoder;
+    // The number of earlier encodings to send along with each new one.
+    size_t num_redundant_encodings = 1;
+    // If set, the number of earlier encodings that are sent follows the
+    // uplink packet loss, up to |num_redundant_encodings|, and the speech
+    // encoder gets the share of the target bitrate that keeps the total
+    // within it.
+    bool adapt_to_packet_loss = false;
   };
 
   explicit AudioEncoderCopyRed(Config&& config);
@@ -44,6 +54,8 @@ class AudioEncoderCopyRed final : public AudioEncoder {
   size_t Num10MsFramesInNextPacket() const override;
   size_t Max10MsFramesInAPacket() const override;
   int GetTargetBitrate() const override;
+  // The number of earlier encodings currently sent with each new one.
+  size_t num_redundant_encodings() const { return num_redundant_encodings_; }
   void Reset() override;
   bool SetFec(bool enable) override;
   bool SetDtx(bool enable) override;
@@ -65,10 +77,21 @@ class AudioEncoderCopyRed final : public AudioEncoder {
                          rtc::Buffer* encoded) override;
 
  private:
+  // Picks the number of redundant encodings for the last reported packet loss
+  // and updates the speech encoder's share of the target bitrate.
+  void UpdateRedundancy();
+
   std::unique_ptr<AudioEncoder> speech_encoder_;
   int red_payload_type_;
-  rtc::Buffer secondary_encoded_;
-  EncodedInfoLeaf secondary_info_;
+  const size_t max_redundant_encodings_;
+  const bool adapt_to_packet_loss_;
+  size_t num_redundant_encodings_;
+  // The latest |max_redundant_encodings_| encodings, newest first.
+  std::list<std::pair<EncodedInfoLeaf, rtc::Buffer>> redundant_encodings_;
+  bool fec_enabled_ = false;
+  float packet_loss_fraction_ = 0.f;
+  rtc::Optional<int> target_audio_bitrate_bps_;
+  rtc::Optional<int64_t> bwe_period_ms_;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioEncoderCopyRed);
 };
 
@@ -17,6 +17,7 @@
 #include "test/gtest.h"
 #include "test/mock_audio_encoder.h"
 
+using ::testing::AnyNumber;
 using ::testing::Return;
 using ::testing::_;
 using ::testing::SetArgPointee;
@@ -33,16 +34,24 @@ static const size_t kMaxNumSamples = 48 * 10 * 2;  // 10 ms @ 48 kHz stereo.
 class AudioEncoderCopyRedTest : public ::testing::Test {
  protected:
   AudioEncoderCopyRedTest()
-      : mock_encoder_(new MockAudioEncoder),
-        timestamp_(4711),
+      : timestamp_(4711),
         sample_rate_hz_(16000),
         num_audio_samples_10ms(sample_rate_hz_ / 100),
         red_payload_type_(200) {
+    CreateRed(1, false);
+    memset(audio_, 0, sizeof(audio_));
+  }
+
+  // Replaces |red_| and |mock_encoder_| with ones using the given redundancy
+  // settings.
+  void CreateRed(size_t num_redundant_encodings, bool adapt_to_packet_loss) {
+    mock_encoder_ = new MockAudioEncoder;
     AudioEncoderCopyRed::Config config;
     config.payload_type = red_payload_type_;
+    config.num_redundant_encodings = num_redundant_encodings;
+    config.adapt_to_packet_loss = adapt_to_packet_loss;
     config.speech_encoder = std::unique_ptr<AudioEncoder>(mock_encoder_);
     red_.reset(new AudioEncoderCopyRed(std::move(config)));
-    memset(audio_, 0, sizeof(audio_));
     EXPECT_CALL(*mock_encoder_, NumChannels()).WillRepeatedly(Return(1U));
     EXPECT_CALL(*mock_encoder_, SampleRateHz())
         .WillRepeatedly(Return(sample_rate_hz_));
@@ -181,6 +190,71 @@ TEST_F(AudioEncoderCopyRedTest, CheckPayloadSizes) {
   }
 }
 
+// Checks that up to |num_redundant_encodings| earlier payloads are added,
+// newest first.
+TEST_F(AudioEncoderCopyRedTest, CheckMultipleRedundantPayloadSizes) {
+  CreateRed(2, false);
+  static const int kNumPackets = 10;
+  InSequence s;
+  for (int encode_size = 1; encode_size <= kNumPackets; ++encode_size) {
+    EXPECT_CALL(*mock_encoder_, EncodeImpl(_, _, _))
+        .WillOnce(Invoke(MockAudioEncoder::FakeEncoding(encode_size)));
+  }
+
+  Encode();
+  EXPECT_EQ(1u, encoded_info_.redundant.size());
+  Encode();
+  EXPECT_EQ(2u, encoded_info_.redundant.size());
+  EXPECT_EQ(3u, encoded_info_.encoded_bytes);
+
+  for (size_t i = 3; i <= kNumPackets; ++i) {
+    Encode();
+    ASSERT_EQ(3u, encoded_info_.redundant.size());
+    EXPECT_EQ(i, encoded_info_.redundant[0].encoded_bytes);
+    EXPECT_EQ(i - 1, encoded_info_.redundant[1].encoded_bytes);
+    EXPECT_EQ(i - 2, encoded_info_.redundant[2].encoded_bytes);
+    EXPECT_EQ(i + i - 1 + i - 2, encoded_info_.encoded_bytes);
+    EXPECT_EQ(i + i - 1 + i - 2, encoded_.size());
+  }
+}
+
+// Checks that the number of redundant payloads follows the packet loss, and
+// that the target bitrate is shared between them.
+TEST_F(AudioEncoderCopyRedTest, CheckRedundancyAdaptsToPacketLoss) {
+  CreateRed(3, true);
+  EXPECT_EQ(1u, red_->num_redundant_encodings());
+  EXPECT_CALL(*mock_encoder_, OnReceivedUplinkPacketLossFraction(_))
+      .Times(AnyNumber());
+  EXPECT_CALL(*mock_encoder_,
+              OnReceivedUplinkBandwidth(30000, rtc::Optional<int64_t>()));
+  red_->OnReceivedUplinkBandwidth(60000, rtc::nullopt);
+
+  EXPECT_CALL(*mock_encoder_,
+              OnReceivedUplinkBandwidth(60000, rtc::Optional<int64_t>()));
+  red_->OnReceivedUplinkPacketLossFraction(0.f);
+  EXPECT_EQ(0u, red_->num_redundant_encodings());
+
+  EXPECT_CALL(*mock_encoder_,
+              OnReceivedUplinkBandwidth(20000, rtc::Optional<int64_t>()));
+  red_->OnReceivedUplinkPacketLossFraction(0.15f);
+  EXPECT_EQ(2u, red_->num_redundant_encodings());
+
+  EXPECT_CALL(*mock_encoder_,
+              OnReceivedUplinkBandwidth(15000, rtc::Optional<int64_t>()));
+  red_->OnReceivedUplinkPacketLossFraction(0.5f);
+  EXPECT_EQ(3u, red_->num_redundant_encodings());
+
+  // With in-band FEC, one earlier payload fewer is sent.
+  EXPECT_CALL(*mock_encoder_, SetFec(true)).WillOnce(Return(true));
+  EXPECT_CALL(*mock_encoder_,
+              OnReceivedUplinkBandwidth(20000, rtc::Optional<int64_t>()));
+  EXPECT_TRUE(red_->SetFec(true));
+  EXPECT_EQ(2u, red_->num_redundant_encodings());
+
+  EXPECT_CALL(*mock_encoder_, GetTargetBitrate()).WillOnce(Return(20000));
+  EXPECT_EQ(60000, red_->GetTargetBitrate());
+}
+
 // Checks that the correct timestamps are returned.
 TEST_F(AudioEncoderCopyRedTest, CheckTimestamps) {
   uint32_t primary_timestamp = timestamp_;
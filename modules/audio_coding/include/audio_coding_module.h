@@ -285,6 +285,12 @@ class AudioCodingModule {
   //
   virtual int32_t Add10MsData(const AudioFrame& audio_frame) = 0;
 
+  // Same as above, but |input_timestamp| is used as the timestamp of the audio
+  // instead of |audio_frame.timestamp_|. This allows a frame that is shared
+  // with other encoders to be added without being modified.
+  virtual int32_t Add10MsData(const AudioFrame& audio_frame,
+                              uint32_t input_timestamp) = 0;
+
   ///////////////////////////////////////////////////////////////////////////
   // (RED) Redundant Coding
   //
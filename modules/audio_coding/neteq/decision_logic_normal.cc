@@ -158,7 +158,12 @@ Operations DecisionLogicNormal::ExpectedPacketAvailable(Modes prev_mode,
     // Check criterion for time-stretching.
     int low_limit, high_limit;
     delay_manager_->BufferLimits(&low_limit, &high_limit);
-    if (buffer_level_filter_->filtered_current_level() >= high_limit << 2)
+    // Low-latency mode has little headroom, so it fast-accelerates at twice
+    // the high limit already instead of four times.
+    const int fast_accelerate_shift =
+        delay_manager_->low_latency_mode() ? 1 : 2;
+    if (buffer_level_filter_->filtered_current_level() >=
+        high_limit << fast_accelerate_shift)
       return kFastAccelerate;
     if (TimescaleAllowed()) {
       if (buffer_level_filter_->filtered_current_level() >= high_limit)
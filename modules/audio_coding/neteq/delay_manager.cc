@@ -19,6 +19,7 @@
 #include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_coding/neteq/delay_peak_detector.h"
 #include "modules/include/module_common_types.h"
+#include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
 #include "system_wrappers/include/field_trial.h"
@@ -47,7 +48,10 @@ DelayManager::DelayManager(size_t max_packets_in_buffer,
       peak_detector_(*peak_detector),
       last_pack_cng_or_dtmf_(1),
       frame_length_change_experiment_(
-          field_trial::IsEnabled("WebRTC-Audio-NetEqFramelengthExperiment")) {
+          field_trial::IsEnabled("WebRTC-Audio-NetEqFramelengthExperiment")),
+      low_latency_mode_(false),
+      low_latency_min_delay_ms_(0),
+      delay_quantile_estimator_(kLowLatencyQuantile) {
   assert(peak_detector);  // Should never be NULL.
   Reset();
 }
@@ -110,7 +114,9 @@ int DelayManager::Update(uint16_t sequence_number,
     // Calculate inter-arrival time (IAT) in integer "packet times"
     // (rounding down). This is the value used as index to the histogram
     // vector |iat_vector_|.
-    int iat_packets = packet_iat_stopwatch_->ElapsedMs() / packet_len_ms;
+    const int iat_ms = rtc::saturated_cast<int>(
+        packet_iat_stopwatch_->ElapsedMs());
+    int iat_packets = iat_ms / packet_len_ms;
 
     if (streaming_mode_) {
       UpdateCumulativeSums(packet_len_ms, sequence_number);
@@ -131,10 +137,16 @@ int DelayManager::Update(uint16_t sequence_number,
     const int max_iat = kMaxIat;
     iat_packets = std::min(iat_packets, max_iat);
     UpdateHistogram(iat_packets);
-    // Calculate new |target_level_| based on updated statistics.
-    target_level_ = CalculateTargetLevel(iat_packets);
-    if (streaming_mode_) {
-      target_level_ = std::max(target_level_, max_iat_cumulative_sum_);
+    if (low_latency_mode_) {
+      CalculateLowLatencyTargetLevel(
+          UpdateRelativeDelay(iat_ms, timestamp, sample_rate_hz),
+          packet_len_ms);
+    } else {
+      // Calculate new |target_level_| based on updated statistics.
+      target_level_ = CalculateTargetLevel(iat_packets);
+      if (streaming_mode_) {
+        target_level_ = std::max(target_level_, max_iat_cumulative_sum_);
+      }
     }
 
     LimitTargetLevel();
@@ -172,6 +184,43 @@ void DelayManager::UpdateCumulativeSums(int packet_len_ms,
   }
 }
 
+// The packet's delay relative to the previous packet is its inter-arrival time
+// minus the time between their timestamps. Accumulating these over the history
+// window, without going below zero, gives the delay relative to the earliest
+// arriving packet in the window.
+int DelayManager::UpdateRelativeDelay(int iat_ms,
+                                      uint32_t timestamp,
+                                      int sample_rate_hz) {
+  const int64_t expected_iat_ms =
+      1000 * static_cast<int64_t>(
+                 static_cast<int32_t>(timestamp - last_timestamp_)) /
+      sample_rate_hz;
+  const int64_t now_ms =
+      rtc::dchecked_cast<int64_t>(tick_timer_->ticks()) *
+      tick_timer_->ms_per_tick();
+  delay_history_.push_back(
+      {rtc::saturated_cast<int>(iat_ms - expected_iat_ms), now_ms});
+  while (now_ms - delay_history_.front().arrival_time_ms > kDelayHistoryMs) {
+    delay_history_.pop_front();
+  }
+  int relative_delay_ms = 0;
+  for (const DelayHistoryEntry& entry : delay_history_) {
+    relative_delay_ms = std::max(relative_delay_ms + entry.iat_delay_ms, 0);
+  }
+  return relative_delay_ms;
+}
+
+void DelayManager::CalculateLowLatencyTargetLevel(int relative_delay_ms,
+                                                  int packet_len_ms) {
+  RTC_DCHECK_GT(packet_len_ms, 0);
+  delay_quantile_estimator_.Update(relative_delay_ms);
+  const int target_ms = std::max(delay_quantile_estimator_.Quantile(),
+                                 low_latency_min_delay_ms_);
+  // The buffer level filter only distinguishes whole packets.
+  base_target_level_ = std::max(target_ms / packet_len_ms, 1);
+  target_level_ = (target_ms << 8) / packet_len_ms;
+}
+
 // Each element in the vector is first multiplied by the forgetting factor
 // |iat_factor_|. Then the vector element indicated by |iat_packets| is then
 // increased (additive) by 1 - |iat_factor_|. This way, the probability of
@@ -250,8 +299,14 @@ void DelayManager::LimitTargetLevel() {
       static_cast<int>((3 * (max_packets_in_buffer_ << 8)) / 4);
   target_level_ = std::min(target_level_, max_buffer_packets_q8);
 
-  // Sanity check, at least 1 packet (in Q8).
-  target_level_ = std::max(target_level_, 1 << 8);
+  // Sanity check, at least 1 packet (in Q8). In low-latency mode the floor is
+  // |low_latency_min_delay_ms_| instead.
+  int min_target_level = 1 << 8;
+  if (low_latency_mode_ && packet_len_ms_ > 0) {
+    min_target_level =
+        std::max((low_latency_min_delay_ms_ << 8) / packet_len_ms_, 1);
+  }
+  target_level_ = std::max(target_level_, min_target_level);
 }
 
 int DelayManager::CalculateTargetLevel(int iat_packets) {
@@ -325,6 +380,18 @@ void DelayManager::Reset() {
   iat_cumulative_sum_ = 0;
   max_iat_cumulative_sum_ = 0;
   last_pack_cng_or_dtmf_ = 1;
+  delay_quantile_estimator_.Reset();
+  delay_history_.clear();
+}
+
+void DelayManager::EnableLowLatencyMode(int min_delay_ms) {
+  RTC_DCHECK_GT(min_delay_ms, 0);
+  low_latency_mode_ = true;
+  low_latency_min_delay_ms_ = min_delay_ms;
+}
+
+bool DelayManager::low_latency_mode() const {
+  return low_latency_mode_;
 }
 
 double DelayManager::EstimatedClockDriftPpm() const {
@@ -358,16 +425,18 @@ void DelayManager::BufferLimits(int* lower_limit, int* higher_limit) const {
     return;
   }
 
-  int window_20ms = 0x7FFF;  // Default large value for legacy bit-exactness.
+  int window = 0x7FFF;  // Default large value for legacy bit-exactness.
   if (packet_len_ms_ > 0) {
-    window_20ms = (20 << 8) / packet_len_ms_;
+    // 20 ms, or 10 ms in low-latency mode to accelerate sooner.
+    const int window_ms = low_latency_mode_ ? 10 : 20;
+    window = (window_ms << 8) / packet_len_ms_;
   }
 
   // |target_level_| is in Q8 already.
   *lower_limit = (target_level_ * 3) / 4;
   // |higher_limit| is equal to |target_level_|, but should at
-  // least be 20 ms higher than |lower_limit_|.
-  *higher_limit = std::max(target_level_, *lower_limit + window_20ms);
+  // least be |window| higher than |lower_limit_|.
+  *higher_limit = std::max(target_level_, *lower_limit + window);
 }
 
 int DelayManager::TargetLevel() const {
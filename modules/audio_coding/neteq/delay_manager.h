@@ -13,9 +13,11 @@
 
 #include <string.h>  // Provide access to size_t.
 
+#include <deque>
 #include <memory>
 #include <vector>
 
+#include "modules/audio_coding/neteq/delay_quantile_estimator.h"
 #include "modules/audio_coding/neteq/tick_timer.h"
 #include "rtc_base/constructormagic.h"
 #include "typedefs.h"  // NOLINT(build/include)
@@ -65,6 +67,14 @@ class DelayManager {
   // Resets the DelayManager and the associated DelayPeakDetector.
   virtual void Reset();
 
+  // Switches to low-latency mode, meant for links with little jitter. The
+  // target level is then a quantile of the packet arrival delay rather than
+  // derived from the IAT histogram and the peak detector, and it may go below
+  // one packet, down to |min_delay_ms|. The buffer limits are also tighter,
+  // so that NetEq accelerates sooner. Survives Reset().
+  virtual void EnableLowLatencyMode(int min_delay_ms);
+  virtual bool low_latency_mode() const;
+
   // Calculates the average inter-arrival time deviation from the histogram.
   // The result is returned as parts-per-million deviation from the nominal
   // inter-arrival time. That is, if the average inter-arrival time is equal to
@@ -125,6 +135,11 @@ class DelayManager {
   // Steady-state forgetting factor for |iat_vector_|, 0.9993 in Q15.
   static const int kIatFactor_ = 32745;
   static const int kMaxIat = 64;  // Max inter-arrival time to register.
+  // Quantile of the arrival delay used as target in low-latency mode, 0.95 in
+  // Q30 to match |kLimitProbability|.
+  static const int kLowLatencyQuantile = 1020054733;
+  // Arrival delays are relative to the earliest packet in this window.
+  static const int kDelayHistoryMs = 2000;
 
   // Sets |iat_vector_| to the default start distribution and sets the
   // |base_target_level_| and |target_level_| to the corresponding values.
@@ -139,6 +154,16 @@ class DelayManager {
   // all other entries are decreased. This method is called by Update().
   void UpdateHistogram(size_t iat_packets);
 
+  // Returns the arrival delay of the packet with |timestamp|, relative to the
+  // earliest arriving packet in the last |kDelayHistoryMs|, and records the
+  // packet. Used in low-latency mode.
+  int UpdateRelativeDelay(int iat_ms, uint32_t timestamp, int sample_rate_hz);
+
+  // Computes |target_level_| in low-latency mode. Called by Update() instead
+  // of CalculateTargetLevel().
+  void CalculateLowLatencyTargetLevel(int relative_delay_ms,
+                                      int packet_len_ms);
+
   // Makes sure that |target_level_| is not too large, taking
   // |max_packets_in_buffer_| and |extra_delay_ms_| into account. This method is
   // called by Update().
@@ -173,6 +198,16 @@ class DelayManager {
   DelayPeakDetector& peak_detector_;
   int last_pack_cng_or_dtmf_;
   const bool frame_length_change_experiment_;
+  bool low_latency_mode_;
+  int low_latency_min_delay_ms_;
+  DelayQuantileEstimator delay_quantile_estimator_;
+  // Arrival time minus expected arrival time, in ms, and arrival time for
+  // the packets in the last |kDelayHistoryMs|.
+  struct DelayHistoryEntry {
+    int iat_delay_ms;
+    int64_t arrival_time_ms;
+  };
+  std::deque<DelayHistoryEntry> delay_history_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(DelayManager);
 };
@@ -14,6 +14,8 @@
 
 #include <math.h>
 
+#include <algorithm>
+
 #include "modules/audio_coding/neteq/mock/mock_delay_peak_detector.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -335,6 +337,47 @@ TEST_F(DelayManagerTest, Failures) {
   EXPECT_FALSE(dm_->SetMaximumDelay(60));
 }
 
+TEST_F(DelayManagerTest, LowLatencyTargetBelowOnePacket) {
+  dm_->EnableLowLatencyMode(10);
+  SetPacketAudioLength(kFrameSizeMs);
+  // The peak detector is not used in low-latency mode.
+  EXPECT_CALL(detector_, Update(_, _)).Times(0);
+  InsertNextPacket();
+  for (int i = 0; i < 50; ++i) {
+    IncreaseTime(kFrameSizeMs);
+    InsertNextPacket();
+  }
+  // Without jitter the target is the 10 ms floor, half a packet.
+  EXPECT_EQ((10 << 8) / kFrameSizeMs, dm_->TargetLevel());
+  EXPECT_EQ(1, dm_->base_target_level());
+  int lower, higher;
+  dm_->BufferLimits(&lower, &higher);
+  // Lower limit is 75% of the target; the higher limit 10 ms above it.
+  EXPECT_EQ(dm_->TargetLevel() * 3 / 4, lower);
+  EXPECT_EQ(lower + (10 << 8) / kFrameSizeMs, higher);
+
+  EXPECT_CALL(detector_, Reset());
+  dm_->Reset();
+  EXPECT_TRUE(dm_->low_latency_mode());
+}
+
+TEST_F(DelayManagerTest, LowLatencyTargetFollowsDelayQuantile) {
+  dm_->EnableLowLatencyMode(10);
+  SetPacketAudioLength(kFrameSizeMs);
+  // Every tenth packet is 40 ms late, which also delays the one after it.
+  const int kLateMs = 40;
+  int arrival_time_ms = 0;
+  for (int i = 0; i < 500; ++i) {
+    int next_arrival_ms = i * kFrameSizeMs + (i % 10 == 0 ? kLateMs : 0);
+    next_arrival_ms = std::max(next_arrival_ms, arrival_time_ms);
+    IncreaseTime(next_arrival_ms - arrival_time_ms);
+    arrival_time_ms = next_arrival_ms;
+    InsertNextPacket();
+  }
+  EXPECT_EQ((kLateMs << 8) / kFrameSizeMs, dm_->TargetLevel());
+  EXPECT_EQ(kLateMs / kFrameSizeMs, dm_->base_target_level());
+}
+
 // Test if the histogram is stretched correctly if the packet size is decreased.
 TEST(DelayManagerIATScalingTest, StretchTest) {
   using IATVector = DelayManager::IATVector;
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/delay_quantile_estimator.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+const int DelayQuantileEstimator::kMaxDelayMs;
+
+DelayQuantileEstimator::DelayQuantileEstimator(int quantile_q30)
+    : quantile_q30_(quantile_q30), histogram_(kMaxDelayMs + 1, 0) {
+  RTC_DCHECK_GT(quantile_q30_, 0);
+  RTC_DCHECK_LE(quantile_q30_, 1 << 30);
+  Reset();
+}
+
+DelayQuantileEstimator::~DelayQuantileEstimator() = default;
+
+void DelayQuantileEstimator::Update(int delay_ms) {
+  const size_t index = static_cast<size_t>(
+      std::min(std::max(delay_ms, 0), static_cast<int>(kMaxDelayMs)));
+  // Same update as the IAT histogram in DelayManager: scale every bucket by
+  // the forgetting factor and add the remainder to the observed one.
+  for (int& probability : histogram_) {
+    probability = (static_cast<int64_t>(probability) * forget_factor_) >> 15;
+  }
+  histogram_[index] += (32768 - forget_factor_) << 15;
+  forget_factor_ += (kForgetFactor - forget_factor_ + 3) >> 2;
+}
+
+int DelayQuantileEstimator::Quantile() const {
+  // The histogram does not sum to exactly 1 due to rounding, so compare
+  // against the quantile of the actual sum.
+  int64_t sum = 0;
+  for (int probability : histogram_)
+    sum += probability;
+  const int64_t limit = (sum * quantile_q30_) >> 30;
+  int64_t cumulative = 0;
+  for (size_t i = 0; i < histogram_.size(); ++i) {
+    cumulative += histogram_[i];
+    if (cumulative >= limit)
+      return static_cast<int>(i);
+  }
+  return kMaxDelayMs;
+}
+
+void DelayQuantileEstimator::Reset() {
+  std::fill(histogram_.begin(), histogram_.end(), 0);
+  histogram_[0] = 1 << 30;
+  // Adapt quickly to the first observations.
+  forget_factor_ = 0;
+}
+
+}  // namespace webrtc
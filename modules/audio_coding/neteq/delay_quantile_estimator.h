@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_CODING_NETEQ_DELAY_QUANTILE_ESTIMATOR_H_
+#define MODULES_AUDIO_CODING_NETEQ_DELAY_QUANTILE_ESTIMATOR_H_
+
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Estimates a quantile of the packet arrival delay, in ms, from a histogram
+// with 1 ms buckets and exponential forgetting. Used by the DelayManager's
+// low-latency mode instead of the inter-arrival time histogram, which only
+// has a resolution of whole packets.
+class DelayQuantileEstimator {
+ public:
+  // |quantile_q30| is the probability, in Q30, that a delay is less than or
+  // equal to the estimate.
+  explicit DelayQuantileEstimator(int quantile_q30);
+  ~DelayQuantileEstimator();
+
+  // Adds a delay observation. Delays above |kMaxDelayMs| are saturated.
+  void Update(int delay_ms);
+
+  // Returns the estimated delay quantile in ms.
+  int Quantile() const;
+
+  void Reset();
+
+  static const int kMaxDelayMs = 500;
+
+ private:
+  // Steady-state forgetting factor, 0.9993 in Q15, as for the IAT histogram.
+  static const int kForgetFactor = 32745;
+
+  const int quantile_q30_;
+  std::vector<int> histogram_;  // Probabilities in Q30.
+  int forget_factor_;  // Q15. Starts at 0 and converges to |kForgetFactor|.
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DelayQuantileEstimator);
+};
+
+}  // namespace webrtc
+#endif  // MODULES_AUDIO_CODING_NETEQ_DELAY_QUANTILE_ESTIMATOR_H_
@@ -0,0 +1,55 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_coding/neteq/delay_quantile_estimator.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+const int kQuantile95 = 1020054733;  // 0.95 in Q30.
+}  // namespace
+
+TEST(DelayQuantileEstimatorTest, StartsAtZero) {
+  DelayQuantileEstimator estimator(kQuantile95);
+  EXPECT_EQ(0, estimator.Quantile());
+}
+
+TEST(DelayQuantileEstimatorTest, ConvergesToConstantDelay) {
+  DelayQuantileEstimator estimator(kQuantile95);
+  for (int i = 0; i < 100; ++i)
+    estimator.Update(7);
+  EXPECT_EQ(7, estimator.Quantile());
+}
+
+TEST(DelayQuantileEstimatorTest, FindsQuantileOfMixedDelays) {
+  DelayQuantileEstimator estimator(kQuantile95);
+  // 10% of the packets are 40 ms late, the rest arrive on time.
+  for (int i = 0; i < 5000; ++i)
+    estimator.Update(i % 10 == 0 ? 40 : 0);
+  EXPECT_EQ(40, estimator.Quantile());
+
+  // With only 2% late packets, the 95th percentile is on time.
+  for (int i = 0; i < 20000; ++i)
+    estimator.Update(i % 50 == 0 ? 40 : 0);
+  EXPECT_EQ(0, estimator.Quantile());
+}
+
+TEST(DelayQuantileEstimatorTest, SaturatesLargeDelays) {
+  DelayQuantileEstimator estimator(kQuantile95);
+  for (int i = 0; i < 100; ++i)
+    estimator.Update(10 * DelayQuantileEstimator::kMaxDelayMs);
+  EXPECT_EQ(DelayQuantileEstimator::kMaxDelayMs, estimator.Quantile());
+  estimator.Reset();
+  EXPECT_EQ(0, estimator.Quantile());
+}
+
+}  // namespace webrtc
@@ -101,6 +101,19 @@ class NetEq {
     NetEqPlayoutMode playout_mode = kPlayoutOn;
     bool enable_fast_accelerate = false;
     bool enable_muted_state = false;
+    // Only used together with |enable_muted_state|. When the sender has
+    // stopped transmitting (e.g. Opus DTX) and codec-internal comfort noise
+    // has been played for |dtx_muted_state_delay_ms|, NetEq goes idle and
+    // returns muted frames without decoding comfort noise, until the next
+    // speech packet is due.
+    bool enable_dtx_muted_state = false;
+    int dtx_muted_state_delay_ms = 200;
+    // Low-latency mode for links with little jitter. The target delay follows
+    // a quantile of the packet arrival delay, with a floor of
+    // |low_latency_min_delay_ms|, and NetEq accelerates sooner. Implies
+    // |enable_fast_accelerate|.
+    bool enable_low_latency = false;
+    int low_latency_min_delay_ms = 10;
     rtc::Optional<AudioCodecPairId> codec_pair_id;
   };
 
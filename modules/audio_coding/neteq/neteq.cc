@@ -34,7 +34,12 @@ std::string NetEq::Config::ToString() const {
      << ", playout_mode=" << playout_mode
      << ", enable_fast_accelerate="
      << (enable_fast_accelerate ? " true": "false")
-     << ", enable_muted_state=" << (enable_muted_state ? " true": "false");
+     << ", enable_muted_state=" << (enable_muted_state ? " true": "false")
+     << ", enable_dtx_muted_state="
+     << (enable_dtx_muted_state ? "true" : "false")
+     << ", dtx_muted_state_delay_ms=" << dtx_muted_state_delay_ms
+     << ", enable_low_latency=" << (enable_low_latency ? "true" : "false")
+     << ", low_latency_min_delay_ms=" << low_latency_min_delay_ms;
   return ss.str();
 }
 
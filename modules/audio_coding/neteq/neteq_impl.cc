@@ -102,9 +102,13 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
       ssrc_(0),
       first_packet_(true),
       playout_mode_(config.playout_mode),
-      enable_fast_accelerate_(config.enable_fast_accelerate),
+      enable_fast_accelerate_(config.enable_fast_accelerate ||
+                              config.enable_low_latency),
       nack_enabled_(false),
       enable_muted_state_(config.enable_muted_state),
+      enable_dtx_muted_state_(config.enable_muted_state &&
+                              config.enable_dtx_muted_state),
+      dtx_muted_state_delay_ms_(config.dtx_muted_state_delay_ms),
       expand_uma_logger_("WebRTC.Audio.ExpandRatePercent",
                          10,  // Report once every 10 s.
                          tick_timer_.get()),
@@ -119,6 +123,9 @@ NetEqImpl::NetEqImpl(const NetEq::Config& config,
     fs = 8000;
   }
   delay_manager_->SetMaximumDelay(config.max_delay_ms);
+  if (config.enable_low_latency) {
+    delay_manager_->EnableLowLatencyMode(config.low_latency_min_delay_ms);
+  }
   fs_hz_ = fs;
   fs_mult_ = fs / 8000;
   last_output_sample_rate_hz_ = fs;
@@ -850,22 +857,23 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame, bool* muted) {
   // Check for muted state.
   if (enable_muted_state_ && expand_->Muted() && packet_buffer_->Empty()) {
     RTC_DCHECK_EQ(last_mode_, kModeExpand);
-    audio_frame->Reset();
-    RTC_DCHECK(audio_frame->muted());  // Reset() should mute the frame.
     playout_timestamp_ += static_cast<uint32_t>(output_size_samples_);
-    audio_frame->sample_rate_hz_ = fs_hz_;
-    audio_frame->samples_per_channel_ = output_size_samples_;
-    audio_frame->timestamp_ =
-        first_packet_
-            ? 0
-            : timestamp_scaler_->ToExternal(playout_timestamp_) -
-                  static_cast<uint32_t>(audio_frame->samples_per_channel_);
-    audio_frame->num_channels_ = sync_buffer_->Channels();
+    GetMutedAudio(audio_frame);
     stats_.ExpandedNoiseSamples(output_size_samples_, false);
     *muted = true;
     return 0;
   }
 
+  // Check for DTX muted state. While no packets are buffered, the comfort
+  // noise is neither decoded nor analyzed. Occasional DTX update packets are
+  // still decoded, to keep the decoder state, but their output stays muted.
+  const bool dtx_muted = InDtxMutedState();
+  if (dtx_muted && packet_buffer_->Empty()) {
+    GetMutedAudio(audio_frame);
+    *muted = true;
+    return 0;
+  }
+
   int return_value = GetDecision(&operation, &packet_list, &dtmf_event,
                                  &play_dtmf);
   if (return_value != 0) {
@@ -1076,10 +1084,39 @@ int NetEqImpl::GetAudioInternal(AudioFrame* audio_frame, bool* muted) {
     generated_noise_stopwatch_.reset();
   }
 
+  if (last_mode_ != kModeCodecInternalCng) {
+    codec_internal_cng_stopwatch_.reset();
+  } else if (!codec_internal_cng_stopwatch_) {
+    codec_internal_cng_stopwatch_ = tick_timer_->GetNewStopwatch();
+  } else if (dtx_muted && !play_dtmf) {
+    audio_frame->Mute();
+    *muted = true;
+  }
+
   if (decode_return_value) return decode_return_value;
   return return_value;
 }
 
+void NetEqImpl::GetMutedAudio(AudioFrame* audio_frame) {
+  audio_frame->Reset();
+  RTC_DCHECK(audio_frame->muted());  // Reset() should mute the frame.
+  audio_frame->sample_rate_hz_ = fs_hz_;
+  audio_frame->samples_per_channel_ = output_size_samples_;
+  audio_frame->timestamp_ =
+      first_packet_
+          ? 0
+          : timestamp_scaler_->ToExternal(playout_timestamp_) -
+                static_cast<uint32_t>(audio_frame->samples_per_channel_);
+  audio_frame->num_channels_ = sync_buffer_->Channels();
+}
+
+bool NetEqImpl::InDtxMutedState() const {
+  return enable_dtx_muted_state_ && last_mode_ == kModeCodecInternalCng &&
+         codec_internal_cng_stopwatch_ &&
+         codec_internal_cng_stopwatch_->ElapsedMs() >=
+             static_cast<uint64_t>(dtx_muted_state_delay_ms_);
+}
+
 int NetEqImpl::GetDecision(Operations* operation,
                            PacketList* packet_list,
                            DtmfEvent* dtmf_event,
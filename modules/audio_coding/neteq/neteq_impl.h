@@ -252,6 +252,15 @@ class NetEqImpl : public webrtc::NetEq {
   int GetAudioInternal(AudioFrame* audio_frame, bool* muted)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
 
+  // Writes a muted 10 ms frame to |audio_frame|, without touching the sync
+  // buffer.
+  void GetMutedAudio(AudioFrame* audio_frame)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
+  // Returns true if the sender has been in codec-internal DTX long enough for
+  // the output to be muted. See NetEq::Config::enable_dtx_muted_state.
+  bool InDtxMutedState() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
   // Provides a decision to the GetAudioInternal method. The decision what to
   // do is written to |operation|. Packets to decode are written to
   // |packet_list|, and a DTMF event to play is written to |dtmf_event|. When
@@ -434,10 +443,15 @@ class NetEqImpl : public webrtc::NetEq {
   std::unique_ptr<NackTracker> nack_ RTC_GUARDED_BY(crit_sect_);
   bool nack_enabled_ RTC_GUARDED_BY(crit_sect_);
   const bool enable_muted_state_ RTC_GUARDED_BY(crit_sect_);
+  const bool enable_dtx_muted_state_ RTC_GUARDED_BY(crit_sect_);
+  const int dtx_muted_state_delay_ms_ RTC_GUARDED_BY(crit_sect_);
   AudioFrame::VADActivity last_vad_activity_ RTC_GUARDED_BY(crit_sect_) =
       AudioFrame::kVadPassive;
   std::unique_ptr<TickTimer::Stopwatch> generated_noise_stopwatch_
       RTC_GUARDED_BY(crit_sect_);
+  // Measures the time spent in codec-internal CNG mode since the last speech.
+  std::unique_ptr<TickTimer::Stopwatch> codec_internal_cng_stopwatch_
+      RTC_GUARDED_BY(crit_sect_);
   std::vector<uint32_t> last_decoded_timestamps_ RTC_GUARDED_BY(crit_sect_);
   ExpandUmaLogger expand_uma_logger_ RTC_GUARDED_BY(crit_sect_);
   ExpandUmaLogger speech_expand_uma_logger_ RTC_GUARDED_BY(crit_sect_);
@@ -41,6 +41,7 @@ using ::testing::SetArgPointee;
 using ::testing::SetArrayArgument;
 using ::testing::InSequence;
 using ::testing::Invoke;
+using ::testing::InvokeWithoutArgs;
 using ::testing::WithArg;
 using ::testing::Pointee;
 using ::testing::IsNull;
@@ -831,6 +832,119 @@ TEST_F(NetEqImplTest, CodecInternalCng) {
   EXPECT_CALL(mock_decoder, Die());
 }
 
+// This test verifies that NetEq stops generating codec-internal comfort noise
+// and returns muted frames during a long DTX period, when DTX muted state is
+// enabled, and that it resumes normal playout when speech arrives again.
+TEST_F(NetEqImplTest, CodecInternalCngDtxMutedState) {
+  config_.enable_muted_state = true;
+  config_.enable_dtx_muted_state = true;
+  config_.dtx_muted_state_delay_ms = 50;
+  UseNoMocks();
+  CreateInstance();
+
+  const uint8_t kPayloadType = 17;   // Just an arbitrary number.
+  const uint32_t kReceiveTime = 17;  // Value doesn't matter for this test.
+  const int kSampleRateKhz = 48;
+  const size_t kPayloadLengthSamples =
+      static_cast<size_t>(20 * kSampleRateKhz);  // 20 ms.
+  const size_t kPayloadLengthBytes = 10;
+  uint8_t payload[kPayloadLengthBytes] = {0};
+  int16_t dummy_output[kPayloadLengthSamples] = {0};
+
+  RTPHeader rtp_header;
+  rtp_header.payloadType = kPayloadType;
+  rtp_header.sequenceNumber = 0x1234;
+  rtp_header.timestamp = 0x12345678;
+  rtp_header.ssrc = 0x87654321;
+
+  MockAudioDecoder mock_decoder;
+  EXPECT_CALL(mock_decoder, Reset()).WillRepeatedly(Return());
+  EXPECT_CALL(mock_decoder, SampleRateHz())
+      .WillRepeatedly(Return(kSampleRateKhz * 1000));
+  EXPECT_CALL(mock_decoder, Channels()).WillRepeatedly(Return(1));
+  EXPECT_CALL(mock_decoder, IncomingPacket(_, kPayloadLengthBytes, _, _, _))
+      .WillRepeatedly(Return(0));
+  EXPECT_CALL(mock_decoder, PacketDuration(_, kPayloadLengthBytes))
+      .WillRepeatedly(Return(rtc::checked_cast<int>(kPayloadLengthSamples)));
+  EXPECT_CALL(mock_decoder, PacketDuration(nullptr, 0))
+      .WillRepeatedly(Return(rtc::checked_cast<int>(kPayloadLengthSamples)));
+  EXPECT_CALL(mock_decoder, DecodeInternal(Pointee(0), kPayloadLengthBytes,
+                                           kSampleRateKhz * 1000, _, _))
+      .WillOnce(DoAll(SetArrayArgument<3>(dummy_output,
+                                          dummy_output + kPayloadLengthSamples),
+                      SetArgPointee<4>(AudioDecoder::kSpeech),
+                      Return(rtc::checked_cast<int>(kPayloadLengthSamples))));
+  EXPECT_CALL(mock_decoder, DecodeInternal(Pointee(1), kPayloadLengthBytes,
+                                           kSampleRateKhz * 1000, _, _))
+      .WillOnce(DoAll(SetArrayArgument<3>(dummy_output,
+                                          dummy_output + kPayloadLengthSamples),
+                      SetArgPointee<4>(AudioDecoder::kComfortNoise),
+                      Return(rtc::checked_cast<int>(kPayloadLengthSamples))));
+  int num_cng_decodes = 0;
+  EXPECT_CALL(mock_decoder,
+              DecodeInternal(IsNull(), 0, kSampleRateKhz * 1000, _, _))
+      .WillRepeatedly(DoAll(
+          InvokeWithoutArgs([&num_cng_decodes] { ++num_cng_decodes; }),
+          SetArrayArgument<3>(dummy_output,
+                              dummy_output + kPayloadLengthSamples),
+          SetArgPointee<4>(AudioDecoder::kComfortNoise),
+          Return(rtc::checked_cast<int>(kPayloadLengthSamples))));
+  EXPECT_CALL(mock_decoder, DecodeInternal(Pointee(2), kPayloadLengthBytes,
+                                           kSampleRateKhz * 1000, _, _))
+      .WillOnce(DoAll(SetArrayArgument<3>(dummy_output,
+                                          dummy_output + kPayloadLengthSamples),
+                      SetArgPointee<4>(AudioDecoder::kSpeech),
+                      Return(rtc::checked_cast<int>(kPayloadLengthSamples))));
+
+  EXPECT_EQ(NetEq::kOK, neteq_->RegisterExternalDecoder(
+                            &mock_decoder, NetEqDecoder::kDecoderOpus,
+                            "dummy name", kPayloadType));
+
+  // Insert one speech packet followed by one CNG packet.
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->InsertPacket(rtp_header, payload, kReceiveTime));
+  payload[0] = 1;
+  rtp_header.sequenceNumber++;
+  rtp_header.timestamp += kPayloadLengthSamples;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->InsertPacket(rtp_header, payload, kReceiveTime));
+
+  AudioFrame output;
+  bool muted = false;
+  int num_frames = 0;
+  while (!muted) {
+    EXPECT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
+    ASSERT_LT(++num_frames, 20) << "NetEq did not enter DTX muted state.";
+  }
+  EXPECT_TRUE(output.muted());
+  EXPECT_EQ(AudioFrame::kCNG, output.speech_type_);
+  EXPECT_EQ(static_cast<size_t>(10 * kSampleRateKhz),
+            output.samples_per_channel_);
+
+  // No comfort noise is decoded while muted.
+  const int num_cng_decodes_before_muted = num_cng_decodes;
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
+    EXPECT_TRUE(muted);
+  }
+  EXPECT_EQ(num_cng_decodes_before_muted, num_cng_decodes);
+
+  // Insert a speech packet, and verify that NetEq leaves the muted state.
+  payload[0] = 2;
+  rtp_header.sequenceNumber++;
+  rtp_header.timestamp += 30 * kPayloadLengthSamples;
+  EXPECT_EQ(NetEq::kOK,
+            neteq_->InsertPacket(rtp_header, payload, kReceiveTime));
+  num_frames = 0;
+  do {
+    EXPECT_EQ(NetEq::kOK, neteq_->GetAudio(&output, &muted));
+    ASSERT_LT(++num_frames, 20) << "NetEq did not leave DTX muted state.";
+  } while (output.speech_type_ != AudioFrame::kNormalSpeech);
+  EXPECT_FALSE(muted);
+
+  EXPECT_CALL(mock_decoder, Die());
+}
+
 TEST_F(NetEqImplTest, UnsupportedDecoder) {
   UseNoMocks();
   CreateInstance();
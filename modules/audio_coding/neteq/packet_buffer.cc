@@ -8,13 +8,14 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
-// This is the implementation of the PacketBuffer class. It is mostly based on
-// an STL list. The list is kept sorted at all times so that the next packet to
-// decode is at the beginning of the list.
+// This is the implementation of the PacketBuffer class. It is based on a
+// fixed-capacity ring buffer. The buffer is kept sorted at all times so that
+// the next packet to decode is at the beginning of the buffer.
 
 #include "modules/audio_coding/neteq/packet_buffer.h"
 
-#include <algorithm>  // find_if()
+#include <algorithm>
+#include <utility>
 
 #include "api/audio_codecs/audio_decoder.h"
 #include "modules/audio_coding/neteq/decoder_database.h"
@@ -24,21 +25,6 @@
 
 namespace webrtc {
 namespace {
-// Predicate used when inserting packets in the buffer list.
-// Operator() returns true when |packet| goes before |new_packet|.
-class NewTimestampIsLarger {
- public:
-  explicit NewTimestampIsLarger(const Packet& new_packet)
-      : new_packet_(new_packet) {
-  }
-  bool operator()(const Packet& packet) {
-    return (new_packet_ >= packet);
-  }
-
- private:
-  const Packet& new_packet_;
-};
-
 // Returns true if both payload types are known to the decoder database, and
 // have the same sample rate.
 bool EqualSampleRates(uint8_t pt1,
@@ -62,7 +48,11 @@ void LogPacketDiscarded(int codec_level, StatisticsCalculator* stats) {
 
 PacketBuffer::PacketBuffer(size_t max_number_of_packets,
                            const TickTimer* tick_timer)
-    : max_number_of_packets_(max_number_of_packets), tick_timer_(tick_timer) {}
+    : max_number_of_packets_(max_number_of_packets),
+      // A full buffer is flushed before inserting, so there is always room
+      // for at least one packet.
+      slots_(std::max<size_t>(max_number_of_packets, 1)),
+      tick_timer_(tick_timer) {}
 
 // Destructor. All packets in the buffer will be destroyed.
 PacketBuffer::~PacketBuffer() {
@@ -71,11 +61,15 @@ PacketBuffer::~PacketBuffer() {
 
 // Flush the buffer. All packets in the buffer will be destroyed.
 void PacketBuffer::Flush() {
-  buffer_.clear();
+  for (size_t i = 0; i < num_packets_; ++i) {
+    PacketAt(i) = Packet();
+  }
+  first_slot_ = 0;
+  num_packets_ = 0;
 }
 
 bool PacketBuffer::Empty() const {
-  return buffer_.empty();
+  return num_packets_ == 0;
 }
 
 int PacketBuffer::InsertPacket(Packet&& packet, StatisticsCalculator* stats) {
@@ -91,37 +85,53 @@ int PacketBuffer::InsertPacket(Packet&& packet, StatisticsCalculator* stats) {
 
   packet.waiting_time = tick_timer_->GetNewStopwatch();
 
-  if (buffer_.size() >= max_number_of_packets_) {
+  if (num_packets_ >= max_number_of_packets_) {
     // Buffer is full. Flush it.
     Flush();
     RTC_LOG(LS_WARNING) << "Packet buffer flushed";
     return_val = kFlushed;
   }
 
-  // Get an iterator pointing to the place in the buffer where the new packet
-  // should be inserted. The list is searched from the back, since the most
-  // likely case is that the new packet should be near the end of the list.
-  PacketList::reverse_iterator rit = std::find_if(
-      buffer_.rbegin(), buffer_.rend(),
-      NewTimestampIsLarger(packet));
-
-  // The new packet is to be inserted to the right of |rit|. If it has the same
-  // timestamp as |rit|, which has a higher priority, do not insert the new
-  // packet to list.
-  if (rit != buffer_.rend() && packet.timestamp == rit->timestamp) {
+  // Find the position where the new packet should be inserted. The buffer is
+  // searched from the back, since the most likely case is that the new packet
+  // should be at the end of the buffer.
+  size_t position = num_packets_;
+  while (position > 0 && packet < PacketAt(position - 1)) {
+    --position;
+  }
+
+  // The new packet is to be inserted after |position - 1|. If it has the same
+  // timestamp as that packet, which has a higher priority, do not insert the
+  // new packet.
+  if (position > 0 && packet.timestamp == PacketAt(position - 1).timestamp) {
     LogPacketDiscarded(packet.priority.codec_level, stats);
     return return_val;
   }
 
-  // The new packet is to be inserted to the left of |it|. If it has the same
-  // timestamp as |it|, which has a lower priority, replace |it| with the new
-  // packet.
-  PacketList::iterator it = rit.base();
-  if (it != buffer_.end() && packet.timestamp == it->timestamp) {
+  // The new packet is to be inserted before |position|. If it has the same
+  // timestamp as that packet, which has a lower priority, replace that packet
+  // with the new one.
+  if (position < num_packets_ &&
+      packet.timestamp == PacketAt(position).timestamp) {
     LogPacketDiscarded(packet.priority.codec_level, stats);
-    it = buffer_.erase(it);
+    PacketAt(position) = std::move(packet);
+    return return_val;
+  }
+
+  // Make room by moving the packets on the shorter side of |position| one
+  // slot, so that inserting at either end is O(1).
+  if (position < num_packets_ - position) {
+    first_slot_ = (first_slot_ + slots_.size() - 1) % slots_.size();
+    for (size_t i = 0; i < position; ++i) {
+      PacketAt(i) = std::move(PacketAt(i + 1));
+    }
+  } else {
+    for (size_t i = num_packets_; i > position; --i) {
+      PacketAt(i) = std::move(PacketAt(i - 1));
+    }
   }
-  buffer_.insert(it, std::move(packet));  // Insert the packet at that position.
+  PacketAt(position) = std::move(packet);
+  ++num_packets_;
 
   return return_val;
 }
@@ -179,7 +189,7 @@ int PacketBuffer::NextTimestamp(uint32_t* next_timestamp) const {
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  *next_timestamp = buffer_.front().timestamp;
+  *next_timestamp = PacketAt(0).timestamp;
   return kOK;
 }
 
@@ -191,11 +201,11 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
   if (!next_timestamp) {
     return kInvalidPointer;
   }
-  PacketList::const_iterator it;
-  for (it = buffer_.begin(); it != buffer_.end(); ++it) {
-    if (it->timestamp >= timestamp) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
+    if (packet.timestamp >= timestamp) {
       // Found a packet matching the search.
-      *next_timestamp = it->timestamp;
+      *next_timestamp = packet.timestamp;
       return kOK;
     }
   }
@@ -203,7 +213,7 @@ int PacketBuffer::NextHigherTimestamp(uint32_t timestamp,
 }
 
 const Packet* PacketBuffer::PeekNextPacket() const {
-  return buffer_.empty() ? nullptr : &buffer_.front();
+  return Empty() ? nullptr : &PacketAt(0);
 }
 
 rtc::Optional<Packet> PacketBuffer::GetNextPacket() {
@@ -212,10 +222,10 @@ rtc::Optional<Packet> PacketBuffer::GetNextPacket() {
     return rtc::nullopt;
   }
 
-  rtc::Optional<Packet> packet(std::move(buffer_.front()));
+  rtc::Optional<Packet> packet(std::move(PacketAt(0)));
   // Assert that the packet sanity checks in InsertPacket method works.
   RTC_DCHECK(!packet->empty());
-  buffer_.pop_front();
+  PopFront();
 
   return packet;
 }
@@ -225,17 +235,17 @@ int PacketBuffer::DiscardNextPacket(StatisticsCalculator* stats) {
     return kBufferEmpty;
   }
   // Assert that the packet sanity checks in InsertPacket method works.
-  const Packet& packet = buffer_.front();
+  const Packet& packet = PacketAt(0);
   RTC_DCHECK(!packet.empty());
   LogPacketDiscarded(packet.priority.codec_level, stats);
-  buffer_.pop_front();
+  PopFront();
   return kOK;
 }
 
 void PacketBuffer::DiscardOldPackets(uint32_t timestamp_limit,
                                      uint32_t horizon_samples,
                                      StatisticsCalculator* stats) {
-  buffer_.remove_if([timestamp_limit, horizon_samples, stats](const Packet& p) {
+  RemoveIf([timestamp_limit, horizon_samples, stats](const Packet& p) {
     if (timestamp_limit == p.timestamp ||
         !IsObsoleteTimestamp(p.timestamp, timestamp_limit, horizon_samples)) {
       return false;
@@ -252,7 +262,7 @@ void PacketBuffer::DiscardAllOldPackets(uint32_t timestamp_limit,
 
 void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type,
                                                  StatisticsCalculator* stats) {
-  buffer_.remove_if([payload_type, stats](const Packet& p) {
+  RemoveIf([payload_type, stats](const Packet& p) {
     if (p.payload_type != payload_type) {
       return false;
     }
@@ -262,13 +272,14 @@ void PacketBuffer::DiscardPacketsWithPayloadType(uint8_t payload_type,
 }
 
 size_t PacketBuffer::NumPacketsInBuffer() const {
-  return buffer_.size();
+  return num_packets_;
 }
 
 size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
   size_t num_samples = 0;
   size_t last_duration = last_decoded_length;
-  for (const Packet& packet : buffer_) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
     if (packet.frame) {
       // TODO(hlundin): Verify that it's fine to count all packets and remove
       // this check.
@@ -288,7 +299,8 @@ size_t PacketBuffer::NumSamplesInBuffer(size_t last_decoded_length) const {
 bool PacketBuffer::ContainsDtxOrCngPacket(
     const DecoderDatabase* decoder_database) const {
   RTC_DCHECK(decoder_database);
-  for (const Packet& packet : buffer_) {
+  for (size_t i = 0; i < num_packets_; ++i) {
+    const Packet& packet = PacketAt(i);
     if ((packet.frame && packet.frame->IsDtxPacket()) ||
         decoder_database->IsComfortNoise(packet.payload_type)) {
       return true;
@@ -298,8 +310,42 @@ bool PacketBuffer::ContainsDtxOrCngPacket(
 }
 
 void PacketBuffer::BufferStat(int* num_packets, int* max_num_packets) const {
-  *num_packets = static_cast<int>(buffer_.size());
+  *num_packets = static_cast<int>(num_packets_);
   *max_num_packets = static_cast<int>(max_number_of_packets_);
 }
 
+Packet& PacketBuffer::PacketAt(size_t index) {
+  RTC_DCHECK_LT(index, slots_.size());
+  const size_t slot = first_slot_ + index;
+  return slots_[slot < slots_.size() ? slot : slot - slots_.size()];
+}
+
+const Packet& PacketBuffer::PacketAt(size_t index) const {
+  return const_cast<PacketBuffer*>(this)->PacketAt(index);
+}
+
+void PacketBuffer::PopFront() {
+  RTC_DCHECK(!Empty());
+  PacketAt(0) = Packet();
+  first_slot_ = (first_slot_ + 1) % slots_.size();
+  --num_packets_;
+}
+
+template <typename Predicate>
+void PacketBuffer::RemoveIf(Predicate predicate) {
+  size_t num_kept = 0;
+  for (size_t i = 0; i < num_packets_; ++i) {
+    Packet& packet = PacketAt(i);
+    if (predicate(packet)) {
+      packet = Packet();
+    } else {
+      if (num_kept != i) {
+        PacketAt(num_kept) = std::move(packet);
+      }
+      ++num_kept;
+    }
+  }
+  num_packets_ = num_kept;
+}
+
 }  // namespace webrtc
@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 #define MODULES_AUDIO_CODING_NETEQ_PACKET_BUFFER_H_
 
+#include <vector>
+
 #include "api/optional.h"
 #include "modules/audio_coding/neteq/decoder_database.h"
 #include "modules/audio_coding/neteq/packet.h"
@@ -24,7 +26,9 @@ class DecoderDatabase;
 class StatisticsCalculator;
 class TickTimer;
 
-// This is the actual buffer holding the packets before decoding.
+// This is the actual buffer holding the packets before decoding. The packets
+// are kept sorted in a ring buffer with one slot per packet, allocated up
+// front, so that inserting and removing packets does not allocate.
 class PacketBuffer {
  public:
   enum BufferReturnCodes {
@@ -143,8 +147,24 @@ class PacketBuffer {
   }
 
  private:
+  // Returns the packet at |index|, counted from the first packet.
+  Packet& PacketAt(size_t index);
+  const Packet& PacketAt(size_t index) const;
+
+  // Removes the first packet.
+  void PopFront();
+
+  // Removes all packets for which |predicate| returns true, keeping the order
+  // of the remaining ones.
+  template <typename Predicate>
+  void RemoveIf(Predicate predicate);
+
   size_t max_number_of_packets_;
-  PacketList buffer_;
+  // Ring buffer of packets sorted by timestamp. The first packet is at
+  // |slots_[first_slot_]|, and the buffer holds |num_packets_| packets.
+  std::vector<Packet> slots_;
+  size_t first_slot_ = 0;
+  size_t num_packets_ = 0;
   const TickTimer* tick_timer_;
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketBuffer);
 };
@@ -434,6 +434,43 @@ TEST(PacketBuffer, Reordering) {
   EXPECT_CALL(decoder_database, Die());  // Called when object is deleted.
 }
 
+// Inserts out of order packets into a small buffer many times, so that the
+// packets wrap around the end of the underlying ring buffer.
+TEST(PacketBuffer, ReorderingAcrossWrapAround) {
+  TickTimer tick_timer;
+  PacketBuffer buffer(4, &tick_timer);  // 4 packets.
+  const uint32_t ts_increment = 10;
+  PacketGenerator gen(17, 4711, 0, ts_increment);
+  StrictMock<MockStatisticsCalculator> mock_stats;
+
+  uint32_t current_ts = 4711;
+  for (int round = 0; round < 10; ++round) {
+    // Generate three packets and insert them as middle, last, first.
+    std::vector<Packet> packets;
+    for (int i = 0; i < 3; ++i)
+      packets.push_back(gen.NextPacket(10));
+    for (int i : {1, 2, 0})
+      EXPECT_EQ(PacketBuffer::kOK,
+                buffer.InsertPacket(std::move(packets[i]), &mock_stats));
+    EXPECT_EQ(3u, buffer.NumPacketsInBuffer());
+
+    // Every other round, discard the first packet as old.
+    if (round % 2) {
+      EXPECT_CALL(mock_stats, PacketsDiscarded(1));
+      buffer.DiscardAllOldPackets(current_ts + 1, &mock_stats);
+      EXPECT_EQ(2u, buffer.NumPacketsInBuffer());
+      current_ts += ts_increment;
+    }
+
+    while (!buffer.Empty()) {
+      const rtc::Optional<Packet> packet = buffer.GetNextPacket();
+      ASSERT_TRUE(packet);
+      EXPECT_EQ(current_ts, packet->timestamp);
+      current_ts += ts_increment;
+    }
+  }
+}
+
 // The test first inserts a packet with narrow-band CNG, then a packet with
 // wide-band speech. The expected behavior of the packet buffer is to detect a
 // change in sample rate, even though no speech packet has been inserted before,
@@ -340,8 +340,12 @@ void StatisticsCalculator::PopulateDelayManagerStats(
     const DelayManager& delay_manager,
     NetEqNetworkStatistics* stats) {
   RTC_DCHECK(stats);
+  // Low-latency targets are often a fraction of a packet, so they are not
+  // rounded down to whole packets.
   stats->preferred_buffer_size_ms =
-      (delay_manager.TargetLevel() >> 8) * ms_per_packet;
+      delay_manager.low_latency_mode()
+          ? (delay_manager.TargetLevel() * ms_per_packet) >> 8
+          : (delay_manager.TargetLevel() >> 8) * ms_per_packet;
   stats->jitter_peaks_found = delay_manager.PeakFound();
   stats->clockdrift_ppm =
       rtc::saturated_cast<int32_t>(delay_manager.EstimatedClockDriftPpm());
@@ -12,6 +12,7 @@
 
 #include <iostream>
 
+#include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_coding/neteq/tools/neteq_performance_test.h"
 #include "rtc_base/flags.h"
 #include "test/testsupport/fileutils.h"
@@ -23,6 +24,9 @@ DEFINE_int(lossrate, 10,
            "Packet lossrate; drop every N packets.");
 DEFINE_float(drift, 0.1f,
              "Clockdrift factor.");
+DEFINE_bool(generic_dsp, false,
+            "Use the generic C versions of the SPL correlation and "
+            "downsampling functions instead of the SIMD ones.");
 DEFINE_bool(help, false, "Print this message.");
 
 int main(int argc, char* argv[]) {
@@ -32,7 +36,8 @@ int main(int argc, char* argv[]) {
       "  --runtime_ms=N         runtime in ms; default is 10000 ms\n"
       "  --lossrate=N           drop every N packets; default is 10\n"
       "  --drift=F              clockdrift factor between 0.0 and 1.0; "
-      "default is 0.1\n";
+      "default is 0.1\n"
+      "  --generic_dsp          use the C versions of the SPL functions\n";
   webrtc::test::SetExecutablePath(argv[0]);
   if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) ||
       FLAG_help || argc != 1) {
@@ -47,6 +52,13 @@ int main(int argc, char* argv[]) {
   RTC_CHECK_GE(FLAG_lossrate, 0);
   RTC_CHECK(FLAG_drift >= 0.0 && FLAG_drift < 1.0);
 
+  // NetEq initializes SPL too; that is a no-op after the first call.
+  WebRtcSpl_Init();
+  if (FLAG_generic_dsp) {
+    WebRtcSpl_CrossCorrelation = WebRtcSpl_CrossCorrelationC;
+    WebRtcSpl_DownsampleFast = WebRtcSpl_DownsampleFastC;
+  }
+
   int64_t result =
       webrtc::test::NetEqPerformanceTest::Run(FLAG_runtime_ms, FLAG_lossrate,
                                               FLAG_drift);
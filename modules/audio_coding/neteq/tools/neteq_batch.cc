@@ -0,0 +1,417 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// Simulates NetEq on many RTP dumps or event logs at once, spread over a
+// number of threads, for each NetEq configuration of a parameter sweep. The
+// statistics of every simulation, and their averages per configuration, are
+// written as JSON. No output audio is produced unless --output_audio_dir is
+// set.
+//
+// The sweep config has one parameter per line, followed by the values to try,
+// e.g.
+//   max_delay_ms 500,1000,2000
+//   enable_fast_accelerate 0,1
+// and all the combinations of the values are simulated. Parameters that are
+// not listed keep their NetEq::Config default. Lines starting with # are
+// ignored.
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "modules/audio_coding/neteq/include/neteq.h"
+#include "modules/audio_coding/neteq/tools/neteq_packet_source_input.h"
+#include "modules/audio_coding/neteq/tools/neteq_stats_getter.h"
+#include "modules/audio_coding/neteq/tools/neteq_test.h"
+#include "modules/audio_coding/neteq/tools/output_wav_file.h"
+#include "modules/audio_coding/neteq/tools/rtp_file_source.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/ptr_util.h"
+#include "system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+DEFINE_string(input_list,
+              "",
+              "File with the RTP dumps or event logs to simulate, one per line, "
+              "in addition to the ones given as arguments");
+DEFINE_string(sweep_config, "", "Parameter sweep config, see the top of "
+              "neteq_batch.cc. Without it, only the default config is run");
+DEFINE_string(output, "", "File to write the JSON results to, instead of "
+              "stdout");
+DEFINE_string(output_audio_dir,
+              "",
+              "If set, the output audio of every simulation is written to "
+              "this directory as a wav file");
+DEFINE_int(num_threads, 0, "Number of simulation threads. 0 means one per "
+           "core");
+DEFINE_int(audio_level, 1, "Extension ID for audio level (RFC 6464)");
+DEFINE_int(abs_send_time, 3, "Extension ID for absolute sender time");
+DEFINE_int(transport_seq_no, 5, "Extension ID for transport sequence number");
+DEFINE_bool(help, false, "Prints this message");
+
+// The payload types are the neteq_rtpplay defaults.
+const struct {
+  int payload_type;
+  NetEqDecoder codec;
+  const char* name;
+  int sample_rate_hz;
+} kCodecs[] = {
+    {0, NetEqDecoder::kDecoderPCMu, "pcmu", 8000},
+    {8, NetEqDecoder::kDecoderPCMa, "pcma", 8000},
+    {102, NetEqDecoder::kDecoderILBC, "ilbc", 8000},
+    {103, NetEqDecoder::kDecoderISAC, "isac", 16000},
+    {104, NetEqDecoder::kDecoderISACswb, "isac-swb", 32000},
+    {111, NetEqDecoder::kDecoderOpus, "opus", 48000},
+    {93, NetEqDecoder::kDecoderPCM16B, "pcm16-nb", 8000},
+    {94, NetEqDecoder::kDecoderPCM16Bwb, "pcm16-wb", 16000},
+    {95, NetEqDecoder::kDecoderPCM16Bswb32kHz, "pcm16-swb32", 32000},
+    {96, NetEqDecoder::kDecoderPCM16Bswb48kHz, "pcm16-swb48", 48000},
+    {9, NetEqDecoder::kDecoderG722, "g722", 16000},
+    {106, NetEqDecoder::kDecoderAVT, "avt", 8000},
+    {114, NetEqDecoder::kDecoderAVT16kHz, "avt-16", 16000},
+    {115, NetEqDecoder::kDecoderAVT32kHz, "avt-32", 32000},
+    {116, NetEqDecoder::kDecoderAVT48kHz, "avt-48", 48000},
+    {117, NetEqDecoder::kDecoderRED, "red", 0},
+    {13, NetEqDecoder::kDecoderCNGnb, "cng-nb", 8000},
+    {98, NetEqDecoder::kDecoderCNGwb, "cng-wb", 16000},
+    {99, NetEqDecoder::kDecoderCNGswb32kHz, "cng-swb32", 32000},
+    {100, NetEqDecoder::kDecoderCNGswb48kHz, "cng-swb48", 48000},
+};
+
+// Returns 0 for payload types that carry no audio of their own.
+rtc::Optional<int> CodecSampleRate(uint8_t payload_type) {
+  for (const auto& codec : kCodecs) {
+    if (codec.payload_type == payload_type)
+      return codec.sample_rate_hz;
+  }
+  return rtc::nullopt;
+}
+
+// One point of the parameter sweep.
+struct SweepConfig {
+  NetEq::Config config;
+  std::vector<std::pair<std::string, int>> values;
+};
+
+bool SetParameter(const std::string& name, int value, NetEq::Config* config) {
+  if (name == "max_packets_in_buffer")
+    config->max_packets_in_buffer = value;
+  else if (name == "max_delay_ms")
+    config->max_delay_ms = value;
+  else if (name == "enable_fast_accelerate")
+    config->enable_fast_accelerate = value != 0;
+  else if (name == "enable_low_latency")
+    config->enable_low_latency = value != 0;
+  else if (name == "low_latency_min_delay_ms")
+    config->low_latency_min_delay_ms = value;
+  else
+    return false;
+  return true;
+}
+
+std::vector<SweepConfig> ReadSweepConfig(const std::string& file_name) {
+  std::vector<SweepConfig> sweep(1);
+  if (file_name.empty())
+    return sweep;
+  std::ifstream file(file_name);
+  RTC_CHECK(file) << "Cannot open " << file_name;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream line_stream(line);
+    std::string name;
+    std::string values;
+    line_stream >> name >> values;
+    RTC_CHECK(!values.empty()) << "No values for " << name;
+
+    // Every config so far is combined with every value of this parameter.
+    std::vector<SweepConfig> next_sweep;
+    std::istringstream values_stream(values);
+    std::string value;
+    while (std::getline(values_stream, value, ',')) {
+      for (SweepConfig point : sweep) {
+        RTC_CHECK(SetParameter(name, atoi(value.c_str()), &point.config))
+            << "Unknown parameter " << name;
+        point.values.emplace_back(name, atoi(value.c_str()));
+        next_sweep.push_back(std::move(point));
+      }
+    }
+    sweep = std::move(next_sweep);
+  }
+  return sweep;
+}
+
+std::vector<std::string> InputFiles(int argc, char* argv[]) {
+  std::vector<std::string> files(argv + 1, argv + argc);
+  if (strlen(FLAG_input_list) > 0) {
+    std::ifstream list(FLAG_input_list);
+    RTC_CHECK(list) << "Cannot open " << FLAG_input_list;
+    std::string line;
+    while (std::getline(list, line)) {
+      if (!line.empty())
+        files.push_back(line);
+    }
+  }
+  return files;
+}
+
+struct Simulation {
+  std::string input_file_name;
+  size_t sweep_index;
+  bool ok = false;
+  int64_t duration_ms = 0;
+  NetEqStatsGetter::Stats stats;
+};
+
+class BatchRunner {
+ public:
+  BatchRunner(const std::vector<SweepConfig>& sweep,
+              std::vector<Simulation>* simulations)
+      : sweep_(sweep), simulations_(simulations) {}
+
+  void Run(int num_threads) {
+    std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.push_back(rtc::MakeUnique<rtc::PlatformThread>(
+          &BatchRunner::RunThread, this, "NetEqBatch"));
+      threads.back()->Start();
+    }
+    for (auto& thread : threads)
+      thread->Stop();
+  }
+
+ private:
+  static void RunThread(void* obj) {
+    BatchRunner* runner = static_cast<BatchRunner*>(obj);
+    while (Simulation* simulation = runner->NextSimulation())
+      runner->Simulate(simulation);
+  }
+
+  Simulation* NextSimulation() {
+    rtc::CritScope lock(&crit_);
+    if (next_simulation_ == simulations_->size())
+      return nullptr;
+    return &(*simulations_)[next_simulation_++];
+  }
+
+  void Simulate(Simulation* simulation) const {
+    const NetEqPacketSourceInput::RtpHeaderExtensionMap rtp_ext_map = {
+        {FLAG_audio_level, kRtpExtensionAudioLevel},
+        {FLAG_abs_send_time, kRtpExtensionAbsoluteSendTime},
+        {FLAG_transport_seq_no, kRtpExtensionTransportSequenceNumber}};
+
+    const std::string& file_name = simulation->input_file_name;
+    std::unique_ptr<NetEqInput> input;
+    if (RtpFileSource::ValidRtpDump(file_name) ||
+        RtpFileSource::ValidPcap(file_name)) {
+      input.reset(new NetEqRtpDumpInput(file_name, rtp_ext_map));
+    } else {
+      input.reset(new NetEqEventLogInput(file_name, rtp_ext_map));
+    }
+
+    // Skip the packets before the first one of a known codec.
+    rtc::Optional<int> sample_rate_hz;
+    while (!sample_rate_hz && input->NextHeader()) {
+      sample_rate_hz = CodecSampleRate(input->NextHeader()->payloadType);
+      if (!sample_rate_hz || *sample_rate_hz == 0) {
+        sample_rate_hz = rtc::nullopt;
+        input->PopPacket();
+      }
+    }
+    if (!sample_rate_hz || input->ended()) {
+      fprintf(stderr, "No audio packets in %s\n", file_name.c_str());
+      return;
+    }
+
+    std::unique_ptr<AudioSink> output;
+    if (strlen(FLAG_output_audio_dir) > 0) {
+      std::string base_name = file_name.substr(file_name.rfind('/') + 1);
+      output.reset(new OutputWavFile(
+          std::string(FLAG_output_audio_dir) + "/" + base_name + "_" +
+              std::to_string(simulation->sweep_index) + ".wav",
+          *sample_rate_hz));
+    }
+
+    NetEqTest::DecoderMap codecs;
+    for (const auto& codec : kCodecs) {
+      codecs[codec.payload_type] = std::make_pair(codec.codec, codec.name);
+    }
+    NetEqStatsGetter stats_getter(nullptr);
+    NetEqTest::Callbacks callbacks;
+    callbacks.get_audio_callback = &stats_getter;
+    NetEq::Config config = sweep_[simulation->sweep_index].config;
+    config.sample_rate_hz = *sample_rate_hz;
+    NetEqTest test(config, codecs, NetEqTest::ExtDecoderMap(),
+                   std::move(input), std::move(output), callbacks);
+    simulation->duration_ms = test.Run();
+    simulation->stats = stats_getter.AverageStats();
+    simulation->ok = true;
+  }
+
+  const std::vector<SweepConfig>& sweep_;
+  std::vector<Simulation>* const simulations_;
+  rtc::CriticalSection crit_;
+  size_t next_simulation_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+const struct {
+  const char* name;
+  double NetEqStatsGetter::Stats::*value;
+} kStats[] = {
+    {"current_buffer_size_ms",
+     &NetEqStatsGetter::Stats::current_buffer_size_ms},
+    {"preferred_buffer_size_ms",
+     &NetEqStatsGetter::Stats::preferred_buffer_size_ms},
+    {"packet_loss_rate", &NetEqStatsGetter::Stats::packet_loss_rate},
+    {"expand_rate", &NetEqStatsGetter::Stats::expand_rate},
+    {"speech_expand_rate", &NetEqStatsGetter::Stats::speech_expand_rate},
+    {"preemptive_rate", &NetEqStatsGetter::Stats::preemptive_rate},
+    {"accelerate_rate", &NetEqStatsGetter::Stats::accelerate_rate},
+    {"secondary_decoded_rate",
+     &NetEqStatsGetter::Stats::secondary_decoded_rate},
+    {"secondary_discarded_rate",
+     &NetEqStatsGetter::Stats::secondary_discarded_rate},
+    {"clockdrift_ppm", &NetEqStatsGetter::Stats::clockdrift_ppm},
+    {"mean_waiting_time_ms", &NetEqStatsGetter::Stats::mean_waiting_time_ms},
+    {"median_waiting_time_ms",
+     &NetEqStatsGetter::Stats::median_waiting_time_ms},
+    {"min_waiting_time_ms", &NetEqStatsGetter::Stats::min_waiting_time_ms},
+    {"max_waiting_time_ms", &NetEqStatsGetter::Stats::max_waiting_time_ms},
+};
+
+void WriteStats(FILE* file, const NetEqStatsGetter::Stats& stats) {
+  const char* separator = "";
+  for (const auto& stat : kStats) {
+    fprintf(file, "%s\"%s\":%g", separator, stat.name, stats.*stat.value);
+    separator = ",";
+  }
+}
+
+void WriteResults(FILE* file,
+                  const std::vector<SweepConfig>& sweep,
+                  const std::vector<Simulation>& simulations) {
+  fprintf(file, "{\"configs\":[");
+  for (size_t i = 0; i < sweep.size(); ++i) {
+    // The statistics of a config are averaged over its simulations.
+    NetEqStatsGetter::Stats average;
+    int num_simulations = 0;
+    for (const Simulation& simulation : simulations) {
+      if (!simulation.ok || simulation.sweep_index != i)
+        continue;
+      for (const auto& stat : kStats)
+        average.*stat.value += simulation.stats.*stat.value;
+      ++num_simulations;
+    }
+    if (num_simulations > 0) {
+      for (const auto& stat : kStats)
+        average.*stat.value /= num_simulations;
+    }
+
+    fprintf(file, "%s{\"index\":%zu,\"parameters\":{", i > 0 ? "," : "", i);
+    const char* separator = "";
+    for (const auto& value : sweep[i].values) {
+      fprintf(file, "%s\"%s\":%d", separator, value.first.c_str(),
+              value.second);
+      separator = ",";
+    }
+    fprintf(file, "},\"num_simulations\":%d,\"average\":{", num_simulations);
+    WriteStats(file, average);
+    fprintf(file, "}}");
+  }
+  fprintf(file, "],\"simulations\":[");
+  const char* separator = "";
+  for (const Simulation& simulation : simulations) {
+    if (!simulation.ok)
+      continue;
+    fprintf(file,
+            "%s{\"input\":\"%s\",\"config\":%zu,\"duration_ms\":%" PRId64
+            ",\"stats\":{",
+            separator, simulation.input_file_name.c_str(),
+            simulation.sweep_index, simulation.duration_ms);
+    WriteStats(file, simulation.stats);
+    fprintf(file, "}}");
+    separator = ",";
+  }
+  fprintf(file, "]}\n");
+}
+
+int RunBatch(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage = "Tool for simulating NetEq on many RTP dumps or event "
+      "logs in parallel.\n"
+      "Run " + program_name + " --help for usage.\n"
+      "Example usage:\n" + program_name +
+      " --sweep_config=sweep.txt --output=results.json input1.rtp input2.rtp\n";
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true)) {
+    return 1;
+  }
+  if (FLAG_help) {
+    std::cout << usage;
+    rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+
+  const std::vector<std::string> input_files = InputFiles(argc, argv);
+  if (input_files.empty()) {
+    std::cout << usage;
+    return 0;
+  }
+  const std::vector<SweepConfig> sweep = ReadSweepConfig(FLAG_sweep_config);
+
+  std::vector<Simulation> simulations;
+  for (const std::string& input_file : input_files) {
+    for (size_t i = 0; i < sweep.size(); ++i) {
+      Simulation simulation;
+      simulation.input_file_name = input_file;
+      simulation.sweep_index = i;
+      simulations.push_back(simulation);
+    }
+  }
+
+  int num_threads = FLAG_num_threads;
+  if (num_threads <= 0)
+    num_threads = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  BatchRunner runner(sweep, &simulations);
+  runner.Run(num_threads);
+
+  FILE* output = stdout;
+  if (strlen(FLAG_output) > 0) {
+    output = fopen(FLAG_output, "w");
+    RTC_CHECK(output) << "Cannot open " << FLAG_output;
+  }
+  WriteResults(output, sweep, simulations);
+  if (output != stdout)
+    fclose(output);
+  return 0;
+}
+
+}  // namespace
+}  // namespace test
+}  // namespace webrtc
+
+int main(int argc, char* argv[]) {
+  return webrtc::test::RunBatch(argc, argv);
+}
@@ -40,6 +40,19 @@ static const size_t kMinValidCallTimeTimeInMilliseconds =
 #ifdef AUDIO_DEVICE_PLAYS_SINUS_TONE
 static const double k2Pi = 6.28318530717959;
 #endif
+// Number of samples that the audio buffers are preallocated for.
+static const size_t kPreallocatedSamples =
+    kMaxBufferSizeBytes / sizeof(int16_t);
+
+// Raises |level| to |value| if it is larger. Lock-free, and since only the
+// stats task can modify the level concurrently, it rarely has to retry.
+static void UpdateMaxLevel(std::atomic<int16_t>* level, int16_t value) {
+  int16_t current = level->load(std::memory_order_relaxed);
+  while (value > current &&
+         !level->compare_exchange_weak(current, value,
+                                       std::memory_order_relaxed)) {
+  }
+}
 
 AudioDeviceBuffer::AudioDeviceBuffer()
     : task_queue_(kTimerQueueName),
@@ -66,6 +79,8 @@ AudioDeviceBuffer::AudioDeviceBuffer()
   RTC_LOG(WARNING) << "AUDIO_DEVICE_PLAYS_SINUS_TONE is defined!";
 #endif
   WebRtcSpl_Init();
+  play_buffer_.EnsureCapacity(kPreallocatedSamples);
+  rec_buffer_.EnsureCapacity(kPreallocatedSamples);
   playout_thread_checker_.DetachFromThread();
   recording_thread_checker_.DetachFromThread();
 }
@@ -413,12 +428,14 @@ void AudioDeviceBuffer::LogStats(LogState state) {
   last_timer_task_time_ = now_time;
 
   Stats stats;
-  {
-    rtc::CritScope cs(&lock_);
-    stats = stats_;
-    stats_.max_rec_level = 0;
-    stats_.max_play_level = 0;
-  }
+  stats.rec_callbacks = stats_.rec_callbacks.load(std::memory_order_relaxed);
+  stats.play_callbacks = stats_.play_callbacks.load(std::memory_order_relaxed);
+  stats.rec_samples = stats_.rec_samples.load(std::memory_order_relaxed);
+  stats.play_samples = stats_.play_samples.load(std::memory_order_relaxed);
+  stats.max_rec_level =
+      stats_.max_rec_level.exchange(0, std::memory_order_relaxed);
+  stats.max_play_level =
+      stats_.max_play_level.exchange(0, std::memory_order_relaxed);
 
   // Log the latest statistics but skip the first round just after state was
   // set to LOG_START. Hence, first printed log will be after ~10 seconds.
@@ -455,37 +472,34 @@ void AudioDeviceBuffer::LogStats(LogState state) {
 void AudioDeviceBuffer::ResetRecStats() {
   RTC_DCHECK_RUN_ON(&task_queue_);
   last_stats_.ResetRecStats();
-  rtc::CritScope cs(&lock_);
-  stats_.ResetRecStats();
+  stats_.rec_callbacks.store(0, std::memory_order_relaxed);
+  stats_.rec_samples.store(0, std::memory_order_relaxed);
+  stats_.max_rec_level.store(0, std::memory_order_relaxed);
 }
 
 void AudioDeviceBuffer::ResetPlayStats() {
   RTC_DCHECK_RUN_ON(&task_queue_);
   last_stats_.ResetPlayStats();
-  rtc::CritScope cs(&lock_);
-  stats_.ResetPlayStats();
+  stats_.play_callbacks.store(0, std::memory_order_relaxed);
+  stats_.play_samples.store(0, std::memory_order_relaxed);
+  stats_.max_play_level.store(0, std::memory_order_relaxed);
 }
 
 void AudioDeviceBuffer::UpdateRecStats(int16_t max_abs,
                                        size_t samples_per_channel) {
   RTC_DCHECK_RUN_ON(&recording_thread_checker_);
-  rtc::CritScope cs(&lock_);
-  ++stats_.rec_callbacks;
-  stats_.rec_samples += samples_per_channel;
-  if (max_abs > stats_.max_rec_level) {
-    stats_.max_rec_level = max_abs;
-  }
+  stats_.rec_callbacks.fetch_add(1, std::memory_order_relaxed);
+  stats_.rec_samples.fetch_add(samples_per_channel, std::memory_order_relaxed);
+  UpdateMaxLevel(&stats_.max_rec_level, max_abs);
 }
 
 void AudioDeviceBuffer::UpdatePlayStats(int16_t max_abs,
                                         size_t samples_per_channel) {
   RTC_DCHECK_RUN_ON(&playout_thread_checker_);
-  rtc::CritScope cs(&lock_);
-  ++stats_.play_callbacks;
-  stats_.play_samples += samples_per_channel;
-  if (max_abs > stats_.max_play_level) {
-    stats_.max_play_level = max_abs;
-  }
+  stats_.play_callbacks.fetch_add(1, std::memory_order_relaxed);
+  stats_.play_samples.fetch_add(samples_per_channel,
+                                std::memory_order_relaxed);
+  UpdateMaxLevel(&stats_.max_play_level, max_abs);
 }
 
 }  // namespace webrtc
@@ -11,9 +11,10 @@
 #ifndef MODULES_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H_
 #define MODULES_AUDIO_DEVICE_AUDIO_DEVICE_BUFFER_H_
 
+#include <atomic>
+
 #include "modules/audio_device/include/audio_device.h"
 #include "rtc_base/buffer.h"
-#include "rtc_base/criticalsection.h"
 #include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
@@ -124,7 +125,8 @@ class AudioDeviceBuffer {
   void LogStats(LogState state);
 
   // Updates counters in each play/record callback. These counters are later
-  // (periodically) read by LogStats() using a lock.
+  // (periodically) read by LogStats() without any locking, hence the native
+  // audio threads never wait for the task queue.
   void UpdateRecStats(int16_t max_abs, size_t samples_per_channel);
   void UpdatePlayStats(int16_t max_abs, size_t samples_per_channel);
 
@@ -150,8 +152,6 @@ class AudioDeviceBuffer {
   // Native (platform specific) audio thread driving the recording side.
   rtc::ThreadChecker recording_thread_checker_;
 
-  rtc::CriticalSection lock_;
-
   // Task queue used to invoke LogStats() periodically. Tasks are executed on a
   // worker thread but it does not necessarily have to be the same thread for
   // each task.
@@ -187,11 +187,12 @@ class AudioDeviceBuffer {
 
   // Buffer used for audio samples to be played out. Size can be changed
   // dynamically. The 16-bit samples are interleaved, hence the size is
-  // proportional to the number of channels.
+  // proportional to the number of channels. Preallocated for 10 ms of stereo
+  // audio at 96 kHz to avoid allocations on the native audio thread.
   rtc::BufferT<int16_t> play_buffer_ RTC_GUARDED_BY(playout_thread_checker_);
 
   // Byte buffer used for recorded audio samples. Size can be changed
-  // dynamically.
+  // dynamically. Preallocated like |play_buffer_|.
   rtc::BufferT<int16_t> rec_buffer_ RTC_GUARDED_BY(recording_thread_checker_);
 
   // Contains true of a key-press has been detected.
@@ -216,8 +217,18 @@ class AudioDeviceBuffer {
   int64_t play_start_time_ RTC_GUARDED_BY(main_thread_checker_);
   int64_t rec_start_time_ RTC_GUARDED_BY(main_thread_checker_);
 
-  // Contains counters for playout and recording statistics.
-  Stats stats_ RTC_GUARDED_BY(lock_);
+  // Contains counters for playout and recording statistics. Each counter is
+  // written by one native audio thread and read (and for the levels also
+  // cleared) by LogStats() on the task queue.
+  struct AtomicStats {
+    std::atomic<uint64_t> rec_callbacks{0};
+    std::atomic<uint64_t> play_callbacks{0};
+    std::atomic<uint64_t> rec_samples{0};
+    std::atomic<uint64_t> play_samples{0};
+    std::atomic<int16_t> max_rec_level{0};
+    std::atomic<int16_t> max_play_level{0};
+  };
+  AtomicStats stats_;
 
   // Stores current stats at each timer task. Used to calculate differences
   // between two successive timer events.
@@ -238,6 +238,7 @@ class ADMWrapper : public AudioDeviceModule, public AudioTransport {
   int32_t PlayoutDelay(uint16_t* delay_ms) const override {
     return impl_->PlayoutDelay(delay_ms);
   }
+  rtc::Optional<Stats> GetStats() const override { return impl_->GetStats(); }
   bool BuiltInAECIsAvailable() const override {
     return impl_->BuiltInAECIsAvailable();
   }
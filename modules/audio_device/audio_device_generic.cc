@@ -43,6 +43,10 @@ int32_t AudioDeviceGeneric::EnableBuiltInNS(bool enable) {
   return -1;
 }
 
+rtc::Optional<AudioDeviceModule::Stats> AudioDeviceGeneric::GetStats() const {
+  return rtc::nullopt;
+}
+
 #if defined(WEBRTC_IOS)
 int AudioDeviceGeneric::GetPlayoutAudioParameters(
     AudioParameters* params) const {
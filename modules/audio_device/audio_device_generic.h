@@ -111,6 +111,8 @@ class AudioDeviceGeneric {
 
   // Delay information and control
   virtual int32_t PlayoutDelay(uint16_t& delayMS) const = 0;
+  // Linux only.
+  virtual rtc::Optional<AudioDeviceModule::Stats> GetStats() const;
 
   // Android only
   virtual bool BuiltInAECIsAvailable() const;
@@ -845,6 +845,14 @@ int32_t AudioDeviceModuleImpl::PlayoutDelay(uint16_t* delayMS) const {
   return 0;
 }
 
+rtc::Optional<AudioDeviceModule::Stats> AudioDeviceModuleImpl::GetStats()
+    const {
+  if (!initialized_) {
+    return rtc::nullopt;
+  }
+  return audio_device_->GetStats();
+}
+
 bool AudioDeviceModuleImpl::BuiltInAECIsAvailable() const {
   RTC_LOG(INFO) << __FUNCTION__;
   CHECKinitialized__BOOL();
@@ -127,6 +127,7 @@ class AudioDeviceModuleImpl : public AudioDeviceModule {
 
   // Delay information and control
   int32_t PlayoutDelay(uint16_t* delayMS) const override;
+  rtc::Optional<Stats> GetStats() const override;
 
   bool BuiltInAECIsAvailable() const override;
   int32_t EnableBuiltInAEC(bool enable) override;
@@ -42,6 +42,7 @@ FineAudioBuffer::~FineAudioBuffer() {}
 
 void FineAudioBuffer::ResetPlayout() {
   playout_buffer_.Clear();
+  playout_delay_ms_.store(0, std::memory_order_relaxed);
 }
 
 void FineAudioBuffer::ResetRecord() {
@@ -87,7 +88,7 @@ void FineAudioBuffer::GetPlayoutData(rtc::ArrayView<int16_t> audio_buffer,
           (playout_buffer_.size() - audio_buffer.size()) * sizeof(int16_t));
   playout_buffer_.SetSize(playout_buffer_.size() - audio_buffer.size());
   // Cache playout latency for usage in DeliverRecordedData();
-  playout_delay_ms_ = playout_delay_ms;
+  playout_delay_ms_.store(playout_delay_ms, std::memory_order_relaxed);
 }
 
 void FineAudioBuffer::DeliverRecordedData(
@@ -104,7 +105,8 @@ void FineAudioBuffer::DeliverRecordedData(
   while (record_buffer_.size() >= num_elements_10ms) {
     audio_device_buffer_->SetRecordedBuffer(record_buffer_.data(),
                                             record_samples_per_channel_10ms_);
-    audio_device_buffer_->SetVQEData(playout_delay_ms_, record_delay_ms);
+    audio_device_buffer_->SetVQEData(
+        playout_delay_ms_.load(std::memory_order_relaxed), record_delay_ms);
     audio_device_buffer_->DeliverRecordedData();
     memmove(record_buffer_.data(), record_buffer_.data() + num_elements_10ms,
             (record_buffer_.size() - num_elements_10ms) * sizeof(int16_t));
@@ -11,6 +11,8 @@
 #ifndef MODULES_AUDIO_DEVICE_FINE_AUDIO_BUFFER_H_
 #define MODULES_AUDIO_DEVICE_FINE_AUDIO_BUFFER_H_
 
+#include <atomic>
+
 #include "api/array_view.h"
 #include "rtc_base/buffer.h"
 
@@ -27,6 +29,8 @@ class AudioDeviceBuffer;
 // buffers differs from 10ms.
 // As an example: calling DeliverRecordedData() with 5ms buffers will deliver
 // accumulated 10ms worth of data to the ADB every second call.
+// GetPlayoutData() and DeliverRecordedData() may be called on different
+// threads, e.g. one per device direction, without additional locking.
 class FineAudioBuffer {
  public:
   // |device_buffer| is a buffer that provides 10ms of audio data.
@@ -85,8 +89,9 @@ class FineAudioBuffer {
   // Storage for input samples that are about to be delivered to the WebRTC
   // ADB or remains from the last successful delivery of a 10ms audio buffer.
   rtc::BufferT<int16_t> record_buffer_;
-  // Contains latest delay estimate given to GetPlayoutData().
-  int playout_delay_ms_ = 0;
+  // Contains latest delay estimate given to GetPlayoutData(). Playout and
+  // recording can run on different device threads, hence the atomic.
+  std::atomic<int> playout_delay_ms_{0};
 };
 
 }  // namespace webrtc
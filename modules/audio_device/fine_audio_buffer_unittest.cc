@@ -152,4 +152,41 @@ TEST(FineBufferTest, GreaterThan10ms) {
   RunFineBufferTest(kFrameSizeSamples);
 }
 
+// Verifies that the latest playout delay is given to the AEC together with the
+// recording delay, as when playout and recording run on separate threads with
+// device periods shorter than 10 ms.
+TEST(FineBufferTest, ReportsLatestPlayoutDelayWithRecordedData) {
+  const int kFrameSizeSamples = kSamplesPer10Ms / 3;
+  const int kPlayoutDelayMs = 7;
+  const int kRecordDelayMs = 3;
+
+  MockAudioDeviceBuffer audio_device_buffer;
+  audio_device_buffer.SetPlayoutSampleRate(kSampleRate);
+  audio_device_buffer.SetPlayoutChannels(kChannels);
+  audio_device_buffer.SetRecordingSampleRate(kSampleRate);
+  audio_device_buffer.SetRecordingChannels(kChannels);
+  EXPECT_CALL(audio_device_buffer, RequestPlayoutData(_))
+      .WillRepeatedly(Return(kSamplesPer10Ms));
+  EXPECT_CALL(audio_device_buffer, GetPlayoutData(_))
+      .WillRepeatedly(Return(kSamplesPer10Ms));
+  EXPECT_CALL(audio_device_buffer, SetRecordedBuffer(_, kSamplesPer10Ms))
+      .Times(1);
+  EXPECT_CALL(audio_device_buffer, SetVQEData(kPlayoutDelayMs, kRecordDelayMs))
+      .Times(1);
+  EXPECT_CALL(audio_device_buffer, DeliverRecordedData())
+      .WillOnce(Return(0));
+
+  FineAudioBuffer fine_buffer(&audio_device_buffer);
+  std::unique_ptr<int16_t[]> buffer(new int16_t[kChannels * kFrameSizeSamples]);
+  for (int i = 0; i < 3; ++i) {
+    fine_buffer.GetPlayoutData(
+        rtc::ArrayView<int16_t>(buffer.get(), kChannels * kFrameSizeSamples),
+        kPlayoutDelayMs + 2 - i);
+    fine_buffer.DeliverRecordedData(
+        rtc::ArrayView<const int16_t>(buffer.get(),
+                                      kChannels * kFrameSizeSamples),
+        kRecordDelayMs);
+  }
+}
+
 }  // namespace webrtc
@@ -11,6 +11,7 @@
 #ifndef MODULES_AUDIO_DEVICE_INCLUDE_AUDIO_DEVICE_H_
 #define MODULES_AUDIO_DEVICE_INCLUDE_AUDIO_DEVICE_H_
 
+#include "api/optional.h"
 #include "modules/audio_device/include/audio_device_defines.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/refcount.h"
@@ -51,6 +52,19 @@ class AudioDeviceModule : public rtc::RefCountInterface {
     kChannelBoth = 2
   };
 
+  // Delays measured by the audio device implementation.
+  struct Stats {
+    // Delay from when audio is handed to the device until it is played out.
+    int playout_delay_ms = 0;
+    // Delay from when audio is captured until it is delivered to WebRTC.
+    int recording_delay_ms = 0;
+    // Measured latency from microphone to speaker through the device buffers,
+    // i.e. the sum of the recording and the playout delay.
+    int round_trip_latency_ms = 0;
+    // True if the device runs with the buffers of its low-latency mode.
+    bool low_latency = false;
+  };
+
  public:
   // Creates an ADM.
   static rtc::scoped_refptr<AudioDeviceModule> Create(
@@ -144,6 +158,10 @@ class AudioDeviceModule : public rtc::RefCountInterface {
   // Playout delay
   virtual int32_t PlayoutDelay(uint16_t* delayMS) const = 0;
 
+  // Returns the delays measured by the audio device, or nothing if they are
+  // not available on this platform.
+  virtual rtc::Optional<Stats> GetStats() const { return rtc::nullopt; }
+
   // Only supported on Android.
   virtual bool BuiltInAECIsAvailable() const = 0;
   virtual bool BuiltInAGCIsAvailable() const = 0;
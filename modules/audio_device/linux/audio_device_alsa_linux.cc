@@ -15,6 +15,7 @@
 #include "rtc_base/logging.h"
 
 #include "system_wrappers/include/event_wrapper.h"
+#include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/sleep.h"
 webrtc::adm_linux_alsa::AlsaSymbolTable AlsaSymbolTable;
 
@@ -56,6 +57,10 @@ static const unsigned int ALSA_CAPTURE_FREQ = 48000;
 static const unsigned int ALSA_CAPTURE_CH = 2;
 static const unsigned int ALSA_CAPTURE_LATENCY = 40 * 1000;  // in us
 static const unsigned int ALSA_CAPTURE_WAIT_TIMEOUT = 5;     // in ms
+// snd_pcm_set_params() splits the latency into four periods, i.e. 5 ms playout
+// and 2.5 ms capture periods in low-latency mode.
+static const unsigned int ALSA_LOW_LATENCY_PLAYOUT_LATENCY = 20 * 1000;  // us
+static const unsigned int ALSA_LOW_LATENCY_CAPTURE_LATENCY = 10 * 1000;  // us
 
 #define FUNC_GET_NUM_OF_DEVICE 0
 #define FUNC_GET_DEVICE_NAME 1
@@ -91,7 +96,11 @@ AudioDeviceLinuxALSA::AudioDeviceLinuxALSA()
       _recIsInitialized(false),
       _playIsInitialized(false),
       _recordingDelay(0),
-      _playoutDelay(0) {
+      _playoutDelay(0),
+      low_latency_(
+          webrtc::field_trial::IsEnabled("WebRTC-Audio-LinuxLowLatency")),
+      play_low_latency_(false),
+      rec_low_latency_(false) {
   memset(_oldKeyState, 0, sizeof(_oldKeyState));
   RTC_LOG(LS_INFO) << __FUNCTION__ << " created";
 }
@@ -811,9 +820,9 @@ int32_t AudioDeviceLinuxALSA::InitPlayout() {
            _playChannels,                  // channels
            _playoutFreq,                   // rate
            1,                              // soft_resample
-           ALSA_PLAYOUT_LATENCY  // 40*1000 //latency required overall latency
-                                 // in us
-           )) < 0) {             /* 0.5sec */
+           low_latency_ ? ALSA_LOW_LATENCY_PLAYOUT_LATENCY
+                        : ALSA_PLAYOUT_LATENCY  // overall latency in us
+           )) < 0) {
     _playoutFramesIn10MS = 0;
     RTC_LOG(LS_ERROR) << "unable to set playback device: "
                       << LATE(snd_strerror)(errVal) << " (" << errVal << ")";
@@ -846,6 +855,13 @@ int32_t AudioDeviceLinuxALSA::InitPlayout() {
   _playoutBufferSizeIn10MS =
       LATE(snd_pcm_frames_to_bytes)(_handlePlayout, _playoutFramesIn10MS);
 
+  // The shared FineAudioBuffer can only be recreated while recording is not
+  // running; otherwise playout keeps the 10 ms path.
+  play_low_latency_ = low_latency_ && _ptrAudioBuffer && !_recording;
+  if (play_low_latency_) {
+    fine_audio_buffer_.reset(new FineAudioBuffer(_ptrAudioBuffer));
+  }
+
   // Init varaibles used for play
 
   if (_handlePlayout != NULL) {
@@ -923,6 +939,8 @@ int32_t AudioDeviceLinuxALSA::InitRecording() {
   }
 
   _recordingFramesIn10MS = _recordingFreq / 100;
+  const unsigned int captureLatency =
+      low_latency_ ? ALSA_LOW_LATENCY_CAPTURE_LATENCY : ALSA_CAPTURE_LATENCY;
   if ((errVal =
            LATE(snd_pcm_set_params)(_handleRecord,
 #if defined(WEBRTC_ARCH_BIG_ENDIAN)
@@ -934,7 +952,7 @@ int32_t AudioDeviceLinuxALSA::InitRecording() {
                                     _recChannels,                   // channels
                                     _recordingFreq,                 // rate
                                     1,                    // soft_resample
-                                    ALSA_CAPTURE_LATENCY  // latency in us
+                                    captureLatency        // latency in us
                                     )) < 0) {
     // Fall back to another mode then.
     if (_recChannels == 1)
@@ -953,7 +971,7 @@ int32_t AudioDeviceLinuxALSA::InitRecording() {
                                       _recChannels,         // channels
                                       _recordingFreq,       // rate
                                       1,                    // soft_resample
-                                      ALSA_CAPTURE_LATENCY  // latency in us
+                                      captureLatency        // latency in us
                                       )) < 0) {
       _recordingFramesIn10MS = 0;
       RTC_LOG(LS_ERROR) << "unable to set record settings: "
@@ -988,6 +1006,13 @@ int32_t AudioDeviceLinuxALSA::InitRecording() {
   _recordingBufferSizeIn10MS =
       LATE(snd_pcm_frames_to_bytes)(_handleRecord, _recordingFramesIn10MS);
 
+  // The shared FineAudioBuffer can only be recreated while playout is not
+  // running; otherwise recording keeps the 10 ms path.
+  rec_low_latency_ = low_latency_ && _ptrAudioBuffer && !_playing;
+  if (rec_low_latency_) {
+    fine_audio_buffer_.reset(new FineAudioBuffer(_ptrAudioBuffer));
+  }
+
   if (_handleRecord != NULL) {
     // Mark recording side as initialized
     _recIsInitialized = true;
@@ -1012,6 +1037,9 @@ int32_t AudioDeviceLinuxALSA::StartRecording() {
 
   int errVal = 0;
   _recordingFramesLeft = _recordingFramesIn10MS;
+  if (rec_low_latency_) {
+    fine_audio_buffer_->ResetRecord();
+  }
 
   // Make sure we only create the buffer once.
   if (!_recordingBuffer)
@@ -1131,6 +1159,9 @@ int32_t AudioDeviceLinuxALSA::StartPlayout() {
   _playing = true;
 
   _playoutFramesLeft = 0;
+  if (play_low_latency_) {
+    fine_audio_buffer_->ResetPlayout();
+  }
   if (!_playoutBuffer)
     _playoutBuffer = new int8_t[_playoutBufferSizeIn10MS];
   if (!_playoutBuffer) {
@@ -1180,6 +1211,10 @@ int32_t AudioDeviceLinuxALSA::StopPlayout() {
   rtc::CritScope lock(&_critSect);
 
   _playoutFramesLeft = 0;
+  if (play_low_latency_) {
+    // Stop handing the playout delay to a running recording.
+    fine_audio_buffer_->ResetPlayout();
+  }
   delete[] _playoutBuffer;
   _playoutBuffer = NULL;
 
@@ -1207,6 +1242,24 @@ int32_t AudioDeviceLinuxALSA::PlayoutDelay(uint16_t& delayMS) const {
   return 0;
 }
 
+rtc::Optional<AudioDeviceModule::Stats> AudioDeviceLinuxALSA::GetStats() const {
+  rtc::CritScope lock(&_critSect);
+  if (!_playing && !_recording) {
+    return rtc::nullopt;
+  }
+  AudioDeviceModule::Stats stats;
+  stats.playout_delay_ms =
+      _playing ? static_cast<int>(_playoutDelay * 1000 / _playoutFreq) : 0;
+  stats.recording_delay_ms =
+      _recording ? static_cast<int>(_recordingDelay * 1000 / _recordingFreq)
+                 : 0;
+  stats.round_trip_latency_ms =
+      stats.playout_delay_ms + stats.recording_delay_ms;
+  stats.low_latency =
+      (_playing && play_low_latency_) || (_recording && rec_low_latency_);
+  return stats;
+}
+
 bool AudioDeviceLinuxALSA::Playing() const {
   return (_playing);
 }
@@ -1489,6 +1542,10 @@ bool AudioDeviceLinuxALSA::PlayThreadProcess() {
     return true;
   }
 
+  if (play_low_latency_) {
+    return PlayLowLatency(avail_frames);
+  }
+
   if (_playoutFramesLeft <= 0) {
     UnLock();
     _ptrAudioBuffer->RequestPlayoutData(_playoutFramesIn10MS);
@@ -1554,6 +1611,10 @@ bool AudioDeviceLinuxALSA::RecThreadProcess() {
     return true;
   }
 
+  if (rec_low_latency_) {
+    return RecLowLatency(avail_frames);
+  }
+
   if (static_cast<uint32_t>(avail_frames) > _recordingFramesLeft)
     avail_frames = _recordingFramesLeft;
 
@@ -1625,6 +1686,94 @@ bool AudioDeviceLinuxALSA::RecThreadProcess() {
   return true;
 }
 
+bool AudioDeviceLinuxALSA::PlayLowLatency(snd_pcm_sframes_t avail_frames) {
+  // Write at most one period at a time to keep the device buffer shallow.
+  snd_pcm_sframes_t frames = avail_frames;
+  if (_playoutPeriodSizeInFrame > 0 &&
+      static_cast<snd_pcm_uframes_t>(frames) > _playoutPeriodSizeInFrame)
+    frames = _playoutPeriodSizeInFrame;
+  if (static_cast<uint32_t>(frames) > _playoutFramesIn10MS)
+    frames = _playoutFramesIn10MS;
+
+  int err = LATE(snd_pcm_delay)(_handlePlayout, &_playoutDelay);
+  if (err < 0) {
+    _playoutDelay = 0;
+    RTC_LOG(LS_ERROR) << "playout snd_pcm_delay: " << LATE(snd_strerror)(err);
+  }
+  const int playoutDelayMs =
+      static_cast<int>(_playoutDelay * 1000 / _playoutFreq);
+
+  // |_playoutBuffer| holds 10 ms and is only touched by this thread.
+  int16_t* audio = reinterpret_cast<int16_t*>(_playoutBuffer);
+  UnLock();
+  fine_audio_buffer_->GetPlayoutData(
+      rtc::ArrayView<int16_t>(audio, frames * _playChannels), playoutDelayMs);
+  Lock();
+
+  // We have been unlocked - check the flag again.
+  if (!_playing) {
+    UnLock();
+    return true;
+  }
+
+  snd_pcm_sframes_t written =
+      LATE(snd_pcm_writei)(_handlePlayout, audio, frames);
+  if (written < 0) {
+    RTC_LOG(LS_VERBOSE) << "playout snd_pcm_writei error: "
+                        << LATE(snd_strerror)(written);
+    ErrorRecovery(written, _handlePlayout);
+  } else {
+    assert(written == frames);
+  }
+
+  UnLock();
+  return true;
+}
+
+bool AudioDeviceLinuxALSA::RecLowLatency(snd_pcm_sframes_t avail_frames) {
+  if (static_cast<uint32_t>(avail_frames) > _recordingFramesIn10MS)
+    avail_frames = _recordingFramesIn10MS;
+
+  int16_t* audio = reinterpret_cast<int16_t*>(_recordingBuffer);
+  snd_pcm_sframes_t frames =
+      LATE(snd_pcm_readi)(_handleRecord, audio, avail_frames);
+  if (frames < 0) {
+    RTC_LOG(LS_ERROR) << "capture snd_pcm_readi error: "
+                      << LATE(snd_strerror)(frames);
+    ErrorRecovery(frames, _handleRecord);
+    UnLock();
+    return true;
+  }
+
+  int err = LATE(snd_pcm_delay)(_handleRecord, &_recordingDelay);
+  if (err < 0) {
+    _recordingDelay = 0;
+    RTC_LOG(LS_ERROR) << "capture snd_pcm_delay: " << LATE(snd_strerror)(err);
+  }
+  int recordingDelayMs =
+      static_cast<int>(_recordingDelay * 1000 / _recordingFreq);
+
+  // The playout delay is handed over from the playout thread by
+  // |fine_audio_buffer_|, unless playout runs the 10 ms path. Account for it
+  // here in that case, since the AEC only uses the sum of the two.
+  if (!play_low_latency_ && _handlePlayout) {
+    err = LATE(snd_pcm_delay)(_handlePlayout, &_playoutDelay);
+    if (err < 0) {
+      _playoutDelay = 0;
+      RTC_LOG(LS_ERROR) << "playout snd_pcm_delay: "
+                        << LATE(snd_strerror)(err);
+    }
+    recordingDelayMs += static_cast<int>(_playoutDelay * 1000 / _playoutFreq);
+  }
+  _ptrAudioBuffer->SetTypingStatus(KeyPressed());
+
+  UnLock();
+  fine_audio_buffer_->DeliverRecordedData(
+      rtc::ArrayView<const int16_t>(audio, frames * _recChannels),
+      recordingDelayMs);
+  return true;
+}
+
 bool AudioDeviceLinuxALSA::KeyPressed() const {
 #if defined(WEBRTC_USE_X11)
   char szKey[32];
@@ -14,6 +14,7 @@
 #include <memory>
 
 #include "modules/audio_device/audio_device_generic.h"
+#include "modules/audio_device/fine_audio_buffer.h"
 #include "modules/audio_device/linux/audio_mixer_manager_alsa_linux.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/platform_thread.h"
@@ -119,6 +120,7 @@ public:
 
     // Delay information and control
     int32_t PlayoutDelay(uint16_t& delayMS) const override;
+    rtc::Optional<AudioDeviceModule::Stats> GetStats() const override;
 
     void AttachAudioBuffer(AudioDeviceBuffer* audioBuffer) override;
 
@@ -142,6 +144,13 @@ private:
     static bool PlayThreadFunc(void*);
     bool RecThreadProcess();
     bool PlayThreadProcess();
+    // Write or read at most one device period through |fine_audio_buffer_|
+    // in low-latency mode. Called by the thread functions with the lock held,
+    // which is released on return.
+    bool PlayLowLatency(snd_pcm_sframes_t avail_frames)
+        RTC_UNLOCK_FUNCTION(_critSect);
+    bool RecLowLatency(snd_pcm_sframes_t avail_frames)
+        RTC_UNLOCK_FUNCTION(_critSect);
 
     AudioDeviceBuffer* _ptrAudioBuffer;
 
@@ -191,6 +200,18 @@ private:
     snd_pcm_sframes_t _recordingDelay;
     snd_pcm_sframes_t _playoutDelay;
 
+    // Set by the "WebRTC-Audio-LinuxLowLatency" field trial. Opens the devices
+    // with 2.5 ms (capture) and 5 ms (playout) periods and moves audio between
+    // the device and the 10 ms AudioDeviceBuffer through |fine_audio_buffer_|.
+    const bool low_latency_;
+    // Shared by the playout and the recording thread, the former handing the
+    // playout delay to the latter through it. Only (re)created by InitPlayout()
+    // and InitRecording() while the other direction is not running.
+    std::unique_ptr<FineAudioBuffer> fine_audio_buffer_;
+    // Whether playout and recording use |fine_audio_buffer_|.
+    bool play_low_latency_;
+    bool rec_low_latency_;
+
     char _oldKeyState[32];
 #if defined(WEBRTC_USE_X11)
     Display* _XDisplay;
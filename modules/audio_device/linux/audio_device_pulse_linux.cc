@@ -15,6 +15,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/event_wrapper.h"
+#include "system_wrappers/include/field_trial.h"
 
 webrtc::adm_linux_pulse::PulseAudioSymbolTable PaSymbolTable;
 
@@ -50,6 +51,8 @@ AudioDeviceLinuxPulse::AudioDeviceLinuxPulse()
       _startPlay(false),
       _stopPlay(false),
       update_speaker_volume_at_startup_(false),
+      low_latency_(
+          webrtc::field_trial::IsEnabled("WebRTC-Audio-LinuxLowLatency")),
       _sndCardPlayDelay(0),
       _sndCardRecDelay(0),
       _writeErrors(0),
@@ -914,8 +917,10 @@ int32_t AudioDeviceLinuxPulse::InitPlayout() {
     }
 
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-    uint32_t latency = bytesPerSec * WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS /
-                       WEBRTC_PA_MSECS_PER_SEC;
+    const uint32_t latencyMsecs =
+        low_latency_ ? WEBRTC_PA_LOW_LATENCY_PLAYBACK_LATENCY_MINIMUM_MSECS
+                     : WEBRTC_PA_PLAYBACK_LATENCY_MINIMUM_MSECS;
+    uint32_t latency = bytesPerSec * latencyMsecs / WEBRTC_PA_MSECS_PER_SEC;
 
     // Set the play buffer attributes
     _playBufferAttr.maxlength = latency;  // num bytes stored in the buffer
@@ -1013,8 +1018,10 @@ int32_t AudioDeviceLinuxPulse::InitRecording() {
     }
 
     size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-    uint32_t latency = bytesPerSec * WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS /
-                       WEBRTC_PA_MSECS_PER_SEC;
+    const uint32_t latencyMsecs =
+        low_latency_ ? WEBRTC_PA_LOW_LATENCY_CAPTURE_LATENCY_MSECS
+                     : WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS;
+    uint32_t latency = bytesPerSec * latencyMsecs / WEBRTC_PA_MSECS_PER_SEC;
 
     // Set the rec buffer attributes
     // Note: fragsize specifies a maximum transfer size, not a minimum, so
@@ -1260,6 +1267,22 @@ int32_t AudioDeviceLinuxPulse::PlayoutDelay(uint16_t& delayMS) const {
   return 0;
 }
 
+rtc::Optional<AudioDeviceModule::Stats> AudioDeviceLinuxPulse::GetStats()
+    const {
+  rtc::CritScope lock(&_critSect);
+  if (!_playing && !_recording) {
+    return rtc::nullopt;
+  }
+  AudioDeviceModule::Stats stats;
+  stats.playout_delay_ms = _playing ? static_cast<int>(_sndCardPlayDelay) : 0;
+  stats.recording_delay_ms =
+      _recording ? static_cast<int>(_sndCardRecDelay) : 0;
+  stats.round_trip_latency_ms =
+      stats.playout_delay_ms + stats.recording_delay_ms;
+  stats.low_latency = low_latency_;
+  return stats;
+}
+
 bool AudioDeviceLinuxPulse::Playing() const {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   return (_playing);
@@ -1778,10 +1801,11 @@ void AudioDeviceLinuxPulse::PaStreamUnderflowCallbackHandler() {
   }
 
   size_t bytesPerSec = LATE(pa_bytes_per_second)(spec);
-  uint32_t newLatency =
-      _configuredLatencyPlay + bytesPerSec *
-                                   WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS /
-                                   WEBRTC_PA_MSECS_PER_SEC;
+  const uint32_t incrementMsecs =
+      low_latency_ ? WEBRTC_PA_LOW_LATENCY_PLAYBACK_LATENCY_INCREMENT_MSECS
+                   : WEBRTC_PA_PLAYBACK_LATENCY_INCREMENT_MSECS;
+  uint32_t newLatency = _configuredLatencyPlay +
+                        bytesPerSec * incrementMsecs / WEBRTC_PA_MSECS_PER_SEC;
 
   // Set the play buffer attributes
   _playBufferAttr.maxlength = newLatency;
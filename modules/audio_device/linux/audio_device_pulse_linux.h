@@ -80,6 +80,13 @@ const uint32_t WEBRTC_PA_LOW_CAPTURE_LATENCY_MSECS = 10;
 // kNoLatencyRequirements case.)
 const uint32_t WEBRTC_PA_CAPTURE_BUFFER_EXTRA_MSECS = 750;
 
+// Low-latency mode, enabled by the "WebRTC-Audio-LinuxLowLatency" field trial.
+// Both directions then transfer 5 ms at a time; playback starts from a 10 ms
+// target latency and backs off in smaller steps when it underflows.
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_LATENCY_MINIMUM_MSECS = 10;
+const uint32_t WEBRTC_PA_LOW_LATENCY_PLAYBACK_LATENCY_INCREMENT_MSECS = 5;
+const uint32_t WEBRTC_PA_LOW_LATENCY_CAPTURE_LATENCY_MSECS = 5;
+
 const uint32_t WEBRTC_PA_MSECS_PER_SEC = 1000;
 
 // Init _configuredLatencyRec/Play to this value to disable latency requirements
@@ -181,6 +188,7 @@ public:
 
     // Delay information and control
     int32_t PlayoutDelay(uint16_t& delayMS) const override;
+    rtc::Optional<AudioDeviceModule::Stats> GetStats() const override;
 
    void AttachAudioBuffer(AudioDeviceBuffer* audioBuffer) override;
 
@@ -286,6 +294,7 @@ private:
  bool _startPlay;
  bool _stopPlay;
  bool update_speaker_volume_at_startup_;
+ const bool low_latency_;
 
  uint32_t _sndCardPlayDelay;
  uint32_t _sndCardRecDelay;
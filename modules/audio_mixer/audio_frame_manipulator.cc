@@ -9,8 +9,10 @@
  */
 
 #include "modules/audio_mixer/audio_frame_manipulator.h"
-#include "audio/utility/audio_frame_operations.h"
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_mixer/mixer_kernels.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/numerics/safe_conversions.h"
 
 namespace webrtc {
 
@@ -19,14 +21,10 @@ uint32_t AudioMixerCalculateEnergy(const AudioFrame& audio_frame) {
     return 0;
   }
 
-  uint32_t energy = 0;
-  const int16_t* frame_data = audio_frame.data();
-  for (size_t position = 0; position < audio_frame.samples_per_channel_;
-       position++) {
-    // TODO(aleloi): This can overflow. Convert to floats.
-    energy += frame_data[position] * frame_data[position];
-  }
-  return energy;
+  // Loud frames exceed the range of the result, saturate rather than wrap
+  // around so that they still rank above quieter ones.
+  return rtc::saturated_cast<uint32_t>(WebRtcSpl_SquaredSumAndMaxAbsW16(
+      audio_frame.data(), audio_frame.samples_per_channel_, nullptr));
 }
 
 void Ramp(float start_gain, float target_gain, AudioFrame* audio_frame) {
@@ -39,26 +37,39 @@ void Ramp(float start_gain, float target_gain, AudioFrame* audio_frame) {
 
   size_t samples = audio_frame->samples_per_channel_;
   RTC_DCHECK_LT(0, samples);
+  RTC_DCHECK_LE(samples, AudioFrame::kMaxDataSizeSamples);
+  // The gains are accumulated one sample at a time, so every implementation
+  // of the kernel applies exactly the same gains.
+  float gains[AudioFrame::kMaxDataSizeSamples];
   float increment = (target_gain - start_gain) / samples;
   float gain = start_gain;
-  int16_t* frame_data = audio_frame->mutable_data();
   for (size_t i = 0; i < samples; ++i) {
-    // If the audio is interleaved of several channels, we want to
-    // apply the same gain change to the ith sample of every channel.
-    for (size_t ch = 0; ch < audio_frame->num_channels_; ++ch) {
-      frame_data[audio_frame->num_channels_ * i + ch] *= gain;
-    }
+    gains[i] = gain;
     gain += increment;
   }
+  GetMixerKernels().apply_gains(gains, audio_frame->num_channels_, samples,
+                                audio_frame->mutable_data());
 }
 
 void RemixFrame(size_t target_number_of_channels, AudioFrame* frame) {
   RTC_DCHECK_GE(target_number_of_channels, 1);
   RTC_DCHECK_LE(target_number_of_channels, 2);
   if (frame->num_channels_ == 1 && target_number_of_channels == 2) {
-    AudioFrameOperations::MonoToStereo(frame);
+    if (frame->samples_per_channel_ * 2 >= AudioFrame::kMaxDataSizeSamples) {
+      // Not enough memory to expand from mono to stereo.
+      return;
+    }
+    if (!frame->muted()) {
+      GetMixerKernels().mono_to_stereo(frame->samples_per_channel_,
+                                       frame->mutable_data());
+    }
+    frame->num_channels_ = 2;
   } else if (frame->num_channels_ == 2 && target_number_of_channels == 1) {
-    AudioFrameOperations::StereoToMono(frame);
+    if (!frame->muted()) {
+      GetMixerKernels().stereo_to_mono(frame->samples_per_channel_,
+                                       frame->mutable_data());
+    }
+    frame->num_channels_ = 1;
   }
 }
 }  // namespace webrtc
@@ -15,7 +15,8 @@
 
 namespace webrtc {
 
-// Updates the audioFrame's energy (based on its samples).
+// Updates the audioFrame's energy (based on its samples). WebRtcSpl_Init()
+// must have been called.
 uint32_t AudioMixerCalculateEnergy(const AudioFrame& audio_frame);
 
 // Ramps up or down the provided audio frame. Ramp(0, 1, frame) will
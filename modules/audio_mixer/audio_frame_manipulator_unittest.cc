@@ -10,6 +10,7 @@
 
 #include <algorithm>
 
+#include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "test/gtest.h"
 
@@ -62,4 +63,15 @@ TEST(AudioFrameManipulator, CompareBackwardRampWithExpectedResultMono) {
       std::equal(frame_data, frame_data + total_samples, expected_result));
 }
 
+TEST(AudioFrameManipulator, EnergySaturatesForLoudFrames) {
+  WebRtcSpl_Init();
+  AudioFrame frame;
+  FillFrameWithConstants(10, 1, 100, &frame);
+  EXPECT_EQ(100000u, AudioMixerCalculateEnergy(frame));
+
+  // 480 full-scale samples sum to more than fits in 32 bits.
+  FillFrameWithConstants(480, 1, -32768, &frame);
+  EXPECT_EQ(0xFFFFFFFFu, AudioMixerCalculateEnergy(frame));
+}
+
 }  // namespace webrtc
@@ -15,6 +15,7 @@
 #include <iterator>
 #include <utility>
 
+#include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "modules/audio_mixer/default_output_rate_calculator.h"
 #include "rtc_base/logging.h"
@@ -109,7 +110,9 @@ AudioMixerImpl::AudioMixerImpl(
       output_frequency_(0),
       sample_size_(0),
       audio_source_list_(),
-      frame_combiner_(ChooseLimiterType(use_limiter)) {}
+      frame_combiner_(ChooseLimiterType(use_limiter)) {
+  WebRtcSpl_Init();
+}
 
 AudioMixerImpl::~AudioMixerImpl() {}
 
@@ -132,6 +135,12 @@ void AudioMixerImpl::SetLimiterType(FrameCombiner::LimiterType limiter_type) {
   frame_combiner_.SetLimiterType(limiter_type);
 }
 
+void AudioMixerImpl::SetSourcePuller(
+    std::unique_ptr<ParallelSourcePuller> puller) {
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  source_puller_ = std::move(puller);
+}
+
 void AudioMixerImpl::Mix(size_t number_of_channels,
                          AudioFrame* audio_frame_for_mixing) {
   RTC_DCHECK(number_of_channels == 1 || number_of_channels == 2);
@@ -195,11 +204,23 @@ AudioFrameList AudioMixerImpl::GetAudioFromSources() {
   std::vector<SourceFrame> audio_source_mixing_data_list;
   std::vector<SourceFrame> ramp_list;
 
+  if (source_puller_) {
+    pull_jobs_.resize(audio_source_list_.size());
+    for (size_t i = 0; i < audio_source_list_.size(); ++i) {
+      pull_jobs_[i].source = audio_source_list_[i]->audio_source;
+      pull_jobs_[i].frame = &audio_source_list_[i]->audio_frame;
+    }
+    source_puller_->Pull(OutputFrequency(), &pull_jobs_);
+  }
+
   // Get audio from the audio sources and put it in the SourceFrame vector.
-  for (auto& source_and_status : audio_source_list_) {
+  for (size_t i = 0; i < audio_source_list_.size(); ++i) {
+    auto& source_and_status = audio_source_list_[i];
     const auto audio_frame_info =
-        source_and_status->audio_source->GetAudioFrameWithInfo(
-            OutputFrequency(), &source_and_status->audio_frame);
+        source_puller_
+            ? pull_jobs_[i].info
+            : source_and_status->audio_source->GetAudioFrameWithInfo(
+                  OutputFrequency(), &source_and_status->audio_frame);
 
     if (audio_frame_info == Source::AudioFrameInfo::kError) {
       RTC_LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
@@ -17,6 +17,7 @@
 #include "api/audio/audio_mixer.h"
 #include "modules/audio_mixer/frame_combiner.h"
 #include "modules/audio_mixer/output_rate_calculator.h"
+#include "modules/audio_mixer/parallel_source_puller.h"
 #include "modules/audio_processing/include/audio_processing.h"
 #include "rtc_base/race_checker.h"
 #include "rtc_base/scoped_ref_ptr.h"
@@ -56,6 +57,10 @@ class AudioMixerImpl : public AudioMixer {
 
   void SetLimiterType(FrameCombiner::LimiterType limiter_type);
 
+  // Pulls the sources' audio with |puller| instead of one after the other on
+  // the mixing thread. Null goes back to serial pulling.
+  void SetSourcePuller(std::unique_ptr<ParallelSourcePuller> puller);
+
   // AudioMixer functions
   bool AddSource(Source* audio_source) override;
   void RemoveSource(Source* audio_source) override;
@@ -108,6 +113,12 @@ class AudioMixerImpl : public AudioMixer {
   // Component that handles actual adding of audio frames.
   FrameCombiner frame_combiner_ RTC_GUARDED_BY(race_checker_);
 
+  std::unique_ptr<ParallelSourcePuller> source_puller_
+      RTC_GUARDED_BY(race_checker_);
+  // Reused by every round, to avoid allocating.
+  std::vector<ParallelSourcePuller::Job> pull_jobs_
+      RTC_GUARDED_BY(race_checker_);
+
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioMixerImpl);
 };
 }  // namespace webrtc
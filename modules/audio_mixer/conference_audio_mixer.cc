@@ -0,0 +1,195 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/conference_audio_mixer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "common_audio/signal_processing/include/signal_processing_library.h"
+#include "modules/audio_mixer/audio_frame_manipulator.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/numerics/safe_conversions.h"
+
+namespace webrtc {
+namespace {
+
+// The audio level of a decoded frame in -dBov, as in the RTP header
+// extension.
+uint8_t AudioLevelOfFrame(const AudioFrame& frame) {
+  const size_t num_samples = frame.samples_per_channel_ * frame.num_channels_;
+  if (frame.muted() || num_samples == 0)
+    return ConferenceAudioMixer::kSilentAudioLevel;
+  const float energy = static_cast<float>(
+      WebRtcSpl_SquaredSumAndMaxAbsW16(frame.data(), num_samples, nullptr));
+  const float rms = std::sqrt(energy / num_samples);
+  if (rms < 1.0f)
+    return ConferenceAudioMixer::kSilentAudioLevel;
+  const float dbov = 20.0f * std::log10(rms / 32768.0f);
+  return rtc::saturated_cast<uint8_t>(std::min(
+      static_cast<float>(ConferenceAudioMixer::kSilentAudioLevel), -dbov));
+}
+
+}  // namespace
+
+ConferenceAudioMixer::ConferenceAudioMixer(size_t max_mixed_sources)
+    : max_mixed_sources_(max_mixed_sources) {
+  WebRtcSpl_Init();
+  std::fill(sum_, sum_ + AudioFrame::kMaxDataSizeSamples, 0);
+}
+
+ConferenceAudioMixer::~ConferenceAudioMixer() = default;
+
+bool ConferenceAudioMixer::AddSource(Source* audio_source) {
+  RTC_DCHECK(audio_source);
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(FindSource(audio_source) == audio_source_list_.end())
+      << "Source already added to mixer";
+  audio_source_list_.emplace_back(new SourceStatus(audio_source));
+  return true;
+}
+
+void ConferenceAudioMixer::RemoveSource(Source* audio_source) {
+  RTC_DCHECK(audio_source);
+  rtc::CritScope lock(&crit_);
+  const auto iter = FindSource(audio_source);
+  RTC_DCHECK(iter != audio_source_list_.end()) << "Source not present in mixer";
+  audio_source_list_.erase(iter);
+}
+
+void ConferenceAudioMixer::Mix(int sample_rate_hz, size_t number_of_channels) {
+  RTC_DCHECK(number_of_channels == 1 || number_of_channels == 2);
+  RTC_DCHECK_RUNS_SERIALIZED(&race_checker_);
+  const size_t samples_per_channel =
+      rtc::CheckedDivExact(sample_rate_hz * kFrameDurationInMs, 1000);
+  const size_t num_samples = samples_per_channel * number_of_channels;
+  RTC_DCHECK_LE(num_samples, AudioFrame::kMaxDataSizeSamples);
+
+  rtc::CritScope lock(&crit_);
+  std::vector<SourceStatus*> ranked_sources;
+  ranked_sources.reserve(audio_source_list_.size());
+  for (auto& source_status : audio_source_list_) {
+    source_status->decoded = false;
+    rtc::Optional<uint8_t> audio_level =
+        source_status->audio_source->AudioLevel();
+    if (!audio_level) {
+      Decode(sample_rate_hz, source_status.get());
+      audio_level = source_status->muted
+                        ? kSilentAudioLevel
+                        : AudioLevelOfFrame(source_status->audio_frame);
+    }
+    source_status->audio_level = *audio_level;
+    ranked_sources.push_back(source_status.get());
+  }
+
+  // Sources that were mixed last round win ties, to not switch back and
+  // forth between sources that are equally loud.
+  std::sort(ranked_sources.begin(), ranked_sources.end(),
+            [](const SourceStatus* a, const SourceStatus* b) {
+              if (a->audio_level != b->audio_level)
+                return a->audio_level < b->audio_level;
+              return a->is_mixed && !b->is_mixed;
+            });
+
+  std::fill(sum_, sum_ + num_samples, 0);
+  size_t num_mixed = 0;
+  for (SourceStatus* source_status : ranked_sources) {
+    bool is_mixed = num_mixed < max_mixed_sources_ &&
+                    source_status->audio_level < kSilentAudioLevel;
+    if (is_mixed && !source_status->decoded)
+      Decode(sample_rate_hz, source_status);
+    // A source that fails to decode leaves its place to the next one.
+    is_mixed = is_mixed && !source_status->muted;
+    source_status->is_mixed = is_mixed;
+    if (!is_mixed) {
+      source_status->gain = 0.0f;
+      continue;
+    }
+
+    AudioFrame* frame = &source_status->audio_frame;
+    RemixFrame(number_of_channels, frame);
+    RTC_DCHECK_EQ(samples_per_channel, frame->samples_per_channel_);
+    Ramp(source_status->gain, 1.0f, frame);
+    source_status->gain = 1.0f;
+    AddToSum(*frame);
+    ++num_mixed;
+  }
+
+  if (num_mixed == 0) {
+    mix_.UpdateFrame(0, nullptr, samples_per_channel, sample_rate_hz,
+                     AudioFrame::kNormalSpeech, AudioFrame::kVadPassive,
+                     number_of_channels);
+    return;
+  }
+  mix_.UpdateFrame(0, nullptr, samples_per_channel, sample_rate_hz,
+                   AudioFrame::kNormalSpeech, AudioFrame::kVadActive,
+                   number_of_channels);
+  int16_t* mix_data = mix_.mutable_data();
+  for (size_t i = 0; i < num_samples; ++i)
+    mix_data[i] = rtc::saturated_cast<int16_t>(sum_[i]);
+}
+
+void ConferenceAudioMixer::GetMixForListener(const Source* listener,
+                                             AudioFrame* frame) const {
+  RTC_DCHECK(frame);
+  rtc::CritScope lock(&crit_);
+  frame->CopyFrom(mix_);
+  const auto iter = FindSource(listener);
+  if (iter == audio_source_list_.end() || !(*iter)->is_mixed)
+    return;
+
+  // Only the few mixed sources need a mix of their own.
+  const int16_t* own_data = (*iter)->audio_frame.data();
+  int16_t* frame_data = frame->mutable_data();
+  const size_t num_samples = frame->samples_per_channel_ * frame->num_channels_;
+  for (size_t i = 0; i < num_samples; ++i)
+    frame_data[i] = rtc::saturated_cast<int16_t>(sum_[i] - own_data[i]);
+}
+
+bool ConferenceAudioMixer::IsMixed(const Source* audio_source) const {
+  rtc::CritScope lock(&crit_);
+  const auto iter = FindSource(audio_source);
+  if (iter != audio_source_list_.end())
+    return (*iter)->is_mixed;
+
+  RTC_LOG(LS_ERROR) << "Audio source unknown";
+  return false;
+}
+
+ConferenceAudioMixer::SourceStatusList::const_iterator
+ConferenceAudioMixer::FindSource(const Source* audio_source) const {
+  return std::find_if(audio_source_list_.begin(), audio_source_list_.end(),
+                      [audio_source](const std::unique_ptr<SourceStatus>& p) {
+                        return p->audio_source == audio_source;
+                      });
+}
+
+void ConferenceAudioMixer::Decode(int sample_rate_hz,
+                                  SourceStatus* source_status) const {
+  const auto audio_frame_info =
+      source_status->audio_source->GetAudioFrameWithInfo(
+          sample_rate_hz, &source_status->audio_frame);
+  if (audio_frame_info == Source::AudioFrameInfo::kError)
+    RTC_LOG_F(LS_WARNING) << "failed to GetAudioFrameWithInfo() from source";
+  source_status->decoded = true;
+  source_status->muted =
+      audio_frame_info != Source::AudioFrameInfo::kNormal ||
+      source_status->audio_frame.muted();
+}
+
+void ConferenceAudioMixer::AddToSum(const AudioFrame& frame) {
+  const int16_t* data = frame.data();
+  const size_t num_samples = frame.samples_per_channel_ * frame.num_channels_;
+  for (size_t i = 0; i < num_samples; ++i)
+    sum_[i] += data[i];
+}
+
+}  // namespace webrtc
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_CONFERENCE_AUDIO_MIXER_H_
+#define MODULES_AUDIO_MIXER_CONFERENCE_AUDIO_MIXER_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_mixer.h"
+#include "api/optional.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/race_checker.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Mixes a conference with many participants, e.g. on a server, where every
+// participant is both a source and a listener.
+//
+// Unlike AudioMixerImpl, which decodes every source to rank them by energy,
+// the sources are ranked by the audio level of their latest packet, from the
+// RTP audio level header extension, and only the loudest ones are decoded.
+// The mixed sources are summed once; each listener then gets that sum minus
+// its own contribution, so a mix per listener is never computed.
+class ConferenceAudioMixer {
+ public:
+  class Source : public AudioMixer::Source {
+   public:
+    // Returns the audio level of the latest received packet, in -dBov from 0
+    // (loudest) to 127 (silence), or nullopt if the stream does not carry
+    // the audio level header extension. Sources without a level are decoded
+    // to be ranked.
+    virtual rtc::Optional<uint8_t> AudioLevel() const = 0;
+
+    ~Source() override {}
+  };
+
+  static const int kFrameDurationInMs = 10;
+  static const size_t kDefaultMaxMixedSources = 3;
+  // The audio level of digital silence.
+  static const uint8_t kSilentAudioLevel = 127;
+
+  explicit ConferenceAudioMixer(size_t max_mixed_sources);
+  ~ConferenceAudioMixer();
+
+  // A source is never added twice. Addition and removal can happen on
+  // different threads.
+  bool AddSource(Source* audio_source);
+  void RemoveSource(Source* audio_source);
+
+  // Decodes the loudest sources and sums them at |sample_rate_hz|. The
+  // outputs are then read with GetMixForListener() until the next call.
+  void Mix(int sample_rate_hz, size_t number_of_channels)
+      RTC_LOCKS_EXCLUDED(crit_);
+
+  // Writes the mix to be sent to |listener|: the mix of all mixed sources
+  // except |listener| itself. |listener| may also be a listener that is not
+  // a source, which gets the full mix.
+  void GetMixForListener(const Source* listener, AudioFrame* frame) const
+      RTC_LOCKS_EXCLUDED(crit_);
+
+  // Returns true if the source was mixed last round.
+  bool IsMixed(const Source* audio_source) const RTC_LOCKS_EXCLUDED(crit_);
+
+ private:
+  struct SourceStatus {
+    explicit SourceStatus(Source* audio_source) : audio_source(audio_source) {}
+    Source* const audio_source;
+    uint8_t audio_level = kSilentAudioLevel;
+    bool decoded = false;
+    bool muted = true;
+    bool is_mixed = false;
+    float gain = 0.0f;
+    AudioFrame audio_frame;
+  };
+
+  using SourceStatusList = std::vector<std::unique_ptr<SourceStatus>>;
+
+  SourceStatusList::const_iterator FindSource(const Source* audio_source) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void Decode(int sample_rate_hz, SourceStatus* source_status) const;
+  void AddToSum(const AudioFrame& frame);
+
+  const size_t max_mixed_sources_;
+
+  // The critical section guards source insertion and removal, which can be
+  // done from any thread, and the outputs. The race checker checks that
+  // mixing is done sequentially.
+  rtc::CriticalSection crit_;
+  rtc::RaceChecker race_checker_;
+
+  SourceStatusList audio_source_list_ RTC_GUARDED_BY(crit_);
+
+  // The sum of the mixed sources without saturation, so the contribution of
+  // each source can be subtracted exactly, and the saturated full mix.
+  int32_t sum_[AudioFrame::kMaxDataSizeSamples] RTC_GUARDED_BY(crit_);
+  AudioFrame mix_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ConferenceAudioMixer);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_CONFERENCE_AUDIO_MIXER_H_
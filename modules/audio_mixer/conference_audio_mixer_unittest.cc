@@ -0,0 +1,132 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/conference_audio_mixer.h"
+
+#include <memory>
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int kSampleRateHz = 16000;
+constexpr size_t kSamplesPerChannel = kSampleRateHz / 100;
+
+// Produces a constant signal and counts how often it is decoded.
+class FakeSource : public ConferenceAudioMixer::Source {
+ public:
+  FakeSource(rtc::Optional<uint8_t> audio_level, int16_t value)
+      : audio_level_(audio_level), value_(value) {}
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    ++num_decoded_frames_;
+    const std::vector<int16_t> data(
+        rtc::CheckedDivExact(sample_rate_hz, 100), value_);
+    audio_frame->UpdateFrame(0, data.data(), data.size(), sample_rate_hz,
+                             AudioFrame::kNormalSpeech,
+                             AudioFrame::kVadActive);
+    return AudioFrameInfo::kNormal;
+  }
+  int Ssrc() const override { return 0; }
+  int PreferredSampleRate() const override { return kSampleRateHz; }
+  rtc::Optional<uint8_t> AudioLevel() const override { return audio_level_; }
+
+  int num_decoded_frames() const { return num_decoded_frames_; }
+
+ private:
+  const rtc::Optional<uint8_t> audio_level_;
+  const int16_t value_;
+  int num_decoded_frames_ = 0;
+};
+
+int16_t FirstSample(const AudioFrame& frame) {
+  return frame.data()[0];
+}
+
+}  // namespace
+
+TEST(ConferenceAudioMixerTest, DecodesOnlyLoudestSources) {
+  ConferenceAudioMixer mixer(ConferenceAudioMixer::kDefaultMaxMixedSources);
+  std::vector<std::unique_ptr<FakeSource>> sources;
+  // Source i has level 20 + i, so the first sources are the loudest.
+  for (uint8_t i = 0; i < 10; ++i) {
+    sources.emplace_back(new FakeSource(20 + i, 1000));
+    mixer.AddSource(sources.back().get());
+  }
+
+  mixer.Mix(kSampleRateHz, 1);
+  for (size_t i = 0; i < sources.size(); ++i) {
+    const bool loudest = i < ConferenceAudioMixer::kDefaultMaxMixedSources;
+    EXPECT_EQ(loudest, mixer.IsMixed(sources[i].get()));
+    EXPECT_EQ(loudest ? 1 : 0, sources[i]->num_decoded_frames());
+  }
+}
+
+TEST(ConferenceAudioMixerTest, SubtractsListenersOwnAudio) {
+  ConferenceAudioMixer mixer(ConferenceAudioMixer::kDefaultMaxMixedSources);
+  FakeSource first(10, 100);
+  FakeSource second(20, 200);
+  FakeSource third(30, 400);
+  FakeSource silent(ConferenceAudioMixer::kSilentAudioLevel, 0);
+  mixer.AddSource(&first);
+  mixer.AddSource(&second);
+  mixer.AddSource(&third);
+  mixer.AddSource(&silent);
+
+  // The first round ramps the sources in.
+  mixer.Mix(kSampleRateHz, 1);
+  mixer.Mix(kSampleRateHz, 1);
+
+  AudioFrame frame;
+  mixer.GetMixForListener(&first, &frame);
+  EXPECT_EQ(kSamplesPerChannel, frame.samples_per_channel_);
+  EXPECT_EQ(kSampleRateHz, frame.sample_rate_hz_);
+  EXPECT_EQ(600, FirstSample(frame));
+  mixer.GetMixForListener(&third, &frame);
+  EXPECT_EQ(300, FirstSample(frame));
+  // A source that is not mixed hears everyone.
+  mixer.GetMixForListener(&silent, &frame);
+  EXPECT_EQ(700, FirstSample(frame));
+  EXPECT_EQ(0, silent.num_decoded_frames());
+}
+
+TEST(ConferenceAudioMixerTest, RanksSourcesWithoutLevelByDecodedAudio) {
+  ConferenceAudioMixer mixer(1);
+  // A constant 1000 is at about -30 dBov.
+  FakeSource without_level(rtc::nullopt, 1000);
+  FakeSource quiet(40, 100);
+  mixer.AddSource(&quiet);
+  mixer.AddSource(&without_level);
+
+  mixer.Mix(kSampleRateHz, 1);
+  EXPECT_TRUE(mixer.IsMixed(&without_level));
+  EXPECT_FALSE(mixer.IsMixed(&quiet));
+  EXPECT_EQ(1, without_level.num_decoded_frames());
+  EXPECT_EQ(0, quiet.num_decoded_frames());
+}
+
+TEST(ConferenceAudioMixerTest, MixesNothingWhenAllAreSilent) {
+  ConferenceAudioMixer mixer(ConferenceAudioMixer::kDefaultMaxMixedSources);
+  FakeSource silent(ConferenceAudioMixer::kSilentAudioLevel, 0);
+  mixer.AddSource(&silent);
+
+  mixer.Mix(kSampleRateHz, 2);
+  EXPECT_FALSE(mixer.IsMixed(&silent));
+  AudioFrame frame;
+  mixer.GetMixForListener(&silent, &frame);
+  EXPECT_TRUE(frame.muted());
+  EXPECT_EQ(2u, frame.num_channels_);
+}
+
+}  // namespace webrtc
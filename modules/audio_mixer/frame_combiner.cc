@@ -19,6 +19,7 @@
 #include "common_audio/include/audio_util.h"
 #include "modules/audio_mixer/audio_frame_manipulator.h"
 #include "modules/audio_mixer/audio_mixer_impl.h"
+#include "modules/audio_mixer/mixer_kernels.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
@@ -108,13 +109,14 @@ std::array<OneChannelBuffer, kMaximumAmountOfChannels> MixToFloatFrame(
   using OneChannelBuffer = std::array<float, kMaximumChannelSize>;
   std::array<OneChannelBuffer, kMaximumAmountOfChannels> mixing_buffer{};
 
-  for (size_t i = 0; i < mix_list.size(); ++i) {
-    const AudioFrame* const frame = mix_list[i];
-    for (size_t j = 0; j < number_of_channels; ++j) {
-      for (size_t k = 0; k < samples_per_channel; ++k) {
-        mixing_buffer[j][k] += frame->data()[number_of_channels * k + j];
-      }
-    }
+  std::array<float*, kMaximumAmountOfChannels> channel_pointers{};
+  for (size_t i = 0; i < number_of_channels; ++i) {
+    channel_pointers[i] = &mixing_buffer[i][0];
+  }
+  const MixerKernels& kernels = GetMixerKernels();
+  for (const AudioFrame* frame : mix_list) {
+    kernels.add_to_float_channels(frame->data(), number_of_channels,
+                                  samples_per_channel, &channel_pointers[0]);
   }
   return mixing_buffer;
 }
@@ -170,15 +172,11 @@ void RunApmAgc2Limiter(AudioFrameView<float> mixing_buffer_view,
 // Both interleaves and rounds.
 void InterleaveToAudioFrame(AudioFrameView<const float> mixing_buffer_view,
                             AudioFrame* audio_frame_for_mixing) {
-  const size_t number_of_channels = mixing_buffer_view.num_channels();
-  const size_t samples_per_channel = mixing_buffer_view.samples_per_channel();
   // Put data in the result frame.
-  for (size_t i = 0; i < number_of_channels; ++i) {
-    for (size_t j = 0; j < samples_per_channel; ++j) {
-      audio_frame_for_mixing->mutable_data()[number_of_channels * j + i] =
-          FloatS16ToS16(mixing_buffer_view.channel(i)[j]);
-    }
-  }
+  GetMixerKernels().float_channels_to_s16(
+      mixing_buffer_view.data(), mixing_buffer_view.num_channels(),
+      mixing_buffer_view.samples_per_channel(),
+      audio_frame_for_mixing->mutable_data());
 }
 }  // namespace
 
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixer_kernels.h"
+
+#include "common_audio/include/audio_util.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+void AddToFloatChannels_C(const int16_t* src,
+                          size_t num_channels,
+                          size_t samples_per_channel,
+                          float* const* dst) {
+  for (size_t ch = 0; ch < num_channels; ++ch) {
+    for (size_t i = 0; i < samples_per_channel; ++i)
+      dst[ch][i] += src[num_channels * i + ch];
+  }
+}
+
+void ApplyGains_C(const float* gains,
+                  size_t num_channels,
+                  size_t samples_per_channel,
+                  int16_t* data) {
+  for (size_t i = 0; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      data[num_channels * i + ch] *= gains[i];
+  }
+}
+
+void FloatChannelsToS16_C(const float* const* src,
+                          size_t num_channels,
+                          size_t samples_per_channel,
+                          int16_t* dst) {
+  for (size_t ch = 0; ch < num_channels; ++ch) {
+    for (size_t i = 0; i < samples_per_channel; ++i)
+      dst[num_channels * i + ch] = FloatS16ToS16(src[ch][i]);
+  }
+}
+
+void MonoToStereo_C(size_t samples_per_channel, int16_t* data) {
+  // Backwards, so no sample is overwritten before it is read.
+  for (size_t i = samples_per_channel; i-- > 0;) {
+    data[2 * i + 1] = data[i];
+    data[2 * i] = data[i];
+  }
+}
+
+void StereoToMono_C(size_t samples_per_channel, int16_t* data) {
+  for (size_t i = 0; i < samples_per_channel; ++i) {
+    data[i] = (static_cast<int32_t>(data[2 * i]) + data[2 * i + 1]) >> 1;
+  }
+}
+
+MixerKernels DetectMixerKernels() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2))
+    return MixerKernelsAvx2();
+  if (WebRtc_GetCPUInfo(kSSE2))
+    return MixerKernelsSse2();
+#elif defined(WEBRTC_HAS_NEON)
+  return MixerKernelsNeon();
+#endif
+  return MixerKernelsC();
+}
+
+}  // namespace
+
+MixerKernels MixerKernelsC() {
+  return {AddToFloatChannels_C, ApplyGains_C, FloatChannelsToS16_C,
+          MonoToStereo_C, StereoToMono_C};
+}
+
+const MixerKernels& GetMixerKernels() {
+  static const MixerKernels kernels = DetectMixerKernels();
+  return kernels;
+}
+
+}  // namespace webrtc
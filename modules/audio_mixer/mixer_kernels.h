@@ -0,0 +1,63 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_MIXER_KERNELS_H_
+#define MODULES_AUDIO_MIXER_MIXER_KERNELS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "typedefs.h"  // NOLINT(build/include)
+
+namespace webrtc {
+
+// The per-sample loops of mixing. Interleaved int16 audio has mono or stereo
+// samples. All implementations give bit-exact results.
+struct MixerKernels {
+  // Adds interleaved |src| to the deinterleaved float channels |dst|.
+  void (*add_to_float_channels)(const int16_t* src,
+                                size_t num_channels,
+                                size_t samples_per_channel,
+                                float* const* dst);
+  // Multiplies the samples of every channel at index i by |gains[i]|,
+  // truncating as int16_t *= float does.
+  void (*apply_gains)(const float* gains,
+                      size_t num_channels,
+                      size_t samples_per_channel,
+                      int16_t* data);
+  // Rounds and saturates the FloatS16 channels |src| into interleaved |dst|,
+  // as FloatS16ToS16() does.
+  void (*float_channels_to_s16)(const float* const* src,
+                                size_t num_channels,
+                                size_t samples_per_channel,
+                                int16_t* dst);
+  // Remix in place; |data| must have room for the stereo samples.
+  void (*mono_to_stereo)(size_t samples_per_channel, int16_t* data);
+  void (*stereo_to_mono)(size_t samples_per_channel, int16_t* data);
+};
+
+// Returns the fastest kernels that the CPU supports.
+const MixerKernels& GetMixerKernels();
+
+// The implementations, for testing and benchmarking. Only call the SIMD ones
+// if the CPU supports them.
+MixerKernels MixerKernelsC();
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+MixerKernels MixerKernelsSse2();
+// Uses SSE2 where AVX2 does not help.
+MixerKernels MixerKernelsAvx2();
+#endif
+#if defined(WEBRTC_HAS_NEON)
+MixerKernels MixerKernelsNeon();
+#endif
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_MIXER_KERNELS_H_
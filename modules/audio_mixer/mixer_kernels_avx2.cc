@@ -0,0 +1,106 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixer_kernels.h"
+
+#include <immintrin.h>
+
+#include "common_audio/include/audio_util.h"
+
+namespace webrtc {
+namespace {
+
+inline __m256 LoadToFloat(const int16_t* src) {
+  return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(src))));
+}
+
+inline void AddTo(float* dst, __m256 v) {
+  _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), v));
+}
+
+// Saturates and rounds half away from zero, as FloatS16ToS16().
+inline __m256i RoundFloatS16(__m256 v) {
+  const __m256 kSignMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x80000000));
+  v = _mm256_min_ps(_mm256_max_ps(v, _mm256_set1_ps(-32768.f)),
+                    _mm256_set1_ps(32767.f));
+  const __m256 half =
+      _mm256_or_ps(_mm256_and_ps(v, kSignMask), _mm256_set1_ps(0.5f));
+  return _mm256_cvttps_epi32(_mm256_add_ps(v, half));
+}
+
+void AddToFloatChannels_AVX2(const int16_t* src,
+                             size_t num_channels,
+                             size_t samples_per_channel,
+                             float* const* dst) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8)
+      AddTo(dst[0] + i, LoadToFloat(src + i));
+  } else if (num_channels == 2) {
+    // Moves the left samples to the low lane and the right ones to the high.
+    const __m256i kDeinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const __m256 first =
+          _mm256_permutevar8x32_ps(LoadToFloat(src + 2 * i), kDeinterleave);
+      const __m256 second = _mm256_permutevar8x32_ps(
+          LoadToFloat(src + 2 * i + 8), kDeinterleave);
+      AddTo(dst[0] + i, _mm256_permute2f128_ps(first, second, 0x20));
+      AddTo(dst[1] + i, _mm256_permute2f128_ps(first, second, 0x31));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      dst[ch][i] += src[num_channels * i + ch];
+  }
+}
+
+void FloatChannelsToS16_AVX2(const float* const* src,
+                             size_t num_channels,
+                             size_t samples_per_channel,
+                             int16_t* dst) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 16 <= samples_per_channel; i += 16) {
+      const __m256i first = RoundFloatS16(_mm256_loadu_ps(src[0] + i));
+      const __m256i second = RoundFloatS16(_mm256_loadu_ps(src[0] + i + 8));
+      // Packing works within 128-bit lanes, so the quarters are reordered.
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(dst + i),
+          _mm256_permute4x64_epi64(_mm256_packs_epi32(first, second),
+                                   _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const __m256i left = RoundFloatS16(_mm256_loadu_ps(src[0] + i));
+      const __m256i right = RoundFloatS16(_mm256_loadu_ps(src[1] + i));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(dst + 2 * i),
+          _mm256_packs_epi32(_mm256_unpacklo_epi32(left, right),
+                             _mm256_unpackhi_epi32(left, right)));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      dst[num_channels * i + ch] = FloatS16ToS16(src[ch][i]);
+  }
+}
+
+}  // namespace
+
+MixerKernels MixerKernelsAvx2() {
+  // Ramping and remixing are rare or memory bound, so they stay on SSE2.
+  MixerKernels kernels = MixerKernelsSse2();
+  kernels.add_to_float_channels = AddToFloatChannels_AVX2;
+  kernels.float_channels_to_s16 = FloatChannelsToS16_AVX2;
+  return kernels;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,161 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixer_kernels.h"
+
+#include <arm_neon.h>
+
+#include "common_audio/include/audio_util.h"
+
+namespace webrtc {
+namespace {
+
+inline float32x4_t ToFloat(int16x4_t s) {
+  return vcvtq_f32_s32(vmovl_s16(s));
+}
+
+inline void AddTo(float* dst, float32x4_t v) {
+  vst1q_f32(dst, vaddq_f32(vld1q_f32(dst), v));
+}
+
+// Truncates as int16_t *= float does, saturating.
+inline int16x4_t TruncateToS16(float32x4_t v) {
+  return vqmovn_s32(vcvtq_s32_f32(v));
+}
+
+// Saturates and rounds half away from zero, as FloatS16ToS16().
+inline int16x4_t RoundFloatS16(float32x4_t v) {
+  v = vminq_f32(vmaxq_f32(v, vdupq_n_f32(-32768.f)), vdupq_n_f32(32767.f));
+  const uint32x4_t sign =
+      vandq_u32(vreinterpretq_u32_f32(v), vdupq_n_u32(0x80000000));
+  const float32x4_t half = vreinterpretq_f32_u32(
+      vorrq_u32(sign, vreinterpretq_u32_f32(vdupq_n_f32(0.5f))));
+  return TruncateToS16(vaddq_f32(v, half));
+}
+
+void AddToFloatChannels_NEON(const int16_t* src,
+                             size_t num_channels,
+                             size_t samples_per_channel,
+                             float* const* dst) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const int16x8_t s = vld1q_s16(src + i);
+      AddTo(dst[0] + i, ToFloat(vget_low_s16(s)));
+      AddTo(dst[0] + i + 4, ToFloat(vget_high_s16(s)));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      const int16x4x2_t s = vld2_s16(src + 2 * i);
+      AddTo(dst[0] + i, ToFloat(s.val[0]));
+      AddTo(dst[1] + i, ToFloat(s.val[1]));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      dst[ch][i] += src[num_channels * i + ch];
+  }
+}
+
+void ApplyGains_NEON(const float* gains,
+                     size_t num_channels,
+                     size_t samples_per_channel,
+                     int16_t* data) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const int16x8_t s = vld1q_s16(data + i);
+      const int16x4_t low = TruncateToS16(
+          vmulq_f32(ToFloat(vget_low_s16(s)), vld1q_f32(gains + i)));
+      const int16x4_t high = TruncateToS16(
+          vmulq_f32(ToFloat(vget_high_s16(s)), vld1q_f32(gains + i + 4)));
+      vst1q_s16(data + i, vcombine_s16(low, high));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      int16x4x2_t s = vld2_s16(data + 2 * i);
+      const float32x4_t g = vld1q_f32(gains + i);
+      s.val[0] = TruncateToS16(vmulq_f32(ToFloat(s.val[0]), g));
+      s.val[1] = TruncateToS16(vmulq_f32(ToFloat(s.val[1]), g));
+      vst2_s16(data + 2 * i, s);
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      data[num_channels * i + ch] *= gains[i];
+  }
+}
+
+void FloatChannelsToS16_NEON(const float* const* src,
+                             size_t num_channels,
+                             size_t samples_per_channel,
+                             int16_t* dst) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      vst1q_s16(dst + i,
+                vcombine_s16(RoundFloatS16(vld1q_f32(src[0] + i)),
+                             RoundFloatS16(vld1q_f32(src[0] + i + 4))));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      int16x4x2_t s;
+      s.val[0] = RoundFloatS16(vld1q_f32(src[0] + i));
+      s.val[1] = RoundFloatS16(vld1q_f32(src[1] + i));
+      vst2_s16(dst + 2 * i, s);
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      dst[num_channels * i + ch] = FloatS16ToS16(src[ch][i]);
+  }
+}
+
+void MonoToStereo_NEON(size_t samples_per_channel, int16_t* data) {
+  // Backwards, so no sample is overwritten before it is read.
+  size_t i = samples_per_channel;
+  for (; i % 8 != 0; --i) {
+    data[2 * i - 1] = data[i - 1];
+    data[2 * i - 2] = data[i - 1];
+  }
+  while (i > 0) {
+    i -= 8;
+    const int16x8_t s = vld1q_s16(data + i);
+    int16x8x2_t stereo;
+    stereo.val[0] = s;
+    stereo.val[1] = s;
+    vst2q_s16(data + 2 * i, stereo);
+  }
+}
+
+void StereoToMono_NEON(size_t samples_per_channel, int16_t* data) {
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    const int16x8x2_t s = vld2q_s16(data + 2 * i);
+    const int32x4_t low =
+        vaddl_s16(vget_low_s16(s.val[0]), vget_low_s16(s.val[1]));
+    const int32x4_t high =
+        vaddl_s16(vget_high_s16(s.val[0]), vget_high_s16(s.val[1]));
+    vst1q_s16(data + i, vcombine_s16(vmovn_s32(vshrq_n_s32(low, 1)),
+                                     vmovn_s32(vshrq_n_s32(high, 1))));
+  }
+  for (; i < samples_per_channel; ++i) {
+    data[i] = (static_cast<int32_t>(data[2 * i]) + data[2 * i + 1]) >> 1;
+  }
+}
+
+}  // namespace
+
+MixerKernels MixerKernelsNeon() {
+  return {AddToFloatChannels_NEON, ApplyGains_NEON, FloatChannelsToS16_NEON,
+          MonoToStereo_NEON, StereoToMono_NEON};
+}
+
+}  // namespace webrtc
@@ -0,0 +1,173 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixer_kernels.h"
+
+#include <emmintrin.h>
+
+#include "common_audio/include/audio_util.h"
+
+namespace webrtc {
+namespace {
+
+// Sign-extends the low and high four samples of |s| to floats.
+inline __m128 LowToFloat(__m128i s) {
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(s, s), 16));
+}
+
+inline __m128 HighToFloat(__m128i s) {
+  return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(s, s), 16));
+}
+
+inline void AddTo(float* dst, __m128 v) {
+  _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), v));
+}
+
+// Saturates and rounds half away from zero, as FloatS16ToS16().
+inline __m128i RoundFloatS16(__m128 v) {
+  const __m128 kSignMask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+  v = _mm_min_ps(_mm_max_ps(v, _mm_set1_ps(-32768.f)), _mm_set1_ps(32767.f));
+  const __m128 half = _mm_or_ps(_mm_and_ps(v, kSignMask), _mm_set1_ps(0.5f));
+  return _mm_cvttps_epi32(_mm_add_ps(v, half));
+}
+
+void AddToFloatChannels_SSE2(const int16_t* src,
+                             size_t num_channels,
+                             size_t samples_per_channel,
+                             float* const* dst) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const __m128i s =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      AddTo(dst[0] + i, LowToFloat(s));
+      AddTo(dst[0] + i + 4, HighToFloat(s));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      const __m128i s =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * i));
+      const __m128 low = LowToFloat(s);
+      const __m128 high = HighToFloat(s);
+      AddTo(dst[0] + i, _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0)));
+      AddTo(dst[1] + i, _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      dst[ch][i] += src[num_channels * i + ch];
+  }
+}
+
+void ApplyGains_SSE2(const float* gains,
+                     size_t num_channels,
+                     size_t samples_per_channel,
+                     int16_t* data) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      __m128i* p = reinterpret_cast<__m128i*>(data + i);
+      const __m128i s = _mm_loadu_si128(p);
+      const __m128 low = _mm_mul_ps(LowToFloat(s), _mm_loadu_ps(gains + i));
+      const __m128 high =
+          _mm_mul_ps(HighToFloat(s), _mm_loadu_ps(gains + i + 4));
+      _mm_storeu_si128(p, _mm_packs_epi32(_mm_cvttps_epi32(low),
+                                          _mm_cvttps_epi32(high)));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      __m128i* p = reinterpret_cast<__m128i*>(data + 2 * i);
+      const __m128i s = _mm_loadu_si128(p);
+      const __m128 g = _mm_loadu_ps(gains + i);
+      const __m128 low = _mm_mul_ps(LowToFloat(s), _mm_unpacklo_ps(g, g));
+      const __m128 high = _mm_mul_ps(HighToFloat(s), _mm_unpackhi_ps(g, g));
+      _mm_storeu_si128(p, _mm_packs_epi32(_mm_cvttps_epi32(low),
+                                          _mm_cvttps_epi32(high)));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      data[num_channels * i + ch] *= gains[i];
+  }
+}
+
+void FloatChannelsToS16_SSE2(const float* const* src,
+                             size_t num_channels,
+                             size_t samples_per_channel,
+                             int16_t* dst) {
+  size_t i = 0;
+  if (num_channels == 1) {
+    for (; i + 8 <= samples_per_channel; i += 8) {
+      const __m128i low = RoundFloatS16(_mm_loadu_ps(src[0] + i));
+      const __m128i high = RoundFloatS16(_mm_loadu_ps(src[0] + i + 4));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_packs_epi32(low, high));
+    }
+  } else if (num_channels == 2) {
+    for (; i + 4 <= samples_per_channel; i += 4) {
+      const __m128i left = RoundFloatS16(_mm_loadu_ps(src[0] + i));
+      const __m128i right = RoundFloatS16(_mm_loadu_ps(src[1] + i));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i),
+                       _mm_packs_epi32(_mm_unpacklo_epi32(left, right),
+                                       _mm_unpackhi_epi32(left, right)));
+    }
+  }
+  for (; i < samples_per_channel; ++i) {
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      dst[num_channels * i + ch] = FloatS16ToS16(src[ch][i]);
+  }
+}
+
+void MonoToStereo_SSE2(size_t samples_per_channel, int16_t* data) {
+  // Backwards, so no sample is overwritten before it is read.
+  size_t i = samples_per_channel;
+  for (; i % 8 != 0; --i) {
+    data[2 * i - 1] = data[i - 1];
+    data[2 * i - 2] = data[i - 1];
+  }
+  while (i > 0) {
+    i -= 8;
+    const __m128i s =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 2 * i),
+                     _mm_unpacklo_epi16(s, s));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + 2 * i + 8),
+                     _mm_unpackhi_epi16(s, s));
+  }
+}
+
+void StereoToMono_SSE2(size_t samples_per_channel, int16_t* data) {
+  const __m128i kOnes = _mm_set1_epi16(1);
+  size_t i = 0;
+  for (; i + 8 <= samples_per_channel; i += 8) {
+    // Sums the left and right samples of each pair to 32 bits.
+    const __m128i low = _mm_madd_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i)),
+        kOnes);
+    const __m128i high = _mm_madd_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2 * i + 8)),
+        kOnes);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(data + i),
+                     _mm_packs_epi32(_mm_srai_epi32(low, 1),
+                                     _mm_srai_epi32(high, 1)));
+  }
+  for (; i < samples_per_channel; ++i) {
+    data[i] = (static_cast<int32_t>(data[2 * i]) + data[2 * i + 1]) >> 1;
+  }
+}
+
+}  // namespace
+
+MixerKernels MixerKernelsSse2() {
+  return {AddToFloatChannels_SSE2, ApplyGains_SSE2, FloatChannelsToS16_SSE2,
+          MonoToStereo_SSE2, StereoToMono_SSE2};
+}
+
+}  // namespace webrtc
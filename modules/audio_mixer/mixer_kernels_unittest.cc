@@ -0,0 +1,196 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/mixer_kernels.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+// Includes lengths that are not a multiple of the vector widths.
+const size_t kSamplesPerChannel[] = {80, 83, 160, 441, 480};
+
+std::vector<std::pair<std::string, MixerKernels>> SimdKernels() {
+  std::vector<std::pair<std::string, MixerKernels>> kernels;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2))
+    kernels.emplace_back("SSE2", MixerKernelsSse2());
+  if (WebRtc_GetCPUInfo(kAVX2))
+    kernels.emplace_back("AVX2", MixerKernelsAvx2());
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  kernels.emplace_back("NEON", MixerKernelsNeon());
+#endif
+  return kernels;
+}
+
+std::vector<int16_t> RandomSamples(size_t size, Random* random) {
+  std::vector<int16_t> samples(size);
+  for (int16_t& sample : samples)
+    sample = random->Rand<int16_t>();
+  return samples;
+}
+
+// Includes values that round half away from zero and values that saturate.
+std::vector<float> RandomFloatS16(size_t size, Random* random) {
+  std::vector<float> samples(size);
+  for (float& sample : samples) {
+    sample = random->Rand(-40000, 40000);
+    if (random->Rand(1))
+      sample += 0.5f;
+  }
+  return samples;
+}
+
+std::vector<float*> ChannelPointers(std::vector<std::vector<float>>* channels) {
+  std::vector<float*> pointers;
+  for (auto& channel : *channels)
+    pointers.push_back(channel.data());
+  return pointers;
+}
+
+}  // namespace
+
+TEST(MixerKernelsTest, SimdKernelsMatchC) {
+  const MixerKernels c = MixerKernelsC();
+  Random random(0x5eed);
+  for (const auto& simd : SimdKernels()) {
+    for (size_t num_channels = 1; num_channels <= 2; ++num_channels) {
+      for (size_t samples_per_channel : kSamplesPerChannel) {
+        SCOPED_TRACE(simd.first + ", " + std::to_string(num_channels) +
+                     " channels, " + std::to_string(samples_per_channel));
+        const size_t num_samples = num_channels * samples_per_channel;
+        const std::vector<int16_t> src =
+            RandomSamples(num_samples, &random);
+
+        std::vector<std::vector<float>> expected_sum(
+            num_channels, RandomFloatS16(samples_per_channel, &random));
+        std::vector<std::vector<float>> sum = expected_sum;
+        c.add_to_float_channels(src.data(), num_channels, samples_per_channel,
+                                ChannelPointers(&expected_sum).data());
+        simd.second.add_to_float_channels(src.data(), num_channels,
+                                          samples_per_channel,
+                                          ChannelPointers(&sum).data());
+        EXPECT_EQ(expected_sum, sum);
+
+        std::vector<float> gains(samples_per_channel);
+        for (size_t i = 0; i < samples_per_channel; ++i)
+          gains[i] = static_cast<float>(i) / samples_per_channel;
+        std::vector<int16_t> expected = src;
+        std::vector<int16_t> output = src;
+        c.apply_gains(gains.data(), num_channels, samples_per_channel,
+                      expected.data());
+        simd.second.apply_gains(gains.data(), num_channels,
+                                samples_per_channel, output.data());
+        EXPECT_EQ(expected, output);
+
+        c.float_channels_to_s16(ChannelPointers(&sum).data(), num_channels,
+                                samples_per_channel, expected.data());
+        simd.second.float_channels_to_s16(ChannelPointers(&sum).data(),
+                                          num_channels, samples_per_channel,
+                                          output.data());
+        EXPECT_EQ(expected, output);
+      }
+    }
+  }
+}
+
+TEST(MixerKernelsTest, SimdRemixMatchesC) {
+  const MixerKernels c = MixerKernelsC();
+  Random random(0x5eed);
+  for (const auto& simd : SimdKernels()) {
+    for (size_t samples_per_channel : kSamplesPerChannel) {
+      SCOPED_TRACE(simd.first + ", " + std::to_string(samples_per_channel));
+      const std::vector<int16_t> src =
+          RandomSamples(2 * samples_per_channel, &random);
+
+      std::vector<int16_t> expected = src;
+      std::vector<int16_t> output = src;
+      c.mono_to_stereo(samples_per_channel, expected.data());
+      simd.second.mono_to_stereo(samples_per_channel, output.data());
+      EXPECT_EQ(expected, output);
+
+      expected = src;
+      output = src;
+      c.stereo_to_mono(samples_per_channel, expected.data());
+      simd.second.stereo_to_mono(samples_per_channel, output.data());
+      EXPECT_EQ(expected, output);
+    }
+  }
+}
+
+TEST(MixerKernelsTest, RemixesInPlace) {
+  const MixerKernels& kernels = GetMixerKernels();
+  std::vector<int16_t> data = {1, 2, 3, 0, 0, 0};
+  kernels.mono_to_stereo(3, data.data());
+  EXPECT_EQ(std::vector<int16_t>({1, 1, 2, 2, 3, 3}), data);
+
+  data = {1, 3, -5, -2, 32767, 32767};
+  kernels.stereo_to_mono(3, data.data());
+  EXPECT_EQ(2, data[0]);
+  EXPECT_EQ(-4, data[1]);
+  EXPECT_EQ(32767, data[2]);
+}
+
+// Times mixing stereo frames of a few to many sources, with the C and the
+// fastest kernels.
+TEST(MixerKernelsTest, DISABLED_Benchmark) {
+  const int kIterations = 10000;
+  const size_t kNumChannels = 2;
+  const std::pair<const char*, MixerKernels> kernels[] = {
+      {"C", MixerKernelsC()}, {"fastest", GetMixerKernels()}};
+  Random random(0x5eed);
+  for (int sample_rate_hz : {8000, 16000, 48000}) {
+    const size_t samples_per_channel = sample_rate_hz / 100;
+    for (size_t num_sources = 2; num_sources <= 64; num_sources *= 2) {
+      std::vector<std::vector<int16_t>> sources;
+      for (size_t i = 0; i < num_sources; ++i) {
+        sources.push_back(
+            RandomSamples(kNumChannels * samples_per_channel, &random));
+      }
+      std::vector<std::vector<float>> sum(
+          kNumChannels, std::vector<float>(samples_per_channel));
+      const std::vector<float*> sum_pointers = ChannelPointers(&sum);
+      std::vector<int16_t> mix(kNumChannels * samples_per_channel);
+      for (const auto& k : kernels) {
+        int64_t start_ns = rtc::TimeNanos();
+        for (int i = 0; i < kIterations; ++i) {
+          for (auto& channel : sum)
+            std::fill(channel.begin(), channel.end(), 0.f);
+          for (const auto& source : sources) {
+            k.second.add_to_float_channels(source.data(), kNumChannels,
+                                           samples_per_channel,
+                                           sum_pointers.data());
+          }
+          k.second.float_channels_to_s16(sum_pointers.data(),
+                                         kNumChannels, samples_per_channel,
+                                         mix.data());
+        }
+        const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+        test::PrintResult(
+            "mix_time", std::string("_") + k.first,
+            std::to_string(sample_rate_hz) + "_hz_" +
+                std::to_string(num_sources) + "_sources",
+            static_cast<double>(elapsed_ns) / kIterations, "ns", false);
+      }
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/parallel_source_puller.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace {
+
+// Late ticks are summarized in the log this often, 10 s of 10 ms ticks,
+// instead of logged one by one on a machine that is too slow for the load.
+const int64_t kLogLateTicksIntervalTicks = 1000;
+
+}  // namespace
+
+class ParallelSourcePuller::Worker {
+ public:
+  explicit Worker(ParallelSourcePuller* puller)
+      : puller_(puller),
+        wake_up_(false, false),
+        thread_(&Worker::Run, this, "ParallelPull", rtc::kRealtimePriority) {
+    thread_.Start();
+  }
+
+  ~Worker() {
+    stop_ = true;
+    wake_up_.Set();
+    thread_.Stop();
+  }
+
+  void WakeUp() { wake_up_.Set(); }
+
+ private:
+  static void Run(void* obj) {
+    Worker* worker = static_cast<Worker*>(obj);
+    while (true) {
+      worker->wake_up_.Wait(rtc::Event::kForever);
+      if (worker->stop_)
+        return;
+      worker->puller_->RunJobs();
+    }
+  }
+
+  ParallelSourcePuller* const puller_;
+  std::atomic<bool> stop_{false};
+  rtc::Event wake_up_;
+  rtc::PlatformThread thread_;
+};
+
+ParallelSourcePuller::ParallelSourcePuller(int num_threads, int deadline_ms)
+    : deadline_us_(deadline_ms * rtc::kNumMicrosecsPerMillisec),
+      tick_done_(false, false) {
+  RTC_DCHECK_GE(num_threads, 0);
+  for (int i = 0; i < num_threads; ++i)
+    workers_.emplace_back(new Worker(this));
+}
+
+ParallelSourcePuller::~ParallelSourcePuller() = default;
+
+void ParallelSourcePuller::Pull(int sample_rate_hz, std::vector<Job>* jobs) {
+  RTC_DCHECK(jobs);
+  if (jobs->empty())
+    return;
+  const int64_t start_us = rtc::TimeMicros();
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(!jobs_) << "Pull() must not be called concurrently";
+    jobs_ = jobs;
+    sample_rate_hz_ = sample_rate_hz;
+    next_job_ = 0;
+    num_pending_jobs_ = jobs->size();
+  }
+  // Waking up more workers than there are jobs would only add overhead.
+  for (size_t i = 0; i < std::min(workers_.size(), jobs->size() - 1); ++i)
+    workers_[i]->WakeUp();
+  RunJobs();
+  tick_done_.Wait(rtc::Event::kForever);
+
+  const int64_t duration_us = rtc::TimeMicros() - start_us;
+  rtc::CritScope lock(&crit_);
+  jobs_ = nullptr;
+  ++stats_.num_ticks;
+  stats_.total_tick_duration_us += duration_us;
+  stats_.max_tick_duration_us =
+      std::max(stats_.max_tick_duration_us, duration_us);
+  if (duration_us > deadline_us_) {
+    ++stats_.num_late_ticks;
+    ++late_ticks_since_log_;
+    max_late_tick_duration_us_ =
+        std::max(max_late_tick_duration_us_, duration_us);
+  }
+  if (stats_.num_ticks % kLogLateTicksIntervalTicks == 0 &&
+      late_ticks_since_log_ > 0) {
+    RTC_LOG(LS_INFO) << late_ticks_since_log_ << " of the last "
+                     << kLogLateTicksIntervalTicks
+                     << " source pulls took longer than " << deadline_us_
+                     << " us, the longest " << max_late_tick_duration_us_
+                     << " us";
+    late_ticks_since_log_ = 0;
+    max_late_tick_duration_us_ = 0;
+  }
+}
+
+ParallelSourcePuller::Stats ParallelSourcePuller::GetStats() const {
+  rtc::CritScope lock(&crit_);
+  return stats_;
+}
+
+void ParallelSourcePuller::RunJobs() {
+  while (true) {
+    Job* job;
+    int sample_rate_hz;
+    {
+      rtc::CritScope lock(&crit_);
+      // A worker woken up for an earlier tick may find nothing to do.
+      if (!jobs_ || next_job_ == jobs_->size())
+        return;
+      job = &(*jobs_)[next_job_++];
+      sample_rate_hz = sample_rate_hz_;
+    }
+    job->info = job->source->GetAudioFrameWithInfo(sample_rate_hz, job->frame);
+    rtc::CritScope lock(&crit_);
+    if (--num_pending_jobs_ == 0)
+      tick_done_.Set();
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_MIXER_PARALLEL_SOURCE_PULLER_H_
+#define MODULES_AUDIO_MIXER_PARALLEL_SOURCE_PULLER_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/audio/audio_mixer.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Pulls the 10 ms frames of many mixer sources concurrently, on a set of
+// worker threads and the calling thread. For receive streams, this runs the
+// NetEq decoding, expansion and time stretching of the streams in parallel
+// instead of one after the other on the mixing thread.
+//
+// The sources must allow GetAudioFrameWithInfo() to be called on any thread,
+// as long as the calls for one source are not concurrent.
+class ParallelSourcePuller {
+ public:
+  struct Job {
+    AudioMixer::Source* source = nullptr;
+    AudioFrame* frame = nullptr;
+    AudioMixer::Source::AudioFrameInfo info =
+        AudioMixer::Source::AudioFrameInfo::kError;
+  };
+
+  struct Stats {
+    int64_t num_ticks = 0;
+    // Ticks that took longer than the deadline.
+    int64_t num_late_ticks = 0;
+    int64_t total_tick_duration_us = 0;
+    int64_t max_tick_duration_us = 0;
+  };
+
+  // Uses |num_threads| worker threads besides the calling one. A tick is
+  // late if pulling takes longer than |deadline_ms|.
+  ParallelSourcePuller(int num_threads, int deadline_ms);
+  ~ParallelSourcePuller();
+
+  // Calls GetAudioFrameWithInfo() of the source of every job and stores the
+  // result in the job. Returns when all sources have been pulled.
+  void Pull(int sample_rate_hz, std::vector<Job>* jobs);
+
+  Stats GetStats() const;
+
+ private:
+  class Worker;
+
+  // Runs jobs of the current tick until there are none left to claim.
+  void RunJobs();
+
+  const int64_t deadline_us_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  rtc::CriticalSection crit_;
+  std::vector<Job>* jobs_ RTC_GUARDED_BY(crit_) = nullptr;
+  int sample_rate_hz_ RTC_GUARDED_BY(crit_) = 0;
+  size_t next_job_ RTC_GUARDED_BY(crit_) = 0;
+  size_t num_pending_jobs_ RTC_GUARDED_BY(crit_) = 0;
+  Stats stats_ RTC_GUARDED_BY(crit_);
+  // Late ticks since they were last logged.
+  int64_t late_ticks_since_log_ RTC_GUARDED_BY(crit_) = 0;
+  int64_t max_late_tick_duration_us_ RTC_GUARDED_BY(crit_) = 0;
+  // Set when the last pending job of a tick is done.
+  rtc::Event tick_done_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ParallelSourcePuller);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_MIXER_PARALLEL_SOURCE_PULLER_H_
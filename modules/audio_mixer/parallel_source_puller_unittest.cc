@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_mixer/parallel_source_puller.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "modules/audio_mixer/audio_mixer_impl.h"
+#include "modules/audio_mixer/default_output_rate_calculator.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/thread.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Fills the frame with its id, counts the calls and checks that they are not
+// concurrent.
+class FakeSource : public AudioMixer::Source {
+ public:
+  FakeSource(int id, AudioFrameInfo info) : id_(id), info_(info) {}
+
+  AudioFrameInfo GetAudioFrameWithInfo(int sample_rate_hz,
+                                       AudioFrame* audio_frame) override {
+    EXPECT_FALSE(busy_.exchange(true));
+    if (sleep_ms_ > 0)
+      rtc::Thread::SleepMs(sleep_ms_);
+    audio_frame->sample_rate_hz_ = sample_rate_hz;
+    audio_frame->samples_per_channel_ =
+        rtc::CheckedDivExact(sample_rate_hz, 100);
+    audio_frame->num_channels_ = 1;
+    audio_frame->vad_activity_ = AudioFrame::kVadActive;
+    int16_t* data = audio_frame->mutable_data();
+    for (size_t i = 0; i < audio_frame->samples_per_channel_; ++i)
+      data[i] = static_cast<int16_t>(100 * id_ + i % 7);
+    ++num_calls_;
+    busy_ = false;
+    return info_;
+  }
+
+  int Ssrc() const override { return id_; }
+  int PreferredSampleRate() const override { return 16000; }
+
+  int num_calls() const { return num_calls_; }
+  void set_sleep_ms(int sleep_ms) { sleep_ms_ = sleep_ms; }
+
+ private:
+  const int id_;
+  const AudioFrameInfo info_;
+  int sleep_ms_ = 0;
+  std::atomic<int> num_calls_{0};
+  std::atomic<bool> busy_{false};
+};
+
+std::vector<std::unique_ptr<FakeSource>> CreateSources(int num_sources) {
+  std::vector<std::unique_ptr<FakeSource>> sources;
+  for (int i = 0; i < num_sources; ++i) {
+    sources.emplace_back(new FakeSource(
+        i, i % 3 == 0 ? AudioMixer::Source::AudioFrameInfo::kMuted
+                      : AudioMixer::Source::AudioFrameInfo::kNormal));
+  }
+  return sources;
+}
+
+rtc::scoped_refptr<AudioMixerImpl> CreateMixer() {
+  return AudioMixerImpl::Create(
+      std::unique_ptr<OutputRateCalculator>(new DefaultOutputRateCalculator()),
+      false);
+}
+
+}  // namespace
+
+TEST(ParallelSourcePullerTest, PullsEverySourceOncePerTick) {
+  const int kNumSources = 50;
+  const int kNumTicks = 5;
+  auto sources = CreateSources(kNumSources);
+  std::vector<AudioFrame> frames(kNumSources);
+  ParallelSourcePuller puller(3, 1000);
+
+  std::vector<ParallelSourcePuller::Job> jobs(kNumSources);
+  for (int tick = 0; tick < kNumTicks; ++tick) {
+    for (int i = 0; i < kNumSources; ++i) {
+      jobs[i].source = sources[i].get();
+      jobs[i].frame = &frames[i];
+      jobs[i].info = AudioMixer::Source::AudioFrameInfo::kError;
+    }
+    puller.Pull(32000, &jobs);
+    for (int i = 0; i < kNumSources; ++i) {
+      EXPECT_EQ(tick + 1, sources[i]->num_calls());
+      EXPECT_EQ(i % 3 == 0 ? AudioMixer::Source::AudioFrameInfo::kMuted
+                           : AudioMixer::Source::AudioFrameInfo::kNormal,
+                jobs[i].info);
+      EXPECT_EQ(32000, frames[i].sample_rate_hz_);
+      EXPECT_EQ(100 * i, frames[i].data()[0]);
+    }
+  }
+  EXPECT_EQ(kNumTicks, puller.GetStats().num_ticks);
+}
+
+TEST(ParallelSourcePullerTest, PullsOnCallingThreadWithoutWorkers) {
+  auto sources = CreateSources(4);
+  std::vector<AudioFrame> frames(sources.size());
+  std::vector<ParallelSourcePuller::Job> jobs(sources.size());
+  for (size_t i = 0; i < sources.size(); ++i) {
+    jobs[i].source = sources[i].get();
+    jobs[i].frame = &frames[i];
+  }
+  ParallelSourcePuller puller(0, 1000);
+  puller.Pull(16000, &jobs);
+  for (const auto& source : sources)
+    EXPECT_EQ(1, source->num_calls());
+}
+
+TEST(ParallelSourcePullerTest, CountsLateTicks) {
+  auto sources = CreateSources(2);
+  std::vector<AudioFrame> frames(sources.size());
+  std::vector<ParallelSourcePuller::Job> jobs(sources.size());
+  for (size_t i = 0; i < sources.size(); ++i) {
+    jobs[i].source = sources[i].get();
+    jobs[i].frame = &frames[i];
+  }
+  ParallelSourcePuller puller(1, 5);
+  puller.Pull(16000, &jobs);
+  sources[1]->set_sleep_ms(20);
+  puller.Pull(16000, &jobs);
+
+  const ParallelSourcePuller::Stats stats = puller.GetStats();
+  EXPECT_EQ(2, stats.num_ticks);
+  EXPECT_EQ(1, stats.num_late_ticks);
+  EXPECT_GE(stats.max_tick_duration_us, 20000);
+  EXPECT_GE(stats.total_tick_duration_us, stats.max_tick_duration_us);
+}
+
+TEST(ParallelSourcePullerTest, MixerMixesTheSameAsWithSerialPulling) {
+  const int kNumSources = 20;
+  auto sources = CreateSources(kNumSources);
+  rtc::scoped_refptr<AudioMixerImpl> serial_mixer = CreateMixer();
+  rtc::scoped_refptr<AudioMixerImpl> parallel_mixer = CreateMixer();
+  parallel_mixer->SetSourcePuller(
+      std::unique_ptr<ParallelSourcePuller>(new ParallelSourcePuller(2, 10)));
+  for (const auto& source : sources) {
+    serial_mixer->AddSource(source.get());
+    parallel_mixer->AddSource(source.get());
+  }
+
+  for (int tick = 0; tick < 3; ++tick) {
+    AudioFrame serial_frame;
+    AudioFrame parallel_frame;
+    serial_mixer->Mix(1, &serial_frame);
+    parallel_mixer->Mix(1, &parallel_frame);
+    ASSERT_EQ(serial_frame.samples_per_channel_,
+              parallel_frame.samples_per_channel_);
+    for (size_t i = 0; i < serial_frame.samples_per_channel_; ++i)
+      EXPECT_EQ(serial_frame.data()[i], parallel_frame.data()[i]);
+    for (const auto& source : sources) {
+      EXPECT_EQ(
+          serial_mixer->GetAudioSourceMixabilityStatusForTest(source.get()),
+          parallel_mixer->GetAudioSourceMixabilityStatusForTest(source.get()));
+    }
+  }
+  for (const auto& source : sources) {
+    serial_mixer->RemoveSource(source.get());
+    parallel_mixer->RemoveSource(source.get());
+  }
+}
+
+}  // namespace webrtc
@@ -26,7 +26,9 @@
 #include "modules/audio_processing/aec3/shadow_filter_update_gain.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "modules/audio_processing/test/echo_canceller_test_tools.h"
+#include "modules/audio_processing/test/performance_timer.h"
 #include "rtc_base/arraysize.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_minmax.h"
 #include "rtc_base/random.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
@@ -265,6 +267,166 @@ TEST(AdaptiveFirFilter, UpdateErlSse2Optimization) {
 
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Verifies that the AVX2 methods for filter adaptation are similar to their
+// reference counterparts. FMA rounds differently, so the filters are
+// resynchronized after each step instead of being allowed to drift apart, and
+// the outputs are compared relative to their largest magnitude.
+TEST(AdaptiveFirFilter, FilterAdaptationAvx2Optimizations) {
+  bool use_avx2 =
+      (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0);
+  if (use_avx2) {
+    std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+        RenderDelayBuffer::Create(EchoCanceller3Config(), 3));
+    Random random_generator(42U);
+    std::vector<std::vector<float>> x(3, std::vector<float>(kBlockSize, 0.f));
+    FftData S_C;
+    FftData S_AVX2;
+    FftData G;
+    std::vector<FftData> H_C(10);
+    std::vector<FftData> H_AVX2(10);
+    for (auto& H_j : H_C) {
+      H_j.Clear();
+    }
+
+    auto max_abs = [](const std::array<float, kFftLengthBy2Plus1>& v) {
+      float m = 0.f;
+      for (float a : v) {
+        m = std::max(m, fabsf(a));
+      }
+      return m;
+    };
+
+    for (size_t k = 0; k < 500; ++k) {
+      RandomizeSampleVector(&random_generator, x[0]);
+      render_delay_buffer->Insert(x);
+      if (k == 0) {
+        render_delay_buffer->Reset();
+      }
+      render_delay_buffer->PrepareCaptureProcessing();
+      const auto& render_buffer = render_delay_buffer->GetRenderBuffer();
+      H_AVX2 = H_C;
+
+      ApplyFilter_AVX2(*render_buffer, H_AVX2, &S_AVX2);
+      ApplyFilter(*render_buffer, H_C, &S_C);
+      const float S_tolerance =
+          0.00001f * std::max(max_abs(S_C.re), max_abs(S_C.im));
+      for (size_t j = 0; j < S_C.re.size(); ++j) {
+        EXPECT_NEAR(S_C.re[j], S_AVX2.re[j], S_tolerance);
+        EXPECT_NEAR(S_C.im[j], S_AVX2.im[j], S_tolerance);
+      }
+
+      std::for_each(G.re.begin(), G.re.end(),
+                    [&](float& a) { a = random_generator.Rand<float>(); });
+      std::for_each(G.im.begin(), G.im.end(),
+                    [&](float& a) { a = random_generator.Rand<float>(); });
+
+      AdaptPartitions_AVX2(*render_buffer, G, H_AVX2);
+      AdaptPartitions(*render_buffer, G, H_C);
+
+      for (size_t l = 0; l < H_C.size(); ++l) {
+        const float H_tolerance =
+            0.00001f * std::max(max_abs(H_C[l].re), max_abs(H_C[l].im));
+        for (size_t j = 0; j < H_C[l].re.size(); ++j) {
+          EXPECT_NEAR(H_C[l].re[j], H_AVX2[l].re[j], H_tolerance);
+          EXPECT_NEAR(H_C[l].im[j], H_AVX2[l].im[j], H_tolerance);
+        }
+      }
+    }
+  }
+}
+
+// Verifies that the AVX2 methods for the frequency response and the echo
+// return loss are similar to their reference counterparts.
+TEST(AdaptiveFirFilter, UpdateFrequencyResponseAndErlAvx2Optimizations) {
+  bool use_avx2 =
+      (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0);
+  if (use_avx2) {
+    const size_t kNumPartitions = 12;
+    std::vector<FftData> H(kNumPartitions);
+    std::vector<std::array<float, kFftLengthBy2Plus1>> H2(kNumPartitions);
+    std::vector<std::array<float, kFftLengthBy2Plus1>> H2_AVX2(kNumPartitions);
+    std::array<float, kFftLengthBy2Plus1> erl;
+    std::array<float, kFftLengthBy2Plus1> erl_AVX2;
+
+    for (size_t j = 0; j < H.size(); ++j) {
+      for (size_t k = 0; k < H[j].re.size(); ++k) {
+        H[j].re[k] = k + j / 3.f;
+        H[j].im[k] = j + k / 7.f;
+      }
+    }
+
+    UpdateFrequencyResponse(H, &H2);
+    UpdateFrequencyResponse_AVX2(H, &H2_AVX2);
+    for (size_t j = 0; j < H2.size(); ++j) {
+      for (size_t k = 0; k < H[j].re.size(); ++k) {
+        EXPECT_NEAR(H2[j][k], H2_AVX2[j][k], H2[j][k] * 0.00001f);
+      }
+    }
+
+    UpdateErlEstimator(H2, &erl);
+    UpdateErlEstimator_AVX2(H2, &erl_AVX2);
+    for (size_t j = 0; j < erl.size(); ++j) {
+      EXPECT_FLOAT_EQ(erl[j], erl_AVX2[j]);
+    }
+  }
+}
+#endif
+
+// Measures the cost of filtering and adapting a filter of the default main
+// filter length for each available optimization. Keep disabled and only
+// enable locally to measure performance.
+TEST(AdaptiveFirFilter, DISABLED_FilterPerformance) {
+  std::vector<std::pair<const char*, Aec3Optimization>> optimizations = {
+      {"C", Aec3Optimization::kNone}};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    optimizations.push_back({"SSE2", Aec3Optimization::kSse2});
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    optimizations.push_back({"AVX2", Aec3Optimization::kAvx2});
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  optimizations.push_back({"NEON", Aec3Optimization::kNeon});
+#endif
+
+  const EchoCanceller3Config config;
+  const size_t num_partitions = config.filter.main.length_blocks;
+  constexpr size_t kNumBlocks = 2500;
+  for (const auto& optimization : optimizations) {
+    ApmDataDumper data_dumper(42);
+    AdaptiveFirFilter filter(num_partitions, num_partitions, 250,
+                             optimization.second, &data_dumper);
+    std::unique_ptr<RenderDelayBuffer> render_delay_buffer(
+        RenderDelayBuffer::Create(config, 3));
+    Random random_generator(42U);
+    std::vector<std::vector<float>> x(3, std::vector<float>(kBlockSize, 0.f));
+    FftData S;
+    FftData G;
+    ::webrtc::test::PerformanceTimer perf_timer(kNumBlocks);
+    for (size_t k = 0; k < kNumBlocks; ++k) {
+      RandomizeSampleVector(&random_generator, x[0]);
+      render_delay_buffer->Insert(x);
+      render_delay_buffer->PrepareCaptureProcessing();
+      std::for_each(G.re.begin(), G.re.end(),
+                    [&](float& a) { a = random_generator.Rand<float>(); });
+      std::for_each(G.im.begin(), G.im.end(),
+                    [&](float& a) { a = random_generator.Rand<float>(); });
+      const auto& render_buffer = *render_delay_buffer->GetRenderBuffer();
+
+      perf_timer.StartTimer();
+      filter.Filter(render_buffer, &S);
+      filter.Adapt(render_buffer, G);
+      perf_timer.StopTimer();
+    }
+    // There are 2.5 blocks of 4 ms in each 10 ms frame.
+    RTC_LOG(LS_INFO) << optimization.first << ": "
+                     << 2.5 * perf_timer.GetDurationAverage(100)
+                     << " us per 10 ms frame";
+  }
+}
+
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
 // Verifies that the check for non-null data dumper works.
 TEST(AdaptiveFirFilter, NullDataDumper) {
@@ -25,11 +25,11 @@ class BlockProcessor {
  public:
   static BlockProcessor* Create(const EchoCanceller3Config& config,
                                 int sample_rate_hz);
-  // Only used for testing purposes.
   static BlockProcessor* Create(
       const EchoCanceller3Config& config,
       int sample_rate_hz,
       std::unique_ptr<RenderDelayBuffer> render_buffer);
+  // Only used for testing purposes.
   static BlockProcessor* Create(
       const EchoCanceller3Config& config,
       int sample_rate_hz,
@@ -269,6 +269,22 @@ EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
           use_highpass_filter,
           std::unique_ptr<BlockProcessor>(
               BlockProcessor::Create(AdjustConfig(config), sample_rate_hz))) {}
+EchoCanceller3::EchoCanceller3(
+    const EchoCanceller3Config& config,
+    int sample_rate_hz,
+    bool use_highpass_filter,
+    rtc::scoped_refptr<SharedRenderAnalyzer> render_analyzer)
+    : EchoCanceller3(AdjustConfig(config),
+                     sample_rate_hz,
+                     use_highpass_filter,
+                     std::unique_ptr<BlockProcessor>(BlockProcessor::Create(
+                         AdjustConfig(config),
+                         sample_rate_hz,
+                         std::unique_ptr<RenderDelayBuffer>(
+                             RenderDelayBuffer::Create(
+                                 AdjustConfig(config),
+                                 NumBandsForRate(sample_rate_hz),
+                                 std::move(render_analyzer)))))) {}
 EchoCanceller3::EchoCanceller3(const EchoCanceller3Config& config,
                                int sample_rate_hz,
                                bool use_highpass_filter,
@@ -16,6 +16,7 @@
 #include "modules/audio_processing/aec3/block_processor.h"
 #include "modules/audio_processing/aec3/cascaded_biquad_filter.h"
 #include "modules/audio_processing/aec3/frame_blocker.h"
+#include "modules/audio_processing/aec3/shared_render_analyzer.h"
 #include "modules/audio_processing/audio_buffer.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "rtc_base/constructormagic.h"
@@ -66,6 +67,13 @@ class EchoCanceller3 : public EchoControl {
   EchoCanceller3(const EchoCanceller3Config& config,
                  int sample_rate_hz,
                  bool use_highpass_filter);
+  // C-tor for echo cancellers whose render signals are identical, e.g., for
+  // several microphones sharing one loudspeaker, which take the render
+  // analysis from the shared |render_analyzer|.
+  EchoCanceller3(const EchoCanceller3Config& config,
+                 int sample_rate_hz,
+                 bool use_highpass_filter,
+                 rtc::scoped_refptr<SharedRenderAnalyzer> render_analyzer);
   // Testing c-tor that is used only for testing purposes.
   EchoCanceller3(const EchoCanceller3Config& config,
                  int sample_rate_hz,
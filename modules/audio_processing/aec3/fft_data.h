@@ -44,6 +44,9 @@ struct FftData {
     RTC_DCHECK_EQ(kFftLengthBy2Plus1, power_spectrum.size());
     switch (optimization) {
 #if defined(WEBRTC_ARCH_X86_FAMILY)
+      case Aec3Optimization::kAvx2:
+        SpectrumAVX2(power_spectrum);
+        break;
       case Aec3Optimization::kSse2: {
         constexpr int kNumFourBinBands = kFftLengthBy2 / 4;
         constexpr int kLimit = kNumFourBinBands * 4;
@@ -65,6 +68,9 @@ struct FftData {
     }
   }
 
+  // Computes the power spectrum of the data, using AVX2 and FMA.
+  void SpectrumAVX2(rtc::ArrayView<float> power_spectrum) const;
+
   // Copy the data from an interleaved array.
   void CopyFromPackedArray(const std::array<float, kFftLength>& v) {
     re[0] = v[0];
@@ -39,6 +39,28 @@ TEST(FftData, TestOptimizations) {
     EXPECT_EQ(spectrum, spectrum_sse2);
   }
 }
+
+// Verifies that the AVX2 method is similar to its reference counterpart.
+TEST(FftData, TestAvx2Optimizations) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    FftData x;
+    for (size_t k = 0; k < x.re.size(); ++k) {
+      x.re[k] = (k + 1) / 3.f;
+    }
+    x.im[0] = x.im[x.im.size() - 1] = 0.f;
+    for (size_t k = 1; k < x.im.size() - 1; ++k) {
+      x.im[k] = 2.f * (k + 1) / 7.f;
+    }
+
+    std::array<float, kFftLengthBy2Plus1> spectrum;
+    std::array<float, kFftLengthBy2Plus1> spectrum_avx2;
+    x.Spectrum(Aec3Optimization::kNone, spectrum);
+    x.Spectrum(Aec3Optimization::kAvx2, spectrum_avx2);
+    for (size_t k = 0; k < spectrum.size(); ++k) {
+      EXPECT_NEAR(spectrum[k], spectrum_avx2[k], spectrum[k] * 0.00001f);
+    }
+  }
+}
 #endif
 
 #if RTC_DCHECK_IS_ON && GTEST_HAS_DEATH_TEST && !defined(WEBRTC_ANDROID)
@@ -23,6 +23,8 @@
 #include "modules/audio_processing/aec3/render_delay_buffer.h"
 #include "modules/audio_processing/logging/apm_data_dumper.h"
 #include "modules/audio_processing/test/echo_canceller_test_tools.h"
+#include "modules/audio_processing/test/performance_timer.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/random.h"
 #include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
@@ -130,6 +132,106 @@ TEST(MatchedFilter, TestSse2Optimizations) {
 
 #endif
 
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Verifies that the optimized methods for AVX2 are similar to their reference
+// counterparts.
+TEST(MatchedFilter, TestAvx2Optimizations) {
+  bool use_avx2 =
+      (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0);
+  if (use_avx2) {
+    Random random_generator(42U);
+    for (auto down_sampling_factor : kDownSamplingFactors) {
+      const size_t sub_block_size = kBlockSize / down_sampling_factor;
+      std::vector<float> x(2000);
+      RandomizeSampleVector(&random_generator, x);
+      std::vector<float> y(sub_block_size);
+      std::vector<float> h_AVX2(512);
+      std::vector<float> h(512);
+      int x_index = 0;
+      for (int k = 0; k < 1000; ++k) {
+        RandomizeSampleVector(&random_generator, y);
+
+        bool filters_updated = false;
+        float error_sum = 0.f;
+        bool filters_updated_AVX2 = false;
+        float error_sum_AVX2 = 0.f;
+
+        MatchedFilterCore_AVX2(x_index, h.size() * 150.f * 150.f, x, y, h_AVX2,
+                               &filters_updated_AVX2, &error_sum_AVX2);
+
+        MatchedFilterCore(x_index, h.size() * 150.f * 150.f, x, y, h,
+                          &filters_updated, &error_sum);
+
+        EXPECT_EQ(filters_updated, filters_updated_AVX2);
+        EXPECT_NEAR(error_sum, error_sum_AVX2, error_sum / 100000.f);
+
+        for (size_t j = 0; j < h.size(); ++j) {
+          EXPECT_NEAR(h[j], h_AVX2[j], 0.00001f);
+        }
+
+        x_index = (x_index + sub_block_size) % x.size();
+      }
+    }
+  }
+}
+
+#endif
+
+// Measures the cost of the matched filter core with the default delay
+// estimator settings for each available optimization. Keep disabled and only
+// enable locally to measure performance.
+TEST(MatchedFilter, DISABLED_MatchedFilterCorePerformance) {
+  using CoreFunction =
+      void (*)(size_t, float, rtc::ArrayView<const float>,
+               rtc::ArrayView<const float>, rtc::ArrayView<float>, bool*,
+               float*);
+  std::vector<std::pair<const char*, CoreFunction>> cores = {
+      {"C", &MatchedFilterCore}};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    cores.push_back({"SSE2", &MatchedFilterCore_SSE2});
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    cores.push_back({"AVX2", &MatchedFilterCore_AVX2});
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  cores.push_back({"NEON", &MatchedFilterCore_NEON});
+#endif
+
+  const EchoCanceller3Config config;
+  const size_t sub_block_size = kBlockSize / config.delay.down_sampling_factor;
+  constexpr int kNumBlocks = 2500;
+  for (const auto& core : cores) {
+    Random random_generator(42U);
+    std::vector<float> x(2000);
+    RandomizeSampleVector(&random_generator, x);
+    std::vector<float> y(sub_block_size);
+    std::vector<std::vector<float>> h(
+        config.delay.num_filters,
+        std::vector<float>(kMatchedFilterWindowSizeSubBlocks * sub_block_size,
+                           0.f));
+    ::webrtc::test::PerformanceTimer perf_timer(kNumBlocks);
+    size_t x_index = 0;
+    for (int k = 0; k < kNumBlocks; ++k) {
+      RandomizeSampleVector(&random_generator, y);
+      perf_timer.StartTimer();
+      for (auto& h_n : h) {
+        bool filters_updated = false;
+        float error_sum = 0.f;
+        core.second(x_index, h_n.size() * 150.f * 150.f, x, y, h_n,
+                    &filters_updated, &error_sum);
+      }
+      perf_timer.StopTimer();
+      x_index = (x_index + sub_block_size) % x.size();
+    }
+    // There are 2.5 blocks of 4 ms in each 10 ms frame.
+    RTC_LOG(LS_INFO) << core.first << ": "
+                     << 2.5 * perf_timer.GetDurationAverage(100)
+                     << " us per 10 ms frame";
+  }
+}
+
 // Verifies that the matched filter produces proper lag estimates for
 // artificially
 // delayed signals.
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <algorithm>
 #include <numeric>
+#include <utility>
 
 #include "modules/audio_processing/aec3/aec3_common.h"
 #include "modules/audio_processing/aec3/aec3_fft.h"
@@ -21,6 +22,7 @@
 #include "modules/audio_processing/aec3/fft_buffer.h"
 #include "modules/audio_processing/aec3/fft_data.h"
 #include "modules/audio_processing/aec3/matrix_buffer.h"
+#include "modules/audio_processing/aec3/shared_render_analyzer.h"
 #include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
@@ -45,7 +47,10 @@ size_t GetDownSamplingFactor(const EchoCanceller3Config& config) {
 
 class RenderDelayBufferImpl final : public RenderDelayBuffer {
  public:
-  RenderDelayBufferImpl(const EchoCanceller3Config& config, size_t num_bands);
+  RenderDelayBufferImpl(
+      const EchoCanceller3Config& config,
+      size_t num_bands,
+      rtc::scoped_refptr<SharedRenderAnalyzer> shared_analyzer);
   ~RenderDelayBufferImpl() override;
 
   void Reset() override;
@@ -85,6 +90,8 @@ class RenderDelayBufferImpl final : public RenderDelayBuffer {
   const std::vector<std::vector<float>> zero_block_;
   const Aec3Fft fft_;
   std::vector<float> render_ds_;
+  rtc::scoped_refptr<SharedRenderAnalyzer> shared_analyzer_;
+  size_t shared_analyzer_sequence_ = 0;
   const int buffer_headroom_;
   bool last_call_was_render_ = false;
   int num_api_calls_in_a_row_ = 0;
@@ -171,8 +178,10 @@ bool ApiCallSkew(const DownsampledRenderBuffer& low_rate_buffer,
 
 int RenderDelayBufferImpl::instance_count_ = 0;
 
-RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
-                                             size_t num_bands)
+RenderDelayBufferImpl::RenderDelayBufferImpl(
+    const EchoCanceller3Config& config,
+    size_t num_bands,
+    rtc::scoped_refptr<SharedRenderAnalyzer> shared_analyzer)
     : data_dumper_(
           new ApmDataDumper(rtc::AtomicOps::Increment(&instance_count_))),
       optimization_(DetectOptimization()),
@@ -197,10 +206,18 @@ RenderDelayBufferImpl::RenderDelayBufferImpl(const EchoCanceller3Config& config,
       zero_block_(num_bands, std::vector<float>(kBlockSize, 0.f)),
       fft_(),
       render_ds_(sub_block_size_, 0.f),
+      shared_analyzer_(std::move(shared_analyzer)),
       buffer_headroom_(config.filter.main.length_blocks) {
   RTC_DCHECK_EQ(blocks_.buffer.size(), ffts_.buffer.size());
   RTC_DCHECK_EQ(spectra_.buffer.size(), ffts_.buffer.size());
 
+  if (shared_analyzer_ &&
+      shared_analyzer_->down_sampling_factor() != down_sampling_factor_) {
+    RTC_LOG(LS_WARNING) << "Not using the shared render analyzer due to a "
+                           "down sampling factor mismatch.";
+    shared_analyzer_ = nullptr;
+  }
+
   // Necessary condition to avoid unrecoverable echp due to noncausal alignment.
   RTC_DCHECK_EQ(DelayEstimatorOffset(config_), LowRateBufferOffset() * 2);
   Reset();
@@ -440,12 +457,18 @@ void RenderDelayBufferImpl::InsertBlock(
 
   data_dumper_->DumpWav("aec3_render_decimator_input", block[0].size(),
                         block[0].data(), 16000, 1);
-  render_decimator_.Decimate(block[0], ds);
+  if (shared_analyzer_) {
+    shared_analyzer_->Analyze(block[0], b.buffer[previous_write][0],
+                              &shared_analyzer_sequence_, ds,
+                              &f.buffer[f.write], s.buffer[s.write]);
+  } else {
+    render_decimator_.Decimate(block[0], ds);
+    fft_.PaddedFft(block[0], b.buffer[previous_write][0], &f.buffer[f.write]);
+    f.buffer[f.write].Spectrum(optimization_, s.buffer[s.write]);
+  }
   data_dumper_->DumpWav("aec3_render_decimator_output", ds.size(), ds.data(),
                         16000 / down_sampling_factor_, 1);
   std::copy(ds.rbegin(), ds.rend(), lr.buffer.begin() + lr.write);
-  fft_.PaddedFft(block[0], b.buffer[previous_write][0], &f.buffer[f.write]);
-  f.buffer[f.write].Spectrum(optimization_, s.buffer[s.write]);
 }
 
 bool RenderDelayBufferImpl::DetectActiveRender(
@@ -465,7 +488,15 @@ int RenderDelayBuffer::RenderDelayBuffer::DelayEstimatorOffset(
 
 RenderDelayBuffer* RenderDelayBuffer::Create(const EchoCanceller3Config& config,
                                              size_t num_bands) {
-  return new RenderDelayBufferImpl(config, num_bands);
+  return new RenderDelayBufferImpl(config, num_bands, nullptr);
+}
+
+RenderDelayBuffer* RenderDelayBuffer::Create(
+    const EchoCanceller3Config& config,
+    size_t num_bands,
+    rtc::scoped_refptr<SharedRenderAnalyzer> shared_analyzer) {
+  return new RenderDelayBufferImpl(config, num_bands,
+                                   std::move(shared_analyzer));
 }
 
 }  // namespace webrtc
@@ -22,6 +22,8 @@
 #include "modules/audio_processing/aec3/downsampled_render_buffer.h"
 #include "modules/audio_processing/aec3/fft_data.h"
 #include "modules/audio_processing/aec3/render_buffer.h"
+#include "modules/audio_processing/aec3/shared_render_analyzer.h"
+#include "rtc_base/scoped_ref_ptr.h"
 
 namespace webrtc {
 
@@ -39,6 +41,12 @@ class RenderDelayBuffer {
 
   static RenderDelayBuffer* Create(const EchoCanceller3Config& config,
                                    size_t num_bands);
+  // Creates a buffer that takes the render analysis from |shared_analyzer|,
+  // which may be shared with other buffers receiving the same render signal.
+  static RenderDelayBuffer* Create(
+      const EchoCanceller3Config& config,
+      size_t num_bands,
+      rtc::scoped_refptr<SharedRenderAnalyzer> shared_analyzer);
   virtual ~RenderDelayBuffer() = default;
 
   // Resets the buffer alignment.
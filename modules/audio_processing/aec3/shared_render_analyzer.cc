@@ -0,0 +1,121 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/shared_render_analyzer.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+constexpr size_t SharedRenderAnalyzer::kNumAnalyses;
+
+SharedRenderAnalyzer::Analysis::Analysis(size_t downsampled_block_size)
+    : downsampled_block(downsampled_block_size, 0.f) {
+  block.fill(0.f);
+  previous_block.fill(0.f);
+  spectrum.fill(0.f);
+}
+
+rtc::scoped_refptr<SharedRenderAnalyzer> SharedRenderAnalyzer::Create(
+    size_t down_sampling_factor) {
+  return new rtc::RefCountedObject<SharedRenderAnalyzer>(down_sampling_factor);
+}
+
+SharedRenderAnalyzer::SharedRenderAnalyzer(size_t down_sampling_factor)
+    : optimization_(DetectOptimization()),
+      down_sampling_factor_(down_sampling_factor),
+      decimator_(down_sampling_factor),
+      analyses_(kNumAnalyses, Analysis(kBlockSize / down_sampling_factor)) {
+  RTC_DCHECK_LT(0, down_sampling_factor_);
+}
+
+SharedRenderAnalyzer::~SharedRenderAnalyzer() = default;
+
+void SharedRenderAnalyzer::Analyze(rtc::ArrayView<const float> block,
+                                   rtc::ArrayView<const float> previous_block,
+                                   size_t* sequence,
+                                   rtc::ArrayView<float> downsampled_block,
+                                   FftData* fft,
+                                   rtc::ArrayView<float> spectrum) {
+  RTC_DCHECK_EQ(kBlockSize, block.size());
+  RTC_DCHECK_EQ(kBlockSize, previous_block.size());
+  RTC_DCHECK_EQ(kBlockSize / down_sampling_factor_, downsampled_block.size());
+  RTC_DCHECK_EQ(kFftLengthBy2Plus1, spectrum.size());
+  RTC_DCHECK(sequence);
+  RTC_DCHECK(fft);
+
+  rtc::CritScope cs(&crit_);
+  const Analysis* analysis = Find(*sequence, block, previous_block);
+
+  // A caller that is not at the newest analysis and does not match the one it
+  // expects has lost track of the render stream, and may find its block among
+  // the kept analyses.
+  if (!analysis && *sequence != num_analyzed_blocks_) {
+    const size_t num_kept = std::min(num_analyzed_blocks_, kNumAnalyses);
+    for (size_t k = 1; !analysis && k <= num_kept; ++k) {
+      analysis = Find(num_analyzed_blocks_ - k, block, previous_block);
+    }
+  }
+
+  if (!analysis) {
+    analysis = Compute(block, previous_block);
+  }
+
+  *sequence = analysis->sequence + 1;
+  std::copy(analysis->downsampled_block.begin(),
+            analysis->downsampled_block.end(), downsampled_block.begin());
+  fft->Assign(analysis->fft);
+  std::copy(analysis->spectrum.begin(), analysis->spectrum.end(),
+            spectrum.begin());
+}
+
+size_t SharedRenderAnalyzer::NumAnalyzedBlocks() const {
+  rtc::CritScope cs(&crit_);
+  return num_analyzed_blocks_;
+}
+
+const SharedRenderAnalyzer::Analysis* SharedRenderAnalyzer::Find(
+    size_t sequence,
+    rtc::ArrayView<const float> block,
+    rtc::ArrayView<const float> previous_block) const {
+  if (sequence >= num_analyzed_blocks_ ||
+      sequence + kNumAnalyses < num_analyzed_blocks_) {
+    return nullptr;
+  }
+
+  const Analysis& analysis = analyses_[sequence % kNumAnalyses];
+  RTC_DCHECK_EQ(sequence, analysis.sequence);
+  if (!std::equal(block.begin(), block.end(), analysis.block.begin()) ||
+      !std::equal(previous_block.begin(), previous_block.end(),
+                  analysis.previous_block.begin())) {
+    return nullptr;
+  }
+  return &analysis;
+}
+
+const SharedRenderAnalyzer::Analysis* SharedRenderAnalyzer::Compute(
+    rtc::ArrayView<const float> block,
+    rtc::ArrayView<const float> previous_block) {
+  Analysis& analysis = analyses_[num_analyzed_blocks_ % kNumAnalyses];
+  analysis.sequence = num_analyzed_blocks_++;
+  std::copy(block.begin(), block.end(), analysis.block.begin());
+  std::copy(previous_block.begin(), previous_block.end(),
+            analysis.previous_block.begin());
+
+  decimator_.Decimate(block, analysis.downsampled_block);
+  fft_.PaddedFft(block, previous_block, &analysis.fft);
+  analysis.fft.Spectrum(optimization_, analysis.spectrum);
+  return &analysis;
+}
+
+}  // namespace webrtc
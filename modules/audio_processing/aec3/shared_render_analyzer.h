@@ -0,0 +1,99 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_ANALYZER_H_
+#define MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_ANALYZER_H_
+
+#include <stddef.h>
+#include <array>
+#include <vector>
+
+#include "api/array_view.h"
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/aec3_fft.h"
+#include "modules/audio_processing/aec3/decimator.h"
+#include "modules/audio_processing/aec3/fft_data.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Computes the per-block render analysis (decimation for the delay estimator,
+// FFT and power spectrum of the lowest band) once for several render delay
+// buffers that are fed with the same render signal, e.g., the echo cancellers
+// of several microphones sharing one loudspeaker. The most recent analyses are
+// kept, and a buffer reuses one of them only when both its current and its
+// previous block are identical to those the analysis was computed from. Any
+// mismatch therefore yields a freshly computed FFT, but as the decimator state
+// is shared, the analyzer must only be shared by buffers with the same signal.
+class SharedRenderAnalyzer : public rtc::RefCountInterface {
+ public:
+  // Number of analyses kept, which bounds how far the buffers sharing the
+  // analyzer may lag each other and still reuse the analyses.
+  static constexpr size_t kNumAnalyses = 32;
+
+  static rtc::scoped_refptr<SharedRenderAnalyzer> Create(
+      size_t down_sampling_factor);
+
+  // Produces the analysis of the lowest band |block| preceded by
+  // |previous_block|. |sequence| is the position of the caller in the render
+  // stream, initialized to zero by the caller and updated by the method.
+  void Analyze(rtc::ArrayView<const float> block,
+               rtc::ArrayView<const float> previous_block,
+               size_t* sequence,
+               rtc::ArrayView<float> downsampled_block,
+               FftData* fft,
+               rtc::ArrayView<float> spectrum);
+
+  size_t down_sampling_factor() const { return down_sampling_factor_; }
+
+  // Returns the number of blocks that have been analyzed.
+  size_t NumAnalyzedBlocks() const;
+
+ protected:
+  explicit SharedRenderAnalyzer(size_t down_sampling_factor);
+  ~SharedRenderAnalyzer() override;
+
+ private:
+  struct Analysis {
+    explicit Analysis(size_t downsampled_block_size);
+
+    size_t sequence = 0;
+    std::array<float, kBlockSize> block;
+    std::array<float, kBlockSize> previous_block;
+    std::vector<float> downsampled_block;
+    FftData fft;
+    std::array<float, kFftLengthBy2Plus1> spectrum;
+  };
+
+  const Analysis* Find(size_t sequence,
+                       rtc::ArrayView<const float> block,
+                       rtc::ArrayView<const float> previous_block) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  const Analysis* Compute(rtc::ArrayView<const float> block,
+                          rtc::ArrayView<const float> previous_block)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const Aec3Optimization optimization_;
+  const size_t down_sampling_factor_;
+  const Aec3Fft fft_;
+  rtc::CriticalSection crit_;
+  Decimator decimator_ RTC_GUARDED_BY(crit_);
+  std::vector<Analysis> analyses_ RTC_GUARDED_BY(crit_);
+  size_t num_analyzed_blocks_ RTC_GUARDED_BY(crit_) = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedRenderAnalyzer);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_AEC3_SHARED_RENDER_ANALYZER_H_
@@ -0,0 +1,164 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/aec3/shared_render_analyzer.h"
+
+#include <memory>
+#include <vector>
+
+#include "modules/audio_processing/aec3/aec3_common.h"
+#include "modules/audio_processing/aec3/render_delay_buffer.h"
+#include "modules/audio_processing/test/echo_canceller_test_tools.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+// Verifies that the two buffers hold identical render analyses.
+void VerifyBuffersEqual(RenderDelayBuffer* a, RenderDelayBuffer* b) {
+  rtc::ArrayView<const FftData> ffts_a = a->GetRenderBuffer()->GetFftBuffer();
+  rtc::ArrayView<const FftData> ffts_b = b->GetRenderBuffer()->GetFftBuffer();
+  ASSERT_EQ(ffts_a.size(), ffts_b.size());
+  for (size_t k = 0; k < ffts_a.size(); ++k) {
+    EXPECT_EQ(ffts_a[k].re, ffts_b[k].re);
+    EXPECT_EQ(ffts_a[k].im, ffts_b[k].im);
+  }
+  EXPECT_EQ(a->GetRenderBuffer()->GetSpectrumBuffer().buffer,
+            b->GetRenderBuffer()->GetSpectrumBuffer().buffer);
+  EXPECT_EQ(a->GetDownsampledRenderBuffer().buffer,
+            b->GetDownsampledRenderBuffer().buffer);
+}
+
+}  // namespace
+
+// Verifies that buffers sharing the analyzer produce the same render analysis
+// as an unshared buffer while the analysis is only computed once per block.
+TEST(SharedRenderAnalyzer, SharedAnalysisIsIdenticalToUnshared) {
+  const EchoCanceller3Config config;
+  Random random_generator(42U);
+  rtc::scoped_refptr<SharedRenderAnalyzer> analyzer =
+      SharedRenderAnalyzer::Create(config.delay.down_sampling_factor);
+  std::unique_ptr<RenderDelayBuffer> reference(
+      RenderDelayBuffer::Create(config, 1));
+  std::unique_ptr<RenderDelayBuffer> shared_a(
+      RenderDelayBuffer::Create(config, 1, analyzer));
+  std::unique_ptr<RenderDelayBuffer> shared_b(
+      RenderDelayBuffer::Create(config, 1, analyzer));
+  std::vector<std::vector<float>> block(1, std::vector<float>(kBlockSize));
+
+  constexpr size_t kNumBlocks = 200;
+  for (size_t k = 0; k < kNumBlocks; ++k) {
+    RandomizeSampleVector(&random_generator, block[0]);
+    for (auto* buffer : {reference.get(), shared_a.get(), shared_b.get()}) {
+      buffer->Insert(block);
+      buffer->PrepareCaptureProcessing();
+    }
+    VerifyBuffersEqual(reference.get(), shared_a.get());
+    VerifyBuffersEqual(reference.get(), shared_b.get());
+  }
+  EXPECT_EQ(kNumBlocks, analyzer->NumAnalyzedBlocks());
+}
+
+// Verifies that the analysis is reused by a buffer lagging behind the other
+// buffers sharing the analyzer.
+TEST(SharedRenderAnalyzer, LaggingBufferReusesAnalysis) {
+  const EchoCanceller3Config config;
+  Random random_generator(42U);
+  rtc::scoped_refptr<SharedRenderAnalyzer> analyzer =
+      SharedRenderAnalyzer::Create(config.delay.down_sampling_factor);
+  std::unique_ptr<RenderDelayBuffer> reference(
+      RenderDelayBuffer::Create(config, 1));
+  std::unique_ptr<RenderDelayBuffer> leading(
+      RenderDelayBuffer::Create(config, 1, analyzer));
+  std::unique_ptr<RenderDelayBuffer> lagging(
+      RenderDelayBuffer::Create(config, 1, analyzer));
+
+  constexpr size_t kLagBlocks = 3;
+  constexpr size_t kNumBlocks = 100;
+  std::vector<std::vector<std::vector<float>>> blocks(
+      kNumBlocks,
+      std::vector<std::vector<float>>(1, std::vector<float>(kBlockSize)));
+  for (auto& block : blocks) {
+    RandomizeSampleVector(&random_generator, block[0]);
+  }
+
+  // The buffers are fed in chunks of three blocks, with the lagging buffer one
+  // chunk behind the leading buffer.
+  for (size_t k = 0; k < kNumBlocks + kLagBlocks; k += kLagBlocks) {
+    for (size_t j = k; j < std::min(k + kLagBlocks, kNumBlocks); ++j) {
+      reference->Insert(blocks[j]);
+      leading->Insert(blocks[j]);
+    }
+    for (size_t j = k; j < std::min(k + kLagBlocks, kNumBlocks); ++j) {
+      reference->PrepareCaptureProcessing();
+      leading->PrepareCaptureProcessing();
+    }
+    if (k >= kLagBlocks) {
+      for (size_t j = k - kLagBlocks; j < k && j < kNumBlocks; ++j) {
+        lagging->Insert(blocks[j]);
+      }
+      for (size_t j = k - kLagBlocks; j < k && j < kNumBlocks; ++j) {
+        lagging->PrepareCaptureProcessing();
+      }
+    }
+  }
+
+  VerifyBuffersEqual(reference.get(), leading.get());
+  VerifyBuffersEqual(reference.get(), lagging.get());
+  EXPECT_EQ(kNumBlocks, analyzer->NumAnalyzedBlocks());
+}
+
+// Verifies that buffers fed with different render signals get the analyses of
+// their own signals.
+TEST(SharedRenderAnalyzer, DifferentSignalsAreAnalyzedSeparately) {
+  const EchoCanceller3Config config;
+  Random random_generator(42U);
+  rtc::scoped_refptr<SharedRenderAnalyzer> analyzer =
+      SharedRenderAnalyzer::Create(config.delay.down_sampling_factor);
+  std::unique_ptr<RenderDelayBuffer> reference_a(
+      RenderDelayBuffer::Create(config, 1));
+  std::unique_ptr<RenderDelayBuffer> reference_b(
+      RenderDelayBuffer::Create(config, 1));
+  std::unique_ptr<RenderDelayBuffer> shared_a(
+      RenderDelayBuffer::Create(config, 1, analyzer));
+  std::unique_ptr<RenderDelayBuffer> shared_b(
+      RenderDelayBuffer::Create(config, 1, analyzer));
+  std::vector<std::vector<float>> block_a(1, std::vector<float>(kBlockSize));
+  std::vector<std::vector<float>> block_b(1, std::vector<float>(kBlockSize));
+
+  constexpr size_t kNumBlocks = 50;
+  for (size_t k = 0; k < kNumBlocks; ++k) {
+    RandomizeSampleVector(&random_generator, block_a[0]);
+    RandomizeSampleVector(&random_generator, block_b[0]);
+    reference_a->Insert(block_a);
+    shared_a->Insert(block_a);
+    reference_b->Insert(block_b);
+    shared_b->Insert(block_b);
+    for (auto* buffer : {reference_a.get(), reference_b.get(), shared_a.get(),
+                         shared_b.get()}) {
+      buffer->PrepareCaptureProcessing();
+    }
+  }
+
+  // The decimator state is shared, so only the FFTs and spectra are exact.
+  rtc::ArrayView<const FftData> ffts_a =
+      shared_a->GetRenderBuffer()->GetFftBuffer();
+  rtc::ArrayView<const FftData> reference_ffts_a =
+      reference_a->GetRenderBuffer()->GetFftBuffer();
+  for (size_t k = 0; k < ffts_a.size(); ++k) {
+    EXPECT_EQ(reference_ffts_a[k].re, ffts_a[k].re);
+  }
+  EXPECT_EQ(reference_b->GetRenderBuffer()->GetSpectrumBuffer().buffer,
+            shared_b->GetRenderBuffer()->GetSpectrumBuffer().buffer);
+  EXPECT_EQ(2 * kNumBlocks, analyzer->NumAnalyzedBlocks());
+}
+
+}  // namespace webrtc
@@ -141,6 +141,35 @@ TEST(VectorMath, Accumulate) {
     }
   }
 }
+
+TEST(VectorMath, Avx2Optimizations) {
+  if (WebRtc_GetCPUInfo(kAVX2) != 0 && WebRtc_GetCPUInfo(kFMA3) != 0) {
+    std::array<float, kFftLengthBy2Plus1> x;
+    std::array<float, kFftLengthBy2Plus1> y;
+    std::array<float, kFftLengthBy2Plus1> z;
+    std::array<float, kFftLengthBy2Plus1> z_avx2;
+    for (size_t k = 0; k < x.size(); ++k) {
+      x[k] = k;
+      y[k] = (2.f / 3.f) * k;
+    }
+    aec3::VectorMath math(Aec3Optimization::kNone);
+    aec3::VectorMath math_avx2(Aec3Optimization::kAvx2);
+
+    std::copy(y.begin(), y.end(), z.begin());
+    math.Sqrt(z);
+    std::copy(y.begin(), y.end(), z_avx2.begin());
+    math_avx2.Sqrt(z_avx2);
+    EXPECT_EQ(z, z_avx2);
+
+    math.Multiply(x, y, z);
+    math_avx2.Multiply(x, y, z_avx2);
+    EXPECT_EQ(z, z_avx2);
+
+    math.Accumulate(x, z);
+    math_avx2.Accumulate(x, z_avx2);
+    EXPECT_EQ(z, z_avx2);
+  }
+}
 #endif
 
 }  // namespace webrtc
@@ -13,8 +13,17 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <vector>
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
 
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "third_party/rnnoise/src/rnn_activations.h"
 #include "third_party/rnnoise/src/rnn_vad_weights.h"
 
@@ -48,17 +57,151 @@ using rnnoise::RectifiedLinearUnit;
 using rnnoise::SigmoidApproximated;
 using rnnoise::TansigApproximated;
 
+namespace {
+
+std::vector<float> ConvertWeights(rtc::ArrayView<const int8_t> weights) {
+  return std::vector<float>(weights.begin(), weights.end());
+}
+
+// Adds the contribution of |x| to |y| using the kernel for |optimization|.
+void Accumulate(Optimization optimization,
+                rtc::ArrayView<const float> x,
+                rtc::ArrayView<const float> gates,
+                const float* weights,
+                size_t stride,
+                rtc::ArrayView<float> y) {
+  switch (optimization) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    case Optimization::kSse2:
+      AccumulateMatrixVectorProduct_SSE2(x, gates, weights, stride, y);
+      break;
+    case Optimization::kAvx2:
+      AccumulateMatrixVectorProduct_AVX2(x, gates, weights, stride, y);
+      break;
+#endif
+#if defined(WEBRTC_HAS_NEON)
+    case Optimization::kNeon:
+      AccumulateMatrixVectorProduct_NEON(x, gates, weights, stride, y);
+      break;
+#endif
+    default:
+      AccumulateMatrixVectorProduct(x, gates, weights, stride, y);
+  }
+}
+
+}  // namespace
+
+Optimization DetectOptimization() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    return Optimization::kAvx2;
+  }
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    return Optimization::kSse2;
+  }
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+  return Optimization::kNeon;
+#endif
+
+  return Optimization::kNone;
+}
+
+void AccumulateMatrixVectorProduct(rtc::ArrayView<const float> x,
+                                   rtc::ArrayView<const float> gates,
+                                   const float* weights,
+                                   size_t stride,
+                                   rtc::ArrayView<float> y) {
+  RTC_DCHECK(gates.empty() || gates.size() == x.size());
+  RTC_DCHECK_LE(y.size(), stride);
+  for (size_t o = 0; o < y.size(); ++o) {
+    if (gates.empty()) {
+      for (size_t i = 0; i < x.size(); ++i) {
+        y[o] += x[i] * weights[i * stride + o];
+      }
+    } else {
+      for (size_t i = 0; i < x.size(); ++i) {
+        y[o] += x[i] * weights[i * stride + o] * gates[i];
+      }
+    }
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void AccumulateMatrixVectorProduct_SSE2(rtc::ArrayView<const float> x,
+                                        rtc::ArrayView<const float> gates,
+                                        const float* weights,
+                                        size_t stride,
+                                        rtc::ArrayView<float> y) {
+  RTC_DCHECK(gates.empty() || gates.size() == x.size());
+  RTC_DCHECK_LE(y.size(), stride);
+  // Four outputs at a time, each lane accumulating in the same order as the
+  // generic version.
+  size_t o = 0;
+  for (; o + 4 <= y.size(); o += 4) {
+    __m128 acc = _mm_loadu_ps(&y[o]);
+    if (gates.empty()) {
+      for (size_t i = 0; i < x.size(); ++i) {
+        const __m128 w = _mm_loadu_ps(&weights[i * stride + o]);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(x[i]), w));
+      }
+    } else {
+      for (size_t i = 0; i < x.size(); ++i) {
+        const __m128 w = _mm_loadu_ps(&weights[i * stride + o]);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(x[i]), w),
+                                         _mm_set1_ps(gates[i])));
+      }
+    }
+    _mm_storeu_ps(&y[o], acc);
+  }
+  AccumulateMatrixVectorProduct(x, gates, weights + o, stride, y.subview(o));
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+void AccumulateMatrixVectorProduct_NEON(rtc::ArrayView<const float> x,
+                                        rtc::ArrayView<const float> gates,
+                                        const float* weights,
+                                        size_t stride,
+                                        rtc::ArrayView<float> y) {
+  RTC_DCHECK(gates.empty() || gates.size() == x.size());
+  RTC_DCHECK_LE(y.size(), stride);
+  // Separate multiplications and additions are used instead of vmlaq_f32() to
+  // round as the generic version does.
+  size_t o = 0;
+  for (; o + 4 <= y.size(); o += 4) {
+    float32x4_t acc = vld1q_f32(&y[o]);
+    if (gates.empty()) {
+      for (size_t i = 0; i < x.size(); ++i) {
+        const float32x4_t w = vld1q_f32(&weights[i * stride + o]);
+        acc = vaddq_f32(acc, vmulq_n_f32(w, x[i]));
+      }
+    } else {
+      for (size_t i = 0; i < x.size(); ++i) {
+        const float32x4_t w = vld1q_f32(&weights[i * stride + o]);
+        acc = vaddq_f32(acc, vmulq_n_f32(vmulq_n_f32(w, x[i]), gates[i]));
+      }
+    }
+    vst1q_f32(&y[o], acc);
+  }
+  AccumulateMatrixVectorProduct(x, gates, weights + o, stride, y.subview(o));
+}
+#endif
+
 FullyConnectedLayer::FullyConnectedLayer(
     const size_t input_size,
     const size_t output_size,
     const rtc::ArrayView<const int8_t> bias,
     const rtc::ArrayView<const int8_t> weights,
-    float (*const activation_function)(float))
+    float (*const activation_function)(float),
+    Optimization optimization)
     : input_size_(input_size),
       output_size_(output_size),
       bias_(bias),
-      weights_(weights),
-      activation_function_(activation_function) {
+      weights_(ConvertWeights(weights)),
+      activation_function_(activation_function),
+      optimization_(optimization) {
   RTC_DCHECK_LE(output_size_, kFullyConnectedLayersMaxUnits)
       << "Static over-allocation of fully-connected layers output vectors is "
          "not sufficient.";
@@ -75,15 +218,11 @@ rtc::ArrayView<const float> FullyConnectedLayer::GetOutput() const {
 }
 
 void FullyConnectedLayer::ComputeOutput(rtc::ArrayView<const float> input) {
-  // TODO(bugs.chromium.org/9076): Optimize using SSE/AVX fused multiply-add
-  // operations.
+  RTC_DCHECK_EQ(input_size_, input.size());
+  std::copy(bias_.begin(), bias_.end(), output_.begin());
+  Accumulate(optimization_, input, {}, weights_.data(), output_size_,
+             rtc::ArrayView<float>(output_.data(), output_size_));
   for (size_t o = 0; o < output_size_; ++o) {
-    output_[o] = bias_[o];
-    // TODO(bugs.chromium.org/9076): Benchmark how different layouts for
-    // |weights_| change the performance across different platforms.
-    for (size_t i = 0; i < input_size_; ++i) {
-      output_[o] += input[i] * weights_[i * output_size_ + o];
-    }
     output_[o] = (*activation_function_)(kWeightsScale * output_[o]);
   }
 }
@@ -94,13 +233,15 @@ GatedRecurrentLayer::GatedRecurrentLayer(
     const rtc::ArrayView<const int8_t> bias,
     const rtc::ArrayView<const int8_t> weights,
     const rtc::ArrayView<const int8_t> recurrent_weights,
-    float (*const activation_function)(float))
+    float (*const activation_function)(float),
+    Optimization optimization)
     : input_size_(input_size),
       output_size_(output_size),
       bias_(bias),
-      weights_(weights),
-      recurrent_weights_(recurrent_weights),
-      activation_function_(activation_function) {
+      weights_(ConvertWeights(weights)),
+      recurrent_weights_(ConvertWeights(recurrent_weights)),
+      activation_function_(activation_function),
+      optimization_(optimization) {
   RTC_DCHECK_LE(output_size_, kRecurrentLayersMaxUnits)
       << "Static over-allocation of recurrent layers state vectors is not "
       << "sufficient.";
@@ -125,55 +266,46 @@ void GatedRecurrentLayer::Reset() {
 }
 
 void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
-  // TODO(bugs.chromium.org/9076): Optimize using SSE/AVX fused multiply-add
-  // operations.
+  RTC_DCHECK_EQ(input_size_, input.size());
   // Stride and offset used to read parameter arrays.
   const size_t stride = 3 * output_size_;
   size_t offset = 0;
+  const rtc::ArrayView<const float> state(state_.data(), output_size_);
+
+  // Adds the input and the (optionally gated) state contributions to |y| for
+  // the gate whose parameters start at |gate_offset|.
+  auto accumulate = [&](size_t gate_offset,
+                        rtc::ArrayView<const float> state_gates,
+                        rtc::ArrayView<float> y) {
+    std::copy(bias_.begin() + gate_offset,
+              bias_.begin() + gate_offset + output_size_, y.begin());
+    Accumulate(optimization_, input, {}, weights_.data() + gate_offset, stride,
+               y);
+    Accumulate(optimization_, state, state_gates,
+               recurrent_weights_.data() + gate_offset, stride, y);
+  };
 
   // Compute update gates.
   std::array<float, kRecurrentLayersMaxUnits> update;
+  accumulate(offset, {}, {update.data(), output_size_});
   for (size_t o = 0; o < output_size_; ++o) {
-    update[o] = bias_[o];
-    // TODO(bugs.chromium.org/9076): Benchmark how different layouts for
-    // |weights_| and |recurrent_weights_| change the performance across
-    // different platforms.
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      update[o] += input[i] * weights_[i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_; ++s) {
-      update[o] += state_[s] * recurrent_weights_[s * stride + o];
-    }  // Add state.
     update[o] = SigmoidApproximated(kWeightsScale * update[o]);
   }
 
   // Compute reset gates.
   offset += output_size_;
   std::array<float, kRecurrentLayersMaxUnits> reset;
+  accumulate(offset, {}, {reset.data(), output_size_});
   for (size_t o = 0; o < output_size_; ++o) {
-    reset[o] = bias_[offset + o];
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      reset[o] += input[i] * weights_[offset + i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_; ++s) {  // Add state.
-      reset[o] += state_[s] * recurrent_weights_[offset + s * stride + o];
-    }
     reset[o] = SigmoidApproximated(kWeightsScale * reset[o]);
   }
 
-  // Compute output.
+  // Compute output, adding the state through the reset gates.
   offset += output_size_;
   std::array<float, kRecurrentLayersMaxUnits> output;
+  accumulate(offset, {reset.data(), output_size_},
+             {output.data(), output_size_});
   for (size_t o = 0; o < output_size_; ++o) {
-    output[o] = bias_[offset + o];
-    for (size_t i = 0; i < input_size_; ++i) {  // Add input.
-      output[o] += input[i] * weights_[offset + i * stride + o];
-    }
-    for (size_t s = 0; s < output_size_;
-         ++s) {  // Add state through reset gates.
-      output[o] +=
-          state_[s] * recurrent_weights_[offset + s * stride + o] * reset[s];
-    }
     output[o] = (*activation_function_)(kWeightsScale * output[o]);
     // Update output through the update gates.
     output[o] = update[o] * state_[o] + (1.f - update[o]) * output[o];
@@ -181,26 +313,31 @@ void GatedRecurrentLayer::ComputeOutput(rtc::ArrayView<const float> input) {
 
   // Update the state. Not done in the previous loop since that would pollute
   // the current state and lead to incorrect output values.
-  std::copy(output.begin(), output.end(), state_.begin());
+  std::copy(output.begin(), output.begin() + output_size_, state_.begin());
 }
 
-RnnBasedVad::RnnBasedVad()
+RnnBasedVad::RnnBasedVad() : RnnBasedVad(DetectOptimization()) {}
+
+RnnBasedVad::RnnBasedVad(Optimization optimization)
     : input_layer_(kInputLayerInputSize,
                    kInputLayerOutputSize,
                    kInputDenseBias,
                    kInputDenseWeights,
-                   TansigApproximated),
+                   TansigApproximated,
+                   optimization),
       hidden_layer_(kInputLayerOutputSize,
                     kHiddenLayerOutputSize,
                     kHiddenGruBias,
                     kHiddenGruWeights,
                     kHiddenGruRecurrentWeights,
-                    RectifiedLinearUnit),
+                    RectifiedLinearUnit,
+                    optimization),
       output_layer_(kHiddenLayerOutputSize,
                     kOutputLayerOutputSize,
                     kOutputDenseBias,
                     kOutputDenseWeights,
-                    SigmoidApproximated) {
+                    SigmoidApproximated,
+                    optimization) {
   // Input-output chaining size checks.
   RTC_DCHECK_EQ(input_layer_.output_size(), hidden_layer_.input_size())
       << "The input and the hidden layers sizes do not match.";
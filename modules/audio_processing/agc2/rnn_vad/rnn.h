@@ -11,10 +11,13 @@
 #ifndef MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_RNN_H_
 #define MODULES_AUDIO_PROCESSING_AGC2_RNN_VAD_RNN_H_
 
+#include <stddef.h>
 #include <array>
+#include <vector>
 
 #include "api/array_view.h"
 #include "modules/audio_processing/agc2/rnn_vad/common.h"
+#include "typedefs.h"  // NOLINT(build/include)
 
 namespace webrtc {
 namespace rnn_vad {
@@ -31,6 +34,42 @@ constexpr size_t kFullyConnectedLayersMaxUnits = 24;
 // recurrent layer.
 constexpr size_t kRecurrentLayersMaxUnits = 24;
 
+// Instruction sets used by the layers to compute their matrix-vector products.
+enum class Optimization { kNone, kSse2, kAvx2, kNeon };
+
+// Returns the most efficient optimization supported by the CPU.
+Optimization DetectOptimization();
+
+// Computes |y[o] += x[i] * weights[i * stride + o]| for every output |o| in
+// [0, |y.size()|), accumulating the inputs |i| in increasing order. When
+// |gates| is not empty, each product is also multiplied by |gates[i]|. The
+// optimized versions vectorize over the outputs and are bit exact with the
+// generic one.
+void AccumulateMatrixVectorProduct(rtc::ArrayView<const float> x,
+                                   rtc::ArrayView<const float> gates,
+                                   const float* weights,
+                                   size_t stride,
+                                   rtc::ArrayView<float> y);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void AccumulateMatrixVectorProduct_SSE2(rtc::ArrayView<const float> x,
+                                        rtc::ArrayView<const float> gates,
+                                        const float* weights,
+                                        size_t stride,
+                                        rtc::ArrayView<float> y);
+void AccumulateMatrixVectorProduct_AVX2(rtc::ArrayView<const float> x,
+                                        rtc::ArrayView<const float> gates,
+                                        const float* weights,
+                                        size_t stride,
+                                        rtc::ArrayView<float> y);
+#endif
+#if defined(WEBRTC_HAS_NEON)
+void AccumulateMatrixVectorProduct_NEON(rtc::ArrayView<const float> x,
+                                        rtc::ArrayView<const float> gates,
+                                        const float* weights,
+                                        size_t stride,
+                                        rtc::ArrayView<float> y);
+#endif
+
 // Fully-connected layer.
 class FullyConnectedLayer {
  public:
@@ -38,7 +77,8 @@ class FullyConnectedLayer {
                       const size_t output_size,
                       const rtc::ArrayView<const int8_t> bias,
                       const rtc::ArrayView<const int8_t> weights,
-                      float (*const activation_function)(float));
+                      float (*const activation_function)(float),
+                      Optimization optimization);
   FullyConnectedLayer(const FullyConnectedLayer&) = delete;
   FullyConnectedLayer& operator=(const FullyConnectedLayer&) = delete;
   ~FullyConnectedLayer();
@@ -52,8 +92,10 @@ class FullyConnectedLayer {
   const size_t input_size_;
   const size_t output_size_;
   const rtc::ArrayView<const int8_t> bias_;
-  const rtc::ArrayView<const int8_t> weights_;
+  // The quantized weights converted to float once, with the same layout.
+  const std::vector<float> weights_;
   float (*const activation_function_)(float);
+  const Optimization optimization_;
   // The output vector of a recurrent layer has length equal to |output_size_|.
   // However, for efficiency, over-allocation is used.
   std::array<float, kFullyConnectedLayersMaxUnits> output_;
@@ -67,7 +109,8 @@ class GatedRecurrentLayer {
                       const rtc::ArrayView<const int8_t> bias,
                       const rtc::ArrayView<const int8_t> weights,
                       const rtc::ArrayView<const int8_t> recurrent_weights,
-                      float (*const activation_function)(float));
+                      float (*const activation_function)(float),
+                      Optimization optimization);
   GatedRecurrentLayer(const GatedRecurrentLayer&) = delete;
   GatedRecurrentLayer& operator=(const GatedRecurrentLayer&) = delete;
   ~GatedRecurrentLayer();
@@ -82,9 +125,11 @@ class GatedRecurrentLayer {
   const size_t input_size_;
   const size_t output_size_;
   const rtc::ArrayView<const int8_t> bias_;
-  const rtc::ArrayView<const int8_t> weights_;
-  const rtc::ArrayView<const int8_t> recurrent_weights_;
+  // The quantized weights converted to float once, with the same layout.
+  const std::vector<float> weights_;
+  const std::vector<float> recurrent_weights_;
   float (*const activation_function_)(float);
+  const Optimization optimization_;
   // The state vector of a recurrent layer has length equal to |output_size_|.
   // However, to avoid dynamic allocation, over-allocation is used.
   std::array<float, kRecurrentLayersMaxUnits> state_;
@@ -94,6 +139,7 @@ class GatedRecurrentLayer {
 class RnnBasedVad {
  public:
   RnnBasedVad();
+  explicit RnnBasedVad(Optimization optimization);
   RnnBasedVad(const RnnBasedVad&) = delete;
   RnnBasedVad& operator=(const RnnBasedVad&) = delete;
   ~RnnBasedVad();
@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/agc2/rnn_vad/rnn.h"
+
+#include <immintrin.h>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace rnn_vad {
+
+// Eight outputs at a time. FMA is deliberately not used so that each lane
+// rounds as the generic version does. The remaining outputs are left to the
+// SSE2 version.
+void AccumulateMatrixVectorProduct_AVX2(rtc::ArrayView<const float> x,
+                                        rtc::ArrayView<const float> gates,
+                                        const float* weights,
+                                        size_t stride,
+                                        rtc::ArrayView<float> y) {
+  RTC_DCHECK(gates.empty() || gates.size() == x.size());
+  RTC_DCHECK_LE(y.size(), stride);
+  size_t o = 0;
+  for (; o + 8 <= y.size(); o += 8) {
+    __m256 acc = _mm256_loadu_ps(&y[o]);
+    if (gates.empty()) {
+      for (size_t i = 0; i < x.size(); ++i) {
+        const __m256 w = _mm256_loadu_ps(&weights[i * stride + o]);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(x[i]), w));
+      }
+    } else {
+      for (size_t i = 0; i < x.size(); ++i) {
+        const __m256 w = _mm256_loadu_ps(&weights[i * stride + o]);
+        acc = _mm256_add_ps(
+            acc, _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(x[i]), w),
+                               _mm256_set1_ps(gates[i])));
+      }
+    }
+    _mm256_storeu_ps(&y[o], acc);
+  }
+  AccumulateMatrixVectorProduct_SSE2(x, gates, weights + o, stride,
+                                     y.subview(o));
+}
+
+}  // namespace rnn_vad
+}  // namespace webrtc
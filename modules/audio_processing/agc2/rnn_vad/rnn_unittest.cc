@@ -14,7 +14,11 @@
 
 #include "modules/audio_processing/agc2/rnn_vad/rnn.h"
 #include "modules/audio_processing/agc2/rnn_vad/test_utils.h"
+#include "modules/audio_processing/test/performance_timer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "test/gtest.h"
 #include "third_party/rnnoise/src/rnn_activations.h"
 #include "third_party/rnnoise/src/rnn_vad_weights.h"
@@ -28,6 +32,29 @@ using rnnoise::SigmoidApproximated;
 
 namespace {
 
+// Returns the optimizations supported by the CPU, including kNone.
+std::vector<Optimization> GetSupportedOptimizations() {
+  std::vector<Optimization> optimizations = {Optimization::kNone};
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    optimizations.push_back(Optimization::kSse2);
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    optimizations.push_back(Optimization::kAvx2);
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  optimizations.push_back(Optimization::kNeon);
+#endif
+  return optimizations;
+}
+
+void FillRandom(Random* random_generator, rtc::ArrayView<float> v) {
+  for (float& v_k : v) {
+    v_k = random_generator->Rand<float>() - 0.5f;
+  }
+}
+
 void TestFullyConnectedLayer(FullyConnectedLayer* fc,
                              rtc::ArrayView<const float> input_vector,
                              const float expected_output) {
@@ -69,40 +96,47 @@ TEST(RnnVadTest, CheckFullyConnectedLayerOutput) {
   const std::array<int8_t, 24> weights = {
       127,  127,  127, 127,  127,  20,  127,  -126, -126, -54, 14,  125,
       -126, -126, 127, -125, -126, 127, -127, -127, -57,  -30, 127, 80};
-  FullyConnectedLayer fc(24, 1, bias, weights, SigmoidApproximated);
-  // Test on different inputs.
-  {
-    const std::array<float, 24> input_vector = {
-        0.f,           0.f,           0.f,          0.f,          0.f,
-        0.f,           0.215833917f,  0.290601075f, 0.238759011f, 0.244751841f,
-        0.f,           0.0461241305f, 0.106401242f, 0.223070428f, 0.630603909f,
-        0.690453172f,  0.f,           0.387645692f, 0.166913897f, 0.f,
-        0.0327451192f, 0.f,           0.136149868f, 0.446351469f};
-    TestFullyConnectedLayer(&fc, input_vector, 0.436567038f);
-  }
-  {
-    const std::array<float, 24> input_vector = {
-        0.592162728f,  0.529089332f,  1.18205106f,
-        1.21736848f,   0.f,           0.470851123f,
-        0.130675942f,  0.320903003f,  0.305496395f,
-        0.0571633279f, 1.57001138f,   0.0182026215f,
-        0.0977443159f, 0.347477973f,  0.493206412f,
-        0.9688586f,    0.0320267938f, 0.244722098f,
-        0.312745273f,  0.f,           0.00650715502f,
-        0.312553257f,  1.62619662f,   0.782880902f};
-    TestFullyConnectedLayer(&fc, input_vector, 0.874741316f);
-  }
-  {
-    const std::array<float, 24> input_vector = {
-        0.395022154f,  0.333681047f,  0.76302278f,
-        0.965480626f,  0.f,           0.941198349f,
-        0.0892967582f, 0.745046318f,  0.635769248f,
-        0.238564298f,  0.970656633f,  0.014159563f,
-        0.094203949f,  0.446816623f,  0.640755892f,
-        1.20532358f,   0.0254284926f, 0.283327013f,
-        0.726210058f,  0.0550272502f, 0.000344108557f,
-        0.369803518f,  1.56680179f,   0.997883797f};
-    TestFullyConnectedLayer(&fc, input_vector, 0.672785878f);
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    FullyConnectedLayer fc(24, 1, bias, weights, SigmoidApproximated,
+                           optimization);
+    // Test on different inputs.
+    {
+      const std::array<float, 24> input_vector = {
+          0.f,           0.f,           0.f,
+          0.f,           0.f,           0.f,
+          0.215833917f,  0.290601075f,  0.238759011f,
+          0.244751841f,  0.f,           0.0461241305f,
+          0.106401242f,  0.223070428f,  0.630603909f,
+          0.690453172f,  0.f,           0.387645692f,
+          0.166913897f,  0.f,           0.0327451192f,
+          0.f,           0.136149868f,  0.446351469f};
+      TestFullyConnectedLayer(&fc, input_vector, 0.436567038f);
+    }
+    {
+      const std::array<float, 24> input_vector = {
+          0.592162728f,  0.529089332f,  1.18205106f,
+          1.21736848f,   0.f,           0.470851123f,
+          0.130675942f,  0.320903003f,  0.305496395f,
+          0.0571633279f, 1.57001138f,   0.0182026215f,
+          0.0977443159f, 0.347477973f,  0.493206412f,
+          0.9688586f,    0.0320267938f, 0.244722098f,
+          0.312745273f,  0.f,           0.00650715502f,
+          0.312553257f,  1.62619662f,   0.782880902f};
+      TestFullyConnectedLayer(&fc, input_vector, 0.874741316f);
+    }
+    {
+      const std::array<float, 24> input_vector = {
+          0.395022154f,  0.333681047f,  0.76302278f,
+          0.965480626f,  0.f,           0.941198349f,
+          0.0892967582f, 0.745046318f,  0.635769248f,
+          0.238564298f,  0.970656633f,  0.014159563f,
+          0.094203949f,  0.446816623f,  0.640755892f,
+          1.20532358f,   0.0254284926f, 0.283327013f,
+          0.726210058f,  0.0550272502f, 0.000344108557f,
+          0.369803518f,  1.56680179f,   0.997883797f};
+      TestFullyConnectedLayer(&fc, input_vector, 0.672785878f);
+    }
   }
 }
 
@@ -121,21 +155,116 @@ TEST(RnnVadTest, CheckGatedRecurrentLayer) {
       64,  -62, 117, 85,  -51,  -43, 54,  -105, 120, 56,  -128, -107,
       39,  50,  -17, -47, -117, 14,  108, 12,   -7,  -72, 103,  -87,
       -66, 82,  84,  100, -98,  102, -49, 44,   122, 106, -20,  -69};
-  GatedRecurrentLayer gru(5, 4, bias, weights, recurrent_weights,
-                          RectifiedLinearUnit);
-  // Test on different inputs.
-  {
-    const std::array<float, 20> input_sequence = {
-        0.89395463f, 0.93224651f, 0.55788344f, 0.32341808f, 0.93355054f,
-        0.13475326f, 0.97370994f, 0.14253306f, 0.93710381f, 0.76093364f,
-        0.65780413f, 0.41657975f, 0.49403164f, 0.46843281f, 0.75138855f,
-        0.24517593f, 0.47657707f, 0.57064998f, 0.435184f,   0.19319285f};
-    const std::array<float, 16> expected_output_sequence = {
-        0.0239123f,  0.5773077f,  0.f,         0.f,
-        0.01282811f, 0.64330572f, 0.f,         0.04863098f,
-        0.00781069f, 0.75267816f, 0.f,         0.02579715f,
-        0.00471378f, 0.59162533f, 0.11087593f, 0.01334511f};
-    TestGatedRecurrentLayer(&gru, input_sequence, expected_output_sequence);
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    GatedRecurrentLayer gru(5, 4, bias, weights, recurrent_weights,
+                            RectifiedLinearUnit, optimization);
+    // Test on different inputs.
+    {
+      const std::array<float, 20> input_sequence = {
+          0.89395463f, 0.93224651f, 0.55788344f, 0.32341808f, 0.93355054f,
+          0.13475326f, 0.97370994f, 0.14253306f, 0.93710381f, 0.76093364f,
+          0.65780413f, 0.41657975f, 0.49403164f, 0.46843281f, 0.75138855f,
+          0.24517593f, 0.47657707f, 0.57064998f, 0.435184f,   0.19319285f};
+      const std::array<float, 16> expected_output_sequence = {
+          0.0239123f,  0.5773077f,  0.f,         0.f,
+          0.01282811f, 0.64330572f, 0.f,         0.04863098f,
+          0.00781069f, 0.75267816f, 0.f,         0.02579715f,
+          0.00471378f, 0.59162533f, 0.11087593f, 0.01334511f};
+      TestGatedRecurrentLayer(&gru, input_sequence, expected_output_sequence);
+    }
+  }
+}
+
+// Verifies that the optimized matrix-vector products are bit exact with the
+// generic one.
+TEST(RnnVadTest, OptimizedMatrixVectorProductsAreBitexact) {
+  Random random_generator(42U);
+  constexpr size_t kInputSize = 42;
+  constexpr size_t kStride = 3 * kRecurrentLayersMaxUnits;
+  std::vector<float> x(kInputSize);
+  std::vector<float> gates(kInputSize);
+  std::vector<float> weights(kInputSize * kStride);
+  FillRandom(&random_generator, x);
+  FillRandom(&random_generator, gates);
+  FillRandom(&random_generator, weights);
+  for (size_t output_size = 1; output_size <= kRecurrentLayersMaxUnits;
+       ++output_size) {
+    SCOPED_TRACE(output_size);
+    for (bool gated : {false, true}) {
+      rtc::ArrayView<const float> gates_view;
+      if (gated) {
+        gates_view = gates;
+      }
+      std::vector<float> expected(output_size, 0.5f);
+      AccumulateMatrixVectorProduct(x, gates_view, weights.data(), kStride,
+                                    expected);
+      std::vector<float> computed(output_size, 0.5f);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+        AccumulateMatrixVectorProduct_SSE2(x, gates_view, weights.data(),
+                                           kStride, computed);
+        ExpectEqualFloatArray(expected, computed);
+      }
+      if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+        std::fill(computed.begin(), computed.end(), 0.5f);
+        AccumulateMatrixVectorProduct_AVX2(x, gates_view, weights.data(),
+                                           kStride, computed);
+        ExpectEqualFloatArray(expected, computed);
+      }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+      std::fill(computed.begin(), computed.end(), 0.5f);
+      AccumulateMatrixVectorProduct_NEON(x, gates_view, weights.data(),
+                                         kStride, computed);
+      ExpectEqualFloatArray(expected, computed);
+#endif
+    }
+  }
+}
+
+// Verifies that the VAD probabilities do not depend on the optimization.
+TEST(RnnVadTest, OptimizedRnnsAreBitexact) {
+  constexpr size_t kNumFrames = 100;
+  Random random_generator(42U);
+  std::vector<float> features(kNumFrames * kFeatureVectorSize);
+  FillRandom(&random_generator, features);
+  std::vector<float> expected;
+  RnnBasedVad reference_vad(Optimization::kNone);
+  for (size_t i = 0; i < kNumFrames; ++i) {
+    expected.push_back(reference_vad.ComputeVadProbability(
+        {&features[i * kFeatureVectorSize], kFeatureVectorSize}, false));
+  }
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    SCOPED_TRACE(static_cast<int>(optimization));
+    RnnBasedVad vad(optimization);
+    std::vector<float> computed;
+    for (size_t i = 0; i < kNumFrames; ++i) {
+      computed.push_back(vad.ComputeVadProbability(
+          {&features[i * kFeatureVectorSize], kFeatureVectorSize}, false));
+    }
+    ExpectEqualFloatArray(expected, computed);
+  }
+}
+
+// Reports the time taken by the RNN per frame for every supported
+// optimization.
+TEST(RnnVadTest, DISABLED_RnnPerformance) {
+  constexpr size_t kNumFrames = 10000;
+  Random random_generator(42U);
+  std::array<float, kFeatureVectorSize> features;
+  FillRandom(&random_generator, features);
+  for (Optimization optimization : GetSupportedOptimizations()) {
+    RnnBasedVad vad(optimization);
+    ::webrtc::test::PerformanceTimer perf_timer(kNumFrames);
+    for (size_t i = 0; i < kNumFrames; ++i) {
+      perf_timer.StartTimer();
+      vad.ComputeVadProbability(features, false);
+      perf_timer.StopTimer();
+    }
+    RTC_LOG(LS_INFO) << "RNN VAD optimization "
+                     << static_cast<int>(optimization) << ": "
+                     << perf_timer.GetDurationAverage(100) << " us per frame";
   }
 }
 
@@ -61,8 +61,7 @@ AudioBuffer::AudioBuffer(size_t input_num_frames,
     reference_copied_(false),
     activity_(AudioFrame::kVadUnknown),
     keyboard_data_(NULL),
-    data_(new IFChannelBuffer(proc_num_frames_, num_proc_channels_)),
-    output_buffer_(new IFChannelBuffer(output_num_frames_, num_channels_)) {
+    data_(new IFChannelBuffer(proc_num_frames_, num_proc_channels_)) {
   RTC_DCHECK_GT(input_num_frames_, 0);
   RTC_DCHECK_GT(proc_num_frames_, 0);
   RTC_DCHECK_GT(output_num_frames_, 0);
@@ -70,26 +69,37 @@ AudioBuffer::AudioBuffer(size_t input_num_frames,
   RTC_DCHECK_GT(num_proc_channels_, 0);
   RTC_DCHECK_LE(num_proc_channels_, num_input_channels_);
 
-  if (input_num_frames_ != proc_num_frames_ ||
-      output_num_frames_ != proc_num_frames_) {
-    // Create an intermediate buffer for resampling.
+  // All the buffers are allocated here, so that processing a frame never
+  // allocates memory.
+  if (input_num_frames_ != proc_num_frames_) {
+    // The input is downmixed or deinterleaved into this buffer before being
+    // resampled into |data_|.
+    input_buffer_.reset(
+        new IFChannelBuffer(input_num_frames_, num_proc_channels_));
+    for (size_t i = 0; i < num_proc_channels_; ++i) {
+      input_resamplers_.push_back(std::unique_ptr<PushSincResampler>(
+          new PushSincResampler(input_num_frames_, proc_num_frames_)));
+    }
+  }
+
+  if (output_num_frames_ != proc_num_frames_) {
+    // Create intermediate buffers for resampling.
     process_buffer_.reset(new ChannelBuffer<float>(proc_num_frames_,
                                                    num_proc_channels_));
-
-    if (input_num_frames_ != proc_num_frames_) {
-      for (size_t i = 0; i < num_proc_channels_; ++i) {
-        input_resamplers_.push_back(std::unique_ptr<PushSincResampler>(
-            new PushSincResampler(input_num_frames_, proc_num_frames_)));
-      }
+    output_buffer_.reset(
+        new IFChannelBuffer(output_num_frames_, num_proc_channels_));
+    for (size_t i = 0; i < num_proc_channels_; ++i) {
+      output_resamplers_.push_back(std::unique_ptr<PushSincResampler>(
+          new PushSincResampler(proc_num_frames_, output_num_frames_)));
     }
+  }
 
-    if (output_num_frames_ != proc_num_frames_) {
-      for (size_t i = 0; i < num_proc_channels_; ++i) {
-        output_resamplers_.push_back(std::unique_ptr<PushSincResampler>(
-            new PushSincResampler(proc_num_frames_, output_num_frames_)));
-      }
-    }
+  if (num_proc_channels_ > 1) {
+    mixed_low_pass_channels_.reset(
+        new ChannelBuffer<int16_t>(num_split_frames_, 1));
   }
+  low_pass_reference_channels_.reset(
+      new ChannelBuffer<int16_t>(num_split_frames_, num_proc_channels_));
 
   if (num_bands_ > 1) {
     split_data_.reset(new IFChannelBuffer(proc_num_frames_,
@@ -108,43 +118,42 @@ void AudioBuffer::CopyFrom(const float* const* data,
   RTC_DCHECK_EQ(stream_config.num_frames(), input_num_frames_);
   RTC_DCHECK_EQ(stream_config.num_channels(), num_input_channels_);
   InitForNewData();
-  // Initialized lazily because there's a different condition in
-  // DeinterleaveFrom.
   const bool need_to_downmix =
       num_input_channels_ > 1 && num_proc_channels_ == 1;
-  if (need_to_downmix && !input_buffer_) {
-    input_buffer_.reset(
-        new IFChannelBuffer(input_num_frames_, num_proc_channels_));
-  }
+  const bool need_to_resample = input_num_frames_ != proc_num_frames_;
 
   if (stream_config.has_keyboard()) {
     keyboard_data_ = data[KeyboardChannelIndex(stream_config)];
   }
 
+  // Each step writes straight into |data_| when it is the last one before the
+  // conversion, which is then done in place.
+  float* const* proc_data = data_->fbuf()->channels();
+
   // Downmix.
   const float* const* data_ptr = data;
   if (need_to_downmix) {
+    float* const* downmixed =
+        need_to_resample ? input_buffer_->fbuf()->channels() : proc_data;
     DownmixToMono<float, float>(data, input_num_frames_, num_input_channels_,
-                                input_buffer_->fbuf()->channels()[0]);
-    data_ptr = input_buffer_->fbuf_const()->channels();
+                                downmixed[0]);
+    data_ptr = downmixed;
   }
 
   // Resample.
-  if (input_num_frames_ != proc_num_frames_) {
+  if (need_to_resample) {
     for (size_t i = 0; i < num_proc_channels_; ++i) {
       input_resamplers_[i]->Resample(data_ptr[i],
                                      input_num_frames_,
-                                     process_buffer_->channels()[i],
+                                     proc_data[i],
                                      proc_num_frames_);
     }
-    data_ptr = process_buffer_->channels();
+    data_ptr = proc_data;
   }
 
   // Convert to the S16 range.
   for (size_t i = 0; i < num_proc_channels_; ++i) {
-    FloatToFloatS16(data_ptr[i],
-                    proc_num_frames_,
-                    data_->fbuf()->channels()[i]);
+    FloatToFloatS16(data_ptr[i], proc_num_frames_, proc_data[i]);
   }
 }
 
@@ -314,11 +323,6 @@ const int16_t* AudioBuffer::mixed_low_pass_data() {
   }
 
   if (!mixed_low_pass_valid_) {
-    if (!mixed_low_pass_channels_.get()) {
-      mixed_low_pass_channels_.reset(
-          new ChannelBuffer<int16_t>(num_split_frames_, 1));
-    }
-
     DownmixToMono<int16_t, int32_t>(split_channels_const(kBand0To8kHz),
                                     num_split_frames_, num_channels_,
                                     mixed_low_pass_channels_->channels()[0]);
@@ -381,11 +385,6 @@ void AudioBuffer::DeinterleaveFrom(AudioFrame* frame) {
   RTC_DCHECK_EQ(frame->num_channels_, num_input_channels_);
   RTC_DCHECK_EQ(frame->samples_per_channel_, input_num_frames_);
   InitForNewData();
-  // Initialized lazily because there's a different condition in CopyFrom.
-  if ((input_num_frames_ != proc_num_frames_) && !input_buffer_) {
-    input_buffer_.reset(
-        new IFChannelBuffer(input_num_frames_, num_proc_channels_));
-  }
   activity_ = frame->vad_activity_;
 
   int16_t* const* deinterleaved;
@@ -450,12 +449,6 @@ void AudioBuffer::InterleaveTo(AudioFrame* frame, bool data_changed) const {
 
 void AudioBuffer::CopyLowPassToReference() {
   reference_copied_ = true;
-  if (!low_pass_reference_channels_.get() ||
-      low_pass_reference_channels_->num_channels() != num_channels_) {
-    low_pass_reference_channels_.reset(
-        new ChannelBuffer<int16_t>(num_split_frames_,
-                                   num_proc_channels_));
-  }
   for (size_t i = 0; i < num_proc_channels_; i++) {
     memcpy(low_pass_reference_channels_->channels()[i],
            split_bands_const(i)[kBand0To8kHz],
@@ -9,6 +9,12 @@
  */
 
 #include "modules/audio_processing/audio_buffer.h"
+
+#include <vector>
+
+#include "common_audio/include/audio_util.h"
+#include "common_audio/resampler/push_sinc_resampler.h"
+#include "rtc_base/random.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -18,6 +24,7 @@ namespace {
 const size_t kNumFrames = 480u;
 const size_t kStereo = 2u;
 const size_t kMono = 1u;
+const size_t kNumFrames16kHz = 160u;
 
 void ExpectNumChannels(const AudioBuffer& ab, size_t num_channels) {
   EXPECT_EQ(ab.data()->num_channels(), num_channels);
@@ -27,6 +34,14 @@ void ExpectNumChannels(const AudioBuffer& ab, size_t num_channels) {
   EXPECT_EQ(ab.num_channels(), num_channels);
 }
 
+void FillRandom(Random* random_generator, ChannelBuffer<float>* buffer) {
+  for (size_t ch = 0; ch < buffer->num_channels(); ++ch) {
+    for (size_t k = 0; k < buffer->num_frames(); ++k) {
+      buffer->channels()[ch][k] = 2.f * random_generator->Rand<float>() - 1.f;
+    }
+  }
+}
+
 }  // namespace
 
 TEST(AudioBufferTest, SetNumChannelsSetsChannelBuffersNumChannels) {
@@ -45,4 +60,56 @@ TEST(AudioBufferTest, SetNumChannelsDeathTest) {
 }
 #endif
 
+// Verifies that downmixing, resampling and converting the input to the S16
+// range in CopyFrom() give the same result as doing these steps one by one.
+TEST(AudioBufferTest, CopyFromDownmixesResamplesAndConverts) {
+  for (size_t num_proc_frames : {kNumFrames, kNumFrames16kHz}) {
+    SCOPED_TRACE(num_proc_frames);
+    AudioBuffer ab(kNumFrames, kStereo, num_proc_frames, kMono, kNumFrames);
+    PushSincResampler resampler(kNumFrames, num_proc_frames);
+    const StreamConfig stream_config(48000, kStereo);
+    Random random_generator(42U);
+    ChannelBuffer<float> input(kNumFrames, kStereo);
+    std::vector<float> downmixed(kNumFrames);
+    std::vector<float> expected(num_proc_frames);
+    for (int frame = 0; frame < 10; ++frame) {
+      FillRandom(&random_generator, &input);
+      ab.CopyFrom(input.channels(), stream_config);
+
+      DownmixToMono<float, float>(input.channels(), kNumFrames, kStereo,
+                                  downmixed.data());
+      if (num_proc_frames == kNumFrames) {
+        expected = downmixed;
+      } else {
+        resampler.Resample(downmixed.data(), kNumFrames, expected.data(),
+                           num_proc_frames);
+      }
+      FloatToFloatS16(expected.data(), num_proc_frames, expected.data());
+
+      ASSERT_EQ(kMono, ab.num_channels());
+      EXPECT_EQ(expected,
+                std::vector<float>(ab.channels_const_f()[0],
+                                   ab.channels_const_f()[0] + num_proc_frames));
+    }
+  }
+}
+
+// Verifies that CopyTo() writes back what CopyFrom() read when the formats
+// match.
+TEST(AudioBufferTest, CopyToRestoresCopiedFromData) {
+  AudioBuffer ab(kNumFrames, kStereo, kNumFrames, kStereo, kNumFrames);
+  const StreamConfig stream_config(48000, kStereo);
+  Random random_generator(42U);
+  ChannelBuffer<float> input(kNumFrames, kStereo);
+  ChannelBuffer<float> output(kNumFrames, kStereo);
+  FillRandom(&random_generator, &input);
+  ab.CopyFrom(input.channels(), stream_config);
+  ab.CopyTo(stream_config, output.channels());
+  for (size_t ch = 0; ch < kStereo; ++ch) {
+    for (size_t k = 0; k < kNumFrames; ++k) {
+      EXPECT_NEAR(input.channels()[ch][k], output.channels()[ch][k], 1e-6f);
+    }
+  }
+}
+
 }  // namespace webrtc
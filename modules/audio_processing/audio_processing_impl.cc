@@ -335,6 +335,12 @@ AudioProcessingBuilder& AudioProcessingBuilder::SetEchoDetector(
   return *this;
 }
 
+AudioProcessingBuilder& AudioProcessingBuilder::SetCaptureOnly(
+    bool capture_only) {
+  capture_only_ = capture_only;
+  return *this;
+}
+
 AudioProcessing* AudioProcessingBuilder::Create() {
   webrtc::Config config;
   return Create(config);
@@ -344,7 +350,9 @@ AudioProcessing* AudioProcessingBuilder::Create(const webrtc::Config& config) {
   AudioProcessingImpl* apm = new rtc::RefCountedObject<AudioProcessingImpl>(
       config, std::move(capture_post_processing_),
       std::move(render_pre_processing_), std::move(echo_control_factory_),
-      std::move(echo_detector_), nonlinear_beamformer_.release());
+      std::move(echo_detector_), nonlinear_beamformer_.release(),
+      capture_only_);
+  capture_only_ = false;
   if (apm->Initialize() != AudioProcessing::kNoError) {
     delete apm;
     apm = nullptr;
@@ -364,7 +372,8 @@ AudioProcessingImpl::AudioProcessingImpl(
     std::unique_ptr<CustomProcessing> render_pre_processor,
     std::unique_ptr<EchoControlFactory> echo_control_factory,
     std::unique_ptr<EchoDetector> echo_detector,
-    NonlinearBeamformer* beamformer)
+    NonlinearBeamformer* beamformer,
+    bool capture_only)
     : data_dumper_(
           new ApmDataDumper(rtc::AtomicOps::Increment(&instance_count_))),
       capture_runtime_settings_(kRuntimeSettingQueueSize),
@@ -373,6 +382,7 @@ AudioProcessingImpl::AudioProcessingImpl(
       render_runtime_settings_enqueuer_(&render_runtime_settings_),
       high_pass_filter_impl_(new HighPassFilterImpl(this)),
       echo_control_factory_(std::move(echo_control_factory)),
+      capture_only_(capture_only),
       submodule_states_(!!capture_post_processor, !!render_pre_processor),
       public_submodules_(new ApmPublicSubmodules()),
       private_submodules_(
@@ -400,6 +410,18 @@ AudioProcessingImpl::AudioProcessingImpl(
     rtc::CritScope cs_render(&crit_render_);
     rtc::CritScope cs_capture(&crit_capture_);
 
+    if (capture_only_) {
+      // Everything that needs the render stream is left out.
+      RTC_DCHECK(!private_submodules_->render_pre_processor);
+      if (echo_control_factory_) {
+        RTC_LOG(LS_WARNING) << "Echo control is not available in a "
+                               "capture-only APM";
+        echo_control_factory_.reset();
+      }
+      capture_nonlocked_.intelligibility_enabled = false;
+      config_.residual_echo_detector.enabled = false;
+    }
+
     // Mark Echo Controller enabled if a factory is injected.
     capture_nonlocked_.echo_controller_enabled =
         static_cast<bool>(echo_control_factory_);
@@ -421,13 +443,17 @@ AudioProcessingImpl::AudioProcessingImpl(
             public_submodules_->gain_control.get(), &crit_capture_));
 
     // If no echo detector is injected, use the ResidualEchoDetector.
-    if (!private_submodules_->echo_detector) {
+    if (!private_submodules_->echo_detector && !capture_only_) {
       private_submodules_->echo_detector.reset(new ResidualEchoDetector());
     }
 
     // TODO(alessiob): Move the injected gain controller once injection is
     // implemented.
-    private_submodules_->gain_controller2.reset(new GainController2());
+    // A capture-only APM creates it when it is enabled, since most instances
+    // never use it.
+    if (!capture_only_) {
+      private_submodules_->gain_controller2.reset(new GainController2());
+    }
 
     RTC_LOG(LS_INFO) << "Capture post processor activated: "
                      << !!private_submodules_->capture_post_processor
@@ -517,7 +543,8 @@ int AudioProcessingImpl::InitializeLocked() {
       formats_.api_format.reverse_output_stream().num_frames() == 0
           ? formats_.render_processing_format.num_frames()
           : formats_.api_format.reverse_output_stream().num_frames();
-  if (formats_.api_format.reverse_input_stream().num_channels() > 0) {
+  if (formats_.api_format.reverse_input_stream().num_channels() > 0 &&
+      !capture_only_) {
     render_.render_audio.reset(new AudioBuffer(
         formats_.api_format.reverse_input_stream().num_frames(),
         formats_.api_format.reverse_input_stream().num_channels(),
@@ -549,7 +576,9 @@ int AudioProcessingImpl::InitializeLocked() {
   public_submodules_->echo_cancellation->Initialize(
       proc_sample_rate_hz(), num_reverse_channels(), num_output_channels(),
       num_proc_channels());
-  AllocateRenderQueue();
+  if (!capture_only_) {
+    AllocateRenderQueue();
+  }
 
   int success = public_submodules_->echo_cancellation->enable_metrics(true);
   RTC_DCHECK_EQ(0, success);
@@ -695,6 +724,13 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
   RTC_LOG(LS_INFO) << "Highpass filter activated: "
                    << config_.high_pass_filter.enabled;
 
+  // The residual echo detector is enabled by default, so this is not an error.
+  if (capture_only_ && config_.residual_echo_detector.enabled) {
+    RTC_LOG(LS_INFO) << "The residual echo detector is not available in a "
+                        "capture-only APM";
+    config_.residual_echo_detector.enabled = false;
+  }
+
   const bool config_ok = GainController2::Validate(config_.gain_controller2);
   if (!config_ok) {
     RTC_LOG(LS_ERROR) << "AudioProcessing module config error\n"
@@ -705,7 +741,10 @@ void AudioProcessingImpl::ApplyConfig(const AudioProcessing::Config& config) {
   }
   InitializeGainController2();
   InitializePreAmplifier();
-  private_submodules_->gain_controller2->ApplyConfig(config_.gain_controller2);
+  if (private_submodules_->gain_controller2) {
+    private_submodules_->gain_controller2->ApplyConfig(
+        config_.gain_controller2);
+  }
   RTC_LOG(LS_INFO) << "Gain Controller 2 activated: "
                    << config_.gain_controller2.enabled;
   RTC_LOG(LS_INFO) << "Pre-amplifier activated: "
@@ -727,7 +766,7 @@ void AudioProcessingImpl::SetExtraOptions(const webrtc::Config& config) {
   }
 
 #if WEBRTC_INTELLIGIBILITY_ENHANCER
-  if (capture_nonlocked_.intelligibility_enabled !=
+  if (!capture_only_ && capture_nonlocked_.intelligibility_enabled !=
      config.Get<Intelligibility>().enabled) {
     capture_nonlocked_.intelligibility_enabled =
         config.Get<Intelligibility>().enabled;
@@ -873,7 +912,9 @@ int AudioProcessingImpl::ProcessStream(const float* const* src,
     // that retrieves the render side data. This function accesses apm
     // getters that need the capture lock held when being called.
     rtc::CritScope cs_capture(&crit_capture_);
-    EmptyQueuedRenderAudio();
+    if (!capture_only_) {
+      EmptyQueuedRenderAudio();
+    }
 
     if (!src || !dest) {
       return kNullPointerError;
@@ -1142,8 +1183,10 @@ int AudioProcessingImpl::ProcessStream(AudioFrame* frame) {
     // The lock needs to be released as
     // public_submodules_->echo_control_mobile->is_enabled() aquires this lock
     // as well.
-    rtc::CritScope cs_capture(&crit_capture_);
-    EmptyQueuedRenderAudio();
+    if (!capture_only_) {
+      rtc::CritScope cs_capture(&crit_capture_);
+      EmptyQueuedRenderAudio();
+    }
   }
 
   if (!frame) {
@@ -1411,6 +1454,9 @@ int AudioProcessingImpl::AnalyzeReverseStream(const float* const* data,
                                               int sample_rate_hz,
                                               ChannelLayout layout) {
   TRACE_EVENT0("webrtc", "AudioProcessing::AnalyzeReverseStream_ChannelLayout");
+  if (capture_only_) {
+    return kUnsupportedFunctionError;
+  }
   rtc::CritScope cs(&crit_render_);
   const StreamConfig reverse_config = {
       sample_rate_hz, ChannelsFromLayout(layout), LayoutHasKeyboard(layout),
@@ -1426,6 +1472,9 @@ int AudioProcessingImpl::ProcessReverseStream(const float* const* src,
                                               const StreamConfig& output_config,
                                               float* const* dest) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_StreamConfig");
+  if (capture_only_) {
+    return kUnsupportedFunctionError;
+  }
   rtc::CritScope cs(&crit_render_);
   RETURN_ON_ERR(AnalyzeReverseStreamLocked(src, input_config, output_config));
   if (submodule_states_.RenderMultiBandProcessingActive() ||
@@ -1479,6 +1528,9 @@ int AudioProcessingImpl::AnalyzeReverseStreamLocked(
 
 int AudioProcessingImpl::ProcessReverseStream(AudioFrame* frame) {
   TRACE_EVENT0("webrtc", "AudioProcessing::ProcessReverseStream_AudioFrame");
+  if (capture_only_) {
+    return kUnsupportedFunctionError;
+  }
   rtc::CritScope cs(&crit_render_);
   if (frame == nullptr) {
     return kNullPointerError;
@@ -1692,9 +1744,8 @@ AudioProcessing::AudioProcessingStatistics AudioProcessingImpl::GetStatistics()
         metrics.echo_return_loss_enhancement);
     stats.residual_echo_return_loss.Set(metrics.residual_echo_return_loss);
   }
-  {
+  if (private_submodules_->echo_detector) {
     rtc::CritScope cs_capture(&crit_capture_);
-    RTC_DCHECK(private_submodules_->echo_detector);
     auto ed_metrics = private_submodules_->echo_detector->GetMetrics();
     stats.residual_echo_likelihood = ed_metrics.echo_likelihood;
     stats.residual_echo_likelihood_recent_max =
@@ -1874,6 +1925,9 @@ void AudioProcessingImpl::InitializeEchoController() {
 
 void AudioProcessingImpl::InitializeGainController2() {
   if (config_.gain_controller2.enabled) {
+    if (!private_submodules_->gain_controller2) {
+      private_submodules_->gain_controller2.reset(new GainController2());
+    }
     private_submodules_->gain_controller2->Initialize(proc_sample_rate_hz());
   }
 }
@@ -1888,6 +1942,9 @@ void AudioProcessingImpl::InitializePreAmplifier() {
 }
 
 void AudioProcessingImpl::InitializeResidualEchoDetector() {
+  if (capture_only_ && !private_submodules_->echo_detector) {
+    return;
+  }
   RTC_DCHECK(private_submodules_->echo_detector);
   private_submodules_->echo_detector->Initialize(
       proc_sample_rate_hz(), 1,
@@ -39,13 +39,15 @@ class AudioProcessingImpl : public AudioProcessing {
   // Acquires both the render and capture locks.
   explicit AudioProcessingImpl(const webrtc::Config& config);
   // AudioProcessingImpl takes ownership of capture post processor and
-  // beamformer.
+  // beamformer. See AudioProcessingBuilder::SetCaptureOnly() for
+  // |capture_only|.
   AudioProcessingImpl(const webrtc::Config& config,
                       std::unique_ptr<CustomProcessing> capture_post_processor,
                       std::unique_ptr<CustomProcessing> render_pre_processor,
                       std::unique_ptr<EchoControlFactory> echo_control_factory,
                       std::unique_ptr<EchoDetector> echo_detector,
-                      NonlinearBeamformer* beamformer);
+                      NonlinearBeamformer* beamformer,
+                      bool capture_only = false);
   ~AudioProcessingImpl() override;
   int Initialize() override;
   int Initialize(int capture_input_sample_rate_hz,
@@ -174,6 +176,10 @@ class AudioProcessingImpl : public AudioProcessing {
   // EchoControl factory.
   std::unique_ptr<EchoControlFactory> echo_control_factory_;
 
+  // True if there is no render stream; see
+  // AudioProcessingBuilder::SetCaptureOnly().
+  const bool capture_only_;
+
   class ApmSubmoduleStates {
    public:
     ApmSubmoduleStates(bool capture_post_processor_enabled,
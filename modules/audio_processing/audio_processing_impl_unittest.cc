@@ -122,4 +122,47 @@ TEST(AudioProcessingImplTest, UpdateCapturePreGainRuntimeSetting) {
       << "Frame should be amplified.";
 }
 
+TEST(AudioProcessingImplTest, CaptureOnlyRejectsRenderStream) {
+  std::unique_ptr<AudioProcessing> apm(
+      AudioProcessingBuilder().SetCaptureOnly(true).Create());
+  ASSERT_TRUE(apm);
+
+  AudioFrame frame;
+  GenerateFixedFrame(1000, 16000, 1, &frame);
+  EXPECT_NOERR(apm->ProcessStream(&frame));
+  EXPECT_EQ(AudioProcessing::kUnsupportedFunctionError,
+            apm->ProcessReverseStream(&frame));
+
+  webrtc::AudioProcessing::Config apm_config;
+  apm_config.residual_echo_detector.enabled = true;
+  apm->ApplyConfig(apm_config);
+  EXPECT_NOERR(apm->ProcessStream(&frame));
+  EXPECT_FALSE(apm->GetStatistics(false).residual_echo_likelihood);
+}
+
+TEST(AudioProcessingImplTest, CaptureOnlyProcessesLikeFullApm) {
+  std::unique_ptr<AudioProcessing> full_apm(AudioProcessingBuilder().Create());
+  std::unique_ptr<AudioProcessing> capture_only_apm(
+      AudioProcessingBuilder().SetCaptureOnly(true).Create());
+  webrtc::AudioProcessing::Config apm_config;
+  apm_config.high_pass_filter.enabled = true;
+  apm_config.gain_controller2.enabled = true;
+  apm_config.gain_controller2.fixed_gain_db = 6.f;
+  for (AudioProcessing* apm : {full_apm.get(), capture_only_apm.get()}) {
+    apm->ApplyConfig(apm_config);
+    EXPECT_NOERR(apm->noise_suppression()->Enable(true));
+  }
+
+  for (int i = 0; i < 10; ++i) {
+    AudioFrame full_frame;
+    AudioFrame capture_only_frame;
+    GenerateFixedFrame(1000 * i, 48000, 1, &full_frame);
+    GenerateFixedFrame(1000 * i, 48000, 1, &capture_only_frame);
+    EXPECT_NOERR(full_apm->ProcessStream(&full_frame));
+    EXPECT_NOERR(capture_only_apm->ProcessStream(&capture_only_frame));
+    for (size_t j = 0; j < full_frame.samples_per_channel_; ++j)
+      EXPECT_EQ(full_frame.data()[j], capture_only_frame.data()[j]);
+  }
+}
+
 }  // namespace webrtc
@@ -679,6 +679,13 @@ class AudioProcessingBuilder {
   // The AudioProcessingBuilder takes ownership of the echo_detector.
   AudioProcessingBuilder& SetEchoDetector(
       std::unique_ptr<EchoDetector> echo_detector);
+  // Creates a lightweight APM without a render (reverse) stream, e.g. for
+  // server-side noise suppression of many streams from a single thread. The
+  // render buffers and queues are not allocated, gain controller 2 is only
+  // created when enabled, and the render stream functions return
+  // kUnsupportedFunctionError. Echo control and the residual echo detector,
+  // which need the render stream, are not available.
+  AudioProcessingBuilder& SetCaptureOnly(bool capture_only);
   // This creates an APM instance using the previously set components. Calling
   // the Create function resets the AudioProcessingBuilder to its initial state.
   AudioProcessing* Create();
@@ -690,6 +697,7 @@ class AudioProcessingBuilder {
   std::unique_ptr<CustomProcessing> render_pre_processing_;
   std::unique_ptr<NonlinearBeamformer> nonlinear_beamformer_;
   std::unique_ptr<EchoDetector> echo_detector_;
+  bool capture_only_ = false;
   RTC_DISALLOW_COPY_AND_ASSIGN(AudioProcessingBuilder);
 };
 
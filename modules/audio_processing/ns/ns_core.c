@@ -18,6 +18,130 @@
 #include "modules/audio_processing/ns/noise_suppression.h"
 #include "modules/audio_processing/ns/ns_core.h"
 #include "modules/audio_processing/ns/windows_private.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+// Declare function pointers.
+NsMagnitudeSpectrum WebRtcNs_MagnitudeSpectrum;
+NsUpdateQuantiles WebRtcNs_UpdateQuantiles;
+NsWienerFilter WebRtcNs_WienerFilter;
+
+void WebRtcNs_MagnitudeSpectrumC(const float* time_data,
+                                 size_t magnitude_length,
+                                 float* real,
+                                 float* imag,
+                                 float* magn) {
+  size_t i;
+
+  imag[0] = 0;
+  real[0] = time_data[0];
+  magn[0] = fabsf(real[0]) + 1.f;
+  imag[magnitude_length - 1] = 0;
+  real[magnitude_length - 1] = time_data[1];
+  magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
+  for (i = 1; i < magnitude_length - 1; ++i) {
+    real[i] = time_data[2 * i];
+    imag[i] = time_data[2 * i + 1];
+    // Magnitude spectrum.
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void WebRtcNs_UpdateQuantilesC(const float* lmagn,
+                               size_t magnitude_length,
+                               int counter,
+                               float* lquantile,
+                               float* density) {
+  size_t i;
+  float delta;
+
+  // newquantest(...)
+  for (i = 0; i < magnitude_length; i++) {
+    // Compute delta.
+    if (density[i] > 1.0) {
+      delta = FACTOR * 1.f / density[i];
+    } else {
+      delta = FACTOR;
+    }
+
+    // Update log quantile estimate.
+    if (lmagn[i] > lquantile[i]) {
+      lquantile[i] += QUANTILE * delta / (float)(counter + 1);
+    } else {
+      lquantile[i] -= (1.f - QUANTILE) * delta / (float)(counter + 1);
+    }
+
+    // Update density estimate.
+    if (fabs(lmagn[i] - lquantile[i]) < WIDTH) {
+      density[i] = ((float)counter * density[i] + 1.f / (2.f * WIDTH)) /
+                   (float)(counter + 1);
+    }
+  }  // End loop over magnitude spectrum.
+}
+
+void WebRtcNs_WienerFilterC(const float* magn,
+                            const float* noise,
+                            const float* magn_prev,
+                            const float* noise_prev,
+                            const float* smooth,
+                            float overdrive,
+                            float min_gain,
+                            size_t magnitude_length,
+                            float* theFilter) {
+  size_t i;
+  float snrPrior, previousEstimateStsa, currentEstimateStsa;
+
+  for (i = 0; i < magnitude_length; i++) {
+    // Previous estimate: based on previous frame with gain filter.
+    previousEstimateStsa = magn_prev[i] / (noise_prev[i] + 0.0001f) * smooth[i];
+    // Post and prior SNR.
+    currentEstimateStsa = 0.f;
+    if (magn[i] > noise[i]) {
+      currentEstimateStsa = magn[i] / (noise[i] + 0.0001f) - 1.f;
+    }
+    // DD estimate is sum of two terms: current estimate and previous estimate.
+    // Directed decision update of |snrPrior|.
+    snrPrior = DD_PR_SNR * previousEstimateStsa +
+               (1.f - DD_PR_SNR) * currentEstimateStsa;
+    // Gain filter.
+    theFilter[i] = snrPrior / (overdrive + snrPrior);
+    // Flooring bottom.
+    if (theFilter[i] < min_gain) {
+      theFilter[i] = min_gain;
+    }
+    // Flooring top.
+    if (theFilter[i] > 1.f) {
+      theFilter[i] = 1.f;
+    }
+  }  // End of loop over frequencies.
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// Initialize function pointers for x86 platforms, if the CPU supports SSE2 or
+// AVX2.
+static void WebRtcNs_InitX86(void) {
+#if !defined(__SSE2__)
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+#endif
+  WebRtcNs_MagnitudeSpectrum = WebRtcNs_MagnitudeSpectrumSSE2;
+  WebRtcNs_UpdateQuantiles = WebRtcNs_UpdateQuantilesSSE2;
+  WebRtcNs_WienerFilter = WebRtcNs_WienerFilterSSE2;
+  if (WebRtc_GetCPUInfo(kAVX2)) {
+    WebRtcNs_MagnitudeSpectrum = WebRtcNs_MagnitudeSpectrumAVX2;
+    WebRtcNs_UpdateQuantiles = WebRtcNs_UpdateQuantilesAVX2;
+    WebRtcNs_WienerFilter = WebRtcNs_WienerFilterAVX2;
+  }
+}
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// Initialize function pointers for ARM Neon platform.
+static void WebRtcNs_InitNeon(void) {
+  WebRtcNs_MagnitudeSpectrum = WebRtcNs_MagnitudeSpectrumNeon;
+  WebRtcNs_UpdateQuantiles = WebRtcNs_UpdateQuantilesNeon;
+  WebRtcNs_WienerFilter = WebRtcNs_WienerFilterNeon;
+}
+#endif
 
 // Set Feature Extraction Parameters.
 static void set_feature_extraction_parameters(NoiseSuppressionC* self) {
@@ -97,6 +221,19 @@ int WebRtcNs_InitCore(NoiseSuppressionC* self, uint32_t fs) {
   }
   self->magnLen = self->anaLen / 2 + 1;  // Number of frequency bins.
 
+  // Initialize function pointers.
+  WebRtcNs_MagnitudeSpectrum = WebRtcNs_MagnitudeSpectrumC;
+  WebRtcNs_UpdateQuantiles = WebRtcNs_UpdateQuantilesC;
+  WebRtcNs_WienerFilter = WebRtcNs_WienerFilterC;
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  WebRtcNs_InitX86();
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+  WebRtcNs_InitNeon();
+#endif
+
   // Initialize FFT work arrays.
   self->ip[0] = 0;  // Setting this triggers initialization.
   memset(self->dataBuf, 0, sizeof(float) * ANAL_BLOCKL_MAX);
@@ -220,7 +357,7 @@ static void NoiseEstimation(NoiseSuppressionC* self,
                             float* magn,
                             float* noise) {
   size_t i, s, offset;
-  float lmagn[HALF_ANAL_BLOCKL], delta;
+  float lmagn[HALF_ANAL_BLOCKL];
 
   if (self->updates < END_STARTUP_LONG) {
     self->updates++;
@@ -234,32 +371,8 @@ static void NoiseEstimation(NoiseSuppressionC* self,
   for (s = 0; s < SIMULT; s++) {
     offset = s * self->magnLen;
 
-    // newquantest(...)
-    for (i = 0; i < self->magnLen; i++) {
-      // Compute delta.
-      if (self->density[offset + i] > 1.0) {
-        delta = FACTOR * 1.f / self->density[offset + i];
-      } else {
-        delta = FACTOR;
-      }
-
-      // Update log quantile estimate.
-      if (lmagn[i] > self->lquantile[offset + i]) {
-        self->lquantile[offset + i] +=
-            QUANTILE * delta / (float)(self->counter[s] + 1);
-      } else {
-        self->lquantile[offset + i] -=
-            (1.f - QUANTILE) * delta / (float)(self->counter[s] + 1);
-      }
-
-      // Update density estimate.
-      if (fabs(lmagn[i] - self->lquantile[offset + i]) < WIDTH) {
-        self->density[offset + i] =
-            ((float)self->counter[s] * self->density[offset + i] +
-             1.f / (2.f * WIDTH)) /
-            (float)(self->counter[s] + 1);
-      }
-    }  // End loop over magnitude spectrum.
+    WebRtcNs_UpdateQuantiles(lmagn, self->magnLen, self->counter[s],
+                             &self->lquantile[offset], &self->density[offset]);
 
     if (self->counter[s] >= END_STARTUP_LONG) {
       self->counter[s] = 0;
@@ -893,24 +1006,11 @@ static void FFT(NoiseSuppressionC* self,
                 float* real,
                 float* imag,
                 float* magn) {
-  size_t i;
-
   RTC_DCHECK_EQ(magnitude_length, time_data_length / 2 + 1);
 
   WebRtc_rdft(time_data_length, 1, time_data, self->ip, self->wfft);
 
-  imag[0] = 0;
-  real[0] = time_data[0];
-  magn[0] = fabsf(real[0]) + 1.f;
-  imag[magnitude_length - 1] = 0;
-  real[magnitude_length - 1] = time_data[1];
-  magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
-  for (i = 1; i < magnitude_length - 1; ++i) {
-    real[i] = time_data[2 * i];
-    imag[i] = time_data[2 * i + 1];
-    // Magnitude spectrum.
-    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
-  }
+  WebRtcNs_MagnitudeSpectrum(time_data, magnitude_length, real, imag, magn);
 }
 
 // Transforms the signal from frequency to time domain.
@@ -980,35 +1080,6 @@ static void Windowing(const float* window,
   }
 }
 
-// Estimate prior SNR decision-directed and compute DD based Wiener Filter.
-// Input:
-//   * |magn| is the signal magnitude spectrum estimate.
-// Output:
-//   * |theFilter| is the frequency response of the computed Wiener filter.
-static void ComputeDdBasedWienerFilter(const NoiseSuppressionC* self,
-                                       const float* magn,
-                                       float* theFilter) {
-  size_t i;
-  float snrPrior, previousEstimateStsa, currentEstimateStsa;
-
-  for (i = 0; i < self->magnLen; i++) {
-    // Previous estimate: based on previous frame with gain filter.
-    previousEstimateStsa = self->magnPrevProcess[i] /
-                           (self->noisePrev[i] + 0.0001f) * self->smooth[i];
-    // Post and prior SNR.
-    currentEstimateStsa = 0.f;
-    if (magn[i] > self->noise[i]) {
-      currentEstimateStsa = magn[i] / (self->noise[i] + 0.0001f) - 1.f;
-    }
-    // DD estimate is sum of two terms: current estimate and previous estimate.
-    // Directed decision update of |snrPrior|.
-    snrPrior = DD_PR_SNR * previousEstimateStsa +
-               (1.f - DD_PR_SNR) * currentEstimateStsa;
-    // Gain filter.
-    theFilter[i] = snrPrior / (self->overdrive + snrPrior);
-  }  // End of loop over frequencies.
-}
-
 // Changes the aggressiveness of the noise suppression method.
 // |mode| = 0 is mild (6dB), |mode| = 1 is medium (10dB) and |mode| = 2 is
 // aggressive (15dB).
@@ -1275,17 +1346,12 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
     }
   }
 
-  ComputeDdBasedWienerFilter(self, magn, theFilter);
+  // Estimate prior SNR decision-directed and compute DD based Wiener Filter.
+  WebRtcNs_WienerFilter(magn, self->noise, self->magnPrevProcess,
+                        self->noisePrev, self->smooth, self->overdrive,
+                        self->denoiseBound, self->magnLen, theFilter);
 
   for (i = 0; i < self->magnLen; i++) {
-    // Flooring bottom.
-    if (theFilter[i] < self->denoiseBound) {
-      theFilter[i] = self->denoiseBound;
-    }
-    // Flooring top.
-    if (theFilter[i] > 1.f) {
-      theFilter[i] = 1.f;
-    }
     if (self->blockInd < END_STARTUP_SHORT) {
       theFilterTmp[i] =
           (self->initMagnEst[i] - self->overdrive * self->parametricNoise[i]);
@@ -11,7 +11,10 @@
 #ifndef MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 #define MODULES_AUDIO_PROCESSING_NS_NS_CORE_H_
 
+#include <stddef.h>
+
 #include "modules/audio_processing/ns/defines.h"
+#include "typedefs.h"  // NOLINT(build/include)
 
 typedef struct NSParaExtract_ {
   // Bin size of histogram.
@@ -183,6 +186,130 @@ void WebRtcNs_ProcessCore(NoiseSuppressionC* self,
                           size_t num_bands,
                           float* const* outFrame);
 
+/****************************************************************************
+ * Some function pointers, for internal functions shared by the SIMD and
+ * generic C code.
+ */
+// Computes the real and imaginary parts and the magnitude of the spectrum from
+// the WebRtc_rdft() output |time_data|.
+typedef void (*NsMagnitudeSpectrum)(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn);
+extern NsMagnitudeSpectrum WebRtcNs_MagnitudeSpectrum;
+
+// Updates the log quantile |lquantile| and the density |density| of one of the
+// simultaneous quantile estimates with the log magnitude spectrum |lmagn|.
+typedef void (*NsUpdateQuantiles)(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density);
+extern NsUpdateQuantiles WebRtcNs_UpdateQuantiles;
+
+// Estimates the prior SNR decision-directed and computes the DD based Wiener
+// filter |filter|, floored to the range [|min_gain|, 1].
+typedef void (*NsWienerFilter)(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter);
+extern NsWienerFilter WebRtcNs_WienerFilter;
+
+// The generic versions of the above function pointers, defined in ns_core.c.
+void WebRtcNs_MagnitudeSpectrumC(const float* time_data,
+                                 size_t magnitude_length,
+                                 float* real,
+                                 float* imag,
+                                 float* magn);
+void WebRtcNs_UpdateQuantilesC(const float* lmagn,
+                               size_t magnitude_length,
+                               int counter,
+                               float* lquantile,
+                               float* density);
+void WebRtcNs_WienerFilterC(const float* magn,
+                            const float* noise,
+                            const float* magn_prev,
+                            const float* noise_prev,
+                            const float* smooth,
+                            float overdrive,
+                            float min_gain,
+                            size_t magnitude_length,
+                            float* filter);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+// The x86 versions, defined in files ns_core_sse2.c and ns_core_avx2.c. They
+// are bit exact with the generic versions.
+void WebRtcNs_MagnitudeSpectrumSSE2(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn);
+void WebRtcNs_UpdateQuantilesSSE2(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density);
+void WebRtcNs_WienerFilterSSE2(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter);
+void WebRtcNs_MagnitudeSpectrumAVX2(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn);
+void WebRtcNs_UpdateQuantilesAVX2(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density);
+void WebRtcNs_WienerFilterAVX2(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter);
+#endif
+
+#if defined(WEBRTC_HAS_NEON)
+// The ARM Neon versions, defined in file ns_core_neon.c. On 32-bit ARM, the
+// divisions and square roots are Newton-Raphson refined estimates and hence
+// not bit exact with the generic versions.
+void WebRtcNs_MagnitudeSpectrumNeon(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn);
+void WebRtcNs_UpdateQuantilesNeon(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density);
+void WebRtcNs_WienerFilterNeon(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,158 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_core.h"
+
+#include <immintrin.h>
+#include <math.h>
+
+// The AVX2 versions process eight bins at a time and leave the remaining bins
+// to the SSE2 versions, which are bit exact with them.
+
+void WebRtcNs_MagnitudeSpectrumAVX2(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  size_t i;
+
+  imag[0] = 0;
+  real[0] = time_data[0];
+  magn[0] = fabsf(real[0]) + 1.f;
+  imag[magnitude_length - 1] = 0;
+  real[magnitude_length - 1] = time_data[1];
+  magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
+  for (i = 1; i + 8 <= magnitude_length - 1; i += 8) {
+    // Deinterleave eight complex values. The shuffles work within 128-bit
+    // lanes, so the result is reordered across lanes afterwards.
+    const __m256 a = _mm256_loadu_ps(&time_data[2 * i]);
+    const __m256 b = _mm256_loadu_ps(&time_data[2 * i + 8]);
+    const __m256 re = _mm256_castpd_ps(_mm256_permute4x64_pd(
+        _mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))),
+        _MM_SHUFFLE(3, 1, 2, 0)));
+    const __m256 im = _mm256_castpd_ps(_mm256_permute4x64_pd(
+        _mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))),
+        _MM_SHUFFLE(3, 1, 2, 0)));
+    const __m256 re2 = _mm256_mul_ps(re, re);
+    const __m256 im2 = _mm256_mul_ps(im, im);
+    _mm256_storeu_ps(&real[i], re);
+    _mm256_storeu_ps(&imag[i], im);
+    _mm256_storeu_ps(&magn[i], _mm256_add_ps(
+                                   _mm256_sqrt_ps(_mm256_add_ps(re2, im2)),
+                                   one));
+  }
+  for (; i < magnitude_length - 1; ++i) {
+    real[i] = time_data[2 * i];
+    imag[i] = time_data[2 * i + 1];
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void WebRtcNs_UpdateQuantilesAVX2(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 factor = _mm256_set1_ps(FACTOR);
+  const __m256 quantile_up = _mm256_set1_ps(QUANTILE);
+  const __m256 quantile_down = _mm256_set1_ps(1.f - QUANTILE);
+  const __m256 width = _mm256_set1_ps(WIDTH);
+  const __m256 density_increment = _mm256_set1_ps(1.f / (2.f * WIDTH));
+  const __m256 counter_256 = _mm256_set1_ps((float)counter);
+  const __m256 counter_plus_one = _mm256_set1_ps((float)(counter + 1));
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  size_t i;
+
+  for (i = 0; i + 8 <= magnitude_length; i += 8) {
+    const __m256 lmagn_i = _mm256_loadu_ps(&lmagn[i]);
+    __m256 lquantile_i = _mm256_loadu_ps(&lquantile[i]);
+    __m256 density_i = _mm256_loadu_ps(&density[i]);
+
+    // Compute delta.
+    const __m256 delta =
+        _mm256_blendv_ps(factor, _mm256_div_ps(factor, density_i),
+                         _mm256_cmp_ps(density_i, one, _CMP_GT_OQ));
+
+    // Update log quantile estimate.
+    const __m256 up =
+        _mm256_div_ps(_mm256_mul_ps(quantile_up, delta), counter_plus_one);
+    const __m256 down =
+        _mm256_div_ps(_mm256_mul_ps(quantile_down, delta), counter_plus_one);
+    lquantile_i =
+        _mm256_blendv_ps(_mm256_sub_ps(lquantile_i, down),
+                         _mm256_add_ps(lquantile_i, up),
+                         _mm256_cmp_ps(lmagn_i, lquantile_i, _CMP_GT_OQ));
+
+    // Update density estimate.
+    const __m256 distance =
+        _mm256_and_ps(_mm256_sub_ps(lmagn_i, lquantile_i), abs_mask);
+    const __m256 updated_density = _mm256_div_ps(
+        _mm256_add_ps(_mm256_mul_ps(counter_256, density_i), density_increment),
+        counter_plus_one);
+    density_i = _mm256_blendv_ps(density_i, updated_density,
+                                 _mm256_cmp_ps(distance, width, _CMP_LT_OQ));
+
+    _mm256_storeu_ps(&lquantile[i], lquantile_i);
+    _mm256_storeu_ps(&density[i], density_i);
+  }
+
+  WebRtcNs_UpdateQuantilesSSE2(&lmagn[i], magnitude_length - i, counter,
+                               &lquantile[i], &density[i]);
+}
+
+void WebRtcNs_WienerFilterAVX2(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter) {
+  const __m256 one = _mm256_set1_ps(1.f);
+  const __m256 regularizer = _mm256_set1_ps(0.0001f);
+  const __m256 dd_weight = _mm256_set1_ps(DD_PR_SNR);
+  const __m256 current_weight = _mm256_set1_ps(1.f - DD_PR_SNR);
+  const __m256 overdrive_256 = _mm256_set1_ps(overdrive);
+  const __m256 min_gain_256 = _mm256_set1_ps(min_gain);
+  size_t i;
+
+  for (i = 0; i + 8 <= magnitude_length; i += 8) {
+    const __m256 magn_i = _mm256_loadu_ps(&magn[i]);
+    const __m256 noise_i = _mm256_loadu_ps(&noise[i]);
+
+    // Previous estimate: based on previous frame with gain filter.
+    const __m256 previous_estimate = _mm256_mul_ps(
+        _mm256_div_ps(
+            _mm256_loadu_ps(&magn_prev[i]),
+            _mm256_add_ps(_mm256_loadu_ps(&noise_prev[i]), regularizer)),
+        _mm256_loadu_ps(&smooth[i]));
+    // Post and prior SNR.
+    const __m256 current_estimate = _mm256_and_ps(
+        _mm256_cmp_ps(magn_i, noise_i, _CMP_GT_OQ),
+        _mm256_sub_ps(_mm256_div_ps(magn_i, _mm256_add_ps(noise_i, regularizer)),
+                      one));
+    // Directed decision update of the prior SNR.
+    const __m256 snr_prior =
+        _mm256_add_ps(_mm256_mul_ps(dd_weight, previous_estimate),
+                      _mm256_mul_ps(current_weight, current_estimate));
+    // Gain filter, floored to [min_gain, 1].
+    __m256 gain =
+        _mm256_div_ps(snr_prior, _mm256_add_ps(overdrive_256, snr_prior));
+    gain = _mm256_min_ps(_mm256_max_ps(gain, min_gain_256), one);
+    _mm256_storeu_ps(&filter[i], gain);
+  }
+
+  WebRtcNs_WienerFilterSSE2(&magn[i], &noise[i], &magn_prev[i], &noise_prev[i],
+                            &smooth[i], overdrive, min_gain,
+                            magnitude_length - i, &filter[i]);
+}
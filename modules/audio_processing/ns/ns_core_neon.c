@@ -0,0 +1,211 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_core.h"
+
+#include <arm_neon.h>
+#include <math.h>
+
+// ARM64's arm_neon.h has already defined vdivq_f32 vsqrtq_f32.
+#if !defined(WEBRTC_ARCH_ARM64)
+static float32x4_t vdivq_f32(float32x4_t a, float32x4_t b) {
+  int i;
+  float32x4_t x = vrecpeq_f32(b);
+  // from arm documentation
+  // The Newton-Raphson iteration:
+  //     x[n+1] = x[n] * (2 - d * x[n])
+  // converges to (1/d) if x0 is the result of VRECPE applied to d.
+  //
+  // Note: The precision did not improve after 2 iterations.
+  for (i = 0; i < 2; i++) {
+    x = vmulq_f32(vrecpsq_f32(b, x), x);
+  }
+  // a/b = a*(1/b)
+  return vmulq_f32(a, x);
+}
+
+static float32x4_t vsqrtq_f32(float32x4_t s) {
+  int i;
+  float32x4_t x = vrsqrteq_f32(s);
+
+  // Code to handle sqrt(0).
+  // If the input to sqrtf() is zero, a zero will be returned.
+  // If the input to vrsqrteq_f32() is zero, positive infinity is returned.
+  const uint32x4_t vec_p_inf = vdupq_n_u32(0x7F800000);
+  // check for divide by zero
+  const uint32x4_t div_by_zero = vceqq_u32(vec_p_inf, vreinterpretq_u32_f32(x));
+  // zero out the positive infinity results
+  x = vreinterpretq_f32_u32(
+      vandq_u32(vmvnq_u32(div_by_zero), vreinterpretq_u32_f32(x)));
+  // from arm documentation
+  // The Newton-Raphson iteration:
+  //     x[n+1] = x[n] * (3 - d * (x[n] * x[n])) / 2)
+  // converges to (1/√d) if x0 is the result of VRSQRTE applied to d.
+  //
+  // Note: The precision did not improve after 2 iterations.
+  for (i = 0; i < 2; i++) {
+    x = vmulq_f32(vrsqrtsq_f32(vmulq_f32(x, x), s), x);
+  }
+  // sqrt(s) = s * 1/sqrt(s)
+  return vmulq_f32(s, x);
+}
+#endif  // WEBRTC_ARCH_ARM64
+
+void WebRtcNs_MagnitudeSpectrumNeon(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  size_t i;
+
+  imag[0] = 0;
+  real[0] = time_data[0];
+  magn[0] = fabsf(real[0]) + 1.f;
+  imag[magnitude_length - 1] = 0;
+  real[magnitude_length - 1] = time_data[1];
+  magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
+  for (i = 1; i + 4 <= magnitude_length - 1; i += 4) {
+    // Deinterleave four complex values.
+    const float32x4x2_t x = vld2q_f32(&time_data[2 * i]);
+    const float32x4_t power =
+        vaddq_f32(vmulq_f32(x.val[0], x.val[0]), vmulq_f32(x.val[1], x.val[1]));
+    vst1q_f32(&real[i], x.val[0]);
+    vst1q_f32(&imag[i], x.val[1]);
+    vst1q_f32(&magn[i], vaddq_f32(vsqrtq_f32(power), one));
+  }
+  for (; i < magnitude_length - 1; ++i) {
+    real[i] = time_data[2 * i];
+    imag[i] = time_data[2 * i + 1];
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void WebRtcNs_UpdateQuantilesNeon(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density) {
+  const float counter_plus_one = (float)(counter + 1);
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t factor = vdupq_n_f32(FACTOR);
+  const float32x4_t width = vdupq_n_f32(WIDTH);
+  const float32x4_t density_increment = vdupq_n_f32(1.f / (2.f * WIDTH));
+  const float32x4_t counter_128 = vdupq_n_f32((float)counter);
+  const float32x4_t counter_plus_one_128 = vdupq_n_f32(counter_plus_one);
+  const float32x4_t quantile_up = vdupq_n_f32(QUANTILE);
+  const float32x4_t quantile_down = vdupq_n_f32(1.f - QUANTILE);
+  size_t i;
+
+  for (i = 0; i + 4 <= magnitude_length; i += 4) {
+    const float32x4_t lmagn_i = vld1q_f32(&lmagn[i]);
+    float32x4_t lquantile_i = vld1q_f32(&lquantile[i]);
+    float32x4_t density_i = vld1q_f32(&density[i]);
+
+    // Compute delta.
+    const float32x4_t delta = vbslq_f32(vcgtq_f32(density_i, one),
+                                        vdivq_f32(factor, density_i), factor);
+
+    // Update log quantile estimate.
+    const float32x4_t up =
+        vdivq_f32(vmulq_f32(quantile_up, delta), counter_plus_one_128);
+    const float32x4_t down =
+        vdivq_f32(vmulq_f32(quantile_down, delta), counter_plus_one_128);
+    lquantile_i = vbslq_f32(vcgtq_f32(lmagn_i, lquantile_i),
+                            vaddq_f32(lquantile_i, up),
+                            vsubq_f32(lquantile_i, down));
+
+    // Update density estimate.
+    const float32x4_t updated_density = vdivq_f32(
+        vaddq_f32(vmulq_f32(counter_128, density_i), density_increment),
+        counter_plus_one_128);
+    density_i = vbslq_f32(vcltq_f32(vabdq_f32(lmagn_i, lquantile_i), width),
+                          updated_density, density_i);
+
+    vst1q_f32(&lquantile[i], lquantile_i);
+    vst1q_f32(&density[i], density_i);
+  }
+
+  for (; i < magnitude_length; ++i) {
+    const float delta = density[i] > 1.f ? FACTOR / density[i] : FACTOR;
+    if (lmagn[i] > lquantile[i]) {
+      lquantile[i] += QUANTILE * delta / counter_plus_one;
+    } else {
+      lquantile[i] -= (1.f - QUANTILE) * delta / counter_plus_one;
+    }
+    if (fabsf(lmagn[i] - lquantile[i]) < WIDTH) {
+      density[i] = ((float)counter * density[i] + 1.f / (2.f * WIDTH)) /
+                   counter_plus_one;
+    }
+  }
+}
+
+void WebRtcNs_WienerFilterNeon(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter) {
+  const float32x4_t one = vdupq_n_f32(1.f);
+  const float32x4_t regularizer = vdupq_n_f32(0.0001f);
+  const float32x4_t dd_weight = vdupq_n_f32(DD_PR_SNR);
+  const float32x4_t current_weight = vdupq_n_f32(1.f - DD_PR_SNR);
+  const float32x4_t overdrive_128 = vdupq_n_f32(overdrive);
+  const float32x4_t min_gain_128 = vdupq_n_f32(min_gain);
+  const float32x4_t zero = vdupq_n_f32(0.f);
+  size_t i;
+
+  for (i = 0; i + 4 <= magnitude_length; i += 4) {
+    const float32x4_t magn_i = vld1q_f32(&magn[i]);
+    const float32x4_t noise_i = vld1q_f32(&noise[i]);
+
+    // Previous estimate: based on previous frame with gain filter.
+    const float32x4_t previous_estimate = vmulq_f32(
+        vdivq_f32(vld1q_f32(&magn_prev[i]),
+                  vaddq_f32(vld1q_f32(&noise_prev[i]), regularizer)),
+        vld1q_f32(&smooth[i]));
+    // Post and prior SNR.
+    const float32x4_t current_estimate = vbslq_f32(
+        vcgtq_f32(magn_i, noise_i),
+        vsubq_f32(vdivq_f32(magn_i, vaddq_f32(noise_i, regularizer)), one),
+        zero);
+    // Directed decision update of the prior SNR.
+    const float32x4_t snr_prior =
+        vaddq_f32(vmulq_f32(dd_weight, previous_estimate),
+                  vmulq_f32(current_weight, current_estimate));
+    // Gain filter, floored to [min_gain, 1].
+    float32x4_t gain =
+        vdivq_f32(snr_prior, vaddq_f32(overdrive_128, snr_prior));
+    gain = vminq_f32(vmaxq_f32(gain, min_gain_128), one);
+    vst1q_f32(&filter[i], gain);
+  }
+
+  for (; i < magnitude_length; ++i) {
+    const float previous_estimate =
+        magn_prev[i] / (noise_prev[i] + 0.0001f) * smooth[i];
+    float current_estimate = 0.f;
+    float snr_prior;
+    if (magn[i] > noise[i]) {
+      current_estimate = magn[i] / (noise[i] + 0.0001f) - 1.f;
+    }
+    snr_prior =
+        DD_PR_SNR * previous_estimate + (1.f - DD_PR_SNR) * current_estimate;
+    filter[i] = snr_prior / (overdrive + snr_prior);
+    if (filter[i] < min_gain) {
+      filter[i] = min_gain;
+    }
+    if (filter[i] > 1.f) {
+      filter[i] = 1.f;
+    }
+  }
+}
@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_core.h"
+
+#include <emmintrin.h>
+#include <math.h>
+
+// Returns |a| where |mask| is set and |b| elsewhere.
+static inline __m128 Select(__m128 mask, __m128 a, __m128 b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+void WebRtcNs_MagnitudeSpectrumSSE2(const float* time_data,
+                                    size_t magnitude_length,
+                                    float* real,
+                                    float* imag,
+                                    float* magn) {
+  const __m128 one = _mm_set1_ps(1.f);
+  size_t i;
+
+  imag[0] = 0;
+  real[0] = time_data[0];
+  magn[0] = fabsf(real[0]) + 1.f;
+  imag[magnitude_length - 1] = 0;
+  real[magnitude_length - 1] = time_data[1];
+  magn[magnitude_length - 1] = fabsf(real[magnitude_length - 1]) + 1.f;
+  for (i = 1; i + 4 <= magnitude_length - 1; i += 4) {
+    // Deinterleave four complex values.
+    const __m128 a = _mm_loadu_ps(&time_data[2 * i]);
+    const __m128 b = _mm_loadu_ps(&time_data[2 * i + 4]);
+    const __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 re2 = _mm_mul_ps(re, re);
+    const __m128 im2 = _mm_mul_ps(im, im);
+    _mm_storeu_ps(&real[i], re);
+    _mm_storeu_ps(&imag[i], im);
+    _mm_storeu_ps(&magn[i],
+                  _mm_add_ps(_mm_sqrt_ps(_mm_add_ps(re2, im2)), one));
+  }
+  for (; i < magnitude_length - 1; ++i) {
+    real[i] = time_data[2 * i];
+    imag[i] = time_data[2 * i + 1];
+    magn[i] = sqrtf(real[i] * real[i] + imag[i] * imag[i]) + 1.f;
+  }
+}
+
+void WebRtcNs_UpdateQuantilesSSE2(const float* lmagn,
+                                  size_t magnitude_length,
+                                  int counter,
+                                  float* lquantile,
+                                  float* density) {
+  const float counter_plus_one = (float)(counter + 1);
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 factor = _mm_set1_ps(FACTOR);
+  const __m128 quantile_up = _mm_set1_ps(QUANTILE);
+  const __m128 quantile_down = _mm_set1_ps(1.f - QUANTILE);
+  const __m128 width = _mm_set1_ps(WIDTH);
+  const __m128 density_increment = _mm_set1_ps(1.f / (2.f * WIDTH));
+  const __m128 counter_128 = _mm_set1_ps((float)counter);
+  const __m128 counter_plus_one_128 = _mm_set1_ps(counter_plus_one);
+  const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+  size_t i;
+
+  for (i = 0; i + 4 <= magnitude_length; i += 4) {
+    const __m128 lmagn_i = _mm_loadu_ps(&lmagn[i]);
+    __m128 lquantile_i = _mm_loadu_ps(&lquantile[i]);
+    __m128 density_i = _mm_loadu_ps(&density[i]);
+
+    // Compute delta.
+    const __m128 delta =
+        Select(_mm_cmpgt_ps(density_i, one), _mm_div_ps(factor, density_i),
+               factor);
+
+    // Update log quantile estimate.
+    const __m128 up =
+        _mm_div_ps(_mm_mul_ps(quantile_up, delta), counter_plus_one_128);
+    const __m128 down =
+        _mm_div_ps(_mm_mul_ps(quantile_down, delta), counter_plus_one_128);
+    lquantile_i = Select(_mm_cmpgt_ps(lmagn_i, lquantile_i),
+                         _mm_add_ps(lquantile_i, up),
+                         _mm_sub_ps(lquantile_i, down));
+
+    // Update density estimate.
+    const __m128 distance =
+        _mm_and_ps(_mm_sub_ps(lmagn_i, lquantile_i), abs_mask);
+    const __m128 updated_density = _mm_div_ps(
+        _mm_add_ps(_mm_mul_ps(counter_128, density_i), density_increment),
+        counter_plus_one_128);
+    density_i =
+        Select(_mm_cmplt_ps(distance, width), updated_density, density_i);
+
+    _mm_storeu_ps(&lquantile[i], lquantile_i);
+    _mm_storeu_ps(&density[i], density_i);
+  }
+
+  for (; i < magnitude_length; ++i) {
+    const float delta = density[i] > 1.f ? FACTOR / density[i] : FACTOR;
+    if (lmagn[i] > lquantile[i]) {
+      lquantile[i] += QUANTILE * delta / counter_plus_one;
+    } else {
+      lquantile[i] -= (1.f - QUANTILE) * delta / counter_plus_one;
+    }
+    if (fabsf(lmagn[i] - lquantile[i]) < WIDTH) {
+      density[i] = ((float)counter * density[i] + 1.f / (2.f * WIDTH)) /
+                   counter_plus_one;
+    }
+  }
+}
+
+void WebRtcNs_WienerFilterSSE2(const float* magn,
+                               const float* noise,
+                               const float* magn_prev,
+                               const float* noise_prev,
+                               const float* smooth,
+                               float overdrive,
+                               float min_gain,
+                               size_t magnitude_length,
+                               float* filter) {
+  const __m128 one = _mm_set1_ps(1.f);
+  const __m128 regularizer = _mm_set1_ps(0.0001f);
+  const __m128 dd_weight = _mm_set1_ps(DD_PR_SNR);
+  const __m128 current_weight = _mm_set1_ps(1.f - DD_PR_SNR);
+  const __m128 overdrive_128 = _mm_set1_ps(overdrive);
+  const __m128 min_gain_128 = _mm_set1_ps(min_gain);
+  size_t i;
+
+  for (i = 0; i + 4 <= magnitude_length; i += 4) {
+    const __m128 magn_i = _mm_loadu_ps(&magn[i]);
+    const __m128 noise_i = _mm_loadu_ps(&noise[i]);
+
+    // Previous estimate: based on previous frame with gain filter.
+    const __m128 previous_estimate = _mm_mul_ps(
+        _mm_div_ps(_mm_loadu_ps(&magn_prev[i]),
+                   _mm_add_ps(_mm_loadu_ps(&noise_prev[i]), regularizer)),
+        _mm_loadu_ps(&smooth[i]));
+    // Post and prior SNR.
+    const __m128 current_estimate = _mm_and_ps(
+        _mm_cmpgt_ps(magn_i, noise_i),
+        _mm_sub_ps(_mm_div_ps(magn_i, _mm_add_ps(noise_i, regularizer)), one));
+    // Directed decision update of the prior SNR.
+    const __m128 snr_prior =
+        _mm_add_ps(_mm_mul_ps(dd_weight, previous_estimate),
+                   _mm_mul_ps(current_weight, current_estimate));
+    // Gain filter, floored to [min_gain, 1].
+    __m128 gain = _mm_div_ps(snr_prior, _mm_add_ps(overdrive_128, snr_prior));
+    gain = _mm_min_ps(_mm_max_ps(gain, min_gain_128), one);
+    _mm_storeu_ps(&filter[i], gain);
+  }
+
+  for (; i < magnitude_length; ++i) {
+    const float previous_estimate =
+        magn_prev[i] / (noise_prev[i] + 0.0001f) * smooth[i];
+    float current_estimate = 0.f;
+    float snr_prior;
+    if (magn[i] > noise[i]) {
+      current_estimate = magn[i] / (noise[i] + 0.0001f) - 1.f;
+    }
+    snr_prior =
+        DD_PR_SNR * previous_estimate + (1.f - DD_PR_SNR) * current_estimate;
+    filter[i] = snr_prior / (overdrive + snr_prior);
+    if (filter[i] < min_gain) {
+      filter[i] = min_gain;
+    }
+    if (filter[i] > 1.f) {
+      filter[i] = 1.f;
+    }
+  }
+}
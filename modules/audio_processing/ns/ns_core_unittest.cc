@@ -0,0 +1,259 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/ns/ns_core.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "modules/audio_processing/ns/noise_suppression.h"
+#include "modules/audio_processing/test/performance_timer.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+struct NsKernels {
+  const char* name;
+  NsMagnitudeSpectrum magnitude_spectrum;
+  NsUpdateQuantiles update_quantiles;
+  NsWienerFilter wiener_filter;
+  // Whether the kernels are bit exact with the generic versions.
+  bool bitexact;
+};
+
+const NsKernels kGenericKernels = {"C", WebRtcNs_MagnitudeSpectrumC,
+                                   WebRtcNs_UpdateQuantilesC,
+                                   WebRtcNs_WienerFilterC, true};
+
+// Returns the optimized kernels supported by the CPU.
+std::vector<NsKernels> OptimizedKernels() {
+  std::vector<NsKernels> kernels;
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2) != 0) {
+    kernels.push_back({"SSE2", WebRtcNs_MagnitudeSpectrumSSE2,
+                       WebRtcNs_UpdateQuantilesSSE2, WebRtcNs_WienerFilterSSE2,
+                       true});
+  }
+  if (WebRtc_GetCPUInfo(kAVX2) != 0) {
+    kernels.push_back({"AVX2", WebRtcNs_MagnitudeSpectrumAVX2,
+                       WebRtcNs_UpdateQuantilesAVX2, WebRtcNs_WienerFilterAVX2,
+                       true});
+  }
+#endif
+#if defined(WEBRTC_HAS_NEON)
+  kernels.push_back({"NEON", WebRtcNs_MagnitudeSpectrumNeon,
+                     WebRtcNs_UpdateQuantilesNeon, WebRtcNs_WienerFilterNeon,
+                     false});
+#endif
+  return kernels;
+}
+
+void SetKernels(const NsKernels& kernels) {
+  WebRtcNs_MagnitudeSpectrum = kernels.magnitude_spectrum;
+  WebRtcNs_UpdateQuantiles = kernels.update_quantiles;
+  WebRtcNs_WienerFilter = kernels.wiener_filter;
+}
+
+void FillRandom(Random* random_generator,
+                float min_value,
+                float max_value,
+                std::vector<float>* v) {
+  for (float& v_k : *v) {
+    v_k = min_value + (max_value - min_value) * random_generator->Rand<float>();
+  }
+}
+
+void ExpectEqual(const std::vector<float>& reference,
+                 const std::vector<float>& v,
+                 bool bitexact) {
+  ASSERT_EQ(reference.size(), v.size());
+  for (size_t k = 0; k < v.size(); ++k) {
+    if (bitexact) {
+      EXPECT_EQ(reference[k], v[k]) << "at index " << k;
+    } else {
+      EXPECT_NEAR(reference[k], v[k], 1e-4f * std::max(1.f, fabsf(reference[k])))
+          << "at index " << k;
+    }
+  }
+}
+
+// Runs the noise suppressor on a noisy tone and returns the output.
+std::vector<float> SuppressNoise(int sample_rate_hz,
+                                 size_t num_frames,
+                                 const NsKernels& kernels,
+                                 test::PerformanceTimer* timer) {
+  const size_t frame_length = sample_rate_hz == 8000 ? 80 : 160;
+  NsHandle* ns = WebRtcNs_Create();
+  EXPECT_EQ(0, WebRtcNs_Init(ns, sample_rate_hz));
+  EXPECT_EQ(0, WebRtcNs_set_policy(ns, 2));
+  // WebRtcNs_Init() sets up the kernels supported by the CPU.
+  SetKernels(kernels);
+
+  Random random_generator(42U);
+  std::vector<float> frame(frame_length);
+  std::vector<float> output;
+  for (size_t k = 0; k < num_frames; ++k) {
+    for (size_t j = 0; j < frame_length; ++j) {
+      const size_t n = k * frame_length + j;
+      const float tone = (k / 100) % 2 == 0 ? 0.f : 5000.f * sinf(0.1f * n);
+      frame[j] = tone + 500.f * (random_generator.Rand<float>() - 0.5f);
+    }
+    const float* input_bands[] = {frame.data()};
+    std::vector<float> output_frame(frame_length);
+    float* output_bands[] = {output_frame.data()};
+    if (timer) {
+      timer->StartTimer();
+    }
+    WebRtcNs_Analyze(ns, frame.data());
+    WebRtcNs_Process(ns, input_bands, 1, output_bands);
+    if (timer) {
+      timer->StopTimer();
+    }
+    output.insert(output.end(), output_frame.begin(), output_frame.end());
+  }
+  WebRtcNs_Free(ns);
+  return output;
+}
+
+}  // namespace
+
+// Verifies that the optimized magnitude spectrum computations match the
+// generic one.
+TEST(NsCore, MagnitudeSpectrum) {
+  Random random_generator(42U);
+  for (size_t magnitude_length : {65, 129}) {
+    std::vector<float> time_data(2 * (magnitude_length - 1));
+    FillRandom(&random_generator, -32768.f, 32767.f, &time_data);
+    std::vector<float> real(magnitude_length);
+    std::vector<float> imag(magnitude_length);
+    std::vector<float> magn(magnitude_length);
+    WebRtcNs_MagnitudeSpectrumC(time_data.data(), magnitude_length,
+                                real.data(), imag.data(), magn.data());
+    for (const auto& kernels : OptimizedKernels()) {
+      SCOPED_TRACE(kernels.name);
+      std::vector<float> real_opt(magnitude_length);
+      std::vector<float> imag_opt(magnitude_length);
+      std::vector<float> magn_opt(magnitude_length);
+      kernels.magnitude_spectrum(time_data.data(), magnitude_length,
+                                 real_opt.data(), imag_opt.data(),
+                                 magn_opt.data());
+      ExpectEqual(real, real_opt, true);
+      ExpectEqual(imag, imag_opt, true);
+      ExpectEqual(magn, magn_opt, kernels.bitexact);
+    }
+  }
+}
+
+// Verifies that the optimized quantile updates match the generic one.
+TEST(NsCore, UpdateQuantiles) {
+  Random random_generator(42U);
+  for (size_t magnitude_length : {65, 129}) {
+    for (int counter : {0, 1, 17, 199}) {
+      std::vector<float> lmagn(magnitude_length);
+      std::vector<float> lquantile(magnitude_length);
+      std::vector<float> density(magnitude_length);
+      FillRandom(&random_generator, -2.f, 10.f, &lmagn);
+      FillRandom(&random_generator, 0.f, 3.f, &density);
+      // Let every other quantile be close to the magnitude, for the density
+      // estimate to be updated.
+      for (size_t k = 0; k < magnitude_length; ++k) {
+        lquantile[k] = k % 2 == 0
+                           ? lmagn[k] + 0.02f * (random_generator.Rand<float>() -
+                                                 0.5f)
+                           : 8.f * random_generator.Rand<float>();
+      }
+
+      std::vector<float> lquantile_ref = lquantile;
+      std::vector<float> density_ref = density;
+      WebRtcNs_UpdateQuantilesC(lmagn.data(), magnitude_length, counter,
+                                lquantile_ref.data(), density_ref.data());
+      for (const auto& kernels : OptimizedKernels()) {
+        SCOPED_TRACE(kernels.name);
+        std::vector<float> lquantile_opt = lquantile;
+        std::vector<float> density_opt = density;
+        kernels.update_quantiles(lmagn.data(), magnitude_length, counter,
+                                 lquantile_opt.data(), density_opt.data());
+        ExpectEqual(lquantile_ref, lquantile_opt, kernels.bitexact);
+        ExpectEqual(density_ref, density_opt, kernels.bitexact);
+      }
+    }
+  }
+}
+
+// Verifies that the optimized Wiener filter computations match the generic
+// one.
+TEST(NsCore, WienerFilter) {
+  Random random_generator(42U);
+  for (size_t magnitude_length : {65, 129}) {
+    std::vector<float> magn(magnitude_length);
+    std::vector<float> noise(magnitude_length);
+    std::vector<float> magn_prev(magnitude_length);
+    std::vector<float> noise_prev(magnitude_length);
+    std::vector<float> smooth(magnitude_length);
+    FillRandom(&random_generator, 1.f, 10000.f, &magn);
+    FillRandom(&random_generator, 0.f, 10000.f, &noise);
+    FillRandom(&random_generator, 1.f, 10000.f, &magn_prev);
+    FillRandom(&random_generator, 0.f, 10000.f, &noise_prev);
+    FillRandom(&random_generator, 0.f, 1.f, &smooth);
+
+    std::vector<float> filter(magnitude_length);
+    WebRtcNs_WienerFilterC(magn.data(), noise.data(), magn_prev.data(),
+                           noise_prev.data(), smooth.data(), 1.3f, 0.1f,
+                           magnitude_length, filter.data());
+    for (const auto& kernels : OptimizedKernels()) {
+      SCOPED_TRACE(kernels.name);
+      std::vector<float> filter_opt(magnitude_length);
+      kernels.wiener_filter(magn.data(), noise.data(), magn_prev.data(),
+                            noise_prev.data(), smooth.data(), 1.3f, 0.1f,
+                            magnitude_length, filter_opt.data());
+      ExpectEqual(filter, filter_opt, kernels.bitexact);
+    }
+  }
+}
+
+// Verifies that the noise suppressor output is bit exact with the generic
+// kernels when using bit exact optimized kernels.
+TEST(NsCore, OptimizedKernelsAreBitexact) {
+  constexpr size_t kNumFrames = 500;
+  for (int sample_rate_hz : {8000, 16000}) {
+    const std::vector<float> reference =
+        SuppressNoise(sample_rate_hz, kNumFrames, kGenericKernels, nullptr);
+    for (const auto& kernels : OptimizedKernels()) {
+      if (!kernels.bitexact) {
+        continue;
+      }
+      SCOPED_TRACE(kernels.name);
+      EXPECT_EQ(reference,
+                SuppressNoise(sample_rate_hz, kNumFrames, kernels, nullptr));
+    }
+  }
+}
+
+// Reports the time taken by the noise suppressor per frame for the generic and
+// the optimized kernels.
+TEST(NsCore, DISABLED_Performance) {
+  constexpr size_t kNumFrames = 10000;
+  std::vector<NsKernels> all_kernels = OptimizedKernels();
+  all_kernels.insert(all_kernels.begin(), kGenericKernels);
+  for (const auto& kernels : all_kernels) {
+    test::PerformanceTimer perf_timer(kNumFrames);
+    SuppressNoise(16000, kNumFrames, kernels, &perf_timer);
+    RTC_LOG(LS_INFO) << "NS " << kernels.name << ": "
+                     << perf_timer.GetDurationAverage(100) << " us per frame";
+  }
+}
+
+}  // namespace webrtc
@@ -12,8 +12,8 @@
 
 #include <math.h>
 #include <algorithm>
-#include <numeric>
 
+#include "common_audio/signal_processing/include/signal_processing_library.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -45,6 +45,7 @@ int ComputeRms(float mean_square) {
 }  // namespace
 
 RmsLevel::RmsLevel() {
+  WebRtcSpl_Init();
   Reset();
 }
 
@@ -64,9 +65,9 @@ void RmsLevel::Analyze(rtc::ArrayView<const int16_t> data) {
 
   CheckBlockSize(data.size());
 
-  const float sum_square =
-      std::accumulate(data.begin(), data.end(), 0.f,
-                      [](float a, int16_t b) { return a + b * b; });
+  // The squares are summed exactly; only the result is rounded to float.
+  const float sum_square = static_cast<float>(
+      WebRtcSpl_SquaredSumAndMaxAbsW16(data.data(), data.size(), nullptr));
   RTC_DCHECK_GE(sum_square, 0.f);
   sum_square_ += sum_square;
   sample_count_ += data.size();
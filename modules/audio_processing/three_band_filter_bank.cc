@@ -36,8 +36,19 @@
 #include "modules/audio_processing/three_band_filter_bank.h"
 
 #include <cmath>
+#include <cstddef>
+#include <cstring>
 
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "typedefs.h"  // NOLINT(build/include)
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#include <emmintrin.h>
+#endif
+#if defined(WEBRTC_HAS_NEON)
+#include <arm_neon.h>
+#endif
 
 namespace webrtc {
 namespace {
@@ -82,25 +93,287 @@ const float kLowpassCoeffs[kNumBands * kSparsity][kNumCoeffs] =
      {+0.00994113f, +0.14989004f, -0.01585778f, -0.00173287f},
      {+0.00425496f, +0.16547118f, -0.00496888f, -0.00047749f}};
 
-// Downsamples |in| into |out|, taking one every |kNumbands| starting from
-// |offset|. |split_length| is the |out| length. |in| has to be at least
-// |kNumBands| * |split_length| long.
-void Downsample(const float* in,
+// Number of sparse filters, one for each delay and branch of the polyphase
+// decomposition.
+const size_t kNumFilters = kNumBands * kSparsity;
+
+// Number of past samples needed by the sparse filters. The filter with index
+// |offset| has its non-zero coefficients every |kSparsity| samples starting
+// with a delay of |offset| / |kNumBands| samples.
+const size_t kMemorySize = kSparsity * (kNumCoeffs - 1) + kSparsity - 1;
+
+// Returns the output of the sparse filter |offset| for the sample |x| points
+// to, with the past samples preceding it.
+float SparseFilter(const float* x, size_t offset) {
+  const size_t delay = offset / kNumBands;
+  float y = 0.f;
+  for (size_t k = 0; k < kNumCoeffs; ++k) {
+    y += x[-static_cast<ptrdiff_t>(k * kSparsity + delay)] *
+         kLowpassCoeffs[offset][k];
+  }
+  return y;
+}
+
+// Computes the analysis output sample |k| of every band in |out| from the
+// polyphase branches |inputs|.
+void AnalyzeSample(const float* const* inputs,
+                   const float* dct_modulation,
+                   size_t k,
+                   float* const* out) {
+  float acc[kNumBands] = {0.f};
+  for (size_t i = 0; i < kNumBands; ++i) {
+    for (size_t j = 0; j < kSparsity; ++j) {
+      const size_t offset = i + j * kNumBands;
+      const float y = SparseFilter(&inputs[i][k], offset);
+      for (size_t band = 0; band < kNumBands; ++band) {
+        acc[band] += dct_modulation[offset * kNumBands + band] * y;
+      }
+    }
+  }
+  for (size_t band = 0; band < kNumBands; ++band) {
+    out[band][k] = acc[band];
+  }
+}
+
+// Computes the synthesis output sample |k| of the polyphase branch |i| from
+// the modulated filter inputs |inputs|.
+float SynthesizeSample(const float* const* inputs, size_t i, size_t k) {
+  float acc = 0.f;
+  for (size_t j = 0; j < kSparsity; ++j) {
+    const size_t offset = i + j * kNumBands;
+    acc += kNumBands * SparseFilter(&inputs[offset][k], offset);
+  }
+  return acc;
+}
+
+void AnalysisC(const float* const* inputs,
+               const float* dct_modulation,
+               size_t split_length,
+               float* const* out) {
+  for (size_t k = 0; k < split_length; ++k) {
+    AnalyzeSample(inputs, dct_modulation, k, out);
+  }
+}
+
+// Modulates the bands |in| for every sparse filter and writes the result in
+// |inputs|.
+void ModulateC(const float* const* in,
+               const float* dct_modulation,
+               size_t split_length,
+               float* const* inputs) {
+  for (size_t offset = 0; offset < kNumFilters; ++offset) {
+    const float* modulation = &dct_modulation[offset * kNumBands];
+    for (size_t k = 0; k < split_length; ++k) {
+      float m = 0.f;
+      for (size_t band = 0; band < kNumBands; ++band) {
+        m += modulation[band] * in[band][k];
+      }
+      inputs[offset][k] = m;
+    }
+  }
+}
+
+void SynthesisC(const float* const* inputs,
+                size_t i,
                 size_t split_length,
-                size_t offset,
                 float* out) {
-  for (size_t i = 0; i < split_length; ++i) {
-    out[i] = in[kNumBands * i + offset];
+  for (size_t k = 0; k < split_length; ++k) {
+    out[k] = SynthesizeSample(inputs, i, k);
+  }
+}
+
+// The SIMD versions compute four consecutive samples at a time, each lane with
+// the same operations and in the same order as the generic versions.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+__m128 SparseFilter_SSE2(const float* x, size_t offset) {
+  const size_t delay = offset / kNumBands;
+  __m128 y = _mm_setzero_ps();
+  for (size_t k = 0; k < kNumCoeffs; ++k) {
+    const __m128 x_k =
+        _mm_loadu_ps(x - static_cast<ptrdiff_t>(k * kSparsity + delay));
+    y = _mm_add_ps(y, _mm_mul_ps(x_k, _mm_set1_ps(kLowpassCoeffs[offset][k])));
+  }
+  return y;
+}
+
+void Analysis_SSE2(const float* const* inputs,
+                   const float* dct_modulation,
+                   size_t split_length,
+                   float* const* out) {
+  size_t k = 0;
+  for (; k + 4 <= split_length; k += 4) {
+    __m128 acc[kNumBands] = {_mm_setzero_ps(), _mm_setzero_ps(),
+                             _mm_setzero_ps()};
+    for (size_t i = 0; i < kNumBands; ++i) {
+      for (size_t j = 0; j < kSparsity; ++j) {
+        const size_t offset = i + j * kNumBands;
+        const __m128 y = SparseFilter_SSE2(&inputs[i][k], offset);
+        for (size_t band = 0; band < kNumBands; ++band) {
+          acc[band] = _mm_add_ps(
+              acc[band],
+              _mm_mul_ps(_mm_set1_ps(dct_modulation[offset * kNumBands + band]),
+                         y));
+        }
+      }
+    }
+    for (size_t band = 0; band < kNumBands; ++band) {
+      _mm_storeu_ps(&out[band][k], acc[band]);
+    }
+  }
+  for (; k < split_length; ++k) {
+    AnalyzeSample(inputs, dct_modulation, k, out);
+  }
+}
+
+void Modulate_SSE2(const float* const* in,
+                   const float* dct_modulation,
+                   size_t split_length,
+                   float* const* inputs) {
+  for (size_t offset = 0; offset < kNumFilters; ++offset) {
+    const float* modulation = &dct_modulation[offset * kNumBands];
+    size_t k = 0;
+    for (; k + 4 <= split_length; k += 4) {
+      __m128 m = _mm_setzero_ps();
+      for (size_t band = 0; band < kNumBands; ++band) {
+        m = _mm_add_ps(m, _mm_mul_ps(_mm_set1_ps(modulation[band]),
+                                     _mm_loadu_ps(&in[band][k])));
+      }
+      _mm_storeu_ps(&inputs[offset][k], m);
+    }
+    for (; k < split_length; ++k) {
+      float m = 0.f;
+      for (size_t band = 0; band < kNumBands; ++band) {
+        m += modulation[band] * in[band][k];
+      }
+      inputs[offset][k] = m;
+    }
+  }
+}
+
+void Synthesis_SSE2(const float* const* inputs,
+                    size_t i,
+                    size_t split_length,
+                    float* out) {
+  const __m128 num_bands = _mm_set1_ps(kNumBands);
+  size_t k = 0;
+  for (; k + 4 <= split_length; k += 4) {
+    __m128 acc = _mm_setzero_ps();
+    for (size_t j = 0; j < kSparsity; ++j) {
+      const size_t offset = i + j * kNumBands;
+      acc = _mm_add_ps(
+          acc,
+          _mm_mul_ps(num_bands, SparseFilter_SSE2(&inputs[offset][k], offset)));
+    }
+    _mm_storeu_ps(&out[k], acc);
+  }
+  for (; k < split_length; ++k) {
+    out[k] = SynthesizeSample(inputs, i, k);
   }
 }
+#endif
 
-// Upsamples |in| into |out|, scaling by |kNumBands| and accumulating it every
-// |kNumBands| starting from |offset|. |split_length| is the |in| length. |out|
-// has to be at least |kNumBands| * |split_length| long.
-void Upsample(const float* in, size_t split_length, size_t offset, float* out) {
-  for (size_t i = 0; i < split_length; ++i) {
-    out[kNumBands * i + offset] += kNumBands * in[i];
+#if defined(WEBRTC_HAS_NEON)
+float32x4_t SparseFilter_NEON(const float* x, size_t offset) {
+  const size_t delay = offset / kNumBands;
+  float32x4_t y = vdupq_n_f32(0.f);
+  for (size_t k = 0; k < kNumCoeffs; ++k) {
+    const float32x4_t x_k =
+        vld1q_f32(x - static_cast<ptrdiff_t>(k * kSparsity + delay));
+    y = vaddq_f32(y, vmulq_n_f32(x_k, kLowpassCoeffs[offset][k]));
   }
+  return y;
+}
+
+void Analysis_NEON(const float* const* inputs,
+                   const float* dct_modulation,
+                   size_t split_length,
+                   float* const* out) {
+  size_t k = 0;
+  for (; k + 4 <= split_length; k += 4) {
+    float32x4_t acc[kNumBands] = {vdupq_n_f32(0.f), vdupq_n_f32(0.f),
+                                  vdupq_n_f32(0.f)};
+    for (size_t i = 0; i < kNumBands; ++i) {
+      for (size_t j = 0; j < kSparsity; ++j) {
+        const size_t offset = i + j * kNumBands;
+        const float32x4_t y = SparseFilter_NEON(&inputs[i][k], offset);
+        for (size_t band = 0; band < kNumBands; ++band) {
+          acc[band] = vaddq_f32(
+              acc[band],
+              vmulq_n_f32(y, dct_modulation[offset * kNumBands + band]));
+        }
+      }
+    }
+    for (size_t band = 0; band < kNumBands; ++band) {
+      vst1q_f32(&out[band][k], acc[band]);
+    }
+  }
+  for (; k < split_length; ++k) {
+    AnalyzeSample(inputs, dct_modulation, k, out);
+  }
+}
+
+void Modulate_NEON(const float* const* in,
+                   const float* dct_modulation,
+                   size_t split_length,
+                   float* const* inputs) {
+  for (size_t offset = 0; offset < kNumFilters; ++offset) {
+    const float* modulation = &dct_modulation[offset * kNumBands];
+    size_t k = 0;
+    for (; k + 4 <= split_length; k += 4) {
+      float32x4_t m = vdupq_n_f32(0.f);
+      for (size_t band = 0; band < kNumBands; ++band) {
+        m = vaddq_f32(m,
+                      vmulq_n_f32(vld1q_f32(&in[band][k]), modulation[band]));
+      }
+      vst1q_f32(&inputs[offset][k], m);
+    }
+    for (; k < split_length; ++k) {
+      float m = 0.f;
+      for (size_t band = 0; band < kNumBands; ++band) {
+        m += modulation[band] * in[band][k];
+      }
+      inputs[offset][k] = m;
+    }
+  }
+}
+
+void Synthesis_NEON(const float* const* inputs,
+                    size_t i,
+                    size_t split_length,
+                    float* out) {
+  size_t k = 0;
+  for (; k + 4 <= split_length; k += 4) {
+    float32x4_t acc = vdupq_n_f32(0.f);
+    for (size_t j = 0; j < kSparsity; ++j) {
+      const size_t offset = i + j * kNumBands;
+      acc = vaddq_f32(acc, vmulq_n_f32(SparseFilter_NEON(&inputs[offset][k],
+                                                         offset),
+                                       kNumBands));
+    }
+    vst1q_f32(&out[k], acc);
+  }
+  for (; k < split_length; ++k) {
+    out[k] = SynthesizeSample(inputs, i, k);
+  }
+}
+#endif
+
+bool SimdSupported() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  return WebRtc_GetCPUInfo(kSSE2) != 0;
+#elif defined(WEBRTC_HAS_NEON)
+  return true;
+#else
+  return false;
+#endif
+}
+
+// Moves the last |kMemorySize| samples of |buffer| to its beginning, where
+// they become the past samples of the next block.
+void UpdateMemory(std::vector<float>* buffer) {
+  RTC_DCHECK_GE(buffer->size(), kMemorySize);
+  std::memmove(buffer->data(), buffer->data() + buffer->size() - kMemorySize,
+               kMemorySize * sizeof((*buffer)[0]));
 }
 
 }  // namespace
@@ -109,24 +382,21 @@ void Upsample(const float* in, size_t split_length, size_t offset, float* out) {
 // use a DCT to shift it in both directions at the same time, to the center
 // frequencies [1 / 12, 3 / 12, 5 / 12].
 ThreeBandFilterBank::ThreeBandFilterBank(size_t length)
-    : in_buffer_(rtc::CheckedDivExact(length, kNumBands)),
-      out_buffer_(in_buffer_.size()) {
-  for (size_t i = 0; i < kSparsity; ++i) {
-    for (size_t j = 0; j < kNumBands; ++j) {
-      analysis_filters_.push_back(
-          std::unique_ptr<SparseFIRFilter>(new SparseFIRFilter(
-              kLowpassCoeffs[i * kNumBands + j], kNumCoeffs, kSparsity, i)));
-      synthesis_filters_.push_back(
-          std::unique_ptr<SparseFIRFilter>(new SparseFIRFilter(
-              kLowpassCoeffs[i * kNumBands + j], kNumCoeffs, kSparsity, i)));
-    }
-  }
-  dct_modulation_.resize(kNumBands * kSparsity);
-  for (size_t i = 0; i < dct_modulation_.size(); ++i) {
-    dct_modulation_[i].resize(kNumBands);
+    : ThreeBandFilterBank(length, SimdSupported()) {}
+
+ThreeBandFilterBank::ThreeBandFilterBank(size_t length, bool use_simd)
+    : split_length_(rtc::CheckedDivExact(length, kNumBands)),
+      use_simd_(use_simd && SimdSupported()),
+      analysis_inputs_(kNumBands,
+                       std::vector<float>(kMemorySize + split_length_, 0.f)),
+      synthesis_inputs_(kNumFilters,
+                        std::vector<float>(kMemorySize + split_length_, 0.f)),
+      synthesis_output_(split_length_),
+      dct_modulation_(kNumFilters * kNumBands) {
+  for (size_t i = 0; i < kNumFilters; ++i) {
     for (size_t j = 0; j < kNumBands; ++j) {
-      dct_modulation_[i][j] =
-          2.f * cos(2.f * M_PI * i * (2.f * j + 1.f) / dct_modulation_.size());
+      dct_modulation_[i * kNumBands + j] =
+          2.f * cos(2.f * M_PI * i * (2.f * j + 1.f) / kNumFilters);
     }
   }
 }
@@ -139,22 +409,32 @@ ThreeBandFilterBank::~ThreeBandFilterBank() = default;
 //      decomposition of the low-pass prototype filter and upsampled by a factor
 //      of |kSparsity|.
 //   3. Modulating with cosines and accumulating to get the desired band.
+// Steps 2 and 3 are done at once, one output sample at a time.
 void ThreeBandFilterBank::Analysis(const float* in,
                                    size_t length,
                                    float* const* out) {
-  RTC_CHECK_EQ(in_buffer_.size(), rtc::CheckedDivExact(length, kNumBands));
-  for (size_t i = 0; i < kNumBands; ++i) {
-    memset(out[i], 0, in_buffer_.size() * sizeof(*out[i]));
-  }
+  RTC_CHECK_EQ(split_length_, rtc::CheckedDivExact(length, kNumBands));
+  const float* inputs[kNumBands];
   for (size_t i = 0; i < kNumBands; ++i) {
-    Downsample(in, in_buffer_.size(), kNumBands - i - 1, &in_buffer_[0]);
-    for (size_t j = 0; j < kSparsity; ++j) {
-      const size_t offset = i + j * kNumBands;
-      analysis_filters_[offset]->Filter(&in_buffer_[0],
-                                        in_buffer_.size(),
-                                        &out_buffer_[0]);
-      DownModulate(&out_buffer_[0], out_buffer_.size(), offset, out);
+    float* input = &analysis_inputs_[i][kMemorySize];
+    for (size_t k = 0; k < split_length_; ++k) {
+      input[k] = in[kNumBands * k + kNumBands - i - 1];
     }
+    inputs[i] = input;
+  }
+
+  if (use_simd_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    Analysis_SSE2(inputs, dct_modulation_.data(), split_length_, out);
+#elif defined(WEBRTC_HAS_NEON)
+    Analysis_NEON(inputs, dct_modulation_.data(), split_length_, out);
+#endif
+  } else {
+    AnalysisC(inputs, dct_modulation_.data(), split_length_, out);
+  }
+
+  for (auto& input : analysis_inputs_) {
+    UpdateMemory(&input);
   }
 }
 
@@ -167,49 +447,39 @@ void ThreeBandFilterBank::Analysis(const float* in,
 void ThreeBandFilterBank::Synthesis(const float* const* in,
                                     size_t split_length,
                                     float* out) {
-  RTC_CHECK_EQ(in_buffer_.size(), split_length);
-  memset(out, 0, kNumBands * in_buffer_.size() * sizeof(*out));
-  for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < kSparsity; ++j) {
-      const size_t offset = i + j * kNumBands;
-      UpModulate(in, in_buffer_.size(), offset, &in_buffer_[0]);
-      synthesis_filters_[offset]->Filter(&in_buffer_[0],
-                                         in_buffer_.size(),
-                                         &out_buffer_[0]);
-      Upsample(&out_buffer_[0], out_buffer_.size(), i, out);
-    }
+  RTC_CHECK_EQ(split_length_, split_length);
+  float* modulated[kNumFilters];
+  for (size_t offset = 0; offset < kNumFilters; ++offset) {
+    modulated[offset] = &synthesis_inputs_[offset][kMemorySize];
   }
-}
 
+  if (use_simd_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+    Modulate_SSE2(in, dct_modulation_.data(), split_length_, modulated);
+#elif defined(WEBRTC_HAS_NEON)
+    Modulate_NEON(in, dct_modulation_.data(), split_length_, modulated);
+#endif
+  } else {
+    ModulateC(in, dct_modulation_.data(), split_length_, modulated);
+  }
 
-// Modulates |in| by |dct_modulation_| and accumulates it in each of the
-// |kNumBands| bands of |out|. |offset| is the index in the period of the
-// cosines used for modulation. |split_length| is the length of |in| and each
-// band of |out|.
-void ThreeBandFilterBank::DownModulate(const float* in,
-                                       size_t split_length,
-                                       size_t offset,
-                                       float* const* out) {
   for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < split_length; ++j) {
-      out[i][j] += dct_modulation_[offset][i] * in[j];
+    if (use_simd_) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+      Synthesis_SSE2(modulated, i, split_length_, synthesis_output_.data());
+#elif defined(WEBRTC_HAS_NEON)
+      Synthesis_NEON(modulated, i, split_length_, synthesis_output_.data());
+#endif
+    } else {
+      SynthesisC(modulated, i, split_length_, synthesis_output_.data());
+    }
+    for (size_t k = 0; k < split_length_; ++k) {
+      out[kNumBands * k + i] = synthesis_output_[k];
     }
   }
-}
 
-// Modulates each of the |kNumBands| bands of |in| by |dct_modulation_| and
-// accumulates them in |out|. |out| is cleared before starting to accumulate.
-// |offset| is the index in the period of the cosines used for modulation.
-// |split_length| is the length of each band of |in| and |out|.
-void ThreeBandFilterBank::UpModulate(const float* const* in,
-                                     size_t split_length,
-                                     size_t offset,
-                                     float* out) {
-  memset(out, 0, split_length * sizeof(*out));
-  for (size_t i = 0; i < kNumBands; ++i) {
-    for (size_t j = 0; j < split_length; ++j) {
-      out[j] += dct_modulation_[offset][i] * in[i][j];
-    }
+  for (auto& input : synthesis_inputs_) {
+    UpdateMemory(&input);
   }
 }
 
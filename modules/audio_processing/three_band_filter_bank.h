@@ -11,17 +11,15 @@
 #ifndef MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
 #define MODULES_AUDIO_PROCESSING_THREE_BAND_FILTER_BANK_H_
 
-#include <cstring>
-#include <memory>
+#include <stddef.h>
 #include <vector>
 
-#include "common_audio/sparse_fir_filter.h"
-
 namespace webrtc {
 
 // An implementation of a 3-band FIR filter-bank with DCT modulation, similar to
 // the proposed in "Multirate Signal Processing for Communication Systems" by
 // Fredric J Harris.
+//
 // The low-pass filter prototype has these characteristics:
 // * Pass-band ripple = 0.3dB
 // * Pass-band frequency = 0.147 (7kHz at 48kHz)
@@ -35,6 +33,9 @@ namespace webrtc {
 class ThreeBandFilterBank final {
  public:
   explicit ThreeBandFilterBank(size_t length);
+  // Only used for testing. Allows to disable the SIMD kernels, which produce
+  // the same output as the generic ones.
+  ThreeBandFilterBank(size_t length, bool use_simd);
   ~ThreeBandFilterBank();
 
   // Splits |in| into 3 downsampled frequency bands in |out|.
@@ -48,20 +49,17 @@ class ThreeBandFilterBank final {
   void Synthesis(const float* const* in, size_t split_length, float* out);
 
  private:
-  void DownModulate(const float* in,
-                    size_t split_length,
-                    size_t offset,
-                    float* const* out);
-  void UpModulate(const float* const* in,
-                  size_t split_length,
-                  size_t offset,
-                  float* out);
-
-  std::vector<float> in_buffer_;
-  std::vector<float> out_buffer_;
-  std::vector<std::unique_ptr<SparseFIRFilter>> analysis_filters_;
-  std::vector<std::unique_ptr<SparseFIRFilter>> synthesis_filters_;
-  std::vector<std::vector<float>> dct_modulation_;
+  const size_t split_length_;
+  const bool use_simd_;
+  // Downsampled input of each polyphase branch of the analysis, preceded by
+  // the past samples needed by the sparse filters.
+  std::vector<std::vector<float>> analysis_inputs_;
+  // Modulated input of each of the sparse synthesis filters, preceded by the
+  // past samples they need.
+  std::vector<std::vector<float>> synthesis_inputs_;
+  std::vector<float> synthesis_output_;
+  // Cosines used for modulation, |kNumBands| for each of the sparse filters.
+  std::vector<float> dct_modulation_;
 };
 
 }  // namespace webrtc
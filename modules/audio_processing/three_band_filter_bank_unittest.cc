@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/three_band_filter_bank.h"
+
+#include <vector>
+
+#include "modules/audio_processing/test/performance_timer.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kNumBands = 3;
+
+void FillRandom(Random* random_generator, std::vector<float>* v) {
+  for (float& v_k : *v) {
+    v_k = 32767.f * (2.f * random_generator->Rand<float>() - 1.f);
+  }
+}
+
+// Runs the analysis and the synthesis on |num_frames| random frames and
+// returns all the bands and the outputs.
+std::vector<float> AnalyzeAndSynthesize(size_t frame_length,
+                                        size_t num_frames,
+                                        bool use_simd,
+                                        test::PerformanceTimer* timer) {
+  ThreeBandFilterBank filter_bank(frame_length, use_simd);
+  Random random_generator(42U);
+  const size_t split_length = frame_length / kNumBands;
+  std::vector<float> in(frame_length);
+  std::vector<std::vector<float>> bands(kNumBands,
+                                        std::vector<float>(split_length));
+  float* band_pointers[kNumBands] = {bands[0].data(), bands[1].data(),
+                                     bands[2].data()};
+  std::vector<float> out(frame_length);
+  std::vector<float> result;
+  for (size_t k = 0; k < num_frames; ++k) {
+    FillRandom(&random_generator, &in);
+    if (timer) {
+      timer->StartTimer();
+    }
+    filter_bank.Analysis(in.data(), frame_length, band_pointers);
+    filter_bank.Synthesis(band_pointers, split_length, out.data());
+    if (timer) {
+      timer->StopTimer();
+    }
+    for (const auto& band : bands) {
+      result.insert(result.end(), band.begin(), band.end());
+    }
+    result.insert(result.end(), out.begin(), out.end());
+  }
+  return result;
+}
+
+}  // namespace
+
+// Verifies that the SIMD kernels produce the same output as the generic ones,
+// also for bands shorter than the filter memory.
+TEST(ThreeBandFilterBankTest, SimdIsBitexact) {
+  for (size_t frame_length : {480, 30, 9}) {
+    SCOPED_TRACE(frame_length);
+    EXPECT_EQ(AnalyzeAndSynthesize(frame_length, 50, false, nullptr),
+              AnalyzeAndSynthesize(frame_length, 50, true, nullptr));
+  }
+}
+
+// Reports the time taken by the analysis and the synthesis of a 10 ms frame at
+// 48 kHz.
+TEST(ThreeBandFilterBankTest, DISABLED_Performance) {
+  constexpr size_t kNumFrames = 10000;
+  for (bool use_simd : {false, true}) {
+    test::PerformanceTimer perf_timer(kNumFrames);
+    AnalyzeAndSynthesize(480, kNumFrames, use_simd, &perf_timer);
+    RTC_LOG(LS_INFO) << "Three-band filter bank" << (use_simd ? ", SIMD" : "")
+                     << ": " << perf_timer.GetDurationAverage(100)
+                     << " us per frame";
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,76 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/transient/dyadic_fir_filter.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+
+void DyadicFirFilterC(const float* coefficients,
+                      size_t coefficients_length,
+                      const float* in,
+                      size_t out_length,
+                      float* out) {
+  RTC_DCHECK_EQ(0, coefficients_length % 2);
+  for (size_t k = 0; k < out_length; ++k) {
+    const float* window = &in[2 * k + 1];
+    float sum = 0.f;
+    for (size_t t = 0; t < coefficients_length; t += 2) {
+      sum += coefficients[t] * window[t] + coefficients[t + 1] * window[t + 1];
+    }
+    out[k] = sum;
+  }
+}
+
+DyadicFirFilter::DyadicFirFilter(const float* coefficients,
+                                 size_t coefficients_length,
+                                 size_t max_input_length)
+    : coefficients_length_(coefficients_length),
+      max_input_length_(max_input_length),
+      coefficients_(coefficients_length + coefficients_length % 2, 0.f),
+      buffer_(coefficients_length + max_input_length, 0.f),
+      kernel_(DyadicFirFilterC) {
+  RTC_DCHECK(coefficients);
+  RTC_DCHECK_GT(coefficients_length, 0);
+  std::reverse_copy(coefficients, coefficients + coefficients_length,
+                    coefficients_.begin());
+// If we know the minimum architecture at compile time, avoid CPU detection.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  kernel_ = DyadicFirFilterSSE2;
+#else
+  if (WebRtc_GetCPUInfo(kSSE2))
+    kernel_ = DyadicFirFilterSSE2;
+#endif
+#endif
+}
+
+DyadicFirFilter::~DyadicFirFilter() {}
+
+void DyadicFirFilter::Filter(const float* in, size_t in_length, float* out) {
+  RTC_DCHECK_LE(in_length, max_input_length_);
+  const size_t history = coefficients_length_ - 1;
+  memcpy(&buffer_[history], in, in_length * sizeof(buffer_[0]));
+  buffer_[history + in_length] = 0.f;
+
+  kernel_(coefficients_.data(), coefficients_.size(), buffer_.data(),
+          in_length / 2, out);
+
+  // Keep the latest samples as history for the next call.
+  memmove(buffer_.data(), &buffer_[in_length], history * sizeof(buffer_[0]));
+}
+
+}  // namespace webrtc
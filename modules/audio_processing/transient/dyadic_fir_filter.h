@@ -0,0 +1,70 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_TRANSIENT_DYADIC_FIR_FILTER_H_
+#define MODULES_AUDIO_PROCESSING_TRANSIENT_DYADIC_FIR_FILTER_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "typedefs.h"  // NOLINT(build/include)
+
+namespace webrtc {
+
+// Computes |out_length| samples of a filter decimating by two:
+//   out[k] = sum(t < coefficients_length) coefficients[t] * in[2 * k + 1 + t]
+// |coefficients_length| must be even. The taps are summed in pairs, in the
+// same order in all versions, so they are bit exact.
+void DyadicFirFilterC(const float* coefficients,
+                      size_t coefficients_length,
+                      const float* in,
+                      size_t out_length,
+                      float* out);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void DyadicFirFilterSSE2(const float* coefficients,
+                         size_t coefficients_length,
+                         const float* in,
+                         size_t out_length,
+                         float* out);
+#endif
+
+// Filters a signal and decimates it by two, keeping the odd output samples.
+// This is equivalent to a FIRFilter followed by DyadicDecimate() with
+// |odd_sequence| set, but only the samples that are kept are computed. The
+// filter state is kept between calls.
+class DyadicFirFilter {
+ public:
+  DyadicFirFilter(const float* coefficients,
+                  size_t coefficients_length,
+                  size_t max_input_length);
+  ~DyadicFirFilter();
+
+  // Filters |in_length| samples of |in|, at most |max_input_length|, and
+  // writes |in_length| / 2 samples to |out|.
+  void Filter(const float* in, size_t in_length, float* out);
+
+ private:
+  using Kernel = void (*)(const float*, size_t, const float*, size_t, float*);
+
+  const size_t coefficients_length_;
+  const size_t max_input_length_;
+  // The coefficients in reverse order, so that the oldest sample is multiplied
+  // first, padded with a zero to an even length.
+  std::vector<float> coefficients_;
+  // |coefficients_length_| - 1 samples of history followed by the input, and
+  // one more sample for the zero padded coefficient to multiply.
+  std::vector<float> buffer_;
+  Kernel kernel_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_TRANSIENT_DYADIC_FIR_FILTER_H_
@@ -0,0 +1,45 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/transient/dyadic_fir_filter.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+
+// Computes four output samples at a time. The windows of consecutive outputs
+// start two samples apart, so each pair of taps is applied to the even and odd
+// halves of eight consecutive input samples. DyadicFirFilterC() computes the
+// remaining outputs.
+void DyadicFirFilterSSE2(const float* coefficients,
+                         size_t coefficients_length,
+                         const float* in,
+                         size_t out_length,
+                         float* out) {
+  size_t k = 0;
+  for (; k + 4 <= out_length; k += 4) {
+    const float* window = &in[2 * k + 1];
+    __m128 sum = _mm_setzero_ps();
+    for (size_t t = 0; t < coefficients_length; t += 2) {
+      const __m128 low = _mm_loadu_ps(&window[t]);
+      const __m128 high = _mm_loadu_ps(&window[t + 4]);
+      const __m128 first = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+      const __m128 second = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+      sum = _mm_add_ps(
+          sum, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(coefficients[t]), first),
+                          _mm_mul_ps(_mm_set1_ps(coefficients[t + 1]), second)));
+    }
+    _mm_storeu_ps(&out[k], sum);
+  }
+  DyadicFirFilterC(coefficients, coefficients_length, &in[2 * k],
+                   out_length - k, &out[k]);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/transient/dyadic_fir_filter.h"
+
+#include <vector>
+
+#include "modules/audio_processing/transient/daubechies_8_wavelet_coeffs.h"
+#include "modules/audio_processing/transient/dyadic_decimator.h"
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+std::vector<float> RandomSignal(size_t length, Random* random) {
+  std::vector<float> signal(length);
+  for (float& sample : signal)
+    sample = random->Gaussian(0, 1000);
+  return signal;
+}
+
+// Filters |signal| as a whole and decimates each chunk of |chunk_lengths|, as
+// WPDNode did before the filtering and the decimation were fused.
+std::vector<float> FilterThenDecimate(const std::vector<float>& coefficients,
+                                      const std::vector<float>& signal,
+                                      const std::vector<size_t>& chunk_lengths) {
+  std::vector<float> filtered(signal.size());
+  for (size_t n = 0; n < signal.size(); ++n) {
+    double sum = 0.0;
+    for (size_t j = 0; j < coefficients.size() && j <= n; ++j)
+      sum += coefficients[j] * signal[n - j];
+    filtered[n] = static_cast<float>(sum);
+  }
+  std::vector<float> decimated;
+  size_t start = 0;
+  for (size_t chunk_length : chunk_lengths) {
+    std::vector<float> out(chunk_length / 2);
+    EXPECT_EQ(out.size(), DyadicDecimate(&filtered[start], chunk_length, true,
+                                         out.data(), out.size()));
+    decimated.insert(decimated.end(), out.begin(), out.end());
+    start += chunk_length;
+  }
+  return decimated;
+}
+
+}  // namespace
+
+TEST(DyadicFirFilterTest, MatchesFilterFollowedByDecimation) {
+  Random random(0x5eed);
+  const std::vector<float> kDaubechies(
+      kDaubechies8LowPassCoefficients,
+      kDaubechies8LowPassCoefficients + kDaubechies8CoefficientsLength);
+  const std::vector<float> kOddLength = {0.2f, -0.3f, 0.5f, -0.7f, 0.11f};
+  const std::vector<float> kIdentity = {1.f};
+  // Odd chunks shift which samples of the filtered signal are kept.
+  const std::vector<size_t> kChunkLengths = {80, 40, 25, 2, 81, 1, 63, 80};
+  size_t signal_length = 0;
+  for (size_t chunk_length : kChunkLengths)
+    signal_length += chunk_length;
+
+  for (const std::vector<float>& coefficients :
+       {kDaubechies, kOddLength, kIdentity}) {
+    const std::vector<float> signal = RandomSignal(signal_length, &random);
+    const std::vector<float> expected =
+        FilterThenDecimate(coefficients, signal, kChunkLengths);
+
+    DyadicFirFilter filter(coefficients.data(), coefficients.size(), 81);
+    std::vector<float> actual;
+    size_t start = 0;
+    for (size_t chunk_length : kChunkLengths) {
+      std::vector<float> out(chunk_length / 2);
+      filter.Filter(&signal[start], chunk_length, out.data());
+      actual.insert(actual.end(), out.begin(), out.end());
+      start += chunk_length;
+    }
+
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+      EXPECT_NEAR(expected[i], actual[i], 0.01f) << coefficients.size();
+  }
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(DyadicFirFilterTest, SSE2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  Random random(0x5eed);
+  for (size_t coefficients_length : {2, 4, 16}) {
+    const std::vector<float> coefficients =
+        RandomSignal(coefficients_length, &random);
+    for (size_t out_length : {1, 3, 4, 5, 40, 43}) {
+      const std::vector<float> in =
+          RandomSignal(2 * out_length + coefficients_length, &random);
+      std::vector<float> expected(out_length);
+      std::vector<float> actual(out_length);
+      DyadicFirFilterC(coefficients.data(), coefficients_length, in.data(),
+                       out_length, expected.data());
+      DyadicFirFilterSSE2(coefficients.data(), coefficients_length, in.data(),
+                          out_length, actual.data());
+      EXPECT_EQ(expected, actual) << coefficients_length << " " << out_length;
+    }
+  }
+}
+#endif
+
+}  // namespace webrtc
@@ -19,13 +19,11 @@ namespace webrtc {
 
 MovingMoments::MovingMoments(size_t length)
     : length_(length),
-      queue_(),
+      values_(length, 0.f),
+      oldest_(0),
       sum_(0.0),
       sum_of_squares_(0.0) {
   RTC_DCHECK_GT(length, 0);
-  for (size_t i = 0; i < length; ++i) {
-    queue_.push(0.0);
-  }
 }
 
 MovingMoments::~MovingMoments() {}
@@ -38,9 +36,10 @@ void MovingMoments::CalculateMoments(const float* in, size_t in_length,
   RTC_DCHECK(second);
 
   for (size_t i = 0; i < in_length; ++i) {
-    const float old_value = queue_.front();
-    queue_.pop();
-    queue_.push(in[i]);
+    const float old_value = values_[oldest_];
+    values_[oldest_] = in[i];
+    if (++oldest_ == length_)
+      oldest_ = 0;
 
     sum_ += in[i] - old_value;
     sum_of_squares_ += in[i] * in[i] - old_value * old_value;
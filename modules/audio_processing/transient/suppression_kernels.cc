@@ -0,0 +1,46 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/transient/suppression_kernels.h"
+
+#include <cmath>
+
+namespace webrtc {
+
+void ComplexMagnitudesC(const float* spectrum,
+                        size_t length,
+                        float* magnitudes) {
+  for (size_t i = 0; i < length; ++i) {
+    magnitudes[i] = std::abs(spectrum[i * 2]) + std::abs(spectrum[i * 2 + 1]);
+  }
+}
+
+void SoftRestorationC(const float* spectral_mean,
+                      const float* mean_factor,
+                      float block_mean,
+                      float attenuation,
+                      size_t length,
+                      float* magnitudes,
+                      float* spectrum) {
+  for (size_t i = 0; i < length; ++i) {
+    if (magnitudes[i] > spectral_mean[i] && magnitudes[i] > 0 &&
+        magnitudes[i] < block_mean * mean_factor[i]) {
+      const float new_magnitude =
+          magnitudes[i] - attenuation * (magnitudes[i] - spectral_mean[i]);
+      const float magnitude_ratio = new_magnitude / magnitudes[i];
+
+      spectrum[i * 2] *= magnitude_ratio;
+      spectrum[i * 2 + 1] *= magnitude_ratio;
+      magnitudes[i] = new_magnitude;
+    }
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_AUDIO_PROCESSING_TRANSIENT_SUPPRESSION_KERNELS_H_
+#define MODULES_AUDIO_PROCESSING_TRANSIENT_SUPPRESSION_KERNELS_H_
+
+#include <stddef.h>
+
+#include "typedefs.h"  // NOLINT(build/include)
+
+// The per-bin loops of TransientSuppressor. The SIMD versions are bit exact
+// with the C versions.
+
+namespace webrtc {
+
+// Writes the magnitude approximation |re| + |im| of each of the |length|
+// interleaved complex bins of |spectrum| to |magnitudes|.
+typedef void (*ComplexMagnitudesKernel)(const float* spectrum,
+                                        size_t length,
+                                        float* magnitudes);
+void ComplexMagnitudesC(const float* spectrum,
+                        size_t length,
+                        float* magnitudes);
+
+// Attenuates by |attenuation| the part of each bin of |spectrum| whose
+// magnitude exceeds |spectral_mean|, for the bins whose magnitude is also
+// lower than |block_mean| * |mean_factor|. |block_mean| can be infinity to
+// attenuate all bins exceeding |spectral_mean|. |magnitudes| are updated with
+// the attenuated values.
+typedef void (*SoftRestorationKernel)(const float* spectral_mean,
+                                      const float* mean_factor,
+                                      float block_mean,
+                                      float attenuation,
+                                      size_t length,
+                                      float* magnitudes,
+                                      float* spectrum);
+void SoftRestorationC(const float* spectral_mean,
+                      const float* mean_factor,
+                      float block_mean,
+                      float attenuation,
+                      size_t length,
+                      float* magnitudes,
+                      float* spectrum);
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void ComplexMagnitudesSSE2(const float* spectrum,
+                           size_t length,
+                           float* magnitudes);
+void SoftRestorationSSE2(const float* spectral_mean,
+                         const float* mean_factor,
+                         float block_mean,
+                         float attenuation,
+                         size_t length,
+                         float* magnitudes,
+                         float* spectrum);
+#endif
+
+}  // namespace webrtc
+
+#endif  // MODULES_AUDIO_PROCESSING_TRANSIENT_SUPPRESSION_KERNELS_H_
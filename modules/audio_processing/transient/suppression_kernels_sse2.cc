@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/transient/suppression_kernels.h"
+
+#include <emmintrin.h>
+
+namespace webrtc {
+
+// The SSE2 versions process four bins at a time and leave the remaining bins
+// to the C versions.
+
+void ComplexMagnitudesSSE2(const float* spectrum,
+                           size_t length,
+                           float* magnitudes) {
+  const __m128 sign_mask = _mm_set1_ps(-0.f);
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    const __m128 low = _mm_loadu_ps(&spectrum[i * 2]);
+    const __m128 high = _mm_loadu_ps(&spectrum[i * 2 + 4]);
+    const __m128 re = _mm_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 im = _mm_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1));
+    _mm_storeu_ps(&magnitudes[i], _mm_add_ps(_mm_andnot_ps(sign_mask, re),
+                                             _mm_andnot_ps(sign_mask, im)));
+  }
+  ComplexMagnitudesC(&spectrum[i * 2], length - i, &magnitudes[i]);
+}
+
+void SoftRestorationSSE2(const float* spectral_mean,
+                         const float* mean_factor,
+                         float block_mean,
+                         float attenuation,
+                         size_t length,
+                         float* magnitudes,
+                         float* spectrum) {
+  const __m128 block_mean_4 = _mm_set1_ps(block_mean);
+  const __m128 attenuation_4 = _mm_set1_ps(attenuation);
+  const __m128 one = _mm_set1_ps(1.f);
+  size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    const __m128 magnitude = _mm_loadu_ps(&magnitudes[i]);
+    const __m128 mean = _mm_loadu_ps(&spectral_mean[i]);
+    const __m128 ceiling =
+        _mm_mul_ps(block_mean_4, _mm_loadu_ps(&mean_factor[i]));
+    const __m128 restore = _mm_and_ps(
+        _mm_and_ps(_mm_cmpgt_ps(magnitude, mean),
+                   _mm_cmpgt_ps(magnitude, _mm_setzero_ps())),
+        _mm_cmplt_ps(magnitude, ceiling));
+    if (_mm_movemask_ps(restore) == 0)
+      continue;
+
+    const __m128 new_magnitude = _mm_sub_ps(
+        magnitude, _mm_mul_ps(attenuation_4, _mm_sub_ps(magnitude, mean)));
+    // Bins that are not restored are scaled by one, which keeps them as is.
+    // Their magnitude may be zero, so it is replaced by one in the division.
+    const __m128 divisor = _mm_or_ps(_mm_and_ps(restore, magnitude),
+                                     _mm_andnot_ps(restore, one));
+    const __m128 ratio =
+        _mm_or_ps(_mm_and_ps(restore, _mm_div_ps(new_magnitude, divisor)),
+                  _mm_andnot_ps(restore, one));
+    _mm_storeu_ps(&magnitudes[i],
+                  _mm_or_ps(_mm_and_ps(restore, new_magnitude),
+                            _mm_andnot_ps(restore, magnitude)));
+
+    // Apply the ratio of each bin to its real and imaginary parts.
+    const __m128 ratio_low = _mm_unpacklo_ps(ratio, ratio);
+    const __m128 ratio_high = _mm_unpackhi_ps(ratio, ratio);
+    _mm_storeu_ps(&spectrum[i * 2],
+                  _mm_mul_ps(_mm_loadu_ps(&spectrum[i * 2]), ratio_low));
+    _mm_storeu_ps(&spectrum[i * 2 + 4],
+                  _mm_mul_ps(_mm_loadu_ps(&spectrum[i * 2 + 4]), ratio_high));
+  }
+  SoftRestorationC(&spectral_mean[i], &mean_factor[i], block_mean,
+                   attenuation, length - i, &magnitudes[i], &spectrum[i * 2]);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/audio_processing/transient/suppression_kernels.h"
+
+#include <limits>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+std::vector<float> RandomValues(size_t length, float scale, Random* random) {
+  std::vector<float> values(length);
+  for (float& value : values)
+    value = scale * random->Rand<float>();
+  return values;
+}
+
+}  // namespace
+
+TEST(SuppressionKernelsTest, SoftRestorationAttenuatesPeaks) {
+  const float kSpectralMean[] = {1.f, 1.f, 1.f, 1.f};
+  const float kMeanFactor[] = {1.f, 1.f, 1.f, 1.f};
+  // Below the mean, a peak to restore, above the ceiling and zero.
+  float magnitudes[] = {0.5f, 3.f, 20.f, 0.f};
+  float spectrum[] = {0.25f, 0.25f, 2.f, 1.f, 10.f, 10.f, 0.f, 0.f};
+  SoftRestorationC(kSpectralMean, kMeanFactor, 10.f, 0.5f, 4, magnitudes,
+                   spectrum);
+  const float kExpectedMagnitudes[] = {0.5f, 2.f, 20.f, 0.f};
+  const float kExpectedSpectrum[] = {0.25f, 0.25f, 4.f / 3, 2.f / 3,
+                                     10.f,  10.f,  0.f,     0.f};
+  for (size_t i = 0; i < 4; ++i)
+    EXPECT_FLOAT_EQ(kExpectedMagnitudes[i], magnitudes[i]);
+  for (size_t i = 0; i < 8; ++i)
+    EXPECT_FLOAT_EQ(kExpectedSpectrum[i], spectrum[i]);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(SuppressionKernelsTest, SSE2MatchesC) {
+  if (!WebRtc_GetCPUInfo(kSSE2))
+    return;
+  Random random(0x5eed);
+  // The bin counts of the supported sample rates.
+  for (size_t length : {65, 129, 257, 513}) {
+    std::vector<float> spectrum = RandomValues(2 * length, 200.f, &random);
+    for (size_t i = 0; i < spectrum.size(); i += 3)
+      spectrum[i] = -spectrum[i];
+    // Some bins are zero.
+    spectrum[2] = spectrum[3] = 0.f;
+
+    std::vector<float> expected_magnitudes(length);
+    std::vector<float> magnitudes(length);
+    ComplexMagnitudesC(spectrum.data(), length, expected_magnitudes.data());
+    ComplexMagnitudesSSE2(spectrum.data(), length, magnitudes.data());
+    EXPECT_EQ(expected_magnitudes, magnitudes);
+
+    const std::vector<float> spectral_mean =
+        RandomValues(length, 200.f, &random);
+    const std::vector<float> mean_factor = RandomValues(length, 4.f, &random);
+    for (float block_mean : {100.f, std::numeric_limits<float>::infinity()}) {
+      std::vector<float> expected_spectrum = spectrum;
+      std::vector<float> actual_spectrum = spectrum;
+      std::vector<float> expected = expected_magnitudes;
+      std::vector<float> actual = expected_magnitudes;
+      SoftRestorationC(spectral_mean.data(), mean_factor.data(), block_mean,
+                       0.7f, length, expected.data(),
+                       expected_spectrum.data());
+      SoftRestorationSSE2(spectral_mean.data(), mean_factor.data(),
+                          block_mean, 0.7f, length, actual.data(),
+                          actual_spectrum.data());
+      EXPECT_EQ(expected, actual) << length;
+      EXPECT_EQ(expected_spectrum, actual_spectrum) << length;
+      EXPECT_NE(expected_magnitudes, expected);
+    }
+  }
+}
+#endif
+
+}  // namespace webrtc
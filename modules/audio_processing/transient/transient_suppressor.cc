@@ -15,6 +15,7 @@
 #include <cmath>
 #include <complex>
 #include <deque>
+#include <limits>
 #include <set>
 
 #include "common_audio/fft4g.h"
@@ -25,6 +26,7 @@
 #include "modules/audio_processing/transient/transient_detector.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
 #include "typedefs.h"  // NOLINT(build/include)
 
 namespace webrtc {
@@ -36,14 +38,6 @@ static const float kVoiceThreshold = 0.02f;
 static const size_t kMinVoiceBin = 3;
 static const size_t kMaxVoiceBin = 60;
 
-namespace {
-
-float ComplexMagnitude(float a, float b) {
-  return std::abs(a) + std::abs(b);
-}
-
-}  // namespace
-
 TransientSuppressor::TransientSuppressor()
     : data_length_(0),
       detection_length_(0),
@@ -52,6 +46,8 @@ TransientSuppressor::TransientSuppressor()
       complex_analysis_length_(0),
       num_channels_(0),
       window_(NULL),
+      complex_magnitudes_(ComplexMagnitudesC),
+      soft_restoration_(SoftRestorationC),
       detector_smoothed_(0.f),
       keypress_counter_(0),
       chunks_since_keypress_(0),
@@ -61,6 +57,12 @@ TransientSuppressor::TransientSuppressor()
       chunks_since_voice_change_(0),
       seed_(182),
       using_reference_(false) {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+  if (WebRtc_GetCPUInfo(kSSE2)) {
+    complex_magnitudes_ = ComplexMagnitudesSSE2;
+    soft_restoration_ = SoftRestorationSSE2;
+  }
+#endif
 }
 
 TransientSuppressor::~TransientSuppressor() {}
@@ -246,10 +248,8 @@ void TransientSuppressor::Suppress(float* in_ptr,
   fft_buffer_[analysis_length_ + 1] = 0.f;
   fft_buffer_[1] = 0.f;
 
-  for (size_t i = 0; i < complex_analysis_length_; ++i) {
-    magnitudes_[i] = ComplexMagnitude(fft_buffer_[i * 2],
-                                      fft_buffer_[i * 2 + 1]);
-  }
+  complex_magnitudes_(fft_buffer_.get(), complex_analysis_length_,
+                      magnitudes_.get());
   // Restore audio if necessary.
   if (suppression_enabled_) {
     if (use_hard_restoration_) {
@@ -405,20 +405,12 @@ void TransientSuppressor::SoftRestoration(float* spectral_mean) {
   // previous spectral mean and lower than a factor of the block mean
   // we adjust them. The factor is a double sigmoid that has a minimum in the
   // voice frequency range (300Hz - 3kHz).
-  for (size_t i = 0; i < complex_analysis_length_; ++i) {
-    if (magnitudes_[i] > spectral_mean[i] && magnitudes_[i] > 0 &&
-        (using_reference_ ||
-         magnitudes_[i] < block_frequency_mean * mean_factor_[i])) {
-      const float new_magnitude =
-          magnitudes_[i] -
-          detector_smoothed_ * (magnitudes_[i] - spectral_mean[i]);
-      const float magnitude_ratio = new_magnitude / magnitudes_[i];
-
-      fft_buffer_[i * 2] *= magnitude_ratio;
-      fft_buffer_[i * 2 + 1] *= magnitude_ratio;
-      magnitudes_[i] = new_magnitude;
-    }
-  }
+  // With a reference the block mean does not limit the restoration.
+  soft_restoration_(spectral_mean, mean_factor_.get(),
+                    using_reference_ ? std::numeric_limits<float>::infinity()
+                                     : block_frequency_mean,
+                    detector_smoothed_, complex_analysis_length_,
+                    magnitudes_.get(), fft_buffer_.get());
 }
 
 }  // namespace webrtc
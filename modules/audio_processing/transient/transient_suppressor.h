@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 
+#include "modules/audio_processing/transient/suppression_kernels.h"
 #include "rtc_base/gtest_prod_util.h"
 #include "typedefs.h"  // NOLINT(build/include)
 
@@ -100,6 +101,9 @@ class TransientSuppressor {
 
   std::unique_ptr<float[]> mean_factor_;
 
+  ComplexMagnitudesKernel complex_magnitudes_;
+  SoftRestorationKernel soft_restoration_;
+
   float detector_smoothed_;
 
   int keypress_counter_;
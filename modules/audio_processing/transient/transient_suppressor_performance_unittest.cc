@@ -0,0 +1,72 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <math.h>
+
+#include <string>
+#include <vector>
+
+#include "modules/audio_processing/transient/transient_suppressor.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumWarmupChunks = 100;
+const int kNumTimedChunks = 1000;
+// A key is pressed every 70 ms, which keeps the suppression enabled.
+const int kChunksPerKeypress = 7;
+
+// A tone in noise, with a click at the start of the chunks where a key is
+// pressed.
+void CreateChunk(int chunk_index, bool key_pressed, Random* random,
+                 std::vector<float>* chunk) {
+  for (size_t i = 0; i < chunk->size(); ++i) {
+    const size_t t = chunk_index * chunk->size() + i;
+    (*chunk)[i] = 3000.f * sinf(0.01f * t) +
+                  static_cast<float>(random->Gaussian(0, 300));
+    if (key_pressed && i < 30)
+      (*chunk)[i] += 20000.f * random->Rand<float>();
+  }
+}
+
+double MeasureUsPerChunk(int sample_rate_hz) {
+  TransientSuppressor suppressor;
+  EXPECT_EQ(0, suppressor.Initialize(sample_rate_hz, sample_rate_hz, 1));
+  Random random(0x1234);
+  std::vector<float> chunk(sample_rate_hz / 100);
+  int64_t elapsed_us = 0;
+  for (int i = 0; i < kNumWarmupChunks + kNumTimedChunks; ++i) {
+    const bool key_pressed = i % kChunksPerKeypress == 0;
+    CreateChunk(i, key_pressed, &random, &chunk);
+    const int64_t start_us = rtc::TimeMicros();
+    EXPECT_EQ(0, suppressor.Suppress(chunk.data(), chunk.size(), 1, nullptr,
+                                     chunk.size(), nullptr, 0, 1.f,
+                                     key_pressed));
+    if (i >= kNumWarmupChunks)
+      elapsed_us += rtc::TimeMicros() - start_us;
+  }
+  return static_cast<double>(elapsed_us) / kNumTimedChunks;
+}
+
+}  // namespace
+
+TEST(TransientSuppressorPerformanceTest, TimePerChunk) {
+  for (int sample_rate_hz : {16000, 32000, 48000}) {
+    test::PrintResult("transient_suppressor_time_per_chunk", "",
+                      std::to_string(sample_rate_hz / 1000) + "kHz",
+                      MeasureUsPerChunk(sample_rate_hz), "us", true);
+  }
+}
+
+}  // namespace webrtc
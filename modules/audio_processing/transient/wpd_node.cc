@@ -13,9 +13,7 @@
 #include <math.h>
 #include <string.h>
 
-#include "common_audio/fir_filter.h"
-#include "common_audio/fir_filter_factory.h"
-#include "modules/audio_processing/transient/dyadic_decimator.h"
+#include "modules/audio_processing/transient/dyadic_fir_filter.h"
 #include "rtc_base/checks.h"
 
 namespace webrtc {
@@ -23,17 +21,16 @@ namespace webrtc {
 WPDNode::WPDNode(size_t length,
                  const float* coefficients,
                  size_t coefficients_length)
-    : // The data buffer has parent data length to be able to contain and filter
-      // it.
-      data_(new float[2 * length + 1]),
+    : data_(new float[length]),
       length_(length),
-      filter_(CreateFirFilter(coefficients,
-                              coefficients_length,
-                              2 * length + 1)) {
+      // The parent data may also have an odd length, 2 * |length| + 1.
+      filter_(new DyadicFirFilter(coefficients,
+                                  coefficients_length,
+                                  2 * length + 1)) {
   RTC_DCHECK_GT(length, 0);
   RTC_DCHECK(coefficients);
   RTC_DCHECK_GT(coefficients_length, 0);
-  memset(data_.get(), 0.f, (2 * length + 1) * sizeof(data_[0]));
+  memset(data_.get(), 0.f, length * sizeof(data_[0]));
 }
 
 WPDNode::~WPDNode() {}
@@ -43,17 +40,10 @@ int WPDNode::Update(const float* parent_data, size_t parent_data_length) {
     return -1;
   }
 
-  // Filter data.
+  // Filter and decimate data: only the odd samples of the filtered signal are
+  // computed.
   filter_->Filter(parent_data, parent_data_length, data_.get());
 
-  // Decimate data.
-  const bool kOddSequence = true;
-  size_t output_samples = DyadicDecimate(
-      data_.get(), parent_data_length, kOddSequence, data_.get(), length_);
-  if (output_samples != length_) {
-    return -1;
-  }
-
   // Get abs to all values.
   for (size_t i = 0; i < length_; ++i) {
     data_[i] = fabs(data_[i]);
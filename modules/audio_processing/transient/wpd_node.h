@@ -17,7 +17,7 @@
 
 namespace webrtc {
 
-class FIRFilter;
+class DyadicFirFilter;
 
 // A single node of a Wavelet Packet Decomposition (WPD) tree.
 class WPDNode {
@@ -39,7 +39,7 @@ class WPDNode {
  private:
   std::unique_ptr<float[]> data_;
   size_t length_;
-  std::unique_ptr<FIRFilter> filter_;
+  std::unique_ptr<DyadicFirFilter> filter_;
 };
 
 }  // namespace webrtc
@@ -44,6 +44,16 @@ const float kDefaultLowLossThreshold = 0.02f;
 const float kDefaultHighLossThreshold = 0.1f;
 const int kDefaultBitrateThresholdKbps = 0;
 
+// Loss reported within this long of a delay-based overuse is considered
+// congestive. Delay-based information older than this isn't used.
+const int64_t kLossDelayCorrelationWindowMs = 2000;
+// The random loss level follows increases slowly and decreases quickly, so
+// that a sudden rise in loss is acted upon even without a delay increase.
+const float kRandomLossRiseFactor = 0.8f;
+const float kRandomLossFallFactor = 0.5f;
+// Loss above this level is never considered random.
+const float kMaxRandomLoss = 0.15f;
+
 struct UmaRampUpMetric {
   const char* metric_name;
   int bitrate_kbps;
@@ -116,6 +126,7 @@ SendSideBandwidthEstimation::SendSideBandwidthEstimation(RtcEventLog* event_log)
       last_packet_report_ms_(-1),
       last_timeout_ms_(-1),
       last_fraction_loss_(0),
+      congestive_fraction_loss_(0),
       last_logged_fraction_loss_(0),
       last_round_trip_time_ms_(0),
       bwe_incoming_(0),
@@ -133,7 +144,12 @@ SendSideBandwidthEstimation::SendSideBandwidthEstimation(RtcEventLog* event_log)
           webrtc::field_trial::IsEnabled("WebRTC-FeedbackTimeout")),
       low_loss_threshold_(kDefaultLowLossThreshold),
       high_loss_threshold_(kDefaultHighLossThreshold),
-      bitrate_threshold_bps_(1000 * kDefaultBitrateThresholdKbps) {
+      bitrate_threshold_bps_(1000 * kDefaultBitrateThresholdKbps),
+      in_random_loss_experiment_(
+          webrtc::field_trial::IsEnabled("WebRTC-BweRandomLossDetection")),
+      last_delay_based_update_ms_(-1),
+      last_delay_based_overuse_ms_(-1),
+      random_loss_(0.0f) {
   RTC_DCHECK(event_log);
   if (BweLossExperimentIsEnabled()) {
     uint32_t bitrate_threshold_kbps;
@@ -206,6 +222,13 @@ void SendSideBandwidthEstimation::UpdateDelayBasedEstimate(
   CapBitrateToThresholds(now_ms, current_bitrate_bps_);
 }
 
+void SendSideBandwidthEstimation::UpdateDelayBasedOveruse(int64_t now_ms,
+                                                          bool overusing) {
+  last_delay_based_update_ms_ = now_ms;
+  if (overusing)
+    last_delay_based_overuse_ms_ = now_ms;
+}
+
 void SendSideBandwidthEstimation::UpdateReceiverBlock(uint8_t fraction_loss,
                                                       int64_t rtt_ms,
                                                       int number_of_packets,
@@ -239,6 +262,7 @@ void SendSideBandwidthEstimation::UpdatePacketsLost(int packets_lost,
     int64_t lost_q8 = lost_packets_since_last_loss_update_ << 8;
     int64_t expected = expected_packets_since_last_loss_update_;
     last_fraction_loss_ = std::min<int>(lost_q8 / expected, 255);
+    UpdateCongestiveLoss(now_ms);
 
     // Reset accumulators.
 
@@ -250,6 +274,28 @@ void SendSideBandwidthEstimation::UpdatePacketsLost(int packets_lost,
   UpdateUmaStatsPacketsLost(now_ms, packets_lost);
 }
 
+void SendSideBandwidthEstimation::UpdateCongestiveLoss(int64_t now_ms) {
+  congestive_fraction_loss_ = last_fraction_loss_;
+  if (!in_random_loss_experiment_ || last_delay_based_update_ms_ == -1 ||
+      now_ms - last_delay_based_update_ms_ > kLossDelayCorrelationWindowMs) {
+    return;
+  }
+  // Loss coinciding with a delay increase is caused by congestion. Act on all
+  // of it and keep it out of the random loss level.
+  if (last_delay_based_overuse_ms_ != -1 &&
+      now_ms - last_delay_based_overuse_ms_ <= kLossDelayCorrelationWindowMs) {
+    return;
+  }
+  float loss = last_fraction_loss_ / 256.0f;
+  float factor =
+      loss > random_loss_ ? kRandomLossRiseFactor : kRandomLossFallFactor;
+  random_loss_ =
+      std::min(factor * random_loss_ + (1 - factor) * loss, kMaxRandomLoss);
+  float excess_loss = std::max(loss - random_loss_, 0.0f);
+  congestive_fraction_loss_ =
+      std::min<int>(static_cast<int>(excess_loss * 256 + 0.5f), 255);
+}
+
 void SendSideBandwidthEstimation::UpdateUmaStatsPacketsLost(int64_t now_ms,
                                                             int packets_lost) {
   int bitrate_kbps = static_cast<int>((current_bitrate_bps_ + 500) / 1000);
@@ -319,7 +365,7 @@ void SendSideBandwidthEstimation::UpdateEstimate(int64_t now_ms) {
   int64_t time_since_feedback_ms = now_ms - last_feedback_ms_;
   if (time_since_packet_report_ms < 1.2 * kFeedbackIntervalMs) {
     // We only care about loss above a given bitrate threshold.
-    float loss = last_fraction_loss_ / 256.0f;
+    float loss = congestive_fraction_loss_ / 256.0f;
     // We only make decisions based on loss when the bitrate is above a
     // threshold. This is a crude way of handling loss which is uncorrelated
     // to congestion.
@@ -358,7 +404,7 @@ void SendSideBandwidthEstimation::UpdateEstimate(int64_t now_ms) {
           //   where packetLoss = 256*lossRate;
           new_bitrate = static_cast<uint32_t>(
               (current_bitrate_bps_ *
-               static_cast<double>(512 - last_fraction_loss_)) /
+               static_cast<double>(512 - congestive_fraction_loss_)) /
               512.0);
           has_decreased_since_last_fraction_loss_ = true;
         }
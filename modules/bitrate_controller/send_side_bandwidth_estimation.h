@@ -40,6 +40,11 @@ class SendSideBandwidthEstimation {
   // Call when a new delay-based estimate is available.
   void UpdateDelayBasedEstimate(int64_t now_ms, uint32_t bitrate_bps);
 
+  // Call when delay-based feedback has been processed. |overusing| is true if
+  // the delay detector signaled overuse while processing it. Used to tell
+  // congestive loss apart from random loss.
+  void UpdateDelayBasedOveruse(int64_t now_ms, bool overusing);
+
   // Call when we receive a RTCP message with a ReceiveBlock.
   void UpdateReceiverBlock(uint8_t fraction_loss,
                            int64_t rtt_ms,
@@ -68,6 +73,11 @@ class SendSideBandwidthEstimation {
 
   void UpdateUmaStatsPacketsLost(int64_t now_ms, int packets_lost);
 
+  // Updates |congestive_fraction_loss_| from |last_fraction_loss_|. Loss that
+  // isn't accompanied by a delay increase is considered random up to the level
+  // tracked by |random_loss_|, and only the excess is acted upon.
+  void UpdateCongestiveLoss(int64_t now_ms);
+
   // Updates history of min bitrates.
   // After this method returns min_bitrate_history_.front().second contains the
   // min bitrate used during last kBweIncreaseIntervalMs.
@@ -93,6 +103,8 @@ class SendSideBandwidthEstimation {
   int64_t last_packet_report_ms_;
   int64_t last_timeout_ms_;
   uint8_t last_fraction_loss_;
+  // Part of |last_fraction_loss_| attributed to congestion.
+  uint8_t congestive_fraction_loss_;
   uint8_t last_logged_fraction_loss_;
   int64_t last_round_trip_time_ms_;
 
@@ -111,6 +123,11 @@ class SendSideBandwidthEstimation {
   float low_loss_threshold_;
   float high_loss_threshold_;
   uint32_t bitrate_threshold_bps_;
+  bool in_random_loss_experiment_;
+  int64_t last_delay_based_update_ms_;
+  int64_t last_delay_based_overuse_ms_;
+  // Smoothed loss fraction observed while the delay detector saw no overuse.
+  float random_loss_;
 };
 }  // namespace webrtc
 #endif  // MODULES_BITRATE_CONTROLLER_SEND_SIDE_BANDWIDTH_ESTIMATION_H_
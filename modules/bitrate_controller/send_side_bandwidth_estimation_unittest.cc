@@ -14,6 +14,7 @@
 #include "logging/rtc_event_log/events/rtc_event_bwe_update_loss_based.h"
 #include "logging/rtc_event_log/mock/mock_rtc_event_log.h"
 #include "modules/bitrate_controller/send_side_bandwidth_estimation.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -34,6 +35,29 @@ MATCHER(LossBasedBweUpdateWithBitrateAndLossFraction, "") {
   return bwe_event->bitrate_bps_ > 0 && bwe_event->fraction_loss_ > 0;
 }
 
+// Reports a steady loss of about 8% once a second for 20 seconds and returns
+// the resulting estimate.
+int EstimateWithSteadyLoss(bool delay_based_overuse) {
+  ::testing::NiceMock<MockRtcEventLog> event_log;
+  SendSideBandwidthEstimation bwe(&event_log);
+  bwe.SetMinMaxBitrate(10000, 10000000);
+  bwe.SetSendBitrate(300000);
+
+  static const uint8_t kFractionLoss = 20;
+  int64_t now_ms = 0;
+  for (int i = 0; i < 20; ++i) {
+    bwe.UpdateDelayBasedOveruse(now_ms, delay_based_overuse);
+    bwe.UpdateReceiverBlock(kFractionLoss, 50, 100, now_ms);
+    now_ms += 1000;
+  }
+  int bitrate_bps;
+  uint8_t fraction_loss;
+  int64_t rtt_ms;
+  bwe.CurrentEstimate(&bitrate_bps, &fraction_loss, &rtt_ms);
+  EXPECT_EQ(kFractionLoss, fraction_loss);
+  return bitrate_bps;
+}
+
 void TestProbing(bool use_delay_based) {
   MockRtcEventLog event_log;
   SendSideBandwidthEstimation bwe(&event_log);
@@ -164,5 +188,19 @@ TEST(SendSideBweTest, SettingSendBitrateOverridesDelayBasedEstimate) {
   EXPECT_EQ(bitrate_bps, kForcedHighBitrate);
 }
 
+TEST(SendSideBweTest, SteadyLossHoldsBitrateByDefault) {
+  EXPECT_EQ(300000, EstimateWithSteadyLoss(false));
+}
+
+TEST(SendSideBweTest, IncreasesBitrateOnRandomLoss) {
+  test::ScopedFieldTrials field_trial("WebRTC-BweRandomLossDetection/Enabled/");
+  EXPECT_GT(EstimateWithSteadyLoss(false), 300000);
+}
+
+TEST(SendSideBweTest, HoldsBitrateOnLossWithDelayBasedOveruse) {
+  test::ScopedFieldTrials field_trial("WebRTC-BweRandomLossDetection/Enabled/");
+  EXPECT_EQ(300000, EstimateWithSteadyLoss(true));
+}
+
 
 }  // namespace webrtc
@@ -76,13 +76,15 @@ DelayBasedBwe::Result::Result()
     : updated(false),
       probe(false),
       target_bitrate_bps(0),
-      recovered_from_overuse(false) {}
+      recovered_from_overuse(false),
+      delay_detector_overuse(false) {}
 
 DelayBasedBwe::Result::Result(bool probe, uint32_t target_bitrate_bps)
     : updated(true),
       probe(probe),
       target_bitrate_bps(target_bitrate_bps),
-      recovered_from_overuse(false) {}
+      recovered_from_overuse(false),
+      delay_detector_overuse(false) {}
 
 DelayBasedBwe::Result::~Result() {}
 
@@ -137,6 +139,7 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketFeedbackVector(
   }
   bool delayed_feedback = true;
   bool recovered_from_overuse = false;
+  bool delay_detector_overuse = false;
   BandwidthUsage prev_detector_state = delay_detector_->State();
   for (const auto& packet_feedback : packet_feedback_vector) {
     if (packet_feedback.send_time_ms < 0)
@@ -147,6 +150,8 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketFeedbackVector(
         delay_detector_->State() == BandwidthUsage::kBwNormal) {
       recovered_from_overuse = true;
     }
+    if (delay_detector_->State() == BandwidthUsage::kBwOverusing)
+      delay_detector_overuse = true;
     prev_detector_state = delay_detector_->State();
   }
 
@@ -158,8 +163,10 @@ DelayBasedBwe::Result DelayBasedBwe::IncomingPacketFeedbackVector(
     }
   } else {
     consecutive_delayed_feedbacks_ = 0;
-    return MaybeUpdateEstimate(acked_bitrate_bps, recovered_from_overuse,
-                               at_time_ms);
+    Result result = MaybeUpdateEstimate(acked_bitrate_bps,
+                                        recovered_from_overuse, at_time_ms);
+    result.delay_detector_overuse = delay_detector_overuse;
+    return result;
   }
   return Result();
 }
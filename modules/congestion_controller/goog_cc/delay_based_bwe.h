@@ -41,6 +41,8 @@ class DelayBasedBwe {
     bool probe;
     uint32_t target_bitrate_bps;
     bool recovered_from_overuse;
+    // True if the delay detector signaled overuse for any of the packets.
+    bool delay_detector_overuse;
   };
 
   explicit DelayBasedBwe(RtcEventLog* event_log);
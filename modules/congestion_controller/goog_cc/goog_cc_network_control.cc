@@ -81,24 +81,26 @@ static void ClampBitrates(int64_t* bitrate_bps,
     *bitrate_bps = std::max(*min_bitrate_bps, *bitrate_bps);
 }
 
-std::vector<PacketFeedback> ReceivedPacketsFeedbackAsRtp(
-    const TransportPacketsFeedback report) {
-  std::vector<PacketFeedback> packet_feedback_vector;
-  for (auto& fb : report.PacketsWithFeedback()) {
-    if (fb.receive_time.IsFinite()) {
-      PacketFeedback pf(fb.receive_time.ms(), 0);
-      pf.creation_time_ms = report.feedback_time.ms();
-      if (fb.sent_packet.has_value()) {
-        pf.payload_size = fb.sent_packet->size.bytes();
-        pf.pacing_info = fb.sent_packet->pacing_info;
-        pf.send_time_ms = fb.sent_packet->send_time.ms();
-      } else {
-        pf.send_time_ms = PacketFeedback::kNoSendTime;
-      }
-      packet_feedback_vector.push_back(pf);
+// Converts the received packets in |report| into |packet_feedback_vector|,
+// reusing its storage.
+void ReceivedPacketsFeedbackAsRtp(
+    const TransportPacketsFeedback& report,
+    std::vector<PacketFeedback>* packet_feedback_vector) {
+  packet_feedback_vector->clear();
+  for (const auto& fb : report.PacketsWithFeedback()) {
+    if (!fb.receive_time.IsFinite())
+      continue;
+    if (fb.sent_packet.has_value()) {
+      packet_feedback_vector->emplace_back(
+          report.feedback_time.ms(), fb.receive_time.ms(),
+          fb.sent_packet->send_time.ms(), 0, fb.sent_packet->size.bytes(), 0,
+          0, fb.sent_packet->pacing_info);
+    } else {
+      packet_feedback_vector->emplace_back(
+          report.feedback_time.ms(), fb.receive_time.ms(),
+          PacketFeedback::kNoSendTime, 0, 0, 0, 0, PacedPacketInfo());
     }
   }
-  return packet_feedback_vector;
 }
 
 int64_t GetBpsOrDefault(const rtc::Optional<DataRate>& rate,
@@ -298,8 +300,7 @@ NetworkControlUpdate GoogCcNetworkController::OnTransportPacketsFeedback(
         *std::min_element(feedback_rtts_.begin(), feedback_rtts_.end()));
   }
 
-  std::vector<PacketFeedback> received_feedback_vector =
-      ReceivedPacketsFeedbackAsRtp(report);
+  ReceivedPacketsFeedbackAsRtp(report, &received_feedback_vector_);
 
   rtc::Optional<int64_t> alr_start_time =
       alr_detector_->GetApplicationLimitedRegionStartTime();
@@ -311,11 +312,15 @@ NetworkControlUpdate GoogCcNetworkController::OnTransportPacketsFeedback(
   }
   previously_in_alr = alr_start_time.has_value();
   acknowledged_bitrate_estimator_->IncomingPacketFeedbackVector(
-      received_feedback_vector);
+      received_feedback_vector_);
   DelayBasedBwe::Result result;
   result = delay_based_bwe_->IncomingPacketFeedbackVector(
-      received_feedback_vector, acknowledged_bitrate_estimator_->bitrate_bps(),
+      received_feedback_vector_, acknowledged_bitrate_estimator_->bitrate_bps(),
       report.feedback_time.ms());
+  if (!received_feedback_vector_.empty()) {
+    bandwidth_estimation_->UpdateDelayBasedOveruse(
+        report.feedback_time.ms(), result.delay_detector_overuse);
+  }
   NetworkControlUpdate update;
   if (result.updated) {
     if (result.probe) {
@@ -70,6 +70,10 @@ class GoogCcNetworkController : public NetworkControllerInterface {
   std::unique_ptr<DelayBasedBwe> delay_based_bwe_;
   std::unique_ptr<AcknowledgedBitrateEstimator> acknowledged_bitrate_estimator_;
 
+  // Received packets of the latest transport feedback. Kept as a member so
+  // that its storage is reused from one feedback message to the next.
+  std::vector<PacketFeedback> received_feedback_vector_;
+
   std::deque<int64_t> feedback_rtts_;
   rtc::Optional<int64_t> min_feedback_rtt_ms_;
 
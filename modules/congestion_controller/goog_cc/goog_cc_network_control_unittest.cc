@@ -0,0 +1,114 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/transport/test/network_control_tester.h"
+#include "logging/rtc_event_log/rtc_event_log.h"
+#include "modules/congestion_controller/goog_cc/include/goog_cc_factory.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace webrtc_cc {
+namespace test {
+namespace {
+
+const DataRate kInitialBitrate = DataRate::kbps(300);
+
+NetworkControllerConfig InitialConfig() {
+  NetworkControllerConfig config;
+  config.constraints.min_data_rate = DataRate::kbps(30);
+  config.constraints.max_data_rate = DataRate::kbps(5000);
+  config.starting_bandwidth = kInitialBitrate;
+  return config;
+}
+
+// Feedback for |packets_per_feedback| packets of |packet_size| bytes sent at
+// |send_rate| over a link with a constant |delay|. One packet in 50 is lost.
+std::vector<TransportPacketsFeedback> CreateFeedback(int num_feedbacks,
+                                                     int packets_per_feedback,
+                                                     DataSize packet_size,
+                                                     DataRate send_rate,
+                                                     TimeDelta delay) {
+  std::vector<TransportPacketsFeedback> feedbacks;
+  Timestamp send_time = Timestamp::seconds(100000);
+  TimeDelta packet_interval = packet_size / send_rate;
+  int64_t sequence_number = 1;
+  for (int i = 0; i < num_feedbacks; ++i) {
+    TransportPacketsFeedback feedback;
+    for (int j = 0; j < packets_per_feedback; ++j) {
+      PacketResult result;
+      result.sent_packet.emplace();
+      result.sent_packet->send_time = send_time;
+      result.sent_packet->size = packet_size;
+      result.sent_packet->sequence_number = sequence_number++;
+      if (sequence_number % 50 != 0)
+        result.receive_time = send_time + delay;
+      feedback.packet_feedbacks.push_back(result);
+      send_time += packet_interval;
+    }
+    feedback.feedback_time = send_time + delay;
+    feedbacks.push_back(feedback);
+  }
+  return feedbacks;
+}
+
+}  // namespace
+
+TEST(GoogCcNetworkControllerTest, UpdatesTargetRateFromFeedback) {
+  RtcEventLogNullImpl event_log;
+  GoogCcNetworkControllerFactory factory(&event_log);
+  webrtc::test::NetworkControllerTester tester(&factory, InitialConfig());
+  auto packet_producer = &webrtc::test::SimpleTargetRateProducer::ProduceNext;
+
+  tester.RunSimulation(TimeDelta::seconds(10), TimeDelta::ms(10),
+                       DataRate::kbps(200), TimeDelta::ms(50),
+                       packet_producer);
+  ASSERT_TRUE(tester.GetState().target_rate.has_value());
+  EXPECT_LT(tester.GetState().target_rate->target_rate, kInitialBitrate);
+  EXPECT_GT(tester.GetState().target_rate->target_rate, DataRate::kbps(30));
+}
+
+// Feeds synthetic transport feedback to the controller, 20 ms apart, as from a
+// 2.5 Mbps video call, and reports the processing time per message.
+TEST(GoogCcNetworkControllerTest, DISABLED_TransportFeedbackBenchmark) {
+  const int kFeedbacks = 50000;
+  const int kPacketsPerFeedback = 5;
+  const DataSize kPacketSize = DataSize::bytes(1200);
+  const DataRate kSendRate = DataRate::kbps(2500);
+  std::vector<TransportPacketsFeedback> feedbacks =
+      CreateFeedback(kFeedbacks, kPacketsPerFeedback, kPacketSize, kSendRate,
+                     TimeDelta::ms(40));
+
+  RtcEventLogNullImpl event_log;
+  GoogCcNetworkControllerFactory factory(&event_log);
+  NetworkControllerConfig config = InitialConfig();
+  config.constraints.at_time =
+      feedbacks.front().packet_feedbacks.front().sent_packet->send_time;
+  std::unique_ptr<NetworkControllerInterface> controller =
+      factory.Create(config);
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (const TransportPacketsFeedback& feedback : feedbacks)
+    controller->OnTransportPacketsFeedback(feedback);
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  webrtc::test::PrintResult(
+      "transport_feedback_time", "",
+      std::to_string(kPacketsPerFeedback) + "_packets_per_feedback",
+      static_cast<double>(elapsed_ns) / kFeedbacks, "ns", false);
+}
+
+}  // namespace test
+}  // namespace webrtc_cc
+}  // namespace webrtc
@@ -74,12 +74,18 @@ constexpr double kProbeUncertainty = 0.05;
 constexpr char kBweRapidRecoveryExperiment[] =
     "WebRTC-BweRapidRecoveryExperiment";
 
+// Use probing to return to the estimate from before an ALR period or a
+// network outage, when the application starts sending again.
+constexpr char kBweAlrFastRecoveryExperiment[] = "WebRTC-BweAlrFastRecovery";
+
 }  // namespace
 
 ProbeController::ProbeController() : enable_periodic_alr_probing_(false) {
   Reset(0);
   in_rapid_recovery_experiment_ = webrtc::field_trial::FindFullName(
                                       kBweRapidRecoveryExperiment) == "Enabled";
+  in_alr_fast_recovery_experiment_ =
+      webrtc::field_trial::IsEnabled(kBweAlrFastRecoveryExperiment);
 }
 
 ProbeController::~ProbeController() {}
@@ -147,6 +153,8 @@ void ProbeController::OnMaxTotalAllocatedBitrate(
 }
 
 void ProbeController::OnNetworkAvailability(NetworkAvailability msg) {
+  bool network_lost = network_available_ && !msg.network_available;
+  bool network_regained = !network_available_ && msg.network_available;
   network_available_ = msg.network_available;
 
   if (!network_available_ && state_ == State::kWaitingForProbingResult) {
@@ -154,8 +162,16 @@ void ProbeController::OnNetworkAvailability(NetworkAvailability msg) {
     min_bitrate_to_probe_further_bps_ = kExponentialProbingDisabled;
   }
 
+  if (network_lost) {
+    // Keep the estimate from before the ALR period if we are in one.
+    bitrate_to_recover_bps_ =
+        std::max(bitrate_to_recover_bps_, estimated_bitrate_bps_);
+  }
+
   if (network_available_ && state_ == State::kInit && start_bitrate_bps_ > 0)
     InitiateExponentialProbing(msg.at_time.ms());
+  else if (network_regained)
+    MaybeInitiateFastRecoveryProbing(msg.at_time.ms());
 }
 
 void ProbeController::InitiateExponentialProbing(int64_t at_time_ms) {
@@ -210,10 +226,30 @@ void ProbeController::EnablePeriodicAlrProbing(bool enable) {
 
 void ProbeController::SetAlrStartTimeMs(
     rtc::Optional<int64_t> alr_start_time_ms) {
+  if (!alr_start_time_ms_ && alr_start_time_ms)
+    bitrate_to_recover_bps_ = estimated_bitrate_bps_;
   alr_start_time_ms_ = alr_start_time_ms;
 }
 void ProbeController::SetAlrEndedTimeMs(int64_t alr_end_time_ms) {
   alr_end_time_ms_.emplace(alr_end_time_ms);
+  MaybeInitiateFastRecoveryProbing(alr_end_time_ms);
+}
+
+void ProbeController::MaybeInitiateFastRecoveryProbing(int64_t at_time_ms) {
+  int64_t bitrate_to_recover_bps = bitrate_to_recover_bps_;
+  bitrate_to_recover_bps_ = 0;
+  if (!in_alr_fast_recovery_experiment_ || !network_available_ ||
+      state_ != State::kProbingComplete || bitrate_to_recover_bps == 0) {
+    return;
+  }
+  // A successful probe sets the estimate directly, so there is no need to ramp
+  // up from the estimate we got while the application was limited.
+  if ((1 - kProbeUncertainty) * bitrate_to_recover_bps >
+      estimated_bitrate_bps_) {
+    RTC_LOG(LS_INFO) << "Probing to recover the estimate of "
+                     << bitrate_to_recover_bps << " bps.";
+    InitiateProbing(at_time_ms, {bitrate_to_recover_bps}, false);
+  }
 }
 
 void ProbeController::RequestProbe(int64_t at_time_ms) {
@@ -265,6 +301,7 @@ void ProbeController::Reset(int64_t at_time_ms) {
   time_of_last_large_drop_ms_ = now_ms;
   bitrate_before_last_large_drop_bps_ = 0;
   max_total_allocated_bitrate_ = 0;
+  bitrate_to_recover_bps_ = 0;
 }
 
 void ProbeController::Process(int64_t at_time_ms) {
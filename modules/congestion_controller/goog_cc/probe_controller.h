@@ -74,6 +74,9 @@ class ProbeController {
   };
 
   void InitiateExponentialProbing(int64_t at_time_ms);
+  // Probes at the estimate from before the last ALR period or network outage,
+  // if the estimate has dropped since.
+  void MaybeInitiateFastRecoveryProbing(int64_t at_time_ms);
   void InitiateProbing(int64_t now_ms,
                        std::initializer_list<int64_t> bitrates_to_probe,
                        bool probe_further);
@@ -94,6 +97,10 @@ class ProbeController {
   int64_t max_total_allocated_bitrate_;
 
   bool in_rapid_recovery_experiment_;
+  bool in_alr_fast_recovery_experiment_;
+  // Estimate when the current ALR period or network outage began, or 0 if
+  // there is nothing to recover.
+  int64_t bitrate_to_recover_bps_;
   // For WebRTC.BWE.MidCallProbing.* metric.
   bool mid_call_probing_waiting_for_result_;
   int64_t mid_call_probing_bitrate_bps_;
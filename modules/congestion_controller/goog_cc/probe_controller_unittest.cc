@@ -13,6 +13,7 @@
 #include "modules/congestion_controller/goog_cc/probe_controller.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
+#include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 
@@ -206,6 +207,89 @@ TEST_F(ProbeControllerTest, RequestProbeWhenBweDropNotRecent) {
   EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 0u);
 }
 
+TEST_F(ProbeControllerTest, ProbeAtEstimateBeforeAlrWhenAlrEnds) {
+  webrtc::test::ScopedFieldTrials field_trial(
+      "WebRTC-BweAlrFastRecovery/Enabled/");
+  probe_controller_.reset(new ProbeController());
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps, NowMs());
+  probe_controller_->SetEstimatedBitrate(500, NowMs());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 2u);
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->Process(NowMs());
+
+  probe_controller_->SetAlrStartTimeMs(clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
+  probe_controller_->Process(NowMs());
+  probe_controller_->SetEstimatedBitrate(250, NowMs());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 0u);
+
+  probe_controller_->SetAlrStartTimeMs(rtc::nullopt);
+  probe_controller_->SetAlrEndedTimeMs(clock_.TimeInMilliseconds());
+  std::vector<ProbeClusterConfig> probes =
+      probe_controller_->GetAndResetPendingProbes();
+  ASSERT_EQ(probes.size(), 1u);
+  EXPECT_EQ(probes[0].target_data_rate.bps(), 500);
+}
+
+TEST_F(ProbeControllerTest, NoProbeWhenAlrEndsIfEstimateDidNotDrop) {
+  webrtc::test::ScopedFieldTrials field_trial(
+      "WebRTC-BweAlrFastRecovery/Enabled/");
+  probe_controller_.reset(new ProbeController());
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps, NowMs());
+  probe_controller_->SetEstimatedBitrate(500, NowMs());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 2u);
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->Process(NowMs());
+
+  probe_controller_->SetAlrStartTimeMs(clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
+  probe_controller_->Process(NowMs());
+  probe_controller_->SetEstimatedBitrate(490, NowMs());
+  probe_controller_->SetAlrStartTimeMs(rtc::nullopt);
+  probe_controller_->SetAlrEndedTimeMs(clock_.TimeInMilliseconds());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 0u);
+}
+
+TEST_F(ProbeControllerTest, ProbeAtEstimateBeforeOutageWhenNetworkIsBack) {
+  webrtc::test::ScopedFieldTrials field_trial(
+      "WebRTC-BweAlrFastRecovery/Enabled/");
+  probe_controller_.reset(new ProbeController());
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps, NowMs());
+  probe_controller_->SetEstimatedBitrate(500, NowMs());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 2u);
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->Process(NowMs());
+
+  SetNetworkAvailable(false);
+  clock_.AdvanceTimeMilliseconds(1000);
+  probe_controller_->SetEstimatedBitrate(200, NowMs());
+  SetNetworkAvailable(true);
+  std::vector<ProbeClusterConfig> probes =
+      probe_controller_->GetAndResetPendingProbes();
+  ASSERT_EQ(probes.size(), 1u);
+  EXPECT_EQ(probes[0].target_data_rate.bps(), 500);
+}
+
+TEST_F(ProbeControllerTest, NoFastRecoveryProbeByDefault) {
+  probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
+                                 kMaxBitrateBps, NowMs());
+  probe_controller_->SetEstimatedBitrate(500, NowMs());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 2u);
+  clock_.AdvanceTimeMilliseconds(kExponentialProbingTimeoutMs);
+  probe_controller_->Process(NowMs());
+
+  probe_controller_->SetAlrStartTimeMs(clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(kAlrProbeInterval + 1);
+  probe_controller_->Process(NowMs());
+  probe_controller_->SetEstimatedBitrate(250, NowMs());
+  probe_controller_->SetAlrStartTimeMs(rtc::nullopt);
+  probe_controller_->SetAlrEndedTimeMs(clock_.TimeInMilliseconds());
+  EXPECT_EQ(probe_controller_->GetAndResetPendingProbes().size(), 0u);
+}
+
 TEST_F(ProbeControllerTest, PeriodicProbing) {
   probe_controller_->EnablePeriodicAlrProbing(true);
   probe_controller_->SetBitrates(kMinBitrateBps, kStartBitrateBps,
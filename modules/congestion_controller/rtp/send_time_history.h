@@ -11,8 +11,9 @@
 #ifndef MODULES_CONGESTION_CONTROLLER_RTP_SEND_TIME_HISTORY_H_
 #define MODULES_CONGESTION_CONTROLLER_RTP_SEND_TIME_HISTORY_H_
 
-#include <map>
+#include <vector>
 
+#include "api/optional.h"
 #include "modules/include/module_common_types.h"
 #include "rtc_base/constructormagic.h"
 
@@ -21,9 +22,22 @@ class Clock;
 struct PacketFeedback;
 namespace webrtc_cc {
 
+// History of sent packets, indexed by unwrapped transport-wide sequence
+// number. Packets are kept in a ring buffer that covers a window of
+// consecutive sequence numbers, so adding, looking up and expiring a packet
+// are O(1). The window holds at most |max_packets| sequence numbers; when a
+// new packet doesn't fit, the oldest are dropped. Storage grows by doubling,
+// up to |max_packets| rounded up to a power of two.
 class SendTimeHistory {
  public:
+  // Feedback only carries 16-bit sequence numbers, so packets more than half
+  // the sequence number space older than the newest ones can't be looked up.
+  static const size_t kDefaultMaxPackets = 1 << 15;
+
   SendTimeHistory(const Clock* clock, int64_t packet_age_limit_ms);
+  SendTimeHistory(const Clock* clock,
+                  int64_t packet_age_limit_ms,
+                  size_t max_packets);
   ~SendTimeHistory();
 
   // Cleanup old entries, then add new packet info with provided parameters.
@@ -45,10 +59,24 @@ class SendTimeHistory {
                              uint16_t remote_net_id) const;
 
  private:
+  rtc::Optional<PacketFeedback>& Slot(int64_t unwrapped_seq_num);
+  const rtc::Optional<PacketFeedback>& Slot(int64_t unwrapped_seq_num) const;
+  // Returns the packet with |unwrapped_seq_num|, or null.
+  PacketFeedback* Find(int64_t unwrapped_seq_num);
+  // Makes room for a window of |window_size| sequence numbers.
+  void Reserve(int64_t window_size);
+
   const Clock* const clock_;
   const int64_t packet_age_limit_ms_;
+  const size_t max_packets_;
   SequenceNumberUnwrapper seq_num_unwrapper_;
-  std::map<int64_t, PacketFeedback> history_;
+  // Ring buffer whose size is a power of two. Sequence number n is stored at
+  // n & (history_.size() - 1). Slots outside [first_seq_num_, end_seq_num_)
+  // are always empty; slots inside are empty for packets that were never
+  // added or have been removed.
+  std::vector<rtc::Optional<PacketFeedback>> history_;
+  int64_t first_seq_num_;
+  int64_t end_seq_num_;
   rtc::Optional<int64_t> latest_acked_seq_num_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(SendTimeHistory);
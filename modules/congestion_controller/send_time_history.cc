@@ -19,34 +19,88 @@
 
 namespace webrtc {
 
+namespace {
+
+// Initial ring buffer size. Grows by doubling as needed.
+constexpr size_t kInitialCapacity = 64;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t power = 1;
+  while (power < value)
+    power *= 2;
+  return power;
+}
+
+}  // namespace
+
+const size_t SendTimeHistory::kDefaultMaxPackets;
+
 SendTimeHistory::SendTimeHistory(const Clock* clock,
                                  int64_t packet_age_limit_ms)
-    : clock_(clock), packet_age_limit_ms_(packet_age_limit_ms) {}
+    : SendTimeHistory(clock, packet_age_limit_ms, kDefaultMaxPackets) {}
+
+SendTimeHistory::SendTimeHistory(const Clock* clock,
+                                 int64_t packet_age_limit_ms,
+                                 size_t max_packets)
+    : clock_(clock),
+      packet_age_limit_ms_(packet_age_limit_ms),
+      max_packets_(max_packets),
+      history_(std::min(kInitialCapacity, RoundUpToPowerOfTwo(max_packets))),
+      first_seq_num_(0),
+      end_seq_num_(0) {
+  RTC_DCHECK_GT(max_packets, 0);
+}
 
 SendTimeHistory::~SendTimeHistory() {}
 
 void SendTimeHistory::AddAndRemoveOld(const PacketFeedback& packet) {
   int64_t now_ms = clock_->TimeInMilliseconds();
   // Remove old.
-  while (!history_.empty() &&
-         now_ms - history_.begin()->second.creation_time_ms >
-             packet_age_limit_ms_) {
+  while (first_seq_num_ < end_seq_num_) {
+    rtc::Optional<PacketFeedback>& oldest = Slot(first_seq_num_);
+    if (oldest && now_ms - oldest->creation_time_ms <= packet_age_limit_ms_)
+      break;
     // TODO(sprang): Warn if erasing (too many) old items?
-    history_.erase(history_.begin());
+    oldest.reset();
+    ++first_seq_num_;
   }
 
   // Add new.
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(packet.sequence_number);
-  history_.insert(std::make_pair(unwrapped_seq_num, packet));
+  if (first_seq_num_ == end_seq_num_) {
+    first_seq_num_ = unwrapped_seq_num;
+    end_seq_num_ = unwrapped_seq_num;
+  }
+  const int64_t max_packets = static_cast<int64_t>(max_packets_);
+  if (unwrapped_seq_num < first_seq_num_) {
+    // Added out of order, before the oldest packet in the window.
+    if (end_seq_num_ - unwrapped_seq_num > max_packets)
+      return;
+    Reserve(end_seq_num_ - unwrapped_seq_num);
+    first_seq_num_ = unwrapped_seq_num;
+  } else if (unwrapped_seq_num >= end_seq_num_) {
+    int64_t new_end_seq_num = unwrapped_seq_num + 1;
+    // Drop the oldest packets that no longer fit in the window.
+    int64_t new_first_seq_num =
+        std::max(first_seq_num_, new_end_seq_num - max_packets);
+    for (int64_t seq_num = first_seq_num_;
+         seq_num < std::min(new_first_seq_num, end_seq_num_); ++seq_num) {
+      Slot(seq_num).reset();
+    }
+    first_seq_num_ = new_first_seq_num;
+    Reserve(new_end_seq_num - first_seq_num_);
+    end_seq_num_ = new_end_seq_num;
+  }
+  Slot(unwrapped_seq_num).emplace(packet);
 }
 
 bool SendTimeHistory::OnSentPacket(uint16_t sequence_number,
                                    int64_t send_time_ms) {
   int64_t unwrapped_seq_num = seq_num_unwrapper_.Unwrap(sequence_number);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = Find(unwrapped_seq_num);
+  if (!packet)
     return false;
-  it->second.send_time_ms = send_time_ms;
+  packet->send_time_ms = send_time_ms;
   return true;
 }
 
@@ -58,35 +112,65 @@ bool SendTimeHistory::GetFeedback(PacketFeedback* packet_feedback,
   latest_acked_seq_num_.emplace(
       std::max(unwrapped_seq_num, latest_acked_seq_num_.value_or(0)));
   RTC_DCHECK_GE(*latest_acked_seq_num_, 0);
-  auto it = history_.find(unwrapped_seq_num);
-  if (it == history_.end())
+  PacketFeedback* packet = Find(unwrapped_seq_num);
+  if (!packet)
     return false;
 
   // Save arrival_time not to overwrite it.
   int64_t arrival_time_ms = packet_feedback->arrival_time_ms;
-  *packet_feedback = it->second;
+  *packet_feedback = *packet;
   packet_feedback->arrival_time_ms = arrival_time_ms;
 
   if (remove)
-    history_.erase(it);
+    Slot(unwrapped_seq_num).reset();
   return true;
 }
 
 size_t SendTimeHistory::GetOutstandingBytes(uint16_t local_net_id,
                                             uint16_t remote_net_id) const {
   size_t outstanding_bytes = 0;
-  auto unacked_it = history_.begin();
+  int64_t unacked_seq_num = first_seq_num_;
   if (latest_acked_seq_num_) {
-    unacked_it = history_.lower_bound(*latest_acked_seq_num_);
+    unacked_seq_num = std::max(unacked_seq_num, *latest_acked_seq_num_);
   }
-  for (; unacked_it != history_.end(); ++unacked_it) {
-    if (unacked_it->second.local_net_id == local_net_id &&
-        unacked_it->second.remote_net_id == remote_net_id &&
-        unacked_it->second.send_time_ms >= 0) {
-      outstanding_bytes += unacked_it->second.payload_size;
+  for (; unacked_seq_num < end_seq_num_; ++unacked_seq_num) {
+    const rtc::Optional<PacketFeedback>& packet = Slot(unacked_seq_num);
+    if (packet && packet->local_net_id == local_net_id &&
+        packet->remote_net_id == remote_net_id && packet->send_time_ms >= 0) {
+      outstanding_bytes += packet->payload_size;
     }
   }
   return outstanding_bytes;
 }
 
+rtc::Optional<PacketFeedback>& SendTimeHistory::Slot(
+    int64_t unwrapped_seq_num) {
+  return history_[unwrapped_seq_num & (history_.size() - 1)];
+}
+
+const rtc::Optional<PacketFeedback>& SendTimeHistory::Slot(
+    int64_t unwrapped_seq_num) const {
+  return history_[unwrapped_seq_num & (history_.size() - 1)];
+}
+
+PacketFeedback* SendTimeHistory::Find(int64_t unwrapped_seq_num) {
+  if (unwrapped_seq_num < first_seq_num_ || unwrapped_seq_num >= end_seq_num_)
+    return nullptr;
+  rtc::Optional<PacketFeedback>& packet = Slot(unwrapped_seq_num);
+  return packet ? &*packet : nullptr;
+}
+
+void SendTimeHistory::Reserve(int64_t window_size) {
+  RTC_DCHECK_LE(window_size, static_cast<int64_t>(max_packets_));
+  size_t capacity = history_.size();
+  if (static_cast<size_t>(window_size) <= capacity)
+    return;
+  while (capacity < static_cast<size_t>(window_size))
+    capacity *= 2;
+  std::vector<rtc::Optional<PacketFeedback>> history(capacity);
+  for (int64_t seq_num = first_seq_num_; seq_num < end_seq_num_; ++seq_num)
+    history[seq_num & (capacity - 1)] = std::move(Slot(seq_num));
+  history_.swap(history);
+}
+
 }  // namespace webrtc
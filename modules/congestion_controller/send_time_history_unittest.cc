@@ -233,5 +233,51 @@ TEST_F(LegacySendTimeHistoryTest, InterlievedGetAndRemove) {
   EXPECT_TRUE(history_.GetFeedback(&packet3, true));
   EXPECT_EQ(packets[2], packet3);
 }
+
+TEST_F(LegacySendTimeHistoryTest, GrowsBeyondInitialCapacity) {
+  const int kNumPackets = 5000;
+  for (int i = 0; i < kNumPackets; ++i)
+    AddPacketWithSendTime(static_cast<uint16_t>(i), i, i, PacedPacketInfo());
+  for (int i = 0; i < kNumPackets; ++i) {
+    PacketFeedback packet(0, static_cast<uint16_t>(i));
+    EXPECT_TRUE(history_.GetFeedback(&packet, false));
+    EXPECT_EQ(i, packet.send_time_ms);
+  }
+}
+
+TEST_F(LegacySendTimeHistoryTest, DropsOldestPacketsWhenFull) {
+  const size_t kMaxPackets = 4;
+  SendTimeHistory history(&clock_, kDefaultHistoryLengthMs, kMaxPackets);
+  for (uint16_t i = 0; i < 6; ++i) {
+    history.AddAndRemoveOld(PacketFeedback(clock_.TimeInMilliseconds(), i, 100,
+                                           0, 0, PacedPacketInfo()));
+  }
+  for (uint16_t i = 0; i < 6; ++i) {
+    PacketFeedback packet(0, i);
+    EXPECT_EQ(i >= 2, history.GetFeedback(&packet, false));
+  }
+
+  // A gap wider than the window drops everything before it.
+  history.AddAndRemoveOld(PacketFeedback(clock_.TimeInMilliseconds(), 100, 100,
+                                         0, 0, PacedPacketInfo()));
+  PacketFeedback packet(0, 5);
+  EXPECT_FALSE(history.GetFeedback(&packet, false));
+  PacketFeedback packet2(0, 100);
+  EXPECT_TRUE(history.GetFeedback(&packet2, false));
+}
+
+TEST_F(LegacySendTimeHistoryTest, OutstandingBytesAfterLatestAcked) {
+  for (uint16_t i = 0; i < 10; ++i)
+    AddPacketWithSendTime(i, 100, i, PacedPacketInfo());
+  // Packets that have not been sent don't count.
+  history_.AddAndRemoveOld(PacketFeedback(clock_.TimeInMilliseconds(), 10, 100,
+                                          0, 0, PacedPacketInfo()));
+  EXPECT_EQ(1000u, history_.GetOutstandingBytes(0, 0));
+  EXPECT_EQ(0u, history_.GetOutstandingBytes(1, 0));
+
+  PacketFeedback packet(0, 5);
+  EXPECT_TRUE(history_.GetFeedback(&packet, true));
+  EXPECT_EQ(400u, history_.GetOutstandingBytes(0, 0));
+}
 }  // namespace test
 }  // namespace webrtc
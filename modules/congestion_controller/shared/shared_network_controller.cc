@@ -0,0 +1,382 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/shared/shared_network_controller.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/ptr_util.h"
+
+namespace webrtc {
+namespace {
+
+DataRate ScaleRate(DataRate rate, double factor) {
+  return rate.IsFinite() ? rate * factor : rate;
+}
+
+DataSize ScaleSize(DataSize size, double factor) {
+  return size.IsFinite() ? size * factor : size;
+}
+
+DataRate AddRates(DataRate a, DataRate b) {
+  if (a.IsInfinite() || b.IsInfinite())
+    return DataRate::Infinity();
+  return DataRate::bps(a.bps() + b.bps());
+}
+
+// Adds |rate| to |*sum|, if set.
+void AddOptionalRate(const rtc::Optional<DataRate>& rate,
+                     rtc::Optional<DataRate>* sum) {
+  if (rate)
+    *sum = AddRates(sum->value_or(DataRate::Zero()), *rate);
+}
+
+}  // namespace
+
+class SharedNetworkController::Member : public NetworkControllerInterface {
+ public:
+  Member(SharedNetworkController* shared,
+         double weight,
+         const NetworkControllerConfig& config)
+      : shared_(shared),
+        weight_(weight),
+        constraints_(config.constraints),
+        streams_config_(config.stream_based_config) {
+    shared_->AddMember(this, config);
+  }
+  ~Member() override { shared_->RemoveMember(this); }
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability msg) override;
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange msg) override;
+  NetworkControlUpdate OnProcessInterval(ProcessInterval msg) override;
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport msg) override;
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate msg) override;
+  NetworkControlUpdate OnSentPacket(SentPacket msg) override;
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig msg) override;
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints msg) override;
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override;
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override;
+
+ private:
+  friend class SharedNetworkController;
+
+  SharedNetworkController* const shared_;
+  const double weight_;
+  // The fields below are guarded by |shared_->crit_|.
+  TargetRateConstraints constraints_;
+  StreamsConfig streams_config_;
+  bool network_available_ = false;
+  DataSize data_in_flight_ = DataSize::Zero();
+  // Value of |shared_->state_version_| when this member last got its share.
+  int64_t reported_state_version_ = -1;
+};
+
+class SharedNetworkController::MemberFactory
+    : public NetworkControllerFactoryInterface {
+ public:
+  MemberFactory(SharedNetworkController* shared, double weight)
+      : shared_(shared), weight_(weight) {}
+
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return rtc::MakeUnique<Member>(shared_, weight_, config);
+  }
+  TimeDelta GetProcessInterval() const override {
+    return shared_->process_interval_;
+  }
+
+ private:
+  SharedNetworkController* const shared_;
+  const double weight_;
+};
+
+NetworkControlUpdate SharedNetworkController::Member::OnNetworkAvailability(
+    NetworkAvailability msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  network_available_ = msg.network_available;
+  bool available = shared_->AnyNetworkAvailable();
+  if (available == shared_->network_available_)
+    return shared_->MemberUpdate(this);
+  shared_->network_available_ = available;
+  msg.network_available = available;
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnNetworkAvailability(msg));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnNetworkRouteChange(
+    NetworkRouteChange msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  constraints_ = msg.constraints;
+  data_in_flight_ = DataSize::Zero();
+  msg.constraints = shared_->AggregateConstraints(msg.at_time);
+  if (msg.starting_rate)
+    msg.starting_rate = ScaleRate(*msg.starting_rate,
+                                  shared_->total_weight_ / weight_);
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnNetworkRouteChange(msg));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnProcessInterval(
+    ProcessInterval msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  shared_->latest_time_ = msg.at_time;
+  // Every member is driven at the process interval; the shared controller
+  // only needs one of them.
+  if (shared_->last_process_time_.IsFinite() &&
+      msg.at_time - shared_->last_process_time_ < shared_->process_interval_) {
+    return shared_->MemberUpdate(this);
+  }
+  shared_->last_process_time_ = msg.at_time;
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnProcessInterval(msg));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnRemoteBitrateReport(
+    RemoteBitrateReport msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnRemoteBitrateReport(msg));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnRoundTripTimeUpdate(
+    RoundTripTimeUpdate msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnRoundTripTimeUpdate(msg));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnSentPacket(
+    SentPacket msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  return shared_->OnControllerUpdate(this,
+                                     shared_->controller_->OnSentPacket(msg));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnStreamsConfig(
+    StreamsConfig msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  streams_config_ = msg;
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnStreamsConfig(
+                shared_->AggregateStreamsConfig(msg.at_time, msg)));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnTargetRateConstraints(
+    TargetRateConstraints msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  constraints_ = msg;
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnTargetRateConstraints(
+                shared_->AggregateConstraints(msg.at_time)));
+}
+
+NetworkControlUpdate SharedNetworkController::Member::OnTransportLossReport(
+    TransportLossReport msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnTransportLossReport(msg));
+}
+
+NetworkControlUpdate
+SharedNetworkController::Member::OnTransportPacketsFeedback(
+    TransportPacketsFeedback msg) {
+  rtc::CritScope cs(&shared_->crit_);
+  // The other members' packets are in flight on the same path.
+  DataSize others_in_flight = shared_->TotalDataInFlight() - data_in_flight_;
+  data_in_flight_ = msg.data_in_flight;
+  msg.data_in_flight += others_in_flight;
+  msg.prior_in_flight += others_in_flight;
+  return shared_->OnControllerUpdate(
+      this, shared_->controller_->OnTransportPacketsFeedback(msg));
+}
+
+SharedNetworkController::SharedNetworkController(
+    std::unique_ptr<NetworkControllerFactoryInterface> factory)
+    : factory_(std::move(factory)),
+      process_interval_(factory_->GetProcessInterval()),
+      total_weight_(0),
+      network_available_(false),
+      last_process_time_(Timestamp::Infinity()),
+      latest_time_(Timestamp::Infinity()),
+      state_version_(0) {}
+
+SharedNetworkController::~SharedNetworkController() {
+  RTC_DCHECK(members_.empty());
+}
+
+std::unique_ptr<NetworkControllerFactoryInterface>
+SharedNetworkController::CreateMemberFactory(double weight) {
+  RTC_DCHECK_GT(weight, 0);
+  return rtc::MakeUnique<MemberFactory>(this, weight);
+}
+
+size_t SharedNetworkController::NumMembersForTest() const {
+  rtc::CritScope cs(&crit_);
+  return members_.size();
+}
+
+void SharedNetworkController::AddMember(Member* member,
+                                        const NetworkControllerConfig& config) {
+  rtc::CritScope cs(&crit_);
+  members_.push_back(member);
+  total_weight_ += member->weight_;
+  ++state_version_;
+  latest_time_ = config.constraints.at_time;
+  if (!controller_) {
+    controller_ = factory_->Create(config);
+    return;
+  }
+  OnControllerUpdate(nullptr, controller_->OnTargetRateConstraints(
+                                  AggregateConstraints(latest_time_)));
+  OnControllerUpdate(nullptr,
+                     controller_->OnStreamsConfig(AggregateStreamsConfig(
+                         latest_time_, config.stream_based_config)));
+}
+
+void SharedNetworkController::RemoveMember(Member* member) {
+  rtc::CritScope cs(&crit_);
+  auto it = std::find(members_.begin(), members_.end(), member);
+  RTC_DCHECK(it != members_.end());
+  members_.erase(it);
+  ++state_version_;
+  if (members_.empty()) {
+    // Start over with the next member.
+    controller_.reset();
+    total_weight_ = 0;
+    network_available_ = false;
+    last_process_time_ = Timestamp::Infinity();
+    state_ = State();
+    pending_probe_clusters_.clear();
+    return;
+  }
+  total_weight_ -= member->weight_;
+  if (network_available_ && !AnyNetworkAvailable()) {
+    network_available_ = false;
+    NetworkAvailability msg;
+    msg.at_time = latest_time_;
+    msg.network_available = false;
+    OnControllerUpdate(nullptr, controller_->OnNetworkAvailability(msg));
+  }
+  OnControllerUpdate(nullptr, controller_->OnTargetRateConstraints(
+                                  AggregateConstraints(latest_time_)));
+  OnControllerUpdate(
+      nullptr, controller_->OnStreamsConfig(AggregateStreamsConfig(
+                   latest_time_, members_.front()->streams_config_)));
+}
+
+NetworkControlUpdate SharedNetworkController::OnControllerUpdate(
+    Member* member,
+    NetworkControlUpdate update) {
+  bool changed = false;
+  if (update.target_rate) {
+    state_.target_rate = update.target_rate;
+    changed = true;
+  }
+  if (update.pacer_config) {
+    state_.pacer_config = update.pacer_config;
+    changed = true;
+  }
+  if (update.congestion_window) {
+    state_.congestion_window = update.congestion_window;
+    changed = true;
+  }
+  if (changed)
+    ++state_version_;
+  // Probes are sent by one member only. Those triggered without a member
+  // calling go to the next one that does.
+  pending_probe_clusters_.insert(pending_probe_clusters_.end(),
+                                 update.probe_cluster_configs.begin(),
+                                 update.probe_cluster_configs.end());
+  if (!member)
+    return NetworkControlUpdate();
+  return MemberUpdate(member);
+}
+
+NetworkControlUpdate SharedNetworkController::MemberUpdate(Member* member) {
+  NetworkControlUpdate update;
+  update.probe_cluster_configs.swap(pending_probe_clusters_);
+  if (member->reported_state_version_ == state_version_)
+    return update;
+  member->reported_state_version_ = state_version_;
+
+  double share = member->weight_ / total_weight_;
+  if (state_.target_rate) {
+    TargetTransferRate target_rate = *state_.target_rate;
+    target_rate.target_rate = ScaleRate(target_rate.target_rate, share);
+    target_rate.network_estimate.bandwidth =
+        ScaleRate(target_rate.network_estimate.bandwidth, share);
+    update.target_rate = target_rate;
+  }
+  if (state_.pacer_config) {
+    PacerConfig pacer_config = *state_.pacer_config;
+    pacer_config.data_window = ScaleSize(pacer_config.data_window, share);
+    pacer_config.pad_window = ScaleSize(pacer_config.pad_window, share);
+    update.pacer_config = pacer_config;
+  }
+  if (state_.congestion_window)
+    update.congestion_window = ScaleSize(*state_.congestion_window, share);
+  return update;
+}
+
+TargetRateConstraints SharedNetworkController::AggregateConstraints(
+    Timestamp at_time) const {
+  TargetRateConstraints constraints;
+  constraints.at_time = at_time;
+  bool all_have_max = true;
+  for (const Member* member : members_) {
+    AddOptionalRate(member->constraints_.min_data_rate,
+                    &constraints.min_data_rate);
+    AddOptionalRate(member->constraints_.max_data_rate,
+                    &constraints.max_data_rate);
+    all_have_max &= member->constraints_.max_data_rate.has_value();
+  }
+  // A member without a limit lifts the limit of the aggregate.
+  if (!all_have_max)
+    constraints.max_data_rate.reset();
+  return constraints;
+}
+
+StreamsConfig SharedNetworkController::AggregateStreamsConfig(
+    Timestamp at_time,
+    const StreamsConfig& latest) const {
+  StreamsConfig config;
+  config.at_time = at_time;
+  config.pacing_factor = latest.pacing_factor;
+  for (const Member* member : members_) {
+    const StreamsConfig& member_config = member->streams_config_;
+    config.requests_alr_probing |= member_config.requests_alr_probing;
+    AddOptionalRate(member_config.min_pacing_rate, &config.min_pacing_rate);
+    AddOptionalRate(member_config.max_padding_rate, &config.max_padding_rate);
+    AddOptionalRate(member_config.max_total_allocated_bitrate,
+                    &config.max_total_allocated_bitrate);
+  }
+  return config;
+}
+
+bool SharedNetworkController::AnyNetworkAvailable() const {
+  for (const Member* member : members_) {
+    if (member->network_available_)
+      return true;
+  }
+  return false;
+}
+
+DataSize SharedNetworkController::TotalDataInFlight() const {
+  DataSize data_in_flight = DataSize::Zero();
+  for (const Member* member : members_)
+    data_in_flight += member->data_in_flight_;
+  return data_in_flight;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,118 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_CONGESTION_CONTROLLER_SHARED_SHARED_NETWORK_CONTROLLER_H_
+#define MODULES_CONGESTION_CONTROLLER_SHARED_SHARED_NETWORK_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
+#include "api/optional.h"
+#include "api/transport/network_control.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace webrtc {
+
+// Lets several Calls that send to the same remote host, e.g. many
+// PeerConnections from a gateway to one SFU, share a single network
+// controller instead of competing for the bottleneck with one each.
+//
+// Each Call gets a factory from CreateMemberFactory() to use as the
+// NetworkControllerFactoryInterface of its RtpTransportControllerSend. The
+// messages of all members go to one controller created by the wrapped
+// factory, so the aggregate flow has one bandwidth estimate and one probing
+// schedule:
+//  - Target rate, pacing rates and congestion window are split between the
+//    members in proportion to their weights.
+//  - Probe clusters are only returned to the member whose message triggered
+//    them.
+//  - Constraints, stream configs and data in flight are summed over the
+//    members, and the network is available if it is for any member.
+//  - Process intervals are forwarded at most once per interval.
+//
+// Members keep their own pacers. A member sees a new estimate the next time
+// it calls its controller, which is at least once per process interval.
+// Transport sequence numbers are forwarded as is, so the wrapped controller
+// must not rely on them being unique across members.
+//
+// Thread safe; members may run on different task queues. Must outlive every
+// controller created by its member factories.
+class SharedNetworkController {
+ public:
+  explicit SharedNetworkController(
+      std::unique_ptr<NetworkControllerFactoryInterface> factory);
+  ~SharedNetworkController();
+
+  // |weight| must be positive.
+  std::unique_ptr<NetworkControllerFactoryInterface> CreateMemberFactory(
+      double weight);
+
+  size_t NumMembersForTest() const;
+
+ private:
+  class Member;
+  class MemberFactory;
+
+  // Latest output of the shared controller.
+  struct State {
+    rtc::Optional<TargetTransferRate> target_rate;
+    rtc::Optional<PacerConfig> pacer_config;
+    rtc::Optional<DataSize> congestion_window;
+  };
+
+  void AddMember(Member* member, const NetworkControllerConfig& config);
+  void RemoveMember(Member* member);
+
+  // Both called with |crit_| held. Records the output of the shared
+  // controller, and returns |member|'s share of everything it hasn't seen
+  // yet, plus |update|'s probe clusters.
+  NetworkControlUpdate OnControllerUpdate(Member* member,
+                                          NetworkControlUpdate update)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  NetworkControlUpdate MemberUpdate(Member* member)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  TargetRateConstraints AggregateConstraints(Timestamp at_time) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  StreamsConfig AggregateStreamsConfig(Timestamp at_time,
+                                       const StreamsConfig& latest) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  bool AnyNetworkAvailable() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  DataSize TotalDataInFlight() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  const std::unique_ptr<NetworkControllerFactoryInterface> factory_;
+  const TimeDelta process_interval_;
+
+  rtc::CriticalSection crit_;
+  std::unique_ptr<NetworkControllerInterface> controller_
+      RTC_GUARDED_BY(crit_);
+  std::vector<Member*> members_ RTC_GUARDED_BY(crit_);
+  double total_weight_ RTC_GUARDED_BY(crit_);
+  bool network_available_ RTC_GUARDED_BY(crit_);
+  Timestamp last_process_time_ RTC_GUARDED_BY(crit_);
+  Timestamp latest_time_ RTC_GUARDED_BY(crit_);
+  State state_ RTC_GUARDED_BY(crit_);
+  // Probe clusters the shared controller produced while no member was
+  // calling it, e.g. when one joined or left.
+  std::vector<ProbeClusterConfig> pending_probe_clusters_
+      RTC_GUARDED_BY(crit_);
+  // Incremented whenever |state_| or the members' shares change.
+  int64_t state_version_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedNetworkController);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_CONGESTION_CONTROLLER_SHARED_SHARED_NETWORK_CONTROLLER_H_
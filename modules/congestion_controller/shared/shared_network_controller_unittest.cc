@@ -0,0 +1,297 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/congestion_controller/shared/shared_network_controller.h"
+
+#include <memory>
+#include <utility>
+
+#include "rtc_base/ptr_util.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace test {
+namespace {
+
+const TimeDelta kProcessInterval = TimeDelta::ms(25);
+
+// What the fake controllers have been told, shared with the test.
+struct FakeControllerLog {
+  int num_created = 0;
+  int num_destroyed = 0;
+  int num_process_intervals = 0;
+  TargetRateConstraints constraints;
+  StreamsConfig streams_config;
+  bool network_available = false;
+  DataSize data_in_flight = DataSize::Zero();
+  // Returned from the next call to the controller.
+  NetworkControlUpdate next_update;
+};
+
+class FakeController : public NetworkControllerInterface {
+ public:
+  FakeController(FakeControllerLog* log, const NetworkControllerConfig& config)
+      : log_(log) {
+    ++log_->num_created;
+    log_->constraints = config.constraints;
+    log_->streams_config = config.stream_based_config;
+  }
+  ~FakeController() override { ++log_->num_destroyed; }
+
+  NetworkControlUpdate OnNetworkAvailability(NetworkAvailability msg) override {
+    log_->network_available = msg.network_available;
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnNetworkRouteChange(NetworkRouteChange msg) override {
+    log_->constraints = msg.constraints;
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnProcessInterval(ProcessInterval msg) override {
+    ++log_->num_process_intervals;
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnRemoteBitrateReport(RemoteBitrateReport msg) override {
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnRoundTripTimeUpdate(RoundTripTimeUpdate msg) override {
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnSentPacket(SentPacket msg) override {
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnStreamsConfig(StreamsConfig msg) override {
+    log_->streams_config = msg;
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnTargetRateConstraints(
+      TargetRateConstraints msg) override {
+    log_->constraints = msg;
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnTransportLossReport(TransportLossReport msg) override {
+    return TakeUpdate();
+  }
+  NetworkControlUpdate OnTransportPacketsFeedback(
+      TransportPacketsFeedback msg) override {
+    log_->data_in_flight = msg.data_in_flight;
+    return TakeUpdate();
+  }
+
+ private:
+  NetworkControlUpdate TakeUpdate() {
+    NetworkControlUpdate update = std::move(log_->next_update);
+    log_->next_update = NetworkControlUpdate();
+    return update;
+  }
+
+  FakeControllerLog* const log_;
+};
+
+class FakeControllerFactory : public NetworkControllerFactoryInterface {
+ public:
+  explicit FakeControllerFactory(FakeControllerLog* log) : log_(log) {}
+  std::unique_ptr<NetworkControllerInterface> Create(
+      NetworkControllerConfig config) override {
+    return rtc::MakeUnique<FakeController>(log_, config);
+  }
+  TimeDelta GetProcessInterval() const override { return kProcessInterval; }
+
+ private:
+  FakeControllerLog* const log_;
+};
+
+NetworkControllerConfig MemberConfig(DataRate min_rate, DataRate max_rate) {
+  NetworkControllerConfig config;
+  config.constraints.at_time = Timestamp::ms(1000);
+  config.constraints.min_data_rate = min_rate;
+  config.constraints.max_data_rate = max_rate;
+  config.starting_bandwidth = DataRate::kbps(300);
+  return config;
+}
+
+NetworkControlUpdate TargetRateUpdate(DataRate rate) {
+  NetworkControlUpdate update;
+  TargetTransferRate target_rate;
+  target_rate.at_time = Timestamp::ms(1000);
+  target_rate.target_rate = rate;
+  target_rate.network_estimate.bandwidth = rate;
+  update.target_rate = target_rate;
+  PacerConfig pacer_config;
+  pacer_config.at_time = Timestamp::ms(1000);
+  pacer_config.time_window = TimeDelta::seconds(1);
+  pacer_config.data_window = rate * TimeDelta::seconds(1);
+  pacer_config.pad_window = DataSize::Zero();
+  update.pacer_config = pacer_config;
+  return update;
+}
+
+ProcessInterval ProcessAt(int64_t time_ms) {
+  ProcessInterval msg;
+  msg.at_time = Timestamp::ms(time_ms);
+  return msg;
+}
+
+class SharedNetworkControllerTest : public ::testing::Test {
+ protected:
+  SharedNetworkControllerTest()
+      : shared_(rtc::MakeUnique<FakeControllerFactory>(&log_)) {}
+
+  std::unique_ptr<NetworkControllerInterface> CreateMember(
+      double weight,
+      DataRate min_rate = DataRate::kbps(30),
+      DataRate max_rate = DataRate::kbps(2000)) {
+    return shared_.CreateMemberFactory(weight)->Create(
+        MemberConfig(min_rate, max_rate));
+  }
+
+  FakeControllerLog log_;
+  SharedNetworkController shared_;
+};
+
+}  // namespace
+
+TEST_F(SharedNetworkControllerTest, CreatesOneControllerForAllMembers) {
+  auto first = CreateMember(1);
+  auto second = CreateMember(1);
+  EXPECT_EQ(1, log_.num_created);
+  EXPECT_EQ(2u, shared_.NumMembersForTest());
+
+  second.reset();
+  EXPECT_EQ(0, log_.num_destroyed);
+  first.reset();
+  EXPECT_EQ(1, log_.num_destroyed);
+  EXPECT_EQ(0u, shared_.NumMembersForTest());
+
+  // A new member starts over with a new controller.
+  auto third = CreateMember(1);
+  EXPECT_EQ(2, log_.num_created);
+}
+
+TEST_F(SharedNetworkControllerTest, SplitsTargetRateByWeight) {
+  auto light = CreateMember(1);
+  auto heavy = CreateMember(3);
+
+  log_.next_update = TargetRateUpdate(DataRate::kbps(800));
+  NetworkControlUpdate light_update = light->OnProcessInterval(ProcessAt(1000));
+  ASSERT_TRUE(light_update.target_rate);
+  EXPECT_EQ(DataRate::kbps(200), light_update.target_rate->target_rate);
+  EXPECT_EQ(DataRate::kbps(200),
+            light_update.target_rate->network_estimate.bandwidth);
+  ASSERT_TRUE(light_update.pacer_config);
+  EXPECT_EQ(DataSize::bytes(25000), light_update.pacer_config->data_window);
+
+  // The other member gets its share on its next call, without a new estimate.
+  NetworkControlUpdate heavy_update = heavy->OnProcessInterval(ProcessAt(1010));
+  ASSERT_TRUE(heavy_update.target_rate);
+  EXPECT_EQ(DataRate::kbps(600), heavy_update.target_rate->target_rate);
+
+  // Nothing new to report.
+  EXPECT_FALSE(light->OnProcessInterval(ProcessAt(1020)).target_rate);
+}
+
+TEST_F(SharedNetworkControllerTest, RedistributesRateWhenMemberLeaves) {
+  auto first = CreateMember(1);
+  auto second = CreateMember(1);
+  log_.next_update = TargetRateUpdate(DataRate::kbps(800));
+  NetworkControlUpdate update = first->OnProcessInterval(ProcessAt(1000));
+  ASSERT_TRUE(update.target_rate);
+  EXPECT_EQ(DataRate::kbps(400), update.target_rate->target_rate);
+
+  second.reset();
+  update = first->OnProcessInterval(ProcessAt(1010));
+  ASSERT_TRUE(update.target_rate);
+  EXPECT_EQ(DataRate::kbps(800), update.target_rate->target_rate);
+}
+
+TEST_F(SharedNetworkControllerTest, ForwardsOneProcessIntervalPerInterval) {
+  auto first = CreateMember(1);
+  auto second = CreateMember(1);
+  first->OnProcessInterval(ProcessAt(1000));
+  second->OnProcessInterval(ProcessAt(1005));
+  EXPECT_EQ(1, log_.num_process_intervals);
+  second->OnProcessInterval(ProcessAt(1025));
+  first->OnProcessInterval(ProcessAt(1030));
+  EXPECT_EQ(2, log_.num_process_intervals);
+}
+
+TEST_F(SharedNetworkControllerTest, ReturnsProbesToCallingMemberOnly) {
+  auto first = CreateMember(1);
+  auto second = CreateMember(1);
+  ProbeClusterConfig probe;
+  probe.at_time = Timestamp::ms(1000);
+  probe.target_data_rate = DataRate::kbps(1000);
+  log_.next_update.probe_cluster_configs.push_back(probe);
+
+  NetworkControlUpdate update = second->OnProcessInterval(ProcessAt(1000));
+  ASSERT_EQ(1u, update.probe_cluster_configs.size());
+  EXPECT_EQ(DataRate::kbps(1000),
+            update.probe_cluster_configs[0].target_data_rate);
+  EXPECT_TRUE(
+      first->OnProcessInterval(ProcessAt(1030)).probe_cluster_configs.empty());
+}
+
+TEST_F(SharedNetworkControllerTest, SumsConstraintsOverMembers) {
+  auto first = CreateMember(1, DataRate::kbps(30), DataRate::kbps(1000));
+  auto second = CreateMember(1, DataRate::kbps(50), DataRate::kbps(2000));
+  ASSERT_TRUE(log_.constraints.min_data_rate);
+  ASSERT_TRUE(log_.constraints.max_data_rate);
+  EXPECT_EQ(DataRate::kbps(80), *log_.constraints.min_data_rate);
+  EXPECT_EQ(DataRate::kbps(3000), *log_.constraints.max_data_rate);
+
+  // A member without a limit lifts the limit of the aggregate.
+  TargetRateConstraints constraints;
+  constraints.at_time = Timestamp::ms(1000);
+  constraints.min_data_rate = DataRate::kbps(30);
+  second->OnTargetRateConstraints(constraints);
+  EXPECT_EQ(DataRate::kbps(60), *log_.constraints.min_data_rate);
+  EXPECT_FALSE(log_.constraints.max_data_rate);
+
+  second.reset();
+  ASSERT_TRUE(log_.constraints.max_data_rate);
+  EXPECT_EQ(DataRate::kbps(1000), *log_.constraints.max_data_rate);
+}
+
+TEST_F(SharedNetworkControllerTest, NetworkAvailableIfAvailableForAnyMember) {
+  auto first = CreateMember(1);
+  auto second = CreateMember(1);
+  NetworkAvailability msg;
+  msg.at_time = Timestamp::ms(1000);
+  msg.network_available = true;
+  first->OnNetworkAvailability(msg);
+  EXPECT_TRUE(log_.network_available);
+
+  msg.network_available = false;
+  second->OnNetworkAvailability(msg);
+  EXPECT_TRUE(log_.network_available);
+
+  first.reset();
+  EXPECT_FALSE(log_.network_available);
+}
+
+TEST_F(SharedNetworkControllerTest, AddsDataInFlightOfOtherMembers) {
+  auto first = CreateMember(1);
+  auto second = CreateMember(1);
+  TransportPacketsFeedback feedback;
+  feedback.feedback_time = Timestamp::ms(1000);
+  feedback.data_in_flight = DataSize::bytes(3000);
+  first->OnTransportPacketsFeedback(feedback);
+  EXPECT_EQ(DataSize::bytes(3000), log_.data_in_flight);
+
+  feedback.data_in_flight = DataSize::bytes(2000);
+  second->OnTransportPacketsFeedback(feedback);
+  EXPECT_EQ(DataSize::bytes(5000), log_.data_in_flight);
+
+  feedback.data_in_flight = DataSize::bytes(1000);
+  first->OnTransportPacketsFeedback(feedback);
+  EXPECT_EQ(DataSize::bytes(3000), log_.data_in_flight);
+}
+
+}  // namespace test
+}  // namespace webrtc
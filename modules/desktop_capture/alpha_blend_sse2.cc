@@ -0,0 +1,81 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/alpha_blend_sse2.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <emmintrin.h>
+#endif
+
+namespace webrtc {
+
+namespace {
+
+// Returns |dest| * |base_alpha| / 255 + |src| for eight 16-bit channels,
+// truncated to 8 bits. x / 255 is computed as (x + 1 + (x >> 8)) >> 8, which
+// is exact for all x <= 255 * 255.
+inline __m128i BlendChannels(__m128i dest, __m128i src, __m128i base_alpha) {
+  const __m128i one = _mm_set1_epi16(1);
+  const __m128i low_byte = _mm_set1_epi16(0xff);
+  __m128i product = _mm_mullo_epi16(dest, base_alpha);
+  product = _mm_add_epi16(_mm_add_epi16(product, one),
+                          _mm_srli_epi16(product, 8));
+  product = _mm_srli_epi16(product, 8);
+  return _mm_and_si128(_mm_add_epi16(product, src), low_byte);
+}
+
+}  // namespace
+
+extern void AlphaBlendPixels_SSE2(uint8_t* dest,
+                                  const uint8_t* src,
+                                  int count) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i alpha_mask = _mm_set1_epi32(0xff000000);
+  __m128i* d = reinterpret_cast<__m128i*>(dest);
+  const __m128i* s = reinterpret_cast<const __m128i*>(src);
+  for (int i = 0; i < count; i += 4, ++d, ++s) {
+    const __m128i src_pixels = _mm_loadu_si128(s);
+    const __m128i src_alpha = _mm_and_si128(src_pixels, alpha_mask);
+    const __m128i transparent = _mm_cmpeq_epi32(src_alpha, zero);
+    if (_mm_movemask_epi8(transparent) == 0xffff)
+      continue;
+    const __m128i opaque = _mm_cmpeq_epi32(src_alpha, alpha_mask);
+    const __m128i dest_pixels = _mm_loadu_si128(d);
+
+    // 255 - alpha of each pixel, replicated into its four 16-bit channels.
+    __m128i base_alpha =
+        _mm_srli_epi32(_mm_andnot_si128(src_pixels, alpha_mask), 24);
+    base_alpha = _mm_or_si128(base_alpha, _mm_slli_epi32(base_alpha, 16));
+
+    const __m128i low = BlendChannels(_mm_unpacklo_epi8(dest_pixels, zero),
+                                      _mm_unpacklo_epi8(src_pixels, zero),
+                                      _mm_unpacklo_epi32(base_alpha,
+                                                         base_alpha));
+    const __m128i high = BlendChannels(_mm_unpackhi_epi8(dest_pixels, zero),
+                                       _mm_unpackhi_epi8(src_pixels, zero),
+                                       _mm_unpackhi_epi32(base_alpha,
+                                                          base_alpha));
+    __m128i result = _mm_packus_epi16(low, high);
+    // Blended pixels keep the alpha of |dest|.
+    result = _mm_or_si128(_mm_andnot_si128(alpha_mask, result),
+                          _mm_and_si128(alpha_mask, dest_pixels));
+    // Fully opaque source pixels are copied, fully transparent ones are
+    // skipped.
+    result = _mm_or_si128(_mm_and_si128(opaque, src_pixels),
+                          _mm_andnot_si128(opaque, result));
+    result = _mm_or_si128(_mm_and_si128(transparent, dest_pixels),
+                          _mm_andnot_si128(transparent, result));
+    _mm_storeu_si128(d, result);
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,28 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// This header file is used only by desktop_and_cursor_composer.cc. It defines
+// the SSE2 routine for blending the cursor into a frame.
+
+#ifndef MODULES_DESKTOP_CAPTURE_ALPHA_BLEND_SSE2_H_
+#define MODULES_DESKTOP_CAPTURE_ALPHA_BLEND_SSE2_H_
+
+#include <stdint.h>
+
+namespace webrtc {
+
+// Blends |count| pre-multiplied BGRA pixels from |src| into the opaque pixels
+// in |dest|. |count| must be a multiple of 4. Produces exactly the same output
+// as the C version in desktop_and_cursor_composer.cc.
+extern void AlphaBlendPixels_SSE2(uint8_t* dest, const uint8_t* src, int count);
+
+}  // namespace webrtc
+
+#endif  // MODULES_DESKTOP_CAPTURE_ALPHA_BLEND_SSE2_H_
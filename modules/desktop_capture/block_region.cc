@@ -0,0 +1,169 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/block_region.h"
+
+#include <algorithm>
+
+#include "modules/desktop_capture/differ_block.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+
+const int kBitsPerWord = 64;
+
+int BlocksToCover(int pixels) {
+  return (pixels + kBlockSize - 1) / kBlockSize;
+}
+
+}  // namespace
+
+BlockRegion::BlockRegion(const DesktopRect& area)
+    : area_(area),
+      width_in_blocks_(BlocksToCover(area.width())),
+      height_in_blocks_(BlocksToCover(area.height())),
+      words_per_row_((width_in_blocks_ + kBitsPerWord - 1) / kBitsPerWord),
+      bits_(words_per_row_ * height_in_blocks_, 0) {
+  RTC_DCHECK_GE(area.width(), 0);
+  RTC_DCHECK_GE(area.height(), 0);
+}
+
+BlockRegion::BlockRegion(const BlockRegion& other) = default;
+
+BlockRegion::~BlockRegion() {}
+
+BlockRegion& BlockRegion::operator=(const BlockRegion& other) = default;
+
+bool BlockRegion::is_empty() const {
+  for (uint64_t word : bits_) {
+    if (word != 0)
+      return false;
+  }
+  return true;
+}
+
+void BlockRegion::Clear() {
+  std::fill(bits_.begin(), bits_.end(), 0);
+}
+
+bool BlockRegion::IsBlockSet(int x, int y) const {
+  RTC_DCHECK_GE(x, 0);
+  RTC_DCHECK_LT(x, width_in_blocks_);
+  RTC_DCHECK_GE(y, 0);
+  RTC_DCHECK_LT(y, height_in_blocks_);
+  return (row(y)[x / kBitsPerWord] >> (x % kBitsPerWord)) & 1;
+}
+
+void BlockRegion::AddBlocks(int y, int left, int right) {
+  RTC_DCHECK_GE(y, 0);
+  RTC_DCHECK_LT(y, height_in_blocks_);
+  RTC_DCHECK_GE(left, 0);
+  RTC_DCHECK_LE(right, width_in_blocks_);
+  uint64_t* words = row(y);
+  for (int x = left; x < right;) {
+    const int bit = x % kBitsPerWord;
+    const int count = std::min(kBitsPerWord - bit, right - x);
+    const uint64_t mask =
+        count == kBitsPerWord ? ~uint64_t{0} : (uint64_t{1} << count) - 1;
+    words[x / kBitsPerWord] |= mask << bit;
+    x += count;
+  }
+}
+
+void BlockRegion::AddRect(const DesktopRect& rect) {
+  DesktopRect clipped = rect;
+  clipped.IntersectWith(area_);
+  if (clipped.is_empty())
+    return;
+  const int left = (clipped.left() - area_.left()) / kBlockSize;
+  const int right = BlocksToCover(clipped.right() - area_.left());
+  const int top = (clipped.top() - area_.top()) / kBlockSize;
+  const int bottom = BlocksToCover(clipped.bottom() - area_.top());
+  for (int y = top; y < bottom; ++y)
+    AddBlocks(y, left, right);
+}
+
+void BlockRegion::AddRegion(const BlockRegion& region) {
+  RTC_DCHECK(area_.equals(region.area_));
+  for (size_t i = 0; i < bits_.size(); ++i)
+    bits_[i] |= region.bits_[i];
+}
+
+void BlockRegion::IntersectWith(const BlockRegion& region) {
+  RTC_DCHECK(area_.equals(region.area_));
+  for (size_t i = 0; i < bits_.size(); ++i)
+    bits_[i] &= region.bits_[i];
+}
+
+void BlockRegion::Subtract(const BlockRegion& region) {
+  RTC_DCHECK(area_.equals(region.area_));
+  for (size_t i = 0; i < bits_.size(); ++i)
+    bits_[i] &= ~region.bits_[i];
+}
+
+void BlockRegion::AddToDesktopRegion(DesktopRegion* output) const {
+  int y = 0;
+  while (y < height_in_blocks_) {
+    // Consecutive block-rows with the same blocks set are emitted as a single
+    // band, so that |output| doesn't need to merge them row by row.
+    const uint64_t* words = row(y);
+    int bottom = y + 1;
+    while (bottom < height_in_blocks_ &&
+           std::equal(words, words + words_per_row_, row(bottom))) {
+      ++bottom;
+    }
+    const int top_px = area_.top() + y * kBlockSize;
+    const int bottom_px =
+        std::min(area_.top() + bottom * kBlockSize, area_.bottom());
+    for (int x = FindSetBlock(words, 0); x < width_in_blocks_;) {
+      const int end = FindUnsetBlock(words, x);
+      output->AddRect(DesktopRect::MakeLTRB(
+          area_.left() + x * kBlockSize, top_px,
+          std::min(area_.left() + end * kBlockSize, area_.right()),
+          bottom_px));
+      x = FindSetBlock(words, end);
+    }
+    y = bottom;
+  }
+}
+
+int BlockRegion::FindSetBlock(const uint64_t* words, int x) const {
+  while (x < width_in_blocks_) {
+    uint64_t word = words[x / kBitsPerWord] >> (x % kBitsPerWord);
+    if (word != 0) {
+      while (!(word & 1)) {
+        word >>= 1;
+        ++x;
+      }
+      return x;
+    }
+    x = (x / kBitsPerWord + 1) * kBitsPerWord;
+  }
+  return width_in_blocks_;
+}
+
+int BlockRegion::FindUnsetBlock(const uint64_t* words, int x) const {
+  while (x < width_in_blocks_) {
+    uint64_t word = ~words[x / kBitsPerWord] >> (x % kBitsPerWord);
+    if (word != 0) {
+      while (!(word & 1)) {
+        word >>= 1;
+        ++x;
+      }
+      return std::min(x, width_in_blocks_);
+    }
+    x = (x / kBitsPerWord + 1) * kBitsPerWord;
+  }
+  return width_in_blocks_;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,88 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_DESKTOP_CAPTURE_BLOCK_REGION_H_
+#define MODULES_DESKTOP_CAPTURE_BLOCK_REGION_H_
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "modules/desktop_capture/desktop_geometry.h"
+#include "modules/desktop_capture/desktop_region.h"
+
+namespace webrtc {
+
+// BlockRegion represents a region of |area| as a bitmap of kBlockSize x
+// kBlockSize blocks, aligned to the top-left corner of |area|. Blocks on the
+// right and bottom edges are clipped to |area|.
+//
+// Unlike DesktopRegion it does not allocate when blocks are added, and union,
+// intersection and subtraction are word-wise bit operations. This makes it
+// cheap to accumulate highly fragmented regions, e.g. the output of the
+// differ, and convert them to a DesktopRegion once.
+class BlockRegion {
+ public:
+  explicit BlockRegion(const DesktopRect& area);
+  BlockRegion(const BlockRegion& other);
+  ~BlockRegion();
+
+  BlockRegion& operator=(const BlockRegion& other);
+
+  const DesktopRect& area() const { return area_; }
+  int width_in_blocks() const { return width_in_blocks_; }
+  int height_in_blocks() const { return height_in_blocks_; }
+
+  bool is_empty() const;
+
+  // Reset the region to be empty.
+  void Clear();
+
+  // Returns true if the block at (|x|, |y|), in blocks, is in the region.
+  bool IsBlockSet(int x, int y) const;
+
+  // Adds blocks [|left|, |right|) of block-row |y| to the region.
+  void AddBlocks(int y, int left, int right);
+
+  // Adds all blocks intersecting |rect| to the region. |rect| uses the same
+  // coordinates as |area|.
+  void AddRect(const DesktopRect& rect);
+
+  // The following operations require |region| to have the same area.
+  void AddRegion(const BlockRegion& region);
+  void IntersectWith(const BlockRegion& region);
+  void Subtract(const BlockRegion& region);
+
+  // Adds the blocks of the region, clipped to |area|, to |output|.
+  void AddToDesktopRegion(DesktopRegion* output) const;
+
+ private:
+  uint64_t* row(int y) { return bits_.data() + y * words_per_row_; }
+  const uint64_t* row(int y) const {
+    return bits_.data() + y * words_per_row_;
+  }
+
+  // Returns the first set block at or after |x| in |words|, or
+  // |width_in_blocks_| if there is none.
+  int FindSetBlock(const uint64_t* words, int x) const;
+  // Returns the first unset block at or after |x| in |words|, or
+  // |width_in_blocks_| if there is none.
+  int FindUnsetBlock(const uint64_t* words, int x) const;
+
+  DesktopRect area_;
+  int width_in_blocks_;
+  int height_in_blocks_;
+  int words_per_row_;
+  std::vector<uint64_t> bits_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_DESKTOP_CAPTURE_BLOCK_REGION_H_
@@ -0,0 +1,129 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/block_region.h"
+
+#include <stdlib.h>
+
+#include "modules/desktop_capture/differ_block.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+DesktopRegion ToDesktopRegion(const BlockRegion& region) {
+  DesktopRegion result;
+  region.AddToDesktopRegion(&result);
+  return result;
+}
+
+// Returns the rectangle covered by block (|x|, |y|) of |area|.
+DesktopRect BlockRect(const DesktopRect& area, int x, int y) {
+  DesktopRect rect = DesktopRect::MakeXYWH(area.left() + x * kBlockSize,
+                                           area.top() + y * kBlockSize,
+                                           kBlockSize, kBlockSize);
+  rect.IntersectWith(area);
+  return rect;
+}
+
+}  // namespace
+
+TEST(BlockRegionTest, EmptyWhenCreated) {
+  BlockRegion region(DesktopRect::MakeWH(100, 100));
+  EXPECT_TRUE(region.is_empty());
+  EXPECT_EQ(4, region.width_in_blocks());
+  EXPECT_EQ(4, region.height_in_blocks());
+  EXPECT_TRUE(ToDesktopRegion(region).is_empty());
+}
+
+TEST(BlockRegionTest, AddRectCoversIntersectingBlocks) {
+  const DesktopRect area = DesktopRect::MakeXYWH(10, 20, 100, 100);
+  BlockRegion region(area);
+  region.AddRect(DesktopRect::MakeLTRB(45, 55, 50, 60));
+  EXPECT_FALSE(region.is_empty());
+  EXPECT_TRUE(region.IsBlockSet(1, 1));
+  EXPECT_FALSE(region.IsBlockSet(0, 0));
+  EXPECT_TRUE(ToDesktopRegion(region).Equals(
+      DesktopRegion(DesktopRect::MakeXYWH(42, 52, 32, 32))));
+
+  region.Clear();
+  EXPECT_TRUE(region.is_empty());
+}
+
+TEST(BlockRegionTest, EdgeBlocksAreClippedToArea) {
+  const DesktopRect area = DesktopRect::MakeWH(100, 70);
+  BlockRegion region(area);
+  region.AddRect(area);
+  EXPECT_TRUE(ToDesktopRegion(region).Equals(DesktopRegion(area)));
+
+  region.Clear();
+  region.AddBlocks(2, 3, 4);
+  EXPECT_TRUE(ToDesktopRegion(region).Equals(
+      DesktopRegion(DesktopRect::MakeLTRB(96, 64, 100, 70))));
+}
+
+TEST(BlockRegionTest, SetOperations) {
+  const DesktopRect area = DesktopRect::MakeWH(4 * kBlockSize, kBlockSize);
+  BlockRegion a(area);
+  a.AddBlocks(0, 0, 3);
+  BlockRegion b(area);
+  b.AddBlocks(0, 2, 4);
+
+  BlockRegion result = a;
+  result.AddRegion(b);
+  EXPECT_TRUE(ToDesktopRegion(result).Equals(DesktopRegion(area)));
+
+  result = a;
+  result.IntersectWith(b);
+  EXPECT_TRUE(ToDesktopRegion(result).Equals(DesktopRegion(
+      DesktopRect::MakeLTRB(2 * kBlockSize, 0, 3 * kBlockSize, kBlockSize))));
+
+  result = a;
+  result.Subtract(b);
+  EXPECT_TRUE(ToDesktopRegion(result).Equals(
+      DesktopRegion(DesktopRect::MakeWH(2 * kBlockSize, kBlockSize))));
+}
+
+// Verify that runs spanning several bitmap words are handled properly.
+TEST(BlockRegionTest, WideRows) {
+  const DesktopRect area = DesktopRect::MakeWH(200 * kBlockSize, kBlockSize);
+  BlockRegion region(area);
+  region.AddBlocks(0, 60, 130);
+  region.AddBlocks(0, 199, 200);
+  DesktopRegion expected;
+  expected.AddRect(
+      DesktopRect::MakeLTRB(60 * kBlockSize, 0, 130 * kBlockSize, kBlockSize));
+  expected.AddRect(DesktopRect::MakeLTRB(199 * kBlockSize, 0, 200 * kBlockSize,
+                                         kBlockSize));
+  EXPECT_TRUE(ToDesktopRegion(region).Equals(expected));
+}
+
+// Verify that the result matches adding each block to a DesktopRegion.
+TEST(BlockRegionTest, MatchesDesktopRegion) {
+  const DesktopRect area = DesktopRect::MakeXYWH(-7, 13, 2000, 1100);
+  srand(12345);
+  for (int i = 0; i < 100; ++i) {
+    SCOPED_TRACE(i);
+    BlockRegion region(area);
+    DesktopRegion expected;
+    for (int y = 0; y < region.height_in_blocks(); ++y) {
+      for (int x = 0; x < region.width_in_blocks(); ++x) {
+        if (rand() % 4 == 0) {
+          region.AddBlocks(y, x, x + 1);
+          expected.AddRect(BlockRect(area, x, y));
+        }
+      }
+    }
+    EXPECT_TRUE(ToDesktopRegion(region).Equals(expected));
+  }
+}
+
+}  // namespace webrtc
@@ -21,37 +21,61 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/ptr_util.h"
+#include "typedefs.h"  // NOLINT(build/include)
+#if !defined(WEBRTC_ARCH_ARM_FAMILY) && !defined(WEBRTC_ARCH_MIPS_FAMILY)
+#include "modules/desktop_capture/alpha_blend_sse2.h"
+#endif
+#include "system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
 
 namespace {
 
+// Blends |count| pixels of |src| into |dest|.
+void AlphaBlendPixels_C(uint8_t* dest, const uint8_t* src, int count) {
+  for (int x = 0; x < count; ++x) {
+    uint32_t base_alpha = 255 - src[x * DesktopFrame::kBytesPerPixel + 3];
+    if (base_alpha == 255) {
+      continue;
+    } else if (base_alpha == 0) {
+      memcpy(dest + x * DesktopFrame::kBytesPerPixel,
+             src + x * DesktopFrame::kBytesPerPixel,
+             DesktopFrame::kBytesPerPixel);
+    } else {
+      dest[x * DesktopFrame::kBytesPerPixel] =
+          dest[x * DesktopFrame::kBytesPerPixel] * base_alpha / 255 +
+          src[x * DesktopFrame::kBytesPerPixel];
+      dest[x * DesktopFrame::kBytesPerPixel + 1] =
+          dest[x * DesktopFrame::kBytesPerPixel + 1] * base_alpha / 255 +
+          src[x * DesktopFrame::kBytesPerPixel + 1];
+      dest[x * DesktopFrame::kBytesPerPixel + 2] =
+          dest[x * DesktopFrame::kBytesPerPixel + 2] * base_alpha / 255 +
+          src[x * DesktopFrame::kBytesPerPixel + 2];
+    }
+  }
+}
+
 // Helper function that blends one image into another. Source image must be
 // pre-multiplied with the alpha channel. Destination is assumed to be opaque.
 void AlphaBlend(uint8_t* dest, int dest_stride,
                 const uint8_t* src, int src_stride,
                 const DesktopSize& size) {
+#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
+  const int vector_width = 0;
+#else
+  static const bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
+  // The SSE2 version blends 4 pixels at a time.
+  const int vector_width = have_sse2 ? size.width() - size.width() % 4 : 0;
+#endif
+  const int tail_offset = vector_width * DesktopFrame::kBytesPerPixel;
   for (int y = 0; y < size.height(); ++y) {
-    for (int x = 0; x < size.width(); ++x) {
-      uint32_t base_alpha = 255 - src[x * DesktopFrame::kBytesPerPixel + 3];
-      if (base_alpha == 255) {
-        continue;
-      } else if (base_alpha == 0) {
-        memcpy(dest + x * DesktopFrame::kBytesPerPixel,
-               src + x * DesktopFrame::kBytesPerPixel,
-               DesktopFrame::kBytesPerPixel);
-      } else {
-        dest[x * DesktopFrame::kBytesPerPixel] =
-            dest[x * DesktopFrame::kBytesPerPixel] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel];
-        dest[x * DesktopFrame::kBytesPerPixel + 1] =
-            dest[x * DesktopFrame::kBytesPerPixel + 1] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 1];
-        dest[x * DesktopFrame::kBytesPerPixel + 2] =
-            dest[x * DesktopFrame::kBytesPerPixel + 2] * base_alpha / 255 +
-            src[x * DesktopFrame::kBytesPerPixel + 2];
-      }
-    }
+#if !defined(WEBRTC_ARCH_ARM_FAMILY) && !defined(WEBRTC_ARCH_MIPS_FAMILY)
+    if (vector_width > 0)
+      AlphaBlendPixels_SSE2(dest, src, vector_width);
+#endif
+    // Pixels that don't fill a whole vector are blended by the C version.
+    AlphaBlendPixels_C(dest + tail_offset, src + tail_offset,
+                       size.width() - vector_width);
     src += src_stride;
     dest += dest_stride;
   }
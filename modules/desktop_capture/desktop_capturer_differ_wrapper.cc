@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <utility>
 
+#include "modules/desktop_capture/block_region.h"
 #include "modules/desktop_capture/desktop_geometry.h"
 #include "modules/desktop_capture/differ_block.h"
 #include "rtc_base/checks.h"
@@ -44,21 +45,17 @@ bool PartialBlockDifference(const uint8_t* old_buffer,
   return false;
 }
 
-// Compares columns in the range of [|left|, |right|), in a row in the
-// range of [|top|, |top| + |height|), starts from |old_buffer| and
-// |new_buffer|, and outputs updated regions into |output|. |stride| is the
-// DesktopFrame::stride().
+// Compares |width| columns in a block-row of |height| rows, starts from
+// |old_buffer| and |new_buffer|, and adds updated blocks into block-row |y| of
+// |output|. |stride| is the DesktopFrame::stride().
 void CompareRow(const uint8_t* old_buffer,
                 const uint8_t* new_buffer,
-                const int left,
-                const int right,
-                const int top,
-                const int bottom,
+                const int width,
+                const int height,
                 const int stride,
-                DesktopRegion* const output) {
+                const int y,
+                BlockRegion* const output) {
   const int block_x_offset = kBlockSize * DesktopFrame::kBytesPerPixel;
-  const int width = right - left;
-  const int height = bottom - top;
   const int block_count = (width - 1) / kBlockSize;
   const int last_block_width = width - block_count * kBlockSize;
   RTC_DCHECK_GT(last_block_width, 0);
@@ -78,9 +75,7 @@ void CompareRow(const uint8_t* old_buffer,
     } else if (first_dirty_x_block != -1) {
       // The block on the left is the last dirty block in a continuous
       // dirty area.
-      output->AddRect(
-          DesktopRect::MakeLTRB(first_dirty_x_block * kBlockSize + left, top,
-                                x * kBlockSize + left, bottom));
+      output->AddBlocks(y, first_dirty_x_block, x);
       first_dirty_x_block = -1;
     }
     old_buffer += block_x_offset;
@@ -99,17 +94,16 @@ void CompareRow(const uint8_t* old_buffer,
     if (first_dirty_x_block == -1) {
       first_dirty_x_block = block_count;
     }
-    output->AddRect(DesktopRect::MakeLTRB(
-        first_dirty_x_block * kBlockSize + left, top, right, bottom));
+    output->AddBlocks(y, first_dirty_x_block, block_count + 1);
   } else if (first_dirty_x_block != -1) {
-    output->AddRect(
-        DesktopRect::MakeLTRB(first_dirty_x_block * kBlockSize + left, top,
-                              block_count * kBlockSize + left, bottom));
+    output->AddBlocks(y, first_dirty_x_block, block_count);
   }
 }
 
 // Compares |rect| area in |old_frame| and |new_frame|, and outputs dirty
-// regions into |output|.
+// regions into |output|. Dirty blocks are collected in a BlockRegion and added
+// to |output| at once, which is much cheaper than adding each dirty span of
+// each block-row to a DesktopRegion.
 void CompareFrames(const DesktopFrame& old_frame,
                    const DesktopFrame& new_frame,
                    DesktopRect rect,
@@ -127,18 +121,18 @@ void CompareFrames(const DesktopFrame& old_frame,
   const uint8_t* curr_block_row_start =
       new_frame.GetFrameDataAtPos(rect.top_left());
 
-  int top = rect.top();
+  BlockRegion dirty_blocks(rect);
   // The last row may have a different height, so we handle it separately.
   for (int y = 0; y < y_block_count; y++) {
-    CompareRow(prev_block_row_start, curr_block_row_start, rect.left(),
-               rect.right(), top, top + kBlockSize, old_frame.stride(), output);
-    top += kBlockSize;
+    CompareRow(prev_block_row_start, curr_block_row_start, rect.width(),
+               kBlockSize, old_frame.stride(), y, &dirty_blocks);
     prev_block_row_start += block_y_stride;
     curr_block_row_start += block_y_stride;
   }
-  CompareRow(prev_block_row_start, curr_block_row_start, rect.left(),
-             rect.right(), top, top + last_y_block_height, old_frame.stride(),
-             output);
+  CompareRow(prev_block_row_start, curr_block_row_start, rect.width(),
+             last_y_block_height, old_frame.stride(), y_block_count,
+             &dirty_blocks);
+  dirty_blocks.AddToDesktopRegion(output);
 }
 
 }  // namespace
@@ -0,0 +1,113 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/desktop_frame_i420_converter.h"
+
+#include <algorithm>
+
+#include "modules/desktop_capture/desktop_region.h"
+#include "rtc_base/checks.h"
+#include "third_party/libyuv/include/libyuv/convert.h"
+#include "third_party/libyuv/include/libyuv/planar_functions.h"
+
+namespace webrtc {
+
+namespace {
+
+// Expands |rect| to even coordinates, so that it covers whole chroma samples.
+DesktopRect AlignToChroma(const DesktopRect& rect, const DesktopSize& size) {
+  return DesktopRect::MakeLTRB(rect.left() & ~1, rect.top() & ~1,
+                               std::min(size.width(), (rect.right() + 1) & ~1),
+                               std::min(size.height(),
+                                        (rect.bottom() + 1) & ~1));
+}
+
+void ConvertRect(const DesktopFrame& frame,
+                 const DesktopRect& rect,
+                 I420Buffer* buffer) {
+  const int uv_left = rect.left() / 2;
+  const int uv_top = rect.top() / 2;
+  int result = libyuv::ARGBToI420(
+      frame.GetFrameDataAtPos(rect.top_left()), frame.stride(),
+      buffer->MutableDataY() + rect.top() * buffer->StrideY() + rect.left(),
+      buffer->StrideY(),
+      buffer->MutableDataU() + uv_top * buffer->StrideU() + uv_left,
+      buffer->StrideU(),
+      buffer->MutableDataV() + uv_top * buffer->StrideV() + uv_left,
+      buffer->StrideV(), rect.width(), rect.height());
+  RTC_DCHECK_EQ(result, 0);
+}
+
+void CopyRect(const I420BufferInterface& src,
+              const DesktopRect& rect,
+              I420Buffer* dst) {
+  const int uv_left = rect.left() / 2;
+  const int uv_top = rect.top() / 2;
+  const int uv_width = (rect.width() + 1) / 2;
+  const int uv_height = (rect.height() + 1) / 2;
+  libyuv::CopyPlane(
+      src.DataY() + rect.top() * src.StrideY() + rect.left(), src.StrideY(),
+      dst->MutableDataY() + rect.top() * dst->StrideY() + rect.left(),
+      dst->StrideY(), rect.width(), rect.height());
+  libyuv::CopyPlane(src.DataU() + uv_top * src.StrideU() + uv_left,
+                    src.StrideU(),
+                    dst->MutableDataU() + uv_top * dst->StrideU() + uv_left,
+                    dst->StrideU(), uv_width, uv_height);
+  libyuv::CopyPlane(src.DataV() + uv_top * src.StrideV() + uv_left,
+                    src.StrideV(),
+                    dst->MutableDataV() + uv_top * dst->StrideV() + uv_left,
+                    dst->StrideV(), uv_width, uv_height);
+}
+
+}  // namespace
+
+DesktopFrameI420Converter::DesktopFrameI420Converter() {}
+
+DesktopFrameI420Converter::~DesktopFrameI420Converter() {}
+
+rtc::scoped_refptr<I420BufferInterface> DesktopFrameI420Converter::Convert(
+    const DesktopFrame& frame) {
+  const DesktopSize& size = frame.size();
+  rtc::scoped_refptr<I420Buffer> buffer =
+      buffer_pool_.CreateBuffer(size.width(), size.height());
+  if (!buffer)
+    return nullptr;
+
+  const DesktopRect frame_rect = DesktopRect::MakeSize(size);
+  if (!last_buffer_ || last_buffer_->width() != size.width() ||
+      last_buffer_->height() != size.height()) {
+    ConvertRect(frame, frame_rect, buffer.get());
+  } else {
+    DesktopRegion converted;
+    for (DesktopRegion::Iterator it(frame.updated_region()); !it.IsAtEnd();
+         it.Advance()) {
+      DesktopRect rect = it.rect();
+      rect.IntersectWith(frame_rect);
+      if (!rect.is_empty())
+        converted.AddRect(AlignToChroma(rect, size));
+    }
+    DesktopRegion unchanged(frame_rect);
+    unchanged.Subtract(converted);
+
+    for (DesktopRegion::Iterator it(converted); !it.IsAtEnd(); it.Advance())
+      ConvertRect(frame, it.rect(), buffer.get());
+    for (DesktopRegion::Iterator it(unchanged); !it.IsAtEnd(); it.Advance())
+      CopyRect(*last_buffer_, it.rect(), buffer.get());
+  }
+
+  last_buffer_ = buffer;
+  return buffer;
+}
+
+void DesktopFrameI420Converter::Reset() {
+  last_buffer_ = nullptr;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,54 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_I420_CONVERTER_H_
+#define MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_I420_CONVERTER_H_
+
+#include "api/video/i420_buffer.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "modules/desktop_capture/desktop_frame.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+namespace webrtc {
+
+// Converts the BGRA DesktopFrames of a capturer into pooled I420 buffers that
+// can be handed to a video encoder. Only the updated_region() of a frame is
+// converted; the rest of the buffer is copied from the previous result, which
+// is far cheaper than converting it again. Capturers that know their dirty
+// rects, or a DesktopCapturerDifferWrapper, therefore turn a mostly static
+// screen into a mostly copied buffer.
+//
+// Returned buffers are refcounted like SharedDesktopFrame and are never
+// written to again, so they can be held by the encoder while later frames are
+// converted.
+class DesktopFrameI420Converter {
+ public:
+  DesktopFrameI420Converter();
+  ~DesktopFrameI420Converter();
+
+  // Returns the I420 version of |frame|. The whole frame is converted if its
+  // size differs from the previous one. Returns null if the buffer pool is
+  // exhausted because too many earlier buffers are still in use.
+  rtc::scoped_refptr<I420BufferInterface> Convert(const DesktopFrame& frame);
+
+  // Forgets the previous result, so that the next frame is fully converted.
+  void Reset();
+
+ private:
+  I420BufferPool buffer_pool_;
+  rtc::scoped_refptr<I420Buffer> last_buffer_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(DesktopFrameI420Converter);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_DESKTOP_CAPTURE_DESKTOP_FRAME_I420_CONVERTER_H_
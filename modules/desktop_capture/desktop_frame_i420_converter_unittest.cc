@@ -0,0 +1,109 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/desktop_frame_i420_converter.h"
+
+#include <string.h>
+
+#include "modules/desktop_capture/desktop_frame.h"
+#include "modules/desktop_capture/desktop_region.h"
+#include "rtc_base/random.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+// An odd size, so that the chroma alignment of updated rects is exercised.
+const int kWidth = 101;
+const int kHeight = 75;
+
+void FillRect(DesktopFrame* frame, const DesktopRect& rect, Random* random) {
+  for (int y = rect.top(); y < rect.bottom(); ++y) {
+    uint8_t* row = frame->GetFrameDataAtPos(DesktopVector(rect.left(), y));
+    for (int x = 0; x < rect.width() * DesktopFrame::kBytesPerPixel; ++x)
+      row[x] = static_cast<uint8_t>(random->Rand(0, 255));
+  }
+}
+
+bool PlaneEquals(const uint8_t* a,
+                 int stride_a,
+                 const uint8_t* b,
+                 int stride_b,
+                 int width,
+                 int height) {
+  for (int y = 0; y < height; ++y) {
+    if (memcmp(a + y * stride_a, b + y * stride_b, width) != 0)
+      return false;
+  }
+  return true;
+}
+
+bool BuffersEqual(const I420BufferInterface& a, const I420BufferInterface& b) {
+  return a.width() == b.width() && a.height() == b.height() &&
+         PlaneEquals(a.DataY(), a.StrideY(), b.DataY(), b.StrideY(), a.width(),
+                     a.height()) &&
+         PlaneEquals(a.DataU(), a.StrideU(), b.DataU(), b.StrideU(),
+                     a.ChromaWidth(), a.ChromaHeight()) &&
+         PlaneEquals(a.DataV(), a.StrideV(), b.DataV(), b.StrideV(),
+                     a.ChromaWidth(), a.ChromaHeight());
+}
+
+}  // namespace
+
+TEST(DesktopFrameI420ConverterTest, ConvertsOnlyUpdatedRegion) {
+  Random random(0x5678);
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  FillRect(&frame, DesktopRect::MakeSize(frame.size()), &random);
+
+  DesktopFrameI420Converter converter;
+  rtc::scoped_refptr<I420BufferInterface> first = converter.Convert(frame);
+  ASSERT_TRUE(first);
+  rtc::scoped_refptr<I420Buffer> first_copy = I420Buffer::Copy(*first);
+
+  // Odd coordinates, and a rect touching the right and bottom edges.
+  const DesktopRect kUpdatedRects[] = {DesktopRect::MakeLTRB(3, 5, 20, 18),
+                                       DesktopRect::MakeLTRB(60, 41, 101, 75)};
+  frame.mutable_updated_region()->Clear();
+  for (const DesktopRect& rect : kUpdatedRects) {
+    FillRect(&frame, rect, &random);
+    frame.mutable_updated_region()->AddRect(rect);
+  }
+  rtc::scoped_refptr<I420BufferInterface> second = converter.Convert(frame);
+  ASSERT_TRUE(second);
+
+  DesktopFrameI420Converter full_converter;
+  rtc::scoped_refptr<I420BufferInterface> expected =
+      full_converter.Convert(frame);
+  EXPECT_TRUE(BuffersEqual(*expected, *second));
+  // The first buffer may still be in use by an encoder and is left untouched.
+  EXPECT_NE(first.get(), second.get());
+  EXPECT_TRUE(BuffersEqual(*first_copy, *first));
+}
+
+TEST(DesktopFrameI420ConverterTest, ConvertsWholeFrameAfterSizeChange) {
+  Random random(0x1234);
+  DesktopFrameI420Converter converter;
+  BasicDesktopFrame small_frame(DesktopSize(kWidth - 1, kHeight - 1));
+  FillRect(&small_frame, DesktopRect::MakeSize(small_frame.size()), &random);
+  ASSERT_TRUE(converter.Convert(small_frame));
+
+  BasicDesktopFrame frame(DesktopSize(kWidth, kHeight));
+  FillRect(&frame, DesktopRect::MakeSize(frame.size()), &random);
+  // An empty updated region is ignored when the size changes.
+  frame.mutable_updated_region()->Clear();
+  rtc::scoped_refptr<I420BufferInterface> converted = converter.Convert(frame);
+  ASSERT_TRUE(converted);
+
+  DesktopFrameI420Converter full_converter;
+  EXPECT_TRUE(BuffersEqual(*full_converter.Convert(frame), *converted));
+}
+
+}  // namespace webrtc
@@ -13,7 +13,12 @@
 #include <string.h>
 
 #include "typedefs.h"  // NOLINT(build/include)
+#if defined(WEBRTC_HAS_NEON)
+#include "modules/desktop_capture/differ_vector_neon.h"
+#elif !defined(WEBRTC_ARCH_ARM_FAMILY) && !defined(WEBRTC_ARCH_MIPS_FAMILY)
+#include "modules/desktop_capture/differ_vector_avx2.h"
 #include "modules/desktop_capture/differ_vector_sse2.h"
+#endif
 #include "system_wrappers/include/cpu_features_wrapper.h"
 
 namespace webrtc {
@@ -30,14 +35,26 @@ bool VectorDifference(const uint8_t* image1, const uint8_t* image2) {
   static bool (*diff_proc)(const uint8_t*, const uint8_t*) = nullptr;
 
   if (!diff_proc) {
-#if defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
-    // For ARM and MIPS processors, always use C version.
-    // TODO(hclam): Implement a NEON version.
+#if defined(WEBRTC_HAS_NEON)
+    if (kBlockSize == 32) {
+      diff_proc = &VectorDifference_NEON_W32;
+    } else if (kBlockSize == 16) {
+      diff_proc = &VectorDifference_NEON_W16;
+    } else {
+      diff_proc = &VectorDifference_C;
+    }
+#elif defined(WEBRTC_ARCH_ARM_FAMILY) || defined(WEBRTC_ARCH_MIPS_FAMILY)
+    // For ARM without NEON and MIPS processors, always use C version.
     diff_proc = &VectorDifference_C;
 #else
+    bool have_avx2 = WebRtc_GetCPUInfo(kAVX2) != 0;
     bool have_sse2 = WebRtc_GetCPUInfo(kSSE2) != 0;
-    // For x86 processors, check if SSE2 is supported.
-    if (have_sse2 && kBlockSize == 32) {
+    // For x86 processors, prefer AVX2 and fall back to SSE2 if supported.
+    if (have_avx2 && kBlockSize == 32) {
+      diff_proc = &VectorDifference_AVX2_W32;
+    } else if (have_avx2 && kBlockSize == 16) {
+      diff_proc = &VectorDifference_AVX2_W16;
+    } else if (have_sse2 && kBlockSize == 32) {
       diff_proc = &VectorDifference_SSE2_W32;
     } else if (have_sse2 && kBlockSize == 16) {
       diff_proc = &VectorDifference_SSE2_W16;
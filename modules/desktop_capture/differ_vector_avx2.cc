@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/differ_vector_avx2.h"
+
+#include <immintrin.h>
+
+namespace webrtc {
+
+// Only equality matters, so OR together the XOR of each 32 byte chunk instead
+// of accumulating sums of absolute differences as the SSE2 version does.
+extern bool VectorDifference_AVX2_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+  const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+  const __m256i x0 =
+      _mm256_xor_si256(_mm256_loadu_si256(i1), _mm256_loadu_si256(i2));
+  const __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                      _mm256_loadu_si256(i2 + 1));
+  const __m256i acc = _mm256_or_si256(x0, x1);
+  return !_mm256_testz_si256(acc, acc);
+}
+
+extern bool VectorDifference_AVX2_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  const __m256i* i1 = reinterpret_cast<const __m256i*>(image1);
+  const __m256i* i2 = reinterpret_cast<const __m256i*>(image2);
+  const __m256i x0 =
+      _mm256_xor_si256(_mm256_loadu_si256(i1), _mm256_loadu_si256(i2));
+  const __m256i x1 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 1),
+                                      _mm256_loadu_si256(i2 + 1));
+  const __m256i x2 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 2),
+                                      _mm256_loadu_si256(i2 + 2));
+  const __m256i x3 = _mm256_xor_si256(_mm256_loadu_si256(i1 + 3),
+                                      _mm256_loadu_si256(i2 + 3));
+  const __m256i acc =
+      _mm256_or_si256(_mm256_or_si256(x0, x1), _mm256_or_si256(x2, x3));
+  return !_mm256_testz_si256(acc, acc);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/desktop_capture/differ_vector_neon.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+
+namespace {
+
+// Returns the XOR of the 16 bytes at |image1| and |image2|.
+inline uint8x16_t XorVector(const uint8_t* image1, const uint8_t* image2) {
+  return veorq_u8(vld1q_u8(image1), vld1q_u8(image2));
+}
+
+inline bool AnyBitSet(uint8x16_t v) {
+  const uint64x2_t v64 = vreinterpretq_u64_u8(v);
+  return (vgetq_lane_u64(v64, 0) | vgetq_lane_u64(v64, 1)) != 0;
+}
+
+}  // namespace
+
+extern bool VectorDifference_NEON_W16(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  uint8x16_t acc = XorVector(image1, image2);
+  acc = vorrq_u8(acc, XorVector(image1 + 16, image2 + 16));
+  acc = vorrq_u8(acc, XorVector(image1 + 32, image2 + 32));
+  acc = vorrq_u8(acc, XorVector(image1 + 48, image2 + 48));
+  return AnyBitSet(acc);
+}
+
+extern bool VectorDifference_NEON_W32(const uint8_t* image1,
+                                      const uint8_t* image2) {
+  uint8x16_t acc = XorVector(image1, image2);
+  for (int offset = 16; offset < 128; offset += 16)
+    acc = vorrq_u8(acc, XorVector(image1 + offset, image2 + offset));
+  return AnyBitSet(acc);
+}
+
+}  // namespace webrtc
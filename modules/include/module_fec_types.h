@@ -22,11 +22,21 @@ enum FecMaskType {
   kFecMaskBursty,
 };
 
+// The code used to generate FEC packets. |kFecSchemeXor| is the XOR parity of
+// ULPFEC and FlexFEC, which recovers one lost packet per FEC packet covering
+// it. |kFecSchemeReedSolomon|, see ReedSolomonFec, recovers any k lost packets
+// of a frame from k FEC packets, and so copes better with bursts of losses.
+enum FecScheme {
+  kFecSchemeXor,
+  kFecSchemeReedSolomon,
+};
+
 // Struct containing forward error correction settings.
 struct FecProtectionParams {
   int fec_rate;
   int max_fec_frames;
   FecMaskType fec_mask_type;
+  FecScheme fec_scheme;
 };
 
 }  // namespace webrtc
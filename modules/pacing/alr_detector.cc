@@ -55,6 +55,16 @@ AlrDetector::~AlrDetector() {}
 void AlrDetector::OnBytesSent(size_t bytes_sent, int64_t delta_time_ms) {
   alr_budget_.UseBudget(bytes_sent);
   alr_budget_.IncreaseBudget(delta_time_ms);
+  UpdateAlrState();
+}
+
+void AlrDetector::OnBytesSentUs(size_t bytes_sent, int64_t delta_time_us) {
+  alr_budget_.UseBudget(bytes_sent);
+  alr_budget_.IncreaseBudgetUs(delta_time_us);
+  UpdateAlrState();
+}
+
+void AlrDetector::UpdateAlrState() {
   bool state_changed = false;
   if (alr_budget_.budget_level_percent() > alr_start_budget_level_percent_ &&
       !alr_started_time_ms_) {
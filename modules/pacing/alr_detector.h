@@ -36,6 +36,8 @@ class AlrDetector {
   ~AlrDetector();
 
   void OnBytesSent(size_t bytes_sent, int64_t delta_time_ms);
+  // For senders that report more often than once per millisecond.
+  void OnBytesSentUs(size_t bytes_sent, int64_t delta_time_us);
 
   // Set current estimated bandwidth.
   void SetEstimatedBitrate(int bitrate_bps);
@@ -57,6 +59,8 @@ class AlrDetector {
   void UpdateBudgetWithBytesSent(size_t bytes_sent);
 
  private:
+  void UpdateAlrState();
+
   int bandwidth_usage_percent_;
   int alr_start_budget_level_percent_;
   int alr_stop_budget_level_percent_;
@@ -16,14 +16,18 @@
 namespace webrtc {
 namespace {
 constexpr int kWindowMs = 500;
-}
+// One byte takes 8000 us at 1 kbps.
+constexpr int64_t kUsPerByteAtOneKbps = 8000;
+}  // namespace
 
 IntervalBudget::IntervalBudget(int initial_target_rate_kbps)
     : IntervalBudget(initial_target_rate_kbps, false) {}
 
 IntervalBudget::IntervalBudget(int initial_target_rate_kbps,
                                bool can_build_up_underuse)
-    : bytes_remaining_(0), can_build_up_underuse_(can_build_up_underuse) {
+    : bytes_remaining_(0),
+      fractional_bytes_(0),
+      can_build_up_underuse_(can_build_up_underuse) {
   set_target_rate_kbps(initial_target_rate_kbps);
 }
 
@@ -35,7 +39,17 @@ void IntervalBudget::set_target_rate_kbps(int target_rate_kbps) {
 }
 
 void IntervalBudget::IncreaseBudget(int64_t delta_time_ms) {
-  int bytes = rtc::dchecked_cast<int>(target_rate_kbps_ * delta_time_ms / 8);
+  AddBytes(rtc::dchecked_cast<int>(target_rate_kbps_ * delta_time_ms / 8));
+}
+
+void IntervalBudget::IncreaseBudgetUs(int64_t delta_time_us) {
+  fractional_bytes_ += target_rate_kbps_ * delta_time_us;
+  int bytes = rtc::dchecked_cast<int>(fractional_bytes_ / kUsPerByteAtOneKbps);
+  fractional_bytes_ -= bytes * kUsPerByteAtOneKbps;
+  AddBytes(bytes);
+}
+
+void IntervalBudget::AddBytes(int bytes) {
   if (bytes_remaining_ < 0 || can_build_up_underuse_) {
     // We overused last interval, compensate this interval.
     bytes_remaining_ = std::min(bytes_remaining_ + bytes, max_bytes_in_budget_);
@@ -50,6 +64,18 @@ void IntervalBudget::UseBudget(size_t bytes) {
                               -max_bytes_in_budget_);
 }
 
+int64_t IntervalBudget::TimeUntilBytesRemainingUs() const {
+  if (bytes_remaining_ > 0)
+    return 0;
+  if (target_rate_kbps_ <= 0)
+    return -1;
+  // Time until the budget reaches one byte, rounded up.
+  int64_t missing = (1 - int64_t{bytes_remaining_}) * kUsPerByteAtOneKbps -
+                    fractional_bytes_;
+  return std::max<int64_t>(
+      0, (missing + target_rate_kbps_ - 1) / target_rate_kbps_);
+}
+
 size_t IntervalBudget::bytes_remaining() const {
   return static_cast<size_t>(std::max(0, bytes_remaining_));
 }
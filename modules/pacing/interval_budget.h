@@ -25,16 +25,29 @@ class IntervalBudget {
 
   // TODO(tschumim): Unify IncreaseBudget and UseBudget to one function.
   void IncreaseBudget(int64_t delta_time_ms);
+  // Same as IncreaseBudget(), for callers that update the budget more often
+  // than once per millisecond. Fractions of a byte are carried over to the
+  // next call rather than lost.
+  void IncreaseBudgetUs(int64_t delta_time_us);
   void UseBudget(size_t bytes);
 
+  // Returns the time it takes at the target rate until there are bytes
+  // remaining, or 0 if there already are. Returns -1 if the target rate is 0.
+  int64_t TimeUntilBytesRemainingUs() const;
+
   size_t bytes_remaining() const;
   int budget_level_percent() const;
   int target_rate_kbps() const;
 
  private:
+  void AddBytes(int bytes);
+
   int target_rate_kbps_;
   int max_bytes_in_budget_;
   int bytes_remaining_;
+  // Budget increase not yet added to |bytes_remaining_|, in kbps * us, i.e.
+  // 1/8000 bytes.
+  int64_t fractional_bytes_;
   bool can_build_up_underuse_;
 };
 
@@ -116,4 +116,34 @@ TEST(IntervalBudgetTest, CanNotBuildUpUnderuseWhenConfigured) {
             TimeToBytes(kBitrateKbps, delta_time_ms));
 }
 
+TEST(IntervalBudgetTest, IncreaseBudgetUsKeepsFractionsOfBytes) {
+  IntervalBudget interval_budget(kBitrateKbps, kCanBuildUpUnderuse);
+  // 100 kbps is 12.5 bytes per ms, i.e. 1.25 bytes per 100 us.
+  for (int i = 0; i < 400; ++i)
+    interval_budget.IncreaseBudgetUs(100);
+  EXPECT_EQ(interval_budget.bytes_remaining(),
+            TimeToBytes(kBitrateKbps, 40));
+}
+
+TEST(IntervalBudgetTest, TimeUntilBytesRemaining) {
+  IntervalBudget interval_budget(kBitrateKbps);
+  // One byte takes 80 us at 100 kbps.
+  EXPECT_EQ(80, interval_budget.TimeUntilBytesRemainingUs());
+  interval_budget.IncreaseBudgetUs(80);
+  EXPECT_EQ(1u, interval_budget.bytes_remaining());
+  EXPECT_EQ(0, interval_budget.TimeUntilBytesRemainingUs());
+
+  interval_budget.UseBudget(1000);
+  int64_t wait_us = interval_budget.TimeUntilBytesRemainingUs();
+  EXPECT_EQ(1000 * 80, wait_us);
+  interval_budget.IncreaseBudgetUs(wait_us - 1);
+  EXPECT_EQ(0u, interval_budget.bytes_remaining());
+  interval_budget.IncreaseBudgetUs(1);
+  EXPECT_EQ(1u, interval_budget.bytes_remaining());
+
+  interval_budget.set_target_rate_kbps(0);
+  interval_budget.UseBudget(1);
+  EXPECT_EQ(-1, interval_budget.TimeUntilBytesRemainingUs());
+}
+
 }  // namespace webrtc
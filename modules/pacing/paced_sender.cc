@@ -21,13 +21,14 @@
 #include "modules/pacing/alr_detector.h"
 #include "modules/pacing/bitrate_prober.h"
 #include "modules/pacing/interval_budget.h"
-#include "modules/pacing/round_robin_packet_queue.h"
+#include "modules/pacing/weighted_fair_packet_queue.h"
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial.h"
+#include "system_wrappers/include/metrics.h"
 #include "system_wrappers/include/runtime_enabled_features.h"
 
 namespace {
@@ -41,6 +42,11 @@ const int64_t kMaxElapsedTimeMs = 2000;
 // time.
 const int64_t kMaxIntervalTimeMs = 30;
 
+// In sub-millisecond mode, the most media budget the pacer may have beyond
+// what it needs to make up for earlier sends, so that time spent with nothing
+// to send, or waking up late, doesn't turn into a burst.
+const int64_t kSubMillisecondMaxBurstUs = 1000;
+
 }  // namespace
 
 namespace webrtc {
@@ -54,7 +60,7 @@ PacedSender::PacedSender(const Clock* clock,
     : PacedSender(clock,
                   packet_sender,
                   event_log,
-                  rtc::MakeUnique<RoundRobinPacketQueue>(clock)) {}
+                  rtc::MakeUnique<WeightedFairPacketQueue>(clock)) {}
 
 PacedSender::PacedSender(const Clock* clock,
                          PacketSender* packet_sender,
@@ -79,7 +85,8 @@ PacedSender::PacedSender(const Clock* clock,
       packet_counter_(0),
       pacing_factor_(kDefaultPaceMultiplier),
       queue_time_limit(kMaxQueueLengthMs),
-      account_for_audio_(false) {
+      account_for_audio_(false),
+      sub_millisecond_pacing_(false) {
   UpdateBudgetWithElapsedTime(kMinPacketLimitMs);
 }
 
@@ -102,7 +109,7 @@ void PacedSender::Pause() {
   // Tell the process thread to call our TimeUntilNextProcess() method to get
   // a new (longer) estimate for when to call Process().
   if (process_thread_)
-    process_thread_->WakeUp(this);
+    process_thread_->RescheduleModule(this);
 }
 
 void PacedSender::Resume() {
@@ -117,17 +124,39 @@ void PacedSender::Resume() {
   // Tell the process thread to call our TimeUntilNextProcess() method to
   // refresh the estimate for when to call Process().
   if (process_thread_)
-    process_thread_->WakeUp(this);
+    process_thread_->RescheduleModule(this);
 }
 
 void PacedSender::SetCongestionWindow(int64_t congestion_window_bytes) {
-  rtc::CritScope cs(&critsect_);
-  congestion_window_bytes_ = congestion_window_bytes;
+  bool window_opened;
+  {
+    rtc::CritScope cs(&critsect_);
+    bool was_congested = Congested();
+    congestion_window_bytes_ = congestion_window_bytes;
+    window_opened = was_congested && !Congested();
+  }
+  if (window_opened)
+    WakeUpProcessThread();
 }
 
 void PacedSender::UpdateOutstandingData(int64_t outstanding_bytes) {
-  rtc::CritScope cs(&critsect_);
-  outstanding_bytes_ = outstanding_bytes;
+  bool window_opened;
+  {
+    rtc::CritScope cs(&critsect_);
+    bool was_congested = Congested();
+    outstanding_bytes_ = outstanding_bytes;
+    window_opened = was_congested && !Congested();
+  }
+  if (window_opened)
+    WakeUpProcessThread();
+}
+
+void PacedSender::WakeUpProcessThread() {
+  rtc::CritScope cs(&process_thread_lock_);
+  // Don't wait for the next regular process call to send what the congestion
+  // window held back.
+  if (process_thread_)
+    process_thread_->WakeUp(this);
 }
 
 bool PacedSender::Congested() const {
@@ -196,6 +225,11 @@ void PacedSender::InsertPacket(RtpPacketSender::Priority priority,
                                      retransmission, packet_counter_++));
 }
 
+void PacedSender::SetSubMillisecondPacing(bool enabled) {
+  rtc::CritScope cs(&critsect_);
+  sub_millisecond_pacing_ = enabled;
+}
+
 void PacedSender::SetAccountForAudioPackets(bool account_for_audio) {
   rtc::CritScope cs(&critsect_);
   account_for_audio_ = account_for_audio;
@@ -236,6 +270,8 @@ int64_t PacedSender::QueueInMs() const {
 
 int64_t PacedSender::TimeUntilNextProcess() {
   rtc::CritScope cs(&critsect_);
+  if (sub_millisecond_pacing_)
+    return (TimeUntilNextProcessUsInternal() + 999) / 1000;
   int64_t elapsed_time_us =
       clock_->TimeInMicroseconds() - time_last_process_us_;
   int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
@@ -252,17 +288,55 @@ int64_t PacedSender::TimeUntilNextProcess() {
   return std::max<int64_t>(kMinPacketLimitMs - elapsed_time_ms, 0);
 }
 
+int64_t PacedSender::TimeUntilNextProcessUs() {
+  rtc::CritScope cs(&critsect_);
+  return TimeUntilNextProcessUsInternal();
+}
+
+int64_t PacedSender::TimeUntilNextProcessUsInternal() const {
+  int64_t now_us = clock_->TimeInMicroseconds();
+  int64_t elapsed_time_us = now_us - time_last_process_us_;
+  if (paused_) {
+    return std::max<int64_t>(kPausedProcessIntervalMs * 1000 - elapsed_time_us,
+                             0);
+  }
+
+  if (prober_->IsProbing()) {
+    int64_t ret = prober_->TimeUntilNextProbe(clock_->TimeInMilliseconds());
+    if (ret > 0 || (ret == 0 && !probing_send_failure_))
+      return ret * 1000;
+  }
+
+  int64_t next_process_us = kMinPacketLimitMs * 1000 - elapsed_time_us;
+  if (sub_millisecond_pacing_ && !packets_->Empty() && !Congested()) {
+    // Wake up as soon as the budget has grown enough to send the next packet.
+    // It grows from the last send at the rate set then.
+    int64_t budget_wait_us = media_budget_->TimeUntilBytesRemainingUs();
+    if (budget_wait_us >= 0) {
+      next_process_us = std::min(
+          next_process_us, budget_wait_us - (now_us - last_send_time_us_));
+    }
+  }
+  return std::max<int64_t>(next_process_us, 0);
+}
+
 void PacedSender::Process() {
   int64_t now_us = clock_->TimeInMicroseconds();
   rtc::CritScope cs(&critsect_);
   time_last_process_us_ = now_us;
-  int64_t elapsed_time_ms = (now_us - last_send_time_us_ + 500) / 1000;
+  int64_t elapsed_time_us = now_us - last_send_time_us_;
+  int64_t elapsed_time_ms = (elapsed_time_us + 500) / 1000;
   if (elapsed_time_ms > kMaxElapsedTimeMs) {
     RTC_LOG(LS_WARNING) << "Elapsed time (" << elapsed_time_ms
                         << " ms) longer than expected, limiting to "
                         << kMaxElapsedTimeMs << " ms";
     elapsed_time_ms = kMaxElapsedTimeMs;
+    elapsed_time_us = kMaxElapsedTimeMs * 1000;
   }
+  // In sub-millisecond mode the budget is updated on every call, which would
+  // round to zero elapsed milliseconds.
+  bool budget_elapsed = sub_millisecond_pacing_ ? elapsed_time_us > 0
+                                                : elapsed_time_ms > 0;
   // When congested we send a padding packet every 500 ms to ensure we won't get
   // stuck in the congested state due to no feedback being received.
   // TODO(srte): Stop sending packet in paused state when pause is no longer
@@ -278,11 +352,19 @@ void PacedSender::Process() {
       }
       last_send_time_us_ = clock_->TimeInMicroseconds();
     }
+    was_congested_ = Congested();
     return;
   }
+  if (was_congested_) {
+    // Resume at the pacing rate rather than with a burst of what would have
+    // been sent while the congestion window was full.
+    was_congested_ = false;
+    elapsed_time_us = std::min(elapsed_time_us, kMinPacketLimitMs * 1000);
+    elapsed_time_ms = std::min(elapsed_time_ms, kMinPacketLimitMs);
+  }
 
   int target_bitrate_kbps = pacing_bitrate_kbps_;
-  if (elapsed_time_ms > 0) {
+  if (budget_elapsed) {
     size_t queue_size_bytes = packets_->SizeInBytes();
     if (queue_size_bytes > 0) {
       // Assuming equal size packets and input/output rate, the average packet
@@ -298,7 +380,11 @@ void PacedSender::Process() {
     }
 
     media_budget_->set_target_rate_kbps(target_bitrate_kbps);
-    UpdateBudgetWithElapsedTime(elapsed_time_ms);
+    if (sub_millisecond_pacing_) {
+      UpdateBudgetWithElapsedTimeUs(elapsed_time_us);
+    } else {
+      UpdateBudgetWithElapsedTime(elapsed_time_ms);
+    }
   }
 
   last_send_time_us_ = clock_->TimeInMicroseconds();
@@ -311,6 +397,7 @@ void PacedSender::Process() {
     pacing_info = prober_->CurrentCluster();
     recommended_probe_size = prober_->RecommendedMinProbeSize();
   }
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   // The paused state is checked in the loop since SendPacket leaves the
   // critical section allowing the paused state to be changed from other code.
   while (!packets_->Empty() && !paused_ && !Congested()) {
@@ -319,6 +406,16 @@ void PacedSender::Process() {
     // reinsert it if send fails.
     const PacketQueueInterface::Packet& packet = packets_->BeginPop();
 
+    // The discardable packets are the last to be sent, so they only get here
+    // once everything else has been.
+    if (discardable_delay_limit_ms_ > 0 &&
+        packet.priority == RtpPacketSender::kDiscardablePriority &&
+        now_ms - packet.capture_time_ms > discardable_delay_limit_ms_) {
+      packets_->FinalizePop(packet);
+      ++num_discarded_packets_;
+      continue;
+    }
+
     if (SendPacket(packet, pacing_info)) {
       bytes_sent += packet.bytes;
       // Send succeeded, remove it from the queue.
@@ -349,7 +446,14 @@ void PacedSender::Process() {
     if (!probing_send_failure_)
       prober_->ProbeSent(clock_->TimeInMilliseconds(), bytes_sent);
   }
-  alr_detector_->OnBytesSent(bytes_sent, elapsed_time_ms);
+  if (sub_millisecond_pacing_) {
+    alr_detector_->OnBytesSentUs(bytes_sent, elapsed_time_us);
+  } else {
+    alr_detector_->OnBytesSent(bytes_sent, elapsed_time_ms);
+  }
+  // Bytes sent back to back, to compare how smooth the two pacing modes are.
+  if (bytes_sent > 0)
+    RTC_HISTOGRAM_COUNTS_100000("WebRTC.Pacer.BurstSizeBytes", bytes_sent);
 }
 
 void PacedSender::ProcessThreadAttached(ProcessThread* process_thread) {
@@ -408,6 +512,18 @@ void PacedSender::UpdateBudgetWithElapsedTime(int64_t delta_time_ms) {
   padding_budget_->IncreaseBudget(delta_time_ms);
 }
 
+void PacedSender::UpdateBudgetWithElapsedTimeUs(int64_t delta_time_us) {
+  delta_time_us = std::min(kMaxIntervalTimeMs * 1000, delta_time_us);
+  int64_t media_delta_us = delta_time_us;
+  int64_t time_until_budget_us = media_budget_->TimeUntilBytesRemainingUs();
+  if (time_until_budget_us >= 0) {
+    media_delta_us = std::min(
+        media_delta_us, time_until_budget_us + kSubMillisecondMaxBurstUs);
+  }
+  media_budget_->IncreaseBudgetUs(media_delta_us);
+  padding_budget_->IncreaseBudgetUs(delta_time_us);
+}
+
 void PacedSender::UpdateBudgetWithBytesSent(size_t bytes_sent) {
   outstanding_bytes_ += bytes_sent;
   media_budget_->UseBudget(bytes_sent);
@@ -427,4 +543,14 @@ void PacedSender::SetQueueTimeLimit(int limit_ms) {
   queue_time_limit = limit_ms;
 }
 
+void PacedSender::SetDiscardableDelayLimit(int limit_ms) {
+  rtc::CritScope cs(&critsect_);
+  discardable_delay_limit_ms_ = std::max(limit_ms, 0);
+}
+
+int64_t PacedSender::NumDiscardedPackets() const {
+  rtc::CritScope cs(&critsect_);
+  return num_discarded_packets_;
+}
+
 }  // namespace webrtc
@@ -81,6 +81,8 @@ class PacedSender : public Pacer {
   // Resume sending packets.
   void Resume();
 
+  // Media is held back while |outstanding_bytes| is at least the congestion
+  // window. Sending resumes at the pacing rate as soon as the window opens.
   void SetCongestionWindow(int64_t congestion_window_bytes);
   void UpdateOutstandingData(int64_t outstanding_bytes);
 
@@ -130,9 +132,17 @@ class PacedSender : public Pacer {
   // Deprecated, alr detection will be moved out of the pacer.
   virtual rtc::Optional<int64_t> GetApplicationLimitedRegionStartTime() const;
 
+  // Sends packets as soon as the media budget allows rather than in bursts
+  // every 5 ms. The budget is then updated with microsecond precision and
+  // TimeUntilNextProcessUs() is derived from the budget deficit, so the pacer
+  // should be driven by a timer finer than the ProcessThread, see PacerThread.
+  void SetSubMillisecondPacing(bool enabled);
+
   // Returns the number of milliseconds until the module want a worker thread
   // to call Process.
   int64_t TimeUntilNextProcess() override;
+  // Same as TimeUntilNextProcess(), in microseconds.
+  int64_t TimeUntilNextProcessUs();
 
   // Process any pending packets in the queue(s).
   void Process() override;
@@ -142,13 +152,23 @@ class PacedSender : public Pacer {
   // Deprecated, SetPacingRates should be used instead.
   void SetPacingFactor(float pacing_factor);
   void SetQueueTimeLimit(int limit_ms);
+  // Drops the packets of kDiscardablePriority that are still queued
+  // |limit_ms| after they were captured, rather than sending them that late.
+  // 0, the default, sends them however late.
+  void SetDiscardableDelayLimit(int limit_ms);
+  // The number of discardable packets dropped so far.
+  int64_t NumDiscardedPackets() const;
 
  private:
   // Updates the number of bytes that can be sent for the next time interval.
   void UpdateBudgetWithElapsedTime(int64_t delta_time_in_ms)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void UpdateBudgetWithElapsedTimeUs(int64_t delta_time_us)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   void UpdateBudgetWithBytesSent(size_t bytes)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  int64_t TimeUntilNextProcessUsInternal() const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
 
   bool SendPacket(const PacketQueueInterface::Packet& packet,
                   const PacedPacketInfo& cluster_info)
@@ -158,6 +178,7 @@ class PacedSender : public Pacer {
 
   void OnBytesSent(size_t bytes_sent) RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
   bool Congested() const RTC_EXCLUSIVE_LOCKS_REQUIRED(critsect_);
+  void WakeUpProcessThread() RTC_LOCKS_EXCLUDED(critsect_);
 
   const Clock* const clock_;
   PacketSender* const packet_sender_;
@@ -195,6 +216,9 @@ class PacedSender : public Pacer {
   int64_t congestion_window_bytes_ RTC_GUARDED_BY(critsect_) =
       kNoCongestionWindow;
   int64_t outstanding_bytes_ RTC_GUARDED_BY(critsect_) = 0;
+  // Set when Process() found the congestion window full, so that the time
+  // spent waiting for it isn't added to the media budget.
+  bool was_congested_ RTC_GUARDED_BY(critsect_) = false;
   float pacing_factor_ RTC_GUARDED_BY(critsect_);
   // Lock to avoid race when attaching process thread. This can happen due to
   // the Call class setting network state on SendSideCongestionController, which
@@ -205,7 +229,10 @@ class PacedSender : public Pacer {
   ProcessThread* process_thread_ RTC_GUARDED_BY(process_thread_lock_) = nullptr;
 
   int64_t queue_time_limit RTC_GUARDED_BY(critsect_);
+  int64_t discardable_delay_limit_ms_ RTC_GUARDED_BY(critsect_) = 0;
+  int64_t num_discarded_packets_ RTC_GUARDED_BY(critsect_) = 0;
   bool account_for_audio_ RTC_GUARDED_BY(critsect_);
+  bool sub_millisecond_pacing_ RTC_GUARDED_BY(critsect_);
 };
 }  // namespace webrtc
 #endif  // MODULES_PACING_PACED_SENDER_H_
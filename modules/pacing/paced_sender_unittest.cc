@@ -15,6 +15,7 @@
 #include "modules/pacing/paced_sender.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial.h"
+#include "system_wrappers/include/metrics_default.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -470,6 +471,38 @@ TEST_F(PacedSenderTest, Priority) {
   send_bucket_->Process();
 }
 
+TEST_F(PacedSenderTest, DropsDiscardablePacketsQueuedTooLong) {
+  const int kDelayLimitMs = 100;
+  uint32_t ssrc = 12345;
+  uint32_t ssrc_discardable = 12346;
+  uint16_t sequence_number = 1234;
+  const int64_t capture_time_ms = clock_.TimeInMilliseconds();
+  send_bucket_->SetDiscardableDelayLimit(kDelayLimitMs);
+
+  send_bucket_->InsertPacket(PacedSender::kDiscardablePriority,
+                             ssrc_discardable, sequence_number,
+                             capture_time_ms - kDelayLimitMs, 250, false);
+  send_bucket_->InsertPacket(PacedSender::kDiscardablePriority,
+                             ssrc_discardable, sequence_number + 1,
+                             capture_time_ms, 250, false);
+  send_bucket_->InsertPacket(PacedSender::kLowPriority, ssrc, sequence_number,
+                             capture_time_ms, 250, false);
+
+  // The discardable packets go after the low priority one, and the one that
+  // was captured too long ago isn't sent at all.
+  testing::InSequence in_sequence;
+  EXPECT_CALL(callback_,
+              TimeToSendPacket(ssrc, sequence_number, capture_time_ms, false, _))
+      .WillOnce(Return(true));
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc_discardable, sequence_number + 1,
+                                          capture_time_ms, false, _))
+      .WillOnce(Return(true));
+  clock_.AdvanceTimeMilliseconds(5);
+  send_bucket_->Process();
+  EXPECT_EQ(0u, send_bucket_->QueueSizePackets());
+  EXPECT_EQ(1, send_bucket_->NumDiscardedPackets());
+}
+
 TEST_F(PacedSenderTest, RetransmissionPriority) {
   uint32_t ssrc = 12345;
   uint16_t sequence_number = 1234;
@@ -659,6 +692,44 @@ TEST_F(PacedSenderTest, ResumesSendingWhenCongestionEnds) {
   }
 }
 
+TEST_F(PacedSenderTest, DoesNotBurstWhenCongestionEnds) {
+  uint32_t ssrc = 202020;
+  uint16_t sequence_number = 1000;
+  const size_t kPacketSize = 250;
+  const int64_t kCongestionWindow = kPacketSize * 10;
+
+  send_bucket_->UpdateOutstandingData(0);
+  send_bucket_->SetCongestionWindow(kCongestionWindow);
+  int64_t sent_data = 0;
+  while (sent_data < kCongestionWindow) {
+    sent_data += kPacketSize;
+    SendAndExpectPacket(PacedSender::kNormalPriority, ssrc, sequence_number++,
+                        clock_.TimeInMilliseconds(), kPacketSize, false);
+    clock_.AdvanceTimeMilliseconds(5);
+    send_bucket_->Process();
+  }
+  testing::Mock::VerifyAndClearExpectations(&callback_);
+
+  EXPECT_CALL(callback_, TimeToSendPacket(_, _, _, _, _)).Times(0);
+  for (int i = 0; i < 20; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, ssrc,
+                               sequence_number++, clock_.TimeInMilliseconds(),
+                               kPacketSize, false);
+    clock_.AdvanceTimeMilliseconds(5);
+    send_bucket_->Process();
+  }
+  testing::Mock::VerifyAndClearExpectations(&callback_);
+
+  // The window has room for all queued packets, but only what the pacing rate
+  // allows in one process interval goes out.
+  const size_t kBytesPerInterval = kTargetBitrateBps * kPaceMultiplier / 8 / 200;
+  EXPECT_CALL(callback_, TimeToSendPacket(ssrc, _, _, false, _))
+      .Times(kBytesPerInterval / kPacketSize)
+      .WillRepeatedly(Return(true));
+  send_bucket_->UpdateOutstandingData(0);
+  send_bucket_->Process();
+}
+
 TEST_F(PacedSenderTest, Pause) {
   uint32_t ssrc_low_priority = 12345;
   uint32_t ssrc = 12346;
@@ -1181,6 +1252,85 @@ TEST_F(PacedSenderTest, QueueTimePausedDuringPush) {
 }
 #endif
 
+TEST_F(PacedSenderTest, SubMillisecondPacingSendsOnePacketAtATime) {
+  PacedSenderProbing callback;
+  send_bucket_.reset(new PacedSender(&clock_, &callback, nullptr));
+  send_bucket_->SetProbingEnabled(false);
+  send_bucket_->SetPacingRates(kTargetBitrateBps * kPaceMultiplier, 0);
+  send_bucket_->SetSubMillisecondPacing(true);
+
+  const size_t kPacketSize = 1200;
+  const int kNumPackets = 20;
+  const uint32_t kSsrc = 12345;
+  for (int i = 0; i < kNumPackets; ++i) {
+    send_bucket_->InsertPacket(PacedSender::kNormalPriority, kSsrc, i,
+                               clock_.TimeInMilliseconds(), kPacketSize, false);
+  }
+
+  int64_t start_us = clock_.TimeInMicroseconds();
+  int64_t first_sent_us = -1;
+  while (callback.packets_sent() < kNumPackets) {
+    int64_t wait_us = send_bucket_->TimeUntilNextProcessUs();
+    ASSERT_LE(wait_us, 5000);
+    clock_.AdvanceTimeMicroseconds(wait_us);
+    int packets_sent = callback.packets_sent();
+    send_bucket_->Process();
+    EXPECT_LE(callback.packets_sent() - packets_sent, 1);
+    if (first_sent_us < 0 && callback.packets_sent() > 0)
+      first_sent_us = clock_.TimeInMicroseconds();
+    ASSERT_LT(clock_.TimeInMicroseconds() - start_us, 1000000);
+  }
+
+  // Every packet after the first is sent as soon as the budget has recovered
+  // from the previous one, so packets go out evenly at the pacing rate. The
+  // pacer may start out with up to 1 ms of budget.
+  const int64_t kPacingRateKbps = kTargetBitrateBps * kPaceMultiplier / 1000;
+  int64_t expected_us =
+      (kNumPackets - 1) * kPacketSize * 8 * 1000 / kPacingRateKbps;
+  int64_t elapsed_us = clock_.TimeInMicroseconds() - first_sent_us;
+  EXPECT_LE(elapsed_us, expected_us);
+  EXPECT_GE(elapsed_us, expected_us - 1000);
+}
+
+TEST_F(PacedSenderTest, SubMillisecondPacingReducesBurstSize) {
+  const char kBurstSizeHistogram[] = "WebRTC.Pacer.BurstSizeBytes";
+  const size_t kPacketSize = 1200;
+  const int kNumPackets = 100;
+  const uint32_t kSsrc = 12345;
+  // At 20 Mbps, 5 ms of budget is about ten packets.
+  const uint32_t kPacingRateBps = 20000000;
+
+  for (bool sub_millisecond : {false, true}) {
+    PacedSenderProbing callback;
+    send_bucket_.reset(new PacedSender(&clock_, &callback, nullptr));
+    send_bucket_->SetProbingEnabled(false);
+    send_bucket_->SetPacingRates(kPacingRateBps, 0);
+    send_bucket_->SetSubMillisecondPacing(sub_millisecond);
+    metrics::Reset();
+
+    for (int i = 0; i < kNumPackets; ++i) {
+      send_bucket_->InsertPacket(PacedSender::kNormalPriority, kSsrc, i,
+                                 clock_.TimeInMilliseconds(), kPacketSize,
+                                 false);
+    }
+    while (callback.packets_sent() < kNumPackets) {
+      clock_.AdvanceTimeMicroseconds(send_bucket_->TimeUntilNextProcessUs());
+      send_bucket_->Process();
+    }
+
+    if (sub_millisecond) {
+      // Up to 1 ms of budget may be sent at once when the queue was idle; the
+      // rest goes out one packet at a time.
+      EXPECT_GE(metrics::NumEvents(kBurstSizeHistogram, kPacketSize),
+                kNumPackets - 5);
+    } else {
+      EXPECT_LT(metrics::NumSamples(kBurstSizeHistogram), kNumPackets / 5);
+      EXPECT_GE(metrics::MinSample(kBurstSizeHistogram),
+                static_cast<int>(5 * kPacketSize));
+    }
+  }
+}
+
 // TODO(sprang): Extract PacketQueue from PacedSender so that we can test
 // removing elements while paused. (This is possible, but only because of semi-
 // racy condition so can't easily be tested).
@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/pacer_thread.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#include <algorithm>
+
+#include "modules/pacing/paced_sender.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+namespace {
+
+// Waits longer than this are done on |stop_|, which has millisecond
+// resolution, leaving up to 2 ms for the high-resolution sleep.
+const int64_t kMinEventWaitUs = 2000;
+// Upper bound on event waits, so that packets inserted while the queue was
+// empty, or a Resume(), are picked up at least as quickly as with a
+// ProcessThread.
+const int kMaxEventWaitMs = 5;
+
+void SleepUs(int64_t sleep_us) {
+#if defined(WEBRTC_WIN)
+  // Sleep() has the resolution of the system timer, so yield until the
+  // deadline instead.
+  int64_t deadline_us = rtc::TimeMicros() + sleep_us;
+  while (rtc::TimeMicros() < deadline_us)
+    ::SwitchToThread();
+#else
+  struct timespec ts;
+  ts.tv_sec = sleep_us / rtc::kNumMicrosecsPerSec;
+  ts.tv_nsec =
+      (sleep_us % rtc::kNumMicrosecsPerSec) * rtc::kNumNanosecsPerMicrosec;
+  nanosleep(&ts, nullptr);
+#endif
+}
+
+}  // namespace
+
+PacerThread::PacerThread(PacedSender* pacer)
+    : pacer_(pacer),
+      stop_(true, false),
+      thread_(&PacerThread::Run, this, "PacerThread", rtc::kHighPriority) {}
+
+PacerThread::~PacerThread() {
+  Stop();
+}
+
+void PacerThread::Start() {
+  if (thread_.IsRunning())
+    return;
+  stop_.Reset();
+  thread_.Start();
+}
+
+void PacerThread::Stop() {
+  if (!thread_.IsRunning())
+    return;
+  stop_.Set();
+  thread_.Stop();
+}
+
+// static
+void PacerThread::Run(void* obj) {
+  static_cast<PacerThread*>(obj)->Loop();
+}
+
+void PacerThread::Loop() {
+  while (true) {
+    int64_t wait_us = pacer_->TimeUntilNextProcessUs();
+    if (wait_us >= kMinEventWaitUs) {
+      // Wake up early and sleep the rest, which is more precise.
+      int wait_ms = static_cast<int>(
+          std::min<int64_t>(wait_us / 1000 - 1, kMaxEventWaitMs));
+      if (stop_.Wait(wait_ms))
+        return;
+      continue;
+    }
+    if (stop_.Wait(0))
+      return;
+    if (wait_us > 0)
+      SleepUs(wait_us);
+    pacer_->Process();
+  }
+}
+
+}  // namespace webrtc
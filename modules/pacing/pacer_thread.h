@@ -0,0 +1,53 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_PACER_THREAD_H_
+#define MODULES_PACING_PACER_THREAD_H_
+
+#include <stdint.h>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+
+namespace webrtc {
+
+class PacedSender;
+
+// Dedicated thread that calls PacedSender::Process() at the microsecond
+// resolution of PacedSender::TimeUntilNextProcessUs(), for pacers in
+// sub-millisecond mode. A ProcessThread wakes up at millisecond granularity at
+// best. Waits of more than a couple of milliseconds are done on an event and
+// the rest with a high-resolution sleep.
+//
+// The pacer must not also be registered with a ProcessThread. Start() and
+// Stop() must be called on the same thread.
+class PacerThread {
+ public:
+  explicit PacerThread(PacedSender* pacer);
+  ~PacerThread();
+
+  void Start();
+  void Stop();
+
+ private:
+  static void Run(void* obj);
+  void Loop();
+
+  PacedSender* const pacer_;
+  rtc::Event stop_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PacerThread);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_PACER_THREAD_H_
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/pacer_thread.h"
+
+#include "modules/pacing/paced_sender.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+class CountingPacketSender : public PacedSender::PacketSender {
+ public:
+  explicit CountingPacketSender(int expected_packets)
+      : expected_packets_(expected_packets), done_(false, false) {}
+
+  bool TimeToSendPacket(uint32_t ssrc,
+                        uint16_t sequence_number,
+                        int64_t capture_time_ms,
+                        bool retransmission,
+                        const PacedPacketInfo& pacing_info) override {
+    rtc::CritScope cs(&crit_);
+    if (++packets_sent_ == expected_packets_)
+      done_.Set();
+    return true;
+  }
+
+  size_t TimeToSendPadding(size_t bytes,
+                           const PacedPacketInfo& pacing_info) override {
+    return 0;
+  }
+
+  bool Wait(int timeout_ms) { return done_.Wait(timeout_ms); }
+
+ private:
+  const int expected_packets_;
+  rtc::CriticalSection crit_;
+  int packets_sent_ RTC_GUARDED_BY(crit_) = 0;
+  rtc::Event done_;
+};
+
+}  // namespace
+
+TEST(PacerThreadTest, SendsQueuedPacketsAtPacingRate) {
+  const int kNumPackets = 50;
+  const size_t kPacketSize = 1200;
+  // 50 packets take 48 ms at 10 Mbps.
+  const uint32_t kPacingRateBps = 10000000;
+  Clock* clock = Clock::GetRealTimeClock();
+  CountingPacketSender packet_sender(kNumPackets);
+  PacedSender pacer(clock, &packet_sender, nullptr);
+  pacer.SetProbingEnabled(false);
+  pacer.SetPacingRates(kPacingRateBps, 0);
+  pacer.SetSubMillisecondPacing(true);
+
+  PacerThread thread(&pacer);
+  thread.Start();
+  int64_t start_ms = clock->TimeInMilliseconds();
+  for (int i = 0; i < kNumPackets; ++i) {
+    pacer.InsertPacket(PacedSender::kNormalPriority, 12345, i,
+                       clock->TimeInMilliseconds(), kPacketSize, false);
+  }
+  EXPECT_TRUE(packet_sender.Wait(1000));
+  EXPECT_GE(clock->TimeInMilliseconds() - start_ms, 40);
+  thread.Stop();
+}
+
+}  // namespace webrtc
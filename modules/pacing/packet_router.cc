@@ -12,12 +12,14 @@
 
 #include <algorithm>
 #include <limits>
+#include <unordered_map>
 
 #include "modules/rtp_rtcp/include/rtp_rtcp.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/platform_thread_types.h"
 #include "rtc_base/timeutils.h"
 
 namespace webrtc {
@@ -27,8 +29,19 @@ constexpr int kRembSendIntervalMs = 200;
 
 }  // namespace
 
+struct PacketRouter::RoutingTable {
+  RtpRtcp* Find(uint32_t ssrc) const {
+    auto it = modules.find(ssrc);
+    return it == modules.end() ? nullptr : it->second;
+  }
+
+  std::unordered_map<uint32_t, RtpRtcp*> modules;
+};
+
 PacketRouter::PacketRouter()
-    : last_send_module_(nullptr),
+    : routing_table_(new RoutingTable()),
+      routing_readers_(0),
+      last_send_module_(nullptr),
       last_remb_time_ms_(rtc::TimeMillis()),
       last_send_bitrate_bps_(0),
       bitrate_bps_(0),
@@ -42,35 +55,48 @@ PacketRouter::~PacketRouter() {
   RTC_DCHECK(sender_remb_candidates_.empty());
   RTC_DCHECK(receiver_remb_candidates_.empty());
   RTC_DCHECK(active_remb_module_ == nullptr);
+  RTC_DCHECK_EQ(0, rtc::AtomicOps::AcquireLoad(&routing_readers_));
+  delete routing_table_;
 }
 
 void PacketRouter::AddSendRtpModule(RtpRtcp* rtp_module, bool remb_candidate) {
-  rtc::CritScope cs(&modules_crit_);
-  RTC_DCHECK(std::find(rtp_send_modules_.begin(), rtp_send_modules_.end(),
-                       rtp_module) == rtp_send_modules_.end());
-  // Put modules which can use regular payload packets (over rtx) instead of
-  // padding first as it's less of a waste
-  if ((rtp_module->RtxSendStatus() & kRtxRedundantPayloads) > 0) {
-    rtp_send_modules_.push_front(rtp_module);
-  } else {
-    rtp_send_modules_.push_back(rtp_module);
-  }
+  RoutingTable* old_table;
+  {
+    rtc::CritScope cs(&modules_crit_);
+    RTC_DCHECK(std::find(rtp_send_modules_.begin(), rtp_send_modules_.end(),
+                         rtp_module) == rtp_send_modules_.end());
+    // Put modules which can use regular payload packets (over rtx) instead of
+    // padding first as it's less of a waste
+    if ((rtp_module->RtxSendStatus() & kRtxRedundantPayloads) > 0) {
+      rtp_send_modules_.push_front(rtp_module);
+    } else {
+      rtp_send_modules_.push_back(rtp_module);
+    }
 
-  if (remb_candidate) {
-    AddRembModuleCandidate(rtp_module, /* media_sender = */ true);
+    if (remb_candidate) {
+      AddRembModuleCandidate(rtp_module, /* media_sender = */ true);
+    }
+    old_table = PublishRoutingTable();
   }
+  RetireRoutingTable(old_table);
 }
 
 void PacketRouter::RemoveSendRtpModule(RtpRtcp* rtp_module) {
-  rtc::CritScope cs(&modules_crit_);
-  MaybeRemoveRembModuleCandidate(rtp_module, /* media_sender = */ true);
-  auto it =
-      std::find(rtp_send_modules_.begin(), rtp_send_modules_.end(), rtp_module);
-  RTC_DCHECK(it != rtp_send_modules_.end());
-  rtp_send_modules_.erase(it);
-  if (last_send_module_ == rtp_module) {
-    last_send_module_ = nullptr;
+  RoutingTable* old_table;
+  {
+    rtc::CritScope cs(&modules_crit_);
+    MaybeRemoveRembModuleCandidate(rtp_module, /* media_sender = */ true);
+    auto it = std::find(rtp_send_modules_.begin(), rtp_send_modules_.end(),
+                        rtp_module);
+    RTC_DCHECK(it != rtp_send_modules_.end());
+    rtp_send_modules_.erase(it);
+    old_table = PublishRoutingTable();
   }
+  // Once the old table is retired, no TimeToSendPacket() call can use
+  // |rtp_module| anymore, nor cache it as the last send module.
+  RetireRoutingTable(old_table);
+  rtc::AtomicOps::CompareAndSwapPtr(&last_send_module_, rtp_module,
+                                    static_cast<RtpRtcp*>(nullptr));
 }
 
 void PacketRouter::AddReceiveRtpModule(RtcpFeedbackSenderInterface* rtcp_sender,
@@ -102,24 +128,86 @@ bool PacketRouter::TimeToSendPacket(uint32_t ssrc,
                                     int64_t capture_timestamp,
                                     bool retransmission,
                                     const PacedPacketInfo& pacing_info) {
-  rtc::CritScope cs(&modules_crit_);
-  for (auto* rtp_module : rtp_send_modules_) {
-    if (!rtp_module->SendingMedia()) {
-      continue;
-    }
-    if (ssrc == rtp_module->SSRC() || ssrc == rtp_module->FlexfecSsrc()) {
-      if ((rtp_module->RtxSendStatus() & kRtxRedundantPayloads) &&
-          rtp_module->HasBweExtensions()) {
-        // This is now the last module to send media, and has the desired
-        // properties needed for payload based padding. Cache it for later use.
-        last_send_module_ = rtp_module;
-      }
-      return rtp_module->TimeToSendPacket(ssrc, sequence_number,
+  rtc::AtomicOps::Increment(&routing_readers_);
+  const RoutingTable* table = rtc::AtomicOps::AcquireLoadPtr(&routing_table_);
+  RtpRtcp* rtp_module = table->Find(ssrc);
+  if (rtp_module && IsMediaModuleForSsrc(rtp_module, ssrc)) {
+    MaybeSetLastSendModule(rtp_module);
+    bool sent = rtp_module->TimeToSendPacket(ssrc, sequence_number,
+                                             capture_timestamp, retransmission,
+                                             pacing_info);
+    rtc::AtomicOps::Decrement(&routing_readers_);
+    return sent;
+  }
+  rtc::AtomicOps::Decrement(&routing_readers_);
+  return TimeToSendPacketLocked(ssrc, sequence_number, capture_timestamp,
+                                retransmission, pacing_info);
+}
+
+bool PacketRouter::TimeToSendPacketLocked(uint32_t ssrc,
+                                          uint16_t sequence_number,
+                                          int64_t capture_timestamp,
+                                          bool retransmission,
+                                          const PacedPacketInfo& pacing_info) {
+  RoutingTable* old_table = nullptr;
+  bool sent = true;
+  {
+    rtc::CritScope cs(&modules_crit_);
+    for (auto* rtp_module : rtp_send_modules_) {
+      if (!IsMediaModuleForSsrc(rtp_module, ssrc))
+        continue;
+      // The SSRCs of |rtp_module| changed since the table was built.
+      if (routing_table_->Find(ssrc) != rtp_module)
+        old_table = PublishRoutingTable();
+      MaybeSetLastSendModule(rtp_module);
+      sent = rtp_module->TimeToSendPacket(ssrc, sequence_number,
                                           capture_timestamp, retransmission,
                                           pacing_info);
+      break;
     }
   }
-  return true;
+  if (old_table)
+    RetireRoutingTable(old_table);
+  return sent;
+}
+
+bool PacketRouter::IsMediaModuleForSsrc(RtpRtcp* rtp_module,
+                                        uint32_t ssrc) const {
+  return rtp_module->SendingMedia() &&
+         (ssrc == rtp_module->SSRC() || ssrc == rtp_module->FlexfecSsrc());
+}
+
+void PacketRouter::MaybeSetLastSendModule(RtpRtcp* rtp_module) {
+  if ((rtp_module->RtxSendStatus() & kRtxRedundantPayloads) &&
+      rtp_module->HasBweExtensions()) {
+    // This is now the last module to send media, and has the desired
+    // properties needed for payload based padding. Cache it for later use.
+    rtc::AtomicOps::ReleaseStorePtr(&last_send_module_, rtp_module);
+  }
+}
+
+PacketRouter::RoutingTable* PacketRouter::PublishRoutingTable() {
+  RoutingTable* table = new RoutingTable();
+  for (RtpRtcp* rtp_module : rtp_send_modules_) {
+    // As with a linear search of |rtp_send_modules_|, the first module with a
+    // given SSRC wins.
+    table->modules.emplace(rtp_module->SSRC(), rtp_module);
+    rtc::Optional<uint32_t> flexfec_ssrc = rtp_module->FlexfecSsrc();
+    if (flexfec_ssrc)
+      table->modules.emplace(*flexfec_ssrc, rtp_module);
+  }
+  RoutingTable* old_table = routing_table_;
+  rtc::AtomicOps::ReleaseStorePtr(&routing_table_, table);
+  return old_table;
+}
+
+void PacketRouter::RetireRoutingTable(RoutingTable* table) {
+  // Calls that started before the new table was published may still be
+  // using |table|. Sending a packet is short, and the pacer sends from one
+  // thread, so there is soon a moment without any call in progress.
+  while (rtc::AtomicOps::CompareAndSwap(&routing_readers_, 0, 0) != 0)
+    rtc::YieldCurrentThread();
+  delete table;
 }
 
 size_t PacketRouter::TimeToSendPadding(size_t bytes_to_send,
@@ -132,11 +220,12 @@ size_t PacketRouter::TimeToSendPadding(size_t bytes_to_send,
   // will be more skewed towards the highest bitrate stream. At the very least
   // this prevents sending payload padding on a disabled stream where it's
   // guaranteed not to be useful.
-  if (last_send_module_ != nullptr) {
-    RTC_DCHECK(std::find(rtp_send_modules_.begin(), rtp_send_modules_.end(),
-                         last_send_module_) != rtp_send_modules_.end());
-    RTC_DCHECK(last_send_module_->HasBweExtensions());
-    total_bytes_sent += last_send_module_->TimeToSendPadding(
+  RtpRtcp* last_send_module = rtc::AtomicOps::AcquireLoadPtr(&last_send_module_);
+  if (last_send_module != nullptr &&
+      std::find(rtp_send_modules_.begin(), rtp_send_modules_.end(),
+                last_send_module) != rtp_send_modules_.end()) {
+    RTC_DCHECK(last_send_module->HasBweExtensions());
+    total_bytes_sent += last_send_module->TimeToSendPadding(
         bytes_to_send - total_bytes_sent, pacing_info);
     if (total_bytes_sent >= bytes_to_send) {
       return total_bytes_sent;
@@ -161,21 +250,10 @@ void PacketRouter::SetTransportWideSequenceNumber(uint16_t sequence_number) {
 }
 
 uint16_t PacketRouter::AllocateSequenceNumber() {
-  int prev_seq = rtc::AtomicOps::AcquireLoad(&transport_seq_);
-  int desired_prev_seq;
-  int new_seq;
-  do {
-    desired_prev_seq = prev_seq;
-    new_seq = (desired_prev_seq + 1) & 0xFFFF;
-    // Note: CompareAndSwap returns the actual value of transport_seq at the
-    // time the CAS operation was executed. Thus, if prev_seq is returned, the
-    // operation was successful - otherwise we need to retry. Saving the
-    // return value saves us a load on retry.
-    prev_seq = rtc::AtomicOps::CompareAndSwap(&transport_seq_, desired_prev_seq,
-                                              new_seq);
-  } while (prev_seq != desired_prev_seq);
-
-  return new_seq;
+  // A single atomic increment, which unlike a compare-and-swap loop never
+  // retries when several threads allocate at once. Only the low 16 bits of
+  // |transport_seq_| are used, so it is fine for it to wrap.
+  return static_cast<uint16_t>(rtc::AtomicOps::Increment(&transport_seq_));
 }
 
 void PacketRouter::OnReceiveBitrateChanged(const std::vector<uint32_t>& ssrcs,
@@ -188,7 +266,7 @@ void PacketRouter::OnReceiveBitrateChanged(const std::vector<uint32_t>& ssrcs,
 
   int64_t now_ms = rtc::TimeMillis();
   {
-    rtc::CritScope lock(&remb_crit_);
+    MutexLock lock(&remb_mutex_);
 
     // If we already have an estimate, check if the new total estimate is below
     // kSendThresholdPercent of the previous estimate.
@@ -221,7 +299,7 @@ void PacketRouter::OnReceiveBitrateChanged(const std::vector<uint32_t>& ssrcs,
 void PacketRouter::SetMaxDesiredReceiveBitrate(int64_t bitrate_bps) {
   RTC_DCHECK_GE(bitrate_bps, 0);
   {
-    rtc::CritScope lock(&remb_crit_);
+    MutexLock lock(&remb_mutex_);
     max_bitrate_bps_ = bitrate_bps;
     if (rtc::TimeMillis() - last_remb_time_ms_ < kRembSendIntervalMs &&
         last_send_bitrate_bps_ > 0 &&
@@ -20,6 +20,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/synchronization/mutex.h"
 #include "rtc_base/race_checker.h"
 #include "rtc_base/thread_annotations.h"
 
@@ -91,24 +92,57 @@ class PacketRouter : public PacedSender::PacketSender,
   void UnsetActiveRembModule() RTC_EXCLUSIVE_LOCKS_REQUIRED(modules_crit_);
   void DetermineActiveRembModule() RTC_EXCLUSIVE_LOCKS_REQUIRED(modules_crit_);
 
+  // Map from media and FlexFEC SSRC to send module. Tables are never modified
+  // once published, so TimeToSendPacket() reads them without a lock.
+  struct RoutingTable;
+
+  // Fallback for SSRCs the current table doesn't route, e.g. after
+  // RtpRtcp::SetSSRC(). Also republishes the table if it is out of date.
+  bool TimeToSendPacketLocked(uint32_t ssrc,
+                              uint16_t sequence_number,
+                              int64_t capture_timestamp,
+                              bool retransmission,
+                              const PacedPacketInfo& packet_info)
+      RTC_LOCKS_EXCLUDED(modules_crit_);
+  bool IsMediaModuleForSsrc(RtpRtcp* rtp_module, uint32_t ssrc) const;
+  // Caches |rtp_module| for TimeToSendPadding() if it can send payload based
+  // padding.
+  void MaybeSetLastSendModule(RtpRtcp* rtp_module);
+  // Publishes a table built from |rtp_send_modules_| and returns the previous
+  // one, which must be passed to RetireRoutingTable() once |modules_crit_| is
+  // released.
+  RoutingTable* PublishRoutingTable()
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(modules_crit_);
+  // Waits until no TimeToSendPacket() call can still be using |table|, and
+  // deletes it.
+  void RetireRoutingTable(RoutingTable* table)
+      RTC_LOCKS_EXCLUDED(modules_crit_);
+
   rtc::CriticalSection modules_crit_;
   // Rtp and Rtcp modules of the rtp senders.
   std::list<RtpRtcp*> rtp_send_modules_ RTC_GUARDED_BY(modules_crit_);
-  // The last module used to send media.
-  RtpRtcp* last_send_module_ RTC_GUARDED_BY(modules_crit_);
+  // Published routing table for |rtp_send_modules_|. Written under
+  // |modules_crit_|, read with an acquire load.
+  RoutingTable* volatile routing_table_;
+  // Number of TimeToSendPacket() calls that may be using a routing table.
+  volatile int routing_readers_;
+  // The last module used to send media. Set by TimeToSendPacket() without
+  // holding |modules_crit_|, so it may briefly point to a module that is
+  // being removed; TimeToSendPadding() checks it is still a send module.
+  RtpRtcp* volatile last_send_module_;
   // Rtcp modules of the rtp receivers.
   std::vector<RtcpFeedbackSenderInterface*> rtcp_feedback_senders_
       RTC_GUARDED_BY(modules_crit_);
 
-  // TODO(eladalon): remb_crit_ only ever held from one function, and it's not
+  // TODO(eladalon): remb_mutex_ only ever held from one function, and it's not
   // clear if that function can actually be called from more than one thread.
-  rtc::CriticalSection remb_crit_;
+  Mutex remb_mutex_{"PacketRouter::remb_mutex_"};
   // The last time a REMB was sent.
-  int64_t last_remb_time_ms_ RTC_GUARDED_BY(remb_crit_);
-  int64_t last_send_bitrate_bps_ RTC_GUARDED_BY(remb_crit_);
+  int64_t last_remb_time_ms_ RTC_GUARDED_BY(remb_mutex_);
+  int64_t last_send_bitrate_bps_ RTC_GUARDED_BY(remb_mutex_);
   // The last bitrate update.
-  int64_t bitrate_bps_ RTC_GUARDED_BY(remb_crit_);
-  int64_t max_bitrate_bps_ RTC_GUARDED_BY(remb_crit_);
+  int64_t bitrate_bps_ RTC_GUARDED_BY(remb_mutex_);
+  int64_t max_bitrate_bps_ RTC_GUARDED_BY(remb_mutex_);
 
   // Candidates for the REMB module can be RTP sender/receiver modules, with
   // the sender modules taking precedence.
@@ -104,6 +104,8 @@ TEST(PacketRouterTest, TimeToSendPacket) {
   packet_router.AddSendRtpModule(&rtp_1, false);
   packet_router.AddSendRtpModule(&rtp_2, false);
 
+  // The SSRCs are also read when the router rebuilds its routing table, so
+  // SSRC() may be called more than once per packet.
   const uint16_t kSsrc1 = 1234;
   uint16_t sequence_number = 17;
   uint64_t timestamp = 7890;
@@ -111,7 +113,7 @@ TEST(PacketRouterTest, TimeToSendPacket) {
 
   // Send on the first module by letting rtp_1 be sending with correct ssrc.
   EXPECT_CALL(rtp_1, SendingMedia()).Times(1).WillOnce(Return(true));
-  EXPECT_CALL(rtp_1, SSRC()).Times(1).WillOnce(Return(kSsrc1));
+  EXPECT_CALL(rtp_1, SSRC()).WillRepeatedly(Return(kSsrc1));
   EXPECT_CALL(rtp_1, TimeToSendPacket(
                          kSsrc1, sequence_number, timestamp, retransmission,
                          Field(&PacedPacketInfo::probe_cluster_id, 1)))
@@ -129,7 +131,7 @@ TEST(PacketRouterTest, TimeToSendPacket) {
   const uint16_t kSsrc2 = 4567;
   EXPECT_CALL(rtp_1, SendingMedia()).Times(1).WillOnce(Return(false));
   EXPECT_CALL(rtp_2, SendingMedia()).Times(1).WillOnce(Return(true));
-  EXPECT_CALL(rtp_2, SSRC()).Times(1).WillOnce(Return(kSsrc2));
+  EXPECT_CALL(rtp_2, SSRC()).WillRepeatedly(Return(kSsrc2));
   EXPECT_CALL(rtp_1, TimeToSendPacket(_, _, _, _, _)).Times(0);
   EXPECT_CALL(rtp_2, TimeToSendPacket(
                          kSsrc2, sequence_number, timestamp, retransmission,
@@ -141,9 +143,9 @@ TEST(PacketRouterTest, TimeToSendPacket) {
       PacedPacketInfo(2, kProbeMinProbes, kProbeMinBytes)));
 
   // No module is sending, hence no packet should be sent.
-  EXPECT_CALL(rtp_1, SendingMedia()).Times(1).WillOnce(Return(false));
+  EXPECT_CALL(rtp_1, SendingMedia()).WillRepeatedly(Return(false));
   EXPECT_CALL(rtp_1, TimeToSendPacket(_, _, _, _, _)).Times(0);
-  EXPECT_CALL(rtp_2, SendingMedia()).Times(1).WillOnce(Return(false));
+  EXPECT_CALL(rtp_2, SendingMedia()).WillRepeatedly(Return(false));
   EXPECT_CALL(rtp_2, TimeToSendPacket(_, _, _, _, _)).Times(0);
   EXPECT_TRUE(packet_router.TimeToSendPacket(
       kSsrc1, sequence_number, timestamp, retransmission,
@@ -151,9 +153,9 @@ TEST(PacketRouterTest, TimeToSendPacket) {
 
   // Add a packet with incorrect ssrc and test it's dropped in the router.
   EXPECT_CALL(rtp_1, SendingMedia()).Times(1).WillOnce(Return(true));
-  EXPECT_CALL(rtp_1, SSRC()).Times(1).WillOnce(Return(kSsrc1));
+  EXPECT_CALL(rtp_1, SSRC()).WillRepeatedly(Return(kSsrc1));
   EXPECT_CALL(rtp_2, SendingMedia()).Times(1).WillOnce(Return(true));
-  EXPECT_CALL(rtp_2, SSRC()).Times(1).WillOnce(Return(kSsrc2));
+  EXPECT_CALL(rtp_2, SSRC()).WillRepeatedly(Return(kSsrc2));
   EXPECT_CALL(rtp_1, TimeToSendPacket(_, _, _, _, _)).Times(0);
   EXPECT_CALL(rtp_2, TimeToSendPacket(_, _, _, _, _)).Times(0);
   EXPECT_TRUE(packet_router.TimeToSendPacket(
@@ -165,7 +167,7 @@ TEST(PacketRouterTest, TimeToSendPacket) {
   // rtp_1 has been removed, try sending a packet on that ssrc and make sure
   // it is dropped as expected by not expecting any calls to rtp_1.
   EXPECT_CALL(rtp_2, SendingMedia()).Times(1).WillOnce(Return(true));
-  EXPECT_CALL(rtp_2, SSRC()).Times(1).WillOnce(Return(kSsrc2));
+  EXPECT_CALL(rtp_2, SSRC()).WillRepeatedly(Return(kSsrc2));
   EXPECT_CALL(rtp_2, TimeToSendPacket(_, _, _, _, _)).Times(0);
   EXPECT_TRUE(packet_router.TimeToSendPacket(
       kSsrc1, sequence_number, timestamp, retransmission,
@@ -349,6 +351,63 @@ TEST(PacketRouterTest, PadsOnLastActiveMediaStream) {
   packet_router.RemoveSendRtpModule(&rtp_3);
 }
 
+TEST(PacketRouterTest, TimeToSendPacketFollowsSsrcChanges) {
+  PacketRouter packet_router;
+  NiceMock<MockRtpRtcp> rtp_1;
+  NiceMock<MockRtpRtcp> rtp_2;
+  uint32_t ssrc_1 = 1234;
+  const uint32_t kSsrc2 = 4567;
+  ON_CALL(rtp_1, SSRC()).WillByDefault(ReturnPointee(&ssrc_1));
+  ON_CALL(rtp_1, SendingMedia()).WillByDefault(Return(true));
+  ON_CALL(rtp_2, SSRC()).WillByDefault(Return(kSsrc2));
+  ON_CALL(rtp_2, SendingMedia()).WillByDefault(Return(true));
+  packet_router.AddSendRtpModule(&rtp_1, false);
+  packet_router.AddSendRtpModule(&rtp_2, false);
+  const PacedPacketInfo paced_info(PacedPacketInfo::kNotAProbe, kProbeMinBytes,
+                                   kProbeMinBytes);
+
+  EXPECT_CALL(rtp_1, TimeToSendPacket(1234, 1, _, _, _)).WillOnce(Return(true));
+  EXPECT_TRUE(packet_router.TimeToSendPacket(1234, 1, 0, false, paced_info));
+
+  // The module now sends on a new SSRC, and nothing on the old one.
+  ssrc_1 = 8910;
+  EXPECT_CALL(rtp_1, TimeToSendPacket(8910, 2, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(true));
+  EXPECT_TRUE(packet_router.TimeToSendPacket(8910, 2, 0, false, paced_info));
+  EXPECT_TRUE(packet_router.TimeToSendPacket(8910, 2, 0, false, paced_info));
+  EXPECT_CALL(rtp_1, TimeToSendPacket(1234, _, _, _, _)).Times(0);
+  EXPECT_CALL(rtp_2, TimeToSendPacket(1234, _, _, _, _)).Times(0);
+  EXPECT_TRUE(packet_router.TimeToSendPacket(1234, 3, 0, false, paced_info));
+
+  EXPECT_CALL(rtp_2, TimeToSendPacket(kSsrc2, 4, _, _, _))
+      .WillOnce(Return(false));
+  EXPECT_FALSE(packet_router.TimeToSendPacket(kSsrc2, 4, 0, false, paced_info));
+
+  packet_router.RemoveSendRtpModule(&rtp_1);
+  packet_router.RemoveSendRtpModule(&rtp_2);
+}
+
+TEST(PacketRouterTest, TimeToSendPacketOnFlexfecSsrc) {
+  PacketRouter packet_router;
+  NiceMock<MockRtpRtcp> rtp;
+  const uint32_t kSsrc = 1234;
+  const uint32_t kFlexfecSsrc = 4567;
+  ON_CALL(rtp, SSRC()).WillByDefault(Return(kSsrc));
+  ON_CALL(rtp, FlexfecSsrc()).WillByDefault(Return(kFlexfecSsrc));
+  ON_CALL(rtp, SendingMedia()).WillByDefault(Return(true));
+  packet_router.AddSendRtpModule(&rtp, false);
+
+  EXPECT_CALL(rtp, TimeToSendPacket(kFlexfecSsrc, 1, _, _, _))
+      .WillOnce(Return(true));
+  EXPECT_TRUE(packet_router.TimeToSendPacket(
+      kFlexfecSsrc, 1, 0, false,
+      PacedPacketInfo(PacedPacketInfo::kNotAProbe, kProbeMinBytes,
+                      kProbeMinBytes)));
+
+  packet_router.RemoveSendRtpModule(&rtp);
+}
+
 TEST(PacketRouterTest, SenderOnlyFunctionsRespectSendingMedia) {
   PacketRouter packet_router;
   NiceMock<MockRtpRtcp> rtp;
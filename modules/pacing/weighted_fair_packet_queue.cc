@@ -0,0 +1,365 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/weighted_fair_packet_queue.h"
+
+#include <algorithm>
+#include <new>
+
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+namespace {
+
+const size_t kMinRingCapacity = 16;
+
+}  // namespace
+
+const int WeightedFairPacketQueue::kDefaultWeight;
+const int WeightedFairPacketQueue::kMaxWeight;
+const size_t WeightedFairPacketQueue::kQuantumBytes;
+
+WeightedFairPacketQueue::PacketRing::PacketRing()
+    : capacity_(0), head_(0), size_(0) {}
+
+WeightedFairPacketQueue::PacketRing::~PacketRing() {
+  while (!empty())
+    PopFront();
+}
+
+WeightedFairPacketQueue::QueuedPacket*
+WeightedFairPacketQueue::PacketRing::At(size_t index) {
+  RTC_DCHECK_LT(index, capacity_);
+  return reinterpret_cast<QueuedPacket*>(
+      &slots_[(head_ + index) & (capacity_ - 1)]);
+}
+
+void WeightedFairPacketQueue::PacketRing::PushBack(
+    const QueuedPacket& packet) {
+  if (size_ == capacity_)
+    Grow();
+  new (At(size_)) QueuedPacket(packet);
+  ++size_;
+}
+
+void WeightedFairPacketQueue::PacketRing::PushFront(
+    const QueuedPacket& packet) {
+  if (size_ == capacity_)
+    Grow();
+  head_ = (head_ + capacity_ - 1) & (capacity_ - 1);
+  new (At(0)) QueuedPacket(packet);
+  ++size_;
+}
+
+void WeightedFairPacketQueue::PacketRing::PopFront() {
+  RTC_DCHECK(!empty());
+  At(0)->~QueuedPacket();
+  head_ = (head_ + 1) & (capacity_ - 1);
+  --size_;
+}
+
+void WeightedFairPacketQueue::PacketRing::Grow() {
+  size_t capacity = std::max(kMinRingCapacity, 2 * capacity_);
+  std::unique_ptr<Storage[]> slots(new Storage[capacity]);
+  for (size_t i = 0; i < size_; ++i) {
+    QueuedPacket* packet = At(i);
+    new (&slots[i]) QueuedPacket(*packet);
+    packet->~QueuedPacket();
+  }
+  slots_ = std::move(slots);
+  capacity_ = capacity;
+  head_ = 0;
+}
+
+WeightedFairPacketQueue::Stream::Stream(uint32_t ssrc)
+    : ssrc(ssrc),
+      weight(kDefaultWeight),
+      deficit_bytes(0),
+      active_priority(-1),
+      prev(nullptr),
+      next(nullptr) {}
+
+WeightedFairPacketQueue::Stream::~Stream() {}
+
+WeightedFairPacketQueue::WeightedFairPacketQueue(const Clock* clock)
+    : clock_(clock), time_last_updated_(clock_->TimeInMilliseconds()) {}
+
+WeightedFairPacketQueue::~WeightedFairPacketQueue() {}
+
+void WeightedFairPacketQueue::SetStreamWeight(uint32_t ssrc, int weight) {
+  GetOrCreateStream(ssrc)->weight = std::min(std::max(weight, 1), kMaxWeight);
+}
+
+void WeightedFairPacketQueue::Push(const Packet& packet_to_insert) {
+  Stream* stream = GetOrCreateStream(packet_to_insert.ssrc);
+
+  // As in RoundRobinPacketQueue, the time spent paused is subtracted from the
+  // enqueue time now and added back when the packet is popped, which leaves
+  // only the time spent in the queue while not paused.
+  UpdateQueueTime(packet_to_insert.enqueue_time_ms);
+  QueuedPacket queued(packet_to_insert,
+                      AddEnqueueTime(packet_to_insert.enqueue_time_ms));
+  queued.packet.enqueue_time_ms -= pause_time_sum_ms_;
+  stream->classes[ClassIndex(queued.packet)].PushBack(queued);
+
+  // Note that RtpPacketSender::Priority uses lower ordinal for higher
+  // priority.
+  int priority = PriorityIndex(packet_to_insert.priority);
+  if (stream->active_priority < 0) {
+    Activate(stream, priority);
+  } else if (priority < stream->active_priority) {
+    Deactivate(stream);
+    Activate(stream, priority);
+  }
+
+  size_packets_ += 1;
+  size_bytes_ += packet_to_insert.bytes;
+}
+
+const PacketQueueInterface::Packet& WeightedFairPacketQueue::BeginPop() {
+  RTC_CHECK(!pop_packet_ && !pop_);
+
+  Stream* stream = NextStream();
+  int retransmissions = 2 * stream->active_priority;
+  int class_index = stream->classes[retransmissions].empty()
+                        ? retransmissions + 1
+                        : retransmissions;
+  PacketRing& ring = stream->classes[class_index];
+  RTC_CHECK(!ring.empty());
+  pop_packet_.emplace(ring.front());
+  ring.PopFront();
+  pop_.emplace(PendingPop{stream, class_index});
+
+  return pop_packet_->packet;
+}
+
+void WeightedFairPacketQueue::CancelPop(const Packet& packet) {
+  RTC_CHECK(pop_packet_ && pop_);
+  pop_->stream->classes[pop_->class_index].PushFront(*pop_packet_);
+  pop_packet_.reset();
+  pop_.reset();
+}
+
+void WeightedFairPacketQueue::FinalizePop(const Packet& packet) {
+  RTC_CHECK(!paused_);
+  if (Empty())
+    return;
+  RTC_CHECK(pop_packet_ && pop_);
+  Stream* stream = pop_->stream;
+  const QueuedPacket& popped = *pop_packet_;
+
+  // See RoundRobinPacketQueue::FinalizePop() for how the time spent paused is
+  // excluded.
+  int64_t time_in_non_paused_state_ms =
+      time_last_updated_ - popped.packet.enqueue_time_ms - pause_time_sum_ms_;
+  queue_time_sum_ms_ -= time_in_non_paused_state_ms;
+  RemoveEnqueueTime(popped.push_index);
+
+  stream->deficit_bytes -= popped.packet.bytes;
+  size_bytes_ -= popped.packet.bytes;
+  size_packets_ -= 1;
+  RTC_CHECK(size_packets_ > 0 || queue_time_sum_ms_ == 0);
+
+  int priority = TopPriority(*stream);
+  if (priority != stream->active_priority) {
+    Deactivate(stream);
+    if (priority >= 0)
+      Activate(stream, priority);
+  }
+
+  pop_packet_.reset();
+  pop_.reset();
+}
+
+bool WeightedFairPacketQueue::Empty() const {
+  return size_packets_ == 0;
+}
+
+size_t WeightedFairPacketQueue::SizeInPackets() const {
+  return size_packets_;
+}
+
+uint64_t WeightedFairPacketQueue::SizeInBytes() const {
+  return size_bytes_;
+}
+
+int64_t WeightedFairPacketQueue::OldestEnqueueTimeMs() const {
+  if (Empty())
+    return 0;
+  RTC_CHECK_GT(enqueue_times_size_, 0);
+  return enqueue_times_[enqueue_times_head_].time_ms;
+}
+
+void WeightedFairPacketQueue::UpdateQueueTime(int64_t timestamp_ms) {
+  RTC_CHECK_GE(timestamp_ms, time_last_updated_);
+  if (timestamp_ms == time_last_updated_)
+    return;
+
+  int64_t delta_ms = timestamp_ms - time_last_updated_;
+
+  if (paused_) {
+    pause_time_sum_ms_ += delta_ms;
+  } else {
+    queue_time_sum_ms_ += delta_ms * size_packets_;
+  }
+
+  time_last_updated_ = timestamp_ms;
+}
+
+void WeightedFairPacketQueue::SetPauseState(bool paused,
+                                            int64_t timestamp_ms) {
+  if (paused_ == paused)
+    return;
+  UpdateQueueTime(timestamp_ms);
+  paused_ = paused;
+}
+
+int64_t WeightedFairPacketQueue::AverageQueueTimeMs() const {
+  if (Empty())
+    return 0;
+  return queue_time_sum_ms_ / size_packets_;
+}
+
+// static
+int WeightedFairPacketQueue::PriorityIndex(
+    RtpPacketSender::Priority priority) {
+  switch (priority) {
+    case RtpPacketSender::kHighPriority:
+      return 0;
+    case RtpPacketSender::kNormalPriority:
+      return 1;
+    case RtpPacketSender::kLowPriority:
+      return 2;
+    case RtpPacketSender::kDiscardablePriority:
+      return 3;
+  }
+  RTC_NOTREACHED();
+  return kNumPriorities - 1;
+}
+
+// static
+int WeightedFairPacketQueue::ClassIndex(const Packet& packet) {
+  return 2 * PriorityIndex(packet.priority) + (packet.retransmission ? 0 : 1);
+}
+
+WeightedFairPacketQueue::Stream* WeightedFairPacketQueue::GetOrCreateStream(
+    uint32_t ssrc) {
+  if (last_pushed_stream_ && last_pushed_stream_->ssrc == ssrc)
+    return last_pushed_stream_;
+  std::unique_ptr<Stream>& stream = streams_[ssrc];
+  if (!stream)
+    stream.reset(new Stream(ssrc));
+  last_pushed_stream_ = stream.get();
+  return last_pushed_stream_;
+}
+
+// static
+int WeightedFairPacketQueue::TopPriority(const Stream& stream) {
+  for (int priority = 0; priority < kNumPriorities; ++priority) {
+    if (!stream.classes[2 * priority].empty() ||
+        !stream.classes[2 * priority + 1].empty()) {
+      return priority;
+    }
+  }
+  return -1;
+}
+
+void WeightedFairPacketQueue::Activate(Stream* stream, int priority) {
+  RTC_DCHECK_LT(stream->active_priority, 0);
+  stream->active_priority = priority;
+  stream->deficit_bytes = 0;
+  Stream*& current = active_streams_[priority];
+  if (!current) {
+    stream->prev = stream;
+    stream->next = stream;
+    current = stream;
+    return;
+  }
+  // Join at the end of the round, i.e. just before the stream whose turn it
+  // is.
+  stream->next = current;
+  stream->prev = current->prev;
+  current->prev->next = stream;
+  current->prev = stream;
+}
+
+void WeightedFairPacketQueue::Deactivate(Stream* stream) {
+  RTC_DCHECK_GE(stream->active_priority, 0);
+  Stream*& current = active_streams_[stream->active_priority];
+  if (stream->next == stream) {
+    current = nullptr;
+  } else {
+    if (current == stream)
+      current = stream->next;
+    stream->prev->next = stream->next;
+    stream->next->prev = stream->prev;
+  }
+  stream->prev = nullptr;
+  stream->next = nullptr;
+  stream->active_priority = -1;
+  // Credit isn't kept while a stream has nothing to send.
+  stream->deficit_bytes = 0;
+}
+
+WeightedFairPacketQueue::Stream* WeightedFairPacketQueue::NextStream() {
+  for (Stream*& current : active_streams_) {
+    if (!current)
+      continue;
+    // A stream whose turn is used up gets its quantum for the next round and
+    // passes the turn on. A quantum is about a packet's worth, so this takes
+    // few iterations.
+    while (current->deficit_bytes <= 0) {
+      current->deficit_bytes += static_cast<int64_t>(kQuantumBytes) *
+                                current->weight;
+      current = current->next;
+    }
+    return current;
+  }
+  RTC_CHECK(false) << "No stream to send from.";
+  return nullptr;
+}
+
+uint64_t WeightedFairPacketQueue::AddEnqueueTime(int64_t time_ms) {
+  if (enqueue_times_size_ == enqueue_times_capacity_) {
+    size_t capacity =
+        std::max(kMinRingCapacity, 2 * enqueue_times_capacity_);
+    std::unique_ptr<EnqueueTime[]> times(new EnqueueTime[capacity]);
+    for (size_t i = 0; i < enqueue_times_size_; ++i) {
+      times[i] = enqueue_times_[(enqueue_times_head_ + i) &
+                                (enqueue_times_capacity_ - 1)];
+    }
+    enqueue_times_ = std::move(times);
+    enqueue_times_capacity_ = capacity;
+    enqueue_times_head_ = 0;
+  }
+  enqueue_times_[(enqueue_times_head_ + enqueue_times_size_) &
+                 (enqueue_times_capacity_ - 1)] = EnqueueTime{time_ms, true};
+  ++enqueue_times_size_;
+  return first_push_index_ + enqueue_times_size_ - 1;
+}
+
+void WeightedFairPacketQueue::RemoveEnqueueTime(uint64_t push_index) {
+  RTC_DCHECK_GE(push_index, first_push_index_);
+  size_t offset = static_cast<size_t>(push_index - first_push_index_);
+  RTC_DCHECK_LT(offset, enqueue_times_size_);
+  enqueue_times_[(enqueue_times_head_ + offset) &
+                 (enqueue_times_capacity_ - 1)]
+      .queued = false;
+  while (enqueue_times_size_ > 0 &&
+         !enqueue_times_[enqueue_times_head_].queued) {
+    enqueue_times_head_ =
+        (enqueue_times_head_ + 1) & (enqueue_times_capacity_ - 1);
+    --enqueue_times_size_;
+    ++first_push_index_;
+  }
+}
+
+}  // namespace webrtc
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_PACING_WEIGHTED_FAIR_PACKET_QUEUE_H_
+#define MODULES_PACING_WEIGHTED_FAIR_PACKET_QUEUE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+
+#include "api/optional.h"
+#include "modules/pacing/packet_queue_interface.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Pacer queue that shares the send budget between SSRCs by deficit round
+// robin, with every operation O(1) and no per-packet heap allocation.
+//
+// Packets of higher priority are always sent first. Among the streams whose
+// most urgent packet has the same priority, each stream in turn may send
+// kQuantumBytes times its weight before the next one gets to send, so over
+// time streams share the bytes sent in proportion to their weights. Within a
+// stream, retransmissions go before media of the same priority, and packets
+// are otherwise sent in the order they were pushed.
+//
+// Each stream keeps one ring buffer of packets per (priority, retransmission)
+// class. Streams with packets are linked into one circular list per priority.
+class WeightedFairPacketQueue : public PacketQueueInterface {
+ public:
+  explicit WeightedFairPacketQueue(const Clock* clock);
+  ~WeightedFairPacketQueue() override;
+
+  using Packet = PacketQueueInterface::Packet;
+
+  static const int kDefaultWeight = 1;
+  static const int kMaxWeight = 64;
+  static const size_t kQuantumBytes = 1200;
+
+  // Sets the share of |ssrc| relative to other streams of the same priority.
+  // |weight| is clamped to [1, kMaxWeight].
+  void SetStreamWeight(uint32_t ssrc, int weight);
+
+  void Push(const Packet& packet) override;
+  const Packet& BeginPop() override;
+  void CancelPop(const Packet& packet) override;
+  void FinalizePop(const Packet& packet) override;
+
+  bool Empty() const override;
+  size_t SizeInPackets() const override;
+  uint64_t SizeInBytes() const override;
+
+  int64_t OldestEnqueueTimeMs() const override;
+  int64_t AverageQueueTimeMs() const override;
+  void UpdateQueueTime(int64_t timestamp_ms) override;
+  void SetPauseState(bool paused, int64_t timestamp_ms) override;
+
+ private:
+  static const int kNumPriorities = 4;
+  // A class per priority, with retransmissions ahead of media.
+  static const int kNumClasses = 2 * kNumPriorities;
+
+  struct QueuedPacket {
+    QueuedPacket(const Packet& packet, uint64_t push_index)
+        : packet(packet), push_index(push_index) {}
+
+    Packet packet;
+    // Position of the packet in |enqueue_times_|.
+    uint64_t push_index;
+  };
+
+  // FIFO with push and pop at both ends. Storage grows by doubling and is
+  // reused, so steady state pushes don't allocate.
+  class PacketRing {
+   public:
+    PacketRing();
+    ~PacketRing();
+
+    bool empty() const { return size_ == 0; }
+    QueuedPacket& front() { return *At(0); }
+    void PushBack(const QueuedPacket& packet);
+    void PushFront(const QueuedPacket& packet);
+    void PopFront();
+
+   private:
+    QueuedPacket* At(size_t index);
+    void Grow();
+
+    typedef std::aligned_storage<sizeof(QueuedPacket),
+                                 alignof(QueuedPacket)>::type Storage;
+    std::unique_ptr<Storage[]> slots_;
+    size_t capacity_;
+    size_t head_;
+    size_t size_;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(PacketRing);
+  };
+
+  struct Stream {
+    explicit Stream(uint32_t ssrc);
+    ~Stream();
+
+    const uint32_t ssrc;
+    int weight;
+    // Bytes the stream may still send in its current turn.
+    int64_t deficit_bytes;
+    PacketRing classes[kNumClasses];
+    // Priority of the list this stream is linked into, or -1 when it has no
+    // packets.
+    int active_priority;
+    Stream* prev;
+    Stream* next;
+  };
+
+  // Age of a queued packet, in push order. Entries of popped packets are
+  // dropped once they reach the front.
+  struct EnqueueTime {
+    int64_t time_ms;
+    bool queued;
+  };
+
+  static int PriorityIndex(RtpPacketSender::Priority priority);
+  static int ClassIndex(const Packet& packet);
+
+  Stream* GetOrCreateStream(uint32_t ssrc);
+  // Most urgent priority with packets in |stream|, or -1.
+  static int TopPriority(const Stream& stream);
+  void Activate(Stream* stream, int priority);
+  void Deactivate(Stream* stream);
+  // Stream whose turn it is to send, among those with the most urgent
+  // packets.
+  Stream* NextStream();
+
+  // Returns the push index of the new entry.
+  uint64_t AddEnqueueTime(int64_t time_ms);
+  void RemoveEnqueueTime(uint64_t push_index);
+
+  const Clock* const clock_;
+  int64_t time_last_updated_;
+
+  bool paused_ = false;
+  size_t size_packets_ = 0;
+  uint64_t size_bytes_ = 0;
+  int64_t queue_time_sum_ms_ = 0;
+  int64_t pause_time_sum_ms_ = 0;
+
+  std::unordered_map<uint32_t, std::unique_ptr<Stream>> streams_;
+  // Senders usually push runs of packets for the same SSRC.
+  Stream* last_pushed_stream_ = nullptr;
+  // For each priority, the stream whose turn it is in a circular list of the
+  // streams whose most urgent packets have that priority.
+  Stream* active_streams_[kNumPriorities] = {};
+
+  struct PendingPop {
+    Stream* stream;
+    int class_index;
+  };
+  rtc::Optional<QueuedPacket> pop_packet_;
+  rtc::Optional<PendingPop> pop_;
+
+  // Ring of EnqueueTimes indexed by push index, starting at
+  // |first_push_index_|. It holds every packet pushed since the oldest one
+  // still queued, so its front is always the oldest queued packet.
+  std::unique_ptr<EnqueueTime[]> enqueue_times_;
+  size_t enqueue_times_capacity_ = 0;
+  size_t enqueue_times_head_ = 0;
+  size_t enqueue_times_size_ = 0;
+  uint64_t first_push_index_ = 0;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(WeightedFairPacketQueue);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_PACING_WEIGHTED_FAIR_PACKET_QUEUE_H_
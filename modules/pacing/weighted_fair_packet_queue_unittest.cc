@@ -0,0 +1,241 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/pacing/weighted_fair_packet_queue.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/pacing/round_robin_packet_queue.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/clock.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int64_t kStartTimeMs = 1000;
+const int64_t kStartTimeUs = kStartTimeMs * 1000;
+
+class WeightedFairPacketQueueTest : public ::testing::Test {
+ protected:
+  WeightedFairPacketQueueTest() : clock_(kStartTimeUs), queue_(&clock_) {}
+
+  void Push(RtpPacketSender::Priority priority,
+            uint32_t ssrc,
+            uint16_t sequence_number,
+            size_t bytes,
+            bool retransmission) {
+    queue_.Push(PacketQueueInterface::Packet(
+        priority, ssrc, sequence_number, clock_.TimeInMilliseconds(),
+        clock_.TimeInMilliseconds(), bytes, retransmission, enqueue_order_++));
+  }
+
+  void PushMedia(uint32_t ssrc, uint16_t sequence_number) {
+    Push(RtpPacketSender::kNormalPriority, ssrc, sequence_number,
+         WeightedFairPacketQueue::kQuantumBytes, false);
+  }
+
+  // Pops the next packet and returns its sequence number.
+  uint16_t Pop() {
+    const PacketQueueInterface::Packet& packet = queue_.BeginPop();
+    uint16_t sequence_number = packet.sequence_number;
+    queue_.FinalizePop(packet);
+    return sequence_number;
+  }
+
+  SimulatedClock clock_;
+  WeightedFairPacketQueue queue_;
+  uint64_t enqueue_order_ = 0;
+};
+
+}  // namespace
+
+TEST_F(WeightedFairPacketQueueTest, HigherPriorityFirst) {
+  Push(RtpPacketSender::kLowPriority, 1, 1, 100, false);
+  Push(RtpPacketSender::kNormalPriority, 2, 2, 100, false);
+  Push(RtpPacketSender::kHighPriority, 3, 3, 100, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 4, 100, false);
+  EXPECT_EQ(4u, queue_.SizeInPackets());
+  EXPECT_EQ(400u, queue_.SizeInBytes());
+
+  EXPECT_EQ(3, Pop());
+  uint16_t first = Pop();
+  uint16_t second = Pop();
+  EXPECT_TRUE((first == 2 && second == 4) || (first == 4 && second == 2));
+  EXPECT_EQ(1, Pop());
+  EXPECT_TRUE(queue_.Empty());
+  EXPECT_EQ(0u, queue_.SizeInBytes());
+}
+
+TEST_F(WeightedFairPacketQueueTest, RetransmissionsBeforeMediaOfSameStream) {
+  Push(RtpPacketSender::kNormalPriority, 1, 1, 100, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 2, 100, false);
+  Push(RtpPacketSender::kNormalPriority, 1, 3, 100, true);
+  EXPECT_EQ(3, Pop());
+  EXPECT_EQ(1, Pop());
+  EXPECT_EQ(2, Pop());
+}
+
+TEST_F(WeightedFairPacketQueueTest, KeepsPushOrderWithinStream) {
+  for (uint16_t i = 0; i < 100; ++i)
+    PushMedia(1, i);
+  for (uint16_t i = 0; i < 100; ++i)
+    EXPECT_EQ(i, Pop());
+}
+
+TEST_F(WeightedFairPacketQueueTest, CancelPopKeepsOrder) {
+  PushMedia(1, 1);
+  PushMedia(1, 2);
+  const PacketQueueInterface::Packet& packet = queue_.BeginPop();
+  EXPECT_EQ(1, packet.sequence_number);
+  queue_.CancelPop(packet);
+  EXPECT_EQ(2u, queue_.SizeInPackets());
+  EXPECT_EQ(1, Pop());
+  EXPECT_EQ(2, Pop());
+}
+
+TEST_F(WeightedFairPacketQueueTest, AlternatesBetweenEqualStreams) {
+  for (uint16_t i = 0; i < 10; ++i) {
+    PushMedia(1, i);
+    PushMedia(2, 100 + i);
+  }
+  // With packets of one quantum, streams send one packet per turn.
+  std::vector<uint16_t> popped;
+  while (!queue_.Empty())
+    popped.push_back(Pop());
+  for (size_t i = 1; i < popped.size(); ++i)
+    EXPECT_NE(popped[i - 1] < 100, popped[i] < 100);
+}
+
+TEST_F(WeightedFairPacketQueueTest, SharesBytesByWeight) {
+  const uint32_t kLight = 1;
+  const uint32_t kHeavy = 2;
+  queue_.SetStreamWeight(kHeavy, 3);
+  uint16_t sequence_number = 0;
+  for (int i = 0; i < 400; ++i) {
+    Push(RtpPacketSender::kNormalPriority, kLight, sequence_number++, 500,
+         false);
+    Push(RtpPacketSender::kNormalPriority, kHeavy, sequence_number++, 1100,
+         false);
+  }
+
+  std::map<uint32_t, size_t> bytes_sent;
+  for (int i = 0; i < 400; ++i) {
+    const PacketQueueInterface::Packet& packet = queue_.BeginPop();
+    bytes_sent[packet.ssrc] += packet.bytes;
+    queue_.FinalizePop(packet);
+  }
+  double ratio = static_cast<double>(bytes_sent[kHeavy]) / bytes_sent[kLight];
+  EXPECT_NEAR(3.0, ratio, 0.2);
+}
+
+TEST_F(WeightedFairPacketQueueTest, IdleStreamDoesNotBankCredit) {
+  // Let stream 2 get a large turn while it is alone in the queue.
+  queue_.SetStreamWeight(2, WeightedFairPacketQueue::kMaxWeight);
+  PushMedia(2, 100);
+  EXPECT_EQ(100, Pop());
+  EXPECT_TRUE(queue_.Empty());
+
+  // What was left of that turn is gone once the stream has no packets.
+  queue_.SetStreamWeight(2, WeightedFairPacketQueue::kDefaultWeight);
+  for (uint16_t i = 0; i < 10; ++i) {
+    PushMedia(1, i);
+    PushMedia(2, 101 + i);
+  }
+  std::vector<uint16_t> popped;
+  while (!queue_.Empty())
+    popped.push_back(Pop());
+  for (size_t i = 1; i < popped.size(); ++i)
+    EXPECT_NE(popped[i - 1] < 100, popped[i] < 100);
+}
+
+TEST_F(WeightedFairPacketQueueTest, OldestEnqueueTime) {
+  EXPECT_EQ(0, queue_.OldestEnqueueTimeMs());
+  PushMedia(1, 1);
+  clock_.AdvanceTimeMilliseconds(10);
+  PushMedia(2, 2);
+  clock_.AdvanceTimeMilliseconds(10);
+  PushMedia(1, 3);
+  EXPECT_EQ(kStartTimeMs, queue_.OldestEnqueueTimeMs());
+
+  // Packets can leave out of push order; the oldest remaining one counts.
+  queue_.UpdateQueueTime(clock_.TimeInMilliseconds());
+  Pop();
+  Pop();
+  EXPECT_EQ(1u, queue_.SizeInPackets());
+  EXPECT_EQ(kStartTimeMs + 20, queue_.OldestEnqueueTimeMs());
+}
+
+TEST_F(WeightedFairPacketQueueTest, AverageQueueTimeExcludesPauses) {
+  PushMedia(1, 1);
+  clock_.AdvanceTimeMilliseconds(100);
+  queue_.UpdateQueueTime(clock_.TimeInMilliseconds());
+  EXPECT_EQ(100, queue_.AverageQueueTimeMs());
+
+  queue_.SetPauseState(true, clock_.TimeInMilliseconds());
+  clock_.AdvanceTimeMilliseconds(100);
+  queue_.UpdateQueueTime(clock_.TimeInMilliseconds());
+  EXPECT_EQ(100, queue_.AverageQueueTimeMs());
+  queue_.SetPauseState(false, clock_.TimeInMilliseconds());
+
+  clock_.AdvanceTimeMilliseconds(50);
+  queue_.UpdateQueueTime(clock_.TimeInMilliseconds());
+  EXPECT_EQ(150, queue_.AverageQueueTimeMs());
+  Pop();
+  EXPECT_EQ(0, queue_.AverageQueueTimeMs());
+}
+
+// Keeps |kStreams| streams with |kDepth| packets each in the queue while
+// pushing and popping |kPackets| packets, with both queue implementations.
+TEST(WeightedFairPacketQueueBenchmark, DISABLED_PushPop) {
+  const int kStreams = 16;
+  const int kDepth = 64;
+  const int kPackets = 2000000;
+  SimulatedClock clock(kStartTimeUs);
+
+  auto run = [&](PacketQueueInterface* queue) {
+    uint64_t enqueue_order = 0;
+    auto push = [&](int i) {
+      queue->Push(PacketQueueInterface::Packet(
+          RtpPacketSender::kNormalPriority, i % kStreams,
+          static_cast<uint16_t>(i), kStartTimeMs, kStartTimeMs, 1000 + i % 200,
+          i % 20 == 0, enqueue_order++));
+    };
+    for (int i = 0; i < kStreams * kDepth; ++i)
+      push(i);
+    int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < kPackets; ++i) {
+      push(i);
+      const PacketQueueInterface::Packet& packet = queue->BeginPop();
+      queue->FinalizePop(packet);
+    }
+    int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    while (!queue->Empty())
+      queue->FinalizePop(queue->BeginPop());
+    return static_cast<double>(elapsed_ns) / kPackets;
+  };
+
+  RoundRobinPacketQueue round_robin(&clock);
+  double round_robin_ns = run(&round_robin);
+  WeightedFairPacketQueue weighted_fair(&clock);
+  double weighted_fair_ns = run(&weighted_fair);
+  const std::string trace = std::to_string(kStreams) + "_streams_" +
+                            std::to_string(kDepth) + "_deep";
+  test::PrintResult("packet_queue_time", "_round_robin", trace, round_robin_ns,
+                    "ns", false);
+  test::PrintResult("packet_queue_time", "_weighted_fair", trace,
+                    weighted_fair_ns, "ns", false);
+}
+
+}  // namespace webrtc
@@ -32,7 +32,10 @@ enum {
   kInitialProbingIntervalMs = 2000,
   kMinClusterSize = 4,
   kMaxProbePackets = 15,
-  kExpectedNumberOfProbes = 3
+  kExpectedNumberOfProbes = 3,
+  // Bounds the probe history, which otherwise grows with every large packet
+  // for as long as a probe can't be found.
+  kMaxProbeHistory = 64
 };
 
 static const double kTimestampToMs = 1000.0 /
@@ -69,7 +72,7 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
   }
 
   void RemoteBitrateEstimatorAbsSendTime::AddCluster(
-      std::list<Cluster>* clusters,
+      std::vector<Cluster>* clusters,
       Cluster* cluster) {
     cluster->send_mean_ms /= static_cast<float>(cluster->count);
     cluster->recv_mean_ms /= static_cast<float>(cluster->count);
@@ -87,45 +90,86 @@ bool RemoteBitrateEstimatorAbsSendTime::IsWithinClusterBounds(
         detector_(),
         incoming_bitrate_(kBitrateWindowMs, 8000),
         incoming_bitrate_initialized_(false),
+        probes_(kMaxProbeHistory, Probe(0, 0, 0)),
+        oldest_probe_(0),
+        num_probes_(0),
         total_probes_received_(0),
         first_packet_time_ms_(-1),
         last_update_ms_(-1),
-        uma_recorded_(false) {
+        uma_recorded_(false),
+        last_stream_packet_ms_(-1),
+        valid_estimate_(false),
+        feedback_interval_ms_(0),
+        has_removed_ssrcs_(false) {
     RTC_DCHECK(clock_);
     RTC_DCHECK(observer_);
     RTC_LOG(LS_INFO) << "RemoteBitrateEstimatorAbsSendTime: Instantiating.";
 }
 
-void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
-    std::list<Cluster>* clusters) const {
-  Cluster current;
-  int64_t prev_send_time = -1;
-  int64_t prev_recv_time = -1;
-  for (std::list<Probe>::const_iterator it = probes_.begin();
-       it != probes_.end();
-       ++it) {
-    if (prev_send_time >= 0) {
-      int send_delta_ms = it->send_time_ms - prev_send_time;
-      int recv_delta_ms = it->recv_time_ms - prev_recv_time;
-      if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
-        ++current.num_above_min_delta;
-      }
-      if (!IsWithinClusterBounds(send_delta_ms, current)) {
-        if (current.count >= kMinClusterSize &&
-            current.send_mean_ms > 0.0f &&
-            current.recv_mean_ms > 0.0f) {
-          AddCluster(clusters, &current);
-        }
-        current = Cluster();
-      }
-      current.send_mean_ms += send_delta_ms;
-      current.recv_mean_ms += recv_delta_ms;
-      current.mean_size += it->payload_size;
-      ++current.count;
+void RemoteBitrateEstimatorAbsSendTime::AddProbe(const Probe& probe) {
+  if (num_probes_ == probes_.size())
+    RemoveOldestProbe();
+  if (num_probes_ > 0)
+    UpdateProbeClusters(NewestProbe(), probe);
+  probes_[(oldest_probe_ + num_probes_) % probes_.size()] = probe;
+  ++num_probes_;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::RemoveOldestProbe() {
+  RTC_DCHECK_GT(num_probes_, 0);
+  oldest_probe_ = (oldest_probe_ + 1) % probes_.size();
+  --num_probes_;
+  RecomputeProbeClusters();
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ClearProbes() {
+  oldest_probe_ = 0;
+  num_probes_ = 0;
+  probe_clusters_.clear();
+  current_probe_cluster_ = Cluster();
+}
+
+const Probe& RemoteBitrateEstimatorAbsSendTime::NewestProbe() const {
+  RTC_DCHECK_GT(num_probes_, 0);
+  return probes_[(oldest_probe_ + num_probes_ - 1) % probes_.size()];
+}
+
+void RemoteBitrateEstimatorAbsSendTime::UpdateProbeClusters(
+    const Probe& prev_probe,
+    const Probe& probe) {
+  Cluster& current = current_probe_cluster_;
+  int send_delta_ms = probe.send_time_ms - prev_probe.send_time_ms;
+  int recv_delta_ms = probe.recv_time_ms - prev_probe.recv_time_ms;
+  if (send_delta_ms >= 1 && recv_delta_ms >= 1) {
+    ++current.num_above_min_delta;
+  }
+  if (!IsWithinClusterBounds(send_delta_ms, current)) {
+    if (current.count >= kMinClusterSize &&
+        current.send_mean_ms > 0.0f &&
+        current.recv_mean_ms > 0.0f) {
+      AddCluster(&probe_clusters_, &current);
     }
-    prev_send_time = it->send_time_ms;
-    prev_recv_time = it->recv_time_ms;
+    current = Cluster();
   }
+  current.send_mean_ms += send_delta_ms;
+  current.recv_mean_ms += recv_delta_ms;
+  current.mean_size += probe.payload_size;
+  ++current.count;
+}
+
+void RemoteBitrateEstimatorAbsSendTime::RecomputeProbeClusters() {
+  probe_clusters_.clear();
+  current_probe_cluster_ = Cluster();
+  for (size_t i = 1; i < num_probes_; ++i) {
+    UpdateProbeClusters(probes_[(oldest_probe_ + i - 1) % probes_.size()],
+                        probes_[(oldest_probe_ + i) % probes_.size()]);
+  }
+}
+
+void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
+    std::vector<Cluster>* clusters) const {
+  *clusters = probe_clusters_;
+  Cluster current = current_probe_cluster_;
   if (current.count >= kMinClusterSize &&
       current.send_mean_ms > 0.0f &&
       current.recv_mean_ms > 0.0f) {
@@ -133,12 +177,12 @@ void RemoteBitrateEstimatorAbsSendTime::ComputeClusters(
   }
 }
 
-std::list<Cluster>::const_iterator
+std::vector<Cluster>::const_iterator
 RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
-    const std::list<Cluster>& clusters) const {
+    const std::vector<Cluster>& clusters) const {
   int highest_probe_bitrate_bps = 0;
-  std::list<Cluster>::const_iterator best_it = clusters.end();
-  for (std::list<Cluster>::const_iterator it = clusters.begin();
+  std::vector<Cluster>::const_iterator best_it = clusters.end();
+  for (std::vector<Cluster>::const_iterator it = clusters.begin();
        it != clusters.end();
        ++it) {
     if (it->send_mean_ms == 0 || it->recv_mean_ms == 0)
@@ -168,20 +212,21 @@ RemoteBitrateEstimatorAbsSendTime::FindBestProbe(
 
 RemoteBitrateEstimatorAbsSendTime::ProbeResult
 RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
-  std::list<Cluster> clusters;
+  std::vector<Cluster> clusters;
   ComputeClusters(&clusters);
   if (clusters.empty()) {
     // If we reach the max number of probe packets and still have no clusters,
     // we will remove the oldest one.
-    if (probes_.size() >= kMaxProbePackets)
-      probes_.pop_front();
+    if (num_probes_ >= kMaxProbePackets)
+      RemoveOldestProbe();
     return ProbeResult::kNoUpdate;
   }
 
-  std::list<Cluster>::const_iterator best_it = FindBestProbe(clusters);
+  std::vector<Cluster>::const_iterator best_it = FindBestProbe(clusters);
   if (best_it != clusters.end()) {
     int probe_bitrate_bps =
         std::min(best_it->GetSendBitrateBps(), best_it->GetRecvBitrateBps());
+    rtc::CritScope lock(&crit_);
     // Make sure that a probe sent on a lower bitrate than our estimate can't
     // reduce the estimate.
     if (IsBitrateImproving(probe_bitrate_bps)) {
@@ -192,6 +237,7 @@ RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
                        << " ms, mean recv delta: " << best_it->recv_mean_ms
                        << " ms, num probes: " << best_it->count;
       remote_rate_.SetEstimate(probe_bitrate_bps, now_ms);
+      UpdateCachedRateControlState();
       return ProbeResult::kBitrateUpdated;
     }
   }
@@ -199,7 +245,7 @@ RemoteBitrateEstimatorAbsSendTime::ProcessClusters(int64_t now_ms) {
   // Not probing and received non-probe packet, or finished with current set
   // of probes.
   if (clusters.size() >= kExpectedNumberOfProbes)
-    probes_.clear();
+    ClearProbes();
   return ProbeResult::kNoUpdate;
 }
 
@@ -212,6 +258,11 @@ bool RemoteBitrateEstimatorAbsSendTime::IsBitrateImproving(
   return initial_probe || bitrate_above_estimate;
 }
 
+void RemoteBitrateEstimatorAbsSendTime::UpdateCachedRateControlState() {
+  valid_estimate_ = remote_rate_.ValidEstimate();
+  feedback_interval_ms_ = remote_rate_.GetFeedbackInterval();
+}
+
 void RemoteBitrateEstimatorAbsSendTime::IncomingPacket(
     int64_t arrival_time_ms,
     size_t payload_size,
@@ -270,78 +321,85 @@ void RemoteBitrateEstimatorAbsSendTime::IncomingPacketInfo(
   bool update_estimate = false;
   uint32_t target_bitrate_bps = 0;
   std::vector<uint32_t> ssrcs;
-  {
-    rtc::CritScope lock(&crit_);
 
-    TimeoutStreams(now_ms);
-    RTC_DCHECK(inter_arrival_.get());
-    RTC_DCHECK(estimator_.get());
-    ssrcs_[ssrc] = now_ms;
-
-    // For now only try to detect probes while we don't have a valid estimate.
-    // We currently assume that only packets larger than 200 bytes are paced by
-    // the sender.
-    const size_t kMinProbePacketSize = 200;
-    if (payload_size > kMinProbePacketSize &&
-        (!remote_rate_.ValidEstimate() ||
-         now_ms - first_packet_time_ms_ < kInitialProbingIntervalMs)) {
-      // TODO(holmer): Use a map instead to get correct order?
-      if (total_probes_received_ < kMaxProbePackets) {
-        int send_delta_ms = -1;
-        int recv_delta_ms = -1;
-        if (!probes_.empty()) {
-          send_delta_ms = send_time_ms - probes_.back().send_time_ms;
-          recv_delta_ms = arrival_time_ms - probes_.back().recv_time_ms;
-        }
-        RTC_LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
-                         << " ms, recv time=" << arrival_time_ms
-                         << " ms, send delta=" << send_delta_ms
-                         << " ms, recv delta=" << recv_delta_ms << " ms.";
+  // Only the rate control and the reported SSRCs are shared with other
+  // threads, so |crit_| is not taken for packets that don't update them.
+  if (has_removed_ssrcs_.load(std::memory_order_acquire))
+    RemoveStreams(now_ms);
+  TimeoutStreams(now_ms);
+  RTC_DCHECK(inter_arrival_.get());
+  RTC_DCHECK(estimator_.get());
+  ssrcs_[ssrc] = now_ms;
+  last_stream_packet_ms_ = now_ms;
+
+  // For now only try to detect probes while we don't have a valid estimate.
+  // We currently assume that only packets larger than 200 bytes are paced by
+  // the sender.
+  const size_t kMinProbePacketSize = 200;
+  if (payload_size > kMinProbePacketSize &&
+      (!valid_estimate_ ||
+       now_ms - first_packet_time_ms_ < kInitialProbingIntervalMs)) {
+    // TODO(holmer): Use a map instead to get correct order?
+    if (total_probes_received_ < kMaxProbePackets) {
+      int send_delta_ms = -1;
+      int recv_delta_ms = -1;
+      if (num_probes_ > 0) {
+        send_delta_ms = send_time_ms - NewestProbe().send_time_ms;
+        recv_delta_ms = arrival_time_ms - NewestProbe().recv_time_ms;
       }
-      probes_.push_back(Probe(send_time_ms, arrival_time_ms, payload_size));
-      ++total_probes_received_;
-      // Make sure that a probe which updated the bitrate immediately has an
-      // effect by calling the OnReceiveBitrateChanged callback.
-      if (ProcessClusters(now_ms) == ProbeResult::kBitrateUpdated)
-        update_estimate = true;
-    }
-    if (inter_arrival_->ComputeDeltas(timestamp, arrival_time_ms, now_ms,
-                                      payload_size, &ts_delta, &t_delta,
-                                      &size_delta)) {
-      double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
-      estimator_->Update(t_delta, ts_delta_ms, size_delta, detector_.State(),
-                         arrival_time_ms);
-      detector_.Detect(estimator_->offset(), ts_delta_ms,
-                       estimator_->num_of_deltas(), arrival_time_ms);
+      RTC_LOG(LS_INFO) << "Probe packet received: send time=" << send_time_ms
+                       << " ms, recv time=" << arrival_time_ms
+                       << " ms, send delta=" << send_delta_ms
+                       << " ms, recv delta=" << recv_delta_ms << " ms.";
     }
+    AddProbe(Probe(send_time_ms, arrival_time_ms, payload_size));
+    ++total_probes_received_;
+    // Make sure that a probe which updated the bitrate immediately has an
+    // effect by calling the OnReceiveBitrateChanged callback.
+    if (ProcessClusters(now_ms) == ProbeResult::kBitrateUpdated)
+      update_estimate = true;
+  }
+  if (inter_arrival_->ComputeDeltas(timestamp, arrival_time_ms, now_ms,
+                                    payload_size, &ts_delta, &t_delta,
+                                    &size_delta)) {
+    double ts_delta_ms = (1000.0 * ts_delta) / (1 << kInterArrivalShift);
+    estimator_->Update(t_delta, ts_delta_ms, size_delta, detector_.State(),
+                       arrival_time_ms);
+    detector_.Detect(estimator_->offset(), ts_delta_ms,
+                     estimator_->num_of_deltas(), arrival_time_ms);
+  }
 
-    if (!update_estimate) {
-      // Check if it's time for a periodic update or if we should update because
-      // of an over-use.
-      if (last_update_ms_ == -1 ||
-          now_ms - last_update_ms_ > remote_rate_.GetFeedbackInterval()) {
-        update_estimate = true;
-      } else if (detector_.State() == BandwidthUsage::kBwOverusing) {
-        rtc::Optional<uint32_t> incoming_rate =
-            incoming_bitrate_.Rate(arrival_time_ms);
-        if (incoming_rate &&
-            remote_rate_.TimeToReduceFurther(now_ms, *incoming_rate)) {
-          update_estimate = true;
-        }
+  if (!update_estimate) {
+    // Check if it's time for a periodic update or if we should update because
+    // of an over-use.
+    if (last_update_ms_ == -1 ||
+        now_ms - last_update_ms_ > feedback_interval_ms_) {
+      update_estimate = true;
+    } else if (detector_.State() == BandwidthUsage::kBwOverusing) {
+      rtc::Optional<uint32_t> incoming_rate =
+          incoming_bitrate_.Rate(arrival_time_ms);
+      if (incoming_rate) {
+        rtc::CritScope lock(&crit_);
+        update_estimate =
+            remote_rate_.TimeToReduceFurther(now_ms, *incoming_rate);
       }
     }
+  }
 
-    if (update_estimate) {
-      // The first overuse should immediately trigger a new estimate.
-      // We also have to update the estimate immediately if we are overusing
-      // and the target bitrate is too high compared to what we are receiving.
-      const RateControlInput input(detector_.State(),
-                                   incoming_bitrate_.Rate(arrival_time_ms),
-                                   estimator_->var_noise());
-      target_bitrate_bps = remote_rate_.Update(&input, now_ms);
-      update_estimate = remote_rate_.ValidEstimate();
-      ssrcs = Keys(ssrcs_);
-    }
+  if (update_estimate) {
+    // The first overuse should immediately trigger a new estimate.
+    // We also have to update the estimate immediately if we are overusing
+    // and the target bitrate is too high compared to what we are receiving.
+    const RateControlInput input(detector_.State(),
+                                 incoming_bitrate_.Rate(arrival_time_ms),
+                                 estimator_->var_noise());
+    PruneTimedOutStreams(now_ms);
+    ssrcs = Keys(ssrcs_);
+    rtc::CritScope lock(&crit_);
+    target_bitrate_bps = remote_rate_.Update(&input, now_ms);
+    UpdateCachedRateControlState();
+    update_estimate = valid_estimate_;
+    reported_ssrcs_ = ssrcs;
   }
   if (update_estimate) {
     last_update_ms_ = now_ms;
@@ -356,14 +414,26 @@ int64_t RemoteBitrateEstimatorAbsSendTime::TimeUntilNextProcess() {
   return kDisabledModuleTime;
 }
 
-void RemoteBitrateEstimatorAbsSendTime::TimeoutStreams(int64_t now_ms) {
-  for (Ssrcs::iterator it = ssrcs_.begin(); it != ssrcs_.end();) {
-    if ((now_ms - it->second) > kStreamTimeOutMs) {
-      ssrcs_.erase(it++);
-    } else {
-      ++it;
-    }
+void RemoteBitrateEstimatorAbsSendTime::RemoveStreams(int64_t now_ms) {
+  std::vector<uint32_t> removed_ssrcs;
+  {
+    rtc::CritScope lock(&crit_);
+    removed_ssrcs.swap(removed_ssrcs_);
+    has_removed_ssrcs_.store(false, std::memory_order_relaxed);
   }
+  for (uint32_t ssrc : removed_ssrcs)
+    ssrcs_.erase(ssrc);
+  // The stream that received the last packet may have been removed.
+  PruneTimedOutStreams(now_ms);
+  last_stream_packet_ms_ = -1;
+  for (const auto& stream : ssrcs_)
+    last_stream_packet_ms_ = std::max(last_stream_packet_ms_, stream.second);
+}
+
+void RemoteBitrateEstimatorAbsSendTime::TimeoutStreams(int64_t now_ms) {
+  // All streams have timed out when the last one to receive a packet has.
+  if (now_ms - last_stream_packet_ms_ > kStreamTimeOutMs)
+    ssrcs_.clear();
   if (ssrcs_.empty()) {
     // We can't update the estimate if we don't have any active streams.
     inter_arrival_.reset(
@@ -375,6 +445,16 @@ void RemoteBitrateEstimatorAbsSendTime::TimeoutStreams(int64_t now_ms) {
   }
 }
 
+void RemoteBitrateEstimatorAbsSendTime::PruneTimedOutStreams(int64_t now_ms) {
+  for (Ssrcs::iterator it = ssrcs_.begin(); it != ssrcs_.end();) {
+    if ((now_ms - it->second) > kStreamTimeOutMs) {
+      ssrcs_.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+}
+
 void RemoteBitrateEstimatorAbsSendTime::OnRttUpdate(int64_t avg_rtt_ms,
                                                     int64_t max_rtt_ms) {
   rtc::CritScope lock(&crit_);
@@ -383,7 +463,13 @@ void RemoteBitrateEstimatorAbsSendTime::OnRttUpdate(int64_t avg_rtt_ms,
 
 void RemoteBitrateEstimatorAbsSendTime::RemoveStream(uint32_t ssrc) {
   rtc::CritScope lock(&crit_);
-  ssrcs_.erase(ssrc);
+  reported_ssrcs_.erase(
+      std::remove(reported_ssrcs_.begin(), reported_ssrcs_.end(), ssrc),
+      reported_ssrcs_.end());
+  // |ssrcs_| is owned by the packet path, which applies the removal when the
+  // next packet arrives.
+  removed_ssrcs_.push_back(ssrc);
+  has_removed_ssrcs_.store(true, std::memory_order_release);
 }
 
 bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
@@ -399,8 +485,8 @@ bool RemoteBitrateEstimatorAbsSendTime::LatestEstimate(
   if (!remote_rate_.ValidEstimate()) {
     return false;
   }
-  *ssrcs = Keys(ssrcs_);
-  if (ssrcs_.empty()) {
+  *ssrcs = reported_ssrcs_;
+  if (reported_ssrcs_.empty()) {
     *bitrate_bps = 0;
   } else {
     *bitrate_bps = remote_rate_.LatestEstimate();
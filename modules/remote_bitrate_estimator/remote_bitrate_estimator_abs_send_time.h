@@ -11,7 +11,7 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_BITRATE_ESTIMATOR_ABS_SEND_TIME_H_
 
-#include <list>
+#include <atomic>
 #include <map>
 #include <memory>
 #include <vector>
@@ -93,26 +93,47 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   static bool IsWithinClusterBounds(int send_delta_ms,
                                     const Cluster& cluster_aggregate);
 
-  static void AddCluster(std::list<Cluster>* clusters, Cluster* cluster);
+  static void AddCluster(std::vector<Cluster>* clusters, Cluster* cluster);
 
   void IncomingPacketInfo(int64_t arrival_time_ms,
                           uint32_t send_time_24bits,
                           size_t payload_size,
                           uint32_t ssrc);
 
-  void ComputeClusters(std::list<Cluster>* clusters) const;
+  // Appends |probe| to the probe history, evicting the oldest probe if the
+  // history is full.
+  void AddProbe(const Probe& probe);
+  void RemoveOldestProbe();
+  void ClearProbes();
+  const Probe& NewestProbe() const;
 
-  std::list<Cluster>::const_iterator FindBestProbe(
-      const std::list<Cluster>& clusters) const;
+  // Adds the deltas between |prev_probe| and |probe| to the cluster
+  // statistics.
+  void UpdateProbeClusters(const Probe& prev_probe, const Probe& probe);
+  // Rebuilds the cluster statistics from the probe history, which is needed
+  // when a probe is removed from the front.
+  void RecomputeProbeClusters();
+
+  void ComputeClusters(std::vector<Cluster>* clusters) const;
+
+  std::vector<Cluster>::const_iterator FindBestProbe(
+      const std::vector<Cluster>& clusters) const;
 
   // Returns true if a probe which changed the estimate was detected.
-  ProbeResult ProcessClusters(int64_t now_ms)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+  ProbeResult ProcessClusters(int64_t now_ms);
 
   bool IsBitrateImproving(int probe_bitrate_bps) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
 
-  void TimeoutStreams(int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+  // Caches the rate control state that is read for every packet, so that the
+  // packet path only takes |crit_| when it updates |remote_rate_|.
+  void UpdateCachedRateControlState() RTC_EXCLUSIVE_LOCKS_REQUIRED(&crit_);
+
+  // Applies the streams removed with RemoveStream() to |ssrcs_|.
+  void RemoveStreams(int64_t now_ms);
+  void TimeoutStreams(int64_t now_ms);
+  // Drops the streams that haven't received a packet in kStreamTimeOutMs.
+  void PruneTimedOutStreams(int64_t now_ms);
 
   rtc::RaceChecker network_race_;
   const Clock* const clock_;
@@ -124,15 +145,34 @@ class RemoteBitrateEstimatorAbsSendTime : public RemoteBitrateEstimator {
   bool incoming_bitrate_initialized_;
   std::vector<int> recent_propagation_delta_ms_;
   std::vector<int64_t> recent_update_time_ms_;
-  std::list<Probe> probes_;
+  // Ring buffer holding the |num_probes_| most recent probes, starting at
+  // |oldest_probe_|.
+  std::vector<Probe> probes_;
+  size_t oldest_probe_;
+  size_t num_probes_;
+  // Clusters completed so far in |probes_|, and the running sums of the
+  // cluster that the newest probes belong to.
+  std::vector<Cluster> probe_clusters_;
+  Cluster current_probe_cluster_;
   size_t total_probes_received_;
   int64_t first_packet_time_ms_;
   int64_t last_update_ms_;
   bool uma_recorded_;
+  // Time of the last packet of each stream. Streams that have timed out are
+  // only pruned when the SSRCs are reported, or when all of them timed out.
+  Ssrcs ssrcs_;
+  int64_t last_stream_packet_ms_;
+  // Copies of remote_rate_.ValidEstimate() and of
+  // remote_rate_.GetFeedbackInterval().
+  bool valid_estimate_;
+  int64_t feedback_interval_ms_;
 
   rtc::CriticalSection crit_;
-  Ssrcs ssrcs_ RTC_GUARDED_BY(&crit_);
   AimdRateControl remote_rate_ RTC_GUARDED_BY(&crit_);
+  // The SSRCs reported by the last estimate, for LatestEstimate().
+  std::vector<uint32_t> reported_ssrcs_ RTC_GUARDED_BY(&crit_);
+  std::vector<uint32_t> removed_ssrcs_ RTC_GUARDED_BY(&crit_);
+  std::atomic<bool> has_removed_ssrcs_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RemoteBitrateEstimatorAbsSendTime);
 };
@@ -32,15 +32,20 @@ const int RemoteEstimatorProxy::kDefaultSendIntervalMs = 100;
 static constexpr int64_t kMaxTimeMs =
     std::numeric_limits<int64_t>::max() / 1000;
 
+// Marks the sequence numbers in |packet_arrival_times_| that weren't received.
+static constexpr int64_t kNotReceived = -1;
+
 RemoteEstimatorProxy::RemoteEstimatorProxy(
     const Clock* clock,
     TransportFeedbackSenderInterface* feedback_sender)
     : clock_(clock),
       feedback_sender_(feedback_sender),
       last_process_time_ms_(-1),
+      feedback_packet_(new rtcp::TransportFeedback()),
       media_ssrc_(0),
       feedback_sequence_(0),
       window_start_seq_(-1),
+      arrival_times_start_seq_(0),
       send_interval_ms_(kDefaultSendIntervalMs) {}
 
 RemoteEstimatorProxy::~RemoteEstimatorProxy() {}
@@ -81,10 +86,10 @@ void RemoteEstimatorProxy::Process() {
 
   bool more_to_build = true;
   while (more_to_build) {
-    rtcp::TransportFeedback feedback_packet;
-    if (BuildFeedbackPacket(&feedback_packet)) {
+    feedback_packet_->Clear();
+    if (BuildFeedbackPacket(feedback_packet_.get())) {
       RTC_DCHECK(feedback_sender_ != nullptr);
-      feedback_sender_->SendTransportFeedback(&feedback_packet);
+      feedback_sender_->SendTransportFeedback(feedback_packet_.get());
     } else {
       more_to_build = false;
     }
@@ -130,15 +135,13 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     return;
   }
 
-  if (packet_arrival_times_.lower_bound(window_start_seq_) ==
-      packet_arrival_times_.end()) {
+  if (FirstReceivedIndex(window_start_seq_) == packet_arrival_times_.size()) {
     // Start new feedback packet, cull old packets.
-    for (auto it = packet_arrival_times_.begin();
-         it != packet_arrival_times_.end() && it->first < seq &&
-         arrival_time - it->second >= kBackWindowMs;) {
-      auto delete_it = it;
-      ++it;
-      packet_arrival_times_.erase(delete_it);
+    while (!packet_arrival_times_.empty() && arrival_times_start_seq_ < seq &&
+           (packet_arrival_times_.front() == kNotReceived ||
+            arrival_time - packet_arrival_times_.front() >= kBackWindowMs)) {
+      packet_arrival_times_.pop_front();
+      ++arrival_times_start_seq_;
     }
   }
 
@@ -148,11 +151,36 @@ void RemoteEstimatorProxy::OnPacketArrival(uint16_t sequence_number,
     window_start_seq_ = seq;
   }
 
-  // We are only interested in the first time a packet is received.
-  if (packet_arrival_times_.find(seq) != packet_arrival_times_.end())
+  if (packet_arrival_times_.empty()) {
+    arrival_times_start_seq_ = seq;
+    packet_arrival_times_.push_back(arrival_time);
     return;
+  }
+  if (seq < arrival_times_start_seq_) {
+    packet_arrival_times_.insert(packet_arrival_times_.begin(),
+                                 arrival_times_start_seq_ - seq, kNotReceived);
+    arrival_times_start_seq_ = seq;
+  }
+  size_t index = static_cast<size_t>(seq - arrival_times_start_seq_);
+  if (index >= packet_arrival_times_.size()) {
+    packet_arrival_times_.resize(index + 1, kNotReceived);
+  }
+  // We are only interested in the first time a packet is received.
+  if (packet_arrival_times_[index] == kNotReceived)
+    packet_arrival_times_[index] = arrival_time;
+}
 
-  packet_arrival_times_[seq] = arrival_time;
+size_t RemoteEstimatorProxy::FirstReceivedIndex(int64_t seq) const {
+  size_t index = 0;
+  if (seq > arrival_times_start_seq_) {
+    index = std::min(static_cast<size_t>(seq - arrival_times_start_seq_),
+                     packet_arrival_times_.size());
+  }
+  while (index < packet_arrival_times_.size() &&
+         packet_arrival_times_[index] == kNotReceived) {
+    ++index;
+  }
+  return index;
 }
 
 bool RemoteEstimatorProxy::BuildFeedbackPacket(
@@ -161,28 +189,32 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
   // feedback packet. Some older may still be in the map, in case a reordering
   // happens and we need to retransmit them.
   rtc::CritScope cs(&lock_);
-  auto it = packet_arrival_times_.lower_bound(window_start_seq_);
-  if (it == packet_arrival_times_.end()) {
+  size_t index = FirstReceivedIndex(window_start_seq_);
+  if (index == packet_arrival_times_.size()) {
     // Feedback for all packets already sent.
     return false;
   }
 
   // TODO(sprang): Measure receive times in microseconds and remove the
   // conversions below.
-  const int64_t first_sequence = it->first;
+  const size_t first_index = index;
   feedback_packet->SetMediaSsrc(media_ssrc_);
   // Base sequence is the expected next (window_start_seq_). This is known, but
   // we might not have actually received it, so the base time shall be the time
   // of the first received packet in the feedback.
   feedback_packet->SetBase(static_cast<uint16_t>(window_start_seq_ & 0xFFFF),
-                           it->second * 1000);
+                           packet_arrival_times_[index] * 1000);
   feedback_packet->SetFeedbackSequenceNumber(feedback_sequence_++);
-  for (; it != packet_arrival_times_.end(); ++it) {
-    if (!feedback_packet->AddReceivedPacket(
-            static_cast<uint16_t>(it->first & 0xFFFF), it->second * 1000)) {
+  for (; index < packet_arrival_times_.size(); ++index) {
+    const int64_t arrival_time = packet_arrival_times_[index];
+    if (arrival_time == kNotReceived)
+      continue;
+    const int64_t seq = arrival_times_start_seq_ + index;
+    if (!feedback_packet->AddReceivedPacket(static_cast<uint16_t>(seq & 0xFFFF),
+                                            arrival_time * 1000)) {
       // If we can't even add the first seq to the feedback packet, we won't be
       // able to build it at all.
-      RTC_CHECK_NE(first_sequence, it->first);
+      RTC_CHECK_NE(first_index, index);
 
       // Could not add timestamp, feedback packet might be full. Return and
       // try again with a fresh packet.
@@ -192,7 +224,7 @@ bool RemoteEstimatorProxy::BuildFeedbackPacket(
     // Note: Don't erase items from packet_arrival_times_ after sending, in case
     // they need to be re-sent after a reordering. Removal will be handled
     // by OnPacketArrival once packets are too old.
-    window_start_seq_ = it->first + 1;
+    window_start_seq_ = seq + 1;
   }
 
   return true;
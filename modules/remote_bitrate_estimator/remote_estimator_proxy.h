@@ -11,7 +11,8 @@
 #ifndef MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 #define MODULES_REMOTE_BITRATE_ESTIMATOR_REMOTE_ESTIMATOR_PROXY_H_
 
-#include <map>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "modules/include/module_common_types.h"
@@ -57,10 +58,17 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   void OnPacketArrival(uint16_t sequence_number, int64_t arrival_time)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
   bool BuildFeedbackPacket(rtcp::TransportFeedback* feedback_packet);
+  // Index into |packet_arrival_times_| of the first received packet with a
+  // sequence number of at least |seq|, or its size if there is none.
+  size_t FirstReceivedIndex(int64_t seq) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(&lock_);
 
   const Clock* const clock_;
   TransportFeedbackSenderInterface* const feedback_sender_;
   int64_t last_process_time_ms_;
+  // Reused by Process() for every feedback packet, so that its buffers are
+  // allocated only once.
+  const std::unique_ptr<rtcp::TransportFeedback> feedback_packet_;
 
   rtc::CriticalSection lock_;
 
@@ -68,8 +76,11 @@ class RemoteEstimatorProxy : public RemoteBitrateEstimator {
   uint8_t feedback_sequence_ RTC_GUARDED_BY(&lock_);
   SequenceNumberUnwrapper unwrapper_ RTC_GUARDED_BY(&lock_);
   int64_t window_start_seq_ RTC_GUARDED_BY(&lock_);
-  // Map unwrapped seq -> time.
-  std::map<int64_t, int64_t> packet_arrival_times_ RTC_GUARDED_BY(&lock_);
+  // Arrival times of the unwrapped sequence numbers from
+  // |arrival_times_start_seq_| on, or -1 for packets not received. The last
+  // entry is always a received packet.
+  std::deque<int64_t> packet_arrival_times_ RTC_GUARDED_BY(&lock_);
+  int64_t arrival_times_start_seq_ RTC_GUARDED_BY(&lock_);
   int64_t send_interval_ms_ RTC_GUARDED_BY(&lock_);
 };
 
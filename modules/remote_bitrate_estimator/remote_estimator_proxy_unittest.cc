@@ -293,6 +293,33 @@ TEST_F(RemoteEstimatorProxyTest, RemovesTimestampsOutOfScope) {
   Process();
 }
 
+TEST_F(RemoteEstimatorProxyTest, ConsecutiveFeedbackOnlyReportsNewPackets) {
+  IncomingPacket(kBaseSeq, kBaseTimeMs);
+  IncomingPacket(kBaseSeq + 1, kBaseTimeMs + 1);
+  IncomingPacket(kBaseSeq + 2, kBaseTimeMs + 2);
+  EXPECT_CALL(router_, SendTransportFeedback(_)).WillOnce(Return(true));
+  Process();
+
+  // Packets are reported again only after a reordering, and missing packets
+  // between the reported ones don't make it into the feedback.
+  IncomingPacket(kBaseSeq + 5, kBaseTimeMs + 5);
+  IncomingPacket(kBaseSeq + 7, kBaseTimeMs + 7);
+
+  EXPECT_CALL(router_, SendTransportFeedback(_))
+      .WillOnce(Invoke([](rtcp::TransportFeedback* feedback_packet) {
+        EXPECT_EQ(kBaseSeq + 3, feedback_packet->GetBaseSequence());
+        EXPECT_EQ(5u, feedback_packet->GetPacketStatusCount());
+
+        EXPECT_THAT(SequenceNumbers(*feedback_packet),
+                    ElementsAre(kBaseSeq + 5, kBaseSeq + 7));
+        EXPECT_THAT(TimestampsMs(*feedback_packet),
+                    ElementsAre(kBaseTimeMs + 5, kBaseTimeMs + 7));
+        return true;
+      }));
+
+  Process();
+}
+
 TEST_F(RemoteEstimatorProxyTest, TimeUntilNextProcessIsZeroBeforeFirstProcess) {
   EXPECT_EQ(0, proxy_.TimeUntilNextProcess());
 }
@@ -11,6 +11,7 @@
 #ifndef MODULES_RTP_RTCP_INCLUDE_RTP_RTCP_H_
 #define MODULES_RTP_RTCP_INCLUDE_RTP_RTCP_H_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -25,14 +26,20 @@
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/deprecation.h"
 
+namespace rtc {
+class MemoryAccount;
+}  // namespace rtc
+
 namespace webrtc {
 
 // Forward declarations.
+class FrameEncryptorInterface;
 class OverheadObserver;
 class RateLimiter;
 class ReceiveStatisticsProvider;
 class RemoteBitrateEstimator;
 class RtcEventLog;
+class RtpPacketToSend;
 class RtpReceiver;
 class Transport;
 class VideoBitrateAllocationObserver;
@@ -91,6 +98,11 @@ class RtpRtcp : public Module, public RtcpFeedbackSenderInterface {
     FrameCountObserver* send_frame_count_observer = nullptr;
     SendSideDelayObserver* send_side_delay_observer = nullptr;
     RtcEventLog* event_log = nullptr;
+    // If set, the memory used by the packet history is reported to it.
+    rtc::MemoryAccount* memory_account = nullptr;
+    // If set, every outgoing video frame is encrypted before packetization.
+    // Must outlive the module.
+    FrameEncryptorInterface* frame_encryptor = nullptr;
     SendPacketObserver* send_packet_observer = nullptr;
     RateLimiter* retransmission_rate_limiter = nullptr;
     OverheadObserver* overhead_observer = nullptr;
@@ -241,6 +253,14 @@ class RtpRtcp : public Module, public RtcpFeedbackSenderInterface {
                                 const RTPVideoHeader* rtp_video_header,
                                 uint32_t* transport_frame_id_out) = 0;
 
+  // Sends |packet|, built outside of this module, e.g. forwarded from a
+  // received stream without depacketization. Its ssrc must be SSRC(), and its
+  // sequence number and timestamp must already be set; media created by this
+  // module continues the sequence numbers after it. Goes through the pacer,
+  // if there is one. Returns false if media is not being sent.
+  virtual bool SendRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
+                             StorageType storage) = 0;
+
   virtual bool TimeToSendPacket(uint32_t ssrc,
                                 uint16_t sequence_number,
                                 int64_t capture_time_ms,
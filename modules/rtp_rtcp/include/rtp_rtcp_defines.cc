@@ -10,6 +10,8 @@
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 
+#include <algorithm>
+
 namespace webrtc {
 
 StreamDataCounters::StreamDataCounters() : first_packet_time_ms(-1) {}
@@ -44,4 +46,16 @@ PayloadUnion::~PayloadUnion() = default;
 PayloadUnion& PayloadUnion::operator=(const PayloadUnion&) = default;
 PayloadUnion& PayloadUnion::operator=(PayloadUnion&&) = default;
 
+size_t UnencryptedFrameHeaderSize(VideoCodecType codec_type,
+                                  FrameType frame_type,
+                                  size_t frame_size) {
+  constexpr size_t kVp8KeyFrameHeaderSize = 10;
+  constexpr size_t kVp8DeltaFrameHeaderSize = 3;
+  if (codec_type != kVideoCodecVP8)
+    return 0;
+  return std::min(frame_size, frame_type == kVideoFrameKey
+                                  ? kVp8KeyFrameHeaderSize
+                                  : kVp8DeltaFrameHeaderSize);
+}
+
 }  // namespace webrtc
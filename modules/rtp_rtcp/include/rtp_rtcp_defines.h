@@ -216,6 +216,14 @@ struct RTCPReportBlock {
 
 typedef std::list<RTCPReportBlock> ReportBlockList;
 
+// The number of leading bytes of an encoded frame that are sent unencrypted,
+// and authenticated as additional data, when frame encryption is used,
+// because the depacketizer parses them. For VP8 this is the frame tag, plus
+// the start code and frame size of key frames (RFC 6386, section 9.1).
+size_t UnencryptedFrameHeaderSize(VideoCodecType codec_type,
+                                  FrameType frame_type,
+                                  size_t frame_size);
+
 struct RtpState {
   RtpState()
       : sequence_number(0),
@@ -468,6 +476,10 @@ class RtpPacketSender {
     kHighPriority = 0,    // Pass through; will be sent immediately.
     kNormalPriority = 2,  // Put in back of the line.
     kLowPriority = 3,     // Put in back of the low priority line.
+    // Behind the low priority line too, and may be dropped by the pacer if
+    // it has waited too long. For the upper temporal layers of video, which
+    // the base layer doesn't depend on.
+    kDiscardablePriority = 4,
   };
   // Low priority packets are mixed with the normal priority packets
   // while we are paused.
@@ -11,6 +11,7 @@
 #ifndef MODULES_RTP_RTCP_MOCKS_MOCK_RTP_RTCP_H_
 #define MODULES_RTP_RTCP_MOCKS_MOCK_RTP_RTCP_H_
 
+#include <memory>
 #include <set>
 #include <string>
 #include <utility>
@@ -22,6 +23,7 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "rtc_base/checks.h"
 #include "test/gmock.h"
 
@@ -98,6 +100,13 @@ class MockRtpRtcp : public RtpRtcp {
                     const RTPFragmentationHeader* fragmentation,
                     const RTPVideoHeader* rtp_video_header,
                     uint32_t* frame_id_out));
+  // gmock can't mock methods taking move-only arguments.
+  bool SendRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
+                     StorageType storage) override {
+    return SendRtpPacketMock(packet.get(), storage);
+  }
+  MOCK_METHOD2(SendRtpPacketMock,
+               bool(RtpPacketToSend* packet, StorageType storage));
   MOCK_METHOD5(TimeToSendPacket,
                bool(uint32_t ssrc,
                     uint16_t sequence_number,
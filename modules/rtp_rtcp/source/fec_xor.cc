@@ -0,0 +1,64 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/fec_xor.h"
+
+#include <string.h>
+
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+typedef void (*XorBytesFunction)(const uint8_t* src,
+                                 size_t length,
+                                 uint8_t* dst);
+
+// If we know the minimum architecture at compile time, avoid CPU detection.
+XorBytesFunction SelectXorBytes() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSE2__)
+  return XorBytes_SSE2;
+#else
+  return WebRtc_GetCPUInfo(kSSE2) ? XorBytes_SSE2 : XorBytes_C;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return XorBytes_NEON;
+#else
+  return XorBytes_C;
+#endif
+}
+
+}  // namespace
+
+void XorBytes(const uint8_t* src, size_t length, uint8_t* dst) {
+  static const XorBytesFunction xor_bytes = SelectXorBytes();
+  xor_bytes(src, length, dst);
+}
+
+void XorBytes_C(const uint8_t* src, size_t length, uint8_t* dst) {
+  // Eight bytes at a time; memcpy keeps the unaligned accesses well defined
+  // and compiles to plain loads and stores.
+  size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t s;
+    uint64_t d;
+    memcpy(&s, src + i, 8);
+    memcpy(&d, dst + i, 8);
+    d ^= s;
+    memcpy(dst + i, &d, 8);
+  }
+  for (; i < length; ++i)
+    dst[i] ^= src[i];
+}
+
+}  // namespace internal
+}  // namespace webrtc
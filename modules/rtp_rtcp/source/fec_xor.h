@@ -0,0 +1,39 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+#define MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "typedefs.h"  // NOLINT(build/include)
+
+namespace webrtc {
+namespace internal {
+
+// XORs |length| bytes of |src| into |dst|, as done for every protected
+// packet when generating or recovering ULPFEC and FlexFEC packets. Uses the
+// widest kernel the CPU supports. The buffers must not overlap, but need no
+// particular alignment.
+void XorBytes(const uint8_t* src, size_t length, uint8_t* dst);
+
+// The kernels, exposed for testing.
+void XorBytes_C(const uint8_t* src, size_t length, uint8_t* dst);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void XorBytes_SSE2(const uint8_t* src, size_t length, uint8_t* dst);
+#elif defined(WEBRTC_HAS_NEON)
+void XorBytes_NEON(const uint8_t* src, size_t length, uint8_t* dst);
+#endif
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_FEC_XOR_H_
@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/fec_xor.h"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/fec_test_helper.h"
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+typedef void (*XorBytesFunction)(const uint8_t* src,
+                                 size_t length,
+                                 uint8_t* dst);
+
+std::vector<uint8_t> RandomBytes(size_t length, Random* random) {
+  std::vector<uint8_t> bytes(length);
+  for (uint8_t& byte : bytes)
+    byte = random->Rand<uint8_t>();
+  return bytes;
+}
+
+// Checks |xor_bytes| against a byte at a time XOR, for all lengths up to
+// |kMaxLength| and all alignments of the source and destination.
+void TestKernel(XorBytesFunction xor_bytes) {
+  const size_t kMaxLength = 80;
+  const size_t kGuard = 16;
+  Random random(0x1234);
+  for (size_t src_offset = 0; src_offset < 16; ++src_offset) {
+    for (size_t dst_offset = 0; dst_offset < 16; dst_offset += 3) {
+      for (size_t length = 0; length <= kMaxLength; ++length) {
+        std::vector<uint8_t> src = RandomBytes(kMaxLength + kGuard, &random);
+        std::vector<uint8_t> dst = RandomBytes(kMaxLength + kGuard, &random);
+        std::vector<uint8_t> expected = dst;
+        for (size_t i = 0; i < length; ++i)
+          expected[dst_offset + i] ^= src[src_offset + i];
+        xor_bytes(&src[src_offset], length, &dst[dst_offset]);
+        ASSERT_EQ(expected, dst) << "length " << length << ", src offset "
+                                 << src_offset << ", dst offset "
+                                 << dst_offset;
+      }
+    }
+  }
+}
+
+// Generates FEC for 50% overhead over frames of |kNumMediaPackets| packets.
+void BenchmarkEncode(ForwardErrorCorrection* fec,
+                     FecMaskType mask_type,
+                     const char* name) {
+  const int kNumMediaPackets = 12;
+  const int kNumFrames = 20000;
+  const uint8_t kProtectionFactor = 128;
+  Random random(0xabcdef);
+  test::fec::MediaPacketGenerator generator(
+      kRtpHeaderSize, IP_PACKET_SIZE - 28 - fec->MaxPacketOverhead(), 4321,
+      &random);
+  ForwardErrorCorrection::PacketList media_packets =
+      generator.ConstructMediaPackets(kNumMediaPackets);
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumFrames; ++i) {
+    fec_packets.clear();
+    ASSERT_EQ(0, fec->EncodeFec(media_packets, kProtectionFactor, 0, false,
+                                mask_type, &fec_packets));
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  const std::string trace =
+      std::string(name) + (mask_type == kFecMaskBursty ? "_bursty" : "_random");
+  test::PrintResult("fec_encode_time", "", trace,
+                    static_cast<double>(elapsed_ns) / kNumFrames / 1000, "us",
+                    false);
+  test::PrintResult("fec_packets", "", trace, fec_packets.size(), "packets",
+                    false);
+}
+
+}  // namespace
+
+TEST(FecXorTest, CKernelMatchesByteXor) {
+  TestKernel(XorBytes_C);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(FecXorTest, Sse2KernelMatchesByteXor) {
+  TestKernel(XorBytes_SSE2);
+}
+#elif defined(WEBRTC_HAS_NEON)
+TEST(FecXorTest, NeonKernelMatchesByteXor) {
+  TestKernel(XorBytes_NEON);
+}
+#endif
+
+TEST(FecXorTest, DispatchedKernelMatchesByteXor) {
+  TestKernel(XorBytes);
+}
+
+TEST(FecXorTest, DISABLED_EncodeBenchmark) {
+  std::unique_ptr<ForwardErrorCorrection> ulpfec =
+      ForwardErrorCorrection::CreateUlpfec(1234);
+  std::unique_ptr<ForwardErrorCorrection> flexfec =
+      ForwardErrorCorrection::CreateFlexfec(1234, 4321);
+  for (FecMaskType mask_type : {kFecMaskBursty, kFecMaskRandom}) {
+    BenchmarkEncode(ulpfec.get(), mask_type, "ULPFEC");
+    BenchmarkEncode(flexfec.get(), mask_type, "FlexFEC");
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
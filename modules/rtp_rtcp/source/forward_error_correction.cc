@@ -18,6 +18,7 @@
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/fec_xor.h"
 #include "modules/rtp_rtcp/source/flexfec_header_reader_writer.h"
 #include "modules/rtp_rtcp/source/forward_error_correction_internal.h"
 #include "modules/rtp_rtcp/source/ulpfec_header_reader_writer.h"
@@ -344,6 +345,8 @@ void ForwardErrorCorrection::ResetState(
   // Free the memory for any existing recovered packets, if the caller hasn't.
   recovered_packets->clear();
   received_fec_packets_.clear();
+  fec_packets_by_protected_seq_num_.clear();
+  recovery_possible_ = false;
 }
 
 void ForwardErrorCorrection::InsertMediaPacket(
@@ -351,13 +354,15 @@ void ForwardErrorCorrection::InsertMediaPacket(
     const ReceivedPacket& received_packet) {
   RTC_DCHECK_EQ(received_packet.ssrc, protected_media_ssrc_);
 
-  // Search for duplicate packets.
-  for (const auto& recovered_packet : *recovered_packets) {
-    RTC_DCHECK_EQ(recovered_packet->ssrc, received_packet.ssrc);
-    if (recovered_packet->seq_num == received_packet.seq_num) {
-      // Duplicate packet, no need to add to list.
-      return;
-    }
+  // Search for duplicate packets. |recovered_packets| is sorted, so this is
+  // also where the new packet belongs.
+  auto insert_it =
+      std::lower_bound(recovered_packets->begin(), recovered_packets->end(),
+                       &received_packet, SortablePacket::LessThan());
+  if (insert_it != recovered_packets->end() &&
+      (*insert_it)->seq_num == received_packet.seq_num) {
+    // Duplicate packet, no need to add to list.
+    return;
   }
 
   std::unique_ptr<RecoveredPacket> recovered_packet(new RecoveredPacket());
@@ -369,26 +374,29 @@ void ForwardErrorCorrection::InsertMediaPacket(
   recovered_packet->seq_num = received_packet.seq_num;
   recovered_packet->pkt = received_packet.pkt;
   recovered_packet->pkt->length = received_packet.pkt->length;
-  // TODO(holmer): Consider replacing this with a binary search for the right
-  // position, and then just insert the new packet. Would get rid of the sort.
   RecoveredPacket* recovered_packet_ptr = recovered_packet.get();
-  recovered_packets->push_back(std::move(recovered_packet));
-  recovered_packets->sort(SortablePacket::LessThan());
+  recovered_packets->insert(insert_it, std::move(recovered_packet));
   UpdateCoveringFecPackets(*recovered_packet_ptr);
 }
 
 void ForwardErrorCorrection::UpdateCoveringFecPackets(
     const RecoveredPacket& packet) {
-  for (auto& fec_packet : received_fec_packets_) {
-    // Is this FEC packet protecting the media packet |packet|?
+  auto range = fec_packets_by_protected_seq_num_.equal_range(packet.seq_num);
+  for (auto it = range.first; it != range.second; ++it) {
+    // Found an FEC packet which is protecting |packet|.
+    ReceivedFecPacket* fec_packet = it->second;
     auto protected_it = std::lower_bound(fec_packet->protected_packets.begin(),
                                          fec_packet->protected_packets.end(),
                                          &packet, SortablePacket::LessThan());
-    if (protected_it != fec_packet->protected_packets.end() &&
-        (*protected_it)->seq_num == packet.seq_num) {
-      // Found an FEC packet which is protecting |packet|.
-      (*protected_it)->pkt = packet.pkt;
+    RTC_DCHECK(protected_it != fec_packet->protected_packets.end());
+    RTC_DCHECK_EQ((*protected_it)->seq_num, packet.seq_num);
+    if ((*protected_it)->pkt == nullptr) {
+      RTC_DCHECK_GT(fec_packet->num_missing_packets, 0);
+      if (--fec_packet->num_missing_packets <= 1) {
+        recovery_possible_ = true;
+      }
     }
+    (*protected_it)->pkt = packet.pkt;
   }
 }
 
@@ -447,13 +455,21 @@ void ForwardErrorCorrection::InsertFecPacket(
     RTC_LOG(LS_WARNING) << "Received FEC packet has an all-zero packet mask.";
   } else {
     AssignRecoveredPackets(recovered_packets, fec_packet.get());
-    // TODO(holmer): Consider replacing this with a binary search for the right
-    // position, and then just insert the new packet. Would get rid of the sort.
-    received_fec_packets_.push_back(std::move(fec_packet));
-    received_fec_packets_.sort(SortablePacket::LessThan());
+    if (fec_packet->num_missing_packets <= 1) {
+      recovery_possible_ = true;
+    }
+    for (const auto& protected_packet : fec_packet->protected_packets) {
+      fec_packets_by_protected_seq_num_.emplace(protected_packet->seq_num,
+                                                fec_packet.get());
+    }
+    auto insert_it =
+        std::upper_bound(received_fec_packets_.begin(),
+                         received_fec_packets_.end(), fec_packet,
+                         SortablePacket::LessThan());
+    received_fec_packets_.insert(insert_it, std::move(fec_packet));
     const size_t max_fec_packets = fec_header_reader_->MaxFecPackets();
     if (received_fec_packets_.size() > max_fec_packets) {
-      received_fec_packets_.pop_front();
+      EraseFecPacket(received_fec_packets_.begin());
     }
     RTC_DCHECK_LE(received_fec_packets_.size(), max_fec_packets);
   }
@@ -472,6 +488,7 @@ void ForwardErrorCorrection::AssignRecoveredPackets(
   auto it_p = protected_packets->cbegin();
   auto it_r = recovered_packets.cbegin();
   SortablePacket::LessThan less_than;
+  fec_packet->num_missing_packets = protected_packets->size();
   while (it_p != protected_packets->end() && it_r != recovered_packets.end()) {
     if (less_than(*it_p, *it_r)) {
       ++it_p;
@@ -480,12 +497,30 @@ void ForwardErrorCorrection::AssignRecoveredPackets(
     } else {  // *it_p == *it_r.
       // This protected packet has already been recovered.
       (*it_p)->pkt = (*it_r)->pkt;
+      --fec_packet->num_missing_packets;
       ++it_p;
       ++it_r;
     }
   }
 }
 
+ForwardErrorCorrection::ReceivedFecPacketList::iterator
+ForwardErrorCorrection::EraseFecPacket(
+    ReceivedFecPacketList::iterator fec_packet_it) {
+  const ReceivedFecPacket* fec_packet = fec_packet_it->get();
+  for (const auto& protected_packet : fec_packet->protected_packets) {
+    auto range = fec_packets_by_protected_seq_num_.equal_range(
+        protected_packet->seq_num);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (it->second == fec_packet) {
+        fec_packets_by_protected_seq_num_.erase(it);
+        break;
+      }
+    }
+  }
+  return received_fec_packets_.erase(fec_packet_it);
+}
+
 void ForwardErrorCorrection::InsertPacket(
     const ReceivedPacket& received_packet,
     RecoveredPacketList* recovered_packets) {
@@ -508,7 +543,7 @@ void ForwardErrorCorrection::InsertPacket(
     while (it != received_fec_packets_.end()) {
       uint16_t seq_num_diff = MinDiff(received_packet.seq_num, (*it)->seq_num);
       if (seq_num_diff > 0x3fff) {
-        it = received_fec_packets_.erase(it);
+        it = EraseFecPacket(it);
       } else {
         // No need to keep iterating, since |received_fec_packets_| is sorted.
         break;
@@ -611,9 +646,8 @@ void ForwardErrorCorrection::XorPayloads(const Packet& src,
   // XOR the payload.
   RTC_DCHECK_LE(kRtpHeaderSize + payload_length, sizeof(src.data));
   RTC_DCHECK_LE(dst_offset + payload_length, sizeof(dst->data));
-  for (size_t i = 0; i < payload_length; ++i) {
-    dst->data[dst_offset + i] ^= src.data[kRtpHeaderSize + i];
-  }
+  internal::XorBytes(&src.data[kRtpHeaderSize], payload_length,
+                     &dst->data[dst_offset]);
 }
 
 bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
@@ -639,6 +673,12 @@ bool ForwardErrorCorrection::RecoverPacket(const ReceivedFecPacket& fec_packet,
 
 void ForwardErrorCorrection::AttemptRecovery(
     RecoveredPacketList* recovered_packets) {
+  // Every FEC packet left after the previous call is missing at least two
+  // packets, so there is nothing to do until one of them gets closer.
+  if (!recovery_possible_) {
+    return;
+  }
+  recovery_possible_ = false;
   auto fec_packet_it = received_fec_packets_.begin();
   while (fec_packet_it != received_fec_packets_.end()) {
     // Search for each FEC packet's protected media packets.
@@ -651,30 +691,31 @@ void ForwardErrorCorrection::AttemptRecovery(
       recovered_packet->pkt = nullptr;
       if (!RecoverPacket(**fec_packet_it, recovered_packet.get())) {
         // Can't recover using this packet, drop it.
-        fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+        fec_packet_it = EraseFecPacket(fec_packet_it);
         continue;
       }
 
       auto* recovered_packet_ptr = recovered_packet.get();
       // Add recovered packet to the list of recovered packets and update any
       // FEC packets covering this packet with a pointer to the data.
-      // TODO(holmer): Consider replacing this with a binary search for the
-      // right position, and then just insert the new packet. Would get rid of
-      // the sort.
-      recovered_packets->push_back(std::move(recovered_packet));
-      recovered_packets->sort(SortablePacket::LessThan());
+      auto insert_it =
+          std::upper_bound(recovered_packets->begin(), recovered_packets->end(),
+                           recovered_packet, SortablePacket::LessThan());
+      recovered_packets->insert(insert_it, std::move(recovered_packet));
+      fec_packet_it = EraseFecPacket(fec_packet_it);
       UpdateCoveringFecPackets(*recovered_packet_ptr);
       DiscardOldRecoveredPackets(recovered_packets);
-      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
 
-      // A packet has been recovered. We need to check the FEC list again, as
-      // this may allow additional packets to be recovered.
-      // Restart for first FEC packet.
-      fec_packet_it = received_fec_packets_.begin();
+      // A packet has been recovered. If this allows additional packets to be
+      // recovered, we need to check the FEC list again.
+      if (recovery_possible_) {
+        recovery_possible_ = false;
+        fec_packet_it = received_fec_packets_.begin();
+      }
     } else if (packets_missing == 0) {
       // Either all protected packets arrived or have been recovered. We can
       // discard this FEC packet.
-      fec_packet_it = received_fec_packets_.erase(fec_packet_it);
+      fec_packet_it = EraseFecPacket(fec_packet_it);
     } else {
       fec_packet_it++;
     }
@@ -683,16 +724,9 @@ void ForwardErrorCorrection::AttemptRecovery(
 
 int ForwardErrorCorrection::NumCoveredPacketsMissing(
     const ReceivedFecPacket& fec_packet) {
-  int packets_missing = 0;
-  for (const auto& protected_packet : fec_packet.protected_packets) {
-    if (protected_packet->pkt == nullptr) {
-      ++packets_missing;
-      if (packets_missing > 1) {
-        break;  // We can't recover more than one packet.
-      }
-    }
-  }
-  return packets_missing;
+  // We can't recover more than one packet.
+  return static_cast<int>(
+      std::min<size_t>(fec_packet.num_missing_packets, 2));
 }
 
 void ForwardErrorCorrection::DiscardOldRecoveredPackets(
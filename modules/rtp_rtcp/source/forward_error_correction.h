@@ -14,6 +14,7 @@
 #include <stdint.h>
 
 #include <list>
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -127,6 +128,9 @@ class ForwardErrorCorrection {
 
     // List of media packets that this FEC packet protects.
     ProtectedPacketList protected_packets;
+    // Number of |protected_packets| that have neither been received nor
+    // recovered yet.
+    size_t num_missing_packets = 0;
     // RTP header fields.
     uint32_t ssrc;
     // FEC header fields.
@@ -283,11 +287,17 @@ class ForwardErrorCorrection {
   void InsertFecPacket(const RecoveredPacketList& recovered_packets,
                        const ReceivedPacket& received_packet);
 
-  // Assigns pointers to already recovered packets covered by |fec_packet|.
+  // Assigns pointers to already recovered packets covered by |fec_packet|,
+  // and counts the covered packets that are still missing.
   static void AssignRecoveredPackets(
       const RecoveredPacketList& recovered_packets,
       ReceivedFecPacket* fec_packet);
 
+  // Removes |fec_packet_it| from |received_fec_packets_| and from the index
+  // of protected sequence numbers. Returns the next FEC packet.
+  ReceivedFecPacketList::iterator EraseFecPacket(
+      ReceivedFecPacketList::iterator fec_packet_it);
+
   // Attempt to recover missing packets, using the internally stored
   // received FEC packets.
   void AttemptRecovery(RecoveredPacketList* recovered_packets);
@@ -338,6 +348,13 @@ class ForwardErrorCorrection {
 
   std::vector<Packet> generated_fec_packets_;
   ReceivedFecPacketList received_fec_packets_;
+  // Maps the sequence number of each packet protected by the FEC packets in
+  // |received_fec_packets_| to the FEC packets protecting it, so that an
+  // arriving media packet only touches the FEC packets that cover it.
+  std::multimap<uint16_t, ReceivedFecPacket*> fec_packets_by_protected_seq_num_;
+  // True if an FEC packet may have been left with at most one missing packet
+  // since the last call to AttemptRecovery().
+  bool recovery_possible_ = false;
 
   // Arrays used to avoid dynamically allocating memory when generating
   // the packet masks.
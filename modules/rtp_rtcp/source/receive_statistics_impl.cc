@@ -36,7 +36,8 @@ StreamStatisticianImpl::StreamStatisticianImpl(
     : ssrc_(ssrc),
       clock_(clock),
       incoming_bitrate_(kStatisticsProcessIntervalMs,
-                        RateStatistics::kBpsScale),
+                        RateStatistics::kBpsScale,
+                        RateStatistics::kCoarseBucketSizeMs),
       max_reordering_threshold_(kDefaultMaxReorderingThreshold),
       jitter_q4_(0),
       cumulative_loss_(0),
@@ -65,10 +66,11 @@ StreamDataCounters StreamStatisticianImpl::UpdateCounters(
     const RTPHeader& header,
     size_t packet_length,
     bool retransmitted) {
+  const int64_t now_ms = clock_->TimeInMilliseconds();
   rtc::CritScope cs(&stream_lock_);
   bool in_order = InOrderPacketInternal(header.sequenceNumber);
   RTC_DCHECK_EQ(ssrc_, header.ssrc);
-  incoming_bitrate_.Update(packet_length, clock_->TimeInMilliseconds());
+  incoming_bitrate_.Update(packet_length, now_ms);
   receive_counters_.transmitted.AddPacket(packet_length, header);
   if (!in_order && retransmitted) {
     receive_counters_.retransmitted.AddPacket(packet_length, header);
@@ -76,7 +78,7 @@ StreamDataCounters StreamStatisticianImpl::UpdateCounters(
 
   if (receive_counters_.transmitted.packets == 1) {
     received_seq_first_ = header.sequenceNumber;
-    receive_counters_.first_packet_time_ms = clock_->TimeInMilliseconds();
+    receive_counters_.first_packet_time_ms = now_ms;
   }
 
   // Count only the new packets received. That is, if packets 1, 2, 3, 5, 4, 6
@@ -103,7 +105,7 @@ StreamDataCounters StreamStatisticianImpl::UpdateCounters(
     }
     last_received_timestamp_ = header.timestamp;
     last_receive_time_ntp_ = receive_time;
-    last_receive_time_ms_ = clock_->TimeInMilliseconds();
+    last_receive_time_ms_ = now_ms;
   }
 
   size_t packet_oh = header.headerLength + header.paddingLength;
@@ -359,11 +361,17 @@ ReceiveStatistics* ReceiveStatistics::Create(Clock* clock) {
   return new ReceiveStatisticsImpl(clock);
 }
 
+constexpr size_t ReceiveStatisticsImpl::kLookupCacheSize;
+
 ReceiveStatisticsImpl::ReceiveStatisticsImpl(Clock* clock)
     : clock_(clock),
       last_returned_ssrc_(0),
       rtcp_stats_callback_(NULL),
-      rtp_stats_callback_(NULL) {}
+      rtp_stats_callback_(NULL),
+      has_rtp_stats_callback_(false) {
+  for (auto& statistician : lookup_cache_)
+    statistician.store(nullptr, std::memory_order_relaxed);
+}
 
 ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
   while (!statisticians_.empty()) {
@@ -372,39 +380,46 @@ ReceiveStatisticsImpl::~ReceiveStatisticsImpl() {
   }
 }
 
+StreamStatisticianImpl* ReceiveStatisticsImpl::LookupStatistician(
+    uint32_t ssrc,
+    bool create) {
+  std::atomic<StreamStatisticianImpl*>& cached =
+      lookup_cache_[ssrc % kLookupCacheSize];
+  StreamStatisticianImpl* impl = cached.load(std::memory_order_acquire);
+  if (impl && impl->ssrc() == ssrc)
+    return impl;
+
+  rtc::CritScope cs(&receive_statistics_lock_);
+  auto it = statisticians_.find(ssrc);
+  if (it != statisticians_.end()) {
+    impl = it->second;
+  } else if (create) {
+    impl = new StreamStatisticianImpl(ssrc, clock_, this, this);
+    statisticians_[ssrc] = impl;
+  } else {
+    return nullptr;
+  }
+  cached.store(impl, std::memory_order_release);
+  return impl;
+}
+
 void ReceiveStatisticsImpl::IncomingPacket(const RTPHeader& header,
                                            size_t packet_length,
                                            bool retransmitted) {
-  StreamStatisticianImpl* impl;
-  {
-    rtc::CritScope cs(&receive_statistics_lock_);
-    auto it = statisticians_.find(header.ssrc);
-    if (it != statisticians_.end()) {
-      impl = it->second;
-    } else {
-      impl = new StreamStatisticianImpl(header.ssrc, clock_, this, this);
-      statisticians_[header.ssrc] = impl;
-    }
-  }
   // StreamStatisticianImpl instance is created once and only destroyed when
   // this whole ReceiveStatisticsImpl is destroyed. StreamStatisticianImpl has
   // it's own locking so don't hold receive_statistics_lock_ (potential
   // deadlock).
-  impl->IncomingPacket(header, packet_length, retransmitted);
+  LookupStatistician(header.ssrc, true)
+      ->IncomingPacket(header, packet_length, retransmitted);
 }
 
 void ReceiveStatisticsImpl::FecPacketReceived(const RTPHeader& header,
                                               size_t packet_length) {
-  StreamStatisticianImpl* impl;
-  {
-    rtc::CritScope cs(&receive_statistics_lock_);
-    auto it = statisticians_.find(header.ssrc);
-    // Ignore FEC if it is the first packet.
-    if (it == statisticians_.end())
-      return;
-    impl = it->second;
-  }
-  impl->FecPacketReceived(header, packet_length);
+  // Ignore FEC if it is the first packet.
+  StreamStatisticianImpl* impl = LookupStatistician(header.ssrc, false);
+  if (impl)
+    impl->FecPacketReceived(header, packet_length);
 }
 
 StreamStatistician* ReceiveStatisticsImpl::GetStatistician(
@@ -451,10 +466,13 @@ void ReceiveStatisticsImpl::RegisterRtpStatisticsCallback(
   if (callback != NULL)
     assert(rtp_stats_callback_ == NULL);
   rtp_stats_callback_ = callback;
+  has_rtp_stats_callback_.store(callback != NULL, std::memory_order_relaxed);
 }
 
 void ReceiveStatisticsImpl::DataCountersUpdated(const StreamDataCounters& stats,
                                                 uint32_t ssrc) {
+  if (!has_rtp_stats_callback_.load(std::memory_order_relaxed))
+    return;
   rtc::CritScope cs(&receive_statistics_lock_);
   if (rtp_stats_callback_) {
     rtp_stats_callback_->DataCountersUpdated(stats, ssrc);
@@ -14,6 +14,7 @@
 #include "modules/rtp_rtcp/include/receive_statistics.h"
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -31,6 +32,8 @@ class StreamStatisticianImpl : public StreamStatistician {
                          StreamDataCountersCallback* rtp_callback);
   ~StreamStatisticianImpl() override;
 
+  uint32_t ssrc() const { return ssrc_; }
+
   // |reset| here and in next method restarts calculation of fraction_lost stat.
   bool GetStatistics(RtcpStatistics* statistics, bool reset) override;
   bool GetActiveStatisticsAndReset(RtcpStatistics* statistics);
@@ -123,13 +126,27 @@ class ReceiveStatisticsImpl : public ReceiveStatistics,
   void DataCountersUpdated(const StreamDataCounters& counters,
                            uint32_t ssrc) override;
 
+  // Returns the statistician of |ssrc|, or null if there is none and
+  // |create| is false.
+  StreamStatisticianImpl* LookupStatistician(uint32_t ssrc, bool create);
+
   Clock* const clock_;
   rtc::CriticalSection receive_statistics_lock_;
   uint32_t last_returned_ssrc_;
-  std::map<uint32_t, StreamStatisticianImpl*> statisticians_;
+  std::map<uint32_t, StreamStatisticianImpl*> statisticians_
+      RTC_GUARDED_BY(receive_statistics_lock_);
+  // Statisticians are only destroyed along with this object, so packets find
+  // theirs here without taking |receive_statistics_lock_|. Direct mapped by
+  // SSRC; a miss falls back to |statisticians_|.
+  static constexpr size_t kLookupCacheSize = 16;
+  std::atomic<StreamStatisticianImpl*> lookup_cache_[kLookupCacheSize];
 
   RtcpStatisticsCallback* rtcp_stats_callback_;
-  StreamDataCountersCallback* rtp_stats_callback_;
+  StreamDataCountersCallback* rtp_stats_callback_
+      RTC_GUARDED_BY(receive_statistics_lock_);
+  // Whether |rtp_stats_callback_| is set, so that the counters of each packet
+  // are only passed on under the lock when someone listens.
+  std::atomic<bool> has_rtp_stats_callback_;
 };
 }  // namespace webrtc
 #endif  // MODULES_RTP_RTCP_SOURCE_RECEIVE_STATISTICS_IMPL_H_
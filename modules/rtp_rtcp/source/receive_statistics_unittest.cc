@@ -100,6 +100,35 @@ TEST_F(ReceiveStatisticsTest, TwoIncomingSsrcs) {
   EXPECT_EQ(3u, packets_received);
 }
 
+TEST_F(ReceiveStatisticsTest, ManySsrcsWithCollidingLookups) {
+  // More SSRCs than the statisticians are cached for, several of which share
+  // a cache entry.
+  const int kNumSsrcs = 40;
+  std::vector<RTPHeader> headers;
+  for (int i = 0; i < kNumSsrcs; ++i)
+    headers.push_back(CreateRtpHeader(kSsrc1 + 16 * i));
+  for (int packet = 0; packet < 3; ++packet) {
+    for (RTPHeader& header : headers) {
+      receive_statistics_->IncomingPacket(header, kPacketSize1, false);
+      ++header.sequenceNumber;
+    }
+  }
+  receive_statistics_->FecPacketReceived(headers[7], kPacketSize1);
+
+  for (int i = 0; i < kNumSsrcs; ++i) {
+    StreamStatistician* statistician =
+        receive_statistics_->GetStatistician(headers[i].ssrc);
+    ASSERT_TRUE(statistician);
+    StreamDataCounters counters;
+    statistician->GetReceiveStreamDataCounters(&counters);
+    EXPECT_EQ(3u, counters.transmitted.packets);
+    EXPECT_EQ(i == 7 ? 1u : 0u, counters.fec.packets);
+  }
+  EXPECT_FALSE(receive_statistics_->GetStatistician(kSsrc1 + 1));
+  EXPECT_THAT(receive_statistics_->RtcpReportBlocks(kNumSsrcs),
+              SizeIs(kNumSsrcs));
+}
+
 TEST_F(ReceiveStatisticsTest,
        RtcpReportBlocksReturnsMaxBlocksWhenThereAreMoreStatisticians) {
   RTPHeader header1 = CreateRtpHeader(kSsrc1);
@@ -0,0 +1,247 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_code.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "system_wrappers/include/cpu_features_wrapper.h"
+
+namespace webrtc {
+namespace {
+
+// x^8 + x^4 + x^3 + x^2 + 1, with generator 2.
+const int kFieldPolynomial = 0x11d;
+
+struct GaloisTables {
+  GaloisTables() {
+    int x = 1;
+    for (int i = 0; i < 255; ++i) {
+      exp[i] = static_cast<uint8_t>(x);
+      exp[i + 255] = static_cast<uint8_t>(x);
+      log[x] = static_cast<uint8_t>(i);
+      x <<= 1;
+      if (x & 0x100)
+        x ^= kFieldPolynomial;
+    }
+    log[0] = 0;
+  }
+
+  // Twice the period, so that exp[log[a] + log[b]] needs no modulo.
+  uint8_t exp[510];
+  uint8_t log[256];
+};
+
+const GaloisTables& Tables() {
+  static const GaloisTables* const tables = new GaloisTables();
+  return *tables;
+}
+
+uint8_t Inverse(uint8_t a) {
+  RTC_DCHECK_NE(a, 0);
+  const GaloisTables& tables = Tables();
+  return tables.exp[255 - tables.log[a]];
+}
+
+// Inverts the |size| x |size| row-major |matrix| in place, by Gauss-Jordan
+// elimination. Returns false if it is singular.
+bool InvertMatrix(std::vector<uint8_t>* matrix, size_t size) {
+  std::vector<uint8_t> inverse(size * size, 0);
+  for (size_t i = 0; i < size; ++i)
+    inverse[i * size + i] = 1;
+  std::vector<uint8_t>& m = *matrix;
+  for (size_t col = 0; col < size; ++col) {
+    size_t pivot = col;
+    while (pivot < size && m[pivot * size + col] == 0)
+      ++pivot;
+    if (pivot == size)
+      return false;
+    if (pivot != col) {
+      std::swap_ranges(&m[pivot * size], &m[pivot * size] + size,
+                       &m[col * size]);
+      std::swap_ranges(&inverse[pivot * size], &inverse[pivot * size] + size,
+                       &inverse[col * size]);
+    }
+    const uint8_t scale = Inverse(m[col * size + col]);
+    for (size_t k = 0; k < size; ++k) {
+      m[col * size + k] = ReedSolomonCode::Multiply(m[col * size + k], scale);
+      inverse[col * size + k] =
+          ReedSolomonCode::Multiply(inverse[col * size + k], scale);
+    }
+    for (size_t row = 0; row < size; ++row) {
+      const uint8_t factor = m[row * size + col];
+      if (row == col || factor == 0)
+        continue;
+      for (size_t k = 0; k < size; ++k) {
+        m[row * size + k] ^= ReedSolomonCode::Multiply(factor, m[col * size + k]);
+        inverse[row * size + k] ^=
+            ReedSolomonCode::Multiply(factor, inverse[col * size + k]);
+      }
+    }
+  }
+  matrix->swap(inverse);
+  return true;
+}
+
+typedef void (*GaloisMultiplyAddFunction)(const uint8_t* low_table,
+                                          const uint8_t* high_table,
+                                          const uint8_t* src,
+                                          size_t length,
+                                          uint8_t* dst);
+
+GaloisMultiplyAddFunction SelectGaloisMultiplyAdd() {
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+#if defined(__SSSE3__)
+  return internal::GaloisMultiplyAdd_SSSE3;
+#else
+  return WebRtc_GetCPUInfo(kSSSE3) ? internal::GaloisMultiplyAdd_SSSE3
+                                   : internal::GaloisMultiplyAdd_C;
+#endif
+#elif defined(WEBRTC_HAS_NEON)
+  return internal::GaloisMultiplyAdd_NEON;
+#else
+  return internal::GaloisMultiplyAdd_C;
+#endif
+}
+
+}  // namespace
+
+constexpr size_t ReedSolomonCode::kMaxShards;
+
+ReedSolomonCode::ReedSolomonCode(size_t num_data, size_t num_parity)
+    : num_data_(num_data),
+      num_parity_(num_parity),
+      parity_matrix_(num_data * num_parity) {
+  RTC_DCHECK_GT(num_data_, 0);
+  RTC_DCHECK_LE(num_data_ + num_parity_, kMaxShards);
+  // Cauchy matrix 1 / (x_i + y_j), with x_i = num_data + i and y_j = j. All
+  // its square submatrices are invertible, which is what makes any |num_data|
+  // shards enough to decode.
+  for (size_t i = 0; i < num_parity_; ++i) {
+    for (size_t j = 0; j < num_data_; ++j) {
+      parity_matrix_[i * num_data_ + j] =
+          Inverse(static_cast<uint8_t>((num_data_ + i) ^ j));
+    }
+  }
+}
+
+ReedSolomonCode::~ReedSolomonCode() = default;
+
+void ReedSolomonCode::Encode(const uint8_t* const* data,
+                             size_t length,
+                             uint8_t* const* parity) const {
+  for (size_t i = 0; i < num_parity_; ++i) {
+    memset(parity[i], 0, length);
+    for (size_t j = 0; j < num_data_; ++j) {
+      internal::GaloisMultiplyAdd(parity_matrix_[i * num_data_ + j], data[j],
+                                  length, parity[i]);
+    }
+  }
+}
+
+bool ReedSolomonCode::Decode(uint8_t* const* shards,
+                             const std::vector<bool>& present,
+                             size_t length) const {
+  RTC_DCHECK_EQ(present.size(), num_data_ + num_parity_);
+  std::vector<size_t> missing;
+  for (size_t j = 0; j < num_data_; ++j) {
+    if (!present[j])
+      missing.push_back(j);
+  }
+  if (missing.empty())
+    return true;
+  std::vector<size_t> parity_rows;
+  for (size_t i = 0; i < num_parity_ && parity_rows.size() < missing.size();
+       ++i) {
+    if (present[num_data_ + i])
+      parity_rows.push_back(i);
+  }
+  if (parity_rows.size() < missing.size())
+    return false;
+
+  // Each parity row, less the contribution of the data that is present, is
+  // a combination of the missing data only. Solve for it.
+  const size_t size = missing.size();
+  std::vector<uint8_t> matrix(size * size);
+  std::vector<std::vector<uint8_t>> syndromes(size);
+  for (size_t r = 0; r < size; ++r) {
+    const uint8_t* row = &parity_matrix_[parity_rows[r] * num_data_];
+    for (size_t c = 0; c < size; ++c)
+      matrix[r * size + c] = row[missing[c]];
+    const uint8_t* parity = shards[num_data_ + parity_rows[r]];
+    syndromes[r].assign(parity, parity + length);
+    for (size_t j = 0; j < num_data_; ++j) {
+      if (present[j])
+        internal::GaloisMultiplyAdd(row[j], shards[j], length,
+                                    syndromes[r].data());
+    }
+  }
+  if (!InvertMatrix(&matrix, size)) {
+    RTC_NOTREACHED();
+    return false;
+  }
+  for (size_t c = 0; c < size; ++c) {
+    uint8_t* shard = shards[missing[c]];
+    memset(shard, 0, length);
+    for (size_t r = 0; r < size; ++r) {
+      internal::GaloisMultiplyAdd(matrix[c * size + r], syndromes[r].data(),
+                                  length, shard);
+    }
+  }
+  return true;
+}
+
+uint8_t ReedSolomonCode::Multiply(uint8_t a, uint8_t b) {
+  if (a == 0 || b == 0)
+    return 0;
+  const GaloisTables& tables = Tables();
+  return tables.exp[tables.log[a] + tables.log[b]];
+}
+
+namespace internal {
+
+void GaloisMultiplyAdd(uint8_t coefficient,
+                       const uint8_t* src,
+                       size_t length,
+                       uint8_t* dst) {
+  static const GaloisMultiplyAddFunction multiply_add =
+      SelectGaloisMultiplyAdd();
+  if (coefficient == 0)
+    return;
+  uint8_t low_table[16];
+  uint8_t high_table[16];
+  GaloisNibbleTables(coefficient, low_table, high_table);
+  multiply_add(low_table, high_table, src, length, dst);
+}
+
+void GaloisMultiplyAdd_C(const uint8_t* low_table,
+                         const uint8_t* high_table,
+                         const uint8_t* src,
+                         size_t length,
+                         uint8_t* dst) {
+  for (size_t i = 0; i < length; ++i)
+    dst[i] ^= low_table[src[i] & 0x0f] ^ high_table[src[i] >> 4];
+}
+
+void GaloisNibbleTables(uint8_t coefficient,
+                        uint8_t* low_table,
+                        uint8_t* high_table) {
+  for (int x = 0; x < 16; ++x) {
+    low_table[x] = ReedSolomonCode::Multiply(coefficient, x);
+    high_table[x] = ReedSolomonCode::Multiply(coefficient, x << 4);
+  }
+}
+
+}  // namespace internal
+}  // namespace webrtc
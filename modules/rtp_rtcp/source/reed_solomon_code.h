@@ -0,0 +1,101 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_CODE_H_
+#define MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_CODE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "typedefs.h"  // NOLINT(build/include)
+
+namespace webrtc {
+
+// Systematic Reed-Solomon erasure code over GF(2^8), with a Cauchy generator
+// matrix. |num_data| shards are protected by |num_parity| parity shards of the
+// same length, and any |num_data| of the |num_data| + |num_parity| shards are
+// enough to restore the data. Shards are byte arrays of the same length.
+class ReedSolomonCode {
+ public:
+  // |num_data| + |num_parity| must be at most kMaxShards.
+  static constexpr size_t kMaxShards = 256;
+
+  ReedSolomonCode(size_t num_data, size_t num_parity);
+  ~ReedSolomonCode();
+
+  size_t num_data() const { return num_data_; }
+  size_t num_parity() const { return num_parity_; }
+
+  // Computes the |num_parity| shards |parity| from the |num_data| shards
+  // |data|, all |length| bytes.
+  void Encode(const uint8_t* const* data,
+              size_t length,
+              uint8_t* const* parity) const;
+
+  // Restores the missing data shards in place. |shards| has the |num_data|
+  // data shards followed by the |num_parity| parity shards, and |present|
+  // tells which of them were received. Missing parity shards aren't restored.
+  // Returns false if fewer than |num_data| shards are present.
+  bool Decode(uint8_t* const* shards,
+              const std::vector<bool>& present,
+              size_t length) const;
+
+  // Returns the product of |a| and |b| in GF(2^8).
+  static uint8_t Multiply(uint8_t a, uint8_t b);
+
+ private:
+  const size_t num_data_;
+  const size_t num_parity_;
+  // |num_parity_| rows of |num_data_| coefficients.
+  std::vector<uint8_t> parity_matrix_;
+};
+
+namespace internal {
+
+// dst[i] ^= |coefficient| * src[i] in GF(2^8), for |length| bytes. Uses the
+// widest kernel the CPU supports. Exposed for testing, as are the kernels.
+void GaloisMultiplyAdd(uint8_t coefficient,
+                       const uint8_t* src,
+                       size_t length,
+                       uint8_t* dst);
+
+// The kernels look up the products of the low and the high nibble of each
+// byte in these 16-entry tables, see GaloisNibbleTables().
+void GaloisMultiplyAdd_C(const uint8_t* low_table,
+                         const uint8_t* high_table,
+                         const uint8_t* src,
+                         size_t length,
+                         uint8_t* dst);
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+void GaloisMultiplyAdd_SSSE3(const uint8_t* low_table,
+                             const uint8_t* high_table,
+                             const uint8_t* src,
+                             size_t length,
+                             uint8_t* dst);
+#elif defined(WEBRTC_HAS_NEON)
+void GaloisMultiplyAdd_NEON(const uint8_t* low_table,
+                            const uint8_t* high_table,
+                            const uint8_t* src,
+                            size_t length,
+                            uint8_t* dst);
+#endif
+
+// Sets |low_table|[x] to |coefficient| * x and |high_table|[x] to
+// |coefficient| * (x << 4), for x < 16.
+void GaloisNibbleTables(uint8_t coefficient,
+                        uint8_t* low_table,
+                        uint8_t* high_table);
+
+}  // namespace internal
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_CODE_H_
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_code.h"
+
+#include <arm_neon.h>
+
+namespace webrtc {
+namespace internal {
+namespace {
+
+#if defined(__aarch64__)
+typedef uint8x16_t NibbleTable;
+
+NibbleTable LoadTable(const uint8_t* table) {
+  return vld1q_u8(table);
+}
+
+uint8x16_t Lookup(const NibbleTable& table, uint8x16_t indices) {
+  return vqtbl1q_u8(table, indices);
+}
+#else
+typedef uint8x8x2_t NibbleTable;
+
+NibbleTable LoadTable(const uint8_t* table) {
+  NibbleTable result;
+  result.val[0] = vld1_u8(table);
+  result.val[1] = vld1_u8(table + 8);
+  return result;
+}
+
+uint8x16_t Lookup(const NibbleTable& table, uint8x16_t indices) {
+  return vcombine_u8(vtbl2_u8(table, vget_low_u8(indices)),
+                     vtbl2_u8(table, vget_high_u8(indices)));
+}
+#endif
+
+}  // namespace
+
+void GaloisMultiplyAdd_NEON(const uint8_t* low_table,
+                            const uint8_t* high_table,
+                            const uint8_t* src,
+                            size_t length,
+                            uint8_t* dst) {
+  const NibbleTable low = LoadTable(low_table);
+  const NibbleTable high = LoadTable(high_table);
+  const uint8x16_t nibble_mask = vdupq_n_u8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const uint8x16_t s = vld1q_u8(src + i);
+    const uint8x16_t product =
+        veorq_u8(Lookup(low, vandq_u8(s, nibble_mask)),
+                 Lookup(high, vshrq_n_u8(s, 4)));
+    vst1q_u8(dst + i, veorq_u8(vld1q_u8(dst + i), product));
+  }
+  GaloisMultiplyAdd_C(low_table, high_table, src + i, length - i, dst + i);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,43 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_code.h"
+
+#include <tmmintrin.h>
+
+namespace webrtc {
+namespace internal {
+
+void GaloisMultiplyAdd_SSSE3(const uint8_t* low_table,
+                             const uint8_t* high_table,
+                             const uint8_t* src,
+                             size_t length,
+                             uint8_t* dst) {
+  const __m128i low =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(low_table));
+  const __m128i high =
+      _mm_loadu_si128(reinterpret_cast<const __m128i*>(high_table));
+  const __m128i nibble_mask = _mm_set1_epi8(0x0f);
+  size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    __m128i* d = reinterpret_cast<__m128i*>(dst + i);
+    // Products of the low and the high nibbles, looked up 16 at a time.
+    const __m128i product = _mm_xor_si128(
+        _mm_shuffle_epi8(low, _mm_and_si128(s, nibble_mask)),
+        _mm_shuffle_epi8(high,
+                         _mm_and_si128(_mm_srli_epi64(s, 4), nibble_mask)));
+    _mm_storeu_si128(d, _mm_xor_si128(_mm_loadu_si128(d), product));
+  }
+  GaloisMultiplyAdd_C(low_table, high_table, src + i, length - i, dst + i);
+}
+
+}  // namespace internal
+}  // namespace webrtc
@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_code.h"
+
+#include <string>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/fec_xor.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+typedef void (*GaloisMultiplyAddFunction)(const uint8_t* low_table,
+                                          const uint8_t* high_table,
+                                          const uint8_t* src,
+                                          size_t length,
+                                          uint8_t* dst);
+
+std::vector<uint8_t> RandomBytes(size_t length, Random* random) {
+  std::vector<uint8_t> bytes(length);
+  for (uint8_t& byte : bytes)
+    byte = random->Rand<uint8_t>();
+  return bytes;
+}
+
+// Checks |multiply_add| against ReedSolomonCode::Multiply(), for all lengths
+// up to |kMaxLength| and some coefficients and alignments.
+void TestKernel(GaloisMultiplyAddFunction multiply_add) {
+  const size_t kMaxLength = 80;
+  const size_t kGuard = 16;
+  Random random(0x1234);
+  for (int coefficient : {1, 2, 0x1d, 0x80, 0xff}) {
+    uint8_t low_table[16];
+    uint8_t high_table[16];
+    internal::GaloisNibbleTables(coefficient, low_table, high_table);
+    for (size_t offset = 0; offset < 16; offset += 5) {
+      for (size_t length = 0; length <= kMaxLength; ++length) {
+        std::vector<uint8_t> src = RandomBytes(kMaxLength + kGuard, &random);
+        std::vector<uint8_t> dst = RandomBytes(kMaxLength + kGuard, &random);
+        std::vector<uint8_t> expected = dst;
+        for (size_t i = 0; i < length; ++i) {
+          expected[i] ^= ReedSolomonCode::Multiply(coefficient,
+                                                   src[offset + i]);
+        }
+        multiply_add(low_table, high_table, &src[offset], length, &dst[0]);
+        ASSERT_EQ(expected, dst) << "coefficient " << coefficient << ", length "
+                                 << length << ", offset " << offset;
+      }
+    }
+  }
+}
+
+class ReedSolomonCodeTest : public ::testing::Test {
+ protected:
+  static constexpr size_t kLength = 37;
+
+  ReedSolomonCodeTest() : random_(0x5678) {}
+
+  // Encodes random data and checks that it is restored from the shards for
+  // each |present| pattern with at least |num_data| shards.
+  void TestAllErasures(size_t num_data, size_t num_parity) {
+    ReedSolomonCode code(num_data, num_parity);
+    const size_t num_shards = num_data + num_parity;
+    std::vector<std::vector<uint8_t>> shards(num_shards);
+    for (size_t i = 0; i < num_data; ++i)
+      shards[i] = RandomBytes(kLength, &random_);
+    for (size_t i = num_data; i < num_shards; ++i)
+      shards[i].resize(kLength);
+    std::vector<const uint8_t*> data(num_data);
+    std::vector<uint8_t*> parity(num_parity);
+    for (size_t i = 0; i < num_data; ++i)
+      data[i] = shards[i].data();
+    for (size_t i = 0; i < num_parity; ++i)
+      parity[i] = shards[num_data + i].data();
+    code.Encode(data.data(), kLength, parity.data());
+
+    for (uint32_t mask = 0; mask < (1u << num_shards); ++mask) {
+      std::vector<bool> present(num_shards);
+      size_t num_present = 0;
+      for (size_t i = 0; i < num_shards; ++i) {
+        present[i] = (mask >> i) & 1;
+        num_present += present[i] ? 1 : 0;
+      }
+      std::vector<std::vector<uint8_t>> received = shards;
+      std::vector<uint8_t*> pointers(num_shards);
+      for (size_t i = 0; i < num_shards; ++i) {
+        if (!present[i])
+          received[i].assign(kLength, 0xaa);
+        pointers[i] = received[i].data();
+      }
+      if (num_present < num_data) {
+        EXPECT_FALSE(code.Decode(pointers.data(), present, kLength));
+        continue;
+      }
+      ASSERT_TRUE(code.Decode(pointers.data(), present, kLength))
+          << "mask " << mask;
+      for (size_t i = 0; i < num_data; ++i)
+        ASSERT_EQ(shards[i], received[i]) << "mask " << mask << ", shard " << i;
+    }
+  }
+
+  Random random_;
+};
+
+constexpr size_t ReedSolomonCodeTest::kLength;
+
+}  // namespace
+
+TEST(GaloisMultiplyAddTest, CKernelMatchesMultiply) {
+  TestKernel(internal::GaloisMultiplyAdd_C);
+}
+
+#if defined(WEBRTC_ARCH_X86_FAMILY)
+TEST(GaloisMultiplyAddTest, Ssse3KernelMatchesMultiply) {
+  TestKernel(internal::GaloisMultiplyAdd_SSSE3);
+}
+#elif defined(WEBRTC_HAS_NEON)
+TEST(GaloisMultiplyAddTest, NeonKernelMatchesMultiply) {
+  TestKernel(internal::GaloisMultiplyAdd_NEON);
+}
+#endif
+
+TEST(GaloisMultiplyAddTest, MultiplyIsAFieldProduct) {
+  for (int a = 1; a < 256; ++a) {
+    int inverses = 0;
+    for (int b = 1; b < 256; ++b) {
+      EXPECT_EQ(ReedSolomonCode::Multiply(a, b), ReedSolomonCode::Multiply(b, a));
+      inverses += ReedSolomonCode::Multiply(a, b) == 1 ? 1 : 0;
+    }
+    EXPECT_EQ(1, inverses) << a;
+    EXPECT_EQ(0, ReedSolomonCode::Multiply(a, 0));
+  }
+  // x^8 is reduced by the field polynomial.
+  EXPECT_EQ(0x1d, ReedSolomonCode::Multiply(0x80, 2));
+}
+
+TEST_F(ReedSolomonCodeTest, RestoresDataFromAnyErasures) {
+  TestAllErasures(1, 1);
+  TestAllErasures(1, 3);
+  TestAllErasures(3, 1);
+  TestAllErasures(4, 4);
+  TestAllErasures(6, 3);
+  TestAllErasures(10, 6);
+}
+
+TEST_F(ReedSolomonCodeTest, RestoresLargeCode) {
+  const size_t kNumData = 48;
+  const size_t kNumParity = 48;
+  ReedSolomonCode code(kNumData, kNumParity);
+  std::vector<std::vector<uint8_t>> shards(kNumData + kNumParity);
+  std::vector<uint8_t*> pointers(kNumData + kNumParity);
+  for (size_t i = 0; i < shards.size(); ++i) {
+    shards[i] = RandomBytes(kLength, &random_);
+    pointers[i] = shards[i].data();
+  }
+  code.Encode(pointers.data(), kLength, pointers.data() + kNumData);
+  const std::vector<std::vector<uint8_t>> sent = shards;
+
+  // Lose every other data shard and the first half of the parity shards.
+  std::vector<bool> present(kNumData + kNumParity, true);
+  for (size_t i = 0; i < kNumData; i += 2) {
+    present[i] = false;
+    shards[i].assign(kLength, 0);
+  }
+  for (size_t i = 0; i < kNumParity / 2; ++i)
+    present[kNumData + i] = false;
+  ASSERT_TRUE(code.Decode(pointers.data(), present, kLength));
+  for (size_t i = 0; i < kNumData; ++i)
+    EXPECT_EQ(sent[i], shards[i]);
+}
+
+TEST(GaloisMultiplyAddTest, DISABLED_Benchmark) {
+  const size_t kLength = 1200;
+  const int kIterations = 200000;
+  Random random(0xabcdef);
+  std::vector<uint8_t> src = RandomBytes(kLength, &random);
+  std::vector<uint8_t> dst(kLength, 0);
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kIterations; ++i)
+    internal::GaloisMultiplyAdd(0x8e, src.data(), kLength, dst.data());
+  int64_t multiply_ns = rtc::TimeNanos() - start_ns;
+  start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kIterations; ++i)
+    internal::XorBytes(src.data(), kLength, dst.data());
+  int64_t xor_ns = rtc::TimeNanos() - start_ns;
+  const std::string trace = std::to_string(kLength) + "_bytes";
+  test::PrintResult("galois_multiply_add_time", "", trace,
+                    static_cast<double>(multiply_ns) / kIterations, "ns",
+                    false);
+  test::PrintResult("xor_time", "", trace,
+                    static_cast<double>(xor_ns) / kIterations, "ns", false);
+}
+
+}  // namespace webrtc
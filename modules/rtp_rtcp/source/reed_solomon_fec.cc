@@ -0,0 +1,240 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_fec.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/reed_solomon_code.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace {
+
+// Bytes of the shard before the rest of the packet: the first two RTP header
+// bytes, the length recovery field and the timestamp.
+constexpr size_t kShardHeaderSize = 8;
+
+struct BlockHeader {
+  uint16_t seq_num_base;
+  size_t num_media_packets;
+  size_t num_fec_packets;
+  size_t fec_index;
+  size_t shard_length;
+};
+
+bool ParseHeader(const ForwardErrorCorrection::Packet& fec_packet,
+                 BlockHeader* header) {
+  if (fec_packet.length < ReedSolomonFec::kHeaderSize)
+    return false;
+  const uint8_t* data = fec_packet.data;
+  header->seq_num_base = ByteReader<uint16_t>::ReadBigEndian(data);
+  header->num_media_packets = data[2];
+  header->num_fec_packets = data[3];
+  header->fec_index = data[4];
+  header->shard_length = ByteReader<uint16_t>::ReadBigEndian(data + 6);
+  return header->num_media_packets > 0 &&
+         header->num_media_packets <= ReedSolomonFec::kMaxMediaPackets &&
+         header->fec_index < header->num_fec_packets &&
+         header->shard_length >= kShardHeaderSize &&
+         fec_packet.length == ReedSolomonFec::kHeaderSize + header->shard_length;
+}
+
+void WriteShard(const ForwardErrorCorrection::Packet& media_packet,
+                uint8_t* shard) {
+  memcpy(shard, media_packet.data, 2);
+  ByteWriter<uint16_t>::WriteBigEndian(shard + 2,
+                                       media_packet.length - kRtpHeaderSize);
+  memcpy(shard + 4, media_packet.data + 4, 4);
+  memcpy(shard + kShardHeaderSize, media_packet.data + kRtpHeaderSize,
+         media_packet.length - kRtpHeaderSize);
+}
+
+// Returns false if |shard| has no valid packet of at most |shard_length|.
+bool ReadShard(const uint8_t* shard,
+               size_t shard_length,
+               uint16_t seq_num,
+               uint32_t ssrc,
+               ForwardErrorCorrection::Packet* media_packet) {
+  const size_t payload_length = ByteReader<uint16_t>::ReadBigEndian(shard + 2);
+  if (kShardHeaderSize + payload_length > shard_length)
+    return false;
+  memcpy(media_packet->data, shard, 2);
+  // Set the RTP version to 2.
+  media_packet->data[0] = (media_packet->data[0] & 0x3f) | 0x80;
+  ByteWriter<uint16_t>::WriteBigEndian(media_packet->data + 2, seq_num);
+  memcpy(media_packet->data + 4, shard + 4, 4);
+  ByteWriter<uint32_t>::WriteBigEndian(media_packet->data + 8, ssrc);
+  memcpy(media_packet->data + kRtpHeaderSize, shard + kShardHeaderSize,
+         payload_length);
+  media_packet->length = kRtpHeaderSize + payload_length;
+  return true;
+}
+
+}  // namespace
+
+constexpr size_t ReedSolomonFec::kHeaderSize;
+constexpr size_t ReedSolomonFec::kMaxPacketOverhead;
+constexpr size_t ReedSolomonFec::kMaxMediaPackets;
+
+ReedSolomonFec::ReedSolomonFec() : generated_fec_packets_(kMaxMediaPackets) {}
+
+ReedSolomonFec::~ReedSolomonFec() = default;
+
+int ReedSolomonFec::EncodeFec(
+    const ForwardErrorCorrection::PacketList& media_packets,
+    uint8_t protection_factor,
+    std::list<ForwardErrorCorrection::Packet*>* fec_packets) {
+  RTC_DCHECK(fec_packets->empty());
+  const size_t num_media_packets = media_packets.size();
+  RTC_DCHECK_GT(num_media_packets, 0);
+  if (num_media_packets > kMaxMediaPackets) {
+    RTC_LOG(LS_WARNING) << "Can't protect " << num_media_packets
+                        << " media packets per frame. Max is "
+                        << kMaxMediaPackets << ".";
+    return -1;
+  }
+  const uint16_t seq_num_base =
+      ForwardErrorCorrection::ParseSequenceNumber(media_packets.front()->data);
+  size_t max_length = 0;
+  uint16_t expected_seq_num = seq_num_base;
+  for (const auto& media_packet : media_packets) {
+    if (media_packet->length < kRtpHeaderSize ||
+        media_packet->length + kMaxPacketOverhead > IP_PACKET_SIZE) {
+      RTC_LOG(LS_WARNING) << "Can't protect media packet of "
+                          << media_packet->length << " bytes.";
+      return -1;
+    }
+    if (ForwardErrorCorrection::ParseSequenceNumber(media_packet->data) !=
+        expected_seq_num++) {
+      RTC_LOG(LS_INFO) << "Can't protect media packets with sequence number "
+                          "gaps.";
+      return -1;
+    }
+    max_length = std::max(max_length, media_packet->length);
+  }
+
+  const size_t num_fec_packets =
+      ForwardErrorCorrection::NumFecPackets(num_media_packets,
+                                            protection_factor);
+  if (num_fec_packets == 0)
+    return 0;
+  const size_t shard_length = max_length - kRtpHeaderSize + kShardHeaderSize;
+
+  // The media shards are built from the packets, and the parity shards in
+  // place in the FEC packets.
+  std::vector<uint8_t> media_shards(num_media_packets * shard_length, 0);
+  std::vector<const uint8_t*> data(num_media_packets);
+  size_t i = 0;
+  for (const auto& media_packet : media_packets) {
+    uint8_t* shard = &media_shards[i * shard_length];
+    WriteShard(*media_packet, shard);
+    data[i++] = shard;
+  }
+  std::vector<uint8_t*> parity(num_fec_packets);
+  for (i = 0; i < num_fec_packets; ++i) {
+    ForwardErrorCorrection::Packet* fec_packet = &generated_fec_packets_[i];
+    uint8_t* header = fec_packet->data;
+    ByteWriter<uint16_t>::WriteBigEndian(header, seq_num_base);
+    header[2] = static_cast<uint8_t>(num_media_packets);
+    header[3] = static_cast<uint8_t>(num_fec_packets);
+    header[4] = static_cast<uint8_t>(i);
+    header[5] = 0;
+    ByteWriter<uint16_t>::WriteBigEndian(header + 6, shard_length);
+    fec_packet->length = kHeaderSize + shard_length;
+    parity[i] = header + kHeaderSize;
+    fec_packets->push_back(fec_packet);
+  }
+  ReedSolomonCode(num_media_packets, num_fec_packets)
+      .Encode(data.data(), shard_length, parity.data());
+  return 0;
+}
+
+size_t ReedSolomonFec::DecodeFec(
+    const std::vector<const ForwardErrorCorrection::Packet*>& media_packets,
+    const std::vector<const ForwardErrorCorrection::Packet*>& fec_packets,
+    uint32_t ssrc,
+    ForwardErrorCorrection::PacketList* recovered_packets) {
+  if (fec_packets.empty())
+    return 0;
+  BlockHeader block;
+  if (!ParseHeader(*fec_packets.front(), &block))
+    return 0;
+  const size_t num_shards = block.num_media_packets + block.num_fec_packets;
+  std::vector<uint8_t> shards(num_shards * block.shard_length, 0);
+  std::vector<bool> present(num_shards, false);
+
+  for (const ForwardErrorCorrection::Packet* media_packet : media_packets) {
+    const uint16_t index = static_cast<uint16_t>(
+        ByteReader<uint16_t>::ReadBigEndian(media_packet->data + 2) -
+        block.seq_num_base);
+    if (index >= block.num_media_packets || present[index] ||
+        media_packet->length < kRtpHeaderSize ||
+        media_packet->length - kRtpHeaderSize + kShardHeaderSize >
+            block.shard_length) {
+      continue;
+    }
+    WriteShard(*media_packet, &shards[index * block.shard_length]);
+    present[index] = true;
+  }
+  size_t num_missing = 0;
+  for (size_t j = 0; j < block.num_media_packets; ++j)
+    num_missing += present[j] ? 0 : 1;
+  if (num_missing == 0)
+    return 0;
+
+  for (const ForwardErrorCorrection::Packet* fec_packet : fec_packets) {
+    BlockHeader header;
+    if (!ParseHeader(*fec_packet, &header) ||
+        header.seq_num_base != block.seq_num_base ||
+        header.num_media_packets != block.num_media_packets ||
+        header.num_fec_packets != block.num_fec_packets ||
+        header.shard_length != block.shard_length) {
+      continue;
+    }
+    const size_t index = block.num_media_packets + header.fec_index;
+    memcpy(&shards[index * block.shard_length], fec_packet->data + kHeaderSize,
+           block.shard_length);
+    present[index] = true;
+  }
+
+  std::vector<uint8_t*> shard_pointers(num_shards);
+  for (size_t j = 0; j < num_shards; ++j)
+    shard_pointers[j] = &shards[j * block.shard_length];
+  if (!ReedSolomonCode(block.num_media_packets, block.num_fec_packets)
+           .Decode(shard_pointers.data(), present, block.shard_length)) {
+    return 0;
+  }
+
+  size_t num_recovered = 0;
+  for (size_t j = 0; j < block.num_media_packets; ++j) {
+    if (present[j])
+      continue;
+    std::unique_ptr<ForwardErrorCorrection::Packet> packet(
+        new ForwardErrorCorrection::Packet());
+    if (!ReadShard(shard_pointers[j], block.shard_length,
+                   static_cast<uint16_t>(block.seq_num_base + j), ssrc,
+                   packet.get())) {
+      RTC_LOG(LS_WARNING) << "Recovered packet has invalid length.";
+      continue;
+    }
+    recovered_packets->push_back(std::move(packet));
+    ++num_recovered;
+  }
+  return num_recovered;
+}
+
+}  // namespace webrtc
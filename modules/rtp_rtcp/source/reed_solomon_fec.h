@@ -0,0 +1,84 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_FEC_H_
+#define MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_FEC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <list>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// FEC for the media packets of a frame with a Reed-Solomon code, the
+// kFecSchemeReedSolomon counterpart of ForwardErrorCorrection. Any k lost
+// media packets of a frame are recovered from any k of its FEC packets, where
+// XOR parity needs each lost packet to be the only one lost from some FEC
+// packet's mask, so bursts of losses are recovered without a retransmission.
+//
+// Like the packets of ForwardErrorCorrection, the FEC packets are payloads to
+// be sent in RED or on a separate ssrc. Each protects a block of
+// consecutively numbered media packets and starts with this header:
+//
+//    0                   1                   2                   3
+//    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |         SN base               |  num media    |   num FEC     |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//   |  FEC index    |   reserved    |         shard length          |
+//   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+//
+// followed by the parity shard. The shard of a media packet is its first two
+// RTP header bytes, its length less the RTP header, its timestamp and the
+// rest of the packet, zero padded to the longest packet of the block.
+class ReedSolomonFec {
+ public:
+  static constexpr size_t kHeaderSize = 8;
+  // FEC packets are this much longer than the longest media packet.
+  static constexpr size_t kMaxPacketOverhead = kHeaderSize + 8 - kRtpHeaderSize;
+  static constexpr size_t kMaxMediaPackets = kUlpfecMaxMediaPackets;
+
+  ReedSolomonFec();
+  ~ReedSolomonFec();
+
+  // Generates ForwardErrorCorrection::NumFecPackets() FEC packets for
+  // |protection_factor| from |media_packets|, which must be RTP packets with
+  // consecutive sequence numbers. The packets put in |fec_packets|, which must
+  // be empty, are valid until the next call. Returns 0 on success, -1 on
+  // failure.
+  int EncodeFec(const ForwardErrorCorrection::PacketList& media_packets,
+                uint8_t protection_factor,
+                std::list<ForwardErrorCorrection::Packet*>* fec_packets);
+
+  // Recovers the media packets of the block protected by |fec_packets| that
+  // are missing from |media_packets|, if enough packets of the block were
+  // received. Packets not of the block are ignored, as are FEC packets that
+  // don't match the first one. Recovered packets get |ssrc| and are appended
+  // to |recovered_packets|. Returns the number of packets recovered.
+  static size_t DecodeFec(
+      const std::vector<const ForwardErrorCorrection::Packet*>& media_packets,
+      const std::vector<const ForwardErrorCorrection::Packet*>& fec_packets,
+      uint32_t ssrc,
+      ForwardErrorCorrection::PacketList* recovered_packets);
+
+ private:
+  std::vector<ForwardErrorCorrection::Packet> generated_fec_packets_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ReedSolomonFec);
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_REED_SOLOMON_FEC_H_
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/reed_solomon_fec.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "modules/rtp_rtcp/source/fec_test_helper.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kMediaSsrc = 8475;
+constexpr uint8_t kProtectionFactor = 128;  // 50% overhead.
+
+class ReedSolomonFecTest : public ::testing::Test {
+ protected:
+  ReedSolomonFecTest()
+      : random_(0x1357),
+        generator_(kRtpHeaderSize,
+                   IP_PACKET_SIZE - 28 - ReedSolomonFec::kMaxPacketOverhead,
+                   kMediaSsrc,
+                   &random_) {}
+
+  // Encodes |num_media_packets| packets, drops the media and FEC packets at
+  // the indices in |lost_media| and |lost_fec|, and checks that the dropped
+  // media packets are recovered from the rest if |recoverable|.
+  void EncodeDropAndDecode(int num_media_packets,
+                           const std::vector<int>& lost_media,
+                           const std::vector<int>& lost_fec,
+                           bool recoverable) {
+    ForwardErrorCorrection::PacketList media_packets =
+        generator_.ConstructMediaPackets(num_media_packets);
+    std::list<ForwardErrorCorrection::Packet*> fec_packets;
+    ASSERT_EQ(0,
+              fec_.EncodeFec(media_packets, kProtectionFactor, &fec_packets));
+    ASSERT_EQ(static_cast<size_t>(ForwardErrorCorrection::NumFecPackets(
+                  num_media_packets, kProtectionFactor)),
+              fec_packets.size());
+
+    std::vector<const ForwardErrorCorrection::Packet*> received_media;
+    std::vector<const ForwardErrorCorrection::Packet*> lost_packets;
+    int i = 0;
+    for (const auto& media_packet : media_packets) {
+      if (std::find(lost_media.begin(), lost_media.end(), i++) !=
+          lost_media.end()) {
+        lost_packets.push_back(media_packet.get());
+      } else {
+        received_media.push_back(media_packet.get());
+      }
+    }
+    std::vector<const ForwardErrorCorrection::Packet*> received_fec;
+    i = 0;
+    for (const ForwardErrorCorrection::Packet* fec_packet : fec_packets) {
+      if (std::find(lost_fec.begin(), lost_fec.end(), i++) == lost_fec.end())
+        received_fec.push_back(fec_packet);
+    }
+
+    ForwardErrorCorrection::PacketList recovered;
+    const size_t num_recovered = ReedSolomonFec::DecodeFec(
+        received_media, received_fec, kMediaSsrc, &recovered);
+    if (!recoverable) {
+      EXPECT_EQ(0u, num_recovered);
+      EXPECT_TRUE(recovered.empty());
+      return;
+    }
+    ASSERT_EQ(lost_packets.size(), num_recovered);
+    auto recovered_it = recovered.begin();
+    for (const ForwardErrorCorrection::Packet* lost_packet : lost_packets) {
+      const ForwardErrorCorrection::Packet& packet = **recovered_it++;
+      ASSERT_EQ(lost_packet->length, packet.length);
+      EXPECT_EQ(0, memcmp(lost_packet->data, packet.data, packet.length));
+    }
+  }
+
+  Random random_;
+  test::fec::MediaPacketGenerator generator_;
+  ReedSolomonFec fec_;
+};
+
+}  // namespace
+
+TEST_F(ReedSolomonFecTest, RecoversSingleLoss) {
+  EncodeDropAndDecode(4, {2}, {}, true);
+}
+
+TEST_F(ReedSolomonFecTest, RecoversBurstAsLongAsFecPackets) {
+  // 12 media packets get 6 FEC packets, and any 6 losses are recovered.
+  EncodeDropAndDecode(12, {3, 4, 5, 6, 7, 8}, {}, true);
+}
+
+TEST_F(ReedSolomonFecTest, RecoversMediaAndFecLoss) {
+  EncodeDropAndDecode(12, {0, 1, 2, 11}, {0, 5}, true);
+}
+
+TEST_F(ReedSolomonFecTest, DoesNotRecoverWithTooFewPackets) {
+  EncodeDropAndDecode(12, {3, 4, 5, 6, 7}, {0, 1}, false);
+}
+
+TEST_F(ReedSolomonFecTest, NothingToRecoverWithoutLoss) {
+  EncodeDropAndDecode(8, {}, {}, false);
+}
+
+TEST_F(ReedSolomonFecTest, RejectsSequenceNumberGaps) {
+  ForwardErrorCorrection::PacketList media_packets =
+      generator_.ConstructMediaPackets(3, 100);
+  media_packets.splice(media_packets.end(),
+                       generator_.ConstructMediaPackets(1, 104));
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+  EXPECT_EQ(-1, fec_.EncodeFec(media_packets, kProtectionFactor, &fec_packets));
+}
+
+TEST_F(ReedSolomonFecTest, DISABLED_EncodeBenchmark) {
+  const int kNumMediaPackets = 12;
+  const int kNumFrames = 20000;
+  ForwardErrorCorrection::PacketList media_packets =
+      generator_.ConstructMediaPackets(kNumMediaPackets);
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int i = 0; i < kNumFrames; ++i) {
+    fec_packets.clear();
+    ASSERT_EQ(0,
+              fec_.EncodeFec(media_packets, kProtectionFactor, &fec_packets));
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  test::PrintResult("fec_encode_time", "", "ReedSolomon",
+                    static_cast<double>(elapsed_ns) / kNumFrames / 1000, "us",
+                    false);
+  test::PrintResult("fec_packets", "", "ReedSolomon", fec_packets.size(),
+                    "packets", false);
+}
+
+}  // namespace webrtc
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_parser.h"
+
+#include "modules/rtp_rtcp/source/byte_io.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+
+namespace webrtc {
+namespace rtcp {
+namespace {
+
+// Lengths of the fixed parts of a sender report, a receiver report and a
+// feedback message, and of a NACK item.
+constexpr size_t kSenderReportBaseLength = 24;
+constexpr size_t kReceiverReportBaseLength = 4;
+constexpr size_t kCommonFeedbackLength = 8;
+constexpr size_t kNackItemLength = 4;
+
+// Visits the report blocks following the |base_length| bytes of the report.
+bool VisitReportBlocks(const CommonHeader& block,
+                       size_t base_length,
+                       uint32_t sender_ssrc,
+                       CompoundPacketParser::Visitor* visitor) {
+  const uint8_t* next_report_block = block.payload() + base_length;
+  ReportBlock report_block;
+  for (uint8_t i = 0; i < block.count(); ++i) {
+    bool block_parsed =
+        report_block.Parse(next_report_block, ReportBlock::kLength);
+    RTC_DCHECK(block_parsed);
+    visitor->OnReportBlock(sender_ssrc, report_block);
+    next_report_block += ReportBlock::kLength;
+  }
+  return true;
+}
+
+bool VisitSenderReport(const CommonHeader& block,
+                       CompoundPacketParser::Visitor* visitor) {
+  if (block.payload_size_bytes() <
+      kSenderReportBaseLength + block.count() * ReportBlock::kLength) {
+    RTC_LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+  const uint8_t* const payload = block.payload();
+  const uint32_t sender_ssrc = ByteReader<uint32_t>::ReadBigEndian(&payload[0]);
+  NtpTime ntp(ByteReader<uint32_t>::ReadBigEndian(&payload[4]),
+              ByteReader<uint32_t>::ReadBigEndian(&payload[8]));
+  visitor->OnSenderReport(sender_ssrc, ntp,
+                          ByteReader<uint32_t>::ReadBigEndian(&payload[12]));
+  return VisitReportBlocks(block, kSenderReportBaseLength, sender_ssrc,
+                           visitor);
+}
+
+bool VisitReceiverReport(const CommonHeader& block,
+                         CompoundPacketParser::Visitor* visitor) {
+  if (block.payload_size_bytes() <
+      kReceiverReportBaseLength + block.count() * ReportBlock::kLength) {
+    RTC_LOG(LS_WARNING) << "Packet is too small to contain all the data.";
+    return false;
+  }
+  const uint32_t sender_ssrc =
+      ByteReader<uint32_t>::ReadBigEndian(block.payload());
+  visitor->OnReceiverReport(sender_ssrc);
+  return VisitReportBlocks(block, kReceiverReportBaseLength, sender_ssrc,
+                           visitor);
+}
+
+bool VisitNack(const CommonHeader& block,
+               CompoundPacketParser::Visitor* visitor) {
+  if (block.payload_size_bytes() < kCommonFeedbackLength + kNackItemLength) {
+    RTC_LOG(LS_WARNING) << "Payload length " << block.payload_size_bytes()
+                        << " is too small for a Nack.";
+    return false;
+  }
+  const uint8_t* const payload = block.payload();
+  if (!visitor->OnNack(ByteReader<uint32_t>::ReadBigEndian(&payload[0]),
+                       ByteReader<uint32_t>::ReadBigEndian(&payload[4]))) {
+    return true;
+  }
+  const size_t nack_items =
+      (block.payload_size_bytes() - kCommonFeedbackLength) / kNackItemLength;
+  const uint8_t* next_nack = payload + kCommonFeedbackLength;
+  for (size_t i = 0; i < nack_items; ++i) {
+    uint16_t pid = ByteReader<uint16_t>::ReadBigEndian(next_nack);
+    uint16_t bitmask = ByteReader<uint16_t>::ReadBigEndian(next_nack + 2);
+    visitor->OnNackedPacket(pid);
+    for (++pid; bitmask != 0; bitmask >>= 1, ++pid) {
+      if (bitmask & 1)
+        visitor->OnNackedPacket(pid);
+    }
+    next_nack += kNackItemLength;
+  }
+  return true;
+}
+
+}  // namespace
+
+CompoundPacketParser::CompoundPacketParser(
+    TransportFeedback* transport_feedback)
+    : transport_feedback_(transport_feedback) {
+  RTC_DCHECK(transport_feedback_);
+}
+
+CompoundPacketParser::~CompoundPacketParser() = default;
+
+bool CompoundPacketParser::Parse(const uint8_t* packet,
+                                 size_t length,
+                                 Visitor* visitor) {
+  const uint8_t* const packet_end = packet + length;
+  CommonHeader block;
+  for (const uint8_t* next_block = packet; next_block != packet_end;
+       next_block = block.NextPacket()) {
+    ptrdiff_t remaining_blocks_size = packet_end - next_block;
+    RTC_DCHECK_GT(remaining_blocks_size, 0);
+    if (!block.Parse(next_block, remaining_blocks_size)) {
+      if (next_block == packet)
+        return false;
+      visitor->OnMalformedBlock();
+      break;
+    }
+    ParseBlock(block, visitor);
+  }
+  return true;
+}
+
+void CompoundPacketParser::ParseBlock(const CommonHeader& block,
+                                      Visitor* visitor) {
+  bool parsed;
+  switch (block.type()) {
+    case SenderReport::kPacketType:
+      parsed = VisitSenderReport(block, visitor);
+      break;
+    case ReceiverReport::kPacketType:
+      parsed = VisitReceiverReport(block, visitor);
+      break;
+    case Rtpfb::kPacketType:
+      switch (block.fmt()) {
+        case Nack::kFeedbackMessageType:
+          parsed = VisitNack(block, visitor);
+          break;
+        case TransportFeedback::kFeedbackMessageType:
+          parsed = transport_feedback_->Parse(block);
+          if (parsed)
+            visitor->OnTransportFeedback(*transport_feedback_);
+          break;
+        default:
+          visitor->OnOtherBlock(block);
+          return;
+      }
+      break;
+    default:
+      visitor->OnOtherBlock(block);
+      return;
+  }
+  if (!parsed)
+    visitor->OnMalformedBlock();
+}
+
+}  // namespace rtcp
+}  // namespace webrtc
@@ -0,0 +1,83 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_PARSER_H_
+#define MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_PARSER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/constructormagic.h"
+#include "system_wrappers/include/ntp_time.h"
+
+namespace webrtc {
+namespace rtcp {
+class CommonHeader;
+class ReportBlock;
+class TransportFeedback;
+
+// Parses the blocks of a compound RTCP packet in place and hands them to a
+// Visitor, one at a time. Unlike parsing sender and receiver reports and
+// NACKs into their rtcp:: packet classes, this doesn't allocate, and
+// transport-wide feedback is decoded into a TransportFeedback provided by the
+// caller, reusing its storage from packet to packet.
+class CompoundPacketParser {
+ public:
+  class Visitor {
+   public:
+    // A sender report. OnReportBlock() is called for each of its report
+    // blocks next.
+    virtual void OnSenderReport(uint32_t sender_ssrc,
+                                NtpTime ntp,
+                                uint32_t rtp_timestamp) {}
+    // A receiver report. OnReportBlock() is called for each of its report
+    // blocks next.
+    virtual void OnReceiverReport(uint32_t sender_ssrc) {}
+    virtual void OnReportBlock(uint32_t sender_ssrc,
+                               const ReportBlock& report_block) {}
+    // A generic NACK. If it returns true, OnNackedPacket() is called for each
+    // requested packet next.
+    virtual bool OnNack(uint32_t sender_ssrc, uint32_t media_ssrc) {
+      return false;
+    }
+    virtual void OnNackedPacket(uint16_t packet_id) {}
+    // Transport-wide feedback, valid until the next call to Parse().
+    virtual void OnTransportFeedback(const TransportFeedback& feedback) {}
+    // Any other block, left for the visitor to parse.
+    virtual void OnOtherBlock(const CommonHeader& block) {}
+    // A block that failed to parse, or a header that failed to parse after
+    // the first block.
+    virtual void OnMalformedBlock() {}
+
+   protected:
+    virtual ~Visitor() = default;
+  };
+
+  // |transport_feedback| must outlive the parser.
+  explicit CompoundPacketParser(TransportFeedback* transport_feedback);
+  ~CompoundPacketParser();
+
+  // Visits the blocks of the |length| bytes of |packet| in order. Returns
+  // false, without visiting anything, if the header of the first block is
+  // invalid. An invalid header after that ends the packet.
+  bool Parse(const uint8_t* packet, size_t length, Visitor* visitor);
+
+ private:
+  void ParseBlock(const CommonHeader& block, Visitor* visitor);
+
+  TransportFeedback* const transport_feedback_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(CompoundPacketParser);
+};
+
+}  // namespace rtcp
+}  // namespace webrtc
+
+#endif  // MODULES_RTP_RTCP_SOURCE_RTCP_PACKET_COMPOUND_PACKET_PARSER_H_
@@ -0,0 +1,186 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_parser.h"
+
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+
+using ::testing::_;
+using ::testing::ElementsAre;
+using ::testing::InSequence;
+using ::testing::Invoke;
+using ::testing::Property;
+using ::testing::Return;
+using ::testing::StrictMock;
+using webrtc::rtcp::Bye;
+using webrtc::rtcp::CommonHeader;
+using webrtc::rtcp::CompoundPacket;
+using webrtc::rtcp::CompoundPacketParser;
+using webrtc::rtcp::Nack;
+using webrtc::rtcp::ReceiverReport;
+using webrtc::rtcp::ReportBlock;
+using webrtc::rtcp::SenderReport;
+using webrtc::rtcp::TransportFeedback;
+
+namespace webrtc {
+namespace {
+
+const uint32_t kSenderSsrc = 0x12345678;
+const uint32_t kMediaSsrc = 0x23456789;
+const uint32_t kRtpTimestamp = 0x33343536;
+
+class MockVisitor : public CompoundPacketParser::Visitor {
+ public:
+  MOCK_METHOD3(OnSenderReport,
+               void(uint32_t sender_ssrc, NtpTime ntp, uint32_t rtp_timestamp));
+  MOCK_METHOD1(OnReceiverReport, void(uint32_t sender_ssrc));
+  MOCK_METHOD2(OnReportBlock,
+               void(uint32_t sender_ssrc, const ReportBlock& report_block));
+  MOCK_METHOD2(OnNack, bool(uint32_t sender_ssrc, uint32_t media_ssrc));
+  MOCK_METHOD1(OnNackedPacket, void(uint16_t packet_id));
+  MOCK_METHOD1(OnTransportFeedback, void(const TransportFeedback& feedback));
+  MOCK_METHOD1(OnOtherBlock, void(const CommonHeader& block));
+  MOCK_METHOD0(OnMalformedBlock, void());
+};
+
+}  // namespace
+
+TEST(RtcpCompoundPacketParserTest, VisitsReportsAndReportBlocks) {
+  ReportBlock rb1;
+  rb1.SetMediaSsrc(1);
+  ReportBlock rb2;
+  rb2.SetMediaSsrc(2);
+  SenderReport sr;
+  sr.SetSenderSsrc(kSenderSsrc);
+  sr.SetNtp(NtpTime(0x11121314, 0x21222324));
+  sr.SetRtpTimestamp(kRtpTimestamp);
+  sr.AddReportBlock(rb1);
+  ReceiverReport rr;
+  rr.SetSenderSsrc(kMediaSsrc);
+  rr.AddReportBlock(rb1);
+  rr.AddReportBlock(rb2);
+  CompoundPacket compound;
+  compound.Append(&sr);
+  compound.Append(&rr);
+  rtc::Buffer packet = compound.Build();
+
+  StrictMock<MockVisitor> visitor;
+  {
+    InSequence s;
+    EXPECT_CALL(visitor, OnSenderReport(kSenderSsrc,
+                                        NtpTime(0x11121314, 0x21222324),
+                                        kRtpTimestamp));
+    EXPECT_CALL(visitor, OnReportBlock(kSenderSsrc,
+                                       Property(&ReportBlock::source_ssrc, 1)));
+    EXPECT_CALL(visitor, OnReceiverReport(kMediaSsrc));
+    EXPECT_CALL(visitor, OnReportBlock(kMediaSsrc,
+                                       Property(&ReportBlock::source_ssrc, 1)));
+    EXPECT_CALL(visitor, OnReportBlock(kMediaSsrc,
+                                       Property(&ReportBlock::source_ssrc, 2)));
+  }
+  TransportFeedback transport_feedback;
+  CompoundPacketParser parser(&transport_feedback);
+  EXPECT_TRUE(parser.Parse(packet.data(), packet.size(), &visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, VisitsNackedPacketsWhenAccepted) {
+  Nack nack;
+  nack.SetSenderSsrc(kSenderSsrc);
+  nack.SetMediaSsrc(kMediaSsrc);
+  nack.SetPacketIds({1, 2, 3, 5, 20, 40, 41});
+  rtc::Buffer packet = nack.Build();
+
+  StrictMock<MockVisitor> visitor;
+  std::vector<uint16_t> packet_ids;
+  EXPECT_CALL(visitor, OnNack(kSenderSsrc, kMediaSsrc)).WillOnce(Return(true));
+  EXPECT_CALL(visitor, OnNackedPacket(_))
+      .WillRepeatedly(
+          Invoke([&](uint16_t packet_id) { packet_ids.push_back(packet_id); }));
+  TransportFeedback transport_feedback;
+  CompoundPacketParser parser(&transport_feedback);
+  EXPECT_TRUE(parser.Parse(packet.data(), packet.size(), &visitor));
+  EXPECT_THAT(packet_ids, ElementsAre(1, 2, 3, 5, 20, 40, 41));
+
+  // Packet ids are not visited if the NACK is not accepted.
+  EXPECT_CALL(visitor, OnNack(kSenderSsrc, kMediaSsrc)).WillOnce(Return(false));
+  EXPECT_TRUE(parser.Parse(packet.data(), packet.size(), &visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, ReusesTransportFeedback) {
+  TransportFeedback transport_feedback;
+  CompoundPacketParser parser(&transport_feedback);
+  StrictMock<MockVisitor> visitor;
+  for (uint16_t base_seq : {100, 1000}) {
+    TransportFeedback feedback;
+    feedback.SetSenderSsrc(kSenderSsrc);
+    feedback.SetMediaSsrc(kMediaSsrc);
+    feedback.SetBase(base_seq, 10000);
+    feedback.AddReceivedPacket(base_seq, 10000);
+    feedback.AddReceivedPacket(base_seq + 3, 12000);
+    rtc::Buffer packet = feedback.Build();
+
+    EXPECT_CALL(visitor, OnTransportFeedback(_))
+        .WillOnce(Invoke([&](const TransportFeedback& parsed) {
+          EXPECT_EQ(&transport_feedback, &parsed);
+          EXPECT_EQ(kMediaSsrc, parsed.media_ssrc());
+          EXPECT_EQ(base_seq, parsed.GetBaseSequence());
+          EXPECT_EQ(4u, parsed.GetPacketStatusCount());
+          ASSERT_EQ(2u, parsed.GetReceivedPackets().size());
+          EXPECT_EQ(base_seq + 3,
+                    parsed.GetReceivedPackets()[1].sequence_number());
+        }));
+    EXPECT_TRUE(parser.Parse(packet.data(), packet.size(), &visitor));
+  }
+}
+
+TEST(RtcpCompoundPacketParserTest, LeavesOtherBlocksToVisitor) {
+  Bye bye;
+  bye.SetSenderSsrc(kSenderSsrc);
+  rtc::Buffer packet = bye.Build();
+
+  StrictMock<MockVisitor> visitor;
+  EXPECT_CALL(visitor, OnOtherBlock(Property(&CommonHeader::type,
+                                             Bye::kPacketType)));
+  TransportFeedback transport_feedback;
+  CompoundPacketParser parser(&transport_feedback);
+  EXPECT_TRUE(parser.Parse(packet.data(), packet.size(), &visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, ReportsMalformedBlocks) {
+  // A receiver report claiming a report block it doesn't have, and a
+  // truncated header after it.
+  const uint8_t kPacket[] = {0x81, 201, 0x00, 0x01, 0x12, 0x34, 0x56, 0x78,
+                             0x80, 201, 0x00};
+  StrictMock<MockVisitor> visitor;
+  EXPECT_CALL(visitor, OnMalformedBlock()).Times(2);
+  TransportFeedback transport_feedback;
+  CompoundPacketParser parser(&transport_feedback);
+  EXPECT_TRUE(parser.Parse(kPacket, sizeof(kPacket), &visitor));
+}
+
+TEST(RtcpCompoundPacketParserTest, FailsForInvalidFirstHeader) {
+  const uint8_t kPacket[] = {0x81, 201, 0x00};
+  StrictMock<MockVisitor> visitor;
+  TransportFeedback transport_feedback;
+  CompoundPacketParser parser(&transport_feedback);
+  EXPECT_FALSE(parser.Parse(kPacket, sizeof(kPacket), &visitor));
+}
+
+}  // namespace webrtc
@@ -378,9 +378,12 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     return false;
   }
 
-  std::vector<uint8_t> delta_sizes;
-  delta_sizes.reserve(status_count);
-  while (delta_sizes.size() < status_count) {
+  // The chunks are decoded twice, first to find where the deltas start and
+  // then along with the deltas, so that parsing a reused TransportFeedback
+  // doesn't allocate the delta sizes of all packets.
+  const size_t chunks_index = index;
+  size_t num_delta_sizes = 0;
+  while (num_delta_sizes < status_count) {
     if (index + kChunkSizeBytes > end_index) {
       RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
       Clear();
@@ -390,47 +393,58 @@ bool TransportFeedback::Parse(const CommonHeader& packet) {
     uint16_t chunk = ByteReader<uint16_t>::ReadBigEndian(&payload[index]);
     index += kChunkSizeBytes;
     encoded_chunks_.push_back(chunk);
-    last_chunk_.Decode(chunk, status_count - delta_sizes.size());
-    last_chunk_.AppendTo(&delta_sizes);
+    last_chunk_.Decode(chunk, status_count - num_delta_sizes);
+    num_delta_sizes += last_chunk_.size();
   }
   // Last chunk is stored in the |last_chunk_|.
   encoded_chunks_.pop_back();
-  RTC_DCHECK_EQ(delta_sizes.size(), status_count);
+  RTC_DCHECK_EQ(num_delta_sizes, status_count);
   num_seq_no_ = status_count;
 
+  const size_t deltas_index = index;
   uint16_t seq_no = base_seq_no_;
-  for (size_t delta_size : delta_sizes) {
-    if (index + delta_size > end_index) {
-      RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
-      Clear();
-      return false;
-    }
-    switch (delta_size) {
-      case 0:
-        break;
-      case 1: {
-        int16_t delta = payload[index];
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
-      }
-      case 2: {
-        int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
-        packets_.emplace_back(seq_no, delta);
-        last_timestamp_us_ += delta * kDeltaScaleFactor;
-        index += delta_size;
-        break;
-      }
-      case 3:
+  num_delta_sizes = 0;
+  LastChunk chunk_delta_sizes;
+  for (size_t chunk_index = chunks_index; chunk_index < deltas_index;
+       chunk_index += kChunkSizeBytes) {
+    chunk_delta_sizes.Decode(
+        ByteReader<uint16_t>::ReadBigEndian(&payload[chunk_index]),
+        status_count - num_delta_sizes);
+    num_delta_sizes += chunk_delta_sizes.size();
+    for (size_t i = 0; i < chunk_delta_sizes.size(); ++i) {
+      const DeltaSize delta_size = chunk_delta_sizes.delta_size(i);
+      if (index + delta_size > end_index) {
+        RTC_LOG(LS_WARNING) << "Buffer overflow while parsing packet.";
         Clear();
-        RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
         return false;
-      default:
-        RTC_NOTREACHED();
-        break;
+      }
+      switch (delta_size) {
+        case 0:
+          break;
+        case 1: {
+          int16_t delta = payload[index];
+          packets_.emplace_back(seq_no, delta);
+          last_timestamp_us_ += delta * kDeltaScaleFactor;
+          index += delta_size;
+          break;
+        }
+        case 2: {
+          int16_t delta = ByteReader<int16_t>::ReadBigEndian(&payload[index]);
+          packets_.emplace_back(seq_no, delta);
+          last_timestamp_us_ += delta * kDeltaScaleFactor;
+          index += delta_size;
+          break;
+        }
+        case 3:
+          Clear();
+          RTC_LOG(LS_WARNING) << "Invalid delta_size for seq_no " << seq_no;
+          return false;
+        default:
+          RTC_NOTREACHED();
+          break;
+      }
+      ++seq_no;
     }
-    ++seq_no;
   }
   size_bytes_ = RtcpPacket::kHeaderLength + index;
   RTC_DCHECK_LE(index, end_index);
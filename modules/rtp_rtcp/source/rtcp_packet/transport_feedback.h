@@ -65,6 +65,10 @@ class TransportFeedback : public Rtpfb {
   // Get the reference time in microseconds, including any precision loss.
   int64_t GetBaseTimeUs() const;
 
+  // Reset packet to consistent empty state. The allocated storage is kept, so
+  // that a sender can reuse one packet for all the feedback it builds.
+  void Clear();
+
   bool Parse(const CommonHeader& packet);
   static std::unique_ptr<TransportFeedback> ParseFrom(const uint8_t* buffer,
                                                       size_t length);
@@ -106,6 +110,11 @@ class TransportFeedback : public Rtpfb {
 
     // Decode up to |max_size| delta sizes from |chunk|.
     void Decode(uint16_t chunk, size_t max_size);
+    // Number of stored delta sizes, and the |index|th of them.
+    size_t size() const { return size_; }
+    DeltaSize delta_size(size_t index) const {
+      return all_same_ ? delta_sizes_[0] : delta_sizes_[index];
+    }
     // Appends content of the Lastchunk to |deltas|.
     void AppendTo(std::vector<DeltaSize>* deltas) const;
 
@@ -131,9 +140,6 @@ class TransportFeedback : public Rtpfb {
     bool has_large_delta_;
   };
 
-  // Reset packet to consistent empty state.
-  void Clear();
-
   bool AddDeltaSize(DeltaSize delta_size);
 
   uint16_t base_seq_no_;
@@ -24,15 +24,14 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/common_header.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/compound_packet_parser.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
-#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/rapid_resync_request.h"
-#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
-#include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/tmmbn.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/tmmbr.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
@@ -71,7 +70,8 @@ struct RTCPReceiver::PacketInformation {
   ReportBlockList report_blocks;
   int64_t rtt_ms = 0;
   uint32_t receiver_estimated_max_bitrate_bps = 0;
-  std::unique_ptr<rtcp::TransportFeedback> transport_feedback;
+  // Points to RTCPReceiver::transport_feedback_, when set.
+  const rtcp::TransportFeedback* transport_feedback = nullptr;
   rtc::Optional<VideoBitrateAllocation> target_bitrate_allocation;
 };
 
@@ -123,6 +123,66 @@ struct RTCPReceiver::LastFirStatus {
   uint8_t sequence_number;
 };
 
+// Takes |rtcp_receiver_lock_| for each block that updates the receiver state,
+// rather than for the whole compound packet.
+class RTCPReceiver::PacketVisitor : public rtcp::CompoundPacketParser::Visitor {
+ public:
+  PacketVisitor(RTCPReceiver* receiver, PacketInformation* packet_information)
+      : receiver_(receiver), packet_information_(packet_information) {}
+
+  void OnSenderReport(uint32_t sender_ssrc,
+                      NtpTime ntp,
+                      uint32_t rtp_timestamp) override {
+    rtc::CritScope lock(&receiver_->rtcp_receiver_lock_);
+    receiver_->HandleSenderReport(sender_ssrc, ntp, rtp_timestamp,
+                                  packet_information_);
+  }
+
+  void OnReceiverReport(uint32_t sender_ssrc) override {
+    rtc::CritScope lock(&receiver_->rtcp_receiver_lock_);
+    receiver_->HandleReceiverReport(sender_ssrc, packet_information_);
+  }
+
+  void OnReportBlock(uint32_t sender_ssrc,
+                     const ReportBlock& report_block) override {
+    rtc::CritScope lock(&receiver_->rtcp_receiver_lock_);
+    receiver_->HandleReportBlock(report_block, packet_information_,
+                                 sender_ssrc);
+  }
+
+  bool OnNack(uint32_t sender_ssrc, uint32_t media_ssrc) override {
+    rtc::CritScope lock(&receiver_->rtcp_receiver_lock_);
+    if (!receiver_->HandleNack(media_ssrc))
+      return false;
+    packet_information_->packet_type_flags |= kRtcpNack;
+    return true;
+  }
+
+  void OnNackedPacket(uint16_t packet_id) override {
+    packet_information_->nack_sequence_numbers.push_back(packet_id);
+  }
+
+  void OnTransportFeedback(
+      const rtcp::TransportFeedback& transport_feedback) override {
+    packet_information_->packet_type_flags |= kRtcpTransportFeedback;
+    packet_information_->transport_feedback = &transport_feedback;
+  }
+
+  void OnOtherBlock(const CommonHeader& rtcp_block) override {
+    rtc::CritScope lock(&receiver_->rtcp_receiver_lock_);
+    receiver_->HandleOtherBlock(rtcp_block, packet_information_);
+  }
+
+  void OnMalformedBlock() override {
+    rtc::CritScope lock(&receiver_->rtcp_receiver_lock_);
+    ++receiver_->num_skipped_packets_;
+  }
+
+ private:
+  RTCPReceiver* const receiver_;
+  PacketInformation* const packet_information_;
+};
+
 RTCPReceiver::RTCPReceiver(
     Clock* clock,
     bool receiver_only,
@@ -162,6 +222,7 @@ void RTCPReceiver::IncomingPacket(const uint8_t* packet, size_t packet_size) {
     return;
   }
 
+  RTC_DCHECK_RUNS_SERIALIZED(&parse_race_checker_);
   PacketInformation packet_information;
   if (!ParseCompoundPacket(packet, packet + packet_size, &packet_information))
     return;
@@ -307,84 +368,23 @@ int32_t RTCPReceiver::StatisticsReceived(
 bool RTCPReceiver::ParseCompoundPacket(const uint8_t* packet_begin,
                                        const uint8_t* packet_end,
                                        PacketInformation* packet_information) {
-  rtc::CritScope lock(&rtcp_receiver_lock_);
+  PacketVisitor visitor(this, packet_information);
+  rtcp::CompoundPacketParser parser(&transport_feedback_);
+  if (!parser.Parse(packet_begin, packet_end - packet_begin, &visitor)) {
+    // Failed to parse 1st header, nothing was extracted from this packet.
+    RTC_LOG(LS_WARNING) << "Incoming invalid RTCP packet";
+    return false;
+  }
 
-  CommonHeader rtcp_block;
-  for (const uint8_t* next_block = packet_begin; next_block != packet_end;
-       next_block = rtcp_block.NextPacket()) {
-    ptrdiff_t remaining_blocks_size = packet_end - next_block;
-    RTC_DCHECK_GT(remaining_blocks_size, 0);
-    if (!rtcp_block.Parse(next_block, remaining_blocks_size)) {
-      if (next_block == packet_begin) {
-        // Failed to parse 1st header, nothing was extracted from this packet.
-        RTC_LOG(LS_WARNING) << "Incoming invalid RTCP packet";
-        return false;
-      }
-      ++num_skipped_packets_;
-      break;
-    }
+  rtc::CritScope lock(&rtcp_receiver_lock_);
+  if (packet_type_counter_.first_packet_time_ms == -1)
+    packet_type_counter_.first_packet_time_ms = clock_->TimeInMilliseconds();
 
-    if (packet_type_counter_.first_packet_time_ms == -1)
-      packet_type_counter_.first_packet_time_ms = clock_->TimeInMilliseconds();
-
-    switch (rtcp_block.type()) {
-      case rtcp::SenderReport::kPacketType:
-        HandleSenderReport(rtcp_block, packet_information);
-        break;
-      case rtcp::ReceiverReport::kPacketType:
-        HandleReceiverReport(rtcp_block, packet_information);
-        break;
-      case rtcp::Sdes::kPacketType:
-        HandleSdes(rtcp_block, packet_information);
-        break;
-      case rtcp::ExtendedReports::kPacketType:
-        HandleXr(rtcp_block, packet_information);
-        break;
-      case rtcp::Bye::kPacketType:
-        HandleBye(rtcp_block);
-        break;
-      case rtcp::Rtpfb::kPacketType:
-        switch (rtcp_block.fmt()) {
-          case rtcp::Nack::kFeedbackMessageType:
-            HandleNack(rtcp_block, packet_information);
-            break;
-          case rtcp::Tmmbr::kFeedbackMessageType:
-            HandleTmmbr(rtcp_block, packet_information);
-            break;
-          case rtcp::Tmmbn::kFeedbackMessageType:
-            HandleTmmbn(rtcp_block, packet_information);
-            break;
-          case rtcp::RapidResyncRequest::kFeedbackMessageType:
-            HandleSrReq(rtcp_block, packet_information);
-            break;
-          case rtcp::TransportFeedback::kFeedbackMessageType:
-            HandleTransportFeedback(rtcp_block, packet_information);
-            break;
-          default:
-            ++num_skipped_packets_;
-            break;
-        }
-        break;
-      case rtcp::Psfb::kPacketType:
-        switch (rtcp_block.fmt()) {
-          case rtcp::Pli::kFeedbackMessageType:
-            HandlePli(rtcp_block, packet_information);
-            break;
-          case rtcp::Fir::kFeedbackMessageType:
-            HandleFir(rtcp_block, packet_information);
-            break;
-          case rtcp::Remb::kFeedbackMessageType:
-            HandlePsfbApp(rtcp_block, packet_information);
-            break;
-          default:
-            ++num_skipped_packets_;
-            break;
-        }
-        break;
-      default:
-        ++num_skipped_packets_;
-        break;
-    }
+  if (!packet_information->nack_sequence_numbers.empty()) {
+    for (uint16_t packet_id : packet_information->nack_sequence_numbers)
+      nack_stats_.ReportRequest(packet_id);
+    packet_type_counter_.nack_requests = nack_stats_.requests();
+    packet_type_counter_.unique_nack_requests = nack_stats_.unique_requests();
   }
 
   if (packet_type_counter_observer_) {
@@ -406,16 +406,60 @@ bool RTCPReceiver::ParseCompoundPacket(const uint8_t* packet_begin,
   return true;
 }
 
-void RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
-                                      PacketInformation* packet_information) {
-  rtcp::SenderReport sender_report;
-  if (!sender_report.Parse(rtcp_block)) {
-    ++num_skipped_packets_;
-    return;
+void RTCPReceiver::HandleOtherBlock(const CommonHeader& rtcp_block,
+                                    PacketInformation* packet_information) {
+  switch (rtcp_block.type()) {
+    case rtcp::Sdes::kPacketType:
+      HandleSdes(rtcp_block, packet_information);
+      break;
+    case rtcp::ExtendedReports::kPacketType:
+      HandleXr(rtcp_block, packet_information);
+      break;
+    case rtcp::Bye::kPacketType:
+      HandleBye(rtcp_block);
+      break;
+    case rtcp::Rtpfb::kPacketType:
+      switch (rtcp_block.fmt()) {
+        case rtcp::Tmmbr::kFeedbackMessageType:
+          HandleTmmbr(rtcp_block, packet_information);
+          break;
+        case rtcp::Tmmbn::kFeedbackMessageType:
+          HandleTmmbn(rtcp_block, packet_information);
+          break;
+        case rtcp::RapidResyncRequest::kFeedbackMessageType:
+          HandleSrReq(rtcp_block, packet_information);
+          break;
+        default:
+          ++num_skipped_packets_;
+          break;
+      }
+      break;
+    case rtcp::Psfb::kPacketType:
+      switch (rtcp_block.fmt()) {
+        case rtcp::Pli::kFeedbackMessageType:
+          HandlePli(rtcp_block, packet_information);
+          break;
+        case rtcp::Fir::kFeedbackMessageType:
+          HandleFir(rtcp_block, packet_information);
+          break;
+        case rtcp::Remb::kFeedbackMessageType:
+          HandlePsfbApp(rtcp_block, packet_information);
+          break;
+        default:
+          ++num_skipped_packets_;
+          break;
+      }
+      break;
+    default:
+      ++num_skipped_packets_;
+      break;
   }
+}
 
-  const uint32_t remote_ssrc = sender_report.sender_ssrc();
-
+void RTCPReceiver::HandleSenderReport(uint32_t remote_ssrc,
+                                      NtpTime ntp,
+                                      uint32_t rtp_timestamp,
+                                      PacketInformation* packet_information) {
   packet_information->remote_ssrc = remote_ssrc;
 
   UpdateTmmbrRemoteIsAlive(remote_ssrc);
@@ -428,29 +472,18 @@ void RTCPReceiver::HandleSenderReport(const CommonHeader& rtcp_block,
     // Only signal that we have received a SR when we accept one.
     packet_information->packet_type_flags |= kRtcpSr;
 
-    remote_sender_ntp_time_ = sender_report.ntp();
-    remote_sender_rtp_time_ = sender_report.rtp_timestamp();
+    remote_sender_ntp_time_ = ntp;
+    remote_sender_rtp_time_ = rtp_timestamp;
     last_received_sr_ntp_ = clock_->CurrentNtpTime();
   } else {
     // We will only store the send report from one source, but
     // we will store all the receive blocks.
     packet_information->packet_type_flags |= kRtcpRr;
   }
-
-  for (const rtcp::ReportBlock report_block : sender_report.report_blocks())
-    HandleReportBlock(report_block, packet_information, remote_ssrc);
 }
 
-void RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
+void RTCPReceiver::HandleReceiverReport(uint32_t remote_ssrc,
                                         PacketInformation* packet_information) {
-  rtcp::ReceiverReport receiver_report;
-  if (!receiver_report.Parse(rtcp_block)) {
-    ++num_skipped_packets_;
-    return;
-  }
-
-  const uint32_t remote_ssrc = receiver_report.sender_ssrc();
-
   packet_information->remote_ssrc = remote_ssrc;
 
   UpdateTmmbrRemoteIsAlive(remote_ssrc);
@@ -459,9 +492,6 @@ void RTCPReceiver::HandleReceiverReport(const CommonHeader& rtcp_block,
                        "remote_ssrc", remote_ssrc, "ssrc", main_ssrc_);
 
   packet_information->packet_type_flags |= kRtcpRr;
-
-  for (const ReportBlock& report_block : receiver_report.report_blocks())
-    HandleReportBlock(report_block, packet_information, remote_ssrc);
 }
 
 void RTCPReceiver::HandleReportBlock(const ReportBlock& report_block,
@@ -655,29 +685,11 @@ void RTCPReceiver::HandleSdes(const CommonHeader& rtcp_block,
   packet_information->packet_type_flags |= kRtcpSdes;
 }
 
-void RTCPReceiver::HandleNack(const CommonHeader& rtcp_block,
-                              PacketInformation* packet_information) {
-  rtcp::Nack nack;
-  if (!nack.Parse(rtcp_block)) {
-    ++num_skipped_packets_;
-    return;
-  }
-
-  if (receiver_only_ || main_ssrc_ != nack.media_ssrc())  // Not to us.
-    return;
-
-  packet_information->nack_sequence_numbers.insert(
-      packet_information->nack_sequence_numbers.end(),
-      nack.packet_ids().begin(), nack.packet_ids().end());
-  for (uint16_t packet_id : nack.packet_ids())
-    nack_stats_.ReportRequest(packet_id);
-
-  if (!nack.packet_ids().empty()) {
-    packet_information->packet_type_flags |= kRtcpNack;
-    ++packet_type_counter_.nack_packets;
-    packet_type_counter_.nack_requests = nack_stats_.requests();
-    packet_type_counter_.unique_nack_requests = nack_stats_.unique_requests();
-  }
+bool RTCPReceiver::HandleNack(uint32_t media_ssrc) {
+  if (receiver_only_ || main_ssrc_ != media_ssrc)  // Not to us.
+    return false;
+  ++packet_type_counter_.nack_packets;
+  return true;
 }
 
 void RTCPReceiver::HandleBye(const CommonHeader& rtcp_block) {
@@ -915,20 +927,6 @@ void RTCPReceiver::HandleFir(const CommonHeader& rtcp_block,
   }
 }
 
-void RTCPReceiver::HandleTransportFeedback(
-    const CommonHeader& rtcp_block,
-    PacketInformation* packet_information) {
-  std::unique_ptr<rtcp::TransportFeedback> transport_feedback(
-      new rtcp::TransportFeedback());
-  if (!transport_feedback->Parse(rtcp_block)) {
-    ++num_skipped_packets_;
-    return;
-  }
-
-  packet_information->packet_type_flags |= kRtcpTransportFeedback;
-  packet_information->transport_feedback = std::move(transport_feedback);
-}
-
 void RTCPReceiver::NotifyTmmbrUpdated() {
   // Find bounding set.
   std::vector<rtcp::TmmbItem> bounding =
@@ -20,7 +20,9 @@
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/rtp_rtcp/source/rtcp_nack_stats.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/race_checker.h"
 #include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/ntp_time.h"
 #include "typedefs.h"  // NOLINT(build/include)
@@ -114,6 +116,7 @@ class RTCPReceiver {
   RtcpStatisticsCallback* GetRtcpStatisticsCallback();
 
  private:
+  class PacketVisitor;
   struct PacketInformation;
   struct TmmbrInformation;
   struct RrtrInformation;
@@ -139,11 +142,13 @@ class RTCPReceiver {
   TmmbrInformation* GetTmmbrInformation(uint32_t remote_ssrc)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  void HandleSenderReport(const rtcp::CommonHeader& rtcp_block,
+  void HandleSenderReport(uint32_t remote_ssrc,
+                          NtpTime ntp,
+                          uint32_t rtp_timestamp,
                           PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  void HandleReceiverReport(const rtcp::CommonHeader& rtcp_block,
+  void HandleReceiverReport(uint32_t remote_ssrc,
                             PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
@@ -172,8 +177,13 @@ class RTCPReceiver {
                              PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  void HandleNack(const rtcp::CommonHeader& rtcp_block,
-                  PacketInformation* packet_information)
+  // Returns true if the NACK is for the media we send.
+  bool HandleNack(uint32_t media_ssrc)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
+
+  // Handles the blocks that the CompoundPacketParser doesn't parse itself.
+  void HandleOtherBlock(const rtcp::CommonHeader& rtcp_block,
+                        PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
   void HandleBye(const rtcp::CommonHeader& rtcp_block)
@@ -203,14 +213,16 @@ class RTCPReceiver {
                  PacketInformation* packet_information)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
 
-  void HandleTransportFeedback(const rtcp::CommonHeader& rtcp_block,
-                               PacketInformation* packet_information)
-      RTC_EXCLUSIVE_LOCKS_REQUIRED(rtcp_receiver_lock_);
-
   Clock* const clock_;
   const bool receiver_only_;
   ModuleRtpRtcp* const rtp_rtcp_;
 
+  // Compound packets are parsed without holding |rtcp_receiver_lock_|, and
+  // transport feedback is parsed into the same |transport_feedback_| each
+  // time, so IncomingPacket() must not be called concurrently.
+  rtc::RaceChecker parse_race_checker_;
+  rtcp::TransportFeedback transport_feedback_;
+
   rtc::CriticalSection feedbacks_lock_;
   RtcpBandwidthObserver* const rtcp_bandwidth_observer_;
   RtcpIntraFrameObserver* const rtcp_intra_frame_observer_;
@@ -73,6 +73,28 @@ void RtcpTransceiver::RemoveMediaReceiverRtcpObserver(
   task_queue_->PostTaskAndReply(std::move(remove), std::move(on_removed));
 }
 
+void RtcpTransceiver::AddMediaSender(uint32_t local_ssrc,
+                                     RtpStreamRtcpHandler* handler) {
+  rtc::WeakPtr<RtcpTransceiverImpl> ptr = ptr_;
+  task_queue_->PostTask([ptr, local_ssrc, handler] {
+    if (ptr) {
+      bool added = ptr->AddMediaSender(local_ssrc, handler);
+      RTC_DCHECK(added) << "Media sender " << local_ssrc << " already added.";
+    }
+  });
+}
+
+void RtcpTransceiver::RemoveMediaSender(
+    uint32_t local_ssrc,
+    std::unique_ptr<rtc::QueuedTask> on_removed) {
+  rtc::WeakPtr<RtcpTransceiverImpl> ptr = ptr_;
+  auto remove = [ptr, local_ssrc] {
+    if (ptr)
+      ptr->RemoveMediaSender(local_ssrc);
+  };
+  task_queue_->PostTaskAndReply(std::move(remove), std::move(on_removed));
+}
+
 void RtcpTransceiver::SetReadyToSend(bool ready) {
   rtc::WeakPtr<RtcpTransceiverImpl> ptr = ptr_;
   task_queue_->PostTask([ptr, ready] {
@@ -43,6 +43,14 @@ class RtcpTransceiver : public RtcpFeedbackSenderInterface {
       MediaReceiverRtcpObserver* observer,
       std::unique_ptr<rtc::QueuedTask> on_removed);
 
+  // Adds a local media sender. Calls to |handler| will be done on the
+  // |config.task_queue|.
+  void AddMediaSender(uint32_t local_ssrc, RtpStreamRtcpHandler* handler);
+  // Removes the media sender. Might return before the sender is removed.
+  // Posts |on_removed| task when |handler| is no longer used.
+  void RemoveMediaSender(uint32_t local_ssrc,
+                         std::unique_ptr<rtc::QueuedTask> on_removed);
+
   // Enables/disables sending rtcp packets eventually.
   // Packets may be sent after the SetReadyToSend(false) returns, but no new
   // packets will be scheduled.
@@ -13,6 +13,7 @@
 
 #include <string>
 
+#include "api/array_view.h"
 #include "api/rtp_headers.h"
 #include "api/video/video_bitrate_allocation.h"
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
@@ -22,6 +23,9 @@
 namespace webrtc {
 class ReceiveStatisticsProvider;
 class Transport;
+namespace rtcp {
+class ReportBlock;
+}  // namespace rtcp
 
 // Interface to watch incoming rtcp packets by media (rtp) receiver.
 class MediaReceiverRtcpObserver {
@@ -38,6 +42,34 @@ class MediaReceiverRtcpObserver {
                                    const VideoBitrateAllocation& allocation) {}
 };
 
+// Interface to a local media (rtp) sender: provides the statistics for its
+// sender reports, and watches the incoming rtcp packets about it.
+class RtpStreamRtcpHandler {
+ public:
+  struct RtpStats {
+    uint32_t num_sent_packets = 0;
+    uint32_t num_sent_bytes = 0;
+    // Rtp timestamp of the last sent frame and its capture time, used along
+    // with |clock_rate_hz| to find the rtp timestamp for the sender report.
+    uint32_t last_rtp_timestamp = 0;
+    int64_t last_capture_time_us = 0;
+    int clock_rate_hz = 90000;
+  };
+
+  virtual ~RtpStreamRtcpHandler() = default;
+
+  // Returns the statistics for the next sender report. No sender report is
+  // sent for the stream until it returns stats with a sent packet.
+  virtual RtpStats SentStats() = 0;
+
+  virtual void OnNack(uint32_t sender_ssrc,
+                      rtc::ArrayView<const uint16_t> sequence_numbers) {}
+  virtual void OnPli(uint32_t sender_ssrc) {}
+  virtual void OnFir(uint32_t sender_ssrc) {}
+  virtual void OnReportBlock(uint32_t sender_ssrc,
+                             const rtcp::ReportBlock& report_block) {}
+};
+
 struct RtcpTransceiverConfig {
   RtcpTransceiverConfig();
   RtcpTransceiverConfig(const RtcpTransceiverConfig&);
@@ -70,10 +102,16 @@ struct RtcpTransceiverConfig {
   // Rtcp report block generator for outgoing receiver reports.
   ReceiveStatisticsProvider* receive_statistics = nullptr;
 
-  // Callback to pass result of rtt calculation. Should outlive RtcpTransceiver.
-  // Callbacks will be invoked on the task_queue.
+  // Callback to pass result of rtt calculation, from the report blocks about
+  // local media senders and from the DLRR replies to our RRTR. Should outlive
+  // RtcpTransceiver. Callbacks will be invoked on the task_queue.
   RtcpRttStats* rtt_observer = nullptr;
 
+  // Callback to pass the bitrate of incoming REMB, and the lowest bitrate
+  // limit requested with TMMBR for a local media sender. Should outlive
+  // RtcpTransceiver. Callbacks will be invoked on the task_queue.
+  RtcpBandwidthObserver* bandwidth_observer = nullptr;
+
   // Configures if sending should
   //  enforce compound packets: https://tools.ietf.org/html/rfc4585#section-3.1
   //  or allow reduced size packets: https://tools.ietf.org/html/rfc5506
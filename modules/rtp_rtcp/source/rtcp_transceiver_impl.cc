@@ -10,6 +10,8 @@
 
 #include "modules/rtp_rtcp/source/rtcp_transceiver_impl.h"
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 #include "api/call/transport.h"
@@ -23,11 +25,16 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/psfb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rtpfb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sdes.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/sender_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/tmmbn.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/tmmbr.h"
 #include "modules/rtp_rtcp/source/time_util.h"
+#include "modules/rtp_rtcp/source/tmmbr_help.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
@@ -37,16 +44,27 @@
 namespace webrtc {
 namespace {
 
+// Like RTCPReceiver, drops TMMBR requests that weren't renewed for five
+// regular rtcp intervals.
+constexpr int64_t kTmmbrTimeoutUs = 5 * 5 * rtc::kNumMicrosecsPerSec;
+
 struct SenderReportTimes {
   int64_t local_received_time_us;
   NtpTime remote_sent_time;
 };
 
+struct RrtrTimes {
+  int64_t local_received_time_us;
+  uint32_t remote_sent_time_compact_ntp;
+};
+
 }  // namespace
 
 struct RtcpTransceiverImpl::RemoteSenderState {
   uint8_t fir_sequence_number = 0;
   rtc::Optional<SenderReportTimes> last_received_sender_report;
+  // Reference time to reply to with a DLRR in the next compound packet.
+  rtc::Optional<RrtrTimes> last_received_rrtr;
   std::vector<MediaReceiverRtcpObserver*> observers;
 };
 
@@ -118,6 +136,18 @@ void RtcpTransceiverImpl::RemoveMediaReceiverRtcpObserver(
   stored.erase(it);
 }
 
+bool RtcpTransceiverImpl::AddMediaSender(uint32_t local_ssrc,
+                                         RtpStreamRtcpHandler* handler) {
+  RTC_DCHECK(handler);
+  return local_senders_.emplace(local_ssrc, handler).second;
+}
+
+bool RtcpTransceiverImpl::RemoveMediaSender(uint32_t local_ssrc) {
+  tmmbr_requests_.erase(local_ssrc);
+  pending_tmmbn_.erase(local_ssrc);
+  return local_senders_.erase(local_ssrc) > 0;
+}
+
 void RtcpTransceiverImpl::SetReadyToSend(bool ready) {
   if (config_.schedule_periodic_compound_packets) {
     if (ready_to_send_ && !ready)  // Stop existent send task.
@@ -219,6 +249,32 @@ void RtcpTransceiverImpl::HandleReceivedPacket(
     case rtcp::SenderReport::kPacketType:
       HandleSenderReport(rtcp_packet_header, now_us);
       break;
+    case rtcp::ReceiverReport::kPacketType:
+      HandleReceiverReport(rtcp_packet_header, now_us);
+      break;
+    case rtcp::Rtpfb::kPacketType:
+      switch (rtcp_packet_header.fmt()) {
+        case rtcp::Nack::kFeedbackMessageType:
+          HandleNack(rtcp_packet_header);
+          break;
+        case rtcp::Tmmbr::kFeedbackMessageType:
+          HandleTmmbr(rtcp_packet_header, now_us);
+          break;
+      }
+      break;
+    case rtcp::Psfb::kPacketType:
+      switch (rtcp_packet_header.fmt()) {
+        case rtcp::Pli::kFeedbackMessageType:
+          HandlePli(rtcp_packet_header);
+          break;
+        case rtcp::Fir::kFeedbackMessageType:
+          HandleFir(rtcp_packet_header);
+          break;
+        case rtcp::Remb::kFeedbackMessageType:
+          HandleRemb(rtcp_packet_header);
+          break;
+      }
+      break;
     case rtcp::ExtendedReports::kPacketType:
       HandleExtendedReports(rtcp_packet_header, now_us);
       break;
@@ -254,6 +310,171 @@ void RtcpTransceiverImpl::HandleSenderReport(
   for (MediaReceiverRtcpObserver* observer : remote_sender.observers)
     observer->OnSenderReport(sender_report.sender_ssrc(), sender_report.ntp(),
                              sender_report.rtp_timestamp());
+
+  HandleReportBlocks(sender_report.sender_ssrc(), sender_report.report_blocks(),
+                     now_us);
+}
+
+void RtcpTransceiverImpl::HandleReceiverReport(
+    const rtcp::CommonHeader& rtcp_packet_header,
+    int64_t now_us) {
+  rtcp::ReceiverReport receiver_report;
+  if (!receiver_report.Parse(rtcp_packet_header))
+    return;
+  HandleReportBlocks(receiver_report.sender_ssrc(),
+                     receiver_report.report_blocks(), now_us);
+}
+
+void RtcpTransceiverImpl::HandleReportBlocks(
+    uint32_t sender_ssrc,
+    rtc::ArrayView<const rtcp::ReportBlock> report_blocks,
+    int64_t now_us) {
+  if (local_senders_.empty())
+    return;
+  // Delay and last_sr are transferred using 32bit compact ntp resolution.
+  // Convert packet arrival time to same format through 64bit ntp format.
+  uint32_t receive_time_ntp = CompactNtp(TimeMicrosToNtp(now_us));
+  for (const rtcp::ReportBlock& report_block : report_blocks) {
+    auto local_sender_it = local_senders_.find(report_block.source_ssrc());
+    if (local_sender_it == local_senders_.end())
+      continue;
+    local_sender_it->second->OnReportBlock(sender_ssrc, report_block);
+    // Last SR is zero when the remote side hasn't received a sender report.
+    if (config_.rtt_observer && report_block.last_sr() != 0) {
+      uint32_t rtt_ntp = receive_time_ntp - report_block.delay_since_last_sr() -
+                         report_block.last_sr();
+      config_.rtt_observer->OnRttUpdate(CompactNtpRttToMs(rtt_ntp));
+    }
+  }
+}
+
+void RtcpTransceiverImpl::HandleNack(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  rtcp::Nack nack;
+  if (!nack.Parse(rtcp_packet_header))
+    return;
+  auto local_sender_it = local_senders_.find(nack.media_ssrc());
+  if (local_sender_it == local_senders_.end())
+    return;
+  local_sender_it->second->OnNack(nack.sender_ssrc(), nack.packet_ids());
+}
+
+void RtcpTransceiverImpl::HandlePli(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  rtcp::Pli pli;
+  if (!pli.Parse(rtcp_packet_header))
+    return;
+  auto local_sender_it = local_senders_.find(pli.media_ssrc());
+  if (local_sender_it == local_senders_.end())
+    return;
+  local_sender_it->second->OnPli(pli.sender_ssrc());
+}
+
+void RtcpTransceiverImpl::HandleFir(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  rtcp::Fir fir;
+  if (!fir.Parse(rtcp_packet_header))
+    return;
+  for (const rtcp::Fir::Request& request : fir.requests()) {
+    auto local_sender_it = local_senders_.find(request.ssrc);
+    if (local_sender_it == local_senders_.end())
+      continue;
+    local_sender_it->second->OnFir(fir.sender_ssrc());
+  }
+}
+
+void RtcpTransceiverImpl::HandleRemb(
+    const rtcp::CommonHeader& rtcp_packet_header) {
+  rtcp::Remb remb;
+  if (!config_.bandwidth_observer || !remb.Parse(rtcp_packet_header))
+    return;
+  config_.bandwidth_observer->OnReceivedEstimatedBitrate(
+      static_cast<uint32_t>(std::min<uint64_t>(
+          remb.bitrate_bps(), std::numeric_limits<uint32_t>::max())));
+}
+
+void RtcpTransceiverImpl::HandleTmmbr(
+    const rtcp::CommonHeader& rtcp_packet_header,
+    int64_t now_us) {
+  rtcp::Tmmbr tmmbr;
+  if (!tmmbr.Parse(rtcp_packet_header))
+    return;
+  // Media ssrc should be 0, unless the request is relayed for another ssrc.
+  uint32_t remote_ssrc =
+      tmmbr.media_ssrc() != 0 ? tmmbr.media_ssrc() : tmmbr.sender_ssrc();
+  for (const rtcp::TmmbItem& request : tmmbr.requests()) {
+    if (request.bitrate_bps() == 0 ||
+        local_senders_.find(request.ssrc()) == local_senders_.end())
+      continue;
+    TmmbrRequest& stored = tmmbr_requests_[request.ssrc()][remote_ssrc];
+    stored.item = rtcp::TmmbItem(remote_ssrc, request.bitrate_bps(),
+                                 request.packet_overhead());
+    stored.received_time_us = now_us;
+    pending_tmmbn_.insert(request.ssrc());
+  }
+  if (pending_tmmbn_.empty())
+    return;
+  ReportTmmbrBitrateLimit();
+  // Each request is answered with a TMMBN without waiting for the next
+  // regular report, https://tools.ietf.org/html/rfc5104#section-4.2.1.2
+  SendCompoundPacket();
+}
+
+void RtcpTransceiverImpl::ExpireTmmbrRequests(int64_t now_us) {
+  bool expired = false;
+  for (auto sender_it = tmmbr_requests_.begin();
+       sender_it != tmmbr_requests_.end();) {
+    std::map<uint32_t, TmmbrRequest>& requests = sender_it->second;
+    for (auto it = requests.begin(); it != requests.end();) {
+      if (now_us - it->second.received_time_us > kTmmbrTimeoutUs) {
+        it = requests.erase(it);
+        pending_tmmbn_.insert(sender_it->first);
+        expired = true;
+      } else {
+        ++it;
+      }
+    }
+    if (requests.empty())
+      sender_it = tmmbr_requests_.erase(sender_it);
+    else
+      ++sender_it;
+  }
+  if (expired)
+    ReportTmmbrBitrateLimit();
+}
+
+void RtcpTransceiverImpl::ReportTmmbrBitrateLimit() {
+  if (!config_.bandwidth_observer)
+    return;
+  // Send streams share the bandwidth estimate, so the strictest limit on
+  // any of them applies.
+  rtc::Optional<uint64_t> min_bitrate_bps;
+  for (const auto& local_sender : tmmbr_requests_) {
+    std::vector<rtcp::TmmbItem> bounding_set =
+        TmmbrBoundingSet(local_sender.first);
+    if (bounding_set.empty())
+      continue;
+    uint64_t bitrate_bps = TMMBRHelp::CalcMinBitrateBps(bounding_set);
+    if (!min_bitrate_bps || bitrate_bps < *min_bitrate_bps)
+      min_bitrate_bps = bitrate_bps;
+  }
+  if (min_bitrate_bps &&
+      *min_bitrate_bps <= std::numeric_limits<uint32_t>::max()) {
+    config_.bandwidth_observer->OnReceivedEstimatedBitrate(
+        static_cast<uint32_t>(*min_bitrate_bps));
+  }
+}
+
+std::vector<rtcp::TmmbItem> RtcpTransceiverImpl::TmmbrBoundingSet(
+    uint32_t local_ssrc) const {
+  auto it = tmmbr_requests_.find(local_ssrc);
+  if (it == tmmbr_requests_.end())
+    return {};
+  std::vector<rtcp::TmmbItem> candidates;
+  candidates.reserve(it->second.size());
+  for (const auto& request : it->second)
+    candidates.push_back(request.second.item);
+  return TMMBRHelp::FindBoundingSet(std::move(candidates));
 }
 
 void RtcpTransceiverImpl::HandleExtendedReports(
@@ -263,6 +484,10 @@ void RtcpTransceiverImpl::HandleExtendedReports(
   if (!extended_reports.Parse(rtcp_packet_header))
     return;
 
+  if (extended_reports.rrtr())
+    HandleRrtr(extended_reports.sender_ssrc(), *extended_reports.rrtr(),
+               now_us);
+
   if (extended_reports.dlrr())
     HandleDlrr(extended_reports.dlrr(), now_us);
 
@@ -271,6 +496,16 @@ void RtcpTransceiverImpl::HandleExtendedReports(
                         extended_reports.sender_ssrc());
 }
 
+void RtcpTransceiverImpl::HandleRrtr(uint32_t sender_ssrc,
+                                     const rtcp::Rrtr& rrtr,
+                                     int64_t now_us) {
+  rtc::Optional<RrtrTimes>& last =
+      remote_senders_[sender_ssrc].last_received_rrtr;
+  last.emplace();
+  last->local_received_time_us = now_us;
+  last->remote_sent_time_compact_ntp = CompactNtp(rrtr.ntp());
+}
+
 void RtcpTransceiverImpl::HandleDlrr(const rtcp::Dlrr& dlrr, int64_t now_us) {
   if (!config_.non_sender_rtt_measurement || config_.rtt_observer == nullptr)
     return;
@@ -358,10 +593,14 @@ void RtcpTransceiverImpl::CreateCompoundPacket(PacketSender* sender) {
   RTC_DCHECK(sender->IsEmpty());
   const uint32_t sender_ssrc = config_.feedback_ssrc;
   int64_t now_us = rtc::TimeMicros();
-  rtcp::ReceiverReport receiver_report;
-  receiver_report.SetSenderSsrc(sender_ssrc);
-  receiver_report.SetReportBlocks(CreateReportBlocks(now_us));
-  sender->AppendPacket(receiver_report);
+  std::vector<rtcp::ReportBlock> report_blocks = CreateReportBlocks(now_us);
+  const bool sends_media = AppendSenderReports(report_blocks, now_us, sender);
+  if (!sends_media) {
+    rtcp::ReceiverReport receiver_report;
+    receiver_report.SetSenderSsrc(sender_ssrc);
+    receiver_report.SetReportBlocks(std::move(report_blocks));
+    sender->AppendPacket(receiver_report);
+  }
 
   if (!config_.cname.empty()) {
     rtcp::Sdes sdes;
@@ -374,22 +613,74 @@ void RtcpTransceiverImpl::CreateCompoundPacket(PacketSender* sender) {
     remb_->SetSenderSsrc(sender_ssrc);
     sender->AppendPacket(*remb_);
   }
-  // TODO(bugs.webrtc.org/8239): Do not send rrtr if this packet starts with
-  // SenderReport instead of ReceiverReport
-  // when RtcpTransceiver supports rtp senders.
-  if (config_.non_sender_rtt_measurement) {
-    rtcp::ExtendedReports xr;
+  for (uint32_t local_ssrc : pending_tmmbn_) {
+    rtcp::Tmmbn tmmbn;
+    tmmbn.SetSenderSsrc(local_ssrc);
+    for (const rtcp::TmmbItem& item : TmmbrBoundingSet(local_ssrc))
+      tmmbn.AddTmmbr(item);
+    sender->AppendPacket(tmmbn);
+  }
+  pending_tmmbn_.clear();
 
+  rtcp::ExtendedReports xr;
+  bool has_xr = false;
+  // A sender gets its rtt from the report blocks about it instead.
+  if (config_.non_sender_rtt_measurement && !sends_media) {
     rtcp::Rrtr rrtr;
     rrtr.SetNtp(TimeMicrosToNtp(now_us));
     xr.SetRrtr(rrtr);
-
+    has_xr = true;
+  }
+  for (auto& remote_sender : remote_senders_) {
+    rtc::Optional<RrtrTimes>& rrtr = remote_sender.second.last_received_rrtr;
+    if (!rrtr)
+      continue;
+    rtcp::ReceiveTimeInfo reply(
+        remote_sender.first, rrtr->remote_sent_time_compact_ntp,
+        SaturatedUsToCompactNtp(now_us - rrtr->local_received_time_us));
+    // The rest are replied to in the next compound packet.
+    if (!xr.AddDlrrItem(reply))
+      break;
+    rrtr = rtc::nullopt;
+    has_xr = true;
+  }
+  if (has_xr) {
     xr.SetSenderSsrc(sender_ssrc);
     sender->AppendPacket(xr);
   }
 }
 
+bool RtcpTransceiverImpl::AppendSenderReports(
+    std::vector<rtcp::ReportBlock> report_blocks,
+    int64_t now_us,
+    PacketSender* sender) {
+  bool appended = false;
+  const NtpTime now_ntp = TimeMicrosToNtp(now_us);
+  for (const auto& local_sender : local_senders_) {
+    RtpStreamRtcpHandler::RtpStats stats = local_sender.second->SentStats();
+    if (stats.num_sent_packets == 0)
+      continue;
+    // Extrapolate the rtp timestamp of the last frame to now.
+    uint32_t rtp_timestamp =
+        stats.last_rtp_timestamp +
+        static_cast<uint32_t>((now_us - stats.last_capture_time_us) *
+                              stats.clock_rate_hz / rtc::kNumMicrosecsPerSec);
+    rtcp::SenderReport sender_report;
+    sender_report.SetSenderSsrc(local_sender.first);
+    sender_report.SetNtp(now_ntp);
+    sender_report.SetRtpTimestamp(rtp_timestamp);
+    sender_report.SetPacketCount(stats.num_sent_packets);
+    sender_report.SetOctetCount(stats.num_sent_bytes);
+    if (!appended)
+      sender_report.SetReportBlocks(std::move(report_blocks));
+    sender->AppendPacket(sender_report);
+    appended = true;
+  }
+  return appended;
+}
+
 void RtcpTransceiverImpl::SendPeriodicCompoundPacket() {
+  ExpireTmmbrRequests(rtc::TimeMicros());
   auto send_packet = [this](rtc::ArrayView<const uint8_t> packet) {
     config_.outgoing_transport->SendRtcp(packet.data(), packet.size());
   };
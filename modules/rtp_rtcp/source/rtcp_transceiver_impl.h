@@ -11,8 +11,10 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTCP_TRANSCEIVER_IMPL_H_
 #define MODULES_RTP_RTCP_SOURCE_RTCP_TRANSCEIVER_IMPL_H_
 
+#include <map>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -22,7 +24,9 @@
 #include "modules/rtp_rtcp/source/rtcp_packet/dlrr.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/report_block.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/rrtr.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/target_bitrate.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/tmmb_item.h"
 #include "modules/rtp_rtcp/source/rtcp_transceiver_config.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/weak_ptr.h"
@@ -43,6 +47,12 @@ class RtcpTransceiverImpl {
   void RemoveMediaReceiverRtcpObserver(uint32_t remote_ssrc,
                                        MediaReceiverRtcpObserver* observer);
 
+  // Adds a local media sender, so that compound packets start with sender
+  // reports for it, and incoming feedback about it is passed to |handler|.
+  // Returns false if a sender with |local_ssrc| was already added.
+  bool AddMediaSender(uint32_t local_ssrc, RtpStreamRtcpHandler* handler);
+  bool RemoveMediaSender(uint32_t local_ssrc);
+
   void SetReadyToSend(bool ready);
 
   void ReceivePacket(rtc::ArrayView<const uint8_t> packet, int64_t now_us);
@@ -63,6 +73,10 @@ class RtcpTransceiverImpl {
  private:
   class PacketSender;
   struct RemoteSenderState;
+  struct TmmbrRequest {
+    rtcp::TmmbItem item;
+    int64_t received_time_us;
+  };
 
   void HandleReceivedPacket(const rtcp::CommonHeader& rtcp_packet_header,
                             int64_t now_us);
@@ -70,13 +84,31 @@ class RtcpTransceiverImpl {
   void HandleBye(const rtcp::CommonHeader& rtcp_packet_header);
   void HandleSenderReport(const rtcp::CommonHeader& rtcp_packet_header,
                           int64_t now_us);
+  void HandleReceiverReport(const rtcp::CommonHeader& rtcp_packet_header,
+                            int64_t now_us);
+  void HandleReportBlocks(uint32_t sender_ssrc,
+                          rtc::ArrayView<const rtcp::ReportBlock> report_blocks,
+                          int64_t now_us);
+  void HandleNack(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandlePli(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandleFir(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandleRemb(const rtcp::CommonHeader& rtcp_packet_header);
+  void HandleTmmbr(const rtcp::CommonHeader& rtcp_packet_header,
+                   int64_t now_us);
   void HandleExtendedReports(const rtcp::CommonHeader& rtcp_packet_header,
                              int64_t now_us);
   // Extended Reports blocks handlers.
+  void HandleRrtr(uint32_t sender_ssrc, const rtcp::Rrtr& rrtr, int64_t now_us);
   void HandleDlrr(const rtcp::Dlrr& dlrr, int64_t now_us);
   void HandleTargetBitrate(const rtcp::TargetBitrate& target_bitrate,
                            uint32_t remote_ssrc);
 
+  // Drops the TMMBR requests that weren't renewed in time.
+  void ExpireTmmbrRequests(int64_t now_us);
+  // Reports the lowest bitrate limit of the TMMBR bounding sets.
+  void ReportTmmbrBitrateLimit();
+  std::vector<rtcp::TmmbItem> TmmbrBoundingSet(uint32_t local_ssrc) const;
+
   void ReschedulePeriodicCompoundPackets();
   void SchedulePeriodicCompoundPackets(int64_t delay_ms);
   // Creates compound RTCP packet, as defined in
@@ -87,6 +119,11 @@ class RtcpTransceiverImpl {
   void SendImmediateFeedback(const rtcp::RtcpPacket& rtcp_packet);
   // Generate Report Blocks to be send in Sender or Receiver Report.
   std::vector<rtcp::ReportBlock> CreateReportBlocks(int64_t now_us);
+  // Appends sender reports for the local senders that have sent packets, the
+  // first one with |report_blocks|. Returns false if none was appended.
+  bool AppendSenderReports(std::vector<rtcp::ReportBlock> report_blocks,
+                           int64_t now_us,
+                           PacketSender* sender);
 
   const RtcpTransceiverConfig config_;
 
@@ -95,6 +132,12 @@ class RtcpTransceiverImpl {
   // TODO(danilchap): Remove entries from remote_senders_ that are no longer
   // needed.
   std::map<uint32_t, RemoteSenderState> remote_senders_;
+  std::map<uint32_t, RtpStreamRtcpHandler*> local_senders_;
+  // TMMBR requests about local senders, by local ssrc and then by the ssrc
+  // the request is for on the remote side.
+  std::map<uint32_t, std::map<uint32_t, TmmbrRequest>> tmmbr_requests_;
+  // Local senders to send a TMMBN for in the next compound packet.
+  std::set<uint32_t> pending_tmmbn_;
   rtc::WeakPtrFactory<RtcpTransceiverImpl> ptr_factory_;
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtcpTransceiverImpl);
@@ -14,10 +14,18 @@
 
 #include "api/video/video_bitrate_allocation.h"
 #include "modules/rtp_rtcp/include/receive_statistics.h"
+#include "modules/rtp_rtcp/mocks/mock_rtcp_bandwidth_observer.h"
 #include "modules/rtp_rtcp/mocks/mock_rtcp_rtt_stats.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/app.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/bye.h"
 #include "modules/rtp_rtcp/source/rtcp_packet/compound_packet.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/extended_reports.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/fir.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/nack.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/pli.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/receiver_report.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/remb.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/tmmbr.h"
 #include "modules/rtp_rtcp/source/time_util.h"
 #include "rtc_base/event.h"
 #include "rtc_base/fakeclock.h"
@@ -39,15 +47,18 @@ using ::testing::StrictMock;
 using ::webrtc::VideoBitrateAllocation;
 using ::webrtc::CompactNtp;
 using ::webrtc::CompactNtpRttToMs;
+using ::webrtc::MockRtcpBandwidthObserver;
 using ::webrtc::MockRtcpRttStats;
 using ::webrtc::MockTransport;
 using ::webrtc::NtpTime;
 using ::webrtc::RtcpTransceiverConfig;
 using ::webrtc::RtcpTransceiverImpl;
+using ::webrtc::RtpStreamRtcpHandler;
 using ::webrtc::SaturatedUsToCompactNtp;
 using ::webrtc::TimeMicrosToNtp;
 using ::webrtc::rtcp::Bye;
 using ::webrtc::rtcp::CompoundPacket;
+using ::webrtc::rtcp::ReceiverReport;
 using ::webrtc::rtcp::ReportBlock;
 using ::webrtc::rtcp::SenderReport;
 using ::webrtc::test::RtcpPacketParser;
@@ -57,6 +68,15 @@ class MockReceiveStatisticsProvider : public webrtc::ReceiveStatisticsProvider {
   MOCK_METHOD1(RtcpReportBlocks, std::vector<ReportBlock>(size_t));
 };
 
+class MockRtpStreamRtcpHandler : public webrtc::RtpStreamRtcpHandler {
+ public:
+  MOCK_METHOD0(SentStats, RtpStats());
+  MOCK_METHOD2(OnNack, void(uint32_t, rtc::ArrayView<const uint16_t>));
+  MOCK_METHOD1(OnPli, void(uint32_t));
+  MOCK_METHOD1(OnFir, void(uint32_t));
+  MOCK_METHOD2(OnReportBlock, void(uint32_t, const ReportBlock&));
+};
+
 class MockMediaReceiverRtcpObserver : public webrtc::MediaReceiverRtcpObserver {
  public:
   MOCK_METHOD3(OnSenderReport, void(uint32_t, NtpTime, uint32_t));
@@ -979,4 +999,255 @@ TEST(RtcpTransceiverImplTest, IgnoresUnknownSsrcInDlrr) {
   rtcp_transceiver.ReceivePacket(raw_packet, time_us + 100000);
 }
 
+TEST(RtcpTransceiverImplTest, SendsSenderReportForMediaSender) {
+  const uint32_t kFeedbackSsrc = 1234;
+  const uint32_t kLocalSsrc = 4321;
+  const uint32_t kRemoteSsrc = 5678;
+  rtc::ScopedFakeClock clock;
+  clock.SetTimeMicros(10000000);
+  MockReceiveStatisticsProvider receive_statistics;
+  std::vector<ReportBlock> report_blocks(1);
+  report_blocks[0].SetMediaSsrc(kRemoteSsrc);
+  EXPECT_CALL(receive_statistics, RtcpReportBlocks(_))
+      .WillRepeatedly(Return(report_blocks));
+  StrictMock<MockRtpStreamRtcpHandler> media_sender;
+  RtpStreamRtcpHandler::RtpStats stats;
+  stats.num_sent_packets = 10;
+  stats.num_sent_bytes = 12000;
+  stats.last_rtp_timestamp = 90000;
+  // Captured 20ms ago.
+  stats.last_capture_time_us = rtc::TimeMicros() - 20000;
+  stats.clock_rate_hz = 90000;
+  EXPECT_CALL(media_sender, SentStats()).WillOnce(Return(stats));
+
+  RtcpTransceiverConfig config;
+  config.feedback_ssrc = kFeedbackSsrc;
+  config.schedule_periodic_compound_packets = false;
+  config.receive_statistics = &receive_statistics;
+  config.non_sender_rtt_measurement = true;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  EXPECT_TRUE(rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender));
+  EXPECT_FALSE(rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender));
+
+  rtcp_transceiver.SendCompoundPacket();
+
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 0);
+  ASSERT_EQ(rtcp_parser.sender_report()->num_packets(), 1);
+  const SenderReport& sender_report = *rtcp_parser.sender_report();
+  EXPECT_EQ(sender_report.sender_ssrc(), kLocalSsrc);
+  EXPECT_EQ(sender_report.ntp(), TimeMicrosToNtp(rtc::TimeMicros()));
+  EXPECT_EQ(sender_report.rtp_timestamp(), 90000u + 20 * 90);
+  EXPECT_EQ(sender_report.sender_packet_count(), 10u);
+  EXPECT_EQ(sender_report.sender_octet_count(), 12000u);
+  ASSERT_THAT(sender_report.report_blocks(), SizeIs(1));
+  EXPECT_EQ(sender_report.report_blocks()[0].source_ssrc(), kRemoteSsrc);
+  // A media sender measures rtt from the report blocks instead of with rrtr.
+  EXPECT_FALSE(rtcp_parser.xr()->rrtr());
+}
+
+TEST(RtcpTransceiverImplTest, SendsReceiverReportUntilMediaSenderHasSent) {
+  const uint32_t kLocalSsrc = 4321;
+  StrictMock<MockRtpStreamRtcpHandler> media_sender;
+  EXPECT_CALL(media_sender, SentStats())
+      .WillOnce(Return(RtpStreamRtcpHandler::RtpStats()));
+  RtcpTransceiverConfig config;
+  config.schedule_periodic_compound_packets = false;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender);
+
+  rtcp_transceiver.SendCompoundPacket();
+  EXPECT_EQ(rtcp_parser.sender_report()->num_packets(), 0);
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 1);
+
+  // No stats are requested after the sender is removed.
+  EXPECT_TRUE(rtcp_transceiver.RemoveMediaSender(kLocalSsrc));
+  EXPECT_FALSE(rtcp_transceiver.RemoveMediaSender(kLocalSsrc));
+  rtcp_transceiver.SendCompoundPacket();
+  EXPECT_EQ(rtcp_parser.receiver_report()->num_packets(), 2);
+}
+
+TEST(RtcpTransceiverImplTest, PassesFeedbackForMediaSenderToHandler) {
+  const uint32_t kLocalSsrc = 4321;
+  const uint32_t kOtherSsrc = 4322;
+  const uint32_t kRemoteSsrc = 5678;
+  StrictMock<MockRtpStreamRtcpHandler> media_sender;
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender);
+
+  webrtc::rtcp::Nack nack;
+  nack.SetSenderSsrc(kRemoteSsrc);
+  nack.SetMediaSsrc(kLocalSsrc);
+  nack.SetPacketIds({10, 12});
+  webrtc::rtcp::Nack other_nack;
+  other_nack.SetSenderSsrc(kRemoteSsrc);
+  other_nack.SetMediaSsrc(kOtherSsrc);
+  other_nack.SetPacketIds({20});
+  webrtc::rtcp::Pli pli;
+  pli.SetSenderSsrc(kRemoteSsrc);
+  pli.SetMediaSsrc(kLocalSsrc);
+  webrtc::rtcp::Fir fir;
+  fir.SetSenderSsrc(kRemoteSsrc);
+  fir.AddRequestTo(kOtherSsrc, 1);
+  fir.AddRequestTo(kLocalSsrc, 2);
+  CompoundPacket compound;
+  compound.Append(&nack);
+  compound.Append(&other_nack);
+  compound.Append(&pli);
+  compound.Append(&fir);
+  auto raw_packet = compound.Build();
+
+  EXPECT_CALL(media_sender, OnNack(kRemoteSsrc, ElementsAre(10, 12)));
+  EXPECT_CALL(media_sender, OnPli(kRemoteSsrc));
+  EXPECT_CALL(media_sender, OnFir(kRemoteSsrc));
+  rtcp_transceiver.ReceivePacket(raw_packet, /*now_us=*/0);
+}
+
+TEST(RtcpTransceiverImplTest, CalculatesRoundTripTimeOnReportBlock) {
+  const uint32_t kLocalSsrc = 4321;
+  const uint32_t kRemoteSsrc = 5678;
+  StrictMock<MockRtpStreamRtcpHandler> media_sender;
+  MockRtcpRttStats rtt_observer;
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  config.rtt_observer = &rtt_observer;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender);
+
+  int64_t time_us = 12345678;
+  ReportBlock report_block;
+  report_block.SetMediaSsrc(kLocalSsrc);
+  report_block.SetLastSr(CompactNtp(TimeMicrosToNtp(time_us)));
+  report_block.SetDelayLastSr(SaturatedUsToCompactNtp(10 * 1000));
+  ReceiverReport receiver_report;
+  receiver_report.SetSenderSsrc(kRemoteSsrc);
+  receiver_report.AddReportBlock(report_block);
+  auto raw_packet = receiver_report.Build();
+
+  EXPECT_CALL(media_sender, OnReportBlock(kRemoteSsrc, _));
+  EXPECT_CALL(rtt_observer, OnRttUpdate(100 /* rtt_ms */));
+  rtcp_transceiver.ReceivePacket(raw_packet, time_us + 110 * 1000);
+}
+
+TEST(RtcpTransceiverImplTest, RepliesToRrtrWithDlrr) {
+  const uint32_t kFeedbackSsrc = 1234;
+  const uint32_t kRemoteSsrc = 5678;
+  RtcpTransceiverConfig config;
+  config.feedback_ssrc = kFeedbackSsrc;
+  config.schedule_periodic_compound_packets = false;
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+
+  const NtpTime kRemoteNtp(0x11223344, 0x55667788);
+  webrtc::rtcp::Rrtr rrtr;
+  rrtr.SetNtp(kRemoteNtp);
+  webrtc::rtcp::ExtendedReports xr;
+  xr.SetSenderSsrc(kRemoteSsrc);
+  xr.SetRrtr(rrtr);
+  auto raw_packet = xr.Build();
+  rtc::ScopedFakeClock clock;
+  clock.SetTimeMicros(10000000);
+  rtcp_transceiver.ReceivePacket(raw_packet, rtc::TimeMicros());
+  clock.AdvanceTimeMicros(50000);
+
+  rtcp_transceiver.SendCompoundPacket();
+
+  ASSERT_EQ(rtcp_parser.xr()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.xr()->sender_ssrc(), kFeedbackSsrc);
+  ASSERT_THAT(rtcp_parser.xr()->dlrr().sub_blocks(), SizeIs(1));
+  const webrtc::rtcp::ReceiveTimeInfo& reply =
+      rtcp_parser.xr()->dlrr().sub_blocks()[0];
+  EXPECT_EQ(reply.ssrc, kRemoteSsrc);
+  EXPECT_EQ(reply.last_rr, CompactNtp(kRemoteNtp));
+  EXPECT_EQ(CompactNtpRttToMs(reply.delay_since_last_rr), 50);
+
+  // Each rrtr is replied to once.
+  rtcp_transceiver.SendCompoundPacket();
+  EXPECT_EQ(rtcp_parser.xr()->num_packets(), 1);
+}
+
+TEST(RtcpTransceiverImplTest, PassesIncomingRembToBandwidthObserver) {
+  MockRtcpBandwidthObserver bandwidth_observer;
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  config.bandwidth_observer = &bandwidth_observer;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+
+  webrtc::rtcp::Remb remb;
+  remb.SetSenderSsrc(5678);
+  remb.SetSsrcs({4321});
+  remb.SetBitrateBps(250000);
+  auto raw_packet = remb.Build();
+
+  EXPECT_CALL(bandwidth_observer, OnReceivedEstimatedBitrate(250000));
+  rtcp_transceiver.ReceivePacket(raw_packet, /*now_us=*/0);
+}
+
+TEST(RtcpTransceiverImplTest, RepliesToTmmbrForMediaSenderWithTmmbn) {
+  const uint32_t kLocalSsrc = 4321;
+  const uint32_t kOtherSsrc = 4322;
+  const uint32_t kRemoteSsrc = 5678;
+  MockRtpStreamRtcpHandler media_sender;
+  MockRtcpBandwidthObserver bandwidth_observer;
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  config.bandwidth_observer = &bandwidth_observer;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender);
+
+  webrtc::rtcp::Tmmbr tmmbr;
+  tmmbr.SetSenderSsrc(kRemoteSsrc);
+  tmmbr.AddTmmbr(webrtc::rtcp::TmmbItem(kOtherSsrc, 100000, 40));
+  tmmbr.AddTmmbr(webrtc::rtcp::TmmbItem(kLocalSsrc, 300000, 40));
+  auto raw_packet = tmmbr.Build();
+
+  EXPECT_CALL(bandwidth_observer, OnReceivedEstimatedBitrate(300000));
+  rtcp_transceiver.ReceivePacket(raw_packet, rtc::TimeMicros());
+
+  ASSERT_EQ(rtcp_parser.tmmbn()->num_packets(), 1);
+  EXPECT_EQ(rtcp_parser.tmmbn()->sender_ssrc(), kLocalSsrc);
+  ASSERT_THAT(rtcp_parser.tmmbn()->items(), SizeIs(1));
+  EXPECT_EQ(rtcp_parser.tmmbn()->items()[0].ssrc(), kRemoteSsrc);
+  EXPECT_EQ(rtcp_parser.tmmbn()->items()[0].bitrate_bps(), 300000u);
+}
+
+TEST(RtcpTransceiverImplTest, DropsTmmbrRequestsThatAreNotRenewed) {
+  const uint32_t kLocalSsrc = 4321;
+  const uint32_t kRemoteSsrc = 5678;
+  MockRtpStreamRtcpHandler media_sender;
+  RtcpTransceiverConfig config = DefaultTestConfig();
+  RtcpPacketParser rtcp_parser;
+  RtcpParserTransport transport(&rtcp_parser);
+  config.outgoing_transport = &transport;
+  RtcpTransceiverImpl rtcp_transceiver(config);
+  rtcp_transceiver.AddMediaSender(kLocalSsrc, &media_sender);
+  rtc::ScopedFakeClock clock;
+  clock.SetTimeMicros(10000000);
+
+  webrtc::rtcp::Tmmbr tmmbr;
+  tmmbr.SetSenderSsrc(kRemoteSsrc);
+  tmmbr.AddTmmbr(webrtc::rtcp::TmmbItem(kLocalSsrc, 300000, 40));
+  auto raw_packet = tmmbr.Build();
+  rtcp_transceiver.ReceivePacket(raw_packet, rtc::TimeMicros());
+  ASSERT_EQ(rtcp_parser.tmmbn()->num_packets(), 1);
+
+  // Still valid after 20 seconds, so no new TMMBN is sent.
+  clock.AdvanceTimeMicros(20 * rtc::kNumMicrosecsPerSec);
+  rtcp_transceiver.SendCompoundPacket();
+  EXPECT_EQ(rtcp_parser.tmmbn()->num_packets(), 1);
+
+  clock.AdvanceTimeMicros(10 * rtc::kNumMicrosecsPerSec);
+  rtcp_transceiver.SendCompoundPacket();
+  EXPECT_EQ(rtcp_parser.tmmbn()->num_packets(), 2);
+  EXPECT_THAT(rtcp_parser.tmmbn()->items(), SizeIs(0));
+}
+
 }  // namespace
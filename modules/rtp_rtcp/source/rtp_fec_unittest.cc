@@ -9,6 +9,7 @@
  */
 
 #include <algorithm>
+#include <iterator>
 #include <list>
 #include <memory>
 
@@ -647,6 +648,61 @@ TYPED_TEST(RtpFecTest, FecRecoveryWithFecOutOfOrder) {
   EXPECT_TRUE(this->IsRecoveryComplete());
 }
 
+// Verify that media packets arriving after the FEC packets trigger recovery
+// through FEC packets that each become recoverable in turn.
+TYPED_TEST(RtpFecTest, FecRecoveryWithFecBeforeMediaChained) {
+  constexpr int kNumImportantPackets = 0;
+  constexpr bool kUseUnequalProtection = false;
+  constexpr int kNumMediaPackets = 4;
+  constexpr uint8_t kProtectionFactor = 255;
+
+  // Packet Mask for (4,4,0) code, from random mask table.
+  // (kNumMediaPackets = 4; num_fec_packets = 4, kNumImportantPackets = 0)
+
+  //         media#0   media#1  media#2    media#3
+  // fec#0:    1          1        0          0
+  // fec#1:    1          0        1          0
+  // fec#2:    0          0        1          1
+  // fec#3:    0          1        0          1
+  //
+
+  this->media_packets_ =
+      this->media_packet_generator_.ConstructMediaPackets(kNumMediaPackets);
+
+  EXPECT_EQ(
+      0, this->fec_.EncodeFec(this->media_packets_, kProtectionFactor,
+                              kNumImportantPackets, kUseUnequalProtection,
+                              kFecMaskRandom, &this->generated_fec_packets_));
+
+  // Expect 4 FEC packets.
+  EXPECT_EQ(4u, this->generated_fec_packets_.size());
+
+  // Lose FEC packet #0 and media packets #0, #2 and #3.
+  memset(this->media_loss_mask_, 0, sizeof(this->media_loss_mask_));
+  memset(this->fec_loss_mask_, 0, sizeof(this->fec_loss_mask_));
+  this->fec_loss_mask_[0] = 1;
+  this->media_loss_mask_[0] = 1;
+  this->media_loss_mask_[2] = 1;
+  this->media_loss_mask_[3] = 1;
+  // Add FEC packets to received list before the media packet.
+  this->ReceivedPackets(this->generated_fec_packets_, this->fec_loss_mask_,
+                        true);
+  this->ReceivedPackets(this->media_packets_, this->media_loss_mask_, false);
+
+  auto media_it = std::prev(this->received_packets_.end());
+  for (auto it = this->received_packets_.begin(); it != media_it; ++it) {
+    this->fec_.DecodeFec(**it, &this->recovered_packets_);
+  }
+  // No FEC packet can recover anything on its own.
+  EXPECT_TRUE(this->recovered_packets_.empty());
+
+  // Media packet #1 lets FEC packet #3 recover media packet #3, which lets
+  // FEC packet #2 recover media packet #2, which in turn lets FEC packet #1
+  // recover media packet #0.
+  this->fec_.DecodeFec(**media_it, &this->recovered_packets_);
+  EXPECT_TRUE(this->IsRecoveryComplete());
+}
+
 // Test 50% protection with random mask type: Two cases are considered:
 // a 50% non-consecutive loss which can be fully recovered, and a 50%
 // consecutive loss which cannot be fully recovered.
@@ -10,7 +10,9 @@
 
 #include "modules/rtp_rtcp/source/rtp_packet.h"
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <utility>
 
 #include "common_types.h"  // NOLINT(build/include)
@@ -19,6 +21,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/numerics/safe_conversions.h"
+#include "rtc_base/packetbufferallocator.h"
 #include "rtc_base/random.h"
 
 namespace webrtc {
@@ -64,7 +67,7 @@ RtpPacket::RtpPacket(const ExtensionManager* extensions)
 RtpPacket::RtpPacket(const RtpPacket&) = default;
 
 RtpPacket::RtpPacket(const ExtensionManager* extensions, size_t capacity)
-    : buffer_(capacity) {
+    : buffer_(rtc::PacketBufferAllocator::Allocate(capacity)) {
   RTC_DCHECK_GE(capacity, kFixedHeaderSize);
   Clear();
   if (extensions) {
@@ -72,14 +75,22 @@ RtpPacket::RtpPacket(const ExtensionManager* extensions, size_t capacity)
   } else {
     for (size_t i = 0; i < kMaxExtensionHeaders; ++i)
       extension_entries_[i].type = ExtensionManager::kInvalidType;
+    std::fill(std::begin(extension_ids_), std::end(extension_ids_),
+              ExtensionManager::kInvalidId);
   }
 }
 
 RtpPacket::~RtpPacket() {}
 
 void RtpPacket::IdentifyExtensions(const ExtensionManager& extensions) {
-  for (int i = 0; i < kMaxExtensionHeaders; ++i)
-    extension_entries_[i].type = extensions.GetType(i + 1);
+  std::fill(std::begin(extension_ids_), std::end(extension_ids_),
+            ExtensionManager::kInvalidId);
+  for (int i = 0; i < kMaxExtensionHeaders; ++i) {
+    ExtensionType type = extensions.GetType(i + 1);
+    extension_entries_[i].type = type;
+    if (type != ExtensionManager::kInvalidType)
+      extension_ids_[type] = i + 1;
+  }
 }
 
 bool RtpPacket::Parse(const uint8_t* buffer, size_t buffer_size) {
@@ -198,7 +209,10 @@ void RtpPacket::CopyHeaderFrom(const RtpPacket& packet) {
   for (size_t i = 0; i < kMaxExtensionHeaders; ++i) {
     extension_entries_[i] = packet.extension_entries_[i];
   }
+  std::copy(std::begin(packet.extension_ids_), std::end(packet.extension_ids_),
+            std::begin(extension_ids_));
   extensions_size_ = packet.extensions_size_;
+  extensions_pending_ = packet.extensions_pending_;
   buffer_.SetData(packet.data(), packet.headers_size());
   // Reset payload and padding.
   payload_size_ = 0;
@@ -237,6 +251,7 @@ void RtpPacket::SetSsrc(uint32_t ssrc) {
 
 void RtpPacket::SetCsrcs(const std::vector<uint32_t>& csrcs) {
   RTC_DCHECK_EQ(extensions_size_, 0);
+  RTC_DCHECK(!extensions_pending_);
   RTC_DCHECK_EQ(payload_size_, 0);
   RTC_DCHECK_EQ(padding_size_, 0);
   RTC_DCHECK_LE(csrcs.size(), 0x0fu);
@@ -256,6 +271,7 @@ bool RtpPacket::HasRawExtension(int id) const {
     return false;
   RTC_DCHECK_GE(id, kMinExtensionId);
   RTC_DCHECK_LE(id, kMaxExtensionId);
+  ParseExtensionsIfPending();
   return extension_entries_[id - 1].offset != 0;
 }
 
@@ -264,6 +280,7 @@ rtc::ArrayView<const uint8_t> RtpPacket::GetRawExtension(int id) const {
     return nullptr;
   RTC_DCHECK_GE(id, kMinExtensionId);
   RTC_DCHECK_LE(id, kMaxExtensionId);
+  ParseExtensionsIfPending();
   const ExtensionInfo& extension = extension_entries_[id - 1];
   if (extension.offset == 0)
     return nullptr;
@@ -286,6 +303,7 @@ rtc::ArrayView<uint8_t> RtpPacket::AllocateRawExtension(int id, size_t length) {
   RTC_DCHECK_LE(id, kMaxExtensionId);
   RTC_DCHECK_GE(length, 1);
   RTC_DCHECK_LE(length, 16);
+  ParseExtensionsIfPending();
 
   ExtensionInfo* extension_entry = &extension_entries_[id - 1];
   if (extension_entry->offset != 0) {
@@ -404,6 +422,7 @@ void RtpPacket::Clear() {
   payload_size_ = 0;
   padding_size_ = 0;
   extensions_size_ = 0;
+  extensions_pending_ = false;
   for (ExtensionInfo& location : extension_entries_) {
     location.offset = 0;
     location.length = 0;
@@ -447,6 +466,7 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
   }
 
   extensions_size_ = 0;
+  extensions_pending_ = false;
   for (ExtensionInfo& location : extension_entries_) {
     location.offset = 0;
     location.length = 0;
@@ -476,40 +496,8 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
     if (profile != kOneByteExtensionId) {
       RTC_LOG(LS_WARNING) << "Unsupported rtp extension " << profile;
     } else {
-      constexpr uint8_t kPaddingId = 0;
-      constexpr uint8_t kReservedId = 15;
-      while (extensions_size_ + kOneByteHeaderSize < extensions_capacity) {
-        int id = buffer[extension_offset + extensions_size_] >> 4;
-        if (id == kReservedId) {
-          break;
-        } else if (id == kPaddingId) {
-          extensions_size_++;
-          continue;
-        }
-        uint8_t length =
-            1 + (buffer[extension_offset + extensions_size_] & 0xf);
-        if (extensions_size_ + kOneByteHeaderSize + length >
-            extensions_capacity) {
-          RTC_LOG(LS_WARNING) << "Oversized rtp header extension.";
-          break;
-        }
-
-        size_t idx = id - 1;
-        if (extension_entries_[idx].length != 0) {
-          RTC_LOG(LS_VERBOSE)
-              << "Duplicate rtp header extension id " << id << ". Overwriting.";
-        }
-
-        size_t offset =
-            extension_offset + extensions_size_ + kOneByteHeaderSize;
-        if (!rtc::IsValueInRangeForNumericType<uint16_t>(offset)) {
-          RTC_DLOG(LS_WARNING) << "Oversized rtp header extension.";
-          break;
-        }
-        extension_entries_[idx].offset = static_cast<uint16_t>(offset);
-        extension_entries_[idx].length = length;
-        extensions_size_ += kOneByteHeaderSize + length;
-      }
+      // Look up the individual extensions when first needed.
+      extensions_pending_ = true;
     }
     payload_offset_ = extension_offset + extensions_capacity;
   }
@@ -521,30 +509,75 @@ bool RtpPacket::ParseBuffer(const uint8_t* buffer, size_t size) {
   return true;
 }
 
+void RtpPacket::ParseExtensions() const {
+  RTC_DCHECK(extensions_pending_);
+  extensions_pending_ = false;
+  // ParseBuffer has checked that the extension block fits in the packet.
+  const uint8_t* buffer = data();
+  const uint8_t number_of_crcs = buffer[0] & 0x0f;
+  const size_t extension_offset = kFixedHeaderSize + number_of_crcs * 4 + 4;
+  const size_t extensions_capacity =
+      ByteReader<uint16_t>::ReadBigEndian(&buffer[extension_offset - 2]) * 4;
+
+  constexpr uint8_t kPaddingId = 0;
+  constexpr uint8_t kReservedId = 15;
+  while (extensions_size_ + kOneByteHeaderSize < extensions_capacity) {
+    int id = buffer[extension_offset + extensions_size_] >> 4;
+    if (id == kReservedId) {
+      break;
+    } else if (id == kPaddingId) {
+      extensions_size_++;
+      continue;
+    }
+    uint8_t length = 1 + (buffer[extension_offset + extensions_size_] & 0xf);
+    if (extensions_size_ + kOneByteHeaderSize + length > extensions_capacity) {
+      RTC_LOG(LS_WARNING) << "Oversized rtp header extension.";
+      break;
+    }
+
+    size_t idx = id - 1;
+    if (extension_entries_[idx].length != 0) {
+      RTC_LOG(LS_VERBOSE) << "Duplicate rtp header extension id " << id
+                          << ". Overwriting.";
+    }
+
+    size_t offset = extension_offset + extensions_size_ + kOneByteHeaderSize;
+    if (!rtc::IsValueInRangeForNumericType<uint16_t>(offset)) {
+      RTC_DLOG(LS_WARNING) << "Oversized rtp header extension.";
+      break;
+    }
+    extension_entries_[idx].offset = static_cast<uint16_t>(offset);
+    extension_entries_[idx].length = length;
+    extensions_size_ += kOneByteHeaderSize + length;
+  }
+}
+
 rtc::ArrayView<const uint8_t> RtpPacket::FindExtension(
     ExtensionType type) const {
-  for (const ExtensionInfo& extension : extension_entries_) {
-    if (extension.type == type) {
-      if (extension.length == 0) {
-        // Extension is registered but not set.
-        return nullptr;
-      }
-      return rtc::MakeArrayView(data() + extension.offset, extension.length);
-    }
+  RTC_DCHECK_LT(type, kRtpExtensionNumberOfExtensions);
+  int id = extension_ids_[type];
+  if (id == ExtensionManager::kInvalidId) {
+    // Extension not registered.
+    return nullptr;
+  }
+  ParseExtensionsIfPending();
+  const ExtensionInfo& extension = extension_entries_[id - 1];
+  if (extension.length == 0) {
+    // Extension is registered but not set.
+    return nullptr;
   }
-  return nullptr;
+  return rtc::MakeArrayView(data() + extension.offset, extension.length);
 }
 
 rtc::ArrayView<uint8_t> RtpPacket::AllocateExtension(ExtensionType type,
                                                      size_t length) {
-  for (int i = 0; i < kMaxExtensionHeaders; ++i) {
-    if (extension_entries_[i].type == type) {
-      int extension_id = i + 1;
-      return AllocateRawExtension(extension_id, length);
-    }
+  RTC_DCHECK_LT(type, kRtpExtensionNumberOfExtensions);
+  int id = extension_ids_[type];
+  if (id == ExtensionManager::kInvalidId) {
+    // Extension not registered.
+    return nullptr;
   }
-  // Extension not registered.
-  return nullptr;
+  return AllocateRawExtension(id, length);
 }
 
 uint8_t* RtpPacket::WriteAt(size_t offset) {
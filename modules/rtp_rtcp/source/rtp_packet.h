@@ -41,6 +41,11 @@ class RtpPacket {
   RtpPacket& operator=(const RtpPacket&) = default;
 
   // Parse and copy given buffer into Packet.
+  // The header extension block is only validated by Parse. The offsets of the
+  // individual extensions are looked up on the first access to any of them,
+  // so packets whose extensions are never read don't pay for it. Because of
+  // that, const accessors of extensions are not safe to call concurrently on
+  // the same packet.
   bool Parse(const uint8_t* buffer, size_t size);
   bool Parse(rtc::ArrayView<const uint8_t> packet);
 
@@ -134,6 +139,14 @@ class RtpPacket {
   // but does not touch packet own buffer, leaving packet in invalid state.
   bool ParseBuffer(const uint8_t* buffer, size_t size);
 
+  // Fills |extension_entries_| from the one-byte header extension block found
+  // by ParseBuffer, unless already done.
+  void ParseExtensionsIfPending() const {
+    if (extensions_pending_)
+      ParseExtensions();
+  }
+  void ParseExtensions() const;
+
   // Find an extension |type|.
   // Returns view of the raw extension or empty view on failure.
   rtc::ArrayView<const uint8_t> FindExtension(ExtensionType type) const;
@@ -155,8 +168,13 @@ class RtpPacket {
   size_t payload_offset_;  // Match header size with csrcs and extensions.
   size_t payload_size_;
 
-  ExtensionInfo extension_entries_[kMaxExtensionHeaders];
-  size_t extensions_size_ = 0;  // Unaligned.
+  // Indexed by extension id - 1. Filled lazily for parsed packets, see
+  // ParseExtensionsIfPending().
+  mutable ExtensionInfo extension_entries_[kMaxExtensionHeaders];
+  mutable size_t extensions_size_ = 0;  // Unaligned.
+  mutable bool extensions_pending_ = false;
+  // Id of each registered extension type, or ExtensionManager::kInvalidId.
+  uint8_t extension_ids_[kRtpExtensionNumberOfExtensions];
   rtc::CopyOnWriteBuffer buffer_;
 };
 
@@ -11,9 +11,10 @@
 #include "modules/rtp_rtcp/source/rtp_packet_history.h"
 
 #include <algorithm>
-#include <limits>
+#include <iterator>
 #include <utility>
 
+#include "modules/include/module_common_types_public.h"
 #include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -25,15 +26,18 @@ namespace {
 // Min packet size for BestFittingPacket() to honor.
 constexpr size_t kMinPacketRequestBytes = 50;
 
-// Utility function to get the absolute difference in size between the provided
-// target size and the size of packet.
-size_t SizeDiff(const std::unique_ptr<RtpPacketToSend>& packet, size_t size) {
-  size_t packet_size = packet->size();
-  if (packet_size > size) {
-    return packet_size - size;
-  }
-  return size - packet_size;
-}
+// Bounds of the ring buffer size. The maximum is the smallest power of two
+// that can hold kMaxCapacity packets.
+constexpr size_t kMinRingSize = 64;
+constexpr size_t kMaxRingSize = 16384;
+static_assert(kMaxRingSize >= RtpPacketHistory::kMaxCapacity,
+              "Ring buffer can't hold the max capacity.");
+static_assert((kMaxRingSize & (kMaxRingSize - 1)) == 0,
+              "Ring buffer size must be a power of two.");
+
+// Approximate size of a node in the std::set size index.
+constexpr size_t kSizeIndexNodeBytes =
+    sizeof(std::pair<size_t, uint16_t>) + 4 * sizeof(void*);
 }  // namespace
 
 constexpr size_t RtpPacketHistory::kMaxCapacity;
@@ -55,7 +59,10 @@ RtpPacketHistory::RtpPacketHistory(Clock* clock)
     : clock_(clock),
       number_to_store_(0),
       mode_(StorageMode::kDisabled),
-      rtt_ms_(-1) {}
+      rtt_ms_(-1),
+      num_packets_(0),
+      start_seqno_(0),
+      window_size_(0) {}
 
 RtpPacketHistory::~RtpPacketHistory() {}
 
@@ -96,20 +103,27 @@ void RtpPacketHistory::PutRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
 
   // Store packet.
   const uint16_t rtp_seq_no = packet->SequenceNumber();
-  StoredPacket& stored_packet = packet_history_[rtp_seq_no];
-  RTC_DCHECK(stored_packet.packet == nullptr);
-  stored_packet.packet = std::move(packet);
-
-  if (stored_packet.packet->capture_time_ms() <= 0) {
-    stored_packet.packet->set_capture_time_ms(now_ms);
+  if (StoredPacket* existing_packet = FindPacket(rtp_seq_no)) {
+    RTC_NOTREACHED() << "Sequence number " << rtp_seq_no << " already stored.";
+    RemovePacket(existing_packet);
   }
-  stored_packet.send_time_ms = send_time_ms;
-  stored_packet.storage_type = type;
-  stored_packet.times_retransmitted = 0;
+  StoredPacket* stored_packet = AllocateSlot(rtp_seq_no);
+  if (!stored_packet) {
+    RTC_LOG(LS_WARNING) << "Not storing packet " << rtp_seq_no
+                        << ", too old for the history.";
+    return;
+  }
+  stored_packet->packet = std::move(packet);
 
-  if (!start_seqno_) {
-    start_seqno_ = rtp_seq_no;
+  if (stored_packet->packet->capture_time_ms() <= 0) {
+    stored_packet->packet->set_capture_time_ms(now_ms);
   }
+  stored_packet->send_time_ms = send_time_ms;
+  stored_packet->storage_type = type;
+  stored_packet->times_retransmitted = 0;
+
+  packets_by_size_.emplace(stored_packet->packet->size(), rtp_seq_no);
+  ++num_packets_;
 }
 
 std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
@@ -121,29 +135,46 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetPacketAndSetSendTime(
   }
 
   int64_t now_ms = clock_->TimeInMilliseconds();
-  StoredPacketIterator rtp_it = packet_history_.find(sequence_number);
-  if (rtp_it == packet_history_.end()) {
+  StoredPacket* packet = FindPacket(sequence_number);
+  if (!packet) {
     return nullptr;
   }
 
-  StoredPacket& packet = rtp_it->second;
-  if (verify_rtt && !VerifyRtt(rtp_it->second, now_ms)) {
+  if (verify_rtt && !VerifyRtt(*packet, now_ms)) {
     return nullptr;
   }
 
-  if (packet.send_time_ms) {
-    ++packet.times_retransmitted;
+  if (packet->send_time_ms) {
+    ++packet->times_retransmitted;
   }
 
-  // Update send-time and return copy of packet instance.
-  packet.send_time_ms = now_ms;
+  // Update send-time and return copy of packet instance. The copy shares the
+  // payload buffer with the stored packet.
+  packet->send_time_ms = now_ms;
 
-  if (packet.storage_type == StorageType::kDontRetransmit) {
+  if (packet->storage_type == StorageType::kDontRetransmit) {
     // Non retransmittable packet, so call must come from paced sender.
     // Remove from history and return actual packet instance.
-    return RemovePacket(rtp_it);
+    return RemovePacket(packet);
   }
-  return rtc::MakeUnique<RtpPacketToSend>(*packet.packet);
+  return rtc::MakeUnique<RtpPacketToSend>(*packet->packet);
+}
+
+std::unique_ptr<RtpPacketToSend> RtpPacketHistory::TakeUnsentPacket(
+    uint16_t sequence_number,
+    StorageType* storage) {
+  RTC_DCHECK(storage);
+  rtc::CritScope cs(&lock_);
+  if (mode_ == StorageMode::kDisabled) {
+    return nullptr;
+  }
+
+  StoredPacket* packet = FindPacket(sequence_number);
+  if (!packet || packet->send_time_ms) {
+    return nullptr;
+  }
+  *storage = packet->storage_type;
+  return RemovePacket(packet);
 }
 
 rtc::Optional<RtpPacketHistory::PacketState> RtpPacketHistory::GetPacketState(
@@ -154,16 +185,16 @@ rtc::Optional<RtpPacketHistory::PacketState> RtpPacketHistory::GetPacketState(
     return rtc::nullopt;
   }
 
-  auto rtp_it = packet_history_.find(sequence_number);
-  if (rtp_it == packet_history_.end()) {
+  const StoredPacket* packet = FindPacket(sequence_number);
+  if (!packet) {
     return rtc::nullopt;
   }
 
-  if (verify_rtt && !VerifyRtt(rtp_it->second, clock_->TimeInMilliseconds())) {
+  if (verify_rtt && !VerifyRtt(*packet, clock_->TimeInMilliseconds())) {
     return rtc::nullopt;
   }
 
-  return StoredPacketToPacketState(rtp_it->second);
+  return StoredPacketToPacketState(*packet);
 }
 
 bool RtpPacketHistory::VerifyRtt(const RtpPacketHistory::StoredPacket& packet,
@@ -186,64 +217,100 @@ std::unique_ptr<RtpPacketToSend> RtpPacketHistory::GetBestFittingPacket(
     size_t packet_length) const {
   // TODO(sprang): Make this smarter, taking retransmit count etc into account.
   rtc::CritScope cs(&lock_);
-  if (packet_length < kMinPacketRequestBytes || packet_history_.empty()) {
+  if (packet_length < kMinPacketRequestBytes || num_packets_ == 0) {
     return nullptr;
   }
 
-  size_t min_diff = std::numeric_limits<size_t>::max();
-  RtpPacketToSend* best_packet = nullptr;
-  for (auto& it : packet_history_) {
-    size_t diff = SizeDiff(it.second.packet, packet_length);
-    if (!min_diff || diff < min_diff) {
-      min_diff = diff;
-      best_packet = it.second.packet.get();
-      if (diff == 0) {
-        break;
-      }
+  // The best fit is either the smallest packet of at least |packet_length|
+  // bytes, or the largest one below that. Prefer the smaller one on a tie, and
+  // the oldest one of equal size.
+  auto best_it = packets_by_size_.lower_bound(std::make_pair(packet_length, 0));
+  size_t best_size;
+  if (best_it == packets_by_size_.end() ||
+      (best_it != packets_by_size_.begin() &&
+       packet_length - std::prev(best_it)->first <=
+           best_it->first - packet_length)) {
+    best_size = std::prev(best_it)->first;
+  } else {
+    best_size = best_it->first;
+  }
+
+  // Packets of the same size are ordered by raw sequence number. When the
+  // history spans a wrap-around, the oldest one is the first at or after
+  // |start_seqno_|, not the first of the size.
+  auto first_it = packets_by_size_.lower_bound(std::make_pair(best_size, 0));
+  best_it =
+      packets_by_size_.lower_bound(std::make_pair(best_size, start_seqno_));
+  if (best_it == packets_by_size_.end() || best_it->first != best_size ||
+      IsNewerSequenceNumber(best_it->second, first_it->second)) {
+    best_it = first_it;
+  }
+
+  const StoredPacket* best_packet = FindPacket(best_it->second);
+  RTC_DCHECK(best_packet);
+  return rtc::MakeUnique<RtpPacketToSend>(*best_packet->packet);
+}
+
+RtpPacketHistory::Stats RtpPacketHistory::GetStats() const {
+  rtc::CritScope cs(&lock_);
+  Stats stats;
+  stats.num_packets = num_packets_;
+  stats.allocated_bytes = packet_history_.capacity() * sizeof(StoredPacket) +
+                          packets_by_size_.size() * kSizeIndexNodeBytes;
+  for (const StoredPacket& stored_packet : packet_history_) {
+    if (stored_packet.packet) {
+      stats.packet_bytes += stored_packet.packet->size();
+      stats.allocated_bytes +=
+          sizeof(RtpPacketToSend) + stored_packet.packet->capacity();
     }
   }
+  return stats;
+}
 
-  return rtc::MakeUnique<RtpPacketToSend>(*best_packet);
+size_t RtpPacketHistory::MemoryUsageBytes() const {
+  return GetStats().allocated_bytes;
 }
 
 void RtpPacketHistory::Reset() {
-  packet_history_.clear();
-  start_seqno_.reset();
+  std::vector<StoredPacket>().swap(packet_history_);
+  packets_by_size_.clear();
+  num_packets_ = 0;
+  start_seqno_ = 0;
+  window_size_ = 0;
 }
 
 void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
   int64_t packet_duration_ms =
       std::max(kMinPacketDurationRtt * rtt_ms_, kMinPacketDurationMs);
-  while (!packet_history_.empty()) {
-    auto stored_packet_it = packet_history_.find(*start_seqno_);
-    RTC_DCHECK(stored_packet_it != packet_history_.end());
+  while (num_packets_ > 0) {
+    StoredPacket* stored_packet = FindPacket(start_seqno_);
+    RTC_DCHECK(stored_packet);
 
-    if (packet_history_.size() >= kMaxCapacity) {
+    if (num_packets_ >= kMaxCapacity) {
       // We have reached the absolute max capacity, remove one packet
       // unconditionally.
-      RemovePacket(stored_packet_it);
+      RemovePacket(stored_packet);
       continue;
     }
 
-    const StoredPacket& stored_packet = stored_packet_it->second;
-    if (!stored_packet.send_time_ms) {
+    if (!stored_packet->send_time_ms) {
       // Don't remove packets that have not been sent.
       return;
     }
 
-    if (*stored_packet.send_time_ms + packet_duration_ms > now_ms) {
+    if (*stored_packet->send_time_ms + packet_duration_ms > now_ms) {
       // Don't cull packets too early to avoid failed retransmission requests.
       return;
     }
 
-    if (packet_history_.size() >= number_to_store_ ||
+    if (num_packets_ >= number_to_store_ ||
         (mode_ == StorageMode::kStoreAndCull &&
-         *stored_packet.send_time_ms +
+         *stored_packet->send_time_ms +
                  (packet_duration_ms * kPacketCullingDelayFactor) <=
              now_ms)) {
       // Too many packets in history, or this packet has timed out. Remove it
       // and continue.
-      RemovePacket(stored_packet_it);
+      RemovePacket(stored_packet);
     } else {
       // No more packets can be removed right now.
       return;
@@ -251,25 +318,112 @@ void RtpPacketHistory::CullOldPackets(int64_t now_ms) {
   }
 }
 
-std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
-    StoredPacketIterator packet_it) {
-  // Move the packet out from the StoredPacket container.
-  std::unique_ptr<RtpPacketToSend> rtp_packet =
-      std::move(packet_it->second.packet);
-  // Erase the packet from the map, and capture iterator to the next one.
-  StoredPacketIterator next_it = packet_history_.erase(packet_it);
-
-  // |next_it| now points to the next element, or to the end. If the end,
-  // check if we can wrap around.
-  if (next_it == packet_history_.end()) {
-    next_it = packet_history_.begin();
+RtpPacketHistory::StoredPacket* RtpPacketHistory::FindPacket(
+    uint16_t sequence_number) {
+  return const_cast<StoredPacket*>(
+      static_cast<const RtpPacketHistory*>(this)->FindPacket(sequence_number));
+}
+
+const RtpPacketHistory::StoredPacket* RtpPacketHistory::FindPacket(
+    uint16_t sequence_number) const {
+  if (num_packets_ == 0 ||
+      static_cast<uint16_t>(sequence_number - start_seqno_) >= window_size_) {
+    return nullptr;
+  }
+  const StoredPacket& stored_packet =
+      packet_history_[sequence_number & (packet_history_.size() - 1)];
+  if (!stored_packet.packet) {
+    return nullptr;
   }
+  RTC_DCHECK_EQ(sequence_number, stored_packet.packet->SequenceNumber());
+  return &stored_packet;
+}
 
-  // Update |start_seq_no| to the new oldest item.
-  if (next_it != packet_history_.end()) {
-    start_seqno_ = next_it->first;
+RtpPacketHistory::StoredPacket* RtpPacketHistory::AllocateSlot(
+    uint16_t sequence_number) {
+  if (num_packets_ > 0 && IsNewerSequenceNumber(start_seqno_, sequence_number)) {
+    // Older than the oldest packet, extend the window backwards if possible.
+    size_t window_size =
+        window_size_ + static_cast<uint16_t>(start_seqno_ - sequence_number);
+    if (window_size > kMaxRingSize) {
+      return nullptr;
+    }
+    if (window_size > packet_history_.size()) {
+      ResizeRing(window_size);
+    }
+    start_seqno_ = sequence_number;
+    window_size_ = window_size;
   } else {
-    start_seqno_.reset();
+    // Remove the oldest packets if the window can't reach this one.
+    while (num_packets_ > 0 &&
+           static_cast<uint16_t>(sequence_number - start_seqno_) >=
+               kMaxRingSize) {
+      RemovePacket(FindPacket(start_seqno_));
+    }
+    if (num_packets_ == 0) {
+      start_seqno_ = sequence_number;
+      window_size_ = 0;
+    }
+    size_t offset = static_cast<uint16_t>(sequence_number - start_seqno_);
+    if (offset >= window_size_) {
+      window_size_ = offset + 1;
+      if (window_size_ > packet_history_.size()) {
+        ResizeRing(window_size_);
+      }
+    }
+  }
+
+  StoredPacket* stored_packet =
+      &packet_history_[sequence_number & (packet_history_.size() - 1)];
+  RTC_DCHECK(!stored_packet->packet);
+  return stored_packet;
+}
+
+void RtpPacketHistory::ResizeRing(size_t size) {
+  RTC_DCHECK_LE(size, kMaxRingSize);
+  size_t ring_size = kMinRingSize;
+  while (ring_size < size) {
+    ring_size *= 2;
+  }
+
+  std::vector<StoredPacket> ring(ring_size);
+  for (StoredPacket& stored_packet : packet_history_) {
+    if (stored_packet.packet) {
+      uint16_t sequence_number = stored_packet.packet->SequenceNumber();
+      ring[sequence_number & (ring_size - 1)] = std::move(stored_packet);
+    }
+  }
+  packet_history_.swap(ring);
+}
+
+std::unique_ptr<RtpPacketToSend> RtpPacketHistory::RemovePacket(
+    StoredPacket* stored_packet) {
+  // Move the packet out from the StoredPacket container, and leave the slot
+  // empty.
+  std::unique_ptr<RtpPacketToSend> rtp_packet =
+      std::move(stored_packet->packet);
+  *stored_packet = StoredPacket();
+
+  const uint16_t rtp_seq_no = rtp_packet->SequenceNumber();
+  packets_by_size_.erase(std::make_pair(rtp_packet->size(), rtp_seq_no));
+  --num_packets_;
+
+  const size_t mask = packet_history_.size() - 1;
+  if (num_packets_ == 0) {
+    window_size_ = 0;
+  } else if (rtp_seq_no == start_seqno_) {
+    // Update |start_seqno_| to the new oldest item.
+    do {
+      ++start_seqno_;
+      --window_size_;
+    } while (!packet_history_[start_seqno_ & mask].packet);
+  } else if (static_cast<uint16_t>(rtp_seq_no - start_seqno_) ==
+             window_size_ - 1) {
+    // Shrink the window to end at the new latest item.
+    do {
+      --window_size_;
+    } while (
+        !packet_history_[(start_seqno_ + window_size_ - 1) & mask].packet);
   }
 
   return rtp_packet;
@@ -11,13 +11,15 @@
 #ifndef MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 #define MODULES_RTP_RTCP_SOURCE_RTP_PACKET_HISTORY_H_
 
-#include <map>
 #include <memory>
+#include <set>
+#include <utility>
 #include <vector>
 
 #include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/memory_account.h"
 #include "rtc_base/thread_annotations.h"
 #include "typedefs.h"  // NOLINT(build/include)
 
@@ -26,7 +28,11 @@ namespace webrtc {
 class Clock;
 class RtpPacketToSend;
 
-class RtpPacketHistory {
+// Stores sent RTP packets of one stream for retransmission. Packets are kept
+// in a ring buffer indexed by sequence number, so lookups are O(1). Stored
+// packets are moved in, and the packets returned for retransmission share
+// their payload buffer with the stored copy.
+class RtpPacketHistory : public rtc::MemoryUsageSource {
  public:
   enum class StorageMode {
     kDisabled,     // Don't store any packets.
@@ -50,6 +56,16 @@ class RtpPacketHistory {
     size_t times_retransmitted = 0;
   };
 
+  // Memory used by the history.
+  struct Stats {
+    size_t num_packets = 0;
+    // Sum of the sizes of the stored packets.
+    size_t packet_bytes = 0;
+    // Everything allocated by the history: the ring buffer, the size index
+    // and the stored packets including unused buffer capacity.
+    size_t allocated_bytes = 0;
+  };
+
   // Maximum number of packets we ever allow in the history.
   static constexpr size_t kMaxCapacity = 9600;
   // Don't remove packets within max(1000ms, 3x RTT).
@@ -59,7 +75,7 @@ class RtpPacketHistory {
   static constexpr int kPacketCullingDelayFactor = 3;
 
   explicit RtpPacketHistory(Clock* clock);
-  ~RtpPacketHistory();
+  ~RtpPacketHistory() override;
 
   // Set/get storage mode. Note that setting the state will clear the history,
   // even if setting the same state as is currently used.
@@ -83,6 +99,14 @@ class RtpPacketHistory {
       uint16_t sequence_number,
       bool verify_rtt);
 
+  // Takes the packet with |sequence_number| out of the history if it hasn't
+  // been sent yet, and sets |storage| to how it was stored. This lets the
+  // pacer set the send time extensions of the packet without copying it.
+  // Packets that may be retransmitted are to be put back once sent. Returns
+  // nullptr if the packet isn't stored or has already been sent.
+  std::unique_ptr<RtpPacketToSend> TakeUnsentPacket(uint16_t sequence_number,
+                                                    StorageType* storage);
+
   // Similar to GetPacketAndSetSendTime(), but only returns a snapshot of the
   // current state for packet, and never updates internal state.
   rtc::Optional<PacketState> GetPacketState(uint16_t sequence_number,
@@ -93,6 +117,12 @@ class RtpPacketHistory {
   std::unique_ptr<RtpPacketToSend> GetBestFittingPacket(
       size_t packet_size) const;
 
+  Stats GetStats() const;
+
+  // rtc::MemoryUsageSource implementation. Returns
+  // |GetStats().allocated_bytes|.
+  size_t MemoryUsageBytes() const override;
+
  private:
   struct StoredPacket {
     StoredPacket();
@@ -114,17 +144,27 @@ class RtpPacketHistory {
     std::unique_ptr<RtpPacketToSend> packet;
   };
 
-  using StoredPacketIterator = std::map<uint16_t, StoredPacket>::iterator;
-
   // Helper method used by GetPacketAndSetSendTime() and GetPacketState() to
   // check if packet has too recently been sent.
   bool VerifyRtt(const StoredPacket& packet, int64_t now_ms) const
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void Reset() RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   void CullOldPackets(int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the slot holding |sequence_number|, or nullptr if not stored.
+  StoredPacket* FindPacket(uint16_t sequence_number)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  const StoredPacket* FindPacket(uint16_t sequence_number) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Returns the empty slot to store |sequence_number| in, growing the ring or
+  // removing the oldest packets when needed to make room. Returns nullptr if
+  // the packet is too old to fit.
+  StoredPacket* AllocateSlot(uint16_t sequence_number)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  // Resizes the ring to |size| slots, a power of two spanning the window.
+  void ResizeRing(size_t size) RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   // Removes the packet from the history, and context/mapping that has been
   // stored. Returns the RTP packet instance contained within the StoredPacket.
-  std::unique_ptr<RtpPacketToSend> RemovePacket(StoredPacketIterator packet)
+  std::unique_ptr<RtpPacketToSend> RemovePacket(StoredPacket* packet)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
   static PacketState StoredPacketToPacketState(
       const StoredPacket& stored_packet);
@@ -135,12 +175,21 @@ class RtpPacketHistory {
   StorageMode mode_ RTC_GUARDED_BY(lock_);
   int64_t rtt_ms_ RTC_GUARDED_BY(lock_);
 
-  // Map from rtp sequence numbers to stored packet.
-  std::map<uint16_t, StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
-
-  // The earliest packet in the history. This might not be the lowest sequence
-  // number, in case there is a wraparound.
-  rtc::Optional<uint16_t> start_seqno_ RTC_GUARDED_BY(lock_);
+  // Ring buffer of stored packets, indexed by rtp sequence number modulo its
+  // size. Always a power of two in size, and at least as large as the window
+  // [start_seqno_, start_seqno_ + window_size_). Slots without a packet are
+  // empty.
+  std::vector<StoredPacket> packet_history_ RTC_GUARDED_BY(lock_);
+  size_t num_packets_ RTC_GUARDED_BY(lock_);
+
+  // The earliest packet in the history, and the number of sequence numbers
+  // from it up to and including the latest one.
+  uint16_t start_seqno_ RTC_GUARDED_BY(lock_);
+  size_t window_size_ RTC_GUARDED_BY(lock_);
+
+  // Stored packets ordered by size, then sequence number, for
+  // GetBestFittingPacket().
+  std::set<std::pair<size_t, uint16_t>> packets_by_size_ RTC_GUARDED_BY(lock_);
 
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(RtpPacketHistory);
 };
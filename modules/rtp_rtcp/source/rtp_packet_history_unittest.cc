@@ -171,6 +171,29 @@ TEST_F(RtpPacketHistoryTest, DontRetransmit) {
   EXPECT_FALSE(hist_.GetPacketAndSetSendTime(kStartSeqNum, false));
 }
 
+TEST_F(RtpPacketHistoryTest, TakesUnsentPacketWithoutCopyingIt) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  std::unique_ptr<RtpPacketToSend> packet = CreateRtpPacket(kStartSeqNum);
+  const uint8_t* data = packet->data();
+  hist_.PutRtpPacket(std::move(packet), kAllowRetransmission, rtc::nullopt);
+
+  StorageType storage = kDontRetransmit;
+  std::unique_ptr<RtpPacketToSend> packet_out =
+      hist_.TakeUnsentPacket(kStartSeqNum, &storage);
+  ASSERT_TRUE(packet_out);
+  EXPECT_EQ(kAllowRetransmission, storage);
+  // The buffer isn't shared, so writing the packet doesn't copy it.
+  packet_out->SetMarker(true);
+  EXPECT_EQ(data, packet_out->data());
+  EXPECT_FALSE(hist_.GetPacketState(kStartSeqNum, false));
+
+  // Once sent and put back, it is retransmitted but not taken again.
+  hist_.PutRtpPacket(std::move(packet_out), storage,
+                     fake_clock_.TimeInMilliseconds());
+  EXPECT_FALSE(hist_.TakeUnsentPacket(kStartSeqNum, &storage));
+  EXPECT_TRUE(hist_.GetPacketAndSetSendTime(kStartSeqNum, false));
+}
+
 TEST_F(RtpPacketHistoryTest, PacketStateIsCorrect) {
   const uint32_t kSsrc = 92384762;
   hist_.SetStorePacketsStatus(StorageMode::kStoreAndCull, 10);
@@ -489,4 +512,117 @@ TEST_F(RtpPacketHistoryTest, GetBestFittingPacket) {
   EXPECT_EQ(target_packet_size,
             hist_.GetBestFittingPacket(target_packet_size)->size());
 }
+
+TEST_F(RtpPacketHistoryTest, GetBestFittingPacketWithoutExactMatch) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+
+  const size_t kPayloadSizes[] = {100, 300, 600};
+  for (size_t i = 0; i < 3; ++i) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        CreateRtpPacket(To16u(kStartSeqNum + i));
+    packet->SetPayloadSize(kPayloadSizes[i]);
+    hist_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                       fake_clock_.TimeInMilliseconds());
+  }
+  const size_t kHeaderSize = CreateRtpPacket(0)->headers_size();
+
+  // Closest to a larger packet.
+  EXPECT_EQ(kStartSeqNum + 1,
+            hist_.GetBestFittingPacket(kHeaderSize + 250)->SequenceNumber());
+  // Closest to a smaller packet.
+  EXPECT_EQ(To16u(kStartSeqNum + 2),
+            hist_.GetBestFittingPacket(kHeaderSize + 1000)->SequenceNumber());
+  // Equally close to both, picks the smaller one.
+  EXPECT_EQ(kStartSeqNum + 1,
+            hist_.GetBestFittingPacket(kHeaderSize + 450)->SequenceNumber());
+
+  // Removed packets are no longer candidates.
+  std::unique_ptr<RtpPacketToSend> packet =
+      CreateRtpPacket(To16u(kStartSeqNum + 3));
+  packet->SetPayloadSize(1000);
+  hist_.PutRtpPacket(std::move(packet), kDontRetransmit, rtc::nullopt);
+  EXPECT_EQ(To16u(kStartSeqNum + 3),
+            hist_.GetBestFittingPacket(kHeaderSize + 1000)->SequenceNumber());
+  EXPECT_TRUE(hist_.GetPacketAndSetSendTime(To16u(kStartSeqNum + 3), false));
+  EXPECT_EQ(To16u(kStartSeqNum + 2),
+            hist_.GetBestFittingPacket(kHeaderSize + 1000)->SequenceNumber());
+}
+
+TEST_F(RtpPacketHistoryTest, GetBestFittingPacketPrefersOldestAcrossWrap) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+
+  // kStartSeqNum is stored first, before the sequence number wraps to 0.
+  for (size_t i = 0; i < 4; ++i) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        CreateRtpPacket(To16u(kStartSeqNum + i));
+    packet->SetPayloadSize(500);
+    hist_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                       fake_clock_.TimeInMilliseconds());
+  }
+  const size_t kHeaderSize = CreateRtpPacket(0)->headers_size();
+
+  EXPECT_EQ(kStartSeqNum,
+            hist_.GetBestFittingPacket(kHeaderSize + 500)->SequenceNumber());
+}
+
+TEST_F(RtpPacketHistoryTest, HandlesGapsInSequenceNumbers) {
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 1000);
+
+  // Gaps, a packet spanning more than the initial ring size, and one older
+  // than the first.
+  const uint16_t kSeqNums[] = {kStartSeqNum, To16u(kStartSeqNum + 3),
+                               To16u(kStartSeqNum + 500),
+                               To16u(kStartSeqNum - 2)};
+  for (uint16_t seq_num : kSeqNums) {
+    hist_.PutRtpPacket(CreateRtpPacket(seq_num), kAllowRetransmission,
+                       rtc::nullopt);
+  }
+  for (uint16_t seq_num : kSeqNums) {
+    rtc::Optional<RtpPacketHistory::PacketState> state =
+        hist_.GetPacketState(seq_num, false);
+    ASSERT_TRUE(state);
+    EXPECT_EQ(seq_num, state->rtp_sequence_number);
+  }
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 1), false));
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 499), false));
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 501), false));
+  EXPECT_EQ(4u, hist_.GetStats().num_packets);
+
+  // A packet too far ahead to be in the same ring pushes out the old ones.
+  hist_.PutRtpPacket(CreateRtpPacket(To16u(kStartSeqNum + 30000)),
+                     kAllowRetransmission, rtc::nullopt);
+  EXPECT_FALSE(hist_.GetPacketState(kStartSeqNum, false));
+  EXPECT_FALSE(hist_.GetPacketState(To16u(kStartSeqNum + 500), false));
+  EXPECT_TRUE(hist_.GetPacketState(To16u(kStartSeqNum + 30000), false));
+  EXPECT_EQ(1u, hist_.GetStats().num_packets);
+}
+
+TEST_F(RtpPacketHistoryTest, ReportsMemoryStats) {
+  RtpPacketHistory::Stats stats = hist_.GetStats();
+  EXPECT_EQ(0u, stats.num_packets);
+  EXPECT_EQ(0u, stats.packet_bytes);
+  EXPECT_EQ(0u, stats.allocated_bytes);
+
+  hist_.SetStorePacketsStatus(StorageMode::kStore, 10);
+  size_t packet_bytes = 0;
+  for (size_t i = 0; i < 3; ++i) {
+    std::unique_ptr<RtpPacketToSend> packet =
+        CreateRtpPacket(To16u(kStartSeqNum + i));
+    packet->SetPayloadSize(100 * (i + 1));
+    packet_bytes += packet->size();
+    hist_.PutRtpPacket(std::move(packet), kAllowRetransmission,
+                       fake_clock_.TimeInMilliseconds());
+  }
+  stats = hist_.GetStats();
+  EXPECT_EQ(3u, stats.num_packets);
+  EXPECT_EQ(packet_bytes, stats.packet_bytes);
+  EXPECT_GT(stats.allocated_bytes, packet_bytes);
+
+  // Retransmissions don't add to the stored packets.
+  EXPECT_TRUE(hist_.GetPacketAndSetSendTime(kStartSeqNum, false));
+  EXPECT_EQ(packet_bytes, hist_.GetStats().packet_bytes);
+
+  hist_.SetStorePacketsStatus(StorageMode::kDisabled, 0);
+  EXPECT_EQ(0u, hist_.GetStats().allocated_bytes);
+}
 }  // namespace webrtc
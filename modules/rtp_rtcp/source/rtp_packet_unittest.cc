@@ -388,6 +388,33 @@ TEST(RtpPacketTest, ParseWith2Extensions) {
   EXPECT_EQ(kAudioLevel, audio_level);
 }
 
+TEST(RtpPacketTest, ParsedExtensionsSurviveCopyAndReparse) {
+  RtpPacketToSend::ExtensionManager extensions;
+  extensions.Register(kRtpExtensionTransmissionTimeOffset,
+                      kTransmissionOffsetExtensionId);
+  extensions.Register(kRtpExtensionAudioLevel, kAudioLevelExtensionId);
+  RtpPacketReceived packet(&extensions);
+  ASSERT_TRUE(packet.Parse(kPacketWithTOAndAL, sizeof(kPacketWithTOAndAL)));
+
+  // Copy before any extension has been looked up.
+  RtpPacketReceived copy(packet);
+  ASSERT_TRUE(packet.Parse(kPacketWithTO, sizeof(kPacketWithTO)));
+  EXPECT_TRUE(packet.HasExtension<TransmissionOffset>());
+  EXPECT_FALSE(packet.HasExtension<AudioLevel>());
+
+  bool voice_active;
+  uint8_t audio_level;
+  EXPECT_TRUE(copy.GetExtension<AudioLevel>(&voice_active, &audio_level));
+  EXPECT_EQ(kAudioLevel, audio_level);
+  int32_t time_offset;
+  EXPECT_TRUE(copy.GetExtension<TransmissionOffset>(&time_offset));
+  EXPECT_EQ(kTimeOffset, time_offset);
+  EXPECT_EQ(1u, copy.GetRawExtension(kAudioLevelExtensionId).size());
+
+  ASSERT_TRUE(packet.Parse(kMinimumPacket, sizeof(kMinimumPacket)));
+  EXPECT_FALSE(packet.HasExtension<TransmissionOffset>());
+}
+
 TEST(RtpPacketTest, ParseWithAllFeatures) {
   RtpPacketToSend::ExtensionManager extensions;
   extensions.Register(kRtpExtensionTransmissionTimeOffset,
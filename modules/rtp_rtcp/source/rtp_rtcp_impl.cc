@@ -15,8 +15,10 @@
 #include <algorithm>
 #include <set>
 #include <string>
+#include <utility>
 
 #include "api/rtpparameters.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
@@ -127,6 +129,10 @@ ModuleRtpRtcpImpl::ModuleRtpRtcpImpl(const Configuration& configuration)
         configuration.populate_network2_timestamp));
     // Make sure rtcp sender use same timestamp offset as rtp sender.
     rtcp_sender_.SetTimestampOffset(rtp_sender_->TimestampOffset());
+    if (configuration.memory_account)
+      rtp_sender_->RegisterMemoryUsage(configuration.memory_account);
+    if (configuration.frame_encryptor)
+      rtp_sender_->SetFrameEncryptor(configuration.frame_encryptor);
 
     if (keepalive_config_.timeout_interval_ms != -1) {
       next_keepalive_time_ =
@@ -450,6 +456,11 @@ bool ModuleRtpRtcpImpl::SendOutgoingData(
       expected_retransmission_time_ms);
 }
 
+bool ModuleRtpRtcpImpl::SendRtpPacket(std::unique_ptr<RtpPacketToSend> packet,
+                                      StorageType storage) {
+  return rtp_sender_->SendForwardedPacket(std::move(packet), storage);
+}
+
 bool ModuleRtpRtcpImpl::TimeToSendPacket(uint32_t ssrc,
                                          uint16_t sequence_number,
                                          int64_t capture_time_ms,
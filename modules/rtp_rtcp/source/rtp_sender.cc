@@ -182,6 +182,10 @@ RTPSender::~RTPSender() {
   // variables but we grab them in all other methods. (what's the design?)
   // Start documenting what thread we're on in what method so that it's easier
   // to understand performance attributes and possibly remove locks.
+  if (memory_account_) {
+    memory_account_->RemoveSource(&packet_history_);
+    memory_account_->RemoveSource(&flexfec_packet_history_);
+  }
   while (!payload_type_map_.empty()) {
     std::map<int8_t, RtpUtility::Payload*>::iterator it =
         payload_type_map_.begin();
@@ -229,6 +233,7 @@ uint32_t RTPSender::NackOverheadRate() const {
 int32_t RTPSender::RegisterRtpHeaderExtension(RTPExtensionType type,
                                               uint8_t id) {
   rtc::CritScope lock(&send_critsect_);
+  packet_template_.reset();
   return rtp_header_extension_map_.RegisterByType(id, type) ? 0 : -1;
 }
 
@@ -239,6 +244,7 @@ bool RTPSender::IsRtpHeaderExtensionRegistered(RTPExtensionType type) const {
 
 int32_t RTPSender::DeregisterRtpHeaderExtension(RTPExtensionType type) {
   rtc::CritScope lock(&send_critsect_);
+  packet_template_.reset();
   return rtp_header_extension_map_.Deregister(type);
 }
 
@@ -486,7 +492,7 @@ size_t RTPSender::TrySendRedundantPayloads(size_t bytes_to_send,
     if (!packet)
       break;
     size_t payload_size = packet->payload_size();
-    if (!PrepareAndSendPacket(std::move(packet), true, false, pacing_info))
+    if (!PrepareAndSendPacket(packet.get(), true, false, pacing_info))
       break;
     bytes_left -= payload_size;
   }
@@ -620,6 +626,20 @@ void RTPSender::SetStorePacketsStatus(bool enable, uint16_t number_to_store) {
   packet_history_.SetStorePacketsStatus(mode, number_to_store);
 }
 
+void RTPSender::RegisterMemoryUsage(rtc::MemoryAccount* memory_account) {
+  RTC_DCHECK(memory_account);
+  RTC_DCHECK(!memory_account_);
+  memory_account_ = memory_account;
+  memory_account_->AddSource(rtc::kRtpPacketHistoryMemory, &packet_history_);
+  memory_account_->AddSource(rtc::kRtpPacketHistoryMemory,
+                             &flexfec_packet_history_);
+}
+
+void RTPSender::SetFrameEncryptor(FrameEncryptorInterface* frame_encryptor) {
+  RTC_DCHECK(video_);
+  video_->SetFrameEncryptor(frame_encryptor);
+}
+
 bool RTPSender::StorePackets() const {
   return packet_history_.GetStorageMode() !=
          RtpPacketHistory::StorageMode::kDisabled;
@@ -665,7 +685,7 @@ int32_t RTPSender::ReSendPacket(uint16_t packet_id) {
   }
 
   const bool rtx = (RtxStatus() & kRtxRetransmitted) > 0;
-  if (!PrepareAndSendPacket(std::move(packet), rtx, true, PacedPacketInfo()))
+  if (!PrepareAndSendPacket(packet.get(), rtx, true, PacedPacketInfo()))
     return -1;
 
   return packet_size;
@@ -741,6 +761,23 @@ bool RTPSender::TimeToSendPacket(uint32_t ssrc,
   if (!SendingMedia())
     return true;
 
+  if (ssrc == SSRC() && !retransmission) {
+    // The first transmission takes the packet out of the history instead of
+    // copying it. A copy shares its buffer with the stored packet, so setting
+    // the send time extensions on it would copy the whole packet.
+    StorageType storage;
+    std::unique_ptr<RtpPacketToSend> packet =
+        packet_history_.TakeUnsentPacket(sequence_number, &storage);
+    if (packet) {
+      bool sent = PrepareAndSendPacket(packet.get(), false, false, pacing_info);
+      if (storage == kAllowRetransmission) {
+        packet_history_.PutRtpPacket(std::move(packet), storage,
+                                     clock_->TimeInMilliseconds());
+      }
+      return sent;
+    }
+  }
+
   std::unique_ptr<RtpPacketToSend> packet;
   // No need to verify RTT here, it has already been checked before putting the
   // packet into the pacer. But _do_ update the send time.
@@ -757,18 +794,17 @@ bool RTPSender::TimeToSendPacket(uint32_t ssrc,
   }
 
   return PrepareAndSendPacket(
-      std::move(packet),
-      retransmission && (RtxStatus() & kRtxRetransmitted) > 0, retransmission,
-      pacing_info);
+      packet.get(), retransmission && (RtxStatus() & kRtxRetransmitted) > 0,
+      retransmission, pacing_info);
 }
 
-bool RTPSender::PrepareAndSendPacket(std::unique_ptr<RtpPacketToSend> packet,
+bool RTPSender::PrepareAndSendPacket(RtpPacketToSend* packet,
                                      bool send_over_rtx,
                                      bool is_retransmit,
                                      const PacedPacketInfo& pacing_info) {
   RTC_DCHECK(packet);
   int64_t capture_time_ms = packet->capture_time_ms();
-  RtpPacketToSend* packet_to_send = packet.get();
+  RtpPacketToSend* packet_to_send = packet;
 
   if (!is_retransmit && packet->Marker()) {
     TRACE_EVENT_ASYNC_END0(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"), "PacedSend",
@@ -977,6 +1013,28 @@ bool RTPSender::SendToNetwork(std::unique_ptr<RtpPacketToSend> packet,
   return sent;
 }
 
+bool RTPSender::SendForwardedPacket(std::unique_ptr<RtpPacketToSend> packet,
+                                    StorageType storage) {
+  RTC_DCHECK(packet);
+  {
+    rtc::CritScope lock(&send_critsect_);
+    if (!sending_media_)
+      return false;
+    RTC_DCHECK(packet->Ssrc() == ssrc_);
+    if (!IsNewerSequenceNumber(sequence_number_, packet->SequenceNumber())) {
+      sequence_number_ = packet->SequenceNumber() + 1;
+      // Same state as AssignSequenceNumber() keeps for padding.
+      last_packet_marker_bit_ = packet->Marker();
+      last_payload_type_ = packet->PayloadType();
+      last_rtp_timestamp_ = packet->Timestamp();
+      last_timestamp_time_ms_ = clock_->TimeInMilliseconds();
+      capture_time_ms_ = packet->capture_time_ms();
+    }
+  }
+  return SendToNetwork(std::move(packet), storage,
+                       RtpPacketSender::kNormalPriority);
+}
+
 void RTPSender::UpdateDelayStatistics(int64_t capture_time_ms, int64_t now_ms) {
   if (!send_side_delay_observer_ || capture_time_ms <= 0)
     return;
@@ -1063,23 +1121,40 @@ void RTPSender::GetDataCounters(StreamDataCounters* rtp_stats,
 
 std::unique_ptr<RtpPacketToSend> RTPSender::AllocatePacket() const {
   rtc::CritScope lock(&send_critsect_);
-  std::unique_ptr<RtpPacketToSend> packet(
-      new RtpPacketToSend(&rtp_header_extension_map_, max_packet_size_));
   RTC_DCHECK(ssrc_);
-  packet->SetSsrc(*ssrc_);
-  packet->SetCsrcs(csrcs_);
-  // Reserve extensions, if registered, RtpSender set in SendToNetwork.
-  packet->ReserveExtension<AbsoluteSendTime>();
-  packet->ReserveExtension<TransmissionOffset>();
-  packet->ReserveExtension<TransportSequenceNumber>();
+  rtc::Optional<PlayoutDelay> playout_delay;
   if (playout_delay_oracle_.send_playout_delay()) {
-    packet->SetExtension<PlayoutDelayLimits>(
-        playout_delay_oracle_.playout_delay());
+    playout_delay = playout_delay_oracle_.playout_delay();
   }
-  if (!mid_.empty()) {
-    // This is a no-op if the MID header extension is not registered.
-    packet->SetExtension<RtpMid>(mid_);
+  if (!packet_template_ ||
+      playout_delay.has_value() !=
+          packet_template_playout_delay_.has_value() ||
+      (playout_delay &&
+       (playout_delay->min_ms != packet_template_playout_delay_->min_ms ||
+        playout_delay->max_ms != packet_template_playout_delay_->max_ms))) {
+    packet_template_.reset(
+        new RtpPacketToSend(&rtp_header_extension_map_, max_packet_size_));
+    packet_template_->SetSsrc(*ssrc_);
+    packet_template_->SetCsrcs(csrcs_);
+    // Reserve extensions, if registered, RtpSender set in SendToNetwork.
+    packet_template_->ReserveExtension<AbsoluteSendTime>();
+    packet_template_->ReserveExtension<TransmissionOffset>();
+    packet_template_->ReserveExtension<TransportSequenceNumber>();
+    if (playout_delay) {
+      packet_template_->SetExtension<PlayoutDelayLimits>(*playout_delay);
+    }
+    if (!mid_.empty()) {
+      // This is a no-op if the MID header extension is not registered.
+      packet_template_->SetExtension<RtpMid>(mid_);
+    }
+    packet_template_playout_delay_ = playout_delay;
   }
+
+  // The registered extensions are copied from the template along with the
+  // header, no need to look them up in the extension map again.
+  std::unique_ptr<RtpPacketToSend> packet(
+      new RtpPacketToSend(nullptr, max_packet_size_));
+  packet->CopyHeaderFrom(*packet_template_);
   return packet;
 }
 
@@ -1149,6 +1224,7 @@ void RTPSender::SetSSRC(uint32_t ssrc) {
     return;  // Since it's same ssrc, don't reset anything.
   }
   ssrc_.emplace(ssrc);
+  packet_template_.reset();
   if (!sequence_number_forced_) {
     sequence_number_ = random_.Rand(1, kMaxInitRtpSeqNumber);
   }
@@ -1164,6 +1240,7 @@ void RTPSender::SetMid(const std::string& mid) {
   // This is configured via the API.
   rtc::CritScope lock(&send_critsect_);
   mid_ = mid;
+  packet_template_.reset();
 }
 
 rtc::Optional<uint32_t> RTPSender::FlexfecSsrc() const {
@@ -1177,6 +1254,7 @@ void RTPSender::SetCsrcs(const std::vector<uint32_t>& csrcs) {
   RTC_DCHECK_LE(csrcs.size(), kRtpCsrcSize);
   rtc::CritScope lock(&send_critsect_);
   csrcs_ = csrcs;
+  packet_template_.reset();
 }
 
 void RTPSender::SetSequenceNumber(uint16_t seq) {
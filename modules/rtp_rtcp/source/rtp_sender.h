@@ -37,6 +37,7 @@
 
 namespace webrtc {
 
+class FrameEncryptorInterface;
 class OverheadObserver;
 class RateLimiter;
 class RtcEventLog;
@@ -132,6 +133,13 @@ class RTPSender {
                       int64_t avg_rtt);
 
   void SetStorePacketsStatus(bool enable, uint16_t number_to_store);
+  // Reports the memory used by the packet histories to |memory_account| until
+  // the sender is destroyed. May only be called once.
+  void RegisterMemoryUsage(rtc::MemoryAccount* memory_account);
+
+  // Encrypts all outgoing video frames with |frame_encryptor|. Must be called
+  // before the first frame is sent, and only on video senders.
+  void SetFrameEncryptor(FrameEncryptorInterface* frame_encryptor);
 
   bool StorePackets() const;
 
@@ -178,6 +186,12 @@ class RTPSender {
                      StorageType storage,
                      RtpPacketSender::Priority priority);
 
+  // Sends a media packet that already has its ssrc, sequence number and
+  // timestamp set, e.g. one forwarded from a received stream. Packets created
+  // by this sender continue the sequence numbers after it.
+  bool SendForwardedPacket(std::unique_ptr<RtpPacketToSend> packet,
+                           StorageType storage);
+
   // Audio.
 
   // Send a DTMF tone using RFC 2833 (4733).
@@ -224,7 +238,9 @@ class RTPSender {
 
   size_t SendPadData(size_t bytes, const PacedPacketInfo& pacing_info);
 
-  bool PrepareAndSendPacket(std::unique_ptr<RtpPacketToSend> packet,
+  // Sets the send time extensions of |packet|, which stays owned by the
+  // caller, and sends it, or an RTX packet built from it.
+  bool PrepareAndSendPacket(RtpPacketToSend* packet,
                             bool send_over_rtx,
                             bool is_retransmit,
                             const PacedPacketInfo& pacing_info);
@@ -290,10 +306,20 @@ class RTPSender {
   // delay extension on header.
   PlayoutDelayOracle playout_delay_oracle_;
 
+  // Header that AllocatePacket() copies into every new packet, so that the
+  // ssrc, csrcs and extensions are only written when they change. Reset
+  // when any of them changes, and rebuilt when the playout delay to send
+  // differs from |packet_template_playout_delay_|.
+  mutable std::unique_ptr<RtpPacketToSend> packet_template_
+      RTC_GUARDED_BY(send_critsect_);
+  mutable rtc::Optional<PlayoutDelay> packet_template_playout_delay_
+      RTC_GUARDED_BY(send_critsect_);
+
   RtpPacketHistory packet_history_;
   // TODO(brandtr): Remove |flexfec_packet_history_| when the FlexfecSender
   // is hooked up to the PacedSender.
   RtpPacketHistory flexfec_packet_history_;
+  rtc::MemoryAccount* memory_account_ = nullptr;
 
   // Statistics
   rtc::CriticalSection statistics_crit_;
@@ -30,6 +30,7 @@
 #include "rtc_base/buffer.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/rate_limiter.h"
+#include "rtc_base/refcountedobject.h"
 #include "test/field_trial.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
@@ -112,6 +113,29 @@ MATCHER_P(SameRtcEventTypeAs, value, "") {
   return value == arg->GetType();
 }
 
+// Inverts the bits of the frame and appends a byte with the size of the
+// additional data.
+class InvertingFrameEncryptor : public FrameEncryptorInterface {
+ public:
+  int Encrypt(cricket::MediaType media_type,
+              uint32_t ssrc,
+              rtc::ArrayView<const uint8_t> additional_data,
+              rtc::ArrayView<const uint8_t> frame,
+              rtc::ArrayView<uint8_t> encrypted_frame,
+              size_t* bytes_written) override {
+    for (size_t i = 0; i < frame.size(); ++i)
+      encrypted_frame[i] = ~frame[i];
+    encrypted_frame[frame.size()] =
+        static_cast<uint8_t>(additional_data.size());
+    *bytes_written = frame.size() + 1;
+    return 0;
+  }
+  size_t GetMaxCiphertextByteSize(cricket::MediaType media_type,
+                                  size_t frame_size) override {
+    return frame_size + 1;
+  }
+};
+
 }  // namespace
 
 class MockRtpPacketSender : public RtpPacketSender {
@@ -328,6 +352,37 @@ TEST_P(RtpSenderTestWithoutPacer, AllocatePacketReserveExtensions) {
   EXPECT_FALSE(packet->HasExtension<VideoOrientation>());
 }
 
+TEST_P(RtpSenderTestWithoutPacer, AllocatePacketFollowsConfigurationChanges) {
+  auto packet = rtp_sender_->AllocatePacket();
+  ASSERT_TRUE(packet);
+  EXPECT_TRUE(packet->Csrcs().empty());
+  EXPECT_FALSE(packet->HasExtension<AbsoluteSendTime>());
+
+  std::vector<uint32_t> csrcs;
+  csrcs.push_back(0x23456789);
+  rtp_sender_->SetCsrcs(csrcs);
+  ASSERT_EQ(
+      0, rtp_sender_->RegisterRtpHeaderExtension(kRtpExtensionAbsoluteSendTime,
+                                                 kAbsoluteSendTimeExtensionId));
+  ASSERT_EQ(0, rtp_sender_->RegisterRtpHeaderExtension(
+                   kRtpExtensionVideoRotation, kVideoRotationExtensionId));
+  rtp_sender_->SetSSRC(kSsrc + 1);
+
+  packet = rtp_sender_->AllocatePacket();
+  ASSERT_TRUE(packet);
+  EXPECT_EQ(kSsrc + 1, packet->Ssrc());
+  EXPECT_EQ(csrcs, packet->Csrcs());
+  EXPECT_TRUE(packet->HasExtension<AbsoluteSendTime>());
+  // Extensions that are registered but not in the header can still be set.
+  EXPECT_TRUE(packet->SetExtension<VideoOrientation>(kVideoRotation_90));
+
+  ASSERT_EQ(0, rtp_sender_->DeregisterRtpHeaderExtension(
+                   kRtpExtensionAbsoluteSendTime));
+  packet = rtp_sender_->AllocatePacket();
+  ASSERT_TRUE(packet);
+  EXPECT_FALSE(packet->HasExtension<AbsoluteSendTime>());
+}
+
 TEST_P(RtpSenderTestWithoutPacer, AssignSequenceNumberAdvanceSequenceNumber) {
   auto packet = rtp_sender_->AllocatePacket();
   ASSERT_TRUE(packet);
@@ -347,6 +402,28 @@ TEST_P(RtpSenderTestWithoutPacer, AssignSequenceNumberFailsOnNotSending) {
   EXPECT_FALSE(rtp_sender_->AssignSequenceNumber(packet.get()));
 }
 
+TEST_P(RtpSenderTestWithoutPacer, SendForwardedPacketContinuesSequence) {
+  auto packet = rtp_sender_->AllocatePacket();
+  ASSERT_TRUE(packet);
+  const uint16_t kForwardedSequenceNumber = rtp_sender_->SequenceNumber() + 100;
+  packet->SetSequenceNumber(kForwardedSequenceNumber);
+  packet->SetTimestamp(kTimestamp);
+  packet->AllocatePayload(100);
+
+  EXPECT_TRUE(rtp_sender_->SendForwardedPacket(std::move(packet),
+                                               kAllowRetransmission));
+  ASSERT_EQ(1, transport_.packets_sent());
+  EXPECT_EQ(kForwardedSequenceNumber,
+            transport_.last_sent_packet().SequenceNumber());
+  EXPECT_EQ(kTimestamp, transport_.last_sent_packet().Timestamp());
+  // Packets of this sender continue after the forwarded one.
+  EXPECT_EQ(kForwardedSequenceNumber + 1, rtp_sender_->SequenceNumber());
+
+  rtp_sender_->SetSendingMediaStatus(false);
+  EXPECT_FALSE(rtp_sender_->SendForwardedPacket(rtp_sender_->AllocatePacket(),
+                                                kAllowRetransmission));
+}
+
 TEST_P(RtpSenderTestWithoutPacer, AssignSequenceNumberMayAllowPaddingOnVideo) {
   constexpr size_t kPaddingSize = 100;
   auto packet = rtp_sender_->AllocatePacket();
@@ -975,6 +1052,30 @@ TEST_P(RtpSenderTestWithoutPacer, SendGenericVideo) {
   EXPECT_THAT(sent_payload.subview(1), ElementsAreArray(payload));
 }
 
+TEST_P(RtpSenderTestWithoutPacer, SendEncryptedGenericVideo) {
+  char payload_name[RTP_PAYLOAD_NAME_SIZE] = "GENERIC";
+  const uint8_t payload_type = 127;
+  ASSERT_EQ(0, rtp_sender_->RegisterPayload(payload_name, payload_type, 90000,
+                                            0, 1500));
+  rtc::scoped_refptr<FrameEncryptorInterface> encryptor(
+      new rtc::RefCountedObject<InvertingFrameEncryptor>());
+  rtp_sender_->SetFrameEncryptor(encryptor.get());
+  const uint8_t payload[] = {47, 11, 32, 93, 89};
+
+  ASSERT_TRUE(rtp_sender_->SendOutgoingData(
+      kVideoFrameKey, payload_type, 1234, 4321, payload, sizeof(payload),
+      nullptr, nullptr, nullptr, kDefaultExpectedRetransmissionTimeMs));
+
+  // Generic frames are encrypted from the first byte.
+  const uint8_t kEncrypted[] = {static_cast<uint8_t>(~47),
+                                static_cast<uint8_t>(~11),
+                                static_cast<uint8_t>(~32),
+                                static_cast<uint8_t>(~93),
+                                static_cast<uint8_t>(~89), 0};
+  auto sent_payload = transport_.last_sent_packet().payload();
+  EXPECT_THAT(sent_payload.subview(1), ElementsAreArray(kEncrypted));
+}
+
 TEST_P(RtpSenderTest, SendFlexfecPackets) {
   constexpr int kMediaPayloadType = 127;
   constexpr int kFlexfecPayloadType = 118;
@@ -77,6 +77,11 @@ RtpVideoCodecTypes RTPSenderVideo::VideoCodecType() const {
 }
 
 // Static.
+void RTPSenderVideo::SetFrameEncryptor(
+    FrameEncryptorInterface* frame_encryptor) {
+  frame_encryptor_ = frame_encryptor;
+}
+
 RtpUtility::Payload* RTPSenderVideo::CreateVideoPayload(
     const char payload_name[RTP_PAYLOAD_NAME_SIZE],
     int8_t payload_type) {
@@ -100,13 +105,13 @@ RtpUtility::Payload* RTPSenderVideo::CreateVideoPayload(
 }
 
 void RTPSenderVideo::SendVideoPacket(std::unique_ptr<RtpPacketToSend> packet,
-                                     StorageType storage) {
+                                     StorageType storage,
+                                     RtpPacketSender::Priority priority) {
   // Remember some values about the packet before sending it away.
   size_t packet_size = packet->size();
   uint16_t seq_num = packet->SequenceNumber();
   uint32_t rtp_timestamp = packet->Timestamp();
-  if (!rtp_sender_->SendToNetwork(std::move(packet), storage,
-                                  RtpPacketSender::kLowPriority)) {
+  if (!rtp_sender_->SendToNetwork(std::move(packet), storage, priority)) {
     RTC_LOG(LS_WARNING) << "Failed to send video packet " << seq_num;
     return;
   }
@@ -120,6 +125,7 @@ void RTPSenderVideo::SendVideoPacket(std::unique_ptr<RtpPacketToSend> packet,
 void RTPSenderVideo::SendVideoPacketAsRedMaybeWithUlpfec(
     std::unique_ptr<RtpPacketToSend> media_packet,
     StorageType media_packet_storage,
+    RtpPacketSender::Priority media_packet_priority,
     bool protect_media_packet) {
   uint32_t rtp_timestamp = media_packet->Timestamp();
   uint16_t media_seq_num = media_packet->SequenceNumber();
@@ -155,7 +161,7 @@ void RTPSenderVideo::SendVideoPacketAsRedMaybeWithUlpfec(
   // Send |red_packet| instead of |packet| for allocated sequence number.
   size_t red_packet_size = red_packet->size();
   if (rtp_sender_->SendToNetwork(std::move(red_packet), media_packet_storage,
-                                 RtpPacketSender::kLowPriority)) {
+                                 media_packet_priority)) {
     rtc::CritScope cs(&stats_crit_);
     video_bitrate_.Update(red_packet_size, clock_->TimeInMilliseconds());
     TRACE_EVENT_INSTANT2(TRACE_DISABLED_BY_DEFAULT("webrtc_rtp"),
@@ -189,13 +195,15 @@ void RTPSenderVideo::SendVideoPacketAsRedMaybeWithUlpfec(
 void RTPSenderVideo::SendVideoPacketWithFlexfec(
     std::unique_ptr<RtpPacketToSend> media_packet,
     StorageType media_packet_storage,
+    RtpPacketSender::Priority media_packet_priority,
     bool protect_media_packet) {
   RTC_DCHECK(flexfec_sender_);
 
   if (protect_media_packet)
     flexfec_sender_->AddRtpPacketAndGenerateFec(*media_packet);
 
-  SendVideoPacket(std::move(media_packet), media_packet_storage);
+  SendVideoPacket(std::move(media_packet), media_packet_storage,
+                  media_packet_priority);
 
   if (flexfec_sender_->FecAvailable()) {
     std::vector<std::unique_ptr<RtpPacketToSend>> fec_packets =
@@ -272,6 +280,40 @@ size_t RTPSenderVideo::CalculateFecPacketOverhead() const {
   return overhead;
 }
 
+bool RTPSenderVideo::EncryptFrame(RtpVideoCodecTypes video_type,
+                                  FrameType frame_type,
+                                  uint32_t ssrc,
+                                  const uint8_t** payload_data,
+                                  size_t* payload_size) {
+  if (video_type == kRtpVideoH264) {
+    RTC_LOG(LS_ERROR) << "Frame encryption is not supported for H264.";
+    return false;
+  }
+  const size_t header_size = UnencryptedFrameHeaderSize(
+      video_type == kRtpVideoVp8 ? kVideoCodecVP8 : kVideoCodecGeneric,
+      frame_type, *payload_size);
+  rtc::ArrayView<const uint8_t> header(*payload_data, header_size);
+  rtc::ArrayView<const uint8_t> frame(*payload_data + header_size,
+                                      *payload_size - header_size);
+  encrypted_frame_.SetSize(header_size +
+                           frame_encryptor_->GetMaxCiphertextByteSize(
+                               cricket::MEDIA_TYPE_VIDEO, frame.size()));
+  memcpy(encrypted_frame_.data(), header.data(), header_size);
+  size_t bytes_written = 0;
+  if (frame_encryptor_->Encrypt(
+          cricket::MEDIA_TYPE_VIDEO, ssrc, header, frame,
+          rtc::ArrayView<uint8_t>(encrypted_frame_.data() + header_size,
+                                  encrypted_frame_.size() - header_size),
+          &bytes_written) != 0) {
+    RTC_LOG(LS_WARNING) << "Failed to encrypt video frame.";
+    return false;
+  }
+  encrypted_frame_.SetSize(header_size + bytes_written);
+  *payload_data = encrypted_frame_.data();
+  *payload_size = encrypted_frame_.size();
+  return true;
+}
+
 void RTPSenderVideo::SetFecParameters(const FecProtectionParams& delta_params,
                                       const FecProtectionParams& key_params) {
   rtc::CritScope cs(&crit_);
@@ -301,6 +343,16 @@ bool RTPSenderVideo::SendVideo(RtpVideoCodecTypes video_type,
 
   // Create header that will be reused in all packets.
   std::unique_ptr<RtpPacketToSend> rtp_header = rtp_sender_->AllocatePacket();
+
+  if (frame_encryptor_) {
+    if (!EncryptFrame(video_type, frame_type, rtp_header->Ssrc(),
+                      &payload_data, &payload_size)) {
+      return false;
+    }
+    // Only the H264 packetizer uses the fragmentation, which doesn't apply to
+    // the encrypted frame.
+    fragmentation = nullptr;
+  }
   rtp_header->SetPayloadType(payload_type);
   rtp_header->SetTimestamp(rtp_timestamp);
   rtp_header->set_capture_time_ms(capture_time_ms);
@@ -373,6 +425,13 @@ bool RTPSenderVideo::SendVideo(RtpVideoCodecTypes video_type,
       video_header ? GetTemporalId(*video_header) : kNoTemporalIdx;
   StorageType storage = GetStorageType(temporal_id, retransmission_settings,
                                        expected_retransmission_time_ms);
+  // The base layer goes ahead of the upper temporal layers in the pacer,
+  // since it doesn't depend on them, so congestion delays and drops those
+  // first.
+  const RtpPacketSender::Priority priority =
+      temporal_id == 0 || temporal_id == kNoTemporalIdx
+          ? RtpPacketSender::kLowPriority
+          : RtpPacketSender::kDiscardablePriority;
   size_t num_packets =
       packetizer->SetPayloadData(payload_data, payload_size, fragmentation);
 
@@ -410,12 +469,13 @@ bool RTPSenderVideo::SendVideo(RtpVideoCodecTypes video_type,
     if (flexfec_enabled()) {
       // TODO(brandtr): Remove the FlexFEC code path when FlexfecSender
       // is wired up to PacedSender instead.
-      SendVideoPacketWithFlexfec(std::move(packet), storage, protect_packet);
+      SendVideoPacketWithFlexfec(std::move(packet), storage, priority,
+                                 protect_packet);
     } else if (red_enabled) {
-      SendVideoPacketAsRedMaybeWithUlpfec(std::move(packet), storage,
+      SendVideoPacketAsRedMaybeWithUlpfec(std::move(packet), storage, priority,
                                           protect_packet);
     } else {
-      SendVideoPacket(std::move(packet), storage);
+      SendVideoPacket(std::move(packet), storage, priority);
     }
 
     if (first_frame) {
@@ -14,6 +14,7 @@
 #include <map>
 #include <memory>
 
+#include "api/crypto/frame_encryptor_interface.h"
 #include "api/optional.h"
 #include "common_types.h"  // NOLINT(build/include)
 #include "modules/rtp_rtcp/include/flexfec_sender.h"
@@ -22,6 +23,7 @@
 #include "modules/rtp_rtcp/source/rtp_sender.h"
 #include "modules/rtp_rtcp/source/rtp_utility.h"
 #include "modules/rtp_rtcp/source/ulpfec_generator.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/onetimeevent.h"
 #include "rtc_base/rate_statistics.h"
@@ -61,6 +63,11 @@ class RTPSenderVideo {
 
   void SetVideoCodecType(RtpVideoCodecTypes type);
 
+  // Encrypts all frames with |frame_encryptor| before packetization. H264
+  // frames can't be encrypted, since the packetizer parses the NAL units, and
+  // are dropped. Must be called before the first frame is sent.
+  void SetFrameEncryptor(FrameEncryptorInterface* frame_encryptor);
+
   // ULPFEC.
   void SetUlpfecConfig(int red_payload_type, int ulpfec_payload_type);
   void GetUlpfecConfig(int* red_payload_type, int* ulpfec_payload_type) const;
@@ -98,18 +105,29 @@ class RTPSenderVideo {
 
   size_t CalculateFecPacketOverhead() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Replaces |payload_data| and |payload_size| with the encrypted frame,
+  // stored in |encrypted_frame_|.
+  bool EncryptFrame(RtpVideoCodecTypes video_type,
+                    FrameType frame_type,
+                    uint32_t ssrc,
+                    const uint8_t** payload_data,
+                    size_t* payload_size);
+
   void SendVideoPacket(std::unique_ptr<RtpPacketToSend> packet,
-                       StorageType storage);
+                       StorageType storage,
+                       RtpPacketSender::Priority priority);
 
   void SendVideoPacketAsRedMaybeWithUlpfec(
       std::unique_ptr<RtpPacketToSend> media_packet,
       StorageType media_packet_storage,
+      RtpPacketSender::Priority media_packet_priority,
       bool protect_media_packet);
 
   // TODO(brandtr): Remove the FlexFEC functions when FlexfecSender has been
   // moved to PacedSender.
   void SendVideoPacketWithFlexfec(std::unique_ptr<RtpPacketToSend> media_packet,
                                   StorageType media_packet_storage,
+                                  RtpPacketSender::Priority media_packet_priority,
                                   bool protect_media_packet);
 
   bool red_enabled() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
@@ -159,6 +177,11 @@ class RTPSenderVideo {
       RTC_GUARDED_BY(stats_crit_);
 
   OneTimeEvent first_frame_sent_;
+
+  FrameEncryptorInterface* frame_encryptor_ = nullptr;
+  // The last encrypted frame. Only used by SendVideo, which is called on the
+  // encoder thread.
+  rtc::Buffer encrypted_frame_;
 };
 
 }  // namespace webrtc
@@ -28,6 +28,7 @@ class MockProcessThread : public ProcessThread {
   MOCK_METHOD0(Start, void());
   MOCK_METHOD0(Stop, void());
   MOCK_METHOD1(WakeUp, void(Module* module));
+  MOCK_METHOD1(RescheduleModule, void(Module* module));
   MOCK_METHOD1(PostTask, void(rtc::QueuedTask* task));
   MOCK_METHOD2(RegisterModule, void(Module* module, const rtc::Location&));
   MOCK_METHOD1(DeRegisterModule, void(Module* module));
@@ -55,6 +55,13 @@ class ProcessThread {
   // Can be called on any thread.
   virtual void WakeUp(Module* module) = 0;
 
+  // Tells the thread that the module's TimeUntilNextProcess() has changed,
+  // e.g. because it was given work sooner than it said it would need to run.
+  // The worker thread asks the module again, without calling Process(), and
+  // otherwise only asks it after each Process().
+  // Can be called on any thread.
+  virtual void RescheduleModule(Module* module) = 0;
+
   // Queues a task object to run on the worker thread.  Ownership of the
   // task object is transferred to the ProcessThread and the object will
   // either be deleted after running on the worker thread, or on the
@@ -10,9 +10,13 @@
 
 #include "modules/utility/source/process_thread_impl.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "modules/include/module.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/task_queue.h"
+#include "rtc_base/task_stats.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
 
@@ -24,6 +28,11 @@ namespace {
 // should be made, but Process() should be called directly.
 const int64_t kCallProcessImmediately = -1;
 
+// And this one, the initial value of |next_callback|, to signal that
+// TimeUntilNextProcess should be called to find out when to call Process().
+// Both sort before any actual time.
+const int64_t kQueryTimeUntilNextProcess = 0;
+
 int64_t GetNextCallbackTime(Module* module, int64_t time_now) {
   int64_t interval = module->TimeUntilNextProcess();
   if (interval < 0) {
@@ -99,8 +108,23 @@ void ProcessThreadImpl::WakeUp(Module* module) {
   {
     rtc::CritScope lock(&lock_);
     for (ModuleCallback& m : modules_) {
-      if (m.module == module)
-        m.next_callback = kCallProcessImmediately;
+      if (m.module == module && m.next_callback != kCallProcessImmediately)
+        ScheduleLocked(&m, kCallProcessImmediately);
+    }
+  }
+  wake_up_->Set();
+}
+
+void ProcessThreadImpl::RescheduleModule(Module* module) {
+  // Allowed to be called on any thread.
+  {
+    rtc::CritScope lock(&lock_);
+    for (ModuleCallback& m : modules_) {
+      // A module that is about to be processed is asked afterwards anyway.
+      if (m.module == module && m.next_callback != kCallProcessImmediately &&
+          m.next_callback != kQueryTimeUntilNextProcess) {
+        ScheduleLocked(&m, kQueryTimeUntilNextProcess);
+      }
     }
   }
   wake_up_->Set();
@@ -110,7 +134,9 @@ void ProcessThreadImpl::PostTask(std::unique_ptr<rtc::QueuedTask> task) {
   // Allowed to be called on any thread.
   {
     rtc::CritScope lock(&lock_);
-    queue_.push(task.release());
+    queue_.push(
+        rtc::TaskStats::MaybeSampleTask(std::move(task), thread_name_)
+            .release());
   }
   wake_up_->Set();
 }
@@ -141,6 +167,7 @@ void ProcessThreadImpl::RegisterModule(Module* module,
   {
     rtc::CritScope lock(&lock_);
     modules_.push_back(ModuleCallback(module, from));
+    ScheduleLocked(&modules_.back(), kQueryTimeUntilNextProcess);
   }
 
   // Wake the thread calling ProcessThreadImpl::Process() to update the
@@ -155,6 +182,13 @@ void ProcessThreadImpl::DeRegisterModule(Module* module) {
 
   {
     rtc::CritScope lock(&lock_);
+    deadlines_.erase(std::remove_if(deadlines_.begin(), deadlines_.end(),
+                                    [&module](const Deadline& d) {
+                                      return d.callback->module == module;
+                                    }),
+                     deadlines_.end());
+    std::make_heap(deadlines_.begin(), deadlines_.end(),
+                   std::greater<Deadline>());
     modules_.remove_if([&module](const ModuleCallback& m) {
         return m.module == module;
       });
@@ -178,31 +212,61 @@ bool ProcessThreadImpl::Process() {
     rtc::CritScope lock(&lock_);
     if (stop_)
       return false;
-    for (ModuleCallback& m : modules_) {
+    // Take the modules that are due off the heap first, so that each of them
+    // is processed once per wakeup, even if it asks to be called right away.
+    std::vector<ModuleCallback*> due;
+    while (!deadlines_.empty() && deadlines_.front().next_callback <= now) {
+      std::pop_heap(deadlines_.begin(), deadlines_.end(),
+                    std::greater<Deadline>());
+      const Deadline deadline = deadlines_.back();
+      deadlines_.pop_back();
+      if (deadline.generation == deadline.callback->generation)
+        due.push_back(deadline.callback);
+    }
+
+    for (ModuleCallback* m : due) {
       // TODO(tommi): Would be good to measure the time TimeUntilNextProcess
       // takes and dcheck if it takes too long (e.g. >=10ms).  Ideally this
       // operation should not require taking a lock, so querying all modules
       // should run in a matter of nanoseconds.
-      if (m.next_callback == 0)
-        m.next_callback = GetNextCallbackTime(m.module, now);
+      if (m->next_callback == kQueryTimeUntilNextProcess)
+        m->next_callback = GetNextCallbackTime(m->module, now);
 
-      if (m.next_callback <= now ||
-          m.next_callback == kCallProcessImmediately) {
+      if (m->next_callback <= now ||
+          m->next_callback == kCallProcessImmediately) {
         {
           TRACE_EVENT2("webrtc", "ModuleProcess", "function",
-                       m.location.function_name(), "file",
-                       m.location.file_and_line());
-          m.module->Process();
+                       m->location.function_name(), "file",
+                       m->location.file_and_line());
+          if (rtc::TaskStats::ShouldSample()) {
+            const int64_t start_time_us = rtc::TimeMicros();
+            m->module->Process();
+            const int64_t wait_time_us =
+                m->next_callback == kCallProcessImmediately
+                    ? 0
+                    : start_time_us - m->next_callback * 1000;
+            rtc::TaskStats::AddSample(
+                thread_name_, m->location.function_name(),
+                m->location.file_and_line(), wait_time_us,
+                rtc::TimeMicros() - start_time_us,
+                static_cast<int>(queue_.size()));
+          } else {
+            m->module->Process();
+          }
         }
         // Use a new 'now' reference to calculate when the next callback
         // should occur.  We'll continue to use 'now' above for the baseline
         // of calculating how long we should wait, to reduce variance.
         int64_t new_now = rtc::TimeMillis();
-        m.next_callback = GetNextCallbackTime(m.module, new_now);
+        ScheduleLocked(m, GetNextCallbackTime(m->module, new_now));
+      } else {
+        ScheduleLocked(m, m->next_callback);
       }
+    }
 
-      if (m.next_callback < next_checkpoint)
-        next_checkpoint = m.next_callback;
+    if (!deadlines_.empty() &&
+        deadlines_.front().next_callback < next_checkpoint) {
+      next_checkpoint = deadlines_.front().next_callback;
     }
 
     while (!queue_.empty()) {
@@ -221,4 +285,25 @@ bool ProcessThreadImpl::Process() {
 
   return true;
 }
+
+void ProcessThreadImpl::ScheduleLocked(ModuleCallback* callback,
+                                       int64_t next_callback) {
+  callback->next_callback = next_callback;
+  ++callback->generation;
+  // Modules that are woken up often leave stale entries behind faster than
+  // their deadlines pop them.
+  if (deadlines_.size() > 2 * modules_.size() + 16) {
+    deadlines_.erase(std::remove_if(deadlines_.begin(), deadlines_.end(),
+                                    [](const Deadline& d) {
+                                      return d.generation !=
+                                             d.callback->generation;
+                                    }),
+                     deadlines_.end());
+    std::make_heap(deadlines_.begin(), deadlines_.end(),
+                   std::greater<Deadline>());
+  }
+  deadlines_.push_back({next_callback, callback, callback->generation});
+  std::push_heap(deadlines_.begin(), deadlines_.end(),
+                 std::greater<Deadline>());
+}
 }  // namespace webrtc
@@ -14,6 +14,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "modules/utility/include/process_thread.h"
 #include "rtc_base/criticalsection.h"
@@ -34,6 +35,7 @@ class ProcessThreadImpl : public ProcessThread {
   void Stop() override;
 
   void WakeUp(Module* module) override;
+  void RescheduleModule(Module* module) override;
   void PostTask(std::unique_ptr<rtc::QueuedTask> task) override;
 
   void RegisterModule(Module* module, const rtc::Location& from) override;
@@ -56,6 +58,8 @@ class ProcessThreadImpl : public ProcessThread {
 
     Module* const module;
     int64_t next_callback = 0;  // Absolute timestamp.
+    // Tells the current entry of the module in |deadlines_| from stale ones.
+    uint32_t generation = 0;
     const rtc::Location location;
 
    private:
@@ -64,6 +68,23 @@ class ProcessThreadImpl : public ProcessThread {
 
   typedef std::list<ModuleCallback> ModuleList;
 
+  // An entry of the min-heap |deadlines_|, ordered by |next_callback|. The
+  // entries of a module that has been rescheduled since are left in the heap
+  // and skipped when they come up, since a heap can't find them.
+  struct Deadline {
+    int64_t next_callback;
+    ModuleCallback* callback;
+    uint32_t generation;
+
+    bool operator>(const Deadline& other) const {
+      return next_callback > other.next_callback;
+    }
+  };
+
+  // Sets when |callback| is due next, and pushes the entry for it.
+  void ScheduleLocked(ModuleCallback* callback, int64_t next_callback)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Warning: For some reason, if |lock_| comes immediately before |modules_|
   // with the current class layout, we will  start to have mysterious crashes
   // on Mac 10.9 debug.  I (Tommi) suspect we're hitting some obscure alignemnt
@@ -78,6 +99,9 @@ class ProcessThreadImpl : public ProcessThread {
   std::unique_ptr<rtc::PlatformThread> thread_;
 
   ModuleList modules_;
+  // So that a wakeup only touches the modules that are due, rather than
+  // visiting all of them.
+  std::vector<Deadline> deadlines_ RTC_GUARDED_BY(lock_);
   std::queue<rtc::QueuedTask*> queue_;
   bool stop_;
   const char* thread_name_;
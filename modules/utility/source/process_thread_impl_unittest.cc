@@ -306,6 +306,73 @@ TEST(ProcessThreadImpl, WakeUp) {
   EXPECT_LE(diff, 100u);
 }
 
+// Tests that rescheduling a module makes the thread ask it again when it
+// wants to be called back, without calling Process() first.
+TEST(ProcessThreadImpl, RescheduleModule) {
+  ProcessThreadImpl thread("ProcessThread");
+  thread.Start();
+
+  std::unique_ptr<EventWrapper> started(EventWrapper::Create());
+  std::unique_ptr<EventWrapper> called(EventWrapper::Create());
+
+  MockModule module;
+  int64_t start_time;
+  int64_t called_time;
+
+  {
+    InSequence sequence;
+    EXPECT_CALL(module, ProcessThreadAttached(&thread)).Times(1);
+    EXPECT_CALL(module, TimeUntilNextProcess())
+        .WillOnce(DoAll(SetTimestamp(&start_time), SetEvent(started.get()),
+                        Return(1000)));
+    EXPECT_CALL(module, TimeUntilNextProcess()).WillOnce(Return(0));
+    EXPECT_CALL(module, Process())
+        .WillOnce(DoAll(SetTimestamp(&called_time), SetEvent(called.get()),
+                        Return()));
+    EXPECT_CALL(module, TimeUntilNextProcess()).WillOnce(Return(1000));
+  }
+
+  thread.RegisterModule(&module, RTC_FROM_HERE);
+
+  EXPECT_EQ(kEventSignaled, started->Wait(kEventWaitTimeout));
+  thread.RescheduleModule(&module);
+  EXPECT_EQ(kEventSignaled, called->Wait(kEventWaitTimeout));
+
+  EXPECT_CALL(module, ProcessThreadAttached(nullptr)).Times(1);
+  thread.Stop();
+
+  EXPECT_GE(called_time, start_time);
+  EXPECT_LE(called_time - start_time, 100);
+}
+
+// Tests that a module that isn't due is left alone while other modules are
+// processed.
+TEST(ProcessThreadImpl, ModuleThatIsNotDueIsNotQueried) {
+  ProcessThreadImpl thread("ProcessThread");
+  std::unique_ptr<EventWrapper> event(EventWrapper::Create());
+
+  MockModule idle_module;
+  EXPECT_CALL(idle_module, TimeUntilNextProcess()).WillOnce(Return(10000));
+  EXPECT_CALL(idle_module, Process()).Times(0);
+  EXPECT_CALL(idle_module, ProcessThreadAttached(_)).Times(2);
+
+  int process_count = 0;
+  MockModule busy_module;
+  EXPECT_CALL(busy_module, TimeUntilNextProcess()).WillRepeatedly(Return(1));
+  EXPECT_CALL(busy_module, Process())
+      .WillRepeatedly(DoAll(Increment(&process_count), Invoke([&] {
+                              if (process_count == 10)
+                                event->Set();
+                            })));
+  EXPECT_CALL(busy_module, ProcessThreadAttached(_)).Times(2);
+
+  thread.RegisterModule(&idle_module, RTC_FROM_HERE);
+  thread.RegisterModule(&busy_module, RTC_FROM_HERE);
+  thread.Start();
+  EXPECT_EQ(kEventSignaled, event->Wait(kEventWaitTimeout));
+  thread.Stop();
+}
+
 // Tests that we can post a task that gets run straight away on the worker
 // thread.
 TEST(ProcessThreadImpl, PostTask) {
@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <new>
+#include <utility>
 
 #include "media/base/videocommon.h"
 #include "rtc_base/logging.h"
@@ -31,6 +32,25 @@
 
 namespace webrtc {
 namespace videocapturemodule {
+
+class VideoCaptureModuleV4L2::DecodeTask : public rtc::QueuedTask {
+ public:
+  DecodeTask(VideoCaptureModuleV4L2* module,
+             std::unique_ptr<rtc::Buffer> frame,
+             const VideoCaptureCapability& frameInfo)
+      : module_(module), frame_(std::move(frame)), frame_info_(frameInfo) {}
+
+ private:
+  bool Run() override {
+    module_->DecodeFrame(std::move(frame_), frame_info_);
+    return true;
+  }
+
+  VideoCaptureModuleV4L2* const module_;
+  std::unique_ptr<rtc::Buffer> frame_;
+  const VideoCaptureCapability frame_info_;
+};
+
 rtc::scoped_refptr<VideoCaptureModule> VideoCaptureImpl::Create(
     const char* deviceUniqueId) {
   rtc::scoped_refptr<VideoCaptureModuleV4L2> implementation(
@@ -52,7 +72,9 @@ VideoCaptureModuleV4L2::VideoCaptureModuleV4L2()
       _currentFrameRate(-1),
       _captureStarted(false),
       _captureVideoType(VideoType::kI420),
-      _pool(NULL) {}
+      _pool(NULL),
+      _pendingDecodes(0),
+      _droppedDecodes(0) {}
 
 int32_t VideoCaptureModuleV4L2::Init(const char* deviceUniqueIdUTF8) {
   int len = strlen((const char*)deviceUniqueIdUTF8);
@@ -126,21 +148,23 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
 
   // Supported video formats in preferred order.
   // If the requested resolution is larger than VGA, we prefer MJPEG. Go for
-  // I420 otherwise.
-  const int nFormats = 5;
+  // I420 otherwise. NV12 is passed on without conversion.
+  const int nFormats = 6;
   unsigned int fmts[nFormats];
   if (capability.width > 640 || capability.height > 480) {
     fmts[0] = V4L2_PIX_FMT_MJPEG;
-    fmts[1] = V4L2_PIX_FMT_YUV420;
-    fmts[2] = V4L2_PIX_FMT_YUYV;
-    fmts[3] = V4L2_PIX_FMT_UYVY;
-    fmts[4] = V4L2_PIX_FMT_JPEG;
+    fmts[1] = V4L2_PIX_FMT_NV12;
+    fmts[2] = V4L2_PIX_FMT_YUV420;
+    fmts[3] = V4L2_PIX_FMT_YUYV;
+    fmts[4] = V4L2_PIX_FMT_UYVY;
+    fmts[5] = V4L2_PIX_FMT_JPEG;
   } else {
     fmts[0] = V4L2_PIX_FMT_YUV420;
-    fmts[1] = V4L2_PIX_FMT_YUYV;
-    fmts[2] = V4L2_PIX_FMT_UYVY;
-    fmts[3] = V4L2_PIX_FMT_MJPEG;
-    fmts[4] = V4L2_PIX_FMT_JPEG;
+    fmts[1] = V4L2_PIX_FMT_NV12;
+    fmts[2] = V4L2_PIX_FMT_YUYV;
+    fmts[3] = V4L2_PIX_FMT_UYVY;
+    fmts[4] = V4L2_PIX_FMT_MJPEG;
+    fmts[5] = V4L2_PIX_FMT_JPEG;
   }
 
   // Enumerate image formats.
@@ -183,6 +207,8 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
     _captureVideoType = VideoType::kYUY2;
   else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_YUV420)
     _captureVideoType = VideoType::kI420;
+  else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_NV12)
+    _captureVideoType = VideoType::kNV12;
   else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_UYVY)
     _captureVideoType = VideoType::kUYVY;
   else if (video_fmt.fmt.pix.pixelformat == V4L2_PIX_FMT_MJPEG ||
@@ -239,6 +265,11 @@ int32_t VideoCaptureModuleV4L2::StartCapture(
     return -1;
   }
 
+  _decodeQueue.reset(_captureVideoType == VideoType::kMJPEG
+                         ? new rtc::TaskQueue("V4L2MjpegDecode",
+                                              rtc::TaskQueue::Priority::HIGH)
+                         : nullptr);
+
   // start capture thread;
   if (!_captureThread) {
     _captureThread.reset(new rtc::PlatformThread(
@@ -265,6 +296,18 @@ int32_t VideoCaptureModuleV4L2::StopCapture() {
     _captureThread->Stop();
     _captureThread.reset();
   }
+  // Waits for the frame that is being decoded, if any, and drops the rest.
+  _decodeQueue.reset();
+  {
+    rtc::CritScope cs(&_decodeCritSect);
+    if (_droppedDecodes > 0) {
+      RTC_LOG(LS_INFO) << "Dropped " << _droppedDecodes
+                       << " MJPEG frames that the decoder didn't keep up with";
+    }
+    _freeDecodeBuffers.clear();
+    _pendingDecodes = 0;
+    _droppedDecodes = 0;
+  }
 
   rtc::CritScope cs(&_captureCritSect);
   if (_captureStarted) {
@@ -398,8 +441,13 @@ bool VideoCaptureModuleV4L2::CaptureProcess() {
     frameInfo.videoType = _captureVideoType;
 
     // convert to to I420 if needed
-    IncomingFrame((unsigned char*)_pool[buf.index].start, buf.bytesused,
-                  frameInfo);
+    if (_decodeQueue) {
+      PostDecode(static_cast<const uint8_t*>(_pool[buf.index].start),
+                 buf.bytesused, frameInfo);
+    } else {
+      IncomingFrame((unsigned char*)_pool[buf.index].start, buf.bytesused,
+                    frameInfo);
+    }
     // enqueue the buffer again
     if (ioctl(_deviceFd, VIDIOC_QBUF, &buf) == -1) {
       RTC_LOG(LS_INFO) << "Failed to enqueue capture buffer";
@@ -409,6 +457,39 @@ bool VideoCaptureModuleV4L2::CaptureProcess() {
   return true;
 }
 
+void VideoCaptureModuleV4L2::PostDecode(
+    const uint8_t* data,
+    size_t length,
+    const VideoCaptureCapability& frameInfo) {
+  std::unique_ptr<rtc::Buffer> frame;
+  {
+    rtc::CritScope cs(&_decodeCritSect);
+    if (_pendingDecodes >= kMaxPendingDecodes) {
+      ++_droppedDecodes;
+      return;
+    }
+    ++_pendingDecodes;
+    if (!_freeDecodeBuffers.empty()) {
+      frame = std::move(_freeDecodeBuffers.back());
+      _freeDecodeBuffers.pop_back();
+    }
+  }
+  if (!frame)
+    frame.reset(new rtc::Buffer());
+  frame->SetData(data, length);
+  _decodeQueue->PostTask(std::unique_ptr<rtc::QueuedTask>(
+      new DecodeTask(this, std::move(frame), frameInfo)));
+}
+
+void VideoCaptureModuleV4L2::DecodeFrame(
+    std::unique_ptr<rtc::Buffer> frame,
+    const VideoCaptureCapability& frameInfo) {
+  IncomingFrame(frame->data(), frame->size(), frameInfo);
+  rtc::CritScope cs(&_decodeCritSect);
+  --_pendingDecodes;
+  _freeDecodeBuffers.push_back(std::move(frame));
+}
+
 int32_t VideoCaptureModuleV4L2::CaptureSettings(
     VideoCaptureCapability& settings) {
   settings.width = _currentWidth;
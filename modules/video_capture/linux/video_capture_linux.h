@@ -12,11 +12,14 @@
 #define MODULES_VIDEO_CAPTURE_MAIN_SOURCE_LINUX_VIDEO_CAPTURE_LINUX_H_
 
 #include <memory>
+#include <vector>
 
 #include "common_types.h"  // NOLINT(build/include)
 #include "modules/video_capture/video_capture_impl.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/platform_thread.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc
 {
@@ -35,11 +38,24 @@ public:
 
 private:
     enum {kNoOfV4L2Bufffers=4};
+    // MJPEG frames that may wait for the decoder, beyond which new frames
+    // are dropped so that the latency doesn't build up.
+    enum {kMaxPendingDecodes=2};
+
+    class DecodeTask;
 
     static bool CaptureThread(void*);
     bool CaptureProcess();
     bool AllocateVideoBuffers();
     bool DeAllocateVideoBuffers();
+    // Copies the compressed frame and posts it to |_decodeQueue|, so that
+    // the capture thread can give the V4L2 buffer back to the driver while
+    // the previous frame is still being decoded.
+    void PostDecode(const uint8_t* data,
+                    size_t length,
+                    const VideoCaptureCapability& frameInfo);
+    void DecodeFrame(std::unique_ptr<rtc::Buffer> frame,
+                     const VideoCaptureCapability& frameInfo);
 
     // TODO(pbos): Stop using unique_ptr and resetting the thread.
     std::unique_ptr<rtc::PlatformThread> _captureThread;
@@ -60,6 +76,14 @@ private:
         size_t length;
     };
     Buffer *_pool;
+
+    // Only while capturing MJPEG.
+    std::unique_ptr<rtc::TaskQueue> _decodeQueue;
+    rtc::CriticalSection _decodeCritSect;
+    std::vector<std::unique_ptr<rtc::Buffer>> _freeDecodeBuffers
+        RTC_GUARDED_BY(_decodeCritSect);
+    int _pendingDecodes RTC_GUARDED_BY(_decodeCritSect);
+    int _droppedDecodes RTC_GUARDED_BY(_decodeCritSect);
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
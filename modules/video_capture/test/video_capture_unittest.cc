@@ -15,6 +15,7 @@
 #include <sstream>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "api/video/video_frame.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/utility/include/process_thread.h"
@@ -129,6 +130,11 @@ class TestVideoCaptureCallback
                                         frame.video_frame_buffer());
   }
 
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> last_frame() {
+    rtc::CritScope cs(&capture_cs_);
+    return last_frame_;
+  }
+
   void SetExpectedCaptureRotation(webrtc::VideoRotation rotation) {
     rtc::CritScope cs(&capture_cs_);
     rotate_frame_ = rotation;
@@ -419,3 +425,37 @@ TEST_F(VideoCaptureExternalTest, Rotation) {
   EXPECT_EQ(0, capture_input_interface_->IncomingFrame(test_buffer.get(),
     length, capture_callback_.capability(), 0));
 }
+
+// NV12 input is passed on as NV12, unless the module has to rotate it.
+TEST_F(VideoCaptureExternalTest, PassesOnNV12) {
+  rtc::scoped_refptr<webrtc::NV12Buffer> nv12 = webrtc::NV12Buffer::Copy(
+      *test_frame_->video_frame_buffer()->GetI420());
+  const size_t y_size = kTestWidth * kTestHeight;
+  const size_t uv_size = kTestWidth * nv12->ChromaHeight();
+  std::unique_ptr<uint8_t[]> test_buffer(new uint8_t[y_size + uv_size]);
+  for (int row = 0; row < kTestHeight; ++row) {
+    memcpy(test_buffer.get() + row * kTestWidth,
+           nv12->DataY() + row * nv12->StrideY(), kTestWidth);
+  }
+  for (int row = 0; row < nv12->ChromaHeight(); ++row) {
+    memcpy(test_buffer.get() + y_size + row * kTestWidth,
+           nv12->DataUV() + row * nv12->StrideUV(), kTestWidth);
+  }
+  VideoCaptureCapability capability = capture_callback_.capability();
+  capability.videoType = webrtc::VideoType::kNV12;
+
+  EXPECT_EQ(0, capture_input_interface_->IncomingFrame(
+                   test_buffer.get(), y_size + uv_size, capability, 0));
+  rtc::scoped_refptr<webrtc::VideoFrameBuffer> frame =
+      capture_callback_.last_frame();
+  ASSERT_EQ(webrtc::VideoFrameBuffer::Type::kNV12, frame->type());
+  EXPECT_TRUE(webrtc::test::FrameBufsEqual(test_frame_->video_frame_buffer(),
+                                           frame->ToI420()));
+
+  EXPECT_TRUE(capture_module_->SetApplyRotation(true));
+  EXPECT_EQ(0, capture_module_->SetCaptureRotation(webrtc::kVideoRotation_180));
+  EXPECT_EQ(0, capture_input_interface_->IncomingFrame(
+                   test_buffer.get(), y_size + uv_size, capability, 0));
+  EXPECT_EQ(webrtc::VideoFrameBuffer::Type::kI420,
+            capture_callback_.last_frame()->type());
+}
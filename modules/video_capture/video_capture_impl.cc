@@ -11,6 +11,7 @@
 #include <stdlib.h>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/include/module_common_types.h"
 #include "modules/video_capture/video_capture_config.h"
@@ -140,8 +141,6 @@ int32_t VideoCaptureImpl::IncomingFrame(uint8_t* videoFrame,
     return -1;
   }
 
-  int stride_y = width;
-  int stride_uv = (width + 1) / 2;
   int target_width = width;
   int target_height = height;
 
@@ -157,13 +156,37 @@ int32_t VideoCaptureImpl::IncomingFrame(uint8_t* videoFrame,
     }
   }
 
+  // NV12 that doesn't need to be rotated is copied as is.
+  if (frameInfo.videoType == VideoType::kNV12 && height > 0 &&
+      (!apply_rotation || _rotateFrame == kVideoRotation_0)) {
+    rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+        nv12_buffer_pool_.CreateBuffer(width, height);
+    if (!nv12_buffer) {
+      RTC_LOG(LS_WARNING) << "Dropping a captured frame, no free buffer.";
+      return -1;
+    }
+    libyuv::CopyPlane(videoFrame, width, nv12_buffer->MutableDataY(),
+                      nv12_buffer->StrideY(), width, height);
+    libyuv::CopyPlane(videoFrame + width * height, 2 * ((width + 1) / 2),
+                      nv12_buffer->MutableDataUV(), nv12_buffer->StrideUV(),
+                      2 * ((width + 1) / 2), (height + 1) / 2);
+    VideoFrame captureFrame(nv12_buffer, 0, rtc::TimeMillis(),
+                            !apply_rotation ? _rotateFrame : kVideoRotation_0);
+    captureFrame.set_ntp_time_ms(captureTime);
+    DeliverCapturedFrame(captureFrame);
+    return 0;
+  }
+
   // Setting absolute height (in case it was negative).
   // In Windows, the image starts bottom left, instead of top left.
   // Setting a negative source height, inverts the image (within LibYuv).
 
-  // TODO(nisse): Use a pool?
-  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(
-      target_width, abs(target_height), stride_y, stride_uv, stride_uv);
+  rtc::scoped_refptr<I420Buffer> buffer =
+      buffer_pool_.CreateBuffer(target_width, abs(target_height));
+  if (!buffer) {
+    RTC_LOG(LS_WARNING) << "Dropping a captured frame, no free buffer.";
+    return -1;
+  }
 
   libyuv::RotationMode rotation_mode = libyuv::kRotate0;
   if (apply_rotation) {
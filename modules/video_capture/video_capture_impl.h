@@ -16,6 +16,8 @@
  */
 
 #include "api/video/video_frame.h"
+#include "common_video/include/i420_buffer_pool.h"
+#include "common_video/include/nv12_buffer_pool.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/video_capture/video_capture.h"
 #include "modules/video_capture/video_capture_config.h"
@@ -114,6 +116,13 @@ private:
 
     // Indicate whether rotation should be applied before delivered externally.
     bool apply_rotation_;
+
+    // The frames are converted into these, guarded by |_apiCs|, rather than
+    // into a buffer that is allocated, and faulted in, for every frame.
+    I420BufferPool buffer_pool_;
+    // NV12 frames that don't need to be rotated are passed on as NV12, for
+    // the encoders that take it.
+    NV12BufferPool nv12_buffer_pool_;
 };
 }  // namespace videocapturemodule
 }  // namespace webrtc
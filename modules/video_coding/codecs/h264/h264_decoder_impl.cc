@@ -13,6 +13,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <string>
 
 extern "C" {
 #include "third_party/ffmpeg/libavcodec/avcodec.h"
@@ -26,6 +27,7 @@ extern "C" {
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
+#include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
 
 namespace webrtc {
@@ -38,6 +40,8 @@ const size_t kYPlaneIndex = 0;
 const size_t kUPlaneIndex = 1;
 const size_t kVPlaneIndex = 2;
 
+const char kH264DecoderThreadingFieldTrial[] = "WebRTC-H264DecoderThreading";
+
 // Used by histograms. Values of entries should not be changed.
 enum H264DecoderImplEvent {
   kH264DecoderEventInit = 0,
@@ -88,6 +92,19 @@ void InitializeFFmpeg() {
 
 #endif  // defined(WEBRTC_INITIALIZE_FFMPEG)
 
+// Uses more threads for larger frames, when there are cores for them.
+int NumberOfDecoderThreads(int width, int height, int number_of_cores) {
+  if (width * height >= 3840 * 2160 && number_of_cores >= 8) {
+    return 8;  // 8 threads for 4K on high perf machines.
+  } else if (width * height >= 1920 * 1080 && number_of_cores >= 4) {
+    return 4;  // 4 threads for 1080p.
+  } else if (width * height >= 1280 * 720 && number_of_cores >= 3) {
+    return 2;  // 2 threads for HD.
+  } else {
+    return 1;  // 1 thread for qHD or less.
+  }
+}
+
 }  // namespace
 
 int H264DecoderImpl::AVGetBuffer2(
@@ -135,8 +152,11 @@ int H264DecoderImpl::AVGetBuffer2(
   // http://crbug.com/390941. Our pool is set up to zero-initialize new buffers.
   // TODO(nisse): Delete that feature from the video pool, instead add
   // an explicit call to InitializeData here.
-  rtc::scoped_refptr<I420Buffer> frame_buffer =
-      decoder->pool_.CreateBuffer(width, height);
+  rtc::scoped_refptr<I420Buffer> frame_buffer;
+  {
+    rtc::CritScope lock(&decoder->pool_lock_);
+    frame_buffer = decoder->pool_.CreateBuffer(width, height);
+  }
 
   int y_size = width * height;
   int uv_size = frame_buffer->ChromaWidth() * frame_buffer->ChromaHeight();
@@ -181,12 +201,25 @@ void H264DecoderImpl::AVFreeBuffer2(void* opaque, uint8_t* data) {
   delete video_frame;
 }
 
-H264DecoderImpl::H264DecoderImpl() : pool_(true),
-                                     decoded_image_callback_(nullptr),
-                                     has_reported_init_(false),
-                                     has_reported_error_(false) {
+H264DecoderImpl::ThreadingMode H264DecoderImpl::ThreadingModeFromFieldTrial() {
+  const std::string group =
+      field_trial::FindFullName(kH264DecoderThreadingFieldTrial);
+  if (group.find("Disabled") == 0)
+    return ThreadingMode::kDisabled;
+  if (group.find("Frame") == 0)
+    return ThreadingMode::kFrame;
+  return ThreadingMode::kSlice;
 }
 
+H264DecoderImpl::H264DecoderImpl()
+    : threading_mode_(ThreadingModeFromFieldTrial()),
+      number_of_cores_(1),
+      number_of_threads_(1),
+      pool_(true),
+      decoded_image_callback_(nullptr),
+      has_reported_init_(false),
+      has_reported_error_(false) {}
+
 H264DecoderImpl::~H264DecoderImpl() {
   Release();
 }
@@ -220,23 +253,48 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
   }
   RTC_DCHECK(!av_context_);
 
-  // Initialize AVCodecContext.
+  number_of_cores_ = number_of_cores;
+  int width = codec_settings ? codec_settings->width : 0;
+  int height = codec_settings ? codec_settings->height : 0;
+  ret = OpenContext(width, height,
+                    threading_mode_ == ThreadingMode::kDisabled
+                        ? 1
+                        : NumberOfDecoderThreads(width, height,
+                                                 number_of_cores_));
+  if (ret != WEBRTC_VIDEO_CODEC_OK) {
+    ReportError();
+    return ret;
+  }
+
+  av_frame_.reset(av_frame_alloc());
+  return WEBRTC_VIDEO_CODEC_OK;
+}
+
+int32_t H264DecoderImpl::OpenContext(int width,
+                                     int height,
+                                     int number_of_threads) {
+  // Initialize AVCodecContext. Replacing a previous context joins its
+  // threads.
   av_context_.reset(avcodec_alloc_context3(nullptr));
 
   av_context_->codec_type = AVMEDIA_TYPE_VIDEO;
   av_context_->codec_id = AV_CODEC_ID_H264;
-  if (codec_settings) {
-    av_context_->coded_width = codec_settings->width;
-    av_context_->coded_height = codec_settings->height;
-  }
+  av_context_->coded_width = width;
+  av_context_->coded_height = height;
   av_context_->pix_fmt = kPixelFormatDefault;
   av_context_->extradata = nullptr;
   av_context_->extradata_size = 0;
 
-  // If this is ever increased, look at |av_context_->thread_safe_callbacks| and
-  // make it possible to disable the thread checker in the frame buffer pool.
-  av_context_->thread_count = 1;
-  av_context_->thread_type = FF_THREAD_SLICE;
+  av_context_->thread_count = number_of_threads;
+  if (threading_mode_ == ThreadingMode::kFrame) {
+    av_context_->thread_type = FF_THREAD_FRAME;
+    // Lets the frame threads get their buffers from |AVGetBuffer2|
+    // themselves, instead of waiting for the thread calling |Decode|.
+    av_context_->thread_safe_callbacks = 1;
+  } else {
+    av_context_->thread_type = FF_THREAD_SLICE;
+  }
+  number_of_threads_ = number_of_threads;
 
   // Function used by FFmpeg to get buffers to store decoded frames in.
   av_context_->get_buffer2 = AVGetBuffer2;
@@ -249,22 +307,25 @@ int32_t H264DecoderImpl::InitDecode(const VideoCodec* codec_settings,
     // This is an indication that FFmpeg has not been initialized or it has not
     // been compiled/initialized with the correct set of codecs.
     RTC_LOG(LS_ERROR) << "FFmpeg H.264 decoder not found.";
-    Release();
-    ReportError();
+    av_context_.reset();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   int res = avcodec_open2(av_context_.get(), codec, nullptr);
   if (res < 0) {
     RTC_LOG(LS_ERROR) << "avcodec_open2 error: " << res;
-    Release();
-    ReportError();
+    av_context_.reset();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
-
-  av_frame_.reset(av_frame_alloc());
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
+void H264DecoderImpl::DrainFrames() {
+  if (avcodec_send_packet(av_context_.get(), nullptr) < 0)
+    return;
+  while (avcodec_receive_frame(av_context_.get(), av_frame_.get()) == 0)
+    DeliverFrame(rtc::nullopt);
+}
+
 int32_t H264DecoderImpl::Release() {
   av_context_.reset();
   av_frame_.reset();
@@ -322,8 +383,33 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   packet.size = static_cast<int>(input_image._length);
-  int64_t frame_timestamp_us = input_image.ntp_time_ms_ * 1000;  // ms -> μs
-  av_context_->reordered_opaque = frame_timestamp_us;
+
+  // Picks the number of threads on key frames, where a new context doesn't
+  // miss any references.
+  if (threading_mode_ != ThreadingMode::kDisabled &&
+      input_image._frameType == kVideoFrameKey &&
+      input_image._encodedWidth > 0 && input_image._encodedHeight > 0) {
+    const int width = static_cast<int>(input_image._encodedWidth);
+    const int height = static_cast<int>(input_image._encodedHeight);
+    const int number_of_threads =
+        NumberOfDecoderThreads(width, height, number_of_cores_);
+    if (number_of_threads != number_of_threads_) {
+      RTC_LOG(LS_INFO) << "Decoding " << width << "x" << height << " with "
+                       << number_of_threads << " threads.";
+      if (threading_mode_ == ThreadingMode::kFrame)
+        DrainFrames();
+      int32_t ret = OpenContext(width, height, number_of_threads);
+      if (ret != WEBRTC_VIDEO_CODEC_OK) {
+        Release();
+        ReportError();
+        return ret;
+      }
+    }
+  }
+
+  // The RTP timestamp identifies the input frame of a decoded frame, which
+  // with frame threading is returned by a later call.
+  av_context_->reordered_opaque = input_image._timeStamp;
 
   int result = avcodec_send_packet(av_context_.get(), &packet);
   if (result < 0) {
@@ -332,17 +418,44 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
 
-  result = avcodec_receive_frame(av_context_.get(), av_frame_.get());
-  if (result < 0) {
+  rtc::Optional<uint8_t> qp;
+  // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
+  h264_bitstream_parser_.ParseBitstream(input_image._buffer,
+                                        input_image._length);
+  int qp_int;
+  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
+    qp.emplace(qp_int);
+  }
+
+  bool has_output = false;
+  while (true) {
+    result = avcodec_receive_frame(av_context_.get(), av_frame_.get());
+    if (result == AVERROR(EAGAIN))
+      break;
+    if (result < 0) {
+      RTC_LOG(LS_ERROR) << "avcodec_receive_frame error: " << result;
+      ReportError();
+      return WEBRTC_VIDEO_CODEC_ERROR;
+    }
+    // We don't expect reordering, but frame threading delays the output.
+    RTC_DCHECK(threading_mode_ == ThreadingMode::kFrame ||
+               av_frame_->reordered_opaque == input_image._timeStamp);
+    DeliverFrame(av_frame_->reordered_opaque == input_image._timeStamp
+                     ? qp
+                     : rtc::nullopt);
+    has_output = true;
+  }
+  // Frame threads return the frame later.
+  if (!has_output && (threading_mode_ != ThreadingMode::kFrame ||
+                      number_of_threads_ == 1)) {
     RTC_LOG(LS_ERROR) << "avcodec_receive_frame error: " << result;
     ReportError();
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
+  return WEBRTC_VIDEO_CODEC_OK;
+}
 
-  // We don't expect reordering. Decoded frame tamestamp should match
-  // the input one.
-  RTC_DCHECK_EQ(av_frame_->reordered_opaque, frame_timestamp_us);
-
+void H264DecoderImpl::DeliverFrame(rtc::Optional<uint8_t> qp) {
   // Obtain the |video_frame| containing the decoded image.
   VideoFrame* video_frame = static_cast<VideoFrame*>(
       av_buffer_get_opaque(av_frame_->buf[0]));
@@ -352,16 +465,8 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
   RTC_CHECK_EQ(av_frame_->data[kYPlaneIndex], i420_buffer->DataY());
   RTC_CHECK_EQ(av_frame_->data[kUPlaneIndex], i420_buffer->DataU());
   RTC_CHECK_EQ(av_frame_->data[kVPlaneIndex], i420_buffer->DataV());
-  video_frame->set_timestamp(input_image._timeStamp);
-
-  rtc::Optional<uint8_t> qp;
-  // TODO(sakal): Maybe it is possible to get QP directly from FFmpeg.
-  h264_bitstream_parser_.ParseBitstream(input_image._buffer,
-                                        input_image._length);
-  int qp_int;
-  if (h264_bitstream_parser_.GetLastSliceQp(&qp_int)) {
-    qp.emplace(qp_int);
-  }
+  video_frame->set_timestamp(
+      static_cast<uint32_t>(av_frame_->reordered_opaque));
 
   // The decoded image may be larger than what is supposed to be visible, see
   // |AVGetBuffer2|'s use of |avcodec_align_dimensions|. This crops the image
@@ -387,15 +492,16 @@ int32_t H264DecoderImpl::Decode(const EncodedImage& input_image,
   }
   // Stop referencing it, possibly freeing |video_frame|.
   av_frame_unref(av_frame_.get());
-  video_frame = nullptr;
-
-  return WEBRTC_VIDEO_CODEC_OK;
 }
 
 const char* H264DecoderImpl::ImplementationName() const {
   return "FFmpeg";
 }
 
+int H264DecoderImpl::NumberOfThreads() const {
+  return number_of_threads_;
+}
+
 bool H264DecoderImpl::IsInitialized() const {
   return av_context_ != nullptr;
 }
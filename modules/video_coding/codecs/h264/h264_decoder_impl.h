@@ -20,8 +20,11 @@ extern "C" {
 #include "third_party/ffmpeg/libavcodec/avcodec.h"
 }  // extern "C"
 
+#include "api/optional.h"
 #include "common_video/h264/h264_bitstream_parser.h"
 #include "common_video/include/i420_buffer_pool.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
 
@@ -32,6 +35,14 @@ struct AVFrameDeleter {
   void operator()(AVFrame* ptr) const { av_frame_free(&ptr); }
 };
 
+// Decodes with FFmpeg. The number of decoding threads is chosen by the
+// resolution of the last key frame and the number of cores, and FFmpeg is
+// reopened on a key frame that changes it. By default the threads decode
+// slices of the same frame, which adds no delay but only helps streams with
+// several slices per frame. The "WebRTC-H264DecoderThreading" field trial
+// group "Frame" makes them decode consecutive frames instead, which helps
+// any stream but delays the output by a frame per extra thread, and the group
+// "Disabled" decodes on the calling thread only.
 class H264DecoderImpl : public H264Decoder {
  public:
   H264DecoderImpl();
@@ -54,7 +65,11 @@ class H264DecoderImpl : public H264Decoder {
 
   const char* ImplementationName() const override;
 
+  int NumberOfThreads() const override;
+
  private:
+  enum class ThreadingMode { kDisabled, kSlice, kFrame };
+
   // Called by FFmpeg when it needs a frame buffer to store decoded frames in.
   // The |VideoFrame| returned by FFmpeg at |Decode| originate from here. Their
   // buffers are reference counted and freed by FFmpeg using |AVFreeBuffer2|.
@@ -63,13 +78,30 @@ class H264DecoderImpl : public H264Decoder {
   // Called by FFmpeg when it is done with a video frame, see |AVGetBuffer2|.
   static void AVFreeBuffer2(void* opaque, uint8_t* data);
 
+  static ThreadingMode ThreadingModeFromFieldTrial();
+
   bool IsInitialized() const;
 
+  // Creates and opens |av_context_| for frames of |width| by |height| with
+  // |number_of_threads| threads.
+  int32_t OpenContext(int width, int height, int number_of_threads);
+  // Returns the frames still buffered by the frame threads of |av_context_|,
+  // which can't decode more frames afterwards.
+  void DrainFrames();
+  // Returns the frame in |av_frame_| to the callback.
+  void DeliverFrame(rtc::Optional<uint8_t> qp);
+
   // Reports statistics with histograms.
   void ReportInit();
   void ReportError();
 
-  I420BufferPool pool_;
+  const ThreadingMode threading_mode_;
+  int number_of_cores_;
+  int number_of_threads_;
+
+  // With frame threading, |AVGetBuffer2| is called on FFmpeg's threads.
+  rtc::CriticalSection pool_lock_;
+  I420BufferPool pool_ RTC_GUARDED_BY(pool_lock_);
   std::unique_ptr<AVCodecContext, AVCodecContextDeleter> av_context_;
   std::unique_ptr<AVFrame, AVFrameDeleter> av_frame_;
 
@@ -278,6 +278,7 @@ int32_t H264EncoderImpl::Release() {
   }
   encoded_image_._buffer = nullptr;
   encoded_image_buffer_.reset();
+  nv12_conversion_pool_.Release();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -339,7 +340,7 @@ int32_t H264EncoderImpl::Encode(const VideoFrame& input_frame,
     openh264_encoder_->ForceIntraFrame(true);
   }
   rtc::scoped_refptr<const I420BufferInterface> frame_buffer =
-      input_frame.video_frame_buffer()->ToI420();
+      ConvertToI420(input_frame.video_frame_buffer(), &nv12_conversion_pool_);
   // EncodeFrame input.
   SSourcePicture picture;
   memset(&picture, 0, sizeof(SSourcePicture));
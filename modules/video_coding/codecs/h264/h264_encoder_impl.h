@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "common_video/h264/h264_bitstream_parser.h"
+#include "common_video/include/i420_buffer_pool.h"
 #include "modules/video_coding/codecs/h264/include/h264.h"
 #include "modules/video_coding/utility/quality_scaler.h"
 
@@ -90,6 +91,9 @@ class H264EncoderImpl : public H264Encoder {
   size_t max_payload_size_;
   int32_t number_of_cores_;
 
+  // Holds the I420 conversions of NV12 input frames, which OpenH264 can't take.
+  I420BufferPool nv12_conversion_pool_;
+
   EncodedImage encoded_image_;
   std::unique_ptr<uint8_t[]> encoded_image_buffer_;
   EncodedImageCallback* encoded_image_callback_;
@@ -19,6 +19,8 @@
 #include "api/video_codecs/video_decoder.h"
 #include "api/video_codecs/video_decoder_factory.h"
 #include "modules/video_coding/codecs/multiplex/include/multiplex_encoder_adapter.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -64,9 +66,14 @@ class MultiplexDecoderAdapter : public VideoDecoder {
   std::vector<std::unique_ptr<VideoDecoder>> decoders_;
   std::vector<std::unique_ptr<AdapterDecodedImageCallback>> adapter_callbacks_;
   DecodedImageCallback* decoded_complete_callback_;
+  // The AXX component is decoded here while the YUV component is decoded on
+  // the calling thread.
+  std::unique_ptr<rtc::TaskQueue> alpha_decoder_queue_;
 
+  rtc::CriticalSection crit_;
   // Holds YUV or AXX decode output of a frame that is identified by timestamp.
-  std::map<uint32_t /* timestamp */, DecodedImageData> decoded_data_;
+  std::map<uint32_t /* timestamp */, DecodedImageData> decoded_data_
+      RTC_GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
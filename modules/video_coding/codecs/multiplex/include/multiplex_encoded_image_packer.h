@@ -94,8 +94,12 @@ struct MultiplexImage {
 //    component.
 class MultiplexEncodedImagePacker {
  public:
-  // Note: It is caller responsibility to release the buffer of the result.
-  static EncodedImage PackAndRelease(const MultiplexImage& image);
+  // Packs |image| into |combined_image|. The buffer of |combined_image| is
+  // reused if it is large enough, otherwise it is replaced by a larger one.
+  // It must either be null or have been allocated by a previous call, and it
+  // is the caller's responsibility to release it. The buffers of the image
+  // components are not released.
+  static void Pack(const MultiplexImage& image, EncodedImage* combined_image);
 
   // Note: The image components just share the memory with |combined_image|.
   static MultiplexImage Unpack(const EncodedImage& combined_image);
@@ -21,6 +21,7 @@
 #include "modules/video_coding/codecs/multiplex/include/multiplex_encoded_image_packer.h"
 #include "modules/video_coding/include/video_codec_interface.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/task_queue.h"
 
 namespace webrtc {
 
@@ -66,6 +67,9 @@ class MultiplexEncoderAdapter : public VideoEncoder {
   std::vector<std::unique_ptr<VideoEncoder>> encoders_;
   std::vector<std::unique_ptr<AdapterEncodedImageCallback>> adapter_callbacks_;
   EncodedImageCallback* encoded_complete_callback_;
+  // The AXX component is encoded here while the YUV component is encoded on
+  // the calling thread.
+  std::unique_ptr<rtc::TaskQueue> alpha_encoder_queue_;
 
   std::map<uint32_t /* timestamp */, MultiplexImage> stashed_images_
       RTC_GUARDED_BY(crit_);
@@ -74,7 +78,7 @@ class MultiplexEncoderAdapter : public VideoEncoder {
   std::vector<uint8_t> multiplex_dummy_planes_;
 
   int key_frame_interval_;
-  EncodedImage combined_image_;
+  EncodedImage combined_image_ RTC_GUARDED_BY(crit_);
 
   rtc::CriticalSection crit_;
 };
@@ -15,6 +15,7 @@
 #include "common_video/include/video_frame.h"
 #include "common_video/include/video_frame_buffer.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
+#include "rtc_base/event.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
 
@@ -105,6 +106,9 @@ int32_t MultiplexDecoderAdapter::InitDecode(const VideoCodec* codec_settings,
     decoder->RegisterDecodeCompleteCallback(adapter_callbacks_.back().get());
     decoders_.emplace_back(std::move(decoder));
   }
+  if (!alpha_decoder_queue_) {
+    alpha_decoder_queue_.reset(new rtc::TaskQueue("MultiplexAlphaDecoder"));
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -117,21 +121,42 @@ int32_t MultiplexDecoderAdapter::Decode(
       MultiplexEncodedImagePacker::Unpack(input_image);
 
   if (image.component_count == 1) {
+    rtc::CritScope cs(&crit_);
     RTC_DCHECK(decoded_data_.find(input_image._timeStamp) ==
                decoded_data_.end());
     decoded_data_.emplace(std::piecewise_construct,
                           std::forward_as_tuple(input_image._timeStamp),
                           std::forward_as_tuple(kAXXStream));
   }
-  int32_t rv = 0;
-  for (size_t i = 0; i < image.image_components.size(); i++) {
-    rv = decoders_[image.image_components[i].component_index]->Decode(
-        image.image_components[i].encoded_image, missing_frames,
-        nullptr, render_time_ms);
-    if (rv != WEBRTC_VIDEO_CODEC_OK)
-      return rv;
+  if (image.image_components.size() != kAlphaCodecStreams) {
+    int32_t rv = 0;
+    for (size_t i = 0; i < image.image_components.size(); i++) {
+      rv = decoders_[image.image_components[i].component_index]->Decode(
+          image.image_components[i].encoded_image, missing_frames, nullptr,
+          render_time_ms);
+      if (rv != WEBRTC_VIDEO_CODEC_OK)
+        return rv;
+    }
+    return rv;
   }
-  return rv;
+
+  // Decode the second component on |alpha_decoder_queue_| and the first one
+  // on this thread at the same time. The components share the memory of
+  // |input_image|, which stays valid since this waits for both decoders.
+  const MultiplexImageComponent& component = image.image_components[0];
+  const MultiplexImageComponent& other_component = image.image_components[1];
+  int32_t other_rv = WEBRTC_VIDEO_CODEC_OK;
+  rtc::Event other_decoded(false, false);
+  alpha_decoder_queue_->PostTask([&] {
+    other_rv = decoders_[other_component.component_index]->Decode(
+        other_component.encoded_image, missing_frames, nullptr,
+        render_time_ms);
+    other_decoded.Set();
+  });
+  const int32_t rv = decoders_[component.component_index]->Decode(
+      component.encoded_image, missing_frames, nullptr, render_time_ms);
+  other_decoded.Wait(rtc::Event::kForever);
+  return rv != WEBRTC_VIDEO_CODEC_OK ? rv : other_rv;
 }
 
 int32_t MultiplexDecoderAdapter::RegisterDecodeCompleteCallback(
@@ -155,6 +180,8 @@ void MultiplexDecoderAdapter::Decoded(AlphaCodecStream stream_idx,
                                       VideoFrame* decoded_image,
                                       rtc::Optional<int32_t> decode_time_ms,
                                       rtc::Optional<uint8_t> qp) {
+  // The components of a frame are decoded on different threads.
+  rtc::CritScope cs(&crit_);
   const auto& other_decoded_data_it =
       decoded_data_.find(decoded_image->timestamp());
   if (other_decoded_data_it != decoded_data_.end()) {
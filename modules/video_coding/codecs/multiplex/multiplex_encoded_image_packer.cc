@@ -116,8 +116,8 @@ void PackBitstream(uint8_t* buffer, MultiplexImageComponent image) {
 MultiplexImage::MultiplexImage(uint16_t picture_index, uint8_t frame_count)
     : image_index(picture_index), component_count(frame_count) {}
 
-EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
-    const MultiplexImage& multiplex_image) {
+void MultiplexEncodedImagePacker::Pack(const MultiplexImage& multiplex_image,
+                                       EncodedImage* combined_image) {
   MultiplexImageHeader header;
   std::vector<MultiplexImageComponentHeader> frame_headers;
 
@@ -130,7 +130,9 @@ EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
 
   const std::vector<MultiplexImageComponent>& images =
       multiplex_image.image_components;
-  EncodedImage combined_image = images[0].encoded_image;
+  uint8_t* buffer = combined_image->_buffer;
+  size_t buffer_size = combined_image->_size;
+  *combined_image = images[0].encoded_image;
   for (size_t i = 0; i < images.size(); i++) {
     MultiplexImageComponentHeader frame_header;
     header_offset += kMultiplexImageComponentHeaderSize;
@@ -154,24 +156,30 @@ EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
     // Thus only when all components are key frames, we can mark the combined
     // frame as key frame.
     if (frame_header.frame_type == FrameType::kVideoFrameDelta) {
-      combined_image._frameType = FrameType::kVideoFrameDelta;
+      combined_image->_frameType = FrameType::kVideoFrameDelta;
     }
 
     frame_headers.push_back(frame_header);
   }
 
-  combined_image._length = combined_image._size = bitstream_offset;
-  combined_image._buffer = new uint8_t[combined_image._length];
+  if (buffer_size < static_cast<size_t>(bitstream_offset)) {
+    delete[] buffer;
+    buffer_size = bitstream_offset;
+    buffer = new uint8_t[buffer_size];
+  }
+  combined_image->_buffer = buffer;
+  combined_image->_size = buffer_size;
+  combined_image->_length = bitstream_offset;
 
   // header
-  header_offset = PackHeader(combined_image._buffer, header);
+  header_offset = PackHeader(combined_image->_buffer, header);
   RTC_DCHECK_EQ(header.first_component_header_offset,
                 kMultiplexImageHeaderSize);
 
   // Frame Header
   for (size_t i = 0; i < images.size(); i++) {
     int relative_offset = PackFrameHeader(
-        combined_image._buffer + header_offset, frame_headers[i]);
+        combined_image->_buffer + header_offset, frame_headers[i]);
     RTC_DCHECK_EQ(relative_offset, kMultiplexImageComponentHeaderSize);
 
     header_offset = frame_headers[i].next_component_header_offset;
@@ -184,12 +192,9 @@ EncodedImage MultiplexEncodedImagePacker::PackAndRelease(
 
   // Bitstreams
   for (size_t i = 0; i < images.size(); i++) {
-    PackBitstream(combined_image._buffer + frame_headers[i].bitstream_offset,
+    PackBitstream(combined_image->_buffer + frame_headers[i].bitstream_offset,
                   images[i]);
-    delete[] images[i].encoded_image._buffer;
   }
-
-  return combined_image;
 }
 
 MultiplexImage MultiplexEncodedImagePacker::Unpack(
@@ -16,6 +16,7 @@
 #include "common_video/include/video_frame_buffer.h"
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "modules/include/module_common_types.h"
+#include "rtc_base/event.h"
 #include "rtc_base/keep_ref_until_done.h"
 #include "rtc_base/logging.h"
 
@@ -103,6 +104,9 @@ int MultiplexEncoderAdapter::InitEncode(const VideoCodec* inst,
     encoder->RegisterEncodeCompleteCallback(adapter_callbacks_.back().get());
     encoders_.emplace_back(std::move(encoder));
   }
+  if (!alpha_encoder_queue_) {
+    alpha_encoder_queue_.reset(new rtc::TaskQueue("MultiplexAlphaEncoder"));
+  }
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -133,16 +137,17 @@ int MultiplexEncoderAdapter::Encode(
 
   ++picture_index_;
 
-  // Encode YUV
-  int rv = encoders_[kYUVStream]->Encode(input_image, codec_specific_info,
-                                         &adjusted_frame_types);
   // If we do not receive an alpha frame, we send a single frame for this
   // |picture_index_|. The receiver will receive |frame_count| as 1 which
   // soecifies this case.
-  if (rv || !has_alpha)
-    return rv;
+  if (!has_alpha) {
+    return encoders_[kYUVStream]->Encode(input_image, codec_specific_info,
+                                         &adjusted_frame_types);
+  }
 
-  // Encode AXX
+  // Encode AXX on |alpha_encoder_queue_| and YUV on this thread at the same
+  // time. Both encoders are only used on one thread at a time, since this
+  // waits for the AXX encoder to finish before returning.
   const I420ABufferInterface* yuva_buffer =
       input_image.video_frame_buffer()->GetI420A();
   rtc::scoped_refptr<I420BufferInterface> alpha_buffer =
@@ -153,9 +158,17 @@ int MultiplexEncoderAdapter::Encode(
                      rtc::KeepRefUntilDone(input_image.video_frame_buffer()));
   VideoFrame alpha_image(alpha_buffer, input_image.timestamp(),
                          input_image.render_time_ms(), input_image.rotation());
-  rv = encoders_[kAXXStream]->Encode(alpha_image, codec_specific_info,
-                                     &adjusted_frame_types);
-  return rv;
+  int alpha_rv = WEBRTC_VIDEO_CODEC_OK;
+  rtc::Event alpha_encoded(false, false);
+  alpha_encoder_queue_->PostTask([&] {
+    alpha_rv = encoders_[kAXXStream]->Encode(alpha_image, codec_specific_info,
+                                             &adjusted_frame_types);
+    alpha_encoded.Set();
+  });
+  const int rv = encoders_[kYUVStream]->Encode(
+      input_image, codec_specific_info, &adjusted_frame_types);
+  alpha_encoded.Wait(rtc::Event::kForever);
+  return rv ? rv : alpha_rv;
 }
 
 int MultiplexEncoderAdapter::RegisterEncodeCompleteCallback(
@@ -204,10 +217,8 @@ int MultiplexEncoderAdapter::Release() {
     }
   }
   stashed_images_.clear();
-  if (combined_image_._buffer) {
-    delete[] combined_image_._buffer;
-    combined_image_._buffer = nullptr;
-  }
+  delete[] combined_image_._buffer;
+  combined_image_ = EncodedImage();
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -220,15 +231,11 @@ EncodedImageCallback::Result MultiplexEncoderAdapter::OnEncodedImage(
     const EncodedImage& encodedImage,
     const CodecSpecificInfo* codecSpecificInfo,
     const RTPFragmentationHeader* fragmentation) {
-  // Save the image
   MultiplexImageComponent image_component;
   image_component.component_index = stream_idx;
   image_component.codec_type =
       PayloadStringToCodecType(associated_format_.name);
   image_component.encoded_image = encodedImage;
-  image_component.encoded_image._buffer = new uint8_t[encodedImage._length];
-  std::memcpy(image_component.encoded_image._buffer, encodedImage._buffer,
-              encodedImage._length);
 
   rtc::CritScope cs(&crit_);
   const auto& stashed_image_itr = stashed_images_.find(encodedImage._timeStamp);
@@ -237,6 +244,13 @@ EncodedImageCallback::Result MultiplexEncoderAdapter::OnEncodedImage(
   MultiplexImage& stashed_image = stashed_image_itr->second;
   const uint8_t frame_count = stashed_image.component_count;
 
+  // Only a component that has to wait for the others is copied. The one
+  // completing the image is packed straight from the encoder's buffer.
+  if (stashed_image.image_components.size() + 1 < frame_count) {
+    image_component.encoded_image._buffer = new uint8_t[encodedImage._length];
+    std::memcpy(image_component.encoded_image._buffer, encodedImage._buffer,
+                encodedImage._length);
+  }
   stashed_image.image_components.push_back(image_component);
 
   if (stashed_image.image_components.size() == frame_count) {
@@ -250,10 +264,11 @@ EncodedImageCallback::Result MultiplexEncoderAdapter::OnEncodedImage(
 
       // We have to send out those stashed frames, otherwise the delta frame
       // dependency chain is broken.
-      if (combined_image_._buffer)
-        delete[] combined_image_._buffer;
-      combined_image_ =
-          MultiplexEncodedImagePacker::PackAndRelease(iter->second);
+      MultiplexEncodedImagePacker::Pack(iter->second, &combined_image_);
+      for (auto& image_component : iter->second.image_components) {
+        if (image_component.encoded_image._buffer != encodedImage._buffer)
+          delete[] image_component.encoded_image._buffer;
+      }
 
       CodecSpecificInfo codec_info = *codecSpecificInfo;
       codec_info.codecType = kVideoCodecMultiplex;
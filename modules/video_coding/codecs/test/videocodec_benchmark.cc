@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/codecs/test/videocodec_benchmark.h"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+
+#if defined(WEBRTC_POSIX)
+#include <sys/resource.h>
+#endif
+
+#include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/cpu_info.h"
+
+namespace webrtc {
+namespace test {
+
+namespace {
+
+int64_t PeakMemoryBytes() {
+#if defined(WEBRTC_POSIX)
+  struct rusage rusage;
+  if (getrusage(RUSAGE_SELF, &rusage) != 0)
+    return -1;
+#if defined(WEBRTC_MAC)
+  return rusage.ru_maxrss;
+#else
+  // Kilobytes everywhere but on Mac.
+  return static_cast<int64_t>(rusage.ru_maxrss) * 1024;
+#endif
+#else
+  return -1;
+#endif
+}
+
+// |samples| is sorted.
+int Percentile(const std::vector<size_t>& samples, int percent) {
+  if (samples.empty())
+    return 0;
+  const size_t index = (samples.size() - 1) * percent / 100;
+  return static_cast<int>(samples[index]);
+}
+
+}  // namespace
+
+struct VideoCodecBenchmark::Instance {
+  Instance(VideoCodecTestFixture::Config config,
+           std::vector<RateProfile> rate_profiles)
+      : config(config),
+        rate_profiles(std::move(rate_profiles)),
+        fixture(config) {}
+
+  const VideoCodecTestFixture::Config config;
+  const std::vector<RateProfile> rate_profiles;
+  VideoCodecTestFixtureImpl fixture;
+  int core = -1;
+  int64_t run_time_us = 0;
+};
+
+std::string VideoCodecBenchmark::Result::ToString() const {
+  std::stringstream ss;
+  ss << "num_instances: " << instances.size();
+  ss << "\nelapsed_time_ms: " << elapsed_time_us / 1000;
+  ss << "\naggregate_fps: " << aggregate_fps;
+  ss << "\npeak_memory_kbytes: " << peak_memory_bytes / 1024;
+  ss << "\nmemory_growth_kbytes: " << memory_growth_bytes / 1024;
+  for (const InstanceResult& instance : instances) {
+    ss << "\n--> " << instance.name;
+    ss << "\nnum_frames: " << instance.num_frames;
+    ss << "\nfps: " << instance.fps;
+    ss << "\nencode_time_us_p50: " << instance.encode_time_us_p50;
+    ss << "\nencode_time_us_p95: " << instance.encode_time_us_p95;
+    ss << "\nencode_time_us_p99: " << instance.encode_time_us_p99;
+    ss << "\ndecode_time_us_p50: " << instance.decode_time_us_p50;
+    ss << "\ndecode_time_us_p95: " << instance.decode_time_us_p95;
+    ss << "\ndecode_time_us_p99: " << instance.decode_time_us_p99;
+  }
+  return ss.str();
+}
+
+VideoCodecBenchmark::VideoCodecBenchmark(bool pin_to_cores)
+    : pin_to_cores_(pin_to_cores) {}
+
+VideoCodecBenchmark::~VideoCodecBenchmark() = default;
+
+void VideoCodecBenchmark::AddInstance(VideoCodecTestFixture::Config config,
+                                      std::vector<RateProfile> rate_profiles) {
+  RTC_DCHECK(!rate_profiles.empty());
+  config.measure_quality = false;
+  config.measure_cpu = false;
+  instances_.push_back(
+      rtc::MakeUnique<Instance>(config, std::move(rate_profiles)));
+}
+
+void VideoCodecBenchmark::RunInstance(void* obj) {
+  Instance* instance = static_cast<Instance*>(obj);
+  const int64_t start_us = rtc::TimeMicros();
+  instance->fixture.RunBenchmark(instance->rate_profiles, instance->core);
+  instance->run_time_us = rtc::TimeMicros() - start_us;
+}
+
+VideoCodecBenchmark::Result VideoCodecBenchmark::Run() {
+  const int num_cores = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  const int64_t memory_before_bytes = PeakMemoryBytes();
+
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  const int64_t start_us = rtc::TimeMicros();
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    instances_[i]->core = pin_to_cores_ ? static_cast<int>(i) % num_cores : -1;
+    threads.push_back(rtc::MakeUnique<rtc::PlatformThread>(
+        &RunInstance, instances_[i].get(), "VideoCodecBenchmark"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+
+  Result result;
+  result.elapsed_time_us = rtc::TimeMicros() - start_us;
+  result.peak_memory_bytes = PeakMemoryBytes();
+  if (result.peak_memory_bytes >= 0 && memory_before_bytes >= 0) {
+    result.memory_growth_bytes =
+        result.peak_memory_bytes - memory_before_bytes;
+  }
+
+  size_t total_num_frames = 0;
+  for (const auto& instance : instances_) {
+    const VideoCodecTestFixture::Config& config = instance->config;
+    InstanceResult instance_result;
+    instance_result.name = config.CodecName() + "_" +
+                           std::to_string(config.codec_settings.width) + "x" +
+                           std::to_string(config.codec_settings.height) +
+                           "_" + config.filename;
+    instance_result.num_frames = config.num_frames;
+    if (instance->run_time_us > 0) {
+      instance_result.fps = static_cast<double>(config.num_frames) *
+                            rtc::kNumMicrosecsPerSec / instance->run_time_us;
+    }
+
+    std::vector<size_t> encode_times_us;
+    std::vector<size_t> decode_times_us;
+    VideoCodecTestStats& stats = instance->fixture.GetStats();
+    const size_t num_layers = std::max(config.NumberOfSimulcastStreams(),
+                                       config.NumberOfSpatialLayers());
+    for (size_t layer_idx = 0; layer_idx < num_layers; ++layer_idx) {
+      for (size_t frame_num = 0; frame_num < stats.Size(layer_idx);
+           ++frame_num) {
+        const VideoCodecTestStats::FrameStatistics* frame_stat =
+            stats.GetFrame(frame_num, layer_idx);
+        if (frame_stat->encoding_successful)
+          encode_times_us.push_back(frame_stat->encode_time_us);
+        if (frame_stat->decoding_successful)
+          decode_times_us.push_back(frame_stat->decode_time_us);
+      }
+    }
+    std::sort(encode_times_us.begin(), encode_times_us.end());
+    std::sort(decode_times_us.begin(), decode_times_us.end());
+    instance_result.encode_time_us_p50 = Percentile(encode_times_us, 50);
+    instance_result.encode_time_us_p95 = Percentile(encode_times_us, 95);
+    instance_result.encode_time_us_p99 = Percentile(encode_times_us, 99);
+    instance_result.decode_time_us_p50 = Percentile(decode_times_us, 50);
+    instance_result.decode_time_us_p95 = Percentile(decode_times_us, 95);
+    instance_result.decode_time_us_p99 = Percentile(decode_times_us, 99);
+
+    total_num_frames += config.num_frames;
+    result.instances.push_back(instance_result);
+  }
+  if (result.elapsed_time_us > 0) {
+    result.aggregate_fps = static_cast<double>(total_num_frames) *
+                           rtc::kNumMicrosecsPerSec / result.elapsed_time_us;
+  }
+  return result;
+}
+
+}  // namespace test
+}  // namespace webrtc
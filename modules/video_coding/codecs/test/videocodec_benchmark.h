@@ -0,0 +1,82 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_BENCHMARK_H_
+#define MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_BENCHMARK_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/test/videocodec_test_fixture.h"
+#include "modules/video_coding/codecs/test/videocodec_test_fixture_impl.h"
+
+namespace webrtc {
+namespace test {
+
+// Runs several encode and decode instances at the same time, each with its own
+// clip, resolution and codec, to find out how many streams a machine can
+// handle. Each instance is a VideoCodecTestFixtureImpl on its own thread. The
+// frames are fed as fast as the codecs take them. Nothing is written to disk
+// and the quality of the decoded frames isn't measured, so only the codecs
+// load the CPU.
+class VideoCodecBenchmark {
+ public:
+  struct InstanceResult {
+    std::string name;
+    size_t num_frames = 0;
+    double fps = 0.0;
+    // Percentiles of the time to encode and to decode a frame, over all the
+    // simulcast streams or spatial layers.
+    int encode_time_us_p50 = 0;
+    int encode_time_us_p95 = 0;
+    int encode_time_us_p99 = 0;
+    int decode_time_us_p50 = 0;
+    int decode_time_us_p95 = 0;
+    int decode_time_us_p99 = 0;
+  };
+
+  struct Result {
+    std::string ToString() const;
+
+    int64_t elapsed_time_us = 0;
+    // Frames processed per second by all the instances together.
+    double aggregate_fps = 0.0;
+    // Peak resident memory of the process, and how much it grew while the
+    // instances ran. -1 where unknown.
+    int64_t peak_memory_bytes = -1;
+    int64_t memory_growth_bytes = -1;
+    std::vector<InstanceResult> instances;
+  };
+
+  // With |pin_to_cores|, the instances are spread over the cores, one per
+  // core in turn. Pinning only works on Linux.
+  explicit VideoCodecBenchmark(bool pin_to_cores);
+  ~VideoCodecBenchmark();
+
+  // |config.measure_quality| and |config.measure_cpu| are ignored.
+  void AddInstance(VideoCodecTestFixture::Config config,
+                   std::vector<RateProfile> rate_profiles);
+
+  Result Run();
+
+ private:
+  struct Instance;
+
+  static void RunInstance(void* obj);
+
+  const bool pin_to_cores_;
+  std::vector<std::unique_ptr<Instance>> instances_;
+};
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_CODECS_TEST_VIDEOCODEC_BENCHMARK_H_
@@ -14,6 +14,10 @@
 #include <memory>
 #include <utility>
 
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
 #if defined(WEBRTC_ANDROID)
 #include "modules/video_coding/codecs/test/android_codec_factory_helper.h"
 #endif
@@ -36,6 +40,7 @@
 #include "rtc_base/cpu_time.h"
 #include "rtc_base/event.h"
 #include "rtc_base/file.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/strings/string_builder.h"
 #include "system_wrappers/include/cpu_info.h"
@@ -256,6 +261,7 @@ std::string VideoCodecTestFixtureImpl::Config::ToString() const {
   ss << "\ndecode: " << decode;
   ss << "\nuse_single_core: " << use_single_core;
   ss << "\nmeasure_cpu: " << measure_cpu;
+  ss << "\nmeasure_quality: " << measure_quality;
   ss << "\nnum_cores: " << NumberOfCores();
   ss << "\nkeyframe_interval: " << keyframe_interval;
   ss << "\ncodec_type: " << codec_type;
@@ -415,6 +421,32 @@ void VideoCodecTestFixtureImpl::RunTest(
                    bs_thresholds);
 }
 
+void VideoCodecTestFixtureImpl::RunBenchmark(
+    const std::vector<RateProfile>& rate_profiles,
+    int core) {
+  RTC_DCHECK(!rate_profiles.empty());
+
+  rtc::test::TaskQueueForTest task_queue("VidProc TQ");
+#if defined(WEBRTC_LINUX)
+  if (core >= 0) {
+    task_queue.SendTask([core] {
+      // Threads inherit the affinity of the thread that starts them.
+      cpu_set_t cpu_set;
+      CPU_ZERO(&cpu_set);
+      CPU_SET(core, &cpu_set);
+      if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+        RTC_LOG(LS_WARNING) << "Failed to pin the codecs to core " << core;
+    });
+  }
+#endif
+
+  SetUpAndInitObjects(
+      &task_queue, static_cast<const int>(rate_profiles[0].target_kbps),
+      static_cast<const int>(rate_profiles[0].input_fps), nullptr);
+  ProcessAllFrames(&task_queue, rate_profiles);
+  ReleaseAndCloseObjects(&task_queue);
+}
+
 void VideoCodecTestFixtureImpl::ProcessAllFrames(
     rtc::TaskQueue* task_queue,
     const std::vector<RateProfile>& rate_profiles) {
@@ -58,6 +58,12 @@ class VideoCodecTestFixtureImpl : public VideoCodecTestFixture {
 
   VideoCodecTestStats& GetStats() override;
 
+  // Runs the codecs on all the frames as fast as they take them, and neither
+  // writes nor prints anything, for VideoCodecBenchmark. On Linux, the task
+  // queue that runs the codecs, and the threads the codecs start, are pinned
+  // to |core| unless it is negative.
+  void RunBenchmark(const std::vector<RateProfile>& rate_profiles, int core);
+
  private:
   class CpuProcessTime;
 
@@ -8,15 +8,19 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <string>
 #include <vector>
 
 #include "api/test/create_videocodec_test_fixture.h"
 #include "media/base/mediaconstants.h"
+#include "modules/video_coding/codecs/test/videocodec_benchmark.h"
 #include "modules/video_coding/utility/vp8_header_parser.h"
 #include "modules/video_coding/utility/vp9_uncompressed_header_parser.h"
 #include "rtc_base/ptr_util.h"
+#include "system_wrappers/include/cpu_info.h"
 #include "test/gtest.h"
 #include "test/testsupport/fileutils.h"
+#include "test/testsupport/perf_test.h"
 
 namespace webrtc {
 namespace test {
@@ -481,5 +485,54 @@ TEST(VideoCodecTestLibvpx, DISABLED_SvcVP9RdPerf) {
   PrintRdPerf(rd_stats);
 }
 
+TEST(VideoCodecTestLibvpx, DISABLED_MultiInstanceBenchmarkVP8) {
+  VideoCodecBenchmark benchmark(/*pin_to_cores=*/true);
+  const int num_instances = static_cast<int>(CpuInfo::DetectNumberOfCores());
+  for (int i = 0; i < num_instances; ++i) {
+    auto config = CreateConfig();
+    if (i % 2 == 1) {
+      config.filename = "FourPeople_1280x720_30";
+      config.filepath = ResourcePath(config.filename, "yuv");
+      config.SetCodecSettings(cricket::kVp8CodecName, 1, 1, 1, true, true,
+                              false, 1280, 720);
+    } else {
+      config.SetCodecSettings(cricket::kVp8CodecName, 1, 1, 1, true, true,
+                              false, kCifWidth, kCifHeight);
+    }
+    std::vector<RateProfile> rate_profiles = {
+        {i % 2 == 1 ? 1500u : 500u, 30, config.num_frames}};
+    benchmark.AddInstance(config, rate_profiles);
+  }
+
+  const VideoCodecBenchmark::Result result = benchmark.Run();
+  const std::string trace = std::to_string(num_instances) + "_instances";
+  PrintResult("aggregate_fps", "", trace, result.aggregate_fps, "fps", true);
+  if (result.peak_memory_bytes >= 0) {
+    PrintResult("peak_memory", "", trace, result.peak_memory_bytes / 1024.0,
+                "KB", false);
+    PrintResult("memory_growth", "", trace, result.memory_growth_bytes / 1024.0,
+                "KB", false);
+  }
+  for (size_t i = 0; i < result.instances.size(); ++i) {
+    const VideoCodecBenchmark::InstanceResult& instance = result.instances[i];
+    const std::string instance_trace =
+        "instance_" + std::to_string(i) + "_" + instance.name;
+    PrintResult("fps", "", instance_trace, instance.fps, "fps", false);
+    PrintResult("encode_time", "_p50", instance_trace,
+                instance.encode_time_us_p50, "us", false);
+    PrintResult("encode_time", "_p95", instance_trace,
+                instance.encode_time_us_p95, "us", false);
+    PrintResult("encode_time", "_p99", instance_trace,
+                instance.encode_time_us_p99, "us", false);
+    PrintResult("decode_time", "_p50", instance_trace,
+                instance.decode_time_us_p50, "us", false);
+    PrintResult("decode_time", "_p95", instance_trace,
+                instance.decode_time_us_p95, "us", false);
+    PrintResult("decode_time", "_p99", instance_trace,
+                instance.decode_time_us_p99, "us", false);
+  }
+  EXPECT_GT(result.aggregate_fps, 0.0);
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -268,7 +268,7 @@ void VideoProcessor::ProcessFrame() {
                          static_cast<int64_t>(timestamp / kMsToRtpTimestamp),
                          webrtc::kVideoRotation_0);
   // Store input frame as a reference for quality calculations.
-  if (config_.decode && !config_.measure_cpu) {
+  if (config_.decode && config_.measure_quality && !config_.measure_cpu) {
     input_frames_.emplace(frame_number, input_frame);
   }
   last_inputed_timestamp_ = timestamp;
@@ -466,7 +466,7 @@ void VideoProcessor::FrameDecoded(const VideoFrame& decoded_frame,
   frame_stat->decoded_height = decoded_frame.height();
 
   // Skip quality metrics calculation to not affect CPU usage.
-  if (!config_.measure_cpu) {
+  if (config_.measure_quality && !config_.measure_cpu) {
     const auto reference_frame = input_frames_.find(frame_number);
     RTC_CHECK(reference_frame != input_frames_.cend())
         << "The codecs are either buffering too much, dropping too much, or "
@@ -26,6 +26,9 @@
 namespace webrtc {
 namespace {
 constexpr int kVp8ErrorPropagationTh = 30;
+// Number of output buffers allocated at InitDecode, roughly the number of
+// decoded frames in flight towards the renderer.
+constexpr size_t kNumPrewarmedBuffers = 4;
 // vpx_decoder.h documentation indicates decode deadline is time in us, with
 // "Set to zero for unlimited.", but actual implementation requires this to be
 // a mode with 0 meaning allow delay and 1 not allowing it.
@@ -134,6 +137,8 @@ int LibvpxVp8Decoder::InitDecode(const VideoCodec* inst, int number_of_cores) {
 
   propagation_cnt_ = -1;
   inited_ = true;
+  if (inst && inst->width > 0 && inst->height > 0)
+    buffer_pool_.Prewarm(inst->width, inst->height, kNumPrewarmedBuffers);
 
   // Always start with a complete key frame.
   key_frame_required_ = true;
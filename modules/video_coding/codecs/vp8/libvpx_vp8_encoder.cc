@@ -34,6 +34,8 @@ constexpr int kLowVp8QpThreshold = 29;
 constexpr int kHighVp8QpThreshold = 95;
 
 constexpr int kTokenPartitions = VP8_ONE_TOKENPARTITION;
+// Fastest real-time speed used by default, see SetCpuSpeed().
+constexpr int kMaxRealtimeCpuSpeed = 12;
 constexpr uint32_t kVp832ByteAlign = 32u;
 
 // VP8 denoiser states.
@@ -246,6 +248,7 @@ int LibvpxVp8Encoder::Release() {
     vpx_img_free(&raw_images_.back());
     raw_images_.pop_back();
   }
+  nv12_conversion_pool_.Release();
   temporal_layers_.clear();
   temporal_layers_checkers_.clear();
   inited_ = false;
@@ -501,6 +504,20 @@ int LibvpxVp8Encoder::InitEncode(const VideoCodec* inst,
   // TODO(fbarchard): Consider number of Simulcast layers.
   configurations_[0].g_threads = NumberOfThreads(
       configurations_[0].g_w, configurations_[0].g_h, number_of_cores);
+  const int max_threads = inst->performance_profile.max_threads;
+  if (max_threads > 0) {
+    configurations_[0].g_threads = std::min(
+        configurations_[0].g_threads, static_cast<unsigned int>(max_threads));
+  }
+
+  speed_controller_.reset();
+  if (inst->performance_profile.adaptive_speed) {
+    const int max_speed = inst->performance_profile.max_speed > 0
+                              ? inst->performance_profile.max_speed
+                              : kMaxRealtimeCpuSpeed;
+    speed_controller_ =
+        rtc::MakeUnique<EncoderSpeedController>(-cpu_speed_[0], max_speed);
+  }
 
   // Creating a wrapper to the image - setting image data to NULL.
   // Actual pointer will be set in encode. Setting align to 1, as it
@@ -707,7 +724,7 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     return WEBRTC_VIDEO_CODEC_UNINITIALIZED;
 
   rtc::scoped_refptr<I420BufferInterface> input_image =
-      frame.video_frame_buffer()->ToI420();
+      ConvertToI420(frame.video_frame_buffer(), &nv12_conversion_pool_);
   // Since we are extracting raw pointers from |input_image| to
   // |raw_images_[0]|, the resolution of these frames must match.
   RTC_DCHECK_EQ(input_image->width(), raw_images_[0].d_w);
@@ -818,6 +835,7 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
 
   int error = WEBRTC_VIDEO_CODEC_OK;
   int num_tries = 0;
+  const int64_t encode_start_us = rtc::TimeMicros();
   // If the first try returns WEBRTC_VIDEO_CODEC_TARGET_BITRATE_OVERSHOOT
   // the frame must be reencoded with the same parameters again because
   // target bitrate is exceeded and encoder state has been reset.
@@ -840,6 +858,12 @@ int LibvpxVp8Encoder::Encode(const VideoFrame& frame,
     // Examines frame timestamps only.
     error = GetEncodedPartitions(tl_configs, frame);
   }
+  if (speed_controller_ &&
+      speed_controller_->OnFrameEncoded(rtc::TimeMicros() - encode_start_us,
+                                        codec_.maxFramerate)) {
+    cpu_speed_[0] = -speed_controller_->speed();
+    vpx_codec_control(&(encoders_[0]), VP8E_SET_CPUUSED, cpu_speed_[0]);
+  }
   return error;
 }
 
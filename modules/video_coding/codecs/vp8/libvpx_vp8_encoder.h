@@ -17,10 +17,12 @@
 #include "api/video/video_frame.h"
 #include "api/video_codecs/video_encoder.h"
 #include "common_types.h"  // NOLINT(build/include)
+#include "common_video/include/i420_buffer_pool.h"
 #include "common_video/include/video_frame.h"
 #include "modules/video_coding/codecs/vp8/include/vp8.h"
 #include "modules/video_coding/codecs/vp8/temporal_layers.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "modules/video_coding/utility/encoder_speed_controller.h"
 
 #include "vpx/vp8cx.h"
 #include "vpx/vpx_encoder.h"
@@ -99,7 +101,13 @@ class LibvpxVp8Encoder : public VP8Encoder {
   std::vector<bool> key_frame_request_;
   std::vector<bool> send_stream_;
   std::vector<int> cpu_speed_;
+  // Adapts the cpu speed of the highest resolution stream to the encode time,
+  // if enabled by the codec's performance profile. Works on the magnitude of
+  // |cpu_speed_[0]|, since faster VP8 real-time speeds are more negative.
+  std::unique_ptr<EncoderSpeedController> speed_controller_;
   std::vector<vpx_image_t> raw_images_;
+  // Holds the I420 conversions of NV12 input frames, which libvpx can't take.
+  I420BufferPool nv12_conversion_pool_;
   std::vector<EncodedImage> encoded_images_;
   std::vector<vpx_codec_ctx_t> encoders_;
   std::vector<vpx_codec_enc_cfg_t> configurations_;
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <vector>
 
 #include "vpx/vpx_encoder.h"
@@ -36,6 +37,8 @@ namespace webrtc {
 
 namespace {
 const float kMaxScreenSharingFramerateFps = 5.0f;
+// Fastest speed of the real-time presets, see GetCpuSpeed().
+const int kMaxRealtimeCpuSpeed = 8;
 }
 
 // Only positive speeds, range for real-time coding currently is: 5 - 8.
@@ -346,8 +349,21 @@ int VP9EncoderImpl::InitEncode(const VideoCodec* inst,
   // Determine number of threads based on the image size and #cores.
   config_->g_threads =
       NumberOfThreads(config_->g_w, config_->g_h, number_of_cores);
+  const int max_threads = inst->performance_profile.max_threads;
+  if (max_threads > 0) {
+    config_->g_threads =
+        std::min(config_->g_threads, static_cast<unsigned int>(max_threads));
+  }
 
   cpu_speed_ = GetCpuSpeed(config_->g_w, config_->g_h);
+  speed_controller_.reset();
+  if (inst->performance_profile.adaptive_speed) {
+    const int max_speed = inst->performance_profile.max_speed > 0
+                              ? inst->performance_profile.max_speed
+                              : kMaxRealtimeCpuSpeed;
+    speed_controller_ =
+        rtc::MakeUnique<EncoderSpeedController>(cpu_speed_, max_speed);
+  }
 
   // TODO(asapersson): Check configuration of temporal switch up and increase
   // pattern length.
@@ -615,12 +631,22 @@ int VP9EncoderImpl::Encode(const VideoFrame& input_image,
   RTC_CHECK_GT(codec_.maxFramerate, 0);
   uint32_t duration =
       90000 / target_framerate_fps_.value_or(codec_.maxFramerate);
+  const int64_t encode_start_us = rtc::TimeMicros();
   if (vpx_codec_encode(encoder_, raw_, timestamp_, duration, flags,
                        VPX_DL_REALTIME)) {
     return WEBRTC_VIDEO_CODEC_ERROR;
   }
   timestamp_ += duration;
 
+  if (speed_controller_ &&
+      speed_controller_->OnFrameEncoded(
+          rtc::TimeMicros() - encode_start_us,
+          static_cast<uint32_t>(
+              target_framerate_fps_.value_or(codec_.maxFramerate)))) {
+    cpu_speed_ = speed_controller_->speed();
+    vpx_codec_control(encoder_, VP8E_SET_CPUUSED, cpu_speed_);
+  }
+
   const bool end_of_picture = true;
   DeliverBufferedFrame(end_of_picture);
 
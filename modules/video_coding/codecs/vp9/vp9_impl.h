@@ -17,6 +17,7 @@
 
 #include "modules/video_coding/codecs/vp9/include/vp9.h"
 #include "modules/video_coding/codecs/vp9/vp9_frame_buffer_pool.h"
+#include "modules/video_coding/utility/encoder_speed_controller.h"
 #include "rtc_base/rate_statistics.h"
 
 #include "vpx/vp8cx.h"
@@ -90,6 +91,9 @@ class VP9EncoderImpl : public VP9Encoder {
   bool inited_;
   int64_t timestamp_;
   int cpu_speed_;
+  // Adapts |cpu_speed_| to the encode time, if enabled by the codec's
+  // performance profile.
+  std::unique_ptr<EncoderSpeedController> speed_controller_;
   uint32_t rc_max_intra_target_;
   vpx_codec_ctx_t* encoder_;
   vpx_codec_enc_cfg_t* config_;
@@ -63,6 +63,13 @@ VCMEncodedFrame::~VCMEncodedFrame() {
   Free();
 }
 
+std::vector<rtc::ArrayView<const uint8_t>> VCMEncodedFrame::BitstreamSegments()
+    const {
+  if (_length == 0)
+    return {};
+  return {rtc::ArrayView<const uint8_t>(_buffer, _length)};
+}
+
 void VCMEncodedFrame::Free() {
   Reset();
   if (_buffer != NULL) {
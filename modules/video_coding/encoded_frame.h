@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "common_types.h"  // NOLINT(build/include)
 #include "common_video/include/video_frame.h"
 #include "modules/include/module_common_types.h"
@@ -27,7 +28,7 @@ class VCMEncodedFrame : protected EncodedImage {
   explicit VCMEncodedFrame(const webrtc::EncodedImage& rhs);
   VCMEncodedFrame(const VCMEncodedFrame& rhs);
 
-  ~VCMEncodedFrame();
+  virtual ~VCMEncodedFrame();
   /**
   *   Delete VideoFrame and resets members to zero
   */
@@ -66,6 +67,18 @@ class VCMEncodedFrame : protected EncodedImage {
   */
   size_t Length() const { return _length; }
   /**
+  *   Get the bitstream as segments in decoding order. A frame assembled from
+  *   packets holds its bitstream in the packet payloads, and has no Buffer(),
+  *   until Linearize() is called. Other frames have the single segment
+  *   Buffer().
+  */
+  virtual std::vector<rtc::ArrayView<const uint8_t>> BitstreamSegments()
+      const;
+  /**
+  *   Copy the bitstream into Buffer() if it is held in segments.
+  */
+  virtual void Linearize() {}
+  /**
   *   Get frame timestamp (90kHz)
   */
   uint32_t TimeStamp() const { return _timeStamp; }
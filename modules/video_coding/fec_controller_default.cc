@@ -10,7 +10,19 @@
 
 #include "modules/video_coding/fec_controller_default.h"
 
+#include "system_wrappers/include/field_trial.h"
+
 namespace webrtc {
+namespace {
+
+// Number of lost packets to pick the FEC scheme from.
+const int kLossesPerSchemeDecision = 20;
+// Reed-Solomon is used if at least this fraction of the lost packets were
+// lost together with a neighbour.
+const float kBurstLossFractionForReedSolomon = 0.5f;
+
+}  // namespace
+
 using rtc::CritScope;
 FecControllerDefault::FecControllerDefault(
     Clock* clock,
@@ -19,13 +31,15 @@ FecControllerDefault::FecControllerDefault(
       protection_callback_(protection_callback),
       loss_prot_logic_(new media_optimization::VCMLossProtectionLogic(
           clock_->TimeInMilliseconds())),
-      max_payload_size_(1460) {}
+      max_payload_size_(1460),
+      reed_solomon_enabled_(
+          webrtc::field_trial::IsEnabled("WebRTC-FecReedSolomon")),
+      loss_mask_index_(0),
+      fec_scheme_(kFecSchemeXor),
+      fec_mask_type_(kFecMaskRandom) {}
 
 FecControllerDefault::FecControllerDefault(Clock* clock)
-    : clock_(clock),
-      loss_prot_logic_(new media_optimization::VCMLossProtectionLogic(
-          clock_->TimeInMilliseconds())),
-      max_payload_size_(1460) {}
+    : FecControllerDefault(clock, nullptr) {}
 
 FecControllerDefault::~FecControllerDefault(void) {
   loss_prot_logic_->Release();
@@ -62,6 +76,7 @@ uint32_t FecControllerDefault::UpdateFecRates(
   FecProtectionParams key_fec_params;
   {
     CritScope lock(&crit_sect_);
+    UpdateFecScheme(loss_mask_vector);
     loss_prot_logic_->UpdateBitRate(target_bitrate_kbps);
     loss_prot_logic_->UpdateRtt(round_trip_time_ms);
     // Update frame rate for the loss protection logic class: frame rate should
@@ -99,13 +114,14 @@ uint32_t FecControllerDefault::UpdateFecRates(
         loss_prot_logic_->SelectedMethod()->MaxFramesFec();
     key_fec_params.max_fec_frames =
         loss_prot_logic_->SelectedMethod()->MaxFramesFec();
+    // Set the FEC packet mask type. |kFecMaskBursty| is more effective for
+    // consecutive losses and little/no packet re-ordering. Without feedback
+    // on the degree of correlated losses, |kFecMaskRandom| is used.
+    delta_fec_params.fec_mask_type = fec_mask_type_;
+    key_fec_params.fec_mask_type = fec_mask_type_;
+    delta_fec_params.fec_scheme = fec_scheme_;
+    key_fec_params.fec_scheme = fec_scheme_;
   }
-  // Set the FEC packet mask type. |kFecMaskBursty| is more effective for
-  // consecutive losses and little/no packet re-ordering. As we currently
-  // do not have feedback data on the degree of correlated losses and packet
-  // re-ordering, we keep default setting to |kFecMaskRandom| for now.
-  delta_fec_params.fec_mask_type = kFecMaskRandom;
-  key_fec_params.fec_mask_type = kFecMaskRandom;
   // Update protection callback with protection settings.
   uint32_t sent_video_rate_bps = 0;
   uint32_t sent_nack_rate_bps = 0;
@@ -131,6 +147,26 @@ uint32_t FecControllerDefault::UpdateFecRates(
   // Source coding rate: total rate - protection overhead.
   return estimated_bitrate_bps * (1.0 - protection_overhead_rate);
 }
+void FecControllerDefault::UpdateFecScheme(
+    const std::vector<bool>& loss_mask_vector) {
+  if (!reed_solomon_enabled_)
+    return;
+  for (bool lost : loss_mask_vector) {
+    if (lost)
+      loss_stats_.AddLostPacket(loss_mask_index_);
+    ++loss_mask_index_;
+  }
+  const int single_losses = loss_stats_.GetSingleLossCount();
+  const int burst_losses = loss_stats_.GetMultipleLossPacketCount();
+  if (single_losses + burst_losses < kLossesPerSchemeDecision)
+    return;
+  const bool bursty = burst_losses >= kBurstLossFractionForReedSolomon *
+                                          (single_losses + burst_losses);
+  fec_scheme_ = bursty ? kFecSchemeReedSolomon : kFecSchemeXor;
+  fec_mask_type_ = bursty ? kFecMaskBursty : kFecMaskRandom;
+  loss_stats_ = PacketLossStats();
+}
+
 void FecControllerDefault::SetProtectionMethod(bool enable_fec,
                                                bool enable_nack) {
   media_optimization::VCMProtectionMethodEnum method(media_optimization::kNone);
@@ -15,6 +15,7 @@
 #include <vector>
 #include "api/fec_controller.h"
 #include "modules/include/module_common_types.h"
+#include "modules/rtp_rtcp/source/packet_loss_stats.h"
 #include "modules/video_coding/media_opt_util.h"
 #include "rtc_base/criticalsection.h"
 #include "system_wrappers/include/clock.h"
@@ -41,16 +42,28 @@ class FecControllerDefault : public FecController {
                           int64_t round_trip_time_ms) override;
   void UpdateWithEncodedData(const size_t encoded_image_length,
                              const FrameType encoded_image_frametype) override;
-  bool UseLossVectorMask() override { return false; }
+  // With the WebRTC-FecReedSolomon field trial, the loss vector is used to
+  // pick the FEC scheme and mask type from the burstiness of the losses.
+  bool UseLossVectorMask() override { return reed_solomon_enabled_; }
 
  private:
   enum { kBitrateAverageWinMs = 1000 };
+  void UpdateFecScheme(const std::vector<bool>& loss_mask_vector)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_sect_);
+
   Clock* const clock_;
   VCMProtectionCallback* protection_callback_;
   rtc::CriticalSection crit_sect_;
   std::unique_ptr<media_optimization::VCMLossProtectionLogic> loss_prot_logic_
       RTC_GUARDED_BY(crit_sect_);
   size_t max_payload_size_ RTC_GUARDED_BY(crit_sect_);
+  const bool reed_solomon_enabled_;
+  // Losses since the scheme was last picked. Packets of the loss vector are
+  // numbered by |loss_mask_index_|.
+  PacketLossStats loss_stats_ RTC_GUARDED_BY(crit_sect_);
+  uint16_t loss_mask_index_ RTC_GUARDED_BY(crit_sect_);
+  FecScheme fec_scheme_ RTC_GUARDED_BY(crit_sect_);
+  FecMaskType fec_mask_type_ RTC_GUARDED_BY(crit_sect_);
   RTC_DISALLOW_COPY_AND_ASSIGN(FecControllerDefault);
 };
 
@@ -10,6 +10,7 @@
 
 #include "modules/video_coding/fec_controller_default.h"
 #include "system_wrappers/include/clock.h"
+#include "test/field_trial.h"
 #include "test/gtest.h"
 
 namespace webrtc {
@@ -29,6 +30,8 @@ class ProtectionBitrateCalculatorTest : public ::testing::Test {
                           uint32_t* sent_video_rate_bps,
                           uint32_t* sent_nack_rate_bps,
                           uint32_t* sent_fec_rate_bps) override {
+      delta_params_ = *delta_params;
+      key_params_ = *key_params;
       *sent_video_rate_bps = kCodecBitrateBps;
       *sent_nack_rate_bps = nack_rate_bps_;
       *sent_fec_rate_bps = fec_rate_bps_;
@@ -37,6 +40,8 @@ class ProtectionBitrateCalculatorTest : public ::testing::Test {
 
     uint32_t fec_rate_bps_ = 0;
     uint32_t nack_rate_bps_ = 0;
+    FecProtectionParams delta_params_ = {0, 0, kFecMaskRandom, kFecSchemeXor};
+    FecProtectionParams key_params_ = {0, 0, kFecMaskRandom, kFecSchemeXor};
   };
 
   // Note: simulated clock starts at 1 seconds, since parts of webrtc use 0 as
@@ -104,4 +109,48 @@ TEST_F(ProtectionBitrateCalculatorTest, NoProtection) {
   EXPECT_EQ(kMaxBitrateBps, target_bitrate);
 }
 
+// Reports |num_reports| loss vectors of 100 packets, each with 10 losses in
+// bursts of |burst_length|.
+void ReportLosses(FecControllerDefault* fec_controller,
+                  int num_reports,
+                  int burst_length) {
+  for (int i = 0; i < num_reports; ++i) {
+    std::vector<bool> loss_mask_vector(100, false);
+    for (int lost = 0; lost < 10; ++lost)
+      loss_mask_vector[(lost / burst_length) * 10 + lost % burst_length] = true;
+    fec_controller->UpdateFecRates(130000, 30, 25, loss_mask_vector, 100);
+  }
+}
+
+TEST_F(ProtectionBitrateCalculatorTest, UsesXorFecWithoutFieldTrial) {
+  fec_controller_.SetProtectionMethod(true /*enable_fec*/,
+                                      false /* enable_nack */);
+  fec_controller_.SetEncodingData(640, 480, 1, 1000);
+  EXPECT_FALSE(fec_controller_.UseLossVectorMask());
+
+  ReportLosses(&fec_controller_, 5, 5);
+  EXPECT_EQ(kFecSchemeXor, protection_callback_.delta_params_.fec_scheme);
+  EXPECT_EQ(kFecMaskRandom, protection_callback_.delta_params_.fec_mask_type);
+}
+
+TEST_F(ProtectionBitrateCalculatorTest, UsesReedSolomonFecForBurstLoss) {
+  test::ScopedFieldTrials field_trials("WebRTC-FecReedSolomon/Enabled/");
+  FecControllerDefault fec_controller(&clock_, &protection_callback_);
+  fec_controller.SetProtectionMethod(true /*enable_fec*/,
+                                     false /* enable_nack */);
+  fec_controller.SetEncodingData(640, 480, 1, 1000);
+  EXPECT_TRUE(fec_controller.UseLossVectorMask());
+
+  ReportLosses(&fec_controller, 2, 5);
+  EXPECT_EQ(kFecSchemeReedSolomon,
+            protection_callback_.delta_params_.fec_scheme);
+  EXPECT_EQ(kFecSchemeReedSolomon, protection_callback_.key_params_.fec_scheme);
+  EXPECT_EQ(kFecMaskBursty, protection_callback_.delta_params_.fec_mask_type);
+
+  // Back to XOR FEC once the losses are isolated.
+  ReportLosses(&fec_controller, 2, 1);
+  EXPECT_EQ(kFecSchemeXor, protection_callback_.delta_params_.fec_scheme);
+  EXPECT_EQ(kFecMaskRandom, protection_callback_.delta_params_.fec_mask_type);
+}
+
 }  // namespace webrtc
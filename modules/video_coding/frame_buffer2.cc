@@ -12,8 +12,8 @@
 
 #include <algorithm>
 #include <cstring>
-#include <queue>
 
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/video_coding/include/video_coding_defines.h"
 #include "modules/video_coding/jitter_estimator.h"
 #include "modules/video_coding/timing.h"
@@ -39,26 +39,55 @@ constexpr int kMaxFramesHistory = 50;
 constexpr int kMaxAllowedFrameDelayMs = 5;
 
 constexpr int64_t kLogNonDecodedIntervalMs = 5000;
+
+// Entries a frame may add to the frame table: its own, one for each reference
+// and one for the lower spatial layer.
+constexpr size_t kMaxEntriesPerFrame = EncodedFrame::kMaxFrameReferences + 2;
+
+// Whether the frames of lower temporal layers don't reference |frame|, so
+// that it can be skipped, along with the frames that reference it.
+bool IsSkippable(const EncodedFrame& frame) {
+  if (frame.is_keyframe())
+    return false;
+  const CodecSpecificInfo* codec_specific = frame.CodecSpecific();
+  switch (codec_specific->codecType) {
+    case kVideoCodecVP8:
+      return codec_specific->codecSpecific.VP8.nonReference ||
+             codec_specific->codecSpecific.VP8.temporalIdx > 0;
+    case kVideoCodecVP9:
+      return codec_specific->codecSpecific.VP9.temporal_idx > 0;
+    default:
+      return false;
+  }
+}
 }  // namespace
 
+constexpr size_t FrameBuffer::kFrameTableSize;
+
 FrameBuffer::FrameBuffer(Clock* clock,
                          VCMJitterEstimator* jitter_estimator,
                          VCMTiming* timing,
                          VCMReceiveStatisticsCallback* stats_callback)
-    : clock_(clock),
+    : frames_(kFrameTableSize),
+      first_position_(0),
+      num_entries_(0),
+      clock_(clock),
       new_continuous_frame_event_(false, false),
       jitter_estimator_(jitter_estimator),
       timing_(timing),
       inter_frame_delay_(clock_->TimeInMilliseconds()),
       last_decoded_frame_timestamp_(0),
-      last_decoded_frame_it_(frames_.end()),
-      last_continuous_frame_it_(frames_.end()),
       num_frames_history_(0),
       num_frames_buffered_(0),
       stopped_(false),
       protection_mode_(kProtectionNack),
+      max_decode_framerate_(0),
       stats_callback_(stats_callback),
-      last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs) {}
+      last_log_non_decoded_ms_(-kLogNonDecodedIntervalMs),
+      callback_queue_(nullptr),
+      latest_return_time_ms_(0),
+      keyframe_required_(false),
+      wait_task_id_(0) {}
 
 FrameBuffer::~FrameBuffer() {}
 
@@ -80,56 +109,10 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
       if (stopped_)
         return kStopped;
 
-      wait_ms = max_wait_time_ms;
-
       // Need to hold |crit_| in order to use |frames_|, therefore we
-      // set it here in the loop instead of outside the loop in order to not
-      // acquire the lock unnecesserily.
-      next_frame_it_ = frames_.end();
-
-      // |frame_it| points to the first frame after the
-      // |last_decoded_frame_it_|.
-      auto frame_it = frames_.end();
-      if (last_decoded_frame_it_ == frames_.end()) {
-        frame_it = frames_.begin();
-      } else {
-        frame_it = last_decoded_frame_it_;
-        ++frame_it;
-      }
-
-      // |continuous_end_it| points to the first frame after the
-      // |last_continuous_frame_it_|.
-      auto continuous_end_it = last_continuous_frame_it_;
-      if (continuous_end_it != frames_.end())
-        ++continuous_end_it;
-
-      for (; frame_it != continuous_end_it && frame_it != frames_.end();
-           ++frame_it) {
-        if (!frame_it->second.continuous ||
-            frame_it->second.num_missing_decodable > 0) {
-          continue;
-        }
-
-        EncodedFrame* frame = frame_it->second.frame.get();
-
-        if (keyframe_required && !frame->is_keyframe())
-          continue;
-
-        next_frame_it_ = frame_it;
-        if (frame->RenderTime() == -1)
-          frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-        wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
-
-        // This will cause the frame buffer to prefer high framerate rather
-        // than high resolution in the case of the decoder not decoding fast
-        // enough and the stream has multiple spatial and temporal layers.
-        // For multiple temporal layers it may cause non-base layer frames to be
-        // skipped if they are late.
-        if (wait_ms < -kMaxAllowedFrameDelayMs)
-          continue;
-
-        break;
-      }
+      // look for the frame here in the loop instead of outside the loop in
+      // order to not acquire the lock unnecesserily.
+      wait_ms = FindNextFrame(max_wait_time_ms, keyframe_required, now_ms);
     }  // rtc::Critscope lock(&crit_);
 
     wait_ms = std::min<int64_t>(wait_ms, latest_return_time_ms - now_ms);
@@ -139,73 +122,14 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
   {
     rtc::CritScope lock(&crit_);
     now_ms = clock_->TimeInMilliseconds();
-    if (next_frame_it_ != frames_.end()) {
-      std::unique_ptr<EncodedFrame> frame =
-          std::move(next_frame_it_->second.frame);
-
-      if (!frame->delayed_by_retransmission()) {
-        int64_t frame_delay;
-
-        if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
-                                              frame->ReceivedTime())) {
-          jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
-        }
-
-        float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
-        timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
-        timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
-      } else {
-        if (webrtc::field_trial::IsEnabled("WebRTC-AddRttToPlayoutDelay"))
-          jitter_estimator_->FrameNacked();
-      }
-
-      // Gracefully handle bad RTP timestamps and render time issues.
-      if (HasBadRenderTiming(*frame, now_ms)) {
-        jitter_estimator_->Reset();
-        timing_->Reset();
-        frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
-      }
-
-      UpdateJitterDelay();
-      UpdateTimingFrameInfo();
-      PropagateDecodability(next_frame_it_->second);
-
-      // Sanity check for RTP timestamp monotonicity.
-      if (last_decoded_frame_it_ != frames_.end()) {
-        const VideoLayerFrameId& last_decoded_frame_key =
-            last_decoded_frame_it_->first;
-        const VideoLayerFrameId& frame_key = next_frame_it_->first;
-
-        const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
-            last_decoded_frame_timestamp_ == frame->timestamp &&
-            last_decoded_frame_key.picture_id == frame_key.picture_id &&
-            last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
-
-        if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
-            !frame_is_higher_spatial_layer_of_last_decoded_frame) {
-          // TODO(brandtr): Consider clearing the entire buffer when we hit
-          // these conditions.
-          RTC_LOG(LS_WARNING)
-              << "Frame with (timestamp:picture_id:spatial_id) ("
-              << frame->timestamp << ":" << frame->id.picture_id << ":"
-              << static_cast<int>(frame->id.spatial_layer) << ")"
-              << " sent to decoder after frame with"
-              << " (timestamp:picture_id:spatial_id) ("
-              << last_decoded_frame_timestamp_ << ":"
-              << last_decoded_frame_key.picture_id << ":"
-              << static_cast<int>(last_decoded_frame_key.spatial_layer) << ").";
-        }
-      }
-
-      AdvanceLastDecodedFrame(next_frame_it_);
-      last_decoded_frame_timestamp_ = frame->timestamp;
-      *frame_out = std::move(frame);
+    if (next_frame_) {
+      *frame_out = GetNextFrame(now_ms);
       return kFrameFound;
     }
   }
 
   if (latest_return_time_ms - now_ms > 0) {
-    // If |next_frame_it_ == frames_.end()| and there is still time left, it
+    // If there is no |next_frame_| and there is still time left, it
     // means that the frame buffer was cleared as the thread in this function
     // was waiting to acquire |crit_| in order to return. Wait for the
     // remaining time and then return.
@@ -215,6 +139,193 @@ FrameBuffer::ReturnReason FrameBuffer::NextFrame(
   return kTimeout;
 }
 
+void FrameBuffer::NextFrame(
+    int64_t max_wait_time_ms,
+    bool keyframe_required,
+    rtc::TaskQueue* callback_queue,
+    std::function<void(std::unique_ptr<EncodedFrame>, ReturnReason)> handler) {
+  TRACE_EVENT0("webrtc", "FrameBuffer::NextFrame");
+  RTC_DCHECK(callback_queue);
+  RTC_DCHECK(handler);
+  rtc::CritScope lock(&crit_);
+  callback_queue_ = callback_queue;
+  frame_handler_ = std::move(handler);
+  keyframe_required_ = keyframe_required;
+  latest_return_time_ms_ = clock_->TimeInMilliseconds() + max_wait_time_ms;
+  StartWaitForNextFrameOnQueue();
+}
+
+void FrameBuffer::StartWaitForNextFrameOnQueue() {
+  RTC_DCHECK(callback_queue_);
+  int64_t wait_ms = 0;
+  if (!stopped_) {
+    const int64_t now_ms = clock_->TimeInMilliseconds();
+    const int64_t max_wait_time_ms = latest_return_time_ms_ - now_ms;
+    wait_ms = FindNextFrame(max_wait_time_ms, keyframe_required_, now_ms);
+    wait_ms = std::min<int64_t>(wait_ms, max_wait_time_ms);
+    wait_ms = std::max<int64_t>(wait_ms, 0);
+  }
+  // A task posted earlier is superseded by this one and does nothing, which
+  // is how a new continuous frame or Stop() cuts the wait short.
+  const uint64_t task_id = ++wait_task_id_;
+  callback_queue_->PostDelayedTask(
+      [this, task_id] { OnWaitForNextFrameDone(task_id); },
+      static_cast<uint32_t>(wait_ms));
+}
+
+void FrameBuffer::OnWaitForNextFrameDone(uint64_t task_id) {
+  std::function<void(std::unique_ptr<EncodedFrame>, ReturnReason)> handler;
+  std::unique_ptr<EncodedFrame> frame;
+  ReturnReason reason = kTimeout;
+  {
+    rtc::CritScope lock(&crit_);
+    if (task_id != wait_task_id_ || !frame_handler_)
+      return;
+    const int64_t now_ms = clock_->TimeInMilliseconds();
+    if (stopped_) {
+      reason = kStopped;
+    } else if (next_frame_) {
+      frame = GetNextFrame(now_ms);
+      reason = kFrameFound;
+    } else if (latest_return_time_ms_ - now_ms > 0) {
+      // The frame buffer was cleared while waiting, wait for the remaining
+      // time.
+      StartWaitForNextFrameOnQueue();
+      return;
+    }
+    handler = std::move(frame_handler_);
+    frame_handler_ = nullptr;
+    callback_queue_ = nullptr;
+  }
+  // Called without |crit_| so that the handler can insert frames or ask for
+  // the next one.
+  handler(std::move(frame), reason);
+}
+
+int64_t FrameBuffer::FindNextFrame(int64_t max_wait_time_ms,
+                                   bool keyframe_required,
+                                   int64_t now_ms) {
+  int64_t wait_ms = max_wait_time_ms;
+
+  next_frame_.reset();
+  if (!last_continuous_frame_)
+    return wait_ms;
+
+  // The frames after the last continuous frame can't be decoded yet, and the
+  // first continuous frame after the last decoded frame usually can. The
+  // frames skipped on the way are removed when a later frame is decoded.
+  const size_t continuous_end = *last_continuous_frame_ + 1;
+  for (size_t position =
+           last_decoded_frame_ ? *last_decoded_frame_ + 1 : first_position_;
+       position < continuous_end; ++position) {
+    FrameInfo& info = Entry(position);
+    if (!info.continuous || info.num_missing_decodable > 0)
+      continue;
+
+    EncodedFrame* frame = info.frame.get();
+
+    if (keyframe_required && !frame->is_keyframe())
+      continue;
+
+    if (max_decode_framerate_ > 0 && last_decoded_frame_ &&
+        IsSkippable(*frame) &&
+        ForwardDiff(last_decoded_frame_timestamp_, frame->timestamp) <
+            static_cast<uint32_t>(kVideoPayloadTypeFrequency /
+                                  max_decode_framerate_)) {
+      continue;
+    }
+
+    next_frame_ = position;
+    if (frame->RenderTime() == -1)
+      frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+
+    // With a playout delay of 0 the frames are decoded as soon as they are
+    // decodable, and a newer decodable frame replaces this one, which is then
+    // dropped as stale.
+    if (frame->RenderTime() == 0) {
+      wait_ms = 0;
+      continue;
+    }
+
+    wait_ms = timing_->MaxWaitingTime(frame->RenderTime(), now_ms);
+
+    // This will cause the frame buffer to prefer high framerate rather
+    // than high resolution in the case of the decoder not decoding fast
+    // enough and the stream has multiple spatial and temporal layers.
+    // For multiple temporal layers it may cause non-base layer frames to be
+    // skipped if they are late.
+    if (wait_ms < -kMaxAllowedFrameDelayMs)
+      continue;
+
+    break;
+  }
+  return wait_ms;
+}
+
+std::unique_ptr<EncodedFrame> FrameBuffer::GetNextFrame(int64_t now_ms) {
+  RTC_DCHECK(next_frame_);
+  FrameInfo& next_frame_info = Entry(*next_frame_);
+  std::unique_ptr<EncodedFrame> frame = std::move(next_frame_info.frame);
+
+  if (!frame->delayed_by_retransmission()) {
+    int64_t frame_delay;
+
+    if (inter_frame_delay_.CalculateDelay(frame->timestamp, &frame_delay,
+                                          frame->ReceivedTime())) {
+      jitter_estimator_->UpdateEstimate(frame_delay, frame->size());
+    }
+
+    float rtt_mult = protection_mode_ == kProtectionNackFEC ? 0.0 : 1.0;
+    timing_->SetJitterDelay(jitter_estimator_->GetJitterEstimate(rtt_mult));
+    timing_->UpdateCurrentDelay(frame->RenderTime(), now_ms);
+  } else {
+    if (webrtc::field_trial::IsEnabled("WebRTC-AddRttToPlayoutDelay"))
+      jitter_estimator_->FrameNacked();
+  }
+
+  // Gracefully handle bad RTP timestamps and render time issues.
+  if (HasBadRenderTiming(*frame, now_ms)) {
+    jitter_estimator_->Reset();
+    timing_->Reset();
+    frame->SetRenderTime(timing_->RenderTimeMs(frame->timestamp, now_ms));
+  }
+
+  UpdateJitterDelay();
+  UpdateTimingFrameInfo();
+  PropagateDecodability(next_frame_info);
+
+  // Sanity check for RTP timestamp monotonicity.
+  if (last_decoded_frame_) {
+    const VideoLayerFrameId& last_decoded_frame_key =
+        Entry(*last_decoded_frame_).id;
+    const VideoLayerFrameId& frame_key = next_frame_info.id;
+
+    const bool frame_is_higher_spatial_layer_of_last_decoded_frame =
+        last_decoded_frame_timestamp_ == frame->timestamp &&
+        last_decoded_frame_key.picture_id == frame_key.picture_id &&
+        last_decoded_frame_key.spatial_layer < frame_key.spatial_layer;
+
+    if (AheadOrAt(last_decoded_frame_timestamp_, frame->timestamp) &&
+        !frame_is_higher_spatial_layer_of_last_decoded_frame) {
+      // TODO(brandtr): Consider clearing the entire buffer when we hit
+      // these conditions.
+      RTC_LOG(LS_WARNING)
+          << "Frame with (timestamp:picture_id:spatial_id) ("
+          << frame->timestamp << ":" << frame->id.picture_id << ":"
+          << static_cast<int>(frame->id.spatial_layer) << ")"
+          << " sent to decoder after frame with"
+          << " (timestamp:picture_id:spatial_id) ("
+          << last_decoded_frame_timestamp_ << ":"
+          << last_decoded_frame_key.picture_id << ":"
+          << static_cast<int>(last_decoded_frame_key.spatial_layer) << ").";
+    }
+  }
+
+  AdvanceLastDecodedFrame(*next_frame_);
+  last_decoded_frame_timestamp_ = frame->timestamp;
+  return frame;
+}
+
 bool FrameBuffer::HasBadRenderTiming(const EncodedFrame& frame,
                                      int64_t now_ms) {
   // Assume that render timing errors are due to changes in the video stream.
@@ -260,6 +371,8 @@ void FrameBuffer::Stop() {
   rtc::CritScope lock(&crit_);
   stopped_ = true;
   new_continuous_frame_event_.Set();
+  if (frame_handler_)
+    StartWaitForNextFrameOnQueue();
 }
 
 void FrameBuffer::UpdateRtt(int64_t rtt_ms) {
@@ -267,6 +380,11 @@ void FrameBuffer::UpdateRtt(int64_t rtt_ms) {
   jitter_estimator_->UpdateRtt(rtt_ms);
 }
 
+void FrameBuffer::SetMaxDecodeFramerate(int max_fps) {
+  rtc::CritScope lock(&crit_);
+  max_decode_framerate_ = std::max(max_fps, 0);
+}
+
 bool FrameBuffer::ValidReferences(const EncodedFrame& frame) const {
   if (frame.id.picture_id < 0)
     return false;
@@ -311,9 +429,8 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
   rtc::CritScope lock(&crit_);
 
   int64_t last_continuous_picture_id =
-      last_continuous_frame_it_ == frames_.end()
-          ? -1
-          : last_continuous_frame_it_->first.picture_id;
+      last_continuous_frame_ ? Entry(*last_continuous_frame_).id.picture_id
+                             : -1;
 
   if (!ValidReferences(*frame)) {
     RTC_LOG(LS_WARNING) << "Frame with (picture_id:spatial_id) ("
@@ -323,7 +440,8 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
     return last_continuous_picture_id;
   }
 
-  if (num_frames_buffered_ >= kMaxFramesBuffered) {
+  if (num_frames_buffered_ >= kMaxFramesBuffered ||
+      num_entries_ + kMaxEntriesPerFrame > kFrameTableSize) {
     if (frame->is_keyframe()) {
       RTC_LOG(LS_WARNING) << "Inserting keyframe (picture_id:spatial_id) ("
                           << id.picture_id << ":"
@@ -341,8 +459,7 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
     }
   }
 
-  if (last_decoded_frame_it_ != frames_.end() &&
-      id <= last_decoded_frame_it_->first) {
+  if (last_decoded_frame_ && id <= Entry(*last_decoded_frame_).id) {
     if (AheadOf(frame->timestamp, last_decoded_frame_timestamp_) &&
         frame->is_keyframe()) {
       // If this frame has a newer timestamp but an earlier picture id then we
@@ -359,9 +476,9 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
                           << id.picture_id << ":"
                           << static_cast<int>(id.spatial_layer)
                           << ") inserted after frame ("
-                          << last_decoded_frame_it_->first.picture_id << ":"
+                          << Entry(*last_decoded_frame_).id.picture_id << ":"
                           << static_cast<int>(
-                                 last_decoded_frame_it_->first.spatial_layer)
+                                 Entry(*last_decoded_frame_).id.spatial_layer)
                           << ") was handed off for decoding, dropping frame.";
       return last_continuous_picture_id;
     }
@@ -370,17 +487,16 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
   // Test if inserting this frame would cause the order of the frames to become
   // ambiguous (covering more than half the interval of 2^16). This can happen
   // when the picture id make large jumps mid stream.
-  if (!frames_.empty() && id < frames_.begin()->first &&
-      frames_.rbegin()->first < id) {
+  if (num_entries_ > 0 && id < Entry(first_position_).id &&
+      Entry(EndPosition() - 1).id < id) {
     RTC_LOG(LS_WARNING)
         << "A jump in picture id was detected, clearing buffer.";
     ClearFramesAndHistory();
     last_continuous_picture_id = -1;
   }
 
-  auto info = frames_.emplace(id, FrameInfo()).first;
-
-  if (info->second.frame) {
+  size_t position = FindEntry(id);
+  if (position != EndPosition() && Entry(position).frame) {
     RTC_LOG(LS_WARNING) << "Frame with (picture_id:spatial_id) ("
                         << id.picture_id << ":"
                         << static_cast<int>(id.spatial_layer)
@@ -388,56 +504,74 @@ int64_t FrameBuffer::InsertFrame(std::unique_ptr<EncodedFrame> frame) {
     return last_continuous_picture_id;
   }
 
-  if (!UpdateFrameInfoWithIncomingFrame(*frame, info))
+  size_t num_missing_continuous;
+  size_t num_missing_decodable;
+  if (!UpdateFrameInfoWithIncomingFrame(*frame, &num_missing_continuous,
+                                        &num_missing_decodable)) {
+    // Keep an entry for the dropped frame since earlier references may
+    // already list it as a dependent frame.
+    FrameInfo& info = Entry(FindOrInsertEntry(id));
+    info.num_missing_continuous = num_missing_continuous;
+    info.num_missing_decodable = num_missing_decodable;
     return last_continuous_picture_id;
+  }
   UpdatePlayoutDelays(*frame);
 
-  info->second.frame = std::move(frame);
+  // The references are earlier in the table, so the entry of the frame is
+  // looked up after adding theirs.
+  position = FindOrInsertEntry(id);
+  FrameInfo& info = Entry(position);
+  info.num_missing_continuous = num_missing_continuous;
+  info.num_missing_decodable = num_missing_decodable;
+  info.frame = std::move(frame);
   ++num_frames_buffered_;
 
-  if (info->second.num_missing_continuous == 0) {
-    info->second.continuous = true;
-    PropagateContinuity(info);
-    last_continuous_picture_id = last_continuous_frame_it_->first.picture_id;
+  if (info.num_missing_continuous == 0) {
+    info.continuous = true;
+    PropagateContinuity(position);
+    last_continuous_picture_id = Entry(*last_continuous_frame_).id.picture_id;
 
     // Since we now have new continuous frames there might be a better frame
     // to return from NextFrame. Signal that thread so that it again can choose
     // which frame to return.
     new_continuous_frame_event_.Set();
+    if (frame_handler_)
+      StartWaitForNextFrameOnQueue();
   }
 
   return last_continuous_picture_id;
 }
 
-void FrameBuffer::PropagateContinuity(FrameMap::iterator start) {
+void FrameBuffer::PropagateContinuity(size_t start) {
   TRACE_EVENT0("webrtc", "FrameBuffer::PropagateContinuity");
-  RTC_DCHECK(start->second.continuous);
-  if (last_continuous_frame_it_ == frames_.end())
-    last_continuous_frame_it_ = start;
+  RTC_DCHECK(Entry(start).continuous);
+  if (!last_continuous_frame_)
+    last_continuous_frame_ = start;
 
-  std::queue<FrameMap::iterator> continuous_frames;
-  continuous_frames.push(start);
+  continuous_frames_.clear();
+  continuous_frames_.push_back(start);
 
   // A simple BFS to traverse continuous frames.
-  while (!continuous_frames.empty()) {
-    auto frame = continuous_frames.front();
-    continuous_frames.pop();
+  for (size_t i = 0; i < continuous_frames_.size(); ++i) {
+    const size_t position = continuous_frames_[i];
+    const FrameInfo& frame = Entry(position);
 
-    if (last_continuous_frame_it_->first < frame->first)
-      last_continuous_frame_it_ = frame;
+    if (*last_continuous_frame_ < position)
+      last_continuous_frame_ = position;
 
     // Loop through all dependent frames, and if that frame no longer has
     // any unfulfilled dependencies then that frame is continuous as well.
-    for (size_t d = 0; d < frame->second.num_dependent_frames; ++d) {
-      auto frame_ref = frames_.find(frame->second.dependent_frames[d]);
-      RTC_DCHECK(frame_ref != frames_.end());
+    for (size_t d = 0; d < frame.num_dependent_frames; ++d) {
+      size_t frame_ref = FindEntry(frame.dependent_frames[d]);
+      RTC_DCHECK(frame_ref != EndPosition());
 
       // TODO(philipel): Look into why we've seen this happen.
-      if (frame_ref != frames_.end()) {
-        --frame_ref->second.num_missing_continuous;
-        if (frame_ref->second.num_missing_continuous == 0) {
-          frame_ref->second.continuous = true;
-          continuous_frames.push(frame_ref);
+      if (frame_ref != EndPosition()) {
+        FrameInfo& ref_info = Entry(frame_ref);
+        --ref_info.num_missing_continuous;
+        if (ref_info.num_missing_continuous == 0) {
+          ref_info.continuous = true;
+          continuous_frames_.push_back(frame_ref);
         }
       }
     }
@@ -448,60 +582,58 @@ void FrameBuffer::PropagateDecodability(const FrameInfo& info) {
   TRACE_EVENT0("webrtc", "FrameBuffer::PropagateDecodability");
   RTC_CHECK(info.num_dependent_frames < FrameInfo::kMaxNumDependentFrames);
   for (size_t d = 0; d < info.num_dependent_frames; ++d) {
-    auto ref_info = frames_.find(info.dependent_frames[d]);
-    RTC_DCHECK(ref_info != frames_.end());
+    size_t ref_info = FindEntry(info.dependent_frames[d]);
+    RTC_DCHECK(ref_info != EndPosition());
     // TODO(philipel): Look into why we've seen this happen.
-    if (ref_info != frames_.end()) {
-      RTC_DCHECK_GT(ref_info->second.num_missing_decodable, 0U);
-      --ref_info->second.num_missing_decodable;
+    if (ref_info != EndPosition()) {
+      RTC_DCHECK_GT(Entry(ref_info).num_missing_decodable, 0U);
+      --Entry(ref_info).num_missing_decodable;
     }
   }
 }
 
-void FrameBuffer::AdvanceLastDecodedFrame(FrameMap::iterator decoded) {
+void FrameBuffer::AdvanceLastDecodedFrame(size_t decoded) {
   TRACE_EVENT0("webrtc", "FrameBuffer::AdvanceLastDecodedFrame");
-  if (last_decoded_frame_it_ == frames_.end()) {
-    last_decoded_frame_it_ = frames_.begin();
-  } else {
-    RTC_DCHECK(last_decoded_frame_it_->first < decoded->first);
-    ++last_decoded_frame_it_;
-  }
+  const size_t first_skipped =
+      last_decoded_frame_ ? *last_decoded_frame_ + 1 : first_position_;
+  RTC_DCHECK_LE(first_skipped, decoded);
   --num_frames_buffered_;
   ++num_frames_history_;
 
   // First, delete non-decoded frames from the history.
-  while (last_decoded_frame_it_ != decoded) {
-    if (last_decoded_frame_it_->second.frame)
+  for (size_t position = first_skipped; position < decoded; ++position) {
+    if (Entry(position).frame)
       --num_frames_buffered_;
-    last_decoded_frame_it_ = frames_.erase(last_decoded_frame_it_);
   }
+  EraseEntries(first_skipped, decoded);
+  last_decoded_frame_ = decoded;
 
   // Then remove old history if we have too much history saved.
   if (num_frames_history_ > kMaxFramesHistory) {
-    frames_.erase(frames_.begin());
+    RTC_DCHECK_LT(first_position_, decoded);
+    EraseEntries(first_position_, first_position_ + 1);
     --num_frames_history_;
   }
 }
 
-bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
-                                                   FrameMap::iterator info) {
+bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(
+    const EncodedFrame& frame,
+    size_t* num_missing_continuous,
+    size_t* num_missing_decodable) {
   TRACE_EVENT0("webrtc", "FrameBuffer::UpdateFrameInfoWithIncomingFrame");
   const VideoLayerFrameId& id = frame.id;
-  info->second.num_missing_continuous = frame.num_references;
-  info->second.num_missing_decodable = frame.num_references;
+  *num_missing_continuous = frame.num_references;
+  *num_missing_decodable = frame.num_references;
 
-  RTC_DCHECK(last_decoded_frame_it_ == frames_.end() ||
-             last_decoded_frame_it_->first < info->first);
+  RTC_DCHECK(!last_decoded_frame_ || Entry(*last_decoded_frame_).id < id);
 
   // Check how many dependencies that have already been fulfilled.
   for (size_t i = 0; i < frame.num_references; ++i) {
     VideoLayerFrameId ref_key(frame.references[i], frame.id.spatial_layer);
-    auto ref_info = frames_.find(ref_key);
 
     // Does |frame| depend on a frame earlier than the last decoded frame?
-    if (last_decoded_frame_it_ != frames_.end() &&
-        ref_key <= last_decoded_frame_it_->first) {
-      if (ref_info == frames_.end()) {
+    if (last_decoded_frame_ && ref_key <= Entry(*last_decoded_frame_).id) {
+      if (FindEntry(ref_key) == EndPosition()) {
         int64_t now_ms = clock_->TimeInMilliseconds();
         if (last_log_non_decoded_ms_ + kLogNonDecodedIntervalMs < now_ms) {
           RTC_LOG(LS_WARNING)
@@ -514,56 +646,53 @@ bool FrameBuffer::UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
         return false;
       }
 
-      --info->second.num_missing_continuous;
-      --info->second.num_missing_decodable;
+      --*num_missing_continuous;
+      --*num_missing_decodable;
     } else {
-      if (ref_info == frames_.end())
-        ref_info = frames_.insert(std::make_pair(ref_key, FrameInfo())).first;
+      FrameInfo& ref_info = Entry(FindOrInsertEntry(ref_key));
 
-      if (ref_info->second.continuous)
-        --info->second.num_missing_continuous;
+      if (ref_info.continuous)
+        --*num_missing_continuous;
 
       // Add backwards reference so |frame| can be updated when new
       // frames are inserted or decoded.
-      ref_info->second.dependent_frames[ref_info->second.num_dependent_frames] =
-          id;
-      RTC_DCHECK_LT(ref_info->second.num_dependent_frames,
+      ref_info.dependent_frames[ref_info.num_dependent_frames] = id;
+      RTC_DCHECK_LT(ref_info.num_dependent_frames,
                     (FrameInfo::kMaxNumDependentFrames - 1));
       // TODO(philipel): Look into why this could happen and handle
       // appropriately.
-      if (ref_info->second.num_dependent_frames <
+      if (ref_info.num_dependent_frames <
           (FrameInfo::kMaxNumDependentFrames - 1)) {
-        ++ref_info->second.num_dependent_frames;
+        ++ref_info.num_dependent_frames;
       }
+      RTC_DCHECK_LE(ref_info.num_missing_continuous,
+                    ref_info.num_missing_decodable);
     }
-    RTC_DCHECK_LE(ref_info->second.num_missing_continuous,
-                  ref_info->second.num_missing_decodable);
   }
 
   // Check if we have the lower spatial layer frame.
   if (frame.inter_layer_predicted) {
-    ++info->second.num_missing_continuous;
-    ++info->second.num_missing_decodable;
+    ++*num_missing_continuous;
+    ++*num_missing_decodable;
 
     VideoLayerFrameId ref_key(frame.id.picture_id, frame.id.spatial_layer - 1);
     // Gets or create the FrameInfo for the referenced frame.
-    auto ref_info = frames_.insert(std::make_pair(ref_key, FrameInfo())).first;
-    if (ref_info->second.continuous)
-      --info->second.num_missing_continuous;
+    const size_t ref_position = FindOrInsertEntry(ref_key);
+    FrameInfo& ref_info = Entry(ref_position);
+    if (ref_info.continuous)
+      --*num_missing_continuous;
 
-    if (ref_info == last_decoded_frame_it_) {
-      --info->second.num_missing_decodable;
+    if (last_decoded_frame_ && ref_position == *last_decoded_frame_) {
+      --*num_missing_decodable;
     } else {
-      ref_info->second.dependent_frames[ref_info->second.num_dependent_frames] =
-          id;
-      ++ref_info->second.num_dependent_frames;
+      ref_info.dependent_frames[ref_info.num_dependent_frames] = id;
+      ++ref_info.num_dependent_frames;
     }
-    RTC_DCHECK_LE(ref_info->second.num_missing_continuous,
-                  ref_info->second.num_missing_decodable);
+    RTC_DCHECK_LE(ref_info.num_missing_continuous,
+                  ref_info.num_missing_decodable);
   }
 
-  RTC_DCHECK_LE(info->second.num_missing_continuous,
-                info->second.num_missing_decodable);
+  RTC_DCHECK_LE(*num_missing_continuous, *num_missing_decodable);
 
   return true;
 }
@@ -598,16 +727,94 @@ void FrameBuffer::UpdateTimingFrameInfo() {
 
 void FrameBuffer::ClearFramesAndHistory() {
   TRACE_EVENT0("webrtc", "FrameBuffer::ClearFramesAndHistory");
-  frames_.clear();
-  last_decoded_frame_it_ = frames_.end();
-  last_continuous_frame_it_ = frames_.end();
-  next_frame_it_ = frames_.end();
+  EraseEntries(first_position_, EndPosition());
+  last_decoded_frame_.reset();
+  last_continuous_frame_.reset();
+  next_frame_.reset();
   num_frames_history_ = 0;
   num_frames_buffered_ = 0;
 }
 
+size_t FrameBuffer::LowerBoundEntry(const VideoLayerFrameId& id) const {
+  size_t begin = first_position_;
+  size_t end = EndPosition();
+  // Frames mostly arrive in order, so look at the last entry first.
+  if (num_entries_ == 0 || Entry(end - 1).id < id)
+    return end;
+  if (Entry(end - 1).id == id)
+    return end - 1;
+  while (begin < end) {
+    const size_t middle = begin + (end - begin) / 2;
+    if (Entry(middle).id < id) {
+      begin = middle + 1;
+    } else {
+      end = middle;
+    }
+  }
+  return begin;
+}
+
+size_t FrameBuffer::FindEntry(const VideoLayerFrameId& id) const {
+  const size_t position = LowerBoundEntry(id);
+  if (position != EndPosition() && Entry(position).id == id)
+    return position;
+  return EndPosition();
+}
+
+size_t FrameBuffer::FindOrInsertEntry(const VideoLayerFrameId& id) {
+  const size_t position = LowerBoundEntry(id);
+  if (position != EndPosition() && Entry(position).id == id)
+    return position;
+
+  RTC_CHECK_LT(num_entries_, kFrameTableSize);
+  for (size_t later = EndPosition(); later > position; --later)
+    Entry(later) = std::move(Entry(later - 1));
+  ++num_entries_;
+  Entry(position) = FrameInfo();
+  Entry(position).id = id;
+
+  for (rtc::Optional<size_t>* moved :
+       {&last_decoded_frame_, &last_continuous_frame_, &next_frame_}) {
+    if (*moved && **moved >= position)
+      ++**moved;
+  }
+  return position;
+}
+
+void FrameBuffer::EraseEntries(size_t begin, size_t end) {
+  RTC_DCHECK_LE(first_position_, begin);
+  RTC_DCHECK_LE(begin, end);
+  RTC_DCHECK_LE(end, EndPosition());
+  const size_t count = end - begin;
+  if (count == 0)
+    return;
+  for (rtc::Optional<size_t>* moved :
+       {&last_decoded_frame_, &last_continuous_frame_, &next_frame_}) {
+    if (!*moved || **moved >= end)
+      continue;
+    if (**moved >= begin) {
+      moved->reset();
+    } else {
+      **moved += count;
+    }
+  }
+  while (begin > first_position_) {
+    --begin;
+    --end;
+    Entry(end) = std::move(Entry(begin));
+  }
+  for (size_t position = first_position_; position < first_position_ + count;
+       ++position) {
+    Entry(position).frame.reset();
+  }
+  first_position_ += count;
+  num_entries_ -= count;
+}
+
 FrameBuffer::FrameInfo::FrameInfo() = default;
 FrameBuffer::FrameInfo::FrameInfo(FrameInfo&&) = default;
+FrameBuffer::FrameInfo& FrameBuffer::FrameInfo::operator=(FrameInfo&&) =
+    default;
 FrameBuffer::FrameInfo::~FrameInfo() = default;
 
 }  // namespace video_coding
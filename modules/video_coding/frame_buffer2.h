@@ -12,10 +12,12 @@
 #define MODULES_VIDEO_CODING_FRAME_BUFFER2_H_
 
 #include <array>
-#include <map>
+#include <functional>
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "api/optional.h"
 #include "api/video/encoded_frame.h"
 #include "modules/video_coding/include/video_coding_defines.h"
 #include "modules/video_coding/inter_frame_delay.h"
@@ -23,6 +25,7 @@
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
 #include "rtc_base/numerics/sequence_number_util.h"
+#include "rtc_base/task_queue.h"
 #include "rtc_base/thread_annotations.h"
 
 namespace webrtc {
@@ -61,6 +64,19 @@ class FrameBuffer {
                          std::unique_ptr<EncodedFrame>* frame_out,
                          bool keyframe_required = false);
 
+  // Asynchronous version of NextFrame() for decoding on a task queue. Returns
+  // right away and later runs |handler| on |callback_queue| with the frame
+  // and kFrameFound, with nullptr and kTimeout after |max_wait_time_ms|, or
+  // with nullptr and kStopped when the frame buffer is stopped. Each call
+  // replaces the pending request, if any. |callback_queue| must be destroyed
+  // before the frame buffer.
+  void NextFrame(
+      int64_t max_wait_time_ms,
+      bool keyframe_required,
+      rtc::TaskQueue* callback_queue,
+      std::function<void(std::unique_ptr<EncodedFrame>, ReturnReason)>
+          handler);
+
   // Tells the FrameBuffer which protection mode that is in use. Affects
   // the frame timing.
   // TODO(philipel): Remove this when new timing calculations has been
@@ -78,15 +94,27 @@ class FrameBuffer {
   // Updates the RTT for jitter buffer estimation.
   void UpdateRtt(int64_t rtt_ms);
 
+  // Decodes about |max_fps| frames per second at most, by skipping the frames
+  // that are less than 1 / |max_fps| after the last decoded one and that the
+  // frames of lower temporal layers don't reference: those above the base
+  // temporal layer, and VP8 frames marked as not referenced. The frames that
+  // reference a skipped frame aren't decodable and are skipped too. Keyframes
+  // and streams without temporal layers are decoded in full. 0, the default,
+  // decodes every frame.
+  void SetMaxDecodeFramerate(int max_fps);
+
  private:
   struct FrameInfo {
     FrameInfo();
     FrameInfo(FrameInfo&&);
+    FrameInfo& operator=(FrameInfo&&);
     ~FrameInfo();
 
     // The maximum number of frames that can depend on this frame.
     static constexpr size_t kMaxNumDependentFrames = 8;
 
+    VideoLayerFrameId id;
+
     // Which other frames that have direct unfulfilled dependencies
     // on this frame.
     // TODO(philipel): Add simple modify/access functions to prevent adding too
@@ -112,7 +140,62 @@ class FrameBuffer {
     std::unique_ptr<EncodedFrame> frame;
   };
 
-  using FrameMap = std::map<VideoLayerFrameId, FrameInfo>;
+  // Capacity of the frame table, enough for kMaxFramesBuffered frames and
+  // the decoded history with room for placeholders of missing references.
+  static constexpr size_t kFrameTableSize = 1024;
+
+  // The frame table holds the buffered frames, placeholders for the frames
+  // they reference that haven't been received yet and the history of decoded
+  // frames, sorted by id in a ring of kFrameTableSize entries. An entry is
+  // addressed by its position, counted from the first entry ever stored, so
+  // that positions stay valid when earlier entries are removed.
+  FrameInfo& Entry(size_t position) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    return frames_[position % kFrameTableSize];
+  }
+  const FrameInfo& Entry(size_t position) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    return frames_[position % kFrameTableSize];
+  }
+  size_t EndPosition() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_) {
+    return first_position_ + num_entries_;
+  }
+
+  // Returns the position of the first entry not before |id|.
+  size_t LowerBoundEntry(const VideoLayerFrameId& id) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Returns the position of the entry for |id|, or EndPosition() if there is
+  // none.
+  size_t FindEntry(const VideoLayerFrameId& id) const
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Returns the position of the entry for |id|, inserting an empty one if
+  // there is none. Later entries move up one position. The table must not be
+  // full.
+  size_t FindOrInsertEntry(const VideoLayerFrameId& id)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Removes the entries in [|begin|, |end|) by moving the entries before them
+  // up, so that the positions from |end| on are kept.
+  void EraseEntries(size_t begin, size_t end)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Sets |next_frame_| to the frame to decode next, if any, and returns
+  // how long to wait before decoding it, or |max_wait_time_ms| if there is
+  // no decodable frame.
+  int64_t FindNextFrame(int64_t max_wait_time_ms,
+                        bool keyframe_required,
+                        int64_t now_ms) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Takes the frame at |next_frame_| out of the buffer and marks it as
+  // decoded.
+  std::unique_ptr<EncodedFrame> GetNextFrame(int64_t now_ms)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
+  // Posts the task answering the pending asynchronous NextFrame() to
+  // |callback_queue_|, when the next frame is due.
+  void StartWaitForNextFrameOnQueue() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void OnWaitForNextFrameDone(uint64_t task_id);
 
   // Check that the references of |frame| are valid.
   bool ValidReferences(const EncodedFrame& frame) const;
@@ -124,23 +207,25 @@ class FrameBuffer {
 
   // Update all directly dependent and indirectly dependent frames and mark
   // them as continuous if all their references has been fulfilled.
-  void PropagateContinuity(FrameMap::iterator start)
+  void PropagateContinuity(size_t start)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Marks the frame as decoded and updates all directly dependent frames.
   void PropagateDecodability(const FrameInfo& info)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  // Advances |last_decoded_frame_it_| to |decoded| and removes old
+  // Advances |last_decoded_frame_| to |decoded| and removes old
   // frame info.
-  void AdvanceLastDecodedFrame(FrameMap::iterator decoded)
+  void AdvanceLastDecodedFrame(size_t decoded)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  // Update the corresponding FrameInfo of |frame| and all FrameInfos that
-  // |frame| references.
+  // Update the FrameInfos that |frame| references, and count in
+  // |num_missing_continuous| and |num_missing_decodable| the references
+  // that |frame| is still missing.
   // Return false if |frame| will never be decodable, true otherwise.
   bool UpdateFrameInfoWithIncomingFrame(const EncodedFrame& frame,
-                                        FrameMap::iterator info)
+                                        size_t* num_missing_continuous,
+                                        size_t* num_missing_decodable)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   void UpdateJitterDelay() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
@@ -152,7 +237,11 @@ class FrameBuffer {
   bool HasBadRenderTiming(const EncodedFrame& frame, int64_t now_ms)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  FrameMap frames_ RTC_GUARDED_BY(crit_);
+  std::vector<FrameInfo> frames_ RTC_GUARDED_BY(crit_);
+  size_t first_position_ RTC_GUARDED_BY(crit_);
+  size_t num_entries_ RTC_GUARDED_BY(crit_);
+  // Reused by PropagateContinuity() to not allocate for each frame.
+  std::vector<size_t> continuous_frames_ RTC_GUARDED_BY(crit_);
 
   rtc::CriticalSection crit_;
   Clock* const clock_;
@@ -161,16 +250,26 @@ class FrameBuffer {
   VCMTiming* const timing_ RTC_GUARDED_BY(crit_);
   VCMInterFrameDelay inter_frame_delay_ RTC_GUARDED_BY(crit_);
   uint32_t last_decoded_frame_timestamp_ RTC_GUARDED_BY(crit_);
-  FrameMap::iterator last_decoded_frame_it_ RTC_GUARDED_BY(crit_);
-  FrameMap::iterator last_continuous_frame_it_ RTC_GUARDED_BY(crit_);
-  FrameMap::iterator next_frame_it_ RTC_GUARDED_BY(crit_);
+  rtc::Optional<size_t> last_decoded_frame_ RTC_GUARDED_BY(crit_);
+  rtc::Optional<size_t> last_continuous_frame_ RTC_GUARDED_BY(crit_);
+  rtc::Optional<size_t> next_frame_ RTC_GUARDED_BY(crit_);
   int num_frames_history_ RTC_GUARDED_BY(crit_);
   int num_frames_buffered_ RTC_GUARDED_BY(crit_);
   bool stopped_ RTC_GUARDED_BY(crit_);
   VCMVideoProtection protection_mode_ RTC_GUARDED_BY(crit_);
+  int max_decode_framerate_ RTC_GUARDED_BY(crit_);
   VCMReceiveStatisticsCallback* const stats_callback_;
   int64_t last_log_non_decoded_ms_ RTC_GUARDED_BY(crit_);
 
+  // The pending asynchronous NextFrame() request.
+  rtc::TaskQueue* callback_queue_ RTC_GUARDED_BY(crit_);
+  std::function<void(std::unique_ptr<EncodedFrame>, ReturnReason)>
+      frame_handler_ RTC_GUARDED_BY(crit_);
+  int64_t latest_return_time_ms_ RTC_GUARDED_BY(crit_);
+  bool keyframe_required_ RTC_GUARDED_BY(crit_);
+  // Id of the latest task posted for the request.
+  uint64_t wait_task_id_ RTC_GUARDED_BY(crit_);
+
   RTC_DISALLOW_IMPLICIT_CONSTRUCTORS(FrameBuffer);
 };
 
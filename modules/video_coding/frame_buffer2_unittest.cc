@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <cstring>
 #include <limits>
+#include <string>
 #include <vector>
 
 #include "modules/video_coding/frame_object.h"
@@ -21,9 +22,12 @@
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/random.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/timeutils.h"
 #include "system_wrappers/include/clock.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
 
 using testing::_;
 using testing::Return;
@@ -99,6 +103,11 @@ class FrameObjectFake : public EncodedFrame {
   // In EncodedImage |_length| is used to descibe its size and |_size| to
   // describe its capacity.
   void SetSize(int size) { _length = size; }
+
+  void SetTemporalLayer(uint8_t temporal_idx) {
+    _codecSpecificInfo.codecType = kVideoCodecVP8;
+    _codecSpecificInfo.codecSpecific.VP8.temporalIdx = temporal_idx;
+  }
 };
 
 class VCMReceiveStatisticsCallbackMock : public VCMReceiveStatisticsCallback {
@@ -174,6 +183,23 @@ class TestFrameBuffer2 : public ::testing::Test {
     return buffer_->InsertFrame(std::move(frame));
   }
 
+  // Inserts a VP8 frame of |temporal_idx| that references the frame
+  // |reference|, or a keyframe if |reference| is -1.
+  void InsertTemporalLayerFrame(uint16_t picture_id,
+                                int64_t ts_ms,
+                                uint8_t temporal_idx,
+                                int reference) {
+    std::unique_ptr<FrameObjectFake> frame(new FrameObjectFake());
+    frame->id.picture_id = picture_id;
+    frame->timestamp = ts_ms * 90;
+    frame->SetTemporalLayer(temporal_idx);
+    if (reference >= 0) {
+      frame->num_references = 1;
+      frame->references[0] = rtc::checked_cast<uint16_t>(reference);
+    }
+    buffer_->InsertFrame(std::move(frame));
+  }
+
   void ExtractFrame(int64_t max_wait_time = 0, bool keyframe_required = false) {
     crit_.Enter();
     if (max_wait_time == 0) {
@@ -293,6 +319,33 @@ TEST_F(TestFrameBuffer2, ZeroPlayoutDelay) {
   EXPECT_EQ(0, frames_[0]->RenderTimeMs());
 }
 
+TEST_F(TestFrameBuffer2, ZeroPlayoutDelayDropsStaleFrames) {
+  VCMTiming timing(&clock_);
+  buffer_.reset(
+      new FrameBuffer(&clock_, &jitter_estimator_, &timing, &stats_callback_));
+  const PlayoutDelay kPlayoutDelayMs = {0, 0};
+  std::unique_ptr<FrameObjectFake> test_frame(new FrameObjectFake());
+  test_frame->id.picture_id = 0;
+  test_frame->SetPlayoutDelay(kPlayoutDelayMs);
+  buffer_->InsertFrame(std::move(test_frame));
+  ExtractFrame();
+
+  // Frame 2 doesn't need frame 1, so frame 1 is stale once 2 is decodable.
+  InsertFrame(1, 0, 33, false, 0);
+  InsertFrame(2, 0, 66, false, 0);
+  ExtractFrame();
+  // Frame 4 needs frame 3, which is decoded first.
+  InsertFrame(3, 0, 99, false, 2);
+  InsertFrame(4, 0, 133, false, 3);
+  ExtractFrame();
+  ExtractFrame();
+
+  CheckFrame(0, 0, 0);
+  CheckFrame(1, 2, 0);
+  CheckFrame(2, 3, 0);
+  CheckFrame(3, 4, 0);
+}
+
 // Flaky test, see bugs.webrtc.org/7068.
 TEST_F(TestFrameBuffer2, DISABLED_OneUnorderedSuperFrame) {
   uint16_t pid = Rand();
@@ -392,6 +445,51 @@ TEST_F(TestFrameBuffer2, DropTemporalLayerSlowDecoder) {
   CheckNoFrame(9);
 }
 
+TEST_F(TestFrameBuffer2, SkipsUpperTemporalLayerAboveMaxDecodeFramerate) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  buffer_->SetMaxDecodeFramerate(10);
+
+  // 20 fps in two temporal layers, of which the base layer is decoded at 10
+  // fps.
+  InsertTemporalLayerFrame(pid, ts, 0, -1);
+  for (int i = 1; i < 8; ++i) {
+    if (i % 2 == 1)
+      InsertTemporalLayerFrame(pid + i, ts + i * kFps20, 1, pid + i - 1);
+    else
+      InsertTemporalLayerFrame(pid + i, ts + i * kFps20, 0, pid + i - 2);
+  }
+
+  for (int i = 0; i < 5; ++i) {
+    ExtractFrame();
+    clock_.AdvanceTimeMilliseconds(kFps10);
+  }
+
+  CheckFrame(0, pid, 0);
+  CheckFrame(1, pid + 2, 0);
+  CheckFrame(2, pid + 4, 0);
+  CheckFrame(3, pid + 6, 0);
+  CheckNoFrame(4);
+}
+
+TEST_F(TestFrameBuffer2, MaxDecodeFramerateKeepsFramesWithoutLayers) {
+  uint16_t pid = Rand();
+  uint32_t ts = Rand();
+  buffer_->SetMaxDecodeFramerate(10);
+
+  InsertFrame(pid, 0, ts, false);
+  for (int i = 1; i < 4; ++i)
+    InsertFrame(pid + i, 0, ts + i * kFps20, false, pid + i - 1);
+
+  for (int i = 0; i < 4; ++i) {
+    ExtractFrame();
+    clock_.AdvanceTimeMilliseconds(kFps20);
+  }
+
+  for (int i = 0; i < 4; ++i)
+    CheckFrame(i, pid + i, 0);
+}
+
 TEST_F(TestFrameBuffer2, DropSpatialLayerSlowDecoder) {
   uint16_t pid = Rand();
   uint32_t ts = Rand();
@@ -592,5 +690,76 @@ TEST_F(TestFrameBuffer2, KeyframeClearsFullBuffer) {
   CheckFrame(1, kMaxBufferSize + 1, 0);
 }
 
+TEST_F(TestFrameBuffer2, NextFrameOnTaskQueue) {
+  rtc::TaskQueue queue("DecodeQueue");
+  rtc::Event handler_done(false, false);
+  std::unique_ptr<EncodedFrame> frame;
+  FrameBuffer::ReturnReason reason = FrameBuffer::kFrameFound;
+  auto handler = [&](std::unique_ptr<EncodedFrame> next_frame,
+                     FrameBuffer::ReturnReason next_reason) {
+    EXPECT_TRUE(queue.IsCurrent());
+    frame = std::move(next_frame);
+    reason = next_reason;
+    handler_done.Set();
+  };
+  uint16_t pid = Rand();
+
+  buffer_->NextFrame(1000, false, &queue, handler);
+  InsertFrame(pid, 0, Rand(), false);
+  ASSERT_TRUE(handler_done.Wait(1000));
+  EXPECT_EQ(FrameBuffer::kFrameFound, reason);
+  ASSERT_TRUE(frame);
+  EXPECT_EQ(pid, frame->id.picture_id);
+
+  buffer_->NextFrame(0, false, &queue, handler);
+  ASSERT_TRUE(handler_done.Wait(1000));
+  EXPECT_EQ(FrameBuffer::kTimeout, reason);
+  EXPECT_FALSE(frame);
+
+  // Stopping the buffer answers a pending request right away.
+  buffer_->NextFrame(100000, false, &queue, handler);
+  buffer_->Stop();
+  ASSERT_TRUE(handler_done.Wait(1000));
+  EXPECT_EQ(FrameBuffer::kStopped, reason);
+  EXPECT_FALSE(frame);
+}
+
+TEST_F(TestFrameBuffer2, DISABLED_SpatialLayersBenchmark) {
+  const int kNumSpatialLayers = 3;
+  const int kNumPictures = 20000;
+  // Pictures are extracted this many pictures after they are inserted, so
+  // that the buffer holds some frames.
+  const int kBufferedPictures = 30;
+  // Without the mocks, which would dominate the time.
+  VCMJitterEstimator jitter_estimator(&clock_);
+  buffer_.reset(
+      new FrameBuffer(&clock_, &jitter_estimator, &timing_, nullptr));
+
+  int64_t start_ns = rtc::TimeNanos();
+  for (int pid = 0; pid < kNumPictures; ++pid) {
+    for (int sid = 0; sid < kNumSpatialLayers; ++sid) {
+      if (pid == 0) {
+        InsertFrame(pid, sid, 0, sid > 0);
+      } else {
+        InsertFrame(pid, sid, pid * kFps20, sid > 0, pid - 1);
+      }
+    }
+    if (pid < kBufferedPictures)
+      continue;
+    for (int sid = 0; sid < kNumSpatialLayers; ++sid) {
+      std::unique_ptr<EncodedFrame> frame;
+      ASSERT_EQ(FrameBuffer::kFrameFound, buffer_->NextFrame(0, &frame));
+    }
+    clock_.AdvanceTimeMilliseconds(kFps20);
+  }
+  int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+  test::PrintResult(
+      "frame_buffer_time", "",
+      std::to_string(kNumSpatialLayers) + "_spatial_layers",
+      static_cast<double>(elapsed_ns) / (kNumPictures * kNumSpatialLayers) /
+          1000,
+      "us", false);
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
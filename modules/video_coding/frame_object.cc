@@ -10,7 +10,10 @@
 
 #include "modules/video_coding/frame_object.h"
 
+#include <string.h>
+
 #include "common_video/h264/h264_common.h"
+#include "modules/rtp_rtcp/include/rtp_rtcp_defines.h"
 #include "modules/video_coding/packet_buffer.h"
 #include "rtc_base/checks.h"
 
@@ -49,22 +52,16 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
   // as of the first packet's.
   SetPlayoutDelay(first_packet->video_header.playout_delay);
 
-  // Since FFmpeg use an optimized bitstream reader that reads in chunks of
-  // 32/64 bits we have to add at least that much padding to the buffer
-  // to make sure the decoder doesn't read out of bounds.
+  // The bitstream stays in the packet payloads until Linearize() is called.
   // NOTE! EncodedImage::_size is the size of the buffer (think capacity of
   //       an std::vector) and EncodedImage::_length is the actual size of
   //       the bitstream (think size of an std::vector).
-  if (codec_type_ == kVideoCodecH264)
-    _size = frame_size + EncodedImage::kBufferPaddingBytesH264;
-  else
-    _size = frame_size;
-
-  _buffer = new uint8_t[_size];
+  _buffer = nullptr;
+  _size = 0;
   _length = frame_size;
 
-  bool bitstream_copied = GetBitstream(_buffer);
-  RTC_DCHECK(bitstream_copied);
+  bool bitstream_taken = packet_buffer_->TakeBitstream(*this, &segments_);
+  RTC_DCHECK(bitstream_taken);
   _encodedWidth = first_packet->width;
   _encodedHeight = first_packet->height;
 
@@ -113,6 +110,7 @@ RtpFrameObject::RtpFrameObject(PacketBuffer* packet_buffer,
 }
 
 RtpFrameObject::~RtpFrameObject() {
+  FreeSegments();
   packet_buffer_->ReturnFrame(this);
 }
 
@@ -137,7 +135,63 @@ VideoCodecType RtpFrameObject::codec_type() const {
 }
 
 bool RtpFrameObject::GetBitstream(uint8_t* destination) const {
-  return packet_buffer_->GetBitstream(*this, destination);
+  if (_buffer) {
+    memcpy(destination, _buffer, _length);
+    return true;
+  }
+  for (const rtc::ArrayView<const uint8_t>& segment : segments_) {
+    memcpy(destination, segment.data(), segment.size());
+    destination += segment.size();
+  }
+  return true;
+}
+
+std::vector<rtc::ArrayView<const uint8_t>> RtpFrameObject::BitstreamSegments()
+    const {
+  if (_buffer)
+    return VCMEncodedFrame::BitstreamSegments();
+  return segments_;
+}
+
+void RtpFrameObject::Linearize() {
+  if (_buffer)
+    return;
+
+  // Since FFmpeg use an optimized bitstream reader that reads in chunks of
+  // 32/64 bits we have to add at least that much padding to the buffer
+  // to make sure the decoder doesn't read out of bounds.
+  if (codec_type_ == kVideoCodecH264)
+    _size = _length + EncodedImage::kBufferPaddingBytesH264;
+  else
+    _size = _length;
+
+  uint8_t* buffer = new uint8_t[_size];
+  GetBitstream(buffer);
+  memset(buffer + _length, 0, _size - _length);
+  _buffer = buffer;
+  FreeSegments();
+}
+
+bool RtpFrameObject::Decrypt(FrameDecryptorInterface* frame_decryptor,
+                             uint32_t ssrc) {
+  Linearize();
+  // The decrypted frame is shorter, so it fits in the buffer.
+  const size_t header_size =
+      UnencryptedFrameHeaderSize(codec_type_, frame_type_, _length);
+  rtc::ArrayView<const uint8_t> header(_buffer, header_size);
+  rtc::ArrayView<uint8_t> encrypted_frame(_buffer + header_size,
+                                          _length - header_size);
+  size_t bytes_written = 0;
+  if (frame_decryptor->Decrypt(cricket::MEDIA_TYPE_VIDEO, ssrc, header,
+                               encrypted_frame, encrypted_frame,
+                               &bytes_written) != 0) {
+    return false;
+  }
+  RTC_DCHECK_LE(bytes_written, encrypted_frame.size());
+  _length = header_size + bytes_written;
+  // Keep the padding after the bitstream zeroed.
+  memset(_buffer + _length, 0, _size - _length);
+  return true;
 }
 
 uint32_t RtpFrameObject::Timestamp() const {
@@ -164,5 +218,11 @@ rtc::Optional<RTPVideoTypeHeader> RtpFrameObject::GetCodecHeader() const {
   return packet->video_header.codecHeader;
 }
 
+void RtpFrameObject::FreeSegments() {
+  for (const rtc::ArrayView<const uint8_t>& segment : segments_)
+    delete[] segment.data();
+  segments_.clear();
+}
+
 }  // namespace video_coding
 }  // namespace webrtc
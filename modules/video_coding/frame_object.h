@@ -11,6 +11,10 @@
 #ifndef MODULES_VIDEO_CODING_FRAME_OBJECT_H_
 #define MODULES_VIDEO_CODING_FRAME_OBJECT_H_
 
+#include <vector>
+
+#include "api/array_view.h"
+#include "api/crypto/frame_decryptor_interface.h"
 #include "api/optional.h"
 #include "api/video/encoded_frame.h"
 #include "common_types.h"  // NOLINT(build/include)
@@ -21,6 +25,10 @@ namespace video_coding {
 
 class PacketBuffer;
 
+// A frame assembled from the packets of a PacketBuffer. It takes the packet
+// payloads over instead of copying them, and only copies them into one buffer
+// when Linearize() is called, on the decoding thread rather than under the
+// packet buffer lock.
 class RtpFrameObject : public EncodedFrame {
  public:
   RtpFrameObject(PacketBuffer* packet_buffer,
@@ -37,6 +45,12 @@ class RtpFrameObject : public EncodedFrame {
   enum FrameType frame_type() const;
   VideoCodecType codec_type() const;
   bool GetBitstream(uint8_t* destination) const override;
+  std::vector<rtc::ArrayView<const uint8_t>> BitstreamSegments()
+      const override;
+  void Linearize() override;
+  // Linearizes the frame and decrypts it in place with |frame_decryptor|.
+  // Returns false if the frame fails to decrypt, and must be dropped.
+  bool Decrypt(FrameDecryptorInterface* frame_decryptor, uint32_t ssrc);
   uint32_t Timestamp() const override;
   int64_t ReceivedTime() const override;
   int64_t RenderTime() const override;
@@ -44,7 +58,11 @@ class RtpFrameObject : public EncodedFrame {
   rtc::Optional<RTPVideoTypeHeader> GetCodecHeader() const;
 
  private:
+  void FreeSegments();
+
   rtc::scoped_refptr<PacketBuffer> packet_buffer_;
+  // The packet payloads, owned by the frame, until the frame is linearized.
+  std::vector<rtc::ArrayView<const uint8_t>> segments_;
   enum FrameType frame_type_;
   VideoCodecType codec_type_;
   uint16_t first_seq_num_;
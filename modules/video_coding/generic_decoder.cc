@@ -167,6 +167,10 @@ void VCMDecodedFrameCallback::OnDecoderImplementationName(
   _receiveCallback->OnDecoderImplementationName(implementation_name);
 }
 
+void VCMDecodedFrameCallback::OnDecoderNumberOfThreads(int number_of_threads) {
+  _receiveCallback->OnDecoderNumberOfThreads(number_of_threads);
+}
+
 void VCMDecodedFrameCallback::Map(uint32_t timestamp,
                                   VCMFrameInformation* frameInfo) {
   rtc::CritScope cs(&lock_);
@@ -229,10 +233,12 @@ int32_t VCMGenericDecoder::Decode(const VCMEncodedFrame& frame, int64_t nowMs) {
     _callback->Map(frame.TimeStamp(), &_frameInfos[_nextFrameInfoIdx]);
 
     _nextFrameInfoIdx = (_nextFrameInfoIdx + 1) % kDecoderFrameMemoryLength;
+    RTC_DCHECK(frame.Buffer() || frame.Length() == 0);
     int32_t ret = decoder_->Decode(frame.EncodedImage(), frame.MissingFrame(),
                                    frame.CodecSpecific(), frame.RenderTimeMs());
 
     _callback->OnDecoderImplementationName(decoder_->ImplementationName());
+    _callback->OnDecoderNumberOfThreads(decoder_->NumberOfThreads());
     if (ret < WEBRTC_VIDEO_CODEC_OK) {
       RTC_LOG(LS_WARNING) << "Failed to decode frame with timestamp "
                           << frame.TimeStamp() << ", error code: " << ret;
@@ -53,6 +53,7 @@ class VCMDecodedFrameCallback : public DecodedImageCallback {
 
   uint64_t LastReceivedPictureID() const;
   void OnDecoderImplementationName(const char* implementation_name);
+  void OnDecoderNumberOfThreads(int number_of_threads);
 
   void Map(uint32_t timestamp, VCMFrameInformation* frameInfo);
   int32_t Pop(uint32_t timestamp);
@@ -88,7 +89,8 @@ class VCMGenericDecoder {
   /**
   * Decode to a raw I420 frame,
   *
-  * inputVideoBuffer reference to encoded video frame
+  * inputVideoBuffer reference to encoded video frame. A frame held in
+  * segments must be linearized first.
   */
   int32_t Decode(const VCMEncodedFrame& inputFrame, int64_t nowMs);
 
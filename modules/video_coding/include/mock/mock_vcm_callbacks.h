@@ -38,6 +38,7 @@ class MockVCMReceiveCallback : public VCMReceiveCallback {
   MOCK_METHOD1(ReceivedDecodedReferenceFrame, int32_t(const uint64_t));
   MOCK_METHOD1(OnIncomingPayloadType, void(int));
   MOCK_METHOD1(OnDecoderImplementationName, void(const char*));
+  MOCK_METHOD1(OnDecoderNumberOfThreads, void(int));
 };
 
 }  // namespace webrtc
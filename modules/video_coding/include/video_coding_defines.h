@@ -77,6 +77,7 @@ class VCMReceiveCallback {
   // Called when the current receive codec changes.
   virtual void OnIncomingPayloadType(int payload_type);
   virtual void OnDecoderImplementationName(const char* implementation_name);
+  virtual void OnDecoderNumberOfThreads(int number_of_threads);
 
  protected:
   virtual ~VCMReceiveCallback() {}
@@ -28,6 +28,13 @@ const int kProcessFrequency = 50;
 const int kProcessIntervalMs = 1000 / kProcessFrequency;
 const int kMaxReorderedPackets = 128;
 const int kNumReorderingBuckets = 10;
+// Larger than kMaxPacketAge, and a divisor of 2^16 so that sequence numbers
+// map to the same slot across wrap-around.
+const int kSeqNumRingSize = 1 << 14;
+const uint16_t kNoSlot = 0xffff;
+
+static_assert(kSeqNumRingSize > kMaxPacketAge, "ring too small");
+static_assert(kMaxNackPackets < kNoSlot, "too many nack slots");
 }  // namespace
 
 NackModule::NackInfo::NackInfo()
@@ -39,12 +46,16 @@ NackModule::NackInfo::NackInfo(uint16_t seq_num, uint16_t send_at_seq_num)
       sent_at_time(-1),
       retries(0) {}
 
+NackModule::SlotList::SlotList() : head(kNoSlot), tail(kNoSlot) {}
+
 NackModule::NackModule(Clock* clock,
                        NackSender* nack_sender,
                        KeyFrameRequestSender* keyframe_request_sender)
     : clock_(clock),
       nack_sender_(nack_sender),
       keyframe_request_sender_(keyframe_request_sender),
+      slot_by_seq_num_(kSeqNumRingSize, kNoSlot),
+      nack_list_size_(0),
       reordering_histogram_(kNumReorderingBuckets, kMaxReorderedPackets),
       initialized_(false),
       rtt_ms_(kDefaultRttMs),
@@ -66,7 +77,7 @@ int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
   if (!initialized_) {
     newest_seq_num_ = seq_num;
     if (is_keyframe)
-      keyframe_list_.insert(seq_num);
+      keyframe_list_.push_back(seq_num);
     initialized_ = true;
     return 0;
   }
@@ -78,11 +89,11 @@ int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
 
   if (AheadOf(newest_seq_num_, seq_num)) {
     // An out of order packet has been received.
-    auto nack_list_it = nack_list_.find(seq_num);
+    uint16_t slot = FindSlot(seq_num);
     int nacks_sent_for_packet = 0;
-    if (nack_list_it != nack_list_.end()) {
-      nacks_sent_for_packet = nack_list_it->second.retries;
-      nack_list_.erase(nack_list_it);
+    if (slot != kNoSlot) {
+      nacks_sent_for_packet = nack_slots_[slot].info.retries;
+      EraseSlot(slot);
     }
     if (!is_retransmitted)
       UpdateReorderingStatistics(seq_num);
@@ -93,12 +104,14 @@ int NackModule::OnReceivedPacket(uint16_t seq_num, bool is_keyframe) {
 
   // Keep track of new keyframes.
   if (is_keyframe)
-    keyframe_list_.insert(seq_num);
+    keyframe_list_.push_back(seq_num);
 
   // And remove old ones so we don't accumulate keyframes.
-  auto it = keyframe_list_.lower_bound(seq_num - kMaxPacketAge);
-  if (it != keyframe_list_.begin())
-    keyframe_list_.erase(keyframe_list_.begin(), it);
+  const uint16_t oldest_keyframe_to_keep = seq_num - kMaxPacketAge;
+  while (!keyframe_list_.empty() &&
+         AheadOf(oldest_keyframe_to_keep, keyframe_list_.front())) {
+    keyframe_list_.pop_front();
+  }
 
   // Are there any nacks that are waiting for this seq_num.
   std::vector<uint16_t> nack_batch = GetNackBatch(kSeqNumOnly);
@@ -116,9 +129,9 @@ int NackModule::OnReceivedPacket(const VCMPacket& packet) {
 
 void NackModule::ClearUpTo(uint16_t seq_num) {
   rtc::CritScope lock(&crit_);
-  nack_list_.erase(nack_list_.begin(), nack_list_.lower_bound(seq_num));
-  keyframe_list_.erase(keyframe_list_.begin(),
-                       keyframe_list_.lower_bound(seq_num));
+  EraseNacksOlderThan(seq_num);
+  while (!keyframe_list_.empty() && AheadOf(seq_num, keyframe_list_.front()))
+    keyframe_list_.pop_front();
 }
 
 void NackModule::UpdateRtt(int64_t rtt_ms) {
@@ -128,7 +141,7 @@ void NackModule::UpdateRtt(int64_t rtt_ms) {
 
 void NackModule::Clear() {
   rtc::CritScope lock(&crit_);
-  nack_list_.clear();
+  ClearNackList();
   keyframe_list_.clear();
 }
 
@@ -163,21 +176,73 @@ void NackModule::Process() {
   }
 }
 
+void NackModule::PushBack(SlotList* list, Link link, uint16_t slot) {
+  NackSlot& nack_slot = nack_slots_[slot];
+  nack_slot.prev[link] = list->tail;
+  nack_slot.next[link] = kNoSlot;
+  if (list->tail == kNoSlot)
+    list->head = slot;
+  else
+    nack_slots_[list->tail].next[link] = slot;
+  list->tail = slot;
+}
+
+void NackModule::Unlink(SlotList* list, Link link, uint16_t slot) {
+  NackSlot& nack_slot = nack_slots_[slot];
+  if (nack_slot.prev[link] == kNoSlot)
+    list->head = nack_slot.next[link];
+  else
+    nack_slots_[nack_slot.prev[link]].next[link] = nack_slot.next[link];
+  if (nack_slot.next[link] == kNoSlot)
+    list->tail = nack_slot.prev[link];
+  else
+    nack_slots_[nack_slot.next[link]].prev[link] = nack_slot.prev[link];
+}
+
+uint16_t NackModule::FindSlot(uint16_t seq_num) const {
+  uint16_t slot = slot_by_seq_num_[seq_num % kSeqNumRingSize];
+  if (slot == kNoSlot || nack_slots_[slot].info.seq_num != seq_num)
+    return kNoSlot;
+  return slot;
+}
+
+void NackModule::EraseSlot(uint16_t slot) {
+  const NackInfo& info = nack_slots_[slot].info;
+  Unlink(&nack_list_, kSeqNumLink, slot);
+  Unlink(info.sent_at_time == -1 ? &pending_queue_ : &retry_queue_, kQueueLink,
+         slot);
+  slot_by_seq_num_[info.seq_num % kSeqNumRingSize] = kNoSlot;
+  free_slots_.push_back(slot);
+  --nack_list_size_;
+}
+
+void NackModule::EraseNacksOlderThan(uint16_t seq_num) {
+  while (nack_list_.head != kNoSlot &&
+         AheadOf(seq_num, nack_slots_[nack_list_.head].info.seq_num)) {
+    EraseSlot(nack_list_.head);
+  }
+}
+
+void NackModule::ClearNackList() {
+  while (nack_list_.head != kNoSlot)
+    EraseSlot(nack_list_.head);
+}
+
 bool NackModule::RemovePacketsUntilKeyFrame() {
   while (!keyframe_list_.empty()) {
-    auto it = nack_list_.lower_bound(*keyframe_list_.begin());
+    uint16_t keyframe_seq_num = keyframe_list_.front();
 
-    if (it != nack_list_.begin()) {
+    if (nack_list_.head != kNoSlot &&
+        AheadOf(keyframe_seq_num, nack_slots_[nack_list_.head].info.seq_num)) {
       // We have found a keyframe that actually is newer than at least one
       // packet in the nack list.
-      RTC_DCHECK(it != nack_list_.end());
-      nack_list_.erase(nack_list_.begin(), it);
+      EraseNacksOlderThan(keyframe_seq_num);
       return true;
     }
 
     // If this keyframe is so old it does not remove any packets from the list,
     // remove it from the list of keyframes and try the next keyframe.
-    keyframe_list_.erase(keyframe_list_.begin());
+    keyframe_list_.pop_front();
   }
   return false;
 }
@@ -185,20 +250,19 @@ bool NackModule::RemovePacketsUntilKeyFrame() {
 void NackModule::AddPacketsToNack(uint16_t seq_num_start,
                                   uint16_t seq_num_end) {
   // Remove old packets.
-  auto it = nack_list_.lower_bound(seq_num_end - kMaxPacketAge);
-  nack_list_.erase(nack_list_.begin(), it);
+  EraseNacksOlderThan(seq_num_end - kMaxPacketAge);
 
   // If the nack list is too large, remove packets from the nack list until
   // the latest first packet of a keyframe. If the list is still too large,
   // clear it and request a keyframe.
   uint16_t num_new_nacks = ForwardDiff(seq_num_start, seq_num_end);
-  if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+  if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     while (RemovePacketsUntilKeyFrame() &&
-           nack_list_.size() + num_new_nacks > kMaxNackPackets) {
+           nack_list_size_ + num_new_nacks > kMaxNackPackets) {
     }
 
-    if (nack_list_.size() + num_new_nacks > kMaxNackPackets) {
-      nack_list_.clear();
+    if (nack_list_size_ + num_new_nacks > kMaxNackPackets) {
+      ClearNackList();
       RTC_LOG(LS_WARNING) << "NACK list full, clearing NACK"
                              " list and requesting keyframe.";
       keyframe_request_sender_->RequestKeyFrame();
@@ -207,9 +271,21 @@ void NackModule::AddPacketsToNack(uint16_t seq_num_start,
   }
 
   for (uint16_t seq_num = seq_num_start; seq_num != seq_num_end; ++seq_num) {
-    NackInfo nack_info(seq_num, seq_num + WaitNumberOfPackets(0.5));
-    RTC_DCHECK(nack_list_.find(seq_num) == nack_list_.end());
-    nack_list_[seq_num] = nack_info;
+    uint16_t slot;
+    if (free_slots_.empty()) {
+      slot = static_cast<uint16_t>(nack_slots_.size());
+      nack_slots_.emplace_back();
+    } else {
+      slot = free_slots_.back();
+      free_slots_.pop_back();
+    }
+    RTC_DCHECK_EQ(slot_by_seq_num_[seq_num % kSeqNumRingSize], kNoSlot);
+    nack_slots_[slot].info =
+        NackInfo(seq_num, seq_num + WaitNumberOfPackets(0.5));
+    slot_by_seq_num_[seq_num % kSeqNumRingSize] = slot;
+    PushBack(&nack_list_, kSeqNumLink, slot);
+    PushBack(&pending_queue_, kQueueLink, slot);
+    ++nack_list_size_;
   }
 }
 
@@ -217,38 +293,52 @@ std::vector<uint16_t> NackModule::GetNackBatch(NackFilterOptions options) {
   bool consider_seq_num = options != kTimeOnly;
   bool consider_timestamp = options != kSeqNumOnly;
   int64_t now_ms = clock_->TimeInMilliseconds();
-  std::vector<uint16_t> nack_batch;
-  auto it = nack_list_.begin();
-  while (it != nack_list_.end()) {
-    if (consider_seq_num && it->second.sent_at_time == -1 &&
-        AheadOrAt(newest_seq_num_, it->second.send_at_seq_num)) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                            << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
-      }
-      continue;
+
+  // Packets never nacked are due when enough later packets have arrived, or
+  // like retries, an RTT after |sent_at_time| = -1. Only the due head of the
+  // retry queue is visited.
+  std::vector<uint16_t> due_slots;
+  for (uint16_t slot = pending_queue_.head; slot != kNoSlot;
+       slot = nack_slots_[slot].next[kQueueLink]) {
+    const NackInfo& info = nack_slots_[slot].info;
+    if ((consider_seq_num &&
+         AheadOrAt(newest_seq_num_, info.send_at_seq_num)) ||
+        (consider_timestamp && info.sent_at_time + rtt_ms_ <= now_ms)) {
+      due_slots.push_back(slot);
+    }
+  }
+  if (consider_timestamp) {
+    for (uint16_t slot = retry_queue_.head;
+         slot != kNoSlot &&
+         nack_slots_[slot].info.sent_at_time + rtt_ms_ <= now_ms;
+         slot = nack_slots_[slot].next[kQueueLink]) {
+      due_slots.push_back(slot);
     }
+  }
+
+  // Nack the oldest packets first.
+  DescendingSeqNumComp<uint16_t> older;
+  std::sort(due_slots.begin(), due_slots.end(),
+            [this, &older](uint16_t a, uint16_t b) {
+              return older(nack_slots_[a].info.seq_num,
+                           nack_slots_[b].info.seq_num);
+            });
 
-    if (consider_timestamp && it->second.sent_at_time + rtt_ms_ <= now_ms) {
-      nack_batch.emplace_back(it->second.seq_num);
-      ++it->second.retries;
-      it->second.sent_at_time = now_ms;
-      if (it->second.retries >= kMaxNackRetries) {
-        RTC_LOG(LS_WARNING) << "Sequence number " << it->second.seq_num
-                            << " removed from NACK list due to max retries.";
-        it = nack_list_.erase(it);
-      } else {
-        ++it;
-      }
-      continue;
+  std::vector<uint16_t> nack_batch;
+  nack_batch.reserve(due_slots.size());
+  for (uint16_t slot : due_slots) {
+    NackInfo& info = nack_slots_[slot].info;
+    nack_batch.emplace_back(info.seq_num);
+    Unlink(info.sent_at_time == -1 ? &pending_queue_ : &retry_queue_,
+           kQueueLink, slot);
+    ++info.retries;
+    info.sent_at_time = now_ms;
+    PushBack(&retry_queue_, kQueueLink, slot);
+    if (info.retries >= kMaxNackRetries) {
+      RTC_LOG(LS_WARNING) << "Sequence number " << info.seq_num
+                          << " removed from NACK list due to max retries.";
+      EraseSlot(slot);
     }
-    ++it;
   }
   return nack_batch;
 }
@@ -11,9 +11,8 @@
 #ifndef MODULES_VIDEO_CODING_NACK_MODULE_H_
 #define MODULES_VIDEO_CODING_NACK_MODULE_H_
 
-#include <map>
+#include <deque>
 #include <vector>
-#include <set>
 
 #include "modules/include/module.h"
 #include "modules/video_coding/histogram.h"
@@ -59,6 +58,38 @@ class NackModule : public Module {
     int64_t sent_at_time;
     int retries;
   };
+
+  // The nack list is a pool of at most kMaxNackPackets slots, found by
+  // sequence number through |slot_by_seq_num_|. Each slot is linked into
+  // |nack_list_|, in sequence number order, and into either |pending_queue_|,
+  // if it has never been nacked, or |retry_queue_|, in the order it was last
+  // nacked. As all retries wait for the same RTT, the head of |retry_queue_|
+  // is always the next one due.
+  enum Link { kSeqNumLink, kQueueLink, kNumLinks };
+  struct NackSlot {
+    NackInfo info;
+    uint16_t prev[kNumLinks];
+    uint16_t next[kNumLinks];
+  };
+  struct SlotList {
+    SlotList();
+
+    uint16_t head;
+    uint16_t tail;
+  };
+
+  void PushBack(SlotList* list, Link link, uint16_t slot)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void Unlink(SlotList* list, Link link, uint16_t slot)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Returns the slot of |seq_num|, or kNoSlot if it isn't in the nack list.
+  uint16_t FindSlot(uint16_t seq_num) const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void EraseSlot(uint16_t slot) RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Removes the packets older than |seq_num| from the nack list.
+  void EraseNacksOlderThan(uint16_t seq_num)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void ClearNackList() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   void AddPacketsToNack(uint16_t seq_num_start, uint16_t seq_num_end)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
@@ -85,10 +116,17 @@ class NackModule : public Module {
   // TODO(philipel): Some of the variables below are consistently used on a
   // known thread (e.g. see |initialized_|). Those probably do not need
   // synchronized access.
-  std::map<uint16_t, NackInfo, DescendingSeqNumComp<uint16_t>> nack_list_
-      RTC_GUARDED_BY(crit_);
-  std::set<uint16_t, DescendingSeqNumComp<uint16_t>> keyframe_list_
-      RTC_GUARDED_BY(crit_);
+  std::vector<NackSlot> nack_slots_ RTC_GUARDED_BY(crit_);
+  std::vector<uint16_t> free_slots_ RTC_GUARDED_BY(crit_);
+  // Indexed by sequence number modulo its size, which is larger than the
+  // span of sequence numbers in the nack list.
+  std::vector<uint16_t> slot_by_seq_num_ RTC_GUARDED_BY(crit_);
+  SlotList nack_list_ RTC_GUARDED_BY(crit_);
+  SlotList pending_queue_ RTC_GUARDED_BY(crit_);
+  SlotList retry_queue_ RTC_GUARDED_BY(crit_);
+  size_t nack_list_size_ RTC_GUARDED_BY(crit_);
+  // Oldest first. Keyframes are only added as the newest packet.
+  std::deque<uint16_t> keyframe_list_ RTC_GUARDED_BY(crit_);
   video_coding::Histogram reordering_histogram_ RTC_GUARDED_BY(crit_);
   bool initialized_ RTC_GUARDED_BY(crit_);
   int64_t rtt_ms_ RTC_GUARDED_BY(crit_);
@@ -196,6 +196,31 @@ TEST_F(TestNackModule, ResendNack) {
   EXPECT_EQ(4u, sent_nacks_.size());
 }
 
+TEST_F(TestNackModule, ResendNacksInSequenceNumberOrder) {
+  VCMPacket packet;
+  packet.seqNum = 1;
+  nack_module_.OnReceivedPacket(packet);
+  packet.seqNum = 3;
+  nack_module_.OnReceivedPacket(packet);
+  clock_->AdvanceTimeMilliseconds(50);
+  packet.seqNum = 10;
+  nack_module_.OnReceivedPacket(packet);
+  EXPECT_EQ(7u, sent_nacks_.size());
+
+  // Packet 2 is nacked again after packets 4 to 9 were first nacked.
+  clock_->AdvanceTimeMilliseconds(50);
+  nack_module_.Process();
+  ASSERT_EQ(8u, sent_nacks_.size());
+  EXPECT_EQ(2, sent_nacks_[7]);
+
+  sent_nacks_.clear();
+  nack_module_.UpdateRtt(10);
+  clock_->AdvanceTimeMilliseconds(10);
+  nack_module_.Process();
+  const std::vector<uint16_t> expected = {2, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(expected, sent_nacks_);
+}
+
 TEST_F(TestNackModule, ResendPacketMaxRetries) {
   VCMPacket packet;
   packet.seqNum = 1;
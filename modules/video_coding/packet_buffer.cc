@@ -35,6 +35,22 @@ rtc::scoped_refptr<PacketBuffer> PacketBuffer::Create(
       clock, start_buffer_size, max_buffer_size, received_frame_callback));
 }
 
+size_t PacketBuffer::BufferSizeForBitrate(int max_bitrate_bps,
+                                          size_t min_buffer_size) {
+  // Packets are often smaller than the MTU, so assume small ones to be safe.
+  const int kAssumedPacketSizeBytes = 1000;
+  const int kBufferedTimeMs = 1000;
+  // The buffer must not hold packets more than half the sequence number space
+  // apart, or older and newer packets can't be told apart.
+  const size_t kMaxBufferSize = 1 << 14;
+  const int64_t packets = static_cast<int64_t>(max_bitrate_bps) *
+                          kBufferedTimeMs / (8 * 1000 * kAssumedPacketSizeBytes);
+  size_t size = min_buffer_size;
+  while (size < kMaxBufferSize && static_cast<int64_t>(size) < packets)
+    size *= 2;
+  return size;
+}
+
 PacketBuffer::PacketBuffer(Clock* clock,
                            size_t start_buffer_size,
                            size_t max_buffer_size,
@@ -215,6 +231,17 @@ int PacketBuffer::GetUniqueFramesSeen() const {
   return unique_frames_seen_;
 }
 
+size_t PacketBuffer::MemoryUsageBytes() const {
+  rtc::CritScope lock(&crit_);
+  size_t bytes = data_buffer_.capacity() * sizeof(VCMPacket) +
+                 sequence_buffer_.capacity() * sizeof(ContinuityInfo);
+  for (const VCMPacket& packet : data_buffer_) {
+    if (packet.dataPtr)
+      bytes += packet.sizeBytes;
+  }
+  return bytes;
+}
+
 bool PacketBuffer::ExpandBufferSize() {
   if (size_ == max_size_) {
     RTC_LOG(LS_WARNING) << "PacketBuffer is already at max size (" << max_size_
@@ -416,15 +443,17 @@ void PacketBuffer::ReturnFrame(RtpFrameObject* frame) {
   }
 }
 
-bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
-                                uint8_t* destination) {
+bool PacketBuffer::TakeBitstream(
+    const RtpFrameObject& frame,
+    std::vector<rtc::ArrayView<const uint8_t>>* segments) {
   rtc::CritScope lock(&crit_);
 
   size_t index = frame.first_seq_num() % size_;
   size_t end = (frame.last_seq_num() + 1) % size_;
   uint16_t seq_num = frame.first_seq_num();
-  uint8_t* destination_end = destination + frame.size();
+  size_t frame_size = 0;
 
+  // Check the whole frame first, so that no payload is taken if it fails.
   do {
     if (!sequence_buffer_[index].used ||
         sequence_buffer_[index].seq_num != seq_num) {
@@ -432,21 +461,29 @@ bool PacketBuffer::GetBitstream(const RtpFrameObject& frame,
     }
 
     RTC_DCHECK_EQ(data_buffer_[index].seqNum, sequence_buffer_[index].seq_num);
-    size_t length = data_buffer_[index].sizeBytes;
-    if (destination + length > destination_end) {
-      RTC_LOG(LS_WARNING) << "Frame (" << frame.id.picture_id << ":"
-                          << static_cast<int>(frame.id.spatial_layer) << ")"
-                          << " bitstream buffer is not large enough.";
-      return false;
-    }
-
-    const uint8_t* source = data_buffer_[index].dataPtr;
-    memcpy(destination, source, length);
-    destination += length;
+    frame_size += data_buffer_[index].sizeBytes;
     index = (index + 1) % size_;
     ++seq_num;
   } while (index != end);
 
+  if (frame_size > frame.size()) {
+    RTC_LOG(LS_WARNING) << "Frame (" << frame.id.picture_id << ":"
+                        << static_cast<int>(frame.id.spatial_layer) << ")"
+                        << " bitstream buffer is not large enough.";
+    return false;
+  }
+
+  index = frame.first_seq_num() % size_;
+  do {
+    VCMPacket& packet = data_buffer_[index];
+    if (packet.sizeBytes > 0)
+      segments->emplace_back(packet.dataPtr, packet.sizeBytes);
+    else
+      delete[] packet.dataPtr;
+    packet.dataPtr = nullptr;
+    index = (index + 1) % size_;
+  } while (index != end);
+
   return true;
 }
 
@@ -16,10 +16,12 @@
 #include <set>
 #include <vector>
 
+#include "api/array_view.h"
 #include "modules/include/module_common_types.h"
 #include "modules/video_coding/packet.h"
 #include "modules/video_coding/rtp_frame_reference_finder.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/memory_account.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/thread_annotations.h"
@@ -39,7 +41,7 @@ class OnReceivedFrameCallback {
   virtual void OnReceivedFrame(std::unique_ptr<RtpFrameObject> frame) = 0;
 };
 
-class PacketBuffer {
+class PacketBuffer : public rtc::MemoryUsageSource {
  public:
   static rtc::scoped_refptr<PacketBuffer> Create(
       Clock* clock,
@@ -47,7 +49,14 @@ class PacketBuffer {
       size_t max_buffer_size,
       OnReceivedFrameCallback* frame_callback);
 
-  virtual ~PacketBuffer();
+  // Returns a buffer size, a power of 2, that holds about a second of packets
+  // of a stream of |max_bitrate_bps|, and at least |min_buffer_size| packets.
+  // A buffer created with this as its start size doesn't have to grow, and
+  // copy all its packets under the lock, as the packets of the stream come in.
+  static size_t BufferSizeForBitrate(int max_bitrate_bps,
+                                     size_t min_buffer_size);
+
+  ~PacketBuffer() override;
 
   // Returns true if |packet| is inserted into the packet buffer, false
   // otherwise. The PacketBuffer will always take ownership of the
@@ -64,6 +73,10 @@ class PacketBuffer {
   // Returns number of different frames seen in the packet buffer
   int GetUniqueFramesSeen() const;
 
+  // rtc::MemoryUsageSource implementation. Counts the slots of the buffer and
+  // the payloads of the packets it holds.
+  size_t MemoryUsageBytes() const override;
+
   int AddRef() const;
   int Release() const;
 
@@ -113,9 +126,13 @@ class PacketBuffer {
   std::vector<std::unique_ptr<RtpFrameObject>> FindFrames(uint16_t seq_num)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
-  // Copy the bitstream for |frame| to |destination|.
+  // Moves the payloads of the packets of |frame| to |segments|, in order,
+  // without copying them. The caller owns the payloads from then on and must
+  // delete[] them. The payloads of empty packets are deleted instead.
   // Virtual for testing.
-  virtual bool GetBitstream(const RtpFrameObject& frame, uint8_t* destination);
+  virtual bool TakeBitstream(
+      const RtpFrameObject& frame,
+      std::vector<rtc::ArrayView<const uint8_t>>* segments);
 
   // Get the packet with sequence number |seq_num|.
   // Virtual for testing.
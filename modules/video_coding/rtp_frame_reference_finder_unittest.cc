@@ -13,6 +13,7 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "modules/video_coding/frame_object.h"
 #include "modules/video_coding/packet_buffer.h"
@@ -38,8 +39,9 @@ class FakePacketBuffer : public PacketBuffer {
     return true;
   }
 
-  bool GetBitstream(const RtpFrameObject& frame,
-                    uint8_t* destination) override {
+  bool TakeBitstream(
+      const RtpFrameObject& frame,
+      std::vector<rtc::ArrayView<const uint8_t>>* segments) override {
     return true;
   }
 
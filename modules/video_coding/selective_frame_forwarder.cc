@@ -0,0 +1,176 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/selective_frame_forwarder.h"
+
+#include "modules/video_coding/frame_object.h"
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+namespace video_coding {
+
+SelectiveFrameForwarder::SelectiveFrameForwarder()
+    : max_temporal_layer_(kMaxTemporalStreams - 1),
+      max_spatial_layer_(kMaxSpatialLayers - 1),
+      last_picture_id_(-1),
+      output_picture_id_(0),
+      output_tl0_pic_idx_(0),
+      end_of_picture_(true),
+      num_pid_diffs_(0) {}
+
+SelectiveFrameForwarder::~SelectiveFrameForwarder() = default;
+
+void SelectiveFrameForwarder::SetMaxLayers(uint8_t max_temporal_layer,
+                                           uint8_t max_spatial_layer) {
+  max_temporal_layer_ = max_temporal_layer;
+  max_spatial_layer_ = max_spatial_layer;
+}
+
+bool SelectiveFrameForwarder::ForwardFrame(const RtpFrameObject& frame) {
+  rtc::Optional<RTPVideoTypeHeader> codec_header = frame.GetCodecHeader();
+  if (!codec_header)
+    return false;
+  return ForwardFrame(frame, frame.codec_type(), *codec_header);
+}
+
+bool SelectiveFrameForwarder::ForwardFrame(
+    const EncodedFrame& frame,
+    VideoCodecType codec_type,
+    const RTPVideoTypeHeader& codec_header) {
+  uint8_t temporal_idx;
+  bool drop_temporal_layers = true;
+  switch (codec_type) {
+    case kVideoCodecVP8:
+      temporal_idx = codec_header.VP8.temporalIdx;
+      break;
+    case kVideoCodecVP9:
+      temporal_idx = codec_header.VP9.temporal_idx;
+      drop_temporal_layers = codec_header.VP9.flexible_mode;
+      break;
+    default:
+      // Not a layered codec.
+      return true;
+  }
+  if (temporal_idx == kNoTemporalIdx)
+    temporal_idx = 0;
+
+  if (drop_temporal_layers && temporal_idx > max_temporal_layer_)
+    return false;
+  if (frame.id.spatial_layer > max_spatial_layer_)
+    return false;
+
+  // Don't forward frames the receiver could not decode.
+  for (size_t i = 0; i < frame.num_references; ++i) {
+    if (!IsForwarded(
+            VideoLayerFrameId(frame.references[i], frame.id.spatial_layer))) {
+      return false;
+    }
+  }
+  if (frame.inter_layer_predicted &&
+      (frame.id.spatial_layer == 0 ||
+       !IsForwarded(VideoLayerFrameId(frame.id.picture_id,
+                                      frame.id.spatial_layer - 1)))) {
+    return false;
+  }
+
+  OnFrameForwarded(frame, codec_type, codec_header, temporal_idx);
+  return true;
+}
+
+void SelectiveFrameForwarder::RewritePacketHeader(
+    RTPVideoHeader* header) const {
+  if (header->codec == kRtpVideoVp8) {
+    RTPVideoHeaderVP8* vp8 = &header->codecHeader.VP8;
+    if (vp8->pictureId != kNoPictureId)
+      vp8->pictureId = output_picture_id_;
+    if (vp8->tl0PicIdx != kNoTl0PicIdx)
+      vp8->tl0PicIdx = output_tl0_pic_idx_;
+  } else if (header->codec == kRtpVideoVp9) {
+    RTPVideoHeaderVP9* vp9 = &header->codecHeader.VP9;
+    if (vp9->picture_id != kNoPictureId)
+      vp9->picture_id = output_picture_id_;
+    if (vp9->tl0_pic_idx != kNoTl0PicIdx)
+      vp9->tl0_pic_idx = output_tl0_pic_idx_;
+    if (vp9->flexible_mode) {
+      RTC_DCHECK_EQ(num_pid_diffs_, vp9->num_ref_pics);
+      for (size_t i = 0; i < num_pid_diffs_; ++i)
+        vp9->pid_diff[i] = pid_diff_[i];
+    }
+    vp9->end_of_picture = end_of_picture_;
+  }
+}
+
+bool SelectiveFrameForwarder::IsForwarded(const VideoLayerFrameId& id) const {
+  return forwarded_frames_.find(id) != forwarded_frames_.end();
+}
+
+void SelectiveFrameForwarder::OnFrameForwarded(
+    const EncodedFrame& frame,
+    VideoCodecType codec_type,
+    const RTPVideoTypeHeader& codec_header,
+    uint8_t temporal_idx) {
+  forwarded_frames_.insert(frame.id);
+  if (forwarded_frames_.size() > kMaxForwardedFrames)
+    forwarded_frames_.erase(forwarded_frames_.begin());
+
+  int16_t picture_id;
+  int16_t tl0_pic_idx;
+  uint16_t picture_id_mask;
+  bool renumber;
+  if (codec_type == kVideoCodecVP8) {
+    picture_id = codec_header.VP8.pictureId;
+    tl0_pic_idx = codec_header.VP8.tl0PicIdx;
+    picture_id_mask = kMaxTwoBytePictureId;
+    renumber = true;
+  } else {
+    picture_id = codec_header.VP9.picture_id;
+    tl0_pic_idx = codec_header.VP9.tl0_pic_idx;
+    picture_id_mask = codec_header.VP9.max_picture_id;
+    renumber = codec_header.VP9.flexible_mode;
+  }
+
+  if (frame.id.picture_id != last_picture_id_) {
+    // Spatial layers of the same picture share its picture ID.
+    if (last_picture_id_ == -1 || !renumber) {
+      output_picture_id_ = picture_id;
+      output_tl0_pic_idx_ = tl0_pic_idx;
+    } else {
+      output_picture_id_ = (output_picture_id_ + 1) & picture_id_mask;
+      if (temporal_idx == 0)
+        ++output_tl0_pic_idx_;
+    }
+    last_picture_id_ = frame.id.picture_id;
+    output_picture_ids_[frame.id.picture_id] = output_picture_id_;
+    if (output_picture_ids_.size() > kMaxForwardedFrames)
+      output_picture_ids_.erase(output_picture_ids_.begin());
+  }
+
+  end_of_picture_ = true;
+  num_pid_diffs_ = 0;
+  if (codec_type == kVideoCodecVP9) {
+    const RTPVideoHeaderVP9& vp9 = codec_header.VP9;
+    // The receiver must not wait for the spatial layers that are dropped.
+    end_of_picture_ =
+        vp9.end_of_picture || frame.id.spatial_layer == max_spatial_layer_;
+    if (vp9.flexible_mode) {
+      num_pid_diffs_ = frame.num_references;
+      for (size_t i = 0; i < num_pid_diffs_; ++i) {
+        auto it = output_picture_ids_.find(frame.references[i]);
+        pid_diff_[i] = it == output_picture_ids_.end()
+                           ? vp9.pid_diff[i]
+                           : (output_picture_id_ - it->second) &
+                                 picture_id_mask;
+      }
+    }
+  }
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
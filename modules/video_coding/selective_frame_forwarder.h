@@ -0,0 +1,90 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_SELECTIVE_FRAME_FORWARDER_H_
+#define MODULES_VIDEO_CODING_SELECTIVE_FRAME_FORWARDER_H_
+
+#include <map>
+#include <set>
+
+#include "api/video/encoded_frame.h"
+#include "api/video/video_bitrate_allocation.h"
+#include "common_types.h"  // NOLINT(build/include)
+#include "modules/include/module_common_types.h"
+
+namespace webrtc {
+namespace video_coding {
+
+class RtpFrameObject;
+
+// Selects the frames of a VP8 or VP9 stream to forward to a receiver that
+// only gets some of its temporal and spatial layers, e.g. in a selective
+// forwarding unit, without decoding the stream.
+//
+// The frames must have gone through RtpFrameReferenceFinder. A frame is only
+// forwarded if it is in the selected layers and all the frames it references
+// were forwarded, so the receiver can decode everything it gets. Lowering the
+// layers takes effect at once. New layers are added from the first frame
+// whose references were all forwarded, e.g. a VP8 layer sync frame.
+//
+// The picture IDs of the forwarded frames are rewritten to be consecutive,
+// with TL0PICIDX and VP9 reference diffs to match, so the receiver does not
+// take dropped frames for losses. In VP9 non-flexible mode the references
+// follow from the scalability structure, which would not match renumbered
+// pictures, so only spatial layers are dropped there.
+class SelectiveFrameForwarder {
+ public:
+  SelectiveFrameForwarder();
+  ~SelectiveFrameForwarder();
+
+  // Sets the highest temporal and spatial layer index to forward.
+  void SetMaxLayers(uint8_t max_temporal_layer, uint8_t max_spatial_layer);
+
+  // Returns true if |frame| should be forwarded. The frame's packets must
+  // then have their headers rewritten with RewritePacketHeader() before the
+  // next frame is passed in.
+  bool ForwardFrame(const RtpFrameObject& frame);
+  bool ForwardFrame(const EncodedFrame& frame,
+                    VideoCodecType codec_type,
+                    const RTPVideoTypeHeader& codec_header);
+
+  // Rewrites the codec header of a packet of the last forwarded frame.
+  void RewritePacketHeader(RTPVideoHeader* header) const;
+
+ private:
+  static const size_t kMaxForwardedFrames = 100;
+
+  bool IsForwarded(const VideoLayerFrameId& id) const;
+  void OnFrameForwarded(const EncodedFrame& frame,
+                        VideoCodecType codec_type,
+                        const RTPVideoTypeHeader& codec_header,
+                        uint8_t temporal_idx);
+
+  uint8_t max_temporal_layer_;
+  uint8_t max_spatial_layer_;
+
+  std::set<VideoLayerFrameId> forwarded_frames_;
+  // Output picture IDs of the recently forwarded pictures, by input picture
+  // ID as unwrapped by RtpFrameReferenceFinder.
+  std::map<int64_t, uint16_t> output_picture_ids_;
+  int64_t last_picture_id_;
+  uint16_t output_picture_id_;
+  uint8_t output_tl0_pic_idx_;
+
+  // Rewritten fields of the last forwarded frame.
+  bool end_of_picture_;
+  size_t num_pid_diffs_;
+  uint8_t pid_diff_[kMaxVp9RefPics];
+};
+
+}  // namespace video_coding
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_SELECTIVE_FRAME_FORWARDER_H_
@@ -0,0 +1,228 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/selective_frame_forwarder.h"
+
+#include <vector>
+
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace video_coding {
+
+namespace {
+
+class FrameObjectFake : public EncodedFrame {
+ public:
+  bool GetBitstream(uint8_t* destination) const override { return true; }
+  uint32_t Timestamp() const override { return timestamp; }
+  int64_t ReceivedTime() const override { return 0; }
+  int64_t RenderTime() const override { return _renderTimeMs; }
+};
+
+FrameObjectFake Frame(int64_t picture_id,
+                      uint8_t spatial_layer,
+                      std::vector<int64_t> references) {
+  FrameObjectFake frame;
+  frame.id = VideoLayerFrameId(picture_id, spatial_layer);
+  frame.num_references = references.size();
+  for (size_t i = 0; i < references.size(); ++i)
+    frame.references[i] = references[i];
+  return frame;
+}
+
+RTPVideoHeader Vp8Header(int16_t picture_id,
+                         int16_t tl0_pic_idx,
+                         uint8_t temporal_idx) {
+  RTPVideoHeader header;
+  memset(&header, 0, sizeof(header));
+  header.codec = kRtpVideoVp8;
+  header.codecHeader.VP8.InitRTPVideoHeaderVP8();
+  header.codecHeader.VP8.pictureId = picture_id;
+  header.codecHeader.VP8.tl0PicIdx = tl0_pic_idx;
+  header.codecHeader.VP8.temporalIdx = temporal_idx;
+  return header;
+}
+
+RTPVideoHeader Vp9FlexibleHeader(int16_t picture_id,
+                                 uint8_t temporal_idx,
+                                 uint8_t spatial_idx,
+                                 std::vector<uint8_t> pid_diffs) {
+  RTPVideoHeader header;
+  memset(&header, 0, sizeof(header));
+  header.codec = kRtpVideoVp9;
+  header.codecHeader.VP9.InitRTPVideoHeaderVP9();
+  header.codecHeader.VP9.flexible_mode = true;
+  header.codecHeader.VP9.picture_id = picture_id;
+  header.codecHeader.VP9.temporal_idx = temporal_idx;
+  header.codecHeader.VP9.spatial_idx = spatial_idx;
+  header.codecHeader.VP9.num_ref_pics = pid_diffs.size();
+  for (size_t i = 0; i < pid_diffs.size(); ++i)
+    header.codecHeader.VP9.pid_diff[i] = pid_diffs[i];
+  return header;
+}
+
+// The temporal layers of the pictures in a three layer VP8 pattern.
+const uint8_t kVp8TemporalPattern[] = {0, 2, 1, 2};
+
+}  // namespace
+
+class SelectiveFrameForwarderTest : public ::testing::Test {
+ protected:
+  // Passes a picture of the three layer pattern, with the references that
+  // RtpFrameReferenceFinder gives it, and returns the rewritten header if it
+  // was forwarded.
+  rtc::Optional<RTPVideoHeader> ForwardVp8(int picture_id, bool layer_sync) {
+    uint8_t tid = kVp8TemporalPattern[picture_id % 4];
+    std::vector<int64_t> references;
+    if (picture_id > 0) {
+      // The latest picture of each layer up to |tid|, or only of layer 0 for
+      // base layer and sync frames.
+      const uint8_t max_layer = layer_sync ? 0 : tid;
+      for (uint8_t layer = 0; layer <= max_layer; ++layer) {
+        int p = picture_id - 1;
+        while (p >= 0 && kVp8TemporalPattern[p % 4] != layer)
+          --p;
+        if (p >= 0)
+          references.push_back(p);
+      }
+    }
+    FrameObjectFake frame = Frame(picture_id, 0, references);
+    RTPVideoHeader header = Vp8Header(picture_id, picture_id / 4, tid);
+    header.codecHeader.VP8.layerSync = layer_sync;
+    if (!forwarder_.ForwardFrame(frame, kVideoCodecVP8, header.codecHeader))
+      return rtc::nullopt;
+    forwarder_.RewritePacketHeader(&header);
+    return header;
+  }
+
+  SelectiveFrameForwarder forwarder_;
+};
+
+TEST_F(SelectiveFrameForwarderTest, ForwardsAllLayersByDefault) {
+  for (int i = 0; i < 12; ++i) {
+    rtc::Optional<RTPVideoHeader> header = ForwardVp8(i, false);
+    ASSERT_TRUE(header);
+    EXPECT_EQ(i, header->codecHeader.VP8.pictureId);
+    EXPECT_EQ(i / 4, header->codecHeader.VP8.tl0PicIdx);
+  }
+}
+
+TEST_F(SelectiveFrameForwarderTest, DropsTemporalLayersWithContinuousIds) {
+  forwarder_.SetMaxLayers(1, 0);
+  int16_t expected_picture_id = 0;
+  for (int i = 0; i < 12; ++i) {
+    rtc::Optional<RTPVideoHeader> header = ForwardVp8(i, false);
+    if (kVp8TemporalPattern[i % 4] == 2) {
+      EXPECT_FALSE(header);
+      continue;
+    }
+    ASSERT_TRUE(header);
+    EXPECT_EQ(expected_picture_id++, header->codecHeader.VP8.pictureId);
+    EXPECT_EQ(i / 4, header->codecHeader.VP8.tl0PicIdx);
+  }
+
+  forwarder_.SetMaxLayers(0, 0);
+  for (int i = 12; i < 20; ++i) {
+    rtc::Optional<RTPVideoHeader> header = ForwardVp8(i, false);
+    EXPECT_EQ(i % 4 == 0, static_cast<bool>(header));
+    if (header) {
+      EXPECT_EQ(expected_picture_id++, header->codecHeader.VP8.pictureId);
+      EXPECT_EQ(i / 4, header->codecHeader.VP8.tl0PicIdx);
+    }
+  }
+}
+
+TEST_F(SelectiveFrameForwarderTest, AddsTemporalLayerAtLayerSync) {
+  forwarder_.SetMaxLayers(0, 0);
+  for (int i = 0; i < 4; ++i)
+    EXPECT_EQ(i == 0, static_cast<bool>(ForwardVp8(i, false)));
+
+  forwarder_.SetMaxLayers(2, 0);
+  // Pictures 5 to 7 reference pictures of layers 1 and 2 that were dropped.
+  EXPECT_TRUE(ForwardVp8(4, false));
+  EXPECT_FALSE(ForwardVp8(5, false));
+  EXPECT_FALSE(ForwardVp8(6, false));
+  EXPECT_FALSE(ForwardVp8(7, false));
+  EXPECT_TRUE(ForwardVp8(8, false));
+  // Sync frames only reference layer 0.
+  rtc::Optional<RTPVideoHeader> header = ForwardVp8(9, true);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(3, header->codecHeader.VP8.pictureId);
+  EXPECT_TRUE(ForwardVp8(10, true));
+  EXPECT_TRUE(ForwardVp8(11, false));
+  header = ForwardVp8(12, false);
+  ASSERT_TRUE(header);
+  EXPECT_EQ(6, header->codecHeader.VP8.pictureId);
+  EXPECT_EQ(3, header->codecHeader.VP8.tl0PicIdx);
+}
+
+TEST_F(SelectiveFrameForwarderTest, DropsFramesWithMissingReferences) {
+  FrameObjectFake delta = Frame(1, 0, {0});
+  RTPVideoHeader header = Vp8Header(1, 0, 0);
+  EXPECT_FALSE(forwarder_.ForwardFrame(delta, kVideoCodecVP8,
+                                       header.codecHeader));
+}
+
+TEST_F(SelectiveFrameForwarderTest, DropsSpatialLayersAndEndsPicture) {
+  forwarder_.SetMaxLayers(0, 0);
+  for (int picture_id = 0; picture_id < 3; ++picture_id) {
+    for (uint8_t sid = 0; sid < 2; ++sid) {
+      std::vector<int64_t> references;
+      if (picture_id > 0)
+        references.push_back(picture_id - 1);
+      FrameObjectFake frame = Frame(picture_id, sid, references);
+      frame.inter_layer_predicted = sid > 0;
+      RTPVideoHeader header = Vp9FlexibleHeader(
+          picture_id, 0, sid, std::vector<uint8_t>(references.size(), 1));
+      header.codecHeader.VP9.end_of_picture = sid == 1;
+      bool forwarded =
+          forwarder_.ForwardFrame(frame, kVideoCodecVP9, header.codecHeader);
+      EXPECT_EQ(sid == 0, forwarded);
+      if (!forwarded)
+        continue;
+      forwarder_.RewritePacketHeader(&header);
+      EXPECT_EQ(picture_id, header.codecHeader.VP9.picture_id);
+      EXPECT_TRUE(header.codecHeader.VP9.end_of_picture);
+    }
+  }
+}
+
+TEST_F(SelectiveFrameForwarderTest, RewritesVp9ReferenceDiffs) {
+  forwarder_.SetMaxLayers(0, 0);
+  // Two temporal layers, layer 1 pictures in between are dropped.
+  const int64_t kBase = 100;
+  for (int i = 0; i < 6; ++i) {
+    const uint8_t tid = i % 2;
+    std::vector<int64_t> references;
+    std::vector<uint8_t> pid_diffs;
+    if (i > 0) {
+      int diff = tid == 0 ? 2 : 1;
+      references.push_back(kBase + i - diff);
+      pid_diffs.push_back(diff);
+    }
+    FrameObjectFake frame = Frame(kBase + i, 0, references);
+    RTPVideoHeader header = Vp9FlexibleHeader(kBase + i, tid, 0, pid_diffs);
+    bool forwarded =
+        forwarder_.ForwardFrame(frame, kVideoCodecVP9, header.codecHeader);
+    EXPECT_EQ(tid == 0, forwarded);
+    if (!forwarded)
+      continue;
+    forwarder_.RewritePacketHeader(&header);
+    EXPECT_EQ(kBase + i / 2, header.codecHeader.VP9.picture_id);
+    if (i > 0) {
+      ASSERT_EQ(1, header.codecHeader.VP9.num_ref_pics);
+      EXPECT_EQ(1, header.codecHeader.VP9.pid_diff[0]);
+    }
+  }
+}
+
+}  // namespace video_coding
+}  // namespace webrtc
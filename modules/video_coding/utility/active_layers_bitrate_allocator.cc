@@ -0,0 +1,60 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/active_layers_bitrate_allocator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+ActiveLayersBitrateAllocator::ActiveLayersBitrateAllocator(
+    std::unique_ptr<VideoBitrateAllocator> allocator)
+    : allocator_(std::move(allocator)) {
+  RTC_DCHECK(allocator_);
+}
+
+ActiveLayersBitrateAllocator::~ActiveLayersBitrateAllocator() = default;
+
+void ActiveLayersBitrateAllocator::SetActiveLayers(
+    const std::vector<bool>& active_layers) {
+  active_layers_ = active_layers;
+}
+
+VideoBitrateAllocation ActiveLayersBitrateAllocator::GetAllocation(
+    uint32_t total_bitrate,
+    uint32_t framerate) {
+  VideoBitrateAllocation allocation =
+      allocator_->GetAllocation(total_bitrate, framerate);
+  if (active_layers_.size() < 2)
+    return allocation;
+  const size_t num_layers =
+      std::min(active_layers_.size(), static_cast<size_t>(kMaxSpatialLayers));
+  for (size_t spatial_index = 0; spatial_index < num_layers; ++spatial_index) {
+    if (active_layers_[spatial_index])
+      continue;
+    for (size_t temporal_index = 0; temporal_index < kMaxTemporalStreams;
+         ++temporal_index) {
+      // A bitrate of 0, rather than none, tells the encoders to stop.
+      if (allocation.HasBitrate(spatial_index, temporal_index))
+        allocation.SetBitrate(spatial_index, temporal_index, 0);
+    }
+  }
+  return allocation;
+}
+
+uint32_t ActiveLayersBitrateAllocator::GetPreferredBitrateBps(
+    uint32_t framerate) {
+  return allocator_->GetPreferredBitrateBps(framerate);
+}
+
+}  // namespace webrtc
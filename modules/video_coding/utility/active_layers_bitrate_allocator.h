@@ -0,0 +1,48 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ACTIVE_LAYERS_BITRATE_ALLOCATOR_H_
+#define MODULES_VIDEO_CODING_UTILITY_ACTIVE_LAYERS_BITRATE_ALLOCATOR_H_
+
+#include <memory>
+#include <vector>
+
+#include "common_video/include/video_bitrate_allocator.h"
+
+namespace webrtc {
+
+// Allocates as |allocator| does, except that the simulcast layers that are
+// paused get no bitrate. Encoders that support simulcast don't encode the
+// layers that get no bitrate, and encode a keyframe on a layer, and only on
+// that one, when it gets bitrate again, so layers can be paused and resumed
+// without reconfiguring the encoder.
+class ActiveLayersBitrateAllocator : public VideoBitrateAllocator {
+ public:
+  explicit ActiveLayersBitrateAllocator(
+      std::unique_ptr<VideoBitrateAllocator> allocator);
+  ~ActiveLayersBitrateAllocator() override;
+
+  // Pauses the layers that are false in |active_layers|, and resumes the
+  // others and any beyond its end. With a single layer, nothing is paused:
+  // the stream as a whole is paused by not funding it.
+  void SetActiveLayers(const std::vector<bool>& active_layers);
+
+  VideoBitrateAllocation GetAllocation(uint32_t total_bitrate,
+                                       uint32_t framerate) override;
+  uint32_t GetPreferredBitrateBps(uint32_t framerate) override;
+
+ private:
+  const std::unique_ptr<VideoBitrateAllocator> allocator_;
+  std::vector<bool> active_layers_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ACTIVE_LAYERS_BITRATE_ALLOCATOR_H_
@@ -0,0 +1,75 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/active_layers_bitrate_allocator.h"
+
+#include <memory>
+
+#include "rtc_base/ptr_util.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kFramerate = 30;
+
+// Gives each of three layers a third of the bitrate, in two temporal layers.
+class ThreeLayerAllocator : public VideoBitrateAllocator {
+ public:
+  VideoBitrateAllocation GetAllocation(uint32_t total_bitrate,
+                                       uint32_t framerate) override {
+    VideoBitrateAllocation allocation;
+    for (size_t spatial_index = 0; spatial_index < 3; ++spatial_index) {
+      allocation.SetBitrate(spatial_index, 0, total_bitrate / 6);
+      allocation.SetBitrate(spatial_index, 1, total_bitrate / 6);
+    }
+    return allocation;
+  }
+  uint32_t GetPreferredBitrateBps(uint32_t framerate) override {
+    return 600000;
+  }
+};
+
+}  // namespace
+
+TEST(ActiveLayersBitrateAllocatorTest, AllocatesAsAllocatorByDefault) {
+  ActiveLayersBitrateAllocator allocator(
+      rtc::MakeUnique<ThreeLayerAllocator>());
+  VideoBitrateAllocation allocation =
+      allocator.GetAllocation(600000, kFramerate);
+  EXPECT_EQ(600000u, allocation.get_sum_bps());
+  EXPECT_EQ(600000u, allocator.GetPreferredBitrateBps(kFramerate));
+}
+
+TEST(ActiveLayersBitrateAllocatorTest, GivesPausedLayersNoBitrate) {
+  ActiveLayersBitrateAllocator allocator(
+      rtc::MakeUnique<ThreeLayerAllocator>());
+  allocator.SetActiveLayers({true, false, false});
+  VideoBitrateAllocation allocation =
+      allocator.GetAllocation(600000, kFramerate);
+  EXPECT_EQ(200000u, allocation.GetSpatialLayerSum(0));
+  EXPECT_EQ(0u, allocation.GetSpatialLayerSum(1));
+  EXPECT_EQ(0u, allocation.GetSpatialLayerSum(2));
+  // Paused, rather than unused.
+  EXPECT_TRUE(allocation.HasBitrate(2, 0));
+
+  allocator.SetActiveLayers({true, true, true});
+  allocation = allocator.GetAllocation(600000, kFramerate);
+  EXPECT_EQ(200000u, allocation.GetSpatialLayerSum(2));
+}
+
+TEST(ActiveLayersBitrateAllocatorTest, DoesNotPauseSingleLayer) {
+  ActiveLayersBitrateAllocator allocator(
+      rtc::MakeUnique<ThreeLayerAllocator>());
+  allocator.SetActiveLayers({false});
+  EXPECT_EQ(600000u, allocator.GetAllocation(600000, kFramerate).get_sum_bps());
+}
+
+}  // namespace webrtc
@@ -0,0 +1,58 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoder_speed_controller.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+
+namespace {
+const float kUsageFilterAlpha = 0.9f;
+const float kHighUsagePercent = 85.0f;
+const float kLowUsagePercent = 42.0f;
+// Give the filter time to reflect a new speed before changing it again.
+const int kMinFramesBetweenChanges = 30;
+}  // namespace
+
+EncoderSpeedController::EncoderSpeedController(int initial_speed,
+                                               int max_speed)
+    : initial_speed_(initial_speed),
+      max_speed_(std::max(initial_speed, max_speed)),
+      speed_(initial_speed),
+      frames_since_change_(0),
+      usage_percent_(kUsageFilterAlpha) {}
+
+bool EncoderSpeedController::OnFrameEncoded(int64_t encode_time_us,
+                                            uint32_t framerate) {
+  RTC_DCHECK_GE(encode_time_us, 0);
+  const float frame_interval_us =
+      static_cast<float>(rtc::kNumMicrosecsPerSec) / std::max(framerate, 1u);
+  usage_percent_.Apply(1.0f, 100.0f * encode_time_us / frame_interval_us);
+
+  if (++frames_since_change_ < kMinFramesBetweenChanges)
+    return false;
+
+  if (usage_percent_.filtered() > kHighUsagePercent && speed_ < max_speed_) {
+    ++speed_;
+  } else if (usage_percent_.filtered() < kLowUsagePercent &&
+             speed_ > initial_speed_) {
+    --speed_;
+  } else {
+    return false;
+  }
+  frames_since_change_ = 0;
+  return true;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,47 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef MODULES_VIDEO_CODING_UTILITY_ENCODER_SPEED_CONTROLLER_H_
+#define MODULES_VIDEO_CODING_UTILITY_ENCODER_SPEED_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include "rtc_base/numerics/exp_filter.h"
+
+namespace webrtc {
+
+// Adapts a real-time encoder speed preset, such as libvpx cpu-used, to the
+// measured encode time. Higher speeds are faster. When encoding takes up too
+// much of the frame interval, the speed is stepped up towards |max_speed| so
+// that the encoder trades compression efficiency for time before the CPU
+// adaptation has to reduce resolution. When there is headroom again, the
+// speed is stepped back down towards |initial_speed|.
+// The thresholds match the defaults of OveruseFrameDetector.
+class EncoderSpeedController {
+ public:
+  EncoderSpeedController(int initial_speed, int max_speed);
+
+  // Reports the time spent encoding a frame at |framerate|. Returns true if
+  // speed() changed.
+  bool OnFrameEncoded(int64_t encode_time_us, uint32_t framerate);
+
+  int speed() const { return speed_; }
+
+ private:
+  const int initial_speed_;
+  const int max_speed_;
+  int speed_;
+  int frames_since_change_;
+  rtc::ExpFilter usage_percent_;
+};
+
+}  // namespace webrtc
+
+#endif  // MODULES_VIDEO_CODING_UTILITY_ENCODER_SPEED_CONTROLLER_H_
@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "modules/video_coding/utility/encoder_speed_controller.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+const uint32_t kFramerate = 30;
+// Encode times of 95% and 20% of the frame interval at |kFramerate|.
+const int64_t kSlowEncodeTimeUs = 31667;
+const int64_t kFastEncodeTimeUs = 6667;
+const int kFramesPerChange = 30;
+
+// Returns the number of speed changes seen while encoding |num_frames|.
+int EncodeFrames(EncoderSpeedController* controller,
+                 int num_frames,
+                 int64_t encode_time_us) {
+  int changes = 0;
+  for (int i = 0; i < num_frames; ++i) {
+    if (controller->OnFrameEncoded(encode_time_us, kFramerate))
+      ++changes;
+  }
+  return changes;
+}
+}  // namespace
+
+TEST(EncoderSpeedControllerTest, KeepsInitialSpeedWithinBudget) {
+  EncoderSpeedController controller(5, 8);
+  EXPECT_EQ(0, EncodeFrames(&controller, 10 * kFramesPerChange,
+                            kFastEncodeTimeUs));
+  EXPECT_EQ(5, controller.speed());
+}
+
+TEST(EncoderSpeedControllerTest, SpeedsUpWhenOverusingUpToMaxSpeed) {
+  EncoderSpeedController controller(5, 7);
+  EXPECT_EQ(0, EncodeFrames(&controller, kFramesPerChange - 1,
+                            kSlowEncodeTimeUs));
+  EXPECT_EQ(5, controller.speed());
+  EXPECT_TRUE(controller.OnFrameEncoded(kSlowEncodeTimeUs, kFramerate));
+  EXPECT_EQ(6, controller.speed());
+
+  EXPECT_EQ(1, EncodeFrames(&controller, 10 * kFramesPerChange,
+                            kSlowEncodeTimeUs));
+  EXPECT_EQ(7, controller.speed());
+}
+
+TEST(EncoderSpeedControllerTest, ReturnsToInitialSpeedWhenUnderusing) {
+  EncoderSpeedController controller(5, 8);
+  EncodeFrames(&controller, 3 * kFramesPerChange, kSlowEncodeTimeUs);
+  EXPECT_EQ(8, controller.speed());
+
+  EncodeFrames(&controller, 10 * kFramesPerChange, kFastEncodeTimeUs);
+  EXPECT_EQ(5, controller.speed());
+}
+
+TEST(EncoderSpeedControllerTest, NeverChangesWithEmptyRange) {
+  EncoderSpeedController controller(7, 7);
+  EXPECT_EQ(0, EncodeFrames(&controller, 10 * kFramesPerChange,
+                            kSlowEncodeTimeUs));
+  EXPECT_EQ(7, controller.speed());
+}
+
+}  // namespace webrtc
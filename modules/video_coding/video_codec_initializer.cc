@@ -22,6 +22,7 @@
 #include "modules/video_coding/utility/default_video_bitrate_allocator.h"
 #include "rtc_base/logging.h"
 #include "system_wrappers/include/clock.h"
+#include "system_wrappers/include/field_trial.h"
 
 namespace webrtc {
 
@@ -114,6 +115,10 @@ VideoCodec VideoCodecInitializer::VideoEncoderConfigToVideoCodec(
     video_codec.minBitrate = kEncoderMinBitrateKbps;
   video_codec.timing_frame_thresholds = {kDefaultTimingFramesDelayMs,
                                          kDefaultOutlierFrameSizePercent};
+  // Zero delay makes every frame a timing frame, for per-frame latency
+  // tracing of the whole pipeline.
+  if (field_trial::IsEnabled("WebRTC-TimingFramesEveryFrame"))
+    video_codec.timing_frame_thresholds.delay_ms = 0;
   RTC_DCHECK_LE(streams.size(), kMaxSimulcastStreams);
 
   for (size_t i = 0; i < streams.size(); ++i) {
@@ -19,5 +19,6 @@ int32_t VCMReceiveCallback::ReceivedDecodedReferenceFrame(
 void VCMReceiveCallback::OnIncomingPayloadType(int payload_type) {}
 void VCMReceiveCallback::OnDecoderImplementationName(
     const char* implementation_name) {}
+void VCMReceiveCallback::OnDecoderNumberOfThreads(int number_of_threads) {}
 
 }  // namespace webrtc
@@ -98,6 +98,17 @@ class VideoSender {
   int32_t AddVideoFrame(const VideoFrame& videoFrame,
                         const CodecSpecificInfo* codecSpecificInfo);
 
+  // AddVideoFrame() split in two, so that a caller can run the media
+  // optimization drop decision before spending any time preparing the frame
+  // (cropping, scaling or converting it). DropFrameBeforeEncode() applies
+  // pending encoder parameters and returns true if the next frame should be
+  // dropped, in which case the drop has already been reported to the post
+  // encode callback. Frames that aren't dropped must then be passed to
+  // EncodeFrame(), which encodes without running the drop decision again.
+  bool DropFrameBeforeEncode();
+  int32_t EncodeFrame(const VideoFrame& videoFrame,
+                      const CodecSpecificInfo* codecSpecificInfo);
+
   int32_t IntraFrameRequest(size_t stream_index);
   int32_t EnableFrameDropper(bool enable);
 
@@ -151,7 +162,10 @@ class VideoReceiver : public Module {
 
   int32_t Decode(uint16_t maxWaitTimeMs);
 
-  int32_t Decode(const webrtc::VCMEncodedFrame* frame);
+  // Decodes a frame of the new jitter buffer. Frames assembled from packets
+  // are only copied into one buffer if the decoder or the pre-decode callback
+  // needs them to be.
+  int32_t Decode(webrtc::VCMEncodedFrame* frame);
 
   int32_t IncomingPacket(const uint8_t* incomingPayload,
                          size_t payloadLength,
@@ -200,7 +214,7 @@ class VideoReceiver : public Module {
   bool IsDecoderThreadRunning();
 
   rtc::ThreadChecker construction_thread_checker_;
-  rtc::ThreadChecker decoder_thread_checker_;
+  rtc::SequencedTaskChecker decoder_thread_checker_;
   rtc::ThreadChecker module_thread_checker_;
   Clock* const clock_;
   rtc::CriticalSection process_crit_;
@@ -12,6 +12,7 @@
 #include <map>
 #include <set>
 #include <utility>
+#include <vector>
 
 #include "common_video/h264/h264_common.h"
 #include "modules/video_coding/frame_object.h"
@@ -106,6 +107,19 @@ TEST_F(TestPacketBuffer, InsertMultiplePackets) {
   EXPECT_TRUE(Insert(seq_num + 3, kKeyFrame, kFirst, kLast));
 }
 
+TEST_F(TestPacketBuffer, MemoryUsageCountsStoredPayloads) {
+  const uint16_t seq_num = Rand();
+  const size_t empty_bytes = packet_buffer_->MemoryUsageBytes();
+  EXPECT_GT(empty_bytes, 0u);
+
+  EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kNotLast, 100,
+                     new uint8_t[100]));
+  EXPECT_EQ(empty_bytes + 100, packet_buffer_->MemoryUsageBytes());
+
+  packet_buffer_->ClearTo(seq_num);
+  EXPECT_EQ(empty_bytes, packet_buffer_->MemoryUsageBytes());
+}
+
 TEST_F(TestPacketBuffer, InsertDuplicatePacket) {
   const uint16_t seq_num = Rand();
   EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kLast));
@@ -609,12 +623,16 @@ TEST_P(TestPacketBufferH264Parameterized, GetBitstreamBufferPadding) {
   packet_buffer_->InsertPacket(&packet);
 
   ASSERT_EQ(1UL, frames_from_callback_.size());
-  EXPECT_EQ(frames_from_callback_[seq_num]->EncodedImage()._length,
-            sizeof(data_data));
-  EXPECT_EQ(frames_from_callback_[seq_num]->EncodedImage()._size,
+  RtpFrameObject* frame = frames_from_callback_[seq_num].get();
+  frame->Linearize();
+  EXPECT_EQ(frame->EncodedImage()._length, sizeof(data_data));
+  EXPECT_EQ(frame->EncodedImage()._size,
             sizeof(data_data) + EncodedImage::kBufferPaddingBytesH264);
-  EXPECT_TRUE(frames_from_callback_[seq_num]->GetBitstream(result.get()));
-  EXPECT_EQ(memcmp(result.get(), data, sizeof(data_data)), 0);
+  EXPECT_EQ(memcmp(frame->Buffer(), data_data, sizeof(data_data)), 0);
+  for (size_t i = 0; i < EncodedImage::kBufferPaddingBytesH264; ++i)
+    EXPECT_EQ(0, frame->Buffer()[sizeof(data_data) + i]);
+  EXPECT_TRUE(frame->GetBitstream(result.get()));
+  EXPECT_EQ(memcmp(result.get(), data_data, sizeof(data_data)), 0);
 }
 
 TEST_F(TestPacketBuffer, FreeSlotsOnFrameDestruction) {
@@ -656,14 +674,66 @@ TEST_F(TestPacketBuffer, Clear) {
   CheckFrame(seq_num + kStartSize);
 }
 
-TEST_F(TestPacketBuffer, InvalidateFrameByClearing) {
+TEST_F(TestPacketBuffer, FrameKeepsBitstreamWhenCleared) {
   const uint16_t seq_num = Rand();
+  uint8_t bitstream_data[] = "frame data";
+  uint8_t* data = new uint8_t[sizeof(bitstream_data)];
+  memcpy(data, bitstream_data, sizeof(bitstream_data));
 
-  EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kLast));
+  EXPECT_TRUE(
+      Insert(seq_num, kKeyFrame, kFirst, kLast, sizeof(bitstream_data), data));
   ASSERT_EQ(1UL, frames_from_callback_.size());
 
   packet_buffer_->Clear();
-  EXPECT_FALSE(frames_from_callback_.begin()->second->GetBitstream(nullptr));
+  uint8_t result[sizeof(bitstream_data)];
+  EXPECT_TRUE(frames_from_callback_.begin()->second->GetBitstream(result));
+  EXPECT_EQ(memcmp(result, bitstream_data, sizeof(bitstream_data)), 0);
+}
+
+TEST_F(TestPacketBuffer, BitstreamSegmentsArePacketPayloads) {
+  const uint16_t seq_num = Rand();
+  uint8_t first_data[] = {1, 2, 3};
+  uint8_t last_data[] = {4, 5};
+  uint8_t* first = new uint8_t[sizeof(first_data)];
+  uint8_t* last = new uint8_t[sizeof(last_data)];
+  memcpy(first, first_data, sizeof(first_data));
+  memcpy(last, last_data, sizeof(last_data));
+
+  EXPECT_TRUE(Insert(seq_num, kKeyFrame, kFirst, kNotLast, sizeof(first_data),
+                     first));
+  // Empty packets don't get a segment.
+  EXPECT_TRUE(Insert(seq_num + 1, kKeyFrame, kNotFirst, kNotLast));
+  EXPECT_TRUE(Insert(seq_num + 2, kKeyFrame, kNotFirst, kLast,
+                     sizeof(last_data), last));
+  ASSERT_EQ(1UL, frames_from_callback_.size());
+  RtpFrameObject* frame = frames_from_callback_[seq_num].get();
+
+  EXPECT_EQ(nullptr, frame->Buffer());
+  std::vector<rtc::ArrayView<const uint8_t>> segments =
+      frame->BitstreamSegments();
+  ASSERT_EQ(2UL, segments.size());
+  EXPECT_EQ(first, segments[0].data());
+  EXPECT_EQ(sizeof(first_data), segments[0].size());
+  EXPECT_EQ(last, segments[1].data());
+  EXPECT_EQ(sizeof(last_data), segments[1].size());
+
+  frame->Linearize();
+  const uint8_t expected[] = {1, 2, 3, 4, 5};
+  ASSERT_NE(nullptr, frame->Buffer());
+  EXPECT_EQ(sizeof(expected), frame->Length());
+  EXPECT_EQ(memcmp(frame->Buffer(), expected, sizeof(expected)), 0);
+  segments = frame->BitstreamSegments();
+  ASSERT_EQ(1UL, segments.size());
+  EXPECT_EQ(frame->Buffer(), segments[0].data());
+  EXPECT_EQ(sizeof(expected), segments[0].size());
+}
+
+TEST(PacketBufferSizeTest, BufferSizeForBitrate) {
+  EXPECT_EQ(512UL, PacketBuffer::BufferSizeForBitrate(0, 512));
+  EXPECT_EQ(512UL, PacketBuffer::BufferSizeForBitrate(1000000, 512));
+  // 20 Mbps is 2500 packets of 1000 bytes a second.
+  EXPECT_EQ(4096UL, PacketBuffer::BufferSizeForBitrate(20000000, 512));
+  EXPECT_EQ(16384UL, PacketBuffer::BufferSizeForBitrate(1000000000, 512));
 }
 
 TEST_F(TestPacketBuffer, FramesAfterClear) {
@@ -50,7 +50,7 @@ VideoReceiver::VideoReceiver(Clock* clock,
       _receiveStatsTimer(1000, clock_),
       _retransmissionTimer(10, clock_),
       _keyRequestTimer(500, clock_) {
-  decoder_thread_checker_.DetachFromThread();
+  decoder_thread_checker_.Detach();
   module_thread_checker_.DetachFromThread();
 }
 
@@ -260,7 +260,7 @@ void VideoReceiver::DecoderThreadStopped() {
   }
 #if RTC_DCHECK_IS_ON
   decoder_thread_is_running_ = false;
-  decoder_thread_checker_.DetachFromThread();
+  decoder_thread_checker_.Detach();
 #endif
 }
 
@@ -326,8 +326,9 @@ int32_t VideoReceiver::Decode(uint16_t maxWaitTimeMs) {
 // Used for the new jitter buffer.
 // TODO(philipel): Clean up among the Decode functions as we replace
 //                 VCMEncodedFrame with FrameObject.
-int32_t VideoReceiver::Decode(const webrtc::VCMEncodedFrame* frame) {
+int32_t VideoReceiver::Decode(webrtc::VCMEncodedFrame* frame) {
   RTC_DCHECK_RUN_ON(&decoder_thread_checker_);
+  frame->Linearize();
   if (pre_decode_image_callback_) {
     EncodedImage encoded_image(frame->EncodedImage());
     int qp = -1;
@@ -53,6 +53,8 @@ class TestVideoReceiver : public ::testing::Test {
     EXPECT_CALL(receive_callback_, OnIncomingPayloadType(_)).Times(AnyNumber());
     EXPECT_CALL(receive_callback_, OnDecoderImplementationName(_))
         .Times(AnyNumber());
+    EXPECT_CALL(receive_callback_, OnDecoderNumberOfThreads(_))
+        .Times(AnyNumber());
     receiver_->RegisterReceiveCallback(&receive_callback_);
   }
 
@@ -242,18 +242,22 @@ void VideoSender::SetEncoderParameters(EncoderParameters params,
 // Add one raw video frame to the encoder, blocking.
 int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
                                    const CodecSpecificInfo* codecSpecificInfo) {
+  if (DropFrameBeforeEncode())
+    return VCM_OK;
+  return EncodeFrame(videoFrame, codecSpecificInfo);
+}
+
+bool VideoSender::DropFrameBeforeEncode() {
   EncoderParameters encoder_params;
-  std::vector<FrameType> next_frame_types;
   bool encoder_has_internal_source = false;
   {
     rtc::CritScope lock(&params_crit_);
     encoder_params = encoder_params_;
-    next_frame_types = next_frame_types_;
     encoder_has_internal_source = encoder_has_internal_source_;
   }
   rtc::CritScope lock(&encoder_crit_);
   if (_encoder == nullptr)
-    return VCM_UNINITIALIZED;
+    return false;
   SetEncoderParameters(encoder_params, encoder_has_internal_source);
   if (_mediaOpt.DropFrame()) {
     RTC_LOG(LS_VERBOSE) << "Drop Frame "
@@ -264,8 +268,21 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
                         << encoder_params.input_frame_rate;
     post_encode_callback_->OnDroppedFrame(
         EncodedImageCallback::DropReason::kDroppedByMediaOptimizations);
-    return VCM_OK;
+    return true;
   }
+  return false;
+}
+
+int32_t VideoSender::EncodeFrame(const VideoFrame& videoFrame,
+                                 const CodecSpecificInfo* codecSpecificInfo) {
+  std::vector<FrameType> next_frame_types;
+  {
+    rtc::CritScope lock(&params_crit_);
+    next_frame_types = next_frame_types_;
+  }
+  rtc::CritScope lock(&encoder_crit_);
+  if (_encoder == nullptr)
+    return VCM_UNINITIALIZED;
   // TODO(pbos): Make sure setting send codec is synchronized with video
   // processing so frame size always matches.
   if (!_codecDataBase.MatchesCurrentResolution(videoFrame.width(),
@@ -277,8 +294,11 @@ int32_t VideoSender::AddVideoFrame(const VideoFrame& videoFrame,
   VideoFrame converted_frame = videoFrame;
   const VideoFrameBuffer::Type buffer_type =
       converted_frame.video_frame_buffer()->type();
+  // NV12 is passed on as is; encoders that can't take it convert it
+  // themselves, into pooled buffers.
   const bool is_buffer_type_supported =
       buffer_type == VideoFrameBuffer::Type::kI420 ||
+      buffer_type == VideoFrameBuffer::Type::kNV12 ||
       (buffer_type == VideoFrameBuffer::Type::kNative &&
        _encoder->SupportsNativeHandle());
   if (!is_buffer_type_supported) {
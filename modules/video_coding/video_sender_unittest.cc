@@ -299,6 +299,16 @@ TEST_F(TestVideoSenderWithMockEncoder, TestIntraRequests) {
   AddFrame();
 }
 
+TEST_F(TestVideoSenderWithMockEncoder, EncodesFrameAfterSeparateDropCheck) {
+  // The drop decision can be made before the frame is prepared, and the frame
+  // is then encoded with the same frame types as through AddVideoFrame().
+  ExpectInitialKeyFrames();
+  EXPECT_FALSE(sender_->DropFrameBeforeEncode());
+  EXPECT_EQ(0, sender_->EncodeFrame(*generator_->NextFrame(), nullptr));
+  ExpectIntraRequest(-1);
+  AddFrame();
+}
+
 TEST_F(TestVideoSenderWithMockEncoder, TestSetRate) {
   // Let actual fps be half of max, so it can be distinguished from default.
   const uint32_t kActualFrameRate = settings_.maxFramerate / 2;
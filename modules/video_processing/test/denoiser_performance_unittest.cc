@@ -0,0 +1,95 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "api/video/i420_buffer.h"
+#include "modules/video_processing/video_denoiser.h"
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace {
+
+const int kNumDistinctFrames = 8;
+const int kNumWarmupFrames = 5;
+const int kNumTimedFrames = 60;
+
+struct Resolution {
+  const char* name;
+  int width;
+  int height;
+};
+
+// A gradient background with additive noise and a bright square moving
+// across it, so that both the filtering and the moving object paths run.
+rtc::scoped_refptr<I420Buffer> CreateNoisyFrame(int width,
+                                                int height,
+                                                int frame_index,
+                                                Random* random) {
+  rtc::scoped_refptr<I420Buffer> buffer = I420Buffer::Create(width, height);
+  const int square_size = height / 4;
+  const int square_x = (frame_index * width / kNumDistinctFrames) % width;
+  const int square_y = height / 3;
+  // Neutral chroma; only the luma plane is denoised.
+  I420Buffer::SetBlack(buffer.get());
+  for (int y = 0; y < height; ++y) {
+    uint8_t* row = buffer->MutableDataY() + y * buffer->StrideY();
+    for (int x = 0; x < width; ++x) {
+      const bool in_square = x >= square_x && x < square_x + square_size &&
+                             y >= square_y && y < square_y + square_size;
+      const int value = (in_square ? 220 : 64 + (x + y) % 96) +
+                        random->Rand(-6, 6);
+      row[x] = static_cast<uint8_t>(std::min(255, std::max(0, value)));
+    }
+  }
+  return buffer;
+}
+
+double MeasureMsPerFrame(
+    bool runtime_cpu_detection,
+    const std::vector<rtc::scoped_refptr<I420Buffer>>& frames) {
+  VideoDenoiser denoiser(runtime_cpu_detection);
+  for (int i = 0; i < kNumWarmupFrames; ++i)
+    denoiser.DenoiseFrame(frames[i % frames.size()], true);
+
+  const int64_t start_us = rtc::TimeMicros();
+  for (int i = 0; i < kNumTimedFrames; ++i)
+    denoiser.DenoiseFrame(frames[i % frames.size()], true);
+  const int64_t elapsed_us = rtc::TimeMicros() - start_us;
+  return static_cast<double>(elapsed_us) / rtc::kNumMicrosecsPerMillisec /
+         kNumTimedFrames;
+}
+
+}  // namespace
+
+TEST(VideoDenoiserPerformanceTest, TimePerFrame) {
+  const Resolution kResolutions[] = {
+      {"360p", 640, 360}, {"720p", 1280, 720}, {"1080p", 1920, 1080}};
+  for (const Resolution& resolution : kResolutions) {
+    Random random(0x1234);
+    std::vector<rtc::scoped_refptr<I420Buffer>> frames;
+    for (int i = 0; i < kNumDistinctFrames; ++i) {
+      frames.push_back(CreateNoisyFrame(resolution.width, resolution.height, i,
+                                        &random));
+    }
+
+    test::PrintResult("denoiser_time_per_frame", "_c", resolution.name,
+                      MeasureMsPerFrame(false, frames), "ms", false);
+    test::PrintResult("denoiser_time_per_frame", "_simd", resolution.name,
+                      MeasureMsPerFrame(true, frames), "ms", true);
+  }
+}
+
+}  // namespace webrtc
@@ -40,6 +40,27 @@ TEST(VideoDenoiserTest, CopyMem) {
   EXPECT_EQ(0, memcmp(src, dst, 16 * 16));
 }
 
+TEST(VideoDenoiserTest, Sum) {
+  std::unique_ptr<DenoiserFilter> df_c(DenoiserFilter::Create(false, nullptr));
+  std::unique_ptr<DenoiserFilter> df_sse_neon(
+      DenoiserFilter::Create(true, nullptr));
+  uint8_t src[16 * 16];
+  for (int i = 0; i < 16; ++i) {
+    for (int j = 0; j < 16; ++j) {
+      src[i * 16 + j] = 255 - i * 7 - j;
+    }
+  }
+  // Sum of the center 8x8 block of the 16x16 block.
+  uint32_t sum = 0;
+  for (int i = 4; i < 12; ++i) {
+    for (int j = 4; j < 12; ++j) {
+      sum += 255 - i * 7 - j;
+    }
+  }
+  EXPECT_EQ(sum, df_c->Sum8x8(src + 4 * 16 + 4, 16));
+  EXPECT_EQ(sum, df_sse_neon->Sum8x8(src + 4 * 16 + 4, 16));
+}
+
 TEST(VideoDenoiserTest, Variance) {
   std::unique_ptr<DenoiserFilter> df_c(DenoiserFilter::Create(false, nullptr));
   std::unique_ptr<DenoiserFilter> df_sse_neon(
@@ -25,6 +25,16 @@ void DenoiserFilterC::CopyMem16x16(const uint8_t* src,
   }
 }
 
+uint32_t DenoiserFilterC::Sum8x8(const uint8_t* src, int src_stride) {
+  uint32_t sum = 0;
+  for (int i = 0; i < 8; i++) {
+    for (int j = 0; j < 8; j++)
+      sum += src[j];
+    src += src_stride;
+  }
+  return sum;
+}
+
 uint32_t DenoiserFilterC::Variance16x8(const uint8_t* a,
                                        int a_stride,
                                        const uint8_t* b,
@@ -258,14 +258,10 @@ rtc::scoped_refptr<I420BufferInterface> VideoDenoiser::DenoiseFrame(
       uint8_t* mb_dst = mb_dst_base + offset_col;
       const uint8_t* mb_dst_prev = mb_dst_prev_base + offset_col;
 
-      // TODO(jackychen): Need SSE2/NEON opt.
+      // Luma sum of the center 8x8 block, used for noise estimation.
       int luma = 0;
       if (ne_enable) {
-        for (int i = 4; i < 12; ++i) {
-          for (int j = 4; j < 12; ++j) {
-            luma += mb_src[i * stride_y_src + j];
-          }
-        }
+        luma = filter_->Sum8x8(mb_src + 4 * stride_y_src + 4, stride_y_src);
       }
 
       // Get the filtered block and filter_decision.
@@ -13,6 +13,7 @@
 #include <string.h>
 
 #include "p2p/base/stun.h"
+#include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
@@ -66,16 +67,17 @@ int AsyncStunTCPSocket::Send(const void *pv, size_t cb,
   if (cb != expected_pkt_len)
     return -1;
 
-  AppendToOutBuffer(pv, cb);
-
   RTC_DCHECK(pad_bytes < 4);
-  char padding[4] = {0};
-  AppendToOutBuffer(padding, pad_bytes);
-
-  int res = FlushOutBuffer();
+  static const char kPadding[4] = {0};
+  rtc::OutgoingBuffer buffers[2];
+  buffers[0].data = pv;
+  buffers[0].length = cb;
+  buffers[1].data = kPadding;
+  buffers[1].length = pad_bytes;
+
+  int res = SendBuffers(buffers, arraysize(buffers));
   if (res <= 0) {
     // drop packet if we made no progress
-    ClearOutBuffer();
     return res;
   }
 
@@ -98,26 +100,28 @@ void AsyncStunTCPSocket::ProcessInput(char* data, size_t* len) {
   // |         Channel Number        |            Length             |
   // +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
 
-  while (true) {
-    // We need at least 4 bytes to read the STUN or ChannelData packet length.
-    if (*len < kPacketLenOffset + kPacketLenSize)
-      return;
-
+  // Complete packets are delivered in place; the incomplete rest is moved to
+  // the front of the buffer once at the end.
+  size_t pos = 0;
+  // We need at least 4 bytes to read the STUN or ChannelData packet length.
+  while (*len - pos >= kPacketLenOffset + kPacketLenSize) {
     int pad_bytes;
-    size_t expected_pkt_len = GetExpectedLength(data, *len, &pad_bytes);
+    size_t expected_pkt_len =
+        GetExpectedLength(data + pos, *len - pos, &pad_bytes);
     size_t actual_length = expected_pkt_len + pad_bytes;
 
-    if (*len < actual_length) {
-      return;
+    if (*len - pos < actual_length) {
+      break;
     }
 
-    SignalReadPacket(this, data, expected_pkt_len, remote_addr,
+    SignalReadPacket(this, data + pos, expected_pkt_len, remote_addr,
                      rtc::CreatePacketTime(0));
+    pos += actual_length;
+  }
 
-    *len -= actual_length;
-    if (*len > 0) {
-      memmove(data, data + actual_length, *len);
-    }
+  *len -= pos;
+  if (pos > 0 && *len > 0) {
+    memmove(data, data + pos, *len);
   }
 }
 
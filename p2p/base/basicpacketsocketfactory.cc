@@ -20,12 +20,22 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/nethelpers.h"
 #include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/receivebufferpool.h"
 #include "rtc_base/socketadapters.h"
 #include "rtc_base/ssladapter.h"
 #include "rtc_base/thread.h"
 
 namespace rtc {
 
+namespace {
+
+// Unsent data that the kernel may hold for a TCP socket. The TCP packet
+// sockets drop packets while the socket doesn't accept more, so this bounds
+// how stale queued media can get on a congested connection.
+const int kTcpNotSentLowAtBytes = 16 * 1024;
+
+}  // namespace
+
 BasicPacketSocketFactory::BasicPacketSocketFactory()
     : thread_(Thread::Current()),
       socket_factory_(NULL) {
@@ -60,7 +70,10 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateUdpSocket(
     delete socket;
     return NULL;
   }
-  return new AsyncUDPSocket(socket);
+  AsyncUDPSocket* udp_socket = new AsyncUDPSocket(socket);
+  // Lets RtpTransport take received media packets without copying them.
+  udp_socket->SetReceiveBufferPool(ReceiveBufferPool::Default());
+  return udp_socket;
 }
 
 AsyncPacketSocket* BasicPacketSocketFactory::CreateServerTcpSocket(
@@ -95,6 +108,7 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateServerTcpSocket(
   // Set TCP_NODELAY (via OPT_NODELAY) for improved performance.
   // See http://go/gtalktcpnodelayexperiment
   socket->SetOption(Socket::OPT_NODELAY, 1);
+  socket->SetOption(Socket::OPT_NOTSENT_LOWAT, kTcpNotSentLowAtBytes);
 
   if (opts & PacketSocketFactory::OPT_STUN)
     return new cricket::AsyncStunTCPSocket(socket, true);
@@ -201,6 +215,7 @@ AsyncPacketSocket* BasicPacketSocketFactory::CreateClientTcpSocket(
   // Set TCP_NODELAY (via OPT_NODELAY) for improved performance.
   // See http://go/gtalktcpnodelayexperiment
   tcp_socket->SetOption(Socket::OPT_NODELAY, 1);
+  tcp_socket->SetOption(Socket::OPT_NOTSENT_LOWAT, kTcpNotSentLowAtBytes);
 
   return tcp_socket;
 }
@@ -437,6 +437,32 @@ int DtlsTransport::SendPacket(const char* data,
   }
 }
 
+int DtlsTransport::SendPackets(rtc::OutgoingPacket* packets,
+                               size_t count,
+                               int flags) {
+  if (!dtls_active_) {
+    // Not doing DTLS.
+    return ice_transport_->SendPackets(packets, count);
+  }
+  if (dtls_state() != DTLS_TRANSPORT_CONNECTED || !(flags & PF_SRTP_BYPASS)) {
+    // Packets that go through DTLS, or fail, one at a time.
+    return PacketTransportInternal::SendPackets(packets, count, flags);
+  }
+
+  RTC_DCHECK(!srtp_ciphers_.empty());
+  // Like SendPacket(), refuse anything that isn't RTP, sending only the packets
+  // before it.
+  size_t rtp_count = 0;
+  while (rtp_count < count &&
+         IsRtpPacket(static_cast<const char*>(packets[rtp_count].data),
+                     packets[rtp_count].size)) {
+    ++rtp_count;
+  }
+  if (rtp_count == 0)
+    return count > 0 ? -1 : 0;
+  return ice_transport_->SendPackets(packets, rtp_count);
+}
+
 IceTransportInternal* DtlsTransport::ice_transport() {
   return ice_transport_;
 }
@@ -642,8 +668,13 @@ void DtlsTransport::OnDtlsEvent(rtc::StreamInterface* dtls, int sig, int err) {
   RTC_DCHECK(dtls == dtls_.get());
   if (sig & rtc::SE_OPEN) {
     // This is the first time.
-    RTC_LOG(LS_INFO) << ToString()
-                     << ": DTLS handshake complete.";
+    int64_t duration_ms = 0;
+    if (dtls_->GetHandshakeDurationMs(&duration_ms)) {
+      RTC_LOG(LS_INFO) << ToString() << ": DTLS handshake complete in "
+                       << duration_ms << " ms.";
+    } else {
+      RTC_LOG(LS_INFO) << ToString() << ": DTLS handshake complete.";
+    }
     if (dtls_->GetState() == rtc::SS_OPEN) {
       // The check for OPEN shouldn't be necessary but let's make
       // sure we don't accidentally frob the state if it's closed.
@@ -129,6 +129,11 @@ class DtlsTransport : public DtlsTransportInternal {
                  size_t size,
                  const rtc::PacketOptions& options,
                  int flags) override;
+  // Passes batches of SRTP packets (PF_SRTP_BYPASS), or of any packets when
+  // not doing DTLS, on to the ICE transport in one piece.
+  int SendPackets(rtc::OutgoingPacket* packets,
+                  size_t count,
+                  int flags) override;
 
   bool GetOption(rtc::Socket::Option opt, int* value) override;
 
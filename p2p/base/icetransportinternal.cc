@@ -49,6 +49,10 @@ int IceConfig::stable_writable_connection_ping_interval_or_default() const {
   return stable_writable_connection_ping_interval.value_or(
       STRONG_AND_STABLE_WRITABLE_CONNECTION_PING_INTERVAL);
 }
+int IceConfig::media_active_connection_ping_interval_or_default() const {
+  return media_active_connection_ping_interval.value_or(
+      stable_writable_connection_ping_interval_or_default());
+}
 int IceConfig::regather_on_failed_networks_interval_or_default() const {
   return regather_on_failed_networks_interval.value_or(
       REGATHER_ON_FAILED_NETWORKS_INTERVAL);
@@ -89,6 +89,12 @@ struct IceConfig {
   // Writable connections are pinged at a slower rate once stablized.
   rtc::Optional<int> stable_writable_connection_ping_interval;
 
+  // Stable writable connections that have received data within the receiving
+  // timeout are pinged at this interval instead, since the incoming media
+  // already shows that they are alive. Unset means they are pinged at the
+  // stable writable interval.
+  rtc::Optional<int> media_active_connection_ping_interval;
+
   // If set to true, this means the ICE transport should presume TURN-to-TURN
   // candidate pairs will succeed, even before a binding response is received.
   bool presume_writable_when_fully_relayed = false;
@@ -162,6 +168,7 @@ struct IceConfig {
   int receiving_timeout_or_default() const;
   int backup_connection_ping_interval_or_default() const;
   int stable_writable_connection_ping_interval_or_default() const;
+  int media_active_connection_ping_interval_or_default() const;
   int regather_on_failed_networks_interval_or_default() const;
   int receiving_switching_delay_or_default() const;
   int ice_check_interval_strong_connectivity_or_default() const;
@@ -224,6 +231,10 @@ class IceTransportInternal : public rtc::PacketTransportInternal {
 
   virtual void SetRemoteIceMode(IceMode mode) = 0;
 
+  // Sets whether this agent implements full ICE or ICE-lite (RFC 5245, section
+  // 2.7). Full ICE by default.
+  virtual void SetIceMode(IceMode mode) {}
+
   virtual void SetIceConfig(const IceConfig& config) = 0;
 
   // Start gathering candidates if not already started, or if an ICE restart
@@ -13,6 +13,7 @@
 #include <algorithm>
 #include <iterator>
 #include <set>
+#include <unordered_map>
 #include <utility>
 
 #include "api/candidate.h"
@@ -192,6 +193,7 @@ void P2PTransportChannel::AddConnection(Connection* connection) {
 
   connection->set_ice_event_log(&ice_event_log_);
   LogCandidatePairEvent(connection, webrtc::IceCandidatePairEventType::kAdded);
+  WakeUpCheckAndPing();
 }
 
 // Determines whether we should switch the selected connection to
@@ -413,6 +415,17 @@ void P2PTransportChannel::SetRemoteIceMode(IceMode mode) {
   remote_ice_mode_ = mode;
 }
 
+void P2PTransportChannel::SetIceMode(IceMode mode) {
+  RTC_DCHECK(network_thread_ == rtc::Thread::Current());
+  if (ice_mode_ == mode) {
+    return;
+  }
+  RTC_LOG(LS_INFO) << ToString() << ": Using "
+                   << (mode == ICEMODE_LITE ? "ICE-lite" : "full ICE");
+  ice_mode_ = mode;
+  RequestSortAndStateUpdate("ICE mode changed");
+}
+
 // TODO(qingsi): We apply the convention that setting a rtc::Optional parameter
 // to null restores its default value in the implementation. However, some
 // rtc::Optional parameters are only processed below if non-null, e.g.,
@@ -462,6 +475,15 @@ void P2PTransportChannel::SetIceConfig(const IceConfig& config) {
         << config_.stable_writable_connection_ping_interval_or_default();
   }
 
+  if (config_.media_active_connection_ping_interval !=
+      config.media_active_connection_ping_interval) {
+    config_.media_active_connection_ping_interval =
+        config.media_active_connection_ping_interval;
+    RTC_LOG(LS_INFO)
+        << "Set media_active_connection_ping_interval to "
+        << config_.media_active_connection_ping_interval_or_default();
+  }
+
   if (config_.presume_writable_when_fully_relayed !=
       config.presume_writable_when_fully_relayed) {
     if (!connections_.empty()) {
@@ -618,6 +640,14 @@ RTCError P2PTransportChannel::ValidateIceConfig(const IceConfig& config) {
                     "strongly connected");
   }
 
+  if (config.media_active_connection_ping_interval_or_default() <
+      config.stable_writable_connection_ping_interval_or_default()) {
+    return RTCError(RTCErrorType::INVALID_PARAMETER,
+                    "Ping interval of candidate pairs receiving media is "
+                    "shorter than that of stable and writable candidate "
+                    "pairs");
+  }
+
   if (config.ice_unwritable_timeout_or_default() > CONNECTION_WRITE_TIMEOUT) {
     return RTCError(RTCErrorType::INVALID_PARAMETER,
                     "The timeout period for the writability state to become "
@@ -691,6 +721,12 @@ void P2PTransportChannel::MaybeStartGathering() {
       AddAllocatorSession(allocator_->CreateSession(
           transport_name(), component(), ice_parameters_.ufrag,
           ice_parameters_.pwd));
+      if (ice_mode_ == ICEMODE_LITE) {
+        // An ICE-lite agent only has host candidates.
+        PortAllocatorSession* session = allocator_sessions_.back().get();
+        session->set_flags(session->flags() | PORTALLOCATOR_DISABLE_STUN |
+                           PORTALLOCATOR_DISABLE_RELAY);
+      }
       allocator_sessions_.back()->StartGettingPorts();
     }
   }
@@ -1053,6 +1089,12 @@ bool P2PTransportChannel::CreateConnection(PortInterface* port,
   if (!port->SupportsProtocol(remote_candidate.protocol())) {
     return false;
   }
+  // An ICE-lite agent doesn't send checks, so a connection to a signaled
+  // candidate would be of no use until the remote agent checks it, and then
+  // OnUnknownAddress() creates it.
+  if (ice_mode_ == ICEMODE_LITE && !origin_port) {
+    return false;
+  }
   // Look for an existing connection with this remote address.  If one is not
   // found or it is found but the existing remote candidate has an older
   // generation, then we can create a new connection for this address.
@@ -1219,6 +1261,34 @@ int P2PTransportChannel::SendPacket(const char *data, size_t len,
   return sent;
 }
 
+int P2PTransportChannel::SendPackets(rtc::OutgoingPacket* packets,
+                                     size_t count,
+                                     int flags) {
+  RTC_DCHECK(network_thread_ == rtc::Thread::Current());
+  if (flags != 0) {
+    error_ = EINVAL;
+    return -1;
+  }
+  if (!ReadyToSend(selected_connection_)) {
+    error_ = ENOTCONN;
+    return -1;
+  }
+  if (count == 0)
+    return 0;
+
+  last_sent_packet_id_ = packets[count - 1].options.packet_id;
+  for (size_t i = 0; i < count; ++i) {
+    packets[i].options.info_signaled_after_sent.packet_type =
+        rtc::PacketType::kData;
+  }
+  int sent = selected_connection_->SendBatch(packets, count);
+  if (sent <= 0) {
+    RTC_DCHECK(sent < 0);
+    error_ = selected_connection_->GetError();
+  }
+  return sent;
+}
+
 bool P2PTransportChannel::GetStats(ConnectionInfos* candidate_pair_stats_list,
                                    CandidateStatsList* candidate_stats_list) {
   RTC_DCHECK(network_thread_ == rtc::Thread::Current());
@@ -1282,15 +1352,22 @@ void P2PTransportChannel::MaybeStartPinging() {
   }
 
   int64_t now = rtc::TimeMillis();
-  if (std::any_of(
+  // An ICE-lite agent doesn't ping, but updates the connection states as
+  // soon as it has a connection.
+  if ((ice_mode_ == ICEMODE_LITE && !connections_.empty()) ||
+      std::any_of(
           connections_.begin(), connections_.end(),
           [this, now](const Connection* c) { return IsPingable(c, now); })) {
     RTC_LOG(LS_INFO) << ToString()
                      << ": Have a pingable connection for the first time; "
                         "starting to ping.";
-    invoker_.AsyncInvoke<void>(
-        RTC_FROM_HERE, thread(),
-        rtc::Bind(&P2PTransportChannel::CheckAndPing, this));
+    ScheduleCheckAndPing(0);
+    started_pinging_ = true;
+    if (ice_mode_ == ICEMODE_LITE) {
+      // There are only host candidates, and no pings that could detect failed
+      // networks to regather on.
+      return;
+    }
     invoker_.AsyncInvokeDelayed<void>(
         RTC_FROM_HERE, thread(),
         rtc::Bind(&P2PTransportChannel::RegatherOnFailedNetworks, this),
@@ -1301,7 +1378,6 @@ void P2PTransportChannel::MaybeStartPinging() {
           rtc::Bind(&P2PTransportChannel::RegatherOnAllNetworks, this),
           SampleRegatherAllNetworksInterval());
     }
-    started_pinging_ = true;
   }
 }
 
@@ -1500,6 +1576,12 @@ int P2PTransportChannel::CompareConnections(
 }
 
 bool P2PTransportChannel::PresumedWritable(const Connection* conn) const {
+  if (ice_mode_ == ICEMODE_LITE) {
+    // An ICE-lite agent never pings, so its connections are considered
+    // writable as long as the remote agent's checks keep arriving.
+    return conn->write_state() == Connection::STATE_WRITE_INIT &&
+           conn->receiving();
+  }
   return (conn->write_state() == Connection::STATE_WRITE_INIT &&
           config_.presume_writable_when_fully_relayed &&
           conn->local_candidate().type() == RELAY_PORT_TYPE &&
@@ -1525,15 +1607,19 @@ void P2PTransportChannel::SortConnectionsAndUpdateState(
   // one whose estimated latency is lowest.  So it is the only one that we
   // need to consider switching to.
   // TODO(honghaiz): Don't sort;  Just use std::max_element in the right places.
-  std::stable_sort(connections_.begin(), connections_.end(),
-                   [this](const Connection* a, const Connection* b) {
-                     int cmp = CompareConnections(a, b, rtc::nullopt, nullptr);
-                     if (cmp != 0) {
-                       return cmp > 0;
-                     }
-                     // Otherwise, sort based on latency estimate.
-                     return a->rtt() < b->rtt();
-                   });
+  auto is_better = [this](const Connection* a, const Connection* b) {
+    int cmp = CompareConnections(a, b, rtc::nullopt, nullptr);
+    if (cmp != 0) {
+      return cmp > 0;
+    }
+    // Otherwise, sort based on latency estimate.
+    return a->rtt() < b->rtt();
+  };
+  // Most state changes don't change the order, which takes a linear number of
+  // comparisons to verify rather than the O(n log n) of sorting.
+  if (!std::is_sorted(connections_.begin(), connections_.end(), is_better)) {
+    std::stable_sort(connections_.begin(), connections_.end(), is_better);
+  }
 
   RTC_LOG(LS_VERBOSE) << "Sorting " << connections_.size()
                       << " available connections";
@@ -1816,6 +1902,11 @@ void P2PTransportChannel::CheckAndPing() {
   // Make sure the states of the connections are up-to-date (since this affects
   // which ones are pingable).
   UpdateConnectionStates();
+  if (ice_mode_ == ICEMODE_LITE) {
+    // Only the receiving states need updating.
+    ScheduleCheckAndPing(check_receiving_interval());
+    return;
+  }
   // When the selected connection is not receiving or not writable, or any
   // active connection has not been pinged enough times, use the weak ping
   // interval.
@@ -1835,9 +1926,90 @@ void P2PTransportChannel::CheckAndPing() {
     }
   }
   int delay = std::min(ping_interval, check_receiving_interval());
+  if (!weak() && !need_more_pings_at_weak_interval) {
+    // Nothing may need attention for a while on a strongly connected channel,
+    // e.g. when all connections are stable and have been pinged recently.
+    int64_t now = rtc::TimeMillis();
+    int idle_delay = CalculateIdleCheckAndPingDelay(ping_interval, now);
+    if (idle_delay > delay) {
+      int64_t wake_up_ms = now + idle_delay + CHECK_AND_PING_TICK_INTERVAL - 1;
+      wake_up_ms -= wake_up_ms % CHECK_AND_PING_TICK_INTERVAL;
+      delay = static_cast<int>(wake_up_ms - now);
+    }
+  }
+  ScheduleCheckAndPing(delay);
+}
+
+void P2PTransportChannel::ScheduleCheckAndPing(int delay) {
+  int64_t deadline_ms = rtc::TimeMillis() + delay;
+  if (check_and_ping_deadline_ms_ != 0 &&
+      check_and_ping_deadline_ms_ <= deadline_ms) {
+    return;
+  }
+  // A check scheduled for later is superseded; it is ignored when it fires.
+  check_and_ping_deadline_ms_ = deadline_ms;
   invoker_.AsyncInvokeDelayed<void>(
       RTC_FROM_HERE, thread(),
-      rtc::Bind(&P2PTransportChannel::CheckAndPing, this), delay);
+      rtc::Bind(&P2PTransportChannel::OnCheckAndPingTimer, this, deadline_ms),
+      delay);
+}
+
+void P2PTransportChannel::OnCheckAndPingTimer(int64_t deadline_ms) {
+  if (deadline_ms != check_and_ping_deadline_ms_) {
+    return;
+  }
+  check_and_ping_deadline_ms_ = 0;
+  CheckAndPing();
+}
+
+void P2PTransportChannel::WakeUpCheckAndPing() {
+  // A channel that is not idle is already checked at least this often, so
+  // this only shortens the wait of an idle one.
+  if (started_pinging_) {
+    ScheduleCheckAndPing(
+        std::min(strong_ping_interval(), check_receiving_interval()));
+  }
+}
+
+int P2PTransportChannel::CalculateIdleCheckAndPingDelay(int ping_interval,
+                                                        int64_t now) const {
+  // The stable ping interval also bounds how late connections that have died
+  // are cleaned up.
+  int64_t next_ms =
+      now + config_.stable_writable_connection_ping_interval_or_default();
+  for (const Connection* conn : connections_) {
+    // Unanswered pings need regular state updates, so that a connection that
+    // stops responding becomes unwritable without delay.
+    if (conn->write_state() != Connection::STATE_WRITE_TIMEOUT &&
+        conn->last_ping_sent() > conn->last_ping_response_received()) {
+      return 0;
+    }
+    // Between a ping response and the next ping, a connection is receiving
+    // regardless of incoming packets. Otherwise it stops receiving once
+    // nothing, media included, arrived within the receiving timeout.
+    if (conn->receiving() &&
+        conn->last_ping_sent() == conn->last_ping_response_received()) {
+      next_ms = std::min(next_ms,
+                         conn->last_received() + conn->receiving_timeout() + 1);
+    }
+
+    if (IsPingable(conn, now)) {
+      // Pings are spaced by |ping_interval| across all connections.
+      next_ms = std::min(next_ms, last_ping_sent_ms_ + ping_interval);
+    } else if (conn->state() != IceCandidatePairState::FAILED &&
+               (conn->connected() || conn->writable())) {
+      if (IsBackupConnection(conn)) {
+        next_ms = std::min(
+            next_ms, conn->last_ping_response_received() +
+                         config_.backup_connection_ping_interval_or_default());
+      } else if (conn->active()) {
+        next_ms = std::min(next_ms,
+                           conn->last_ping_sent() +
+                               CalculateActiveWritablePingInterval(conn, now));
+      }
+    }
+  }
+  return static_cast<int>(std::max<int64_t>(0, next_ms - now));
 }
 
 // A connection is considered a backup connection if the channel state
@@ -1921,8 +2093,15 @@ int P2PTransportChannel::CalculateActiveWritablePingInterval(
       stable_interval, WEAK_OR_STABILIZING_WRITABLE_CONNECTION_PING_INTERVAL);
   // If the channel is weak or the connection is not stable yet, use the
   // weak_or_stablizing_interval.
-  return (!weak() && conn->stable(now)) ? stable_interval
-                                        : weak_or_stablizing_interval;
+  if (weak() || !conn->stable(now)) {
+    return weak_or_stablizing_interval;
+  }
+  // Incoming media shows that a stable connection is still alive.
+  if (conn->last_data_received() > 0 &&
+      now <= conn->last_data_received() + conn->receiving_timeout()) {
+    return config_.media_active_connection_ping_interval_or_default();
+  }
+  return stable_interval;
 }
 
 // Returns the next pingable connection to ping.
@@ -1980,34 +2159,43 @@ Connection* P2PTransportChannel::FindNextPingableConnection() {
   // Otherwise, treat everything as unpinged.
   // TODO(honghaiz): Instead of adding two separate vectors, we can add a state
   // "pinged" to filter out unpinged connections.
-  if (std::find_if(unpinged_connections_.begin(), unpinged_connections_.end(),
-                   [this, now](Connection* conn) {
-                     return this->IsPingable(conn, now);
-                   }) == unpinged_connections_.end()) {
+  auto is_pingable = [this, now](Connection* conn) {
+    return IsPingable(conn, now);
+  };
+  std::vector<Connection*> pingable_connections;
+  std::copy_if(unpinged_connections_.begin(), unpinged_connections_.end(),
+               std::back_inserter(pingable_connections), is_pingable);
+  if (pingable_connections.empty()) {
     unpinged_connections_.insert(pinged_connections_.begin(),
                                  pinged_connections_.end());
     pinged_connections_.clear();
+    std::copy_if(unpinged_connections_.begin(), unpinged_connections_.end(),
+                 std::back_inserter(pingable_connections), is_pingable);
+  }
+  if (pingable_connections.empty()) {
+    return nullptr;
   }
 
   // Among un-pinged pingable connections, "more pingable" takes precedence.
-  std::vector<Connection*> pingable_connections;
-  std::copy_if(unpinged_connections_.begin(), unpinged_connections_.end(),
-               std::back_inserter(pingable_connections),
-               [this, now](Connection* conn) { return IsPingable(conn, now); });
-  auto iter =
-      std::max_element(pingable_connections.begin(), pingable_connections.end(),
-                       [this](Connection* conn1, Connection* conn2) {
-                         // Some implementations of max_element compare an
-                         // element with itself.
-                         if (conn1 == conn2) {
-                           return false;
-                         }
-                         return MorePingable(conn1, conn2) == conn2;
-                       });
-  if (iter != pingable_connections.end()) {
-    return *iter;
+  // Without a preference, the one that comes first in the ordered
+  // |connections_| is pinged. The positions are looked up once, since there is
+  // no preference between any two connections before the first pings.
+  std::unordered_map<Connection*, size_t> positions;
+  if (pingable_connections.size() > 1) {
+    for (size_t i = 0; i < connections_.size(); ++i) {
+      positions[connections_[i]] = i;
+    }
   }
-  return nullptr;
+  Connection* most_pingable = pingable_connections[0];
+  for (size_t i = 1; i < pingable_connections.size(); ++i) {
+    Connection* conn = pingable_connections[i];
+    Connection* more_pingable = MorePingable(most_pingable, conn);
+    if (more_pingable == conn ||
+        (!more_pingable && positions[conn] < positions[most_pingable])) {
+      most_pingable = conn;
+    }
+  }
+  return most_pingable;
 }
 
 void P2PTransportChannel::MarkConnectionPinged(Connection* conn) {
@@ -2101,6 +2289,7 @@ void P2PTransportChannel::OnConnectionStateChange(Connection* connection) {
   // We have to unroll the stack before doing this because we may be changing
   // the state of connections while sorting.
   RequestSortAndStateUpdate("candidate pair state changed");
+  WakeUpCheckAndPing();
 }
 
 // When a connection is removed, edit it out, and then update our best
@@ -2163,6 +2352,25 @@ void P2PTransportChannel::OnPortsPruned(
                     << ports_.size() << " remaining";
     }
   }
+  FailConnectionsOnInactiveNetworks(ports);
+}
+
+void P2PTransportChannel::FailConnectionsOnInactiveNetworks(
+    const std::vector<PortInterface*>& ports) {
+  // A port whose network has gone away (e.g. on a Wi-Fi to cellular handover)
+  // can no longer send or receive. Fail its connections right away instead of
+  // waiting for them to time out; the resulting state change lets a backup
+  // connection on another network take over without a media gap.
+  for (Connection* conn : connections_) {
+    if (conn->port()->Network()->active() ||
+        conn->state() == IceCandidatePairState::FAILED ||
+        std::find(ports.begin(), ports.end(), conn->port()) == ports.end()) {
+      continue;
+    }
+    RTC_LOG(LS_INFO) << ToString() << ": Failing connection "
+                     << conn->ToString() << " because its network is gone";
+    conn->FailAndPrune();
+  }
 }
 
 void P2PTransportChannel::OnCandidatesRemoved(
@@ -2232,16 +2440,21 @@ void P2PTransportChannel::OnReadPacket(Connection* connection,
                                        const rtc::PacketTime& packet_time) {
   RTC_DCHECK(network_thread_ == rtc::Thread::Current());
 
+  // Nearly all packets arrive on the selected connection, which is always one
+  // of |connections_|, so only the others need to be looked up there.
+  const bool on_selected_connection = connection == selected_connection_;
+
   // Do not deliver, if packet doesn't belong to the correct transport channel.
-  if (!FindConnection(connection))
+  if (!on_selected_connection && !FindConnection(connection))
     return;
 
   // Let the client know of an incoming packet
   SignalReadPacket(this, data, len, packet_time, 0);
 
   // May need to switch the sending connection based on the receiving media path
-  // if this is the controlled side.
-  if (ice_role_ == ICEROLE_CONTROLLED) {
+  // if this is the controlled side. There's nothing to switch to when the
+  // packet came on the selected connection.
+  if (ice_role_ == ICEROLE_CONTROLLED && !on_selected_connection) {
     MaybeSwitchSelectedConnection(connection, "data received");
   }
 }
@@ -2328,17 +2541,7 @@ Connection* P2PTransportChannel::MorePingable(Connection* conn1,
     }
   }
 
-  Connection* least_recently_pinged_conn = LeastRecentlyPinged(conn1, conn2);
-  if (least_recently_pinged_conn) {
-    return least_recently_pinged_conn;
-  }
-
-  // During the initial state when nothing has been pinged yet, return the first
-  // one in the ordered |connections_|.
-  return *(std::find_if(connections_.begin(), connections_.end(),
-                        [conn1, conn2](Connection* conn) {
-                          return conn == conn1 || conn == conn2;
-                        }));
+  return LeastRecentlyPinged(conn1, conn2);
 }
 
 void P2PTransportChannel::set_writable(bool writable) {
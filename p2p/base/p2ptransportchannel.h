@@ -54,6 +54,11 @@ enum class IceRestartState { CONNECTING, CONNECTED, DISCONNECTED, MAX_VALUE };
 
 static const int MIN_PINGS_AT_WEAK_PING_INTERVAL = 3;
 
+// When a strongly connected channel has nothing to do for longer than its
+// regular check interval, the wake-up time is rounded up to a multiple of this
+// interval so that the idle channels on a thread are checked in shared ticks.
+static const int CHECK_AND_PING_TICK_INTERVAL = 100;
+
 bool IceCredentialsChanged(const std::string& old_ufrag,
                            const std::string& old_pwd,
                            const std::string& new_ufrag,
@@ -93,6 +98,12 @@ class P2PTransportChannel : public IceTransportInternal {
   void SetIceParameters(const IceParameters& ice_params) override;
   void SetRemoteIceParameters(const IceParameters& ice_params) override;
   void SetRemoteIceMode(IceMode mode) override;
+  // In ICE-lite mode, the channel gathers only host candidates and never
+  // sends connectivity checks. It creates connections only for the checks
+  // it receives, treats a connection as writable while it receives checks,
+  // and selects the connection the controlling agent nominates. It only wakes
+  // up to update the connection states.
+  void SetIceMode(IceMode mode) override;
   // TODO(deadbeef): Deprecated. Remove when Chromium's
   // IceTransportChannel does not depend on this.
   void Connect() {}
@@ -115,6 +126,10 @@ class P2PTransportChannel : public IceTransportInternal {
                  size_t len,
                  const rtc::PacketOptions& options,
                  int flags) override;
+  // Sends the whole batch over the selected connection.
+  int SendPackets(rtc::OutgoingPacket* packets,
+                  size_t count,
+                  int flags) override;
   int SetOption(rtc::Socket::Option opt, int value) override;
   bool GetOption(rtc::Socket::Option opt, int* value) override;
   int GetError() override;
@@ -134,6 +149,7 @@ class P2PTransportChannel : public IceTransportInternal {
   const std::vector<PortInterface*>& ports() { return ports_; }
   const std::vector<PortInterface*>& pruned_ports() { return pruned_ports_; }
 
+  IceMode ice_mode() const { return ice_mode_; }
   IceMode remote_ice_mode() const { return remote_ice_mode_; }
 
   void PruneAllPorts();
@@ -259,6 +275,9 @@ class P2PTransportChannel : public IceTransportInternal {
   void OnPortReady(PortAllocatorSession *session, PortInterface* port);
   void OnPortsPruned(PortAllocatorSession* session,
                      const std::vector<PortInterface*>& ports);
+  // Fails the connections on |ports| whose network is no longer active.
+  void FailConnectionsOnInactiveNetworks(
+      const std::vector<PortInterface*>& ports);
   void OnCandidatesReady(PortAllocatorSession *session,
                          const std::vector<Candidate>& candidates);
   void OnCandidatesRemoved(PortAllocatorSession* session,
@@ -289,6 +308,16 @@ class P2PTransportChannel : public IceTransportInternal {
   void OnNominated(Connection* conn);
 
   void CheckAndPing();
+  // Runs CheckAndPing() after |delay| ms, unless a check is already scheduled
+  // to run sooner.
+  void ScheduleCheckAndPing(int delay);
+  void OnCheckAndPingTimer(int64_t deadline_ms);
+  // Brings a long-delayed check forward when the connections change.
+  void WakeUpCheckAndPing();
+  // Returns how long a strongly connected channel can wait before it has to
+  // update connection states or send a ping, or 0 if it has to do so within
+  // the regular check interval.
+  int CalculateIdleCheckAndPingDelay(int ping_interval, int64_t now) const;
   void RegatherOnFailedNetworks();
   void RegatherOnAllNetworks();
 
@@ -316,7 +345,7 @@ class P2PTransportChannel : public IceTransportInternal {
 
   Connection* FindOldestConnectionNeedingTriggeredCheck(int64_t now);
   // Between |conn1| and |conn2|, this function returns the one which should
-  // be pinged first.
+  // be pinged first, or nullptr if there is no preference.
   Connection* MorePingable(Connection* conn1, Connection* conn2);
   // Select the connection which is Relay/Relay. If both of them are,
   // UDP relay protocol takes precedence.
@@ -391,6 +420,7 @@ class P2PTransportChannel : public IceTransportInternal {
   OptionMap options_;
   IceParameters ice_parameters_;
   std::vector<IceParameters> remote_ice_parameters_;
+  IceMode ice_mode_ = ICEMODE_FULL;
   IceMode remote_ice_mode_;
   IceRole ice_role_;
   uint64_t tiebreaker_;
@@ -405,6 +435,8 @@ class P2PTransportChannel : public IceTransportInternal {
   IceConfig config_;
   int last_sent_packet_id_ = -1;  // -1 indicates no packet was sent before.
   bool started_pinging_ = false;
+  // Time at which the next CheckAndPing() is scheduled, or 0 if none is.
+  int64_t check_and_ping_deadline_ms_ = 0;
   // The value put in the "nomination" attribute for the next nominated
   // connection. A zero-value indicates the connection will not be nominated.
   uint32_t nomination_ = 0;
@@ -1214,6 +1214,46 @@ TEST_F(P2PTransportChannelTest, GetStats) {
   DestroyChannels();
 }
 
+// Tests that a batch of packets is sent over the selected connection and
+// counted in its stats.
+TEST_F(P2PTransportChannelTest, SendPacketsSendsBatch) {
+  rtc::ScopedFakeClock clock;
+  ConfigureEndpoints(OPEN, OPEN, kDefaultPortAllocatorFlags,
+                     kDefaultPortAllocatorFlags);
+  CreateChannels();
+  EXPECT_TRUE_SIMULATED_WAIT(ep1_ch1()->receiving() && ep1_ch1()->writable() &&
+                                 ep2_ch1()->receiving() &&
+                                 ep2_ch1()->writable(),
+                             kMediumTimeout, clock);
+  const char* data = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234567890";
+  const size_t len = strlen(data);
+  rtc::OutgoingPacket packets[3];
+  for (rtc::OutgoingPacket& packet : packets) {
+    packet.data = data;
+    packet.size = len;
+  }
+  EXPECT_EQ(3, ep1_ch1()->SendPackets(packets, 3, 0));
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_TRUE_SIMULATED_WAIT(
+        CheckDataOnChannel(ep2_ch1(), data, static_cast<int>(len)),
+        kMediumTimeout, clock);
+  }
+
+  ConnectionInfos infos;
+  CandidateStatsList candidate_stats_list;
+  ASSERT_TRUE(ep1_ch1()->GetStats(&infos, &candidate_stats_list));
+  const ConnectionInfo* best_conn_info = nullptr;
+  for (const ConnectionInfo& info : infos) {
+    if (info.best_connection)
+      best_conn_info = &info;
+  }
+  ASSERT_TRUE(best_conn_info != nullptr);
+  EXPECT_EQ(3U, best_conn_info->sent_total_packets);
+  EXPECT_EQ(0U, best_conn_info->sent_discarded_packets);
+  EXPECT_EQ(3 * len, best_conn_info->sent_total_bytes);
+  DestroyChannels();
+}
+
 // Tests that UMAs are recorded when ICE restarts while the channel
 // is disconnected.
 TEST_F(P2PTransportChannelTest, TestUMAIceRestartWhileDisconnected) {
@@ -3101,6 +3141,48 @@ TEST_F(P2PTransportChannelMultihomedTest, TestRestoreBackupConnection) {
   DestroyChannels();
 }
 
+// Tests that when the network of the selected connection goes away, the
+// connections on it are failed right away and the backup connection on the
+// other network is selected without waiting for the connections to time out.
+TEST_F(P2PTransportChannelMultihomedTest,
+       TestSwitchToBackupConnectionWhenNetworkGone) {
+  rtc::ScopedFakeClock clock;
+  auto& wifi = kAlternateAddrs;
+  auto& cellular = kPublicAddrs;
+  AddAddress(0, wifi[0], "test_wifi0", rtc::ADAPTER_TYPE_WIFI);
+  AddAddress(0, cellular[0], "test_cell0", rtc::ADAPTER_TYPE_CELLULAR);
+  AddAddress(1, wifi[1], "test_wifi1", rtc::ADAPTER_TYPE_WIFI);
+  // Use only local ports for simplicity.
+  SetAllocatorFlags(0, kOnlyLocalPorts);
+  SetAllocatorFlags(1, kOnlyLocalPorts);
+
+  IceConfig config = CreateIceConfig(1000, GATHER_CONTINUALLY);
+  CreateChannels(config, config);
+  EXPECT_TRUE_SIMULATED_WAIT(ep1_ch1()->receiving() && ep1_ch1()->writable() &&
+                                 ep2_ch1()->receiving() &&
+                                 ep2_ch1()->writable(),
+                             kMediumTimeout, clock);
+  EXPECT_TRUE(ep1_ch1()->selected_connection() &&
+              LocalCandidate(ep1_ch1())->address().EqualIPs(wifi[0]));
+  const Connection* backup;
+  EXPECT_TRUE_SIMULATED_WAIT(
+      (backup = GetConnectionWithLocalAddress(ep1_ch1(), cellular[0])) !=
+              nullptr &&
+          backup->writable(),
+      kDefaultTimeout, clock);
+
+  // The Wi-Fi interface goes away. Connections would otherwise only be
+  // replaced after the receiving timeout has passed.
+  RemoveAddress(0, wifi[0]);
+  const int kSwitchTimeoutMs = 100;
+  EXPECT_TRUE_SIMULATED_WAIT(
+      ep1_ch1()->selected_connection() &&
+          LocalCandidate(ep1_ch1())->address().EqualIPs(cellular[0]),
+      kSwitchTimeoutMs, clock);
+
+  DestroyChannels();
+}
+
 // A collection of tests which tests a single P2PTransportChannel by sending
 // pings.
 class P2PTransportChannelPingTest : public testing::Test,
@@ -3410,6 +3492,66 @@ TEST_F(P2PTransportChannelPingTest, TestStunPingIntervals) {
       WEAK_OR_STABILIZING_WRITABLE_CONNECTION_PING_INTERVAL + SCHEDULING_RANGE);
 }
 
+// Verify that a stable connection that is receiving media is pinged at the
+// media active interval, and at the stable interval once the media stops.
+TEST_F(P2PTransportChannelPingTest, TestMediaActiveConnectionPingInterval) {
+  rtc::ScopedFakeClock clock;
+  const int kMediaActivePingInterval = 6000;
+  const int kMediaInterval = 500;
+  int RTT_RATIO = 4;
+  int SCHEDULING_RANGE = 200;
+
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch("TestChannel", 1, &pa);
+  IceConfig config = ch.config();
+  config.media_active_connection_ping_interval = kMediaActivePingInterval;
+  ch.SetIceConfig(config);
+  PrepareChannel(&ch);
+  ch.MaybeStartGathering();
+  ch.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", 1, 1));
+  Connection* conn = WaitForConnectionTo(&ch, "1.1.1.1", 1);
+  ASSERT_TRUE(conn != nullptr);
+  SIMULATED_WAIT(conn->num_pings_sent() >= MIN_PINGS_AT_WEAK_PING_INTERVAL,
+                 kDefaultTimeout, clock);
+
+  // Make the connection writable and stable.
+  for (int i = 0; i <= RTT_RATIO; i++) {
+    conn->ReceivedPingResponse(LOW_RTT, "id");
+  }
+  int ping_sent_before = conn->num_pings_sent();
+  SIMULATED_WAIT(conn->num_pings_sent() == ping_sent_before + 1, kMediumTimeout,
+                 clock);
+  conn->ReceivedPingResponse(LOW_RTT, "id");
+  ASSERT_TRUE(conn->stable(rtc::TimeMillis()));
+
+  // Media keeps arriving, so the next ping is sent only after the media
+  // active interval.
+  ping_sent_before = conn->num_pings_sent();
+  int64_t start = rtc::TimeMillis();
+  while (conn->num_pings_sent() == ping_sent_before &&
+         rtc::TimeMillis() - start < 2 * kMediaActivePingInterval) {
+    conn->OnReadPacket("ABC", 3, rtc::CreatePacketTime(0));
+    SIMULATED_WAIT(conn->num_pings_sent() > ping_sent_before, kMediaInterval,
+                   clock);
+  }
+  int64_t ping_interval_ms = rtc::TimeMillis() - start;
+  EXPECT_GE(ping_interval_ms, kMediaActivePingInterval - kMediaInterval);
+  EXPECT_LE(ping_interval_ms, kMediaActivePingInterval + SCHEDULING_RANGE);
+  conn->ReceivedPingResponse(LOW_RTT, "id");
+
+  // Without media, the connection is pinged at the stable interval again.
+  ping_sent_before = conn->num_pings_sent();
+  start = rtc::TimeMillis();
+  SIMULATED_WAIT(conn->num_pings_sent() == ping_sent_before + 1,
+                 2 * kMediaActivePingInterval, clock);
+  ping_interval_ms = rtc::TimeMillis() - start;
+  EXPECT_GE(ping_interval_ms,
+            STRONG_AND_STABLE_WRITABLE_CONNECTION_PING_INTERVAL);
+  EXPECT_LE(
+      ping_interval_ms,
+      STRONG_AND_STABLE_WRITABLE_CONNECTION_PING_INTERVAL + SCHEDULING_RANGE);
+}
+
 // Test that we start pinging as soon as we have a connection and remote ICE
 // parameters.
 TEST_F(P2PTransportChannelPingTest, PingingStartedAsSoonAsPossible) {
@@ -3806,6 +3948,45 @@ TEST_F(P2PTransportChannelPingTest, TestSelectConnectionFromUnknownAddress) {
   EXPECT_EQ(kIcePwd[2], conn5->remote_candidate().password());
 }
 
+// An ICE-lite channel creates connections only for the checks it receives,
+// never pings, and is writable while the checks keep arriving.
+TEST_F(P2PTransportChannelPingTest, TestIceLiteOnlyAnswersChecks) {
+  rtc::ScopedFakeClock clock;
+  FakePortAllocator pa(rtc::Thread::Current(), nullptr);
+  P2PTransportChannel ch("ice lite", 1, &pa);
+  PrepareChannel(&ch);
+  ch.SetIceRole(ICEROLE_CONTROLLED);
+  ch.SetIceMode(ICEMODE_LITE);
+  EXPECT_EQ(ICEMODE_LITE, ch.ice_mode());
+  ch.MaybeStartGathering();
+  ch.AddRemoteCandidate(CreateUdpCandidate(LOCAL_PORT_TYPE, "1.1.1.1", 1, 1));
+  SIMULATED_WAIT(false, kShortTimeout, clock);
+  EXPECT_TRUE(ch.connections().empty());
+
+  IceMessage request;
+  request.SetType(STUN_BINDING_REQUEST);
+  request.AddAttribute(rtc::MakeUnique<StunByteStringAttribute>(
+      STUN_ATTR_USERNAME, kIceUfrag[1]));
+  request.AddAttribute(
+      rtc::MakeUnique<StunUInt32Attribute>(STUN_ATTR_PRIORITY, 1U));
+  request.AddAttribute(
+      rtc::MakeUnique<StunByteStringAttribute>(STUN_ATTR_USE_CANDIDATE));
+  TestUDPPort* port = static_cast<TestUDPPort*>(GetPort(&ch));
+  port->SignalUnknownAddress(port, rtc::SocketAddress("1.1.1.1", 1), PROTO_UDP,
+                             &request, kIceUfrag[1], false);
+  Connection* conn = WaitForConnectionTo(&ch, "1.1.1.1", 1, &clock);
+  ASSERT_TRUE(conn != nullptr);
+  EXPECT_EQ_SIMULATED_WAIT(conn, ch.selected_connection(), kShortTimeout,
+                           clock);
+  EXPECT_TRUE(ch.writable());
+  EXPECT_TRUE(channel_ready_to_send());
+
+  // Without checks, the connection stops receiving and so being writable.
+  EXPECT_TRUE_SIMULATED_WAIT(!ch.writable(), kDefaultTimeout, clock);
+  EXPECT_EQ(0, conn->num_pings_sent());
+  EXPECT_EQ(1u, ch.connections().size());
+}
+
 // The controlled side will select a connection as the "selected connection"
 // based on media received until the controlling side nominates a connection,
 // at which point the controlled side will select that connection as
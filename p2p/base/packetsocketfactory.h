@@ -84,6 +84,13 @@ class PacketSocketFactory {
 
   virtual AsyncResolverInterface* CreateAsyncResolver() = 0;
 
+  // Tells the factory that the UDP |socket| it created is used by an ICE port
+  // with the username fragment |ice_ufrag|. Called again when the port's ufrag
+  // changes. Factories that share one socket among many ports use this to
+  // route incoming connectivity checks; by default it does nothing.
+  virtual void SetUdpSocketIceUfrag(AsyncPacketSocket* socket,
+                                    const std::string& ice_ufrag) {}
+
  private:
   RTC_DISALLOW_COPY_AND_ASSIGN(PacketSocketFactory);
 };
@@ -20,6 +20,23 @@ PacketTransportInternal* PacketTransportInternal::GetInternal() {
   return this;
 }
 
+int PacketTransportInternal::SendPackets(rtc::OutgoingPacket* packets,
+                                         size_t count,
+                                         int flags) {
+  size_t sent = 0;
+  int last_result = 0;
+  for (; sent < count; ++sent) {
+    const rtc::OutgoingPacket& packet = packets[sent];
+    last_result = SendPacket(static_cast<const char*>(packet.data), packet.size,
+                             packet.options, flags);
+    if (last_result < 0)
+      break;
+  }
+  if (sent == 0 && count > 0)
+    return last_result;
+  return static_cast<int>(sent);
+}
+
 bool PacketTransportInternal::GetOption(rtc::Socket::Option opt, int* value) {
   return false;
 }
@@ -53,6 +53,17 @@ class PacketTransportInternal : public virtual webrtc::PacketTransportInterface,
                          const rtc::PacketOptions& options,
                          int flags = 0) = 0;
 
+  // Sends |count| packets, |options| and |flags| applying as in SendPacket().
+  // Implementations may overwrite the |addr| of the packets, which the caller
+  // doesn't need to set. Bookkeeping is done once per batch where possible,
+  // and a UDP socket underneath may send the whole batch in one system call.
+  // Returns the number of packets sent, which may be fewer than |count|, or
+  // a negative value if none could be sent. The default implementation calls
+  // SendPacket() for each packet.
+  virtual int SendPackets(rtc::OutgoingPacket* packets,
+                          size_t count,
+                          int flags = 0);
+
   // Sets a socket option. Note that not all options are
   // supported by all transport types.
   virtual int SetOption(rtc::Socket::Option opt, int value) = 0;
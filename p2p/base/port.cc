@@ -11,6 +11,7 @@
 #include "p2p/base/port.h"
 
 #include <math.h>
+#include <string.h>
 
 #include <algorithm>
 #include <utility>
@@ -18,6 +19,7 @@
 
 #include "p2p/base/portallocator.h"
 #include "rtc_base/base64.h"
+#include "rtc_base/byteorder.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/crc32.h"
 #include "rtc_base/helpers.h"
@@ -61,6 +63,14 @@ inline bool TooLongWithoutResponse(
   return now > (first.sent_time + maximum_time);
 }
 
+// Peeks at the message type before checking the FINGERPRINT, so that other
+// STUN messages don't pay for the CRC twice.
+bool IsStunBindingIndication(const char* data, size_t size) {
+  return size >= cricket::kStunHeaderSize &&
+         rtc::GetBE16(data) == cricket::STUN_BINDING_INDICATION &&
+         cricket::StunMessage::ValidateFingerprint(data, size);
+}
+
 // Helper methods for converting string values of log description fields to
 // enum.
 webrtc::IceCandidateType GetCandidateTypeByString(const std::string& type) {
@@ -382,6 +392,24 @@ void Port::SetIceParameters(int component,
     c.set_username(username_fragment);
     c.set_password(password);
   }
+  UpdateIceParametersInternal();
+}
+
+int Port::SendToBatch(rtc::OutgoingPacket* packets,
+                      size_t count,
+                      bool payload) {
+  size_t sent = 0;
+  int last_result = 0;
+  for (; sent < count; ++sent) {
+    const rtc::OutgoingPacket& packet = packets[sent];
+    last_result =
+        SendTo(packet.data, packet.size, packet.addr, packet.options, payload);
+    if (last_result < 0)
+      break;
+  }
+  if (sent == 0 && count > 0)
+    return last_result;
+  return static_cast<int>(sent);
 }
 
 const std::vector<Candidate>& Port::Candidates() const {
@@ -527,9 +555,6 @@ bool Port::GetStunMessage(const char* data,
                           const rtc::SocketAddress& addr,
                           std::unique_ptr<IceMessage>* out_msg,
                           std::string* out_username) {
-  // NOTE: This could clearly be optimized to avoid allocating any memory.
-  //       However, at the data rates we'll be looking at on the client side,
-  //       this probably isn't worth worrying about.
   RTC_DCHECK(out_msg != NULL);
   RTC_DCHECK(out_username != NULL);
   out_username->clear();
@@ -562,13 +587,21 @@ bool Port::GetStunMessage(const char* data,
     }
 
     // If the username is bad or unknown, fail with a 401 Unauthorized.
-    std::string local_ufrag;
-    std::string remote_ufrag;
-    if (!ParseStunUsername(stun_msg.get(), &local_ufrag, &remote_ufrag) ||
-        local_ufrag != username_fragment()) {
+    // The username is LFRAG:RFRAG; it is checked in place, since every
+    // connectivity check comes through here.
+    const StunByteStringAttribute* username_attr =
+        stun_msg->GetByteString(STUN_ATTR_USERNAME);
+    const char* username = username_attr->bytes();
+    const size_t username_length = username_attr->length();
+    const char* colon =
+        static_cast<const char*>(memchr(username, ':', username_length));
+    const std::string& local_ufrag = username_fragment();
+    if (!colon || static_cast<size_t>(colon - username) != local_ufrag.size() ||
+        memcmp(username, local_ufrag.data(), local_ufrag.size()) != 0) {
       RTC_LOG(LS_ERROR) << ToString()
                         << ": Received STUN request with bad local username "
-                        << local_ufrag << " from " << addr.ToSensitiveString();
+                        << std::string(username, colon ? colon - username : 0)
+                        << " from " << addr.ToSensitiveString();
       SendBindingErrorResponse(stun_msg.get(), addr, STUN_ERROR_UNAUTHORIZED,
                                STUN_ERROR_REASON_UNAUTHORIZED);
       return true;
@@ -584,7 +617,7 @@ bool Port::GetStunMessage(const char* data,
                                STUN_ERROR_REASON_UNAUTHORIZED);
       return true;
     }
-    out_username->assign(remote_ufrag);
+    out_username->assign(colon + 1, username + username_length - (colon + 1));
   } else if ((stun_msg->type() == STUN_BINDING_RESPONSE) ||
              (stun_msg->type() == STUN_BINDING_ERROR_RESPONSE)) {
     if (stun_msg->type() == STUN_BINDING_ERROR_RESPONSE) {
@@ -1194,6 +1227,20 @@ int Connection::receiving_timeout() const {
   return receiving_timeout_.value_or(WEAK_CONNECTION_RECEIVE_TIMEOUT);
 }
 
+int Connection::SendBatch(rtc::OutgoingPacket* packets, size_t count) {
+  size_t sent = 0;
+  int last_result = 0;
+  for (; sent < count; ++sent) {
+    const rtc::OutgoingPacket& packet = packets[sent];
+    last_result = Send(packet.data, packet.size, packet.options);
+    if (last_result < 0)
+      break;
+  }
+  if (sent == 0 && count > 0)
+    return last_result;
+  return static_cast<int>(sent);
+}
+
 void Connection::OnSendStunPacket(const void* data, size_t size,
                                   StunRequest* req) {
   rtc::PacketOptions options(port_->DefaultDscpValue());
@@ -1211,6 +1258,14 @@ void Connection::OnSendStunPacket(const void* data, size_t size,
 
 void Connection::OnReadPacket(
   const char* data, size_t size, const rtc::PacketTime& packet_time) {
+  // Binding indications (keepalives) carry nothing that needs verifying, so
+  // handle them from the wire without building an IceMessage.
+  if (IsStunBindingIndication(data, size)) {
+    RTC_LOG(LS_VERBOSE) << ToString() << ": Received STUN binding indication";
+    ReceivedPing();
+    return;
+  }
+
   std::unique_ptr<IceMessage> msg;
   std::string remote_ufrag;
   const rtc::SocketAddress& addr(remote_candidate_.address());
@@ -1894,6 +1949,28 @@ int ProxyConnection::Send(const void* data, size_t size,
   return sent;
 }
 
+int ProxyConnection::SendBatch(rtc::OutgoingPacket* packets, size_t count) {
+  if (count == 0)
+    return 0;
+  stats_.sent_total_packets += count;
+  const rtc::SocketAddress& addr = remote_candidate_.address();
+  for (size_t i = 0; i < count; ++i)
+    packets[i].addr = addr;
+  int sent = port_->SendToBatch(packets, count, true);
+  if (sent <= 0) {
+    RTC_DCHECK(sent < 0);
+    error_ = port_->GetError();
+    stats_.sent_discarded_packets += count;
+    return sent;
+  }
+  stats_.sent_discarded_packets += count - sent;
+  size_t sent_bytes = 0;
+  for (int i = 0; i < sent; ++i)
+    sent_bytes += packets[i].size;
+  send_rate_tracker_.AddSamples(sent_bytes);
+  return sent;
+}
+
 int ProxyConnection::GetError() {
   return error_;
 }
@@ -15,6 +15,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "api/candidate.h"
@@ -275,6 +276,14 @@ class Port : public PortInterface, public rtc::MessageHandler,
                         const std::string& username_fragment,
                         const std::string& password);
 
+  // Sends |count| packets, each to its |addr|, like SendTo() does. Returns
+  // the number of packets sent, which may be fewer than |count|, or a negative
+  // value if none could be sent. The default implementation calls SendTo()
+  // for each packet; ports on a UDP socket hand the batch to the socket.
+  virtual int SendToBatch(rtc::OutgoingPacket* packets,
+                          size_t count,
+                          bool payload);
+
   // Fired when candidates are discovered by the port. When all candidates
   // are discovered that belong to port SignalAddressReady is fired.
   sigslot::signal2<Port*, const Candidate&> SignalCandidateReady;
@@ -294,7 +303,14 @@ class Port : public PortInterface, public rtc::MessageHandler,
 
   // Returns a map containing all of the connections of this port, keyed by the
   // remote address.
-  typedef std::map<rtc::SocketAddress, Connection*> AddressMap;
+  // Hashed, since every packet received on the port is looked up here.
+  struct AddressHash {
+    size_t operator()(const rtc::SocketAddress& addr) const {
+      return addr.Hash();
+    }
+  };
+  typedef std::unordered_map<rtc::SocketAddress, Connection*, AddressHash>
+      AddressMap;
   const AddressMap& connections() { return connections_; }
 
   // Returns the connection to the given address or NULL if none exists.
@@ -351,7 +367,7 @@ class Port : public PortInterface, public rtc::MessageHandler,
   // Timeout shortening function to speed up unit tests.
   void set_timeout_delay(int delay) { timeout_delay_ = delay; }
 
-  // This method will return local and remote username fragements from the
+  // This method will return local and remote username fragments from the
   // stun username attribute if present.
   bool ParseStunUsername(const StunMessage* stun_msg,
                          std::string* local_username,
@@ -386,6 +402,9 @@ class Port : public PortInterface, public rtc::MessageHandler,
 
   virtual void UpdateNetworkCost();
 
+  // Called by SetIceParameters() after the parameters have changed.
+  virtual void UpdateIceParametersInternal() {}
+
   void set_type(const std::string& type) { type_ = type; }
 
   // Deprecated. Use the AddAddress() method below with "url" instead.
@@ -577,6 +596,10 @@ class Connection : public CandidatePairInterface,
   // covers.
   virtual int Send(const void* data, size_t size,
                    const rtc::PacketOptions& options) = 0;
+  // Sends |count| packets to the remote candidate; their |addr| is
+  // overwritten. Returns the number of packets sent, or a negative value if
+  // none could be sent. The default implementation calls Send() for each.
+  virtual int SendBatch(rtc::OutgoingPacket* packets, size_t count);
 
   // Error if Send() returns < 0
   virtual int GetError() = 0;
@@ -837,6 +860,7 @@ class ProxyConnection : public Connection {
   int Send(const void* data,
            size_t size,
            const rtc::PacketOptions& options) override;
+  int SendBatch(rtc::OutgoingPacket* packets, size_t count) override;
   int GetError() override;
 
  private:
@@ -87,6 +87,13 @@ enum {
   // Exclude link-local network interfaces
   // from considertaion after adapter enumeration.
   PORTALLOCATOR_DISABLE_LINK_LOCAL_NETWORKS = 0x10000,
+
+  // When specified, the relay ports are allocated in the same step as the UDP
+  // and STUN ports instead of one step delay later, so that the allocations on
+  // all TURN servers start right away. Relay ports that are still allocating
+  // when the session stops getting ports are pruned, which cancels their
+  // allocations.
+  PORTALLOCATOR_ENABLE_EARLY_RELAY = 0x20000,
 };
 
 // Defines various reasons that have caused ICE regathering.
@@ -182,6 +189,9 @@ struct RelayServerConfig {
   std::vector<std::string> tls_alpn_protocols;
   std::vector<std::string> tls_elliptic_curves;
   rtc::SSLCertificateVerifier* tls_cert_verifier = nullptr;
+  // Bind TURN channels as soon as permissions are created, see
+  // TurnPort::set_early_channel_binding().
+  bool early_channel_binding = false;
 };
 
 class PortAllocatorSession : public sigslot::has_slots<> {
@@ -14,6 +14,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <cmath>
 #include <memory>
 #include <set>
 
@@ -115,6 +116,9 @@ const uint32_t DEF_ACK_DELAY = 100;  // 100 milliseconds
 
 const uint8_t FLAG_CTL = 0x02;
 const uint8_t FLAG_RST = 0x04;
+// The payload of an ACK carrying this flag is a list of SACK blocks, each a
+// pair of 32-bit left and right edges.
+const uint8_t FLAG_SACK = 0x08;
 
 const uint8_t CTL_CONNECT = 0;
 
@@ -123,6 +127,15 @@ const uint8_t TCP_OPT_EOL = 0;        // End of list.
 const uint8_t TCP_OPT_NOOP = 1;       // No-op.
 const uint8_t TCP_OPT_MSS = 2;        // Maximum segment size.
 const uint8_t TCP_OPT_WND_SCALE = 3;  // Window scale factor.
+const uint8_t TCP_OPT_SACK_PERMITTED = 4;  // SACK permitted.
+
+// Maximum number of SACK blocks attached to an ACK.
+const uint32_t MAX_SACK_BLOCKS = 4;
+const uint32_t SACK_BLOCK_SIZE = 8;
+
+// CUBIC constants (RFC 8312, section 5).
+const double CUBIC_C = 0.4;
+const double CUBIC_BETA = 0.7;
 
 const long DEFAULT_TIMEOUT =
     4000;  // If there are no pending clocks, wake up every 4 seconds
@@ -214,7 +227,8 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
       m_rbuf_len(DEFAULT_RCV_BUF_SIZE),
       m_rbuf(m_rbuf_len),
       m_sbuf_len(DEFAULT_SND_BUF_SIZE),
-      m_sbuf(m_sbuf_len) {
+      m_sbuf(m_sbuf_len),
+      m_packet_buffer(new uint8_t[MAX_PACKET]) {
   // Sanity check on buffer sizes (needed for OnTcpWriteable notification logic)
   RTC_DCHECK(m_rbuf_len + MIN_PACKET < m_sbuf_len);
 
@@ -249,12 +263,21 @@ PseudoTcp::PseudoTcp(IPseudoTcpNotify* notify, uint32_t conv)
 
   m_ts_recent = m_ts_lastack = 0;
 
+  m_sack_enabled = false;
+  m_rexmit_mark = 0;
+
+  m_cubic_epoch_start = 0;
+  m_cubic_w_max = m_cubic_origin = 0;
+  m_cubic_k = m_cubic_w_est = 0;
+
   m_rx_rto = DEF_RTO;
   m_rx_srtt = m_rx_rttvar = 0;
 
   m_use_nagling = true;
   m_ack_delay = DEF_ACK_DELAY;
+  m_use_cubic = false;
   m_support_wnd_scale = true;
+  m_support_sack = true;
 }
 
 PseudoTcp::~PseudoTcp() {}
@@ -304,11 +327,18 @@ void PseudoTcp::NotifyClock(uint32_t now) {
       }
 
       uint32_t nInFlight = m_snd_nxt - m_snd_una;
-      m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+      m_ssthresh = congestionEvent(nInFlight);
       // RTC_LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: " <<
       // nInFlight << "  m_mss: " << m_mss;
       m_cwnd = m_mss;
 
+      // The receiver is allowed to discard data it has selectively
+      // acknowledged, so forget the scoreboard after a timeout.
+      for (SSegment& sseg : m_slist) {
+        sseg.bSacked = false;
+      }
+      m_rexmit_mark = m_snd_una;
+
       // Back off retransmit timer.  Note: the limit is lower when connecting.
       uint32_t rto_limit = (m_state < TCP_ESTABLISHED) ? DEF_RTO : MAX_RTO;
       m_rx_rto = std::min(rto_limit, m_rx_rto * 2);
@@ -374,6 +404,8 @@ void PseudoTcp::GetOption(Option opt, int* value) {
     *value = m_sbuf_len;
   } else if (opt == OPT_RCVBUF) {
     *value = m_rbuf_len;
+  } else if (opt == OPT_CUBIC) {
+    *value = m_use_cubic ? 1 : 0;
   } else {
     RTC_NOTREACHED();
   }
@@ -389,6 +421,9 @@ void PseudoTcp::SetOption(Option opt, int value) {
   } else if (opt == OPT_RCVBUF) {
     RTC_DCHECK(m_state == TCP_LISTEN);
     resizeReceiveBuffer(value);
+  } else if (opt == OPT_CUBIC) {
+    m_use_cubic = value != 0;
+    m_cubic_epoch_start = 0;
   } else {
     RTC_NOTREACHED();
   }
@@ -517,24 +552,31 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 
   uint32_t now = Now();
 
-  std::unique_ptr<uint8_t[]> buffer(new uint8_t[MAX_PACKET]);
-  long_to_bytes(m_conv, buffer.get());
-  long_to_bytes(seq, buffer.get() + 4);
-  long_to_bytes(m_rcv_nxt, buffer.get() + 8);
+  // Pure ACKs carry SACK blocks for the out-of-order data we hold.
+  uint8_t* buffer = m_packet_buffer.get();
+  uint32_t payload_len = len;
+  if (len == 0 && !(flags & FLAG_CTL) && m_sack_enabled && !m_rlist.empty()) {
+    payload_len = writeSackBlocks(buffer + HEADER_SIZE);
+    flags |= FLAG_SACK;
+  }
+
+  long_to_bytes(m_conv, buffer);
+  long_to_bytes(seq, buffer + 4);
+  long_to_bytes(m_rcv_nxt, buffer + 8);
   buffer[12] = 0;
   buffer[13] = flags;
   short_to_bytes(static_cast<uint16_t>(m_rcv_wnd >> m_rwnd_scale),
-                 buffer.get() + 14);
+                 buffer + 14);
 
   // Timestamp computations
-  long_to_bytes(now, buffer.get() + 16);
-  long_to_bytes(m_ts_recent, buffer.get() + 20);
+  long_to_bytes(now, buffer + 16);
+  long_to_bytes(m_ts_recent, buffer + 20);
   m_ts_lastack = m_rcv_nxt;
 
   if (len) {
     size_t bytes_read = 0;
     rtc::StreamResult result =
-        m_sbuf.ReadOffset(buffer.get() + HEADER_SIZE, len, offset, &bytes_read);
+        m_sbuf.ReadOffset(buffer + HEADER_SIZE, len, offset, &bytes_read);
     RTC_DCHECK(result == rtc::SR_SUCCESS);
     RTC_DCHECK(static_cast<uint32_t>(bytes_read) == len);
   }
@@ -550,7 +592,7 @@ IPseudoTcpNotify::WriteResult PseudoTcp::packet(uint32_t seq,
 #endif  // _DEBUGMSG
 
   IPseudoTcpNotify::WriteResult wres = m_notify->TcpWritePacket(
-      this, reinterpret_cast<char*>(buffer.get()), len + HEADER_SIZE);
+      this, reinterpret_cast<char*>(buffer), payload_len + HEADER_SIZE);
   // Note: When len is 0, this is an ACK packet.  We don't read the return value
   // for those, and thus we won't retry.  So go ahead and treat the packet as a
   // success (basically simulate as if it were dropped), which will prevent our
@@ -668,6 +710,15 @@ bool PseudoTcp::process(Segment& seg) {
     return false;
   }
 
+  // SACK blocks are not stream data, treat the segment as a pure ACK.
+  const char* sack_data = NULL;
+  uint32_t sack_len = 0;
+  if (seg.flags & FLAG_SACK) {
+    sack_data = seg.data;
+    sack_len = seg.len;
+    seg.len = 0;
+  }
+
   // Check for control data
   bool bConnect = false;
   if (seg.flags & FLAG_CTL) {
@@ -705,6 +756,10 @@ bool PseudoTcp::process(Segment& seg) {
     m_ts_recent = seg.tsval;
   }
 
+  if (sack_len > 0 && m_sack_enabled) {
+    applySackBlocks(sack_data, sack_len);
+  }
+
   // Check if this is a valuable ack
   if ((seg.ack > m_snd_una) && (seg.ack <= m_snd_nxt)) {
     // Calculate round-trip time
@@ -768,9 +823,18 @@ bool PseudoTcp::process(Segment& seg) {
 #if _DEBUGMSG >= _DBG_NORMAL
         RTC_LOG(LS_INFO) << "recovery retransmit";
 #endif  // _DEBUGMSG
-        if (!transmit(m_slist.begin(), now)) {
+        if (m_sack_enabled && m_slist.begin()->seq < m_rexmit_mark) {
+          // The new hole has been retransmitted already, move on to the next.
+          if (!retransmitNextHole(now)) {
+            closedown(ECONNABORTED);
+            return false;
+          }
+        } else if (!transmit(m_slist.begin(), now)) {
           closedown(ECONNABORTED);
           return false;
+        } else {
+          m_rexmit_mark = std::max(
+              m_rexmit_mark, m_slist.begin()->seq + m_slist.begin()->len);
         }
         m_cwnd += m_mss - std::min(nAcked, m_cwnd);
       }
@@ -779,6 +843,8 @@ bool PseudoTcp::process(Segment& seg) {
       // Slow start, congestion avoidance
       if (m_cwnd < m_ssthresh) {
         m_cwnd += m_mss;
+      } else if (m_use_cubic) {
+        cubicIncrease(now);
       } else {
         m_cwnd += std::max<uint32_t>(1, m_mss * m_mss / m_cwnd);
       }
@@ -803,13 +869,20 @@ bool PseudoTcp::process(Segment& seg) {
           return false;
         }
         m_recover = m_snd_nxt;
+        m_rexmit_mark = m_slist.begin()->seq + m_slist.begin()->len;
         uint32_t nInFlight = m_snd_nxt - m_snd_una;
-        m_ssthresh = std::max(nInFlight / 2, 2 * m_mss);
+        m_ssthresh = congestionEvent(nInFlight);
         // RTC_LOG(LS_INFO) << "m_ssthresh: " << m_ssthresh << "  nInFlight: "
         // << nInFlight << "  m_mss: " << m_mss;
         m_cwnd = m_ssthresh + 3 * m_mss;
       } else if (m_dup_acks > 3) {
         m_cwnd += m_mss;
+        // With SACK, further losses in the same window are repaired without
+        // waiting for a partial ACK for each of them.
+        if (m_sack_enabled && !retransmitNextHole(now)) {
+          closedown(ECONNABORTED);
+          return false;
+        }
       }
     } else {
       m_dup_acks = 0;
@@ -1041,6 +1114,7 @@ void PseudoTcp::attemptSend(SendFlags sflags) {
 
   if (rtc::TimeDiff32(now, m_lastsend) > static_cast<long>(m_rx_rto)) {
     m_cwnd = m_mss;
+    m_cubic_epoch_start = 0;
   }
 
 #if _DEBUGMSG
@@ -1167,6 +1241,124 @@ void PseudoTcp::disableWindowScale() {
   m_support_wnd_scale = false;
 }
 
+void PseudoTcp::disableSack() {
+  m_support_sack = false;
+}
+
+uint32_t PseudoTcp::congestionEvent(uint32_t nInFlight) {
+  m_cubic_epoch_start = 0;
+  if (!m_use_cubic) {
+    return std::max(nInFlight / 2, 2 * m_mss);
+  }
+
+  // Fast convergence: release bandwidth to new flows when the window at the
+  // time of loss is below the previous maximum.
+  if (nInFlight < m_cubic_w_max) {
+    m_cubic_w_max =
+        static_cast<uint32_t>(nInFlight * (1.0 + CUBIC_BETA) / 2.0);
+  } else {
+    m_cubic_w_max = nInFlight;
+  }
+  return std::max(static_cast<uint32_t>(nInFlight * CUBIC_BETA), 2 * m_mss);
+}
+
+void PseudoTcp::cubicIncrease(uint32_t now) {
+  const double mss = m_mss;
+  const double cwnd = m_cwnd;
+  if (m_cubic_epoch_start == 0) {
+    m_cubic_epoch_start = now;
+    if (m_cwnd < m_cubic_w_max) {
+      m_cubic_k = std::cbrt((m_cubic_w_max - cwnd) / mss / CUBIC_C);
+      m_cubic_origin = m_cubic_w_max;
+    } else {
+      m_cubic_k = 0;
+      m_cubic_origin = m_cwnd;
+    }
+    m_cubic_w_est = cwnd;
+  }
+
+  // Window the cubic function reaches one RTT from now, in bytes.
+  double t =
+      (rtc::TimeDiff32(now, m_cubic_epoch_start) + m_rx_srtt) / 1000.0;
+  double target =
+      m_cubic_origin + CUBIC_C * std::pow(t - m_cubic_k, 3) * mss;
+
+  // Never grow slower than Reno would (TCP-friendly region).
+  m_cubic_w_est +=
+      3.0 * (1.0 - CUBIC_BETA) / (1.0 + CUBIC_BETA) * mss * mss / cwnd;
+  target = std::max(target, m_cubic_w_est);
+
+  double increase = (target > cwnd) ? mss * (target - cwnd) / cwnd
+                                    : mss * mss / (100.0 * cwnd);
+  m_cwnd += std::max<uint32_t>(1, static_cast<uint32_t>(
+                                      std::min(increase, mss)));
+}
+
+uint32_t PseudoTcp::writeSackBlocks(uint8_t* buffer) const {
+  // |m_rlist| is sorted by sequence number, but its ranges may overlap or
+  // be adjacent, so merge them before writing.
+  uint32_t blocks = 0;
+  uint32_t right = 0;
+  for (const RSegment& rseg : m_rlist) {
+    if (blocks > 0 && rseg.seq <= right) {
+      right = std::max(right, rseg.seq + rseg.len);
+    } else if (blocks < MAX_SACK_BLOCKS) {
+      ++blocks;
+      right = rseg.seq + rseg.len;
+      long_to_bytes(rseg.seq, buffer + (blocks - 1) * SACK_BLOCK_SIZE);
+    } else {
+      break;
+    }
+    long_to_bytes(right, buffer + (blocks - 1) * SACK_BLOCK_SIZE + 4);
+  }
+  return blocks * SACK_BLOCK_SIZE;
+}
+
+void PseudoTcp::applySackBlocks(const char* data, uint32_t len) {
+  if (len % SACK_BLOCK_SIZE != 0) {
+    RTC_LOG_F(LS_WARNING) << "Invalid SACK blocks received.";
+    return;
+  }
+  for (uint32_t i = 0; i < len; i += SACK_BLOCK_SIZE) {
+    uint32_t left = bytes_to_long(data + i);
+    uint32_t right = bytes_to_long(data + i + 4);
+    for (SSegment& sseg : m_slist) {
+      if (sseg.seq >= right)
+        break;
+      if ((sseg.xmit > 0) && (sseg.seq >= left) &&
+          (sseg.seq + sseg.len <= right)) {
+        sseg.bSacked = true;
+      }
+    }
+  }
+}
+
+bool PseudoTcp::retransmitNextHole(uint32_t now) {
+  // Only segments below the highest SACKed one are presumed lost.
+  uint32_t sack_high = 0;
+  for (const SSegment& sseg : m_slist) {
+    if (sseg.bSacked) {
+      sack_high = sseg.seq + sseg.len;
+    }
+  }
+
+  for (SList::iterator it = m_slist.begin(); it != m_slist.end(); ++it) {
+    if (it->seq + it->len > sack_high)
+      break;
+    if (it->xmit == 0 || it->bSacked || it->seq < m_rexmit_mark)
+      continue;
+#if _DEBUGMSG >= _DBG_NORMAL
+    RTC_LOG(LS_INFO) << "sack retransmit " << it->seq;
+#endif  // _DEBUGMSG
+    if (!transmit(it, now)) {
+      return false;
+    }
+    m_rexmit_mark = it->seq + it->len;
+    return true;
+  }
+  return true;
+}
+
 void PseudoTcp::queueConnectMessage() {
   rtc::ByteBufferWriter buf(rtc::ByteBuffer::ORDER_NETWORK);
 
@@ -1176,6 +1368,10 @@ void PseudoTcp::queueConnectMessage() {
     buf.WriteUInt8(1);
     buf.WriteUInt8(m_rwnd_scale);
   }
+  if (m_support_sack) {
+    buf.WriteUInt8(TCP_OPT_SACK_PERMITTED);
+    buf.WriteUInt8(0);
+  }
   m_snd_wnd = static_cast<uint32_t>(buf.Length());
   queue(buf.Data(), static_cast<uint32_t>(buf.Length()), true);
 }
@@ -1224,6 +1420,10 @@ void PseudoTcp::parseOptions(const char* data, uint32_t len) {
       m_swnd_scale = 0;
     }
   }
+
+  m_sack_enabled =
+      m_support_sack && options_specified.find(TCP_OPT_SACK_PERMITTED) !=
+                            options_specified.end();
 }
 
 void PseudoTcp::applyOption(char kind, const char* data, uint32_t len) {
@@ -1238,6 +1438,12 @@ void PseudoTcp::applyOption(char kind, const char* data, uint32_t len) {
       return;
     }
     applyWindowScaleOption(data[0]);
+  } else if (kind == TCP_OPT_SACK_PERMITTED) {
+    // Selective acknowledgements.
+    // http://www.ietf.org/rfc/rfc2018.txt
+    if (len != 0) {
+      RTC_LOG_F(WARNING) << "Invalid SACK permitted option received.";
+    }
   }
 }
 
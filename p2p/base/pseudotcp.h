@@ -12,6 +12,7 @@
 #define P2P_BASE_PSEUDOTCP_H_
 
 #include <list>
+#include <memory>
 
 #include "rtc_base/stream.h"
 
@@ -88,6 +89,7 @@ class PseudoTcp {
     OPT_ACKDELAY,     // The Delayed ACK timeout (0 == off).
     OPT_RCVBUF,       // Set the receive buffer size, in bytes.
     OPT_SNDBUF,       // Set the send buffer size, in bytes.
+    OPT_CUBIC,        // Whether to use CUBIC congestion avoidance (0 == Reno).
   };
   void GetOption(Option opt, int* value);
   void SetOption(Option opt, int value);
@@ -120,11 +122,13 @@ class PseudoTcp {
 
   struct SSegment {
     SSegment(uint32_t s, uint32_t l, bool c)
-        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c) {}
+        : seq(s), len(l), /*tstamp(0),*/ xmit(0), bCtrl(c), bSacked(false) {}
     uint32_t seq, len;
     // uint32_t tstamp;
     uint8_t xmit;
     bool bCtrl;
+    // Set when the peer has selectively acknowledged this segment.
+    bool bSacked;
   };
   typedef std::list<SSegment> SList;
 
@@ -159,6 +163,21 @@ class PseudoTcp {
 
   void adjustMTU();
 
+  // Returns the new slow start threshold after a loss, given the amount of
+  // data in flight when it was detected.
+  uint32_t congestionEvent(uint32_t nInFlight);
+  // Grows |m_cwnd| in congestion avoidance using the CUBIC window function.
+  void cubicIncrease(uint32_t now);
+
+  // Writes the out-of-order ranges held in |m_rlist| as SACK blocks to
+  // |buffer| and returns the number of bytes written.
+  uint32_t writeSackBlocks(uint8_t* buffer) const;
+  // Marks the segments in |m_slist| covered by the SACK blocks in |data|.
+  void applySackBlocks(const char* data, uint32_t len);
+  // Retransmits the first hole below the highest selectively acknowledged
+  // segment that has not been retransmitted in the current recovery yet.
+  bool retransmitNextHole(uint32_t now);
+
  protected:
   // This method is used in test only to query receive buffer state.
   bool isReceiveBufferFull() const;
@@ -167,6 +186,10 @@ class PseudoTcp {
   // support for testing backward compatibility.
   void disableWindowScale();
 
+  // This method is only used in tests, to disable SACK support for testing
+  // backward compatibility.
+  void disableSack();
+
  private:
   // Queue the connect message with TCP options.
   void queueConnectMessage();
@@ -227,13 +250,31 @@ class PseudoTcp {
   uint32_t m_recover;
   uint32_t m_t_ack;
 
+  // Selective acknowledgements (RFC 2018), used once both peers offered them.
+  bool m_sack_enabled;
+  // Holes below this sequence number have been retransmitted in the current
+  // recovery.
+  uint32_t m_rexmit_mark;
+
+  // CUBIC state (RFC 8312). |m_cubic_epoch_start| is 0 outside of an epoch.
+  uint32_t m_cubic_epoch_start;
+  uint32_t m_cubic_w_max, m_cubic_origin;
+  double m_cubic_k, m_cubic_w_est;
+
+  // Scratch buffer for outgoing packets, reused to avoid an allocation per
+  // packet.
+  std::unique_ptr<uint8_t[]> m_packet_buffer;
+
   // Configuration options
   bool m_use_nagling;
   uint32_t m_ack_delay;
+  bool m_use_cubic;
 
   // This is used by unit tests to test backward compatibility of
   // PseudoTcp implementations that don't support window scaling.
   bool m_support_wnd_scale;
+  // Likewise for SACK.
+  bool m_support_sack;
 };
 
 }  // namespace cricket
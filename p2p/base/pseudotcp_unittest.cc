@@ -34,6 +34,8 @@ class PseudoTcpForTest : public cricket::PseudoTcp {
   bool isReceiveBufferFull() const { return PseudoTcp::isReceiveBufferFull(); }
 
   void disableWindowScale() { PseudoTcp::disableWindowScale(); }
+
+  void disableSack() { PseudoTcp::disableSack(); }
 };
 
 class PseudoTcpTestBase : public testing::Test,
@@ -74,6 +76,10 @@ class PseudoTcpTestBase : public testing::Test,
     local_.SetOption(PseudoTcp::OPT_ACKDELAY, ack_delay);
     remote_.SetOption(PseudoTcp::OPT_ACKDELAY, ack_delay);
   }
+  void SetOptCubic(bool enable_cubic) {
+    local_.SetOption(PseudoTcp::OPT_CUBIC, enable_cubic);
+    remote_.SetOption(PseudoTcp::OPT_CUBIC, enable_cubic);
+  }
   void SetOptSndBuf(int size) {
     local_.SetOption(PseudoTcp::OPT_SNDBUF, size);
     remote_.SetOption(PseudoTcp::OPT_SNDBUF, size);
@@ -86,6 +92,8 @@ class PseudoTcpTestBase : public testing::Test,
   }
   void DisableRemoteWindowScale() { remote_.disableWindowScale(); }
   void DisableLocalWindowScale() { local_.disableWindowScale(); }
+  void DisableRemoteSack() { remote_.disableSack(); }
+  void DisableLocalSack() { local_.disableSack(); }
 
  protected:
   int Connect() {
@@ -712,6 +720,60 @@ TEST_F(PseudoTcpTest, TestSendVerySmallReceiveBuffer) {
   TestTransfer(100000);
 }
 
+// Test sending data with 10% packet loss with a receiver that doesn't support
+// SACK.
+TEST_F(PseudoTcpTest, TestSendWithLossRemoteNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableRemoteSack();
+  TestTransfer(100000);
+}
+
+// Test sending data with 10% packet loss with a sender that doesn't support
+// SACK.
+TEST_F(PseudoTcpTest, TestSendWithLossLocalNoSack) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  DisableLocalSack();
+  TestTransfer(100000);
+}
+
+// Test sending data with 10% packet loss using CUBIC congestion avoidance.
+TEST_F(PseudoTcpTest, TestSendWithLossAndCubic) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetLoss(10);
+  SetOptCubic(true);
+  TestTransfer(100000);
+}
+
+// Test bulk transfer over a 200 ms RTT with a window large enough to fill
+// the pipe.
+TEST_F(PseudoTcpTest, TestSendHighLatencyLargeWindow) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(100);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  TestTransfer(4000000);
+}
+
+// Same as above with 1% packet loss and CUBIC congestion avoidance.
+TEST_F(PseudoTcpTest, TestSendHighLatencyLargeWindowWithLossAndCubic) {
+  SetLocalMtu(1500);
+  SetRemoteMtu(1500);
+  SetDelay(100);
+  SetLoss(1);
+  SetRemoteOptRcvBuf(1000000);
+  SetLocalOptRcvBuf(1000000);
+  SetOptSndBuf(1500000);
+  SetOptCubic(true);
+  TestTransfer(500000);  // less data so test runs faster
+}
+
 // Ping-pong (request/response) tests
 
 // Test sending <= 1x MTU of data in each ping/pong.  Should take <10ms.
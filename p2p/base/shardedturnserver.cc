@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/shardedturnserver.h"
+
+#include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/turnserver.h"
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+struct ShardedTurnServer::Shard {
+  std::unique_ptr<rtc::Thread> thread;
+  // Created, used and destroyed on |thread|.
+  std::unique_ptr<TurnServer> server;
+};
+
+ShardedTurnServer::ShardedTurnServer(size_t num_shards)
+    : num_shards_(num_shards) {
+  RTC_DCHECK_GT(num_shards_, 0);
+}
+
+ShardedTurnServer::~ShardedTurnServer() {
+  Stop();
+}
+
+bool ShardedTurnServer::Start(const rtc::SocketAddress& internal_address,
+                              const rtc::IPAddress& external_ip) {
+  RTC_DCHECK(shards_.empty());
+  rtc::SocketAddress address = internal_address;
+  for (size_t i = 0; i < num_shards_; ++i) {
+    std::unique_ptr<Shard> shard = rtc::MakeUnique<Shard>();
+    shard->thread = rtc::Thread::CreateWithSocketServer();
+    shard->thread->SetName("TurnServerShard", shard.get());
+    shard->thread->Start();
+    bool started = shard->thread->Invoke<bool>(RTC_FROM_HERE, [&] {
+      return StartShard(shard.get(), address, external_ip);
+    });
+    shards_.push_back(std::move(shard));
+    if (!started) {
+      Stop();
+      return false;
+    }
+    if (i == 0) {
+      // Let the other shards share the port picked for the first one.
+      address = internal_address_;
+    }
+  }
+  RTC_LOG(LS_INFO) << "Started " << num_shards_ << " TURN server shards on "
+                   << internal_address_.ToString();
+  return true;
+}
+
+bool ShardedTurnServer::StartShard(Shard* shard,
+                                   const rtc::SocketAddress& internal_address,
+                                   const rtc::IPAddress& external_ip) {
+  rtc::Thread* thread = shard->thread.get();
+  RTC_DCHECK(thread->IsCurrent());
+  rtc::AsyncSocket* socket = thread->socketserver()->CreateAsyncSocket(
+      internal_address.family(), SOCK_DGRAM);
+  if (!socket) {
+    RTC_LOG(LS_ERROR) << "Failed to create a UDP socket for a TURN shard.";
+    return false;
+  }
+  if (num_shards_ > 1 && socket->SetOption(rtc::Socket::OPT_REUSEPORT, 1)) {
+    RTC_LOG(LS_ERROR) << "Failed to set SO_REUSEPORT, error "
+                      << socket->GetError();
+    delete socket;
+    return false;
+  }
+  // Takes ownership of |socket|, also on failure.
+  rtc::AsyncUDPSocket* udp_socket =
+      rtc::AsyncUDPSocket::Create(socket, internal_address);
+  if (!udp_socket) {
+    RTC_LOG(LS_ERROR) << "Failed to bind a TURN shard to "
+                      << internal_address.ToString();
+    return false;
+  }
+  if (internal_address_.IsNil()) {
+    internal_address_ = udp_socket->GetLocalAddress();
+  }
+
+  shard->server = rtc::MakeUnique<TurnServer>(thread);
+  shard->server->set_realm(realm_);
+  shard->server->set_software(software_);
+  shard->server->set_auth_hook(auth_hook_);
+  shard->server->AddInternalSocket(udp_socket, PROTO_UDP);
+  shard->server->SetExternalSocketFactory(
+      new rtc::BasicPacketSocketFactory(thread),
+      rtc::SocketAddress(external_ip, 0));
+  return true;
+}
+
+void ShardedTurnServer::Stop() {
+  for (const std::unique_ptr<Shard>& shard : shards_) {
+    Shard* s = shard.get();
+    s->thread->Invoke<void>(RTC_FROM_HERE, [s] { s->server.reset(); });
+    s->thread->Stop();
+  }
+  shards_.clear();
+  internal_address_.Clear();
+}
+
+}  // namespace cricket
@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_SHARDEDTURNSERVER_H_
+#define P2P_BASE_SHARDEDTURNSERVER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/ipaddress.h"
+#include "rtc_base/socketaddress.h"
+
+namespace cricket {
+
+class TurnAuthInterface;
+
+// Runs several independent TurnServers, one per network thread, that listen
+// on the same UDP address. Every shard binds its own socket with
+// SO_REUSEPORT, so the kernel spreads clients across the shards by hashing
+// the 5-tuple. A client therefore always reaches the same shard, every
+// allocation lives on exactly one thread, and the data path shares no state
+// or locks between shards.
+class ShardedTurnServer {
+ public:
+  explicit ShardedTurnServer(size_t num_shards);
+  ~ShardedTurnServer();
+
+  // Settings applied to every shard; must be set before Start().
+  void set_realm(const std::string& realm) { realm_ = realm; }
+  void set_software(const std::string& software) { software_ = software; }
+  // |auth_hook| is called concurrently from all shard threads, so it must be
+  // thread-safe. It must outlive the ShardedTurnServer.
+  void set_auth_hook(TurnAuthInterface* auth_hook) { auth_hook_ = auth_hook; }
+
+  // Starts the shard threads. Each one listens on |internal_address| and
+  // allocates relayed addresses on |external_ip|. If the port of
+  // |internal_address| is 0, the port chosen for the first shard is used for
+  // the others. Returns false, with no shard left running, if any socket
+  // cannot be created or bound.
+  bool Start(const rtc::SocketAddress& internal_address,
+             const rtc::IPAddress& external_ip);
+  void Stop();
+
+  size_t num_shards() const { return num_shards_; }
+  // The address all shards listen on. Valid after a successful Start().
+  const rtc::SocketAddress& internal_address() const {
+    return internal_address_;
+  }
+
+ private:
+  struct Shard;
+
+  bool StartShard(Shard* shard,
+                  const rtc::SocketAddress& internal_address,
+                  const rtc::IPAddress& external_ip);
+
+  const size_t num_shards_;
+  std::string realm_;
+  std::string software_;
+  TurnAuthInterface* auth_hook_ = nullptr;
+  rtc::SocketAddress internal_address_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ShardedTurnServer);
+};
+
+}  // namespace cricket
+
+#endif  // P2P_BASE_SHARDEDTURNSERVER_H_
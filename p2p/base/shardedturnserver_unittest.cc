@@ -0,0 +1,93 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include "p2p/base/shardedturnserver.h"
+#include "p2p/base/stun.h"
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/bytebuffer.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/helpers.h"
+#include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/thread.h"
+
+namespace cricket {
+
+static const int kTimeoutMs = 5000;
+
+class ShardedTurnServerTest : public testing::Test,
+                              public sigslot::has_slots<> {
+ public:
+  ShardedTurnServerTest() : thread_(&pss_) {}
+
+  void OnReadPacket(rtc::AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const rtc::SocketAddress& remote_addr,
+                    const rtc::PacketTime& packet_time) {
+    StunMessage response;
+    rtc::ByteBufferReader buf(data, size);
+    if (response.Read(&buf) && response.type() == STUN_BINDING_RESPONSE)
+      ++binding_responses_;
+  }
+
+  // Sends a binding request from a new client socket, which the kernel will
+  // hash to one of the shards.
+  void SendBindingRequest(const rtc::SocketAddress& server_address) {
+    std::unique_ptr<rtc::AsyncUDPSocket> client(rtc::AsyncUDPSocket::Create(
+        &pss_, rtc::SocketAddress(server_address.ipaddr(), 0)));
+    ASSERT_TRUE(client);
+    client->SignalReadPacket.connect(this,
+                                     &ShardedTurnServerTest::OnReadPacket);
+    StunMessage request;
+    request.SetType(STUN_BINDING_REQUEST);
+    request.SetTransactionID(
+        rtc::CreateRandomString(kStunTransactionIdLength));
+    rtc::ByteBufferWriter buf;
+    request.Write(&buf);
+    client->SendTo(buf.Data(), buf.Length(), server_address,
+                   rtc::PacketOptions());
+    clients_.push_back(std::move(client));
+  }
+
+ protected:
+  rtc::PhysicalSocketServer pss_;
+  rtc::AutoSocketServerThread thread_;
+  std::vector<std::unique_ptr<rtc::AsyncUDPSocket>> clients_;
+  int binding_responses_ = 0;
+};
+
+TEST_F(ShardedTurnServerTest, AllShardsShareOneAddress) {
+  ShardedTurnServer server(4);
+  ASSERT_TRUE(server.Start(rtc::SocketAddress("127.0.0.1", 0),
+                           rtc::IPAddress(INADDR_LOOPBACK)));
+  EXPECT_EQ(4u, server.num_shards());
+  EXPECT_NE(0, server.internal_address().port());
+
+  const int kNumClients = 16;
+  for (int i = 0; i < kNumClients; ++i)
+    SendBindingRequest(server.internal_address());
+  EXPECT_EQ_WAIT(kNumClients, binding_responses_, kTimeoutMs);
+}
+
+TEST_F(ShardedTurnServerTest, StartFailsIfAddressIsTaken) {
+  // A socket bound without SO_REUSEPORT keeps the shards from binding.
+  std::unique_ptr<rtc::AsyncUDPSocket> blocker(
+      rtc::AsyncUDPSocket::Create(&pss_, rtc::SocketAddress("127.0.0.1", 0)));
+  ASSERT_TRUE(blocker);
+  ShardedTurnServer server(2);
+  EXPECT_FALSE(server.Start(blocker->GetLocalAddress(),
+                            rtc::IPAddress(INADDR_LOOPBACK)));
+  EXPECT_TRUE(server.internal_address().IsNil());
+}
+
+}  // namespace cricket
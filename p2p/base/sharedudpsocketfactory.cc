@@ -0,0 +1,487 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "p2p/base/sharedudpsocketfactory.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include <algorithm>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "p2p/base/stun.h"
+#include "p2p/base/stunrequest.h"
+#include "rtc_base/asyncpacketsocket.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+// Pending STUN transactions are dropped once they are older than any STUN
+// request can get before it times out.
+const int64_t kTransactionTimeoutMs = cricket::STUN_TOTAL_TIMEOUT;
+// The transactions are checked for timeouts whenever their number has doubled
+// since the last check, but no earlier than at this number.
+const size_t kMinTransactionsToPrune = 64;
+
+}  // namespace
+
+// The socket shared by all the ports on one local IP address. Keeps the
+// tables that decide which SharedSocket an incoming packet belongs to.
+class SharedUdpSocketFactory::Listener : public sigslot::has_slots<> {
+ public:
+  explicit Listener(AsyncPacketSocket* socket);
+  ~Listener() override;
+
+  AsyncPacketSocket* socket() const { return socket_.get(); }
+  bool HasSocket(AsyncPacketSocket* socket) const;
+
+  void AddSocket(SharedSocket* socket);
+  void RemoveSocket(SharedSocket* socket);
+  void SetIceUfrag(SharedSocket* socket, const std::string& ice_ufrag);
+
+  int SendTo(SharedSocket* sender,
+             const void* data,
+             size_t size,
+             const SocketAddress& addr,
+             const PacketOptions& options);
+  int SendToBatch(SharedSocket* sender,
+                  const OutgoingPacket* packets,
+                  size_t count);
+
+ private:
+  struct AddressHash {
+    size_t operator()(const SocketAddress& addr) const { return addr.Hash(); }
+  };
+  struct Transaction {
+    SharedSocket* socket;
+    int64_t time_ms;
+  };
+
+  // Remembers where the replies to a packet from |sender| have to go.
+  void AddRoutes(SharedSocket* sender,
+                 const void* data,
+                 size_t size,
+                 const SocketAddress& addr);
+  // Makes |socket| the receiver of the packets from |addr|, unless another
+  // socket already is and |take_over| is false.
+  void SetRoute(const SocketAddress& addr,
+                SharedSocket* socket,
+                bool take_over);
+  void PruneTransactions(int64_t now_ms);
+  SharedSocket* FindReceiver(const char* data,
+                             size_t size,
+                             const SocketAddress& remote_addr);
+
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time);
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet);
+  void OnReadyToSend(AsyncPacketSocket* socket);
+  void OnAddressReady(AsyncPacketSocket* socket, const SocketAddress& address);
+
+  const std::unique_ptr<AsyncPacketSocket> socket_;
+  std::set<AsyncPacketSocket*> sockets_;
+  // The socket that is sending, for SignalSentPacket.
+  SharedSocket* sender_ = nullptr;
+  std::unordered_map<std::string, SharedSocket*> ice_ufrags_;
+  // The owner of each remote address, see SetRoute().
+  std::unordered_map<SocketAddress, SharedSocket*, AddressHash> routes_;
+  // Outgoing STUN requests by transaction ID.
+  std::unordered_map<std::string, Transaction> transactions_;
+  size_t next_prune_size_ = kMinTransactionsToPrune;
+};
+
+// A UDP socket handed out by the factory; a view of the Listener's socket that
+// only sees the packets routed to it.
+class SharedUdpSocketFactory::SharedSocket : public AsyncPacketSocket {
+ public:
+  explicit SharedSocket(Listener* listener) : listener_(listener) {
+    listener_->AddSocket(this);
+  }
+  ~SharedSocket() override { Close(); }
+
+  const std::string& ice_ufrag() const { return ice_ufrag_; }
+  void set_ice_ufrag(const std::string& ice_ufrag) { ice_ufrag_ = ice_ufrag; }
+  // The keys of the Listener's entries for this socket, so that they can be
+  // removed without going through all the entries.
+  std::set<SocketAddress>* routes() { return &routes_; }
+  std::set<std::string>* transaction_ids() { return &transaction_ids_; }
+  // Called when the Listener goes away before this socket.
+  void Detach() { listener_ = nullptr; }
+
+  SocketAddress GetLocalAddress() const override {
+    return listener_ ? listener_->socket()->GetLocalAddress() : SocketAddress();
+  }
+  SocketAddress GetRemoteAddress() const override { return SocketAddress(); }
+
+  int Send(const void* pv, size_t cb, const PacketOptions& options) override {
+    error_ = ENOTCONN;
+    return -1;
+  }
+  int SendTo(const void* pv,
+             size_t cb,
+             const SocketAddress& addr,
+             const PacketOptions& options) override {
+    if (!listener_) {
+      error_ = ENOTCONN;
+      return -1;
+    }
+    int sent = listener_->SendTo(this, pv, cb, addr, options);
+    if (sent < 0) {
+      error_ = listener_->socket()->GetError();
+    }
+    return sent;
+  }
+  int SendToBatch(const OutgoingPacket* packets, size_t count) override {
+    if (!listener_) {
+      error_ = ENOTCONN;
+      return -1;
+    }
+    int sent = listener_->SendToBatch(this, packets, count);
+    if (sent < 0) {
+      error_ = listener_->socket()->GetError();
+    }
+    return sent;
+  }
+
+  int Close() override {
+    if (listener_) {
+      listener_->RemoveSocket(this);
+      listener_ = nullptr;
+    }
+    return 0;
+  }
+  State GetState() const override {
+    return listener_ ? listener_->socket()->GetState() : STATE_CLOSED;
+  }
+
+  int GetOption(Socket::Option opt, int* value) override {
+    return listener_ ? listener_->socket()->GetOption(opt, value) : -1;
+  }
+  int SetOption(Socket::Option opt, int value) override {
+    return listener_ ? listener_->socket()->SetOption(opt, value) : -1;
+  }
+
+  int GetError() const override { return error_; }
+  void SetError(int error) override { error_ = error; }
+
+ private:
+  Listener* listener_;
+  std::string ice_ufrag_;
+  std::set<SocketAddress> routes_;
+  std::set<std::string> transaction_ids_;
+  int error_ = 0;
+};
+
+SharedUdpSocketFactory::Listener::Listener(AsyncPacketSocket* socket)
+    : socket_(socket) {
+  socket_->SignalReadPacket.connect(this, &Listener::OnReadPacket);
+  socket_->SignalSentPacket.connect(this, &Listener::OnSentPacket);
+  socket_->SignalReadyToSend.connect(this, &Listener::OnReadyToSend);
+  socket_->SignalAddressReady.connect(this, &Listener::OnAddressReady);
+}
+
+SharedUdpSocketFactory::Listener::~Listener() {
+  for (AsyncPacketSocket* socket : sockets_) {
+    static_cast<SharedSocket*>(socket)->Detach();
+  }
+}
+
+bool SharedUdpSocketFactory::Listener::HasSocket(
+    AsyncPacketSocket* socket) const {
+  return sockets_.find(socket) != sockets_.end();
+}
+
+void SharedUdpSocketFactory::Listener::AddSocket(SharedSocket* socket) {
+  sockets_.insert(socket);
+}
+
+void SharedUdpSocketFactory::Listener::RemoveSocket(SharedSocket* socket) {
+  sockets_.erase(socket);
+  SetIceUfrag(socket, std::string());
+  for (const SocketAddress& addr : *socket->routes()) {
+    routes_.erase(addr);
+  }
+  socket->routes()->clear();
+  for (const std::string& transaction_id : *socket->transaction_ids()) {
+    transactions_.erase(transaction_id);
+  }
+  socket->transaction_ids()->clear();
+  if (sender_ == socket) {
+    sender_ = nullptr;
+  }
+}
+
+void SharedUdpSocketFactory::Listener::SetIceUfrag(
+    SharedSocket* socket,
+    const std::string& ice_ufrag) {
+  auto it = ice_ufrags_.find(socket->ice_ufrag());
+  if (it != ice_ufrags_.end() && it->second == socket) {
+    ice_ufrags_.erase(it);
+  }
+  socket->set_ice_ufrag(ice_ufrag);
+  if (ice_ufrag.empty()) {
+    return;
+  }
+  if (!ice_ufrags_.insert(std::make_pair(ice_ufrag, socket)).second) {
+    RTC_LOG(LS_WARNING) << "ICE ufrag " << ice_ufrag << " is already used on "
+                        << socket_->GetLocalAddress().ToString()
+                        << "; binding requests for it keep going to the "
+                        << "first socket that used it.";
+  }
+}
+
+int SharedUdpSocketFactory::Listener::SendTo(SharedSocket* sender,
+                                             const void* data,
+                                             size_t size,
+                                             const SocketAddress& addr,
+                                             const PacketOptions& options) {
+  AddRoutes(sender, data, size, addr);
+  sender_ = sender;
+  int sent = socket_->SendTo(data, size, addr, options);
+  sender_ = nullptr;
+  return sent;
+}
+
+int SharedUdpSocketFactory::Listener::SendToBatch(
+    SharedSocket* sender,
+    const OutgoingPacket* packets,
+    size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    AddRoutes(sender, packets[i].data, packets[i].size, packets[i].addr);
+  }
+  sender_ = sender;
+  int sent = socket_->SendToBatch(packets, count);
+  sender_ = nullptr;
+  return sent;
+}
+
+void SharedUdpSocketFactory::Listener::AddRoutes(SharedSocket* sender,
+                                                 const void* data,
+                                                 size_t size,
+                                                 const SocketAddress& addr) {
+  SetRoute(addr, sender, false);
+  cricket::StunMessageView stun;
+  if (!stun.Parse(static_cast<const char*>(data), size) ||
+      !cricket::IsStunRequestType(stun.type())) {
+    return;
+  }
+  int64_t now_ms = TimeMillis();
+  if (transactions_.size() >= next_prune_size_) {
+    PruneTransactions(now_ms);
+  }
+  // Retransmissions keep their transaction ID; they just refresh the entry.
+  std::string transaction_id(stun.transaction_id(),
+                             cricket::kStunTransactionIdLength);
+  Transaction& transaction = transactions_[transaction_id];
+  if (transaction.socket && transaction.socket != sender) {
+    transaction.socket->transaction_ids()->erase(transaction_id);
+  }
+  transaction = {sender, now_ms};
+  sender->transaction_ids()->insert(transaction_id);
+}
+
+void SharedUdpSocketFactory::Listener::SetRoute(const SocketAddress& addr,
+                                                SharedSocket* socket,
+                                                bool take_over) {
+  auto result = routes_.insert(std::make_pair(addr, socket));
+  if (!result.second) {
+    SharedSocket* owner = result.first->second;
+    if (owner == socket || !take_over) {
+      return;
+    }
+    owner->routes()->erase(addr);
+    result.first->second = socket;
+  }
+  socket->routes()->insert(addr);
+}
+
+void SharedUdpSocketFactory::Listener::PruneTransactions(int64_t now_ms) {
+  for (auto it = transactions_.begin(); it != transactions_.end();) {
+    if (now_ms - it->second.time_ms > kTransactionTimeoutMs) {
+      it->second.socket->transaction_ids()->erase(it->first);
+      it = transactions_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  next_prune_size_ =
+      std::max(kMinTransactionsToPrune, 2 * transactions_.size());
+}
+
+SharedUdpSocketFactory::SharedSocket*
+SharedUdpSocketFactory::Listener::FindReceiver(
+    const char* data,
+    size_t size,
+    const SocketAddress& remote_addr) {
+  cricket::StunMessageView stun;
+  if (stun.Parse(data, size)) {
+    int type = stun.type();
+    if (cricket::IsStunSuccessResponseType(type) ||
+        cricket::IsStunErrorResponseType(type)) {
+      auto it = transactions_.find(std::string(
+          stun.transaction_id(), cricket::kStunTransactionIdLength));
+      if (it != transactions_.end()) {
+        SharedSocket* receiver = it->second.socket;
+        receiver->transaction_ids()->erase(it->first);
+        transactions_.erase(it);
+        SetRoute(remote_addr, receiver, true);
+        return receiver;
+      }
+    } else if (cricket::IsStunRequestType(type)) {
+      // The USERNAME of a connectivity check is "<receiver>:<sender>".
+      size_t length = 0;
+      const char* username =
+          stun.GetAttribute(cricket::STUN_ATTR_USERNAME, &length);
+      if (username) {
+        const char* colon =
+            static_cast<const char*>(memchr(username, ':', length));
+        size_t ufrag_length = colon ? colon - username : length;
+        auto it = ice_ufrags_.find(std::string(username, ufrag_length));
+        if (it != ice_ufrags_.end()) {
+          SetRoute(remote_addr, it->second, true);
+          return it->second;
+        }
+      }
+    }
+  }
+  auto it = routes_.find(remote_addr);
+  return it != routes_.end() ? it->second : nullptr;
+}
+
+void SharedUdpSocketFactory::Listener::OnReadPacket(
+    AsyncPacketSocket* socket,
+    const char* data,
+    size_t size,
+    const SocketAddress& remote_addr,
+    const PacketTime& packet_time) {
+  RTC_DCHECK_EQ(socket_.get(), socket);
+  SharedSocket* receiver = FindReceiver(data, size, remote_addr);
+  if (!receiver) {
+    RTC_LOG(LS_VERBOSE) << "Dropping packet of " << size << " bytes from "
+                        << remote_addr.ToSensitiveString()
+                        << " that matches no socket.";
+    return;
+  }
+  receiver->SignalReadPacket(receiver, data, size, remote_addr, packet_time);
+}
+
+void SharedUdpSocketFactory::Listener::OnSentPacket(
+    AsyncPacketSocket* socket,
+    const SentPacket& sent_packet) {
+  if (sender_) {
+    sender_->SignalSentPacket(sender_, sent_packet);
+  }
+}
+
+void SharedUdpSocketFactory::Listener::OnReadyToSend(
+    AsyncPacketSocket* socket) {
+  // A handler may close other sockets.
+  std::vector<AsyncPacketSocket*> sockets(sockets_.begin(), sockets_.end());
+  for (AsyncPacketSocket* shared_socket : sockets) {
+    if (HasSocket(shared_socket)) {
+      shared_socket->SignalReadyToSend(shared_socket);
+    }
+  }
+}
+
+void SharedUdpSocketFactory::Listener::OnAddressReady(
+    AsyncPacketSocket* socket,
+    const SocketAddress& address) {
+  std::vector<AsyncPacketSocket*> sockets(sockets_.begin(), sockets_.end());
+  for (AsyncPacketSocket* shared_socket : sockets) {
+    if (HasSocket(shared_socket)) {
+      shared_socket->SignalAddressReady(shared_socket, address);
+    }
+  }
+}
+
+SharedUdpSocketFactory::SharedUdpSocketFactory(
+    PacketSocketFactory* base_factory)
+    : base_factory_(base_factory) {
+  RTC_DCHECK(base_factory_);
+}
+
+SharedUdpSocketFactory::~SharedUdpSocketFactory() {}
+
+AsyncPacketSocket* SharedUdpSocketFactory::CreateUdpSocket(
+    const SocketAddress& address,
+    uint16_t min_port,
+    uint16_t max_port) {
+  auto it = listeners_.find(address.ipaddr());
+  if (it == listeners_.end()) {
+    AsyncPacketSocket* socket =
+        base_factory_->CreateUdpSocket(address, min_port, max_port);
+    if (!socket) {
+      return nullptr;
+    }
+    it = listeners_
+             .insert(std::make_pair(address.ipaddr(),
+                                    std::unique_ptr<Listener>(
+                                        new Listener(socket))))
+             .first;
+  }
+  return new SharedSocket(it->second.get());
+}
+
+AsyncPacketSocket* SharedUdpSocketFactory::CreateServerTcpSocket(
+    const SocketAddress& local_address,
+    uint16_t min_port,
+    uint16_t max_port,
+    int opts) {
+  return base_factory_->CreateServerTcpSocket(local_address, min_port,
+                                              max_port, opts);
+}
+
+AsyncPacketSocket* SharedUdpSocketFactory::CreateClientTcpSocket(
+    const SocketAddress& local_address,
+    const SocketAddress& remote_address,
+    const ProxyInfo& proxy_info,
+    const std::string& user_agent,
+    int opts) {
+  return base_factory_->CreateClientTcpSocket(
+      local_address, remote_address, proxy_info, user_agent, opts);
+}
+
+AsyncPacketSocket* SharedUdpSocketFactory::CreateClientTcpSocket(
+    const SocketAddress& local_address,
+    const SocketAddress& remote_address,
+    const ProxyInfo& proxy_info,
+    const std::string& user_agent,
+    const PacketSocketTcpOptions& tcp_options) {
+  return base_factory_->CreateClientTcpSocket(
+      local_address, remote_address, proxy_info, user_agent, tcp_options);
+}
+
+AsyncResolverInterface* SharedUdpSocketFactory::CreateAsyncResolver() {
+  return base_factory_->CreateAsyncResolver();
+}
+
+void SharedUdpSocketFactory::SetUdpSocketIceUfrag(
+    AsyncPacketSocket* socket,
+    const std::string& ice_ufrag) {
+  for (const auto& listener : listeners_) {
+    if (listener.second->HasSocket(socket)) {
+      listener.second->SetIceUfrag(static_cast<SharedSocket*>(socket),
+                                   ice_ufrag);
+      return;
+    }
+  }
+}
+
+}  // namespace rtc
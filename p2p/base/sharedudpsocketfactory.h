@@ -0,0 +1,98 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef P2P_BASE_SHAREDUDPSOCKETFACTORY_H_
+#define P2P_BASE_SHAREDUDPSOCKETFACTORY_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "p2p/base/packetsocketfactory.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/ipaddress.h"
+
+namespace rtc {
+
+// A PacketSocketFactory for servers with many PeerConnections, such as media
+// servers, that gives every UDP port on an IP address the same underlying
+// socket. Instead of one socket (and one poll registration) per port, there is
+// one socket per local IP address, which all the ports' host candidates share.
+//
+// The UDP sockets it returns are lightweight views of the shared socket. An
+// incoming packet is delivered to one of them:
+//  - A STUN binding request goes to the port whose ICE username fragment is
+//    the prefix of its USERNAME, and its source address is remembered for
+//    that port.
+//  - A STUN response goes to the port that sent the matching request.
+//  - Anything else goes to the port that owns its source address. A port
+//    takes ownership of a remote address when a binding request for its
+//    ufrag, or the response to one of its requests, comes from there. An
+//    address that no port owns yet goes to the first port that sends to it.
+// Packets that match no port are dropped. Since the remote side sees one
+// 5-tuple for all the ports, only one port at a time can exchange anything
+// but STUN requests and responses with a given remote address; that also
+// means one TURN allocation per server. The ports learn their ufrags
+// through SetUdpSocketIceUfrag(), which UDPPort calls. Only one port per
+// ufrag can receive binding requests, so the PeerConnections have to use
+// rtcp-mux. Socket options are set on the shared socket and so apply to all
+// ports on the address.
+//
+// TCP sockets and resolvers come from |base_factory|, which also creates the
+// shared sockets; the |min_port| and |max_port| of the first UDP socket on an
+// address choose its port. The shared sockets stay open until the factory is
+// destroyed, so the address of the host candidates doesn't change. One
+// instance is to be given to the port allocators of all the PeerConnections,
+// which must share the network thread; it is used on that thread only and
+// must outlive all the sockets it created.
+class SharedUdpSocketFactory : public PacketSocketFactory {
+ public:
+  explicit SharedUdpSocketFactory(PacketSocketFactory* base_factory);
+  ~SharedUdpSocketFactory() override;
+
+  AsyncPacketSocket* CreateUdpSocket(const SocketAddress& address,
+                                     uint16_t min_port,
+                                     uint16_t max_port) override;
+  AsyncPacketSocket* CreateServerTcpSocket(const SocketAddress& local_address,
+                                           uint16_t min_port,
+                                           uint16_t max_port,
+                                           int opts) override;
+  AsyncPacketSocket* CreateClientTcpSocket(const SocketAddress& local_address,
+                                           const SocketAddress& remote_address,
+                                           const ProxyInfo& proxy_info,
+                                           const std::string& user_agent,
+                                           int opts) override;
+  AsyncPacketSocket* CreateClientTcpSocket(
+      const SocketAddress& local_address,
+      const SocketAddress& remote_address,
+      const ProxyInfo& proxy_info,
+      const std::string& user_agent,
+      const PacketSocketTcpOptions& tcp_options) override;
+  AsyncResolverInterface* CreateAsyncResolver() override;
+  void SetUdpSocketIceUfrag(AsyncPacketSocket* socket,
+                            const std::string& ice_ufrag) override;
+
+  // The number of underlying UDP sockets, i.e. of local IP addresses that UDP
+  // sockets were created for.
+  size_t num_shared_sockets() const { return listeners_.size(); }
+
+ private:
+  class Listener;
+  class SharedSocket;
+
+  PacketSocketFactory* const base_factory_;
+  std::map<IPAddress, std::unique_ptr<Listener>> listeners_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SharedUdpSocketFactory);
+};
+
+}  // namespace rtc
+
+#endif  // P2P_BASE_SHAREDUDPSOCKETFACTORY_H_
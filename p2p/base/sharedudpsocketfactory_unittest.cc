@@ -0,0 +1,220 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/sharedudpsocketfactory.h"
+#include "p2p/base/stun.h"
+#include "rtc_base/asyncudpsocket.h"
+#include "rtc_base/bytebuffer.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/virtualsocketserver.h"
+
+namespace rtc {
+
+namespace {
+
+const int kTimeoutMs = 1000;
+const SocketAddress kLocalAddress("11.11.11.11", 0);
+const SocketAddress kLocalAddress2("22.22.22.22", 0);
+const SocketAddress kPeerAddress("33.33.33.33", 5000);
+const SocketAddress kPeerAddress2("44.44.44.44", 5000);
+
+std::string CreateStunMessage(int type,
+                              const std::string& transaction_id,
+                              const std::string& username) {
+  cricket::StunMessage message;
+  message.SetType(type);
+  message.SetTransactionID(transaction_id);
+  if (!username.empty()) {
+    message.AddAttribute(rtc::MakeUnique<cricket::StunByteStringAttribute>(
+        cricket::STUN_ATTR_USERNAME, username));
+  }
+  ByteBufferWriter buf;
+  message.Write(&buf);
+  return std::string(buf.Data(), buf.Length());
+}
+
+}  // namespace
+
+class SharedUdpSocketFactoryTest : public testing::Test,
+                                   public sigslot::has_slots<> {
+ public:
+  SharedUdpSocketFactoryTest()
+      : thread_(&vss_),
+        base_factory_(&vss_),
+        factory_(&base_factory_),
+        peer_(AsyncUDPSocket::Create(&vss_, kPeerAddress)),
+        peer2_(AsyncUDPSocket::Create(&vss_, kPeerAddress2)) {}
+
+  AsyncPacketSocket* CreateSocket(const SocketAddress& address) {
+    AsyncPacketSocket* socket = factory_.CreateUdpSocket(address, 0, 0);
+    if (socket) {
+      socket->SignalReadPacket.connect(
+          this, &SharedUdpSocketFactoryTest::OnReadPacket);
+    }
+    return socket;
+  }
+
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time) {
+    ++received_[socket];
+  }
+
+  void SendFromPeer(AsyncPacketSocket* peer,
+                    const std::string& data,
+                    const SocketAddress& addr) {
+    peer->SendTo(data.data(), data.size(), addr, PacketOptions());
+  }
+
+ protected:
+  VirtualSocketServer vss_;
+  AutoSocketServerThread thread_;
+  BasicPacketSocketFactory base_factory_;
+  SharedUdpSocketFactory factory_;
+  std::unique_ptr<AsyncUDPSocket> peer_;
+  std::unique_ptr<AsyncUDPSocket> peer2_;
+  std::map<AsyncPacketSocket*, int> received_;
+};
+
+TEST_F(SharedUdpSocketFactoryTest, SocketsShareOneSocketPerAddress) {
+  std::unique_ptr<AsyncPacketSocket> socket1(CreateSocket(kLocalAddress));
+  std::unique_ptr<AsyncPacketSocket> socket2(CreateSocket(kLocalAddress));
+  std::unique_ptr<AsyncPacketSocket> socket3(CreateSocket(kLocalAddress2));
+  ASSERT_TRUE(socket1 && socket2 && socket3);
+  EXPECT_EQ(2u, factory_.num_shared_sockets());
+  EXPECT_EQ(socket1->GetLocalAddress(), socket2->GetLocalAddress());
+  EXPECT_NE(0, socket1->GetLocalAddress().port());
+  EXPECT_EQ(kLocalAddress2.ipaddr(), socket3->GetLocalAddress().ipaddr());
+  EXPECT_EQ(AsyncPacketSocket::STATE_BOUND, socket1->GetState());
+}
+
+TEST_F(SharedUdpSocketFactoryTest, RoutesBindingRequestsByUfrag) {
+  std::unique_ptr<AsyncPacketSocket> socket1(CreateSocket(kLocalAddress));
+  std::unique_ptr<AsyncPacketSocket> socket2(CreateSocket(kLocalAddress));
+  factory_.SetUdpSocketIceUfrag(socket1.get(), "ufrag1");
+  factory_.SetUdpSocketIceUfrag(socket2.get(), "ufrag2");
+  const SocketAddress local_address = socket1->GetLocalAddress();
+
+  SendFromPeer(peer_.get(),
+               CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                 "0123456789ab", "ufrag2:peer"),
+               local_address);
+  EXPECT_EQ_WAIT(1, received_[socket2.get()], kTimeoutMs);
+  EXPECT_EQ(0, received_[socket1.get()]);
+
+  // Media from the same address goes to the same socket.
+  SendFromPeer(peer_.get(), "media", local_address);
+  EXPECT_EQ_WAIT(2, received_[socket2.get()], kTimeoutMs);
+
+  // Unknown ufrags and addresses are dropped.
+  SendFromPeer(peer2_.get(),
+               CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                 "0123456789ab", "ufrag3:peer"),
+               local_address);
+  SendFromPeer(peer2_.get(), "media", local_address);
+  SendFromPeer(peer_.get(), "media", local_address);
+  EXPECT_EQ_WAIT(3, received_[socket2.get()], kTimeoutMs);
+  EXPECT_EQ(0, received_[socket1.get()]);
+}
+
+TEST_F(SharedUdpSocketFactoryTest, ChangedUfragReplacesOldUfrag) {
+  std::unique_ptr<AsyncPacketSocket> socket(CreateSocket(kLocalAddress));
+  factory_.SetUdpSocketIceUfrag(socket.get(), "old");
+  factory_.SetUdpSocketIceUfrag(socket.get(), "new");
+
+  SendFromPeer(peer_.get(),
+               CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                 "0123456789ab", "old:peer"),
+               socket->GetLocalAddress());
+  SendFromPeer(peer_.get(),
+               CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                 "0123456789ab", "new:peer"),
+               socket->GetLocalAddress());
+  EXPECT_EQ_WAIT(1, received_[socket.get()], kTimeoutMs);
+}
+
+TEST_F(SharedUdpSocketFactoryTest, RoutesResponsesByTransactionId) {
+  std::unique_ptr<AsyncPacketSocket> socket1(CreateSocket(kLocalAddress));
+  std::unique_ptr<AsyncPacketSocket> socket2(CreateSocket(kLocalAddress));
+  const SocketAddress local_address = socket1->GetLocalAddress();
+
+  // Both sockets send requests to the same server, e.g. a STUN server.
+  std::string request1 = CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                           "transaction1", std::string());
+  std::string request2 = CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                           "transaction2", std::string());
+  socket1->SendTo(request1.data(), request1.size(), kPeerAddress,
+                  PacketOptions());
+  socket2->SendTo(request2.data(), request2.size(), kPeerAddress,
+                  PacketOptions());
+
+  SendFromPeer(peer_.get(),
+               CreateStunMessage(cricket::STUN_BINDING_RESPONSE,
+                                 "transaction1", std::string()),
+               local_address);
+  EXPECT_EQ_WAIT(1, received_[socket1.get()], kTimeoutMs);
+  EXPECT_EQ(0, received_[socket2.get()]);
+
+  // Other packets go to the socket whose request was answered from the
+  // address, even though the other socket sent to it last.
+  SendFromPeer(peer_.get(), "media", local_address);
+  EXPECT_EQ_WAIT(2, received_[socket1.get()], kTimeoutMs);
+  EXPECT_EQ(0, received_[socket2.get()]);
+}
+
+TEST_F(SharedUdpSocketFactoryTest, SendingDoesNotTakeOverAnAddress) {
+  std::unique_ptr<AsyncPacketSocket> socket1(CreateSocket(kLocalAddress));
+  std::unique_ptr<AsyncPacketSocket> socket2(CreateSocket(kLocalAddress));
+  const SocketAddress local_address = socket1->GetLocalAddress();
+
+  ASSERT_LT(0, socket1->SendTo("x", 1, kPeerAddress, PacketOptions()));
+  ASSERT_LT(0, socket2->SendTo("x", 1, kPeerAddress, PacketOptions()));
+  SendFromPeer(peer_.get(), "media", local_address);
+  EXPECT_EQ_WAIT(1, received_[socket1.get()], kTimeoutMs);
+
+  // Once the first socket is closed, the address is free for the other.
+  socket1.reset();
+  ASSERT_LT(0, socket2->SendTo("x", 1, kPeerAddress, PacketOptions()));
+  SendFromPeer(peer_.get(), "media", local_address);
+  EXPECT_EQ_WAIT(1, received_[socket2.get()], kTimeoutMs);
+}
+
+TEST_F(SharedUdpSocketFactoryTest, ClosedSocketReceivesNothing) {
+  std::unique_ptr<AsyncPacketSocket> socket1(CreateSocket(kLocalAddress));
+  std::unique_ptr<AsyncPacketSocket> socket2(CreateSocket(kLocalAddress));
+  factory_.SetUdpSocketIceUfrag(socket1.get(), "ufrag1");
+  const SocketAddress local_address = socket1->GetLocalAddress();
+  ASSERT_LT(0, socket1->SendTo("x", 1, kPeerAddress, PacketOptions()));
+
+  socket1.reset();
+  SendFromPeer(peer_.get(),
+               CreateStunMessage(cricket::STUN_BINDING_REQUEST,
+                                 "0123456789ab", "ufrag1:peer"),
+               local_address);
+  SendFromPeer(peer_.get(), "media", local_address);
+  // A socket created afterwards still shares the address.
+  std::unique_ptr<AsyncPacketSocket> socket3(CreateSocket(kLocalAddress));
+  EXPECT_EQ(local_address, socket3->GetLocalAddress());
+  ASSERT_LT(0, socket3->SendTo("x", 1, kPeerAddress2, PacketOptions()));
+  SendFromPeer(peer2_.get(), "media", local_address);
+  EXPECT_EQ_WAIT(1, received_[socket3.get()], kTimeoutMs);
+  EXPECT_EQ(0, received_[socket2.get()]);
+  EXPECT_EQ(1u, factory_.num_shared_sockets());
+}
+
+}  // namespace rtc
@@ -12,14 +12,20 @@
 
 #include <string.h>
 
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "rtc_base/byteorder.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/crc32.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/messagedigest.h"
+#include "rtc_base/openssldigest.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/stringencode.h"
 
@@ -46,6 +52,135 @@ const uint32_t STUN_FINGERPRINT_XOR_VALUE = 0x5354554E;
 
 // StunMessage
 
+namespace {
+
+// A connection checks and signs its packets with one or two passwords for as
+// long as it lives, so each thread keeps the HMAC-SHA1 of the last few of
+// them with the key already hashed into the pads.
+class HmacCache {
+ public:
+  rtc::OpenSSLHmac* Get(const char* key, size_t key_len) {
+    for (Entry& entry : entries_) {
+      if (entry.key.size() == key_len &&
+          memcmp(entry.key.data(), key, key_len) == 0) {
+        return entry.hmac.get();
+      }
+    }
+    if (entries_.size() < kMaxEntries) {
+      entries_.emplace_back();
+    }
+    Entry& entry = entries_[next_ % entries_.size()];
+    ++next_;
+    entry.key.assign(key, key_len);
+    entry.hmac.reset(new rtc::OpenSSLHmac(rtc::DIGEST_SHA_1, key, key_len));
+    return entry.hmac.get();
+  }
+
+ private:
+  static const size_t kMaxEntries = 8;
+
+  struct Entry {
+    std::string key;
+    std::unique_ptr<rtc::OpenSSLHmac> hmac;
+  };
+  std::vector<Entry> entries_;
+  size_t next_ = 0;
+};
+
+#if defined(WEBRTC_POSIX)
+pthread_key_t g_hmac_cache_tls = 0;
+
+void DeleteHmacCache(void* value) {
+  delete static_cast<HmacCache*>(value);
+}
+
+void InitializeHmacCacheTls() {
+  RTC_CHECK(pthread_key_create(&g_hmac_cache_tls, &DeleteHmacCache) == 0);
+}
+#endif
+
+// Returns the cache of the current thread, or null where there are none.
+HmacCache* CurrentHmacCache() {
+#if defined(WEBRTC_POSIX)
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK(pthread_once(&init_once, &InitializeHmacCacheTls) == 0);
+  HmacCache* cache =
+      static_cast<HmacCache*>(pthread_getspecific(g_hmac_cache_tls));
+  if (!cache) {
+    cache = new HmacCache();
+    pthread_setspecific(g_hmac_cache_tls, cache);
+  }
+  return cache;
+#else
+  return nullptr;
+#endif
+}
+
+// Computes the HMAC-SHA1 that MESSAGE-INTEGRITY holds of |prefix| followed by
+// |input| into the kStunMessageIntegritySize bytes of |hmac|.
+bool ComputeStunHmac(const char* key,
+                     size_t key_len,
+                     const void* prefix,
+                     size_t prefix_len,
+                     const void* input,
+                     size_t in_len,
+                     char* hmac) {
+  size_t ret;
+  HmacCache* cache = CurrentHmacCache();
+  if (cache) {
+    ret = cache->Get(key, key_len)
+              ->Compute(prefix, prefix_len, input, in_len, hmac,
+                        kStunMessageIntegritySize);
+  } else {
+    std::unique_ptr<rtc::MessageDigest> digest(
+        rtc::MessageDigestFactory::Create(rtc::DIGEST_SHA_1));
+    if (!digest)
+      return false;
+    ret = rtc::ComputeHmac(digest.get(), key, key_len, prefix, prefix_len,
+                           input, in_len, hmac, kStunMessageIntegritySize);
+  }
+  RTC_DCHECK(ret == kStunMessageIntegritySize);
+  return ret == kStunMessageIntegritySize;
+}
+
+// Checks the MESSAGE-INTEGRITY attribute that starts |mi_pos| bytes into the
+// |size| byte message in |data|. The HMAC covers everything before the
+// attribute, with the header length field adjusted to end right after it.
+// Only the header is copied, so that the length can be patched.
+bool ValidateMessageIntegrityAt(const char* data,
+                                size_t size,
+                                size_t mi_pos,
+                                const std::string& password) {
+  RTC_DCHECK_GE(mi_pos, kStunHeaderSize);
+  RTC_DCHECK_LE(mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize,
+                size);
+  // Writing the adjusted length of the STUN message @ Message Length.
+  //      0                   1                   2                   3
+  //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  //     |0 0|     STUN Message Type     |         Message Length        |
+  //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+  char header[kStunHeaderSize];
+  memcpy(header, data, kStunHeaderSize);
+  rtc::SetBE16(header + 2,
+               static_cast<uint16_t>(mi_pos + kStunAttributeHeaderSize +
+                                     kStunMessageIntegritySize -
+                                     kStunHeaderSize));
+
+  char hmac[kStunMessageIntegritySize];
+  if (!ComputeStunHmac(password.c_str(), password.size(), header,
+                       sizeof(header), data + kStunHeaderSize,
+                       mi_pos - kStunHeaderSize, hmac)) {
+    return false;
+  }
+
+  // Comparing the calculated HMAC with the one present in the message.
+  return memcmp(data + mi_pos + kStunAttributeHeaderSize, hmac,
+                sizeof(hmac)) == 0;
+}
+
+}  // namespace
+
 StunMessage::StunMessage()
     : type_(0),
       length_(0),
@@ -205,39 +340,7 @@ bool StunMessage::ValidateMessageIntegrity(const char* data, size_t size,
     return false;
   }
 
-  // Getting length of the message to calculate Message Integrity.
-  size_t mi_pos = current_pos;
-  std::unique_ptr<char[]> temp_data(new char[current_pos]);
-  memcpy(temp_data.get(), data, current_pos);
-  if (size > mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize) {
-    // Stun message has other attributes after message integrity.
-    // Adjust the length parameter in stun message to calculate HMAC.
-    size_t extra_offset = size -
-        (mi_pos + kStunAttributeHeaderSize + kStunMessageIntegritySize);
-    size_t new_adjusted_len = size - extra_offset - kStunHeaderSize;
-
-    // Writing new length of the STUN message @ Message Length in temp buffer.
-    //      0                   1                   2                   3
-    //      0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    //     |0 0|     STUN Message Type     |         Message Length        |
-    //     +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
-    rtc::SetBE16(temp_data.get() + 2, static_cast<uint16_t>(new_adjusted_len));
-  }
-
-  char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      password.c_str(), password.size(),
-                                      temp_data.get(), mi_pos,
-                                      hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac))
-    return false;
-
-  // Comparing the calculated HMAC with the one present in the message.
-  return memcmp(data + current_pos + kStunAttributeHeaderSize,
-                hmac,
-                sizeof(hmac)) == 0;
+  return ValidateMessageIntegrityAt(data, size, current_pos, password);
 }
 
 bool StunMessage::AddMessageIntegrity(const std::string& password) {
@@ -261,12 +364,8 @@ bool StunMessage::AddMessageIntegrity(const char* key,
   int msg_len_for_hmac = static_cast<int>(
       buf.Length() - kStunAttributeHeaderSize - msg_integrity_attr->length());
   char hmac[kStunMessageIntegritySize];
-  size_t ret = rtc::ComputeHmac(rtc::DIGEST_SHA_1,
-                                      key, keylen,
-                                      buf.Data(), msg_len_for_hmac,
-                                      hmac, sizeof(hmac));
-  RTC_DCHECK(ret == sizeof(hmac));
-  if (ret != sizeof(hmac)) {
+  if (!ComputeStunHmac(key, keylen, nullptr, 0, buf.Data(), msg_len_for_hmac,
+                       hmac)) {
     RTC_LOG(LS_ERROR) << "HMAC computation failed. Message-Integrity "
                          "has dummy value.";
     return false;
@@ -466,6 +565,77 @@ bool StunMessage::IsValidTransactionId(const std::string& transaction_id) {
       transaction_id.size() == kStunLegacyTransactionIdLength;
 }
 
+// StunMessageView
+
+StunMessageView::StunMessageView()
+    : data_(nullptr), size_(0), type_(0), num_attributes_(0) {}
+
+bool StunMessageView::Parse(const char* data, size_t size) {
+  data_ = data;
+  size_ = size;
+  num_attributes_ = 0;
+  if (size < kStunHeaderSize || (size % 4) != 0)
+    return false;
+
+  type_ = rtc::GetBE16(data);
+  // RTP and RTCP set the MSB of the first byte; see StunMessage::Read().
+  if (type_ & 0x8000)
+    return false;
+  if (rtc::GetBE16(data + 2) + kStunHeaderSize != size)
+    return false;
+  if (rtc::GetBE32(data + kStunTransactionIdOffset - kStunMagicCookieLength) !=
+      kStunMagicCookie) {
+    return false;
+  }
+
+  size_t pos = kStunHeaderSize;
+  while (pos < size) {
+    if (pos + kStunAttributeHeaderSize > size ||
+        num_attributes_ == kMaxAttributes) {
+      return false;
+    }
+    Attribute& attr = attributes_[num_attributes_++];
+    attr.type = rtc::GetBE16(data + pos);
+    attr.length = rtc::GetBE16(data + pos + 2);
+    attr.offset = static_cast<uint32_t>(pos);
+    size_t padded_length = attr.length;
+    if ((padded_length % 4) != 0) {
+      padded_length += (4 - (padded_length % 4));
+    }
+    pos += kStunAttributeHeaderSize + padded_length;
+  }
+  return pos == size;
+}
+
+const StunMessageView::Attribute* StunMessageView::FindAttribute(
+    int type) const {
+  for (size_t i = 0; i < num_attributes_; ++i) {
+    if (attributes_[i].type == type)
+      return &attributes_[i];
+  }
+  return nullptr;
+}
+
+const char* StunMessageView::GetAttribute(int type, size_t* length) const {
+  const Attribute* attr = FindAttribute(type);
+  if (!attr)
+    return nullptr;
+  *length = attr->length;
+  return data_ + attr->offset + kStunAttributeHeaderSize;
+}
+
+bool StunMessageView::HasAttribute(int type) const {
+  return FindAttribute(type) != nullptr;
+}
+
+bool StunMessageView::ValidateMessageIntegrity(
+    const std::string& password) const {
+  const Attribute* attr = FindAttribute(STUN_ATTR_MESSAGE_INTEGRITY);
+  if (!attr || attr->length != kStunMessageIntegritySize)
+    return false;
+  return ValidateMessageIntegrityAt(data_, size_, attr->offset, password);
+}
+
 // StunAttribute
 
 StunAttribute::StunAttribute(uint16_t type, uint16_t length)
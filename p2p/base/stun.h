@@ -213,6 +213,54 @@ class StunMessage {
   uint32_t stun_magic_cookie_;
 };
 
+// A non-owning view over a serialized RFC 5389 STUN message. Parse() indexes
+// the attributes in place, so that connectivity checks and keepalives can be
+// inspected and authenticated without building a StunMessage and allocating
+// its attributes. The viewed buffer must outlive the view.
+class StunMessageView {
+ public:
+  // Messages with more attributes than this are left to StunMessage.
+  static const size_t kMaxAttributes = 16;
+
+  StunMessageView();
+
+  // Returns false if |data| isn't a complete RFC 5389 message or has more
+  // than kMaxAttributes attributes. Does not check the FINGERPRINT; use
+  // StunMessage::ValidateFingerprint() for that.
+  bool Parse(const char* data, size_t size);
+
+  int type() const { return type_; }
+  // Points at the kStunTransactionIdLength bytes of the transaction ID.
+  const char* transaction_id() const {
+    return data_ + kStunTransactionIdOffset;
+  }
+
+  // Returns the value of the first attribute of the given type and stores its
+  // length in |length|, or returns null if there is no such attribute.
+  const char* GetAttribute(int type, size_t* length) const;
+  bool HasAttribute(int type) const;
+
+  // Same result as StunMessage::ValidateMessageIntegrity(), without copying
+  // the message.
+  bool ValidateMessageIntegrity(const std::string& password) const;
+
+ private:
+  struct Attribute {
+    uint16_t type;
+    uint16_t length;
+    // Offset of the attribute header from the start of the message.
+    uint32_t offset;
+  };
+
+  const Attribute* FindAttribute(int type) const;
+
+  const char* data_;
+  size_t size_;
+  uint16_t type_;
+  size_t num_attributes_;
+  Attribute attributes_[kMaxAttributes];
+};
+
 // Base class for all STUN/TURN attributes.
 class StunAttribute {
  public:
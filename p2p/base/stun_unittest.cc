@@ -1238,6 +1238,57 @@ TEST_F(StunTest, ValidateMessageIntegrity) {
   }
 }
 
+// Check that StunMessageView indexes the RFC5769 sample request in place and
+// authenticates it the same way StunMessage::ValidateMessageIntegrity does.
+TEST_F(StunTest, MessageViewParsesAndValidatesRequest) {
+  const char* data = reinterpret_cast<const char*>(kRfc5769SampleRequest);
+  StunMessageView view;
+  ASSERT_TRUE(view.Parse(data, sizeof(kRfc5769SampleRequest)));
+  EXPECT_EQ(STUN_BINDING_REQUEST, view.type());
+  EXPECT_EQ(0, memcmp(view.transaction_id(), kRfc5769SampleMsgTransactionId,
+                      kStunTransactionIdLength));
+
+  size_t length = 0;
+  const char* username = view.GetAttribute(STUN_ATTR_USERNAME, &length);
+  ASSERT_TRUE(username != NULL);
+  EXPECT_EQ(kRfc5769SampleMsgUsername, std::string(username, length));
+  EXPECT_TRUE(view.HasAttribute(STUN_ATTR_FINGERPRINT));
+  EXPECT_FALSE(view.HasAttribute(STUN_ATTR_USE_CANDIDATE));
+  EXPECT_TRUE(view.GetAttribute(STUN_ATTR_USE_CANDIDATE, &length) == NULL);
+
+  EXPECT_TRUE(view.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+  EXPECT_FALSE(view.ValidateMessageIntegrity("InvalidPassword"));
+
+  // Munging any bit before the M-I value must fail authentication.
+  char buf[sizeof(kRfc5769SampleRequest)];
+  memcpy(buf, kRfc5769SampleRequest, sizeof(kRfc5769SampleRequest));
+  for (size_t i = kStunHeaderSize; i < sizeof(buf) - 8; ++i) {
+    buf[i] ^= 0x01;
+    StunMessageView munged;
+    EXPECT_FALSE(munged.Parse(buf, sizeof(buf)) &&
+                 munged.ValidateMessageIntegrity(kRfc5769SampleMsgPassword));
+    buf[i] ^= 0x01;
+  }
+}
+
+TEST_F(StunTest, MessageViewRejectsMalformedMessages) {
+  StunMessageView view;
+  EXPECT_FALSE(view.Parse(reinterpret_cast<const char*>(kRtcpPacket),
+                          sizeof(kRtcpPacket)));
+  EXPECT_FALSE(
+      view.Parse(reinterpret_cast<const char*>(kStunMessageWithExcessLength),
+                 sizeof(kStunMessageWithExcessLength)));
+  EXPECT_FALSE(
+      view.Parse(reinterpret_cast<const char*>(kStunMessageWithSmallLength),
+                 sizeof(kStunMessageWithSmallLength)));
+  EXPECT_FALSE(
+      view.Parse(reinterpret_cast<const char*>(kStunMessageWithBadHmacAtEnd),
+                 sizeof(kStunMessageWithBadHmacAtEnd)));
+  // Truncated in the middle of an attribute.
+  EXPECT_FALSE(view.Parse(reinterpret_cast<const char*>(kRfc5769SampleRequest),
+                          kStunHeaderSize + 4));
+}
+
 // Validate that we generate correct MESSAGE-INTEGRITY attributes.
 // Note the use of IceMessage instead of StunMessage; this is necessary because
 // the RFC5769 test messages used include attributes not found in basic STUN.
@@ -218,6 +218,7 @@ bool UDPPort::Init() {
   socket_->SignalReadyToSend.connect(this, &UDPPort::OnReadyToSend);
   socket_->SignalAddressReady.connect(this, &UDPPort::OnLocalAddressReady);
   requests_.SignalSendPacket.connect(this, &UDPPort::OnSendPacket);
+  socket_factory()->SetUdpSocketIceUfrag(socket_, username_fragment());
   return true;
 }
 
@@ -279,11 +280,31 @@ int UDPPort::SendTo(const void* data, size_t size,
   return sent;
 }
 
+int UDPPort::SendToBatch(rtc::OutgoingPacket* packets,
+                         size_t count,
+                         bool payload) {
+  for (size_t i = 0; i < count; ++i) {
+    CopyPortInformationToPacketInfo(
+        &packets[i].options.info_signaled_after_sent);
+  }
+  int sent = socket_->SendToBatch(packets, count);
+  if (sent < 0) {
+    error_ = socket_->GetError();
+    RTC_LOG(LS_ERROR) << ToString() << ": UDP send of a batch of " << count
+                      << " packets failed with error " << error_;
+  }
+  return sent;
+}
+
 void UDPPort::UpdateNetworkCost() {
   Port::UpdateNetworkCost();
   stun_keepalive_lifetime_ = GetStunKeepaliveLifetime();
 }
 
+void UDPPort::UpdateIceParametersInternal() {
+  socket_factory()->SetUdpSocketIceUfrag(socket_, username_fragment());
+}
+
 int UDPPort::SetOption(rtc::Socket::Option opt, int value) {
   return socket_->SetOption(opt, value);
 }
@@ -149,8 +149,12 @@ class UDPPort : public Port {
              const rtc::SocketAddress& addr,
              const rtc::PacketOptions& options,
              bool payload) override;
+  int SendToBatch(rtc::OutgoingPacket* packets,
+                  size_t count,
+                  bool payload) override;
 
   void UpdateNetworkCost() override;
+  void UpdateIceParametersInternal() override;
 
   void OnLocalAddressReady(rtc::AsyncPacketSocket* socket,
                            const rtc::SocketAddress& address);
@@ -10,6 +10,8 @@
 
 #include "p2p/base/turnport.h"
 
+#include <string.h>
+
 #include <algorithm>
 #include <functional>
 #include <utility>
@@ -1690,35 +1692,44 @@ void TurnEntry::SendChannelBindRequest(int delay) {
 
 int TurnEntry::Send(const void* data, size_t size, bool payload,
                     const rtc::PacketOptions& options) {
+  if (state_ == STATE_BOUND &&
+      port_->TurnCustomizerAllowChannelData(data, size, payload)) {
+    // If the channel is bound, we can send the data as a Channel Message. It
+    // is framed in a buffer that the port reuses, so that relayed media costs
+    // a copy but no allocation per packet.
+    rtc::Buffer& buffer = port_->channel_data_buffer_;
+    buffer.SetSize(TURN_CHANNEL_HEADER_SIZE + size);
+    rtc::SetBE16(buffer.data(), static_cast<uint16_t>(channel_id_));
+    rtc::SetBE16(buffer.data() + 2, static_cast<uint16_t>(size));
+    if (size > 0)
+      memcpy(buffer.data() + TURN_CHANNEL_HEADER_SIZE, data, size);
+    rtc::PacketOptions modified_options(options);
+    modified_options.info_signaled_after_sent.turn_overhead_bytes =
+        TURN_CHANNEL_HEADER_SIZE;
+    return port_->Send(buffer.data(), buffer.size(), modified_options);
+  }
+
+  // If we haven't bound the channel yet, we have to use a Send Indication.
+  // The turn_customizer_ can also make us use Send Indication.
+  TurnMessage msg;
+  msg.SetType(TURN_SEND_INDICATION);
+  msg.SetTransactionID(
+      rtc::CreateRandomString(kStunTransactionIdLength));
+  msg.AddAttribute(rtc::MakeUnique<StunXorAddressAttribute>(
+      STUN_ATTR_XOR_PEER_ADDRESS, ext_addr_));
+  msg.AddAttribute(
+      rtc::MakeUnique<StunByteStringAttribute>(STUN_ATTR_DATA, data, size));
+
+  port_->TurnCustomizerMaybeModifyOutgoingStunMessage(&msg);
+
   rtc::ByteBufferWriter buf;
-  if (state_ != STATE_BOUND ||
-      !port_->TurnCustomizerAllowChannelData(data, size, payload)) {
-    // If we haven't bound the channel yet, we have to use a Send Indication.
-    // The turn_customizer_ can also make us use Send Indication.
-    TurnMessage msg;
-    msg.SetType(TURN_SEND_INDICATION);
-    msg.SetTransactionID(
-        rtc::CreateRandomString(kStunTransactionIdLength));
-    msg.AddAttribute(rtc::MakeUnique<StunXorAddressAttribute>(
-        STUN_ATTR_XOR_PEER_ADDRESS, ext_addr_));
-    msg.AddAttribute(
-        rtc::MakeUnique<StunByteStringAttribute>(STUN_ATTR_DATA, data, size));
-
-    port_->TurnCustomizerMaybeModifyOutgoingStunMessage(&msg);
-
-    const bool success = msg.Write(&buf);
-    RTC_DCHECK(success);
-
-    // If we're sending real data, request a channel bind that we can use later.
-    if (state_ == STATE_UNBOUND && payload) {
-      SendChannelBindRequest(0);
-      state_ = STATE_BINDING;
-    }
-  } else {
-    // If the channel is bound, we can send the data as a Channel Message.
-    buf.WriteUInt16(channel_id_);
-    buf.WriteUInt16(static_cast<uint16_t>(size));
-    buf.WriteBytes(reinterpret_cast<const char*>(data), size);
+  const bool success = msg.Write(&buf);
+  RTC_DCHECK(success);
+
+  // If we're sending real data, request a channel bind that we can use later.
+  if (state_ == STATE_UNBOUND && payload) {
+    SendChannelBindRequest(0);
+    state_ = STATE_BINDING;
   }
   rtc::PacketOptions modified_options(options);
   modified_options.info_signaled_after_sent.turn_overhead_bytes =
@@ -1733,6 +1744,11 @@ void TurnEntry::OnCreatePermissionSuccess() {
   port_->SignalCreatePermissionResult(port_, ext_addr_,
                                       TURN_SUCCESS_RESULT_CODE);
 
+  if (port_->early_channel_binding() && state_ == STATE_UNBOUND) {
+    SendChannelBindRequest(0);
+    state_ = STATE_BINDING;
+  }
+
   // If |state_| is STATE_BOUND, the permission will be refreshed
   // by ChannelBindRequest.
   if (state_ != STATE_BOUND) {
@@ -22,6 +22,7 @@
 #include "p2p/client/basicportallocator.h"
 #include "rtc_base/asyncinvoker.h"
 #include "rtc_base/asyncpacketsocket.h"
+#include "rtc_base/buffer.h"
 #include "rtc_base/sslcertificate.h"
 
 namespace rtc {
@@ -110,6 +111,14 @@ class TurnPort : public Port {
   virtual std::vector<std::string> GetTlsAlpnProtocols() const;
   virtual std::vector<std::string> GetTlsEllipticCurves() const;
 
+  // If enabled, a channel is bound to each peer as soon as its permission has
+  // been created, instead of when the first payload is sent; media then goes
+  // out as ChannelData from the first packet.
+  bool early_channel_binding() const { return early_channel_binding_; }
+  void set_early_channel_binding(bool enable) {
+    early_channel_binding_ = enable;
+  }
+
   // Release a TURN allocation by sending a refresh with lifetime 0.
   // Sets state to STATE_RECEIVEONLY.
   void Release();
@@ -337,6 +346,11 @@ class TurnPort : public Port {
   // Optional TurnCustomizer that can modify outgoing messages.
   webrtc::TurnCustomizer *turn_customizer_ = nullptr;
 
+  bool early_channel_binding_ = false;
+  // Reused by TurnEntry::Send() to frame ChannelData messages without an
+  // allocation per packet.
+  rtc::Buffer channel_data_buffer_;
+
   friend class TurnEntry;
   friend class TurnAllocateRequest;
   friend class TurnRefreshRequest;
@@ -205,6 +205,9 @@ class TurnPortTest : public testing::Test,
                        const rtc::PacketTime& packet_time) {
     udp_packets_.push_back(rtc::Buffer(data, size));
   }
+  void OnTurnSentPacket(const rtc::SentPacket& sent_packet) {
+    turn_overhead_bytes_.push_back(sent_packet.info.turn_overhead_bytes);
+  }
   void OnSocketReadPacket(rtc::AsyncPacketSocket* socket,
                           const char* data, size_t size,
                           const rtc::SocketAddress& remote_addr,
@@ -756,6 +759,7 @@ class TurnPortTest : public testing::Test,
   bool turn_refresh_success_ = false;
   std::vector<rtc::Buffer> turn_packets_;
   std::vector<rtc::Buffer> udp_packets_;
+  std::vector<size_t> turn_overhead_bytes_;
   rtc::PacketOptions options;
   std::unique_ptr<webrtc::TurnCustomizer> turn_customizer_;
 };
@@ -1370,6 +1374,28 @@ TEST_F(TurnPortTest, TestChannelBindGetErrorResponse) {
   EXPECT_TRUE_SIMULATED_WAIT(!udp_packets_.empty(), kSimulatedRtt, fake_clock_);
 }
 
+// Tests that with early channel binding, the first payload already goes out
+// as ChannelData rather than in a Send indication.
+TEST_F(TurnPortTest, TestEarlyChannelBinding) {
+  CreateTurnPort(kTurnUsername, kTurnPassword, kTurnUdpProtoAddr);
+  turn_port_->set_early_channel_binding(true);
+  PrepareTurnAndUdpPorts(PROTO_UDP);
+  Connection* conn1 = turn_port_->CreateConnection(udp_port_->Candidates()[0],
+                                                   Port::ORIGIN_MESSAGE);
+  ASSERT_TRUE(conn1 != nullptr);
+  // Let the create permission and channel bind requests complete.
+  SIMULATED_WAIT(false, kSimulatedRtt * 3, fake_clock_);
+
+  turn_port_->SignalSentPacket.connect(static_cast<TurnPortTest*>(this),
+                                       &TurnPortTest::OnTurnSentPacket);
+  std::string data = "ABC";
+  conn1->Send(data.data(), data.length(), options);
+  ASSERT_EQ(1u, turn_overhead_bytes_.size());
+  // The 4-byte ChannelData header.
+  EXPECT_EQ(4u, turn_overhead_bytes_[0]);
+  turn_port_->SignalSentPacket.disconnect(static_cast<TurnPortTest*>(this));
+}
+
 // Do a TURN allocation, establish a UDP connection, and send some data.
 TEST_F(TurnPortTest, TestTurnSendDataTurnUdpToUdp) {
   // Create ports and prepare addresses.
@@ -26,6 +26,7 @@
 #include "rtc_base/socketadapters.h"
 #include "rtc_base/stringencode.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
 
 namespace cricket {
 
@@ -73,6 +74,9 @@ class TurnServerAllocation::Permission : public rtc::MessageHandler {
 
   rtc::Thread* thread_;
   rtc::IPAddress peer_;
+  // Refresh() only moves this forward; the pending timer is re-armed when it
+  // fires early, so refreshing doesn't have to clear and repost it.
+  int64_t expiration_ms_;
 };
 
 // Encapsulates a TURN channel binding.
@@ -96,6 +100,8 @@ class TurnServerAllocation::Channel : public rtc::MessageHandler {
   rtc::Thread* thread_;
   int id_;
   rtc::SocketAddress peer_;
+  // See Permission::expiration_ms_.
+  int64_t expiration_ms_;
 };
 
 static bool InitResponse(const StunMessage* req, StunMessage* resp) {
@@ -567,6 +573,10 @@ bool TurnServerConnection::operator<(const TurnServerConnection& c) const {
   return std::tie(src_, dst_, proto_) < std::tie(c.src_, c.dst_, c.proto_);
 }
 
+size_t TurnServerConnection::Hash() const {
+  return src_.Hash() ^ (dst_.Hash() * 31) ^ static_cast<size_t>(proto_);
+}
+
 std::string TurnServerConnection::ToString() const {
   const char* const kProtos[] = {
       "unknown", "udp", "tcp", "ssltcp"
@@ -591,13 +601,11 @@ TurnServerAllocation::TurnServerAllocation(TurnServer* server,
 }
 
 TurnServerAllocation::~TurnServerAllocation() {
-  for (ChannelList::iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    delete *it;
+  for (const auto& channel : channels_) {
+    delete channel.second;
   }
-  for (PermissionList::iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    delete *it;
+  for (const auto& perm : perms_) {
+    delete perm.second;
   }
   thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
   RTC_LOG(LS_INFO) << ToString() << ": Allocation destroyed";
@@ -780,7 +788,8 @@ void TurnServerAllocation::HandleChannelBindRequest(const TurnMessage* msg) {
     channel1 = new Channel(thread_, channel_id, peer_attr->GetAddress());
     channel1->SignalDestroyed.connect(this,
         &TurnServerAllocation::OnChannelDestroyed);
-    channels_.push_back(channel1);
+    channels_[channel_id] = channel1;
+    channel_peers_[peer_attr->GetAddress()] = channel1;
   } else {
     channel1->Refresh();
   }
@@ -867,7 +876,7 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
     perm = new Permission(thread_, addr);
     perm->SignalDestroyed.connect(
         this, &TurnServerAllocation::OnPermissionDestroyed);
-    perms_.push_back(perm);
+    perms_[addr] = perm;
   } else {
     perm->Refresh();
   }
@@ -875,32 +884,20 @@ void TurnServerAllocation::AddPermission(const rtc::IPAddress& addr) {
 
 TurnServerAllocation::Permission* TurnServerAllocation::FindPermission(
     const rtc::IPAddress& addr) const {
-  for (PermissionList::const_iterator it = perms_.begin();
-       it != perms_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  PermissionMap::const_iterator it = perms_.find(addr);
+  return (it != perms_.end()) ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     int channel_id) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->id() == channel_id)
-      return *it;
-  }
-  return NULL;
+  ChannelMap::const_iterator it = channels_.find(channel_id);
+  return (it != channels_.end()) ? it->second : NULL;
 }
 
 TurnServerAllocation::Channel* TurnServerAllocation::FindChannel(
     const rtc::SocketAddress& addr) const {
-  for (ChannelList::const_iterator it = channels_.begin();
-       it != channels_.end(); ++it) {
-    if ((*it)->peer() == addr)
-      return *it;
-  }
-  return NULL;
+  ChannelPeerMap::const_iterator it = channel_peers_.find(addr);
+  return (it != channel_peers_.end()) ? it->second : NULL;
 }
 
 void TurnServerAllocation::SendResponse(TurnMessage* msg) {
@@ -931,22 +928,23 @@ void TurnServerAllocation::OnMessage(rtc::Message* msg) {
 }
 
 void TurnServerAllocation::OnPermissionDestroyed(Permission* perm) {
-  PermissionList::iterator it = std::find(perms_.begin(), perms_.end(), perm);
-  RTC_DCHECK(it != perms_.end());
-  perms_.erase(it);
+  size_t erased = perms_.erase(perm->peer());
+  RTC_DCHECK_EQ(1, erased);
 }
 
 void TurnServerAllocation::OnChannelDestroyed(Channel* channel) {
-  ChannelList::iterator it =
-      std::find(channels_.begin(), channels_.end(), channel);
-  RTC_DCHECK(it != channels_.end());
-  channels_.erase(it);
+  size_t erased = channels_.erase(channel->id());
+  RTC_DCHECK_EQ(1, erased);
+  erased = channel_peers_.erase(channel->peer());
+  RTC_DCHECK_EQ(1, erased);
 }
 
 TurnServerAllocation::Permission::Permission(rtc::Thread* thread,
                                    const rtc::IPAddress& peer)
     : thread_(thread), peer_(peer) {
   Refresh();
+  thread_->PostDelayed(RTC_FROM_HERE, kPermissionTimeout, this,
+                       MSG_ALLOCATION_TIMEOUT);
 }
 
 TurnServerAllocation::Permission::~Permission() {
@@ -954,13 +952,17 @@ TurnServerAllocation::Permission::~Permission() {
 }
 
 void TurnServerAllocation::Permission::Refresh() {
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
-  thread_->PostDelayed(RTC_FROM_HERE, kPermissionTimeout, this,
-                       MSG_ALLOCATION_TIMEOUT);
+  expiration_ms_ = rtc::TimeMillis() + kPermissionTimeout;
 }
 
 void TurnServerAllocation::Permission::OnMessage(rtc::Message* msg) {
   RTC_DCHECK(msg->message_id == MSG_ALLOCATION_TIMEOUT);
+  int64_t remaining_ms = expiration_ms_ - rtc::TimeMillis();
+  if (remaining_ms > 0) {
+    thread_->PostDelayed(RTC_FROM_HERE, static_cast<int>(remaining_ms), this,
+                         MSG_ALLOCATION_TIMEOUT);
+    return;
+  }
   SignalDestroyed(this);
   delete this;
 }
@@ -969,6 +971,8 @@ TurnServerAllocation::Channel::Channel(rtc::Thread* thread, int id,
                              const rtc::SocketAddress& peer)
     : thread_(thread), id_(id), peer_(peer) {
   Refresh();
+  thread_->PostDelayed(RTC_FROM_HERE, kChannelTimeout, this,
+                       MSG_ALLOCATION_TIMEOUT);
 }
 
 TurnServerAllocation::Channel::~Channel() {
@@ -976,13 +980,17 @@ TurnServerAllocation::Channel::~Channel() {
 }
 
 void TurnServerAllocation::Channel::Refresh() {
-  thread_->Clear(this, MSG_ALLOCATION_TIMEOUT);
-  thread_->PostDelayed(RTC_FROM_HERE, kChannelTimeout, this,
-                       MSG_ALLOCATION_TIMEOUT);
+  expiration_ms_ = rtc::TimeMillis() + kChannelTimeout;
 }
 
 void TurnServerAllocation::Channel::OnMessage(rtc::Message* msg) {
   RTC_DCHECK(msg->message_id == MSG_ALLOCATION_TIMEOUT);
+  int64_t remaining_ms = expiration_ms_ - rtc::TimeMillis();
+  if (remaining_ms > 0) {
+    thread_->PostDelayed(RTC_FROM_HERE, static_cast<int>(remaining_ms), this,
+                         MSG_ALLOCATION_TIMEOUT);
+    return;
+  }
   SignalDestroyed(this);
   delete this;
 }
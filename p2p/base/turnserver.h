@@ -11,11 +11,11 @@
 #ifndef P2P_BASE_TURNSERVER_H_
 #define P2P_BASE_TURNSERVER_H_
 
-#include <list>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -52,6 +52,8 @@ class TurnServerConnection {
   rtc::AsyncPacketSocket* socket() { return socket_; }
   bool operator==(const TurnServerConnection& t) const;
   bool operator<(const TurnServerConnection& t) const;
+  // Hashes the fields compared by operator==.
+  size_t Hash() const;
   std::string ToString() const;
 
  private:
@@ -94,8 +96,22 @@ class TurnServerAllocation : public rtc::MessageHandler,
  private:
   class Channel;
   class Permission;
-  typedef std::list<Permission*> PermissionList;
-  typedef std::list<Channel*> ChannelList;
+  struct IPAddressHash {
+    size_t operator()(const rtc::IPAddress& addr) const {
+      return rtc::HashIP(addr);
+    }
+  };
+  struct AddressHash {
+    size_t operator()(const rtc::SocketAddress& addr) const {
+      return addr.Hash();
+    }
+  };
+  // Hashed, since every relayed packet looks up its permission or channel.
+  typedef std::unordered_map<rtc::IPAddress, Permission*, IPAddressHash>
+      PermissionMap;
+  typedef std::unordered_map<int, Channel*> ChannelMap;
+  typedef std::unordered_map<rtc::SocketAddress, Channel*, AddressHash>
+      ChannelPeerMap;
 
   void HandleAllocateRequest(const TurnMessage* msg);
   void HandleRefreshRequest(const TurnMessage* msg);
@@ -135,8 +151,10 @@ class TurnServerAllocation : public rtc::MessageHandler,
   std::string username_;
   std::string origin_;
   std::string last_nonce_;
-  PermissionList perms_;
-  ChannelList channels_;
+  PermissionMap perms_;
+  // The bound channels, by channel number and by peer address.
+  ChannelMap channels_;
+  ChannelPeerMap channel_peers_;
 };
 
 // An interface through which the MD5 credential hash can be retrieved.
@@ -171,7 +189,15 @@ class StunMessageObserver {
 // Not yet wired up: TCP support.
 class TurnServer : public sigslot::has_slots<> {
  public:
-  typedef std::map<TurnServerConnection, std::unique_ptr<TurnServerAllocation>>
+  struct ConnectionHash {
+    size_t operator()(const TurnServerConnection& conn) const {
+      return conn.Hash();
+    }
+  };
+  // Hashed, since every packet from a client is looked up here.
+  typedef std::unordered_map<TurnServerConnection,
+                             std::unique_ptr<TurnServerAllocation>,
+                             ConnectionHash>
       AllocationMap;
 
   explicit TurnServer(rtc::Thread* thread);
@@ -342,6 +342,21 @@ void BasicPortAllocatorSession::StartGettingPorts() {
 
 void BasicPortAllocatorSession::StopGettingPorts() {
   RTC_DCHECK(rtc::Thread::Current() == network_thread_);
+  if (flags() & PORTALLOCATOR_ENABLE_EARLY_RELAY) {
+    // The relay candidates that have not been allocated yet won't be used.
+    std::vector<PortData*> ports_to_prune;
+    for (PortData& data : ports_) {
+      if (data.inprogress() && !data.has_pairable_candidate() &&
+          data.port()->Type() == RELAY_PORT_TYPE) {
+        ports_to_prune.push_back(&data);
+      }
+    }
+    if (!ports_to_prune.empty()) {
+      RTC_LOG(LS_INFO) << "Cancelling " << ports_to_prune.size()
+                       << " pending relay allocations";
+      PrunePortsAndRemoveCandidates(ports_to_prune);
+    }
+  }
   ClearGettingPorts();
   // Note: this must be called after ClearGettingPorts because both may set the
   // session state and we should set the state to STOPPED.
@@ -1288,6 +1303,10 @@ void AllocationSequence::OnMessage(rtc::Message* msg) {
     case PHASE_UDP:
       CreateUDPPorts();
       CreateStunPorts();
+      if (IsFlagSet(PORTALLOCATOR_ENABLE_EARLY_RELAY)) {
+        CreateRelayPorts();
+        ++phase_;
+      }
       break;
 
     case PHASE_RELAY:
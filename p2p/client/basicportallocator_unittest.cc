@@ -2062,6 +2062,55 @@ TEST_F(BasicPortAllocatorTest, TestStopGettingPorts) {
   EXPECT_EQ(0U, ports_.size());
 }
 
+// Test that with PORTALLOCATOR_ENABLE_EARLY_RELAY, the relay candidates are
+// gathered without waiting for the step delay.
+TEST_F(BasicPortAllocatorTest, TestEarlyRelayGathersRelayWithoutStepDelay) {
+  turn_server_.AddInternalSocket(kTurnTcpIntAddr, PROTO_TCP);
+  AddInterface(kClientAddr);
+  allocator_.reset(new BasicPortAllocator(&network_manager_));
+  allocator_->Initialize();
+  AddTurnServers(kTurnUdpIntAddr, kTurnTcpIntAddr);
+  allocator_->set_step_delay(kDefaultStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_SHARED_SOCKET |
+                        PORTALLOCATOR_DISABLE_TCP |
+                        PORTALLOCATOR_ENABLE_EARLY_RELAY);
+
+  ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+
+  ASSERT_EQ_SIMULATED_WAIT(3U, candidates_.size(), kDefaultStepDelay / 2,
+                           fake_clock);
+  EXPECT_TRUE(HasCandidate(candidates_, "local", "udp", kClientAddr));
+  EXPECT_TRUE(HasCandidate(candidates_, "relay", "udp",
+                           rtc::SocketAddress(kTurnUdpExtAddr.ipaddr(), 0)));
+}
+
+// Test that with PORTALLOCATOR_ENABLE_EARLY_RELAY, stopping getting ports
+// cancels the relay allocations that haven't completed.
+TEST_F(BasicPortAllocatorTest, TestEarlyRelayStopCancelsPendingAllocations) {
+  AddInterface(kClientAddr);
+  allocator_.reset(new BasicPortAllocator(&network_manager_));
+  allocator_->Initialize();
+  AddTurnServers(kTurnUdpIntAddr, rtc::SocketAddress());
+  virtual_socket_server()->SetDelayOnAddress(kTurnUdpIntAddr, 500);
+  allocator_->set_step_delay(kMinimumStepDelay);
+  allocator_->set_flags(allocator().flags() |
+                        PORTALLOCATOR_ENABLE_SHARED_SOCKET |
+                        PORTALLOCATOR_DISABLE_TCP |
+                        PORTALLOCATOR_ENABLE_EARLY_RELAY);
+
+  ASSERT_TRUE(CreateSession(ICE_CANDIDATE_COMPONENT_RTP));
+  session_->StartGettingPorts();
+  ASSERT_EQ_SIMULATED_WAIT(1U, candidates_.size(), 100, fake_clock);
+  session_->StopGettingPorts();
+  EXPECT_TRUE_SIMULATED_WAIT(candidate_allocation_done_, 100, fake_clock);
+
+  SIMULATED_WAIT(false, 2000, fake_clock);
+  EXPECT_EQ(1U, candidates_.size());
+  EXPECT_TRUE(HasCandidate(candidates_, "local", "udp", kClientAddr));
+}
+
 TEST_F(BasicPortAllocatorTest, TestClearGettingPorts) {
   AddInterface(kClientAddr);
   allocator_->set_step_delay(kDefaultStepDelay);
@@ -36,6 +36,7 @@ std::unique_ptr<Port> TurnPortFactory::Create(
       args.origin,
       args.turn_customizer);
   port->SetTlsCertPolicy(args.config->tls_cert_policy);
+  port->set_early_channel_binding(args.config->early_channel_binding);
   return std::unique_ptr<Port>(port);
 }
 
@@ -50,6 +51,7 @@ std::unique_ptr<Port> TurnPortFactory::Create(
       args.config->tls_alpn_protocols, args.config->tls_elliptic_curves,
       args.turn_customizer, args.config->tls_cert_verifier);
   port->SetTlsCertPolicy(args.config->tls_cert_policy);
+  port->set_early_channel_binding(args.config->early_channel_binding);
   return std::unique_ptr<Port>(port);
 }
 
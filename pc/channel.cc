@@ -461,27 +461,29 @@ void BaseChannel::OnRtpPacket(const webrtc::RtpPacketReceived& parsed_packet) {
   OnPacketReceived(/*rtcp=*/false, parsed_packet.Buffer(), packet_time);
 }
 
-void BaseChannel::UpdateRtpHeaderExtensionMap(
+bool BaseChannel::RegisterRtpDemuxerSink() {
+  RTC_DCHECK(rtp_transport_);
+  return network_thread_->Invoke<bool>(RTC_FROM_HERE, [this] {
+    return rtp_transport_->RegisterRtpDemuxerSink(demuxer_criteria_, this);
+  });
+}
+
+bool BaseChannel::RegisterRtpDemuxerSink(
     const RtpHeaderExtensions& header_extensions) {
   RTC_DCHECK(rtp_transport_);
   // Update the header extension map on network thread in case there is data
-  // race.
+  // race, in the same hop as the sink registration.
   // TODO(zhihuang): Add an rtc::ThreadChecker make sure to RtpTransport won't
   // be accessed from different threads.
   //
   // NOTE: This doesn't take the BUNDLE case in account meaning the RTP header
   // extension maps are not merged when BUNDLE is enabled. This is fine because
   // the ID for MID should be consistent among all the RTP transports.
-  network_thread_->Invoke<void>(RTC_FROM_HERE, [this, &header_extensions] {
-    rtp_transport_->UpdateRtpHeaderExtensionMap(header_extensions);
-  });
-}
-
-bool BaseChannel::RegisterRtpDemuxerSink() {
-  RTC_DCHECK(rtp_transport_);
-  return network_thread_->Invoke<bool>(RTC_FROM_HERE, [this] {
-    return rtp_transport_->RegisterRtpDemuxerSink(demuxer_criteria_, this);
-  });
+  return network_thread_->Invoke<bool>(
+      RTC_FROM_HERE, [this, &header_extensions] {
+        rtp_transport_->UpdateRtpHeaderExtensionMap(header_extensions);
+        return rtp_transport_->RegisterRtpDemuxerSink(demuxer_criteria_, this);
+      });
 }
 
 void BaseChannel::OnRtcpPacketReceived(rtc::CopyOnWriteBuffer* packet,
@@ -515,6 +517,14 @@ void BaseChannel::OnPacketReceived(bool rtcp,
     return;
   }
 
+  // When the network thread is the worker thread too, the packet is handed
+  // to the media channel right away instead of being posted, which would
+  // allocate a closure and queue the packet behind the worker's other
+  // messages.
+  if (worker_thread_->IsCurrent()) {
+    ProcessPacket(rtcp, packet, packet_time);
+    return;
+  }
   invoker_.AsyncInvoke<void>(
       RTC_FROM_HERE, worker_thread_,
       Bind(&BaseChannel::ProcessPacket, this, rtcp, packet, packet_time));
@@ -809,7 +819,6 @@ bool VoiceChannel::SetLocalContent_w(const MediaContentDescription* content,
 
   RtpHeaderExtensions rtp_header_extensions =
       GetFilteredRtpHeaderExtensions(audio->rtp_header_extensions());
-  UpdateRtpHeaderExtensionMap(rtp_header_extensions);
 
   AudioRecvParameters recv_params = last_recv_params_;
   RtpParametersFromMediaDescription(audio, rtp_header_extensions, &recv_params);
@@ -822,7 +831,7 @@ bool VoiceChannel::SetLocalContent_w(const MediaContentDescription* content,
     AddHandledPayloadType(codec.id);
   }
   // Need to re-register the sink to update the handled payload.
-  if (!RegisterRtpDemuxerSink()) {
+  if (!RegisterRtpDemuxerSink(rtp_header_extensions)) {
     RTC_LOG(LS_ERROR) << "Failed to set up audio demuxing.";
     return false;
   }
@@ -944,7 +953,6 @@ bool VideoChannel::SetLocalContent_w(const MediaContentDescription* content,
 
   RtpHeaderExtensions rtp_header_extensions =
       GetFilteredRtpHeaderExtensions(video->rtp_header_extensions());
-  UpdateRtpHeaderExtensionMap(rtp_header_extensions);
 
   VideoRecvParameters recv_params = last_recv_params_;
   RtpParametersFromMediaDescription(video, rtp_header_extensions, &recv_params);
@@ -957,7 +965,7 @@ bool VideoChannel::SetLocalContent_w(const MediaContentDescription* content,
     AddHandledPayloadType(codec.id);
   }
   // Need to re-register the sink to update the handled payload.
-  if (!RegisterRtpDemuxerSink()) {
+  if (!RegisterRtpDemuxerSink(rtp_header_extensions)) {
     RTC_LOG(LS_ERROR) << "Failed to set up video demuxing.";
     return false;
   }
@@ -288,10 +288,10 @@ class BaseChannel : public rtc::MessageHandler,
 
   void AddHandledPayloadType(int payload_type);
 
-  void UpdateRtpHeaderExtensionMap(
-      const RtpHeaderExtensions& header_extensions);
-
   bool RegisterRtpDemuxerSink();
+  // Also updates the RTP header extension map of the transport, with a single
+  // hop to the network thread.
+  bool RegisterRtpDemuxerSink(const RtpHeaderExtensions& header_extensions);
 
  private:
   bool ConnectToRtpTransport();
@@ -129,6 +129,7 @@ bool ChannelManager::Init() {
   }
 
   if (media_engine_) {
+    TRACE_EVENT0("webrtc", "ChannelManager::Init::MediaEngineInit");
     initialized_ = worker_thread_->Invoke<bool>(
         RTC_FROM_HERE, [&] { return media_engine_->Init(); });
     RTC_DCHECK(initialized_);
@@ -10,7 +10,6 @@
 
 #include "pc/datachannel.h"
 
-#include <memory>
 #include <string>
 
 #include "media/sctp/sctptransportinternal.h"
@@ -67,15 +66,13 @@ bool SctpSidAllocator::IsSidAvailable(int sid) const {
 
 DataChannel::PacketQueue::PacketQueue() : byte_count_(0) {}
 
-DataChannel::PacketQueue::~PacketQueue() {
-  Clear();
-}
+DataChannel::PacketQueue::~PacketQueue() {}
 
 bool DataChannel::PacketQueue::Empty() const {
   return packets_.empty();
 }
 
-DataBuffer* DataChannel::PacketQueue::Front() {
+const DataBuffer& DataChannel::PacketQueue::Front() const {
   return packets_.front();
 }
 
@@ -84,20 +81,17 @@ void DataChannel::PacketQueue::Pop() {
     return;
   }
 
-  byte_count_ -= packets_.front()->size();
+  byte_count_ -= packets_.front().size();
   packets_.pop_front();
 }
 
-void DataChannel::PacketQueue::Push(DataBuffer* packet) {
-  byte_count_ += packet->size();
+void DataChannel::PacketQueue::Push(const DataBuffer& packet) {
+  byte_count_ += packet.size();
   packets_.push_back(packet);
 }
 
 void DataChannel::PacketQueue::Clear() {
-  while (!packets_.empty()) {
-    delete packets_.front();
-    packets_.pop_front();
-  }
+  packets_.clear();
   byte_count_ = 0;
 }
 
@@ -375,11 +369,11 @@ void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
   }
 
   bool binary = (params.type == cricket::DMT_BINARY);
-  std::unique_ptr<DataBuffer> buffer(new DataBuffer(payload, binary));
+  DataBuffer buffer(payload, binary);
   if (state_ == kOpen && observer_) {
     ++messages_received_;
-    bytes_received_ += buffer->size();
-    observer_->OnMessage(*buffer.get());
+    bytes_received_ += buffer.size();
+    observer_->OnMessage(buffer);
   } else {
     if (queued_received_data_.byte_count() + payload.size() >
         kMaxQueuedReceivedDataBytes) {
@@ -392,7 +386,7 @@ void DataChannel::OnDataReceived(const cricket::ReceiveDataParams& params,
 
       return;
     }
-    queued_received_data_.Push(buffer.release());
+    queued_received_data_.Push(buffer);
   }
 }
 
@@ -510,11 +504,11 @@ void DataChannel::DeliverQueuedReceivedData() {
   }
 
   while (!queued_received_data_.Empty()) {
-    std::unique_ptr<DataBuffer> buffer(queued_received_data_.Front());
-    ++messages_received_;
-    bytes_received_ += buffer->size();
-    observer_->OnMessage(*buffer);
+    DataBuffer buffer = queued_received_data_.Front();
     queued_received_data_.Pop();
+    ++messages_received_;
+    bytes_received_ += buffer.size();
+    observer_->OnMessage(buffer);
   }
 }
 
@@ -527,17 +521,19 @@ void DataChannel::SendQueuedDataMessages() {
 
   uint64_t start_buffered_amount = buffered_amount();
   while (!queued_send_data_.Empty()) {
-    DataBuffer* buffer = queued_send_data_.Front();
-    if (!SendDataMessage(*buffer, false)) {
+    if (!SendDataMessage(queued_send_data_.Front(), false)) {
       // Leave the message in the queue if sending is aborted.
       break;
     }
     queued_send_data_.Pop();
-    delete buffer;
   }
 
   if (observer_ && buffered_amount() < start_buffered_amount) {
     observer_->OnBufferedAmountChange(start_buffered_amount);
+    if (start_buffered_amount > buffered_amount_low_threshold_ &&
+        buffered_amount() <= buffered_amount_low_threshold_) {
+      observer_->OnBufferedAmountLow();
+    }
   }
 }
 
@@ -597,7 +593,7 @@ bool DataChannel::QueueSendDataMessage(const DataBuffer& buffer) {
     RTC_LOG(LS_ERROR) << "Can't buffer any more data for the data channel.";
     return false;
   }
-  queued_send_data_.Push(new DataBuffer(buffer));
+  queued_send_data_.Push(buffer);
 
   // The buffer can have length zero, in which case there is no change.
   if (observer_ && buffered_amount() > start_buffered_amount) {
@@ -611,14 +607,13 @@ void DataChannel::SendQueuedControlMessages() {
   control_packets.Swap(&queued_control_data_);
 
   while (!control_packets.Empty()) {
-    std::unique_ptr<DataBuffer> buf(control_packets.Front());
-    SendControlMessage(buf->data);
+    SendControlMessage(control_packets.Front().data);
     control_packets.Pop();
   }
 }
 
 void DataChannel::QueueControlMessage(const rtc::CopyOnWriteBuffer& buffer) {
-  queued_control_data_.Push(new DataBuffer(buffer, true));
+  queued_control_data_.Push(DataBuffer(buffer, true));
 }
 
 bool DataChannel::SendControlMessage(const rtc::CopyOnWriteBuffer& buffer) {
@@ -128,6 +128,12 @@ class DataChannel : public DataChannelInterface,
   virtual bool negotiated() const { return config_.negotiated; }
   virtual int id() const { return config_.id; }
   virtual uint64_t buffered_amount() const;
+  virtual uint64_t buffered_amount_low_threshold() const {
+    return buffered_amount_low_threshold_;
+  }
+  virtual void SetBufferedAmountLowThreshold(uint64_t threshold) {
+    buffered_amount_low_threshold_ = threshold;
+  }
   virtual void Close();
   virtual DataState state() const { return state_; }
   virtual uint32_t messages_sent() const { return messages_sent_; }
@@ -193,8 +199,8 @@ class DataChannel : public DataChannelInterface,
   virtual ~DataChannel();
 
  private:
-  // A packet queue which tracks the total queued bytes. Queued packets are
-  // owned by this class.
+  // A packet queue which tracks the total queued bytes. Queuing a packet shares
+  // its payload rather than copying it.
   class PacketQueue {
    public:
     PacketQueue();
@@ -206,18 +212,18 @@ class DataChannel : public DataChannelInterface,
 
     bool Empty() const;
 
-    DataBuffer* Front();
+    const DataBuffer& Front() const;
 
     void Pop();
 
-    void Push(DataBuffer* packet);
+    void Push(const DataBuffer& packet);
 
     void Clear();
 
     void Swap(PacketQueue* other);
 
    private:
-    std::deque<DataBuffer*> packets_;
+    std::deque<DataBuffer> packets_;
     size_t byte_count_;
   };
 
@@ -254,6 +260,7 @@ class DataChannel : public DataChannelInterface,
   uint64_t bytes_sent_;
   uint32_t messages_received_;
   uint64_t bytes_received_;
+  uint64_t buffered_amount_low_threshold_ = 0;
   cricket::DataChannelType data_channel_type_;
   DataChannelProviderInterface* provider_;
   HandshakeState handshake_state_;
@@ -289,6 +296,8 @@ BEGIN_SIGNALING_PROXY_MAP(DataChannel)
   PROXY_CONSTMETHOD0(uint32_t, messages_received)
   PROXY_CONSTMETHOD0(uint64_t, bytes_received)
   PROXY_CONSTMETHOD0(uint64_t, buffered_amount)
+  PROXY_CONSTMETHOD0(uint64_t, buffered_amount_low_threshold)
+  PROXY_METHOD1(void, SetBufferedAmountLowThreshold, uint64_t)
   PROXY_METHOD0(void, Close)
   PROXY_METHOD1(bool, Send, const DataBuffer&)
 END_PROXY_MAP()
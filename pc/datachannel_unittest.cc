@@ -36,8 +36,11 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     ++on_buffered_amount_change_count_;
   }
 
+  void OnBufferedAmountLow() { ++on_buffered_amount_low_count_; }
+
   void OnMessage(const webrtc::DataBuffer& buffer) {
     ++messages_received_;
+    last_message_data_ = buffer.data;
   }
 
   size_t messages_received() const {
@@ -60,10 +63,20 @@ class FakeDataChannelObserver : public webrtc::DataChannelObserver {
     return on_buffered_amount_change_count_;
   }
 
+  size_t on_buffered_amount_low_count() const {
+    return on_buffered_amount_low_count_;
+  }
+
+  const rtc::CopyOnWriteBuffer& last_message_data() const {
+    return last_message_data_;
+  }
+
  private:
   size_t messages_received_;
   size_t on_state_change_count_;
   size_t on_buffered_amount_change_count_;
+  size_t on_buffered_amount_low_count_ = 0;
+  rtc::CopyOnWriteBuffer last_message_data_;
 };
 
 class SctpDataChannelTest : public testing::Test {
@@ -203,6 +216,46 @@ TEST_F(SctpDataChannelTest, QueuedDataSentWhenUnblocked) {
   EXPECT_EQ(2U, observer_->on_buffered_amount_change_count());
 }
 
+// Tests that OnBufferedAmountLow is called when the queued data drops from
+// above the threshold to at or below it, and only then.
+TEST_F(SctpDataChannelTest, BufferedAmountLowWhenUnblocked) {
+  AddObserver();
+  SetChannelReady();
+  webrtc_data_channel_->SetBufferedAmountLowThreshold(4);
+  EXPECT_EQ(4U, webrtc_data_channel_->buffered_amount_low_threshold());
+  webrtc::DataBuffer buffer("abcd");
+  provider_->set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  EXPECT_EQ(0U, observer_->on_buffered_amount_low_count());
+
+  provider_->set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+
+  // The buffered amount never exceeds the threshold.
+  provider_->set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  provider_->set_send_blocked(false);
+  EXPECT_EQ(0U, webrtc_data_channel_->buffered_amount());
+  EXPECT_EQ(1U, observer_->on_buffered_amount_low_count());
+}
+
+// Tests that the payload of a sent message is passed to the transport without
+// being copied, also when it had to be queued.
+TEST_F(SctpDataChannelTest, SendSharesPayload) {
+  SetChannelReady();
+  webrtc::DataBuffer buffer("abcd");
+  EXPECT_TRUE(webrtc_data_channel_->Send(buffer));
+  EXPECT_EQ(buffer.data.cdata(), provider_->last_send_data().cdata());
+
+  webrtc::DataBuffer queued_buffer("efgh");
+  provider_->set_send_blocked(true);
+  EXPECT_TRUE(webrtc_data_channel_->Send(queued_buffer));
+  provider_->set_send_blocked(false);
+  EXPECT_EQ(queued_buffer.data.cdata(), provider_->last_send_data().cdata());
+}
+
 // Tests that no crash when the channel is blocked right away while trying to
 // send queued data.
 TEST_F(SctpDataChannelTest, BlockedWhenSendQueuedDataNoCrash) {
@@ -433,6 +486,8 @@ TEST_F(SctpDataChannelTest, ReceiveDataWithValidSsrc) {
 
   webrtc_data_channel_->OnDataReceived(params, buffer.data);
   EXPECT_EQ(1U, observer_->messages_received());
+  // The payload is delivered without being copied.
+  EXPECT_EQ(buffer.data.cdata(), observer_->last_message_data().cdata());
 }
 
 // Tests that no CONTROL message is sent if the datachannel is negotiated and
@@ -335,6 +335,7 @@ void JsepTransport::SetLocalIceParameters(IceTransportInternal* ice_transport) {
   RTC_DCHECK(local_description_);
   ice_transport->SetIceParameters(
       local_description_->transport_desc.GetIceParameters());
+  ice_transport->SetIceMode(local_description_->transport_desc.ice_mode);
 }
 
 void JsepTransport::SetRemoteIceParameters(
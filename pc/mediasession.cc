@@ -897,6 +897,38 @@ static void MergeCodecs(const std::vector<C>& reference_codecs,
   }
 }
 
+template <class C>
+class CodecsMemo {
+ public:
+  // Returns the codecs computed by |compute| for |inputs|. If |inputs| are
+  // equal to those of the previous call, the previous codecs are returned
+  // without calling |compute|.
+  template <typename ComputeFunction>
+  const std::vector<C>& Get(
+      std::initializer_list<const std::vector<C>*> inputs,
+      const ComputeFunction& compute) {
+    bool same_inputs = has_codecs_ && inputs.size() == inputs_.size();
+    for (size_t i = 0; same_inputs && i < inputs.size(); ++i) {
+      same_inputs = *inputs.begin()[i] == inputs_[i];
+    }
+    if (!same_inputs) {
+      inputs_.clear();
+      for (const std::vector<C>* input : inputs) {
+        inputs_.push_back(*input);
+      }
+      codecs_.clear();
+      compute(&codecs_);
+      has_codecs_ = true;
+    }
+    return codecs_;
+  }
+
+ private:
+  bool has_codecs_ = false;
+  std::vector<std::vector<C>> inputs_;
+  std::vector<C> codecs_;
+};
+
 static bool FindByUriAndEncryption(const RtpHeaderExtensions& extensions,
                                    const webrtc::RtpExtension& ext_to_match,
                                    webrtc::RtpExtension* found_extension) {
@@ -1066,7 +1098,7 @@ static bool CreateMediaContentAnswer(
     const MediaContentDescriptionImpl<C>* offer,
     const MediaDescriptionOptions& media_description_options,
     const MediaSessionOptions& session_options,
-    const std::vector<C>& local_codecs,
+    const std::vector<C>& negotiated_codecs,
     const SecurePolicy& sdes_policy,
     const CryptoParamsVec* current_cryptos,
     const RtpHeaderExtensions& local_rtp_extenstions,
@@ -1074,8 +1106,6 @@ static bool CreateMediaContentAnswer(
     StreamParamsVec* current_streams,
     bool bundle_enabled,
     MediaContentDescriptionImpl<C>* answer) {
-  std::vector<C> negotiated_codecs;
-  NegotiateCodecs(local_codecs, offer->codecs(), &negotiated_codecs);
   answer->AddCodecs(negotiated_codecs);
   answer->set_protocol(offer->protocol());
   RtpHeaderExtensions negotiated_rtp_extensions;
@@ -1300,6 +1330,8 @@ SessionDescription* MediaSessionDescriptionFactory::CreateOffer(
 
   // Iterate through the media description options, matching with existing media
   // descriptions in |current_description|.
+  CodecsMemo<AudioCodec> audio_codecs_memo;
+  CodecsMemo<VideoCodec> video_codecs_memo;
   size_t msection_index = 0;
   for (const MediaDescriptionOptions& media_description_options :
        session_options.media_description_options) {
@@ -1317,7 +1349,8 @@ SessionDescription* MediaSessionDescriptionFactory::CreateOffer(
         if (!AddAudioContentForOffer(media_description_options, session_options,
                                      current_content, current_description,
                                      audio_rtp_extensions, offer_audio_codecs,
-                                     &current_streams, offer.get())) {
+                                     &audio_codecs_memo, &current_streams,
+                                     offer.get())) {
           return nullptr;
         }
         break;
@@ -1325,7 +1358,8 @@ SessionDescription* MediaSessionDescriptionFactory::CreateOffer(
         if (!AddVideoContentForOffer(media_description_options, session_options,
                                      current_content, current_description,
                                      video_rtp_extensions, offer_video_codecs,
-                                     &current_streams, offer.get())) {
+                                     &video_codecs_memo, &current_streams,
+                                     offer.get())) {
           return nullptr;
         }
         break;
@@ -1429,6 +1463,8 @@ SessionDescription* MediaSessionDescriptionFactory::CreateAnswer(
              session_options.media_description_options.size());
   // Iterate through the media description options, matching with existing
   // media descriptions in |current_description|.
+  CodecsMemo<AudioCodec> audio_codecs_memo;
+  CodecsMemo<VideoCodec> video_codecs_memo;
   size_t msection_index = 0;
   for (const MediaDescriptionOptions& media_description_options :
        session_options.media_description_options) {
@@ -1448,8 +1484,8 @@ SessionDescription* MediaSessionDescriptionFactory::CreateAnswer(
         if (!AddAudioContentForAnswer(
                 media_description_options, session_options, offer_content,
                 offer, current_content, current_description,
-                bundle_transport.get(), answer_audio_codecs, &current_streams,
-                answer.get())) {
+                bundle_transport.get(), answer_audio_codecs, &audio_codecs_memo,
+                &current_streams, answer.get())) {
           return nullptr;
         }
         break;
@@ -1457,8 +1493,8 @@ SessionDescription* MediaSessionDescriptionFactory::CreateAnswer(
         if (!AddVideoContentForAnswer(
                 media_description_options, session_options, offer_content,
                 offer, current_content, current_description,
-                bundle_transport.get(), answer_video_codecs, &current_streams,
-                answer.get())) {
+                bundle_transport.get(), answer_video_codecs, &video_codecs_memo,
+                &current_streams, answer.get())) {
           return nullptr;
         }
         break;
@@ -1589,15 +1625,27 @@ void MergeCodecsFromDescription(const SessionDescription* description,
                                 DataCodecs* data_codecs,
                                 UsedPayloadTypes* used_pltypes) {
   RTC_DCHECK(description);
+  // Merging the same codecs again has no effect, so consecutive m= sections
+  // with the same codecs are only merged once.
+  const AudioCodecs* merged_audio_codecs = nullptr;
+  const VideoCodecs* merged_video_codecs = nullptr;
   for (const ContentInfo& content : description->contents()) {
     if (IsMediaContentOfType(&content, MEDIA_TYPE_AUDIO)) {
       const AudioContentDescription* audio =
           content.media_description()->as_audio();
+      if (merged_audio_codecs && *merged_audio_codecs == audio->codecs()) {
+        continue;
+      }
       MergeCodecs<AudioCodec>(audio->codecs(), audio_codecs, used_pltypes);
+      merged_audio_codecs = &audio->codecs();
     } else if (IsMediaContentOfType(&content, MEDIA_TYPE_VIDEO)) {
       const VideoContentDescription* video =
           content.media_description()->as_video();
+      if (merged_video_codecs && *merged_video_codecs == video->codecs()) {
+        continue;
+      }
       MergeCodecs<VideoCodec>(video->codecs(), video_codecs, used_pltypes);
+      merged_video_codecs = &video->codecs();
     } else if (IsMediaContentOfType(&content, MEDIA_TYPE_DATA)) {
       const DataContentDescription* data =
           content.media_description()->as_data();
@@ -1666,10 +1714,19 @@ void MediaSessionDescriptionFactory::GetCodecsForAnswer(
   AudioCodecs filtered_offered_audio_codecs;
   VideoCodecs filtered_offered_video_codecs;
   DataCodecs filtered_offered_data_codecs;
+  // Filtering the same offered codecs again has no effect, so consecutive m=
+  // sections with the same codecs are only filtered once.
+  const AudioCodecs* last_offered_audio_codecs = nullptr;
+  const VideoCodecs* last_offered_video_codecs = nullptr;
   for (const ContentInfo& content : remote_offer->contents()) {
     if (IsMediaContentOfType(&content, MEDIA_TYPE_AUDIO)) {
       const AudioContentDescription* audio =
           content.media_description()->as_audio();
+      if (last_offered_audio_codecs &&
+          *last_offered_audio_codecs == audio->codecs()) {
+        continue;
+      }
+      last_offered_audio_codecs = &audio->codecs();
       for (const AudioCodec& offered_audio_codec : audio->codecs()) {
         if (!FindMatchingCodec<AudioCodec>(audio->codecs(),
                                            filtered_offered_audio_codecs,
@@ -1682,6 +1739,11 @@ void MediaSessionDescriptionFactory::GetCodecsForAnswer(
     } else if (IsMediaContentOfType(&content, MEDIA_TYPE_VIDEO)) {
       const VideoContentDescription* video =
           content.media_description()->as_video();
+      if (last_offered_video_codecs &&
+          *last_offered_video_codecs == video->codecs()) {
+        continue;
+      }
+      last_offered_video_codecs = &video->codecs();
       for (const VideoCodec& offered_video_codec : video->codecs()) {
         if (!FindMatchingCodec<VideoCodec>(video->codecs(),
                                            filtered_offered_video_codecs,
@@ -1839,6 +1901,7 @@ bool MediaSessionDescriptionFactory::AddAudioContentForOffer(
     const SessionDescription* current_description,
     const RtpHeaderExtensions& audio_rtp_extensions,
     const AudioCodecs& audio_codecs,
+    CodecsMemo<AudioCodec>* codecs_memo,
     StreamParamsVec* current_streams,
     SessionDescription* desc) const {
   // Filter audio_codecs (which includes all codecs, with correctly remapped
@@ -1846,31 +1909,39 @@ bool MediaSessionDescriptionFactory::AddAudioContentForOffer(
   const AudioCodecs& supported_audio_codecs =
       GetAudioCodecsForOffer(media_description_options.direction);
 
-  AudioCodecs filtered_codecs;
-  // Add the codecs from current content if it exists and is not being recycled.
+  const AudioCodecs no_codecs;
+  const AudioCodecs* current_codecs = &no_codecs;
   if (current_content && !current_content->rejected) {
     RTC_CHECK(IsMediaContentOfType(current_content, MEDIA_TYPE_AUDIO));
-    const AudioContentDescription* acd =
-        current_content->media_description()->as_audio();
-    for (const AudioCodec& codec : acd->codecs()) {
-      if (FindMatchingCodec<AudioCodec>(acd->codecs(), audio_codecs, codec,
-                                        nullptr)) {
-        filtered_codecs.push_back(codec);
-      }
-    }
-  }
-  // Add other supported audio codecs.
-  AudioCodec found_codec;
-  for (const AudioCodec& codec : supported_audio_codecs) {
-    if (FindMatchingCodec<AudioCodec>(supported_audio_codecs, audio_codecs,
-                                      codec, &found_codec) &&
-        !FindMatchingCodec<AudioCodec>(supported_audio_codecs, filtered_codecs,
-                                       codec, nullptr)) {
-      // Use the |found_codec| from |audio_codecs| because it has the correctly
-      // mapped payload type.
-      filtered_codecs.push_back(found_codec);
-    }
-  }
+    current_codecs =
+        &current_content->media_description()->as_audio()->codecs();
+  }
+  // |audio_codecs| is the same for all m= sections of the offer.
+  const AudioCodecs& filtered_codecs = codecs_memo->Get(
+      {current_codecs, &supported_audio_codecs},
+      [&](AudioCodecs* codecs) {
+        // Add the codecs from current content if it exists and is not being
+        // recycled.
+        for (const AudioCodec& codec : *current_codecs) {
+          if (FindMatchingCodec<AudioCodec>(*current_codecs, audio_codecs,
+                                            codec, nullptr)) {
+            codecs->push_back(codec);
+          }
+        }
+        // Add other supported audio codecs.
+        AudioCodec found_codec;
+        for (const AudioCodec& codec : supported_audio_codecs) {
+          if (FindMatchingCodec<AudioCodec>(supported_audio_codecs,
+                                            audio_codecs, codec,
+                                            &found_codec) &&
+              !FindMatchingCodec<AudioCodec>(supported_audio_codecs, *codecs,
+                                             codec, nullptr)) {
+            // Use the |found_codec| from |audio_codecs| because it has the
+            // correctly mapped payload type.
+            codecs->push_back(found_codec);
+          }
+        }
+      });
 
   cricket::SecurePolicy sdes_policy =
       IsDtlsActive(current_content, current_description) ? cricket::SEC_DISABLED
@@ -1910,6 +1981,7 @@ bool MediaSessionDescriptionFactory::AddVideoContentForOffer(
     const SessionDescription* current_description,
     const RtpHeaderExtensions& video_rtp_extensions,
     const VideoCodecs& video_codecs,
+    CodecsMemo<VideoCodec>* codecs_memo,
     StreamParamsVec* current_streams,
     SessionDescription* desc) const {
   cricket::SecurePolicy sdes_policy =
@@ -1921,31 +1993,38 @@ bool MediaSessionDescriptionFactory::AddVideoContentForOffer(
   GetSupportedVideoSdesCryptoSuiteNames(session_options.crypto_options,
                                         &crypto_suites);
 
-  VideoCodecs filtered_codecs;
-  // Add the codecs from current content if it exists and is not being recycled.
+  const VideoCodecs no_codecs;
+  const VideoCodecs* current_codecs = &no_codecs;
   if (current_content && !current_content->rejected) {
     RTC_CHECK(IsMediaContentOfType(current_content, MEDIA_TYPE_VIDEO));
-    const VideoContentDescription* vcd =
-        current_content->media_description()->as_video();
-    for (const VideoCodec& codec : vcd->codecs()) {
-      if (FindMatchingCodec<VideoCodec>(vcd->codecs(), video_codecs, codec,
-                                        nullptr)) {
-        filtered_codecs.push_back(codec);
-      }
-    }
-  }
-  // Add other supported video codecs.
-  VideoCodec found_codec;
-  for (const VideoCodec& codec : video_codecs_) {
-    if (FindMatchingCodec<VideoCodec>(video_codecs_, video_codecs, codec,
-                                      &found_codec) &&
-        !FindMatchingCodec<VideoCodec>(video_codecs_, filtered_codecs, codec,
-                                       nullptr)) {
-      // Use the |found_codec| from |video_codecs| because it has the correctly
-      // mapped payload type.
-      filtered_codecs.push_back(found_codec);
-    }
-  }
+    current_codecs =
+        &current_content->media_description()->as_video()->codecs();
+  }
+  // |video_codecs| and |video_codecs_| are the same for all m= sections of the
+  // offer.
+  const VideoCodecs& filtered_codecs = codecs_memo->Get(
+      {current_codecs}, [&](VideoCodecs* codecs) {
+        // Add the codecs from current content if it exists and is not being
+        // recycled.
+        for (const VideoCodec& codec : *current_codecs) {
+          if (FindMatchingCodec<VideoCodec>(*current_codecs, video_codecs,
+                                            codec, nullptr)) {
+            codecs->push_back(codec);
+          }
+        }
+        // Add other supported video codecs.
+        VideoCodec found_codec;
+        for (const VideoCodec& codec : video_codecs_) {
+          if (FindMatchingCodec<VideoCodec>(video_codecs_, video_codecs, codec,
+                                            &found_codec) &&
+              !FindMatchingCodec<VideoCodec>(video_codecs_, *codecs,
+                                             codec, nullptr)) {
+            // Use the |found_codec| from |video_codecs| because it has the
+            // correctly mapped payload type.
+            codecs->push_back(found_codec);
+          }
+        }
+      });
 
   if (!CreateMediaContentOffer(
           media_description_options.sender_options, session_options,
@@ -2059,6 +2138,7 @@ bool MediaSessionDescriptionFactory::AddAudioContentForAnswer(
     const SessionDescription* current_description,
     const TransportInfo* bundle_transport,
     const AudioCodecs& audio_codecs,
+    CodecsMemo<AudioCodec>* codecs_memo,
     StreamParamsVec* current_streams,
     SessionDescription* answer) const {
   RTC_CHECK(IsMediaContentOfType(offer_content, MEDIA_TYPE_AUDIO));
@@ -2079,33 +2159,45 @@ bool MediaSessionDescriptionFactory::AddAudioContentForAnswer(
   auto wants_rtd = media_description_options.direction;
   auto offer_rtd = offer_audio_description->direction();
   auto answer_rtd = NegotiateRtpTransceiverDirection(offer_rtd, wants_rtd);
-  AudioCodecs supported_audio_codecs =
+  const AudioCodecs& supported_audio_codecs =
       GetAudioCodecsForAnswer(offer_rtd, answer_rtd);
 
-  AudioCodecs filtered_codecs;
-  // Add the codecs from current content if it exists and is not being recycled.
+  const AudioCodecs no_codecs;
+  const AudioCodecs* current_codecs = &no_codecs;
   if (current_content && !current_content->rejected) {
     RTC_CHECK(IsMediaContentOfType(current_content, MEDIA_TYPE_AUDIO));
-    const AudioContentDescription* acd =
-        current_content->media_description()->as_audio();
-    for (const AudioCodec& codec : acd->codecs()) {
-      if (FindMatchingCodec<AudioCodec>(acd->codecs(), audio_codecs, codec,
-                                        nullptr)) {
-        filtered_codecs.push_back(codec);
-      }
-    }
-  }
-  // Add other supported audio codecs.
-  for (const AudioCodec& codec : supported_audio_codecs) {
-    if (FindMatchingCodec<AudioCodec>(supported_audio_codecs, audio_codecs,
-                                      codec, nullptr) &&
-        !FindMatchingCodec<AudioCodec>(supported_audio_codecs, filtered_codecs,
-                                       codec, nullptr)) {
-      // We should use the local codec with local parameters and the codec id
-      // would be correctly mapped in |NegotiateCodecs|.
-      filtered_codecs.push_back(codec);
-    }
-  }
+    current_codecs =
+        &current_content->media_description()->as_audio()->codecs();
+  }
+  // |audio_codecs| is the same for all m= sections of the answer.
+  const AudioCodecs& negotiated_codecs = codecs_memo->Get(
+      {current_codecs, &supported_audio_codecs,
+       &offer_audio_description->codecs()},
+      [&](AudioCodecs* codecs) {
+        AudioCodecs filtered_codecs;
+        // Add the codecs from current content if it exists and is not being
+        // recycled.
+        for (const AudioCodec& codec : *current_codecs) {
+          if (FindMatchingCodec<AudioCodec>(*current_codecs, audio_codecs,
+                                            codec, nullptr)) {
+            filtered_codecs.push_back(codec);
+          }
+        }
+        // Add other supported audio codecs.
+        for (const AudioCodec& codec : supported_audio_codecs) {
+          if (FindMatchingCodec<AudioCodec>(supported_audio_codecs,
+                                            audio_codecs, codec, nullptr) &&
+              !FindMatchingCodec<AudioCodec>(supported_audio_codecs,
+                                             filtered_codecs, codec,
+                                             nullptr)) {
+            // We should use the local codec with local parameters and the
+            // codec id would be correctly mapped in |NegotiateCodecs|.
+            filtered_codecs.push_back(codec);
+          }
+        }
+        NegotiateCodecs(filtered_codecs, offer_audio_description->codecs(),
+                        codecs);
+      });
 
   bool bundle_enabled = offer_description->HasGroup(GROUP_TYPE_BUNDLE) &&
                         session_options.bundle_enabled;
@@ -2116,7 +2208,7 @@ bool MediaSessionDescriptionFactory::AddAudioContentForAnswer(
       audio_transport->secure() ? cricket::SEC_DISABLED : secure();
   if (!CreateMediaContentAnswer(
           offer_audio_description, media_description_options, session_options,
-          filtered_codecs, sdes_policy, GetCryptos(current_content),
+          negotiated_codecs, sdes_policy, GetCryptos(current_content),
           audio_rtp_header_extensions(session_options.is_unified_plan),
           enable_encrypted_rtp_header_extensions_, current_streams,
           bundle_enabled, audio_answer.get())) {
@@ -2153,6 +2245,7 @@ bool MediaSessionDescriptionFactory::AddVideoContentForAnswer(
     const SessionDescription* current_description,
     const TransportInfo* bundle_transport,
     const VideoCodecs& video_codecs,
+    CodecsMemo<VideoCodec>* codecs_memo,
     StreamParamsVec* current_streams,
     SessionDescription* answer) const {
   RTC_CHECK(IsMediaContentOfType(offer_content, MEDIA_TYPE_VIDEO));
@@ -2167,30 +2260,41 @@ bool MediaSessionDescriptionFactory::AddVideoContentForAnswer(
     return false;
   }
 
-  VideoCodecs filtered_codecs;
-  // Add the codecs from current content if it exists and is not being recycled.
+  const VideoCodecs no_codecs;
+  const VideoCodecs* current_codecs = &no_codecs;
   if (current_content && !current_content->rejected) {
     RTC_CHECK(IsMediaContentOfType(current_content, MEDIA_TYPE_VIDEO));
-    const VideoContentDescription* vcd =
-        current_content->media_description()->as_video();
-    for (const VideoCodec& codec : vcd->codecs()) {
-      if (FindMatchingCodec<VideoCodec>(vcd->codecs(), video_codecs, codec,
-                                        nullptr)) {
-        filtered_codecs.push_back(codec);
-      }
-    }
-  }
-  // Add other supported video codecs.
-  for (const VideoCodec& codec : video_codecs_) {
-    if (FindMatchingCodec<VideoCodec>(video_codecs_, video_codecs, codec,
-                                      nullptr) &&
-        !FindMatchingCodec<VideoCodec>(video_codecs_, filtered_codecs, codec,
-                                       nullptr)) {
-      // We should use the local codec with local parameters and the codec id
-      // would be correctly mapped in |NegotiateCodecs|.
-      filtered_codecs.push_back(codec);
-    }
-  }
+    current_codecs =
+        &current_content->media_description()->as_video()->codecs();
+  }
+  // |video_codecs| and |video_codecs_| are the same for all m= sections of the
+  // answer.
+  const VideoCodecs& negotiated_codecs = codecs_memo->Get(
+      {current_codecs, &offer_video_description->codecs()},
+      [&](VideoCodecs* codecs) {
+        VideoCodecs filtered_codecs;
+        // Add the codecs from current content if it exists and is not being
+        // recycled.
+        for (const VideoCodec& codec : *current_codecs) {
+          if (FindMatchingCodec<VideoCodec>(*current_codecs, video_codecs,
+                                            codec, nullptr)) {
+            filtered_codecs.push_back(codec);
+          }
+        }
+        // Add other supported video codecs.
+        for (const VideoCodec& codec : video_codecs_) {
+          if (FindMatchingCodec<VideoCodec>(video_codecs_, video_codecs, codec,
+                                            nullptr) &&
+              !FindMatchingCodec<VideoCodec>(video_codecs_, filtered_codecs,
+                                             codec, nullptr)) {
+            // We should use the local codec with local parameters and the
+            // codec id would be correctly mapped in |NegotiateCodecs|.
+            filtered_codecs.push_back(codec);
+          }
+        }
+        NegotiateCodecs(filtered_codecs, offer_video_description->codecs(),
+                        codecs);
+      });
 
   bool bundle_enabled = offer_description->HasGroup(GROUP_TYPE_BUNDLE) &&
                         session_options.bundle_enabled;
@@ -2202,7 +2306,7 @@ bool MediaSessionDescriptionFactory::AddVideoContentForAnswer(
       video_transport->secure() ? cricket::SEC_DISABLED : secure();
   if (!CreateMediaContentAnswer(
           offer_video_description, media_description_options, session_options,
-          filtered_codecs, sdes_policy, GetCryptos(current_content),
+          negotiated_codecs, sdes_policy, GetCryptos(current_content),
           video_rtp_header_extensions(session_options.is_unified_plan),
           enable_encrypted_rtp_header_extensions_, current_streams,
           bundle_enabled, video_answer.get())) {
@@ -2259,9 +2363,12 @@ bool MediaSessionDescriptionFactory::AddDataContentForAnswer(
   RTC_CHECK(IsMediaContentOfType(offer_content, MEDIA_TYPE_DATA));
   const DataContentDescription* offer_data_description =
       offer_content->media_description()->as_data();
+  DataCodecs negotiated_codecs;
+  NegotiateCodecs(data_codecs, offer_data_description->codecs(),
+                  &negotiated_codecs);
   if (!CreateMediaContentAnswer(
           offer_data_description, media_description_options, session_options,
-          data_codecs, sdes_policy, GetCryptos(current_content),
+          negotiated_codecs, sdes_policy, GetCryptos(current_content),
           RtpHeaderExtensions(), enable_encrypted_rtp_header_extensions_,
           current_streams, bundle_enabled, data_answer.get())) {
     return false;  // Fails the session setup.
@@ -100,6 +100,12 @@ struct MediaSessionOptions {
   std::vector<MediaDescriptionOptions> media_description_options;
 };
 
+// Remembers the codecs computed for the previous m= section of an offer or
+// answer, so that consecutive m= sections with the same codec inputs, as in
+// offers with hundreds of transceivers, only compute them once.
+template <class C>
+class CodecsMemo;
+
 // Creates media session descriptions according to the supplied codecs and
 // other fields, as well as the supplied per-call options.
 // When creating answers, performs the appropriate negotiation
@@ -212,6 +218,7 @@ class MediaSessionDescriptionFactory {
       const SessionDescription* current_description,
       const RtpHeaderExtensions& audio_rtp_extensions,
       const AudioCodecs& audio_codecs,
+      CodecsMemo<AudioCodec>* codecs_memo,
       StreamParamsVec* current_streams,
       SessionDescription* desc) const;
 
@@ -222,6 +229,7 @@ class MediaSessionDescriptionFactory {
       const SessionDescription* current_description,
       const RtpHeaderExtensions& video_rtp_extensions,
       const VideoCodecs& video_codecs,
+      CodecsMemo<VideoCodec>* codecs_memo,
       StreamParamsVec* current_streams,
       SessionDescription* desc) const;
 
@@ -243,6 +251,7 @@ class MediaSessionDescriptionFactory {
       const SessionDescription* current_description,
       const TransportInfo* bundle_transport,
       const AudioCodecs& audio_codecs,
+      CodecsMemo<AudioCodec>* codecs_memo,
       StreamParamsVec* current_streams,
       SessionDescription* answer) const;
 
@@ -255,6 +264,7 @@ class MediaSessionDescriptionFactory {
       const SessionDescription* current_description,
       const TransportInfo* bundle_transport,
       const VideoCodecs& video_codecs,
+      CodecsMemo<VideoCodec>* codecs_memo,
       StreamParamsVec* current_streams,
       SessionDescription* answer) const;
 
@@ -25,6 +25,7 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/messagedigest.h"
 #include "rtc_base/ssladapter.h"
+#include "rtc_base/stringencode.h"
 
 #define ASSERT_CRYPTO(cd, s, cs) \
     ASSERT_EQ(s, cd->cryptos().size()); \
@@ -1010,6 +1011,47 @@ TEST_F(MediaSessionDescriptionFactoryTest, TestCreateVideoAnswer) {
   EXPECT_EQ(std::string(cricket::kMediaProtocolSavpf), vcd->protocol());
 }
 
+// Create an offer and an answer with many audio and video sections, and ensure
+// that each section gets the same codecs as with a single section of its type.
+TEST_F(MediaSessionDescriptionFactoryTest,
+       TestCreateOfferAndAnswerWithManyMediaSections) {
+  MediaSessionOptions opts;
+  for (int i = 0; i < 20; ++i) {
+    AddMediaSection(MEDIA_TYPE_AUDIO, "audio" + rtc::ToString(i),
+                    RtpTransceiverDirection::kRecvOnly, kActive, &opts);
+    AddMediaSection(MEDIA_TYPE_VIDEO, "video" + rtc::ToString(i),
+                    RtpTransceiverDirection::kRecvOnly, kActive, &opts);
+  }
+  std::unique_ptr<SessionDescription> offer(f1_.CreateOffer(opts, nullptr));
+  ASSERT_TRUE(offer);
+  std::unique_ptr<SessionDescription> answer(
+      f2_.CreateAnswer(offer.get(), opts, nullptr));
+  ASSERT_TRUE(answer);
+  std::unique_ptr<SessionDescription> reoffer(
+      f1_.CreateOffer(opts, offer.get()));
+  ASSERT_TRUE(reoffer);
+  ASSERT_EQ(40u, answer->contents().size());
+  ASSERT_EQ(40u, reoffer->contents().size());
+  for (size_t i = 0; i < answer->contents().size(); i += 2) {
+    EXPECT_EQ(MAKE_VECTOR(kAudioCodecs1),
+              offer->contents()[i].media_description()->as_audio()->codecs());
+    EXPECT_EQ(MAKE_VECTOR(kAudioCodecsAnswer),
+              answer->contents()[i].media_description()->as_audio()->codecs());
+    EXPECT_EQ(
+        MAKE_VECTOR(kAudioCodecs1),
+        reoffer->contents()[i].media_description()->as_audio()->codecs());
+    EXPECT_EQ(
+        MAKE_VECTOR(kVideoCodecs1),
+        offer->contents()[i + 1].media_description()->as_video()->codecs());
+    EXPECT_EQ(
+        MAKE_VECTOR(kVideoCodecsAnswer),
+        answer->contents()[i + 1].media_description()->as_video()->codecs());
+    EXPECT_EQ(
+        MAKE_VECTOR(kVideoCodecs1),
+        reoffer->contents()[i + 1].media_description()->as_video()->codecs());
+  }
+}
+
 // Create a typical video answer with GCM ciphers enabled, and ensure it
 // matches what we expect.
 TEST_F(MediaSessionDescriptionFactoryTest, TestCreateVideoAnswerGcm) {
@@ -25,6 +25,7 @@
 #include "logging/rtc_event_log/icelogger.h"
 #include "logging/rtc_event_log/output/rtc_event_log_output_file.h"
 #include "logging/rtc_event_log/rtc_event_log.h"
+#include "media/sctp/datagramtransport.h"
 #include "media/sctp/sctptransport.h"
 #include "pc/audiotrack.h"
 #include "pc/channel.h"
@@ -99,6 +100,10 @@ static const char kDefaultVideoSenderId[] = "defaultv0";
 // The length of RTCP CNAMEs.
 static const int kRtcpCnameLength = 16;
 
+// How long a collected stats report is reused for, unless
+// RTCConfiguration::stats_cache_lifetime_ms is set.
+static const int kDefaultStatsCacheLifetimeMs = 50;
+
 enum {
   MSG_SET_SESSIONDESCRIPTION_SUCCESS = 0,
   MSG_SET_SESSIONDESCRIPTION_FAILED,
@@ -666,6 +671,7 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
     int max_ipv6_networks;
     bool disable_link_local_networks;
     bool enable_rtp_data_channel;
+    bool enable_datagram_data_channel;
     rtc::Optional<int> screencast_min_bitrate;
     rtc::Optional<bool> combined_audio_video_bwe;
     rtc::Optional<bool> enable_dtls_srtp;
@@ -692,6 +698,7 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
     webrtc::TurnCustomizer* turn_customizer;
     SdpSemantics sdp_semantics;
     rtc::Optional<rtc::AdapterType> network_preference;
+    rtc::Optional<int> stats_cache_lifetime_ms;
   };
   static_assert(sizeof(stuff_being_tested_for_equality) == sizeof(*this),
                 "Did you add something to RTCConfiguration and forget to "
@@ -717,6 +724,7 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
          max_ipv6_networks == o.max_ipv6_networks &&
          disable_link_local_networks == o.disable_link_local_networks &&
          enable_rtp_data_channel == o.enable_rtp_data_channel &&
+         enable_datagram_data_channel == o.enable_datagram_data_channel &&
          screencast_min_bitrate == o.screencast_min_bitrate &&
          combined_audio_video_bwe == o.combined_audio_video_bwe &&
          enable_dtls_srtp == o.enable_dtls_srtp &&
@@ -738,7 +746,8 @@ bool PeerConnectionInterface::RTCConfiguration::operator==(
          ice_regather_interval_range == o.ice_regather_interval_range &&
          turn_customizer == o.turn_customizer &&
          sdp_semantics == o.sdp_semantics &&
-         network_preference == o.network_preference;
+         network_preference == o.network_preference &&
+         stats_cache_lifetime_ms == o.stats_cache_lifetime_ms;
 }
 
 bool PeerConnectionInterface::RTCConfiguration::operator!=(
@@ -949,10 +958,19 @@ bool PeerConnection::Initialize(
   transport_controller_->SignalDtlsHandshakeError.connect(
       this, &PeerConnection::OnTransportControllerDtlsHandshakeError);
 
-  sctp_factory_ = factory_->CreateSctpTransportInternalFactory();
+  if (configuration.enable_datagram_data_channel) {
+    sctp_factory_ =
+        rtc::MakeUnique<cricket::DatagramTransportFactory>(network_thread());
+  } else {
+    sctp_factory_ = factory_->CreateSctpTransportInternalFactory();
+  }
 
-  stats_.reset(new StatsCollector(this));
-  stats_collector_ = RTCStatsCollector::Create(this);
+  const int stats_cache_lifetime_ms =
+      configuration.stats_cache_lifetime_ms.value_or(
+          kDefaultStatsCacheLifetimeMs);
+  stats_.reset(new StatsCollector(this, stats_cache_lifetime_ms));
+  stats_collector_ = RTCStatsCollector::Create(
+      this, stats_cache_lifetime_ms * rtc::kNumMicrosecsPerMillisec);
 
   configuration_ = configuration;
 
@@ -1046,6 +1064,10 @@ RTCError PeerConnection::ValidateConfiguration(
                     "ice_regather_interval_range specified but continual "
                     "gathering policy is GATHER_ONCE");
   }
+  if (config.stats_cache_lifetime_ms && *config.stats_cache_lifetime_ms < 0) {
+    return RTCError(RTCErrorType::INVALID_RANGE,
+                    "stats_cache_lifetime_ms must not be negative");
+  }
   auto result =
       cricket::P2PTransportChannel::ValidateIceConfig(ParseIceConfig(config));
   return result;
@@ -1674,6 +1696,16 @@ void PeerConnection::GetStats(
   stats_collector_->GetStatsReport(internal_receiver, callback);
 }
 
+void PeerConnection::GetStats(
+    rtc::scoped_refptr<RTCStatsSubscription> subscription,
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {
+  TRACE_EVENT0("webrtc", "PeerConnection::GetStats");
+  RTC_DCHECK(subscription);
+  RTC_DCHECK(callback);
+  RTC_DCHECK(stats_collector_);
+  stats_collector_->GetStatsReport(subscription, callback);
+}
+
 PeerConnectionInterface::SignalingState PeerConnection::signaling_state() {
   return signaling_state_;
 }
@@ -4669,6 +4701,11 @@ bool PeerConnection::InitializePortAllocator_n(
     RTC_LOG(LS_INFO) << "Disable candidates on link-local network interfaces.";
   }
 
+  if (webrtc::field_trial::IsEnabled("WebRTC-EarlyRelayGathering")) {
+    port_allocator_flags_ |= cricket::PORTALLOCATOR_ENABLE_EARLY_RELAY;
+    RTC_LOG(LS_INFO) << "Relay candidates are gathered with UDP candidates.";
+  }
+
   port_allocator_->set_flags(port_allocator_flags_);
   // No step delay is used while allocating ports.
   port_allocator_->set_step_delay(cricket::kMinimumStepDelay);
@@ -4808,11 +4845,6 @@ RTCError PeerConnection::UpdateSessionState(
   // But all call-sites should be verifying this before calling us!
   RTC_DCHECK(session_error() == SessionError::kNone);
 
-  // If this is answer-ish we're ready to let media flow.
-  if (type == SdpType::kPrAnswer || type == SdpType::kAnswer) {
-    EnableSending();
-  }
-
   // Update the signaling state according to the specified state machine (see
   // https://w3c.github.io/webrtc-pc/#rtcsignalingstate-enum).
   if (type == SdpType::kOffer) {
@@ -4829,8 +4861,9 @@ RTCError PeerConnection::UpdateSessionState(
   }
 
   // Update internal objects according to the session description's media
-  // descriptions.
-  RTCError error = PushdownMediaDescription(type, source);
+  // descriptions. If this is answer-ish we're ready to let media flow.
+  RTCError error = PushdownMediaDescription(
+      type, source, type == SdpType::kPrAnswer || type == SdpType::kAnswer);
   if (!error.ok()) {
     return error;
   }
@@ -4840,18 +4873,32 @@ RTCError PeerConnection::UpdateSessionState(
 
 RTCError PeerConnection::PushdownMediaDescription(
     SdpType type,
-    cricket::ContentSource source) {
+    cricket::ContentSource source,
+    bool enable_sending) {
   const SessionDescriptionInterface* sdesc =
       (source == cricket::CS_LOCAL ? local_description()
                                    : remote_description());
   RTC_DCHECK(sdesc);
 
-  // Push down the new SDP media section for each audio/video transceiver.
+  // Collect the channels to enable and the new SDP media section for each
+  // audio/video transceiver, and for the RtpDataChannel if used, so that all
+  // of them are pushed down with a single hop to the worker thread instead of
+  // one blocking hop per channel.
+  std::vector<cricket::BaseChannel*> channels_to_enable;
+  std::vector<
+      std::pair<cricket::BaseChannel*, const MediaContentDescription*>>
+      channel_contents;
   for (auto transceiver : transceivers_) {
+    cricket::BaseChannel* channel = transceiver->internal()->channel();
+    if (!channel) {
+      continue;
+    }
+    if (enable_sending && !channel->enabled()) {
+      channels_to_enable.push_back(channel);
+    }
     const ContentInfo* content_info =
         FindMediaSectionForTransceiver(transceiver, sdesc);
-    cricket::BaseChannel* channel = transceiver->internal()->channel();
-    if (!channel || !content_info || content_info->rejected) {
+    if (!content_info || content_info->rejected) {
       continue;
     }
     const MediaContentDescription* content_desc =
@@ -4859,35 +4906,48 @@ RTCError PeerConnection::PushdownMediaDescription(
     if (!content_desc) {
       continue;
     }
-    std::string error;
-    bool success =
-        (source == cricket::CS_LOCAL)
-            ? channel->SetLocalContent(content_desc, type, &error)
-            : channel->SetRemoteContent(content_desc, type, &error);
-    if (!success) {
-      LOG_AND_RETURN_ERROR(RTCErrorType::INVALID_PARAMETER, std::move(error));
-    }
+    channel_contents.push_back(std::make_pair(channel, content_desc));
   }
 
-  // If using the RtpDataChannel, push down the new SDP section for it too.
   if (rtp_data_channel_) {
+    if (enable_sending && !rtp_data_channel_->enabled()) {
+      channels_to_enable.push_back(rtp_data_channel_);
+    }
     const ContentInfo* data_content =
         cricket::GetFirstDataContent(sdesc->description());
     if (data_content && !data_content->rejected) {
       const MediaContentDescription* data_desc =
           data_content->media_description();
       if (data_desc) {
-        std::string error;
-        bool success =
+        channel_contents.push_back(
+            std::make_pair(rtp_data_channel_, data_desc));
+      }
+    }
+  }
+
+  if (!channels_to_enable.empty() || !channel_contents.empty()) {
+    // The channel methods invoke on the worker thread, which they do inline
+    // when already running on it.
+    std::string error;
+    bool success = worker_thread()->Invoke<bool>(RTC_FROM_HERE, [&] {
+      for (cricket::BaseChannel* channel : channels_to_enable) {
+        channel->Enable(true);
+      }
+      for (const auto& channel_content : channel_contents) {
+        cricket::BaseChannel* channel = channel_content.first;
+        const MediaContentDescription* content_desc = channel_content.second;
+        bool applied =
             (source == cricket::CS_LOCAL)
-                ? rtp_data_channel_->SetLocalContent(data_desc, type, &error)
-                : rtp_data_channel_->SetRemoteContent(data_desc, type,
-                                                      &error);
-        if (!success) {
-          LOG_AND_RETURN_ERROR(RTCErrorType::INVALID_PARAMETER,
-                               std::move(error));
+                ? channel->SetLocalContent(content_desc, type, &error)
+                : channel->SetRemoteContent(content_desc, type, &error);
+        if (!applied) {
+          return false;
         }
       }
+      return true;
+    });
+    if (!success) {
+      LOG_AND_RETURN_ERROR(RTCErrorType::INVALID_PARAMETER, std::move(error));
     }
   }
 
@@ -5295,19 +5355,6 @@ void PeerConnection::OnTransportControllerDtlsHandshakeError(
   }
 }
 
-void PeerConnection::EnableSending() {
-  for (auto transceiver : transceivers_) {
-    cricket::BaseChannel* channel = transceiver->internal()->channel();
-    if (channel && !channel->enabled()) {
-      channel->Enable(true);
-    }
-  }
-
-  if (rtp_data_channel_ && !rtp_data_channel_->enabled()) {
-    rtp_data_channel_->Enable(true);
-  }
-}
-
 // Returns the media index for a local ice candidate given the content name.
 bool PeerConnection::GetLocalCandidateMediaIndex(
     const std::string& content_name,
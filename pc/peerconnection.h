@@ -128,6 +128,9 @@ class PeerConnection : public PeerConnectionInternal,
   void GetStats(
       rtc::scoped_refptr<RtpReceiverInterface> selector,
       rtc::scoped_refptr<RTCStatsCollectorCallback> callback) override;
+  void GetStats(
+      rtc::scoped_refptr<RTCStatsSubscription> subscription,
+      rtc::scoped_refptr<RTCStatsCollectorCallback> callback) override;
   void ClearStatsCache() override;
 
   SignalingState signaling_state() override;
@@ -727,9 +730,11 @@ class PeerConnection : public PeerConnectionInternal,
                               cricket::ContentSource source,
                               const cricket::SessionDescription* description);
   // Push the media parts of the local or remote session description
-  // down to all of the channels.
+  // down to all of the channels. With |enable_sending|, also enables the
+  // channels to allow sending of media.
   RTCError PushdownMediaDescription(SdpType type,
-                                    cricket::ContentSource source);
+                                    cricket::ContentSource source,
+                                    bool enable_sending);
   bool PushdownSctpParameters_n(cricket::ContentSource source);
 
   RTCError PushdownTransportDescription(cricket::ContentSource source,
@@ -742,11 +747,6 @@ class PeerConnection : public PeerConnectionInternal,
       const std::string& content_name,
       cricket::TransportDescription* info);
 
-  // Enables media channels to allow sending of media.
-  // This enables media to flow on all configured audio/video channels and the
-  // RtpDataChannel.
-  void EnableSending();
-
   // Destroys all BaseChannels and destroys the SCTP data channel, if present.
   void DestroyAllChannels();
 
@@ -25,7 +25,10 @@
 #include "media/sctp/sctptransport.h"
 #include "rtc_base/bind.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
+#include "rtc_base/timeutils.h"
+#include "rtc_base/trace_event.h"
 // Adding 'nogncheck' to disable the gn include headers check to support modular
 // WebRTC build targets.
 // TODO(zhihuang): This wouldn't be necessary if the interface and
@@ -173,6 +176,8 @@ PeerConnectionFactory::~PeerConnectionFactory() {
 
 bool PeerConnectionFactory::Initialize() {
   RTC_DCHECK(signaling_thread_->IsCurrent());
+  TRACE_EVENT0("webrtc", "PeerConnectionFactory::Initialize");
+  const int64_t start_time_ms = rtc::TimeMillis();
   rtc::InitRandom(rtc::Time32());
 
   default_network_manager_.reset(new rtc::BasicNetworkManager());
@@ -195,11 +200,29 @@ bool PeerConnectionFactory::Initialize() {
     return false;
   }
 
+  RTC_LOG(LS_INFO) << "PeerConnectionFactory::Initialize took "
+                   << rtc::TimeMillis() - start_time_ms << " ms";
   return true;
 }
 
 void PeerConnectionFactory::SetOptions(const Options& options) {
+  bool pool_changed =
+      options.certificate_pool_size != options_.certificate_pool_size ||
+      options.certificate_pool_max_age_ms !=
+          options_.certificate_pool_max_age_ms;
   options_ = options;
+  if (!pool_changed)
+    return;
+
+  certificate_pool_ = nullptr;
+  if (options_.certificate_pool_size > 0) {
+    rtc::RTCCertificatePool::Config config;
+    config.size = static_cast<size_t>(options_.certificate_pool_size);
+    config.max_age_ms = options_.certificate_pool_max_age_ms;
+    certificate_pool_ = new rtc::RefCountedObject<rtc::RTCCertificatePool>(
+        signaling_thread_, network_thread_, config);
+    certificate_pool_->Prepare(rtc::KeyParams());
+  }
 }
 
 rtc::scoped_refptr<AudioSourceInterface>
@@ -253,6 +276,11 @@ void PeerConnectionFactory::StopAecDump() {
   channel_manager_->StopAecDump();
 }
 
+std::vector<rtc::TaskStats::Entry> PeerConnectionFactory::GetTaskStats()
+    const {
+  return rtc::TaskStats::Get();
+}
+
 rtc::scoped_refptr<PeerConnectionInterface>
 PeerConnectionFactory::CreatePeerConnection(
     const PeerConnectionInterface::RTCConfiguration& configuration_in,
@@ -293,7 +321,7 @@ PeerConnectionFactory::CreatePeerConnection(
   // Set internal defaults if optional dependencies are not set.
   if (!dependencies.cert_generator) {
     dependencies.cert_generator = rtc::MakeUnique<rtc::RTCCertificateGenerator>(
-        signaling_thread_, network_thread_);
+        signaling_thread_, network_thread_, certificate_pool_);
   }
   if (!dependencies.allocator) {
     dependencies.allocator.reset(new cricket::BasicPortAllocator(
@@ -661,9 +661,57 @@ rtc::scoped_refptr<RTCStatsReport> CreateReportFilteredBySelector(
 
 }  // namespace
 
+RTCStatsCollector::CollectionScope
+RTCStatsCollector::CollectionScope::ForSubscription(
+    const RTCStatsSubscription& subscription) {
+  if (subscription.types().empty())
+    return All();
+  CollectionScope scope = {false, false, false};
+  for (const std::string& type : subscription.types()) {
+    if (type == RTCMediaStreamStats::kType ||
+        type == RTCMediaStreamTrackStats::kType) {
+      scope.media = true;
+    } else if (type == RTCCodecStats::kType ||
+               type == RTCInboundRTPStreamStats::kType ||
+               type == RTCOutboundRTPStreamStats::kType) {
+      scope.media = true;
+      scope.network = true;
+    } else if (type == RTCIceCandidatePairStats::kType) {
+      scope.call = true;
+      scope.network = true;
+    } else if (type == RTCCertificateStats::kType ||
+               type == RTCLocalIceCandidateStats::kType ||
+               type == RTCRemoteIceCandidateStats::kType ||
+               type == RTCTransportStats::kType) {
+      scope.network = true;
+    }
+    // The remaining types are produced on the signaling thread from state that
+    // is always available.
+  }
+  return scope;
+}
+
+bool RTCStatsCollector::CollectionScope::Covers(
+    const CollectionScope& other) const {
+  return (media || !other.media) && (call || !other.call) &&
+         (network || !other.network);
+}
+
+RTCStatsCollector::CollectionScope& RTCStatsCollector::CollectionScope::
+operator|=(const CollectionScope& other) {
+  media |= other.media;
+  call |= other.call;
+  network |= other.network;
+  return *this;
+}
+
 RTCStatsCollector::RequestInfo::RequestInfo(
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback)
-    : RequestInfo(FilterMode::kAll, std::move(callback), nullptr, nullptr) {}
+    : RequestInfo(FilterMode::kAll,
+                  std::move(callback),
+                  nullptr,
+                  nullptr,
+                  nullptr) {}
 
 RTCStatsCollector::RequestInfo::RequestInfo(
     rtc::scoped_refptr<RtpSenderInternal> selector,
@@ -671,6 +719,7 @@ RTCStatsCollector::RequestInfo::RequestInfo(
     : RequestInfo(FilterMode::kSenderSelector,
                   std::move(callback),
                   std::move(selector),
+                  nullptr,
                   nullptr) {}
 
 RTCStatsCollector::RequestInfo::RequestInfo(
@@ -679,21 +728,42 @@ RTCStatsCollector::RequestInfo::RequestInfo(
     : RequestInfo(FilterMode::kReceiverSelector,
                   std::move(callback),
                   nullptr,
-                  std::move(selector)) {}
+                  std::move(selector),
+                  nullptr) {}
+
+RTCStatsCollector::RequestInfo::RequestInfo(
+    rtc::scoped_refptr<RTCStatsSubscription> subscription,
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback)
+    : RequestInfo(FilterMode::kSubscription,
+                  std::move(callback),
+                  nullptr,
+                  nullptr,
+                  std::move(subscription)) {
+  RTC_DCHECK(subscription_);
+}
 
 RTCStatsCollector::RequestInfo::RequestInfo(
     RTCStatsCollector::RequestInfo::FilterMode filter_mode,
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback,
     rtc::scoped_refptr<RtpSenderInternal> sender_selector,
-    rtc::scoped_refptr<RtpReceiverInternal> receiver_selector)
+    rtc::scoped_refptr<RtpReceiverInternal> receiver_selector,
+    rtc::scoped_refptr<RTCStatsSubscription> subscription)
     : filter_mode_(filter_mode),
       callback_(std::move(callback)),
       sender_selector_(std::move(sender_selector)),
-      receiver_selector_(std::move(receiver_selector)) {
+      receiver_selector_(std::move(receiver_selector)),
+      subscription_(std::move(subscription)) {
   RTC_DCHECK(callback_);
   RTC_DCHECK(!sender_selector_ || !receiver_selector_);
 }
 
+RTCStatsCollector::CollectionScope RTCStatsCollector::RequestInfo::scope()
+    const {
+  if (filter_mode_ == FilterMode::kSubscription)
+    return CollectionScope::ForSubscription(*subscription_);
+  return CollectionScope::All();
+}
+
 rtc::scoped_refptr<RTCStatsCollector> RTCStatsCollector::Create(
     PeerConnectionInternal* pc,
     int64_t cache_lifetime_us) {
@@ -709,8 +779,10 @@ RTCStatsCollector::RTCStatsCollector(PeerConnectionInternal* pc,
       network_thread_(pc->network_thread()),
       num_pending_partial_reports_(0),
       partial_report_timestamp_us_(0),
+      partial_report_scope_(CollectionScope::All()),
       cache_timestamp_us_(0),
-      cache_lifetime_us_(cache_lifetime_us) {
+      cache_lifetime_us_(cache_lifetime_us),
+      cached_report_scope_(CollectionScope::All()) {
   RTC_DCHECK(pc_);
   RTC_DCHECK(signaling_thread_);
   RTC_DCHECK(worker_thread_);
@@ -741,57 +813,100 @@ void RTCStatsCollector::GetStatsReport(
   GetStatsReportInternal(RequestInfo(std::move(selector), std::move(callback)));
 }
 
+void RTCStatsCollector::GetStatsReport(
+    rtc::scoped_refptr<RTCStatsSubscription> subscription,
+    rtc::scoped_refptr<RTCStatsCollectorCallback> callback) {
+  GetStatsReportInternal(
+      RequestInfo(std::move(subscription), std::move(callback)));
+}
+
 void RTCStatsCollector::GetStatsReportInternal(
     RTCStatsCollector::RequestInfo request) {
   RTC_DCHECK(signaling_thread_->IsCurrent());
+  const CollectionScope scope = request.scope();
   requests_.push_back(std::move(request));
 
   // "Now" using a monotonically increasing timer.
   int64_t cache_now_us = rtc::TimeMicros();
   if (cached_report_ &&
-      cache_now_us - cache_timestamp_us_ <= cache_lifetime_us_) {
+      cache_now_us - cache_timestamp_us_ <= cache_lifetime_us_ &&
+      cached_report_scope_.Covers(scope)) {
     // We have a fresh cached report to deliver. Deliver asynchronously, since
     // the caller may not be expecting a synchronous callback, and it avoids
     // reentrancy problems.
-    std::vector<RequestInfo> requests;
-    requests.swap(requests_);
     invoker_.AsyncInvoke<void>(
         RTC_FROM_HERE, signaling_thread_,
         rtc::Bind(&RTCStatsCollector::DeliverCachedReport, this, cached_report_,
-                  std::move(requests)));
+                  TakeRequestsCoveredBy(cached_report_scope_)));
   } else if (!num_pending_partial_reports_) {
     // Only start gathering stats if we're not already gathering stats. In the
     // case of already gathering stats, |callback_| will be invoked when there
     // are no more pending partial reports.
+    StartCollection(cache_now_us);
+  }
+}
 
-    // "Now" using a system clock, relative to the UNIX epoch (Jan 1, 1970,
-    // UTC), in microseconds. The system clock could be modified and is not
-    // necessarily monotonically increasing.
-    int64_t timestamp_us = rtc::TimeUTCMicros();
-
-    num_pending_partial_reports_ = 2;
-    partial_report_timestamp_us_ = cache_now_us;
-
-    // Prepare |transceiver_stats_infos_| for use in
-    // |ProducePartialResultsOnNetworkThread| and
-    // |ProducePartialResultsOnSignalingThread|.
+void RTCStatsCollector::StartCollection(int64_t cache_now_us) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  RTC_DCHECK(!requests_.empty());
+  RTC_DCHECK_EQ(num_pending_partial_reports_, 0);
+  CollectionScope scope = {false, false, false};
+  for (const RequestInfo& request : requests_)
+    scope |= request.scope();
+
+  // "Now" using a system clock, relative to the UNIX epoch (Jan 1, 1970,
+  // UTC), in microseconds. The system clock could be modified and is not
+  // necessarily monotonically increasing.
+  int64_t timestamp_us = rtc::TimeUTCMicros();
+
+  num_pending_partial_reports_ = scope.network ? 2 : 1;
+  partial_report_timestamp_us_ = cache_now_us;
+  partial_report_scope_ = scope;
+
+  // Prepare |transceiver_stats_infos_| for use in
+  // |ProducePartialResultsOnNetworkThread| and
+  // |ProducePartialResultsOnSignalingThread|.
+  if (scope.media)
     transceiver_stats_infos_ = PrepareTransceiverStatsInfos_s();
-    // Prepare |transport_names_| for use in
-    // |ProducePartialResultsOnNetworkThread|.
-    transport_names_ = PrepareTransportNames_s();
-
-    // Prepare |call_stats_| here since GetCallStats() will hop to the worker
-    // thread.
-    // TODO(holmer): To avoid the hop we could move BWE and BWE stats to the
-    // network thread, where it more naturally belongs.
-    call_stats_ = pc_->GetCallStats();
-
+  // Prepare |transport_names_| for use in
+  // |ProducePartialResultsOnNetworkThread|.
+  transport_names_ =
+      scope.network ? PrepareTransportNames_s() : std::set<std::string>();
+
+  // Prepare |call_stats_| here since GetCallStats() will hop to the worker
+  // thread.
+  // TODO(holmer): To avoid the hop we could move BWE and BWE stats to the
+  // network thread, where it more naturally belongs.
+  call_stats_ = scope.call ? pc_->GetCallStats() : Call::Stats();
+
+  if (scope.network) {
     invoker_.AsyncInvoke<void>(
         RTC_FROM_HERE, network_thread_,
         rtc::Bind(&RTCStatsCollector::ProducePartialResultsOnNetworkThread,
                   rtc::scoped_refptr<RTCStatsCollector>(this), timestamp_us));
     ProducePartialResultsOnSignalingThread(timestamp_us);
+  } else {
+    // The signaling thread results complete the report; produce them
+    // asynchronously so that the callback is not invoked synchronously.
+    invoker_.AsyncInvoke<void>(
+        RTC_FROM_HERE, signaling_thread_,
+        rtc::Bind(&RTCStatsCollector::ProducePartialResultsOnSignalingThread,
+                  rtc::scoped_refptr<RTCStatsCollector>(this), timestamp_us));
+  }
+}
+
+std::vector<RTCStatsCollector::RequestInfo>
+RTCStatsCollector::TakeRequestsCoveredBy(const CollectionScope& scope) {
+  std::vector<RequestInfo> covered_requests;
+  std::vector<RequestInfo> remaining_requests;
+  for (RequestInfo& request : requests_) {
+    if (scope.Covers(request.scope()))
+      covered_requests.push_back(std::move(request));
+    else
+      remaining_requests.push_back(std::move(request));
   }
+  requests_.swap(remaining_requests);
+  return covered_requests;
 }
 
 void RTCStatsCollector::ClearCachedStatsReport() {
@@ -871,6 +986,7 @@ void RTCStatsCollector::AddPartialResults_s(
   if (!num_pending_partial_reports_) {
     cache_timestamp_us_ = partial_report_timestamp_us_;
     cached_report_ = partial_report_;
+    cached_report_scope_ = partial_report_scope_;
     partial_report_ = nullptr;
     transceiver_stats_infos_.clear();
     // Trace WebRTC Stats when getStats is called on Javascript.
@@ -879,10 +995,12 @@ void RTCStatsCollector::AddPartialResults_s(
     TRACE_EVENT_INSTANT1("webrtc_stats", "webrtc_stats", "report",
                          cached_report_->ToJson());
 
-    // Deliver report and clear |requests_|.
-    std::vector<RequestInfo> requests;
-    requests.swap(requests_);
-    DeliverCachedReport(cached_report_, std::move(requests));
+    // Deliver the report to the requests it covers. Requests that arrived
+    // during the collection may need a wider scope, gather again for those.
+    DeliverCachedReport(cached_report_,
+                        TakeRequestsCoveredBy(cached_report_scope_));
+    if (!requests_.empty() && !num_pending_partial_reports_)
+      StartCollection(rtc::TimeMicros());
   }
 }
 
@@ -896,6 +1014,10 @@ void RTCStatsCollector::DeliverCachedReport(
   for (const RequestInfo& request : requests) {
     if (request.filter_mode() == RequestInfo::FilterMode::kAll) {
       request.callback()->OnStatsDelivered(cached_report);
+    } else if (request.filter_mode() ==
+               RequestInfo::FilterMode::kSubscription) {
+      request.callback()->OnStatsDelivered(
+          request.subscription()->FilterReport(*cached_report));
     } else {
       bool filter_by_sender_selector;
       rtc::scoped_refptr<RtpSenderInternal> sender_selector;
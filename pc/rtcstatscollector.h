@@ -21,6 +21,7 @@
 #include "api/stats/rtcstats_objects.h"
 #include "api/stats/rtcstatscollectorcallback.h"
 #include "api/stats/rtcstatsreport.h"
+#include "api/stats/rtcstatssubscription.h"
 #include "call/call.h"
 #include "media/base/mediachannel.h"
 #include "pc/datachannel.h"
@@ -65,6 +66,10 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   // as: no RTP streams are received by selector). The result is empty.
   void GetStatsReport(rtc::scoped_refptr<RtpReceiverInternal> selector,
                       rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
+  // Delivers the subset of stats described by |subscription|. Only the stats
+  // needed by the subscribed types are gathered, see |CollectionScope|.
+  void GetStatsReport(rtc::scoped_refptr<RTCStatsSubscription> subscription,
+                      rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
   // Clears the cache's reference to the most recent stats report. Subsequently
   // calling |GetStatsReport| guarantees fresh stats.
   void ClearCachedStatsReport();
@@ -87,9 +92,34 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
       const rtc::scoped_refptr<RTCStatsReport>& partial_report);
 
  private:
+  // The parts of the stats that are gathered. Gathering the media stats
+  // requires a blocking hop to the worker thread, as does gathering the call
+  // stats, and everything produced on the network thread requires a hop there.
+  // Reports are gathered with the union of the scopes of pending requests.
+  struct CollectionScope {
+    static CollectionScope All() { return {true, true, true}; }
+    static CollectionScope ForSubscription(
+        const RTCStatsSubscription& subscription);
+
+    bool Covers(const CollectionScope& other) const;
+    CollectionScope& operator|=(const CollectionScope& other);
+
+    // Stats derived from the transceivers and media channels.
+    bool media;
+    // |Call::Stats|, used by the candidate pair stats.
+    bool call;
+    // Stats produced on the network thread.
+    bool network;
+  };
+
   class RequestInfo {
    public:
-    enum class FilterMode { kAll, kSenderSelector, kReceiverSelector };
+    enum class FilterMode {
+      kAll,
+      kSenderSelector,
+      kReceiverSelector,
+      kSubscription
+    };
 
     // Constructs with FilterMode::kAll.
     explicit RequestInfo(
@@ -102,8 +132,12 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
     // applied even if |selector| is null, resulting in an empty report.
     RequestInfo(rtc::scoped_refptr<RtpReceiverInternal> selector,
                 rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
+    // Constructs with FilterMode::kSubscription.
+    RequestInfo(rtc::scoped_refptr<RTCStatsSubscription> subscription,
+                rtc::scoped_refptr<RTCStatsCollectorCallback> callback);
 
     FilterMode filter_mode() const { return filter_mode_; }
+    CollectionScope scope() const;
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback() const {
       return callback_;
     }
@@ -115,20 +149,31 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
       RTC_DCHECK(filter_mode_ == FilterMode::kReceiverSelector);
       return receiver_selector_;
     }
+    rtc::scoped_refptr<RTCStatsSubscription> subscription() const {
+      RTC_DCHECK(filter_mode_ == FilterMode::kSubscription);
+      return subscription_;
+    }
 
    private:
     RequestInfo(FilterMode filter_mode,
                 rtc::scoped_refptr<RTCStatsCollectorCallback> callback,
                 rtc::scoped_refptr<RtpSenderInternal> sender_selector,
-                rtc::scoped_refptr<RtpReceiverInternal> receiver_selector);
+                rtc::scoped_refptr<RtpReceiverInternal> receiver_selector,
+                rtc::scoped_refptr<RTCStatsSubscription> subscription);
 
     FilterMode filter_mode_;
     rtc::scoped_refptr<RTCStatsCollectorCallback> callback_;
     rtc::scoped_refptr<RtpSenderInternal> sender_selector_;
     rtc::scoped_refptr<RtpReceiverInternal> receiver_selector_;
+    rtc::scoped_refptr<RTCStatsSubscription> subscription_;
   };
 
   void GetStatsReportInternal(RequestInfo request);
+  // Starts gathering stats for |requests_|, with the union of their scopes.
+  void StartCollection(int64_t cache_now_us);
+  // Removes the requests that a report of |scope| satisfies from |requests_|
+  // and returns them.
+  std::vector<RequestInfo> TakeRequestsCoveredBy(const CollectionScope& scope);
 
   struct CertificateStatsPair {
     std::unique_ptr<rtc::SSLCertificateStats> local;
@@ -225,6 +270,7 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
 
   int num_pending_partial_reports_;
   int64_t partial_report_timestamp_us_;
+  CollectionScope partial_report_scope_;
   rtc::scoped_refptr<RTCStatsReport> partial_report_;
   std::vector<RequestInfo> requests_;
 
@@ -244,6 +290,7 @@ class RTCStatsCollector : public virtual rtc::RefCountInterface,
   int64_t cache_timestamp_us_;
   int64_t cache_lifetime_us_;
   rtc::scoped_refptr<const RTCStatsReport> cached_report_;
+  CollectionScope cached_report_scope_;
 
   // Data recorded and maintained by the stats collector during its lifetime.
   // Some stats are produced from this record instead of other components.
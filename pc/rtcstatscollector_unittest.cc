@@ -319,6 +319,13 @@ class RTCStatsCollectorWrapper {
     return WaitForReport(callback);
   }
 
+  rtc::scoped_refptr<const RTCStatsReport> GetStatsReportWithSubscription(
+      rtc::scoped_refptr<RTCStatsSubscription> subscription) {
+    rtc::scoped_refptr<RTCStatsObtainer> callback = RTCStatsObtainer::Create();
+    stats_collector_->GetStatsReport(subscription, callback);
+    return WaitForReport(callback);
+  }
+
   rtc::scoped_refptr<const RTCStatsReport> GetFreshStatsReport() {
     stats_collector_->ClearCachedStatsReport();
     return GetStatsReport();
@@ -1325,6 +1332,47 @@ TEST_F(RTCStatsCollectorTest, CollectRTCPeerConnectionStats) {
   }
 }
 
+TEST_F(RTCStatsCollectorTest, CollectSubscribedStatsAsDeltas) {
+  rtc::scoped_refptr<RTCStatsSubscription> subscription =
+      RTCStatsSubscription::Create({RTCPeerConnectionStats::kType},
+                                   {"dataChannelsOpened"}, true);
+  {
+    rtc::scoped_refptr<const RTCStatsReport> report =
+        stats_->GetStatsReportWithSubscription(subscription);
+    RTCPeerConnectionStats expected("RTCPeerConnection",
+                                    report->timestamp_us());
+    expected.data_channels_opened = 0;
+    EXPECT_EQ(1u, report->size());
+    ASSERT_TRUE(report->Get("RTCPeerConnection"));
+    EXPECT_EQ(expected,
+              report->Get("RTCPeerConnection")->cast_to<
+                  RTCPeerConnectionStats>());
+  }
+
+  // Nothing has changed.
+  stats_->stats_collector()->ClearCachedStatsReport();
+  EXPECT_EQ(0u, stats_->GetStatsReportWithSubscription(subscription)->size());
+
+  rtc::scoped_refptr<DataChannel> dummy_channel = DataChannel::Create(
+      nullptr, cricket::DCT_NONE, "DummyChannel", InternalDataChannelInit());
+  pc_->SignalDataChannelCreated()(dummy_channel.get());
+  dummy_channel->SignalOpened(dummy_channel.get());
+
+  {
+    stats_->stats_collector()->ClearCachedStatsReport();
+    rtc::scoped_refptr<const RTCStatsReport> report =
+        stats_->GetStatsReportWithSubscription(subscription);
+    RTCPeerConnectionStats expected("RTCPeerConnection",
+                                    report->timestamp_us());
+    expected.data_channels_opened = 1;
+    EXPECT_EQ(1u, report->size());
+    ASSERT_TRUE(report->Get("RTCPeerConnection"));
+    EXPECT_EQ(expected,
+              report->Get("RTCPeerConnection")->cast_to<
+                  RTCPeerConnectionStats>());
+  }
+}
+
 TEST_F(RTCStatsCollectorTest,
        CollectLocalRTCMediaStreamStatsAndRTCMediaStreamTrackStats_Audio) {
   rtc::scoped_refptr<MediaStream> local_stream =
@@ -2179,6 +2227,25 @@ class FakeRTCStatsCollector : public RTCStatsCollector,
     delivered_report_ = report;
   }
 
+  // A subscription to stats produced on the signaling thread only does not
+  // hop to the network thread.
+  void VerifySubscriptionThreadUsage() {
+    GetStatsReport(
+        RTCStatsSubscription::Create({RTCPeerConnectionStats::kType}, {}, false),
+        rtc::scoped_refptr<RTCStatsCollectorCallback>(this));
+    EXPECT_TRUE_WAIT(HasDeliveredReport(), kGetStatsReportTimeoutMs);
+    rtc::CritScope cs(&lock_);
+    EXPECT_EQ(produced_on_signaling_thread_, 1);
+    EXPECT_EQ(produced_on_network_thread_, 0);
+    // The test stats are not of the subscribed type.
+    EXPECT_EQ(0u, delivered_report_->size());
+  }
+
+  bool HasDeliveredReport() {
+    rtc::CritScope cs(&lock_);
+    return delivered_report_ != nullptr;
+  }
+
   void VerifyThreadUsageAndResultsMerging() {
     GetStatsReport(rtc::scoped_refptr<RTCStatsCollectorCallback>(this));
     EXPECT_TRUE_WAIT(HasVerifiedResults(), kGetStatsReportTimeoutMs);
@@ -2256,6 +2323,14 @@ TEST(RTCStatsCollectorTestWithFakeCollector, ThreadUsageAndResultsMerging) {
   stats_collector->VerifyThreadUsageAndResultsMerging();
 }
 
+TEST(RTCStatsCollectorTestWithFakeCollector, SubscriptionThreadUsage) {
+  rtc::scoped_refptr<FakePeerConnectionForStats> pc(
+      new rtc::RefCountedObject<FakePeerConnectionForStats>());
+  rtc::scoped_refptr<FakeRTCStatsCollector> stats_collector(
+      FakeRTCStatsCollector::Create(pc, 50 * rtc::kNumMicrosecsPerMillisec));
+  stats_collector->VerifySubscriptionThreadUsage();
+}
+
 }  // namespace
 
 }  // namespace webrtc
@@ -18,6 +18,7 @@
 #include "p2p/base/packettransportinterface.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/receivebufferpool.h"
 #include "rtc_base/trace_event.h"
 
 namespace webrtc {
@@ -137,6 +138,22 @@ bool RtpTransport::SendPacket(bool rtcp,
   return true;
 }
 
+size_t RtpTransport::SendRtpPacketBatch(rtc::OutgoingPacket* packets,
+                                        size_t count,
+                                        int flags) {
+  if (count == 0)
+    return 0;
+  int sent = rtp_packet_transport_->SendPackets(packets, count, flags);
+  if (sent < 0) {
+    if (rtp_packet_transport_->GetError() == ENOTCONN) {
+      RTC_LOG(LS_WARNING) << "Got ENOTCONN from transport.";
+      SetReadyToSend(/*rtcp=*/false, false);
+    }
+    return 0;
+  }
+  return static_cast<size_t>(sent);
+}
+
 void RtpTransport::UpdateRtpHeaderExtensionMap(
     const cricket::RtpHeaderExtensions& header_extensions) {
   header_extension_map_ = RtpHeaderExtensionMap(header_extensions);
@@ -262,7 +279,10 @@ void RtpTransport::OnReadPacket(rtc::PacketTransportInternal* transport,
     return;
   }
 
-  rtc::CopyOnWriteBuffer packet(data, len);
+  // Takes over the socket's receive buffer when it was lent out, so that SRTP
+  // and the RTP parser can work on it in place.
+  rtc::CopyOnWriteBuffer packet = rtc::ReceiveBufferPool::TakeOrCopy(
+      reinterpret_cast<const uint8_t*>(data), len);
   // Protect ourselves against crazy data.
   if (!cricket::IsValidRtpRtcpPacketSize(rtcp, packet.size())) {
     RTC_LOG(LS_ERROR) << "Dropping incoming "
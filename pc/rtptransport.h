@@ -21,6 +21,7 @@
 namespace rtc {
 
 class CopyOnWriteBuffer;
+struct OutgoingPacket;
 struct PacketOptions;
 struct PacketTime;
 class PacketTransportInternal;
@@ -97,6 +98,11 @@ class RtpTransport : public RtpTransportInternal {
                   rtc::CopyOnWriteBuffer* packet,
                   const rtc::PacketOptions& options,
                   int flags);
+  // Sends a batch of RTP packets through the RTP packet transport. Returns the
+  // number of packets sent.
+  size_t SendRtpPacketBatch(rtc::OutgoingPacket* packets,
+                            size_t count,
+                            int flags);
 
   // Overridden by SrtpTransport.
   virtual void OnNetworkRouteChanged(
@@ -209,6 +209,7 @@ class MediaContentDescriptionImpl : public MediaContentDescription {
 
   // Codecs should be in preference order (most preferred codec first).
   const std::vector<C>& codecs() const { return codecs_; }
+  std::vector<C>& mutable_codecs() { return codecs_; }
   void set_codecs(const std::vector<C>& codecs) { codecs_ = codecs; }
   virtual bool has_codecs() const { return !codecs_.empty(); }
   bool HasCodec(int id) {
@@ -162,6 +162,82 @@ bool SrtpSession::UnprotectRtcp(void* p, int in_len, int* out_len) {
   return true;
 }
 
+size_t SrtpSession::ProtectRtpBatch(rtc::ArrayView<SrtpBatchPacket> packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to protect " << packets.size()
+                        << " SRTP packets: no SRTP Session";
+    return 0;
+  }
+
+  size_t protected_packets = 0;
+  int first_err = srtp_err_status_ok;
+  for (SrtpBatchPacket& packet : packets) {
+    int err = packet.capacity < packet.length + rtp_auth_tag_len_
+                  ? srtp_err_status_bad_param
+                  : srtp_protect(session_, packet.data, &packet.length);
+    packet.ok = err == srtp_err_status_ok;
+    if (packet.ok) {
+      ++protected_packets;
+    } else if (first_err == srtp_err_status_ok) {
+      first_err = err;
+    }
+  }
+
+  // Only the last sequence number is needed, for logging.
+  for (size_t i = packets.size(); i > 0; --i) {
+    if (packets[i - 1].ok) {
+      GetRtpSeqNum(packets[i - 1].data, packets[i - 1].length,
+                   &last_send_seq_num_);
+      break;
+    }
+  }
+  if (protected_packets < packets.size()) {
+    RTC_LOG(LS_WARNING) << "Failed to protect "
+                        << packets.size() - protected_packets << " of "
+                        << packets.size() << " SRTP packets, first err="
+                        << first_err
+                        << ", last seqnum=" << last_send_seq_num_;
+  }
+  return protected_packets;
+}
+
+size_t SrtpSession::UnprotectRtpBatch(
+    rtc::ArrayView<SrtpBatchPacket> packets) {
+  RTC_DCHECK(thread_checker_.CalledOnValidThread());
+  if (!session_) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect " << packets.size()
+                        << " SRTP packets: no SRTP Session";
+    return 0;
+  }
+
+  size_t unprotected_packets = 0;
+  int first_err = srtp_err_status_ok;
+  for (SrtpBatchPacket& packet : packets) {
+    int err = srtp_unprotect(session_, packet.data, &packet.length);
+    packet.ok = err == srtp_err_status_ok;
+    if (packet.ok) {
+      ++unprotected_packets;
+      continue;
+    }
+    if (first_err == srtp_err_status_ok) {
+      first_err = err;
+    }
+    if (metrics_observer_) {
+      metrics_observer_->IncrementSparseEnumCounter(
+          webrtc::kEnumCounterSrtpUnprotectError, err);
+    }
+  }
+
+  if (unprotected_packets < packets.size()) {
+    RTC_LOG(LS_WARNING) << "Failed to unprotect "
+                        << packets.size() - unprotected_packets << " of "
+                        << packets.size()
+                        << " SRTP packets, first err=" << first_err;
+  }
+  return unprotected_packets;
+}
+
 bool SrtpSession::GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len) {
   RTC_DCHECK(thread_checker_.CalledOnValidThread());
   RTC_DCHECK(IsExternalAuthActive());
@@ -13,6 +13,7 @@
 
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/umametrics.h"
 #include "rtc_base/scoped_ref_ptr.h"
 #include "rtc_base/thread_checker.h"
@@ -23,6 +24,17 @@ struct srtp_ctx_t_;
 
 namespace cricket {
 
+// One packet of a batch passed to SrtpSession::ProtectRtpBatch() or
+// UnprotectRtpBatch(). The packet is transformed in place and |length| is
+// updated; |capacity| is only used when protecting. |ok| reports whether the
+// packet was transformed.
+struct SrtpBatchPacket {
+  void* data = nullptr;
+  int length = 0;
+  int capacity = 0;
+  bool ok = false;
+};
+
 // Class that wraps a libSRTP session.
 class SrtpSession {
  public:
@@ -66,6 +78,12 @@ class SrtpSession {
   bool UnprotectRtp(void* data, int in_len, int* out_len);
   bool UnprotectRtcp(void* data, int in_len, int* out_len);
 
+  // Protects/unprotects a batch of RTP packets in place. The session state is
+  // checked once per batch and failures are logged once per batch rather
+  // than per packet. Returns the number of packets that succeeded.
+  size_t ProtectRtpBatch(rtc::ArrayView<SrtpBatchPacket> packets);
+  size_t UnprotectRtpBatch(rtc::ArrayView<SrtpBatchPacket> packets);
+
   // Helper method to get authentication params.
   bool GetRtpAuthParams(uint8_t** key, int* key_len, int* tag_len);
 
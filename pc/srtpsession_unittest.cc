@@ -11,6 +11,7 @@
 #include "pc/srtpsession.h"
 
 #include <string>
+#include <vector>
 
 #include "api/fakemetricsobserver.h"
 #include "media/base/fakertp.h"
@@ -18,6 +19,8 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/ptr_util.h"
 #include "rtc_base/sslstreamadapter.h"  // For rtc::SRTP_*
+#include "rtc_base/timeutils.h"
+#include "test/testsupport/perf_test.h"
 #include "third_party/libsrtp/include/srtp.h"
 
 namespace rtc {
@@ -242,4 +245,135 @@ TEST_F(SrtpSessionTest, TestReplay) {
       s1_.ProtectRtp(rtp_packet_, rtp_len_, sizeof(rtp_packet_), &out_len));
 }
 
+TEST_F(SrtpSessionTest, ProtectAndUnprotectRtpBatch) {
+  EXPECT_TRUE(s1_.SetSend(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+  EXPECT_TRUE(s2_.SetRecv(SRTP_AES128_CM_SHA1_80, kTestKey1, kTestKeyLen,
+                          kEncryptedHeaderExtensionIds));
+
+  constexpr size_t kBatchSize = 4;
+  char packets[kBatchSize][sizeof(kPcmuFrame) + 10];
+  cricket::SrtpBatchPacket batch[kBatchSize];
+  for (size_t i = 0; i < kBatchSize; ++i) {
+    memcpy(packets[i], kPcmuFrame, sizeof(kPcmuFrame));
+    SetBE16(reinterpret_cast<uint8_t*>(packets[i]) + 2,
+            static_cast<uint16_t>(i + 1));
+    batch[i].data = packets[i];
+    batch[i].length = sizeof(kPcmuFrame);
+    batch[i].capacity = sizeof(packets[i]);
+  }
+  // Leave no room for the auth tag of the last packet.
+  batch[kBatchSize - 1].capacity = sizeof(kPcmuFrame);
+
+  EXPECT_EQ(kBatchSize - 1, s1_.ProtectRtpBatch(batch));
+  for (size_t i = 0; i < kBatchSize - 1; ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)) +
+                  rtp_auth_tag_len(CS_AES_CM_128_HMAC_SHA1_80),
+              batch[i].length);
+  }
+  EXPECT_FALSE(batch[kBatchSize - 1].ok);
+
+  char replayed_packet[sizeof(packets[0])];
+  memcpy(replayed_packet, packets[0], batch[0].length);
+  cricket::SrtpBatchPacket replay = batch[0];
+  replay.data = replayed_packet;
+
+  rtc::ArrayView<cricket::SrtpBatchPacket> protected_batch(batch,
+                                                           kBatchSize - 1);
+  EXPECT_EQ(kBatchSize - 1, s2_.UnprotectRtpBatch(protected_batch));
+  for (size_t i = 0; i < kBatchSize - 1; ++i) {
+    EXPECT_TRUE(batch[i].ok);
+    EXPECT_EQ(static_cast<int>(sizeof(kPcmuFrame)), batch[i].length);
+    EXPECT_EQ(0, memcmp(packets[i] + 4, kPcmuFrame + 4,
+                        sizeof(kPcmuFrame) - 4));
+  }
+
+  // Replayed packets are rejected.
+  EXPECT_EQ(0u, s2_.UnprotectRtpBatch(
+                    rtc::ArrayView<cricket::SrtpBatchPacket>(&replay, 1)));
+  EXPECT_FALSE(replay.ok);
+}
+
+// Not a test, but a benchmark of single-core SRTP throughput for the
+// supported cipher suites, protecting and unprotecting MTU sized packets one
+// at a time and in batches.
+TEST_F(SrtpSessionTest, DISABLED_ProtectUnprotectThroughputByCipherSuite) {
+  struct CipherSuite {
+    int id;
+    const char* name;
+  };
+  const CipherSuite kCipherSuites[] = {
+      {SRTP_AES128_CM_SHA1_80, CS_AES_CM_128_HMAC_SHA1_80},
+      {SRTP_AEAD_AES_128_GCM, CS_AEAD_AES_128_GCM},
+      {SRTP_AEAD_AES_256_GCM, CS_AEAD_AES_256_GCM},
+  };
+  // Long enough for the largest key and salt, which AES-256-GCM uses.
+  const uint8_t kKey[] = "0123456789abcdef0123456789abcdef0123456789ab";
+  constexpr size_t kPayloadSize = 1200;
+  constexpr size_t kBatchSize = 32;
+  constexpr int kBatches = 2000;
+
+  for (const CipherSuite& cs : kCipherSuites) {
+    int key_len;
+    int salt_len;
+    ASSERT_TRUE(GetSrtpKeyAndSaltLengths(cs.id, &key_len, &salt_len));
+    for (bool batched : {false, true}) {
+      cricket::SrtpSession sender;
+      cricket::SrtpSession receiver;
+      ASSERT_TRUE(sender.SetSend(cs.id, kKey, key_len + salt_len,
+                                 kEncryptedHeaderExtensionIds));
+      ASSERT_TRUE(receiver.SetRecv(cs.id, kKey, key_len + salt_len,
+                                   kEncryptedHeaderExtensionIds));
+
+      std::vector<std::vector<uint8_t>> packets(
+          kBatchSize, std::vector<uint8_t>(kPayloadSize + 16));
+      std::vector<cricket::SrtpBatchPacket> batch(kBatchSize);
+      uint16_t seqnum = 0;
+      int64_t protect_ns = 0;
+      int64_t unprotect_ns = 0;
+      for (int n = 0; n < kBatches; ++n) {
+        for (size_t i = 0; i < kBatchSize; ++i) {
+          memcpy(packets[i].data(), kPcmuFrame, 12);
+          SetBE16(packets[i].data() + 2, ++seqnum);
+          batch[i].data = packets[i].data();
+          batch[i].length = kPayloadSize;
+          batch[i].capacity = static_cast<int>(packets[i].size());
+        }
+
+        int64_t start_ns = TimeNanos();
+        if (batched) {
+          ASSERT_EQ(kBatchSize, sender.ProtectRtpBatch(batch));
+        } else {
+          for (cricket::SrtpBatchPacket& packet : batch) {
+            ASSERT_TRUE(sender.ProtectRtp(packet.data, packet.length,
+                                          packet.capacity, &packet.length));
+          }
+        }
+        protect_ns += TimeNanos() - start_ns;
+
+        start_ns = TimeNanos();
+        if (batched) {
+          ASSERT_EQ(kBatchSize, receiver.UnprotectRtpBatch(batch));
+        } else {
+          for (cricket::SrtpBatchPacket& packet : batch) {
+            ASSERT_TRUE(receiver.UnprotectRtp(packet.data, packet.length,
+                                              &packet.length));
+          }
+        }
+        unprotect_ns += TimeNanos() - start_ns;
+      }
+
+      const double megabytes = kPayloadSize * kBatchSize * kBatches / 1e6;
+      webrtc::test::PrintResult("srtp_protect_throughput",
+                                batched ? "_batched" : "", cs.name,
+                                megabytes / (protect_ns / 1e9), "MBps", false);
+      webrtc::test::PrintResult("srtp_unprotect_throughput",
+                                batched ? "_batched" : "", cs.name,
+                                megabytes / (unprotect_ns / 1e9), "MBps",
+                                false);
+    }
+  }
+}
+
 }  // namespace rtc
@@ -167,6 +167,50 @@ bool SrtpTransport::SendRtpPacket(rtc::CopyOnWriteBuffer* packet,
   return SendPacket(/*rtcp=*/false, packet, updated_options, flags);
 }
 
+size_t SrtpTransport::SendRtpPackets(
+    rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+    rtc::ArrayView<const rtc::PacketOptions> options,
+    int flags) {
+  RTC_DCHECK_EQ(packets.size(), options.size());
+  if (!IsSrtpActive()) {
+    RTC_LOG(LS_ERROR)
+        << "Failed to send the packets because SRTP transport is inactive.";
+    return 0;
+  }
+
+  size_t sent = 0;
+  if (IsExternalAuthActive()) {
+    // The auth params have to be passed along with each packet.
+    for (size_t i = 0; i < packets.size(); ++i) {
+      if (SendRtpPacket(packets[i], options[i], flags))
+        ++sent;
+    }
+    return sent;
+  }
+
+  TRACE_EVENT0("webrtc", "SRTP Encode Batch");
+  RTC_CHECK(send_session_);
+  send_batch_.resize(packets.size());
+  for (size_t i = 0; i < packets.size(); ++i) {
+    send_batch_[i].data = packets[i]->data();
+    send_batch_[i].length = rtc::checked_cast<int>(packets[i]->size());
+    send_batch_[i].capacity = rtc::checked_cast<int>(packets[i]->capacity());
+  }
+  send_session_->ProtectRtpBatch(send_batch_);
+
+  send_packets_.clear();
+  for (size_t i = 0; i < packets.size(); ++i) {
+    if (!send_batch_[i].ok)
+      continue;
+    // Update the length of the packet now that we've added the auth tag.
+    packets[i]->SetSize(send_batch_[i].length);
+    send_packets_.emplace_back(packets[i]->data(), packets[i]->size(),
+                               rtc::SocketAddress(), options[i]);
+  }
+  // The transports below update their counters once for the whole batch.
+  return SendRtpPacketBatch(send_packets_.data(), send_packets_.size(), flags);
+}
+
 bool SrtpTransport::SendRtcpPacket(rtc::CopyOnWriteBuffer* packet,
                                    const rtc::PacketOptions& options,
                                    int flags) {
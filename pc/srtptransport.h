@@ -16,6 +16,7 @@
 #include <utility>
 #include <vector>
 
+#include "api/array_view.h"
 #include "api/ortc/srtptransportinterface.h"
 #include "p2p/base/dtlstransportinternal.h"
 #include "p2p/base/icetransportinternal.h"
@@ -47,6 +48,14 @@ class SrtpTransport : public RtpTransport {
                       const rtc::PacketOptions& options,
                       int flags) override;
 
+  // Protects a batch of RTP packets in one pass over the send session and
+  // sends them, |options[i]| applying to |packets[i]|. Falls back to
+  // SendRtpPacket() for each packet when external auth is active. Returns
+  // the number of packets sent.
+  size_t SendRtpPackets(rtc::ArrayView<rtc::CopyOnWriteBuffer* const> packets,
+                        rtc::ArrayView<const rtc::PacketOptions> options,
+                        int flags);
+
   // The transport becomes active if the send_session_ and recv_session_ are
   // created.
   bool IsSrtpActive() const override;
@@ -165,6 +174,10 @@ class SrtpTransport : public RtpTransport {
   int rtp_abs_sendtime_extn_id_ = -1;
 
   rtc::scoped_refptr<MetricsObserverInterface> metrics_observer_;
+
+  // Reused by SendRtpPackets() to avoid an allocation per batch.
+  std::vector<cricket::SrtpBatchPacket> send_batch_;
+  std::vector<rtc::OutgoingPacket> send_packets_;
 };
 
 }  // namespace webrtc
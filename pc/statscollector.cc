@@ -243,6 +243,14 @@ void ExtractStats(const cricket::VoiceSenderInfo& info, StatsReport* report) {
     report->AddFloat(StatsReport::kStatsValueNameAnaUplinkPacketLossFraction,
                      *info.ana_statistics.uplink_packet_loss_fraction);
   }
+  if (info.ana_statistics.complexity_action_counter) {
+    report->AddInt(StatsReport::kStatsValueNameAnaComplexityActionCounter,
+                   *info.ana_statistics.complexity_action_counter);
+  }
+  if (info.ana_statistics.complexity) {
+    report->AddInt(StatsReport::kStatsValueNameAnaComplexity,
+                   *info.ana_statistics.complexity);
+  }
 }
 
 void ExtractStats(const cricket::VideoReceiverInfo& info, StatsReport* report) {
@@ -436,9 +444,13 @@ const char* AdapterTypeToStatsType(rtc::AdapterType type) {
   }
 }
 
-StatsCollector::StatsCollector(PeerConnectionInternal* pc)
-    : pc_(pc), stats_gathering_started_(0) {
+StatsCollector::StatsCollector(PeerConnectionInternal* pc,
+                               int cache_lifetime_ms)
+    : pc_(pc),
+      cache_lifetime_ms_(cache_lifetime_ms),
+      stats_gathering_started_(0) {
   RTC_DCHECK(pc_);
+  RTC_DCHECK_GE(cache_lifetime_ms_, 0);
 }
 
 StatsCollector::~StatsCollector() {
@@ -553,11 +565,10 @@ void
 StatsCollector::UpdateStats(PeerConnectionInterface::StatsOutputLevel level) {
   RTC_DCHECK(pc_->signaling_thread()->IsCurrent());
   double time_now = GetTimeNow();
-  // Calls to UpdateStats() that occur less than kMinGatherStatsPeriod number of
-  // ms apart will be ignored.
-  const double kMinGatherStatsPeriod = 50;
+  // Calls to UpdateStats() that occur less than |cache_lifetime_ms_| apart
+  // will be ignored.
   if (stats_gathering_started_ != 0 &&
-      stats_gathering_started_ + kMinGatherStatsPeriod > time_now) {
+      stats_gathering_started_ + cache_lifetime_ms_ > time_now) {
     return;
   }
   stats_gathering_started_ = time_now;
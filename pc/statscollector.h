@@ -42,8 +42,10 @@ typedef std::map<std::string, StatsReport*> TrackIdMap;
 class StatsCollector {
  public:
   // The caller is responsible for ensuring that the pc outlives the
-  // StatsCollector instance.
-  explicit StatsCollector(PeerConnectionInternal* pc);
+  // StatsCollector instance. Calls to UpdateStats() within
+  // |cache_lifetime_ms| of the last update reuse its stats.
+  explicit StatsCollector(PeerConnectionInternal* pc,
+                          int cache_lifetime_ms = 50);
   virtual ~StatsCollector();
 
   // Adds a MediaStream with tracks that can be used as a |selector| in a call
@@ -83,8 +85,7 @@ class StatsCollector {
   bool IsValidTrack(const std::string& track_id);
 
   // Method used by the unittest to force a update of stats since UpdateStats()
-  // that occur less than kMinGatherStatsPeriod number of ms apart will be
-  // ignored.
+  // that occur less than |cache_lifetime_ms_| apart will be ignored.
   void ClearUpdateStatsCacheForTest();
 
  private:
@@ -140,6 +141,7 @@ class StatsCollector {
   TrackIdMap track_ids_;
   // Raw pointer to the peer connection the statistics are gathered from.
   PeerConnectionInternal* const pc_;
+  const double cache_lifetime_ms_;
   double stats_gathering_started_;
 
   // TODO(tommi): We appear to be holding on to raw pointers to reference
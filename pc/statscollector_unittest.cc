@@ -498,6 +498,18 @@ void VerifyVoiceSenderInfoReport(const StatsReport* report,
   EXPECT_EQ(
       rtc::ToString<float>(*sinfo.ana_statistics.uplink_packet_loss_fraction),
       value_in_report);
+  EXPECT_TRUE(GetValue(report,
+                       StatsReport::kStatsValueNameAnaComplexityActionCounter,
+                       &value_in_report));
+  ASSERT_TRUE(sinfo.ana_statistics.complexity_action_counter);
+  EXPECT_EQ(
+      rtc::ToString<uint32_t>(*sinfo.ana_statistics.complexity_action_counter),
+      value_in_report);
+  EXPECT_TRUE(GetValue(report, StatsReport::kStatsValueNameAnaComplexity,
+                       &value_in_report));
+  ASSERT_TRUE(sinfo.ana_statistics.complexity);
+  EXPECT_EQ(rtc::ToString<int>(*sinfo.ana_statistics.complexity),
+            value_in_report);
 }
 
 // Helper methods to avoid duplication of code.
@@ -524,6 +536,8 @@ void InitVoiceSenderInfo(cricket::VoiceSenderInfo* voice_sender_info) {
   voice_sender_info->ana_statistics.frame_length_increase_counter = 116;
   voice_sender_info->ana_statistics.frame_length_decrease_counter = 117;
   voice_sender_info->ana_statistics.uplink_packet_loss_fraction = 118.0;
+  voice_sender_info->ana_statistics.complexity_action_counter = 119;
+  voice_sender_info->ana_statistics.complexity = 5;
 }
 
 void UpdateVoiceSenderInfoFromAudioTrack(
@@ -563,6 +577,8 @@ class StatsCollectorForTest : public StatsCollector {
  public:
   explicit StatsCollectorForTest(PeerConnectionInternal* pc)
       : StatsCollector(pc), time_now_(19477) {}
+  StatsCollectorForTest(PeerConnectionInternal* pc, int cache_lifetime_ms)
+      : StatsCollector(pc, cache_lifetime_ms), time_now_(19477) {}
 
   double GetTimeNow() override {
     return time_now_;
@@ -805,6 +821,33 @@ TEST_F(StatsCollectorTest, FilterOutNegativeDataChannelId) {
                         &value_in_report));
 }
 
+// Verify that updates within the cache lifetime reuse the collected stats.
+TEST_F(StatsCollectorTest, UpdatesWithinCacheLifetimeAreCoalesced) {
+  auto pc = CreatePeerConnection();
+  auto stats = CreateStatsCollector(pc);
+
+  stats->UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  pc->AddSctpDataChannel("hacks");
+  stats->UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  StatsReports reports;
+  stats->GetStats(nullptr, &reports);
+  EXPECT_FALSE(
+      FindNthReportByType(reports, StatsReport::kStatsReportTypeDataChannel, 1));
+}
+
+TEST_F(StatsCollectorTest, ZeroCacheLifetimeCollectsOnEveryUpdate) {
+  auto pc = CreatePeerConnection();
+  auto stats = rtc::MakeUnique<StatsCollectorForTest>(pc, 0);
+
+  stats->UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  pc->AddSctpDataChannel("hacks");
+  stats->UpdateStats(PeerConnectionInterface::kStatsOutputLevelStandard);
+  StatsReports reports;
+  stats->GetStats(nullptr, &reports);
+  EXPECT_TRUE(
+      FindNthReportByType(reports, StatsReport::kStatsReportTypeDataChannel, 1));
+}
+
 // Verify that ExtractDataInfo populates reports.
 TEST_F(StatsCollectorTest, ExtractDataInfo) {
   const std::string kDataChannelLabel = "hacks";
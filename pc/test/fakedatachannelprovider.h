@@ -41,6 +41,7 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     }
 
     last_send_data_params_ = params;
+    last_send_data_ = payload;
     return true;
   }
 
@@ -125,6 +126,10 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
     return last_send_data_params_;
   }
 
+  const rtc::CopyOnWriteBuffer& last_send_data() const {
+    return last_send_data_;
+  }
+
   bool IsConnected(webrtc::DataChannel* data_channel) const {
     return connected_channels_.find(data_channel) != connected_channels_.end();
   }
@@ -139,6 +144,7 @@ class FakeDataChannelProvider : public webrtc::DataChannelProviderInterface {
 
  private:
   cricket::SendDataParams last_send_data_params_;
+  rtc::CopyOnWriteBuffer last_send_data_;
   bool send_blocked_;
   bool transport_available_;
   bool ready_to_send_;
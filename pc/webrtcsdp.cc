@@ -448,7 +448,8 @@ static bool GetLine(const std::string& message,
   if (line_end > 0 && (message.at(line_end - 1) == kReturn)) {
     --line_end;
   }
-  *line = message.substr(line_begin, (line_end - line_begin));
+  // Assign rather than substr, to reuse the capacity of |line| between lines.
+  line->assign(message, line_begin, line_end - line_begin);
   const char* cline = line->c_str();
   // RFC 4566
   // An SDP session description consists of a number of lines of text of
@@ -815,6 +816,14 @@ std::string SdpSerialize(const JsepSessionDescription& jdesc) {
   // Time Description.
   AddLine(kTimeDescription, &message);
 
+  // ICE-lite is a session-level attribute, though every transport has a copy.
+  if (!desc->transport_infos().empty() &&
+      desc->transport_infos()[0].description.ice_mode ==
+          cricket::ICEMODE_LITE) {
+    InitAttrLine(kAttributeIceLite, &os);
+    AddLine(os.str(), &message);
+  }
+
   // Group
   if (desc->HasGroup(cricket::GROUP_TYPE_BUNDLE)) {
     std::string group_line = kAttrGroup;
@@ -2377,13 +2386,12 @@ static C* ParseContentDescription(const std::string& message,
   for (int pt : payload_types) {
     payload_type_preferences[pt] = preference--;
   }
-  std::vector<typename C::CodecType> codecs = media_desc->codecs();
+  std::vector<typename C::CodecType>& codecs = media_desc->mutable_codecs();
   std::sort(codecs.begin(), codecs.end(), [&payload_type_preferences](
                                               const typename C::CodecType& a,
                                               const typename C::CodecType& b) {
     return payload_type_preferences[a.id] > payload_type_preferences[b.id];
   });
-  media_desc->set_codecs(codecs);
   return media_desc;
 }
 
@@ -2615,40 +2623,22 @@ void AddFeedbackParameters(const cricket::FeedbackParams& feedback_params,
   }
 }
 
-// Gets the current codec setting associated with |payload_type|. If there
-// is no Codec associated with that payload type it returns an empty codec
-// with that payload type.
-template <class T>
-T GetCodecWithPayloadType(const std::vector<T>& codecs, int payload_type) {
-  const T* codec = FindCodecById(codecs, payload_type);
-  if (codec)
-    return *codec;
-  // Return empty codec with |payload_type|.
-  T ret_val;
-  ret_val.id = payload_type;
-  return ret_val;
-}
-
-// Updates or creates a new codec entry in the audio description.
+// Returns the codec with |payload_type| in the codecs of |content_desc|,
+// adding an empty codec with that payload type if there is none. The codec is
+// updated in place, since copying the codec list for every attribute line
+// makes parsing quadratic in the number of attributes.
 template <class T, class U>
-void AddOrReplaceCodec(MediaContentDescription* content_desc, const U& codec) {
-  T* desc = static_cast<T*>(content_desc);
-  std::vector<U> codecs = desc->codecs();
-  bool found = false;
-
-  typename std::vector<U>::iterator iter;
-  for (iter = codecs.begin(); iter != codecs.end(); ++iter) {
-    if (iter->id == codec.id) {
-      *iter = codec;
-      found = true;
-      break;
+U* FindOrAddCodec(MediaContentDescription* content_desc, int payload_type) {
+  std::vector<U>& codecs = static_cast<T*>(content_desc)->mutable_codecs();
+  for (U& codec : codecs) {
+    if (codec.id == payload_type) {
+      return &codec;
     }
   }
-  if (!found) {
-    desc->AddCodec(codec);
-    return;
-  }
-  desc->set_codecs(codecs);
+  U codec;
+  codec.id = payload_type;
+  codecs.push_back(codec);
+  return &codecs.back();
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -2657,10 +2647,7 @@ template <class T, class U>
 void UpdateCodec(MediaContentDescription* content_desc, int payload_type,
                  const cricket::CodecParameterMap& parameters) {
   // Codec might already have been populated (from rtpmap).
-  U new_codec = GetCodecWithPayloadType(static_cast<T*>(content_desc)->codecs(),
-                                        payload_type);
-  AddParameters(parameters, &new_codec);
-  AddOrReplaceCodec<T, U>(content_desc, new_codec);
+  AddParameters(parameters, FindOrAddCodec<T, U>(content_desc, payload_type));
 }
 
 // Adds or updates existing codec corresponding to |payload_type| according
@@ -2669,10 +2656,8 @@ template <class T, class U>
 void UpdateCodec(MediaContentDescription* content_desc, int payload_type,
                  const cricket::FeedbackParam& feedback_param) {
   // Codec might already have been populated (from rtpmap).
-  U new_codec = GetCodecWithPayloadType(static_cast<T*>(content_desc)->codecs(),
-                                        payload_type);
-  AddFeedbackParameter(feedback_param, &new_codec);
-  AddOrReplaceCodec<T, U>(content_desc, new_codec);
+  AddFeedbackParameter(feedback_param,
+                       FindOrAddCodec<T, U>(content_desc, payload_type));
 }
 
 template <class T>
@@ -3182,14 +3167,13 @@ void UpdateCodec(int payload_type,
                  AudioContentDescription* audio_desc) {
   // Codec may already be populated with (only) optional parameters
   // (from an fmtp).
-  cricket::AudioCodec codec =
-      GetCodecWithPayloadType(audio_desc->codecs(), payload_type);
-  codec.name = name;
-  codec.clockrate = clockrate;
-  codec.bitrate = bitrate;
-  codec.channels = channels;
-  AddOrReplaceCodec<AudioContentDescription, cricket::AudioCodec>(audio_desc,
-                                                                  codec);
+  cricket::AudioCodec* codec =
+      FindOrAddCodec<AudioContentDescription, cricket::AudioCodec>(
+          audio_desc, payload_type);
+  codec->name = name;
+  codec->clockrate = clockrate;
+  codec->bitrate = bitrate;
+  codec->channels = channels;
 }
 
 // Updates or creates a new codec entry in the video description according to
@@ -3199,11 +3183,9 @@ void UpdateCodec(int payload_type,
                  VideoContentDescription* video_desc) {
   // Codec may already be populated with (only) optional parameters
   // (from an fmtp).
-  cricket::VideoCodec codec =
-      GetCodecWithPayloadType(video_desc->codecs(), payload_type);
-  codec.name = name;
-  AddOrReplaceCodec<VideoContentDescription, cricket::VideoCodec>(video_desc,
-                                                                  codec);
+  FindOrAddCodec<VideoContentDescription, cricket::VideoCodec>(video_desc,
+                                                               payload_type)
+      ->name = name;
 }
 
 bool ParseRtpmapAttribute(const std::string& line,
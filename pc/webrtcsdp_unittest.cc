@@ -3222,6 +3222,14 @@ TEST_F(WebRtcSdpTest, DeserializeSdpWithIceLite) {
   EXPECT_EQ(cricket::ICEMODE_LITE, vtinfo->description.ice_mode);
 }
 
+TEST_F(WebRtcSdpTest, SerializeSdpWithIceLite) {
+  JsepSessionDescription jdesc_with_icelite(kDummyType);
+  std::string sdp_with_icelite = kSdpFullString;
+  InjectAfter(kSessionTime, "a=ice-lite\r\n", &sdp_with_icelite);
+  ASSERT_TRUE(SdpDeserialize(sdp_with_icelite, &jdesc_with_icelite));
+  EXPECT_EQ(sdp_with_icelite, webrtc::SdpSerialize(jdesc_with_icelite));
+}
+
 // Verifies that the candidates in the input SDP are parsed and serialized
 // correctly in the output SDP.
 TEST_F(WebRtcSdpTest, RoundTripSdpWithSctpDataChannelsWithCandidates) {
@@ -24,10 +24,34 @@ PacketOptions::PacketOptions(DiffServCodePoint dscp) : dscp(dscp) {}
 PacketOptions::PacketOptions(const PacketOptions& other) = default;
 PacketOptions::~PacketOptions() = default;
 
+OutgoingPacket::OutgoingPacket() = default;
+OutgoingPacket::OutgoingPacket(const void* data,
+                               size_t size,
+                               const SocketAddress& addr,
+                               const PacketOptions& options)
+    : data(data), size(size), addr(addr), options(options) {}
+OutgoingPacket::OutgoingPacket(const OutgoingPacket& other) = default;
+OutgoingPacket::~OutgoingPacket() = default;
+
 AsyncPacketSocket::AsyncPacketSocket() = default;
 
 AsyncPacketSocket::~AsyncPacketSocket() = default;
 
+int AsyncPacketSocket::SendToBatch(const OutgoingPacket* packets,
+                                   size_t count) {
+  size_t sent = 0;
+  int last_result = 0;
+  for (; sent < count; ++sent) {
+    const OutgoingPacket& packet = packets[sent];
+    last_result = SendTo(packet.data, packet.size, packet.addr, packet.options);
+    if (last_result < 0)
+      break;
+  }
+  if (sent == 0 && count > 0)
+    return last_result;
+  return static_cast<int>(sent);
+}
+
 void CopySocketInformationToPacketInfo(size_t packet_size_bytes,
                                        const AsyncPacketSocket& socket_from,
                                        bool is_connectionless,
@@ -70,6 +70,22 @@ inline PacketTime CreatePacketTime(int64_t not_before) {
   return PacketTime(TimeMicros(), not_before);
 }
 
+// One packet of a batched send, see AsyncPacketSocket::SendToBatch().
+struct OutgoingPacket {
+  OutgoingPacket();
+  OutgoingPacket(const void* data,
+                 size_t size,
+                 const SocketAddress& addr,
+                 const PacketOptions& options);
+  OutgoingPacket(const OutgoingPacket& other);
+  ~OutgoingPacket();
+
+  const void* data = nullptr;
+  size_t size = 0;
+  SocketAddress addr;
+  PacketOptions options;
+};
+
 // Provides the ability to receive packets asynchronously. Sends are not
 // buffered since it is acceptable to drop packets under high load.
 class AsyncPacketSocket : public sigslot::has_slots<> {
@@ -96,6 +112,13 @@ class AsyncPacketSocket : public sigslot::has_slots<> {
   virtual int Send(const void *pv, size_t cb, const PacketOptions& options) = 0;
   virtual int SendTo(const void *pv, size_t cb, const SocketAddress& addr,
                      const PacketOptions& options) = 0;
+  // Sends |count| packets, possibly with a single system call. Returns the
+  // number of packets sent, which may be fewer than |count| if the socket
+  // would block, or a negative value if none could be sent. Options must be
+  // honored as by SendTo(); implementations that batch only some of them send
+  // the remaining packets with SendTo(). The default implementation calls
+  // SendTo() for each packet.
+  virtual int SendToBatch(const OutgoingPacket* packets, size_t count);
 
   // Close the socket.
   virtual int Close() = 0;
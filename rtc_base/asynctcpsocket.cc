@@ -15,6 +15,7 @@
 #include <algorithm>
 #include <memory>
 
+#include "rtc_base/arraysize.h"
 #include "rtc_base/byteorder.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
@@ -177,6 +178,29 @@ void AsyncTCPSocketBase::AppendToOutBuffer(const void* pv, size_t cb) {
   outbuf_.AppendData(static_cast<const uint8_t*>(pv), cb);
 }
 
+int AsyncTCPSocketBase::SendBuffers(const OutgoingBuffer* buffers,
+                                    size_t count) {
+  RTC_DCHECK(!listen_);
+  RTC_DCHECK(IsOutBufferEmpty());
+  int res = socket_->SendGathered(buffers, count);
+  if (res <= 0) {
+    return res;
+  }
+  size_t skip = static_cast<size_t>(res);
+  for (size_t i = 0; i < count; ++i) {
+    const OutgoingBuffer& buffer = buffers[i];
+    if (skip >= buffer.length) {
+      skip -= buffer.length;
+      continue;
+    }
+    AppendToOutBuffer(static_cast<const uint8_t*>(buffer.data) + skip,
+                      buffer.length - skip);
+    skip = 0;
+  }
+  RTC_DCHECK_EQ(0, skip);
+  return res;
+}
+
 void AsyncTCPSocketBase::OnConnectEvent(AsyncSocket* socket) {
   SignalConnect(this);
 }
@@ -195,6 +219,16 @@ void AsyncTCPSocketBase::OnReadEvent(AsyncSocket* socket) {
       return;
     }
 
+    // Accepted connections get the same latency related options as the
+    // listening socket.
+    for (Socket::Option opt : {Socket::OPT_NODELAY,
+                               Socket::OPT_NOTSENT_LOWAT}) {
+      int value;
+      if (socket_->GetOption(opt, &value) == 0 && value > 0) {
+        new_socket->SetOption(opt, value);
+      }
+    }
+
     HandleIncomingConnection(new_socket);
 
     // Prime a read event in case data is waiting.
@@ -286,14 +320,17 @@ int AsyncTCPSocket::Send(const void *pv, size_t cb,
   if (!IsOutBufferEmpty())
     return static_cast<int>(cb);
 
-  PacketLength pkt_len = HostToNetwork16(static_cast<PacketLength>(cb));
-  AppendToOutBuffer(&pkt_len, kPacketLenSize);
-  AppendToOutBuffer(pv, cb);
+  uint8_t pkt_len[kPacketLenSize];
+  SetBE16(pkt_len, static_cast<PacketLength>(cb));
+  OutgoingBuffer buffers[2];
+  buffers[0].data = pkt_len;
+  buffers[0].length = kPacketLenSize;
+  buffers[1].data = pv;
+  buffers[1].length = cb;
 
-  int res = FlushOutBuffer();
+  int res = SendBuffers(buffers, arraysize(buffers));
   if (res <= 0) {
     // drop packet if we made no progress
-    ClearOutBuffer();
     return res;
   }
 
@@ -309,21 +346,22 @@ int AsyncTCPSocket::Send(const void *pv, size_t cb,
 void AsyncTCPSocket::ProcessInput(char * data, size_t* len) {
   SocketAddress remote_addr(GetRemoteAddress());
 
-  while (true) {
-    if (*len < kPacketLenSize)
-      return;
-
-    PacketLength pkt_len = rtc::GetBE16(data);
-    if (*len < kPacketLenSize + pkt_len)
-      return;
+  // Deliver every complete packet in place and move the incomplete rest to the
+  // front of the buffer only once, instead of after every packet.
+  size_t pos = 0;
+  while (*len - pos >= kPacketLenSize) {
+    PacketLength pkt_len = rtc::GetBE16(data + pos);
+    if (*len - pos < kPacketLenSize + pkt_len)
+      break;
 
-    SignalReadPacket(this, data + kPacketLenSize, pkt_len, remote_addr,
+    SignalReadPacket(this, data + pos + kPacketLenSize, pkt_len, remote_addr,
                      CreatePacketTime(0));
+    pos += kPacketLenSize + pkt_len;
+  }
 
-    *len -= kPacketLenSize + pkt_len;
-    if (*len > 0) {
-      memmove(data, data + kPacketLenSize + pkt_len, *len);
-    }
+  *len -= pos;
+  if (pos > 0 && *len > 0) {
+    memmove(data, data + pos, *len);
   }
 }
 
@@ -60,6 +60,13 @@ class AsyncTCPSocketBase : public AsyncPacketSocket {
   int FlushOutBuffer();
   // Add data to |outbuf_|.
   void AppendToOutBuffer(const void* pv, size_t cb);
+  // Sends the concatenation of |buffers| with a single gathered write, so
+  // that a packet and its framing don't have to be copied into |outbuf_|
+  // first. The part the socket doesn't accept is appended to |outbuf_| and
+  // sent by later flushes. Must only be called while |outbuf_| is empty.
+  // Returns the number of bytes written to the socket; if that is not
+  // positive, nothing was buffered.
+  int SendBuffers(const OutgoingBuffer* buffers, size_t count);
 
   // Helper methods for |outpos_|.
   bool IsOutBufferEmpty() const { return outbuf_.size() == 0; }
@@ -10,7 +10,9 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "rtc_base/arraysize.h"
 #include "rtc_base/asynctcpsocket.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/virtualsocketserver.h"
@@ -23,7 +25,7 @@ class AsyncTCPSocketTest
  public:
   AsyncTCPSocketTest()
       : vss_(new rtc::VirtualSocketServer()),
-        socket_(vss_->CreateAsyncSocket(SOCK_STREAM)),
+        socket_(vss_->CreateAsyncSocket(AF_INET, SOCK_STREAM)),
         tcp_socket_(new AsyncTCPSocket(socket_, true)),
         ready_to_send_(false) {
     tcp_socket_->SignalReadyToSend.connect(this,
@@ -34,11 +36,40 @@ class AsyncTCPSocketTest
     ready_to_send_ = true;
   }
 
+  std::unique_ptr<AsyncTCPSocket> CreateServer(const SocketAddress& address) {
+    AsyncSocket* socket = vss_->CreateAsyncSocket(AF_INET, SOCK_STREAM);
+    if (socket->Bind(address) != 0) {
+      delete socket;
+      return nullptr;
+    }
+    std::unique_ptr<AsyncTCPSocket> server(new AsyncTCPSocket(socket, true));
+    server->SignalNewConnection.connect(this,
+                                        &AsyncTCPSocketTest::OnNewConnection);
+    return server;
+  }
+
+  void OnNewConnection(AsyncPacketSocket* socket,
+                       AsyncPacketSocket* new_socket) {
+    accepted_socket_.reset(new_socket);
+    new_socket->SignalReadPacket.connect(this,
+                                         &AsyncTCPSocketTest::OnReadPacket);
+  }
+
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time) {
+    received_.push_back(std::string(data, size));
+  }
+
  protected:
   std::unique_ptr<VirtualSocketServer> vss_;
   AsyncSocket* socket_;
   std::unique_ptr<AsyncTCPSocket> tcp_socket_;
   bool ready_to_send_;
+  std::unique_ptr<AsyncPacketSocket> accepted_socket_;
+  std::vector<std::string> received_;
 };
 
 TEST_F(AsyncTCPSocketTest, OnWriteEvent) {
@@ -47,4 +78,29 @@ TEST_F(AsyncTCPSocketTest, OnWriteEvent) {
   EXPECT_TRUE(ready_to_send_);
 }
 
+TEST_F(AsyncTCPSocketTest, DeliversBackToBackPacketsInOrder) {
+  AutoSocketServerThread thread(vss_.get());
+  std::unique_ptr<AsyncTCPSocket> server =
+      CreateServer(SocketAddress("127.0.0.1", 0));
+  ASSERT_TRUE(server);
+  std::unique_ptr<AsyncTCPSocket> client(AsyncTCPSocket::Create(
+      vss_->CreateAsyncSocket(AF_INET, SOCK_STREAM),
+      SocketAddress("127.0.0.1", 0), server->GetLocalAddress()));
+  ASSERT_TRUE(client);
+  ASSERT_TRUE_WAIT(client->GetState() == AsyncPacketSocket::STATE_CONNECTED,
+                   1000);
+
+  // Several packets end up in one read, and have to be framed out of the
+  // input buffer one after the other.
+  const std::string kPackets[] = {"a", "", std::string(1000, 'b'), "cc"};
+  for (const std::string& packet : kPackets) {
+    EXPECT_EQ(static_cast<int>(packet.size()),
+              client->Send(packet.data(), packet.size(), PacketOptions()));
+  }
+  EXPECT_EQ_WAIT(arraysize(kPackets), received_.size(), 1000);
+  for (size_t i = 0; i < received_.size(); ++i) {
+    EXPECT_EQ(kPackets[i], received_[i]);
+  }
+}
+
 }  // namespace rtc
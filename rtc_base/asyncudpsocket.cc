@@ -9,6 +9,12 @@
  */
 
 #include "rtc_base/asyncudpsocket.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 
@@ -16,6 +22,15 @@ namespace rtc {
 
 static const int BUF_SIZE = 64 * 1024;
 
+// Whether a batched send handles everything in |options|. The batched system
+// calls only carry the payload, so a DSCP or send time update makes a packet
+// go through SendTo().
+static bool CanSendInBatch(const PacketOptions& options) {
+  return options.dscp == DSCP_NO_CHANGE &&
+         options.packet_time_params.rtp_sendtime_extension_id == -1 &&
+         options.packet_time_params.srtp_auth_key.empty();
+}
+
 AsyncUDPSocket* AsyncUDPSocket::Create(
     AsyncSocket* socket,
     const SocketAddress& bind_address) {
@@ -80,6 +95,57 @@ int AsyncUDPSocket::SendTo(const void *pv, size_t cb,
   return ret;
 }
 
+int AsyncUDPSocket::SendToBatch(const OutgoingPacket* packets, size_t count) {
+  size_t sent = 0;
+  int last_result = 0;
+  while (sent < count) {
+    size_t end = sent;
+    while (end < count && CanSendInBatch(packets[end].options))
+      ++end;
+    if (end == sent) {
+      const OutgoingPacket& packet = packets[sent];
+      last_result =
+          SendTo(packet.data, packet.size, packet.addr, packet.options);
+      if (last_result < 0)
+        break;
+      ++sent;
+      continue;
+    }
+    last_result = SendDatagramBatch(packets + sent, end - sent);
+    if (last_result < 0)
+      break;
+    sent += last_result;
+    // The socket stopped accepting data part way through.
+    if (sent < end)
+      break;
+  }
+  if (sent == 0 && count > 0)
+    return last_result;
+  return static_cast<int>(sent);
+}
+
+int AsyncUDPSocket::SendDatagramBatch(const OutgoingPacket* packets,
+                                      size_t count) {
+  send_batch_datagrams_.resize(count);
+  for (size_t i = 0; i < count; ++i) {
+    send_batch_datagrams_[i].data = packets[i].data;
+    send_batch_datagrams_[i].length = packets[i].size;
+    send_batch_datagrams_[i].destination = packets[i].addr;
+  }
+  int sent = socket_->SendToBatch(send_batch_datagrams_.data(), count);
+  int64_t send_time_ms = rtc::TimeMillis();
+  for (int i = 0; i < sent; ++i) {
+    const OutgoingPacket& packet = packets[i];
+    rtc::SentPacket sent_packet(packet.options.packet_id, send_time_ms,
+                                packet.options.info_signaled_after_sent);
+    CopySocketInformationToPacketInfo(packet.size, *this, true,
+                                      &sent_packet.info);
+    sent_packet.info.remote_socket_address = packet.addr;
+    SignalSentPacket(this, sent_packet);
+  }
+  return sent;
+}
+
 int AsyncUDPSocket::Close() {
   return socket_->Close();
 }
@@ -104,24 +170,44 @@ void AsyncUDPSocket::SetError(int error) {
   return socket_->SetError(error);
 }
 
+void AsyncUDPSocket::SetRecvBatchSize(size_t max_batch_size) {
+  recv_batch_size_ = std::max<size_t>(
+      1, std::min(max_batch_size, Socket::kMaxRecvBatchSize));
+  if (recv_batch_size_ == 1) {
+    batch_buf_.reset();
+    batch_datagrams_.clear();
+    return;
+  }
+  batch_buf_.reset(new char[recv_batch_size_ * BUF_SIZE]);
+  batch_datagrams_.resize(recv_batch_size_);
+  for (size_t i = 0; i < recv_batch_size_; ++i) {
+    batch_datagrams_[i].buffer = &batch_buf_[i * BUF_SIZE];
+    batch_datagrams_[i].buffer_size = BUF_SIZE;
+  }
+}
+
 void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
   RTC_DCHECK(socket_.get() == socket);
 
+  if (recv_batch_size_ > 1) {
+    ReadBatch();
+    return;
+  }
+  if (pool_) {
+    ReadIntoPooledBuffer();
+    return;
+  }
+
   SocketAddress remote_addr;
   int64_t timestamp;
   int len = socket_->RecvFrom(buf_, size_, &remote_addr, &timestamp);
   if (len < 0) {
-    // An error here typically means we got an ICMP error in response to our
-    // send datagram, indicating the remote address was unreachable.
-    // When doing ICE, this kind of thing will often happen.
-    // TODO: Do something better like forwarding the error to the user.
-    SocketAddress local_addr = socket_->GetLocalAddress();
-    RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
-                     << "] receive failed with error "
-                     << socket_->GetError();
+    LogReceiveError();
     return;
   }
 
+  ++recv_batch_stats_.read_events;
+  ++recv_batch_stats_.packets_received;
   // TODO: Make sure that we got all of the packet.
   // If we did not, then we should resize our buffer to be large enough.
   SignalReadPacket(
@@ -129,6 +215,93 @@ void AsyncUDPSocket::OnReadEvent(AsyncSocket* socket) {
       (timestamp > -1 ? PacketTime(timestamp, 0) : CreatePacketTime(0)));
 }
 
+void AsyncUDPSocket::ReadBatch() {
+  int count =
+      socket_->RecvFromBatch(batch_datagrams_.data(), batch_datagrams_.size());
+  if (count < 0) {
+    // A read event can race with a batch that already drained the socket.
+    if (!socket_->IsBlocking())
+      LogReceiveError();
+    return;
+  }
+  if (count == 0)
+    return;
+
+  ++recv_batch_stats_.read_events;
+  recv_batch_stats_.packets_received += count;
+  // All datagrams of a batch were read together, so they share one receive
+  // time when the socket cannot report a per-datagram timestamp.
+  PacketTime batch_time = CreatePacketTime(0);
+  for (int i = 0; i < count; ++i) {
+    const ReceivedDatagram& datagram = batch_datagrams_[i];
+    if (datagram.truncated) {
+      RTC_LOG(LS_WARNING) << "AsyncUDPSocket["
+                          << socket_->GetLocalAddress().ToSensitiveString()
+                          << "] dropping datagram larger than " << BUF_SIZE
+                          << " bytes.";
+      continue;
+    }
+    SignalReadPacket(this, static_cast<const char*>(datagram.buffer),
+                     datagram.length, datagram.source,
+                     (datagram.timestamp > -1
+                          ? PacketTime(datagram.timestamp, 0)
+                          : batch_time));
+  }
+}
+
+void AsyncUDPSocket::ReadIntoPooledBuffer() {
+  CopyOnWriteBuffer packet = pool_->GetBuffer();
+  packet.SetSize(packet.capacity());
+  // Anything that doesn't fit in the pooled buffer goes on into |buf_|, so
+  // that datagrams of any size are still received.
+  ReceivedDatagram datagram;
+  datagram.buffer = packet.data();
+  datagram.buffer_size = packet.size();
+  datagram.overflow_buffer = buf_;
+  datagram.overflow_buffer_size = size_;
+  int count = socket_->RecvFromBatch(&datagram, 1);
+  if (count < 0) {
+    LogReceiveError();
+    return;
+  }
+  if (count == 0)
+    return;
+
+  ++recv_batch_stats_.read_events;
+  ++recv_batch_stats_.packets_received;
+  if (datagram.truncated) {
+    RTC_LOG(LS_WARNING) << "AsyncUDPSocket["
+                        << socket_->GetLocalAddress().ToSensitiveString()
+                        << "] dropping datagram larger than "
+                        << packet.size() + size_ << " bytes.";
+    return;
+  }
+  if (datagram.length > packet.size()) {
+    // Rare enough that reassembling it in a buffer of its own is fine.
+    CopyOnWriteBuffer large_packet(datagram.length);
+    memcpy(large_packet.data(), packet.cdata(), packet.size());
+    memcpy(large_packet.data() + packet.size(), buf_,
+           datagram.length - packet.size());
+    packet = std::move(large_packet);
+  } else {
+    packet.SetSize(datagram.length);
+  }
+  ReceiveBufferPool::ScopedLend lend(&packet);
+  SignalReadPacket(this, packet.cdata<char>(), packet.size(), datagram.source,
+                   (datagram.timestamp > -1 ? PacketTime(datagram.timestamp, 0)
+                                            : CreatePacketTime(0)));
+}
+
+void AsyncUDPSocket::LogReceiveError() {
+  // An error here typically means we got an ICMP error in response to our
+  // send datagram, indicating the remote address was unreachable.
+  // When doing ICE, this kind of thing will often happen.
+  // TODO: Do something better like forwarding the error to the user.
+  SocketAddress local_addr = socket_->GetLocalAddress();
+  RTC_LOG(LS_INFO) << "AsyncUDPSocket[" << local_addr.ToSensitiveString()
+                   << "] receive failed with error " << socket_->GetError();
+}
+
 void AsyncUDPSocket::OnWriteEvent(AsyncSocket* socket) {
   SignalReadyToSend(this);
 }
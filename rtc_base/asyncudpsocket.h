@@ -12,8 +12,10 @@
 #define RTC_BASE_ASYNCUDPSOCKET_H_
 
 #include <memory>
+#include <vector>
 
 #include "rtc_base/asyncpacketsocket.h"
+#include "rtc_base/receivebufferpool.h"
 #include "rtc_base/socketfactory.h"
 
 namespace rtc {
@@ -43,6 +45,9 @@ class AsyncUDPSocket : public AsyncPacketSocket {
              size_t cb,
              const SocketAddress& addr,
              const rtc::PacketOptions& options) override;
+  // Packets with a DSCP or |packet_time_params| in their options are sent
+  // with SendTo(); runs of the other packets are batched.
+  int SendToBatch(const OutgoingPacket* packets, size_t count) override;
   int Close() override;
 
   State GetState() const override;
@@ -51,15 +56,59 @@ class AsyncUDPSocket : public AsyncPacketSocket {
   int GetError() const override;
   void SetError(int error) override;
 
+  // Counters describing how well reads are being batched.
+  struct RecvBatchStats {
+    // Number of read events that delivered at least one packet.
+    int64_t read_events = 0;
+    int64_t packets_received = 0;
+
+    double AveragePacketsPerRead() const {
+      return read_events == 0
+                 ? 0.0
+                 : static_cast<double>(packets_received) / read_events;
+    }
+  };
+
+  // Drains up to |max_batch_size| datagrams, at most
+  // Socket::kMaxRecvBatchSize, per read event using Socket::RecvFromBatch(),
+  // firing SignalReadPacket for each of them before returning to the event
+  // loop. Each datagram gets a 64 kB slot, like the single read path, so
+  // batching does not limit the datagram size. A value of 1 (the default)
+  // restores one datagram per read event.
+  void SetRecvBatchSize(size_t max_batch_size);
+  RecvBatchStats GetRecvBatchStats() const { return recv_batch_stats_; }
+
+  // Receives each datagram directly into a buffer from |pool| and lends it
+  // out while SignalReadPacket is fired, so that receivers can take it with
+  // ReceiveBufferPool::TakeOrCopy() instead of copying. Datagrams larger than
+  // the pool's buffers are still received, into a buffer of their own. Only
+  // used while the receive batch size is 1. Passing null (the default)
+  // disables pooling. |pool| must outlive this socket.
+  void SetReceiveBufferPool(ReceiveBufferPool* pool) { pool_ = pool; }
+
  private:
   // Called when the underlying socket is ready to be read from.
   void OnReadEvent(AsyncSocket* socket);
+  void ReadBatch();
+  void ReadIntoPooledBuffer();
   // Called when the underlying socket is ready to send.
   void OnWriteEvent(AsyncSocket* socket);
 
+  void LogReceiveError();
+  // Sends |count| packets with Socket::SendToBatch(). Same return value.
+  int SendDatagramBatch(const OutgoingPacket* packets, size_t count);
+
   std::unique_ptr<AsyncSocket> socket_;
   char* buf_;
   size_t size_;
+  ReceiveBufferPool* pool_ = nullptr;
+  size_t recv_batch_size_ = 1;
+  // Left uninitialized, so that the pages of slots that are never filled
+  // are not committed.
+  std::unique_ptr<char[]> batch_buf_;
+  std::vector<ReceivedDatagram> batch_datagrams_;
+  RecvBatchStats recv_batch_stats_;
+  std::vector<OutgoingDatagram> send_batch_datagrams_;
 };
 
 }  // namespace rtc
@@ -22,6 +22,9 @@
 
 namespace rtc {
 
+class PacketBufferAllocator;
+class ReceiveBufferPool;
+
 class CopyOnWriteBuffer {
  public:
   // An empty buffer.
@@ -224,6 +227,15 @@ class CopyOnWriteBuffer {
   }
 
  private:
+  friend class PacketBufferAllocator;
+  friend class ReceiveBufferPool;
+
+  // Wraps an existing, ref counted buffer, e.g. one recycled by a pool.
+  explicit CopyOnWriteBuffer(scoped_refptr<RefCountedObject<Buffer>> buffer)
+      : buffer_(std::move(buffer)) {
+    RTC_DCHECK(IsConsistent());
+  }
+
   // Create a copy of the underlying data if it is referenced from other Buffer
   // objects.
   void CloneDataIfReferenced(size_t new_capacity);
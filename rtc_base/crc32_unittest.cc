@@ -32,4 +32,24 @@ TEST(Crc32Test, TestMultipleUpdates) {
   EXPECT_EQ(0x171A3F5FU, c);
 }
 
+// Checks the eight bytes at a time path against a bytewise reference, at
+// every length and alignment around its step.
+TEST(Crc32Test, MatchesBytewiseCrc) {
+  uint8_t buffer[80];
+  for (size_t i = 0; i < sizeof(buffer); ++i)
+    buffer[i] = static_cast<uint8_t>(i * 37 + 11);
+  for (size_t offset = 0; offset < 8; ++offset) {
+    for (size_t len = 0; len + offset <= sizeof(buffer); ++len) {
+      uint32_t c = 0xFFFFFFFF;
+      for (size_t i = offset; i < offset + len; ++i) {
+        c ^= buffer[i];
+        for (int bit = 0; bit < 8; ++bit)
+          c = (c >> 1) ^ (0xEDB88320 & (0 - (c & 1)));
+      }
+      EXPECT_EQ(c ^ 0xFFFFFFFF, ComputeCrc32(buffer + offset, len))
+          << "offset " << offset << " length " << len;
+    }
+  }
+}
+
 }  // namespace rtc
@@ -13,6 +13,7 @@
 #if defined(WEBRTC_WIN)
 #include <windows.h>
 #elif defined(WEBRTC_POSIX)
+#include <errno.h>
 #include <pthread.h>
 #include <sys/time.h>
 #include <time.h>
@@ -104,7 +105,7 @@ bool Event::Wait(int milliseconds) {
   int error = 0;
 
   struct timespec ts;
-  if (milliseconds != kForever) {
+  if (milliseconds != kForever && milliseconds != 0) {
 #if USE_CLOCK_GETTIME
     clock_gettime(CLOCK_MONOTONIC, &ts);
 #else
@@ -125,7 +126,12 @@ bool Event::Wait(int milliseconds) {
   }
 
   pthread_mutex_lock(&event_mutex_);
-  if (milliseconds != kForever) {
+  if (milliseconds == 0) {
+    // Polling. A timed wait for a deadline that has passed would still sleep
+    // for the timer slack of the thread.
+    if (!event_status_)
+      error = ETIMEDOUT;
+  } else if (milliseconds != kForever) {
     while (!event_status_ && error == 0) {
 #if USE_PTHREAD_COND_TIMEDWAIT_MONOTONIC_NP
       error =
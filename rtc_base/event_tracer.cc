@@ -11,7 +11,18 @@
 
 #include <inttypes.h>
 
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "rtc_base/atomicops.h"
@@ -27,6 +38,12 @@
 // This is a guesstimate that should be enough in most cases.
 static const size_t kEventLoggerArgsStrBufferInitialSize = 256;
 static const size_t kTraceArgBufferLength = 32;
+// Number of events that the recording keeps per thread. Must be a power of
+// two.
+static const size_t kRecordedEventsPerThread = 2048;
+// Up to this many threads get a recording buffer of their own. After that,
+// the buffers of the threads that have exited are reused.
+static const size_t kMaxUnsharedRecordingBuffers = 32;
 
 namespace webrtc {
 
@@ -85,6 +102,181 @@ static void EventTracingThreadFunc(void* params);
 
 // Atomic-int fast path for avoiding logging when disabled.
 static volatile int g_event_logging_active = 0;
+// Same for the recording.
+static volatile int g_event_recording_active = 0;
+
+// What InternalGetCategoryEnabled returns a pointer to, for the categories
+// that are enabled. The trace macros only look at the first byte, so
+// |enabled| must come first; the internal tracer converts the pointers back
+// to get the name and sampling of the category.
+struct TraceCategory {
+  explicit TraceCategory(const char* name)
+      : enabled(1), one_in_n(1), name(new char[strlen(name) + 1]) {
+    strcpy(this->name, name);  // NOLINT(runtime/printf)
+  }
+
+  const unsigned char enabled;
+  // Only one in |one_in_n| of the events of the category are recorded, and
+  // none if it is 0.
+  std::atomic<int> one_in_n;
+  char* const name;
+};
+static_assert(std::is_standard_layout<TraceCategory>::value,
+              "TraceCategory must be standard layout to be converted from "
+              "and to a pointer to its first member.");
+
+const TraceCategory* ToTraceCategory(const unsigned char* category_enabled) {
+  return reinterpret_cast<const TraceCategory*>(category_enabled);
+}
+
+// The categories are never deleted, since the trace macros cache pointers to
+// them for the lifetime of the process.
+class TraceCategoryRegistry {
+ public:
+  TraceCategory* Get(const char* name) {
+    rtc::CritScope lock(&crit_);
+    for (TraceCategory& category : categories_) {
+      if (strcmp(category.name, name) == 0)
+        return &category;
+    }
+    categories_.emplace_back(name);
+    return &categories_.back();
+  }
+
+  static TraceCategoryRegistry* Instance() {
+    static TraceCategoryRegistry* const instance = new TraceCategoryRegistry();
+    return instance;
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  // A deque, so that adding a category doesn't move the others.
+  std::deque<TraceCategory> categories_ RTC_GUARDED_BY(crit_);
+};
+
+struct TraceArg {
+  const char* name;
+  unsigned char type;
+  // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
+  union TraceArgValue {
+    bool as_bool;
+    unsigned long long as_uint;
+    long long as_int;
+    double as_double;
+    const void* as_pointer;
+    const char* as_string;
+  } value;
+
+  // Assert that the size of the union is equal to the size of the as_uint
+  // field since we are assigning to arbitrary types using it.
+  static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
+                "Size of TraceArg value union is not equal to the size of "
+                "the uint field of that union.");
+};
+
+std::string TraceArgValueAsString(TraceArg arg) {
+  std::string output;
+
+  if (arg.type == TRACE_VALUE_TYPE_STRING ||
+      arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+    // Space for every character to be an espaced character + two for
+    // quatation marks.
+    output.reserve(strlen(arg.value.as_string) * 2 + 2);
+    output += '\"';
+    const char* c = arg.value.as_string;
+    do {
+      if (*c == '"' || *c == '\\') {
+        output += '\\';
+        output += *c;
+      } else {
+        output += *c;
+      }
+    } while (*++c);
+    output += '\"';
+  } else {
+    output.resize(kTraceArgBufferLength);
+    size_t print_length = 0;
+    switch (arg.type) {
+      case TRACE_VALUE_TYPE_BOOL:
+        if (arg.value.as_bool) {
+          strcpy(&output[0], "true");
+          print_length = 4;
+        } else {
+          strcpy(&output[0], "false");
+          print_length = 5;
+        }
+        break;
+      case TRACE_VALUE_TYPE_UINT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
+                                arg.value.as_uint);
+        break;
+      case TRACE_VALUE_TYPE_INT:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
+                                arg.value.as_int);
+        break;
+      case TRACE_VALUE_TYPE_DOUBLE:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
+                                arg.value.as_double);
+        break;
+      case TRACE_VALUE_TYPE_POINTER:
+        print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
+                                arg.value.as_pointer);
+        break;
+    }
+    size_t output_length = print_length < kTraceArgBufferLength
+                               ? print_length
+                               : kTraceArgBufferLength - 1;
+    // This will hopefully be very close to nop. On most implementations, it
+    // just writes null byte and sets the length field of the string.
+    output.resize(output_length);
+  }
+
+  return output;
+}
+
+// Writes one event in the TraceEvent format, which is documented here:
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
+void WriteTraceEvent(FILE* file,
+                     bool is_first_event,
+                     const char* name,
+                     const unsigned char* category_enabled,
+                     char phase,
+                     const TraceArg* args,
+                     size_t num_args,
+                     uint64_t timestamp,
+                     int pid,
+                     rtc::PlatformThreadId tid,
+                     std::string* args_str) {
+  args_str->clear();
+  if (num_args > 0) {
+    *args_str += ", \"args\": {";
+    for (size_t i = 0; i < num_args; ++i) {
+      if (i > 0)
+        *args_str += ",";
+      *args_str += " \"";
+      *args_str += args[i].name;
+      *args_str += "\": ";
+      *args_str += TraceArgValueAsString(args[i]);
+    }
+    *args_str += " }";
+  }
+  fprintf(file,
+          "%s{ \"name\": \"%s\""
+          ", \"cat\": \"%s\""
+          ", \"ph\": \"%c\""
+          ", \"ts\": %" PRIu64
+          ", \"pid\": %d"
+#if defined(WEBRTC_WIN)
+          ", \"tid\": %lu"
+#else
+          ", \"tid\": %d"
+#endif  // defined(WEBRTC_WIN)
+          "%s"
+          "}\n",
+          is_first_event ? " " : ",", name,
+          ToTraceCategory(category_enabled)->name, phase, timestamp, pid, tid,
+          args_str->c_str());
+}
 
 // TODO(pbos): Log metadata for all threads, etc.
 class EventLogger final {
@@ -128,8 +320,6 @@ class EventLogger final {
         {name, category_enabled, phase, args, timestamp, 1, thread_id});
   }
 
-// The TraceEvent format is documented here:
-// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
   void Log() {
     RTC_DCHECK(output_file_);
     static const int kLoggingIntervalMs = 100;
@@ -145,43 +335,17 @@ class EventLogger final {
       std::string args_str;
       args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
       for (TraceEvent& e : events) {
-        args_str.clear();
-        if (!e.args.empty()) {
-          args_str += ", \"args\": {";
-          bool is_first_argument = true;
-          for (TraceArg& arg : e.args) {
-            if (!is_first_argument)
-              args_str += ",";
-            is_first_argument = false;
-            args_str += " \"";
-            args_str += arg.name;
-            args_str += "\": ";
-            args_str += TraceArgValueAsString(arg);
-
-            // Delete our copy of the string.
-            if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-              delete[] arg.value.as_string;
-              arg.value.as_string = nullptr;
-            }
+        WriteTraceEvent(output_file_, !has_logged_event, e.name,
+                        e.category_enabled, e.phase, e.args.data(),
+                        e.args.size(), e.timestamp, e.pid, e.tid, &args_str);
+        has_logged_event = true;
+        // Delete our copies of the strings.
+        for (TraceArg& arg : e.args) {
+          if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+            delete[] arg.value.as_string;
+            arg.value.as_string = nullptr;
           }
-          args_str += " }";
         }
-        fprintf(output_file_,
-                "%s{ \"name\": \"%s\""
-                ", \"cat\": \"%s\""
-                ", \"ph\": \"%c\""
-                ", \"ts\": %" PRIu64
-                ", \"pid\": %d"
-#if defined(WEBRTC_WIN)
-                ", \"tid\": %lu"
-#else
-                ", \"tid\": %d"
-#endif  // defined(WEBRTC_WIN)
-                "%s"
-                "}\n",
-                has_logged_event ? "," : " ", e.name, e.category_enabled,
-                e.phase, e.timestamp, e.pid, e.tid, args_str.c_str());
-        has_logged_event = true;
       }
       if (shutting_down)
         break;
@@ -230,26 +394,6 @@ class EventLogger final {
   }
 
  private:
-  struct TraceArg {
-    const char* name;
-    unsigned char type;
-    // Copied from webrtc/rtc_base/trace_event.h TraceValueUnion.
-    union TraceArgValue {
-      bool as_bool;
-      unsigned long long as_uint;
-      long long as_int;
-      double as_double;
-      const void* as_pointer;
-      const char* as_string;
-    } value;
-
-    // Assert that the size of the union is equal to the size of the as_uint
-    // field since we are assigning to arbitrary types using it.
-    static_assert(sizeof(TraceArgValue) == sizeof(unsigned long long),
-                  "Size of TraceArg value union is not equal to the size of "
-                  "the uint field of that union.");
-  };
-
   struct TraceEvent {
     const char* name;
     const unsigned char* category_enabled;
@@ -260,66 +404,6 @@ class EventLogger final {
     rtc::PlatformThreadId tid;
   };
 
-  static std::string TraceArgValueAsString(TraceArg arg) {
-    std::string output;
-
-    if (arg.type == TRACE_VALUE_TYPE_STRING ||
-        arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
-      // Space for every character to be an espaced character + two for
-      // quatation marks.
-      output.reserve(strlen(arg.value.as_string) * 2 + 2);
-      output += '\"';
-      const char* c = arg.value.as_string;
-      do {
-        if (*c == '"' || *c == '\\') {
-          output += '\\';
-          output += *c;
-        } else {
-          output += *c;
-        }
-      } while (*++c);
-      output += '\"';
-    } else {
-      output.resize(kTraceArgBufferLength);
-      size_t print_length = 0;
-      switch (arg.type) {
-        case TRACE_VALUE_TYPE_BOOL:
-          if (arg.value.as_bool) {
-            strcpy(&output[0], "true");
-            print_length = 4;
-          } else {
-            strcpy(&output[0], "false");
-            print_length = 5;
-          }
-          break;
-        case TRACE_VALUE_TYPE_UINT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%llu",
-                                  arg.value.as_uint);
-          break;
-        case TRACE_VALUE_TYPE_INT:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%lld",
-                                  arg.value.as_int);
-          break;
-        case TRACE_VALUE_TYPE_DOUBLE:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "%f",
-                                  arg.value.as_double);
-          break;
-        case TRACE_VALUE_TYPE_POINTER:
-          print_length = sprintfn(&output[0], kTraceArgBufferLength, "\"%p\"",
-                                  arg.value.as_pointer);
-          break;
-      }
-      size_t output_length = print_length < kTraceArgBufferLength
-                                 ? print_length
-                                 : kTraceArgBufferLength - 1;
-      // This will hopefully be very close to nop. On most implementations, it
-      // just writes null byte and sets the length field of the string.
-      output.resize(output_length);
-    }
-
-    return output;
-  }
-
   rtc::CriticalSection crit_;
   std::vector<TraceEvent> trace_events_ RTC_GUARDED_BY(crit_);
   rtc::PlatformThread logging_thread_;
@@ -333,7 +417,356 @@ static void EventTracingThreadFunc(void* params) {
   static_cast<EventLogger*>(params)->Log();
 }
 
+// An event as recorded by an EventRecordingBuffer, with the strings that were
+// copied into the buffer.
+struct RecordedEvent {
+  static const int kMaxArgs = 2;
+  // Including the terminating null character. Longer strings are truncated.
+  static const size_t kMaxCopiedStringSize = 24;
+
+  uint64_t timestamp;
+  const unsigned char* category_enabled;
+  const char* name;
+  char phase;
+  int num_args;
+  TraceArg args[kMaxArgs];
+  char copied_strings[kMaxArgs][kMaxCopiedStringSize];
+};
+
+// The most recent events of one thread, in a ring buffer. Only the thread
+// that owns the buffer writes to it, so recording an event is a handful of
+// stores into memory of that thread, without a lock or an allocation. Other
+// threads can read the buffer at any time, seqlock style: the events are
+// stored as atomic words, and the readers discard the events that may have
+// been overwritten while they were being read.
+class EventRecordingBuffer {
+ public:
+  explicit EventRecordingBuffer(rtc::PlatformThreadId tid) { Reset(tid); }
+
+  // Must not be called while another thread is using the buffer.
+  void Reset(rtc::PlatformThreadId tid) {
+    tid_ = tid;
+    write_count_.store(0, std::memory_order_relaxed);
+    random_state_ = 0x9E3779B97F4A7C15ull ^ static_cast<uint64_t>(tid);
+    unrecorded_scopes_ = 0;
+    scope_depth_ = 0;
+    in_use_.store(true, std::memory_order_release);
+  }
+
+  rtc::PlatformThreadId tid() const { return tid_; }
+  bool in_use() const { return in_use_.load(std::memory_order_acquire); }
+  // Called by the owning thread when it exits.
+  void Release() { in_use_.store(false, std::memory_order_release); }
+
+  // Called by the owning thread only.
+  void Record(char phase,
+              const unsigned char* category_enabled,
+              const char* name,
+              int num_args,
+              const char** arg_names,
+              const unsigned char* arg_types,
+              const unsigned long long* arg_values,
+              uint64_t timestamp) {
+    if (!Sample(phase, ToTraceCategory(category_enabled)->one_in_n.load(
+                           std::memory_order_relaxed))) {
+      return;
+    }
+
+    num_args = std::min(num_args, RecordedEvent::kMaxArgs);
+    const uint64_t count = write_count_.load(std::memory_order_relaxed);
+    // Makes the readers that see any of the stores below also see that the
+    // write count is at least |count|, so that they discard what they read
+    // of the event that is being overwritten.
+    std::atomic_thread_fence(std::memory_order_release);
+    std::atomic<uint64_t>* words =
+        &words_[(count & (kRecordedEventsPerThread - 1)) * kWordsPerEvent];
+    Store(&words[kTimestampWord], timestamp);
+    Store(&words[kCategoryWord], reinterpret_cast<uintptr_t>(category_enabled));
+    Store(&words[kNameWord], reinterpret_cast<uintptr_t>(name));
+    uint64_t header = static_cast<unsigned char>(phase) |
+                      static_cast<uint64_t>(num_args) << 8;
+    for (int i = 0; i < num_args; ++i) {
+      header |= static_cast<uint64_t>(arg_types[i]) << (16 + 8 * i);
+      Store(&words[kArgNameWord + i],
+            reinterpret_cast<uintptr_t>(arg_names[i]));
+      if (arg_types[i] == TRACE_VALUE_TYPE_COPY_STRING) {
+        // The string is temporary, so it is copied into the buffer.
+        uint64_t string_words[kWordsPerCopiedString] = {0};
+        const char* string = reinterpret_cast<const char*>(arg_values[i]);
+        memcpy(string_words, string,
+               std::min(strlen(string),
+                        RecordedEvent::kMaxCopiedStringSize - 1));
+        for (size_t j = 0; j < kWordsPerCopiedString; ++j) {
+          Store(&words[kCopiedStringWord + i * kWordsPerCopiedString + j],
+                string_words[j]);
+        }
+      } else {
+        Store(&words[kArgValueWord + i], arg_values[i]);
+      }
+    }
+    Store(&words[kHeaderWord], header);
+    write_count_.store(count + 1, std::memory_order_release);
+  }
+
+  // Appends the recorded events from |begin_timestamp| on to |events|.
+  void Read(uint64_t begin_timestamp,
+            std::vector<RecordedEvent>* events) const {
+    const uint64_t end = write_count_.load(std::memory_order_acquire);
+    const uint64_t begin =
+        end > kRecordedEventsPerThread ? end - kRecordedEventsPerThread : 0;
+    const size_t first_event = events->size();
+    events->resize(first_event + (end - begin));
+    for (uint64_t i = begin; i < end; ++i)
+      ReadEvent(i, &(*events)[first_event + (i - begin)]);
+
+    // The events that the owning thread may have started to overwrite while
+    // they were being read are discarded.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint64_t count = write_count_.load(std::memory_order_relaxed);
+    const uint64_t valid_begin =
+        count >= kRecordedEventsPerThread
+            ? std::max(begin, count - kRecordedEventsPerThread + 1)
+            : begin;
+    auto valid_events = events->begin() + first_event + (valid_begin - begin);
+    auto last_events =
+        std::find_if(valid_events, events->end(),
+                     [begin_timestamp](const RecordedEvent& event) {
+                       return event.timestamp >= begin_timestamp;
+                     });
+    events->erase(events->begin() + first_event, last_events);
+  }
+
+ private:
+  static const size_t kTimestampWord = 0;
+  static const size_t kCategoryWord = 1;
+  static const size_t kNameWord = 2;
+  // The phase, the number of arguments and their types.
+  static const size_t kHeaderWord = 3;
+  static const size_t kArgNameWord = 4;
+  static const size_t kArgValueWord = kArgNameWord + RecordedEvent::kMaxArgs;
+  static const size_t kWordsPerCopiedString =
+      RecordedEvent::kMaxCopiedStringSize / sizeof(uint64_t);
+  static const size_t kCopiedStringWord =
+      kArgValueWord + RecordedEvent::kMaxArgs;
+  static const size_t kWordsPerEvent =
+      kCopiedStringWord + RecordedEvent::kMaxArgs * kWordsPerCopiedString;
+
+  static void Store(std::atomic<uint64_t>* word, uint64_t value) {
+    word->store(value, std::memory_order_relaxed);
+  }
+  static uint64_t Load(const std::atomic<uint64_t>& word) {
+    return word.load(std::memory_order_relaxed);
+  }
+
+  void ReadEvent(uint64_t index, RecordedEvent* event) const {
+    const std::atomic<uint64_t>* words =
+        &words_[(index & (kRecordedEventsPerThread - 1)) * kWordsPerEvent];
+    event->timestamp = Load(words[kTimestampWord]);
+    event->category_enabled =
+        reinterpret_cast<const unsigned char*>(Load(words[kCategoryWord]));
+    event->name = reinterpret_cast<const char*>(Load(words[kNameWord]));
+    const uint64_t header = Load(words[kHeaderWord]);
+    event->phase = static_cast<char>(header & 0xff);
+    event->num_args = static_cast<int>((header >> 8) & 0xff);
+    for (int i = 0; i < event->num_args; ++i) {
+      TraceArg& arg = event->args[i];
+      arg.name = reinterpret_cast<const char*>(Load(words[kArgNameWord + i]));
+      arg.type = static_cast<unsigned char>((header >> (16 + 8 * i)) & 0xff);
+      if (arg.type == TRACE_VALUE_TYPE_COPY_STRING) {
+        uint64_t string_words[kWordsPerCopiedString];
+        for (size_t j = 0; j < kWordsPerCopiedString; ++j) {
+          string_words[j] =
+              Load(words[kCopiedStringWord + i * kWordsPerCopiedString + j]);
+        }
+        memcpy(event->copied_strings[i], string_words,
+               RecordedEvent::kMaxCopiedStringSize);
+        event->copied_strings[i][RecordedEvent::kMaxCopiedStringSize - 1] = 0;
+        arg.value.as_string = event->copied_strings[i];
+      } else {
+        arg.value.as_uint = Load(words[kArgValueWord + i]);
+      }
+    }
+  }
+
+  // Returns whether to record an event of a category with the sampling
+  // |one_in_n|. The end of a scope is recorded if and only if its beginning
+  // was, which works since the scopes of a thread are nested.
+  bool Sample(char phase, int one_in_n) {
+    if (phase == TRACE_EVENT_PHASE_END && scope_depth_ > 0) {
+      --scope_depth_;
+      return scope_depth_ >= 64 || !(unrecorded_scopes_ >> scope_depth_ & 1);
+    }
+    bool record = one_in_n == 1;
+    if (one_in_n > 1) {
+      // xorshift64.
+      random_state_ ^= random_state_ << 13;
+      random_state_ ^= random_state_ >> 7;
+      random_state_ ^= random_state_ << 17;
+      record = random_state_ % one_in_n == 0;
+    }
+    if (phase == TRACE_EVENT_PHASE_BEGIN) {
+      if (scope_depth_ < 64) {
+        const uint64_t bit = uint64_t{1} << scope_depth_;
+        unrecorded_scopes_ =
+            record ? unrecorded_scopes_ & ~bit : unrecorded_scopes_ | bit;
+      }
+      ++scope_depth_;
+    }
+    return record;
+  }
+
+  std::atomic<uint64_t> words_[kRecordedEventsPerThread * kWordsPerEvent];
+  // The number of events written since the buffer was reset.
+  std::atomic<uint64_t> write_count_;
+  std::atomic<bool> in_use_;
+  rtc::PlatformThreadId tid_;
+
+  // Only used by the owning thread.
+  uint64_t random_state_;
+  // Bit i is set if the enclosing scope at depth i wasn't recorded.
+  uint64_t unrecorded_scopes_;
+  int scope_depth_;
+};
+
+static_assert((kRecordedEventsPerThread & (kRecordedEventsPerThread - 1)) == 0,
+              "The number of recorded events must be a power of two.");
+
+// Owns the recording buffers of all threads. The buffer of a thread is created
+// the first time it records an event. When the thread exits, the buffer is
+// kept, so that the events of the thread are still there when dumped. Once
+// there are many buffers, new threads take over those of the exited threads.
+class EventRecorder final {
+ public:
+  EventRecorder() {
+#if defined(WEBRTC_WIN)
+    // Unlike TLS, fiber local storage calls back when the thread exits.
+    fls_index_ = FlsAlloc(&ReleaseBuffer);
+    RTC_CHECK(fls_index_ != FLS_OUT_OF_INDEXES);
+#else
+    RTC_CHECK_EQ(0, pthread_key_create(&tls_key_, &ReleaseBuffer));
+#endif
+  }
+
+  ~EventRecorder() {
+#if defined(WEBRTC_WIN)
+    FlsFree(fls_index_);
+#else
+    pthread_key_delete(tls_key_);
+#endif
+  }
+
+  void Start() {
+    RTC_CHECK_EQ(
+        0, rtc::AtomicOps::CompareAndSwap(&g_event_recording_active, 0, 1));
+  }
+
+  void Stop() {
+    rtc::AtomicOps::CompareAndSwap(&g_event_recording_active, 1, 0);
+  }
+
+  void Record(char phase,
+              const unsigned char* category_enabled,
+              const char* name,
+              int num_args,
+              const char** arg_names,
+              const unsigned char* arg_types,
+              const unsigned long long* arg_values,
+              uint64_t timestamp) {
+    GetOrCreateBuffer()->Record(phase, category_enabled, name, num_args,
+                                arg_names, arg_types, arg_values, timestamp);
+  }
+
+  void Dump(FILE* file, int64_t duration_ms) {
+    const uint64_t now = rtc::TimeMicros();
+    const uint64_t begin_timestamp =
+        now > static_cast<uint64_t>(duration_ms) * 1000
+            ? now - static_cast<uint64_t>(duration_ms) * 1000
+            : 0;
+    fprintf(file, "{ \"traceEvents\": [\n");
+    bool has_logged_event = false;
+    std::vector<RecordedEvent> events;
+    std::string args_str;
+    args_str.reserve(kEventLoggerArgsStrBufferInitialSize);
+    rtc::CritScope lock(&crit_);
+    for (const auto& buffer : buffers_) {
+      events.clear();
+      buffer->Read(begin_timestamp, &events);
+      // The ends of the scopes that began before the first recorded event
+      // are left out, to keep the beginnings and ends paired.
+      int depth = 0;
+      for (const RecordedEvent& e : events) {
+        if (e.phase == TRACE_EVENT_PHASE_END) {
+          if (depth == 0)
+            continue;
+          --depth;
+        } else if (e.phase == TRACE_EVENT_PHASE_BEGIN) {
+          ++depth;
+        }
+        WriteTraceEvent(file, !has_logged_event, e.name, e.category_enabled,
+                        e.phase, e.args, e.num_args, e.timestamp, 1,
+                        buffer->tid(), &args_str);
+        has_logged_event = true;
+      }
+    }
+    fprintf(file, "]}\n");
+  }
+
+ private:
+  EventRecordingBuffer* GetOrCreateBuffer() {
+#if defined(WEBRTC_WIN)
+    void* buffer = FlsGetValue(fls_index_);
+#else
+    void* buffer = pthread_getspecific(tls_key_);
+#endif
+    if (buffer)
+      return static_cast<EventRecordingBuffer*>(buffer);
+
+    EventRecordingBuffer* new_buffer = nullptr;
+    {
+      rtc::CritScope lock(&crit_);
+      for (const auto& unused_buffer : buffers_) {
+        if (buffers_.size() < kMaxUnsharedRecordingBuffers)
+          break;
+        if (!unused_buffer->in_use()) {
+          new_buffer = unused_buffer.get();
+          new_buffer->Reset(rtc::CurrentThreadId());
+          break;
+        }
+      }
+      if (!new_buffer) {
+        buffers_.emplace_back(new EventRecordingBuffer(rtc::CurrentThreadId()));
+        new_buffer = buffers_.back().get();
+      }
+    }
+#if defined(WEBRTC_WIN)
+    FlsSetValue(fls_index_, new_buffer);
+#else
+    pthread_setspecific(tls_key_, new_buffer);
+#endif
+    return new_buffer;
+  }
+
+#if defined(WEBRTC_WIN)
+  static void WINAPI ReleaseBuffer(void* buffer) {
+#else
+  static void ReleaseBuffer(void* buffer) {
+#endif
+    static_cast<EventRecordingBuffer*>(buffer)->Release();
+  }
+
+#if defined(WEBRTC_WIN)
+  DWORD fls_index_;
+#else
+  pthread_key_t tls_key_;
+#endif
+  // Held while the buffers are dumped, so that no buffer changes owner then.
+  rtc::CriticalSection crit_;
+  std::vector<std::unique_ptr<EventRecordingBuffer>> buffers_
+      RTC_GUARDED_BY(crit_);
+};
+
 static EventLogger* volatile g_event_logger = nullptr;
+static EventRecorder* volatile g_event_recorder = nullptr;
 static const char* const kDisabledTracePrefix = TRACE_DISABLED_BY_DEFAULT("");
 const unsigned char* InternalGetCategoryEnabled(const char* name) {
   const char* prefix_ptr = &kDisabledTracePrefix[0];
@@ -343,8 +776,9 @@ const unsigned char* InternalGetCategoryEnabled(const char* name) {
     ++prefix_ptr;
     ++name_ptr;
   }
-  return reinterpret_cast<const unsigned char*>(*prefix_ptr == '\0' ? ""
-                                                                    : name);
+  if (*prefix_ptr == '\0')
+    return reinterpret_cast<const unsigned char*>("");
+  return &TraceCategoryRegistry::Instance()->Get(name)->enabled;
 }
 
 void InternalAddTraceEvent(char phase,
@@ -356,13 +790,24 @@ void InternalAddTraceEvent(char phase,
                            const unsigned char* arg_types,
                            const unsigned long long* arg_values,
                            unsigned char flags) {
+  const bool recording =
+      rtc::AtomicOps::AcquireLoad(&g_event_recording_active) != 0;
+  const bool logging =
+      rtc::AtomicOps::AcquireLoad(&g_event_logging_active) != 0;
   // Fast path for when event tracing is inactive.
-  if (rtc::AtomicOps::AcquireLoad(&g_event_logging_active) == 0)
+  if (!recording && !logging)
     return;
 
-  g_event_logger->AddTraceEvent(name, category_enabled, phase, num_args,
-                                arg_names, arg_types, arg_values,
-                                rtc::TimeMicros(), 1, rtc::CurrentThreadId());
+  const uint64_t timestamp = rtc::TimeMicros();
+  if (recording) {
+    g_event_recorder->Record(phase, category_enabled, name, num_args,
+                             arg_names, arg_types, arg_values, timestamp);
+  }
+  if (logging) {
+    g_event_logger->AddTraceEvent(name, category_enabled, phase, num_args,
+                                  arg_names, arg_types, arg_values, timestamp,
+                                  1, rtc::CurrentThreadId());
+  }
 }
 
 }  // namespace
@@ -371,6 +816,9 @@ void SetupInternalTracer() {
   RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
                 &g_event_logger, static_cast<EventLogger*>(nullptr),
                 new EventLogger()) == nullptr);
+  RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
+                &g_event_recorder, static_cast<EventRecorder*>(nullptr),
+                new EventRecorder()) == nullptr);
   webrtc::SetupEventTracer(InternalGetCategoryEnabled, InternalAddTraceEvent);
 }
 
@@ -400,14 +848,61 @@ void StopInternalCapture() {
   }
 }
 
+void StartInternalRecording() {
+  if (g_event_recorder) {
+    g_event_recorder->Start();
+  }
+}
+
+void StopInternalRecording() {
+  if (g_event_recorder) {
+    g_event_recorder->Stop();
+  }
+}
+
+void SetInternalRecordingSampling(const char* category, int one_in_n) {
+  RTC_DCHECK_GE(one_in_n, 0);
+  TraceCategoryRegistry::Instance()->Get(category)->one_in_n.store(
+      one_in_n, std::memory_order_relaxed);
+}
+
+void DumpInternalRecordingToFile(FILE* file, int64_t duration_ms) {
+  if (g_event_recorder) {
+    g_event_recorder->Dump(file, duration_ms);
+  }
+}
+
+bool DumpInternalRecording(const char* filename, int64_t duration_ms) {
+  if (!g_event_recorder)
+    return false;
+
+  FILE* file = fopen(filename, "w");
+  if (!file) {
+    RTC_LOG(LS_ERROR) << "Failed to open trace file '" << filename
+                      << "' for writing.";
+    return false;
+  }
+  g_event_recorder->Dump(file, duration_ms);
+  fclose(file);
+  return true;
+}
+
 void ShutdownInternalTracer() {
   StopInternalCapture();
+  StopInternalRecording();
   EventLogger* old_logger = rtc::AtomicOps::AcquireLoadPtr(&g_event_logger);
   RTC_DCHECK(old_logger);
   RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
                 &g_event_logger, old_logger,
                 static_cast<EventLogger*>(nullptr)) == old_logger);
   delete old_logger;
+  EventRecorder* old_recorder =
+      rtc::AtomicOps::AcquireLoadPtr(&g_event_recorder);
+  RTC_DCHECK(old_recorder);
+  RTC_CHECK(rtc::AtomicOps::CompareAndSwapPtr(
+                &g_event_recorder, old_recorder,
+                static_cast<EventRecorder*>(nullptr)) == old_recorder);
+  delete old_recorder;
   webrtc::SetupEventTracer(nullptr, nullptr);
 }
 
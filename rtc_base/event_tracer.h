@@ -26,6 +26,7 @@
 #ifndef RTC_BASE_EVENT_TRACER_H_
 #define RTC_BASE_EVENT_TRACER_H_
 
+#include <stdint.h>
 #include <stdio.h>
 
 namespace webrtc {
@@ -77,6 +78,21 @@ void SetupInternalTracer();
 bool StartInternalCapture(const char* filename);
 void StartInternalCaptureToFile(FILE* file);
 void StopInternalCapture();
+
+// The recording keeps the most recent events of each thread in memory, in a
+// fixed-size buffer per thread, so that it can be left on all the time and
+// dumped when something goes wrong. Recording an event doesn't take a lock,
+// and can run at the same time as a capture.
+void StartInternalRecording();
+void StopInternalRecording();
+// Records one in |one_in_n| of the events of |category|, and none if it is 0.
+// The end of a scope is recorded if and only if its beginning was. All events
+// are recorded by default. Doesn't affect the capture.
+void SetInternalRecordingSampling(const char* category, int one_in_n);
+// Writes the recorded events of the last |duration_ms| in the same format as
+// the capture.
+bool DumpInternalRecording(const char* filename, int64_t duration_ms);
+void DumpInternalRecordingToFile(FILE* file, int64_t duration_ms);
 // Make sure we run this, this will tear down the internal tracing.
 void ShutdownInternalTracer();
 }  // namespace tracing
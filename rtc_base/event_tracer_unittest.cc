@@ -10,6 +10,11 @@
 
 #include "rtc_base/event_tracer.h"
 
+#include <string>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread.h"
 #include "rtc_base/trace_event.h"
 #include "test/gtest.h"
 
@@ -57,6 +62,33 @@ static void AddTraceEventHandler(char phase,
   TestStatistics::Get()->Increment();
 }
 
+// Returns what DumpInternalRecordingToFile writes.
+std::string DumpRecording(int64_t duration_ms) {
+  FILE* file = tmpfile();
+  RTC_CHECK(file);
+  rtc::tracing::DumpInternalRecordingToFile(file, duration_ms);
+  std::string dump(ftell(file), '\0');
+  rewind(file);
+  RTC_CHECK_EQ(dump.size(), fread(&dump[0], 1, dump.size(), file));
+  fclose(file);
+  return dump;
+}
+
+int CountOccurrences(const std::string& str, const std::string& substr) {
+  int count = 0;
+  for (size_t pos = str.find(substr); pos != std::string::npos;
+       pos = str.find(substr, pos + 1)) {
+    ++count;
+  }
+  return count;
+}
+
+void RecordScopes(void* num_scopes) {
+  for (int i = 0; i < *static_cast<int*>(num_scopes); ++i) {
+    TRACE_EVENT0("recording", "RecordScopesThread");
+  }
+}
+
 }  // namespace
 
 namespace webrtc {
@@ -78,4 +110,100 @@ TEST(EventTracerTest, ScopedTraceEvent) {
   TestStatistics::Get()->Reset();
 }
 
+TEST(EventTracerTest, RecordsAndDumpsEvents) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalRecording();
+  {
+    TRACE_EVENT1("recording", "RecordsAndDumpsEvents", "value", 17);
+    TRACE_EVENT_INSTANT1(
+        "recording", "RecordsAndDumpsInstant", "str",
+        TRACE_STR_COPY(std::string("copied \"string\"").c_str()));
+  }
+  rtc::tracing::StopInternalRecording();
+  {
+    TRACE_EVENT0("recording", "NotRecorded");
+  }
+  const std::string dump = DumpRecording(60000);
+  EXPECT_EQ(0u, dump.find("{ \"traceEvents\": ["));
+  EXPECT_EQ(2, CountOccurrences(dump, "\"RecordsAndDumpsEvents\""));
+  EXPECT_EQ(1, CountOccurrences(dump, "\"ph\": \"B\""));
+  EXPECT_EQ(1, CountOccurrences(dump, "\"ph\": \"E\""));
+  EXPECT_EQ(1, CountOccurrences(dump, "\"args\": { \"value\": 17 }"));
+  EXPECT_EQ(1, CountOccurrences(dump, "\"copied \\\"string\\\"\""));
+  EXPECT_EQ(3, CountOccurrences(dump, "\"cat\": \"recording\""));
+  EXPECT_EQ(0, CountOccurrences(dump, "NotRecorded"));
+  rtc::tracing::ShutdownInternalTracer();
+}
+
+TEST(EventTracerTest, DumpsOnlyRecentEvents) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalRecording();
+  TRACE_EVENT_INSTANT0("recording", "DumpsOnlyRecentEvents");
+  rtc::Thread::SleepMs(50);
+  EXPECT_EQ(1, CountOccurrences(DumpRecording(1000), "DumpsOnlyRecentEvents"));
+  EXPECT_EQ(0, CountOccurrences(DumpRecording(10), "DumpsOnlyRecentEvents"));
+  rtc::tracing::ShutdownInternalTracer();
+}
+
+TEST(EventTracerTest, SamplesCategories) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::SetInternalRecordingSampling("unsampled", 0);
+  rtc::tracing::SetInternalRecordingSampling("sampled", 4);
+  rtc::tracing::StartInternalRecording();
+  for (int i = 0; i < 400; ++i) {
+    TRACE_EVENT0("sampled", "SampledScope");
+    TRACE_EVENT0("unsampled", "UnsampledScope");
+  }
+  const std::string dump = DumpRecording(60000);
+  EXPECT_EQ(0, CountOccurrences(dump, "UnsampledScope"));
+  // The beginning and the end of each scope are both recorded or not.
+  const int sampled = CountOccurrences(dump, "SampledScope");
+  EXPECT_EQ(0, sampled % 2);
+  EXPECT_GT(sampled, 2 * 50);
+  EXPECT_LT(sampled, 2 * 150);
+  rtc::tracing::SetInternalRecordingSampling("unsampled", 1);
+  rtc::tracing::SetInternalRecordingSampling("sampled", 1);
+  rtc::tracing::ShutdownInternalTracer();
+}
+
+TEST(EventTracerTest, KeepsTheMostRecentEventsPaired) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalRecording();
+  {
+    TRACE_EVENT0("recording", "OuterScope");
+    // More events than the recording keeps, so that it starts in the middle
+    // of a scope.
+    for (int i = 0; i < 5001; ++i) {
+      TRACE_EVENT_BEGIN0("recording", "InnerScope");
+      if (i < 5000)
+        TRACE_EVENT_END0("recording", "InnerScope");
+    }
+    TRACE_EVENT_END0("recording", "InnerScope");
+  }
+  const std::string dump = DumpRecording(60000);
+  const int num_begins = CountOccurrences(dump, "\"ph\": \"B\"");
+  EXPECT_EQ(num_begins, CountOccurrences(dump, "\"ph\": \"E\""));
+  EXPECT_GT(num_begins, 1000);
+  EXPECT_LT(num_begins, 2000);
+  EXPECT_EQ(0, CountOccurrences(dump, "OuterScope"));
+  rtc::tracing::ShutdownInternalTracer();
+}
+
+TEST(EventTracerTest, RecordsEventsOfAllThreads) {
+  rtc::tracing::SetupInternalTracer();
+  rtc::tracing::StartInternalRecording();
+  int num_scopes = 100;
+  rtc::PlatformThread thread1(&RecordScopes, &num_scopes, "Recording1");
+  rtc::PlatformThread thread2(&RecordScopes, &num_scopes, "Recording2");
+  thread1.Start();
+  thread2.Start();
+  RecordScopes(&num_scopes);
+  thread1.Stop();
+  thread2.Stop();
+  // The exited threads' events are kept.
+  EXPECT_EQ(3 * 2 * num_scopes,
+            CountOccurrences(DumpRecording(60000), "RecordScopesThread"));
+  rtc::tracing::ShutdownInternalTracer();
+}
+
 }  // namespace webrtc
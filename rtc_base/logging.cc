@@ -33,6 +33,7 @@ static const int kMaxLogLineSize = 1024 - 60;
 #include <limits.h>
 
 #include <algorithm>
+#include <atomic>
 #include <iomanip>
 #include <ostream>
 #include <vector>
@@ -78,6 +79,9 @@ std::ostream& GetNoopStream() {
 
 // Global lock for log subsystem, only needed to serialize access to streams_.
 CriticalSection g_log_crit;
+// Whether streams_ is empty, so that checking whether a message is a noop
+// doesn't take g_log_crit. Only written with g_log_crit held.
+std::atomic<bool> g_no_streams(true);
 }  // namespace
 
 void LogSink::OnLogMessage(const std::string& msg,
@@ -86,6 +90,18 @@ void LogSink::OnLogMessage(const std::string& msg,
   OnLogMessage(msg);
 }
 
+void LogSink::OnLogMessages(const QueuedLogMessage* messages,
+                            size_t num_messages) {
+  for (size_t i = 0; i < num_messages; ++i) {
+    if (messages[i].tag) {
+      OnLogMessage(messages[i].message, messages[i].severity,
+                   messages[i].tag);
+    } else {
+      OnLogMessage(messages[i].message);
+    }
+  }
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // LogMessage
 /////////////////////////////////////////////////////////////////////////////
@@ -363,9 +379,10 @@ void LogMessage::UpdateMinLogSeverity()
     RTC_EXCLUSIVE_LOCKS_REQUIRED(g_log_crit) {
   LoggingSeverity min_sev = g_dbg_sev;
   for (auto& kv : streams_) {
-    min_sev = std::min(g_dbg_sev, kv.second);
+    min_sev = std::min(min_sev, kv.second);
   }
   g_min_sev = min_sev;
+  g_no_streams.store(streams_.empty(), std::memory_order_relaxed);
 }
 
 #if defined(WEBRTC_ANDROID)
@@ -473,11 +490,7 @@ bool LogMessage::IsNoop(LoggingSeverity severity) {
   if (severity >= g_dbg_sev)
     return false;
 
-  // TODO(tommi): We're grabbing this lock for every LogMessage instance that
-  // is going to be logged. This introduces unnecessary synchronization for
-  // a feature that's mostly used for testing.
-  CritScope cs(&g_log_crit);
-  return streams_.size() == 0;
+  return g_no_streams.load(std::memory_order_relaxed);
 }
 
 void LogMessage::FinishPrintStream() {
@@ -111,6 +111,16 @@ enum LogErrorContext {
   ERRCTX_OS = ERRCTX_OSSTATUS,  // LOG_E(sev, OS, x)
 };
 
+// A log message that was queued to be passed on to a sink later, see
+// AsyncLogSink.
+struct QueuedLogMessage {
+  std::string message;
+  LoggingSeverity severity = LS_NONE;
+  // Null if the message was logged without a severity and a tag, i.e.
+  // through the single-argument OnLogMessage().
+  const char* tag = nullptr;
+};
+
 // Virtual sink interface that can receive log messages.
 class LogSink {
  public:
@@ -120,6 +130,10 @@ class LogSink {
                             LoggingSeverity severity,
                             const char* tag);
   virtual void OnLogMessage(const std::string& message) = 0;
+  // Receives several messages at once. The default implementation passes
+  // them on to OnLogMessage() one at a time.
+  virtual void OnLogMessages(const QueuedLogMessage* messages,
+                             size_t num_messages);
 };
 
 class LogMessage {
@@ -12,11 +12,25 @@
 
 #include <iostream>
 #include <string>
+#include <utility>
 
 #include "rtc_base/checks.h"
 
 namespace rtc {
 
+namespace {
+// How often AsyncLogSink passes on the queued messages, unless the queue gets
+// half full or is flushed before that.
+const int kAsyncLogSinkDeliveryIntervalMs = 100;
+
+size_t RoundUpToPowerOfTwo(size_t value) {
+  size_t power = 1;
+  while (power < value)
+    power *= 2;
+  return power;
+}
+}  // namespace
+
 FileRotatingLogSink::FileRotatingLogSink(const std::string& log_dir_path,
                                          const std::string& log_prefix,
                                          size_t max_log_size,
@@ -43,6 +57,18 @@ void FileRotatingLogSink::OnLogMessage(const std::string& message) {
   stream_->WriteAll(message.c_str(), message.size(), nullptr, nullptr);
 }
 
+void FileRotatingLogSink::OnLogMessages(const QueuedLogMessage* messages,
+                                        size_t num_messages) {
+  if (stream_->GetState() != SS_OPEN) {
+    std::cerr << "Init() must be called before adding this sink." << std::endl;
+    return;
+  }
+  batch_.clear();
+  for (size_t i = 0; i < num_messages; ++i)
+    batch_ += messages[i].message;
+  stream_->WriteAll(batch_.data(), batch_.size(), nullptr, nullptr);
+}
+
 bool FileRotatingLogSink::Init() {
   return stream_->Open();
 }
@@ -61,4 +87,128 @@ CallSessionFileRotatingLogSink::CallSessionFileRotatingLogSink(
 CallSessionFileRotatingLogSink::~CallSessionFileRotatingLogSink() {
 }
 
+AsyncLogSink::AsyncLogSink(LogSink* sink, size_t max_queued_messages)
+    : sink_(sink),
+      slots_(RoundUpToPowerOfTwo(max_queued_messages)),
+      slot_mask_(slots_.size() - 1),
+      enqueue_position_(0),
+      dequeue_position_(0),
+      dropped_messages_(0),
+      flushes_requested_(0),
+      flushes_done_(0),
+      stopping_(false),
+      wake_up_(false, false),
+      flushed_(false, false),
+      thread_(&AsyncLogSink::DeliveryThread,
+              this,
+              "AsyncLogSink",
+              kLowPriority) {
+  RTC_DCHECK(sink_);
+  RTC_DCHECK_GT(max_queued_messages, 0);
+  for (size_t i = 0; i < slots_.size(); ++i)
+    slots_[i].sequence.store(i, std::memory_order_relaxed);
+  thread_.Start();
+}
+
+AsyncLogSink::~AsyncLogSink() {
+  stopping_.store(true);
+  wake_up_.Set();
+  thread_.Stop();
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& msg,
+                                LoggingSeverity severity,
+                                const char* tag) {
+  Enqueue(msg, severity, tag);
+}
+
+void AsyncLogSink::OnLogMessage(const std::string& message) {
+  Enqueue(message, LS_NONE, nullptr);
+}
+
+void AsyncLogSink::Flush() {
+  const int flush = flushes_requested_.fetch_add(1) + 1;
+  wake_up_.Set();
+  // |flushed_| only wakes up one of the threads that flush at the same time,
+  // so the others find out on the next check.
+  while (flushes_done_.load() < flush)
+    flushed_.Wait(10);
+}
+
+void AsyncLogSink::DeliveryThread(void* obj) {
+  AsyncLogSink* sink = static_cast<AsyncLogSink*>(obj);
+  while (true) {
+    sink->wake_up_.Wait(kAsyncLogSinkDeliveryIntervalMs);
+    const bool stopping = sink->stopping_.load();
+    const int flushes_requested = sink->flushes_requested_.load();
+    sink->Deliver();
+    if (sink->flushes_done_.load() < flushes_requested) {
+      sink->flushes_done_.store(flushes_requested);
+      sink->flushed_.Set();
+    }
+    if (stopping)
+      return;
+  }
+}
+
+void AsyncLogSink::Enqueue(const std::string& message,
+                           LoggingSeverity severity,
+                           const char* tag) {
+  size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  Slot* slot;
+  while (true) {
+    slot = &slots_[position & slot_mask_];
+    const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+    const intptr_t difference =
+        static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The queue is full.
+      dropped_messages_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+  // Assigning reuses the capacity that the slot's string has from earlier
+  // messages, so this doesn't allocate once the queue has warmed up.
+  slot->message.message.assign(message);
+  slot->message.severity = severity;
+  slot->message.tag = tag;
+  slot->sequence.store(position + 1, std::memory_order_release);
+
+  // Wake up the delivery thread early rather than letting the queue fill up.
+  if (position + 1 - dequeue_position_.load(std::memory_order_relaxed) ==
+      slots_.size() / 2) {
+    wake_up_.Set();
+  }
+}
+
+void AsyncLogSink::Deliver() {
+  size_t position = dequeue_position_.load(std::memory_order_relaxed);
+  size_t num_messages;
+  // At most a queue's worth of messages are passed on at once, for the
+  // batches to be of a bounded size while the queue is being refilled.
+  do {
+    num_messages = 0;
+    while (num_messages < slots_.size()) {
+      Slot& slot = slots_[position & slot_mask_];
+      if (slot.sequence.load(std::memory_order_acquire) != position + 1)
+        break;
+      if (num_messages == batch_.size())
+        batch_.emplace_back();
+      std::swap(batch_[num_messages++], slot.message);
+      slot.sequence.store(position + slots_.size(), std::memory_order_release);
+      ++position;
+      dequeue_position_.store(position, std::memory_order_relaxed);
+    }
+    if (num_messages > 0)
+      sink_->OnLogMessages(batch_.data(), num_messages);
+  } while (num_messages == slots_.size());
+}
+
 }  // namespace rtc
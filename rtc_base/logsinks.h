@@ -11,12 +11,17 @@
 #ifndef RTC_BASE_LOGSINKS_H_
 #define RTC_BASE_LOGSINKS_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
 #include "rtc_base/filerotatingstream.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/platform_thread.h"
 
 namespace rtc {
 
@@ -35,6 +40,9 @@ class FileRotatingLogSink : public LogSink {
   // Writes the message to the current file. It will spill over to the next
   // file if needed.
   void OnLogMessage(const std::string& message) override;
+  // Writes all the messages at once.
+  void OnLogMessages(const QueuedLogMessage* messages,
+                     size_t num_messages) override;
 
   // Deletes any existing files in the directory and creates a new log file.
   virtual bool Init();
@@ -47,6 +55,8 @@ class FileRotatingLogSink : public LogSink {
 
  private:
   std::unique_ptr<FileRotatingStream> stream_;
+  // Reused for concatenating the messages passed to OnLogMessages().
+  std::string batch_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(FileRotatingLogSink);
 };
@@ -63,6 +73,68 @@ class CallSessionFileRotatingLogSink : public FileRotatingLogSink {
   RTC_DISALLOW_COPY_AND_ASSIGN(CallSessionFileRotatingLogSink);
 };
 
+// Log sink that passes the messages on to another sink from a thread of its
+// own, in batches, so that the threads that log never wait for a slow sink
+// such as a FileRotatingLogSink. Logging a message copies it into a
+// fixed-size queue without taking a lock. The messages that are logged while
+// the queue is full are dropped, and counted.
+class AsyncLogSink : public LogSink {
+ public:
+  // |sink| must outlive this. |max_queued_messages| is rounded up to a power
+  // of two.
+  explicit AsyncLogSink(LogSink* sink, size_t max_queued_messages = 1024);
+  // Passes on the messages that are still queued.
+  ~AsyncLogSink() override;
+
+  void OnLogMessage(const std::string& msg,
+                    LoggingSeverity severity,
+                    const char* tag) override;
+  void OnLogMessage(const std::string& message) override;
+
+  // Blocks until the messages that were logged before the call have been
+  // passed on.
+  void Flush();
+
+  // The number of messages that were dropped since the queue was full.
+  int dropped_messages() const { return dropped_messages_.load(); }
+
+ private:
+  struct Slot {
+    // The number of messages that have been enqueued when the slot is free
+    // for the next one, plus one once the slot holds that message.
+    std::atomic<size_t> sequence;
+    QueuedLogMessage message;
+  };
+
+  static void DeliveryThread(void* obj);
+  void Enqueue(const std::string& message,
+               LoggingSeverity severity,
+               const char* tag);
+  // Passes on everything that is in the queue. Called on |thread_|.
+  void Deliver();
+
+  LogSink* const sink_;
+  // A bounded multi-producer queue (Dmitry Vyukov's design), with a single
+  // consumer, |thread_|.
+  std::vector<Slot> slots_;
+  const size_t slot_mask_;
+  std::atomic<size_t> enqueue_position_;
+  std::atomic<size_t> dequeue_position_;
+  // The messages are swapped out of the queue into here and passed on from
+  // here, so that the strings of both keep their capacity.
+  std::vector<QueuedLogMessage> batch_;
+
+  std::atomic<int> dropped_messages_;
+  std::atomic<int> flushes_requested_;
+  std::atomic<int> flushes_done_;
+  std::atomic<bool> stopping_;
+  rtc::Event wake_up_;
+  rtc::Event flushed_;
+  rtc::PlatformThread thread_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(AsyncLogSink);
+};
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_LOGSINKS_H_
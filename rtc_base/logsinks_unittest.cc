@@ -0,0 +1,184 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/logsinks.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/platform_thread.h"
+
+namespace rtc {
+
+namespace {
+
+class RecordingLogSink : public LogSink {
+ public:
+  void OnLogMessage(const std::string& msg,
+                    LoggingSeverity severity,
+                    const char* tag) override {
+    messages_.push_back({msg, severity, tag});
+  }
+  void OnLogMessage(const std::string& message) override {
+    messages_.push_back({message, LS_NONE, nullptr});
+  }
+  void OnLogMessages(const QueuedLogMessage* messages,
+                     size_t num_messages) override {
+    ++num_batches_;
+    LogSink::OnLogMessages(messages, num_messages);
+  }
+
+  const std::vector<QueuedLogMessage>& messages() const { return messages_; }
+  int num_batches() const { return num_batches_; }
+
+ private:
+  std::vector<QueuedLogMessage> messages_;
+  int num_batches_ = 0;
+};
+
+// Blocks in the first OnLogMessages() until unblocked.
+class BlockingLogSink : public RecordingLogSink {
+ public:
+  void OnLogMessages(const QueuedLogMessage* messages,
+                     size_t num_messages) override {
+    if (!blocked_) {
+      blocked_ = true;
+      entered_.Set();
+      unblock_.Wait(Event::kForever);
+    }
+    RecordingLogSink::OnLogMessages(messages, num_messages);
+  }
+
+  void WaitUntilBlocked() { entered_.Wait(Event::kForever); }
+  void Unblock() { unblock_.Set(); }
+
+ private:
+  bool blocked_ = false;
+  Event entered_{false, false};
+  Event unblock_{false, false};
+};
+
+struct ProducerParams {
+  AsyncLogSink* sink;
+  int producer;
+  int num_messages;
+};
+
+void ProduceMessages(void* obj) {
+  ProducerParams* params = static_cast<ProducerParams*>(obj);
+  for (int i = 0; i < params->num_messages; ++i) {
+    params->sink->OnLogMessage(std::to_string(params->producer) + " " +
+                               std::to_string(i));
+  }
+}
+
+}  // namespace
+
+TEST(AsyncLogSinkTest, PassesOnMessagesInOrderAndInBatches) {
+  RecordingLogSink sink;
+  AsyncLogSink async_sink(&sink);
+  for (int i = 0; i < 100; ++i)
+    async_sink.OnLogMessage(std::to_string(i));
+  async_sink.Flush();
+  ASSERT_EQ(100u, sink.messages().size());
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(std::to_string(i), sink.messages()[i].message);
+  EXPECT_LT(sink.num_batches(), 100);
+  EXPECT_EQ(0, async_sink.dropped_messages());
+}
+
+TEST(AsyncLogSinkTest, PassesOnSeverityAndTag) {
+  RecordingLogSink sink;
+  AsyncLogSink async_sink(&sink);
+  static const char kTag[] = "tag";
+  async_sink.OnLogMessage("tagged", LS_WARNING, kTag);
+  async_sink.OnLogMessage("untagged");
+  async_sink.Flush();
+  ASSERT_EQ(2u, sink.messages().size());
+  EXPECT_EQ(LS_WARNING, sink.messages()[0].severity);
+  EXPECT_EQ(kTag, sink.messages()[0].tag);
+  EXPECT_EQ(nullptr, sink.messages()[1].tag);
+}
+
+TEST(AsyncLogSinkTest, PassesOnQueuedMessagesWhenDestroyed) {
+  RecordingLogSink sink;
+  {
+    AsyncLogSink async_sink(&sink);
+    async_sink.OnLogMessage("last words");
+  }
+  ASSERT_EQ(1u, sink.messages().size());
+  EXPECT_EQ("last words", sink.messages()[0].message);
+}
+
+TEST(AsyncLogSinkTest, ReceivesLogMessages) {
+  RecordingLogSink sink;
+  AsyncLogSink async_sink(&sink);
+  LogMessage::AddLogToStream(&async_sink, LS_INFO);
+  RTC_LOG(LS_INFO) << "Logged asynchronously";
+  LogMessage::RemoveLogToStream(&async_sink);
+  async_sink.Flush();
+  ASSERT_EQ(1u, sink.messages().size());
+  EXPECT_NE(std::string::npos,
+            sink.messages()[0].message.find("Logged asynchronously"));
+}
+
+TEST(AsyncLogSinkTest, DropsMessagesWhileTheQueueIsFull) {
+  BlockingLogSink sink;
+  AsyncLogSink async_sink(&sink, 4);
+  async_sink.OnLogMessage("first");
+  sink.WaitUntilBlocked();
+  for (int i = 0; i < 10; ++i)
+    async_sink.OnLogMessage(std::to_string(i));
+  EXPECT_EQ(6, async_sink.dropped_messages());
+  sink.Unblock();
+  async_sink.Flush();
+  ASSERT_EQ(5u, sink.messages().size());
+  EXPECT_EQ("first", sink.messages()[0].message);
+  EXPECT_EQ("3", sink.messages()[4].message);
+}
+
+TEST(AsyncLogSinkTest, ConcurrentProducers) {
+  static const int kNumProducers = 4;
+  static const int kMessagesPerProducer = 1000;
+  RecordingLogSink sink;
+  AsyncLogSink async_sink(&sink, 64);
+  std::vector<ProducerParams> params(kNumProducers);
+  std::vector<std::unique_ptr<PlatformThread>> threads;
+  for (int i = 0; i < kNumProducers; ++i) {
+    params[i] = {&async_sink, i, kMessagesPerProducer};
+    threads.emplace_back(
+        new PlatformThread(&ProduceMessages, &params[i], "Producer"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  async_sink.Flush();
+
+  EXPECT_EQ(kNumProducers * kMessagesPerProducer,
+            static_cast<int>(sink.messages().size()) +
+                async_sink.dropped_messages());
+  // The messages of each producer stay in order.
+  std::vector<int> last_message(kNumProducers, -1);
+  for (const QueuedLogMessage& message : sink.messages()) {
+    const size_t space = message.message.find(' ');
+    ASSERT_NE(std::string::npos, space);
+    const int producer = std::stoi(message.message.substr(0, space));
+    const int index = std::stoi(message.message.substr(space + 1));
+    ASSERT_GE(producer, 0);
+    ASSERT_LT(producer, kNumProducers);
+    EXPECT_GT(index, last_message[producer]);
+    last_message[producer] = index;
+  }
+}
+
+}  // namespace rtc
@@ -0,0 +1,63 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/memory_account.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace rtc {
+
+const char kRtpPacketHistoryMemory[] = "rtp_packet_history";
+const char kVideoPacketBufferMemory[] = "video_packet_buffer";
+
+MemoryAccount::Usage::Usage() = default;
+MemoryAccount::Usage::Usage(const Usage&) = default;
+MemoryAccount::Usage::~Usage() = default;
+
+MemoryAccount::MemoryAccount() = default;
+
+MemoryAccount::~MemoryAccount() {
+  RTC_DCHECK(sources_.empty());
+}
+
+void MemoryAccount::AddSource(const char* category,
+                              const MemoryUsageSource* source) {
+  RTC_DCHECK(category);
+  RTC_DCHECK(source);
+  rtc::CritScope cs(&crit_);
+  sources_.push_back({category, source});
+}
+
+void MemoryAccount::RemoveSource(const MemoryUsageSource* source) {
+  rtc::CritScope cs(&crit_);
+  auto it = std::find_if(
+      sources_.begin(), sources_.end(),
+      [source](const Source& entry) { return entry.source == source; });
+  RTC_DCHECK(it != sources_.end());
+  if (it != sources_.end())
+    sources_.erase(it);
+}
+
+MemoryAccount::Usage MemoryAccount::GetUsage() const {
+  Usage usage;
+  // The lock is held while polling, so that sources can't be removed and
+  // destroyed while in use.
+  rtc::CritScope cs(&crit_);
+  for (const Source& entry : sources_) {
+    size_t bytes = entry.source->MemoryUsageBytes();
+    usage.total_bytes += bytes;
+    usage.bytes_by_category[entry.category] += bytes;
+  }
+  return usage;
+}
+
+}  // namespace rtc
@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_MEMORY_ACCOUNT_H_
+#define RTC_BASE_MEMORY_ACCOUNT_H_
+
+#include <stddef.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+namespace rtc {
+
+// Implemented by buffers whose memory usage is reported to a MemoryAccount.
+class MemoryUsageSource {
+ public:
+  // Returns the number of bytes currently allocated by the source. May be
+  // called on any thread.
+  virtual size_t MemoryUsageBytes() const = 0;
+
+ protected:
+  virtual ~MemoryUsageSource() {}
+};
+
+// Collects the memory usage of the buffers belonging to one owner, such as a
+// Call, so that the usage of each owner can be queried separately. Sources
+// are polled when the usage is queried, so accounting adds no cost when
+// buffers change. Thread safe.
+class MemoryAccount {
+ public:
+  struct Usage {
+    Usage();
+    Usage(const Usage&);
+    ~Usage();
+
+    size_t total_bytes = 0;
+    // Bytes used by the sources of each category.
+    std::map<std::string, size_t> bytes_by_category;
+  };
+
+  MemoryAccount();
+  ~MemoryAccount();
+
+  // Adds |source| to the account under |category|, which must outlive the
+  // account. |source| must be removed before it is destroyed.
+  void AddSource(const char* category, const MemoryUsageSource* source);
+  void RemoveSource(const MemoryUsageSource* source);
+
+  Usage GetUsage() const;
+
+ private:
+  struct Source {
+    const char* category;
+    const MemoryUsageSource* source;
+  };
+
+  rtc::CriticalSection crit_;
+  std::vector<Source> sources_ RTC_GUARDED_BY(crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(MemoryAccount);
+};
+
+// Categories used by the buffers in the tree.
+extern const char kRtpPacketHistoryMemory[];
+extern const char kVideoPacketBufferMemory[];
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_MEMORY_ACCOUNT_H_
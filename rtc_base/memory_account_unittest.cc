@@ -0,0 +1,81 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/memory_account.h"
+
+#include "test/gtest.h"
+
+namespace rtc {
+namespace {
+
+const char kCategoryA[] = "a";
+const char kCategoryB[] = "b";
+
+class FakeSource : public MemoryUsageSource {
+ public:
+  explicit FakeSource(size_t bytes) : bytes_(bytes) {}
+  ~FakeSource() override {}
+
+  size_t MemoryUsageBytes() const override { return bytes_; }
+  void set_bytes(size_t bytes) { bytes_ = bytes; }
+
+ private:
+  size_t bytes_;
+};
+
+}  // namespace
+
+TEST(MemoryAccountTest, EmptyAccount) {
+  MemoryAccount account;
+  MemoryAccount::Usage usage = account.GetUsage();
+  EXPECT_EQ(0u, usage.total_bytes);
+  EXPECT_TRUE(usage.bytes_by_category.empty());
+}
+
+TEST(MemoryAccountTest, SumsSourcesByCategory) {
+  MemoryAccount account;
+  FakeSource source1(100);
+  FakeSource source2(20);
+  FakeSource source3(3);
+  account.AddSource(kCategoryA, &source1);
+  account.AddSource(kCategoryA, &source2);
+  account.AddSource(kCategoryB, &source3);
+
+  MemoryAccount::Usage usage = account.GetUsage();
+  EXPECT_EQ(123u, usage.total_bytes);
+  EXPECT_EQ(2u, usage.bytes_by_category.size());
+  EXPECT_EQ(120u, usage.bytes_by_category[kCategoryA]);
+  EXPECT_EQ(3u, usage.bytes_by_category[kCategoryB]);
+
+  // Sources are polled, so changes are seen by the next query.
+  source3.set_bytes(5);
+  EXPECT_EQ(125u, account.GetUsage().total_bytes);
+
+  account.RemoveSource(&source1);
+  account.RemoveSource(&source2);
+  account.RemoveSource(&source3);
+}
+
+TEST(MemoryAccountTest, RemovedSourceIsNotCounted) {
+  MemoryAccount account;
+  FakeSource source1(100);
+  FakeSource source2(20);
+  account.AddSource(kCategoryA, &source1);
+  account.AddSource(kCategoryB, &source2);
+  account.RemoveSource(&source1);
+
+  MemoryAccount::Usage usage = account.GetUsage();
+  EXPECT_EQ(20u, usage.total_bytes);
+  EXPECT_EQ(0u, usage.bytes_by_category.count(kCategoryA));
+
+  account.RemoveSource(&source2);
+}
+
+}  // namespace rtc
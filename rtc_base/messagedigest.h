@@ -54,7 +54,15 @@ bool IsFips180DigestAlgorithm(const std::string& alg);
 // successful, or 0 if |out_len| was too small.
 size_t ComputeDigest(MessageDigest* digest, const void* input, size_t in_len,
                      void* output, size_t out_len);
-// Like the previous function, but creates a digest implementation based on
+// Like the previous function, but authenticates |prefix_len| bytes of |prefix|
+// followed by |in_len| bytes of |input|, as if they were one contiguous
+// buffer. Lets callers that must patch a message header before hashing it
+// (e.g. STUN MESSAGE-INTEGRITY) avoid copying the whole message.
+size_t ComputeHmac(MessageDigest* digest, const void* key, size_t key_len,
+                   const void* prefix, size_t prefix_len,
+                   const void* input, size_t in_len,
+                   void* output, size_t out_len);
+// Like the first function, but creates a digest implementation based on
 // the desired digest name |alg|, e.g. DIGEST_SHA_1. Returns 0 if there is no
 // digest with the given name.
 size_t ComputeDigest(const std::string& alg, const void* input, size_t in_len,
@@ -10,6 +10,7 @@
 
 #include "rtc_base/messagedigest.h"
 #include "rtc_base/gunit.h"
+#include "rtc_base/openssldigest.h"
 #include "rtc_base/stringencode.h"
 
 namespace rtc {
@@ -148,4 +149,33 @@ TEST(MessageDigestTest, TestBadHmac) {
   EXPECT_EQ("", ComputeHmac("sha-9000", "key", "abc"));
 }
 
+// The precomputed HMAC agrees with ComputeHmac(), for keys shorter and longer
+// than a block, and when it is used more than once.
+TEST(MessageDigestTest, TestOpenSSLHmacMatchesComputeHmac) {
+  const std::string prefix("0123456789abcdefghij");
+  const std::string input(300, 'x');
+  for (const char* algorithm : {DIGEST_MD5, DIGEST_SHA_1, DIGEST_SHA_256}) {
+    for (size_t key_len : {0, 16, 64, 65, 200}) {
+      const std::string key(key_len, '\x5a');
+      OpenSSLHmac hmac(algorithm, key.data(), key.size());
+      ASSERT_LT(0U, hmac.Size());
+      std::string expected;
+      ASSERT_TRUE(ComputeHmac(algorithm, key, prefix + input, &expected));
+      for (int i = 0; i < 2; ++i) {
+        char output[64];
+        ASSERT_EQ(hmac.Size(),
+                  hmac.Compute(prefix.data(), prefix.size(), input.data(),
+                               input.size(), output, sizeof(output)));
+        EXPECT_EQ(expected, hex_encode(output, hmac.Size()));
+      }
+    }
+  }
+  OpenSSLHmac sha1("sha-1", "key", 3);
+  char output[20];
+  EXPECT_EQ(0U, sha1.Compute(nullptr, 0, "abc", 3, output, sizeof(output) - 1));
+  OpenSSLHmac bad("sha-9000", "key", 3);
+  EXPECT_EQ(0U, bad.Size());
+  EXPECT_EQ(0U, bad.Compute(nullptr, 0, "abc", 3, output, sizeof(output)));
+}
+
 }  // namespace rtc
@@ -14,6 +14,7 @@
 #include "rtc_base/logging.h"
 #include "rtc_base/messagequeue.h"
 #include "rtc_base/stringencode.h"
+#include "rtc_base/task_stats.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/trace_event.h"
 
@@ -170,11 +171,255 @@ void MessageQueueManager::ProcessAllMessageQueuesInternal() {
   }
 }
 
+//------------------------------------------------------------------
+// PostedMessageQueue
+
+namespace {
+
+const uint32_t kUnpooledNode = static_cast<uint32_t>(-1);
+
+// The free list head packs an ABA tag into the upper half and the index of
+// the first free node plus one (zero when empty) into the lower half.
+uint32_t FreeListIndex(uint64_t head) {
+  return static_cast<uint32_t>(head);
+}
+
+uint64_t FreeListHead(uint64_t previous, uint32_t index) {
+  return (((previous >> 32) + 1) << 32) | index;
+}
+
+}  // namespace
+
+struct PostedMessageQueue::Node {
+  Message msg;
+  // Link in the inbox.
+  std::atomic<Node*> next{nullptr};
+  // Link in the ready list.
+  Node* ready_next = nullptr;
+  // Link in the free list, as index plus one.
+  std::atomic<uint32_t> next_free{0};
+  uint32_t index = kUnpooledNode;
+};
+
+PostedMessageQueue::PostedMessageQueue()
+    : stub_(new Node()),
+      ready_head_(nullptr),
+      ready_tail_(nullptr),
+      size_(0),
+      free_head_(0),
+      num_chunks_(0) {
+  inbox_head_.store(stub_.get());
+  inbox_tail_ = stub_.get();
+  for (auto& chunk : chunks_)
+    chunk.store(nullptr);
+}
+
+PostedMessageQueue::~PostedMessageQueue() {
+  // Pooled nodes go away with their chunk; only overflow nodes are owned
+  // individually.
+  Drain();
+  while (ready_head_) {
+    Node* node = ready_head_;
+    ready_head_ = node->ready_next;
+    if (node->index == kUnpooledNode)
+      delete node;
+  }
+  for (auto& chunk : chunks_)
+    delete[] chunk.load();
+}
+
+void PostedMessageQueue::Push(const Message& msg) {
+  Node* node = AllocNode();
+  node->msg = msg;
+  // Count first, so that a consumer never sees more messages than counted.
+  size_.fetch_add(1, std::memory_order_relaxed);
+  PushInbox(node);
+}
+
+void PostedMessageQueue::Append(const Message& msg) {
+  Drain();
+  Node* node = AllocNode();
+  node->msg = msg;
+  node->ready_next = nullptr;
+  if (ready_tail_) {
+    ready_tail_->ready_next = node;
+  } else {
+    ready_head_ = node;
+  }
+  ready_tail_ = node;
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool PostedMessageQueue::Pop(Message* msg) {
+  if (!ready_head_)
+    Drain();
+  Node* node = ready_head_;
+  if (!node)
+    return false;
+  ready_head_ = node->ready_next;
+  if (!ready_head_)
+    ready_tail_ = nullptr;
+  *msg = node->msg;
+  size_.fetch_sub(1, std::memory_order_release);
+  FreeNode(node);
+  return true;
+}
+
+void PostedMessageQueue::Remove(MessageHandler* phandler,
+                                uint32_t id,
+                                MessageList* removed) {
+  Drain();
+  // Unlink everything first: deleting the data can destroy a handler, which
+  // clears its own messages re-entrantly.
+  Node* matched_head = nullptr;
+  Node* matched_tail = nullptr;
+  Node* prev = nullptr;
+  Node* node = ready_head_;
+  while (node) {
+    Node* next = node->ready_next;
+    if (node->msg.Match(phandler, id)) {
+      if (prev) {
+        prev->ready_next = next;
+      } else {
+        ready_head_ = next;
+      }
+      if (ready_tail_ == node)
+        ready_tail_ = prev;
+      node->ready_next = nullptr;
+      if (matched_tail) {
+        matched_tail->ready_next = node;
+      } else {
+        matched_head = node;
+      }
+      matched_tail = node;
+      size_.fetch_sub(1, std::memory_order_release);
+    } else {
+      prev = node;
+    }
+    node = next;
+  }
+
+  while (matched_head) {
+    node = matched_head;
+    matched_head = node->ready_next;
+    if (removed) {
+      removed->push_back(node->msg);
+    } else {
+      delete node->msg.pdata;
+    }
+    FreeNode(node);
+  }
+}
+
+void PostedMessageQueue::Drain() {
+  while (Node* node = PopInbox()) {
+    node->ready_next = nullptr;
+    if (ready_tail_) {
+      ready_tail_->ready_next = node;
+    } else {
+      ready_head_ = node;
+    }
+    ready_tail_ = node;
+  }
+}
+
+void PostedMessageQueue::PushInbox(Node* node) {
+  node->next.store(nullptr, std::memory_order_relaxed);
+  Node* prev = inbox_head_.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+PostedMessageQueue::Node* PostedMessageQueue::PopInbox() {
+  Node* tail = inbox_tail_;
+  Node* next = tail->next.load(std::memory_order_acquire);
+  if (tail == stub_.get()) {
+    if (!next)
+      return nullptr;
+    inbox_tail_ = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+  if (next) {
+    inbox_tail_ = next;
+    return tail;
+  }
+  // A producer has swapped the head but not linked its node yet. It wakes
+  // the socket server once it has, so we'll be back.
+  if (tail != inbox_head_.load(std::memory_order_acquire))
+    return nullptr;
+  PushInbox(stub_.get());
+  next = tail->next.load(std::memory_order_acquire);
+  if (next) {
+    inbox_tail_ = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+PostedMessageQueue::Node* PostedMessageQueue::NodeAt(uint32_t index) const {
+  Node* chunk = chunks_[index / kNodesPerChunk].load(std::memory_order_acquire);
+  return &chunk[index % kNodesPerChunk];
+}
+
+PostedMessageQueue::Node* PostedMessageQueue::AllocNode() {
+  uint64_t head = free_head_.load(std::memory_order_acquire);
+  while (FreeListIndex(head) != 0) {
+    Node* node = NodeAt(FreeListIndex(head) - 1);
+    uint64_t new_head =
+        FreeListHead(head, node->next_free.load(std::memory_order_relaxed));
+    if (free_head_.compare_exchange_weak(head, new_head,
+                                         std::memory_order_acquire,
+                                         std::memory_order_acquire)) {
+      return node;
+    }
+  }
+  return GrowPool();
+}
+
+PostedMessageQueue::Node* PostedMessageQueue::GrowPool() {
+  CritScope cs(&grow_crit_);
+  if (num_chunks_ == kMaxChunks) {
+    // Pathologically deep queue; stop pooling rather than hold on to the
+    // memory forever.
+    return new Node();
+  }
+  Node* chunk = new Node[kNodesPerChunk];
+  uint32_t base = static_cast<uint32_t>(num_chunks_ * kNodesPerChunk);
+  for (size_t i = 0; i < kNodesPerChunk; ++i) {
+    chunk[i].index = base + static_cast<uint32_t>(i);
+    chunk[i].next_free.store(base + static_cast<uint32_t>(i) + 2,
+                             std::memory_order_relaxed);
+  }
+  chunks_[num_chunks_].store(chunk, std::memory_order_release);
+  ++num_chunks_;
+  // Keep the first node, and publish the rest.
+  PushFreeList(&chunk[1], &chunk[kNodesPerChunk - 1]);
+  return &chunk[0];
+}
+
+void PostedMessageQueue::FreeNode(Node* node) {
+  node->msg = Message();
+  if (node->index == kUnpooledNode) {
+    delete node;
+    return;
+  }
+  PushFreeList(node, node);
+}
+
+void PostedMessageQueue::PushFreeList(Node* first, Node* last) {
+  uint64_t head = free_head_.load(std::memory_order_relaxed);
+  do {
+    last->next_free.store(FreeListIndex(head), std::memory_order_relaxed);
+  } while (!free_head_.compare_exchange_weak(head,
+                                             FreeListHead(head, first->index + 1),
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
 //------------------------------------------------------------------
 // MessageQueue
 MessageQueue::MessageQueue(SocketServer* ss, bool init_queue)
     : fPeekKeep_(false),
-      dmsgq_next_num_(0),
       fInitialized_(false),
       fDestroyed_(false),
       stop_(0),
@@ -297,21 +542,20 @@ bool MessageQueue::Get(Message *pmsg, int cmsWait, bool process_io) {
         // triggered and calculate the next trigger time.
         if (first_pass) {
           first_pass = false;
-          while (!dmsgq_.empty()) {
-            if (msCurrent < dmsgq_.top().msTrigger_) {
-              cmsDelayNext = TimeDiff(dmsgq_.top().msTrigger_, msCurrent);
-              break;
-            }
-            msgq_.push_back(dmsgq_.top().msg_);
-            dmsgq_.pop();
+          dmsgs_scratch_.clear();
+          dmsgq_.Advance(msCurrent, &dmsgs_scratch_);
+          for (TimerWheel::Entry* entry : dmsgs_scratch_) {
+            DelayedMessage* dmsg = static_cast<DelayedMessage*>(entry);
+            msgq_.Append(dmsg->msg_);
+            RecycleDelayedMessage(dmsg);
           }
+          int64_t msNext;
+          if (dmsgq_.NextExpiry(&msNext))
+            cmsDelayNext = std::max<int64_t>(0, TimeDiff(msNext, msCurrent));
         }
         // Pull a message off the message queue, if available.
-        if (msgq_.empty()) {
+        if (!msgq_.Pop(pmsg)) {
           break;
-        } else {
-          *pmsg = msgq_.front();
-          msgq_.pop_front();
         }
       }  // crit_ is released here.
 
@@ -377,22 +621,20 @@ void MessageQueue::Post(const Location& posted_from,
   if (IsQuitting())
     return;
 
-  // Keep thread safe
-  // Add the message to the end of the queue
+  // Add the message to the end of the queue; this is lock-free.
   // Signal for the multiplexer to return
 
-  {
-    CritScope cs(&crit_);
-    Message msg;
-    msg.posted_from = posted_from;
-    msg.phandler = phandler;
-    msg.message_id = id;
-    msg.pdata = pdata;
-    if (time_sensitive) {
-      msg.ts_sensitive = TimeMillis() + kMaxMsgLatency;
-    }
-    msgq_.push_back(msg);
+  Message msg;
+  msg.posted_from = posted_from;
+  msg.phandler = phandler;
+  msg.message_id = id;
+  msg.pdata = pdata;
+  if (time_sensitive) {
+    msg.ts_sensitive = TimeMillis() + kMaxMsgLatency;
   }
+  if (TaskStats::ShouldSample())
+    msg.ready_time_us = TimeMicros();
+  msgq_.Push(msg);
   WakeUpSocketServer();
 }
 
@@ -435,35 +677,55 @@ void MessageQueue::DoDelayPost(const Location& posted_from,
   }
 
   // Keep thread safe
-  // Add to the priority queue. Gets sorted soonest first.
+  // Add to the timer wheel. Expires soonest first.
   // Signal for the multiplexer to return.
 
   {
     CritScope cs(&crit_);
-    Message msg;
-    msg.posted_from = posted_from;
-    msg.phandler = phandler;
-    msg.message_id = id;
-    msg.pdata = pdata;
-    DelayedMessage dmsg(cmsDelay, tstamp, dmsgq_next_num_, msg);
-    dmsgq_.push(dmsg);
-    // If this message queue processes 1 message every millisecond for 50 days,
-    // we will wrap this number.  Even then, only messages with identical times
-    // will be misordered, and then only briefly.  This is probably ok.
-    ++dmsgq_next_num_;
-    RTC_DCHECK_NE(0, dmsgq_next_num_);
+    DelayedMessage* dmsg = NewDelayedMessage();
+    dmsg->cmsDelay_ = cmsDelay;
+    dmsg->msg_.posted_from = posted_from;
+    dmsg->msg_.phandler = phandler;
+    dmsg->msg_.message_id = id;
+    dmsg->msg_.pdata = pdata;
+    if (TaskStats::ShouldSample())
+      dmsg->msg_.ready_time_us = tstamp * kNumMicrosecsPerMillisec;
+    dmsgq_.Schedule(dmsg, tstamp);
   }
   WakeUpSocketServer();
 }
 
+DelayedMessage* MessageQueue::NewDelayedMessage() {
+  if (free_dmsgs_.empty())
+    return new DelayedMessage();
+  DelayedMessage* dmsg = free_dmsgs_.back().release();
+  free_dmsgs_.pop_back();
+  return dmsg;
+}
+
+void MessageQueue::RecycleDelayedMessage(DelayedMessage* dmsg) {
+  dmsg->msg_ = Message();
+  free_dmsgs_.emplace_back(dmsg);
+}
+
+void MessageQueue::SetTimerSlack(int slack_ms) {
+  {
+    CritScope cs(&crit_);
+    dmsgq_.set_slack_ms(slack_ms);
+  }
+  // The next trigger time may have moved.
+  WakeUpSocketServer();
+}
+
 int MessageQueue::GetDelay() {
   CritScope cs(&crit_);
 
   if (!msgq_.empty())
     return 0;
 
-  if (!dmsgq_.empty()) {
-    int delay = TimeUntil(dmsgq_.top().msTrigger_);
+  int64_t msNext;
+  if (dmsgq_.NextExpiry(&msNext)) {
+    int delay = static_cast<int>(TimeUntil(msNext));
     if (delay < 0)
       delay = 0;
     return delay;
@@ -490,50 +752,50 @@ void MessageQueue::Clear(MessageHandler* phandler,
 
   // Remove from ordered message queue
 
-  for (MessageList::iterator it = msgq_.begin(); it != msgq_.end();) {
-    if (it->Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(*it);
-      } else {
-        delete it->pdata;
-      }
-      it = msgq_.erase(it);
-    } else {
-      ++it;
-    }
-  }
+  msgq_.Remove(phandler, id, removed);
 
-  // Remove from priority queue. Not directly iterable, so use this approach
+  // Remove from the timer wheel
 
-  PriorityQueue::container_type::iterator new_end = dmsgq_.container().begin();
-  for (PriorityQueue::container_type::iterator it = new_end;
-       it != dmsgq_.container().end(); ++it) {
-    if (it->msg_.Match(phandler, id)) {
-      if (removed) {
-        removed->push_back(it->msg_);
-      } else {
-        delete it->msg_.pdata;
-      }
+  std::vector<TimerWheel::Entry*> cleared;
+  dmsgq_.CancelIf(
+      [phandler, id](TimerWheel::Entry* entry) {
+        return static_cast<DelayedMessage*>(entry)->msg_.Match(phandler, id);
+      },
+      &cleared);
+  for (TimerWheel::Entry* entry : cleared) {
+    DelayedMessage* dmsg = static_cast<DelayedMessage*>(entry);
+    if (removed) {
+      removed->push_back(dmsg->msg_);
     } else {
-      *new_end++ = *it;
+      delete dmsg->msg_.pdata;
     }
+    RecycleDelayedMessage(dmsg);
   }
-  dmsgq_.container().erase(new_end, dmsgq_.container().end());
-  dmsgq_.reheap();
 }
 
 void MessageQueue::Dispatch(Message *pmsg) {
   TRACE_EVENT2("webrtc", "MessageQueue::Dispatch", "src_file_and_line",
                pmsg->posted_from.file_and_line(), "src_func",
                pmsg->posted_from.function_name());
-  int64_t start_time = TimeMillis();
+  const int64_t ready_time_us = pmsg->ready_time_us;
+  const Location posted_from = pmsg->posted_from;
+  const int queue_depth = static_cast<int>(msgq_.size());
+  int64_t start_time_us = TimeMicros();
   pmsg->phandler->OnMessage(pmsg);
-  int64_t end_time = TimeMillis();
-  int64_t diff = TimeDiff(end_time, start_time);
+  int64_t end_time_us = TimeMicros();
+  int64_t diff = (end_time_us - start_time_us) / kNumMicrosecsPerMillisec;
   if (diff >= kSlowDispatchLoggingThreshold) {
     RTC_LOG(LS_INFO) << "Message took " << diff
                      << "ms to dispatch. Posted from: "
-                     << pmsg->posted_from.ToString();
+                     << posted_from.ToString();
+  }
+  if (ready_time_us) {
+    Thread* thread = Thread::Current();
+    TaskStats::AddSample(
+        thread == this ? thread->name() : std::string("MessageQueue"),
+        posted_from.function_name(), posted_from.file_and_line(),
+        start_time_us - ready_time_us, end_time_us - start_time_us,
+        queue_depth);
   }
 }
 
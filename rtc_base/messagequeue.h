@@ -14,9 +14,9 @@
 #include <string.h>
 
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <memory>
-#include <queue>
 #include <utility>
 #include <vector>
 
@@ -28,6 +28,7 @@
 #include "rtc_base/sigslot.h"
 #include "rtc_base/socketserver.h"
 #include "rtc_base/thread_annotations.h"
+#include "rtc_base/timerwheel.h"
 #include "rtc_base/timeutils.h"
 
 namespace rtc {
@@ -155,7 +156,11 @@ const uint32_t MQID_DISPOSE = static_cast<uint32_t>(-2);
 
 struct Message {
   Message()
-      : phandler(nullptr), message_id(0), pdata(nullptr), ts_sensitive(0) {}
+      : phandler(nullptr),
+        message_id(0),
+        pdata(nullptr),
+        ts_sensitive(0),
+        ready_time_us(0) {}
   inline bool Match(MessageHandler* handler, uint32_t id) const {
     return (handler == nullptr || handler == phandler) &&
            (id == MQID_ANY || id == message_id);
@@ -165,29 +170,86 @@ struct Message {
   uint32_t message_id;
   MessageData *pdata;
   int64_t ts_sensitive;
+  // When the message became ready to be dispatched, if TaskStats samples it.
+  // 0 otherwise.
+  int64_t ready_time_us;
 };
 
 typedef std::list<Message> MessageList;
 
-// DelayedMessage goes into a priority queue, sorted by trigger time.  Messages
-// with the same trigger time are processed in num_ (FIFO) order.
+// Queue of messages that are ready to be dispatched. Push() may be called from
+// any thread and is lock-free: posting links a recycled node into an intrusive
+// multi-producer single-consumer queue, so producers neither contend on a lock
+// nor allocate. All other methods consume and must be serialized by the
+// caller (MessageQueue does so with its |crit_|). Messages keep their post
+// order, and Append() orders after everything pushed before it.
+class PostedMessageQueue {
+ public:
+  PostedMessageQueue();
+  ~PostedMessageQueue();
+
+  // Any thread.
+  void Push(const Message& msg);
 
-class DelayedMessage {
+  // Consumer only.
+  void Append(const Message& msg);
+  bool Pop(Message* msg);
+  // Removes the messages matching |phandler| and |id|, moving them to
+  // |removed| if not null and deleting their data otherwise.
+  void Remove(MessageHandler* phandler, uint32_t id, MessageList* removed);
+
+  // Any thread. May be stale by the time it is used.
+  size_t size() const { return size_.load(std::memory_order_acquire); }
+  bool empty() const { return size() == 0u; }
+
+ private:
+  struct Node;
+
+  // Nodes are carved from chunks that live as long as the queue, and are
+  // recycled through a free list whose head carries an ABA tag next to the
+  // node index. Only growing the pool takes a lock.
+  static const size_t kNodesPerChunk = 256;
+  static const size_t kMaxChunks = 256;
+
+  Node* AllocNode();
+  Node* GrowPool();
+  void FreeNode(Node* node);
+  Node* NodeAt(uint32_t index) const;
+  void PushFreeList(Node* first, Node* last);
+
+  // Moves everything pushed so far onto the ready list.
+  void Drain();
+  Node* PopInbox();
+  void PushInbox(Node* node);
+
+  // Intrusive MPSC queue (D. Vyukov): producers exchange |inbox_head_|, the
+  // consumer walks from |inbox_tail_|. |stub_| keeps it non-empty.
+  std::atomic<Node*> inbox_head_;
+  Node* inbox_tail_;
+  std::unique_ptr<Node> stub_;
+
+  // Drained messages, in order. Consumer only.
+  Node* ready_head_;
+  Node* ready_tail_;
+
+  std::atomic<size_t> size_;
+
+  std::atomic<uint64_t> free_head_;
+  std::atomic<Node*> chunks_[kMaxChunks];
+  CriticalSection grow_crit_;
+  size_t num_chunks_ RTC_GUARDED_BY(grow_crit_);
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(PostedMessageQueue);
+};
+
+// DelayedMessage waits in a MessageQueue's timer wheel until its trigger
+// time. Messages with the same trigger time are processed in FIFO order.
+
+class DelayedMessage : public TimerWheel::Entry {
  public:
-  DelayedMessage(int64_t delay,
-                 int64_t trigger,
-                 uint32_t num,
-                 const Message& msg)
-      : cmsDelay_(delay), msTrigger_(trigger), num_(num), msg_(msg) {}
-
-  bool operator< (const DelayedMessage& dmsg) const {
-    return (dmsg.msTrigger_ < msTrigger_)
-           || ((dmsg.msTrigger_ == msTrigger_) && (dmsg.num_ < num_));
-  }
+  DelayedMessage() : cmsDelay_(0) {}
 
   int64_t cmsDelay_;  // for debugging
-  int64_t msTrigger_;
-  uint32_t num_;
   Message msg_;
 };
 
@@ -262,9 +324,14 @@ class MessageQueue {
   // Amount of time until the next message can be retrieved
   virtual int GetDelay();
 
+  // Lets delayed messages that trigger within |slack_ms| of each other be
+  // dispatched together, up to |slack_ms| - 1 ms late, instead of waking up
+  // for each one. Defaults to 0 (no slack).
+  void SetTimerSlack(int slack_ms);
+
   bool empty() const { return size() == 0u; }
   size_t size() const {
-    CritScope cs(&crit_);  // msgq_.size() is not thread safe.
+    CritScope cs(&crit_);  // dmsgq_.size() is not thread safe.
     return msgq_.size() + dmsgq_.size() + (fPeekKeep_ ? 1u : 0u);
   }
 
@@ -280,12 +347,6 @@ class MessageQueue {
   sigslot::signal0<> SignalQueueDestroyed;
 
  protected:
-  class PriorityQueue : public std::priority_queue<DelayedMessage> {
-   public:
-    container_type& container() { return c; }
-    void reheap() { make_heap(c.begin(), c.end(), comp); }
-  };
-
   void DoDelayPost(const Location& posted_from,
                    int64_t cmsDelay,
                    int64_t tstamp,
@@ -303,11 +364,21 @@ class MessageQueue {
 
   void WakeUpSocketServer();
 
+  DelayedMessage* NewDelayedMessage() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  void RecycleDelayedMessage(DelayedMessage* dmsg)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   bool fPeekKeep_;
   Message msgPeek_;
-  MessageList msgq_ RTC_GUARDED_BY(crit_);
-  PriorityQueue dmsgq_ RTC_GUARDED_BY(crit_);
-  uint32_t dmsgq_next_num_ RTC_GUARDED_BY(crit_);
+  // Posted without |crit_|; consumed with it held.
+  PostedMessageQueue msgq_;
+  TimerWheel dmsgq_ RTC_GUARDED_BY(crit_);
+  // Unscheduled DelayedMessages kept for reuse, so that posting a delayed
+  // message doesn't allocate.
+  std::vector<std::unique_ptr<DelayedMessage>> free_dmsgs_
+      RTC_GUARDED_BY(crit_);
+  // Expired or cleared timers, reused across calls.
+  std::vector<TimerWheel::Entry*> dmsgs_scratch_ RTC_GUARDED_BY(crit_);
   CriticalSection crit_;
   bool fInitialized_;
   bool fDestroyed_;
@@ -10,7 +10,10 @@
 
 #include "rtc_base/messagequeue.h"
 
+#include <algorithm>
 #include <functional>
+#include <string>
+#include <vector>
 
 #include "rtc_base/atomicops.h"
 #include "rtc_base/bind.h"
@@ -18,10 +21,12 @@
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/nullsocketserver.h"
+#include "rtc_base/platform_thread.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
 #include "rtc_base/thread.h"
 #include "rtc_base/timeutils.h"
+#include "test/testsupport/perf_test.h"
 
 using namespace rtc;
 
@@ -87,6 +92,31 @@ TEST_F(MessageQueueTest,
   DelayedPostsWithIdenticalTimesAreProcessedInFifoOrder(&q_nullss);
 }
 
+TEST(MessageQueueTimerSlackTest, CoalescesDelayedMessages) {
+  ScopedFakeClock clock;
+  clock.AdvanceTime(webrtc::TimeDelta::ms(1000));
+  NullSocketServer nullss;
+  // Not registered with the MessageQueueManager, which the fake clock would
+  // otherwise wait on to process its messages.
+  MessageQueue q(&nullss, false);
+  q.SetTimerSlack(10);
+  q.PostDelayed(RTC_FROM_HERE, 1, nullptr, 1);
+  q.PostDelayed(RTC_FROM_HERE, 9, nullptr, 2);
+  q.PostDelayed(RTC_FROM_HERE, 11, nullptr, 3);
+  // Both of the first two messages are dispatched on the 10 ms boundary.
+  EXPECT_EQ(10, q.GetDelay());
+
+  Message msg;
+  clock.AdvanceTime(webrtc::TimeDelta::ms(9));
+  EXPECT_FALSE(q.Get(&msg, 0));
+  clock.AdvanceTime(webrtc::TimeDelta::ms(1));
+  ASSERT_TRUE(q.Get(&msg, 0));
+  EXPECT_EQ(1u, msg.message_id);
+  ASSERT_TRUE(q.Get(&msg, 0));
+  EXPECT_EQ(2u, msg.message_id);
+  EXPECT_EQ(10, q.GetDelay());
+}
+
 TEST_F(MessageQueueTest, DisposeNotLocked) {
   bool was_locked = true;
   bool deleted = false;
@@ -246,3 +276,226 @@ TEST(MessageQueueManager, ClearReentrant) {
   t->Post(RTC_FROM_HERE, &handler, 0,
           new ScopedRefMessageData<RefCountedHandler>(inner_handler));
 }
+
+TEST(PostedMessageQueueTest, AppendOrdersAfterPushedMessages) {
+  PostedMessageQueue queue;
+  Message msg;
+  msg.message_id = 1;
+  queue.Push(msg);
+  msg.message_id = 2;
+  queue.Append(msg);
+  msg.message_id = 3;
+  queue.Push(msg);
+  EXPECT_EQ(3u, queue.size());
+
+  for (uint32_t id = 1; id <= 3; ++id) {
+    ASSERT_TRUE(queue.Pop(&msg));
+    EXPECT_EQ(id, msg.message_id);
+  }
+  EXPECT_FALSE(queue.Pop(&msg));
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(PostedMessageQueueTest, RemoveMatchingMessages) {
+  PostedMessageQueue queue;
+  EmptyHandler handler1;
+  EmptyHandler handler2;
+  Message msg;
+  for (uint32_t id = 0; id < 6; ++id) {
+    msg.phandler = (id % 2) ? &handler1 : &handler2;
+    msg.message_id = id;
+    msg.pdata = new TypedMessageData<int>(id);
+    queue.Push(msg);
+  }
+
+  MessageList removed;
+  queue.Remove(&handler1, MQID_ANY, &removed);
+  ASSERT_EQ(3u, removed.size());
+  for (Message& removed_msg : removed) {
+    EXPECT_EQ(&handler1, removed_msg.phandler);
+    delete removed_msg.pdata;
+  }
+  // Deletes the data itself.
+  queue.Remove(&handler2, 2, nullptr);
+  EXPECT_EQ(2u, queue.size());
+
+  ASSERT_TRUE(queue.Pop(&msg));
+  EXPECT_EQ(0u, msg.message_id);
+  delete msg.pdata;
+  ASSERT_TRUE(queue.Pop(&msg));
+  EXPECT_EQ(4u, msg.message_id);
+  delete msg.pdata;
+  EXPECT_FALSE(queue.Pop(&msg));
+}
+
+namespace {
+
+struct ProducerContext {
+  PostedMessageQueue* queue;
+  uint32_t producer;
+  uint32_t count;
+};
+
+void ProduceMessages(void* obj) {
+  ProducerContext* context = static_cast<ProducerContext*>(obj);
+  Message msg;
+  for (uint32_t seq = 0; seq < context->count; ++seq) {
+    msg.message_id = (context->producer << 24) | seq;
+    context->queue->Push(msg);
+  }
+}
+
+}  // namespace
+
+// Several producers push concurrently with the consumer popping. Every
+// message must come out exactly once, in per-producer order. Also grows the
+// node pool well past one chunk.
+TEST(PostedMessageQueueTest, ConcurrentProducersKeepOrder) {
+  const uint32_t kProducers = 4;
+  const uint32_t kMessagesPerProducer = 20000;
+  PostedMessageQueue queue;
+  std::vector<ProducerContext> contexts;
+  std::vector<std::unique_ptr<PlatformThread>> threads;
+  for (uint32_t i = 0; i < kProducers; ++i)
+    contexts.push_back({&queue, i, kMessagesPerProducer});
+  for (uint32_t i = 0; i < kProducers; ++i) {
+    threads.emplace_back(
+        new PlatformThread(&ProduceMessages, &contexts[i], "producer"));
+    threads.back()->Start();
+  }
+
+  std::vector<uint32_t> next_seq(kProducers, 0);
+  uint32_t received = 0;
+  Message msg;
+  while (received < kProducers * kMessagesPerProducer) {
+    if (!queue.Pop(&msg))
+      continue;
+    uint32_t producer = msg.message_id >> 24;
+    ASSERT_LT(producer, kProducers);
+    EXPECT_EQ(next_seq[producer], msg.message_id & 0xFFFFFF);
+    next_seq[producer] = (msg.message_id & 0xFFFFFF) + 1;
+    ++received;
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  EXPECT_FALSE(queue.Pop(&msg));
+  EXPECT_TRUE(queue.empty());
+}
+
+namespace {
+
+// Carried by the messages whose post-to-dispatch latency is sampled. The
+// poster waits for |ack| so that latency is measured without queueing delay.
+struct LatencyProbe : public MessageData {
+  LatencyProbe(int64_t posted_ns, Event* ack)
+      : posted_ns(posted_ns), ack(ack) {}
+  const int64_t posted_ns;
+  Event* const ack;
+};
+
+class CountingHandler : public MessageHandler {
+ public:
+  CountingHandler(uint32_t expected, Event* done)
+      : expected_(expected), done_(done) {}
+
+  void OnMessage(Message* msg) override {
+    if (msg->pdata) {
+      LatencyProbe* probe = static_cast<LatencyProbe*>(msg->pdata);
+      latencies_ns_.push_back(TimeNanos() - probe->posted_ns);
+      probe->ack->Set();
+      delete probe;
+    }
+    if (++received_ == expected_)
+      done_->Set();
+  }
+
+  std::vector<int64_t>* latencies_ns() { return &latencies_ns_; }
+
+ private:
+  const uint32_t expected_;
+  Event* const done_;
+  uint32_t received_ = 0;
+  std::vector<int64_t> latencies_ns_;
+};
+
+struct PosterContext {
+  Thread* target;
+  MessageHandler* handler;
+  uint32_t count;
+  bool wait_for_dispatch;
+};
+
+void PostMessages(void* obj) {
+  PosterContext* context = static_cast<PosterContext*>(obj);
+  Event ack(false, false);
+  for (uint32_t i = 0; i < context->count; ++i) {
+    if (context->wait_for_dispatch) {
+      context->target->Post(RTC_FROM_HERE, context->handler, 0,
+                            new LatencyProbe(TimeNanos(), &ack));
+      ack.Wait(Event::kForever);
+    } else {
+      context->target->Post(RTC_FROM_HERE, context->handler);
+    }
+  }
+}
+
+// Returns the time it took |producers| threads to get |total| messages
+// dispatched on a fresh consumer thread.
+int64_t RunPosters(uint32_t producers,
+                   uint32_t total,
+                   bool wait_for_dispatch,
+                   std::vector<int64_t>* latencies_ns) {
+  std::unique_ptr<Thread> consumer(Thread::Create());
+  consumer->Start();
+  Event done(false, false);
+  CountingHandler handler(total, &done);
+  std::vector<PosterContext> contexts(
+      producers,
+      {consumer.get(), &handler, total / producers, wait_for_dispatch});
+  std::vector<std::unique_ptr<PlatformThread>> threads;
+  int64_t start_ns = TimeNanos();
+  for (uint32_t i = 0; i < producers; ++i) {
+    threads.emplace_back(
+        new PlatformThread(&PostMessages, &contexts[i], "poster"));
+    threads.back()->Start();
+  }
+  EXPECT_TRUE(done.Wait(60000));
+  int64_t elapsed_ns = TimeNanos() - start_ns;
+  for (auto& thread : threads)
+    thread->Stop();
+  consumer->Stop();
+  if (latencies_ns)
+    latencies_ns->swap(*handler.latencies_ns());
+  return elapsed_ns;
+}
+
+}  // namespace
+
+// Measures cross-thread Post() throughput, with producers posting as fast as
+// they can, and post-to-dispatch latency, with each producer waiting for its
+// message to be dispatched before posting the next. Runs with 1, 4 and 16
+// producers feeding one consumer thread.
+TEST(MessageQueueBenchmark, DISABLED_CrossThreadPostThroughputAndLatency) {
+  const uint32_t kThroughputMessages = 1600000;
+  const uint32_t kLatencyMessages = 16000;
+  for (uint32_t producers : {1, 4, 16}) {
+    int64_t elapsed_ns =
+        RunPosters(producers, kThroughputMessages, false, nullptr);
+    std::vector<int64_t> latencies;
+    RunPosters(producers, kLatencyMessages, true, &latencies);
+    std::sort(latencies.begin(), latencies.end());
+    const std::string trace = std::to_string(producers) + "_producers";
+    webrtc::test::PrintResult(
+        "post_throughput", "", trace,
+        static_cast<double>(kThroughputMessages) * kNumNanosecsPerMillisec /
+            elapsed_ns,
+        "msgs/ms", false);
+    webrtc::test::PrintResult(
+        "post_to_dispatch_latency", "_p50", trace,
+        static_cast<double>(latencies[latencies.size() / 2]), "ns", false);
+    webrtc::test::PrintResult(
+        "post_to_dispatch_latency", "_p99", trace,
+        static_cast<double>(latencies[latencies.size() * 99 / 100]), "ns",
+        false);
+  }
+}
@@ -10,11 +10,18 @@
 
 #include "rtc_base/openssldigest.h"
 
+#include <string.h>
+
 #include "rtc_base/checks.h"
 #include "rtc_base/openssl.h"
 
 namespace rtc {
 
+namespace {
+// That of SHA-384 and SHA-512, the largest of the digests above.
+const size_t kMaxBlockSize = 128;
+}  // namespace
+
 OpenSSLDigest::OpenSSLDigest(const std::string& algorithm) {
   ctx_ = EVP_MD_CTX_new();
   RTC_CHECK(ctx_ != nullptr);
@@ -55,6 +62,78 @@ size_t OpenSSLDigest::Finish(void* buf, size_t len) {
   return md_len;
 }
 
+OpenSSLHmac::OpenSSLHmac(const std::string& algorithm,
+                         const void* key,
+                         size_t key_len) {
+  if (!OpenSSLDigest::GetDigestEVP(algorithm, &md_)) {
+    md_ = nullptr;
+    return;
+  }
+  const size_t block_len = EVP_MD_block_size(md_);
+  uint8_t new_key[kMaxBlockSize];
+  RTC_CHECK_LE(block_len, sizeof(new_key));
+  // Keys longer than a block are hashed first, as in ComputeHmac().
+  if (key_len > block_len) {
+    unsigned int md_len;
+    EVP_Digest(key, key_len, new_key, &md_len, md_, nullptr);
+    memset(new_key + md_len, 0, block_len - md_len);
+  } else {
+    memcpy(new_key, key, key_len);
+    memset(new_key + key_len, 0, block_len - key_len);
+  }
+  uint8_t i_pad[kMaxBlockSize];
+  uint8_t o_pad[kMaxBlockSize];
+  for (size_t i = 0; i < block_len; ++i) {
+    i_pad[i] = 0x36 ^ new_key[i];
+    o_pad[i] = 0x5c ^ new_key[i];
+  }
+  inner_ = EVP_MD_CTX_new();
+  outer_ = EVP_MD_CTX_new();
+  work_ = EVP_MD_CTX_new();
+  RTC_CHECK(inner_ && outer_ && work_);
+  EVP_DigestInit_ex(inner_, md_, nullptr);
+  EVP_DigestUpdate(inner_, i_pad, block_len);
+  EVP_DigestInit_ex(outer_, md_, nullptr);
+  EVP_DigestUpdate(outer_, o_pad, block_len);
+}
+
+OpenSSLHmac::~OpenSSLHmac() {
+  EVP_MD_CTX_destroy(inner_);
+  EVP_MD_CTX_destroy(outer_);
+  EVP_MD_CTX_destroy(work_);
+}
+
+size_t OpenSSLHmac::Size() const {
+  if (!md_) {
+    return 0;
+  }
+  return EVP_MD_size(md_);
+}
+
+size_t OpenSSLHmac::Compute(const void* prefix,
+                            size_t prefix_len,
+                            const void* input,
+                            size_t in_len,
+                            void* output,
+                            size_t out_len) {
+  if (!md_ || out_len < Size()) {
+    return 0;
+  }
+  uint8_t inner[EVP_MAX_MD_SIZE];
+  unsigned int md_len;
+  EVP_MD_CTX_copy_ex(work_, inner_);
+  if (prefix_len > 0) {
+    EVP_DigestUpdate(work_, prefix, prefix_len);
+  }
+  EVP_DigestUpdate(work_, input, in_len);
+  EVP_DigestFinal_ex(work_, inner, &md_len);
+  EVP_MD_CTX_copy_ex(work_, outer_);
+  EVP_DigestUpdate(work_, inner, md_len);
+  EVP_DigestFinal_ex(work_, static_cast<unsigned char*>(output), &md_len);
+  RTC_DCHECK(md_len == Size());
+  return md_len;
+}
+
 bool OpenSSLDigest::GetDigestEVP(const std::string& algorithm,
                                  const EVP_MD** mdp) {
   const EVP_MD* md;
@@ -13,6 +13,7 @@
 
 #include <openssl/evp.h>
 
+#include "rtc_base/constructormagic.h"
 #include "rtc_base/messagedigest.h"
 
 namespace rtc {
@@ -45,6 +46,37 @@ class OpenSSLDigest : public MessageDigest {
   const EVP_MD* md_;
 };
 
+// An HMAC whose key is hashed into the inner and outer pads once, so that
+// each Compute() only hashes the input and the inner digest, which is what
+// checking the MESSAGE-INTEGRITY of many STUN packets with one password is.
+// Not thread safe, since the contexts are shared between calls.
+class OpenSSLHmac {
+ public:
+  // |algorithm| is one of the DIGEST_ names. Size() is 0 if it isn't known.
+  OpenSSLHmac(const std::string& algorithm, const void* key, size_t key_len);
+  ~OpenSSLHmac();
+
+  // Returns the size of the HMAC, that of the digest.
+  size_t Size() const;
+  // Computes the HMAC of |prefix| followed by |input| into |output|, as
+  // ComputeHmac() does, returning the number of bytes written or 0.
+  size_t Compute(const void* prefix,
+                 size_t prefix_len,
+                 const void* input,
+                 size_t in_len,
+                 void* output,
+                 size_t out_len);
+
+ private:
+  const EVP_MD* md_ = nullptr;
+  // The contexts after hashing the inner and the outer pad.
+  EVP_MD_CTX* inner_ = nullptr;
+  EVP_MD_CTX* outer_ = nullptr;
+  EVP_MD_CTX* work_ = nullptr;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(OpenSSLHmac);
+};
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_OPENSSLDIGEST_H_
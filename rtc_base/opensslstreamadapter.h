@@ -93,6 +93,8 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
 
   int GetSslVersion() const override;
 
+  bool GetHandshakeDurationMs(int64_t* duration_ms) const override;
+
   // Key Extractor interface
   bool ExportKeyingMaterial(const std::string& label,
                             const uint8_t* context,
@@ -212,6 +214,11 @@ class OpenSSLStreamAdapter : public SSLStreamAdapter {
   // A 50-ms initial timeout ensures rapid setup on fast connections, but may
   // be too aggressive for low bandwidth links.
   int dtls_handshake_timeout_ms_ = 50;
+
+  // When BeginSSL() was called, and how long the handshake took once it
+  // completed; -1 if it hasn't.
+  int64_t handshake_start_ms_ = -1;
+  int64_t handshake_duration_ms_ = -1;
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,262 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/packetbufferallocator.h"
+
+#if defined(WEBRTC_POSIX)
+#include <pthread.h>
+#endif
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace rtc {
+
+const size_t PacketBufferAllocator::kSmallBufferCapacity;
+const size_t PacketBufferAllocator::kLargeBufferCapacity;
+const size_t PacketBufferAllocator::kMaxCachedSmallBuffers;
+const size_t PacketBufferAllocator::kMaxCachedLargeBuffers;
+
+namespace {
+
+using SizeClass = PacketBufferAllocator::SizeClass;
+const size_t kNumSizeClasses = PacketBufferAllocator::kNumSizeClasses;
+
+struct AtomicStats {
+  std::atomic<int64_t> hits{0};
+  std::atomic<int64_t> misses{0};
+  std::atomic<int64_t> cross_thread_frees{0};
+  std::atomic<int64_t> outstanding{0};
+  std::atomic<int64_t> high_water_mark{0};
+};
+
+std::atomic<bool> g_enabled{false};
+AtomicStats g_stats[kNumSizeClasses];
+
+size_t CapacityOf(SizeClass size_class) {
+  return size_class == PacketBufferAllocator::kSmall
+             ? PacketBufferAllocator::kSmallBufferCapacity
+             : PacketBufferAllocator::kLargeBufferCapacity;
+}
+
+size_t MaxCachedBuffers(SizeClass size_class) {
+  return size_class == PacketBufferAllocator::kSmall
+             ? PacketBufferAllocator::kMaxCachedSmallBuffers
+             : PacketBufferAllocator::kMaxCachedLargeBuffers;
+}
+
+void UpdateHighWaterMark(AtomicStats* stats, int64_t outstanding) {
+  int64_t high_water_mark =
+      stats->high_water_mark.load(std::memory_order_relaxed);
+  while (outstanding > high_water_mark &&
+         !stats->high_water_mark.compare_exchange_weak(
+             high_water_mark, outstanding, std::memory_order_relaxed)) {
+  }
+}
+
+class SlabBuffer;
+
+// The free slabs of one thread. Only the owning thread touches |local_|;
+// other threads hand slabs back through |remote_|.
+class ThreadCache : public RefCountInterface {
+ public:
+  ThreadCache() : owner_(CurrentThreadRef()) {}
+
+  SlabBuffer* Pop(SizeClass size_class) {
+    RTC_DCHECK(IsThreadRefEqual(owner_, CurrentThreadRef()));
+    std::vector<SlabBuffer*>& local = local_[size_class];
+    if (local.empty()) {
+      CritScope cs(&crit_);
+      local.swap(remote_[size_class]);
+    }
+    if (local.empty())
+      return nullptr;
+    SlabBuffer* buffer = local.back();
+    local.pop_back();
+    return buffer;
+  }
+
+  // Returns false if the caller should delete |buffer| instead.
+  bool Push(SlabBuffer* buffer, SizeClass size_class) {
+    // Thread refs can be reused once the owner has exited, so check that
+    // first.
+    if (!exited_.load(std::memory_order_acquire) &&
+        IsThreadRefEqual(owner_, CurrentThreadRef())) {
+      std::vector<SlabBuffer*>& local = local_[size_class];
+      if (local.size() >= MaxCachedBuffers(size_class))
+        return false;
+      local.push_back(buffer);
+      return true;
+    }
+    g_stats[size_class].cross_thread_frees.fetch_add(
+        1, std::memory_order_relaxed);
+    CritScope cs(&crit_);
+    if (exited_.load(std::memory_order_relaxed) ||
+        remote_[size_class].size() >= MaxCachedBuffers(size_class)) {
+      return false;
+    }
+    remote_[size_class].push_back(buffer);
+    return true;
+  }
+
+  // Called on the owning thread as it exits. Slabs that are still in use
+  // are deleted rather than cached when they are released.
+  void Shutdown();
+
+ protected:
+  ~ThreadCache() override {}
+
+ private:
+  const PlatformThreadRef owner_;
+  std::atomic<bool> exited_{false};
+  std::vector<SlabBuffer*> local_[kNumSizeClasses];
+  CriticalSection crit_;
+  std::vector<SlabBuffer*> remote_[kNumSizeClasses] RTC_GUARDED_BY(crit_);
+};
+
+class SlabBuffer : public RefCountedObject<Buffer> {
+ public:
+  SlabBuffer(scoped_refptr<ThreadCache> cache, SizeClass size_class)
+      : RefCountedObject<Buffer>(0, CapacityOf(size_class)),
+        cache_(std::move(cache)),
+        size_class_(size_class) {}
+
+  RefCountReleaseStatus Release() const override {
+    const auto status = ref_count_.DecRef();
+    if (status == RefCountReleaseStatus::kDroppedLastRef) {
+      g_stats[size_class_].outstanding.fetch_sub(1, std::memory_order_relaxed);
+      SlabBuffer* self = const_cast<SlabBuffer*>(this);
+      self->Clear();
+      // The owner of the last reference may have grown the buffer.
+      if (!cache_ || capacity() != CapacityOf(size_class_) ||
+          !cache_->Push(self, size_class_)) {
+        delete this;
+      }
+    }
+    return status;
+  }
+
+ private:
+  friend class ThreadCache;
+  ~SlabBuffer() override {}
+
+  const scoped_refptr<ThreadCache> cache_;
+  const SizeClass size_class_;
+};
+
+void ThreadCache::Shutdown() {
+  std::vector<SlabBuffer*> buffers;
+  {
+    CritScope cs(&crit_);
+    exited_.store(true, std::memory_order_release);
+    for (auto& remote : remote_) {
+      buffers.insert(buffers.end(), remote.begin(), remote.end());
+      remote.clear();
+    }
+  }
+  for (auto& local : local_) {
+    buffers.insert(buffers.end(), local.begin(), local.end());
+    local.clear();
+  }
+  for (SlabBuffer* buffer : buffers)
+    delete buffer;
+}
+
+#if defined(WEBRTC_POSIX)
+pthread_key_t g_thread_cache_tls = 0;
+
+void DeleteThreadCache(void* value) {
+  ThreadCache* cache = static_cast<ThreadCache*>(value);
+  cache->Shutdown();
+  cache->Release();
+}
+
+void InitializeThreadCacheTls() {
+  RTC_CHECK(pthread_key_create(&g_thread_cache_tls, &DeleteThreadCache) == 0);
+}
+#endif
+
+ThreadCache* CurrentThreadCache() {
+#if defined(WEBRTC_POSIX)
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK(pthread_once(&init_once, &InitializeThreadCacheTls) == 0);
+  ThreadCache* cache =
+      static_cast<ThreadCache*>(pthread_getspecific(g_thread_cache_tls));
+  if (!cache) {
+    cache = new RefCountedObject<ThreadCache>();
+    // Owned by the thread until it exits, see DeleteThreadCache().
+    cache->AddRef();
+    pthread_setspecific(g_thread_cache_tls, cache);
+  }
+  return cache;
+#else
+  return nullptr;
+#endif
+}
+
+}  // namespace
+
+void PacketBufferAllocator::SetEnabled(bool enabled) {
+  g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool PacketBufferAllocator::IsEnabled() {
+  return g_enabled.load(std::memory_order_relaxed);
+}
+
+CopyOnWriteBuffer PacketBufferAllocator::Allocate(size_t capacity) {
+  if (!IsEnabled() || capacity > kLargeBufferCapacity)
+    return CopyOnWriteBuffer(0, capacity);
+
+  const SizeClass size_class =
+      capacity <= kSmallBufferCapacity ? kSmall : kLarge;
+  AtomicStats& stats = g_stats[size_class];
+  ThreadCache* cache = CurrentThreadCache();
+  SlabBuffer* buffer = cache ? cache->Pop(size_class) : nullptr;
+  if (buffer) {
+    stats.hits.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    stats.misses.fetch_add(1, std::memory_order_relaxed);
+    buffer = new SlabBuffer(cache, size_class);
+  }
+  UpdateHighWaterMark(
+      &stats, stats.outstanding.fetch_add(1, std::memory_order_relaxed) + 1);
+  return CopyOnWriteBuffer(scoped_refptr<RefCountedObject<Buffer>>(buffer));
+}
+
+CopyOnWriteBuffer PacketBufferAllocator::Copy(const uint8_t* data,
+                                              size_t size) {
+  CopyOnWriteBuffer buffer = Allocate(size);
+  buffer.SetData(data, size);
+  return buffer;
+}
+
+PacketBufferAllocator::Stats PacketBufferAllocator::GetStats(
+    SizeClass size_class) {
+  RTC_DCHECK_LT(size_class, kNumSizeClasses);
+  const AtomicStats& stats = g_stats[size_class];
+  Stats result;
+  result.hits = stats.hits.load(std::memory_order_relaxed);
+  result.misses = stats.misses.load(std::memory_order_relaxed);
+  result.cross_thread_frees =
+      stats.cross_thread_frees.load(std::memory_order_relaxed);
+  result.outstanding = stats.outstanding.load(std::memory_order_relaxed);
+  result.high_water_mark =
+      stats.high_water_mark.load(std::memory_order_relaxed);
+  return result;
+}
+
+}  // namespace rtc
@@ -0,0 +1,79 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_PACKETBUFFERALLOCATOR_H_
+#define RTC_BASE_PACKETBUFFERALLOCATOR_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/copyonwritebuffer.h"
+
+namespace rtc {
+
+// Allocates CopyOnWriteBuffers for packet payloads from per-thread caches of
+// fixed-size slabs, to keep high rate packet producers on different threads
+// from contending in malloc.
+//
+// There are two size classes. A request is rounded up to the smallest class
+// that fits it, so the returned buffer may have more capacity than asked for.
+// Requests larger than the largest class, and all requests while the
+// allocator is disabled (the default), get a plain heap buffer of exactly the
+// requested capacity.
+//
+// When its last reference is dropped a slab goes back to the cache of the
+// thread that allocated it. Slabs released on another thread are queued on
+// that cache under a lock and picked up by its owner the next time its own
+// free slabs run out. Caches are freed when their thread exits.
+//
+// Per-thread caches are only implemented on POSIX; elsewhere every
+// allocation is counted as a miss.
+class PacketBufferAllocator {
+ public:
+  enum SizeClass { kSmall = 0, kLarge, kNumSizeClasses };
+
+  // Room for a packet filling a 1500 byte MTU plus SRTP and TURN overhead.
+  static const size_t kSmallBufferCapacity = 2048;
+  static const size_t kLargeBufferCapacity = 64 * 1024;
+  // Limits on the number of free slabs kept per thread and size class.
+  static const size_t kMaxCachedSmallBuffers = 256;
+  static const size_t kMaxCachedLargeBuffers = 8;
+
+  // Process-wide counters for one size class.
+  struct Stats {
+    // Allocations served from a thread cache.
+    int64_t hits = 0;
+    // Allocations that had to create a new slab.
+    int64_t misses = 0;
+    // Slabs released on a thread other than the one that allocated them.
+    int64_t cross_thread_frees = 0;
+    // Slabs currently referenced by a CopyOnWriteBuffer.
+    int64_t outstanding = 0;
+    // The largest value |outstanding| has reached.
+    int64_t high_water_mark = 0;
+  };
+
+  static void SetEnabled(bool enabled);
+  static bool IsEnabled();
+
+  // Returns an empty buffer with a capacity of at least |capacity| bytes.
+  static CopyOnWriteBuffer Allocate(size_t capacity);
+  // Returns a buffer holding a copy of |size| bytes from |data|.
+  static CopyOnWriteBuffer Copy(const uint8_t* data, size_t size);
+
+  static Stats GetStats(SizeClass size_class);
+
+ private:
+  PacketBufferAllocator() = delete;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_PACKETBUFFERALLOCATOR_H_
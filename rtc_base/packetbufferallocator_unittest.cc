@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/packetbufferallocator.h"
+
+#include <string.h>
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7};
+
+class PacketBufferAllocatorTest : public testing::Test {
+ protected:
+  PacketBufferAllocatorTest() { PacketBufferAllocator::SetEnabled(true); }
+  ~PacketBufferAllocatorTest() override {
+    PacketBufferAllocator::SetEnabled(false);
+  }
+};
+
+}  // namespace
+
+TEST(PacketBufferAllocatorDisabledTest, AllocatesExactCapacity) {
+  ASSERT_FALSE(PacketBufferAllocator::IsEnabled());
+  CopyOnWriteBuffer buffer = PacketBufferAllocator::Allocate(1200);
+  EXPECT_EQ(0u, buffer.size());
+  EXPECT_EQ(1200u, buffer.capacity());
+}
+
+TEST_F(PacketBufferAllocatorTest, RoundsUpToSizeClass) {
+  EXPECT_EQ(PacketBufferAllocator::kSmallBufferCapacity,
+            PacketBufferAllocator::Allocate(1200).capacity());
+  EXPECT_EQ(PacketBufferAllocator::kLargeBufferCapacity,
+            PacketBufferAllocator::Allocate(
+                PacketBufferAllocator::kSmallBufferCapacity + 1)
+                .capacity());
+  const size_t kOversize = PacketBufferAllocator::kLargeBufferCapacity + 1;
+  EXPECT_EQ(kOversize, PacketBufferAllocator::Allocate(kOversize).capacity());
+}
+
+TEST_F(PacketBufferAllocatorTest, ReusesReleasedBuffer) {
+  const uint8_t* data;
+  {
+    CopyOnWriteBuffer buffer =
+        PacketBufferAllocator::Copy(kTestData, sizeof(kTestData));
+    EXPECT_EQ(sizeof(kTestData), buffer.size());
+    EXPECT_EQ(0, memcmp(buffer.cdata(), kTestData, sizeof(kTestData)));
+    data = buffer.cdata();
+  }
+  const PacketBufferAllocator::Stats before =
+      PacketBufferAllocator::GetStats(PacketBufferAllocator::kSmall);
+  CopyOnWriteBuffer buffer = PacketBufferAllocator::Allocate(100);
+  EXPECT_EQ(data, buffer.cdata());
+  EXPECT_EQ(0u, buffer.size());
+  const PacketBufferAllocator::Stats after =
+      PacketBufferAllocator::GetStats(PacketBufferAllocator::kSmall);
+  EXPECT_EQ(before.hits + 1, after.hits);
+  EXPECT_EQ(before.misses, after.misses);
+  EXPECT_EQ(before.outstanding + 1, after.outstanding);
+}
+
+TEST_F(PacketBufferAllocatorTest, TracksHighWaterMark) {
+  const PacketBufferAllocator::Stats before =
+      PacketBufferAllocator::GetStats(PacketBufferAllocator::kLarge);
+  {
+    std::vector<CopyOnWriteBuffer> buffers;
+    for (int64_t i = 0; i < before.high_water_mark + 2; ++i) {
+      buffers.push_back(PacketBufferAllocator::Allocate(
+          PacketBufferAllocator::kLargeBufferCapacity));
+    }
+  }
+  const PacketBufferAllocator::Stats after =
+      PacketBufferAllocator::GetStats(PacketBufferAllocator::kLarge);
+  EXPECT_EQ(before.outstanding, after.outstanding);
+  EXPECT_GE(after.high_water_mark, before.high_water_mark + 2);
+}
+
+TEST_F(PacketBufferAllocatorTest, BufferFreedOnOtherThreadReturnsToOwner) {
+  std::unique_ptr<Thread> other = Thread::Create();
+  ASSERT_TRUE(other->Start());
+
+  CopyOnWriteBuffer buffer = PacketBufferAllocator::Allocate(100);
+  const uint8_t* data = buffer.cdata();
+  const PacketBufferAllocator::Stats before =
+      PacketBufferAllocator::GetStats(PacketBufferAllocator::kSmall);
+  other->Invoke<void>(RTC_FROM_HERE,
+                      [&buffer] { buffer = CopyOnWriteBuffer(); });
+  const PacketBufferAllocator::Stats after =
+      PacketBufferAllocator::GetStats(PacketBufferAllocator::kSmall);
+  EXPECT_EQ(before.cross_thread_frees + 1, after.cross_thread_frees);
+
+  buffer = PacketBufferAllocator::Allocate(100);
+  EXPECT_EQ(data, buffer.cdata());
+}
+
+TEST_F(PacketBufferAllocatorTest, BuffersOutliveTheirThread) {
+  CopyOnWriteBuffer buffer;
+  {
+    std::unique_ptr<Thread> other = Thread::Create();
+    ASSERT_TRUE(other->Start());
+    buffer = other->Invoke<CopyOnWriteBuffer>(RTC_FROM_HERE, [] {
+      return PacketBufferAllocator::Copy(kTestData, sizeof(kTestData));
+    });
+  }
+  EXPECT_EQ(0, memcmp(buffer.cdata(), kTestData, sizeof(kTestData)));
+}
+
+}  // namespace rtc
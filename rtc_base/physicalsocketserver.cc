@@ -42,6 +42,7 @@
 #include <errno.h>
 
 #include <algorithm>
+#include <atomic>
 #include <map>
 
 #include "rtc_base/arraysize.h"
@@ -104,6 +105,50 @@ typedef char* SockOptArg;
 
 namespace rtc {
 
+#if defined(WEBRTC_POSIX)
+// Upper bound on the number of buffers written by a single SendGathered()
+// call; stream sockets accept the remaining ones with the next call.
+static const size_t kMaxGatherBuffers = 16;
+#endif
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+// Upper bound on the number of datagrams written by a single sendmmsg() call.
+// This is also the kernel's limit on segments per UDP_SEGMENT message.
+static const size_t kMaxSendBatchSize = 64;
+// Largest payload of a single UDP_SEGMENT message.
+static const size_t kMaxSegmentedPayloadSize = 65000;
+
+#if !defined(SOL_UDP)
+#define SOL_UDP 17
+#endif
+#if !defined(UDP_SEGMENT)
+#define UDP_SEGMENT 103
+#endif
+
+// Returns true if |datagrams| can be sent as one UDP_SEGMENT message: they
+// share a destination and all but the last have the same size, which is
+// larger than or equal to the size of the last one.
+static bool CanSegmentDatagrams(const OutgoingDatagram* datagrams,
+                                size_t count) {
+  size_t segment_size = datagrams[0].length;
+  if (segment_size == 0)
+    return false;
+  size_t total_size = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const OutgoingDatagram& datagram = datagrams[i];
+    if (!(datagram.destination == datagrams[0].destination))
+      return false;
+    bool last = (i + 1 == count);
+    if (last ? datagram.length > segment_size || datagram.length == 0
+             : datagram.length != segment_size) {
+      return false;
+    }
+    total_size += datagram.length;
+  }
+  return total_size <= kMaxSegmentedPayloadSize;
+}
+#endif
+
 std::unique_ptr<SocketServer> SocketServer::CreateDefault() {
 #if defined(__native_client__)
   return std::unique_ptr<SocketServer>(new rtc::NullSocketServer);
@@ -333,6 +378,9 @@ int PhysicalSocket::Send(const void* pv, size_t cb) {
   MaybeRemapSendError();
   // We have seen minidumps where this may be false.
   RTC_DCHECK(sent <= static_cast<int>(cb));
+  if (sent < 0 && IsBlockingError(GetError())) {
+    edge_writable_ = false;
+  }
   if ((sent > 0 && sent < static_cast<int>(cb)) ||
       (sent < 0 && IsBlockingError(GetError()))) {
     EnableEvents(DE_WRITE);
@@ -358,6 +406,9 @@ int PhysicalSocket::SendTo(const void* buffer,
   MaybeRemapSendError();
   // We have seen minidumps where this may be false.
   RTC_DCHECK(sent <= static_cast<int>(length));
+  if (sent < 0 && IsBlockingError(GetError())) {
+    edge_writable_ = false;
+  }
   if ((sent > 0 && sent < static_cast<int>(length)) ||
       (sent < 0 && IsBlockingError(GetError()))) {
     EnableEvents(DE_WRITE);
@@ -385,6 +436,9 @@ int PhysicalSocket::Recv(void* buffer, size_t length, int64_t* timestamp) {
   UpdateLastError();
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
+  if (received < 0 && IsBlockingError(error)) {
+    edge_readable_ = false;
+  }
   if (udp_ || success) {
     EnableEvents(DE_READ);
   }
@@ -411,6 +465,9 @@ int PhysicalSocket::RecvFrom(void* buffer,
     SocketAddressFromSockAddrStorage(addr_storage, out_addr);
   int error = GetError();
   bool success = (received >= 0) || IsBlockingError(error);
+  if (received < 0 && IsBlockingError(error)) {
+    edge_readable_ = false;
+  }
   if (udp_ || success) {
     EnableEvents(DE_READ);
   }
@@ -420,6 +477,191 @@ int PhysicalSocket::RecvFrom(void* buffer,
   return received;
 }
 
+int PhysicalSocket::RecvFromBatch(ReceivedDatagram* datagrams, size_t count) {
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (!udp_)
+    return Socket::RecvFromBatch(datagrams, count);
+  count = std::min(count, Socket::kMaxRecvBatchSize);
+  mmsghdr msgs[Socket::kMaxRecvBatchSize];
+  iovec iovecs[Socket::kMaxRecvBatchSize][2];
+  sockaddr_storage addrs[Socket::kMaxRecvBatchSize];
+  memset(msgs, 0, count * sizeof(msgs[0]));
+  for (size_t i = 0; i < count; ++i) {
+    iovecs[i][0].iov_base = datagrams[i].buffer;
+    iovecs[i][0].iov_len = datagrams[i].buffer_size;
+    iovecs[i][1].iov_base = datagrams[i].overflow_buffer;
+    iovecs[i][1].iov_len = datagrams[i].overflow_buffer_size;
+    msgs[i].msg_hdr.msg_iov = iovecs[i];
+    msgs[i].msg_hdr.msg_iovlen = datagrams[i].overflow_buffer ? 2 : 1;
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i]);
+  }
+  int received = ::recvmmsg(s_, msgs, static_cast<unsigned int>(count),
+                            MSG_DONTWAIT, nullptr);
+  // SIOCGSTAMP only reports the time of the last datagram, which is the best
+  // approximation available for every datagram of the batch.
+  int64_t timestamp = received > 0 ? GetSocketRecvTimestamp(s_) : -1;
+  UpdateLastError();
+  for (int i = 0; i < received; ++i) {
+    ReceivedDatagram& datagram = datagrams[i];
+    datagram.length = msgs[i].msg_len;
+    datagram.truncated = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    datagram.timestamp = timestamp;
+    SocketAddressFromSockAddrStorage(addrs[i], &datagram.source);
+  }
+  int error = GetError();
+  bool success = (received >= 0) || IsBlockingError(error);
+  if (received < 0 && IsBlockingError(error)) {
+    edge_readable_ = false;
+  }
+  EnableEvents(DE_READ);
+  if (!success) {
+    RTC_LOG_F(LS_VERBOSE) << "Error = " << error;
+  }
+  return received;
+#else
+  return Socket::RecvFromBatch(datagrams, count);
+#endif
+}
+
+int PhysicalSocket::SendToBatch(const OutgoingDatagram* datagrams,
+                                size_t count) {
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  if (!udp_ || count <= 1)
+    return Socket::SendToBatch(datagrams, count);
+  count = std::min(count, kMaxSendBatchSize);
+  if (udp_gso_supported_ && CanSegmentDatagrams(datagrams, count)) {
+    int sent = SendSegmented(datagrams, count);
+    // SendSegmented() clears |udp_gso_supported_| and leaves the datagrams
+    // unsent if segmentation is unavailable; retry them with sendmmsg().
+    if (sent >= 0 || udp_gso_supported_)
+      return sent;
+  }
+  return SendMultiple(datagrams, count);
+#else
+  return Socket::SendToBatch(datagrams, count);
+#endif
+}
+
+int PhysicalSocket::SendGathered(const OutgoingBuffer* buffers,
+                                 size_t count) {
+#if defined(WEBRTC_POSIX)
+  if (udp_ || count <= 1)
+    return Socket::SendGathered(buffers, count);
+  count = std::min(count, kMaxGatherBuffers);
+  iovec iovecs[kMaxGatherBuffers];
+  size_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    iovecs[i].iov_base = const_cast<void*>(buffers[i].data);
+    iovecs[i].iov_len = buffers[i].length;
+    total += buffers[i].length;
+  }
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iovecs;
+  msg.msg_iovlen = count;
+  int sent = static_cast<int>(::sendmsg(s_, &msg,
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+                                        // Suppress SIGPIPE, see Send().
+                                        MSG_NOSIGNAL
+#else
+                                        0
+#endif
+                                        ));
+  UpdateLastError();
+  MaybeRemapSendError();
+  if (sent < 0 && IsBlockingError(GetError())) {
+    edge_writable_ = false;
+  }
+  if ((sent > 0 && static_cast<size_t>(sent) < total) ||
+      (sent < 0 && IsBlockingError(GetError()))) {
+    EnableEvents(DE_WRITE);
+  }
+  return sent;
+#else
+  return Socket::SendGathered(buffers, count);
+#endif
+}
+
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+int PhysicalSocket::SendSegmented(const OutgoingDatagram* datagrams,
+                                  size_t count) {
+  iovec iovecs[kMaxSendBatchSize];
+  for (size_t i = 0; i < count; ++i) {
+    iovecs[i].iov_base = const_cast<void*>(datagrams[i].data);
+    iovecs[i].iov_len = datagrams[i].length;
+  }
+  sockaddr_storage saddr;
+  size_t addr_len = datagrams[0].destination.ToSockAddrStorage(&saddr);
+  char control[CMSG_SPACE(sizeof(uint16_t))];
+  memset(control, 0, sizeof(control));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_name = &saddr;
+  msg.msg_namelen = static_cast<socklen_t>(addr_len);
+  msg.msg_iov = iovecs;
+  msg.msg_iovlen = count;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type = UDP_SEGMENT;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+  uint16_t segment_size = static_cast<uint16_t>(datagrams[0].length);
+  memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+
+  int sent = ::sendmsg(s_, &msg, MSG_NOSIGNAL);
+  UpdateLastError();
+  if (sent < 0) {
+    int error = GetError();
+    // EIO: the device cannot checksum segments. EINVAL/ENOPROTOOPT: the
+    // kernel predates UDP_SEGMENT.
+    if (error == EIO || error == EINVAL || error == ENOPROTOOPT) {
+      RTC_LOG(LS_INFO) << "UDP GSO unavailable (" << error
+                       << "), falling back to sendmmsg.";
+      udp_gso_supported_ = false;
+      return SOCKET_ERROR;
+    }
+    MaybeRemapSendError();
+    if (IsBlockingError(GetError())) {
+      edge_writable_ = false;
+      EnableEvents(DE_WRITE);
+    }
+    return SOCKET_ERROR;
+  }
+  return static_cast<int>(count);
+}
+
+int PhysicalSocket::SendMultiple(const OutgoingDatagram* datagrams,
+                                 size_t count) {
+  mmsghdr msgs[kMaxSendBatchSize];
+  iovec iovecs[kMaxSendBatchSize];
+  sockaddr_storage addrs[kMaxSendBatchSize];
+  memset(msgs, 0, count * sizeof(msgs[0]));
+  for (size_t i = 0; i < count; ++i) {
+    iovecs[i].iov_base = const_cast<void*>(datagrams[i].data);
+    iovecs[i].iov_len = datagrams[i].length;
+    size_t addr_len = datagrams[i].destination.ToSockAddrStorage(&addrs[i]);
+    msgs[i].msg_hdr.msg_name = &addrs[i];
+    msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(addr_len);
+    msgs[i].msg_hdr.msg_iov = &iovecs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int sent = ::sendmmsg(s_, msgs, static_cast<unsigned int>(count),
+                        MSG_NOSIGNAL);
+  UpdateLastError();
+  MaybeRemapSendError();
+  if (sent < 0 && IsBlockingError(GetError())) {
+    edge_writable_ = false;
+  }
+  if ((sent >= 0 && sent < static_cast<int>(count)) ||
+      (sent < 0 && IsBlockingError(GetError()))) {
+    EnableEvents(DE_WRITE);
+  }
+  return sent;
+}
+#endif
+
 int PhysicalSocket::Listen(int backlog) {
   int err = ::listen(s_, backlog);
   UpdateLastError();
@@ -563,6 +805,24 @@ int PhysicalSocket::TranslateOption(Option opt, int* slevel, int* sopt) {
       return -1;
     case OPT_RTP_SENDTIME_EXTN_ID:
       return -1;  // No logging is necessary as this not a OS socket option.
+    case OPT_REUSEPORT:
+#if defined(WEBRTC_POSIX) && defined(SO_REUSEPORT)
+      *slevel = SOL_SOCKET;
+      *sopt = SO_REUSEPORT;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_REUSEPORT not supported.";
+      return -1;
+#endif
+    case OPT_NOTSENT_LOWAT:
+#if defined(WEBRTC_POSIX) && defined(TCP_NOTSENT_LOWAT)
+      *slevel = IPPROTO_TCP;
+      *sopt = TCP_NOTSENT_LOWAT;
+      break;
+#else
+      RTC_LOG(LS_WARNING) << "Socket::OPT_NOTSENT_LOWAT not supported.";
+      return -1;
+#endif
     default:
       RTC_NOTREACHED();
       return -1;
@@ -609,6 +869,21 @@ bool SocketDispatcher::Initialize() {
   // this socket option, SIGPIPE will be disabled for the socket.
   int value = 1;
   ::setsockopt(s_, SOL_SOCKET, SO_NOSIGPIPE, &value, sizeof(value));
+#endif
+#if defined(WEBRTC_USE_EPOLL)
+  edge_triggered_ = udp_ && ss_->epoll_edge_triggered();
+  edge_readable_ = false;
+  edge_writable_ = false;
+#if defined(SO_BUSY_POLL)
+  int busy_poll_us = ss_->busy_poll_us();
+  if (udp_ && busy_poll_us > 0 &&
+      setsockopt(s_, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us,
+                 sizeof(busy_poll_us)) < 0) {
+    // Raising the busy poll time above net.core.busy_read needs
+    // CAP_NET_ADMIN; Wait() still busy polls without it.
+    RTC_LOG(LS_VERBOSE) << "Failed to set SO_BUSY_POLL, error " << errno;
+  }
+#endif
 #endif
   ss_->Add(this);
   return true;
@@ -773,6 +1048,15 @@ void SocketDispatcher::OnEvent(uint32_t ff, int err) {
   // keep a list of events to disable at the end of the method. This list
   // would not be updated with the events enabled by the signal handlers.
   StartBatchedEventUpdates();
+  if (edge_triggered_) {
+    // Remember the readiness reported by the edge until an operation would
+    // block, and only deliver the events that are currently requested.
+    if ((ff & DE_READ) != 0)
+      edge_readable_ = true;
+    if ((ff & DE_WRITE) != 0)
+      edge_writable_ = true;
+    ff &= enabled_events() | DE_CLOSE;
+  }
 #endif
   // Make sure we deliver connect/accept first. Otherwise, consumers may see
   // something like a READ followed by a CONNECT, which would be odd.
@@ -830,8 +1114,24 @@ void SocketDispatcher::FinishBatchedEventUpdates() {
 }
 
 void SocketDispatcher::MaybeUpdateDispatcher(uint8_t old_events) {
-  if (GetEpollEvents(enabled_events()) != GetEpollEvents(old_events) &&
-      saved_enabled_events_ == -1) {
+  if (saved_enabled_events_ != -1) {
+    // Inside OnEvent(), FinishBatchedEventUpdates() will do the update.
+    return;
+  }
+  if (edge_triggered_) {
+    // The epoll registration never changes. Instead, readiness that no edge
+    // will report again has to be delivered by the socket server directly.
+    uint32_t ready = 0;
+    if (edge_readable_)
+      ready |= DE_READ;
+    if (edge_writable_)
+      ready |= DE_WRITE;
+    ready &= enabled_events();
+    if (ready != 0)
+      ss_->ScheduleEdgeTriggeredEvents(this, ready);
+    return;
+  }
+  if (GetEpollEvents(enabled_events()) != GetEpollEvents(old_events)) {
     ss_->Update(this);
   }
 }
@@ -854,6 +1154,10 @@ void SocketDispatcher::DisableEvents(uint8_t events) {
   MaybeUpdateDispatcher(old_events);
 }
 
+bool SocketDispatcher::IsEdgeTriggered() {
+  return edge_triggered_;
+}
+
 #endif  // WEBRTC_USE_EPOLL
 
 int SocketDispatcher::Close() {
@@ -883,13 +1187,15 @@ class EventDispatcher : public Dispatcher {
     close(afd_[1]);
   }
 
+  // Lock-free, since every MessageQueue::Post() lands here. The pipe holds
+  // one byte for each time |fSignaled_| went from false to true and hasn't
+  // been reset yet, so a signal racing with OnPreEvent() leaves its byte
+  // behind and the next wait returns immediately.
   virtual void Signal() {
-    CritScope cs(&crit_);
-    if (!fSignaled_) {
+    if (!fSignaled_.exchange(true, std::memory_order_acq_rel)) {
       const uint8_t b[1] = {0};
       const ssize_t res = write(afd_[1], b, sizeof(b));
       RTC_DCHECK_EQ(1, res);
-      fSignaled_ = true;
     }
   }
 
@@ -899,12 +1205,10 @@ class EventDispatcher : public Dispatcher {
     // It is not possible to perfectly emulate an auto-resetting event with
     // pipes.  This simulates it by resetting before the event is handled.
 
-    CritScope cs(&crit_);
-    if (fSignaled_) {
-      uint8_t b[4];  // Allow for reading more than 1 byte, but expect 1.
+    if (fSignaled_.exchange(false, std::memory_order_acq_rel)) {
+      uint8_t b[1];
       const ssize_t res = read(afd_[0], b, sizeof(b));
       RTC_DCHECK_EQ(1, res);
-      fSignaled_ = false;
     }
   }
 
@@ -917,8 +1221,7 @@ class EventDispatcher : public Dispatcher {
  private:
   PhysicalSocketServer *ss_;
   int afd_[2];
-  bool fSignaled_;
-  CriticalSection crit_;
+  std::atomic<bool> fSignaled_;
 };
 
 // These two classes use the self-pipe trick to deliver POSIX signals to our
@@ -1181,13 +1484,11 @@ class Signaler : public EventDispatcher {
 PhysicalSocketServer::PhysicalSocketServer()
     : fWait_(false) {
 #if defined(WEBRTC_USE_EPOLL)
-  // Since Linux 2.6.8, the size argument is ignored, but must be greater than
-  // zero. Before that the size served as hint to the kernel for the amount of
-  // space to initially allocate in internal data structures.
-  epoll_fd_ = epoll_create(FD_SETSIZE);
+  // The epoll instance grows on demand, so no size hint is needed.
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
   if (epoll_fd_ == -1) {
     // Not an error, will fall back to "select" below.
-    RTC_LOG_E(LS_WARNING, EN, errno) << "epoll_create";
+    RTC_LOG_E(LS_WARNING, EN, errno) << "epoll_create1";
     epoll_fd_ = INVALID_SOCKET;
   }
 #endif
@@ -1292,6 +1593,7 @@ void PhysicalSocketServer::Remove(Dispatcher *pdispatcher) {
   if (epoll_fd_ != INVALID_SOCKET) {
     RemoveEpoll(pdispatcher);
   }
+  edge_triggered_ready_.erase(pdispatcher);
 #endif  // WEBRTC_USE_EPOLL
 }
 
@@ -1310,6 +1612,14 @@ void PhysicalSocketServer::Update(Dispatcher* pdispatcher) {
 #endif
 }
 
+#if defined(WEBRTC_USE_EPOLL)
+void PhysicalSocketServer::ScheduleEdgeTriggeredEvents(Dispatcher* pdispatcher,
+                                                       uint32_t events) {
+  CritScope cs(&crit_);
+  edge_triggered_ready_[pdispatcher] |= events;
+}
+#endif  // WEBRTC_USE_EPOLL
+
 void PhysicalSocketServer::AddRemovePendingDispatchers() {
   if (!pending_add_dispatchers_.empty()) {
     for (Dispatcher* pdispatcher : pending_add_dispatchers_) {
@@ -1543,7 +1853,12 @@ void PhysicalSocketServer::AddEpoll(Dispatcher* pdispatcher) {
   }
 
   struct epoll_event event = {0};
-  event.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  if (pdispatcher->IsEdgeTriggered()) {
+    // Register for everything once; SocketDispatcher filters the events.
+    event.events = EPOLLIN | EPOLLOUT | EPOLLET;
+  } else {
+    event.events = GetEpollEvents(pdispatcher->GetRequestedEvents());
+  }
   event.data.ptr = pdispatcher;
   int err = epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event);
   RTC_DCHECK_EQ(err, 0);
@@ -1577,7 +1892,7 @@ void PhysicalSocketServer::UpdateEpoll(Dispatcher* pdispatcher) {
   RTC_DCHECK(epoll_fd_ != INVALID_SOCKET);
   int fd = pdispatcher->GetDescriptor();
   RTC_DCHECK(fd != INVALID_SOCKET);
-  if (fd == INVALID_SOCKET) {
+  if (fd == INVALID_SOCKET || pdispatcher->IsEdgeTriggered()) {
     return;
   }
 
@@ -1608,13 +1923,36 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
   fWait_ = true;
 
   while (fWait_) {
+    // Don't block while edge-triggered dispatchers still have events that the
+    // kernel won't report again.
+    bool has_ready_events;
+    {
+      CritScope cr(&crit_);
+      has_ready_events = !edge_triggered_ready_.empty();
+    }
     // Wait then call handlers as appropriate
     // < 0 means error
     // 0 means timeout
     // > 0 means count of descriptors ready
-    int n = epoll_wait(epoll_fd_, &epoll_events_[0],
-                       static_cast<int>(epoll_events_.size()),
-                       static_cast<int>(tvWait));
+    int timeout_ms = has_ready_events ? 0 : static_cast<int>(tvWait);
+    int n = 0;
+    if (timeout_ms != 0 && busy_poll_us_ > 0) {
+      // Spin without blocking first, see set_busy_poll_us(). WakeUp() makes
+      // the signaler readable, so it ends the spin like any other event.
+      int64_t spin_stop_us = TimeMicros() + busy_poll_us_;
+      if (timeout_ms > 0) {
+        spin_stop_us = std::min(
+            spin_stop_us, TimeMicros() + timeout_ms * kNumMicrosecsPerMillisec);
+      }
+      do {
+        n = epoll_wait(epoll_fd_, &epoll_events_[0],
+                       static_cast<int>(epoll_events_.size()), 0);
+      } while (n == 0 && TimeMicros() < spin_stop_us);
+    }
+    if (n == 0) {
+      n = epoll_wait(epoll_fd_, &epoll_events_[0],
+                     static_cast<int>(epoll_events_.size()), timeout_ms);
+    }
     if (n < 0) {
       if (errno != EINTR) {
         RTC_LOG_E(LS_ERROR, EN, errno) << "epoll";
@@ -1624,33 +1962,37 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
       // signals managed by this PhysicalSocketServer, the
       // PosixSignalDeliveryDispatcher will be in the signaled state in the next
       // iteration.
-    } else if (n == 0) {
+    } else if (n == 0 && !has_ready_events) {
       // If timeout, return success
       return true;
     } else {
       // We have signaled descriptors
-      CritScope cr(&crit_);
-      for (int i = 0; i < n; ++i) {
-        const epoll_event& event = epoll_events_[i];
-        Dispatcher* pdispatcher = static_cast<Dispatcher*>(event.data.ptr);
-        if (dispatchers_.find(pdispatcher) == dispatchers_.end()) {
-          // The dispatcher for this socket no longer exists.
-          continue;
-        }
+      {
+        CritScope cr(&crit_);
+        for (int i = 0; i < n; ++i) {
+          const epoll_event& event = epoll_events_[i];
+          Dispatcher* pdispatcher = static_cast<Dispatcher*>(event.data.ptr);
+          if (dispatchers_.find(pdispatcher) == dispatchers_.end()) {
+            // The dispatcher for this socket no longer exists.
+            continue;
+          }
 
-        bool readable = (event.events & (EPOLLIN | EPOLLPRI));
-        bool writable = (event.events & EPOLLOUT);
-        bool check_error = (event.events & (EPOLLRDHUP | EPOLLERR | EPOLLHUP));
+          bool readable = (event.events & (EPOLLIN | EPOLLPRI));
+          bool writable = (event.events & EPOLLOUT);
+          bool check_error =
+              (event.events & (EPOLLRDHUP | EPOLLERR | EPOLLHUP));
 
-        ProcessEvents(pdispatcher, readable, writable, check_error);
+          ProcessEvents(pdispatcher, readable, writable, check_error);
+        }
       }
+      ProcessEdgeTriggeredReadyEvents();
     }
 
     if (static_cast<size_t>(n) == epoll_events_.size() &&
         epoll_events_.size() < kMaxEpollEvents) {
       // We used the complete space to receive events, increase size for future
       // iterations.
-      epoll_events_.resize(std::max(epoll_events_.size() * 2, kMaxEpollEvents));
+      epoll_events_.resize(std::min(epoll_events_.size() * 2, kMaxEpollEvents));
     }
 
     if (cmsWait != kForever) {
@@ -1665,6 +2007,31 @@ bool PhysicalSocketServer::WaitEpoll(int cmsWait) {
   return true;
 }
 
+void PhysicalSocketServer::ProcessEdgeTriggeredReadyEvents() {
+  // The handlers run on a copy of the ready list, without |crit_| held.
+  // Events they schedule are delivered on the next iteration so that a busy
+  // socket can't starve the others.
+  {
+    CritScope cr(&crit_);
+    edge_triggered_processing_.assign(edge_triggered_ready_.begin(),
+                                      edge_triggered_ready_.end());
+    edge_triggered_ready_.clear();
+  }
+  for (const auto& entry : edge_triggered_processing_) {
+    Dispatcher* pdispatcher = entry.first;
+    {
+      CritScope cr(&crit_);
+      if (dispatchers_.find(pdispatcher) == dispatchers_.end()) {
+        // An earlier handler removed the dispatcher.
+        continue;
+      }
+    }
+    pdispatcher->OnPreEvent(entry.second);
+    pdispatcher->OnEvent(entry.second, 0);
+  }
+  edge_triggered_processing_.clear();
+}
+
 bool PhysicalSocketServer::WaitPoll(int cmsWait, Dispatcher* dispatcher) {
   RTC_DCHECK(dispatcher);
   int64_t tvWait = -1;
@@ -17,7 +17,9 @@
 #endif
 
 #include <memory>
-#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "rtc_base/criticalsection.h"
@@ -58,6 +60,12 @@ class Dispatcher {
   virtual int GetDescriptor() = 0;
   virtual bool IsDescriptorClosed() = 0;
 #endif
+#if defined(WEBRTC_USE_EPOLL)
+  // Edge-triggered dispatchers are registered with epoll for all events once
+  // and filter them themselves, see PhysicalSocketServer::
+  // set_epoll_edge_triggered().
+  virtual bool IsEdgeTriggered() { return false; }
+#endif
 };
 
 // A socket server that provides the real sockets of the underlying OS.
@@ -81,6 +89,37 @@ class PhysicalSocketServer : public SocketServer {
   void Remove(Dispatcher* dispatcher);
   void Update(Dispatcher* dispatcher);
 
+#if defined(WEBRTC_USE_EPOLL)
+  // When enabled, UDP sockets created afterwards are registered with epoll in
+  // edge-triggered mode. Their registration is never modified when the
+  // requested events change, which saves an epoll_ctl() call per change, and
+  // readiness the kernel won't report again (because a reader did not drain
+  // the socket) is delivered from a ready list without blocking in
+  // epoll_wait(). Must be set before the sockets are created.
+  void set_epoll_edge_triggered(bool enabled) {
+    epoll_edge_triggered_ = enabled;
+  }
+  bool epoll_edge_triggered() const {
+    return epoll_edge_triggered_ && epoll_fd_ != INVALID_SOCKET;
+  }
+
+  // Queues |events| for delivery to the edge-triggered |dispatcher| on the
+  // next iteration of Wait(). Events queued for the same dispatcher before
+  // then are delivered together.
+  void ScheduleEdgeTriggeredEvents(Dispatcher* dispatcher, uint32_t events);
+
+  // When positive, Wait() polls the sockets without blocking for up to
+  // |busy_poll_us| microseconds before it blocks in epoll_wait(), and UDP
+  // sockets created afterwards ask the kernel to busy poll the device queue
+  // for as long when they are read (SO_BUSY_POLL, where permitted). This
+  // trades a core spinning on the network thread for lower wakeup latency,
+  // and is meant for relays and media servers with dedicated network cores.
+  void set_busy_poll_us(int busy_poll_us) { busy_poll_us_ = busy_poll_us; }
+  int busy_poll_us() const {
+    return epoll_fd_ != INVALID_SOCKET ? busy_poll_us_ : 0;
+  }
+#endif
+
 #if defined(WEBRTC_POSIX)
   // Sets the function to be executed in response to the specified POSIX signal.
   // The function is executed from inside Wait() using the "self-pipe trick"--
@@ -99,7 +138,7 @@ class PhysicalSocketServer : public SocketServer {
 #endif
 
  private:
-  typedef std::set<Dispatcher*> DispatcherSet;
+  typedef std::unordered_set<Dispatcher*> DispatcherSet;
 
   void AddRemovePendingDispatchers();
 
@@ -115,9 +154,14 @@ class PhysicalSocketServer : public SocketServer {
   void UpdateEpoll(Dispatcher* dispatcher);
   bool WaitEpoll(int cms);
   bool WaitPoll(int cms, Dispatcher* dispatcher);
+  void ProcessEdgeTriggeredReadyEvents();
 
   int epoll_fd_ = INVALID_SOCKET;
   std::vector<struct epoll_event> epoll_events_;
+  bool epoll_edge_triggered_ = false;
+  int busy_poll_us_ = 0;
+  std::unordered_map<Dispatcher*, uint32_t> edge_triggered_ready_;
+  std::vector<std::pair<Dispatcher*, uint32_t>> edge_triggered_processing_;
 #endif  // WEBRTC_USE_EPOLL
   DispatcherSet dispatchers_;
   DispatcherSet pending_add_dispatchers_;
@@ -163,6 +207,9 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
                size_t length,
                SocketAddress* out_addr,
                int64_t* timestamp) override;
+  int RecvFromBatch(ReceivedDatagram* datagrams, size_t count) override;
+  int SendToBatch(const OutgoingDatagram* datagrams, size_t count) override;
+  int SendGathered(const OutgoingBuffer* buffers, size_t count) override;
 
   int Listen(int backlog) override;
   AsyncSocket* Accept(SocketAddress* out_addr) override;
@@ -189,6 +236,15 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   void UpdateLastError();
   void MaybeRemapSendError();
 
+#if defined(WEBRTC_LINUX) && !defined(WEBRTC_ANDROID)
+  // Sends a run of equally sized datagrams to one destination as a single
+  // UDP_SEGMENT (GSO) message. Returns the number of datagrams sent, or
+  // SOCKET_ERROR.
+  int SendSegmented(const OutgoingDatagram* datagrams, size_t count);
+  // Sends datagrams with sendmmsg(). Same return value as SendToBatch().
+  int SendMultiple(const OutgoingDatagram* datagrams, size_t count);
+#endif
+
   uint8_t enabled_events() const { return enabled_events_; }
   virtual void SetEnabledEvents(uint8_t events);
   virtual void EnableEvents(uint8_t events);
@@ -203,6 +259,12 @@ class PhysicalSocket : public AsyncSocket, public sigslot::has_slots<> {
   int error_ RTC_GUARDED_BY(crit_);
   ConnState state_;
   AsyncResolver* resolver_;
+  // Cleared the first time the kernel or NIC rejects a UDP_SEGMENT send.
+  bool udp_gso_supported_ = true;
+  // Readiness reported by an edge-triggered epoll event that has not been
+  // used up by an operation that would block.
+  bool edge_readable_ = false;
+  bool edge_writable_ = false;
 
 #if !defined(NDEBUG)
   std::string dbg_addr_;
@@ -235,6 +297,9 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
   uint32_t GetRequestedEvents() override;
   void OnPreEvent(uint32_t ff) override;
   void OnEvent(uint32_t ff, int err) override;
+#if defined(WEBRTC_USE_EPOLL)
+  bool IsEdgeTriggered() override;
+#endif
 
   int Close() override;
 
@@ -259,6 +324,7 @@ class SocketDispatcher : public Dispatcher, public PhysicalSocket {
   void MaybeUpdateDispatcher(uint8_t old_events);
 
   int saved_enabled_events_ = -1;
+  bool edge_triggered_ = false;
 #endif
 };
 
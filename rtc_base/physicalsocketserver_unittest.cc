@@ -11,14 +11,21 @@
 #include <memory>
 #include <signal.h>
 #include <stdarg.h>
+#include <string>
+#include <vector>
 
+#include "rtc_base/arraysize.h"
+#include "rtc_base/asyncudpsocket.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/networkmonitor.h"
 #include "rtc_base/physicalsocketserver.h"
+#include "rtc_base/receivebufferpool.h"
 #include "rtc_base/socket_unittest.h"
 #include "rtc_base/testutils.h"
 #include "rtc_base/thread.h"
+#include "rtc_base/timeutils.h"
+#include "test/testsupport/perf_test.h"
 
 namespace rtc {
 
@@ -489,6 +496,439 @@ TEST_F(PhysicalSocketTest,
   server_->set_network_binder(nullptr);
 }
 
+// Several datagrams queued on a UDP socket should all be returned by a single
+// RecvFromBatch() call.
+TEST_F(PhysicalSocketTest, RecvFromBatchDrainsQueuedDatagramsIPv4) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const int kNumDatagrams = 5;
+  for (int i = 0; i < kNumDatagrams; ++i) {
+    char payload = static_cast<char>('a' + i);
+    ASSERT_EQ(1, sender->SendTo(&payload, 1, receiver->GetLocalAddress()));
+  }
+
+  char buffers[8][16];
+  ReceivedDatagram datagrams[8];
+  for (size_t i = 0; i < arraysize(datagrams); ++i) {
+    datagrams[i].buffer = buffers[i];
+    datagrams[i].buffer_size = sizeof(buffers[i]);
+  }
+  int total = 0;
+  // Loopback delivery is asynchronous, so allow a few attempts.
+  for (int attempt = 0; attempt < 100 && total < kNumDatagrams; ++attempt) {
+    int received =
+        receiver->RecvFromBatch(datagrams + total, arraysize(datagrams) - total);
+    if (received > 0) {
+      total += received;
+    } else {
+      Thread::SleepMs(1);
+    }
+  }
+  ASSERT_EQ(kNumDatagrams, total);
+  for (int i = 0; i < kNumDatagrams; ++i) {
+    EXPECT_EQ(1u, datagrams[i].length);
+    EXPECT_FALSE(datagrams[i].truncated);
+    EXPECT_EQ(static_cast<char>('a' + i), buffers[i][0]);
+    EXPECT_EQ(sender->GetLocalAddress(), datagrams[i].source);
+  }
+}
+
+// Collects the packets signaled by an AsyncPacketSocket.
+class ReceivedPacketCollector : public sigslot::has_slots<> {
+ public:
+  explicit ReceivedPacketCollector(AsyncPacketSocket* socket) {
+    socket->SignalReadPacket.connect(this,
+                                     &ReceivedPacketCollector::OnReadPacket);
+  }
+
+  void OnReadPacket(AsyncPacketSocket* socket,
+                    const char* data,
+                    size_t size,
+                    const SocketAddress& remote_addr,
+                    const PacketTime& packet_time) {
+    packets_.push_back(std::string(data, size));
+  }
+
+  const std::vector<std::string>& packets() const { return packets_; }
+
+ private:
+  std::vector<std::string> packets_;
+};
+
+// An AsyncUDPSocket with a receive batch size reads through RecvFromBatch(),
+// and should still deliver every datagram, including ones larger than an
+// MTU.
+TEST_F(PhysicalSocketTest, AsyncUdpSocketBatchedReadDeliversEveryPacketIPv4) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncUDPSocket> udp_socket(AsyncUDPSocket::Create(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM),
+      SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(udp_socket);
+  udp_socket->SetRecvBatchSize(16);
+  ReceivedPacketCollector collector(udp_socket.get());
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const std::string kPayloads[] = {"one", std::string(10000, 'x'), "three"};
+  for (const std::string& payload : kPayloads) {
+    ASSERT_EQ(static_cast<int>(payload.size()),
+              sender->SendTo(payload.data(), payload.size(),
+                             udp_socket->GetLocalAddress()));
+  }
+  for (int i = 0; i < 100 && collector.packets().size() < arraysize(kPayloads);
+       ++i) {
+    server_->Wait(10, true);
+  }
+
+  ASSERT_EQ(arraysize(kPayloads), collector.packets().size());
+  for (size_t i = 0; i < arraysize(kPayloads); ++i) {
+    EXPECT_EQ(kPayloads[i], collector.packets()[i]);
+  }
+  AsyncUDPSocket::RecvBatchStats stats = udp_socket->GetRecvBatchStats();
+  EXPECT_EQ(3, stats.packets_received);
+  EXPECT_GT(stats.read_events, 0);
+  EXPECT_GE(stats.AveragePacketsPerRead(), 1.0);
+}
+
+// With a receive buffer pool, datagrams larger than the pool's buffers
+// should still be delivered.
+TEST_F(PhysicalSocketTest, AsyncUdpSocketPooledReadDeliversEveryPacketIPv4) {
+  MAYBE_SKIP_IPV4;
+  ReceiveBufferPool pool(2048, 16);
+  std::unique_ptr<AsyncUDPSocket> udp_socket(AsyncUDPSocket::Create(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM),
+      SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_TRUE(udp_socket);
+  udp_socket->SetReceiveBufferPool(&pool);
+  ReceivedPacketCollector collector(udp_socket.get());
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const std::string kPayloads[] = {"one", std::string(2048, 'x'),
+                                   std::string(10000, 'y'), "four"};
+  for (const std::string& payload : kPayloads) {
+    ASSERT_EQ(static_cast<int>(payload.size()),
+              sender->SendTo(payload.data(), payload.size(),
+                             udp_socket->GetLocalAddress()));
+  }
+  for (int i = 0; i < 100 && collector.packets().size() < arraysize(kPayloads);
+       ++i) {
+    server_->Wait(10, true);
+  }
+
+  ASSERT_EQ(arraysize(kPayloads), collector.packets().size());
+  for (size_t i = 0; i < arraysize(kPayloads); ++i) {
+    EXPECT_EQ(kPayloads[i], collector.packets()[i]);
+  }
+}
+
+// Counts the packets that AsyncUDPSocket sends one at a time.
+class SendToCountingUdpSocket : public AsyncUDPSocket {
+ public:
+  explicit SendToCountingUdpSocket(AsyncSocket* socket)
+      : AsyncUDPSocket(socket) {}
+
+  int SendTo(const void* pv,
+             size_t cb,
+             const SocketAddress& addr,
+             const PacketOptions& options) override {
+    ++send_to_calls_;
+    return AsyncUDPSocket::SendTo(pv, cb, addr, options);
+  }
+
+  int send_to_calls() const { return send_to_calls_; }
+
+ private:
+  int send_to_calls_ = 0;
+};
+
+// Collects the ids of the packets signaled as sent.
+class SentPacketCollector : public sigslot::has_slots<> {
+ public:
+  explicit SentPacketCollector(AsyncPacketSocket* socket) {
+    socket->SignalSentPacket.connect(this, &SentPacketCollector::OnSentPacket);
+  }
+
+  void OnSentPacket(AsyncPacketSocket* socket, const SentPacket& sent_packet) {
+    packet_ids_.push_back(sent_packet.packet_id);
+  }
+
+  const std::vector<int64_t>& packet_ids() const { return packet_ids_; }
+
+ private:
+  std::vector<int64_t> packet_ids_;
+};
+
+// A packet with options that a batched send can't carry should be sent with
+// SendTo(), without reordering it relative to the batched ones.
+TEST_F(PhysicalSocketTest, AsyncUdpSocketSendToBatchHonorsOptionsIPv4) {
+  MAYBE_SKIP_IPV4;
+  AsyncSocket* socket = server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM);
+  ASSERT_EQ(0, socket->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SendToCountingUdpSocket udp_socket(socket);
+  SentPacketCollector sent_packets(&udp_socket);
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const std::string kPayloads[] = {"aa", "bb", "cc", "dd"};
+  OutgoingPacket packets[arraysize(kPayloads)];
+  for (size_t i = 0; i < arraysize(kPayloads); ++i) {
+    packets[i] = OutgoingPacket(kPayloads[i].data(), kPayloads[i].size(),
+                                receiver->GetLocalAddress(), PacketOptions());
+    packets[i].options.packet_id = i;
+  }
+  packets[1].options.dscp = DSCP_EF;
+  packets[2].options.packet_time_params.rtp_sendtime_extension_id = 3;
+  ASSERT_EQ(4, udp_socket.SendToBatch(packets, arraysize(packets)));
+  EXPECT_EQ(2, udp_socket.send_to_calls());
+  EXPECT_EQ(std::vector<int64_t>({0, 1, 2, 3}), sent_packets.packet_ids());
+
+  char buffer[16];
+  for (size_t i = 0; i < arraysize(kPayloads); ++i) {
+    int received = -1;
+    for (int attempt = 0; attempt < 100 && received < 0; ++attempt) {
+      received = receiver->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr);
+      if (received < 0)
+        Thread::SleepMs(1);
+    }
+    ASSERT_GE(received, 0);
+    EXPECT_EQ(kPayloads[i], std::string(buffer, received));
+  }
+}
+
+// A batch of equally sized datagrams (the UDP_SEGMENT case) and a batch of
+// mixed sizes (the sendmmsg case) should both arrive as separate datagrams.
+TEST_F(PhysicalSocketTest, SendToBatchSendsEveryDatagramIPv4) {
+  MAYBE_SKIP_IPV4;
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+
+  const std::string kPayloads[] = {"aaaa", "bbbb", "cc", "dddddd"};
+  OutgoingDatagram datagrams[arraysize(kPayloads)];
+  for (size_t i = 0; i < arraysize(kPayloads); ++i) {
+    datagrams[i].data = kPayloads[i].data();
+    datagrams[i].length = kPayloads[i].size();
+    datagrams[i].destination = receiver->GetLocalAddress();
+  }
+  ASSERT_EQ(3, sender->SendToBatch(datagrams, 3));
+  ASSERT_EQ(1, sender->SendToBatch(datagrams + 3, 1));
+
+  char buffer[16];
+  for (size_t i = 0; i < arraysize(kPayloads); ++i) {
+    int received = -1;
+    for (int attempt = 0; attempt < 100 && received < 0; ++attempt) {
+      received = receiver->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr);
+      if (received < 0)
+        Thread::SleepMs(1);
+    }
+    ASSERT_GE(received, 0);
+    EXPECT_EQ(kPayloads[i], std::string(buffer, received));
+  }
+}
+
+TEST_F(PhysicalSocketTest, SendGatheredSendsBuffersInOrderIPv4) {
+  MAYBE_SKIP_IPV4;
+  webrtc::testing::StreamSink sink;
+  std::unique_ptr<AsyncSocket> server(
+      server_->CreateAsyncSocket(AF_INET, SOCK_STREAM));
+  sink.Monitor(server.get());
+  ASSERT_EQ(0, server->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, server->Listen(5));
+  std::unique_ptr<AsyncSocket> client(
+      server_->CreateAsyncSocket(AF_INET, SOCK_STREAM));
+  sink.Monitor(client.get());
+  ASSERT_EQ(0, client->Connect(server->GetLocalAddress()));
+  EXPECT_TRUE_WAIT(sink.Check(server.get(), webrtc::testing::SSE_READ),
+                   kTimeout);
+  std::unique_ptr<AsyncSocket> accepted(server->Accept(nullptr));
+  ASSERT_TRUE(accepted);
+  EXPECT_TRUE_WAIT(sink.Check(client.get(), webrtc::testing::SSE_OPEN),
+                   kTimeout);
+
+  const std::string kPieces[] = {"ab", "", "cdef", "g"};
+  OutgoingBuffer buffers[arraysize(kPieces)];
+  for (size_t i = 0; i < arraysize(kPieces); ++i) {
+    buffers[i].data = kPieces[i].data();
+    buffers[i].length = kPieces[i].size();
+  }
+  ASSERT_EQ(7, client->SendGathered(buffers, arraysize(buffers)));
+
+  std::string received;
+  char buffer[16];
+  for (int attempt = 0; attempt < 100 && received.size() < 7; ++attempt) {
+    int len = accepted->Recv(buffer, sizeof(buffer), nullptr);
+    if (len > 0)
+      received.append(buffer, len);
+    else
+      Thread::SleepMs(1);
+  }
+  EXPECT_EQ("abcdefg", received);
+}
+
+#if defined(WEBRTC_USE_EPOLL)
+
+// Reads exactly one datagram per read event, so that edge-triggered sockets
+// are left undrained and have to be serviced from the ready list.
+class SingleDatagramReader : public sigslot::has_slots<> {
+ public:
+  explicit SingleDatagramReader(AsyncSocket* socket) : socket_(socket) {
+    socket_->SignalReadEvent.connect(this, &SingleDatagramReader::OnReadEvent);
+  }
+
+  void OnReadEvent(AsyncSocket* socket) {
+    ++read_events_;
+    char buffer[64];
+    if (socket_->RecvFrom(buffer, sizeof(buffer), nullptr, nullptr) >= 0) {
+      ++datagrams_read_;
+      last_read_time_ns_ = TimeNanos();
+    }
+  }
+
+  int read_events() const { return read_events_; }
+  int datagrams_read() const { return datagrams_read_; }
+  int64_t last_read_time_ns() const { return last_read_time_ns_; }
+
+ private:
+  AsyncSocket* const socket_;
+  int read_events_ = 0;
+  int datagrams_read_ = 0;
+  int64_t last_read_time_ns_ = -1;
+};
+
+TEST_F(PhysicalSocketTest, EdgeTriggeredEpollDeliversUndrainedDatagrams) {
+  MAYBE_SKIP_IPV4;
+  server_->set_epoll_edge_triggered(true);
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_TRUE(static_cast<SocketDispatcher*>(receiver.get())
+                  ->IsEdgeTriggered());
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SingleDatagramReader reader(receiver.get());
+
+  const int kNumDatagrams = 3;
+  for (int i = 0; i < kNumDatagrams; ++i) {
+    char payload = static_cast<char>(i);
+    ASSERT_EQ(1, sender->SendTo(&payload, 1, receiver->GetLocalAddress()));
+  }
+  for (int i = 0; i < 100 && reader.datagrams_read() < kNumDatagrams; ++i) {
+    server_->Wait(10, true);
+  }
+  EXPECT_EQ(kNumDatagrams, reader.datagrams_read());
+}
+
+// Events scheduled repeatedly for the same dispatcher before Wait() runs
+// should reach it once.
+TEST_F(PhysicalSocketTest, EdgeTriggeredEpollMergesScheduledEvents) {
+  MAYBE_SKIP_IPV4;
+  server_->set_epoll_edge_triggered(true);
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SingleDatagramReader reader(receiver.get());
+  SocketDispatcher* dispatcher = static_cast<SocketDispatcher*>(receiver.get());
+  ASSERT_TRUE(dispatcher->IsEdgeTriggered());
+
+  for (int i = 0; i < 3; ++i) {
+    server_->ScheduleEdgeTriggeredEvents(dispatcher, DE_READ);
+  }
+  server_->Wait(0, true);
+  EXPECT_EQ(1, reader.read_events());
+  EXPECT_EQ(0, reader.datagrams_read());
+}
+
+TEST_F(PhysicalSocketTest, BusyPollingWaitDeliversDatagrams) {
+  MAYBE_SKIP_IPV4;
+  server_->set_busy_poll_us(100);
+  EXPECT_EQ(100, server_->busy_poll_us());
+  std::unique_ptr<AsyncSocket> receiver(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  std::unique_ptr<AsyncSocket> sender(
+      server_->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+  ASSERT_EQ(0, receiver->Bind(SocketAddress(kIPv4Loopback, 0)));
+  ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+  SingleDatagramReader reader(receiver.get());
+
+  // Without traffic, Wait() still returns once the timeout expires.
+  int64_t start_ms = TimeMillis();
+  EXPECT_TRUE(server_->Wait(10, true));
+  EXPECT_GE(TimeMillis() - start_ms, 10);
+
+  char payload = 'a';
+  ASSERT_EQ(1, sender->SendTo(&payload, 1, receiver->GetLocalAddress()));
+  for (int i = 0; i < 100 && reader.datagrams_read() < 1; ++i) {
+    server_->Wait(10, true);
+  }
+  EXPECT_EQ(1, reader.datagrams_read());
+}
+
+// Measures the time from sending a datagram to one of |num_sockets| sockets
+// until its read event is dispatched, for level- and edge-triggered epoll.
+// The test is disabled by default to avoid unnecessarily loading the bots.
+TEST_F(PhysicalSocketTest, DISABLED_EpollWakeupToDispatchLatency) {
+  MAYBE_SKIP_IPV4;
+  const size_t kSocketCounts[] = {16, 256, 1000};
+  const int kIterations = 2000;
+  for (bool edge_triggered : {false, true}) {
+    for (size_t num_sockets : kSocketCounts) {
+      std::unique_ptr<PhysicalSocketServer> ss(new PhysicalSocketServer());
+      ss->set_epoll_edge_triggered(edge_triggered);
+      std::unique_ptr<AsyncSocket> sender(
+          ss->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+      ASSERT_EQ(0, sender->Bind(SocketAddress(kIPv4Loopback, 0)));
+      std::vector<std::unique_ptr<AsyncSocket>> sockets;
+      std::vector<std::unique_ptr<SingleDatagramReader>> readers;
+      for (size_t i = 0; i < num_sockets; ++i) {
+        sockets.emplace_back(ss->CreateAsyncSocket(AF_INET, SOCK_DGRAM));
+        ASSERT_TRUE(sockets.back());
+        ASSERT_EQ(0, sockets.back()->Bind(SocketAddress(kIPv4Loopback, 0)));
+        readers.emplace_back(new SingleDatagramReader(sockets.back().get()));
+      }
+
+      int64_t total_latency_ns = 0;
+      int delivered = 0;
+      for (int i = 0; i < kIterations; ++i) {
+        size_t index = (i * 7919) % num_sockets;
+        SingleDatagramReader* reader = readers[index].get();
+        int expected = reader->datagrams_read() + 1;
+        char payload = 0;
+        int64_t send_time_ns = TimeNanos();
+        sender->SendTo(&payload, 1, sockets[index]->GetLocalAddress());
+        for (int j = 0; j < 100 && reader->datagrams_read() < expected; ++j) {
+          ss->Wait(10, true);
+        }
+        if (reader->datagrams_read() == expected) {
+          total_latency_ns += reader->last_read_time_ns() - send_time_ns;
+          ++delivered;
+        }
+      }
+      ASSERT_GT(delivered, 0);
+      webrtc::test::PrintResult(
+          "epoll_wakeup_to_dispatch",
+          edge_triggered ? "_edge_triggered" : "_level_triggered",
+          std::to_string(num_sockets) + "_sockets",
+          total_latency_ns / 1000.0 / delivered, "us", false);
+    }
+  }
+}
+
+#endif  // WEBRTC_USE_EPOLL
+
 class PosixSignalDeliveryTest : public testing::Test {
  public:
   static void RecordSignal(int signum) {
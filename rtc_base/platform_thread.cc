@@ -12,6 +12,7 @@
 
 #include "rtc_base/atomicops.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/thread_placement.h"
 #include "rtc_base/timeutils.h"
 
 #if defined(WEBRTC_LINUX)
@@ -157,6 +158,7 @@ void PlatformThread::Run() {
   // Attach the worker thread checker to this thread.
   RTC_DCHECK(spawned_thread_checker_.CalledOnValidThread());
   rtc::SetCurrentThreadName(name_.c_str());
+  ApplyThreadPlacement(name_.c_str());
 
   if (run_function_) {
     SetPriority(priority_);
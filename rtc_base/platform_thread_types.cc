@@ -15,6 +15,10 @@
 #include <sys/syscall.h>
 #endif
 
+#if defined(WEBRTC_POSIX)
+#include <time.h>
+#endif
+
 namespace rtc {
 
 PlatformThreadId CurrentThreadId() {
@@ -75,4 +79,13 @@ void SetCurrentThreadName(const char* name) {
 #endif
 }
 
+void YieldCurrentThread() {
+#if defined(WEBRTC_WIN)
+  ::Sleep(0);
+#elif defined(WEBRTC_POSIX)
+  static const struct timespec ts_null = {0};
+  nanosleep(&ts_null, nullptr);
+#endif
+}
+
 }  // namespace rtc
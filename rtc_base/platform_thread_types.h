@@ -48,6 +48,10 @@ bool IsThreadRefEqual(const PlatformThreadRef& a, const PlatformThreadRef& b);
 // Sets the current thread name.
 void SetCurrentThreadName(const char* name);
 
+// Gives up the rest of the current thread's time slice, so that a thread
+// spinning on a value another thread is about to change lets it run.
+void YieldCurrentThread();
+
 }  // namespace rtc
 
 #endif  // RTC_BASE_PLATFORM_THREAD_TYPES_H_
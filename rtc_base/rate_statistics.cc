@@ -16,15 +16,21 @@
 
 namespace webrtc {
 
-RateStatistics::RateStatistics(int64_t window_size_ms, float scale)
-    : buckets_(new Bucket[window_size_ms]()),
+RateStatistics::RateStatistics(int64_t window_size_ms,
+                               float scale,
+                               int64_t bucket_size_ms)
+    : bucket_size_ms_(bucket_size_ms),
+      max_num_buckets_(NumBuckets(window_size_ms)),
+      buckets_(new Bucket[max_num_buckets_]()),
       accumulated_count_(0),
       num_samples_(0),
       oldest_time_(-window_size_ms),
       oldest_index_(0),
       scale_(scale),
       max_window_size_ms_(window_size_ms),
-      current_window_size_ms_(max_window_size_ms_) {}
+      current_window_size_ms_(max_window_size_ms_) {
+  RTC_DCHECK_GT(bucket_size_ms, 0);
+}
 
 RateStatistics::~RateStatistics() {}
 
@@ -34,7 +40,7 @@ void RateStatistics::Reset() {
   oldest_time_ = -max_window_size_ms_;
   oldest_index_ = 0;
   current_window_size_ms_ = max_window_size_ms_;
-  for (int64_t i = 0; i < max_window_size_ms_; i++)
+  for (int64_t i = 0; i < max_num_buckets_; i++)
     buckets_[i] = Bucket();
 }
 
@@ -50,11 +56,12 @@ void RateStatistics::Update(size_t count, int64_t now_ms) {
   if (!IsInitialized())
     oldest_time_ = now_ms;
 
-  uint32_t now_offset = static_cast<uint32_t>(now_ms - oldest_time_);
-  RTC_DCHECK_LT(now_offset, max_window_size_ms_);
+  uint32_t now_offset =
+      static_cast<uint32_t>(BucketNumber(now_ms) - BucketNumber(oldest_time_));
+  RTC_DCHECK_LT(now_offset, max_num_buckets_);
   uint32_t index = oldest_index_ + now_offset;
-  if (index >= max_window_size_ms_)
-    index -= max_window_size_ms_;
+  if (index >= max_num_buckets_)
+    index -= max_num_buckets_;
   buckets_[index].sum += count;
   ++buckets_[index].samples;
   accumulated_count_ += count;
@@ -82,24 +89,28 @@ void RateStatistics::EraseOld(int64_t now_ms) {
   if (!IsInitialized())
     return;
 
-  // New oldest time that is included in data set.
-  int64_t new_oldest_time = now_ms - current_window_size_ms_ + 1;
+  // New oldest time that is included in data set. The samples of a bucket are
+  // all kept or all dropped, so the window starts where a bucket does.
+  const int64_t new_oldest_bucket =
+      BucketNumber(now_ms - current_window_size_ms_ + 1);
+  int64_t new_oldest_time = new_oldest_bucket * bucket_size_ms_;
 
   // New oldest time is older than the current one, no need to cull data.
   if (new_oldest_time <= oldest_time_)
     return;
 
   // Loop over buckets and remove too old data points.
-  while (num_samples_ > 0 && oldest_time_ < new_oldest_time) {
+  int64_t oldest_bucket_number = BucketNumber(oldest_time_);
+  while (num_samples_ > 0 && oldest_bucket_number < new_oldest_bucket) {
     const Bucket& oldest_bucket = buckets_[oldest_index_];
     RTC_DCHECK_GE(accumulated_count_, oldest_bucket.sum);
     RTC_DCHECK_GE(num_samples_, oldest_bucket.samples);
     accumulated_count_ -= oldest_bucket.sum;
     num_samples_ -= oldest_bucket.samples;
     buckets_[oldest_index_] = Bucket();
-    if (++oldest_index_ >= max_window_size_ms_)
+    if (++oldest_index_ >= max_num_buckets_)
       oldest_index_ = 0;
-    ++oldest_time_;
+    ++oldest_bucket_number;
   }
   oldest_time_ = new_oldest_time;
 }
@@ -117,4 +128,16 @@ bool RateStatistics::IsInitialized() const {
   return oldest_time_ != -max_window_size_ms_;
 }
 
+int64_t RateStatistics::BucketNumber(int64_t time_ms) const {
+  // Rounds down for negative times too.
+  if (time_ms >= 0)
+    return time_ms / bucket_size_ms_;
+  return -((-time_ms + bucket_size_ms_ - 1) / bucket_size_ms_);
+}
+
+int64_t RateStatistics::NumBuckets(int64_t window_size_ms) const {
+  // A window that doesn't start where a bucket does spans one more of them.
+  return (window_size_ms + 2 * bucket_size_ms_ - 2) / bucket_size_ms_;
+}
+
 }  // namespace webrtc
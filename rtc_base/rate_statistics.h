@@ -22,12 +22,22 @@ class RateStatistics {
  public:
   static constexpr float kBpsScale = 8000.0f;
 
+  // A resolution that keeps the rate within about 2% of the exact one over a
+  // one second window in a few hundred bytes, for the counters that there
+  // are several of per stream.
+  static constexpr int64_t kCoarseBucketSizeMs = 20;
+
   // max_window_size_ms = Maximum window size in ms for the rate estimation.
   //                      Initial window size is set to this, but may be changed
   //                      to something lower by calling SetWindowSize().
   // scale = coefficient to convert counts/ms to desired unit
   //         ex: kBpsScale (8000) for bits/s if count represents bytes.
-  RateStatistics(int64_t max_window_size_ms, float scale);
+  // bucket_size_ms = The resolution of the window. Counts are kept in one
+  //                  bucket per this many ms, and the window moves a bucket
+  //                  at a time. The default of 1 ms gives exact rates.
+  RateStatistics(int64_t max_window_size_ms,
+                 float scale,
+                 int64_t bucket_size_ms = 1);
   ~RateStatistics();
 
   // Reset instance to original state.
@@ -51,13 +61,19 @@ class RateStatistics {
  private:
   void EraseOld(int64_t now_ms);
   bool IsInitialized() const;
+  // The number of the bucket that |time_ms| falls into, counted from 0 ms.
+  int64_t BucketNumber(int64_t time_ms) const;
+  // The number of buckets that a window of |window_size_ms| spans.
+  int64_t NumBuckets(int64_t window_size_ms) const;
 
   // Counters are kept in buckets (circular buffer), with one bucket
-  // per millisecond.
+  // per |bucket_size_ms_|.
   struct Bucket {
     size_t sum;      // Sum of all samples in this bucket.
     size_t samples;  // Number of samples in this bucket.
   };
+  const int64_t bucket_size_ms_;
+  const int64_t max_num_buckets_;
   std::unique_ptr<Bucket[]> buckets_;
 
   // Total count recorded in buckets.
@@ -69,7 +85,8 @@ class RateStatistics {
   // Oldest time recorded in buckets.
   int64_t oldest_time_;
 
-  // Bucket index of oldest counter recorded in buckets.
+  // Bucket index of oldest counter recorded in buckets, which counts the
+  // samples from |oldest_time_| to the end of its bucket.
   uint32_t oldest_index_;
 
   // To convert counts/ms to desired units
@@ -277,4 +277,49 @@ TEST_F(RateStatisticsTest, HandlesQuietPeriods) {
   EXPECT_TRUE(static_cast<bool>(bitrate));
   EXPECT_EQ(0u, *bitrate);
 }
+
+TEST(CoarseRateStatisticsTest, EstimatesSteadyRate) {
+  RateStatistics stats(1000, 8000, RateStatistics::kCoarseBucketSizeMs);
+  const size_t kPacketSize = 1200;
+  const int64_t kIntervalMs = 5;
+  const double kExpectedRateBps = kPacketSize * 8000.0 / kIntervalMs;
+  for (int64_t now_ms = 0; now_ms < 10000; now_ms += kIntervalMs) {
+    stats.Update(kPacketSize, now_ms);
+    if (now_ms >= 1000) {
+      rtc::Optional<uint32_t> rate = stats.Rate(now_ms);
+      ASSERT_TRUE(rate);
+      EXPECT_NEAR(kExpectedRateBps, *rate, kExpectedRateBps * 0.02);
+    }
+  }
+}
+
+TEST(CoarseRateStatisticsTest, DropsWholeBuckets) {
+  const int64_t kBucketSizeMs = 20;
+  RateStatistics stats(100, 8000, kBucketSizeMs);
+  stats.Update(1000, 0);
+  stats.Update(1000, 50);
+  // The window grows until it is full.
+  EXPECT_EQ(16000000u / 100, *stats.Rate(99));
+  // Then it extends back to the start of the oldest bucket...
+  EXPECT_EQ(static_cast<uint32_t>(16000000.0 / 119 + 0.5), *stats.Rate(118));
+  // ...which is dropped once the window starts after it.
+  EXPECT_EQ(8000000u / 100, *stats.Rate(119));
+  EXPECT_FALSE(stats.Rate(170));
+}
+
+TEST(CoarseRateStatisticsTest, HandlesChangingWindowSize) {
+  const int64_t kBucketSizeMs = 10;
+  RateStatistics stats(kWindowMs, 8000, kBucketSizeMs);
+  int64_t now_ms = 0;
+  // One byte per ms, 8 kbps.
+  for (; now_ms < 2 * kWindowMs; now_ms += kBucketSizeMs)
+    stats.Update(kBucketSizeMs, now_ms);
+  now_ms -= kBucketSizeMs;
+  EXPECT_NEAR(8000, *stats.Rate(now_ms), 8000 * 0.02);
+  EXPECT_TRUE(stats.SetWindowSize(kWindowMs / 2, now_ms));
+  // The rate is off by up to a bucket's worth of the window.
+  EXPECT_NEAR(8000, *stats.Rate(now_ms),
+              8000 * kBucketSizeMs / (kWindowMs / 2));
+  EXPECT_FALSE(stats.SetWindowSize(kWindowMs + 1, now_ms));
+}
 }  // namespace
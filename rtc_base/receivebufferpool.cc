@@ -0,0 +1,214 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/receivebufferpool.h"
+
+#if defined(WEBRTC_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/packetbufferallocator.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace rtc {
+
+const size_t ReceiveBufferPool::kDefaultBufferCapacity;
+const size_t ReceiveBufferPool::kDefaultMaxFreeBuffers;
+
+// Owns the free buffers. It is ref counted so that buffers released after the
+// pool itself is gone can still find out that they should not be recycled.
+class ReceiveBufferPool::FreeList : public RefCountInterface {
+ public:
+  FreeList(size_t buffer_capacity, size_t max_free_buffers)
+      : buffer_capacity_(buffer_capacity),
+        max_free_buffers_(max_free_buffers) {}
+
+  PooledBuffer* Pop() {
+    CritScope cs(&crit_);
+    if (free_.empty())
+      return nullptr;
+    PooledBuffer* buffer = free_.back();
+    free_.pop_back();
+    return buffer;
+  }
+
+  // Returns false if the caller should delete |buffer| instead.
+  bool Recycle(PooledBuffer* buffer);
+
+  void Shutdown();
+
+  size_t size() const {
+    CritScope cs(&crit_);
+    return free_.size();
+  }
+
+ protected:
+  ~FreeList() override { RTC_DCHECK(free_.empty()); }
+
+ private:
+  const size_t buffer_capacity_;
+  const size_t max_free_buffers_;
+  CriticalSection crit_;
+  std::vector<PooledBuffer*> free_ RTC_GUARDED_BY(crit_);
+  bool shut_down_ RTC_GUARDED_BY(crit_) = false;
+};
+
+// A buffer that puts itself back on the free list instead of being deleted
+// when its last reference goes away.
+class ReceiveBufferPool::PooledBuffer : public RefCountedObject<Buffer> {
+ public:
+  PooledBuffer(scoped_refptr<FreeList> free_list, size_t buffer_capacity)
+      : RefCountedObject<Buffer>(0, buffer_capacity),
+        free_list_(std::move(free_list)) {}
+
+  RefCountReleaseStatus Release() const override {
+    const auto status = ref_count_.DecRef();
+    if (status == RefCountReleaseStatus::kDroppedLastRef) {
+      PooledBuffer* self = const_cast<PooledBuffer*>(this);
+      self->Clear();
+      if (!free_list_->Recycle(self))
+        delete this;
+    }
+    return status;
+  }
+
+ private:
+  friend class FreeList;
+  ~PooledBuffer() override {}
+
+  const scoped_refptr<FreeList> free_list_;
+};
+
+bool ReceiveBufferPool::FreeList::Recycle(PooledBuffer* buffer) {
+  // The owner of the last reference may have grown the buffer; don't keep
+  // buffers that no longer match the pool.
+  if (buffer->capacity() != buffer_capacity_)
+    return false;
+  CritScope cs(&crit_);
+  if (shut_down_ || free_.size() >= max_free_buffers_)
+    return false;
+  free_.push_back(buffer);
+  return true;
+}
+
+void ReceiveBufferPool::FreeList::Shutdown() {
+  std::vector<PooledBuffer*> buffers;
+  {
+    CritScope cs(&crit_);
+    shut_down_ = true;
+    buffers.swap(free_);
+  }
+  for (PooledBuffer* buffer : buffers)
+    delete buffer;
+}
+
+namespace {
+
+// Lending is synchronous, the receiving layers run on the lender's thread, so
+// the lends are kept per thread: the innermost ScopedLend is stored in thread
+// local storage and links to the enclosing ones. This keeps the receive path
+// free of locks, and costs a single lookup when nothing is lent.
+#if defined(WEBRTC_WIN)
+DWORD CurrentLendKey() {
+  static const DWORD key = TlsAlloc();
+  return key;
+}
+
+void* GetCurrentLend() {
+  return TlsGetValue(CurrentLendKey());
+}
+
+void SetCurrentLend(void* lend) {
+  TlsSetValue(CurrentLendKey(), lend);
+}
+#else
+pthread_key_t CreateCurrentLendKey() {
+  pthread_key_t key;
+  RTC_CHECK(pthread_key_create(&key, nullptr) == 0);
+  return key;
+}
+
+pthread_key_t CurrentLendKey() {
+  static const pthread_key_t key = CreateCurrentLendKey();
+  return key;
+}
+
+void* GetCurrentLend() {
+  return pthread_getspecific(CurrentLendKey());
+}
+
+void SetCurrentLend(void* lend) {
+  pthread_setspecific(CurrentLendKey(), lend);
+}
+#endif
+
+}  // namespace
+
+ReceiveBufferPool::ReceiveBufferPool(size_t buffer_capacity,
+                                     size_t max_free_buffers)
+    : buffer_capacity_(buffer_capacity),
+      free_list_(
+          new RefCountedObject<FreeList>(buffer_capacity, max_free_buffers)) {
+  RTC_DCHECK_GT(buffer_capacity, 0);
+}
+
+ReceiveBufferPool::~ReceiveBufferPool() {
+  free_list_->Shutdown();
+}
+
+ReceiveBufferPool* ReceiveBufferPool::Default() {
+  static ReceiveBufferPool* const pool =
+      new ReceiveBufferPool(kDefaultBufferCapacity, kDefaultMaxFreeBuffers);
+  return pool;
+}
+
+CopyOnWriteBuffer ReceiveBufferPool::GetBuffer() {
+  PooledBuffer* buffer = free_list_->Pop();
+  if (!buffer)
+    buffer = new PooledBuffer(free_list_, buffer_capacity_);
+  return CopyOnWriteBuffer(scoped_refptr<RefCountedObject<Buffer>>(buffer));
+}
+
+size_t ReceiveBufferPool::free_buffers() const {
+  return free_list_->size();
+}
+
+ReceiveBufferPool::ScopedLend::ScopedLend(CopyOnWriteBuffer* buffer)
+    : buffer_(buffer),
+      previous_(static_cast<ScopedLend*>(GetCurrentLend())) {
+  SetCurrentLend(this);
+}
+
+ReceiveBufferPool::ScopedLend::~ScopedLend() {
+  RTC_DCHECK_EQ(this, GetCurrentLend());
+  SetCurrentLend(previous_);
+}
+
+CopyOnWriteBuffer ReceiveBufferPool::TakeOrCopy(const uint8_t* data,
+                                                size_t size) {
+  if (size > 0) {
+    for (ScopedLend* lend = static_cast<ScopedLend*>(GetCurrentLend()); lend;
+         lend = lend->previous_) {
+      CopyOnWriteBuffer* buffer = lend->buffer_;
+      if (buffer->cdata() == data && buffer->size() == size)
+        return std::move(*buffer);
+    }
+  }
+  return PacketBufferAllocator::Copy(data, size);
+}
+
+}  // namespace rtc
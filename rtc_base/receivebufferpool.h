@@ -0,0 +1,87 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_RECEIVEBUFFERPOOL_H_
+#define RTC_BASE_RECEIVEBUFFERPOOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/scoped_ref_ptr.h"
+
+namespace rtc {
+
+// A pool of fixed-capacity, ref counted packet buffers for the receive path.
+//
+// A socket receives each datagram straight into a buffer from the pool and
+// lends it out with a ScopedLend while the packet is signaled up the stack.
+// A layer that wants to keep the packet calls TakeOrCopy() with the pointer it
+// was handed; if that is the lent packet, it gets the pooled buffer itself
+// instead of a copy, and can for example unprotect and parse it in place.
+// Buffers return to the pool, from any thread, when their last reference is
+// dropped.
+class ReceiveBufferPool {
+ public:
+  // Large enough for any datagram on a path with a 1500 byte MTU.
+  static const size_t kDefaultBufferCapacity = 2048;
+  static const size_t kDefaultMaxFreeBuffers = 1024;
+
+  ReceiveBufferPool(size_t buffer_capacity, size_t max_free_buffers);
+  // Buffers that are still referenced stay valid and are freed, rather than
+  // recycled, when released.
+  ~ReceiveBufferPool();
+
+  // A process-wide pool with the default settings.
+  static ReceiveBufferPool* Default();
+
+  // Returns an empty buffer with a capacity of buffer_capacity() bytes,
+  // reusing a free one when possible.
+  CopyOnWriteBuffer GetBuffer();
+  size_t buffer_capacity() const { return buffer_capacity_; }
+  size_t free_buffers() const;
+
+  // Makes the contents of |buffer| available to TakeOrCopy() on the current
+  // thread for the lifetime of the ScopedLend. A lent buffer may be taken at
+  // most once; after that |buffer| is empty and its former data must not be
+  // touched by the lender anymore. Lends on a thread must be nested.
+  class ScopedLend {
+   public:
+    explicit ScopedLend(CopyOnWriteBuffer* buffer);
+    ~ScopedLend();
+
+   private:
+    friend class ReceiveBufferPool;
+
+    CopyOnWriteBuffer* const buffer_;
+    // The enclosing lend on this thread, if any.
+    ScopedLend* const previous_;
+    RTC_DISALLOW_COPY_AND_ASSIGN(ScopedLend);
+  };
+
+  // If |data| and |size| are exactly the contents of a buffer lent on this
+  // thread, moves that buffer out to the caller. Otherwise returns a copy of
+  // the data, allocated with PacketBufferAllocator.
+  static CopyOnWriteBuffer TakeOrCopy(const uint8_t* data, size_t size);
+
+ private:
+  class PooledBuffer;
+  class FreeList;
+
+  const size_t buffer_capacity_;
+  const scoped_refptr<FreeList> free_list_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(ReceiveBufferPool);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_RECEIVEBUFFERPOOL_H_
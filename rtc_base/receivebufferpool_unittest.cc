@@ -0,0 +1,141 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/receivebufferpool.h"
+
+#include <string.h>
+
+#include "rtc_base/gunit.h"
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const uint8_t kTestData[] = {0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7};
+
+}  // namespace
+
+TEST(ReceiveBufferPoolTest, RecyclesReleasedBuffers) {
+  ReceiveBufferPool pool(64, 4);
+  const uint8_t* data;
+  {
+    CopyOnWriteBuffer buffer = pool.GetBuffer();
+    EXPECT_EQ(0u, buffer.size());
+    EXPECT_EQ(64u, buffer.capacity());
+    buffer.SetData(kTestData, sizeof(kTestData));
+    data = buffer.cdata();
+    EXPECT_EQ(0u, pool.free_buffers());
+  }
+  EXPECT_EQ(1u, pool.free_buffers());
+
+  CopyOnWriteBuffer buffer = pool.GetBuffer();
+  EXPECT_EQ(0u, pool.free_buffers());
+  EXPECT_EQ(0u, buffer.size());
+  EXPECT_EQ(data, buffer.cdata());
+}
+
+TEST(ReceiveBufferPoolTest, KeepsAtMostMaxFreeBuffers) {
+  ReceiveBufferPool pool(64, 1);
+  {
+    CopyOnWriteBuffer buffer1 = pool.GetBuffer();
+    CopyOnWriteBuffer buffer2 = pool.GetBuffer();
+  }
+  EXPECT_EQ(1u, pool.free_buffers());
+}
+
+TEST(ReceiveBufferPoolTest, DoesNotRecycleGrownBuffers) {
+  ReceiveBufferPool pool(8, 4);
+  {
+    CopyOnWriteBuffer buffer = pool.GetBuffer();
+    buffer.EnsureCapacity(16);
+  }
+  EXPECT_EQ(0u, pool.free_buffers());
+}
+
+TEST(ReceiveBufferPoolTest, BuffersMayOutliveThePool) {
+  auto pool = rtc::MakeUnique<ReceiveBufferPool>(64, 4);
+  CopyOnWriteBuffer buffer = pool->GetBuffer();
+  buffer.SetData(kTestData, sizeof(kTestData));
+  pool.reset();
+  EXPECT_EQ(sizeof(kTestData), buffer.size());
+  EXPECT_EQ(0, memcmp(buffer.cdata(), kTestData, sizeof(kTestData)));
+}
+
+TEST(ReceiveBufferPoolTest, TakeOrCopyTakesLentBuffer) {
+  ReceiveBufferPool pool(64, 4);
+  CopyOnWriteBuffer buffer = pool.GetBuffer();
+  buffer.SetData(kTestData, sizeof(kTestData));
+  const uint8_t* data = buffer.cdata();
+
+  ReceiveBufferPool::ScopedLend lend(&buffer);
+  CopyOnWriteBuffer taken = ReceiveBufferPool::TakeOrCopy(data, buffer.size());
+  EXPECT_EQ(data, taken.cdata());
+  EXPECT_EQ(sizeof(kTestData), taken.size());
+  EXPECT_EQ(0u, buffer.size());
+  // A successful take leaves nothing to share, so writes stay in place.
+  EXPECT_EQ(data, taken.data());
+}
+
+TEST(ReceiveBufferPoolTest, TakeOrCopyCopiesPartOfLentBuffer) {
+  ReceiveBufferPool pool(64, 4);
+  CopyOnWriteBuffer buffer = pool.GetBuffer();
+  buffer.SetData(kTestData, sizeof(kTestData));
+  const uint8_t* data = buffer.cdata();
+
+  ReceiveBufferPool::ScopedLend lend(&buffer);
+  CopyOnWriteBuffer copy = ReceiveBufferPool::TakeOrCopy(data + 1, 4);
+  EXPECT_NE(data + 1, copy.cdata());
+  EXPECT_EQ(0, memcmp(copy.cdata(), kTestData + 1, 4));
+  EXPECT_EQ(sizeof(kTestData), buffer.size());
+}
+
+TEST(ReceiveBufferPoolTest, TakeOrCopyTakesBufferOfEnclosingLend) {
+  ReceiveBufferPool pool(64, 4);
+  CopyOnWriteBuffer outer = pool.GetBuffer();
+  outer.SetData(kTestData, sizeof(kTestData));
+  const uint8_t* data = outer.cdata();
+  ReceiveBufferPool::ScopedLend outer_lend(&outer);
+
+  CopyOnWriteBuffer inner = pool.GetBuffer();
+  inner.SetData(kTestData, 4);
+  ReceiveBufferPool::ScopedLend inner_lend(&inner);
+  CopyOnWriteBuffer taken = ReceiveBufferPool::TakeOrCopy(data, outer.size());
+  EXPECT_EQ(data, taken.cdata());
+  EXPECT_EQ(0u, outer.size());
+  EXPECT_EQ(4u, inner.size());
+}
+
+TEST(ReceiveBufferPoolTest, TakeOrCopyCopiesBufferLentOnAnotherThread) {
+  ReceiveBufferPool pool(64, 4);
+  CopyOnWriteBuffer buffer = pool.GetBuffer();
+  buffer.SetData(kTestData, sizeof(kTestData));
+  const uint8_t* data = buffer.cdata();
+  ReceiveBufferPool::ScopedLend lend(&buffer);
+
+  std::unique_ptr<Thread> thread = Thread::Create();
+  thread->Start();
+  CopyOnWriteBuffer copy = thread->Invoke<CopyOnWriteBuffer>(
+      RTC_FROM_HERE,
+      [data] { return ReceiveBufferPool::TakeOrCopy(data, sizeof(kTestData)); });
+  EXPECT_NE(data, copy.cdata());
+  EXPECT_EQ(0, memcmp(copy.cdata(), kTestData, sizeof(kTestData)));
+  EXPECT_EQ(sizeof(kTestData), buffer.size());
+}
+
+TEST(ReceiveBufferPoolTest, TakeOrCopyCopiesWhenNothingIsLent) {
+  CopyOnWriteBuffer copy =
+      ReceiveBufferPool::TakeOrCopy(kTestData, sizeof(kTestData));
+  EXPECT_NE(kTestData, copy.cdata());
+  EXPECT_EQ(0, memcmp(copy.cdata(), kTestData, sizeof(kTestData)));
+}
+
+}  // namespace rtc
@@ -16,6 +16,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/refcountedobject.h"
 #include "rtc_base/sslidentity.h"
+#include "rtc_base/timeutils.h"
 
 namespace rtc {
 
@@ -55,6 +56,12 @@ class RTCCertificateGenerationTask : public RefCountInterface,
   }
   ~RTCCertificateGenerationTask() override {}
 
+  // Sets the result ahead of time, for a task that starts with
+  // |MSG_GENERATE_DONE|.
+  void set_certificate(const scoped_refptr<RTCCertificate>& certificate) {
+    certificate_ = certificate;
+  }
+
   // Handles |MSG_GENERATE| and its follow-up |MSG_GENERATE_DONE|.
   void OnMessage(Message* msg) override {
     switch (msg->message_id) {
@@ -99,8 +106,39 @@ class RTCCertificateGenerationTask : public RefCountInterface,
   scoped_refptr<RTCCertificate> certificate_;
 };
 
+bool KeyParamsEqual(const KeyParams& a, const KeyParams& b) {
+  if (a.type() != b.type())
+    return false;
+  if (a.type() == KT_RSA) {
+    return a.rsa_params().mod_size == b.rsa_params().mod_size &&
+           a.rsa_params().pub_exp == b.rsa_params().pub_exp;
+  }
+  return a.ec_curve() == b.ec_curve();
+}
+
 }  // namespace
 
+// Hands the certificates the pool's generator made to the pool. It holds a
+// reference to the pool so that the pool outlives pending generations.
+class RTCCertificatePool::RefillCallback
+    : public RTCCertificateGeneratorCallback {
+ public:
+  RefillCallback(const scoped_refptr<RTCCertificatePool>& pool,
+                 const KeyParams& key_params)
+      : pool_(pool), key_params_(key_params) {}
+
+  void OnSuccess(const scoped_refptr<RTCCertificate>& certificate) override {
+    pool_->OnCertificateGenerated(key_params_, certificate);
+  }
+  void OnFailure() override {
+    pool_->OnCertificateGenerated(key_params_, nullptr);
+  }
+
+ private:
+  const scoped_refptr<RTCCertificatePool> pool_;
+  const KeyParams key_params_;
+};
+
 // static
 scoped_refptr<RTCCertificate>
 RTCCertificateGenerator::GenerateCertificate(
@@ -139,6 +177,19 @@ RTCCertificateGenerator::RTCCertificateGenerator(
   RTC_DCHECK(worker_thread_);
 }
 
+RTCCertificateGenerator::RTCCertificateGenerator(
+    Thread* signaling_thread,
+    Thread* worker_thread,
+    const scoped_refptr<RTCCertificatePool>& pool)
+    : signaling_thread_(signaling_thread),
+      worker_thread_(worker_thread),
+      pool_(pool) {
+  RTC_DCHECK(signaling_thread_);
+  RTC_DCHECK(worker_thread_);
+}
+
+RTCCertificateGenerator::~RTCCertificateGenerator() {}
+
 void RTCCertificateGenerator::GenerateCertificateAsync(
     const KeyParams& key_params,
     const Optional<uint64_t>& expires_ms,
@@ -154,8 +205,107 @@ void RTCCertificateGenerator::GenerateCertificateAsync(
           new RefCountedObject<RTCCertificateGenerationTask>(
               signaling_thread_, worker_thread_, key_params, expires_ms,
               callback));
+  scoped_refptr<RTCCertificate> pooled_certificate;
+  if (pool_ && !expires_ms)
+    pooled_certificate = pool_->TakeCertificate(key_params);
+  if (pooled_certificate) {
+    // Still invoke the callback asynchronously, as promised.
+    msg_data->data()->set_certificate(pooled_certificate);
+    signaling_thread_->Post(RTC_FROM_HERE, msg_data->data().get(),
+                            MSG_GENERATE_DONE, msg_data);
+    return;
+  }
   worker_thread_->Post(RTC_FROM_HERE, msg_data->data().get(), MSG_GENERATE,
                        msg_data);
 }
 
+RTCCertificatePool::RTCCertificatePool(Thread* signaling_thread,
+                                       Thread* worker_thread,
+                                       const Config& config)
+    : signaling_thread_(signaling_thread),
+      config_(config),
+      generator_(signaling_thread, worker_thread) {}
+
+RTCCertificatePool::~RTCCertificatePool() {}
+
+void RTCCertificatePool::Prepare(const KeyParams& key_params) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  if (!key_params.IsValid())
+    return;
+  Refill(FindOrAddEntry(key_params));
+}
+
+scoped_refptr<RTCCertificate> RTCCertificatePool::TakeCertificate(
+    const KeyParams& key_params) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  if (!key_params.IsValid())
+    return nullptr;
+  Entry* entry = FindOrAddEntry(key_params);
+  // Refill first, which drops expired certificates, and again after taking
+  // one so that it is replaced.
+  Refill(entry);
+  if (entry->ready.empty())
+    return nullptr;
+  scoped_refptr<RTCCertificate> certificate = entry->ready.front().certificate;
+  entry->ready.pop_front();
+  Refill(entry);
+  return certificate;
+}
+
+size_t RTCCertificatePool::num_ready(const KeyParams& key_params) const {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  const Entry* entry = FindEntry(key_params);
+  return entry ? entry->ready.size() : 0;
+}
+
+RTCCertificatePool::Entry* RTCCertificatePool::FindEntry(
+    const KeyParams& key_params) {
+  for (Entry& entry : entries_) {
+    if (KeyParamsEqual(entry.key_params, key_params))
+      return &entry;
+  }
+  return nullptr;
+}
+
+const RTCCertificatePool::Entry* RTCCertificatePool::FindEntry(
+    const KeyParams& key_params) const {
+  return const_cast<RTCCertificatePool*>(this)->FindEntry(key_params);
+}
+
+RTCCertificatePool::Entry* RTCCertificatePool::FindOrAddEntry(
+    const KeyParams& key_params) {
+  Entry* entry = FindEntry(key_params);
+  if (entry)
+    return entry;
+  entries_.emplace_back(key_params);
+  return &entries_.back();
+}
+
+void RTCCertificatePool::Refill(Entry* entry) {
+  const int64_t now_ms = TimeMillis();
+  while (!entry->ready.empty() &&
+         now_ms - entry->ready.front().created_ms > config_.max_age_ms) {
+    entry->ready.pop_front();
+  }
+  while (entry->ready.size() + entry->pending < config_.size) {
+    ++entry->pending;
+    generator_.GenerateCertificateAsync(
+        entry->key_params, Optional<uint64_t>(),
+        new RefCountedObject<RefillCallback>(this, entry->key_params));
+  }
+}
+
+void RTCCertificatePool::OnCertificateGenerated(
+    const KeyParams& key_params,
+    const scoped_refptr<RTCCertificate>& certificate) {
+  RTC_DCHECK(signaling_thread_->IsCurrent());
+  Entry* entry = FindEntry(key_params);
+  RTC_DCHECK(entry);
+  RTC_DCHECK_GT(entry->pending, 0);
+  --entry->pending;
+  // Don't retry failures; the next |TakeCertificate| will.
+  if (certificate)
+    entry->ready.push_back({TimeMillis(), certificate});
+}
+
 }  // namespace rtc
@@ -11,6 +11,9 @@
 #ifndef RTC_BASE_RTCCERTIFICATEGENERATOR_H_
 #define RTC_BASE_RTCCERTIFICATEGENERATOR_H_
 
+#include <deque>
+#include <vector>
+
 #include "api/optional.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/rtccertificate.h"
@@ -20,6 +23,8 @@
 
 namespace rtc {
 
+class RTCCertificatePool;
+
 // See |RTCCertificateGeneratorInterface::GenerateCertificateAsync|.
 class RTCCertificateGeneratorCallback : public RefCountInterface {
  public:
@@ -64,7 +69,13 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
       const Optional<uint64_t>& expires_ms);
 
   RTCCertificateGenerator(Thread* signaling_thread, Thread* worker_thread);
-  ~RTCCertificateGenerator() override {}
+  // Certificates without a specific |expires_ms| are taken from |pool| when it
+  // has one ready, instead of being generated. |pool| must use the same
+  // signaling thread.
+  RTCCertificateGenerator(Thread* signaling_thread,
+                          Thread* worker_thread,
+                          const scoped_refptr<RTCCertificatePool>& pool);
+  ~RTCCertificateGenerator() override;
 
   // |RTCCertificateGeneratorInterface| overrides.
   // If |expires_ms| is specified, the certificate will expire in approximately
@@ -79,6 +90,72 @@ class RTCCertificateGenerator : public RTCCertificateGeneratorInterface {
  private:
   Thread* const signaling_thread_;
   Thread* const worker_thread_;
+  const scoped_refptr<RTCCertificatePool> pool_;
+};
+
+// Keeps certificates generated ahead of time, so that handing one out doesn't
+// have to wait for key generation, which can take seconds for RSA. For every
+// |KeyParams| that has been asked for, the pool generates certificates on the
+// worker thread until |Config::size| of them are ready, and replaces each one
+// that is taken. Certificates that have been waiting for longer than
+// |Config::max_age_ms| are discarded instead of handed out, so that they
+// aren't close to expiring when used. All methods must be called on the
+// signaling thread.
+class RTCCertificatePool : public RefCountInterface {
+ public:
+  struct Config {
+    // The number of certificates to keep ready for each |KeyParams|.
+    size_t size = 1;
+    // The longest a certificate may wait in the pool.
+    int64_t max_age_ms = 24 * 60 * 60 * 1000;
+  };
+
+  RTCCertificatePool(Thread* signaling_thread,
+                     Thread* worker_thread,
+                     const Config& config);
+
+  // Starts keeping certificates with |key_params| ready.
+  void Prepare(const KeyParams& key_params);
+
+  // Returns a certificate with |key_params| that was generated ahead of time,
+  // or null if none is ready (yet). In both cases, the pool starts generating
+  // a replacement.
+  scoped_refptr<RTCCertificate> TakeCertificate(const KeyParams& key_params);
+
+  // The number of certificates with |key_params| that are ready.
+  size_t num_ready(const KeyParams& key_params) const;
+
+ protected:
+  ~RTCCertificatePool() override;
+
+ private:
+  class RefillCallback;
+
+  struct ReadyCertificate {
+    int64_t created_ms;
+    scoped_refptr<RTCCertificate> certificate;
+  };
+  struct Entry {
+    explicit Entry(const KeyParams& key_params) : key_params(key_params) {}
+
+    KeyParams key_params;
+    std::deque<ReadyCertificate> ready;
+    size_t pending = 0;
+  };
+
+  Entry* FindEntry(const KeyParams& key_params);
+  const Entry* FindEntry(const KeyParams& key_params) const;
+  Entry* FindOrAddEntry(const KeyParams& key_params);
+  // Drops expired certificates and starts generating until |config_.size| are
+  // ready or pending.
+  void Refill(Entry* entry);
+  void OnCertificateGenerated(const KeyParams& key_params,
+                              const scoped_refptr<RTCCertificate>& certificate);
+
+  Thread* const signaling_thread_;
+  const Config config_;
+  RTCCertificateGenerator generator_;
+  std::vector<Entry> entries_;
 };
 
 }  // namespace rtc
@@ -35,6 +35,7 @@ class RTCCertificateGeneratorFixture : public RTCCertificateGeneratorCallback {
   ~RTCCertificateGeneratorFixture() override {}
 
   RTCCertificateGenerator* generator() const { return generator_.get(); }
+  Thread* worker_thread() const { return worker_thread_.get(); }
   RTCCertificate* certificate() const { return certificate_.get(); }
 
   void OnSuccess(const scoped_refptr<RTCCertificate>& certificate) override {
@@ -149,4 +150,44 @@ TEST_F(RTCCertificateGeneratorTest, GenerateWithInvalidParamsShouldFail) {
   EXPECT_FALSE(fixture_->certificate());
 }
 
+TEST_F(RTCCertificateGeneratorTest, GenerateAsyncTakesPooledCertificate) {
+  RTCCertificatePool::Config config;
+  config.size = 2;
+  scoped_refptr<RTCCertificatePool> pool(
+      new RefCountedObject<RTCCertificatePool>(
+          Thread::Current(), fixture_->worker_thread(), config));
+  pool->Prepare(KeyParams::ECDSA());
+  EXPECT_EQ_WAIT(2u, pool->num_ready(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+  EXPECT_EQ(0u, pool->num_ready(KeyParams::RSA()));
+
+  RTCCertificateGenerator generator(Thread::Current(),
+                                    fixture_->worker_thread(), pool);
+  generator.GenerateCertificateAsync(KeyParams::ECDSA(), Optional<uint64_t>(),
+                                     fixture_);
+  // The pooled certificate is handed out right away, but still
+  // asynchronously.
+  EXPECT_EQ(1u, pool->num_ready(KeyParams::ECDSA()));
+  EXPECT_FALSE(fixture_->GenerateAsyncCompleted());
+  EXPECT_TRUE_WAIT(fixture_->GenerateAsyncCompleted(), kGenerationTimeoutMs);
+  EXPECT_TRUE(fixture_->certificate());
+  // The taken certificate is replaced.
+  EXPECT_EQ_WAIT(2u, pool->num_ready(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+}
+
+TEST_F(RTCCertificateGeneratorTest, PoolDiscardsOldCertificates) {
+  RTCCertificatePool::Config config;
+  config.max_age_ms = 0;
+  scoped_refptr<RTCCertificatePool> pool(
+      new RefCountedObject<RTCCertificatePool>(
+          Thread::Current(), fixture_->worker_thread(), config));
+  EXPECT_FALSE(pool->TakeCertificate(KeyParams::ECDSA()));
+  EXPECT_EQ_WAIT(1u, pool->num_ready(KeyParams::ECDSA()),
+                 kGenerationTimeoutMs);
+  Thread::SleepMs(2);
+  EXPECT_FALSE(pool->TakeCertificate(KeyParams::ECDSA()));
+  EXPECT_EQ(0u, pool->num_ready(KeyParams::ECDSA()));
+}
+
 }  // namespace rtc
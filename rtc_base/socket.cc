@@ -10,6 +10,10 @@
 
 #include "rtc_base/socket.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 namespace rtc {
 
 PacketInfo::PacketInfo() = default;
@@ -24,4 +28,65 @@ SentPacket::SentPacket(int64_t packet_id,
                        const rtc::PacketInfo& info)
     : packet_id(packet_id), send_time_ms(send_time_ms), info(info) {}
 
+const size_t Socket::kMaxRecvBatchSize;
+
+int Socket::RecvFromBatch(ReceivedDatagram* datagrams, size_t count) {
+  if (count == 0)
+    return 0;
+  ReceivedDatagram& datagram = datagrams[0];
+  if (!datagram.overflow_buffer) {
+    int received = RecvFrom(datagram.buffer, datagram.buffer_size,
+                            &datagram.source, &datagram.timestamp);
+    if (received < 0)
+      return received;
+    datagram.length = static_cast<size_t>(received);
+    datagram.truncated = false;
+    return 1;
+  }
+  // RecvFrom() can't scatter, so receive into the overflow buffer and move
+  // the start of the datagram into |buffer| afterwards.
+  char* overflow = static_cast<char*>(datagram.overflow_buffer);
+  int received = RecvFrom(overflow, datagram.overflow_buffer_size,
+                          &datagram.source, &datagram.timestamp);
+  if (received < 0)
+    return received;
+  datagram.length = static_cast<size_t>(received);
+  datagram.truncated = false;
+  size_t head = std::min(datagram.length, datagram.buffer_size);
+  memcpy(datagram.buffer, overflow, head);
+  memmove(overflow, overflow + head, datagram.length - head);
+  return 1;
+}
+
+int Socket::SendToBatch(const OutgoingDatagram* datagrams, size_t count) {
+  size_t sent = 0;
+  for (; sent < count; ++sent) {
+    const OutgoingDatagram& datagram = datagrams[sent];
+    if (SendTo(datagram.data, datagram.length, datagram.destination) < 0)
+      break;
+  }
+  if (sent == 0 && count > 0)
+    return SOCKET_ERROR;
+  return static_cast<int>(sent);
+}
+
+int Socket::SendGathered(const OutgoingBuffer* buffers, size_t count) {
+  size_t total = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const OutgoingBuffer& buffer = buffers[i];
+    if (buffer.length == 0)
+      continue;
+    int sent = Send(buffer.data, buffer.length);
+    if (sent < 0) {
+      if (total == 0)
+        return sent;
+      break;
+    }
+    total += static_cast<size_t>(sent);
+    if (static_cast<size_t>(sent) < buffer.length)
+      break;
+  }
+  return static_cast<int>(total);
+}
+
 }  // namespace rtc
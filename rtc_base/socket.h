@@ -167,6 +167,39 @@ struct SentPacket {
   rtc::PacketInfo info;
 };
 
+// One slot of a batched receive, see Socket::RecvFromBatch(). The caller
+// provides |buffer| and |buffer_size|, and optionally an overflow buffer; the
+// remaining fields are filled in for every datagram that was received.
+struct ReceivedDatagram {
+  void* buffer = nullptr;
+  size_t buffer_size = 0;
+  // If set, the part of a datagram that doesn't fit in |buffer| continues
+  // here instead of being cut off.
+  void* overflow_buffer = nullptr;
+  size_t overflow_buffer_size = 0;
+  // Number of bytes received, written to |buffer| and then, past
+  // |buffer_size|, to |overflow_buffer|.
+  size_t length = 0;
+  // True if the datagram did not fit and was cut short.
+  bool truncated = false;
+  SocketAddress source;
+  // Receive time in microseconds, or -1 if unknown.
+  int64_t timestamp = -1;
+};
+
+// One datagram of a batched send, see Socket::SendToBatch().
+struct OutgoingDatagram {
+  const void* data = nullptr;
+  size_t length = 0;
+  SocketAddress destination;
+};
+
+// One piece of a gathered stream send, see Socket::SendGathered().
+struct OutgoingBuffer {
+  const void* data = nullptr;
+  size_t length = 0;
+};
+
 // General interface for the socket implementations of various networks.  The
 // methods match those of normal UNIX sockets very closely.
 class Socket {
@@ -191,6 +224,25 @@ class Socket {
                        size_t cb,
                        SocketAddress* paddr,
                        int64_t* timestamp) = 0;
+  // Receives up to |count| datagrams into |datagrams| with as few system
+  // calls as the platform allows. Returns the number of datagrams received,
+  // at most kMaxRecvBatchSize, or SOCKET_ERROR, in which case GetError() tells
+  // why (typically EWOULDBLOCK once the socket has been drained). The default
+  // implementation receives a single datagram using RecvFrom().
+  virtual int RecvFromBatch(ReceivedDatagram* datagrams, size_t count);
+  static const size_t kMaxRecvBatchSize = 64;
+  // Sends |count| datagrams with as few system calls as the platform allows.
+  // Returns the number of datagrams sent, which may be fewer than |count| if
+  // the socket stopped accepting data part way through, or SOCKET_ERROR if
+  // not even the first datagram could be sent. The default implementation
+  // calls SendTo() once per datagram.
+  virtual int SendToBatch(const OutgoingDatagram* datagrams, size_t count);
+  // Sends the concatenation of |count| buffers on a connected stream socket,
+  // with a single system call where the platform allows. Returns the number
+  // of bytes sent, which like for Send() may be fewer than the total, or
+  // SOCKET_ERROR if nothing could be sent. The default implementation calls
+  // Send() once per buffer until one of them is sent only in part.
+  virtual int SendGathered(const OutgoingBuffer* buffers, size_t count);
   virtual int Listen(int backlog) = 0;
   virtual Socket *Accept(SocketAddress *paddr) = 0;
   virtual int Close() = 0;
@@ -215,6 +267,11 @@ class Socket {
     OPT_RTP_SENDTIME_EXTN_ID,  // This is a non-traditional socket option param.
                                // This is specific to libjingle and will be used
                                // if SendTime option is needed at socket level.
+    OPT_REUSEPORT,   // Allow several sockets to bind the same address and
+                     // let the kernel balance datagrams between them. Must
+                     // be set before Bind().
+    OPT_NOTSENT_LOWAT,  // Limit in bytes on the data that a TCP socket holds
+                        // unsent before it stops accepting more.
   };
   virtual int GetOption(Option opt, int* value) = 0;
   virtual int SetOption(Option opt, int value) = 0;
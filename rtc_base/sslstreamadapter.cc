@@ -129,6 +129,10 @@ bool SSLStreamAdapter::GetSslCipherSuite(int* cipher_suite) {
   return false;
 }
 
+bool SSLStreamAdapter::GetHandshakeDurationMs(int64_t* duration_ms) const {
+  return false;
+}
+
 bool SSLStreamAdapter::ExportKeyingMaterial(const std::string& label,
                                             const uint8_t* context,
                                             size_t context_len,
@@ -217,6 +217,10 @@ class SSLStreamAdapter : public StreamAdapterInterface {
 
   virtual int GetSslVersion() const = 0;
 
+  // Retrieves how long the handshake took, from sending or receiving the
+  // first handshake message until it completed, if it has completed.
+  virtual bool GetHandshakeDurationMs(int64_t* duration_ms) const;
+
   // Key Exporter interface from RFC 5705
   // Arguments are:
   // label               -- the exporter label.
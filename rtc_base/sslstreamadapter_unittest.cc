@@ -613,6 +613,13 @@ class SSLStreamAdapterTestBase : public testing::Test,
       return server_ssl_->GetSslCipherSuite(retval);
   }
 
+  bool GetHandshakeDurationMs(bool client, int64_t* duration_ms) {
+    if (client)
+      return client_ssl_->GetHandshakeDurationMs(duration_ms);
+    else
+      return server_ssl_->GetHandshakeDurationMs(duration_ms);
+  }
+
   int GetSslVersion(bool client) {
     if (client)
       return client_ssl_->GetSslVersion();
@@ -1113,6 +1120,17 @@ TEST_P(SSLStreamAdapterTestDTLS, TestDTLSConnect) {
   TestHandshake();
 };
 
+// Test that the handshake duration is known once the handshake is done.
+TEST_P(SSLStreamAdapterTestDTLS, TestDTLSHandshakeDuration) {
+  int64_t duration_ms;
+  EXPECT_FALSE(GetHandshakeDurationMs(true, &duration_ms));
+  TestHandshake();
+  ASSERT_TRUE(GetHandshakeDurationMs(true, &duration_ms));
+  EXPECT_LE(0, duration_ms);
+  ASSERT_TRUE(GetHandshakeDurationMs(false, &duration_ms));
+  EXPECT_LE(0, duration_ms);
+};
+
 // Test that we can make a handshake work if the first packet in
 // each direction is lost. This gives us predictable loss
 // rather than having to tune random
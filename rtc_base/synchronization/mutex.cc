@@ -0,0 +1,203 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/mutex.h"
+
+#include <algorithm>
+#include <map>
+#include <thread>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/timeutils.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kUnnamed[] = "Unnamed";
+
+// About as long as a context switch takes, in case the holder is about to
+// let go.
+const int kSpinCount = 100;
+
+// Spinning can't help when the holder can't run at the same time.
+bool ShouldSpin() {
+  static const bool should_spin = std::thread::hardware_concurrency() != 1;
+  return should_spin;
+}
+
+inline void Pause() {
+#if defined(WEBRTC_WIN)
+  YieldProcessor();
+#elif defined(__i386__) || defined(__x86_64__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__) || (defined(__ARM_ARCH) && __ARM_ARCH >= 7)
+  __asm__ __volatile__("yield");
+#endif
+}
+
+struct WaitStats {
+  int64_t num_waits = 0;
+  int64_t wait_time_us_total = 0;
+  int64_t wait_time_us_max = 0;
+};
+
+class LockContentionRegistry {
+ public:
+  static LockContentionRegistry* Instance() {
+    static LockContentionRegistry* const instance =
+        new LockContentionRegistry();
+    return instance;
+  }
+
+  void AddWait(const char* name, int64_t wait_time_us) {
+    rtc::CritScope lock(&crit_);
+    WaitStats& stats = stats_[name];
+    ++stats.num_waits;
+    stats.wait_time_us_total += wait_time_us;
+    stats.wait_time_us_max = std::max(stats.wait_time_us_max, wait_time_us);
+  }
+
+  std::vector<LockContention::Entry> Get() {
+    std::vector<LockContention::Entry> entries;
+    {
+      rtc::CritScope lock(&crit_);
+      entries.reserve(stats_.size());
+      for (const auto& it : stats_) {
+        LockContention::Entry entry;
+        entry.name = it.first;
+        entry.num_waits = it.second.num_waits;
+        entry.wait_time_us_total = it.second.wait_time_us_total;
+        entry.wait_time_us_max = it.second.wait_time_us_max;
+        entries.push_back(std::move(entry));
+      }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const LockContention::Entry& a,
+                 const LockContention::Entry& b) {
+                return a.wait_time_us_total > b.wait_time_us_total;
+              });
+    return entries;
+  }
+
+  void Reset() {
+    rtc::CritScope lock(&crit_);
+    stats_.clear();
+  }
+
+ private:
+  rtc::CriticalSection crit_;
+  // By name rather than by address, since each translation unit may have
+  // its own copy of a name.
+  std::map<std::string, WaitStats> stats_ RTC_GUARDED_BY(crit_);
+};
+
+}  // namespace
+
+Mutex::Mutex() : Mutex(kUnnamed) {}
+
+Mutex::Mutex(const char* name) : name_(name) {
+#if defined(WEBRTC_WIN)
+  InitializeSRWLock(&lock_);
+#else
+  pthread_mutex_init(&mutex_, nullptr);
+#endif
+#if RTC_DCHECK_IS_ON
+  owner_.store(rtc::PlatformThreadRef(), std::memory_order_relaxed);
+#endif
+}
+
+Mutex::~Mutex() {
+#if !defined(WEBRTC_WIN)
+  pthread_mutex_destroy(&mutex_);
+#endif
+}
+
+void Mutex::Lock() {
+  if (!TryLockNative())
+    LockSlow();
+#if RTC_DCHECK_IS_ON
+  owner_.store(rtc::CurrentThreadRef(), std::memory_order_relaxed);
+#endif
+}
+
+bool Mutex::TryLock() {
+  if (!TryLockNative())
+    return false;
+#if RTC_DCHECK_IS_ON
+  owner_.store(rtc::CurrentThreadRef(), std::memory_order_relaxed);
+#endif
+  return true;
+}
+
+void Mutex::Unlock() {
+#if RTC_DCHECK_IS_ON
+  RTC_DCHECK(rtc::IsThreadRefEqual(owner_.load(std::memory_order_relaxed),
+                                   rtc::CurrentThreadRef()));
+  owner_.store(rtc::PlatformThreadRef(), std::memory_order_relaxed);
+#endif
+#if defined(WEBRTC_WIN)
+  ReleaseSRWLockExclusive(&lock_);
+#else
+  pthread_mutex_unlock(&mutex_);
+#endif
+}
+
+bool Mutex::TryLockNative() {
+#if defined(WEBRTC_WIN)
+  return TryAcquireSRWLockExclusive(&lock_) != FALSE;
+#else
+  return pthread_mutex_trylock(&mutex_) == 0;
+#endif
+}
+
+void Mutex::LockSlow() {
+#if RTC_DCHECK_IS_ON
+  RTC_DCHECK(!rtc::IsThreadRefEqual(owner_.load(std::memory_order_relaxed),
+                                    rtc::CurrentThreadRef()))
+      << "Mutex " << name_ << " is locked recursively.";
+#endif
+  if (ShouldSpin()) {
+    for (int i = 0; i < kSpinCount; ++i) {
+      Pause();
+      if (TryLockNative())
+        return;
+    }
+  }
+  const bool measure = LockContention::IsEnabled();
+  const int64_t start_time_us = measure ? rtc::TimeMicros() : 0;
+#if defined(WEBRTC_WIN)
+  AcquireSRWLockExclusive(&lock_);
+#else
+  pthread_mutex_lock(&mutex_);
+#endif
+  if (measure)
+    LockContention::AddWait(name_, rtc::TimeMicros() - start_time_us);
+}
+
+std::atomic<bool> LockContention::enabled_(false);
+
+LockContention::Entry::Entry() = default;
+LockContention::Entry::Entry(const Entry&) = default;
+LockContention::Entry::~Entry() = default;
+
+void LockContention::AddWait(const char* name, int64_t wait_time_us) {
+  LockContentionRegistry::Instance()->AddWait(name, wait_time_us);
+}
+
+std::vector<LockContention::Entry> LockContention::Get() {
+  return LockContentionRegistry::Instance()->Get();
+}
+
+void LockContention::Reset() {
+  LockContentionRegistry::Instance()->Reset();
+}
+
+}  // namespace webrtc
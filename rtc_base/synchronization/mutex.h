@@ -0,0 +1,117 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_SYNCHRONIZATION_MUTEX_H_
+#define RTC_BASE_SYNCHRONIZATION_MUTEX_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/platform_thread_types.h"
+#include "rtc_base/thread_annotations.h"
+
+#if defined(WEBRTC_WIN)
+// Include winsock2.h before including <windows.h> to maintain consistency with
+// win32.h. See criticalsection.h.
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+namespace webrtc {
+
+// A mutex that, unlike rtc::CriticalSection, can't be locked again by the
+// thread that holds it, which deadlocks (and RTC_DCHECKs). In exchange it
+// spins for a while before it sleeps when another thread holds it, which is
+// what the short critical sections of the media path want.
+class RTC_LOCKABLE Mutex {
+ public:
+  // Contention is reported by |name|, which must persist as globals do.
+  Mutex();
+  explicit Mutex(const char* name);
+  ~Mutex();
+
+  void Lock() RTC_EXCLUSIVE_LOCK_FUNCTION();
+  bool TryLock() RTC_EXCLUSIVE_TRYLOCK_FUNCTION(true);
+  void Unlock() RTC_UNLOCK_FUNCTION();
+
+ private:
+  bool TryLockNative();
+  void LockSlow();
+
+  const char* const name_;
+#if defined(WEBRTC_WIN)
+  SRWLOCK lock_;
+#else
+  pthread_mutex_t mutex_;
+#endif
+#if RTC_DCHECK_IS_ON
+  // To tell recursive locking from contention. Only written by the owner.
+  std::atomic<rtc::PlatformThreadRef> owner_;
+#endif
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(Mutex);
+};
+
+class RTC_SCOPED_LOCKABLE MutexLock {
+ public:
+  explicit MutexLock(Mutex* mutex) RTC_EXCLUSIVE_LOCK_FUNCTION(mutex)
+      : mutex_(mutex) {
+    mutex_->Lock();
+  }
+  ~MutexLock() RTC_UNLOCK_FUNCTION() { mutex_->Unlock(); }
+
+ private:
+  Mutex* const mutex_;
+  RTC_DISALLOW_COPY_AND_ASSIGN(MutexLock);
+};
+
+// Counts how often and how long threads wait for each Mutex that they don't
+// get by spinning, by the mutexes' names, to find the locks that are worth
+// splitting up or removing. It is off by default, in which case waiting
+// doesn't read the clock.
+class LockContention {
+ public:
+  struct Entry {
+    Entry();
+    Entry(const Entry&);
+    ~Entry();
+
+    std::string name;
+    int64_t num_waits = 0;
+    int64_t wait_time_us_total = 0;
+    int64_t wait_time_us_max = 0;
+  };
+
+  static void Enable(bool enabled) {
+    enabled_.store(enabled, std::memory_order_relaxed);
+  }
+  static bool IsEnabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  static void AddWait(const char* name, int64_t wait_time_us);
+
+  // Returns the mutexes that have been waited for, the most waited for
+  // first.
+  static std::vector<Entry> Get();
+  static void Reset();
+
+ private:
+  static std::atomic<bool> enabled_;
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_BASE_SYNCHRONIZATION_MUTEX_H_
@@ -0,0 +1,140 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/synchronization/mutex.h"
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/thread.h"
+
+namespace webrtc {
+
+namespace {
+
+const char kMutexName[] = "MutexTest";
+
+struct Counter {
+  Mutex mutex;
+  int value RTC_GUARDED_BY(mutex) = 0;
+};
+
+void IncrementCounter(void* obj) {
+  Counter* counter = static_cast<Counter*>(obj);
+  for (int i = 0; i < 10000; ++i) {
+    MutexLock lock(&counter->mutex);
+    ++counter->value;
+  }
+}
+
+struct LockingThreadParams {
+  Mutex* mutex;
+  rtc::Event* started;
+};
+
+void LockOnce(void* obj) {
+  LockingThreadParams* params = static_cast<LockingThreadParams*>(obj);
+  params->started->Set();
+  MutexLock lock(params->mutex);
+}
+
+struct TryLockParams {
+  Mutex* mutex;
+  bool locked;
+};
+
+void TryLockOnce(void* obj) {
+  TryLockParams* params = static_cast<TryLockParams*>(obj);
+  params->locked = params->mutex->TryLock();
+  if (params->locked)
+    params->mutex->Unlock();
+}
+
+class LockContentionTest : public testing::Test {
+ protected:
+  LockContentionTest() { LockContention::Reset(); }
+  ~LockContentionTest() override {
+    LockContention::Enable(false);
+    LockContention::Reset();
+  }
+
+  // Holds |mutex| for a while, while another thread waits for it.
+  void HoldWhileAnotherThreadWaits(Mutex* mutex) {
+    rtc::Event started(false, false);
+    LockingThreadParams params = {mutex, &started};
+    rtc::PlatformThread thread(&LockOnce, &params, "LockOnce");
+    mutex->Lock();
+    thread.Start();
+    started.Wait(rtc::Event::kForever);
+    rtc::Thread::SleepMs(20);
+    mutex->Unlock();
+    thread.Stop();
+  }
+};
+
+}  // namespace
+
+TEST(MutexTest, TryLockFailsWhileAnotherThreadHoldsIt) {
+  Mutex mutex;
+  TryLockParams params = {&mutex, false};
+  rtc::PlatformThread unlocked_thread(&TryLockOnce, &params, "TryLock");
+  unlocked_thread.Start();
+  unlocked_thread.Stop();
+  EXPECT_TRUE(params.locked);
+
+  mutex.Lock();
+  rtc::PlatformThread locked_thread(&TryLockOnce, &params, "TryLock");
+  locked_thread.Start();
+  locked_thread.Stop();
+  EXPECT_FALSE(params.locked);
+  mutex.Unlock();
+}
+
+TEST(MutexTest, SerializesThreads) {
+  static const int kNumThreads = 4;
+  Counter counter;
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&IncrementCounter, &counter, "Increment"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  MutexLock lock(&counter.mutex);
+  EXPECT_EQ(kNumThreads * 10000, counter.value);
+}
+
+TEST_F(LockContentionTest, CountsWaitsByName) {
+  LockContention::Enable(true);
+  Mutex mutex(kMutexName);
+  HoldWhileAnotherThreadWaits(&mutex);
+
+  std::vector<LockContention::Entry> entries = LockContention::Get();
+  ASSERT_EQ(1u, entries.size());
+  EXPECT_EQ(kMutexName, entries[0].name);
+  EXPECT_EQ(1, entries[0].num_waits);
+  EXPECT_GE(entries[0].wait_time_us_total, 10000);
+  EXPECT_EQ(entries[0].wait_time_us_total, entries[0].wait_time_us_max);
+
+  LockContention::Reset();
+  EXPECT_TRUE(LockContention::Get().empty());
+}
+
+TEST_F(LockContentionTest, CountsNothingWhenDisabled) {
+  Mutex mutex(kMutexName);
+  HoldWhileAnotherThreadWaits(&mutex);
+  EXPECT_TRUE(LockContention::Get().empty());
+}
+
+}  // namespace webrtc
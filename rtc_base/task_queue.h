@@ -12,6 +12,7 @@
 #define RTC_BASE_TASK_QUEUE_H_
 
 #include <memory>
+#include <string>
 #include <type_traits>
 #include <utility>
 
@@ -231,6 +232,8 @@ class RTC_LOCKABLE TaskQueue {
 
  private:
   class Impl;
+  // What rtc::TaskStats calls the queue.
+  const std::string name_;
   const scoped_refptr<Impl> impl_;
 
   RTC_DISALLOW_COPY_AND_ASSIGN(TaskQueue);
@@ -0,0 +1,598 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+// TaskQueue implementation that multiplexes every TaskQueue in the process
+// onto one fixed pool of worker threads, instead of giving each queue its own
+// thread. Each queue is a serial sequence: at most one worker runs its tasks
+// at any time, in posting order, so TaskQueue::Current(), IsCurrent() and
+// SequencedTaskChecker behave as with the other implementations. Only the OS
+// thread a given queue runs on may change between tasks.
+//
+// A queue with pending tasks is "runnable" and sits in exactly one worker's
+// deque. Workers pop runnable queues from the front of their own deque and,
+// when it is empty, steal from the back of the others. A queue runs at most
+// kMaxTasksPerSlice tasks before it goes back to the end of the deque, so that
+// a busy queue can't starve the others sharing its worker.
+
+#include "rtc_base/task_queue.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/event.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/refcountedobject.h"
+#include "rtc_base/task_queue_posix.h"
+#include "rtc_base/task_stats.h"
+#include "rtc_base/timerwheel.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+using internal::GetQueuePtrTls;
+using internal::AutoSetCurrentQueuePtr;
+
+namespace {
+
+using Priority = TaskQueue::Priority;
+
+// Upper bound on the number of tasks a queue runs before yielding its worker.
+const int kMaxTasksPerSlice = 16;
+// The pool never uses fewer workers than this, so that a queue blocking in
+// a task (e.g. waiting on an rtc::Event set by another queue) can't deadlock
+// the process on a single core machine.
+const int kMinWorkers = 4;
+// Delayed tasks due within this many milliseconds of each other are posted
+// together. Set with the rtc_task_queue_pool_timer_slack_ms GN arg.
+#if defined(RTC_TASK_QUEUE_POOL_TIMER_SLACK_MS)
+const int kTimerSlackMs = RTC_TASK_QUEUE_POOL_TIMER_SLACK_MS;
+#else
+const int kTimerSlackMs = 0;
+#endif
+
+// What the pool schedules: a serial sequence of tasks. Implemented by
+// TaskQueue::Impl.
+class Sequence : public RefCountInterface {
+ public:
+  virtual void PostTask(std::unique_ptr<QueuedTask> task) = 0;
+  // Runs up to kMaxTasksPerSlice tasks on the calling worker.
+  virtual void RunSlice() = 0;
+  virtual bool high_priority() const = 0;
+
+ protected:
+  ~Sequence() override {}
+};
+
+typedef scoped_refptr<Sequence> QueueRef;
+
+// A delayed task waiting in the pool's timer wheel.
+struct DelayedTask : public TimerWheel::Entry {
+  QueueRef queue;
+  std::unique_ptr<QueuedTask> task;
+};
+
+typedef std::pair<QueueRef, std::unique_ptr<QueuedTask>> DueTask;
+
+class WorkerPool {
+ public:
+  static WorkerPool* Instance();
+
+  // Makes |queue| runnable on some worker. Any thread.
+  void Schedule(QueueRef queue);
+
+  void PostDelayed(QueueRef queue,
+                   std::unique_ptr<QueuedTask> task,
+                   uint32_t milliseconds);
+  // Deletes the delayed tasks of |queue| that haven't fired yet.
+  void CancelDelayed(const Sequence* queue);
+
+ private:
+  struct Worker {
+    Worker(WorkerPool* pool, int index)
+        : pool(pool),
+          index(index),
+          thread(&WorkerPool::WorkerMain, this, "TaskQueuePool") {}
+    WorkerPool* const pool;
+    const int index;
+    PlatformThread thread;
+    CriticalSection lock;
+    std::deque<QueueRef> runnable RTC_GUARDED_BY(lock);
+  };
+
+  WorkerPool();
+  ~WorkerPool() = delete;
+
+  static void WorkerMain(void* context);
+  static void TimerMain(void* context);
+
+  QueueRef PopLocal(Worker* worker);
+  QueueRef Steal(Worker* thief);
+  void WaitForWork();
+  void RunTimers();
+
+  DelayedTask* NewTimer() RTC_EXCLUSIVE_LOCKS_REQUIRED(timer_lock_);
+  // Takes the queue and task out of |timer| and recycles it.
+  DueTask ReleaseTimer(DelayedTask* timer)
+      RTC_EXCLUSIVE_LOCKS_REQUIRED(timer_lock_);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  // Number of queues sitting in worker deques.
+  std::atomic<int> runnable_count_;
+  std::atomic<int> sleeping_workers_;
+  std::atomic<unsigned> next_worker_;
+  pthread_mutex_t idle_mutex_;
+  pthread_cond_t idle_cond_;
+
+  CriticalSection timer_lock_;
+  TimerWheel timers_ RTC_GUARDED_BY(timer_lock_);
+  // Unscheduled DelayedTasks kept for reuse.
+  std::vector<std::unique_ptr<DelayedTask>> free_timers_
+      RTC_GUARDED_BY(timer_lock_);
+  // When the timer thread is due to wake up next.
+  int64_t timer_wakeup_ms_ RTC_GUARDED_BY(timer_lock_) =
+      std::numeric_limits<int64_t>::max();
+  Event timer_wakeup_;
+  PlatformThread timer_thread_;
+};
+
+// Holds the Worker that the calling thread is, if any.
+pthread_key_t g_worker_tls = 0;
+
+void InitializeWorkerTls() {
+  RTC_CHECK(pthread_key_create(&g_worker_tls, nullptr) == 0);
+}
+
+pthread_key_t GetWorkerTls() {
+  static pthread_once_t init_once = PTHREAD_ONCE_INIT;
+  RTC_CHECK(pthread_once(&init_once, &InitializeWorkerTls) == 0);
+  return g_worker_tls;
+}
+
+// Leaked on purpose; workers run for the lifetime of the process.
+std::atomic<WorkerPool*> g_pool(nullptr);
+pthread_mutex_t g_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Threads don't survive fork(), so a child (e.g. a gtest death test) gets a
+// pool of its own the first time it uses a TaskQueue. The parent's pool is
+// abandoned along with whatever it had queued.
+void ForgetPoolInChild() {
+  g_pool.store(nullptr);
+  pthread_mutex_init(&g_pool_mutex, nullptr);
+}
+
+void InstallForkHandler() {
+  RTC_CHECK_EQ(0, pthread_atfork(nullptr, nullptr, &ForgetPoolInChild));
+}
+
+// static
+WorkerPool* WorkerPool::Instance() {
+  WorkerPool* pool = g_pool.load(std::memory_order_acquire);
+  if (pool)
+    return pool;
+  pthread_mutex_lock(&g_pool_mutex);
+  pool = g_pool.load(std::memory_order_relaxed);
+  if (!pool) {
+    static pthread_once_t atfork_once = PTHREAD_ONCE_INIT;
+    RTC_CHECK(pthread_once(&atfork_once, &InstallForkHandler) == 0);
+    pool = new WorkerPool();
+    g_pool.store(pool, std::memory_order_release);
+  }
+  pthread_mutex_unlock(&g_pool_mutex);
+  return pool;
+}
+
+WorkerPool::WorkerPool()
+    : runnable_count_(0),
+      sleeping_workers_(0),
+      next_worker_(0),
+      timers_(kTimerSlackMs),
+      timer_wakeup_(false, false),
+      timer_thread_(&WorkerPool::TimerMain, this, "TaskQueuePoolTimer") {
+  pthread_mutex_init(&idle_mutex_, nullptr);
+  pthread_cond_init(&idle_cond_, nullptr);
+  int num_workers =
+      std::max(kMinWorkers, static_cast<int>(sysconf(_SC_NPROCESSORS_ONLN)));
+  for (int i = 0; i < num_workers; ++i)
+    workers_.emplace_back(new Worker(this, i));
+  // All workers must exist before any of them starts stealing.
+  for (auto& worker : workers_)
+    worker->thread.Start();
+  timer_thread_.Start();
+}
+
+void WorkerPool::Schedule(QueueRef queue) {
+  // Keep the queue on the posting worker when possible; it is likely to be
+  // warm in that core's cache. Otherwise spread queues round-robin.
+  Worker* worker = static_cast<Worker*>(pthread_getspecific(GetWorkerTls()));
+  if (!worker || worker->pool != this)
+    worker = workers_[next_worker_++ % workers_.size()].get();
+  bool high_priority = queue->high_priority();
+  {
+    CritScope lock(&worker->lock);
+    if (high_priority) {
+      worker->runnable.push_front(std::move(queue));
+    } else {
+      worker->runnable.push_back(std::move(queue));
+    }
+  }
+  // Pairs with the check in WaitForWork(): either the sleeper sees the new
+  // count, or we see the sleeper.
+  runnable_count_.fetch_add(1);
+  if (sleeping_workers_.load() > 0) {
+    pthread_mutex_lock(&idle_mutex_);
+    pthread_cond_signal(&idle_cond_);
+    pthread_mutex_unlock(&idle_mutex_);
+  }
+}
+
+QueueRef WorkerPool::PopLocal(Worker* worker) {
+  CritScope lock(&worker->lock);
+  if (worker->runnable.empty())
+    return nullptr;
+  QueueRef queue = std::move(worker->runnable.front());
+  worker->runnable.pop_front();
+  runnable_count_.fetch_sub(1);
+  return queue;
+}
+
+QueueRef WorkerPool::Steal(Worker* thief) {
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker* victim = workers_[(thief->index + i) % workers_.size()].get();
+    CritScope lock(&victim->lock);
+    if (victim->runnable.empty())
+      continue;
+    QueueRef queue = std::move(victim->runnable.back());
+    victim->runnable.pop_back();
+    runnable_count_.fetch_sub(1);
+    return queue;
+  }
+  return nullptr;
+}
+
+void WorkerPool::WaitForWork() {
+  pthread_mutex_lock(&idle_mutex_);
+  sleeping_workers_.fetch_add(1);
+  while (runnable_count_.load() == 0)
+    pthread_cond_wait(&idle_cond_, &idle_mutex_);
+  sleeping_workers_.fetch_sub(1);
+  pthread_mutex_unlock(&idle_mutex_);
+}
+
+// static
+void WorkerPool::WorkerMain(void* context) {
+  Worker* me = static_cast<Worker*>(context);
+  pthread_setspecific(GetWorkerTls(), me);
+  while (true) {
+    QueueRef queue = me->pool->PopLocal(me);
+    if (!queue)
+      queue = me->pool->Steal(me);
+    if (queue) {
+      queue->RunSlice();
+    } else {
+      me->pool->WaitForWork();
+    }
+  }
+}
+
+void WorkerPool::PostDelayed(QueueRef queue,
+                             std::unique_ptr<QueuedTask> task,
+                             uint32_t milliseconds) {
+  bool wake_timer_thread;
+  {
+    CritScope lock(&timer_lock_);
+    DelayedTask* timer = NewTimer();
+    timer->queue = std::move(queue);
+    timer->task = std::move(task);
+    timers_.Schedule(timer, TimeMillis() + milliseconds);
+    int64_t next_ms;
+    wake_timer_thread =
+        timers_.NextExpiry(&next_ms) && next_ms < timer_wakeup_ms_;
+  }
+  if (wake_timer_thread)
+    timer_wakeup_.Set();
+}
+
+void WorkerPool::CancelDelayed(const Sequence* queue) {
+  std::vector<DueTask> cancelled;
+  {
+    CritScope lock(&timer_lock_);
+    std::vector<TimerWheel::Entry*> entries;
+    timers_.CancelIf(
+        [queue](TimerWheel::Entry* entry) {
+          return static_cast<DelayedTask*>(entry)->queue == queue;
+        },
+        &entries);
+    for (TimerWheel::Entry* entry : entries)
+      cancelled.push_back(ReleaseTimer(static_cast<DelayedTask*>(entry)));
+  }
+  // |cancelled| deletes the tasks outside of |timer_lock_|.
+}
+
+DelayedTask* WorkerPool::NewTimer() {
+  if (free_timers_.empty())
+    return new DelayedTask();
+  DelayedTask* timer = free_timers_.back().release();
+  free_timers_.pop_back();
+  return timer;
+}
+
+DueTask WorkerPool::ReleaseTimer(DelayedTask* timer) {
+  DueTask due(std::move(timer->queue), std::move(timer->task));
+  free_timers_.emplace_back(timer);
+  return due;
+}
+
+// static
+void WorkerPool::TimerMain(void* context) {
+  static_cast<WorkerPool*>(context)->RunTimers();
+}
+
+void WorkerPool::RunTimers() {
+  // Reused across iterations so that expiring timers doesn't allocate.
+  std::vector<TimerWheel::Entry*> expired;
+  std::vector<DueTask> due;
+  while (true) {
+    int wait_ms = Event::kForever;
+    {
+      CritScope lock(&timer_lock_);
+      int64_t now = TimeMillis();
+      timers_.Advance(now, &expired);
+      for (TimerWheel::Entry* entry : expired)
+        due.push_back(ReleaseTimer(static_cast<DelayedTask*>(entry)));
+      expired.clear();
+      int64_t next_ms;
+      if (timers_.NextExpiry(&next_ms)) {
+        timer_wakeup_ms_ = next_ms;
+        wait_ms = static_cast<int>(std::max<int64_t>(0, next_ms - now));
+      } else {
+        timer_wakeup_ms_ = std::numeric_limits<int64_t>::max();
+      }
+    }
+    for (DueTask& timer : due)
+      timer.first->PostTask(std::move(timer.second));
+    due.clear();
+    timer_wakeup_.Wait(wait_ms);
+  }
+}
+
+}  // namespace
+
+class TaskQueue::Impl : public Sequence {
+ public:
+  Impl(const char* queue_name, TaskQueue* queue, Priority priority);
+  ~Impl() override;
+
+  static TaskQueue* CurrentQueue();
+
+  // Used for DCHECKing the current queue.
+  bool IsCurrent() const;
+
+  void PostTask(std::unique_ptr<QueuedTask> task) override;
+  void PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                        std::unique_ptr<QueuedTask> reply,
+                        TaskQueue::Impl* reply_queue);
+  void PostDelayedTask(std::unique_ptr<QueuedTask> task, uint32_t milliseconds);
+
+  // Called by ~TaskQueue. Waits for a running task to finish, then drops
+  // everything pending. Tasks posted afterwards are deleted right away.
+  void Stop();
+
+  void RunSlice() override;
+  bool high_priority() const override { return priority_ == Priority::HIGH; }
+
+ private:
+  class PostAndReplyTask;
+
+  enum class State {
+    kIdle,       // No pending tasks, not in any worker's deque.
+    kScheduled,  // In a worker's deque.
+    kRunning,    // A worker is running its tasks.
+  };
+
+  TaskQueue* const queue_;
+  const Priority priority_;
+
+  CriticalSection lock_;
+  std::deque<std::unique_ptr<QueuedTask>> tasks_ RTC_GUARDED_BY(lock_);
+  State state_ RTC_GUARDED_BY(lock_) = State::kIdle;
+  bool stopped_ RTC_GUARDED_BY(lock_) = false;
+  bool stop_waiting_ RTC_GUARDED_BY(lock_) = false;
+  // Set by the worker when it stops running tasks for a stopped queue.
+  Event slice_done_;
+};
+
+class TaskQueue::Impl::PostAndReplyTask : public QueuedTask {
+ public:
+  PostAndReplyTask(std::unique_ptr<QueuedTask> task,
+                   std::unique_ptr<QueuedTask> reply,
+                   TaskQueue::Impl* reply_queue)
+      : task_(std::move(task)),
+        reply_(std::move(reply)),
+        reply_queue_(reply_queue) {}
+
+ private:
+  bool Run() override {
+    if (!task_->Run())
+      task_.release();
+    // Deleted right away if the reply queue has been stopped meanwhile.
+    reply_queue_->PostTask(std::move(reply_));
+    return true;
+  }
+
+  std::unique_ptr<QueuedTask> task_;
+  std::unique_ptr<QueuedTask> reply_;
+  const scoped_refptr<TaskQueue::Impl> reply_queue_;
+};
+
+TaskQueue::Impl::Impl(const char* queue_name,
+                      TaskQueue* queue,
+                      Priority priority)
+    : queue_(queue), priority_(priority), slice_done_(false, false) {
+  RTC_DCHECK(queue_name);
+  // Start the pool with the first queue rather than at static init time.
+  WorkerPool::Instance();
+}
+
+TaskQueue::Impl::~Impl() {}
+
+// static
+TaskQueue* TaskQueue::Impl::CurrentQueue() {
+  return static_cast<TaskQueue*>(pthread_getspecific(GetQueuePtrTls()));
+}
+
+bool TaskQueue::Impl::IsCurrent() const {
+  return CurrentQueue() == queue_;
+}
+
+void TaskQueue::Impl::PostTask(std::unique_ptr<QueuedTask> task) {
+  RTC_DCHECK(task.get());
+  {
+    CritScope lock(&lock_);
+    if (stopped_)
+      return;
+    tasks_.push_back(std::move(task));
+    if (state_ != State::kIdle)
+      return;
+    state_ = State::kScheduled;
+  }
+  WorkerPool::Instance()->Schedule(QueueRef(this));
+}
+
+void TaskQueue::Impl::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                      uint32_t milliseconds) {
+  WorkerPool::Instance()->PostDelayed(QueueRef(this), std::move(task),
+                                      milliseconds);
+}
+
+void TaskQueue::Impl::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                       std::unique_ptr<QueuedTask> reply,
+                                       TaskQueue::Impl* reply_queue) {
+  PostTask(std::unique_ptr<QueuedTask>(
+      new PostAndReplyTask(std::move(task), std::move(reply), reply_queue)));
+}
+
+void TaskQueue::Impl::RunSlice() {
+  {
+    CritScope lock(&lock_);
+    RTC_DCHECK(state_ == State::kScheduled);
+    if (stopped_) {
+      state_ = State::kIdle;
+      return;
+    }
+    state_ = State::kRunning;
+  }
+
+  AutoSetCurrentQueuePtr set_current(queue_);
+  for (int i = 0; i < kMaxTasksPerSlice; ++i) {
+    std::unique_ptr<QueuedTask> task;
+    {
+      CritScope lock(&lock_);
+      if (stopped_ || tasks_.empty())
+        break;
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    if (!task->Run())
+      task.release();
+  }
+
+  {
+    CritScope lock(&lock_);
+    if (stopped_ || tasks_.empty()) {
+      state_ = State::kIdle;
+      if (stop_waiting_)
+        slice_done_.Set();
+      return;
+    }
+    state_ = State::kScheduled;
+  }
+  // More to do; go to the back of the line.
+  WorkerPool::Instance()->Schedule(QueueRef(this));
+}
+
+void TaskQueue::Impl::Stop() {
+  RTC_DCHECK(!IsCurrent());
+  bool wait;
+  {
+    CritScope lock(&lock_);
+    stopped_ = true;
+    wait = state_ == State::kRunning;
+    stop_waiting_ = wait;
+  }
+  if (wait)
+    slice_done_.Wait(Event::kForever);
+
+  WorkerPool::Instance()->CancelDelayed(this);
+  std::deque<std::unique_ptr<QueuedTask>> pending;
+  {
+    CritScope lock(&lock_);
+    pending.swap(tasks_);
+  }
+  // |pending| deletes the tasks outside of |lock_|, since their destructors
+  // may post to this queue.
+}
+
+TaskQueue::TaskQueue(const char* queue_name, Priority priority)
+    : name_(queue_name),
+      impl_(new RefCountedObject<TaskQueue::Impl>(queue_name, this, priority)) {
+}
+
+TaskQueue::~TaskQueue() {
+  impl_->Stop();
+}
+
+// static
+TaskQueue* TaskQueue::Current() {
+  return TaskQueue::Impl::CurrentQueue();
+}
+
+// Used for DCHECKing the current queue.
+bool TaskQueue::IsCurrent() const {
+  return impl_->IsCurrent();
+}
+
+void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
+  return TaskQueue::impl_->PostTask(
+      TaskStats::MaybeSampleTask(std::move(task), name_));
+}
+
+void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                 std::unique_ptr<QueuedTask> reply,
+                                 TaskQueue* reply_queue) {
+  return TaskQueue::impl_->PostTaskAndReply(
+      TaskStats::MaybeSampleTask(std::move(task), name_), std::move(reply),
+      reply_queue->impl_.get());
+}
+
+void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
+                                 std::unique_ptr<QueuedTask> reply) {
+  return TaskQueue::impl_->PostTaskAndReply(
+      TaskStats::MaybeSampleTask(std::move(task), name_), std::move(reply),
+      impl_.get());
+}
+
+void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
+                                uint32_t milliseconds) {
+  return TaskQueue::impl_->PostDelayedTask(
+      TaskStats::MaybeSampleTask(std::move(task), name_, milliseconds),
+      milliseconds);
+}
+
+}  // namespace rtc
@@ -15,14 +15,20 @@
 // clang-format on
 #endif
 
+#include <stdio.h>
+
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "rtc_base/bind.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
 #include "rtc_base/gunit.h"
 #include "rtc_base/task_queue_for_test.h"
 #include "rtc_base/timeutils.h"
+#include "test/testsupport/perf_test.h"
 
 using rtc::test::TaskQueueForTest;
 
@@ -423,4 +429,137 @@ TEST(TaskQueueTest, PostALot) {
   EXPECT_EQ(kTaskCount, tasks_cleaned_up);
 }
 
+// Many queues sharing whatever threads the implementation uses must still
+// run each queue's tasks one at a time, in order, and on that queue.
+TEST(TaskQueueTest, ManyQueuesKeepPerQueueOrder) {
+  const size_t kQueueCount = 64;
+  const int kTasksPerQueue = 200;
+  std::vector<std::unique_ptr<TaskQueue>> queues;
+  for (size_t i = 0; i < kQueueCount; ++i)
+    queues.emplace_back(new TaskQueue("ManyQueuesKeepPerQueueOrder"));
+
+  std::vector<int> next(kQueueCount, 0);
+  std::vector<bool> in_order(kQueueCount, true);
+  Event done(false, false);
+  size_t queues_done = 0;
+  CriticalSection done_lock;
+  for (int task = 0; task < kTasksPerQueue; ++task) {
+    for (size_t i = 0; i < kQueueCount; ++i) {
+      TaskQueue* queue = queues[i].get();
+      queue->PostTask([&, i, task, queue] {
+        if (!queue->IsCurrent() || TaskQueue::Current() != queue ||
+            next[i] != task) {
+          in_order[i] = false;
+        }
+        next[i] = task + 1;
+        if (task == kTasksPerQueue - 1) {
+          CritScope lock(&done_lock);
+          if (++queues_done == kQueueCount)
+            done.Set();
+        }
+      });
+    }
+  }
+  EXPECT_TRUE(done.Wait(10000));
+  for (size_t i = 0; i < kQueueCount; ++i) {
+    EXPECT_TRUE(in_order[i]) << "queue " << i;
+    EXPECT_EQ(kTasksPerQueue, next[i]);
+  }
+}
+
+namespace {
+
+// Number of threads in this process, or -1 where that isn't known.
+int ProcessThreadCount() {
+#if defined(WEBRTC_LINUX)
+  FILE* status = fopen("/proc/self/status", "r");
+  if (!status)
+    return -1;
+  char line[256];
+  int threads = -1;
+  while (fgets(line, sizeof(line), status)) {
+    if (sscanf(line, "Threads: %d", &threads) == 1)
+      break;
+  }
+  fclose(status);
+  return threads;
+#else
+  return -1;
+#endif
+}
+
+}  // namespace
+
+// Compares TaskQueue implementations (build with and without
+// rtc_enable_task_queue_pool): how many threads N queues cost, and how long
+// a task posted from outside takes to start running, both on an idle queue
+// and while every queue is busy with a burst of tasks.
+TEST(TaskQueueTest, DISABLED_ThreadUsageAndTaskLatency) {
+  for (size_t queue_count : {10, 100, 1000}) {
+    int threads_before = ProcessThreadCount();
+    std::vector<std::unique_ptr<TaskQueue>> queues;
+    for (size_t i = 0; i < queue_count; ++i)
+      queues.emplace_back(new TaskQueue("ThreadUsageAndTaskLatency"));
+    int threads_after = ProcessThreadCount();
+
+    // Idle latency: one task at a time.
+    std::vector<int64_t> idle_latencies;
+    Event ran(false, false);
+    for (size_t i = 0; i < 1000; ++i) {
+      int64_t posted = TimeNanos();
+      int64_t started = 0;
+      queues[i % queue_count]->PostTask([&ran, &started] {
+        started = TimeNanos();
+        ran.Set();
+      });
+      ASSERT_TRUE(ran.Wait(1000));
+      idle_latencies.push_back(started - posted);
+    }
+
+    // Loaded latency: a burst of tasks to every queue at once.
+    const int kBurst = 10;
+    std::vector<int64_t> loaded_latencies(queue_count * kBurst);
+    Event all_ran(false, false);
+    CriticalSection lock;
+    size_t remaining = loaded_latencies.size();
+    int64_t burst_start = TimeNanos();
+    for (int burst = 0; burst < kBurst; ++burst) {
+      for (size_t i = 0; i < queue_count; ++i) {
+        int64_t* latency = &loaded_latencies[burst * queue_count + i];
+        int64_t posted = TimeNanos();
+        queues[i]->PostTask([&, latency, posted] {
+          *latency = TimeNanos() - posted;
+          CritScope cs(&lock);
+          if (--remaining == 0)
+            all_ran.Set();
+        });
+      }
+    }
+    ASSERT_TRUE(all_ran.Wait(30000));
+    int64_t burst_ns = TimeNanos() - burst_start;
+
+    std::sort(idle_latencies.begin(), idle_latencies.end());
+    std::sort(loaded_latencies.begin(), loaded_latencies.end());
+    const std::string trace = std::to_string(queue_count) + "_queues";
+    if (threads_before >= 0) {
+      webrtc::test::PrintResult("added_threads", "", trace,
+                                threads_after - threads_before, "threads",
+                                false);
+    }
+    webrtc::test::PrintResult("task_latency", "_idle_p50", trace,
+                              idle_latencies[500] / 1000.0, "us", false);
+    webrtc::test::PrintResult("task_latency", "_idle_p99", trace,
+                              idle_latencies[990] / 1000.0, "us", false);
+    webrtc::test::PrintResult(
+        "task_latency", "_loaded_p50", trace,
+        loaded_latencies[loaded_latencies.size() / 2] / 1000.0, "us", false);
+    webrtc::test::PrintResult(
+        "task_latency", "_loaded_p99", trace,
+        loaded_latencies[loaded_latencies.size() * 99 / 100] / 1000.0, "us",
+        false);
+    webrtc::test::PrintResult("burst_time", "", trace, burst_ns / 1000.0, "us",
+                              false);
+  }
+}
+
 }  // namespace rtc
@@ -33,6 +33,7 @@
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/refcount.h"
 #include "rtc_base/refcountedobject.h"
+#include "rtc_base/task_stats.h"
 #include "rtc_base/timeutils.h"
 
 namespace rtc {
@@ -477,7 +478,8 @@ void TaskQueue::Impl::ThreadState::CancelTimers() {
 
 // Boilerplate for the PIMPL pattern.
 TaskQueue::TaskQueue(const char* queue_name, Priority priority)
-    : impl_(new RefCountedObject<TaskQueue::Impl>(queue_name, this, priority)) {
+    : name_(queue_name),
+      impl_(new RefCountedObject<TaskQueue::Impl>(queue_name, this, priority)) {
 }
 
 TaskQueue::~TaskQueue() {}
@@ -493,25 +495,30 @@ bool TaskQueue::IsCurrent() const {
 }
 
 void TaskQueue::PostTask(std::unique_ptr<QueuedTask> task) {
-  return TaskQueue::impl_->PostTask(std::move(task));
+  return TaskQueue::impl_->PostTask(
+      TaskStats::MaybeSampleTask(std::move(task), name_));
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply,
                                  TaskQueue* reply_queue) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            reply_queue->impl_.get());
+  return TaskQueue::impl_->PostTaskAndReply(
+      TaskStats::MaybeSampleTask(std::move(task), name_), std::move(reply),
+      reply_queue->impl_.get());
 }
 
 void TaskQueue::PostTaskAndReply(std::unique_ptr<QueuedTask> task,
                                  std::unique_ptr<QueuedTask> reply) {
-  return TaskQueue::impl_->PostTaskAndReply(std::move(task), std::move(reply),
-                                            impl_.get());
+  return TaskQueue::impl_->PostTaskAndReply(
+      TaskStats::MaybeSampleTask(std::move(task), name_), std::move(reply),
+      impl_.get());
 }
 
 void TaskQueue::PostDelayedTask(std::unique_ptr<QueuedTask> task,
                                 uint32_t milliseconds) {
-  return TaskQueue::impl_->PostDelayedTask(std::move(task), milliseconds);
+  return TaskQueue::impl_->PostDelayedTask(
+      TaskStats::MaybeSampleTask(std::move(task), name_, milliseconds),
+      milliseconds);
 }
 
 }  // namespace rtc
@@ -0,0 +1,231 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_stats.h"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+#include <utility>
+
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/timeutils.h"
+
+namespace rtc {
+
+namespace {
+
+const char kUnknown[] = "Unknown";
+
+// A histogram with four buckets per power of two, so that the percentiles
+// are within 25% of the exact ones, in a fixed amount of memory.
+class LogHistogram {
+ public:
+  void Add(int64_t value) {
+    value = std::max<int64_t>(value, 0);
+    ++counts_[BucketIndex(value)];
+    ++num_values_;
+    max_ = std::max(max_, value);
+  }
+
+  // Returns the upper bound of the bucket that holds the percentile, or the
+  // largest value if that is smaller.
+  int64_t Percentile(double fraction) const {
+    const int64_t rank = std::max<int64_t>(
+        1, static_cast<int64_t>(fraction * num_values_ + 0.5));
+    int64_t count = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      count += counts_[i];
+      if (count >= rank)
+        return std::min(BucketLowerBound(i + 1) - 1, max_);
+    }
+    return max_;
+  }
+
+  int64_t max() const { return max_; }
+  int64_t num_values() const { return num_values_; }
+
+ private:
+  static const int kMaxExponent = 40;
+  static const size_t kNumBuckets = (kMaxExponent - 1) * 4 + 4;
+
+  static size_t BucketIndex(int64_t value) {
+    if (value < 4)
+      return static_cast<size_t>(value);
+    int exponent = 63;
+    while (!(value >> exponent))
+      --exponent;
+    if (exponent > kMaxExponent)
+      return kNumBuckets - 1;
+    return (exponent - 1) * 4 + ((value >> (exponent - 2)) & 3);
+  }
+
+  static int64_t BucketLowerBound(size_t index) {
+    if (index < 4)
+      return static_cast<int64_t>(index);
+    const int exponent = static_cast<int>(index / 4) + 1;
+    return static_cast<int64_t>(4 + index % 4) << (exponent - 2);
+  }
+
+  uint32_t counts_[kNumBuckets] = {0};
+  int64_t num_values_ = 0;
+  int64_t max_ = 0;
+};
+
+struct OriginStats {
+  LogHistogram wait_time_us;
+  LogHistogram run_time_us;
+  LogHistogram queue_depth;
+};
+
+// The strings of a Location are compared by address, since they persist as
+// globals do.
+using OriginKey = std::tuple<std::string, const char*, const char*>;
+
+class TaskStatsRegistry {
+ public:
+  static TaskStatsRegistry* Instance() {
+    static TaskStatsRegistry* const instance = new TaskStatsRegistry();
+    return instance;
+  }
+
+  void AddSample(const std::string& queue_name,
+                 const char* function_name,
+                 const char* file_and_line,
+                 int64_t wait_time_us,
+                 int64_t run_time_us,
+                 int queue_depth) {
+    CritScope lock(&crit_);
+    OriginStats& stats =
+        stats_[OriginKey(queue_name, function_name, file_and_line)];
+    stats.wait_time_us.Add(wait_time_us);
+    stats.run_time_us.Add(run_time_us);
+    if (queue_depth >= 0)
+      stats.queue_depth.Add(queue_depth);
+  }
+
+  std::vector<TaskStats::Entry> Get() {
+    std::vector<TaskStats::Entry> entries;
+    {
+      CritScope lock(&crit_);
+      entries.reserve(stats_.size());
+      for (const auto& it : stats_) {
+        TaskStats::Entry entry;
+        entry.queue_name = std::get<0>(it.first);
+        entry.origin = std::string(std::get<1>(it.first)) + "@" +
+                       std::get<2>(it.first);
+        const OriginStats& stats = it.second;
+        entry.num_samples = stats.run_time_us.num_values();
+        entry.wait_time_us_p50 = stats.wait_time_us.Percentile(0.5);
+        entry.wait_time_us_p99 = stats.wait_time_us.Percentile(0.99);
+        entry.wait_time_us_max = stats.wait_time_us.max();
+        entry.run_time_us_p50 = stats.run_time_us.Percentile(0.5);
+        entry.run_time_us_p99 = stats.run_time_us.Percentile(0.99);
+        entry.run_time_us_max = stats.run_time_us.max();
+        if (stats.queue_depth.num_values() > 0) {
+          entry.queue_depth_p50 =
+              static_cast<int>(stats.queue_depth.Percentile(0.5));
+          entry.queue_depth_p99 =
+              static_cast<int>(stats.queue_depth.Percentile(0.99));
+        }
+        entries.push_back(std::move(entry));
+      }
+    }
+    // The map is ordered by the addresses of the origins' strings.
+    std::sort(entries.begin(), entries.end(),
+              [](const TaskStats::Entry& a, const TaskStats::Entry& b) {
+                return std::tie(a.queue_name, a.origin) <
+                       std::tie(b.queue_name, b.origin);
+              });
+    return entries;
+  }
+
+  void Reset() {
+    CritScope lock(&crit_);
+    stats_.clear();
+  }
+
+ private:
+  CriticalSection crit_;
+  std::map<OriginKey, OriginStats> stats_ RTC_GUARDED_BY(crit_);
+};
+
+class SampledTask : public QueuedTask {
+ public:
+  SampledTask(std::unique_ptr<QueuedTask> task,
+              const std::string& queue_name,
+              uint32_t delay_ms)
+      : task_(std::move(task)),
+        queue_name_(queue_name),
+        ready_time_us_(TimeMicros() + delay_ms * kNumMicrosecsPerMillisec) {}
+
+ private:
+  bool Run() override {
+    const int64_t start_time_us = TimeMicros();
+    // A task that returns false has taken over its own ownership.
+    if (!task_->Run())
+      task_.release();
+    // The origin of the task isn't known, which is what a default
+    // constructed Location says.
+    TaskStats::AddSample(queue_name_, kUnknown, kUnknown,
+                         start_time_us - ready_time_us_,
+                         TimeMicros() - start_time_us, -1);
+    return true;
+  }
+
+  std::unique_ptr<QueuedTask> task_;
+  const std::string queue_name_;
+  const int64_t ready_time_us_;
+};
+
+}  // namespace
+
+std::atomic<int> TaskStats::sample_one_in_n_(0);
+std::atomic<uint32_t> TaskStats::sample_counter_(0);
+
+TaskStats::Entry::Entry() = default;
+TaskStats::Entry::Entry(const Entry&) = default;
+TaskStats::Entry::~Entry() = default;
+
+void TaskStats::Enable(int sample_one_in_n) {
+  sample_one_in_n_.store(std::max(sample_one_in_n, 0),
+                         std::memory_order_relaxed);
+}
+
+void TaskStats::AddSample(const std::string& queue_name,
+                          const char* function_name,
+                          const char* file_and_line,
+                          int64_t wait_time_us,
+                          int64_t run_time_us,
+                          int queue_depth) {
+  TaskStatsRegistry::Instance()->AddSample(queue_name, function_name,
+                                           file_and_line, wait_time_us,
+                                           run_time_us, queue_depth);
+}
+
+std::unique_ptr<QueuedTask> TaskStats::MaybeSampleTask(
+    std::unique_ptr<QueuedTask> task,
+    const std::string& queue_name,
+    uint32_t delay_ms) {
+  if (!ShouldSample())
+    return task;
+  return std::unique_ptr<QueuedTask>(
+      new SampledTask(std::move(task), queue_name, delay_ms));
+}
+
+std::vector<TaskStats::Entry> TaskStats::Get() {
+  return TaskStatsRegistry::Instance()->Get();
+}
+
+void TaskStats::Reset() {
+  TaskStatsRegistry::Instance()->Reset();
+}
+
+}  // namespace rtc
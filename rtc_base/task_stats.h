@@ -0,0 +1,100 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TASK_STATS_H_
+#define RTC_BASE_TASK_STATS_H_
+
+#include <stdint.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rtc_base/task_queue.h"
+
+namespace rtc {
+
+// Collects how long the messages and tasks that rtc::Threads, ProcessThreads
+// and TaskQueues run wait before they run and how long they take, by queue
+// and by where they came from, to find out which threads saturate and which
+// tasks cause the stalls. It is off by default. When on, one in N of the
+// tasks are sampled, and only the sampled ones read the clock.
+class TaskStats {
+ public:
+  struct Entry {
+    Entry();
+    Entry(const Entry&);
+    ~Entry();
+
+    std::string queue_name;
+    // Where the message was posted from, as Location::ToString() formats it,
+    // or where the module was registered for ProcessThread modules.
+    // "Unknown" for the tasks of TaskQueues and ProcessThreads, whose
+    // PostTask() isn't told.
+    std::string origin;
+    int64_t num_samples = 0;
+    // From when the task could have run until it started to.
+    int64_t wait_time_us_p50 = 0;
+    int64_t wait_time_us_p99 = 0;
+    int64_t wait_time_us_max = 0;
+    int64_t run_time_us_p50 = 0;
+    int64_t run_time_us_p99 = 0;
+    int64_t run_time_us_max = 0;
+    // The number of tasks that were waiting behind the task when it started
+    // to run, or -1 where the queue doesn't know.
+    int queue_depth_p50 = -1;
+    int queue_depth_p99 = -1;
+  };
+
+  // Samples one in |sample_one_in_n| tasks from now on, and none if it is 0.
+  static void Enable(int sample_one_in_n);
+  static void Disable() { Enable(0); }
+
+  // Decides whether to sample the task that is being posted.
+  static bool ShouldSample() {
+    const int one_in_n = sample_one_in_n_.load(std::memory_order_relaxed);
+    return one_in_n == 1 ||
+           (one_in_n > 1 &&
+            sample_counter_.fetch_add(1, std::memory_order_relaxed) %
+                    one_in_n ==
+                0);
+  }
+
+  // |function_name| and |file_and_line| are those of an rtc::Location, and
+  // must persist as globals do. |queue_depth| is -1 if unknown.
+  static void AddSample(const std::string& queue_name,
+                        const char* function_name,
+                        const char* file_and_line,
+                        int64_t wait_time_us,
+                        int64_t run_time_us,
+                        int queue_depth);
+
+  // For queues that can't sample tasks themselves: if the task is sampled,
+  // wraps it in one that adds a sample when it runs, and returns |task|
+  // otherwise. |delay_ms| is that of a delayed task.
+  static std::unique_ptr<QueuedTask> MaybeSampleTask(
+      std::unique_ptr<QueuedTask> task,
+      const std::string& queue_name,
+      uint32_t delay_ms = 0);
+
+  // Returns the statistics of all the queues and origins that have been
+  // sampled, sorted by queue name and origin.
+  static std::vector<Entry> Get();
+  static void Reset();
+
+ private:
+  static std::atomic<int> sample_one_in_n_;
+  static std::atomic<uint32_t> sample_counter_;
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_TASK_STATS_H_
@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/task_stats.h"
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/event.h"
+#include "rtc_base/gunit.h"
+#include "rtc_base/location.h"
+#include "rtc_base/task_queue.h"
+#include "rtc_base/thread.h"
+
+namespace rtc {
+
+namespace {
+
+const char kFunction[] = "Function";
+const char kFileAndLine[] = "file.cc:1";
+
+class SignalingHandler : public MessageHandler {
+ public:
+  void OnMessage(Message* msg) override { event_.Set(); }
+
+  void Wait() { event_.Wait(Event::kForever); }
+
+ private:
+  Event event_{false, false};
+};
+
+const TaskStats::Entry* FindEntry(const std::vector<TaskStats::Entry>& entries,
+                                  const std::string& queue_name) {
+  for (const TaskStats::Entry& entry : entries) {
+    if (entry.queue_name == queue_name)
+      return &entry;
+  }
+  return nullptr;
+}
+
+class TaskStatsTest : public testing::Test {
+ protected:
+  TaskStatsTest() { TaskStats::Reset(); }
+  ~TaskStatsTest() override {
+    TaskStats::Disable();
+    TaskStats::Reset();
+  }
+};
+
+}  // namespace
+
+TEST_F(TaskStatsTest, SamplesNothingWhenDisabled) {
+  for (int i = 0; i < 10; ++i)
+    EXPECT_FALSE(TaskStats::ShouldSample());
+}
+
+TEST_F(TaskStatsTest, SamplesOneInN) {
+  TaskStats::Enable(4);
+  int num_sampled = 0;
+  for (int i = 0; i < 100; ++i)
+    num_sampled += TaskStats::ShouldSample() ? 1 : 0;
+  EXPECT_EQ(25, num_sampled);
+
+  TaskStats::Enable(1);
+  for (int i = 0; i < 10; ++i)
+    EXPECT_TRUE(TaskStats::ShouldSample());
+}
+
+TEST_F(TaskStatsTest, AggregatesSamplesByQueueAndOrigin) {
+  for (int i = 1; i <= 100; ++i)
+    TaskStats::AddSample("queue", kFunction, kFileAndLine, i * 10, i, i % 10);
+  TaskStats::AddSample("other queue", kFunction, kFileAndLine, 0, 5, -1);
+
+  std::vector<TaskStats::Entry> entries = TaskStats::Get();
+  ASSERT_EQ(2u, entries.size());
+  EXPECT_EQ("other queue", entries[0].queue_name);
+  EXPECT_EQ(-1, entries[0].queue_depth_p50);
+  EXPECT_EQ(5, entries[0].run_time_us_max);
+
+  const TaskStats::Entry& entry = entries[1];
+  EXPECT_EQ("queue", entry.queue_name);
+  EXPECT_EQ("Function@file.cc:1", entry.origin);
+  EXPECT_EQ(100, entry.num_samples);
+  EXPECT_EQ(1000, entry.wait_time_us_max);
+  EXPECT_EQ(100, entry.run_time_us_max);
+  // The percentiles are those of buckets that are 25% wide at most.
+  EXPECT_GE(entry.run_time_us_p50, 50);
+  EXPECT_LE(entry.run_time_us_p50, 63);
+  EXPECT_GE(entry.run_time_us_p99, 99);
+  EXPECT_LE(entry.run_time_us_p99, 100);
+  EXPECT_GE(entry.wait_time_us_p50, 500);
+  EXPECT_LE(entry.wait_time_us_p50, 639);
+  EXPECT_GE(entry.queue_depth_p50, 4);
+  EXPECT_LE(entry.queue_depth_p50, 5);
+  EXPECT_EQ(9, entry.queue_depth_p99);
+
+  TaskStats::Reset();
+  EXPECT_TRUE(TaskStats::Get().empty());
+}
+
+TEST_F(TaskStatsTest, SamplesThreadMessages) {
+  TaskStats::Enable(1);
+  Thread thread;
+  thread.SetName("TaskStatsThread", nullptr);
+  thread.Start();
+  SignalingHandler handler;
+  thread.Post(RTC_FROM_HERE, &handler);
+  handler.Wait();
+  // The sample is added once the message has been handled.
+  thread.Stop();
+
+  std::vector<TaskStats::Entry> entries = TaskStats::Get();
+  const TaskStats::Entry* entry = FindEntry(entries, "TaskStatsThread");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(1, entry->num_samples);
+  EXPECT_NE(std::string::npos, entry->origin.find("task_stats_unittest.cc"));
+  EXPECT_GE(entry->queue_depth_p50, 0);
+}
+
+TEST_F(TaskStatsTest, SamplesTaskQueueTasks) {
+  TaskStats::Enable(1);
+  Event ran(false, false);
+  {
+    TaskQueue queue("TaskStatsQueue");
+    queue.PostTask([&ran] { ran.Set(); });
+    queue.PostDelayedTask([&ran] { ran.Set(); }, 10);
+    ran.Wait(Event::kForever);
+    ran.Wait(Event::kForever);
+    // Destroying the queue waits for the samples of the tasks to be added.
+  }
+
+  std::vector<TaskStats::Entry> entries = TaskStats::Get();
+  const TaskStats::Entry* entry = FindEntry(entries, "TaskStatsQueue");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(2, entry->num_samples);
+  EXPECT_EQ("Unknown@Unknown", entry->origin);
+  EXPECT_EQ(-1, entry->queue_depth_p50);
+  // The delayed task wasn't waiting while it was delayed.
+  EXPECT_LT(entry->wait_time_us_max, 10000);
+}
+
+TEST_F(TaskStatsTest, DoesNotSampleWhenDisabled) {
+  Event ran(false, false);
+  {
+    TaskQueue queue("TaskStatsQueue");
+    queue.PostTask([&ran] { ran.Set(); });
+    ran.Wait(Event::kForever);
+  }
+  EXPECT_TRUE(TaskStats::Get().empty());
+}
+
+}  // namespace rtc
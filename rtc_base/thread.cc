@@ -29,6 +29,7 @@
 #include "rtc_base/nullsocketserver.h"
 #include "rtc_base/platform_thread.h"
 #include "rtc_base/stringutils.h"
+#include "rtc_base/thread_placement.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
 
@@ -311,6 +312,7 @@ void* Thread::PreRun(void* pv) {
   ThreadInit* init = static_cast<ThreadInit*>(pv);
   ThreadManager::Instance()->SetCurrentThread(init->thread);
   rtc::SetCurrentThreadName(init->thread->name_.c_str());
+  rtc::ApplyThreadPlacement(init->thread->name_.c_str());
   if (init->runnable) {
     init->runnable->Run(init->thread);
   } else {
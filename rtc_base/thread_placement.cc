@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/thread_placement.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <map>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/thread_annotations.h"
+
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
+namespace rtc {
+namespace {
+
+struct Placements {
+  CriticalSection lock;
+  std::map<std::string, ThreadPlacement> by_prefix RTC_GUARDED_BY(lock);
+};
+
+Placements* GetPlacements() {
+  static Placements* const placements = new Placements();
+  return placements;
+}
+
+// Parses a list of CPUs in the format of the Linux sysfs cpulist files, e.g.
+// "0-3,8,10-11".
+std::vector<int> ParseCpuList(const char* list) {
+  std::vector<int> cpus;
+  const char* p = list;
+  while (*p) {
+    char* end;
+    long first = strtol(p, &end, 10);
+    if (end == p || first < 0)
+      return std::vector<int>();
+    long last = first;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      last = strtol(p, &end, 10);
+      if (end == p || last < first)
+        return std::vector<int>();
+      p = end;
+    }
+    for (long cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(static_cast<int>(cpu));
+    if (*p == ',')
+      ++p;
+    else if (*p != '\n' && *p != '\0')
+      return std::vector<int>();
+    else if (*p == '\n')
+      break;
+  }
+  return cpus;
+}
+
+}  // namespace
+
+ThreadPlacement::ThreadPlacement() = default;
+ThreadPlacement::ThreadPlacement(const ThreadPlacement&) = default;
+ThreadPlacement::~ThreadPlacement() = default;
+
+void SetThreadPlacement(const std::string& thread_name_prefix,
+                        const ThreadPlacement& placement) {
+  Placements* placements = GetPlacements();
+  CritScope cs(&placements->lock);
+  placements->by_prefix[thread_name_prefix] = placement;
+}
+
+void ClearThreadPlacements() {
+  Placements* placements = GetPlacements();
+  CritScope cs(&placements->lock);
+  placements->by_prefix.clear();
+}
+
+bool ApplyThreadPlacement(const char* thread_name) {
+  RTC_DCHECK(thread_name);
+  const std::string name(thread_name);
+  ThreadPlacement placement;
+  {
+    Placements* placements = GetPlacements();
+    CritScope cs(&placements->lock);
+    size_t matched_length = 0;
+    bool matched = false;
+    for (const auto& entry : placements->by_prefix) {
+      const std::string& prefix = entry.first;
+      if (name.compare(0, prefix.size(), prefix) == 0 &&
+          (!matched || prefix.size() > matched_length)) {
+        placement = entry.second;
+        matched_length = prefix.size();
+        matched = true;
+      }
+    }
+    if (!matched)
+      return true;
+  }
+
+  std::vector<int> cpus = placement.cpus;
+  if (placement.numa_node >= 0) {
+    std::vector<int> node_cpus = GetNumaNodeCpus(placement.numa_node);
+    if (node_cpus.empty())
+      return false;
+    cpus.insert(cpus.end(), node_cpus.begin(), node_cpus.end());
+  }
+  if (cpus.empty())
+    return true;
+  return SetCurrentThreadAffinity(cpus);
+}
+
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus) {
+#if defined(WEBRTC_LINUX)
+  if (cpus.empty())
+    return false;
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    if (cpu < 0 || cpu >= CPU_SETSIZE)
+      return false;
+    CPU_SET(cpu, &cpu_set);
+  }
+  return sched_setaffinity(0, sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif
+}
+
+std::vector<int> GetNumaNodeCpus(int node) {
+#if defined(WEBRTC_LINUX)
+  if (node < 0)
+    return std::vector<int>();
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+           node);
+  FILE* file = fopen(path, "r");
+  if (!file)
+    return std::vector<int>();
+  char list[1024];
+  std::vector<int> cpus;
+  if (fgets(list, sizeof(list), file))
+    cpus = ParseCpuList(list);
+  fclose(file);
+  return cpus;
+#else
+  return std::vector<int>();
+#endif
+}
+
+}  // namespace rtc
@@ -0,0 +1,58 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_THREAD_PLACEMENT_H_
+#define RTC_BASE_THREAD_PLACEMENT_H_
+
+#include <string>
+#include <vector>
+
+namespace rtc {
+
+// The CPUs a thread may run on. An empty placement leaves the thread wherever
+// the OS schedules it.
+struct ThreadPlacement {
+  ThreadPlacement();
+  ThreadPlacement(const ThreadPlacement&);
+  ~ThreadPlacement();
+
+  std::vector<int> cpus;
+  // If non-negative, the thread may also run on all CPUs of this NUMA node.
+  // With the default memory policy of the OS, memory that the thread touches
+  // first, such as the buffers of pools it allocates from, is then allocated
+  // on that node.
+  int numa_node = -1;
+};
+
+// Sets the placement of the threads whose names start with
+// |thread_name_prefix|, e.g. "EncoderQueue", "DecodingThread", "PacerThread",
+// "call_worker_queue", "pc_network_thread" or "pc_worker_thread". When several
+// prefixes match a name the longest one is used. Placements are applied by
+// rtc::PlatformThread, and thereby the task queues, and by rtc::Thread when a
+// thread starts; a running thread is not moved. Only implemented on Linux,
+// elsewhere placements are ignored.
+void SetThreadPlacement(const std::string& thread_name_prefix,
+                        const ThreadPlacement& placement);
+void ClearThreadPlacements();
+
+// Applies the placement set for |thread_name|, if any, to the calling thread.
+// Returns false if there is a placement that could not be applied.
+bool ApplyThreadPlacement(const char* thread_name);
+
+// Restricts the calling thread to run on |cpus|. Returns false on failure or
+// if not supported on the platform.
+bool SetCurrentThreadAffinity(const std::vector<int>& cpus);
+
+// Returns the CPUs of NUMA node |node|, or an empty vector if unknown.
+std::vector<int> GetNumaNodeCpus(int node);
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_THREAD_PLACEMENT_H_
@@ -0,0 +1,88 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/thread_placement.h"
+
+#include "rtc_base/platform_thread.h"
+#include "test/gtest.h"
+
+#if defined(WEBRTC_LINUX)
+#include <sched.h>
+#endif
+
+namespace rtc {
+
+#if defined(WEBRTC_LINUX)
+namespace {
+
+struct AffinityResult {
+  bool on_cpu0 = false;
+  int num_cpus = 0;
+};
+
+void GetAffinity(void* param) {
+  AffinityResult* result = static_cast<AffinityResult*>(param);
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0)
+    return;
+  result->on_cpu0 = CPU_ISSET(0, &cpu_set);
+  result->num_cpus = CPU_COUNT(&cpu_set);
+}
+
+AffinityResult RunThread(const char* name) {
+  AffinityResult result;
+  PlatformThread thread(&GetAffinity, &result, name);
+  thread.Start();
+  thread.Stop();
+  return result;
+}
+
+}  // namespace
+
+TEST(ThreadPlacementTest, AppliesPlacementByLongestPrefix) {
+  ThreadPlacement anywhere;
+  ThreadPlacement cpu0;
+  cpu0.cpus.push_back(0);
+  SetThreadPlacement("Placement", anywhere);
+  SetThreadPlacement("PlacementTest", cpu0);
+
+  AffinityResult result = RunThread("PlacementTestThread");
+  EXPECT_TRUE(result.on_cpu0);
+  EXPECT_EQ(1, result.num_cpus);
+
+  ClearThreadPlacements();
+}
+
+TEST(ThreadPlacementTest, UnmatchedThreadIsNotPlaced) {
+  ThreadPlacement cpu0;
+  cpu0.cpus.push_back(0);
+  SetThreadPlacement("PlacementTest", cpu0);
+
+  AffinityResult placed = RunThread("PlacementTestThread");
+  AffinityResult unplaced = RunThread("OtherThread");
+  EXPECT_EQ(1, placed.num_cpus);
+  EXPECT_LE(placed.num_cpus, unplaced.num_cpus);
+
+  ClearThreadPlacements();
+  EXPECT_EQ(unplaced.num_cpus, RunThread("PlacementTestThread").num_cpus);
+}
+#endif  // defined(WEBRTC_LINUX)
+
+TEST(ThreadPlacementTest, NoPlacementSucceeds) {
+  EXPECT_TRUE(ApplyThreadPlacement("UnplacedThread"));
+}
+
+TEST(ThreadPlacementTest, UnknownNumaNodeHasNoCpus) {
+  EXPECT_TRUE(GetNumaNodeCpus(-1).empty());
+  EXPECT_TRUE(GetNumaNodeCpus(100000).empty());
+}
+
+}  // namespace rtc
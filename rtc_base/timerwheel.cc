@@ -0,0 +1,255 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/timerwheel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+
+namespace rtc {
+
+TimerWheel::Entry::Entry()
+    : prev_(nullptr),
+      next_(nullptr),
+      list_(nullptr),
+      deadline_ms_(0),
+      tick_(0),
+      sequence_(0) {}
+
+TimerWheel::Entry::~Entry() {
+  RTC_DCHECK(!scheduled());
+}
+
+TimerWheel::TimerWheel(int slack_ms)
+    : tick_ms_(std::max(1, slack_ms)),
+      now_tick_(0),
+      size_(0),
+      next_sequence_(0) {
+  std::fill(std::begin(occupied_), std::end(occupied_), 0);
+}
+
+TimerWheel::~TimerWheel() {
+  RTC_DCHECK(empty());
+}
+
+void TimerWheel::set_slack_ms(int slack_ms) {
+  int tick_ms = std::max(1, slack_ms);
+  if (tick_ms == tick_ms_)
+    return;
+  now_tick_ = now_tick_ * tick_ms_ / tick_ms;
+  tick_ms_ = tick_ms;
+  RehashAll();
+}
+
+void TimerWheel::Schedule(Entry* entry, int64_t deadline_ms) {
+  RTC_DCHECK(!entry->scheduled());
+  entry->deadline_ms_ = deadline_ms;
+  entry->tick_ = TickAtOrAfter(deadline_ms);
+  entry->sequence_ = next_sequence_++;
+  Insert(entry);
+  ++size_;
+}
+
+void TimerWheel::Cancel(Entry* entry) {
+  RTC_DCHECK(entry->scheduled());
+  Unlink(entry);
+  --size_;
+}
+
+void TimerWheel::Advance(int64_t now_ms, std::vector<Entry*>* expired) {
+  int64_t target = TickAtOrBefore(now_ms);
+  if (target < now_tick_) {
+    now_tick_ = target;
+    RehashAll();
+  }
+
+  int64_t tick;
+  int level;
+  int slot;
+  while (NextEventTick(&tick, &level, &slot) && tick <= target) {
+    now_tick_ = tick;
+    Rehash(level < kLevels ? &wheels_[level][slot] : &overflow_);
+  }
+  now_tick_ = target;
+
+  size_t first = expired->size();
+  while (Entry* entry = due_.head) {
+    Cancel(entry);
+    expired->push_back(entry);
+  }
+  std::sort(expired->begin() + first, expired->end(), &ExpiresBefore);
+}
+
+bool TimerWheel::NextExpiry(int64_t* expiry_ms) const {
+  if (empty())
+    return false;
+  if (due_.head) {
+    *expiry_ms = now_tick_ * tick_ms_;
+    return true;
+  }
+  int64_t tick;
+  int level;
+  int slot;
+  bool found = NextEventTick(&tick, &level, &slot);
+  RTC_DCHECK(found);
+  if (level > 0) {
+    // Outer slots span many ticks. The earliest timer in the first occupied
+    // one is the earliest overall, since the inner wheels are empty.
+    const List& list = level < kLevels ? wheels_[level][slot] : overflow_;
+    tick = list.head->tick_;
+    for (const Entry* entry = list.head->next_; entry; entry = entry->next_)
+      tick = std::min(tick, entry->tick_);
+  }
+  *expiry_ms = tick * tick_ms_;
+  return true;
+}
+
+int TimerWheel::CountTrailingZeros(uint64_t bits) {
+  RTC_DCHECK_NE(0, bits);
+#if defined(_MSC_VER)
+  unsigned long index;  // NOLINT(runtime/int)
+  _BitScanForward64(&index, bits);
+  return static_cast<int>(index);
+#else
+  return __builtin_ctzll(bits);
+#endif
+}
+
+bool TimerWheel::ExpiresBefore(const Entry* a, const Entry* b) {
+  if (a->deadline_ms_ != b->deadline_ms_)
+    return a->deadline_ms_ < b->deadline_ms_;
+  return a->sequence_ < b->sequence_;
+}
+
+int64_t TimerWheel::TickAtOrAfter(int64_t time_ms) const {
+  // Ticks are never negative; anything before time zero is simply due.
+  if (time_ms <= 0)
+    return 0;
+  return (time_ms + tick_ms_ - 1) / tick_ms_;
+}
+
+int64_t TimerWheel::TickAtOrBefore(int64_t time_ms) const {
+  if (time_ms <= 0)
+    return 0;
+  return time_ms / tick_ms_;
+}
+
+void TimerWheel::Insert(Entry* entry) {
+  if (entry->tick_ <= now_tick_) {
+    Link(&due_, entry);
+    return;
+  }
+  // A timer goes on the innermost wheel whose current rotation contains its
+  // tick, i.e. the first level above which its tick and |now_tick_| agree.
+  for (int level = 0; level < kLevels; ++level) {
+    int shift = (level + 1) * kLevelBits;
+    if ((entry->tick_ >> shift) == (now_tick_ >> shift)) {
+      int slot = (entry->tick_ >> (level * kLevelBits)) & (kSlots - 1);
+      Link(&wheels_[level][slot], entry);
+      occupied_[level] |= uint64_t{1} << slot;
+      return;
+    }
+  }
+  Link(&overflow_, entry);
+}
+
+void TimerWheel::Link(List* list, Entry* entry) {
+  entry->list_ = list;
+  entry->prev_ = nullptr;
+  entry->next_ = list->head;
+  if (list->head)
+    list->head->prev_ = entry;
+  list->head = entry;
+}
+
+void TimerWheel::Unlink(Entry* entry) {
+  List* list = entry->list_;
+  if (entry->prev_) {
+    entry->prev_->next_ = entry->next_;
+  } else {
+    list->head = entry->next_;
+  }
+  if (entry->next_)
+    entry->next_->prev_ = entry->prev_;
+  entry->prev_ = nullptr;
+  entry->next_ = nullptr;
+  entry->list_ = nullptr;
+
+  if (!list->head && list >= &wheels_[0][0] &&
+      list < &wheels_[0][0] + kLevels * kSlots) {
+    ptrdiff_t index = list - &wheels_[0][0];
+    occupied_[index / kSlots] &= ~(uint64_t{1} << (index % kSlots));
+  }
+}
+
+void TimerWheel::Rehash(List* list) {
+  // Entries are linked at the head, so the ones visited are never ones that
+  // were just put back on |list|.
+  Entry* entry = list->head;
+  while (entry) {
+    Entry* next = entry->next_;
+    Unlink(entry);
+    Insert(entry);
+    entry = next;
+  }
+}
+
+void TimerWheel::RehashAll() {
+  List all;
+  ForEachList([this, &all](List* list) {
+    while (Entry* entry = list->head) {
+      Unlink(entry);
+      Link(&all, entry);
+    }
+  });
+  while (Entry* entry = all.head) {
+    Unlink(entry);
+    entry->tick_ = TickAtOrAfter(entry->deadline_ms_);
+    Insert(entry);
+  }
+}
+
+int TimerWheel::NextOccupiedSlot(int level) const {
+  int current = (now_tick_ >> (level * kLevelBits)) & (kSlots - 1);
+  if (current == kSlots - 1)
+    return -1;
+  uint64_t later = occupied_[level] & (~uint64_t{0} << (current + 1));
+  return later ? CountTrailingZeros(later) : -1;
+}
+
+bool TimerWheel::NextEventTick(int64_t* tick, int* level, int* slot) const {
+  // Every timer on a wheel sits after |now_tick_|'s slot in that wheel's
+  // current rotation, and an inner wheel's rotation ends before the next slot
+  // of the wheel outside it begins, so the first level with an occupied slot
+  // holds the next event.
+  for (int l = 0; l < kLevels; ++l) {
+    int s = NextOccupiedSlot(l);
+    if (s < 0)
+      continue;
+    int shift = (l + 1) * kLevelBits;
+    *tick = ((now_tick_ >> shift) << shift) |
+            (static_cast<int64_t>(s) << (l * kLevelBits));
+    *level = l;
+    *slot = s;
+    return true;
+  }
+  if (!overflow_.head)
+    return false;
+  int shift = kLevels * kLevelBits;
+  *tick = ((now_tick_ >> shift) + 1) << shift;
+  *level = kLevels;
+  *slot = 0;
+  return true;
+}
+
+}  // namespace rtc
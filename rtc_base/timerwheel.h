@@ -0,0 +1,170 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_BASE_TIMERWHEEL_H_
+#define RTC_BASE_TIMERWHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/constructormagic.h"
+
+namespace rtc {
+
+// Hierarchical timing wheel for large numbers of timers, e.g. the delayed
+// messages of a MessageQueue or the delayed tasks of a TaskQueue.
+//
+// Time is divided into ticks of |slack_ms| milliseconds (at least 1). A timer
+// is hashed into one of the 64 slots of one of six wheels by its deadline
+// tick, so Schedule() and Cancel() are O(1) and never allocate. Timers on the
+// outer wheels are moved inwards as time reaches their slot, and every timer
+// in an inner slot expires in the same Advance() call. Deadlines are rounded
+// up to a whole tick, so with a slack of N ms a timer fires at most N - 1 ms
+// late, and timers within the same N ms window share one wakeup.
+//
+// Timers are intrusive: clients derive from TimerWheel::Entry and own the
+// storage. The wheel is not thread safe.
+class TimerWheel {
+ private:
+  struct List;
+
+ public:
+  class Entry {
+   public:
+    Entry();
+    ~Entry();
+
+    bool scheduled() const { return list_ != nullptr; }
+    int64_t deadline_ms() const { return deadline_ms_; }
+
+   private:
+    friend class TimerWheel;
+
+    Entry* prev_;
+    Entry* next_;
+    List* list_;
+    int64_t deadline_ms_;
+    int64_t tick_;
+    uint64_t sequence_;
+
+    RTC_DISALLOW_COPY_AND_ASSIGN(Entry);
+  };
+
+  explicit TimerWheel(int slack_ms = 0);
+  ~TimerWheel();
+
+  int slack_ms() const { return tick_ms_; }
+  // Changing the slack rehashes every scheduled timer.
+  void set_slack_ms(int slack_ms);
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  // Schedules |entry|, which must not already be scheduled, to expire at
+  // |deadline_ms|. Deadlines that have already passed expire on the next
+  // Advance().
+  void Schedule(Entry* entry, int64_t deadline_ms);
+  // Unschedules |entry|, which must be scheduled on this wheel.
+  void Cancel(Entry* entry);
+
+  // Appends every timer due at |now_ms| to |expired|, ordered by deadline and
+  // then by the order they were scheduled, and unschedules them. Time may go
+  // backwards, e.g. when a fake clock is installed; that rehashes every timer.
+  void Advance(int64_t now_ms, std::vector<Entry*>* expired);
+
+  // Returns false if no timer is scheduled. Otherwise sets |*expiry_ms| to the
+  // earliest time at which Advance() will expire a timer. That is at or
+  // before the current time if a timer is already due.
+  bool NextExpiry(int64_t* expiry_ms) const;
+
+  // Unschedules every timer for which |pred(entry)| is true and appends it to
+  // |cancelled|. Visits every scheduled timer; meant for bulk removal, not for
+  // the per-timer fast path.
+  template <typename Predicate>
+  void CancelIf(Predicate pred, std::vector<Entry*>* cancelled) {
+    ForEachList([&](List* list) {
+      Entry* entry = list->head;
+      while (entry) {
+        Entry* next = entry->next_;
+        if (pred(entry)) {
+          Cancel(entry);
+          cancelled->push_back(entry);
+        }
+        entry = next;
+      }
+    });
+  }
+
+ private:
+  // Six wheels of 64 slots reach 2^36 ticks, more than two years at 1 ms.
+  static const int kLevelBits = 6;
+  static const int kLevels = 6;
+  static const int kSlots = 1 << kLevelBits;
+
+  struct List {
+    Entry* head = nullptr;
+  };
+
+  template <typename Function>
+  void ForEachList(Function function) {
+    function(&due_);
+    function(&overflow_);
+    for (int level = 0; level < kLevels; ++level) {
+      uint64_t occupied = occupied_[level];
+      while (occupied) {
+        int slot = CountTrailingZeros(occupied);
+        occupied &= occupied - 1;
+        function(&wheels_[level][slot]);
+      }
+    }
+  }
+
+  static int CountTrailingZeros(uint64_t bits);
+  static bool ExpiresBefore(const Entry* a, const Entry* b);
+
+  int64_t TickAtOrAfter(int64_t time_ms) const;
+  int64_t TickAtOrBefore(int64_t time_ms) const;
+
+  // Files |entry| by its tick relative to |now_tick_|.
+  void Insert(Entry* entry);
+  void Link(List* list, Entry* entry);
+  void Unlink(Entry* entry);
+  // Moves every timer in |list| to where it belongs now.
+  void Rehash(List* list);
+  void RehashAll();
+
+  // First occupied slot after |now_tick_|'s own slot in the current rotation
+  // of |level|, or -1.
+  int NextOccupiedSlot(int level) const;
+  // The next tick after |now_tick_| at which a timer expires or has to move
+  // to an inner wheel. Returns false if there is none.
+  bool NextEventTick(int64_t* tick, int* level, int* slot) const;
+
+  int tick_ms_;
+  int64_t now_tick_;
+  size_t size_;
+  uint64_t next_sequence_;
+  // Timers that were already due when scheduled.
+  List due_;
+  // Timers beyond the reach of the outermost wheel.
+  List overflow_;
+  List wheels_[kLevels][kSlots];
+  // Bit n of occupied_[level] is set iff wheels_[level][n] is not empty.
+  uint64_t occupied_[kLevels];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(TimerWheel);
+};
+
+}  // namespace rtc
+
+#endif  // RTC_BASE_TIMERWHEEL_H_
@@ -0,0 +1,301 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_base/timerwheel.h"
+
+#include <algorithm>
+#include <memory>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "rtc_base/random.h"
+#include "rtc_base/timeutils.h"
+#include "test/gtest.h"
+#include "test/testsupport/perf_test.h"
+
+namespace rtc {
+namespace {
+
+struct TestTimer : public TimerWheel::Entry {
+  int id = 0;
+};
+
+std::vector<int> Ids(const std::vector<TimerWheel::Entry*>& entries) {
+  std::vector<int> ids;
+  for (TimerWheel::Entry* entry : entries)
+    ids.push_back(static_cast<TestTimer*>(entry)->id);
+  return ids;
+}
+
+}  // namespace
+
+TEST(TimerWheelTest, ExpiresAtDeadline) {
+  TimerWheel wheel;
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(1000, &expired);
+
+  TestTimer timer;
+  wheel.Schedule(&timer, 1005);
+  int64_t expiry_ms = 0;
+  EXPECT_TRUE(wheel.NextExpiry(&expiry_ms));
+  EXPECT_EQ(1005, expiry_ms);
+
+  wheel.Advance(1004, &expired);
+  EXPECT_TRUE(expired.empty());
+  EXPECT_TRUE(timer.scheduled());
+
+  wheel.Advance(1005, &expired);
+  ASSERT_EQ(1u, expired.size());
+  EXPECT_EQ(&timer, expired[0]);
+  EXPECT_FALSE(timer.scheduled());
+  EXPECT_TRUE(wheel.empty());
+  EXPECT_FALSE(wheel.NextExpiry(&expiry_ms));
+}
+
+TEST(TimerWheelTest, ExpiresInDeadlineThenScheduleOrder) {
+  TimerWheel wheel;
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(1000, &expired);
+
+  TestTimer timers[5];
+  const int64_t deadlines[] = {1000, 998, 999, 1000, 999};
+  const int ids[] = {3, 0, 1, 4, 2};
+  for (int i = 0; i < 5; ++i) {
+    timers[i].id = ids[i];
+    wheel.Schedule(&timers[i], deadlines[i]);
+  }
+  wheel.Advance(1000, &expired);
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), Ids(expired));
+}
+
+TEST(TimerWheelTest, CancelledTimersDoNotExpire) {
+  TimerWheel wheel;
+  TestTimer near, far;
+  wheel.Schedule(&near, 10);
+  wheel.Schedule(&far, 100000);
+  wheel.Cancel(&near);
+  wheel.Cancel(&far);
+  EXPECT_TRUE(wheel.empty());
+
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(1000000, &expired);
+  EXPECT_TRUE(expired.empty());
+}
+
+TEST(TimerWheelTest, SlackCoalescesNearbyDeadlines) {
+  TimerWheel wheel(10);
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(100, &expired);
+
+  TestTimer timers[10];
+  for (int i = 0; i < 10; ++i) {
+    timers[i].id = i;
+    wheel.Schedule(&timers[i], 101 + i);
+  }
+  int64_t expiry_ms = 0;
+  EXPECT_TRUE(wheel.NextExpiry(&expiry_ms));
+  EXPECT_EQ(110, expiry_ms);
+
+  wheel.Advance(109, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(110, &expired);
+  EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}), Ids(expired));
+}
+
+TEST(TimerWheelTest, ChangingSlackKeepsTimers) {
+  TimerWheel wheel;
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(1000, &expired);
+  TestTimer timer;
+  wheel.Schedule(&timer, 1234);
+
+  wheel.set_slack_ms(100);
+  int64_t expiry_ms = 0;
+  EXPECT_TRUE(wheel.NextExpiry(&expiry_ms));
+  EXPECT_EQ(1300, expiry_ms);
+
+  wheel.set_slack_ms(0);
+  EXPECT_TRUE(wheel.NextExpiry(&expiry_ms));
+  EXPECT_EQ(1234, expiry_ms);
+  wheel.Advance(1234, &expired);
+  EXPECT_EQ(1u, expired.size());
+}
+
+TEST(TimerWheelTest, HandlesTimeGoingBackwards) {
+  TimerWheel wheel;
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(1000000, &expired);
+
+  // Scheduled against a clock that was reset to a much earlier time.
+  TestTimer timer;
+  wheel.Schedule(&timer, 1010);
+  wheel.Advance(1000, &expired);
+  EXPECT_TRUE(expired.empty());
+  int64_t expiry_ms = 0;
+  EXPECT_TRUE(wheel.NextExpiry(&expiry_ms));
+  EXPECT_EQ(1010, expiry_ms);
+  wheel.Advance(1010, &expired);
+  EXPECT_EQ(1u, expired.size());
+}
+
+TEST(TimerWheelTest, HandlesDeadlinesBeyondTheOutermostWheel) {
+  TimerWheel wheel;
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(1000, &expired);
+
+  const int64_t kFar = int64_t{1} << 40;
+  TestTimer timer;
+  wheel.Schedule(&timer, kFar);
+  int64_t expiry_ms = 0;
+  EXPECT_TRUE(wheel.NextExpiry(&expiry_ms));
+  EXPECT_EQ(kFar, expiry_ms);
+  wheel.Advance(kFar - 1, &expired);
+  EXPECT_TRUE(expired.empty());
+  wheel.Advance(kFar, &expired);
+  EXPECT_EQ(1u, expired.size());
+}
+
+TEST(TimerWheelTest, CancelIf) {
+  TimerWheel wheel;
+  TestTimer timers[6];
+  for (int i = 0; i < 6; ++i) {
+    timers[i].id = i;
+    wheel.Schedule(&timers[i], i * 1000);
+  }
+  std::vector<TimerWheel::Entry*> cancelled;
+  wheel.CancelIf(
+      [](TimerWheel::Entry* entry) {
+        return static_cast<TestTimer*>(entry)->id % 2 == 1;
+      },
+      &cancelled);
+  std::vector<int> ids = Ids(cancelled);
+  std::sort(ids.begin(), ids.end());
+  EXPECT_EQ((std::vector<int>{1, 3, 5}), ids);
+  EXPECT_EQ(3u, wheel.size());
+
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(10000, &expired);
+  EXPECT_EQ((std::vector<int>{0, 2, 4}), Ids(expired));
+}
+
+// Compares the wheel against a sorted list of deadlines while time advances
+// in uneven steps across every level of the wheel.
+TEST(TimerWheelTest, MatchesReferenceWithRandomDeadlines) {
+  webrtc::Random random(4711);
+  const int64_t kStart = 123456789;
+  const int kTimers = 2000;
+  TimerWheel wheel;
+  std::vector<TimerWheel::Entry*> expired;
+  wheel.Advance(kStart, &expired);
+
+  std::vector<std::unique_ptr<TestTimer>> timers;
+  std::vector<int64_t> deadlines;
+  for (int i = 0; i < kTimers; ++i) {
+    timers.emplace_back(new TestTimer());
+    timers.back()->id = i;
+    // Spread deadlines from sub-millisecond to hours away.
+    int64_t delay = random.Rand(0, 1 << random.Rand(0, 24));
+    deadlines.push_back(kStart + delay);
+    wheel.Schedule(timers.back().get(), deadlines.back());
+  }
+
+  int64_t now = kStart;
+  size_t remaining = kTimers;
+  while (remaining > 0) {
+    int64_t expected_next = INT64_MAX;
+    for (int i = 0; i < kTimers; ++i) {
+      if (timers[i]->scheduled())
+        expected_next = std::min(expected_next, deadlines[i]);
+    }
+    int64_t expiry_ms = 0;
+    ASSERT_TRUE(wheel.NextExpiry(&expiry_ms));
+    ASSERT_EQ(expected_next, expiry_ms);
+
+    now += random.Rand(0, 1 << random.Rand(0, 20));
+    expired.clear();
+    wheel.Advance(now, &expired);
+    for (TimerWheel::Entry* entry : expired)
+      ASSERT_LE(entry->deadline_ms(), now);
+    for (int i = 0; i < kTimers; ++i) {
+      if (timers[i]->scheduled())
+        ASSERT_GT(deadlines[i], now);
+    }
+    remaining -= expired.size();
+    ASSERT_EQ(remaining, wheel.size());
+  }
+}
+
+// Simulates |kTimers| periodic timers (RTCP, ICE pings, stats...) with
+// periods between 20 ms and 5 s for one simulated minute, rescheduling each
+// timer when it fires, with the wheel and with a binary heap of deadlines.
+TEST(TimerWheelTest, DISABLED_PeriodicTimersBenchmark) {
+  const int kTimers = 50000;
+  const int64_t kDurationMs = 60000;
+  webrtc::Random random(17);
+  std::vector<int64_t> periods;
+  for (int i = 0; i < kTimers; ++i)
+    periods.push_back(random.Rand(20, 5000));
+
+  int64_t wheel_fired = 0;
+  int64_t start_ns = TimeNanos();
+  {
+    TimerWheel wheel;
+    std::vector<std::unique_ptr<TestTimer>> timers;
+    for (int i = 0; i < kTimers; ++i) {
+      timers.emplace_back(new TestTimer());
+      timers.back()->id = i;
+      wheel.Schedule(timers.back().get(), periods[i]);
+    }
+    std::vector<TimerWheel::Entry*> expired;
+    for (int64_t now = 1; now <= kDurationMs; ++now) {
+      expired.clear();
+      wheel.Advance(now, &expired);
+      for (TimerWheel::Entry* entry : expired) {
+        TestTimer* timer = static_cast<TestTimer*>(entry);
+        wheel.Schedule(timer, now + periods[timer->id]);
+      }
+      wheel_fired += expired.size();
+    }
+    for (auto& timer : timers)
+      wheel.Cancel(timer.get());
+  }
+  int64_t wheel_ns = TimeNanos() - start_ns;
+
+  int64_t heap_fired = 0;
+  start_ns = TimeNanos();
+  {
+    typedef std::pair<int64_t, int> Deadline;
+    std::priority_queue<Deadline, std::vector<Deadline>, std::greater<Deadline>>
+        heap;
+    for (int i = 0; i < kTimers; ++i)
+      heap.push(Deadline(periods[i], i));
+    for (int64_t now = 1; now <= kDurationMs; ++now) {
+      while (heap.top().first <= now) {
+        int id = heap.top().second;
+        heap.pop();
+        heap.push(Deadline(now + periods[id], id));
+        ++heap_fired;
+      }
+    }
+  }
+  int64_t heap_ns = TimeNanos() - start_ns;
+
+  EXPECT_EQ(heap_fired, wheel_fired);
+  const std::string trace = std::to_string(kTimers) + "_timers";
+  webrtc::test::PrintResult("timer_expiry_time", "_wheel", trace,
+                            static_cast<double>(wheel_ns) / wheel_fired, "ns",
+                            false);
+  webrtc::test::PrintResult("timer_expiry_time", "_heap", trace,
+                            static_cast<double>(heap_ns) / heap_fired, "ns",
+                            false);
+}
+
+}  // namespace rtc
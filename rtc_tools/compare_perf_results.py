@@ -0,0 +1,133 @@
+#!/usr/bin/env python
+# Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+"""Compares the perf results of two builds.
+
+The inputs are the JSON files written by webrtc::test::WritePerfResults(). For
+every trace found in both files which has enough samples in each (see
+PrintResultHistogram() and PrintResultList()), a two-sided Mann-Whitney U test
+tells whether the samples of the two builds differ. Traces that changed both
+significantly and by more than --min_change are printed, and the script then
+exits with 1.
+"""
+
+import json
+import math
+import optparse
+import sys
+
+
+# The normal approximation of the U statistic needs a few samples per side.
+MIN_SAMPLES = 8
+
+
+def _ParseArgs():
+  """Registers the command-line options."""
+  usage = 'usage: %prog [options] <baseline.json> <candidate.json>'
+  parser = optparse.OptionParser(usage=usage)
+
+  parser.add_option('--alpha', type='float', default=0.01,
+                    help=('Significance level of the test. '
+                          'Default: %default'))
+  parser.add_option('--min_change', type='float', default=0.05,
+                    help=('Smallest relative change of the median worth '
+                          'reporting. Default: %default'))
+  options, args = parser.parse_args()
+  if len(args) != 2:
+    parser.error('Expected a baseline and a candidate results file.')
+  return options, args
+
+
+def _Median(values):
+  values = sorted(values)
+  middle = len(values) // 2
+  if len(values) % 2:
+    return values[middle]
+  return (values[middle - 1] + values[middle]) / 2.0
+
+
+def MannWhitneyPValue(a, b):
+  """Returns the two-sided p-value that |a| and |b| share a distribution."""
+  samples = sorted([(value, 0) for value in a] + [(value, 1) for value in b])
+  n = len(samples)
+  rank_sum_a = 0.0
+  tie_correction = 0.0
+  i = 0
+  while i < n:
+    # Tied samples share the average of their ranks.
+    j = i
+    while j + 1 < n and samples[j + 1][0] == samples[i][0]:
+      j += 1
+    rank = (i + j) / 2.0 + 1
+    num_tied = j - i + 1
+    tie_correction += num_tied ** 3 - num_tied
+    rank_sum_a += rank * sum(1 for k in range(i, j + 1) if samples[k][1] == 0)
+    i = j + 1
+
+  n_a = len(a)
+  n_b = len(b)
+  u = rank_sum_a - n_a * (n_a + 1) / 2.0
+  mean_u = n_a * n_b / 2.0
+  variance_u = n_a * n_b / 12.0 * ((n + 1) - tie_correction / (n * (n - 1)))
+  if variance_u <= 0:
+    return 1.0
+  z = abs(u - mean_u) / math.sqrt(variance_u)
+  return math.erfc(z / math.sqrt(2))
+
+
+def _Samples(results):
+  """Maps (chart, trace) to the list of samples, for traces that have some."""
+  samples = {}
+  for chart, traces in results.get('charts', {}).items():
+    for trace, result in traces.items():
+      if result.get('type') == 'list_of_scalar_values':
+        samples[(chart, trace)] = result['values']
+  return samples
+
+
+def CompareResults(baseline, candidate, alpha, min_change):
+  """Returns (chart, trace, baseline median, candidate median, p-value) for
+  every trace that changed significantly between |baseline| and |candidate|,
+  the parsed JSON of two results files."""
+  baseline_samples = _Samples(baseline)
+  candidate_samples = _Samples(candidate)
+  changes = []
+  for key in sorted(set(baseline_samples) & set(candidate_samples)):
+    a = baseline_samples[key]
+    b = candidate_samples[key]
+    if len(a) < MIN_SAMPLES or len(b) < MIN_SAMPLES:
+      continue
+    median_a = _Median(a)
+    median_b = _Median(b)
+    if median_a == 0 or abs(median_b - median_a) / abs(median_a) < min_change:
+      continue
+    p_value = MannWhitneyPValue(a, b)
+    if p_value < alpha:
+      changes.append((key[0], key[1], median_a, median_b, p_value))
+  return changes
+
+
+def main():
+  options, args = _ParseArgs()
+  with open(args[0]) as baseline_file:
+    baseline = json.load(baseline_file)
+  with open(args[1]) as candidate_file:
+    candidate = json.load(candidate_file)
+
+  changes = CompareResults(baseline, candidate, options.alpha,
+                           options.min_change)
+  for chart, trace, median_a, median_b, p_value in changes:
+    print('%s: %s median %g -> %g (%+.1f%%, p=%.2g)' %
+          (chart, trace, median_a, median_b,
+           100.0 * (median_b - median_a) / abs(median_a), p_value))
+  return 1 if changes else 0
+
+
+if __name__ == '__main__':
+  sys.exit(main())
@@ -0,0 +1,60 @@
+#!/usr/bin/env python
+# Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+#
+# Use of this source code is governed by a BSD-style license
+# that can be found in the LICENSE file in the root of the source
+# tree. An additional intellectual property rights grant can be found
+# in the file PATENTS.  All contributing project authors may
+# be found in the AUTHORS file in the root of the source tree.
+
+import unittest
+from compare_perf_results import CompareResults, MannWhitneyPValue
+
+
+def _Results(values):
+  return {
+      'format_version': '1.0',
+      'charts': {
+          'frame_time': {
+              'encode': {
+                  'type': 'list_of_scalar_values',
+                  'values': values,
+                  'units': 'ms',
+              },
+          },
+      },
+  }
+
+
+class ComparePerfResultsTest(unittest.TestCase):
+  def testSameSamplesDoNotDiffer(self):
+    values = [10, 11, 12, 13, 14, 15, 16, 17, 18, 19]
+    self.assertAlmostEqual(MannWhitneyPValue(values, values), 1.0)
+    self.assertEqual(CompareResults(_Results(values), _Results(values),
+                                    0.01, 0.05), [])
+
+  # Verifies that a shift of all the samples is flagged.
+  def testShiftedSamplesAreFlagged(self):
+    baseline = [10, 11, 12, 13, 14, 15, 16, 17, 18, 19]
+    candidate = [value + 10 for value in baseline]
+    changes = CompareResults(_Results(baseline), _Results(candidate),
+                             0.01, 0.05)
+    self.assertEqual(len(changes), 1)
+    chart, trace, median_a, median_b, p_value = changes[0]
+    self.assertEqual((chart, trace), ('frame_time', 'encode'))
+    self.assertEqual((median_a, median_b), (14.5, 24.5))
+    self.assertLess(p_value, 0.01)
+
+  def testSmallChangeIsNotFlagged(self):
+    baseline = [100, 101, 102, 103, 104, 105, 106, 107, 108, 109]
+    candidate = [value + 1 for value in baseline]
+    self.assertEqual(CompareResults(_Results(baseline), _Results(candidate),
+                                    0.01, 0.05), [])
+
+  def testTooFewSamplesAreSkipped(self):
+    self.assertEqual(CompareResults(_Results([1, 2, 3]), _Results([7, 8, 9]),
+                                    0.01, 0.05), [])
+
+
+if __name__ == '__main__':
+  unittest.main()
@@ -129,21 +129,22 @@ int64_t WrappingDifference(uint32_t later, uint32_t earlier, int64_t modulus) {
 }
 
 // This is much more reliable for outgoing streams than for incoming streams.
+// |rtp_timestamps| are the unwrapped RTP timestamps of |packets|.
 template <typename RtpPacketContainer>
 rtc::Optional<uint32_t> EstimateRtpClockFrequency(
     const RtpPacketContainer& packets,
+    const std::vector<int64_t>& rtp_timestamps,
     int64_t end_time_us) {
   RTC_CHECK(packets.size() >= 2);
-  SeqNumUnwrapper<uint32_t> unwrapper;
-  uint64_t first_rtp_timestamp =
-      unwrapper.Unwrap(packets[0].rtp.header.timestamp);
+  RTC_DCHECK_EQ(packets.size(), rtp_timestamps.size());
+  uint64_t first_rtp_timestamp = rtp_timestamps[0];
   int64_t first_log_timestamp = packets[0].log_time_us();
   uint64_t last_rtp_timestamp = first_rtp_timestamp;
   int64_t last_log_timestamp = first_log_timestamp;
   for (size_t i = 1; i < packets.size(); i++) {
     if (packets[i].log_time_us() > end_time_us)
       break;
-    last_rtp_timestamp = unwrapper.Unwrap(packets[i].rtp.header.timestamp);
+    last_rtp_timestamp = rtp_timestamps[i];
     last_log_timestamp = packets[i].log_time_us();
   }
   if (last_log_timestamp - first_log_timestamp < kNumMicrosecsPerSec) {
@@ -282,27 +283,6 @@ void AccumulatePoints(
   }
 }
 
-// For each pair of adjacent elements in |data|, use |f()| to extract a
-// y-coordinate and store the result in a TimeSeries. Note that the x-coordinate
-// will be the time of the second element in the pair.
-template <typename DataType, typename ResultType, typename IterableType>
-void AccumulatePairs(
-    rtc::FunctionView<rtc::Optional<ResultType>(const DataType&,
-                                                const DataType&)> f,
-    const IterableType& data,
-    int64_t begin_time,
-    TimeSeries* result) {
-  ResultType sum = 0;
-  for (size_t i = 1; i < data.size(); i++) {
-    float x = static_cast<float>(data[i].log_time_us() - begin_time) /
-              kNumMicrosecsPerSec;
-    rtc::Optional<ResultType> y = f(data[i - 1], data[i]);
-    if (y)
-      sum += *y;
-    result->points.emplace_back(x, static_cast<float>(sum));
-  }
-}
-
 // Calculates a moving average of |data| and stores the result in a TimeSeries.
 // A data point is generated every |step| microseconds from |begin_time|
 // to |end_time|. The value of each data point is the average of the data
@@ -502,6 +482,16 @@ EventLogAnalyzer::EventLogAnalyzer(const ParsedRtcEventLogNew& log)
   }
   RTC_LOG(LS_INFO) << "Found " << log_segments_.size()
                << " (LOG_START, LOG_END) segments in log.";
+
+  // TODO(qingsi): Add the handling of the "Updated" config event after the
+  // visualization of property change for candidate pairs is introduced.
+  for (const auto& config : parsed_log_.ice_candidate_pair_configs()) {
+    if (candidate_pair_desc_by_id_.find(config.candidate_pair_id) ==
+        candidate_pair_desc_by_id_.end()) {
+      candidate_pair_desc_by_id_[config.candidate_pair_id] =
+          GetCandidatePairLogDescriptionAsString(config);
+    }
+  }
 }
 
 class BitrateObserver : public NetworkChangedObserver,
@@ -536,6 +526,46 @@ float EventLogAnalyzer::ToCallTime(int64_t timestamp) const {
   return static_cast<float>(timestamp - begin_time_) / kNumMicrosecsPerSec;
 }
 
+const std::vector<EventLogAnalyzer::DelayChange>&
+EventLogAnalyzer::GetIncomingDelayChanges(
+    const ParsedRtcEventLogNew::LoggedRtpStreamView& stream) {
+  rtc::CritScope lock(&cache_crit_);
+  auto it = incoming_delay_changes_.find(stream.ssrc);
+  if (it != incoming_delay_changes_.end())
+    return it->second;
+
+  std::vector<DelayChange>& delay_changes =
+      incoming_delay_changes_[stream.ssrc];
+  const auto& packets = stream.packet_view;
+  for (size_t i = 1; i < packets.size(); i++) {
+    DelayChange delay_change;
+    delay_change.time_s = ToCallTime(packets[i].log_time_us());
+    delay_change.capture_time_ms =
+        *NetworkDelayDiff_CaptureTime(packets[i - 1], packets[i]);
+    delay_change.abs_send_time_ms =
+        NetworkDelayDiff_AbsSendTime(packets[i - 1], packets[i]);
+    delay_changes.push_back(delay_change);
+  }
+  return delay_changes;
+}
+
+const std::vector<int64_t>& EventLogAnalyzer::GetUnwrappedRtpTimestamps(
+    PacketDirection direction,
+    const ParsedRtcEventLogNew::LoggedRtpStreamView& stream) {
+  rtc::CritScope lock(&cache_crit_);
+  const auto key = std::make_pair(direction, stream.ssrc);
+  auto it = unwrapped_rtp_timestamps_.find(key);
+  if (it != unwrapped_rtp_timestamps_.end())
+    return it->second;
+
+  std::vector<int64_t>& timestamps = unwrapped_rtp_timestamps_[key];
+  timestamps.reserve(stream.packet_view.size());
+  SeqNumUnwrapper<uint32_t> unwrapper;
+  for (const auto& packet : stream.packet_view)
+    timestamps.push_back(unwrapper.Unwrap(packet.header.timestamp));
+  return timestamps;
+}
+
 void EventLogAnalyzer::CreatePacketGraph(PacketDirection direction,
                                          Plot* plot) {
   for (const auto& stream : parsed_log_.rtp_packets_by_ssrc(direction)) {
@@ -749,17 +779,18 @@ void EventLogAnalyzer::CreateIncomingDelayDeltaGraph(Plot* plot) {
     TimeSeries capture_time_data(
         GetStreamName(kIncomingPacket, stream.ssrc) + " capture-time",
         LineStyle::kBar);
-    ProcessPairs<LoggedRtpPacket, double>(NetworkDelayDiff_CaptureTime,
-                                          stream.packet_view, begin_time_,
-                                          &capture_time_data);
-    plot->AppendTimeSeries(std::move(capture_time_data));
-
     TimeSeries send_time_data(
         GetStreamName(kIncomingPacket, stream.ssrc) + " abs-send-time",
         LineStyle::kBar);
-    ProcessPairs<LoggedRtpPacket, double>(NetworkDelayDiff_AbsSendTime,
-                                          stream.packet_view, begin_time_,
-                                          &send_time_data);
+    for (const DelayChange& delay_change : GetIncomingDelayChanges(stream)) {
+      capture_time_data.points.emplace_back(delay_change.time_s,
+                                            delay_change.capture_time_ms);
+      if (delay_change.abs_send_time_ms) {
+        send_time_data.points.emplace_back(delay_change.time_s,
+                                           *delay_change.abs_send_time_ms);
+      }
+    }
+    plot->AppendTimeSeries(std::move(capture_time_data));
     plot->AppendTimeSeries(std::move(send_time_data));
   }
 
@@ -782,17 +813,20 @@ void EventLogAnalyzer::CreateIncomingDelayGraph(Plot* plot) {
     TimeSeries capture_time_data(
         GetStreamName(kIncomingPacket, stream.ssrc) + " capture-time",
         LineStyle::kLine);
-    AccumulatePairs<LoggedRtpPacket, double>(NetworkDelayDiff_CaptureTime,
-                                             stream.packet_view, begin_time_,
-                                             &capture_time_data);
-    plot->AppendTimeSeries(std::move(capture_time_data));
-
     TimeSeries send_time_data(
         GetStreamName(kIncomingPacket, stream.ssrc) + " abs-send-time",
         LineStyle::kLine);
-    AccumulatePairs<LoggedRtpPacket, double>(NetworkDelayDiff_AbsSendTime,
-                                             stream.packet_view, begin_time_,
-                                             &send_time_data);
+    double capture_time_sum = 0;
+    double send_time_sum = 0;
+    for (const DelayChange& delay_change : GetIncomingDelayChanges(stream)) {
+      capture_time_sum += delay_change.capture_time_ms;
+      send_time_sum += delay_change.abs_send_time_ms.value_or(0);
+      capture_time_data.points.emplace_back(
+          delay_change.time_s, static_cast<float>(capture_time_sum));
+      send_time_data.points.emplace_back(delay_change.time_s,
+                                         static_cast<float>(send_time_sum));
+    }
+    plot->AppendTimeSeries(std::move(capture_time_data));
     plot->AppendTimeSeries(std::move(send_time_data));
   }
 
@@ -1352,9 +1386,8 @@ void EventLogAnalyzer::CreateNetworkDelayFeedbackGraph(Plot* plot) {
 }
 
 void EventLogAnalyzer::CreatePacerDelayGraph(Plot* plot) {
-  for (const auto& stream : parsed_log_.outgoing_rtp_packets_by_ssrc()) {
-    const std::vector<LoggedRtpPacketOutgoing>& packets =
-        stream.outgoing_packets;
+  for (const auto& stream : parsed_log_.rtp_packets_by_ssrc(kOutgoingPacket)) {
+    const auto& packets = stream.packet_view;
 
     if (packets.size() < 2) {
       RTC_LOG(LS_WARNING)
@@ -1365,8 +1398,10 @@ void EventLogAnalyzer::CreatePacerDelayGraph(Plot* plot) {
     int64_t end_time_us = log_segments_.empty()
                               ? std::numeric_limits<int64_t>::max()
                               : log_segments_.front().second;
+    const std::vector<int64_t>& rtp_timestamps =
+        GetUnwrappedRtpTimestamps(kOutgoingPacket, stream);
     rtc::Optional<uint32_t> estimated_frequency =
-        EstimateRtpClockFrequency(packets, end_time_us);
+        EstimateRtpClockFrequency(packets, rtp_timestamps, end_time_us);
     if (!estimated_frequency)
       continue;
     if (IsVideoSsrc(kOutgoingPacket, stream.ssrc) &&
@@ -1381,19 +1416,16 @@ void EventLogAnalyzer::CreatePacerDelayGraph(Plot* plot) {
         GetStreamName(kOutgoingPacket, stream.ssrc) + "(" +
             std::to_string(*estimated_frequency / 1000) + " kHz)",
         LineStyle::kLine, PointStyle::kHighlight);
-    SeqNumUnwrapper<uint32_t> timestamp_unwrapper;
-    uint64_t first_capture_timestamp =
-        timestamp_unwrapper.Unwrap(packets.front().rtp.header.timestamp);
-    uint64_t first_send_timestamp = packets.front().rtp.log_time_us();
-    for (const auto& packet : packets) {
-      double capture_time_ms = (static_cast<double>(timestamp_unwrapper.Unwrap(
-                                    packet.rtp.header.timestamp)) -
-                                first_capture_timestamp) /
-                               *estimated_frequency * 1000;
+    uint64_t first_capture_timestamp = rtp_timestamps[0];
+    uint64_t first_send_timestamp = packets[0].log_time_us();
+    for (size_t i = 0; i < packets.size(); i++) {
+      double capture_time_ms =
+          (static_cast<double>(rtp_timestamps[i]) - first_capture_timestamp) /
+          *estimated_frequency * 1000;
       double send_time_ms =
-          static_cast<double>(packet.rtp.log_time_us() - first_send_timestamp) /
+          static_cast<double>(packets[i].log_time_us() - first_send_timestamp) /
           1000;
-      float x = ToCallTime(packet.rtp.log_time_us());
+      float x = ToCallTime(packets[i].log_time_us());
       float y = send_time_ms - capture_time_ms;
       pacer_delay_series.points.emplace_back(x, y);
     }
@@ -1855,8 +1887,6 @@ void EventLogAnalyzer::CreateIceCandidatePairConfigGraph(Plot* plot) {
           TimeSeries("[" + std::to_string(config.candidate_pair_id) + "]" +
                          candidate_pair_desc,
                      LineStyle::kNone, PointStyle::kHighlight);
-      candidate_pair_desc_by_id_[config.candidate_pair_id] =
-          candidate_pair_desc;
     }
     float x = ToCallTime(config.log_time_us());
     float y = static_cast<float>(config.type);
@@ -1877,23 +1907,11 @@ void EventLogAnalyzer::CreateIceCandidatePairConfigGraph(Plot* plot) {
 }
 
 std::string EventLogAnalyzer::GetCandidatePairLogDescriptionFromId(
-    uint32_t candidate_pair_id) {
-  if (candidate_pair_desc_by_id_.find(candidate_pair_id) !=
-      candidate_pair_desc_by_id_.end()) {
-    return candidate_pair_desc_by_id_[candidate_pair_id];
-  }
-  for (const auto& config : parsed_log_.ice_candidate_pair_configs()) {
-    // TODO(qingsi): Add the handling of the "Updated" config event after the
-    // visualization of property change for candidate pairs is introduced.
-    if (candidate_pair_desc_by_id_.find(config.candidate_pair_id) ==
-        candidate_pair_desc_by_id_.end()) {
-      const std::string candidate_pair_desc =
-          GetCandidatePairLogDescriptionAsString(config);
-      candidate_pair_desc_by_id_[config.candidate_pair_id] =
-          candidate_pair_desc;
-    }
-  }
-  return candidate_pair_desc_by_id_[candidate_pair_id];
+    uint32_t candidate_pair_id) const {
+  auto it = candidate_pair_desc_by_id_.find(candidate_pair_id);
+  if (it == candidate_pair_desc_by_id_.end())
+    return std::string();
+  return it->second;
 }
 
 void EventLogAnalyzer::CreateIceConnectivityCheckGraph(Plot* plot) {
@@ -20,7 +20,9 @@
 
 #include "logging/rtc_event_log/rtc_event_log_parser_new.h"
 #include "modules/audio_coding/neteq/tools/neteq_stats_getter.h"
+#include "rtc_base/criticalsection.h"
 #include "rtc_base/strings/string_builder.h"
+#include "rtc_base/thread_annotations.h"
 #include "rtc_tools/event_log_visualizer/plot_base.h"
 #include "rtc_tools/event_log_visualizer/triage_notifications.h"
 
@@ -33,6 +35,13 @@ class EventLogAnalyzer {
   // modified while the EventLogAnalyzer is being used.
   explicit EventLogAnalyzer(const ParsedRtcEventLogNew& log);
 
+  // The Create*Graph methods only read the log and write to their |plot|, so
+  // different plots can be created concurrently on several threads. The
+  // intermediate results that several plots share, like the per-stream delay
+  // changes, are computed once by whichever plot needs them first.
+  // CreateTriageNotifications and PrintNotifications must not run
+  // concurrently with anything else.
+
   void CreatePacketGraph(PacketDirection direction, Plot* plot);
 
   void CreateAccumulatedPacketsGraph(PacketDirection direction, Plot* plot);
@@ -197,7 +206,24 @@ class EventLogAnalyzer {
     outgoing_high_loss_alerts_.emplace_back(avg_loss_fraction);
   }
 
-  std::string GetCandidatePairLogDescriptionFromId(uint32_t candidate_pair_id);
+  // The change in one-way delay between two consecutive packets of an
+  // incoming stream, based on the capture time and, if the packets have it,
+  // the absolute send time.
+  struct DelayChange {
+    float time_s;
+    double capture_time_ms;
+    rtc::Optional<double> abs_send_time_ms;
+  };
+  const std::vector<DelayChange>& GetIncomingDelayChanges(
+      const ParsedRtcEventLogNew::LoggedRtpStreamView& stream);
+
+  // The RTP timestamps of the packets of a stream, unwrapped.
+  const std::vector<int64_t>& GetUnwrappedRtpTimestamps(
+      PacketDirection direction,
+      const ParsedRtcEventLogNew::LoggedRtpStreamView& stream);
+
+  std::string GetCandidatePairLogDescriptionFromId(
+      uint32_t candidate_pair_id) const;
 
   const ParsedRtcEventLogNew& parsed_log_;
 
@@ -219,8 +245,15 @@ class EventLogAnalyzer {
   std::vector<OutgoingCaptureTimeJump> outgoing_capture_time_jumps_;
   std::vector<OutgoingHighLoss> outgoing_high_loss_alerts_;
 
+  // Filled in by the constructor, and only read after that.
   std::map<uint32_t, std::string> candidate_pair_desc_by_id_;
 
+  rtc::CriticalSection cache_crit_;
+  std::map<uint32_t, std::vector<DelayChange>> incoming_delay_changes_
+      RTC_GUARDED_BY(cache_crit_);
+  std::map<std::pair<PacketDirection, uint32_t>, std::vector<int64_t>>
+      unwrapped_rtp_timestamps_ RTC_GUARDED_BY(cache_crit_);
+
   // Window and step size used for calculating moving averages, e.g. bitrate.
   // The generated data points will be |step_| microseconds apart.
   // Only events occuring at most |window_duration_| microseconds before the
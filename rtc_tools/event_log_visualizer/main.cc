@@ -8,13 +8,23 @@
  *  be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <stdio.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "logging/rtc_event_log/rtc_event_log_parser_new.h"
 #include "rtc_base/flags.h"
+#include "rtc_base/platform_thread.h"
+#include "rtc_base/ptr_util.h"
 #include "rtc_tools/event_log_visualizer/analyzer.h"
 #include "rtc_tools/event_log_visualizer/plot_base.h"
 #include "rtc_tools/event_log_visualizer/plot_python.h"
+#include "system_wrappers/include/cpu_info.h"
 #include "system_wrappers/include/field_trial_default.h"
 #include "test/field_trial.h"
 #include "test/testsupport/fileutils.h"
@@ -151,67 +161,73 @@ DEFINE_bool(print_triage_alerts,
             false,
             "Print triage alerts, i.e. a list of potential problems.");
 
-void SetAllPlotFlags(bool setting);
+DEFINE_int(threads,
+           0,
+           "The number of threads that the plots are created on. 0 means one "
+           "per CPU core.");
 
+DEFINE_string(output_dir,
+              "",
+              "Write the python script of each log to a file in this "
+              "directory, named after the log, instead of to stdout. Needed "
+              "when more than one log is given.");
 
-int main(int argc, char* argv[]) {
-  std::string program_name = argv[0];
-  std::string usage =
-      "A tool for visualizing WebRTC event logs.\n"
-      "Example usage:\n" +
-      program_name + " <logfile> | python\n" + "Run " + program_name +
-      " --help for a list of command line options\n";
+void SetAllPlotFlags(bool setting);
 
-  // Parse command line flags without removing them. We're only interested in
-  // the |plot_profile| flag.
-  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, false);
-  if (strcmp(FLAG_plot_profile, "all") == 0) {
-    SetAllPlotFlags(true);
-  } else if (strcmp(FLAG_plot_profile, "none") == 0) {
-    SetAllPlotFlags(false);
-  } else if (strcmp(FLAG_plot_profile, "sendside_bwe") == 0) {
-    SetAllPlotFlags(false);
-    FLAG_plot_outgoing_packet_sizes = true;
-    FLAG_plot_outgoing_bitrate = true;
-    FLAG_plot_outgoing_stream_bitrate = true;
-    FLAG_plot_simulated_sendside_bwe = true;
-    FLAG_plot_network_delay_feedback = true;
-    FLAG_plot_fraction_loss_feedback = true;
-  } else if (strcmp(FLAG_plot_profile, "receiveside_bwe") == 0) {
-    SetAllPlotFlags(false);
-    FLAG_plot_incoming_packet_sizes = true;
-    FLAG_plot_incoming_delay_delta = true;
-    FLAG_plot_incoming_delay = true;
-    FLAG_plot_incoming_loss_rate = true;
-    FLAG_plot_incoming_bitrate = true;
-    FLAG_plot_incoming_stream_bitrate = true;
-    FLAG_plot_simulated_receiveside_bwe = true;
-  } else if (strcmp(FLAG_plot_profile, "default") == 0) {
-    // Do nothing.
-  } else {
-    rtc::Flag* plot_profile_flag = rtc::FlagList::Lookup("plot_profile");
-    RTC_CHECK(plot_profile_flag);
-    plot_profile_flag->Print(false);
-  }
-  // Parse the remaining flags. They are applied relative to the chosen profile.
-  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+namespace {
 
-  if (argc != 2 || FLAG_help) {
-    // Print usage information.
-    std::cout << usage;
-    if (FLAG_help)
-      rtc::FlagList::Print(nullptr, false);
-    return 0;
+struct TaskList {
+  const std::vector<std::function<void()>>* tasks;
+  std::atomic<size_t> next_task;
+};
+
+void RunTasksOnThread(void* obj) {
+  TaskList* task_list = static_cast<TaskList*>(obj);
+  for (size_t i = task_list->next_task++; i < task_list->tasks->size();
+       i = task_list->next_task++) {
+    (*task_list->tasks)[i]();
   }
+}
 
-  webrtc::test::SetExecutablePath(argv[0]);
-  webrtc::test::ValidateFieldTrialsStringOrDie(FLAG_force_fieldtrials);
-  // InitFieldTrialsFromString stores the char*, so the char array must outlive
-  // the application.
-  webrtc::field_trial::InitFieldTrialsFromString(FLAG_force_fieldtrials);
+// Runs |tasks| on up to |num_threads| threads and returns when all of them
+// have run. Each thread takes the first task that no thread has taken yet, so
+// a thread stuck on a long simulation doesn't hold up the other tasks.
+void RunTasks(const std::vector<std::function<void()>>& tasks,
+              size_t num_threads) {
+  TaskList task_list;
+  task_list.tasks = &tasks;
+  task_list.next_task = 0;
+  num_threads = std::min(num_threads, tasks.size());
+  if (num_threads <= 1) {
+    RunTasksOnThread(&task_list);
+    return;
+  }
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (size_t i = 0; i < num_threads; ++i) {
+    threads.push_back(rtc::MakeUnique<rtc::PlatformThread>(
+        &RunTasksOnThread, &task_list, "AnalyzerWorker"));
+    threads.back()->Start();
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+}
 
-  std::string filename = argv[1];
+std::string OutputFileName(const std::string& output_dir,
+                           const std::string& log_name) {
+  size_t base_name_begin = log_name.find_last_of("/\\");
+  base_name_begin =
+      base_name_begin == std::string::npos ? 0 : base_name_begin + 1;
+  return output_dir + "/" + log_name.substr(base_name_begin) + ".py";
+}
 
+// Parses the log in |filename|, writes the python script that draws the
+// selected plots to |output| and, if asked to, prints the triage alerts.
+// The plots are independent of each other, so they are created concurrently
+// on |num_threads| threads; each is appended to the collection up front, so
+// the plots come out in the same order however the threads are scheduled.
+void AnalyzeLog(const std::string& filename,
+                FILE* output,
+                size_t num_threads) {
   webrtc::ParsedRtcEventLogNew::UnconfiguredHeaderExtensions header_extensions =
       webrtc::ParsedRtcEventLogNew::UnconfiguredHeaderExtensions::kDontParse;
   if (FLAG_parse_unconfigured_header_extensions) {
@@ -221,7 +237,8 @@ int main(int argc, char* argv[]) {
   webrtc::ParsedRtcEventLogNew parsed_log(header_extensions);
 
   if (!parsed_log.ParseFile(filename)) {
-    std::cerr << "Could not parse the entire log file." << std::endl;
+    std::cerr << "Could not parse the entire log file " << filename << "."
+              << std::endl;
     std::cerr << "Proceeding to analyze the first "
               << parsed_log.GetNumberOfEvents() << " events in the file."
               << std::endl;
@@ -229,99 +246,151 @@ int main(int argc, char* argv[]) {
 
   webrtc::EventLogAnalyzer analyzer(parsed_log);
   std::unique_ptr<webrtc::PlotCollection> collection(
-      new webrtc::PythonPlotCollection());
+      new webrtc::PythonPlotCollection(output));
+
+  std::vector<std::function<void()>> tasks;
+  auto add_plot = [&tasks, &collection](
+                      std::function<void(webrtc::Plot*)> create_plot) {
+    webrtc::Plot* plot = collection->AppendNewPlot();
+    tasks.push_back([create_plot, plot] { create_plot(plot); });
+  };
 
   if (FLAG_plot_incoming_packet_sizes) {
-    analyzer.CreatePacketGraph(webrtc::kIncomingPacket,
-                               collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreatePacketGraph(webrtc::kIncomingPacket, plot);
+    });
   }
   if (FLAG_plot_outgoing_packet_sizes) {
-    analyzer.CreatePacketGraph(webrtc::kOutgoingPacket,
-                               collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreatePacketGraph(webrtc::kOutgoingPacket, plot);
+    });
   }
   if (FLAG_plot_incoming_packet_count) {
-    analyzer.CreateAccumulatedPacketsGraph(webrtc::kIncomingPacket,
-                                           collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAccumulatedPacketsGraph(webrtc::kIncomingPacket, plot);
+    });
   }
   if (FLAG_plot_outgoing_packet_count) {
-    analyzer.CreateAccumulatedPacketsGraph(webrtc::kOutgoingPacket,
-                                           collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAccumulatedPacketsGraph(webrtc::kOutgoingPacket, plot);
+    });
   }
   if (FLAG_plot_audio_playout) {
-    analyzer.CreatePlayoutGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreatePlayoutGraph(plot);
+    });
   }
   if (FLAG_plot_audio_level) {
-    analyzer.CreateAudioLevelGraph(webrtc::kIncomingPacket,
-                                   collection->AppendNewPlot());
-    analyzer.CreateAudioLevelGraph(webrtc::kOutgoingPacket,
-                                   collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioLevelGraph(webrtc::kIncomingPacket, plot);
+    });
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioLevelGraph(webrtc::kOutgoingPacket, plot);
+    });
   }
   if (FLAG_plot_incoming_sequence_number_delta) {
-    analyzer.CreateSequenceNumberGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateSequenceNumberGraph(plot);
+    });
   }
   if (FLAG_plot_incoming_delay_delta) {
-    analyzer.CreateIncomingDelayDeltaGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateIncomingDelayDeltaGraph(plot);
+    });
   }
   if (FLAG_plot_incoming_delay) {
-    analyzer.CreateIncomingDelayGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateIncomingDelayGraph(plot);
+    });
   }
   if (FLAG_plot_incoming_loss_rate) {
-    analyzer.CreateIncomingPacketLossGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateIncomingPacketLossGraph(plot);
+    });
   }
   if (FLAG_plot_incoming_bitrate) {
-    analyzer.CreateTotalIncomingBitrateGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateTotalIncomingBitrateGraph(plot);
+    });
   }
   if (FLAG_plot_outgoing_bitrate) {
-    analyzer.CreateTotalOutgoingBitrateGraph(collection->AppendNewPlot(),
-                                             FLAG_show_detector_state,
-                                             FLAG_show_alr_state);
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateTotalOutgoingBitrateGraph(plot, FLAG_show_detector_state,
+                                               FLAG_show_alr_state);
+    });
   }
   if (FLAG_plot_incoming_stream_bitrate) {
-    analyzer.CreateStreamBitrateGraph(webrtc::kIncomingPacket,
-                                      collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateStreamBitrateGraph(webrtc::kIncomingPacket, plot);
+    });
   }
   if (FLAG_plot_outgoing_stream_bitrate) {
-    analyzer.CreateStreamBitrateGraph(webrtc::kOutgoingPacket,
-                                      collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateStreamBitrateGraph(webrtc::kOutgoingPacket, plot);
+    });
   }
   if (FLAG_plot_simulated_receiveside_bwe) {
-    analyzer.CreateReceiveSideBweSimulationGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateReceiveSideBweSimulationGraph(plot);
+    });
   }
   if (FLAG_plot_simulated_sendside_bwe) {
-    analyzer.CreateSendSideBweSimulationGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateSendSideBweSimulationGraph(plot);
+    });
   }
   if (FLAG_plot_network_delay_feedback) {
-    analyzer.CreateNetworkDelayFeedbackGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateNetworkDelayFeedbackGraph(plot);
+    });
   }
   if (FLAG_plot_fraction_loss_feedback) {
-    analyzer.CreateFractionLossGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateFractionLossGraph(plot);
+    });
   }
   if (FLAG_plot_timestamps) {
-    analyzer.CreateTimestampGraph(webrtc::kIncomingPacket,
-                                  collection->AppendNewPlot());
-    analyzer.CreateTimestampGraph(webrtc::kOutgoingPacket,
-                                  collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateTimestampGraph(webrtc::kIncomingPacket, plot);
+    });
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateTimestampGraph(webrtc::kOutgoingPacket, plot);
+    });
   }
   if (FLAG_plot_pacer_delay) {
-    analyzer.CreatePacerDelayGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreatePacerDelayGraph(plot);
+    });
   }
   if (FLAG_plot_audio_encoder_bitrate_bps) {
-    analyzer.CreateAudioEncoderTargetBitrateGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioEncoderTargetBitrateGraph(plot);
+    });
   }
   if (FLAG_plot_audio_encoder_frame_length_ms) {
-    analyzer.CreateAudioEncoderFrameLengthGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioEncoderFrameLengthGraph(plot);
+    });
   }
   if (FLAG_plot_audio_encoder_packet_loss) {
-    analyzer.CreateAudioEncoderPacketLossGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioEncoderPacketLossGraph(plot);
+    });
   }
   if (FLAG_plot_audio_encoder_fec) {
-    analyzer.CreateAudioEncoderEnableFecGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioEncoderEnableFecGraph(plot);
+    });
   }
   if (FLAG_plot_audio_encoder_dtx) {
-    analyzer.CreateAudioEncoderEnableDtxGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioEncoderEnableDtxGraph(plot);
+    });
   }
   if (FLAG_plot_audio_encoder_num_channels) {
-    analyzer.CreateAudioEncoderNumChannelsGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateAudioEncoderNumChannelsGraph(plot);
+    });
   }
   if (FLAG_plot_neteq_stats) {
     std::string wav_path;
@@ -331,48 +400,151 @@ int main(int argc, char* argv[]) {
       wav_path = webrtc::test::ResourcePath(
           "audio_processing/conversational_speech/EN_script2_F_sp2_B1", "wav");
     }
-    auto neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
-    analyzer.CreateAudioJitterBufferGraph(neteq_stats,
-                                          collection->AppendNewPlot());
-    analyzer.CreateNetEqStatsGraph(
-        neteq_stats,
-        [](const webrtc::NetEqNetworkStatistics& stats) {
-          return stats.expand_rate / 16384.f;
-        },
-        "Expand rate", collection->AppendNewPlot());
-    analyzer.CreateNetEqStatsGraph(
-        neteq_stats,
-        [](const webrtc::NetEqNetworkStatistics& stats) {
-          return stats.speech_expand_rate / 16384.f;
-        },
-        "Speech expand rate", collection->AppendNewPlot());
-    analyzer.CreateNetEqStatsGraph(
-        neteq_stats,
-        [](const webrtc::NetEqNetworkStatistics& stats) {
-          return stats.accelerate_rate / 16384.f;
-        },
-        "Accelerate rate", collection->AppendNewPlot());
-    analyzer.CreateNetEqStatsGraph(
-        neteq_stats,
-        [](const webrtc::NetEqNetworkStatistics& stats) {
-          return stats.packet_loss_rate / 16384.f;
-        },
-        "Packet loss rate", collection->AppendNewPlot());
+    // All the NetEq plots come from the same simulation, which is run once.
+    webrtc::Plot* jitter_buffer_plot = collection->AppendNewPlot();
+    webrtc::Plot* expand_rate_plot = collection->AppendNewPlot();
+    webrtc::Plot* speech_expand_rate_plot = collection->AppendNewPlot();
+    webrtc::Plot* accelerate_rate_plot = collection->AppendNewPlot();
+    webrtc::Plot* packet_loss_rate_plot = collection->AppendNewPlot();
+    tasks.push_back([&analyzer, wav_path, jitter_buffer_plot, expand_rate_plot,
+                     speech_expand_rate_plot, accelerate_rate_plot,
+                     packet_loss_rate_plot] {
+      auto neteq_stats = analyzer.SimulateNetEq(wav_path, 48000);
+      analyzer.CreateAudioJitterBufferGraph(neteq_stats, jitter_buffer_plot);
+      analyzer.CreateNetEqStatsGraph(
+          neteq_stats,
+          [](const webrtc::NetEqNetworkStatistics& stats) {
+            return stats.expand_rate / 16384.f;
+          },
+          "Expand rate", expand_rate_plot);
+      analyzer.CreateNetEqStatsGraph(
+          neteq_stats,
+          [](const webrtc::NetEqNetworkStatistics& stats) {
+            return stats.speech_expand_rate / 16384.f;
+          },
+          "Speech expand rate", speech_expand_rate_plot);
+      analyzer.CreateNetEqStatsGraph(
+          neteq_stats,
+          [](const webrtc::NetEqNetworkStatistics& stats) {
+            return stats.accelerate_rate / 16384.f;
+          },
+          "Accelerate rate", accelerate_rate_plot);
+      analyzer.CreateNetEqStatsGraph(
+          neteq_stats,
+          [](const webrtc::NetEqNetworkStatistics& stats) {
+            return stats.packet_loss_rate / 16384.f;
+          },
+          "Packet loss rate", packet_loss_rate_plot);
+    });
   }
 
   if (FLAG_plot_ice_candidate_pair_config) {
-    analyzer.CreateIceCandidatePairConfigGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateIceCandidatePairConfigGraph(plot);
+    });
   }
   if (FLAG_plot_ice_connectivity_check) {
-    analyzer.CreateIceConnectivityCheckGraph(collection->AppendNewPlot());
+    add_plot([&analyzer](webrtc::Plot* plot) {
+      analyzer.CreateIceConnectivityCheckGraph(plot);
+    });
   }
 
+  RunTasks(tasks, num_threads);
   collection->Draw();
 
   if (FLAG_print_triage_alerts) {
     analyzer.CreateTriageNotifications();
     analyzer.PrintNotifications(stderr);
   }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string program_name = argv[0];
+  std::string usage =
+      "A tool for visualizing WebRTC event logs.\n"
+      "Example usage:\n" +
+      program_name + " <logfile> | python\n" + program_name +
+      " --output_dir=<dir> <logfile> [<logfile> ...]\n" + "Run " +
+      program_name + " --help for a list of command line options\n";
+
+  // Parse command line flags without removing them. We're only interested in
+  // the |plot_profile| flag.
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, false);
+  if (strcmp(FLAG_plot_profile, "all") == 0) {
+    SetAllPlotFlags(true);
+  } else if (strcmp(FLAG_plot_profile, "none") == 0) {
+    SetAllPlotFlags(false);
+  } else if (strcmp(FLAG_plot_profile, "sendside_bwe") == 0) {
+    SetAllPlotFlags(false);
+    FLAG_plot_outgoing_packet_sizes = true;
+    FLAG_plot_outgoing_bitrate = true;
+    FLAG_plot_outgoing_stream_bitrate = true;
+    FLAG_plot_simulated_sendside_bwe = true;
+    FLAG_plot_network_delay_feedback = true;
+    FLAG_plot_fraction_loss_feedback = true;
+  } else if (strcmp(FLAG_plot_profile, "receiveside_bwe") == 0) {
+    SetAllPlotFlags(false);
+    FLAG_plot_incoming_packet_sizes = true;
+    FLAG_plot_incoming_delay_delta = true;
+    FLAG_plot_incoming_delay = true;
+    FLAG_plot_incoming_loss_rate = true;
+    FLAG_plot_incoming_bitrate = true;
+    FLAG_plot_incoming_stream_bitrate = true;
+    FLAG_plot_simulated_receiveside_bwe = true;
+  } else if (strcmp(FLAG_plot_profile, "default") == 0) {
+    // Do nothing.
+  } else {
+    rtc::Flag* plot_profile_flag = rtc::FlagList::Lookup("plot_profile");
+    RTC_CHECK(plot_profile_flag);
+    plot_profile_flag->Print(false);
+  }
+  // Parse the remaining flags. They are applied relative to the chosen profile.
+  rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true);
+
+  if (argc < 2 || FLAG_help) {
+    // Print usage information.
+    std::cout << usage;
+    if (FLAG_help)
+      rtc::FlagList::Print(nullptr, false);
+    return 0;
+  }
+
+  webrtc::test::SetExecutablePath(argv[0]);
+  webrtc::test::ValidateFieldTrialsStringOrDie(FLAG_force_fieldtrials);
+  // InitFieldTrialsFromString stores the char*, so the char array must outlive
+  // the application.
+  webrtc::field_trial::InitFieldTrialsFromString(FLAG_force_fieldtrials);
+
+  size_t num_threads = FLAG_threads > 0
+                           ? static_cast<size_t>(FLAG_threads)
+                           : webrtc::CpuInfo::DetectNumberOfCores();
+  if (argc == 2 && FLAG_output_dir[0] == '\0') {
+    AnalyzeLog(argv[1], stdout, num_threads);
+    return 0;
+  }
+
+  // Batch mode: the script of each log goes to its own file.
+  if (FLAG_output_dir[0] == '\0') {
+    std::cerr << "--output_dir is needed when more than one log is given."
+              << std::endl;
+    return 1;
+  }
+  for (int i = 1; i < argc; ++i) {
+    const std::string output_file_name =
+        OutputFileName(FLAG_output_dir, argv[i]);
+    FILE* output = fopen(output_file_name.c_str(), "w");
+    if (!output) {
+      std::cerr << "Could not open " << output_file_name << " for writing."
+                << std::endl;
+      return 1;
+    }
+    if (FLAG_print_triage_alerts)
+      fprintf(stderr, "=== %s ===\n", argv[i]);
+    AnalyzeLog(argv[i], output, num_threads);
+    fclose(output);
+  }
 
   return 0;
 }
@@ -10,23 +10,33 @@
 #ifndef RTC_TOOLS_EVENT_LOG_VISUALIZER_PLOT_PYTHON_H_
 #define RTC_TOOLS_EVENT_LOG_VISUALIZER_PLOT_PYTHON_H_
 
+#include <stdio.h>
+
 #include "rtc_tools/event_log_visualizer/plot_base.h"
 
 namespace webrtc {
 
 class PythonPlot final : public Plot {
  public:
-  PythonPlot();
+  explicit PythonPlot(FILE* output);
   ~PythonPlot() override;
   void Draw() override;
+
+ private:
+  FILE* const output_;
 };
 
 class PythonPlotCollection final : public PlotCollection {
  public:
-  PythonPlotCollection();
+  // The python script is written to |output|, which must outlive the
+  // collection.
+  explicit PythonPlotCollection(FILE* output = stdout);
   ~PythonPlotCollection() override;
   void Draw() override;
   Plot* AppendNewPlot() override;
+
+ private:
+  FILE* const output_;
 };
 
 }  // namespace webrtc
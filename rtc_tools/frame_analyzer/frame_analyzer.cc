@@ -38,7 +38,8 @@
  * frame_analyzer --label=<test_label> --reference_file=<name_of_file>
  * --test_file_ref=<name_of_file> --stats_file_test=<name_of_file>
  * --stats_file=<name_of_file> --width=<frame_width>
- * --height=<frame_height>
+ * --height=<frame_height> [--frame_results_file=<name_of_file>]
+ * [--num_threads=<number_of_threads>]
  */
 int main(int argc, char* argv[]) {
   std::string program_name = argv[0];
@@ -66,7 +67,12 @@ int main(int argc, char* argv[]) {
       " Default: test_file.yuv\n"
       "  - chartjson_result_file: Where to store perf result in chartjson"
       " format. If not present, no perf result will be stored."
-      " Default: None\n";
+      " Default: None\n"
+      "  - frame_results_file: Where to store the PSNR and SSIM of every"
+      " frame as comma separated values. If not present, they are not stored."
+      " Default: None\n"
+      "  - num_threads(int): The number of threads comparing frames. 0 means"
+      " one per core. Default: 0\n";
 
   webrtc::test::CommandLineParser parser;
 
@@ -82,6 +88,8 @@ int main(int argc, char* argv[]) {
   parser.SetFlag("reference_file", "ref.yuv");
   parser.SetFlag("test_file", "test.yuv");
   parser.SetFlag("chartjson_result_file", "");
+  parser.SetFlag("frame_results_file", "");
+  parser.SetFlag("num_threads", "0");
   parser.SetFlag("help", "false");
 
   parser.ProcessFlags();
@@ -99,13 +107,23 @@ int main(int argc, char* argv[]) {
     return -1;
   }
 
+  int num_threads = strtol((parser.GetFlag("num_threads")).c_str(), NULL, 10);
+
   webrtc::test::ResultsContainer results;
 
-  webrtc::test::RunAnalysis(parser.GetFlag("reference_file").c_str(),
-                            parser.GetFlag("test_file").c_str(),
-                            parser.GetFlag("stats_file_ref").c_str(),
-                            parser.GetFlag("stats_file_test").c_str(), width,
-                            height, &results);
+  if (num_threads > 0) {
+    webrtc::test::RunAnalysis(parser.GetFlag("reference_file").c_str(),
+                              parser.GetFlag("test_file").c_str(),
+                              parser.GetFlag("stats_file_ref").c_str(),
+                              parser.GetFlag("stats_file_test").c_str(), width,
+                              height, num_threads, &results);
+  } else {
+    webrtc::test::RunAnalysis(parser.GetFlag("reference_file").c_str(),
+                              parser.GetFlag("test_file").c_str(),
+                              parser.GetFlag("stats_file_ref").c_str(),
+                              parser.GetFlag("stats_file_test").c_str(), width,
+                              height, &results);
+  }
   webrtc::test::GetMaxRepeatedAndSkippedFrames(
       parser.GetFlag("stats_file_ref"), parser.GetFlag("stats_file_test"),
       &results);
@@ -117,5 +135,17 @@ int main(int argc, char* argv[]) {
     webrtc::test::WritePerfResults(chartjson_result_file);
   }
 
+  std::string frame_results_file = parser.GetFlag("frame_results_file");
+  if (!frame_results_file.empty()) {
+    FILE* output = fopen(frame_results_file.c_str(), "w");
+    if (output == NULL) {
+      fprintf(stderr, "Couldn't open frame results file for writing: %s\n",
+              frame_results_file.c_str());
+      return -1;
+    }
+    webrtc::test::PrintFrameResultsCsv(output, results);
+    fclose(output);
+  }
+
   return 0;
 }
@@ -14,10 +14,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <algorithm>
-#include <string>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <string>
 #include <utility>
 
+#include "rtc_base/checks.h"
+#include "rtc_base/platform_thread.h"
+#include "system_wrappers/include/cpu_info.h"
 #include "test/testsupport/perf_test.h"
 
 #define STATS_LINE_LENGTH 32
@@ -28,6 +33,114 @@
 namespace webrtc {
 namespace test {
 
+namespace {
+
+// A test frame and the reference frame it is compared with.
+struct FramePair {
+  int test_frame;
+  int reference_frame;
+  int barcode;
+};
+
+// Frame pairs shared by the analysis threads. Each thread claims the next
+// pair to compare until all are done, so the results keep the order of the
+// test stats file.
+struct AnalysisJob {
+  const char* reference_file_name;
+  const char* test_file_name;
+  // Position of the first reference frame and distance between frames, which
+  // differ from the test file for Y4M files.
+  long reference_first_frame_offset;
+  long reference_frame_interval;
+  int width;
+  int height;
+  const std::vector<FramePair>* frame_pairs;
+  std::vector<AnalysisResult>* results;
+  std::atomic<size_t> next_pair;
+};
+
+// Returns the offset of the first frame header in a Y4M file, or -1.
+long FindFirstY4mFrame(FILE* input_file, const char* y4m_file_name) {
+  // YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header. The
+  // file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
+  char frame_header[Y4M_FILE_HEADER_MAX_SIZE];
+  fseek(input_file, 0, SEEK_SET);
+  size_t bytes_read =
+      fread(frame_header, 1, Y4M_FILE_HEADER_MAX_SIZE - 1, input_file);
+  if (ferror(input_file)) {
+    fprintf(stdout, "Error while reading frame from file %s\n",
+        y4m_file_name);
+    return -1;
+  }
+  frame_header[bytes_read] = '\0';
+  std::string header_contents(frame_header);
+  std::size_t found = header_contents.find(Y4M_FRAME_DELIMITER);
+  if (found == std::string::npos) {
+    fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
+        header_contents.c_str());
+    return -1;
+  }
+  return static_cast<long>(found);
+}
+
+// Reads the I420 frame at |offset|. Returns false if the file ends before.
+bool ReadFrame(FILE* input_file,
+               const char* file_name,
+               long offset,
+               int frame_number,
+               int frame_size,
+               uint8_t* result_frame) {
+  fseek(input_file, offset, SEEK_SET);
+  size_t bytes_read = fread(result_frame, 1, frame_size, input_file);
+  if (bytes_read != static_cast<size_t>(frame_size) && ferror(input_file)) {
+    fprintf(stdout, "Error while reading frame no %d from file %s\n",
+            frame_number, file_name);
+    return false;
+  }
+  return !feof(input_file);
+}
+
+void AnalysisThread(void* obj) {
+  AnalysisJob* job = static_cast<AnalysisJob*>(obj);
+  // Every thread has its own file handles and frame buffers, the files stay
+  // open for the whole analysis.
+  FILE* test_file = fopen(job->test_file_name, "rb");
+  FILE* reference_file = fopen(job->reference_file_name, "rb");
+  // RunAnalysis has checked that both files can be read.
+  RTC_CHECK(test_file);
+  RTC_CHECK(reference_file);
+
+  const int frame_size = GetI420FrameSize(job->width, job->height);
+  std::unique_ptr<uint8_t[]> test_frame(new uint8_t[frame_size]());
+  std::unique_ptr<uint8_t[]> reference_frame(new uint8_t[frame_size]());
+
+  for (size_t i = job->next_pair++; i < job->frame_pairs->size();
+       i = job->next_pair++) {
+    const FramePair& pair = (*job->frame_pairs)[i];
+    ReadFrame(test_file, job->test_file_name,
+              static_cast<long>(pair.test_frame) * frame_size, pair.test_frame,
+              frame_size, test_frame.get());
+    ReadFrame(reference_file, job->reference_file_name,
+              job->reference_first_frame_offset +
+                  pair.reference_frame * job->reference_frame_interval,
+              pair.reference_frame, frame_size, reference_frame.get());
+
+    AnalysisResult& result = (*job->results)[i];
+    result.frame_number = pair.barcode;
+    result.psnr_value =
+        CalculateMetrics(kPSNR, reference_frame.get(), test_frame.get(),
+                         job->width, job->height);
+    result.ssim_value =
+        CalculateMetrics(kSSIM, reference_frame.get(), test_frame.get(),
+                         job->width, job->height);
+  }
+
+  fclose(test_file);
+  fclose(reference_file);
+}
+
+}  // namespace
+
 ResultsContainer::ResultsContainer() {}
 ResultsContainer::~ResultsContainer() {}
 
@@ -98,8 +211,7 @@ bool ExtractFrameFromYuvFile(const char* i420_file_name,
                              int frame_number,
                              uint8_t* result_frame) {
   int frame_size = GetI420FrameSize(width, height);
-  int offset = frame_number * frame_size;  // Calculate offset for the frame.
-  bool errors = false;
+  long offset = static_cast<long>(frame_number) * frame_size;
 
   FILE* input_file = fopen(i420_file_name, "rb");
   if (input_file == NULL) {
@@ -108,16 +220,9 @@ bool ExtractFrameFromYuvFile(const char* i420_file_name,
     return false;
   }
 
-  // Change stream pointer to new offset.
-  fseek(input_file, offset, SEEK_SET);
-
-  size_t bytes_read = fread(result_frame, 1, frame_size, input_file);
-  if (bytes_read != static_cast<size_t>(frame_size) &&
-      ferror(input_file)) {
-    fprintf(stdout, "Error while reading frame no %d from file %s\n",
-            frame_number, i420_file_name);
-    errors = true;
-  }
+  ReadFrame(input_file, i420_file_name, offset, frame_number, frame_size,
+            result_frame);
+  bool errors = ferror(input_file) != 0;
   fclose(input_file);
   return !errors;
 }
@@ -128,8 +233,8 @@ bool ExtractFrameFromY4mFile(const char* y4m_file_name,
                              int frame_number,
                              uint8_t* result_frame) {
   int frame_size = GetI420FrameSize(width, height);
-  int inital_offset = frame_number * (frame_size + Y4M_FRAME_HEADER_SIZE);
-  int frame_offset = 0;
+  long inital_offset =
+      static_cast<long>(frame_number) * (frame_size + Y4M_FRAME_HEADER_SIZE);
 
   FILE* input_file = fopen(y4m_file_name, "rb");
   if (input_file == NULL) {
@@ -138,46 +243,18 @@ bool ExtractFrameFromY4mFile(const char* y4m_file_name,
     return false;
   }
 
-  // YUV4MPEG2, a.k.a. Y4M File format has a file header and a frame header. The
-  // file header has the aspect: "YUV4MPEG2 C420 W640 H360 Ip F30:1 A1:1".
-  char frame_header[Y4M_FILE_HEADER_MAX_SIZE];
-  size_t bytes_read =
-      fread(frame_header, 1, Y4M_FILE_HEADER_MAX_SIZE - 1, input_file);
-  if (bytes_read != static_cast<size_t>(frame_size) && ferror(input_file)) {
-    fprintf(stdout, "Error while reading frame from file %s\n",
-        y4m_file_name);
-    fclose(input_file);
-    return false;
-  }
-  frame_header[bytes_read] = '\0';
-  std::string header_contents(frame_header);
-  std::size_t found = header_contents.find(Y4M_FRAME_DELIMITER);
-  if (found == std::string::npos) {
-    fprintf(stdout, "Corrupted Y4M header, could not find \"FRAME\" in %s\n",
-        header_contents.c_str());
-    fclose(input_file);
-    return false;
-  }
-  frame_offset = static_cast<int>(found);
-
-  // Change stream pointer to new offset, skipping the frame header as well.
-  fseek(input_file, inital_offset + frame_offset + Y4M_FRAME_HEADER_SIZE,
-        SEEK_SET);
-
-  bytes_read = fread(result_frame, 1, frame_size, input_file);
-  if (feof(input_file)) {
-    fclose(input_file);
-    return false;
-  }
-  if (bytes_read != static_cast<size_t>(frame_size) && ferror(input_file)) {
-    fprintf(stdout, "Error while reading frame no %d from file %s\n",
-            frame_number, y4m_file_name);
+  long frame_offset = FindFirstY4mFrame(input_file, y4m_file_name);
+  if (frame_offset < 0) {
     fclose(input_file);
     return false;
   }
 
+  // Skip the frame header as well.
+  bool success = ReadFrame(input_file, y4m_file_name,
+                           inital_offset + frame_offset + Y4M_FRAME_HEADER_SIZE,
+                           frame_number, frame_size, result_frame);
   fclose(input_file);
-  return true;
+  return success;
 }
 
 double CalculateMetrics(VideoAnalysisMetricsType video_metrics_type,
@@ -234,22 +311,31 @@ void RunAnalysis(const char* reference_file_name,
                  int width,
                  int height,
                  ResultsContainer* results) {
+  RunAnalysis(reference_file_name, test_file_name, stats_file_reference_name,
+              stats_file_test_name, width, height,
+              CpuInfo::DetectNumberOfCores(), results);
+}
+
+void RunAnalysis(const char* reference_file_name,
+                 const char* test_file_name,
+                 const char* stats_file_reference_name,
+                 const char* stats_file_test_name,
+                 int width,
+                 int height,
+                 int num_threads,
+                 ResultsContainer* results) {
   // Check if the reference_file_name ends with "y4m".
   bool y4m_mode = false;
   if (std::string(reference_file_name).find("y4m") != std::string::npos) {
     y4m_mode = true;
   }
 
-  int size = GetI420FrameSize(width, height);
   FILE* stats_file_ref = fopen(stats_file_reference_name, "r");
   FILE* stats_file_test = fopen(stats_file_test_name, "r");
 
   // String buffer for the lines in the stats file.
   char line[STATS_LINE_LENGTH];
 
-  // Allocate buffers for test and reference frames.
-  uint8_t* test_frame = new uint8_t[size];
-  uint8_t* reference_frame = new uint8_t[size];
   int previous_frame_number = -1;
 
   // Maps barcode id to the frame id for the reference video.
@@ -265,6 +351,7 @@ void RunAnalysis(const char* reference_file_name,
         std::make_pair(decoded_frame_number, extracted_ref_frame));
   }
 
+  std::vector<FramePair> frame_pairs;
   while (GetNextStatsLine(stats_file_test, line)) {
     int extracted_test_frame = ExtractFrameSequenceNumber(line);
     int decoded_frame_number = ExtractDecodedFrameNumber(line);
@@ -286,38 +373,65 @@ void RunAnalysis(const char* reference_file_name,
     assert(extracted_test_frame != -1);
     assert(decoded_frame_number != -1);
 
-    ExtractFrameFromYuvFile(test_file_name, width, height, extracted_test_frame,
-                            test_frame);
-    if (y4m_mode) {
-      ExtractFrameFromY4mFile(reference_file_name, width, height,
-                              extracted_ref_frame, reference_frame);
-    } else {
-      ExtractFrameFromYuvFile(reference_file_name, width, height,
-                              extracted_ref_frame, reference_frame);
-    }
-
-    // Calculate the PSNR and SSIM.
-    double result_psnr =
-        CalculateMetrics(kPSNR, reference_frame, test_frame, width, height);
-    double result_ssim =
-        CalculateMetrics(kSSIM, reference_frame, test_frame, width, height);
-
     previous_frame_number = decoded_frame_number;
-
-    // Fill in the result struct.
-    AnalysisResult result;
-    result.frame_number = decoded_frame_number;
-    result.psnr_value = result_psnr;
-    result.ssim_value = result_ssim;
-
-    results->frames.push_back(result);
+    frame_pairs.push_back(
+        {extracted_test_frame, extracted_ref_frame, decoded_frame_number});
   }
 
   // Cleanup.
   fclose(stats_file_ref);
   fclose(stats_file_test);
-  delete[] test_frame;
-  delete[] reference_frame;
+
+  AnalysisJob job;
+  job.reference_first_frame_offset = 0;
+  job.reference_frame_interval = GetI420FrameSize(width, height);
+  FILE* test_file = fopen(test_file_name, "rb");
+  FILE* reference_file = fopen(reference_file_name, "rb");
+  if (test_file == NULL || reference_file == NULL) {
+    fprintf(stderr, "Couldn't open input files for reading: %s, %s\n",
+            test_file_name, reference_file_name);
+    frame_pairs.clear();
+  } else if (y4m_mode) {
+    long first_frame = FindFirstY4mFrame(reference_file, reference_file_name);
+    if (first_frame < 0)
+      frame_pairs.clear();
+    // Skip the frame headers as well.
+    job.reference_first_frame_offset = first_frame + Y4M_FRAME_HEADER_SIZE;
+    job.reference_frame_interval += Y4M_FRAME_HEADER_SIZE;
+  }
+  if (test_file)
+    fclose(test_file);
+  if (reference_file)
+    fclose(reference_file);
+
+  // Calculate the PSNR and SSIM of the frame pairs in parallel.
+  std::vector<AnalysisResult> frame_results(frame_pairs.size());
+  job.reference_file_name = reference_file_name;
+  job.test_file_name = test_file_name;
+  job.width = width;
+  job.height = height;
+  job.frame_pairs = &frame_pairs;
+  job.results = &frame_results;
+  job.next_pair = 0;
+
+  num_threads = std::min(num_threads, static_cast<int>(frame_pairs.size()));
+  if (frame_pairs.empty()) {
+    return;
+  } else if (num_threads <= 1) {
+    AnalysisThread(&job);
+  } else {
+    std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+    for (int i = 0; i < num_threads; ++i) {
+      threads.emplace_back(
+          new rtc::PlatformThread(&AnalysisThread, &job, "FrameAnalyzer"));
+      threads.back()->Start();
+    }
+    for (auto& thread : threads)
+      thread->Stop();
+  }
+
+  results->frames.insert(results->frames.end(), frame_results.begin(),
+                         frame_results.end());
 }
 
 std::vector<std::pair<int, int> > CalculateFrameClusters(
@@ -501,5 +615,13 @@ void PrintAnalysisResults(FILE* output, const std::string& label,
               false);
 }
 
+void PrintFrameResultsCsv(FILE* output, const ResultsContainer& results) {
+  fprintf(output, "frame_number,psnr,ssim\n");
+  for (const auto& frame : results.frames) {
+    fprintf(output, "%d,%f,%f\n", frame.frame_number, frame.psnr_value,
+            frame.ssim_value);
+  }
+}
+
 }  // namespace test
 }  // namespace webrtc
@@ -69,6 +69,17 @@ void RunAnalysis(const char* reference_file_name,
                  int height,
                  ResultsContainer* results);
 
+// Same as above, but compares the frames on |num_threads| threads instead of
+// one per core. The results are in the same order for any number of threads.
+void RunAnalysis(const char* reference_file_name,
+                 const char* test_file_name,
+                 const char* stats_file_reference_name,
+                 const char* stats_file_test_name,
+                 int width,
+                 int height,
+                 int num_threads,
+                 ResultsContainer* results);
+
 // Compute PSNR or SSIM for an I420 frame (all planes). When we are calculating
 // PSNR values, the max return value (in the case where the test and reference
 // frames are exactly the same) will be 48. In the case of SSIM the max return
@@ -88,6 +99,10 @@ void PrintAnalysisResults(const std::string& label, ResultsContainer* results);
 void PrintAnalysisResults(FILE* output, const std::string& label,
                           ResultsContainer* results);
 
+// Writes the frame number, PSNR and SSIM of every analyzed frame as comma
+// separated values to the file handle, one frame per line after a header line.
+void PrintFrameResultsCsv(FILE* output, const ResultsContainer& results);
+
 // The barcode number that means that the barcode could not be decoded.
 const int DECODE_ERROR = -1;
 
@@ -338,5 +338,84 @@ TEST_F(VideoQualityAnalysisTest, CalculateFrameClustersEmpty) {
   decltype(clusters) expected;
   ASSERT_EQ(expected, clusters);
 }
+
+TEST_F(VideoQualityAnalysisTest, RunAnalysisGivesSameResultsOnAnyThreadCount) {
+  const int kWidth = 64;
+  const int kHeight = 48;
+  const int kNumFrames = 20;
+  const int frame_size = GetI420FrameSize(kWidth, kHeight);
+  std::string reference_filename = TempFilename(OutputPath(), "ref.yuv");
+  std::string test_filename = TempFilename(OutputPath(), "test.yuv");
+
+  // The test video is the reference video starting at its second frame, with
+  // more distortion for every frame.
+  std::ofstream reference_file(reference_filename, std::ios::binary);
+  std::ofstream test_file(test_filename, std::ios::binary);
+  std::ofstream stats_file_ref(stats_filename_ref_);
+  std::ofstream stats_file_test(stats_filename_);
+  std::vector<char> frame(frame_size);
+  for (int i = 0; i < kNumFrames; ++i) {
+    for (int j = 0; j < frame_size; ++j)
+      frame[j] = static_cast<char>((i * 7 + j * 13) & 0xff);
+    reference_file.write(frame.data(), frame_size);
+    stats_file_ref << "frame_" << i << " " << 100 + i << "\n";
+    if (i == 0)
+      continue;
+    for (int j = 0; j < 16 * i; ++j)
+      frame[j * 17 % frame_size] ^= 0x40;
+    test_file.write(frame.data(), frame_size);
+    stats_file_test << "frame_" << i - 1 << " " << 100 + i << "\n";
+  }
+  reference_file.close();
+  test_file.close();
+  stats_file_ref.close();
+  stats_file_test.close();
+
+  ResultsContainer single_thread_results;
+  RunAnalysis(reference_filename.c_str(), test_filename.c_str(),
+              stats_filename_ref_.c_str(), stats_filename_.c_str(), kWidth,
+              kHeight, 1, &single_thread_results);
+  ResultsContainer multi_thread_results;
+  RunAnalysis(reference_filename.c_str(), test_filename.c_str(),
+              stats_filename_ref_.c_str(), stats_filename_.c_str(), kWidth,
+              kHeight, 4, &multi_thread_results);
+  remove(reference_filename.c_str());
+  remove(test_filename.c_str());
+
+  ASSERT_EQ(static_cast<size_t>(kNumFrames - 1),
+            single_thread_results.frames.size());
+  ASSERT_EQ(single_thread_results.frames.size(),
+            multi_thread_results.frames.size());
+  for (size_t i = 0; i < single_thread_results.frames.size(); ++i) {
+    const AnalysisResult& expected = single_thread_results.frames[i];
+    const AnalysisResult& actual = multi_thread_results.frames[i];
+    EXPECT_EQ(static_cast<int>(101 + i), expected.frame_number);
+    EXPECT_EQ(expected.frame_number, actual.frame_number);
+    EXPECT_EQ(expected.psnr_value, actual.psnr_value);
+    EXPECT_EQ(expected.ssim_value, actual.ssim_value);
+    EXPECT_LT(expected.psnr_value, 48.0);
+    if (i > 0)
+      EXPECT_LT(expected.psnr_value,
+                single_thread_results.frames[i - 1].psnr_value);
+  }
+}
+
+TEST_F(VideoQualityAnalysisTest, PrintFrameResultsCsv) {
+  ResultsContainer result;
+  result.frames.push_back(AnalysisResult(100, 35.0, 0.9));
+  result.frames.push_back(AnalysisResult(101, 34.5, 0.8));
+
+  std::string log_filename =
+      TempFilename(webrtc::test::OutputPath(), "log.csv");
+  FILE* logfile = fopen(log_filename.c_str(), "w");
+  ASSERT_TRUE(logfile != NULL);
+  PrintFrameResultsCsv(logfile, result);
+  ASSERT_EQ(0, fclose(logfile));
+
+  std::vector<std::string> expected_out = {"frame_number,psnr,ssim",
+                                           "100,35.000000,0.900000",
+                                           "101,34.500000,0.800000"};
+  VerifyLogOutput(log_filename, expected_out);
+}
 }  // namespace test
 }  // namespace webrtc
@@ -0,0 +1,520 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/peerconnection_loadtest/loadtest.h"
+
+#include <algorithm>
+#include <map>
+#include <utility>
+
+#include "api/audio_codecs/builtin_audio_decoder_factory.h"
+#include "api/audio_codecs/builtin_audio_encoder_factory.h"
+#include "api/stats/rtcstats_objects.h"
+#include "api/stats/rtcstatscollectorcallback.h"
+#include "api/video_codecs/sdp_video_format.h"
+#include "api/video_codecs/video_decoder_factory.h"
+#include "api/video_codecs/video_encoder_factory.h"
+#include "media/base/mediaconstants.h"
+#include "modules/audio_processing/include/audio_processing.h"
+#include "p2p/base/basicpacketsocketfactory.h"
+#include "p2p/base/sharedudpsocketfactory.h"
+#include "p2p/client/basicportallocator.h"
+#include "pc/test/fakeaudiocapturemodule.h"
+#include "pc/test/fakeperiodicvideotracksource.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/cpu_time.h"
+#include "rtc_base/logging.h"
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/timeutils.h"
+#include "system_wrappers/include/clock.h"
+#include "test/fake_decoder.h"
+#include "test/fake_encoder.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr int64_t kNanosPerMillisecond = 1000000;
+// How long to wait for the stats of all the connections at the end.
+constexpr int kStatsTimeoutMs = 5000;
+constexpr int kPollIntervalMs = 10;
+
+// Constrained baseline, level 3.1, which is what media servers support the
+// most widely.
+SdpVideoFormat H264Format() {
+  return SdpVideoFormat(cricket::kH264CodecName,
+                        {{cricket::kH264FmtpProfileLevelId, "42e01f"},
+                         {cricket::kH264FmtpLevelAsymmetryAllowed, "1"},
+                         {cricket::kH264FmtpPacketizationMode, "1"}});
+}
+
+// Creates fake H.264 encoders, which produce frames of the target size with
+// valid NAL unit headers without encoding anything.
+class FakeH264EncoderFactory : public VideoEncoderFactory {
+ public:
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return {H264Format()};
+  }
+  CodecInfo QueryVideoEncoder(const SdpVideoFormat& format) const override {
+    CodecInfo info;
+    info.is_hardware_accelerated = false;
+    info.has_internal_source = false;
+    return info;
+  }
+  std::unique_ptr<VideoEncoder> CreateVideoEncoder(
+      const SdpVideoFormat& format) override {
+    return rtc::MakeUnique<test::FakeH264Encoder>(Clock::GetRealTimeClock());
+  }
+};
+
+class FakeH264DecoderFactory : public VideoDecoderFactory {
+ public:
+  std::vector<SdpVideoFormat> GetSupportedFormats() const override {
+    return {H264Format()};
+  }
+  std::unique_ptr<VideoDecoder> CreateVideoDecoder(
+      const SdpVideoFormat& format) override {
+    return rtc::MakeUnique<test::FakeH264Decoder>();
+  }
+};
+
+class CreateSdpObserver : public CreateSessionDescriptionObserver {
+ public:
+  using Callback = std::function<void(SessionDescriptionInterface* desc)>;
+
+  CreateSdpObserver(int id, Callback on_success)
+      : id_(id), on_success_(std::move(on_success)) {}
+
+  void OnSuccess(SessionDescriptionInterface* desc) override {
+    on_success_(desc);
+  }
+  void OnFailure(RTCError error) override {
+    RTC_LOG(LS_ERROR) << "Connection " << id_
+                      << ": Failed to create SDP: " << error.message();
+  }
+
+ private:
+  const int id_;
+  const Callback on_success_;
+};
+
+class SetSdpObserver : public SetSessionDescriptionObserver {
+ public:
+  explicit SetSdpObserver(int id) : id_(id) {}
+
+  void OnSuccess() override {}
+  void OnFailure(RTCError error) override {
+    RTC_LOG(LS_ERROR) << "Connection " << id_
+                      << ": Failed to set SDP: " << error.message();
+  }
+
+ private:
+  const int id_;
+};
+
+class StatsCallback : public RTCStatsCollectorCallback {
+ public:
+  using Callback =
+      std::function<void(const rtc::scoped_refptr<const RTCStatsReport>&)>;
+
+  explicit StatsCallback(Callback callback) : callback_(std::move(callback)) {}
+
+  void OnStatsDelivered(
+      const rtc::scoped_refptr<const RTCStatsReport>& report) override {
+    callback_(report);
+  }
+
+ private:
+  const Callback callback_;
+};
+
+}  // namespace
+
+// One PeerConnection, either the offering side that the load test measures
+// or, in the loopback mode, the answering side that stands in for the
+// endpoint under test. Lives on the signaling thread.
+class LoadTest::Endpoint : public PeerConnectionObserver {
+ public:
+  using SdpCallback = std::function<void(const std::string& sdp)>;
+
+  explicit Endpoint(int id) : id_(id) {}
+  ~Endpoint() override {
+    if (pc_)
+      pc_->Close();
+  }
+
+  bool Init(PeerConnectionFactoryInterface* factory,
+            std::unique_ptr<cricket::PortAllocator> allocator) {
+    PeerConnectionInterface::RTCConfiguration config;
+    // One transport per connection, so that a connection takes one port.
+    config.bundle_policy = PeerConnectionInterface::kBundlePolicyMaxBundle;
+    config.rtcp_mux_policy = PeerConnectionInterface::kRtcpMuxPolicyRequire;
+    config.tcp_candidate_policy =
+        PeerConnectionInterface::kTcpCandidatePolicyDisabled;
+    pc_ = factory->CreatePeerConnection(config, std::move(allocator), nullptr,
+                                        this);
+    return pc_ != nullptr;
+  }
+
+  void AddTrack(rtc::scoped_refptr<MediaStreamTrackInterface> track) {
+    if (pc_ && !pc_->AddTrack(track, {"loadtest"}).ok()) {
+      RTC_LOG(LS_ERROR) << "Connection " << id_ << ": Failed to add "
+                        << track->kind() << " track.";
+    }
+  }
+
+  // Calls |on_offer| with the complete offer.
+  void CreateOffer(SdpCallback on_offer) {
+    start_time_ms_ = rtc::TimeMillis();
+    if (!pc_)
+      return;
+    on_local_description_ = std::move(on_offer);
+    // Also offers to receive whatever the other endpoint forwards.
+    PeerConnectionInterface::RTCOfferAnswerOptions options;
+    options.offer_to_receive_audio = 1;
+    options.offer_to_receive_video = 1;
+    pc_->CreateOffer(new rtc::RefCountedObject<CreateSdpObserver>(
+                         id_,
+                         [this](SessionDescriptionInterface* desc) {
+                           SetLocalDescription(desc);
+                         }),
+                     options);
+  }
+
+  // Calls |on_answer| with the complete answer to |offer_sdp|.
+  void AnswerOffer(const std::string& offer_sdp, SdpCallback on_answer) {
+    start_time_ms_ = rtc::TimeMillis();
+    if (!pc_ || !SetRemoteDescription(SdpType::kOffer, offer_sdp))
+      return;
+    on_local_description_ = std::move(on_answer);
+    pc_->CreateAnswer(new rtc::RefCountedObject<CreateSdpObserver>(
+                          id_,
+                          [this](SessionDescriptionInterface* desc) {
+                            SetLocalDescription(desc);
+                          }),
+                      PeerConnectionInterface::RTCOfferAnswerOptions());
+  }
+
+  void SetAnswer(const std::string& answer_sdp) {
+    if (pc_)
+      SetRemoteDescription(SdpType::kAnswer, answer_sdp);
+  }
+
+  void RequestStats() {
+    if (!pc_) {
+      stats_delivered_ = true;
+      return;
+    }
+    pc_->GetStats(new rtc::RefCountedObject<StatsCallback>(
+        [this](const rtc::scoped_refptr<const RTCStatsReport>& report) {
+          for (const RTCTransportStats* stats :
+               report->GetStatsOfType<RTCTransportStats>()) {
+            if (stats->bytes_sent.is_defined())
+              bytes_sent_ += *stats->bytes_sent;
+            if (stats->bytes_received.is_defined())
+              bytes_received_ += *stats->bytes_received;
+          }
+          stats_delivered_ = true;
+        }));
+  }
+
+  // Only valid once the stats are delivered.
+  LoadTestConnectionResult GetResult(int64_t now_ms) const {
+    LoadTestConnectionResult result;
+    result.id = id_;
+    result.bytes_sent = bytes_sent_;
+    result.bytes_received = bytes_received_;
+    if (connected_time_ms_) {
+      result.join_time_ms = *connected_time_ms_ - start_time_ms_;
+      // Bits per millisecond are kilobits per second.
+      const int64_t elapsed_ms =
+          std::max<int64_t>(now_ms - *connected_time_ms_, 1);
+      result.send_kbps = static_cast<int>(bytes_sent_ * 8 / elapsed_ms);
+      result.receive_kbps = static_cast<int>(bytes_received_ * 8 / elapsed_ms);
+    }
+    return result;
+  }
+
+  bool connected() const { return static_cast<bool>(connected_time_ms_); }
+  bool stats_delivered() const { return stats_delivered_; }
+
+  // PeerConnectionObserver implementation.
+  void OnSignalingChange(
+      PeerConnectionInterface::SignalingState new_state) override {}
+  void OnDataChannel(
+      rtc::scoped_refptr<DataChannelInterface> data_channel) override {}
+  void OnRenegotiationNeeded() override {}
+  void OnIceConnectionChange(
+      PeerConnectionInterface::IceConnectionState new_state) override {
+    if (connected_time_ms_ ||
+        (new_state != PeerConnectionInterface::kIceConnectionConnected &&
+         new_state != PeerConnectionInterface::kIceConnectionCompleted)) {
+      return;
+    }
+    connected_time_ms_ = rtc::TimeMillis();
+  }
+  void OnIceGatheringChange(
+      PeerConnectionInterface::IceGatheringState new_state) override {
+    if (new_state == PeerConnectionInterface::kIceGatheringComplete) {
+      gathering_complete_ = true;
+      MaybeSendLocalDescription();
+    }
+  }
+  // The candidates are sent with the description, once they are all
+  // gathered.
+  void OnIceCandidate(const IceCandidateInterface* candidate) override {}
+
+ private:
+  void SetLocalDescription(SessionDescriptionInterface* desc) {
+    pc_->SetLocalDescription(new rtc::RefCountedObject<SetSdpObserver>(id_),
+                             desc);
+    local_description_set_ = true;
+    MaybeSendLocalDescription();
+  }
+
+  bool SetRemoteDescription(SdpType type, const std::string& sdp) {
+    SdpParseError error;
+    std::unique_ptr<SessionDescriptionInterface> desc =
+        CreateSessionDescription(type, sdp, &error);
+    if (!desc) {
+      RTC_LOG(LS_ERROR) << "Connection " << id_
+                        << ": Failed to parse SDP: " << error.description;
+      return false;
+    }
+    pc_->SetRemoteDescription(new rtc::RefCountedObject<SetSdpObserver>(id_),
+                              desc.release());
+    return true;
+  }
+
+  void MaybeSendLocalDescription() {
+    if (!on_local_description_ || !local_description_set_ ||
+        !gathering_complete_ || !pc_->local_description()) {
+      return;
+    }
+    std::string sdp;
+    pc_->local_description()->ToString(&sdp);
+    SdpCallback callback = std::move(on_local_description_);
+    on_local_description_ = nullptr;
+    callback(sdp);
+  }
+
+  const int id_;
+  rtc::scoped_refptr<PeerConnectionInterface> pc_;
+  SdpCallback on_local_description_;
+  bool local_description_set_ = false;
+  bool gathering_complete_ = false;
+  int64_t start_time_ms_ = 0;
+  rtc::Optional<int64_t> connected_time_ms_;
+  bool stats_delivered_ = false;
+  uint64_t bytes_sent_ = 0;
+  uint64_t bytes_received_ = 0;
+};
+
+// Answers the offers with receive-only PeerConnections in this process.
+class LoadTest::LoopbackSignaling : public LoadTestSignaling {
+ public:
+  explicit LoopbackSignaling(LoadTest* test) : test_(test) {}
+
+  void SendOffer(int id,
+                 const std::string& offer_sdp,
+                 AnswerCallback on_answer) override {
+    std::unique_ptr<Endpoint> answerer =
+        test_->CreateEndpoint(id, /*caller=*/false);
+    answerer->AnswerOffer(offer_sdp, std::move(on_answer));
+    answerers_[id] = std::move(answerer);
+  }
+  void Close(int id) override { answerers_.erase(id); }
+
+ private:
+  LoadTest* const test_;
+  std::map<int, std::unique_ptr<Endpoint>> answerers_;
+};
+
+LoadTestResult::LoadTestResult() = default;
+LoadTestResult::LoadTestResult(const LoadTestResult&) = default;
+LoadTestResult::~LoadTestResult() = default;
+
+LoadTest::LoadTest(const LoadTestConfig& config, LoadTestSignaling* signaling)
+    : config_(config), signaling_(signaling) {
+  RTC_DCHECK_GT(config_.joins_per_second, 0);
+  RTC_DCHECK_GT(config_.video_fps, 0);
+  if (!signaling_) {
+    loopback_signaling_ = rtc::MakeUnique<LoopbackSignaling>(this);
+    signaling_ = loopback_signaling_.get();
+  }
+}
+
+LoadTest::~LoadTest() {
+  DestroyEndpoints();
+  loopback_signaling_.reset();
+  audio_track_ = nullptr;
+  video_track_ = nullptr;
+  video_source_ = nullptr;
+  factory_ = nullptr;
+  // The sockets are used on the network thread only.
+  if (network_thread_) {
+    network_thread_->Invoke<void>(RTC_FROM_HERE, [this] {
+      socket_factory_.reset();
+      base_socket_factory_.reset();
+    });
+  }
+}
+
+LoadTestResult LoadTest::Run() {
+  RTC_DCHECK(!signaling_thread_) << "The test can only run once.";
+  signaling_thread_ = rtc::Thread::Current();
+  RTC_CHECK(signaling_thread_);
+  if (!CreateFactory()) {
+    RTC_LOG(LS_ERROR) << "Failed to create the PeerConnectionFactory.";
+    return LoadTestResult();
+  }
+
+  // The connections start on a fixed schedule.
+  const int64_t start_ms = rtc::TimeMillis();
+  for (int id = 0; id < config_.num_connections; ++id) {
+    const int64_t join_ms = start_ms + id * 1000 / config_.joins_per_second;
+    for (int64_t now_ms = rtc::TimeMillis(); now_ms < join_ms;
+         now_ms = rtc::TimeMillis()) {
+      signaling_thread_->ProcessMessages(static_cast<int>(join_ms - now_ms));
+    }
+    StartConnection(id);
+  }
+
+  const int64_t steady_start_ms = rtc::TimeMillis();
+  const int64_t steady_start_cpu_ns = rtc::GetProcessCpuTimeNanos();
+  const int64_t end_ms = steady_start_ms + config_.duration_ms;
+  for (int64_t now_ms = rtc::TimeMillis(); now_ms < end_ms;
+       now_ms = rtc::TimeMillis()) {
+    signaling_thread_->ProcessMessages(static_cast<int>(end_ms - now_ms));
+  }
+  const int64_t cpu_ns = rtc::GetProcessCpuTimeNanos() - steady_start_cpu_ns;
+  LoadTestResult result =
+      CollectResults(cpu_ns, rtc::TimeMillis() - steady_start_ms);
+  DestroyEndpoints();
+  return result;
+}
+
+bool LoadTest::CreateFactory() {
+  network_thread_ = rtc::Thread::CreateWithSocketServer();
+  network_thread_->SetName("loadtest_network", nullptr);
+  worker_thread_ = rtc::Thread::Create();
+  worker_thread_->SetName("loadtest_worker", nullptr);
+  if (!network_thread_->Start() || !worker_thread_->Start())
+    return false;
+
+  network_manager_ = rtc::MakeUnique<rtc::BasicNetworkManager>();
+  base_socket_factory_ =
+      rtc::MakeUnique<rtc::BasicPacketSocketFactory>(network_thread_.get());
+  if (config_.shared_udp_socket) {
+    socket_factory_ = rtc::MakeUnique<rtc::SharedUdpSocketFactory>(
+        base_socket_factory_.get());
+  }
+
+  rtc::scoped_refptr<FakeAudioCaptureModule> adm =
+      FakeAudioCaptureModule::Create();
+  if (!adm)
+    return false;
+  factory_ = CreatePeerConnectionFactory(
+      network_thread_.get(), worker_thread_.get(), signaling_thread_, adm,
+      CreateBuiltinAudioEncoderFactory(), CreateBuiltinAudioDecoderFactory(),
+      rtc::MakeUnique<FakeH264EncoderFactory>(),
+      rtc::MakeUnique<FakeH264DecoderFactory>(), nullptr /* audio_mixer */,
+      nullptr /* audio_processing */);
+  if (!factory_)
+    return false;
+
+  if (config_.audio) {
+    audio_track_ = factory_->CreateAudioTrack(
+        "audio", factory_->CreateAudioSource(cricket::AudioOptions()));
+  }
+  if (config_.video) {
+    FakePeriodicVideoSource::Config video_config;
+    video_config.width = config_.video_width;
+    video_config.height = config_.video_height;
+    video_config.frame_interval_ms = 1000 / config_.video_fps;
+    // All the connections send the frames of the same source, which
+    // generates them on a task queue of its own.
+    video_source_ = new rtc::RefCountedObject<FakePeriodicVideoTrackSource>(
+        video_config, /*remote=*/false);
+    video_track_ = factory_->CreateVideoTrack("video", video_source_);
+  }
+  return true;
+}
+
+std::unique_ptr<LoadTest::Endpoint> LoadTest::CreateEndpoint(int id,
+                                                             bool caller) {
+  // In the loopback mode, the answerers get sockets of their own: they share
+  // the addresses of the callers' shared sockets otherwise, which then can't
+  // tell the packets of the two sides apart.
+  rtc::PacketSocketFactory* socket_factory =
+      caller && socket_factory_ ? socket_factory_.get()
+                                : base_socket_factory_.get();
+  auto allocator = rtc::MakeUnique<cricket::BasicPortAllocator>(
+      network_manager_.get(), socket_factory);
+  allocator->set_flags(allocator->flags() | cricket::PORTALLOCATOR_DISABLE_TCP);
+  if (config_.min_port || config_.max_port)
+    allocator->SetPortRange(config_.min_port, config_.max_port);
+
+  auto endpoint = rtc::MakeUnique<Endpoint>(id);
+  if (!endpoint->Init(factory_, std::move(allocator)))
+    RTC_LOG(LS_ERROR) << "Connection " << id << ": Failed to create.";
+  return endpoint;
+}
+
+void LoadTest::StartConnection(int id) {
+  std::unique_ptr<Endpoint> endpoint = CreateEndpoint(id, /*caller=*/true);
+  if (audio_track_)
+    endpoint->AddTrack(audio_track_);
+  if (video_track_)
+    endpoint->AddTrack(video_track_);
+  Endpoint* caller = endpoint.get();
+  endpoints_.push_back(std::move(endpoint));
+  caller->CreateOffer([this, id, caller](const std::string& offer_sdp) {
+    signaling_->SendOffer(id, offer_sdp, [caller](const std::string& answer) {
+      caller->SetAnswer(answer);
+    });
+  });
+}
+
+LoadTestResult LoadTest::CollectResults(int64_t cpu_ns, int64_t wall_ms) {
+  for (const auto& endpoint : endpoints_)
+    endpoint->RequestStats();
+  const int64_t timeout_ms = rtc::TimeMillis() + kStatsTimeoutMs;
+  while (rtc::TimeMillis() < timeout_ms &&
+         !std::all_of(endpoints_.begin(), endpoints_.end(),
+                      [](const std::unique_ptr<Endpoint>& endpoint) {
+                        return endpoint->stats_delivered();
+                      })) {
+    signaling_thread_->ProcessMessages(kPollIntervalMs);
+  }
+
+  LoadTestResult result;
+  const int64_t now_ms = rtc::TimeMillis();
+  for (const auto& endpoint : endpoints_) {
+    result.connections.push_back(endpoint->GetResult(now_ms));
+    if (endpoint->connected())
+      ++result.connected;
+  }
+  result.streams = result.connected * ((audio_track_ ? 1 : 0) +
+                                       (video_track_ ? 1 : 0));
+  if (result.streams > 0 && wall_ms > 0) {
+    result.cpu_percent_per_stream =
+        100.0 * cpu_ns / (wall_ms * kNanosPerMillisecond) / result.streams;
+  }
+  return result;
+}
+
+void LoadTest::DestroyEndpoints() {
+  for (size_t id = 0; id < endpoints_.size(); ++id)
+    signaling_->Close(static_cast<int>(id));
+  endpoints_.clear();
+}
+
+}  // namespace webrtc
@@ -0,0 +1,148 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef RTC_TOOLS_PEERCONNECTION_LOADTEST_LOADTEST_H_
+#define RTC_TOOLS_PEERCONNECTION_LOADTEST_LOADTEST_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "api/optional.h"
+#include "api/peerconnectioninterface.h"
+#include "p2p/base/packetsocketfactory.h"
+#include "rtc_base/constructormagic.h"
+#include "rtc_base/network.h"
+#include "rtc_base/thread.h"
+
+namespace webrtc {
+
+class FakePeriodicVideoTrackSource;
+
+struct LoadTestConfig {
+  int num_connections = 10;
+  // The connections are started one after the other, at this rate, so that
+  // the join times don't depend on how fast the machine creates them.
+  int joins_per_second = 50;
+  // How long to keep sending after the last connection was started.
+  int duration_ms = 10000;
+  bool audio = true;
+  bool video = true;
+  int video_width = 640;
+  int video_height = 360;
+  int video_fps = 30;
+  // Gives the host candidates of all the connections the same UDP socket,
+  // instead of one socket per connection, see SharedUdpSocketFactory.
+  bool shared_udp_socket = true;
+  uint16_t min_port = 0;
+  uint16_t max_port = 0;
+};
+
+// What one connection achieved.
+struct LoadTestConnectionResult {
+  int id = 0;
+  // From the start of the offer to ICE connected, unset if the connection
+  // never connected.
+  rtc::Optional<int64_t> join_time_ms;
+  uint64_t bytes_sent = 0;
+  uint64_t bytes_received = 0;
+  // The mean rates since the connection connected.
+  int send_kbps = 0;
+  int receive_kbps = 0;
+};
+
+struct LoadTestResult {
+  LoadTestResult();
+  LoadTestResult(const LoadTestResult&);
+  ~LoadTestResult();
+
+  std::vector<LoadTestConnectionResult> connections;
+  int connected = 0;
+  // The number of audio and video streams sent by connected connections.
+  int streams = 0;
+  // The process CPU time from when the last connection was started to the
+  // end, in percent of one core, divided by |streams|.
+  double cpu_percent_per_stream = 0;
+};
+
+// Carries the offers of the load test to the endpoint under test, typically
+// an SFU, and its answers back. The offers are sent once ICE gathering is
+// complete, so they hold all the candidates and no trickling is needed.
+class LoadTestSignaling {
+ public:
+  using AnswerCallback = std::function<void(const std::string& answer_sdp)>;
+
+  virtual ~LoadTestSignaling() = default;
+
+  // Sends the offer of connection |id|. |on_answer| is to be called with the
+  // answer, which must also be complete, on the signaling thread, i.e. the
+  // thread LoadTest::Run() is called on.
+  virtual void SendOffer(int id,
+                         const std::string& offer_sdp,
+                         AnswerCallback on_answer) = 0;
+  // Called when connection |id| is closed, at the end of the test.
+  virtual void Close(int id) {}
+};
+
+// Generates load on a media server with many PeerConnections in one process.
+// The PeerConnections are created by one PeerConnectionFactory and share its
+// threads, a fake audio device and one fake video source, and they encode and
+// decode video with the fake H.264 codecs of test/, so the CPU goes to the
+// transports and the RTP stacks rather than to the codecs. The transports are
+// real: ICE over the host interfaces, DTLS and SRTP.
+//
+// Every connection sends audio and video and receives whatever the other
+// endpoint offers to send. Without |signaling| the other endpoints are
+// receive-only PeerConnections in this process, the loopback mode, which is
+// also what the unittests use.
+class LoadTest {
+ public:
+  // |signaling| may be null, otherwise it must outlive the LoadTest.
+  LoadTest(const LoadTestConfig& config, LoadTestSignaling* signaling);
+  ~LoadTest();
+
+  // Runs the test, once, on the current thread, which becomes the signaling
+  // thread of the PeerConnections and must be an rtc::Thread. The LoadTest
+  // must be destroyed on it too. Returns an empty result if the
+  // PeerConnectionFactory couldn't be created.
+  LoadTestResult Run();
+
+ private:
+  class Endpoint;
+  class LoopbackSignaling;
+
+  bool CreateFactory();
+  std::unique_ptr<Endpoint> CreateEndpoint(int id, bool caller);
+  void StartConnection(int id);
+  LoadTestResult CollectResults(int64_t cpu_ns, int64_t wall_ms);
+  void DestroyEndpoints();
+
+  const LoadTestConfig config_;
+  LoadTestSignaling* signaling_;
+  rtc::Thread* signaling_thread_ = nullptr;
+  std::unique_ptr<rtc::Thread> network_thread_;
+  std::unique_ptr<rtc::Thread> worker_thread_;
+  std::unique_ptr<rtc::BasicNetworkManager> network_manager_;
+  std::unique_ptr<rtc::PacketSocketFactory> base_socket_factory_;
+  std::unique_ptr<rtc::PacketSocketFactory> socket_factory_;
+  rtc::scoped_refptr<PeerConnectionFactoryInterface> factory_;
+  rtc::scoped_refptr<FakePeriodicVideoTrackSource> video_source_;
+  rtc::scoped_refptr<AudioTrackInterface> audio_track_;
+  rtc::scoped_refptr<VideoTrackInterface> video_track_;
+  std::unique_ptr<LoopbackSignaling> loopback_signaling_;
+  std::vector<std::unique_ptr<Endpoint>> endpoints_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(LoadTest);
+};
+
+}  // namespace webrtc
+
+#endif  // RTC_TOOLS_PEERCONNECTION_LOADTEST_LOADTEST_H_
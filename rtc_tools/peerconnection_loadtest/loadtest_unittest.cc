@@ -0,0 +1,78 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "rtc_tools/peerconnection_loadtest/loadtest.h"
+
+#include "rtc_base/ssladapter.h"
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+LoadTestConfig SmallConfig() {
+  LoadTestConfig config;
+  config.num_connections = 4;
+  config.joins_per_second = 20;
+  config.duration_ms = 3000;
+  config.video_width = 320;
+  config.video_height = 180;
+  return config;
+}
+
+class LoadTestTest : public ::testing::Test {
+ protected:
+  static void SetUpTestCase() { rtc::InitializeSSL(); }
+  static void TearDownTestCase() { rtc::CleanupSSL(); }
+
+  rtc::AutoThread signaling_thread_;
+};
+
+void ExpectAllConnected(const LoadTestConfig& config,
+                        const LoadTestResult& result) {
+  ASSERT_EQ(static_cast<size_t>(config.num_connections),
+            result.connections.size());
+  EXPECT_EQ(config.num_connections, result.connected);
+  for (size_t i = 0; i < result.connections.size(); ++i) {
+    const LoadTestConnectionResult& connection = result.connections[i];
+    EXPECT_EQ(static_cast<int>(i), connection.id);
+    ASSERT_TRUE(connection.join_time_ms) << i;
+    EXPECT_GE(*connection.join_time_ms, 0);
+    // Audio and video together send well above what RTCP and the STUN
+    // consent checks would.
+    EXPECT_GT(connection.send_kbps, 50) << i;
+    EXPECT_GT(connection.bytes_received, 0u) << i;
+  }
+}
+
+}  // namespace
+
+TEST_F(LoadTestTest, ConnectionsSendAudioAndVideo) {
+  const LoadTestConfig config = SmallConfig();
+  LoadTest load_test(config, nullptr);
+  const LoadTestResult result = load_test.Run();
+
+  ExpectAllConnected(config, result);
+  EXPECT_EQ(2 * config.num_connections, result.streams);
+  EXPECT_GT(result.cpu_percent_per_stream, 0);
+}
+
+TEST_F(LoadTestTest, ConnectionsWithSocketsOfTheirOwn) {
+  LoadTestConfig config = SmallConfig();
+  config.shared_udp_socket = false;
+  config.audio = false;
+  LoadTest load_test(config, nullptr);
+  const LoadTestResult result = load_test.Run();
+
+  ExpectAllConnected(config, result);
+  EXPECT_EQ(config.num_connections, result.streams);
+}
+
+}  // namespace webrtc
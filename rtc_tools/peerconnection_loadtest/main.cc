@@ -0,0 +1,106 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/flags.h"
+#include "rtc_base/ssladapter.h"
+#include "rtc_base/thread.h"
+#include "rtc_tools/peerconnection_loadtest/loadtest.h"
+
+DEFINE_int(connections, 10, "Number of PeerConnections.");
+DEFINE_int(joins_per_second, 50, "Rate at which the connections are started.");
+DEFINE_int(duration_ms, 10000,
+           "How long to run after the last connection was started.");
+DEFINE_bool(audio, true, "Send audio.");
+DEFINE_bool(video, true, "Send video.");
+DEFINE_int(width, 640, "Width of the video.");
+DEFINE_int(height, 360, "Height of the video.");
+DEFINE_int(fps, 30, "Frame rate of the video.");
+DEFINE_bool(shared_udp_socket, true,
+            "Use one UDP socket per local address for all the connections.");
+DEFINE_int(min_port, 0, "Lowest local UDP port, 0 for any.");
+DEFINE_int(max_port, 0, "Highest local UDP port, 0 for any.");
+DEFINE_bool(per_connection, false, "Print the results of every connection.");
+DEFINE_bool(help, false, "Print this message.");
+
+int main(int argc, char* argv[]) {
+  if (rtc::FlagList::SetFlagsFromCommandLine(&argc, argv, true) ||
+      FLAG_help || argc != 1) {
+    printf("Opens many PeerConnections, which send fake H.264 video and "
+           "audio to in-process\nreceive-only PeerConnections, and reports "
+           "their join times, rates and the\nCPU they take.\n\n"
+           "Usage: %s [options]\n\n", argv[0]);
+    rtc::FlagList::Print(nullptr, false);
+    return FLAG_help ? 0 : 1;
+  }
+  RTC_CHECK_GT(FLAG_connections, 0);
+  RTC_CHECK_GT(FLAG_joins_per_second, 0);
+  RTC_CHECK_GT(FLAG_fps, 0);
+  RTC_CHECK(FLAG_min_port >= 0 && FLAG_max_port <= 65535 &&
+            FLAG_min_port <= FLAG_max_port);
+
+  webrtc::LoadTestConfig config;
+  config.num_connections = FLAG_connections;
+  config.joins_per_second = FLAG_joins_per_second;
+  config.duration_ms = FLAG_duration_ms;
+  config.audio = FLAG_audio;
+  config.video = FLAG_video;
+  config.video_width = FLAG_width;
+  config.video_height = FLAG_height;
+  config.video_fps = FLAG_fps;
+  config.shared_udp_socket = FLAG_shared_udp_socket;
+  config.min_port = static_cast<uint16_t>(FLAG_min_port);
+  config.max_port = static_cast<uint16_t>(FLAG_max_port);
+
+  rtc::InitializeSSL();
+  webrtc::LoadTestResult result;
+  {
+    rtc::AutoThread signaling_thread;
+    webrtc::LoadTest load_test(config, nullptr);
+    result = load_test.Run();
+  }
+  rtc::CleanupSSL();
+
+  std::vector<int64_t> join_times_ms;
+  int64_t send_kbps = 0;
+  for (const webrtc::LoadTestConnectionResult& connection :
+       result.connections) {
+    if (FLAG_per_connection) {
+      printf("connection %d: join_time_ms=%d send_kbps=%d receive_kbps=%d\n",
+             connection.id,
+             connection.join_time_ms ? static_cast<int>(
+                                           *connection.join_time_ms)
+                                     : -1,
+             connection.send_kbps, connection.receive_kbps);
+    }
+    if (connection.join_time_ms) {
+      join_times_ms.push_back(*connection.join_time_ms);
+      send_kbps += connection.send_kbps;
+    }
+  }
+  printf("connected: %d of %d\n", result.connected, FLAG_connections);
+  if (!join_times_ms.empty()) {
+    std::sort(join_times_ms.begin(), join_times_ms.end());
+    printf("join_time_ms: median=%d p95=%d max=%d\n",
+           static_cast<int>(join_times_ms[join_times_ms.size() / 2]),
+           static_cast<int>(join_times_ms[join_times_ms.size() * 95 / 100]),
+           static_cast<int>(join_times_ms.back()));
+    printf("send_kbps_per_connection: %d\n",
+           static_cast<int>(send_kbps / join_times_ms.size()));
+  }
+  printf("streams: %d\n", result.streams);
+  printf("cpu_percent_per_stream: %.3f\n", result.cpu_percent_per_stream);
+  return result.connected == FLAG_connections ? 0 : 1;
+}
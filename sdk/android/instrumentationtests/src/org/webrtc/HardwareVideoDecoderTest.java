@@ -195,4 +195,16 @@ public final class HardwareVideoDecoderTest {
 
     assertEquals(VideoCodecStatus.OK, decoder.release());
   }
+
+  @Test
+  @SmallTest
+  public void testDecodeInAsyncMode() {
+    PeerConnectionFactory.initializeFieldTrials(
+        MediaCodecUtils.ASYNC_MODE_FIELD_TRIAL + "/Enabled/");
+    try {
+      testDecode();
+    } finally {
+      PeerConnectionFactory.initializeFieldTrials(null);
+    }
+  }
 }
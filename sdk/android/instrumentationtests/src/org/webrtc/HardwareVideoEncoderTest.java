@@ -399,6 +399,18 @@ public class HardwareVideoEncoderTest {
     assertEquals(VideoCodecStatus.OK, encoder.release());
   }
 
+  @Test
+  @SmallTest
+  public void testEncodeInAsyncMode() {
+    PeerConnectionFactory.initializeFieldTrials(
+        MediaCodecUtils.ASYNC_MODE_FIELD_TRIAL + "/Enabled/");
+    try {
+      testEncode();
+    } finally {
+      PeerConnectionFactory.initializeFieldTrials(null);
+    }
+  }
+
   @Test
   @SmallTest
   public void testEncodeAltenatingBuffers() {
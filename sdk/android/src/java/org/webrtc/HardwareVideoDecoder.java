@@ -14,6 +14,8 @@ import android.annotation.TargetApi;
 import android.media.MediaCodec;
 import android.media.MediaCodecInfo.CodecCapabilities;
 import android.media.MediaFormat;
+import android.os.Handler;
+import android.os.HandlerThread;
 import android.os.SystemClock;
 import android.view.Surface;
 import java.io.IOException;
@@ -67,14 +69,26 @@ class HardwareVideoDecoder
   }
 
   private final BlockingDeque<FrameInfo> frameInfos;
+  // Indices of the input buffers made available by the codec in asynchronous mode.
+  private final BlockingDeque<Integer> inputBufferIndices = new LinkedBlockingDeque<>();
   private int colorFormat;
 
+  // Whether the codec runs in asynchronous mode, where it delivers decoded output buffers through
+  // callbacks on |callbackThread| instead of being polled by |outputThread|.  Variable is set on
+  // decoder thread and is immutable while the codec is running.
+  private boolean useAsyncMode;
+
   // Output thread runs a loop which polls MediaCodec for decoded output buffers.  It reformats
   // those buffers into VideoFrames and delivers them to the callback.  Variable is set on decoder
   // thread and is immutable while the codec is running.
   @Nullable private Thread outputThread;
+  // Callback thread does the same work as the output thread in asynchronous mode, as the codec
+  // makes the buffers available.  Variable is set on decoder thread and is immutable while the
+  // codec is running.
+  @Nullable private HandlerThread callbackThread;
 
-  // Checker that ensures work is run on the output thread.
+  // Checker that ensures work is run on the output thread, or the callback thread in asynchronous
+  // mode.
   private ThreadChecker outputThreadChecker;
 
   // Checker that ensures work is run on the decoder thread.  The decoder thread is owned by the
@@ -162,7 +176,7 @@ class HardwareVideoDecoder
   private VideoCodecStatus initDecodeInternal(int width, int height) {
     decoderThreadChecker.checkIsOnValidThread();
     Logging.d(TAG, "initDecodeInternal");
-    if (outputThread != null) {
+    if (outputThread != null || callbackThread != null) {
       Logging.e(TAG, "initDecodeInternal called while the codec is already running");
       return VideoCodecStatus.FALLBACK_SOFTWARE;
     }
@@ -183,21 +197,38 @@ class HardwareVideoDecoder
       Logging.e(TAG, "Cannot create media decoder " + codecName);
       return VideoCodecStatus.FALLBACK_SOFTWARE;
     }
+    useAsyncMode = MediaCodecUtils.isAsyncModeEnabled();
+    if (useAsyncMode) {
+      outputThreadChecker = new ThreadChecker();
+      outputThreadChecker.detachThread();
+      callbackThread = new HandlerThread("HardwareVideoDecoder.callbackThread");
+      callbackThread.start();
+    }
     try {
       MediaFormat format = MediaFormat.createVideoFormat(codecType.mimeType(), width, height);
       if (sharedContext == null) {
         format.setInteger(MediaFormat.KEY_COLOR_FORMAT, colorFormat);
       }
+      if (useAsyncMode) {
+        // The callback must be set before the codec is configured.
+        setCodecCallback();
+      }
       codec.configure(format, surface, null, 0);
       codec.start();
     } catch (IllegalStateException e) {
       Logging.e(TAG, "initDecode failed", e);
+      if (callbackThread != null) {
+        callbackThread.quitSafely();
+        callbackThread = null;
+      }
       release();
       return VideoCodecStatus.FALLBACK_SOFTWARE;
     }
     running = true;
-    outputThread = createOutputThread();
-    outputThread.start();
+    if (!useAsyncMode) {
+      outputThread = createOutputThread();
+      outputThread.start();
+    }
 
     Logging.d(TAG, "initDecodeInternal done");
     return VideoCodecStatus.OK;
@@ -251,11 +282,15 @@ class HardwareVideoDecoder
     }
 
     int index;
-    try {
-      index = codec.dequeueInputBuffer(DEQUEUE_INPUT_TIMEOUT_US);
-    } catch (IllegalStateException e) {
-      Logging.e(TAG, "dequeueInputBuffer failed", e);
-      return VideoCodecStatus.ERROR;
+    if (useAsyncMode) {
+      index = pollInputBufferIndex();
+    } else {
+      try {
+        index = codec.dequeueInputBuffer(DEQUEUE_INPUT_TIMEOUT_US);
+      } catch (IllegalStateException e) {
+        Logging.e(TAG, "dequeueInputBuffer failed", e);
+        return VideoCodecStatus.ERROR;
+      }
     }
     if (index < 0) {
       // Decoder is falling behind.  No input buffers available.
@@ -266,7 +301,7 @@ class HardwareVideoDecoder
 
     ByteBuffer buffer;
     try {
-      buffer = codec.getInputBuffers()[index];
+      buffer = getInputBuffer(index);
     } catch (IllegalStateException e) {
       Logging.e(TAG, "getInputBuffers failed", e);
       return VideoCodecStatus.ERROR;
@@ -332,9 +367,15 @@ class HardwareVideoDecoder
       return VideoCodecStatus.OK;
     }
     try {
-      // The outputThread actually stops and releases the codec once running is false.
+      // The outputThread actually stops and releases the codec once running is false.  In
+      // asynchronous mode, the callbackThread releases the codec after any pending callbacks.
       running = false;
-      if (!ThreadUtils.joinUninterruptibly(outputThread, MEDIA_CODEC_RELEASE_TIMEOUT_MS)) {
+      if (useAsyncMode) {
+        new Handler(callbackThread.getLooper()).post(this::releaseCodecOnOutputThread);
+        callbackThread.quitSafely();
+      }
+      final Thread releaseThread = useAsyncMode ? callbackThread : outputThread;
+      if (!ThreadUtils.joinUninterruptibly(releaseThread, MEDIA_CODEC_RELEASE_TIMEOUT_MS)) {
         // Log an exception to capture the stack trace and turn it into a TIMEOUT error.
         Logging.e(TAG, "Media decoder release timeout", new RuntimeException());
         return VideoCodecStatus.TIMEOUT;
@@ -349,6 +390,8 @@ class HardwareVideoDecoder
     } finally {
       codec = null;
       outputThread = null;
+      callbackThread = null;
+      inputBufferIndices.clear();
     }
     return VideoCodecStatus.OK;
   }
@@ -375,25 +418,90 @@ class HardwareVideoDecoder
     };
   }
 
+  // Sets a callback that runs on the callback thread, and delivers decoded frames as soon as the
+  // codec makes them available.
+  @TargetApi(23)
+  private void setCodecCallback() {
+    codec.setCallback(new MediaCodec.Callback() {
+      @Override
+      public void onInputBufferAvailable(MediaCodec codec, int index) {
+        inputBufferIndices.offer(index);
+      }
+
+      @Override
+      public void onOutputBufferAvailable(
+          MediaCodec codec, int index, MediaCodec.BufferInfo info) {
+        if (running) {
+          deliverDecodedFrame(index, info);
+        }
+      }
+
+      @Override
+      public void onError(MediaCodec codec, MediaCodec.CodecException e) {
+        Logging.e(TAG, "MediaCodec error", e);
+      }
+
+      @Override
+      public void onOutputFormatChanged(MediaCodec codec, MediaFormat format) {
+        if (running) {
+          reformat(format);
+        }
+      }
+    }, new Handler(callbackThread.getLooper()));
+  }
+
+  // Waits for an input buffer in asynchronous mode, with the same timeout as
+  // dequeueInputBuffer().  Returns -1 if none is available.
+  private int pollInputBufferIndex() {
+    try {
+      Integer index = inputBufferIndices.poll(DEQUEUE_INPUT_TIMEOUT_US, TimeUnit.MICROSECONDS);
+      return (index != null) ? index : -1;
+    } catch (InterruptedException e) {
+      Thread.currentThread().interrupt();
+      return -1;
+    }
+  }
+
+  // Input and output buffers can only be accessed one at a time in asynchronous mode.
+  @TargetApi(21)
+  private ByteBuffer getInputBuffer(int index) {
+    return useAsyncMode ? codec.getInputBuffer(index) : codec.getInputBuffers()[index];
+  }
+
+  @TargetApi(21)
+  private ByteBuffer getOutputBuffer(int index) {
+    return useAsyncMode ? codec.getOutputBuffer(index) : codec.getOutputBuffers()[index];
+  }
+
   private void deliverDecodedFrame() {
     outputThreadChecker.checkIsOnValidThread();
+    MediaCodec.BufferInfo info = new MediaCodec.BufferInfo();
+    int result;
     try {
-      MediaCodec.BufferInfo info = new MediaCodec.BufferInfo();
       // Block until an output buffer is available (up to 100 milliseconds).  If the timeout is
       // exceeded, deliverDecodedFrame() will be called again on the next iteration of the output
       // thread's loop.  Blocking here prevents the output thread from busy-waiting while the codec
       // is idle.
-      int result = codec.dequeueOutputBuffer(info, DEQUEUE_OUTPUT_BUFFER_TIMEOUT_US);
+      result = codec.dequeueOutputBuffer(info, DEQUEUE_OUTPUT_BUFFER_TIMEOUT_US);
       if (result == MediaCodec.INFO_OUTPUT_FORMAT_CHANGED) {
         reformat(codec.getOutputFormat());
         return;
       }
+    } catch (IllegalStateException e) {
+      Logging.e(TAG, "dequeueOutputBuffer failed", e);
+      return;
+    }
 
-      if (result < 0) {
-        Logging.v(TAG, "dequeueOutputBuffer returned " + result);
-        return;
-      }
+    if (result < 0) {
+      Logging.v(TAG, "dequeueOutputBuffer returned " + result);
+      return;
+    }
+    deliverDecodedFrame(result, info);
+  }
 
+  private void deliverDecodedFrame(int result, MediaCodec.BufferInfo info) {
+    outputThreadChecker.checkIsOnValidThread();
+    try {
       FrameInfo frameInfo = frameInfos.poll();
       Integer decodeTimeMs = null;
       int rotation = 0;
@@ -481,7 +589,7 @@ class HardwareVideoDecoder
       stride = info.size * 2 / (height * 3);
     }
 
-    ByteBuffer buffer = codec.getOutputBuffers()[result];
+    ByteBuffer buffer = getOutputBuffer(result);
     buffer.position(info.offset);
     buffer.limit(info.offset + info.size);
     buffer = buffer.slice();
@@ -643,6 +751,11 @@ class HardwareVideoDecoder
     outputThreadChecker.checkIsOnValidThread();
     running = false;
     shutdownException = e;
+    if (useAsyncMode) {
+      // There is no output loop to exit, so release the codec here.
+      releaseCodecOnOutputThread();
+      callbackThread.quitSafely();
+    }
   }
 
   private boolean isSupportedColorFormat(int colorFormat) {
@@ -17,6 +17,9 @@ import android.media.MediaCodecInfo;
 import android.media.MediaFormat;
 import android.opengl.GLES20;
 import android.os.Bundle;
+import android.os.Handler;
+import android.os.HandlerThread;
+import android.os.SystemClock;
 import android.view.Surface;
 import java.io.IOException;
 import java.nio.ByteBuffer;
@@ -52,6 +55,21 @@ class HardwareVideoEncoder implements VideoEncoder {
   private static final int MEDIA_CODEC_RELEASE_TIMEOUT_MS = 5000;
   private static final int DEQUEUE_OUTPUT_BUFFER_TIMEOUT_US = 100000;
 
+  // Time from when a frame is queued in the codec until it is delivered to the callback.
+  private static final Histogram encodeTimeMsHistogram =
+      Histogram.createCounts("WebRTC.Android.HardwareVideoEncoder.EncodeTimeMs", 1, 1000, 50);
+
+  private static class FrameInfo {
+    // Pre-populated with all the information that can't be sent through MediaCodec.
+    final EncodedImage.Builder builder;
+    final long encodeStartTimeMs;
+
+    FrameInfo(EncodedImage.Builder builder, long encodeStartTimeMs) {
+      this.builder = builder;
+      this.encodeStartTimeMs = encodeStartTimeMs;
+    }
+  }
+
   // --- Initialized on construction.
   private final String codecName;
   private final VideoCodecType codecType;
@@ -70,9 +88,10 @@ class HardwareVideoEncoder implements VideoEncoder {
   // Drawer used to draw input textures onto the codec's input surface.
   private final GlRectDrawer textureDrawer = new GlRectDrawer();
   private final VideoFrameDrawer videoFrameDrawer = new VideoFrameDrawer();
-  // A queue of EncodedImage.Builders that correspond to frames in the codec.  These builders are
-  // pre-populated with all the information that can't be sent through MediaCodec.
-  private final BlockingDeque<EncodedImage.Builder> outputBuilders = new LinkedBlockingDeque<>();
+  // A queue of FrameInfos that correspond to frames in the codec.
+  private final BlockingDeque<FrameInfo> frameInfos = new LinkedBlockingDeque<>();
+  // Indices of the input buffers made available by the codec in asynchronous mode.
+  private final BlockingDeque<Integer> inputBufferIndices = new LinkedBlockingDeque<>();
 
   private final ThreadChecker encodeThreadChecker = new ThreadChecker();
   private final ThreadChecker outputThreadChecker = new ThreadChecker();
@@ -83,8 +102,13 @@ class HardwareVideoEncoder implements VideoEncoder {
 
   // --- Valid and immutable while an encoding session is running.
   @Nullable private MediaCodec codec;
+  // Whether the codec runs in asynchronous mode, where it delivers encoded frames through
+  // callbacks on |callbackThread| instead of being polled by |outputThread|.
+  private boolean useAsyncMode;
   // Thread that delivers encoded frames to the user callback.
   @Nullable private Thread outputThread;
+  // Thread running the codec callbacks in asynchronous mode.
+  @Nullable private HandlerThread callbackThread;
 
   // EGL base wrapping the shared texture context.  Holds hooks to both the shared context and the
   // input surface.  Making this base current allows textures from the context to be drawn onto the
@@ -101,7 +125,7 @@ class HardwareVideoEncoder implements VideoEncoder {
   // Presentation timestamp of the last requested (or forced) key frame.
   private long lastKeyFrameNs;
 
-  // --- Only accessed on the output thread.
+  // --- Only accessed on the output thread, or the callback thread in asynchronous mode.
   // Contents of the last observed config frame output by the MediaCodec. Used by H.264.
   @Nullable private ByteBuffer configBuffer = null;
   private int adjustedBitrate;
@@ -180,6 +204,13 @@ class HardwareVideoEncoder implements VideoEncoder {
       return VideoCodecStatus.FALLBACK_SOFTWARE;
     }
 
+    useAsyncMode = MediaCodecUtils.isAsyncModeEnabled();
+    outputThreadChecker.detachThread();
+    if (useAsyncMode) {
+      callbackThread = new HandlerThread("HardwareVideoEncoder.callbackThread");
+      callbackThread.start();
+    }
+
     final int colorFormat = useSurfaceMode ? surfaceColorFormat : yuvColorFormat;
     try {
       MediaFormat format = MediaFormat.createVideoFormat(codecType.mimeType(), width, height);
@@ -205,6 +236,10 @@ class HardwareVideoEncoder implements VideoEncoder {
         }
       }
       Logging.d(TAG, "Format: " + format);
+      if (useAsyncMode) {
+        // The callback must be set before the codec is configured.
+        setCodecCallback();
+      }
       codec.configure(
           format, null /* surface */, null /* crypto */, MediaCodec.CONFIGURE_FLAG_ENCODE);
 
@@ -223,9 +258,10 @@ class HardwareVideoEncoder implements VideoEncoder {
     }
 
     running = true;
-    outputThreadChecker.detachThread();
-    outputThread = createOutputThread();
-    outputThread.start();
+    if (!useAsyncMode) {
+      outputThread = createOutputThread();
+      outputThread.start();
+    }
 
     return VideoCodecStatus.OK;
   }
@@ -235,12 +271,18 @@ class HardwareVideoEncoder implements VideoEncoder {
     encodeThreadChecker.checkIsOnValidThread();
 
     final VideoCodecStatus returnValue;
-    if (outputThread == null) {
+    final Thread releaseThread = useAsyncMode ? callbackThread : outputThread;
+    if (releaseThread == null) {
       returnValue = VideoCodecStatus.OK;
     } else {
-      // The outputThread actually stops and releases the codec once running is false.
+      // The outputThread actually stops and releases the codec once running is false. In
+      // asynchronous mode, the callbackThread releases the codec after any pending callbacks.
       running = false;
-      if (!ThreadUtils.joinUninterruptibly(outputThread, MEDIA_CODEC_RELEASE_TIMEOUT_MS)) {
+      if (useAsyncMode) {
+        new Handler(callbackThread.getLooper()).post(this::releaseCodecOnOutputThread);
+        callbackThread.quitSafely();
+      }
+      if (!ThreadUtils.joinUninterruptibly(releaseThread, MEDIA_CODEC_RELEASE_TIMEOUT_MS)) {
         Logging.e(TAG, "Media encoder release timeout");
         returnValue = VideoCodecStatus.TIMEOUT;
       } else if (shutdownException != null) {
@@ -262,10 +304,12 @@ class HardwareVideoEncoder implements VideoEncoder {
       textureInputSurface.release();
       textureInputSurface = null;
     }
-    outputBuilders.clear();
+    frameInfos.clear();
+    inputBufferIndices.clear();
 
     codec = null;
     outputThread = null;
+    callbackThread = null;
 
     // Allow changing thread after release.
     encodeThreadChecker.detachThread();
@@ -294,7 +338,7 @@ class HardwareVideoEncoder implements VideoEncoder {
       }
     }
 
-    if (outputBuilders.size() > MAX_ENCODER_Q_SIZE) {
+    if (frameInfos.size() > MAX_ENCODER_Q_SIZE) {
       // Too many frames in the encoder.  Drop this frame.
       Logging.e(TAG, "Dropped frame, encoder queue full");
       return VideoCodecStatus.NO_OUTPUT; // See webrtc bug 2887.
@@ -320,7 +364,7 @@ class HardwareVideoEncoder implements VideoEncoder {
                                        .setEncodedWidth(videoFrame.getBuffer().getWidth())
                                        .setEncodedHeight(videoFrame.getBuffer().getHeight())
                                        .setRotation(videoFrame.getRotation());
-    outputBuilders.offer(builder);
+    frameInfos.offer(new FrameInfo(builder, SystemClock.elapsedRealtime()));
 
     final VideoCodecStatus returnValue;
     if (useSurfaceMode) {
@@ -331,8 +375,8 @@ class HardwareVideoEncoder implements VideoEncoder {
 
     // Check if the queue was successful.
     if (returnValue != VideoCodecStatus.OK) {
-      // Keep the output builders in sync with buffers in the codec.
-      outputBuilders.pollLast();
+      // Keep the frame infos in sync with buffers in the codec.
+      frameInfos.pollLast();
     }
 
     return returnValue;
@@ -364,11 +408,16 @@ class HardwareVideoEncoder implements VideoEncoder {
 
     // No timeout.  Don't block for an input buffer, drop frames if the encoder falls behind.
     int index;
-    try {
-      index = codec.dequeueInputBuffer(0 /* timeout */);
-    } catch (IllegalStateException e) {
-      Logging.e(TAG, "dequeueInputBuffer failed", e);
-      return VideoCodecStatus.ERROR;
+    if (useAsyncMode) {
+      Integer availableIndex = inputBufferIndices.poll();
+      index = (availableIndex != null) ? availableIndex : -1;
+    } else {
+      try {
+        index = codec.dequeueInputBuffer(0 /* timeout */);
+      } catch (IllegalStateException e) {
+        Logging.e(TAG, "dequeueInputBuffer failed", e);
+        return VideoCodecStatus.ERROR;
+      }
     }
 
     if (index == -1) {
@@ -379,7 +428,7 @@ class HardwareVideoEncoder implements VideoEncoder {
 
     ByteBuffer buffer;
     try {
-      buffer = codec.getInputBuffers()[index];
+      buffer = getInputBuffer(index);
     } catch (IllegalStateException e) {
       Logging.e(TAG, "getInputBuffers failed", e);
       return VideoCodecStatus.ERROR;
@@ -481,16 +530,67 @@ class HardwareVideoEncoder implements VideoEncoder {
     };
   }
 
+  // Sets a callback that runs on the callback thread, and delivers encoded frames as soon as the
+  // codec makes them available.
+  @TargetApi(23)
+  private void setCodecCallback() {
+    codec.setCallback(new MediaCodec.Callback() {
+      @Override
+      public void onInputBufferAvailable(MediaCodec codec, int index) {
+        // Never called in surface mode, where input is drawn on the input surface.
+        inputBufferIndices.offer(index);
+      }
+
+      @Override
+      public void onOutputBufferAvailable(
+          MediaCodec codec, int index, MediaCodec.BufferInfo info) {
+        if (running) {
+          deliverEncodedImage(index, info);
+        }
+      }
+
+      @Override
+      public void onError(MediaCodec codec, MediaCodec.CodecException e) {
+        Logging.e(TAG, "MediaCodec error", e);
+      }
+
+      @Override
+      public void onOutputFormatChanged(MediaCodec codec, MediaFormat format) {
+        Logging.d(TAG, "Encoder format changed: " + format);
+      }
+    }, new Handler(callbackThread.getLooper()));
+  }
+
+  // Input and output buffers can only be accessed one at a time in asynchronous mode.
+  @TargetApi(21)
+  private ByteBuffer getInputBuffer(int index) {
+    return useAsyncMode ? codec.getInputBuffer(index) : codec.getInputBuffers()[index];
+  }
+
+  @TargetApi(21)
+  private ByteBuffer getOutputBuffer(int index) {
+    return useAsyncMode ? codec.getOutputBuffer(index) : codec.getOutputBuffers()[index];
+  }
+
   private void deliverEncodedImage() {
     outputThreadChecker.checkIsOnValidThread();
+    MediaCodec.BufferInfo info = new MediaCodec.BufferInfo();
+    int index;
     try {
-      MediaCodec.BufferInfo info = new MediaCodec.BufferInfo();
-      int index = codec.dequeueOutputBuffer(info, DEQUEUE_OUTPUT_BUFFER_TIMEOUT_US);
-      if (index < 0) {
-        return;
-      }
+      index = codec.dequeueOutputBuffer(info, DEQUEUE_OUTPUT_BUFFER_TIMEOUT_US);
+    } catch (IllegalStateException e) {
+      Logging.e(TAG, "dequeueOutputBuffer failed", e);
+      return;
+    }
+    if (index >= 0) {
+      deliverEncodedImage(index, info);
+    }
+  }
 
-      ByteBuffer codecOutputBuffer = codec.getOutputBuffers()[index];
+  private void deliverEncodedImage(int index, MediaCodec.BufferInfo info) {
+    outputThreadChecker.checkIsOnValidThread();
+    try {
+      ByteBuffer codecOutputBuffer = getOutputBuffer(index);
       codecOutputBuffer.position(info.offset);
       codecOutputBuffer.limit(info.offset + info.size);
 
@@ -528,7 +628,10 @@ class HardwareVideoEncoder implements VideoEncoder {
             ? EncodedImage.FrameType.VideoFrameKey
             : EncodedImage.FrameType.VideoFrameDelta;
 
-        EncodedImage.Builder builder = outputBuilders.poll();
+        FrameInfo frameInfo = frameInfos.poll();
+        encodeTimeMsHistogram.addSample(
+            (int) (SystemClock.elapsedRealtime() - frameInfo.encodeStartTimeMs));
+        EncodedImage.Builder builder = frameInfo.builder;
         builder.setBuffer(frameBuffer).setFrameType(frameType);
         // TODO(mellem):  Set codec-specific info.
         callback.onEncodedFrame(builder.createEncodedImage(), new CodecSpecificInfo());
@@ -14,6 +14,7 @@ import android.annotation.TargetApi;
 import android.media.MediaCodec;
 import android.media.MediaCodecInfo;
 import android.media.MediaCodecInfo.CodecCapabilities;
+import android.os.Build;
 import java.util.HashMap;
 import java.util.Map;
 import javax.annotation.Nullable;
@@ -57,6 +58,17 @@ class MediaCodecUtils {
   // Color formats supported by texture mode encoding - in order of preference.
   static final int[] TEXTURE_COLOR_FORMATS = {MediaCodecInfo.CodecCapabilities.COLOR_FormatSurface};
 
+  // Field trial that makes the hardware encoder and decoder run MediaCodec in asynchronous mode,
+  // where buffers are delivered through callbacks instead of being polled with timeouts.
+  static final String ASYNC_MODE_FIELD_TRIAL = "WebRTC-MediaCodecAsyncMode";
+
+  // Asynchronous mode requires setting the callback with a Handler, which is available from API
+  // level 23.
+  static boolean isAsyncModeEnabled() {
+    return Build.VERSION.SDK_INT >= Build.VERSION_CODES.M
+        && PeerConnectionFactory.fieldTrialsFindFullName(ASYNC_MODE_FIELD_TRIAL).equals("Enabled");
+  }
+
   static @Nullable Integer selectColorFormat(
       int[] supportedColorFormats, CodecCapabilities capabilities) {
     for (int supportedColorFormat : supportedColorFormats) {
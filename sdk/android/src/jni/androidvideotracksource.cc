@@ -92,7 +92,7 @@ void AndroidVideoTrackSource::OnFrameCaptured(
   }
 
   rtc::scoped_refptr<VideoFrameBuffer> buffer =
-      AndroidVideoBuffer::Create(jni, j_video_frame_buffer)
+      AndroidVideoBuffer::Create(jni, width, height, j_video_frame_buffer)
           ->CropAndScale(jni, crop_x, crop_y, crop_width, crop_height,
                          adapted_width, adapted_height);
 
@@ -20,6 +20,11 @@ namespace webrtc {
 
 namespace jni {
 
+namespace {
+// Time without underruns after which the buffer is made one burst smaller.
+const int kBufferDecreaseIntervalSeconds = 10;
+}  // namespace
+
 enum AudioDeviceMessageType : uint32_t {
   kMessageOutputStreamDisconnected,
 };
@@ -87,6 +92,7 @@ int AAudioPlayer::StartPlayout() {
     return -1;
   }
   underrun_count_ = aaudio_.xrun_count();
+  frames_without_underrun_ = 0;
   first_data_callback_ = true;
   playing_ = true;
   return 0;
@@ -179,13 +185,22 @@ aaudio_data_callback_result_t AAudioPlayer::OnDataCallback(void* audio_data,
 
   // Check if the underrun count has increased. If it has, increase the buffer
   // size by adding the size of a burst. It will reduce the risk of underruns
-  // at the expense of an increased latency.
+  // at the expense of an increased latency. Once there haven't been any
+  // underruns for a while, a burst is taken away again.
   // TODO(henrika): enable possibility to disable and/or tune the algorithm.
   const int32_t underrun_count = aaudio_.xrun_count();
   if (underrun_count > underrun_count_) {
     RTC_LOG(LS_ERROR) << "Underrun detected: " << underrun_count;
     underrun_count_ = underrun_count;
+    frames_without_underrun_ = 0;
     aaudio_.IncreaseOutputBufferSize();
+  } else {
+    frames_without_underrun_ += num_frames;
+    if (frames_without_underrun_ >= static_cast<int64_t>(
+            kBufferDecreaseIntervalSeconds) * aaudio_.sample_rate()) {
+      frames_without_underrun_ = 0;
+      aaudio_.DecreaseOutputBufferSize();
+    }
   }
 
   // Estimate latency between writing an audio frame to the output stream and
@@ -50,7 +50,9 @@ namespace jni {
 // Also supports automatic buffer-size adjustment based on underrun detections
 // where the internal AAudio buffer can be increased when needed. It will
 // reduce the risk of underruns (~glitches) at the expense of an increased
-// latency.
+// latency. The buffer shrinks again by a burst at a time after a while
+// without underruns, so that a passing glitch doesn't add latency for the
+// rest of the call.
 class AAudioPlayer final : public AudioOutput,
                            public AAudioObserverInterface,
                            public rtc::MessageHandler {
@@ -130,6 +132,10 @@ class AAudioPlayer final : public AudioOutput,
   // Counts number of detected underrun events reported by AAudio.
   int32_t underrun_count_ = 0;
 
+  // Number of frames played out since the last underrun, or since the buffer
+  // size was last decreased.
+  int64_t frames_without_underrun_ = 0;
+
   // True only for the first data callback in each audio session.
   bool first_data_callback_ = true;
 
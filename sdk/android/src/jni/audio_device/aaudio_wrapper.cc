@@ -267,6 +267,27 @@ bool AAudioWrapper::IncreaseOutputBufferSize() {
   return true;
 }
 
+bool AAudioWrapper::DecreaseOutputBufferSize() {
+  RTC_LOG(INFO) << "DecreaseBufferSize";
+  RTC_DCHECK(stream_);
+  RTC_DCHECK(aaudio_thread_checker_.CalledOnValidThread());
+  RTC_DCHECK_EQ(direction(), AAUDIO_DIRECTION_OUTPUT);
+  aaudio_result_t buffer_size = AAudioStream_getBufferSizeInFrames(stream_);
+  // Never go below one burst, which is what OptimizeBuffers() starts with.
+  if (buffer_size - frames_per_burst() < frames_per_burst()) {
+    return false;
+  }
+  buffer_size -= frames_per_burst();
+  buffer_size = AAudioStream_setBufferSizeInFrames(stream_, buffer_size);
+  if (buffer_size < 0) {
+    RTC_LOG(LS_ERROR) << "Failed to change buffer size: "
+                      << AAudio_convertResultToText(buffer_size);
+    return false;
+  }
+  RTC_LOG(INFO) << "Buffer size changed to: " << buffer_size;
+  return true;
+}
+
 void AAudioWrapper::ClearInputStream(void* audio_data, int32_t num_frames) {
   RTC_LOG(INFO) << "ClearInputStream";
   RTC_DCHECK(stream_);
@@ -370,10 +391,11 @@ void AAudioWrapper::SetStreamConfiguration(AAudioStreamBuilder* builder) {
   AAudioStreamBuilder_setChannelCount(builder, audio_parameters().channels());
   // Always use 16-bit PCM audio sample format.
   AAudioStreamBuilder_setFormat(builder, AAUDIO_FORMAT_PCM_I16);
-  // TODO(henrika): investigate effect of using AAUDIO_SHARING_MODE_EXCLUSIVE.
-  // Ask for exclusive mode since this will give us the lowest possible latency.
+  // Ask for exclusive mode since this will give us the lowest possible latency:
+  // on devices that support it, the stream then writes to and reads from the
+  // MMAP buffer of the audio device without going through the mixer.
   // If exclusive mode isn't available, shared mode will be used instead.
-  AAudioStreamBuilder_setSharingMode(builder, AAUDIO_SHARING_MODE_SHARED);
+  AAudioStreamBuilder_setSharingMode(builder, AAUDIO_SHARING_MODE_EXCLUSIVE);
   // Use the direction that was given at construction.
   AAudioStreamBuilder_setDirection(builder, direction_);
   // TODO(henrika): investigate performance using different performance modes.
@@ -444,9 +466,8 @@ bool AAudioWrapper::VerifyStreamConfiguration() {
     RTC_LOG(LS_ERROR) << "Stream unable to use requested format";
     return false;
   }
-  if (AAudioStream_getSharingMode(stream_) != AAUDIO_SHARING_MODE_SHARED) {
-    RTC_LOG(LS_ERROR) << "Stream unable to use requested sharing mode";
-    return false;
+  if (AAudioStream_getSharingMode(stream_) != AAUDIO_SHARING_MODE_EXCLUSIVE) {
+    RTC_LOG(LS_WARNING) << "Exclusive mode is not available, using shared mode";
   }
   if (AAudioStream_getPerformanceMode(stream_) !=
       AAUDIO_PERFORMANCE_MODE_LOW_LATENCY) {
@@ -79,6 +79,11 @@ class AAudioWrapper {
   // reduce the risk of underruns. Can be used while a stream is active.
   bool IncreaseOutputBufferSize();
 
+  // Decreases the internal buffer size for output streams by one burst size,
+  // but not below one burst, to win back latency once underruns have stopped.
+  // Can be used while a stream is active.
+  bool DecreaseOutputBufferSize();
+
   // Drains the recording stream of any existing data by reading from it until
   // it's empty. Can be used to clear out old data before starting a new audio
   // session.
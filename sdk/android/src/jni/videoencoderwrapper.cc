@@ -232,8 +232,9 @@ void VideoEncoderWrapper::OnEncodedFrame(JNIEnv* jni,
       static_cast<uint8_t*>(jni->GetDirectBufferAddress(j_buffer.obj()));
   const size_t buffer_size = jni->GetDirectBufferCapacity(j_buffer.obj());
 
-  std::vector<uint8_t> buffer_copy(buffer_size);
-  memcpy(buffer_copy.data(), buffer, buffer_size);
+  // The buffer belongs to MediaCodec and is reused once this call returns, so
+  // it has to be copied before it is handed to the encoder queue.
+  std::vector<uint8_t> buffer_copy(buffer, buffer + buffer_size);
   const int qp = JavaToNativeOptionalInt(jni, j_qp).value_or(-1);
 
   struct Lambda {
@@ -220,6 +220,15 @@ rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::Adopt(
                                                        j_video_frame_buffer);
 }
 
+rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::Adopt(
+    JNIEnv* jni,
+    int width,
+    int height,
+    const JavaRef<jobject>& j_video_frame_buffer) {
+  return new rtc::RefCountedObject<AndroidVideoBuffer>(jni, width, height,
+                                                       j_video_frame_buffer);
+}
+
 rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::Create(
     JNIEnv* jni,
     const JavaRef<jobject>& j_video_frame_buffer) {
@@ -227,11 +236,30 @@ rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::Create(
   return Adopt(jni, j_video_frame_buffer);
 }
 
+rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::Create(
+    JNIEnv* jni,
+    int width,
+    int height,
+    const JavaRef<jobject>& j_video_frame_buffer) {
+  Java_Buffer_retain(jni, j_video_frame_buffer);
+  return Adopt(jni, width, height, j_video_frame_buffer);
+}
+
+AndroidVideoBuffer::AndroidVideoBuffer(
+    JNIEnv* jni,
+    const JavaRef<jobject>& j_video_frame_buffer)
+    : AndroidVideoBuffer(jni,
+                         Java_Buffer_getWidth(jni, j_video_frame_buffer),
+                         Java_Buffer_getHeight(jni, j_video_frame_buffer),
+                         j_video_frame_buffer) {}
+
 AndroidVideoBuffer::AndroidVideoBuffer(
     JNIEnv* jni,
+    int width,
+    int height,
     const JavaRef<jobject>& j_video_frame_buffer)
-    : width_(Java_Buffer_getWidth(jni, j_video_frame_buffer)),
-      height_(Java_Buffer_getHeight(jni, j_video_frame_buffer)),
+    : width_(width),
+      height_(height),
       j_video_frame_buffer_(jni, j_video_frame_buffer) {}
 
 AndroidVideoBuffer::~AndroidVideoBuffer() {
@@ -252,9 +280,10 @@ rtc::scoped_refptr<AndroidVideoBuffer> AndroidVideoBuffer::CropAndScale(
     int crop_height,
     int scale_width,
     int scale_height) {
-  return Adopt(jni, Java_Buffer_cropAndScale(jni, j_video_frame_buffer_, crop_x,
-                                             crop_y, crop_width, crop_height,
-                                             scale_width, scale_height));
+  return Adopt(jni, scale_width, scale_height,
+               Java_Buffer_cropAndScale(jni, j_video_frame_buffer_, crop_x,
+                                        crop_y, crop_width, crop_height,
+                                        scale_width, scale_height));
 }
 
 VideoFrameBuffer::Type AndroidVideoBuffer::type() const {
@@ -270,13 +299,18 @@ int AndroidVideoBuffer::height() const {
 }
 
 rtc::scoped_refptr<I420BufferInterface> AndroidVideoBuffer::ToI420() {
+  rtc::CritScope lock(&i420_crit_);
+  if (i420_buffer_)
+    return i420_buffer_;
   JNIEnv* jni = AttachCurrentThreadIfNeeded();
   ScopedJavaLocalRef<jobject> j_i420_buffer =
       Java_Buffer_toI420(jni, j_video_frame_buffer_);
 
   // We don't need to retain the buffer because toI420 returns a new object that
   // we are assumed to take the ownership of.
-  return AndroidVideoI420Buffer::Adopt(jni, width_, height_, j_i420_buffer);
+  i420_buffer_ =
+      AndroidVideoI420Buffer::Adopt(jni, width_, height_, j_i420_buffer);
+  return i420_buffer_;
 }
 
 VideoFrame JavaToNativeFrame(JNIEnv* jni,
@@ -17,6 +17,7 @@
 #include "api/video/video_frame_buffer.h"
 #include "api/video/video_rotation.h"
 #include "rtc_base/callback.h"
+#include "rtc_base/criticalsection.h"
 #include "sdk/android/src/jni/jni_helpers.h"
 
 namespace webrtc {
@@ -69,6 +70,13 @@ class AndroidVideoBuffer : public VideoFrameBuffer {
   static rtc::scoped_refptr<AndroidVideoBuffer> Create(
       JNIEnv* jni,
       const JavaRef<jobject>& j_video_frame_buffer);
+  // Like the above, for callers that know the size of the buffer already,
+  // which saves the JNI calls that would ask the buffer for it.
+  static rtc::scoped_refptr<AndroidVideoBuffer> Create(
+      JNIEnv* jni,
+      int width,
+      int height,
+      const JavaRef<jobject>& j_video_frame_buffer);
 
   // Similar to the Create() above, but adopts and takes ownership of the Java
   // VideoFrame.Buffer. I.e. retain() will not be called, but release() will be
@@ -76,6 +84,11 @@ class AndroidVideoBuffer : public VideoFrameBuffer {
   static rtc::scoped_refptr<AndroidVideoBuffer> Adopt(
       JNIEnv* jni,
       const JavaRef<jobject>& j_video_frame_buffer);
+  static rtc::scoped_refptr<AndroidVideoBuffer> Adopt(
+      JNIEnv* jni,
+      int width,
+      int height,
+      const JavaRef<jobject>& j_video_frame_buffer);
 
   ~AndroidVideoBuffer() override;
 
@@ -95,6 +108,10 @@ class AndroidVideoBuffer : public VideoFrameBuffer {
   // Should not be called directly. Adopts the Java VideoFrame.Buffer. Use
   // Create() or Adopt() instead for clarity.
   AndroidVideoBuffer(JNIEnv* jni, const JavaRef<jobject>& j_video_frame_buffer);
+  AndroidVideoBuffer(JNIEnv* jni,
+                     int width,
+                     int height,
+                     const JavaRef<jobject>& j_video_frame_buffer);
 
  private:
   Type type() const override;
@@ -107,6 +124,12 @@ class AndroidVideoBuffer : public VideoFrameBuffer {
   const int height_;
   // Holds a VideoFrame.Buffer.
   const ScopedJavaGlobalRef<jobject> j_video_frame_buffer_;
+
+  // Converting a texture reads it back from the GPU, so the frame is only
+  // converted once however many sinks want it in I420.
+  rtc::CriticalSection i420_crit_;
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer_
+      RTC_GUARDED_BY(i420_crit_);
 };
 
 VideoFrame JavaToNativeFrame(JNIEnv* jni,
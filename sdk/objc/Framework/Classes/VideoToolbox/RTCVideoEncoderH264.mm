@@ -58,6 +58,9 @@ const float kLimitToAverageBitRateFactor = 1.5f;
 // have been found to work better on devices that support VideoToolbox
 const int kLowH264QpThreshold = 28;
 const int kHighH264QpThreshold = 39;
+// The encoder should output every frame as soon as it is encoded, without
+// holding any back to look ahead.
+const int32_t kMaxFrameDelayCount = 0;
 
 const OSType kNV12PixelFormat = kCVPixelFormatType_420YpCbCr8BiPlanarFullRange;
 
@@ -279,6 +282,8 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   std::unique_ptr<webrtc::BitrateAdjuster> _bitrateAdjuster;
   uint32_t _targetBitrateBps;
   uint32_t _encoderBitrateBps;
+  uint32_t _targetFrameRate;
+  uint32_t _encoderFrameRate;
   RTCH264PacketizationMode _packetizationMode;
   CFStringRef _profile;
   RTCVideoEncoderCallback _callback;
@@ -330,6 +335,7 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   // We can only set average bitrate on the HW encoder.
   _targetBitrateBps = settings.startBitrate * 1000;  // startBitrate is in kbps.
   _bitrateAdjuster->SetTargetBitrateBps(_targetBitrateBps);
+  _targetFrameRate = settings.maxFramerate;
 
   // TODO(tkchin): Try setting payload size via
   // kVTCompressionPropertyKey_MaxH264SliceBytes.
@@ -381,15 +387,19 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
       }
       int dstWidth = CVPixelBufferGetWidth(pixelBuffer);
       int dstHeight = CVPixelBufferGetHeight(pixelBuffer);
+      uint8_t *tmpBuffer = nullptr;
       if ([rtcPixelBuffer requiresScalingToWidth:dstWidth height:dstHeight]) {
-        int size =
+        // The scale buffer is kept from frame to frame, since the sizes of
+        // the frames rarely change.
+        size_t size =
             [rtcPixelBuffer bufferSizeForCroppingAndScalingToWidth:dstWidth height:dstHeight];
-        _frameScaleBuffer.resize(size);
-      } else {
-        _frameScaleBuffer.clear();
+        if (_frameScaleBuffer.size() < size) {
+          _frameScaleBuffer.resize(size);
+        }
+        tmpBuffer = _frameScaleBuffer.data();
       }
-      _frameScaleBuffer.shrink_to_fit();
-      if (![rtcPixelBuffer cropAndScaleTo:pixelBuffer withTempBuffer:_frameScaleBuffer.data()]) {
+      if (![rtcPixelBuffer cropAndScaleTo:pixelBuffer withTempBuffer:tmpBuffer]) {
+        CVBufferRelease(pixelBuffer);
         return WEBRTC_VIDEO_CODEC_ERROR;
       }
     }
@@ -437,8 +447,9 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
                                               frame.rotation));
   encodeParams->codecSpecificInfo.packetizationMode = _packetizationMode;
 
-  // Update the bitrate if needed.
-  [self setBitrateBps:_bitrateAdjuster->GetAdjustedBitrateBps()];
+  // Update the bitrate and frame rate if needed, so that the rate control
+  // applies them from this frame on.
+  [self setBitrateBps:_bitrateAdjuster->GetAdjustedBitrateBps() frameRate:_targetFrameRate];
 
   OSStatus status = VTCompressionSessionEncodeFrame(_compressionSession,
                                                     pixelBuffer,
@@ -467,7 +478,8 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
 - (int)setBitrate:(uint32_t)bitrateKbit framerate:(uint32_t)framerate {
   _targetBitrateBps = 1000 * bitrateKbit;
   _bitrateAdjuster->SetTargetBitrateBps(_targetBitrateBps);
-  [self setBitrateBps:_bitrateAdjuster->GetAdjustedBitrateBps()];
+  _targetFrameRate = framerate;
+  [self setBitrateBps:_bitrateAdjuster->GetAdjustedBitrateBps() frameRate:_targetFrameRate];
   return WEBRTC_VIDEO_CODEC_OK;
 }
 
@@ -617,14 +629,11 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_RealTime, true);
   SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_ProfileLevel, _profile);
   SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_AllowFrameReordering, false);
-  [self setEncoderBitrateBps:_targetBitrateBps];
+  // Not supported by all encoders, in which case the default delay is kept.
+  SetVTSessionProperty(
+      _compressionSession, kVTCompressionPropertyKey_MaxFrameDelayCount, kMaxFrameDelayCount);
+  [self setEncoderBitrateBps:_targetBitrateBps frameRate:_targetFrameRate];
   // TODO(tkchin): Look at entropy mode and colorspace matrices.
-  // TODO(tkchin): Investigate to see if there's any way to make this work.
-  // May need it to interop with Android. Currently this call just fails.
-  // On inspecting encoder output on iOS8, this value is set to 6.
-  // internal::SetVTSessionProperty(compression_session_,
-  //     kVTCompressionPropertyKey_MaxFrameDelayCount,
-  //     1);
 
   // Set a relatively large value for keyframe emission (7200 frames or 4 minutes).
   SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_MaxKeyFrameInterval, 7200);
@@ -644,15 +653,21 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
   return @"VideoToolbox";
 }
 
-- (void)setBitrateBps:(uint32_t)bitrateBps {
-  if (_encoderBitrateBps != bitrateBps) {
-    [self setEncoderBitrateBps:bitrateBps];
+- (void)setBitrateBps:(uint32_t)bitrateBps frameRate:(uint32_t)frameRate {
+  if (_encoderBitrateBps != bitrateBps || _encoderFrameRate != frameRate) {
+    [self setEncoderBitrateBps:bitrateBps frameRate:frameRate];
   }
 }
 
-- (void)setEncoderBitrateBps:(uint32_t)bitrateBps {
+- (void)setEncoderBitrateBps:(uint32_t)bitrateBps frameRate:(uint32_t)frameRate {
   if (_compressionSession) {
     SetVTSessionProperty(_compressionSession, kVTCompressionPropertyKey_AverageBitRate, bitrateBps);
+    // The expected frame rate lets the rate control size each frame for the
+    // bitrate, instead of adapting to the frame rate over several frames.
+    if (frameRate > 0) {
+      SetVTSessionProperty(
+          _compressionSession, kVTCompressionPropertyKey_ExpectedFrameRate, frameRate);
+    }
 
     // TODO(tkchin): Add a helper method to set array value.
     int64_t dataLimitBytesPerSecondValue =
@@ -680,6 +695,7 @@ CFStringRef ExtractProfile(webrtc::SdpVideoFormat videoFormat) {
     }
 
     _encoderBitrateBps = bitrateBps;
+    _encoderFrameRate = frameRate;
   }
 }
 
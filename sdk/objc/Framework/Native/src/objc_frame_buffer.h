@@ -14,6 +14,7 @@
 #import <CoreVideo/CoreVideo.h>
 
 #include "common_video/include/video_frame_buffer.h"
+#include "rtc_base/criticalsection.h"
 
 @protocol RTCVideoFrameBuffer;
 
@@ -37,6 +38,11 @@ class ObjCFrameBuffer : public VideoFrameBuffer {
   id<RTCVideoFrameBuffer> frame_buffer_;
   int width_;
   int height_;
+
+  // Converting a CVPixelBuffer copies and converts all of it, so the frame is
+  // only converted once however many sinks want it in I420.
+  rtc::CriticalSection i420_crit_;
+  rtc::scoped_refptr<I420BufferInterface> i420_buffer_ RTC_GUARDED_BY(i420_crit_);
 };
 
 id<RTCVideoFrameBuffer> ToObjCVideoFrameBuffer(
@@ -66,10 +66,11 @@ int ObjCFrameBuffer::height() const {
 }
 
 rtc::scoped_refptr<I420BufferInterface> ObjCFrameBuffer::ToI420() {
-  rtc::scoped_refptr<I420BufferInterface> buffer =
-      new rtc::RefCountedObject<ObjCI420FrameBuffer>([frame_buffer_ toI420]);
-
-  return buffer;
+  rtc::CritScope lock(&i420_crit_);
+  if (!i420_buffer_) {
+    i420_buffer_ = new rtc::RefCountedObject<ObjCI420FrameBuffer>([frame_buffer_ toI420]);
+  }
+  return i420_buffer_;
 }
 
 id<RTCVideoFrameBuffer> ObjCFrameBuffer::wrapped_frame_buffer() const {
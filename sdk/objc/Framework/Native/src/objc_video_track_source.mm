@@ -13,7 +13,6 @@
 #import "WebRTC/RTCVideoFrame.h"
 #import "WebRTC/RTCVideoFrameBuffer.h"
 
-#include "api/video/i420_buffer.h"
 #include "sdk/objc/Framework/Native/src/objc_frame_buffer.h"
 
 @interface RTCObjCVideoSourceAdapter ()
@@ -66,6 +65,7 @@ void ObjCVideoTrackSource::OnCapturedFrame(RTCVideoFrame *frame) {
     return;
   }
 
+  VideoRotation rotation = static_cast<VideoRotation>(frame.rotation);
   rtc::scoped_refptr<VideoFrameBuffer> buffer;
   if (adapted_width == frame.width && adapted_height == frame.height) {
     // No adaption - optimized path.
@@ -82,19 +82,26 @@ void ObjCVideoTrackSource::OnCapturedFrame(RTCVideoFrame *frame) {
                       cropX:crop_x + rtcPixelBuffer.cropX
                       cropY:crop_y + rtcPixelBuffer.cropY]);
   } else {
-    // Adapted I420 frame.
-    // TODO(magjed): Optimize this I420 path.
-    rtc::scoped_refptr<I420Buffer> i420_buffer = I420Buffer::Create(adapted_width, adapted_height);
-    buffer = new rtc::RefCountedObject<ObjCFrameBuffer>(frame.buffer);
-    i420_buffer->CropAndScaleFrom(*buffer->ToI420(), crop_x, crop_y, crop_width, crop_height);
-    buffer = i420_buffer;
+    // Adapted I420 frame. Any pending rotation is applied in the same pass.
+    const VideoRotation applied_rotation = apply_rotation() ? rotation : kVideoRotation_0;
+    buffer = CropScaleAndRotate(new rtc::RefCountedObject<ObjCFrameBuffer>(frame.buffer),
+                                crop_x,
+                                crop_y,
+                                crop_width,
+                                crop_height,
+                                adapted_width,
+                                adapted_height,
+                                applied_rotation);
+    if (applied_rotation != kVideoRotation_0) {
+      rotation = kVideoRotation_0;
+    }
   }
 
   // Applying rotation is only supported for legacy reasons and performance is
   // not critical here.
-  VideoRotation rotation = static_cast<VideoRotation>(frame.rotation);
   if (apply_rotation() && rotation != kVideoRotation_0) {
-    buffer = I420Buffer::Rotate(*buffer->ToI420(), rotation);
+    buffer = CropScaleAndRotate(
+        buffer, 0, 0, buffer->width(), buffer->height(), buffer->width(), buffer->height(), rotation);
     rotation = kVideoRotation_0;
   }
 
@@ -10,7 +10,9 @@
 
 #include "api/stats/rtcstats.h"
 
-#include <iomanip>
+#include <inttypes.h>
+#include <stdio.h>
+
 #include <sstream>
 
 #include "rtc_base/stringencode.h"
@@ -49,27 +51,74 @@ std::string VectorOfStringsToString(const std::vector<T>& strings) {
   return oss.str();
 }
 
-template <typename T>
-std::string ToStringAsDouble(const T value) {
-  // JSON represents numbers as floating point numbers with about 15 decimal
-  // digits of precision.
-  const int JSON_PRECISION = 16;
-  std::ostringstream oss;
-  oss << std::setprecision(JSON_PRECISION) << static_cast<double>(value);
-  return oss.str();
+// Appends |value| the same way as
+// std::ostringstream << std::setprecision(16) << value would, without creating
+// a stream. JSON represents numbers as floating point numbers with about 15
+// decimal digits of precision.
+void AppendJsonValue(double value, std::string* json) {
+  char buffer[32];
+  int length = snprintf(buffer, sizeof(buffer), "%.16g", value);
+  RTC_DCHECK_GT(length, 0);
+  json->append(buffer, length);
+}
+
+void AppendJsonValue(bool value, std::string* json) {
+  json->append(value ? "true" : "false");
+}
+
+void AppendJsonValue(int32_t value, std::string* json) {
+  char buffer[16];
+  int length = snprintf(buffer, sizeof(buffer), "%" PRId32, value);
+  RTC_DCHECK_GT(length, 0);
+  json->append(buffer, length);
+}
+
+void AppendJsonValue(uint32_t value, std::string* json) {
+  char buffer[16];
+  int length = snprintf(buffer, sizeof(buffer), "%" PRIu32, value);
+  RTC_DCHECK_GT(length, 0);
+  json->append(buffer, length);
+}
+
+// 64-bit integers are represented as doubles, see |ValueToJson|.
+void AppendJsonValue(int64_t value, std::string* json) {
+  AppendJsonValue(static_cast<double>(value), json);
+}
+
+void AppendJsonValue(uint64_t value, std::string* json) {
+  AppendJsonValue(static_cast<double>(value), json);
 }
 
+// Strings are not quoted, see |RTCStats::AppendJson|.
+void AppendJsonValue(const std::string& value, std::string* json) {
+  json->append(value);
+}
+
+// Produces "[\"a\",\"b\",\"c\"]".
+void AppendJsonValue(const std::vector<std::string>& strings,
+                     std::string* json) {
+  json->push_back('[');
+  for (size_t i = 0; i < strings.size(); ++i) {
+    if (i > 0)
+      json->push_back(',');
+    json->push_back('"');
+    json->append(strings[i]);
+    json->push_back('"');
+  }
+  json->push_back(']');
+}
+
+// Produces "[a,b,c]". Works for non-string sequence types.
 template <typename T>
-std::string VectorToStringAsDouble(const std::vector<T>& vector) {
-  if (vector.empty())
-    return "[]";
-  std::ostringstream oss;
-  oss << "[" << ToStringAsDouble<T>(vector[0]);
-  for (size_t i = 1; i < vector.size(); ++i) {
-    oss << "," << ToStringAsDouble<T>(vector[i]);
+void AppendJsonValue(const std::vector<T>& vector, std::string* json) {
+  json->push_back('[');
+  for (size_t i = 0; i < vector.size(); ++i) {
+    if (i > 0)
+      json->push_back(',');
+    const T& element = vector[i];
+    AppendJsonValue(element, json);
   }
-  oss << "]";
-  return oss.str();
+  json->push_back(']');
 }
 
 }  // namespace
@@ -96,21 +145,48 @@ bool RTCStats::operator!=(const RTCStats& other) const {
 }
 
 std::string RTCStats::ToJson() const {
-  std::ostringstream oss;
-  oss << "{\"type\":\"" << type() << "\","
-      << "\"id\":\"" << id_ << "\","
-      << "\"timestamp\":" << timestamp_us_;
+  std::string json;
+  AppendJson(&json);
+  return json;
+}
+
+void RTCStats::AppendJson(std::string* json) const {
+  RTC_DCHECK(json);
+  char timestamp[24];
+  int timestamp_length =
+      snprintf(timestamp, sizeof(timestamp), "%" PRId64, timestamp_us_);
+  RTC_DCHECK_GT(timestamp_length, 0);
+  json->append("{\"type\":\"");
+  json->append(type());
+  json->append("\",\"id\":\"");
+  json->append(id_);
+  json->append("\",\"timestamp\":");
+  json->append(timestamp, timestamp_length);
   for (const RTCStatsMemberInterface* member : Members()) {
     if (member->is_defined()) {
-      oss << ",\"" << member->name() << "\":";
-      if (member->is_string())
-        oss << '"' << member->ValueToJson() << '"';
-      else
-        oss << member->ValueToJson();
+      json->append(",\"");
+      json->append(member->name());
+      json->append("\":");
+      if (member->is_string()) {
+        json->push_back('"');
+        member->AppendValueJson(json);
+        json->push_back('"');
+      } else {
+        member->AppendValueJson(json);
+      }
+    }
+  }
+  json->push_back('}');
+}
+
+void RTCStats::RetainMembers(
+    const std::function<bool(const RTCStatsMemberInterface&)>& keep) {
+  for (const RTCStatsMemberInterface* member : Members()) {
+    if (member->is_defined() && !keep(*member)) {
+      // The members are owned by this non-const object.
+      const_cast<RTCStatsMemberInterface*>(member)->is_defined_ = false;
     }
   }
-  oss << "}";
-  return oss.str();
 }
 
 std::vector<const RTCStatsMemberInterface*> RTCStats::Members() const {
@@ -125,7 +201,7 @@ RTCStats::MembersOfThisObjectAndAncestors(
   return members;
 }
 
-#define WEBRTC_DEFINE_RTCSTATSMEMBER(T, type, is_seq, is_str, to_str, to_json) \
+#define WEBRTC_DEFINE_RTCSTATSMEMBER(T, type, is_seq, is_str, to_str)          \
   template <>                                                                  \
   const RTCStatsMemberInterface::Type RTCStatsMember<T>::kType =               \
       RTCStatsMemberInterface::type;                                           \
@@ -145,92 +221,85 @@ RTCStats::MembersOfThisObjectAndAncestors(
   template <>                                                                  \
   std::string RTCStatsMember<T>::ValueToJson() const {                         \
     RTC_DCHECK(is_defined_);                                                   \
-    return to_json;                                                            \
+    std::string json;                                                          \
+    AppendJsonValue(value_, &json);                                            \
+    return json;                                                               \
+  }                                                                            \
+  template <>                                                                  \
+  void RTCStatsMember<T>::AppendValueJson(std::string* json) const {           \
+    RTC_DCHECK(is_defined_);                                                   \
+    AppendJsonValue(value_, json);                                             \
   }
 
 WEBRTC_DEFINE_RTCSTATSMEMBER(bool,
                              kBool,
                              false,
                              false,
-                             rtc::ToString(value_),
                              rtc::ToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(int32_t,
                              kInt32,
                              false,
                              false,
-                             rtc::ToString(value_),
                              rtc::ToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(uint32_t,
                              kUint32,
                              false,
                              false,
-                             rtc::ToString(value_),
                              rtc::ToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(int64_t,
                              kInt64,
                              false,
                              false,
-                             rtc::ToString(value_),
-                             ToStringAsDouble(value_));
+                             rtc::ToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(uint64_t,
                              kUint64,
                              false,
                              false,
-                             rtc::ToString(value_),
-                             ToStringAsDouble(value_));
+                             rtc::ToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(double,
                              kDouble,
                              false,
                              false,
-                             rtc::ToString(value_),
-                             ToStringAsDouble(value_));
+                             rtc::ToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::string,
                              kString,
                              false,
                              true,
-                             value_,
                              value_);
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<bool>,
                              kSequenceBool,
                              true,
                              false,
-                             VectorToString(value_),
                              VectorToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<int32_t>,
                              kSequenceInt32,
                              true,
                              false,
-                             VectorToString(value_),
                              VectorToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<uint32_t>,
                              kSequenceUint32,
                              true,
                              false,
-                             VectorToString(value_),
                              VectorToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<int64_t>,
                              kSequenceInt64,
                              true,
                              false,
-                             VectorToString(value_),
-                             VectorToStringAsDouble(value_));
+                             VectorToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<uint64_t>,
                              kSequenceUint64,
                              true,
                              false,
-                             VectorToString(value_),
-                             VectorToStringAsDouble(value_));
+                             VectorToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<double>,
                              kSequenceDouble,
                              true,
                              false,
-                             VectorToString(value_),
-                             VectorToStringAsDouble(value_));
+                             VectorToString(value_));
 WEBRTC_DEFINE_RTCSTATSMEMBER(std::vector<std::string>,
                              kSequenceString,
                              true,
                              false,
-                             VectorOfStringsToString(value_),
                              VectorOfStringsToString(value_));
 
 }  // namespace webrtc
@@ -10,8 +10,6 @@
 
 #include "api/stats/rtcstatsreport.h"
 
-#include <sstream>
-
 namespace webrtc {
 
 RTCStatsReport::ConstIterator::ConstIterator(
@@ -121,16 +119,23 @@ RTCStatsReport::ConstIterator RTCStatsReport::end() const {
 }
 
 std::string RTCStatsReport::ToJson() const {
-  std::ostringstream oss;
+  std::string json;
+  AppendJson(&json);
+  return json;
+}
+
+void RTCStatsReport::AppendJson(std::string* json) const {
+  RTC_DCHECK(json);
   ConstIterator it = begin();
   if (it != end()) {
-    oss << '[' << it->ToJson();
+    json->push_back('[');
+    it->AppendJson(json);
     for (++it; it != end(); ++it) {
-      oss << "," << it->ToJson();
+      json->push_back(',');
+      it->AppendJson(json);
     }
-    oss << ']';
+    json->push_back(']');
   }
-  return oss.str();
 }
 
 }  // namespace webrtc
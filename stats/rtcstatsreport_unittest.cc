@@ -145,4 +145,39 @@ TEST(RTCStatsReport, TakeMembersFrom) {
   EXPECT_EQ(i, static_cast<int64_t>(6));
 }
 
+TEST(RTCStatsReport, AppendJson) {
+  rtc::scoped_refptr<RTCStatsReport> report = RTCStatsReport::Create(1337);
+  std::string json;
+  report->AppendJson(&json);
+  EXPECT_EQ("", json);
+
+  std::unique_ptr<RTCTestStats1> stats1(new RTCTestStats1("a", 1));
+  stats1->integer = -42;
+  report->AddStats(std::move(stats1));
+  std::unique_ptr<RTCTestStats2> stats2(new RTCTestStats2("b", 2));
+  stats2->number = 0.1;
+  report->AddStats(std::move(stats2));
+  std::unique_ptr<RTCTestStats3> stats3(new RTCTestStats3("c", 3));
+  stats3->string = "foo";
+  report->AddStats(std::move(stats3));
+  report->AddStats(
+      std::unique_ptr<RTCStats>(new RTCTestStats1("d", 4000000000000)));
+
+  const std::string kExpectedJson =
+      "[{\"type\":\"test-stats-1\",\"id\":\"a\",\"timestamp\":1,"
+      "\"integer\":-42},"
+      "{\"type\":\"test-stats-2\",\"id\":\"b\",\"timestamp\":2,"
+      "\"number\":0.1},"
+      "{\"type\":\"test-stats-3\",\"id\":\"c\",\"timestamp\":3,"
+      "\"string\":\"foo\"},"
+      "{\"type\":\"test-stats-1\",\"id\":\"d\","
+      "\"timestamp\":4000000000000}]";
+  EXPECT_EQ(kExpectedJson, report->ToJson());
+
+  // Appending keeps the existing content of the buffer.
+  json = "prefix";
+  report->AppendJson(&json);
+  EXPECT_EQ("prefix" + kExpectedJson, json);
+}
+
 }  // namespace webrtc
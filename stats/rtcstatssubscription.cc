@@ -0,0 +1,102 @@
+/*
+ *  Copyright 2018 The WebRTC Project Authors. All rights reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/stats/rtcstatssubscription.h"
+
+#include <string.h>
+
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/refcountedobject.h"
+
+namespace webrtc {
+
+rtc::scoped_refptr<RTCStatsSubscription> RTCStatsSubscription::Create(
+    std::set<std::string> types,
+    std::set<std::string> members,
+    bool deltas) {
+  return rtc::scoped_refptr<RTCStatsSubscription>(
+      new rtc::RefCountedObject<RTCStatsSubscription>(
+          std::move(types), std::move(members), deltas));
+}
+
+RTCStatsSubscription::RTCStatsSubscription(std::set<std::string> types,
+                                           std::set<std::string> members,
+                                           bool deltas)
+    : types_(std::move(types)), members_(std::move(members)), deltas_(deltas) {}
+
+RTCStatsSubscription::~RTCStatsSubscription() {}
+
+bool RTCStatsSubscription::IsTypeSubscribed(const std::string& type) const {
+  return types_.empty() || types_.find(type) != types_.end();
+}
+
+rtc::scoped_refptr<RTCStatsReport> RTCStatsSubscription::FilterReport(
+    const RTCStatsReport& report) {
+  rtc::scoped_refptr<RTCStatsReport> filtered_report =
+      RTCStatsReport::Create(report.timestamp_us());
+  for (const RTCStats& stats : report) {
+    if (!IsTypeSubscribed(stats.type()))
+      continue;
+    std::unique_ptr<RTCStats> filtered_stats = stats.copy();
+    if (!members_.empty()) {
+      filtered_stats->RetainMembers(
+          [this](const RTCStatsMemberInterface& member) {
+            return members_.find(member.name()) != members_.end();
+          });
+    }
+    filtered_report->AddStats(std::move(filtered_stats));
+  }
+  if (!deltas_)
+    return filtered_report;
+
+  removed_ids_.clear();
+  rtc::scoped_refptr<RTCStatsReport> delta_report =
+      RTCStatsReport::Create(report.timestamp_us());
+  for (const RTCStats& stats : *filtered_report) {
+    const RTCStats* previous_stats =
+        previous_report_ ? previous_report_->Get(stats.id()) : nullptr;
+    if (!previous_stats || previous_stats->type() != stats.type()) {
+      delta_report->AddStats(stats.copy());
+      continue;
+    }
+    // |Members| returns the members of a given class in the same order, so the
+    // previous members are searched from the last match.
+    std::vector<const RTCStatsMemberInterface*> previous_members =
+        previous_stats->Members();
+    std::unique_ptr<RTCStats> delta_stats = stats.copy();
+    size_t i = 0;
+    bool changed = false;
+    delta_stats->RetainMembers(
+        [&previous_members, &i, &changed](
+            const RTCStatsMemberInterface& member) {
+          while (strcmp(previous_members[i]->name(), member.name()) != 0) {
+            ++i;
+            RTC_DCHECK_LT(i, previous_members.size());
+          }
+          const bool member_changed = member != *previous_members[i];
+          changed |= member_changed;
+          return member_changed;
+        });
+    if (changed)
+      delta_report->AddStats(std::move(delta_stats));
+  }
+  if (previous_report_) {
+    for (const RTCStats& stats : *previous_report_) {
+      if (!filtered_report->Get(stats.id()))
+        removed_ids_.push_back(stats.id());
+    }
+  }
+  previous_report_ = filtered_report;
+  return delta_report;
+}
+
+}  // namespace webrtc
@@ -0,0 +1,118 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "api/stats/rtcstatssubscription.h"
+
+#include "api/stats/rtcstats.h"
+#include "rtc_base/gunit.h"
+#include "stats/test/rtcteststats.h"
+
+namespace webrtc {
+
+class RTCOtherTestStats : public RTCStats {
+ public:
+  WEBRTC_RTCSTATS_DECL();
+
+  RTCOtherTestStats(const std::string& id, int64_t timestamp_us)
+      : RTCStats(id, timestamp_us), integer("integer") {}
+
+  RTCStatsMember<int32_t> integer;
+};
+
+WEBRTC_RTCSTATS_IMPL(RTCOtherTestStats, RTCStats, "other-test-stats",
+    &integer);
+
+namespace {
+
+rtc::scoped_refptr<RTCStatsReport> CreateReport(int64_t timestamp_us,
+                                                int32_t value) {
+  rtc::scoped_refptr<RTCStatsReport> report =
+      RTCStatsReport::Create(timestamp_us);
+  std::unique_ptr<RTCTestStats> a(new RTCTestStats("a", timestamp_us));
+  a->m_int32 = value;
+  a->m_string = "constant";
+  report->AddStats(std::move(a));
+  std::unique_ptr<RTCOtherTestStats> b(
+      new RTCOtherTestStats("b", timestamp_us));
+  b->integer = value;
+  report->AddStats(std::move(b));
+  return report;
+}
+
+}  // namespace
+
+TEST(RTCStatsSubscription, EmptySetsSubscribeToEverything) {
+  rtc::scoped_refptr<RTCStatsSubscription> subscription =
+      RTCStatsSubscription::Create({}, {}, false);
+  rtc::scoped_refptr<RTCStatsReport> report = CreateReport(1337, 1);
+  rtc::scoped_refptr<RTCStatsReport> filtered =
+      subscription->FilterReport(*report);
+  EXPECT_EQ(1337, filtered->timestamp_us());
+  EXPECT_EQ(report->ToJson(), filtered->ToJson());
+}
+
+TEST(RTCStatsSubscription, FiltersTypesAndMembers) {
+  rtc::scoped_refptr<RTCStatsSubscription> subscription =
+      RTCStatsSubscription::Create({RTCTestStats::kType}, {"mInt32"}, false);
+  EXPECT_TRUE(subscription->IsTypeSubscribed(RTCTestStats::kType));
+  EXPECT_FALSE(subscription->IsTypeSubscribed(RTCOtherTestStats::kType));
+  rtc::scoped_refptr<RTCStatsReport> filtered =
+      subscription->FilterReport(*CreateReport(0, 1));
+  EXPECT_EQ(1u, filtered->size());
+  ASSERT_TRUE(filtered->Get("a"));
+  const RTCTestStats& a = filtered->Get("a")->cast_to<RTCTestStats>();
+  EXPECT_EQ(1, *a.m_int32);
+  EXPECT_FALSE(a.m_string.is_defined());
+  // Without deltas, the same stats are delivered every time.
+  filtered = subscription->FilterReport(*CreateReport(0, 1));
+  EXPECT_EQ(1u, filtered->size());
+}
+
+TEST(RTCStatsSubscription, DeliversChangedMembers) {
+  rtc::scoped_refptr<RTCStatsSubscription> subscription =
+      RTCStatsSubscription::Create({}, {}, true);
+  // The first report contains everything.
+  rtc::scoped_refptr<RTCStatsReport> filtered =
+      subscription->FilterReport(*CreateReport(0, 1));
+  EXPECT_EQ(2u, filtered->size());
+
+  // Nothing changed.
+  filtered = subscription->FilterReport(*CreateReport(10, 1));
+  EXPECT_EQ(10, filtered->timestamp_us());
+  EXPECT_EQ(0u, filtered->size());
+  EXPECT_TRUE(subscription->removed_ids().empty());
+
+  // Only the changed members are defined.
+  filtered = subscription->FilterReport(*CreateReport(20, 2));
+  EXPECT_EQ(2u, filtered->size());
+  ASSERT_TRUE(filtered->Get("a"));
+  const RTCTestStats& a = filtered->Get("a")->cast_to<RTCTestStats>();
+  EXPECT_EQ(2, *a.m_int32);
+  EXPECT_FALSE(a.m_string.is_defined());
+  ASSERT_TRUE(filtered->Get("b"));
+  EXPECT_EQ(2, *filtered->Get("b")->cast_to<RTCOtherTestStats>().integer);
+
+  // Removed stats objects are listed.
+  rtc::scoped_refptr<RTCStatsReport> report = CreateReport(30, 2);
+  report->Take("a");
+  filtered = subscription->FilterReport(*report);
+  EXPECT_EQ(0u, filtered->size());
+  EXPECT_EQ(std::vector<std::string>({"a"}), subscription->removed_ids());
+
+  // A stats object that reappears is delivered in full.
+  filtered = subscription->FilterReport(*CreateReport(40, 2));
+  EXPECT_EQ(1u, filtered->size());
+  ASSERT_TRUE(filtered->Get("a"));
+  EXPECT_EQ("constant",
+            *filtered->Get("a")->cast_to<RTCTestStats>().m_string);
+  EXPECT_TRUE(subscription->removed_ids().empty());
+}
+
+}  // namespace webrtc
@@ -18,7 +18,7 @@ extern "C" {
 #include "typedefs.h"  // NOLINT(build/include)
 
 // List of features in x86.
-typedef enum { kSSE2, kSSE3 } CPUFeature;
+typedef enum { kSSE2, kSSE3, kSSSE3, kAVX2, kFMA3 } CPUFeature;
 
 // List of features in ARM.
 enum {
@@ -9,9 +9,13 @@
 
 #include "system_wrappers/include/metrics_default.h"
 
+#include <string.h>
+
 #include <algorithm>
+#include <atomic>
 
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/platform_thread_types.h"
 #include "rtc_base/thread_annotations.h"
 #include "system_wrappers/include/metrics.h"
 
@@ -23,77 +27,182 @@ namespace metrics {
 class Histogram;
 
 namespace {
-// Limit for the maximum number of sample values that can be stored.
-// TODO(asapersson): Consider using bucket count (and set up
-// linearly/exponentially spaced buckets) if samples are logged more frequently.
-const int kMaxSampleMapSize = 300;
+// The samples of a histogram are spread over this many shards, each used by
+// the threads whose identifier hashes to it, so that threads adding samples
+// to the same histogram rarely touch the same cache lines.
+const int kLog2NumShards = 3;
+const size_t kNumShards = 1 << kLog2NumShards;
+// Limit for the maximum number of sample values that one shard can store.
+const int kLog2SlotsPerShard = 9;
+const size_t kSlotsPerShard = 1 << kLog2SlotsPerShard;
+
+size_t CurrentShardIndex() {
+  const rtc::PlatformThreadRef thread = rtc::CurrentThreadRef();
+  uint64_t key = 0;
+  memcpy(&key, &thread, std::min(sizeof(key), sizeof(thread)));
+  return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >>
+                             (64 - kLog2NumShards));
+}
+
+// The samples added by the threads of one shard: an open addressing table of
+// the distinct sample values and their counts. Each slot is one atomic word,
+// with the value in the upper half and the count in the lower half, so that a
+// sample is added with a single compare-and-swap and no lock. A slot with a
+// count of zero is free.
+class SampleShard {
+ public:
+  SampleShard() {
+    for (std::atomic<uint64_t>& slot : slots_)
+      slot.store(0, std::memory_order_relaxed);
+  }
+
+  void Add(int sample) {
+    const uint64_t value = ValueBits(sample);
+    size_t index = (static_cast<uint32_t>(sample) * 2654435761u) >>
+                   (32 - kLog2SlotsPerShard);
+    for (size_t probes = 0; probes < kSlotsPerShard; ++probes) {
+      std::atomic<uint64_t>& slot = slots_[index];
+      uint64_t word = slot.load(std::memory_order_relaxed);
+      while (true) {
+        uint64_t new_word;
+        if ((word & kCountMask) == 0) {
+          new_word = value | 1;
+        } else if ((word & ~kCountMask) == value) {
+          if ((word & kCountMask) == kCountMask)
+            return;  // The count would overflow; drop the sample.
+          new_word = word + 1;
+        } else {
+          break;  // Another value; probe the next slot.
+        }
+        // On failure |word| is reloaded, and the slot is looked at again:
+        // another thread may have claimed it, or it may have been cleared.
+        if (slot.compare_exchange_weak(word, new_word,
+                                       std::memory_order_relaxed)) {
+          return;
+        }
+      }
+      index = (index + 1) & (kSlotsPerShard - 1);
+    }
+    // The shard is full of other values; drop the sample.
+  }
+
+  // Adds the counts of the shard to |samples|. If |clear|, the slots are
+  // cleared as they are read, so that each sample is moved to |samples|
+  // exactly once even while other threads are adding to the shard.
+  void AddTo(std::map<int, int>* samples, bool clear) {
+    for (std::atomic<uint64_t>& slot : slots_) {
+      const uint64_t word = clear ? slot.exchange(0, std::memory_order_relaxed)
+                                  : slot.load(std::memory_order_relaxed);
+      if ((word & kCountMask) != 0) {
+        (*samples)[static_cast<int>(static_cast<uint32_t>(word >> 32))] +=
+            static_cast<int>(word & kCountMask);
+      }
+    }
+  }
+
+ private:
+  static const uint64_t kCountMask = 0xffffffffull;
+
+  static uint64_t ValueBits(int sample) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(sample)) << 32;
+  }
+
+  std::atomic<uint64_t> slots_[kSlotsPerShard];
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(SampleShard);
+};
 
 class RtcHistogram {
  public:
   RtcHistogram(const std::string& name, int min, int max, int bucket_count)
-      : min_(min), max_(max), info_(name, min, max, bucket_count) {
+      : name_(name), min_(min), max_(max), bucket_count_(bucket_count) {
     RTC_DCHECK_GT(bucket_count, 0);
+    for (std::atomic<SampleShard*>& shard : shards_)
+      shard.store(nullptr, std::memory_order_relaxed);
+  }
+
+  ~RtcHistogram() {
+    for (std::atomic<SampleShard*>& shard : shards_)
+      delete shard.load(std::memory_order_relaxed);
   }
 
   void Add(int sample) {
     sample = std::min(sample, max_);
     sample = std::max(sample, min_ - 1);  // Underflow bucket.
-
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.size() == kMaxSampleMapSize &&
-        info_.samples.find(sample) == info_.samples.end()) {
-      return;
-    }
-    ++info_.samples[sample];
+    GetOrCreateShard(CurrentShardIndex())->Add(sample);
   }
 
   // Returns a copy (or nullptr if there are no samples) and clears samples.
   std::unique_ptr<SampleInfo> GetAndReset() {
-    rtc::CritScope cs(&crit_);
-    if (info_.samples.empty())
+    std::unique_ptr<SampleInfo> copy(
+        new SampleInfo(name_, min_, max_, bucket_count_));
+    GetSamples(&copy->samples, true);
+    if (copy->samples.empty())
       return nullptr;
-
-    SampleInfo* copy =
-        new SampleInfo(info_.name, info_.min, info_.max, info_.bucket_count);
-
-    std::swap(info_.samples, copy->samples);
-
-    return std::unique_ptr<SampleInfo>(copy);
+    return copy;
   }
 
-  const std::string& name() const { return info_.name; }
+  const std::string& name() const { return name_; }
 
   // Functions only for testing.
   void Reset() {
-    rtc::CritScope cs(&crit_);
-    info_.samples.clear();
+    std::map<int, int> samples;
+    GetSamples(&samples, true);
   }
 
   int NumEvents(int sample) const {
-    rtc::CritScope cs(&crit_);
-    const auto it = info_.samples.find(sample);
-    return (it == info_.samples.end()) ? 0 : it->second;
+    std::map<int, int> samples;
+    GetSamples(&samples, false);
+    const auto it = samples.find(sample);
+    return (it == samples.end()) ? 0 : it->second;
   }
 
   int NumSamples() const {
+    std::map<int, int> samples;
+    GetSamples(&samples, false);
     int num_samples = 0;
-    rtc::CritScope cs(&crit_);
-    for (const auto& sample : info_.samples) {
+    for (const auto& sample : samples) {
       num_samples += sample.second;
     }
     return num_samples;
   }
 
   int MinSample() const {
-    rtc::CritScope cs(&crit_);
-    return (info_.samples.empty()) ? -1 : info_.samples.begin()->first;
+    std::map<int, int> samples;
+    GetSamples(&samples, false);
+    return (samples.empty()) ? -1 : samples.begin()->first;
   }
 
  private:
-  rtc::CriticalSection crit_;
+  // Shards are only allocated once a thread hashing to them adds a sample,
+  // since most histograms are only used from one or two threads.
+  SampleShard* GetOrCreateShard(size_t index) {
+    SampleShard* shard = shards_[index].load(std::memory_order_acquire);
+    if (shard)
+      return shard;
+    SampleShard* new_shard = new SampleShard();
+    if (shards_[index].compare_exchange_strong(shard, new_shard,
+                                               std::memory_order_acq_rel)) {
+      return new_shard;
+    }
+    delete new_shard;
+    return shard;
+  }
+
+  // Merges the samples of all shards into |samples|.
+  void GetSamples(std::map<int, int>* samples, bool clear) const {
+    for (const std::atomic<SampleShard*>& shard : shards_) {
+      SampleShard* samples_shard = shard.load(std::memory_order_acquire);
+      if (samples_shard)
+        samples_shard->AddTo(samples, clear);
+    }
+  }
+
+  const std::string name_;
   const int min_;
   const int max_;
-  SampleInfo info_ RTC_GUARDED_BY(crit_);
+  const size_t bucket_count_;
+  std::atomic<SampleShard*> shards_[kNumShards];
 
   RTC_DISALLOW_COPY_AND_ASSIGN(RtcHistogram);
 };
@@ -9,6 +9,11 @@
  */
 
 #include "system_wrappers/include/metrics_default.h"
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/platform_thread.h"
 #include "system_wrappers/include/metrics.h"
 #include "test/gtest.h"
 
@@ -47,6 +52,25 @@ int NumEvents(const std::string& name,
 
   return it_sample->second;
 }
+
+const int kNumThreads = 8;
+const int kSamplesPerThread = 10000;
+
+// Adds kSamplesPerThread samples, spread over the values 1 to 100.
+void AddSamples(void* obj) {
+  for (int i = 0; i < kSamplesPerThread; ++i)
+    RTC_HISTOGRAM_PERCENTAGE("Concurrent", 1 + i % 100);
+}
+
+std::vector<std::unique_ptr<rtc::PlatformThread>> StartAddingSamples() {
+  std::vector<std::unique_ptr<rtc::PlatformThread>> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back(
+        new rtc::PlatformThread(&AddSamples, nullptr, "AddSamples"));
+    threads.back()->Start();
+  }
+  return threads;
+}
 }  // namespace
 
 class MetricsDefaultTest : public ::testing::Test {
@@ -158,4 +182,31 @@ TEST_F(MetricsDefaultTest, TestMinMaxBucket) {
   EXPECT_EQ(1u, histograms.begin()->second->samples.size());
 }
 
+TEST_F(MetricsDefaultTest, ConcurrentAdds) {
+  for (auto& thread : StartAddingSamples())
+    thread->Stop();
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, metrics::NumSamples("Concurrent"));
+  EXPECT_EQ(kNumThreads * kSamplesPerThread / 100,
+            metrics::NumEvents("Concurrent", 1));
+  EXPECT_EQ(kNumThreads * kSamplesPerThread / 100,
+            metrics::NumEvents("Concurrent", 100));
+  EXPECT_EQ(1, metrics::MinSample("Concurrent"));
+}
+
+TEST_F(MetricsDefaultTest, GetAndResetWhileAdding) {
+  std::map<std::string, std::unique_ptr<metrics::SampleInfo>> histograms;
+  int num_samples = 0;
+  auto threads = StartAddingSamples();
+  for (int i = 0; i < 100; ++i) {
+    metrics::GetAndReset(&histograms);
+    num_samples += NumSamples("Concurrent", histograms);
+  }
+  for (auto& thread : threads)
+    thread->Stop();
+  metrics::GetAndReset(&histograms);
+  num_samples += NumSamples("Concurrent", histograms);
+  // No sample is lost or counted twice.
+  EXPECT_EQ(kNumThreads * kSamplesPerThread, num_samples);
+}
+
 }  // namespace webrtc
@@ -80,8 +80,9 @@ class FuzzyPacketBuffer : public video_coding::PacketBuffer {
     return packet;
   }
 
-  bool GetBitstream(const video_coding::RtpFrameObject& frame,
-                    uint8_t* destination) override {
+  bool TakeBitstream(
+      const video_coding::RtpFrameObject& frame,
+      std::vector<rtc::ArrayView<const uint8_t>>* segments) override {
     return true;
   }
 
@@ -0,0 +1,46 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef TEST_MICROBENCHMARKS_MICROBENCHMARK_H_
+#define TEST_MICROBENCHMARKS_MICROBENCHMARK_H_
+
+#include <string>
+#include <vector>
+
+#include "rtc_base/timeutils.h"
+#include "test/testsupport/perf_test.h"
+
+namespace webrtc {
+namespace test {
+
+// Calls |function| |iterations| times in each of a number of batches, and
+// reports the time per call of every batch under |name|, in nanoseconds, with
+// PrintResultHistogram(). The first batch only warms up the caches.
+template <typename Function>
+void RunMicrobenchmark(const std::string& name,
+                       int iterations,
+                       Function function) {
+  constexpr int kNumBatches = 21;
+  std::vector<double> ns_per_call;
+  for (int batch = 0; batch < kNumBatches; ++batch) {
+    const int64_t start_ns = rtc::TimeNanos();
+    for (int i = 0; i < iterations; ++i)
+      function();
+    const int64_t elapsed_ns = rtc::TimeNanos() - start_ns;
+    if (batch > 0)
+      ns_per_call.push_back(static_cast<double>(elapsed_ns) / iterations);
+  }
+  PrintResultHistogram("microbenchmark", "", name, ns_per_call, "ns", false);
+}
+
+}  // namespace test
+}  // namespace webrtc
+
+#endif  // TEST_MICROBENCHMARKS_MICROBENCHMARK_H_
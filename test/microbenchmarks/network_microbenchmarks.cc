@@ -0,0 +1,120 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "p2p/base/stun.h"
+#include "pc/srtpsession.h"
+#include "rtc_base/bytebuffer.h"
+#include "rtc_base/byteorder.h"
+#include "rtc_base/checks.h"
+#include "rtc_base/sslstreamadapter.h"
+#include "test/gtest.h"
+#include "test/microbenchmarks/microbenchmark.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kSsrc = 0x12345678;
+constexpr int kRtpHeaderSize = 12;
+constexpr int kRtpPacketSize = 1012;
+constexpr int kIterations = 10000;
+// 128 bit key and 112 bit salt.
+const uint8_t kSrtpKey[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ1234";
+constexpr size_t kSrtpKeyLen = 30;
+const char kStunPassword[] = "passwordpasswordpassword";
+
+// Writes an RTP packet with |sequence_number| and a fixed payload to
+// |packet|, which must have room for kRtpPacketSize bytes.
+void WriteRtpPacket(uint16_t sequence_number, uint8_t* packet) {
+  memset(packet, 0, kRtpHeaderSize);
+  packet[0] = 0x80;
+  packet[1] = 96;
+  rtc::SetBE16(packet + 2, sequence_number);
+  rtc::SetBE32(packet + 4, sequence_number * 3000u);
+  rtc::SetBE32(packet + 8, kSsrc);
+  memset(packet + kRtpHeaderSize, 0x5a, kRtpPacketSize - kRtpHeaderSize);
+}
+
+void CreateBindingRequest(cricket::StunMessage* message) {
+  message->SetType(cricket::STUN_BINDING_REQUEST);
+  message->SetTransactionID("0123456789ab");
+  auto username =
+      cricket::StunAttribute::CreateByteString(cricket::STUN_ATTR_USERNAME);
+  username->CopyBytes("remoteufrag:localufrag");
+  message->AddAttribute(std::move(username));
+  auto priority =
+      cricket::StunAttribute::CreateUInt32(cricket::STUN_ATTR_PRIORITY);
+  priority->SetValue(0x6e7f1eff);
+  message->AddAttribute(std::move(priority));
+  RTC_CHECK(message->AddMessageIntegrity(kStunPassword));
+  RTC_CHECK(message->AddFingerprint());
+}
+
+}  // namespace
+
+// Sent packets must not be replayed, so unprotection is measured together
+// with the protection of the packet.
+TEST(NetworkMicrobenchmark, SrtpSessionProtectAndUnprotect) {
+  cricket::SrtpSession send_session;
+  cricket::SrtpSession recv_session;
+  ASSERT_TRUE(send_session.SetSend(rtc::SRTP_AES128_CM_SHA1_80,
+                                   kSrtpKey, kSrtpKeyLen,
+                                   std::vector<int>()));
+  ASSERT_TRUE(recv_session.SetRecv(rtc::SRTP_AES128_CM_SHA1_80,
+                                   kSrtpKey, kSrtpKeyLen,
+                                   std::vector<int>()));
+  uint8_t packet[kRtpPacketSize + 16];
+  uint16_t sequence_number = 0;
+  test::RunMicrobenchmark("SrtpSession_ProtectRtp", kIterations, [&] {
+    WriteRtpPacket(sequence_number++, packet);
+    int out_len;
+    RTC_CHECK(send_session.ProtectRtp(packet, kRtpPacketSize, sizeof(packet),
+                                      &out_len));
+  });
+
+  test::RunMicrobenchmark("SrtpSession_ProtectAndUnprotectRtp", kIterations,
+                          [&] {
+    WriteRtpPacket(sequence_number++, packet);
+    int out_len;
+    RTC_CHECK(send_session.ProtectRtp(packet, kRtpPacketSize, sizeof(packet),
+                                      &out_len));
+    RTC_CHECK(recv_session.UnprotectRtp(packet, out_len, &out_len));
+  });
+}
+
+TEST(NetworkMicrobenchmark, StunMessageWriteAndRead) {
+  cricket::StunMessage message;
+  CreateBindingRequest(&message);
+  test::RunMicrobenchmark("StunMessage_Write", kIterations, [&] {
+    rtc::ByteBufferWriter buffer;
+    RTC_CHECK(message.Write(&buffer));
+  });
+
+  rtc::ByteBufferWriter written;
+  ASSERT_TRUE(message.Write(&written));
+  test::RunMicrobenchmark("StunMessage_Read", kIterations, [&] {
+    rtc::ByteBufferReader buffer(written.Data(), written.Length());
+    cricket::StunMessage read_message;
+    RTC_CHECK(read_message.Read(&buffer));
+  });
+
+  test::RunMicrobenchmark("StunMessage_ValidateMessageIntegrity", kIterations,
+                          [&] {
+    RTC_CHECK(cricket::StunMessage::ValidateMessageIntegrity(
+        written.Data(), written.Length(), kStunPassword));
+  });
+}
+
+}  // namespace webrtc
@@ -0,0 +1,55 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/copyonwritebuffer.h"
+#include "rtc_base/messagequeue.h"
+#include "rtc_base/nullsocketserver.h"
+#include "test/gtest.h"
+#include "test/microbenchmarks/microbenchmark.h"
+
+namespace webrtc {
+namespace {
+
+constexpr size_t kPacketSize = 1200;
+constexpr int kIterations = 100000;
+
+}  // namespace
+
+TEST(RtcBaseMicrobenchmark, CopyOnWriteBufferCopy) {
+  uint8_t data[kPacketSize];
+  memset(data, 0x5a, sizeof(data));
+  const rtc::CopyOnWriteBuffer buffer(data, sizeof(data));
+  test::RunMicrobenchmark("CopyOnWriteBuffer_Copy", kIterations, [&] {
+    rtc::CopyOnWriteBuffer copy(buffer);
+    RTC_CHECK_EQ(kPacketSize, copy.size());
+  });
+
+  // Writing to a shared buffer makes a private copy of the data.
+  test::RunMicrobenchmark("CopyOnWriteBuffer_CopyAndWrite", kIterations, [&] {
+    rtc::CopyOnWriteBuffer copy(buffer);
+    copy.data()[0] = 0;
+  });
+}
+
+TEST(RtcBaseMicrobenchmark, MessageQueuePostAndGet) {
+  rtc::NullSocketServer socket_server;
+  rtc::MessageQueue queue(&socket_server, false);
+  uint32_t id = 0;
+  test::RunMicrobenchmark("MessageQueue_PostAndGet", kIterations, [&] {
+    queue.Post(RTC_FROM_HERE, nullptr, id++);
+    rtc::Message message;
+    RTC_CHECK(queue.Get(&message, 0));
+  });
+}
+
+}  // namespace webrtc
@@ -0,0 +1,189 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <string.h>
+
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "call/rtp_demuxer.h"
+#include "call/rtp_packet_sink_interface.h"
+#include "modules/include/module_fec_types.h"
+#include "modules/rtp_rtcp/include/rtp_header_extension_map.h"
+#include "modules/rtp_rtcp/source/forward_error_correction.h"
+#include "modules/rtp_rtcp/source/rtcp_packet/transport_feedback.h"
+#include "modules/rtp_rtcp/source/rtp_header_extensions.h"
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "modules/rtp_rtcp/source/rtp_packet_to_send.h"
+#include "rtc_base/checks.h"
+#include "test/gtest.h"
+#include "test/microbenchmarks/microbenchmark.h"
+
+namespace webrtc {
+namespace {
+
+constexpr uint32_t kSsrc = 0x12345678;
+constexpr uint8_t kPayloadType = 96;
+constexpr int kTransportSequenceNumberId = 3;
+constexpr int kAbsoluteSendTimeId = 4;
+constexpr size_t kPayloadSize = 1000;
+constexpr int kIterations = 10000;
+
+RtpHeaderExtensionMap CreateExtensions() {
+  RtpHeaderExtensionMap extensions;
+  extensions.Register<TransportSequenceNumber>(kTransportSequenceNumberId);
+  extensions.Register<AbsoluteSendTime>(kAbsoluteSendTimeId);
+  return extensions;
+}
+
+void BuildPacket(uint32_t ssrc,
+                 uint16_t sequence_number,
+                 RtpPacketToSend* packet) {
+  packet->SetPayloadType(kPayloadType);
+  packet->SetSequenceNumber(sequence_number);
+  packet->SetTimestamp(sequence_number * 3000u);
+  packet->SetSsrc(ssrc);
+  packet->SetExtension<TransportSequenceNumber>(sequence_number);
+  packet->SetExtension<AbsoluteSendTime>(sequence_number);
+  uint8_t* payload = packet->AllocatePayload(kPayloadSize);
+  memset(payload, sequence_number & 0xff, kPayloadSize);
+}
+
+class NullSink : public RtpPacketSinkInterface {
+ public:
+  void OnRtpPacket(const RtpPacketReceived& packet) override {}
+};
+
+}  // namespace
+
+TEST(RtpMicrobenchmark, RtpPacketToSendBuild) {
+  const RtpHeaderExtensionMap extensions = CreateExtensions();
+  uint16_t sequence_number = 0;
+  test::RunMicrobenchmark("RtpPacketToSend_Build", kIterations, [&] {
+    RtpPacketToSend packet(&extensions);
+    BuildPacket(kSsrc, sequence_number++, &packet);
+  });
+}
+
+TEST(RtpMicrobenchmark, RtpPacketParse) {
+  const RtpHeaderExtensionMap extensions = CreateExtensions();
+  RtpPacketToSend packet(&extensions);
+  BuildPacket(kSsrc, 1, &packet);
+  RtpPacketReceived received(&extensions);
+  test::RunMicrobenchmark("RtpPacket_Parse", kIterations, [&] {
+    RTC_CHECK(received.Parse(packet.data(), packet.size()));
+  });
+}
+
+TEST(RtpMicrobenchmark, RtpDemuxerLookup) {
+  constexpr size_t kNumStreams = 32;
+  const RtpHeaderExtensionMap extensions = CreateExtensions();
+  NullSink sinks[kNumStreams];
+  RtpDemuxer demuxer;
+  std::vector<RtpPacketReceived> packets;
+  for (size_t i = 0; i < kNumStreams; ++i) {
+    const uint32_t ssrc = kSsrc + static_cast<uint32_t>(i);
+    ASSERT_TRUE(demuxer.AddSink(ssrc, &sinks[i]));
+    RtpPacketToSend packet(&extensions);
+    BuildPacket(ssrc, 1, &packet);
+    packets.emplace_back(&extensions);
+    ASSERT_TRUE(packets.back().Parse(packet.data(), packet.size()));
+  }
+  size_t index = 0;
+  test::RunMicrobenchmark("RtpDemuxer_OnRtpPacket", kIterations, [&] {
+    RTC_CHECK(demuxer.OnRtpPacket(packets[index++ % kNumStreams]));
+  });
+}
+
+TEST(RtpMicrobenchmark, TransportFeedbackBuildAndParse) {
+  constexpr uint16_t kNumPackets = 100;
+  auto build = [] {
+    rtcp::TransportFeedback feedback;
+    feedback.SetSenderSsrc(kSsrc);
+    feedback.SetMediaSsrc(kSsrc + 1);
+    feedback.SetBase(0, 0);
+    for (uint16_t i = 0; i < kNumPackets; ++i) {
+      // Every tenth packet is lost.
+      if (i % 10 != 9)
+        RTC_CHECK(feedback.AddReceivedPacket(i, i * 2000));
+    }
+    return feedback.Build();
+  };
+  test::RunMicrobenchmark("TransportFeedback_Build", kIterations / 10,
+                          [&] { build(); });
+
+  const rtc::Buffer buffer = build();
+  test::RunMicrobenchmark("TransportFeedback_Parse", kIterations / 10, [&] {
+    RTC_CHECK(rtcp::TransportFeedback::ParseFrom(buffer.data(), buffer.size()));
+  });
+}
+
+TEST(RtpMicrobenchmark, UlpfecEncodeAndDecode) {
+  constexpr int kNumMediaPackets = 10;
+  constexpr uint8_t kProtectionFactor = 85;
+  const RtpHeaderExtensionMap extensions = CreateExtensions();
+  ForwardErrorCorrection::PacketList media_packets;
+  for (int i = 0; i < kNumMediaPackets; ++i) {
+    RtpPacketToSend packet(&extensions);
+    BuildPacket(kSsrc, i, &packet);
+    std::unique_ptr<ForwardErrorCorrection::Packet> media_packet(
+        new ForwardErrorCorrection::Packet());
+    media_packet->length = packet.size();
+    memcpy(media_packet->data, packet.data(), packet.size());
+    media_packets.push_back(std::move(media_packet));
+  }
+
+  std::unique_ptr<ForwardErrorCorrection> fec =
+      ForwardErrorCorrection::CreateUlpfec(kSsrc);
+  std::list<ForwardErrorCorrection::Packet*> fec_packets;
+  test::RunMicrobenchmark("ForwardErrorCorrection_EncodeFec",
+                          kIterations / 10, [&] {
+    fec_packets.clear();
+    RTC_CHECK_EQ(0, fec->EncodeFec(media_packets, kProtectionFactor, 0, false,
+                                   kFecMaskBursty, &fec_packets));
+  });
+  ASSERT_FALSE(fec_packets.empty());
+
+  // The first media packet is lost and recovered from the FEC packets, which
+  // follow the media packets in sequence number order.
+  std::vector<std::unique_ptr<ForwardErrorCorrection::ReceivedPacket>>
+      received_packets;
+  uint16_t sequence_number = 1;
+  auto add_received_packet = [&](const ForwardErrorCorrection::Packet& packet,
+                                 bool is_fec) {
+    std::unique_ptr<ForwardErrorCorrection::ReceivedPacket> received_packet(
+        new ForwardErrorCorrection::ReceivedPacket());
+    received_packet->pkt = new ForwardErrorCorrection::Packet();
+    received_packet->pkt->length = packet.length;
+    memcpy(received_packet->pkt->data, packet.data, packet.length);
+    received_packet->is_fec = is_fec;
+    received_packet->ssrc = kSsrc;
+    received_packet->seq_num = sequence_number++;
+    received_packets.push_back(std::move(received_packet));
+  };
+  for (auto it = ++media_packets.begin(); it != media_packets.end(); ++it)
+    add_received_packet(**it, false);
+  for (const ForwardErrorCorrection::Packet* fec_packet : fec_packets)
+    add_received_packet(*fec_packet, true);
+
+  std::unique_ptr<ForwardErrorCorrection> fec_decoder =
+      ForwardErrorCorrection::CreateUlpfec(kSsrc);
+  ForwardErrorCorrection::RecoveredPacketList recovered_packets;
+  test::RunMicrobenchmark("ForwardErrorCorrection_DecodeFec",
+                          kIterations / 10, [&] {
+    fec_decoder->ResetState(&recovered_packets);
+    for (const auto& received_packet : received_packets)
+      fec_decoder->DecodeFec(*received_packet, &recovered_packets);
+  });
+  EXPECT_EQ(static_cast<size_t>(kNumMediaPackets), recovered_packets.size());
+}
+
+}  // namespace webrtc
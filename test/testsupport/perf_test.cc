@@ -12,6 +12,8 @@
 #include "rtc_base/criticalsection.h"
 
 #include <stdio.h>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <map>
 #include <sstream>
@@ -28,6 +30,12 @@ void OutputListToStream(std::ostream* ostream, const Container& values) {
   }
 }
 
+// |sorted_values| must not be empty.
+double Percentile(const std::vector<double>& sorted_values, int percent) {
+  const size_t index = (sorted_values.size() - 1) * percent / 100;
+  return sorted_values[index];
+}
+
 class PerfResultsLogger {
  public:
   PerfResultsLogger() : crit_(), output_(stdout), graphs_() {}
@@ -100,6 +108,47 @@ class PerfResultsLogger {
     rtc::CritScope lock(&crit_);
     graphs_[graph_name].push_back(json_stream.str());
   }
+  void LogResultHistogram(const std::string& graph_name,
+                          const std::string& trace_name,
+                          const rtc::ArrayView<const double> values,
+                          const std::string& units,
+                          const bool important) {
+    double mean = 0.0;
+    double std_dev = 0.0;
+    if (!values.empty()) {
+      for (double value : values)
+        mean += value;
+      mean /= values.size();
+      for (double value : values)
+        std_dev += (value - mean) * (value - mean);
+      std_dev = std::sqrt(std_dev / values.size());
+    }
+    std::ostringstream value_stream;
+    value_stream.precision(8);
+    value_stream << '{' << mean << ',' << std_dev << '}';
+    LogResultsImpl(graph_name, trace_name, value_stream.str(), units,
+                   important);
+
+    std::ostringstream json_stream;
+    json_stream.precision(8);
+    json_stream << '"' << trace_name << R"(":{)";
+    json_stream << R"("type":"list_of_scalar_values",)";
+    json_stream << R"("values":[)";
+    OutputListToStream(&json_stream, values);
+    json_stream << "],";
+    json_stream << R"("std":)" << std_dev << ',';
+    if (!values.empty()) {
+      std::vector<double> sorted_values(values.begin(), values.end());
+      std::sort(sorted_values.begin(), sorted_values.end());
+      json_stream << R"("percentiles":{)";
+      json_stream << R"("p50":)" << Percentile(sorted_values, 50) << ',';
+      json_stream << R"("p90":)" << Percentile(sorted_values, 90) << ',';
+      json_stream << R"("p99":)" << Percentile(sorted_values, 99) << "},";
+    }
+    json_stream << R"("units":")" << units << R"("})";
+    rtc::CritScope lock(&crit_);
+    graphs_[graph_name].push_back(json_stream.str());
+  }
   std::string ToJSON() const;
 
  private:
@@ -205,5 +254,15 @@ void PrintResultList(const std::string& measurement,
                                        units, important);
 }
 
+void PrintResultHistogram(const std::string& measurement,
+                          const std::string& modifier,
+                          const std::string& trace,
+                          const rtc::ArrayView<const double> values,
+                          const std::string& units,
+                          bool important) {
+  GetPerfResultsLogger().LogResultHistogram(measurement + modifier, trace,
+                                            values, units, important);
+}
+
 }  // namespace test
 }  // namespace webrtc
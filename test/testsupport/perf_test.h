@@ -61,6 +61,18 @@ void PrintResultList(const std::string& measurement,
                      const std::string& units,
                      bool important);
 
+// Like PrintResultList(), but the |values| are samples of a single quantity,
+// e.g. the time of each processed frame. Only their mean and standard
+// deviation are printed, but the JSON keeps every sample, together with the
+// 50th, 90th and 99th percentiles, so that the results of two builds can be
+// compared statistically with rtc_tools/compare_perf_results.py.
+void PrintResultHistogram(const std::string& measurement,
+                          const std::string& modifier,
+                          const std::string& trace,
+                          rtc::ArrayView<const double> values,
+                          const std::string& units,
+                          bool important);
+
 // Returns all perf results to date in a JSON string formatted as described in
 // https://github.com/catapult-project/catapult/blob/master/dashboard/docs/data-format.md
 std::string GetPerfResultsJSON();
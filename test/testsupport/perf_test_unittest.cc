@@ -35,6 +35,13 @@ const char* kJsonExpected = R"({
         "type":"list_of_scalar_values",
         "values":[1,2,3],
         "units":"units"
+      },
+      "baz_h":{
+        "type":"list_of_scalar_values",
+        "values":[4,1,3,2],
+        "std":1.118034,
+        "percentiles":{"p50":2,"p90":3,"p99":3},
+        "units":"ms"
       }
     },
     "measurementmodifier":{
@@ -88,6 +95,10 @@ TEST_F(PerfTest, MAYBE_TestPrintResult) {
   expected += "RESULT foobar: baz_vl= [1,2,3] units\n";
   PrintResultList("foo", "bar", "baz_vl", kListOfScalars, "units", false);
 
+  const double kSamples[] = {4, 1, 3, 2};
+  expected += "RESULT foobar: baz_h= {2.5,1.118034} ms\n";
+  PrintResultHistogram("foo", "bar", "baz_h", kSamples, "ms", false);
+
   EXPECT_EQ(expected, testing::internal::GetCapturedStdout());
 }
 
@@ -97,6 +108,8 @@ TEST_F(PerfTest, TestGetPerfResultsJSON) {
   PrintResultMeanAndError("foo", "bar", "baz_me", 1, 2, "lemurs", false);
   const double kListOfScalars[] = {1, 2, 3};
   PrintResultList("foo", "bar", "baz_vl", kListOfScalars, "units", false);
+  const double kSamples[] = {4, 1, 3, 2};
+  PrintResultHistogram("foo", "bar", "baz_h", kSamples, "ms", false);
 
   EXPECT_EQ(RemoveSpaces(kJsonExpected), GetPerfResultsJSON());
 }
@@ -57,7 +57,8 @@
 
 // TODO(zhongwei.yao): WEBRTC_CPU_DETECTION is only used in one place; we should
 // probably just remove it.
-#if (defined(WEBRTC_ARCH_X86_FAMILY) && !defined(__SSE2__))
+// Always defined on x86, where AVX2 support is only known at run time.
+#if defined(WEBRTC_ARCH_X86_FAMILY)
 #define WEBRTC_CPU_DETECTION
 #endif
 
@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/encoder_complexity_ladder.h"
+
+#include <algorithm>
+
+#include "rtc_base/checks.h"
+
+namespace webrtc {
+
+namespace {
+const float kSavingFilterAlpha = 0.5f;
+// A step that saves less than this fraction of the encode usage is not worth
+// the loss of compression efficiency.
+const float kMinEffectiveSaving = 0.05f;
+
+bool IsLibvpx(const VideoCodec& codec) {
+  return codec.codecType == kVideoCodecVP8 || codec.codecType == kVideoCodecVP9;
+}
+
+bool DenoiserEnabled(const VideoCodec& codec) {
+  if (codec.codecType == kVideoCodecVP8)
+    return codec.VP8().denoisingOn;
+  if (codec.codecType == kVideoCodecVP9)
+    return codec.VP9().denoisingOn;
+  return false;
+}
+}  // namespace
+
+EncoderComplexityLadder::EncoderComplexityLadder()
+    : saving_{rtc::ExpFilter(kSavingFilterAlpha),
+              rtc::ExpFilter(kSavingFilterAlpha)},
+      usage_percent_before_step_(0) {
+  std::fill(applicable_, applicable_ + kNumSteps, false);
+}
+
+EncoderComplexityLadder::~EncoderComplexityLadder() = default;
+
+void EncoderComplexityLadder::ConfigureCodec(VideoCodec* codec) {
+  applicable_[kAdaptiveSpeed] =
+      IsLibvpx(*codec) && !codec->performance_profile.adaptive_speed;
+  applicable_[kDisableDenoiser] = DenoiserEnabled(*codec);
+
+  // Steps that no longer apply, e.g. after a codec switch, are dropped.
+  active_.erase(
+      std::remove_if(active_.begin(), active_.end(),
+                     [this](Step step) { return !applicable_[step]; }),
+      active_.end());
+  if (unmeasured_step_ && !applicable_[*unmeasured_step_])
+    unmeasured_step_.reset();
+
+  for (Step step : active_) {
+    switch (step) {
+      case kAdaptiveSpeed:
+        codec->performance_profile.adaptive_speed = true;
+        break;
+      case kDisableDenoiser:
+        if (codec->codecType == kVideoCodecVP8)
+          codec->VP8()->denoisingOn = false;
+        else
+          codec->VP9()->denoisingOn = false;
+        break;
+      case kNumSteps:
+        RTC_NOTREACHED();
+    }
+  }
+}
+
+bool EncoderComplexityLadder::StepDown(int usage_percent) {
+  UpdateCostModel(usage_percent);
+  // A step that turned out not to help only costs compression efficiency.
+  if (!active_.empty() && !IsEffective(active_.back()))
+    active_.pop_back();
+
+  for (int i = 0; i < kNumSteps; ++i) {
+    const Step step = static_cast<Step>(i);
+    if (!applicable_[step] || IsActive(step) || !IsEffective(step))
+      continue;
+    active_.push_back(step);
+    unmeasured_step_ = step;
+    usage_percent_before_step_ = usage_percent;
+    return true;
+  }
+  return false;
+}
+
+bool EncoderComplexityLadder::StepUp(int usage_percent) {
+  UpdateCostModel(usage_percent);
+  if (active_.empty())
+    return false;
+  active_.pop_back();
+  return true;
+}
+
+bool EncoderComplexityLadder::IsActive(Step step) const {
+  return std::find(active_.begin(), active_.end(), step) != active_.end();
+}
+
+rtc::Optional<float> EncoderComplexityLadder::EstimatedSaving(
+    Step step) const {
+  if (saving_[step].filtered() == rtc::ExpFilter::kValueUndefined)
+    return rtc::nullopt;
+  return saving_[step].filtered();
+}
+
+void EncoderComplexityLadder::UpdateCostModel(int usage_percent) {
+  if (!unmeasured_step_)
+    return;
+  if (usage_percent_before_step_ > 0 && IsActive(*unmeasured_step_)) {
+    // Higher usage after a step comes from elsewhere, e.g. more motion.
+    const float saving = std::max(
+        0.0f, static_cast<float>(usage_percent_before_step_ - usage_percent) /
+                  usage_percent_before_step_);
+    saving_[*unmeasured_step_].Apply(1.0f, saving);
+  }
+  unmeasured_step_.reset();
+}
+
+bool EncoderComplexityLadder::IsEffective(Step step) const {
+  rtc::Optional<float> saving = EstimatedSaving(step);
+  // Untried steps are assumed to help.
+  return !saving || *saving >= kMinEffectiveSaving;
+}
+
+}  // namespace webrtc
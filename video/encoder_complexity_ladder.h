@@ -0,0 +1,74 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_ENCODER_COMPLEXITY_LADDER_H_
+#define VIDEO_ENCODER_COMPLEXITY_LADDER_H_
+
+#include <vector>
+
+#include "api/optional.h"
+#include "common_types.h"  // NOLINT(build/include)
+#include "rtc_base/numerics/exp_filter.h"
+
+namespace webrtc {
+
+// Encoder settings that CPU adaptation goes through before it reduces
+// resolution or framerate. Each step trades some compression efficiency for
+// encode time, which usually costs less quality than fewer pixels.
+// The ladder learns online how much each step saves, by comparing the encode
+// usage reported by OveruseFrameDetector before and after the step, and it
+// skips steps that did not pay off.
+class EncoderComplexityLadder {
+ public:
+  enum Step {
+    // Let the encoder raise its speed preset, see
+    // VideoCodec::PerformanceProfile::adaptive_speed.
+    kAdaptiveSpeed = 0,
+    kDisableDenoiser,
+    kNumSteps
+  };
+
+  EncoderComplexityLadder();
+  ~EncoderComplexityLadder();
+
+  // Records which steps apply to a newly set up |codec|, and applies the
+  // active ones to it. Must be called for every encoder configuration.
+  void ConfigureCodec(VideoCodec* codec);
+
+  // Activates the next applicable step that is not known to be ineffective.
+  // |usage_percent| is the current encode usage. Returns false if there is
+  // no such step left, and resolution or framerate should be reduced instead.
+  bool StepDown(int usage_percent);
+  // Deactivates the most recently activated step. Returns false if no step
+  // is active.
+  bool StepUp(int usage_percent);
+
+  int num_active_steps() const { return static_cast<int>(active_.size()); }
+  bool IsActive(Step step) const;
+  // Filtered fraction of the encode usage that |step| saved, or nullopt if
+  // the step has not been measured yet.
+  rtc::Optional<float> EstimatedSaving(Step step) const;
+
+ private:
+  void UpdateCostModel(int usage_percent);
+  bool IsEffective(Step step) const;
+
+  bool applicable_[kNumSteps];
+  // In the order they were activated.
+  std::vector<Step> active_;
+  rtc::ExpFilter saving_[kNumSteps];
+  // The last activated step, while its saving has not been measured.
+  rtc::Optional<Step> unmeasured_step_;
+  int usage_percent_before_step_;
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_ENCODER_COMPLEXITY_LADDER_H_
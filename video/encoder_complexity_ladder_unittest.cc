@@ -0,0 +1,124 @@
+/*
+ *  Copyright (c) 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/encoder_complexity_ladder.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+const int kHighUsagePercent = 90;
+const int kLowUsagePercent = 40;
+
+VideoCodec Vp8Codec(bool denoising) {
+  VideoCodec codec;
+  codec.codecType = kVideoCodecVP8;
+  codec.VP8()->denoisingOn = denoising;
+  return codec;
+}
+}  // namespace
+
+TEST(EncoderComplexityLadderTest, StepsThroughApplicableSettings) {
+  EncoderComplexityLadder ladder;
+  VideoCodec codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+
+  EXPECT_TRUE(ladder.StepDown(kHighUsagePercent));
+  codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+  EXPECT_TRUE(codec.performance_profile.adaptive_speed);
+  EXPECT_TRUE(codec.VP8()->denoisingOn);
+
+  EXPECT_TRUE(ladder.StepDown(kHighUsagePercent - 20));
+  codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+  EXPECT_TRUE(codec.performance_profile.adaptive_speed);
+  EXPECT_FALSE(codec.VP8()->denoisingOn);
+
+  // Nothing left, resolution or framerate has to be reduced.
+  EXPECT_FALSE(ladder.StepDown(kHighUsagePercent - 30));
+  EXPECT_EQ(2, ladder.num_active_steps());
+
+  EXPECT_TRUE(ladder.StepUp(kLowUsagePercent));
+  codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+  EXPECT_TRUE(codec.performance_profile.adaptive_speed);
+  EXPECT_TRUE(codec.VP8()->denoisingOn);
+  EXPECT_TRUE(ladder.StepUp(kLowUsagePercent));
+  EXPECT_FALSE(ladder.StepUp(kLowUsagePercent));
+  EXPECT_EQ(0, ladder.num_active_steps());
+}
+
+TEST(EncoderComplexityLadderTest, SkipsStepsThatDoNotApply) {
+  EncoderComplexityLadder ladder;
+  VideoCodec codec = Vp8Codec(false);
+  codec.performance_profile.adaptive_speed = true;
+  ladder.ConfigureCodec(&codec);
+  EXPECT_FALSE(ladder.StepDown(kHighUsagePercent));
+
+  VideoCodec h264;
+  h264.codecType = kVideoCodecH264;
+  ladder.ConfigureCodec(&h264);
+  EXPECT_FALSE(ladder.StepDown(kHighUsagePercent));
+}
+
+TEST(EncoderComplexityLadderTest, DropsActiveStepsAfterCodecChange) {
+  EncoderComplexityLadder ladder;
+  VideoCodec codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+  EXPECT_TRUE(ladder.StepDown(kHighUsagePercent));
+
+  VideoCodec h264;
+  h264.codecType = kVideoCodecH264;
+  ladder.ConfigureCodec(&h264);
+  EXPECT_EQ(0, ladder.num_active_steps());
+  EXPECT_FALSE(ladder.StepUp(kLowUsagePercent));
+}
+
+TEST(EncoderComplexityLadderTest, LearnsSavingOfEachStep) {
+  EncoderComplexityLadder ladder;
+  VideoCodec codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+  EXPECT_FALSE(ladder.EstimatedSaving(EncoderComplexityLadder::kAdaptiveSpeed));
+
+  EXPECT_TRUE(ladder.StepDown(100));
+  // Usage is measured at the next adaptation.
+  EXPECT_TRUE(ladder.StepUp(75));
+  rtc::Optional<float> saving =
+      ladder.EstimatedSaving(EncoderComplexityLadder::kAdaptiveSpeed);
+  ASSERT_TRUE(saving);
+  EXPECT_FLOAT_EQ(0.25f, *saving);
+  EXPECT_FALSE(
+      ladder.EstimatedSaving(EncoderComplexityLadder::kDisableDenoiser));
+}
+
+TEST(EncoderComplexityLadderTest, SkipsIneffectiveSteps) {
+  EncoderComplexityLadder ladder;
+  VideoCodec codec = Vp8Codec(true);
+  ladder.ConfigureCodec(&codec);
+
+  // The first step does not reduce the usage, so the next step down replaces
+  // it with the denoiser step.
+  EXPECT_TRUE(ladder.StepDown(kHighUsagePercent));
+  EXPECT_TRUE(ladder.StepDown(kHighUsagePercent));
+  EXPECT_EQ(1, ladder.num_active_steps());
+  EXPECT_FALSE(ladder.IsActive(EncoderComplexityLadder::kAdaptiveSpeed));
+  EXPECT_TRUE(ladder.IsActive(EncoderComplexityLadder::kDisableDenoiser));
+
+  EXPECT_TRUE(ladder.StepUp(kLowUsagePercent));
+  // The ineffective step is not retried.
+  EXPECT_TRUE(ladder.StepDown(kHighUsagePercent));
+  EXPECT_TRUE(ladder.IsActive(EncoderComplexityLadder::kDisableDenoiser));
+  EXPECT_FALSE(ladder.StepDown(kHighUsagePercent - 20));
+  EXPECT_EQ(1, ladder.num_active_steps());
+}
+
+}  // namespace webrtc
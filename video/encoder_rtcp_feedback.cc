@@ -11,20 +11,36 @@
 #include "video/encoder_rtcp_feedback.h"
 
 #include "rtc_base/checks.h"
+#include "system_wrappers/include/metrics.h"
 #include "video/video_stream_encoder.h"
 
-static const int kMinKeyFrameRequestIntervalMs = 300;
-
 namespace webrtc {
 
-EncoderRtcpFeedback::EncoderRtcpFeedback(Clock* clock,
-                                         const std::vector<uint32_t>& ssrcs,
-                                         VideoStreamEncoderInterface* encoder)
+const int64_t EncoderRtcpFeedback::kDefaultMinKeyFrameRequestIntervalMs;
+
+EncoderRtcpFeedback::EncoderRtcpFeedback(
+    Clock* clock,
+    const std::vector<uint32_t>& ssrcs,
+    VideoStreamEncoderInterface* encoder,
+    int64_t min_keyframe_request_interval_ms)
     : clock_(clock),
       ssrcs_(ssrcs),
       video_stream_encoder_(encoder),
-      time_last_intra_request_ms_(ssrcs.size(), -1) {
+      min_keyframe_request_interval_ms_(min_keyframe_request_interval_ms),
+      time_last_intra_request_ms_(-1),
+      num_intra_requests_(0),
+      num_suppressed_intra_requests_(0) {
   RTC_DCHECK(!ssrcs.empty());
+  RTC_DCHECK_GE(min_keyframe_request_interval_ms, 0);
+}
+
+EncoderRtcpFeedback::~EncoderRtcpFeedback() {
+  rtc::CritScope lock(&crit_);
+  if (num_intra_requests_ > 0) {
+    RTC_HISTOGRAM_PERCENTAGE(
+        "WebRTC.Video.SuppressedReceivedKeyFrameRequestsInPercent",
+        num_suppressed_intra_requests_ * 100 / num_intra_requests_);
+  }
 }
 
 bool EncoderRtcpFeedback::HasSsrc(uint32_t ssrc) {
@@ -36,28 +52,23 @@ bool EncoderRtcpFeedback::HasSsrc(uint32_t ssrc) {
   return false;
 }
 
-size_t EncoderRtcpFeedback::GetStreamIndex(uint32_t ssrc) {
-  for (size_t i = 0; i < ssrcs_.size(); ++i) {
-    if (ssrcs_[i] == ssrc)
-      return i;
-  }
-  RTC_NOTREACHED() << "Unknown ssrc " << ssrc;
-  return 0;
-}
-
 void EncoderRtcpFeedback::OnReceivedIntraFrameRequest(uint32_t ssrc) {
   RTC_DCHECK(HasSsrc(ssrc));
-  size_t index = GetStreamIndex(ssrc);
   {
     // TODO(mflodman): Move to VideoStreamEncoder after some more changes making
     // it easier to test there.
     int64_t now_ms = clock_->TimeInMilliseconds();
     rtc::CritScope lock(&crit_);
-    if (time_last_intra_request_ms_[index] + kMinKeyFrameRequestIntervalMs >
-        now_ms) {
+    ++num_intra_requests_;
+    // The keyframe is for all the streams, so one that was asked for on any
+    // of them answers the request.
+    if (time_last_intra_request_ms_ != -1 &&
+        time_last_intra_request_ms_ + min_keyframe_request_interval_ms_ >
+            now_ms) {
+      ++num_suppressed_intra_requests_;
       return;
     }
-    time_last_intra_request_ms_[index] = now_ms;
+    time_last_intra_request_ms_ = now_ms;
   }
 
   // Always produce key frame for all streams.
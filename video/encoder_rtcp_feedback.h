@@ -21,23 +21,36 @@ namespace webrtc {
 
 class VideoStreamEncoderInterface;
 
+// Asks the encoder for a keyframe when a receiver does, for all the streams
+// at once. Requests that come within |min_keyframe_request_interval_ms| of the
+// last keyframe that was asked for, on any of the streams, are dropped, since
+// a keyframe that answers them is on its way already. How many are dropped is
+// reported to UMA when the object is destroyed.
 class EncoderRtcpFeedback : public RtcpIntraFrameObserver {
  public:
+  static const int64_t kDefaultMinKeyFrameRequestIntervalMs = 300;
+
   EncoderRtcpFeedback(Clock* clock,
                       const std::vector<uint32_t>& ssrcs,
-                      VideoStreamEncoderInterface* encoder);
+                      VideoStreamEncoderInterface* encoder,
+                      int64_t min_keyframe_request_interval_ms =
+                          kDefaultMinKeyFrameRequestIntervalMs);
+  ~EncoderRtcpFeedback() override;
+
   void OnReceivedIntraFrameRequest(uint32_t ssrc) override;
 
  private:
   bool HasSsrc(uint32_t ssrc);
-  size_t GetStreamIndex(uint32_t ssrc);
 
   Clock* const clock_;
   const std::vector<uint32_t> ssrcs_;
   VideoStreamEncoderInterface* const video_stream_encoder_;
+  const int64_t min_keyframe_request_interval_ms_;
 
   rtc::CriticalSection crit_;
-  std::vector<int64_t> time_last_intra_request_ms_ RTC_GUARDED_BY(crit_);
+  int64_t time_last_intra_request_ms_ RTC_GUARDED_BY(crit_);
+  int num_intra_requests_ RTC_GUARDED_BY(crit_);
+  int num_suppressed_intra_requests_ RTC_GUARDED_BY(crit_);
 };
 
 }  // namespace webrtc
@@ -12,6 +12,7 @@
 
 #include <memory>
 
+#include "system_wrappers/include/metrics_default.h"
 #include "test/gmock.h"
 #include "test/gtest.h"
 #include "video/test/mock_video_stream_encoder.h"
@@ -57,4 +58,28 @@ TEST_F(VieKeyRequestTest, TooManyOnReceivedIntraFrameRequest) {
   encoder_rtcp_feedback_.OnReceivedIntraFrameRequest(kSsrc);
 }
 
+TEST(EncoderRtcpFeedbackTest, CoalescesRequestsForAllStreams) {
+  metrics::Reset();
+  const std::vector<uint32_t> kSsrcs = {1, 2, 3};
+  SimulatedClock clock(123456789);
+  testing::StrictMock<MockVideoStreamEncoder> encoder;
+  {
+    EncoderRtcpFeedback feedback(&clock, kSsrcs, &encoder, 1000);
+    EXPECT_CALL(encoder, SendKeyFrame()).Times(1);
+    for (uint32_t ssrc : kSsrcs)
+      feedback.OnReceivedIntraFrameRequest(ssrc);
+    clock.AdvanceTimeMilliseconds(999);
+    feedback.OnReceivedIntraFrameRequest(kSsrcs[0]);
+
+    EXPECT_CALL(encoder, SendKeyFrame()).Times(1);
+    clock.AdvanceTimeMilliseconds(1);
+    feedback.OnReceivedIntraFrameRequest(kSsrcs[1]);
+  }
+  EXPECT_EQ(1, metrics::NumSamples(
+                   "WebRTC.Video.SuppressedReceivedKeyFrameRequestsInPercent"));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.SuppressedReceivedKeyFrameRequestsInPercent",
+                   60));
+}
+
 }  // namespace webrtc
@@ -0,0 +1,53 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/keyframe_packet_cache.h"
+
+#include <algorithm>
+
+namespace webrtc {
+
+KeyframePacketCache::KeyframePacketCache(size_t max_size_bytes)
+    : max_size_bytes_(max_size_bytes) {}
+
+KeyframePacketCache::~KeyframePacketCache() = default;
+
+void KeyframePacketCache::Insert(const RtpPacketReceived& packet,
+                                 bool starts_keyframe) {
+  if (starts_keyframe) {
+    // Keep what has arrived of the keyframe already.
+    const uint32_t timestamp = packet.Timestamp();
+    packets_.erase(std::remove_if(packets_.begin(), packets_.end(),
+                                  [timestamp](const RtpPacketReceived& p) {
+                                    return p.Timestamp() != timestamp;
+                                  }),
+                   packets_.end());
+    size_bytes_ = 0;
+    for (const RtpPacketReceived& p : packets_)
+      size_bytes_ += p.size();
+    has_keyframe_ = true;
+  }
+  if (size_bytes_ + packet.size() > max_size_bytes_) {
+    // The frames that depend on the keyframe couldn't be forwarded without
+    // this packet, so none of them are of use.
+    Clear();
+    return;
+  }
+  packets_.push_back(packet);
+  size_bytes_ += packet.size();
+}
+
+void KeyframePacketCache::Clear() {
+  packets_.clear();
+  size_bytes_ = 0;
+  has_keyframe_ = false;
+}
+
+}  // namespace webrtc
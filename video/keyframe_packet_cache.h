@@ -0,0 +1,59 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_KEYFRAME_PACKET_CACHE_H_
+#define VIDEO_KEYFRAME_PACKET_CACHE_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "modules/rtp_rtcp/source/rtp_packet_received.h"
+#include "rtc_base/constructormagic.h"
+
+namespace webrtc {
+
+// Keeps the RTP packets of the last keyframe and of all the frames received
+// since, so that a sink that starts to receive a stream, such as the
+// forwarding sink of a new subscriber, can be given a decodable stream right
+// away instead of waiting for the sender to produce a new keyframe. The
+// packets share their buffers with the received ones, and at most
+// |max_size_bytes| of them are kept. If the frames since the keyframe need
+// more than that, nothing is kept until the next keyframe starts.
+class KeyframePacketCache {
+ public:
+  explicit KeyframePacketCache(size_t max_size_bytes);
+  ~KeyframePacketCache();
+
+  // |starts_keyframe| is true for the first packet of a keyframe. Packets of
+  // the keyframe that arrived before it, reordered, are kept.
+  void Insert(const RtpPacketReceived& packet, bool starts_keyframe);
+  void Clear();
+
+  // Whether the packets start with a keyframe.
+  bool HasKeyframe() const { return has_keyframe_; }
+  // The packets since the start of the last keyframe, in the order they
+  // arrived. Without a keyframe, the recent packets, which are of no use to
+  // forward.
+  const std::vector<RtpPacketReceived>& packets() const { return packets_; }
+  size_t size_bytes() const { return size_bytes_; }
+
+ private:
+  const size_t max_size_bytes_;
+  bool has_keyframe_ = false;
+  size_t size_bytes_ = 0;
+  std::vector<RtpPacketReceived> packets_;
+
+  RTC_DISALLOW_COPY_AND_ASSIGN(KeyframePacketCache);
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_KEYFRAME_PACKET_CACHE_H_
@@ -0,0 +1,77 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/keyframe_packet_cache.h"
+
+#include "test/gtest.h"
+
+namespace webrtc {
+
+namespace {
+
+constexpr size_t kPayloadSize = 100;
+
+RtpPacketReceived CreatePacket(uint16_t sequence_number, uint32_t timestamp) {
+  RtpPacketReceived packet;
+  packet.SetSequenceNumber(sequence_number);
+  packet.SetTimestamp(timestamp);
+  packet.AllocatePayload(kPayloadSize);
+  return packet;
+}
+
+}  // namespace
+
+TEST(KeyframePacketCacheTest, KeepsPacketsSinceLastKeyframe) {
+  KeyframePacketCache cache(10000);
+  cache.Insert(CreatePacket(1, 1000), true);
+  cache.Insert(CreatePacket(2, 2000), false);
+  EXPECT_TRUE(cache.HasKeyframe());
+  ASSERT_EQ(2u, cache.packets().size());
+
+  cache.Insert(CreatePacket(3, 3000), true);
+  cache.Insert(CreatePacket(4, 3000), false);
+  EXPECT_TRUE(cache.HasKeyframe());
+  ASSERT_EQ(2u, cache.packets().size());
+  EXPECT_EQ(3, cache.packets()[0].SequenceNumber());
+  EXPECT_EQ(4, cache.packets()[1].SequenceNumber());
+  EXPECT_EQ(cache.packets()[0].size() * 2, cache.size_bytes());
+}
+
+TEST(KeyframePacketCacheTest, KeepsReorderedPacketsOfKeyframe) {
+  KeyframePacketCache cache(10000);
+  cache.Insert(CreatePacket(1, 1000), false);
+  cache.Insert(CreatePacket(3, 2000), false);
+  EXPECT_FALSE(cache.HasKeyframe());
+
+  cache.Insert(CreatePacket(2, 2000), true);
+  EXPECT_TRUE(cache.HasKeyframe());
+  ASSERT_EQ(2u, cache.packets().size());
+  EXPECT_EQ(3, cache.packets()[0].SequenceNumber());
+  EXPECT_EQ(2, cache.packets()[1].SequenceNumber());
+}
+
+TEST(KeyframePacketCacheTest, DropsEverythingUntilNextKeyframeWhenFull) {
+  const size_t packet_size = CreatePacket(1, 1000).size();
+  KeyframePacketCache cache(packet_size * 2);
+  cache.Insert(CreatePacket(1, 1000), true);
+  cache.Insert(CreatePacket(2, 2000), false);
+  EXPECT_TRUE(cache.HasKeyframe());
+
+  cache.Insert(CreatePacket(3, 3000), false);
+  EXPECT_FALSE(cache.HasKeyframe());
+  EXPECT_TRUE(cache.packets().empty());
+  EXPECT_EQ(0u, cache.size_bytes());
+
+  cache.Insert(CreatePacket(4, 4000), true);
+  EXPECT_TRUE(cache.HasKeyframe());
+  EXPECT_EQ(1u, cache.packets().size());
+}
+
+}  // namespace webrtc
@@ -15,6 +15,7 @@
 #include <utility>
 
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_base/arraysize.h"
 #include "rtc_base/checks.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/strings/string_builder.h"
@@ -57,6 +58,37 @@ const int kRateStatisticsWindowSizeMs = 1000;
 // values above - in the map.
 const int kMaxCommonInterframeDelayMs = 500;
 
+// Same as above, for the duration of the stages of a timing frame.
+const int kMaxCommonTimingFrameStageMs = 500;
+
+// Stages of the lifetime of a frame, as recorded in timing frames. Stages that
+// span the network are only measured once the sender clock is estimated.
+struct TimingFrameStage {
+  const char* name;
+  int64_t TimingFrameInfo::*start_ms;
+  int64_t TimingFrameInfo::*end_ms;
+  bool spans_network;
+};
+const TimingFrameStage kTimingFrameStages[] = {
+    {"CaptureToEncode", &TimingFrameInfo::capture_time_ms,
+     &TimingFrameInfo::encode_start_ms, false},
+    {"Encode", &TimingFrameInfo::encode_start_ms,
+     &TimingFrameInfo::encode_finish_ms, false},
+    {"Packetization", &TimingFrameInfo::encode_finish_ms,
+     &TimingFrameInfo::packetization_finish_ms, false},
+    {"Pacer", &TimingFrameInfo::packetization_finish_ms,
+     &TimingFrameInfo::pacer_exit_ms, false},
+    {"Network", &TimingFrameInfo::pacer_exit_ms,
+     &TimingFrameInfo::receive_finish_ms, true},
+    {"JitterBuffer", &TimingFrameInfo::receive_finish_ms,
+     &TimingFrameInfo::decode_start_ms, false},
+    {"Decode", &TimingFrameInfo::decode_start_ms,
+     &TimingFrameInfo::decode_finish_ms, false},
+    {"EndToEnd", &TimingFrameInfo::capture_time_ms,
+     &TimingFrameInfo::decode_finish_ms, true},
+};
+const float kTimingFrameStagePercentiles[] = {0.5f, 0.95f, 0.99f};
+
 const char* UmaPrefixForContentType(VideoContentType content_type) {
   if (videocontenttypehelpers::IsScreenshare(content_type))
     return "WebRTC.Video.Screenshare";
@@ -106,13 +138,20 @@ ReceiveStatisticsProxy::ReceiveStatisticsProxy(
       render_fps_tracker_(100, 10u),
       render_pixel_tracker_(100, 10u),
       total_byte_tracker_(100, 10u),  // bucket_interval_ms, bucket_count
+      decoder_number_of_threads_(1),
       interframe_delay_max_moving_(kMovingMaxWindowMs),
       freq_offset_counter_(clock, nullptr, kFreqOffsetProcessIntervalMs),
       first_report_block_time_ms_(-1),
       avg_rtt_ms_(0),
       last_content_type_(VideoContentType::UNSPECIFIED),
-      timing_frame_info_counter_(kMovingMaxWindowMs) {
-  decode_thread_.DetachFromThread();
+      last_decoded_content_type_(VideoContentType::UNSPECIFIED),
+      timing_frame_info_counter_(kMovingMaxWindowMs),
+      timing_frame_stage_percentiles_(
+          arraysize(kTimingFrameStages),
+          rtc::HistogramPercentileCounter(kMaxCommonTimingFrameStageMs)),
+      rendered_frames_written_(0),
+      rendered_frames_read_(0) {
+  decode_thread_.Detach();
   network_thread_.DetachFromThread();
   stats_.ssrc = config_.rtp.remote_ssrc;
   // TODO(brandtr): Replace |rtx_stats_| with a single instance of
@@ -136,6 +175,7 @@ ReceiveStatisticsProxy::~ReceiveStatisticsProxy() {
 
 void ReceiveStatisticsProxy::UpdateHistograms() {
   RTC_DCHECK_RUN_ON(&decode_thread_);
+  ProcessRenderedFrames();
   char log_stream_buf[8 * 1024];
   rtc::SimpleStringBuilder log_stream(log_stream_buf);
   int stream_duration_sec = (clock_->TimeInMilliseconds() - start_ms_) / 1000;
@@ -227,6 +267,16 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
     RTC_HISTOGRAM_COUNTS_1000("WebRTC.Video.DecodeTimeInMs", *decode_ms);
     log_stream << "WebRTC.Video.DecodeTimeInMs " << *decode_ms << '\n';
   }
+  for (const auto& it : decode_time_counters_by_threads_) {
+    rtc::Optional<int> threads_decode_ms =
+        it.second.Avg(kMinRequiredSamples);
+    if (threads_decode_ms) {
+      std::string uma_name =
+          "WebRTC.Video.DecodeTimeInMs.Threads" + std::to_string(it.first);
+      RTC_HISTOGRAM_COUNTS_SPARSE_1000(uma_name, *threads_decode_ms);
+      log_stream << uma_name << " " << *threads_decode_ms << '\n';
+    }
+  }
   rtc::Optional<int> jb_delay_ms =
       jitter_buffer_delay_counter_.Avg(kMinRequiredSamples);
   if (jb_delay_ms) {
@@ -465,6 +515,21 @@ void ReceiveStatisticsProxy::UpdateHistograms() {
                              static_cast<int>(100 * *qp_fraction));
   }
 
+  for (size_t i = 0; i < arraysize(kTimingFrameStages); ++i) {
+    for (float percentile : kTimingFrameStagePercentiles) {
+      rtc::Optional<uint32_t> stage_ms =
+          timing_frame_stage_percentiles_[i].GetPercentile(percentile);
+      if (!stage_ms)
+        break;
+      char name_buf[128];
+      rtc::SimpleStringBuilder name(name_buf);
+      name << "WebRTC.Video.TimingFrames." << kTimingFrameStages[i].name
+           << static_cast<int>(percentile * 100) << "PercentileInMs";
+      RTC_HISTOGRAM_COUNTS_SPARSE_10000(name.str(), *stage_ms);
+      log_stream << name.str() << " " << *stage_ms << '\n';
+    }
+  }
+
   RTC_LOG(LS_INFO) << log_stream.str();
 }
 
@@ -474,6 +539,7 @@ void ReceiveStatisticsProxy::QualitySample() {
   int64_t now = clock_->TimeInMilliseconds();
   if (last_sample_time_ + kMinSampleLengthMs > now)
     return;
+  ProcessRenderedFrames();
 
   double fps =
       render_fps_tracker_.ComputeRateForInterval(now - last_sample_time_);
@@ -553,6 +619,7 @@ void ReceiveStatisticsProxy::UpdateFramerate(int64_t now_ms) const {
 
 VideoReceiveStream::Stats ReceiveStatisticsProxy::GetStats() const {
   rtc::CritScope lock(&crit_);
+  ProcessRenderedFrames();
   // Get current frame rates here, as only updating them on new frames prevents
   // us from ever correctly displaying frame rate of 0.
   int64_t now_ms = clock_->TimeInMilliseconds();
@@ -578,6 +645,11 @@ void ReceiveStatisticsProxy::OnDecoderImplementationName(
   rtc::CritScope lock(&crit_);
   stats_.decoder_implementation_name = implementation_name;
 }
+
+void ReceiveStatisticsProxy::OnDecoderNumberOfThreads(int number_of_threads) {
+  rtc::CritScope lock(&crit_);
+  decoder_number_of_threads_ = number_of_threads;
+}
 void ReceiveStatisticsProxy::OnIncomingRate(unsigned int framerate,
                                             unsigned int bitrate_bps) {
   RTC_DCHECK_RUN_ON(&network_thread_);
@@ -603,6 +675,7 @@ void ReceiveStatisticsProxy::OnFrameBufferTimingsUpdated(
   stats_.min_playout_delay_ms = min_playout_delay_ms;
   stats_.render_delay_ms = render_delay_ms;
   decode_time_counter_.Add(decode_ms);
+  decode_time_counters_by_threads_[decoder_number_of_threads_].Add(decode_ms);
   jitter_buffer_delay_counter_.Add(jitter_buffer_ms);
   target_delay_counter_.Add(target_delay_ms);
   current_delay_counter_.Add(current_delay_ms);
@@ -621,6 +694,24 @@ void ReceiveStatisticsProxy::OnTimingFrameInfoUpdated(
   rtc::CritScope lock(&crit_);
   int64_t now_ms = clock_->TimeInMilliseconds();
   timing_frame_info_counter_.Add(info, now_ms);
+
+  // The same info is reported for every decoded frame until the next timing
+  // frame is decoded, only count it once.
+  if (last_timing_frame_rtp_timestamp_ &&
+      *last_timing_frame_rtp_timestamp_ == info.rtp_timestamp) {
+    return;
+  }
+  last_timing_frame_rtp_timestamp_ = info.rtp_timestamp;
+  // Sender times are negative until the sender clock is estimated.
+  const bool clocks_synchronized = info.capture_time_ms >= 0;
+  for (size_t i = 0; i < arraysize(kTimingFrameStages); ++i) {
+    const TimingFrameStage& stage = kTimingFrameStages[i];
+    if (stage.spans_network && !clocks_synchronized)
+      continue;
+    const int64_t stage_ms = info.*stage.end_ms - info.*stage.start_ms;
+    if (stage_ms >= 0)
+      timing_frame_stage_percentiles_[i].Add(static_cast<uint32_t>(stage_ms));
+  }
 }
 
 void ReceiveStatisticsProxy::RtcpPacketTypesCounterUpdated(
@@ -706,6 +797,7 @@ void ReceiveStatisticsProxy::OnDecodedFrame(rtc::Optional<uint8_t> qp,
     stats_.qp_sum = rtc::nullopt;
   }
   last_content_type_ = content_type;
+  last_decoded_content_type_.store(content_type, std::memory_order_relaxed);
   decode_fps_estimator_.Update(1, now);
   if (last_decoded_frame_time_ms_) {
     int64_t interframe_delay_ms = now - *last_decoded_frame_time_ms_;
@@ -726,25 +818,58 @@ void ReceiveStatisticsProxy::OnRenderedFrame(const VideoFrame& frame) {
   int height = frame.height();
   RTC_DCHECK_GT(width, 0);
   RTC_DCHECK_GT(height, 0);
-  uint64_t now = clock_->TimeInMilliseconds();
-  rtc::CritScope lock(&crit_);
-  ContentSpecificStats* content_specific_stats =
-      &content_specific_stats_[last_content_type_];
-  renders_fps_estimator_.Update(1, now);
-  ++stats_.frames_rendered;
-  stats_.width = width;
-  stats_.height = height;
-  render_fps_tracker_.AddSamples(1);
-  render_pixel_tracker_.AddSamples(sqrt(width * height));
-  content_specific_stats->received_width.Add(width);
-  content_specific_stats->received_height.Add(height);
-
+  RenderedFrame rendered_frame;
+  rendered_frame.time_ms = clock_->TimeInMilliseconds();
+  rendered_frame.width = width;
+  rendered_frame.height = height;
+  rendered_frame.e2e_delay_ms = -1;
   if (frame.ntp_time_ms() > 0) {
-    int64_t delay_ms = clock_->CurrentNtpInMilliseconds() - frame.ntp_time_ms();
-    if (delay_ms >= 0) {
-      content_specific_stats->e2e_delay_counter.Add(delay_ms);
+    rendered_frame.e2e_delay_ms =
+        clock_->CurrentNtpInMilliseconds() - frame.ntp_time_ms();
+  }
+  rendered_frame.content_type =
+      last_decoded_content_type_.load(std::memory_order_relaxed);
+
+  const size_t written =
+      rendered_frames_written_.load(std::memory_order_relaxed);
+  const size_t queued =
+      written - rendered_frames_read_.load(std::memory_order_acquire);
+  if (queued == kRenderedFrameQueueSize) {
+    rtc::CritScope lock(&crit_);
+    ProcessRenderedFrames();
+  }
+  rendered_frames_[written % kRenderedFrameQueueSize] = rendered_frame;
+  rendered_frames_written_.store(written + 1, std::memory_order_release);
+
+  if (queued + 1 >= kRenderedFrameQueueSize / 2 && crit_.TryEnter()) {
+    ProcessRenderedFrames();
+    crit_.Leave();
+  }
+}
+
+void ReceiveStatisticsProxy::ProcessRenderedFrames() const {
+  const size_t written =
+      rendered_frames_written_.load(std::memory_order_acquire);
+  size_t read = rendered_frames_read_.load(std::memory_order_relaxed);
+  for (; read != written; ++read) {
+    const RenderedFrame& frame =
+        rendered_frames_[read % kRenderedFrameQueueSize];
+    ContentSpecificStats* content_specific_stats =
+        &content_specific_stats_[frame.content_type];
+    renders_fps_estimator_.Update(1, frame.time_ms);
+    ++stats_.frames_rendered;
+    stats_.width = frame.width;
+    stats_.height = frame.height;
+    render_fps_tracker_.AddSamples(1);
+    render_pixel_tracker_.AddSamples(sqrt(frame.width * frame.height));
+    content_specific_stats->received_width.Add(frame.width);
+    content_specific_stats->received_height.Add(frame.height);
+    if (frame.e2e_delay_ms >= 0) {
+      stats_.end_to_end_delay_ms = frame.e2e_delay_ms;
+      content_specific_stats->e2e_delay_counter.Add(frame.e2e_delay_ms);
     }
   }
+  rendered_frames_read_.store(written, std::memory_order_release);
 }
 
 void ReceiveStatisticsProxy::OnSyncOffsetUpdated(int64_t sync_offset_ms,
@@ -836,7 +961,7 @@ void ReceiveStatisticsProxy::DecoderThreadStarting() {
 
 void ReceiveStatisticsProxy::DecoderThreadStopped() {
   RTC_DCHECK_RUN_ON(&main_thread_);
-  decode_thread_.DetachFromThread();
+  decode_thread_.Detach();
 }
 
 ReceiveStatisticsProxy::ContentSpecificStats::ContentSpecificStats()
@@ -11,6 +11,8 @@
 #ifndef VIDEO_RECEIVE_STATISTICS_PROXY_H_
 #define VIDEO_RECEIVE_STATISTICS_PROXY_H_
 
+#include <array>
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
@@ -26,6 +28,7 @@
 #include "rtc_base/numerics/sample_counter.h"
 #include "rtc_base/rate_statistics.h"
 #include "rtc_base/ratetracker.h"
+#include "rtc_base/sequenced_task_checker.h"
 #include "rtc_base/thread_annotations.h"
 #include "rtc_base/thread_checker.h"
 #include "video/quality_threshold.h"
@@ -55,6 +58,7 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   void OnRenderedFrame(const VideoFrame& frame);
   void OnIncomingPayloadType(int payload_type);
   void OnDecoderImplementationName(const char* implementation_name);
+  void OnDecoderNumberOfThreads(int number_of_threads);
   void OnIncomingRate(unsigned int framerate, unsigned int bitrate_bps);
 
   void OnPreDecode(const EncodedImage& encoded_image,
@@ -124,8 +128,24 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
     rtc::HistogramPercentileCounter interframe_delay_percentiles;
   };
 
+  // A frame reported by OnRenderedFrame() that has not been accounted for in
+  // the stats yet.
+  struct RenderedFrame {
+    int64_t time_ms;
+    int width;
+    int height;
+    // Negative if the end-to-end delay is unknown.
+    int64_t e2e_delay_ms;
+    VideoContentType content_type;
+  };
+
+  static const size_t kRenderedFrameQueueSize = 128;
+
   void UpdateHistograms() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
+  // Accounts for the frames queued by OnRenderedFrame().
+  void ProcessRenderedFrames() const RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+
   void QualitySample() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
   // Removes info about old frames and then updates the framerate.
@@ -153,20 +173,26 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   int num_certain_states_ RTC_GUARDED_BY(crit_);
   mutable VideoReceiveStream::Stats stats_ RTC_GUARDED_BY(crit_);
   RateStatistics decode_fps_estimator_ RTC_GUARDED_BY(crit_);
-  RateStatistics renders_fps_estimator_ RTC_GUARDED_BY(crit_);
-  rtc::RateTracker render_fps_tracker_ RTC_GUARDED_BY(crit_);
-  rtc::RateTracker render_pixel_tracker_ RTC_GUARDED_BY(crit_);
+  // The render stats are mutable because the queued rendered frames are
+  // accounted for in const GetStats().
+  mutable RateStatistics renders_fps_estimator_ RTC_GUARDED_BY(crit_);
+  mutable rtc::RateTracker render_fps_tracker_ RTC_GUARDED_BY(crit_);
+  mutable rtc::RateTracker render_pixel_tracker_ RTC_GUARDED_BY(crit_);
   rtc::RateTracker total_byte_tracker_ RTC_GUARDED_BY(crit_);
   rtc::SampleCounter sync_offset_counter_ RTC_GUARDED_BY(crit_);
   rtc::SampleCounter decode_time_counter_ RTC_GUARDED_BY(crit_);
+  // Decode times by the number of threads the decoder used.
+  std::map<int, rtc::SampleCounter> decode_time_counters_by_threads_
+      RTC_GUARDED_BY(crit_);
+  int decoder_number_of_threads_ RTC_GUARDED_BY(crit_);
   rtc::SampleCounter jitter_buffer_delay_counter_ RTC_GUARDED_BY(crit_);
   rtc::SampleCounter target_delay_counter_ RTC_GUARDED_BY(crit_);
   rtc::SampleCounter current_delay_counter_ RTC_GUARDED_BY(crit_);
   rtc::SampleCounter delay_counter_ RTC_GUARDED_BY(crit_);
   mutable rtc::MovingMaxCounter<int> interframe_delay_max_moving_
       RTC_GUARDED_BY(crit_);
-  std::map<VideoContentType, ContentSpecificStats> content_specific_stats_
-      RTC_GUARDED_BY(crit_);
+  mutable std::map<VideoContentType, ContentSpecificStats>
+      content_specific_stats_ RTC_GUARDED_BY(crit_);
   MaxCounter freq_offset_counter_ RTC_GUARDED_BY(crit_);
   int64_t first_report_block_time_ms_ RTC_GUARDED_BY(crit_);
   ReportBlockStats report_block_stats_ RTC_GUARDED_BY(crit_);
@@ -175,14 +201,30 @@ class ReceiveStatisticsProxy : public VCMReceiveStatisticsCallback,
   int64_t avg_rtt_ms_ RTC_GUARDED_BY(crit_);
   mutable std::map<int64_t, size_t> frame_window_ RTC_GUARDED_BY(&crit_);
   VideoContentType last_content_type_ RTC_GUARDED_BY(&crit_);
+  // Copy of |last_content_type_| for the render thread.
+  std::atomic<VideoContentType> last_decoded_content_type_;
   rtc::Optional<int64_t> first_decoded_frame_time_ms_ RTC_GUARDED_BY(&crit_);
   rtc::Optional<int64_t> last_decoded_frame_time_ms_ RTC_GUARDED_BY(&crit_);
   // Mutable because calling Max() on MovingMaxCounter is not const. Yet it is
   // called from const GetStats().
   mutable rtc::MovingMaxCounter<TimingFrameInfo> timing_frame_info_counter_
       RTC_GUARDED_BY(&crit_);
+  // Durations of each stage of the timing frames, for the whole call.
+  std::vector<rtc::HistogramPercentileCounter> timing_frame_stage_percentiles_
+      RTC_GUARDED_BY(&crit_);
+  rtc::Optional<uint32_t> last_timing_frame_rtp_timestamp_
+      RTC_GUARDED_BY(&crit_);
   rtc::Optional<int> num_unique_frames_ RTC_GUARDED_BY(crit_);
-  rtc::ThreadChecker decode_thread_;
+  // Single-producer single-consumer queue of rendered frames, so that the
+  // render thread doesn't contend with the decode and network threads for
+  // |crit_| on every frame. Frames are taken off the queue under |crit_|, by
+  // GetStats(), QualitySample() and UpdateHistograms(). The render thread
+  // only takes |crit_| itself if it's free and the queue is half full, and
+  // waits for it only if the queue is full.
+  mutable std::array<RenderedFrame, kRenderedFrameQueueSize> rendered_frames_;
+  std::atomic<size_t> rendered_frames_written_;
+  mutable std::atomic<size_t> rendered_frames_read_;
+  rtc::SequencedTaskChecker decode_thread_;
   rtc::ThreadChecker network_thread_;
   rtc::ThreadChecker main_thread_;
 };
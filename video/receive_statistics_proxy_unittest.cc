@@ -18,6 +18,8 @@
 #include "api/video/video_frame.h"
 #include "api/video/video_rotation.h"
 #include "modules/video_coding/include/video_codec_interface.h"
+#include "rtc_base/event.h"
+#include "rtc_base/task_queue.h"
 #include "system_wrappers/include/metrics.h"
 #include "system_wrappers/include/metrics_default.h"
 #include "test/gtest.h"
@@ -400,6 +402,51 @@ TEST_F(ReceiveStatisticsProxyTest, RespectsReportingIntervalForTimingFrames) {
   EXPECT_FALSE(result);
 }
 
+TEST_F(ReceiveStatisticsProxyTest, TimingFrameStageHistogramsAreUpdated) {
+  const int kNumFrames = 10;
+  TimingFrameInfo info;
+  for (int i = 0; i < kNumFrames; ++i) {
+    info.rtp_timestamp = i;
+    info.capture_time_ms = 100 * i;
+    info.encode_start_ms = info.capture_time_ms + 1;
+    info.encode_finish_ms = info.encode_start_ms + (i == 0 ? 30 : 10);
+    info.packetization_finish_ms = info.encode_finish_ms;
+    info.pacer_exit_ms = info.packetization_finish_ms + 2;
+    info.network_timestamp_ms = info.pacer_exit_ms;
+    info.network2_timestamp_ms = info.pacer_exit_ms;
+    info.receive_start_ms = info.pacer_exit_ms + 20;
+    info.receive_finish_ms = info.receive_start_ms;
+    info.decode_start_ms = info.receive_finish_ms + 5;
+    info.decode_finish_ms = info.decode_start_ms + 4;
+    statistics_proxy_->OnTimingFrameInfoUpdated(info);
+    // The same info is reported again until the next timing frame.
+    statistics_proxy_->OnTimingFrameInfoUpdated(info);
+  }
+  // Without an estimated sender clock, sender times are negative and network
+  // stages are not measured.
+  info.rtp_timestamp = kNumFrames;
+  info.capture_time_ms = -51;
+  info.encode_start_ms = -50;
+  info.encode_finish_ms = -40;
+  info.packetization_finish_ms = -40;
+  info.pacer_exit_ms = -38;
+  statistics_proxy_->OnTimingFrameInfoUpdated(info);
+
+  statistics_proxy_.reset();
+  EXPECT_EQ(1, metrics::NumSamples(
+                   "WebRTC.Video.TimingFrames.Encode50PercentileInMs"));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.TimingFrames.Encode50PercentileInMs", 10));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.TimingFrames.Encode99PercentileInMs", 30));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.TimingFrames.Network99PercentileInMs", 20));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.TimingFrames.JitterBuffer50PercentileInMs", 5));
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.TimingFrames.EndToEnd50PercentileInMs", 42));
+}
+
 TEST_F(ReceiveStatisticsProxyTest, LifetimeHistogramIsUpdated) {
   const int64_t kTimeSec = 3;
   fake_clock_.AdvanceTimeMilliseconds(kTimeSec * 1000);
@@ -705,6 +752,29 @@ TEST_F(ReceiveStatisticsProxyTest, TimingHistogramsAreUpdated) {
             metrics::NumEvents("WebRTC.Video.OnewayDelayInMs", kTargetDelayMs));
 }
 
+TEST_F(ReceiveStatisticsProxyTest, DecodeTimeHistogramsArePerNumberOfThreads) {
+  const int kSingleThreadDecodeMs = 20;
+  const int kMultiThreadDecodeMs = 8;
+
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    statistics_proxy_->OnFrameBufferTimingsUpdated(
+        kSingleThreadDecodeMs, 0, 0, 0, 0, 0, 0);
+  }
+  statistics_proxy_->OnDecoderNumberOfThreads(4);
+  for (int i = 0; i < kMinRequiredSamples; ++i) {
+    statistics_proxy_->OnFrameBufferTimingsUpdated(
+        kMultiThreadDecodeMs, 0, 0, 0, 0, 0, 0);
+  }
+
+  statistics_proxy_.reset();
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.DecodeTimeInMs.Threads1"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.DecodeTimeInMs.Threads1",
+                                  kSingleThreadDecodeMs));
+  EXPECT_EQ(1, metrics::NumSamples("WebRTC.Video.DecodeTimeInMs.Threads4"));
+  EXPECT_EQ(1, metrics::NumEvents("WebRTC.Video.DecodeTimeInMs.Threads4",
+                                  kMultiThreadDecodeMs));
+}
+
 TEST_F(ReceiveStatisticsProxyTest, DoesNotReportStaleFramerates) {
   const int kDefaultFps = 30;
   const int kWidth = 320;
@@ -747,6 +817,46 @@ TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsReceivedFrameStats) {
   EXPECT_EQ(1u, statistics_proxy_->GetStats().frames_rendered);
 }
 
+TEST_F(ReceiveStatisticsProxyTest, CountsAllFramesRenderedBetweenGetStats) {
+  const int kNumFrames = 1000;
+  for (int i = 0; i < kNumFrames; ++i)
+    statistics_proxy_->OnRenderedFrame(CreateFrame(160, 120));
+
+  EXPECT_EQ(static_cast<uint32_t>(kNumFrames),
+            statistics_proxy_->GetStats().frames_rendered);
+}
+
+TEST_F(ReceiveStatisticsProxyTest, CountsFramesRenderedOnAnotherThread) {
+  const int kNumFrames = 1000;
+  VideoFrame frame = CreateFrame(160, 120);
+  rtc::Event done(false, false);
+  rtc::TaskQueue render_queue("render");
+  render_queue.PostTask([&] {
+    for (int i = 0; i < kNumFrames; ++i)
+      statistics_proxy_->OnRenderedFrame(frame);
+    done.Set();
+  });
+  uint32_t frames_rendered = 0;
+  while (!done.Wait(0)) {
+    const uint32_t frames = statistics_proxy_->GetStats().frames_rendered;
+    EXPECT_GE(frames, frames_rendered);
+    frames_rendered = frames;
+  }
+  EXPECT_EQ(static_cast<uint32_t>(kNumFrames),
+            statistics_proxy_->GetStats().frames_rendered);
+}
+
+TEST_F(ReceiveStatisticsProxyTest, GetStatsReportsEndToEndDelay) {
+  const int64_t kDelayMs = 35;
+  EXPECT_EQ(-1, statistics_proxy_->GetStats().end_to_end_delay_ms);
+
+  VideoFrame frame = CreateFrame(160, 120);
+  fake_clock_.AdvanceTimeMilliseconds(kDelayMs);
+  statistics_proxy_->OnRenderedFrame(frame);
+
+  EXPECT_EQ(kDelayMs, statistics_proxy_->GetStats().end_to_end_delay_ms);
+}
+
 TEST_F(ReceiveStatisticsProxyTest,
        ReceivedFrameHistogramsAreNotUpdatedForTooFewSamples) {
   const int kWidth = 160;
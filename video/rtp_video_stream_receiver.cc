@@ -33,6 +33,7 @@
 #include "rtc_base/checks.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/ptr_util.h"
 #include "rtc_base/system/fallthrough.h"
 #include "system_wrappers/include/field_trial.h"
 #include "system_wrappers/include/metrics.h"
@@ -45,6 +46,9 @@ namespace {
 //                 crbug.com/752886
 constexpr int kPacketBufferStartSize = 512;
 constexpr int kPacketBufferMaxSixe = 2048;
+// How long it takes the sender to encode a keyframe once it has been asked
+// for one, roughly.
+constexpr int64_t kKeyFrameEncodeTimeMs = 100;
 }
 
 std::unique_ptr<RtpRtcp> CreateRtpRtcpModule(
@@ -89,11 +93,13 @@ RtpVideoStreamReceiver::RtpVideoStreamReceiver(
     ProcessThread* process_thread,
     NackSender* nack_sender,
     KeyFrameRequestSender* keyframe_request_sender,
-    video_coding::OnCompleteFrameCallback* complete_frame_callback)
+    video_coding::OnCompleteFrameCallback* complete_frame_callback,
+    rtc::MemoryAccount* memory_account)
     : clock_(Clock::GetRealTimeClock()),
       config_(*config),
       packet_router_(packet_router),
       process_thread_(process_thread),
+      memory_account_(memory_account),
       ntp_estimator_(clock_),
       rtp_header_extensions_(config_.rtp.extensions),
       rtp_receiver_(RtpReceiver::CreateVideoReceiver(clock_,
@@ -109,9 +115,14 @@ RtpVideoStreamReceiver::RtpVideoStreamReceiver(
                                     rtt_stats,
                                     receive_stats_proxy,
                                     packet_router)),
+      rtcp_mode_(config_.rtp.rtcp_mode),
       complete_frame_callback_(complete_frame_callback),
       keyframe_request_sender_(keyframe_request_sender),
-      has_received_frame_(false) {
+      has_received_frame_(false),
+      keyframe_cache_(config_.rtp.keyframe_cache_max_bytes > 0
+                          ? rtc::MakeUnique<KeyframePacketCache>(
+                                config_.rtp.keyframe_cache_max_bytes)
+                          : nullptr) {
   constexpr bool remb_candidate = true;
   packet_router_->AddReceiveRtpModule(rtp_rtcp_.get(), remb_candidate);
   rtp_receive_statistics_->RegisterRtpStatisticsCallback(receive_stats_proxy);
@@ -150,14 +161,27 @@ RtpVideoStreamReceiver::RtpVideoStreamReceiver(
     process_thread_->RegisterModule(nack_module_.get(), RTC_FROM_HERE);
   }
 
+  // With a known bitrate, allocate the buffer for it up front, so that it
+  // doesn't have to grow while holding its lock on the packet delivery path.
+  const size_t packet_buffer_size =
+      video_coding::PacketBuffer::BufferSizeForBitrate(
+          config_.max_bitrate_bps, kPacketBufferStartSize);
   packet_buffer_ = video_coding::PacketBuffer::Create(
-      clock_, kPacketBufferStartSize, kPacketBufferMaxSixe, this);
+      clock_, packet_buffer_size,
+      std::max<size_t>(packet_buffer_size, kPacketBufferMaxSixe), this);
+  if (memory_account_) {
+    memory_account_->AddSource(rtc::kVideoPacketBufferMemory,
+                               packet_buffer_.get());
+  }
   reference_finder_.reset(new video_coding::RtpFrameReferenceFinder(this));
 }
 
 RtpVideoStreamReceiver::~RtpVideoStreamReceiver() {
   RTC_DCHECK(secondary_sinks_.empty());
 
+  if (memory_account_)
+    memory_account_->RemoveSource(packet_buffer_.get());
+
   if (nack_module_) {
     process_thread_->DeRegisterModule(nack_module_.get());
   }
@@ -208,6 +232,13 @@ int32_t RtpVideoStreamReceiver::OnReceivedPayloadData(
       nack_module_ ? nack_module_->OnReceivedPacket(packet) : -1;
   packet.receive_time_ms = clock_->TimeInMilliseconds();
 
+  if (CoalescesKeyFrameRequests() && packet.frameType == kVideoFrameKey &&
+      packet.is_first_packet_in_frame) {
+    packet_starts_keyframe_ = true;
+    rtc::CritScope lock(&keyframe_request_cs_);
+    last_keyframe_request_ms_.reset();
+  }
+
   if (packet.sizeBytes == 0) {
     NotifyReceiverOfEmptyPacket(packet.seqNum);
     return 0;
@@ -297,6 +328,7 @@ void RtpVideoStreamReceiver::OnRtpPacket(const RtpPacketReceived& packet) {
 
   bool in_order = IsPacketInOrder(header);
 
+  packet_starts_keyframe_ = false;
   ReceivePacket(packet.data(), packet.size(), header);
   // Update receive statistics after ReceivePacket.
   // Receive statistics will be reset if the payload type changes (make sure
@@ -308,12 +340,31 @@ void RtpVideoStreamReceiver::OnRtpPacket(const RtpPacketReceived& packet) {
         header, packet.size(), IsPacketRetransmitted(header, in_order));
   }
 
+  if (keyframe_cache_)
+    keyframe_cache_->Insert(packet, packet_starts_keyframe_);
+
   for (RtpPacketSinkInterface* secondary_sink : secondary_sinks_) {
     secondary_sink->OnRtpPacket(packet);
   }
 }
 
 int32_t RtpVideoStreamReceiver::RequestKeyFrame() {
+  if (CoalescesKeyFrameRequests()) {
+    // The sender would answer each request with a keyframe of its own, so
+    // the requests that are made while one is on its way are dropped.
+    rtc::CritScope lock(&keyframe_request_cs_);
+    ++num_keyframe_requests_;
+    int64_t interval_ms = config_.rtp.min_keyframe_request_interval_ms;
+    if (keyframe_cache_)
+      interval_ms = std::max(interval_ms, rtt_ms_ + kKeyFrameEncodeTimeMs);
+    const int64_t now_ms = clock_->TimeInMilliseconds();
+    if (last_keyframe_request_ms_ &&
+        now_ms - *last_keyframe_request_ms_ < interval_ms) {
+      ++num_suppressed_keyframe_requests_;
+      return 0;
+    }
+    last_keyframe_request_ms_ = now_ms;
+  }
   return rtp_rtcp_->RequestKeyFrame();
 }
 
@@ -343,6 +394,14 @@ void RtpVideoStreamReceiver::OnReceivedFrame(
       keyframe_request_sender_->RequestKeyFrame();
   }
 
+  if (config_.frame_decryptor &&
+      !frame->Decrypt(config_.frame_decryptor.get(),
+                      config_.rtp.remote_ssrc)) {
+    RTC_LOG(LS_WARNING) << "Failed to decrypt frame with timestamp "
+                        << frame->Timestamp() << ", dropping it.";
+    return;
+  }
+
   reference_finder_->ManageFrame(std::move(frame));
 }
 
@@ -361,6 +420,8 @@ void RtpVideoStreamReceiver::OnCompleteFrame(
 void RtpVideoStreamReceiver::UpdateRtt(int64_t max_rtt_ms) {
   if (nack_module_)
     nack_module_->UpdateRtt(max_rtt_ms);
+  rtc::CritScope lock(&keyframe_request_cs_);
+  rtt_ms_ = max_rtt_ms;
 }
 
 rtc::Optional<int64_t> RtpVideoStreamReceiver::LastReceivedPacketMs() const {
@@ -377,6 +438,14 @@ void RtpVideoStreamReceiver::AddSecondarySink(RtpPacketSinkInterface* sink) {
   RTC_DCHECK(std::find(secondary_sinks_.cbegin(), secondary_sinks_.cend(),
                        sink) == secondary_sinks_.cend());
   secondary_sinks_.push_back(sink);
+  if (!keyframe_cache_)
+    return;
+  if (keyframe_cache_->HasKeyframe()) {
+    for (const RtpPacketReceived& packet : keyframe_cache_->packets())
+      sink->OnRtpPacket(packet);
+  } else if (receiving_) {
+    RequestKeyFrame();
+  }
 }
 
 void RtpVideoStreamReceiver::RemoveSecondarySink(
@@ -517,8 +586,16 @@ void RtpVideoStreamReceiver::FrameDecoded(int64_t picture_id) {
 }
 
 void RtpVideoStreamReceiver::SignalNetworkState(NetworkState state) {
-  rtp_rtcp_->SetRTCPStatus(state == kNetworkUp ? config_.rtp.rtcp_mode
-                                               : RtcpMode::kOff);
+  rtp_rtcp_->SetRTCPStatus(state == kNetworkUp ? rtcp_mode_ : RtcpMode::kOff);
+}
+
+void RtpVideoStreamReceiver::SetRtcpMode(RtcpMode mode) {
+  RTC_DCHECK(mode != RtcpMode::kOff);
+  rtcp_mode_ = mode;
+  // RTCP is off while the network is down, SignalNetworkState() applies the
+  // new mode when it comes back up.
+  if (rtp_rtcp_->RTCP() != RtcpMode::kOff)
+    rtp_rtcp_->SetRTCPStatus(mode);
 }
 
 int RtpVideoStreamReceiver::GetUniqueFramesSeen() const {
@@ -533,6 +610,8 @@ void RtpVideoStreamReceiver::StartReceive() {
 void RtpVideoStreamReceiver::StopReceive() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_task_checker_);
   receiving_ = false;
+  if (keyframe_cache_)
+    keyframe_cache_->Clear();
 }
 
 bool RtpVideoStreamReceiver::IsPacketInOrder(const RTPHeader& header) const {
@@ -560,6 +639,15 @@ bool RtpVideoStreamReceiver::IsPacketRetransmitted(const RTPHeader& header,
 }
 
 void RtpVideoStreamReceiver::UpdateHistograms() {
+  {
+    rtc::CritScope lock(&keyframe_request_cs_);
+    if (num_keyframe_requests_ > 0) {
+      RTC_HISTOGRAM_PERCENTAGE(
+          "WebRTC.Video.SuppressedKeyFrameRequestsInPercent",
+          num_suppressed_keyframe_requests_ * 100 / num_keyframe_requests_);
+    }
+  }
+
   FecPacketCounter counter = ulpfec_receiver_->GetPacketCounter();
   if (counter.first_packet_time_ms == -1)
     return;
@@ -581,6 +669,10 @@ void RtpVideoStreamReceiver::UpdateHistograms() {
   }
 }
 
+bool RtpVideoStreamReceiver::CoalescesKeyFrameRequests() const {
+  return keyframe_cache_ || config_.rtp.min_keyframe_request_interval_ms > 0;
+}
+
 void RtpVideoStreamReceiver::InsertSpsPpsIntoTracker(uint8_t payload_type) {
   auto codec_params_it = pt_codec_params_.find(payload_type);
   if (codec_params_it == pt_codec_params_.end())
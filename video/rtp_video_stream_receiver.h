@@ -32,9 +32,11 @@
 #include "modules/video_coding/rtp_frame_reference_finder.h"
 #include "rtc_base/constructormagic.h"
 #include "rtc_base/criticalsection.h"
+#include "rtc_base/memory_account.h"
 #include "rtc_base/numerics/sequence_number_util.h"
 #include "rtc_base/sequenced_task_checker.h"
 #include "typedefs.h"  // NOLINT(build/include)
+#include "video/keyframe_packet_cache.h"
 
 namespace webrtc {
 
@@ -72,7 +74,8 @@ class RtpVideoStreamReceiver : public RtpData,
       ProcessThread* process_thread,
       NackSender* nack_sender,
       KeyFrameRequestSender* keyframe_request_sender,
-      video_coding::OnCompleteFrameCallback* complete_frame_callback);
+      video_coding::OnCompleteFrameCallback* complete_frame_callback,
+      rtc::MemoryAccount* memory_account);
   ~RtpVideoStreamReceiver();
 
   bool AddReceiveCodec(const VideoCodec& video_codec,
@@ -93,6 +96,7 @@ class RtpVideoStreamReceiver : public RtpData,
   void FrameDecoded(int64_t seq_num);
 
   void SignalNetworkState(NetworkState state);
+  void SetRtcpMode(RtcpMode mode);
 
   // Returns number of different frames seen in the packet buffer.
   int GetUniqueFramesSeen() const;
@@ -139,7 +143,9 @@ class RtpVideoStreamReceiver : public RtpData,
   // RtpDemuxer only forwards a given RTP packet to one sink. However, some
   // sinks, such as FlexFEC, might wish to be informed of all of the packets
   // a given sink receives (or any set of sinks). They may do so by registering
-  // themselves as secondary sinks.
+  // themselves as secondary sinks. If the stream keeps a keyframe cache, a
+  // sink that is added is given the cached packets first, or a keyframe is
+  // requested if there are none.
   void AddSecondarySink(RtpPacketSinkInterface* sink);
   void RemoveSecondarySink(const RtpPacketSinkInterface* sink);
 
@@ -160,12 +166,15 @@ class RtpVideoStreamReceiver : public RtpData,
   void UpdateHistograms();
   bool IsRedEnabled() const;
   void InsertSpsPpsIntoTracker(uint8_t payload_type);
+  bool CoalescesKeyFrameRequests() const;
 
   Clock* const clock_;
   // Ownership of this object lies with VideoReceiveStream, which owns |this|.
   const VideoReceiveStream::Config& config_;
   PacketRouter* const packet_router_;
   ProcessThread* const process_thread_;
+  // If set, the memory used by |packet_buffer_| is reported to it.
+  rtc::MemoryAccount* const memory_account_;
 
   RemoteNtpTimeEstimator ntp_estimator_;
   RTPPayloadRegistry rtp_payload_registry_;
@@ -180,6 +189,8 @@ class RtpVideoStreamReceiver : public RtpData,
   int64_t last_packet_log_ms_ RTC_GUARDED_BY(worker_task_checker_);
 
   const std::unique_ptr<RtpRtcp> rtp_rtcp_;
+  // Starts out as |config_.rtp.rtcp_mode| and is updated by SetRtcpMode().
+  RtcpMode rtcp_mode_;
 
   // Members for the new jitter buffer experiment.
   video_coding::OnCompleteFrameCallback* complete_frame_callback_;
@@ -201,6 +212,22 @@ class RtpVideoStreamReceiver : public RtpData,
 
   std::vector<RtpPacketSinkInterface*> secondary_sinks_
       RTC_GUARDED_BY(worker_task_checker_);
+
+  // Set if config_.rtp.keyframe_cache_max_bytes is.
+  const std::unique_ptr<KeyframePacketCache> keyframe_cache_
+      RTC_PT_GUARDED_BY(worker_task_checker_);
+  // Set by OnReceivedPayloadData() for the packet that OnRtpPacket() is
+  // handling, which it is called from.
+  bool packet_starts_keyframe_ = false;
+
+  rtc::CriticalSection keyframe_request_cs_;
+  // When the last keyframe request that hasn't been answered yet was sent.
+  rtc::Optional<int64_t> last_keyframe_request_ms_
+      RTC_GUARDED_BY(keyframe_request_cs_);
+  int64_t rtt_ms_ RTC_GUARDED_BY(keyframe_request_cs_) = 0;
+  int num_keyframe_requests_ RTC_GUARDED_BY(keyframe_request_cs_) = 0;
+  int num_suppressed_keyframe_requests_ RTC_GUARDED_BY(keyframe_request_cs_) =
+      0;
 };
 
 }  // namespace webrtc
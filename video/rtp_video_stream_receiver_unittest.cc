@@ -25,6 +25,7 @@
 #include "rtc_base/ptr_util.h"
 #include "system_wrappers/include/clock.h"
 #include "system_wrappers/include/field_trial_default.h"
+#include "system_wrappers/include/metrics_default.h"
 #include "test/field_trial.h"
 #include "video/rtp_video_stream_receiver.h"
 
@@ -130,7 +131,8 @@ class RtpVideoStreamReceiverTest : public testing::Test {
         &mock_transport_, nullptr, &packet_router_, &config_,
         rtp_receive_statistics_.get(), nullptr, process_thread_.get(),
         &mock_nack_sender_,
-        &mock_key_frame_request_sender_, &mock_on_complete_frame_callback_);
+        &mock_key_frame_request_sender_, &mock_on_complete_frame_callback_,
+        nullptr);
   }
 
   WebRtcRTPHeader GetDefaultPacket() {
@@ -487,4 +489,21 @@ TEST_F(RtpVideoStreamReceiverTest, RepeatedSecondarySinkDisallowed) {
 }
 #endif
 
+TEST_F(RtpVideoStreamReceiverTest, CoalescesKeyFrameRequests) {
+  metrics::Reset();
+  VideoReceiveStream::Config config = CreateConfig();
+  config.rtp.min_keyframe_request_interval_ms = 10000;
+  auto receiver = rtc::MakeUnique<RtpVideoStreamReceiver>(
+      &mock_transport_, nullptr, &packet_router_, &config,
+      rtp_receive_statistics_.get(), nullptr, process_thread_.get(),
+      &mock_nack_sender_, &mock_key_frame_request_sender_,
+      &mock_on_complete_frame_callback_, nullptr);
+  for (int i = 0; i < 4; ++i)
+    receiver->RequestKeyFrame();
+  receiver.reset();
+
+  EXPECT_EQ(1, metrics::NumEvents(
+                   "WebRTC.Video.SuppressedKeyFrameRequestsInPercent", 75));
+}
+
 }  // namespace webrtc
@@ -137,12 +137,17 @@ SendStatisticsProxy::SendStatisticsProxy(
       cpu_downscales_(-1),
       media_byte_rate_tracker_(kBucketSizeMs, kBucketCount),
       encoded_frame_rate_tracker_(kBucketSizeMs, kBucketCount),
+      frames_dropped_by_capturer_(0),
+      frames_dropped_by_encoder_queue_(0),
+      frames_dropped_by_rate_limiter_(0),
+      frames_dropped_by_encoder_(0),
       uma_container_(
           new UmaSamplesContainer(GetUmaPrefix(content_type_), stats_, clock)) {
 }
 
 SendStatisticsProxy::~SendStatisticsProxy() {
   rtc::CritScope lock(&crit_);
+  UpdateFrameDropStats();
   uma_container_->UpdateHistograms(rtp_config_, stats_);
 
   int64_t elapsed_sec = (clock_->TimeInMilliseconds() - start_ms_) / 1000;
@@ -632,6 +637,7 @@ void SendStatisticsProxy::OnEncoderReconfigured(
   stats_.preferred_media_bitrate_bps = preferred_bitrate_bps;
 
   if (content_type_ != config.content_type) {
+    UpdateFrameDropStats();
     uma_container_->UpdateHistograms(rtp_config_, stats_);
     uma_container_.reset(new UmaSamplesContainer(
         GetUmaPrefix(config.content_type), stats_, clock_));
@@ -691,6 +697,7 @@ void SendStatisticsProxy::OnSuspendChange(bool is_suspended) {
 VideoSendStream::Stats SendStatisticsProxy::GetStats() {
   rtc::CritScope lock(&crit_);
   PurgeOldStats();
+  UpdateFrameDropStats();
   stats_.input_frame_rate =
       round(uma_container_->input_frame_rate_tracker_.ComputeRate());
   stats_.content_type =
@@ -740,6 +747,17 @@ VideoSendStream::StreamStats* SendStatisticsProxy::GetStatsEntry(
   return entry;
 }
 
+void SendStatisticsProxy::UpdateFrameDropStats() {
+  stats_.frames_dropped_by_capturer =
+      frames_dropped_by_capturer_.load(std::memory_order_relaxed);
+  stats_.frames_dropped_by_encoder_queue =
+      frames_dropped_by_encoder_queue_.load(std::memory_order_relaxed);
+  stats_.frames_dropped_by_rate_limiter =
+      frames_dropped_by_rate_limiter_.load(std::memory_order_relaxed);
+  stats_.frames_dropped_by_encoder =
+      frames_dropped_by_encoder_.load(std::memory_order_relaxed);
+}
+
 void SendStatisticsProxy::OnInactiveSsrc(uint32_t ssrc) {
   rtc::CritScope lock(&crit_);
   VideoSendStream::StreamStats* stats = GetStatsEntry(ssrc);
@@ -969,23 +987,19 @@ void SendStatisticsProxy::OnIncomingFrame(int width, int height) {
 }
 
 void SendStatisticsProxy::OnFrameDroppedBySource() {
-  rtc::CritScope lock(&crit_);
-  ++stats_.frames_dropped_by_capturer;
+  frames_dropped_by_capturer_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void SendStatisticsProxy::OnFrameDroppedInEncoderQueue() {
-  rtc::CritScope lock(&crit_);
-  ++stats_.frames_dropped_by_encoder_queue;
+  frames_dropped_by_encoder_queue_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void SendStatisticsProxy::OnFrameDroppedByEncoder() {
-  rtc::CritScope lock(&crit_);
-  ++stats_.frames_dropped_by_encoder;
+  frames_dropped_by_encoder_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void SendStatisticsProxy::OnFrameDroppedByMediaOptimizations() {
-  rtc::CritScope lock(&crit_);
-  ++stats_.frames_dropped_by_rate_limiter;
+  frames_dropped_by_rate_limiter_.fetch_add(1, std::memory_order_relaxed);
 }
 
 void SendStatisticsProxy::SetAdaptationStats(
@@ -11,6 +11,7 @@
 #ifndef VIDEO_SEND_STATISTICS_PROXY_H_
 #define VIDEO_SEND_STATISTICS_PROXY_H_
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <string>
@@ -213,6 +214,8 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
   typedef std::map<uint32_t, Frame, TimestampOlderThan> EncodedFrameMap;
 
   void PurgeOldStats() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
+  // Copies the frame drop counts into |stats_|.
+  void UpdateFrameDropStats() RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
   VideoSendStream::StreamStats* GetStatsEntry(uint32_t ssrc)
       RTC_EXCLUSIVE_LOCKS_REQUIRED(crit_);
 
@@ -251,6 +254,14 @@ class SendStatisticsProxy : public CpuOveruseMetricsObserver,
 
   rtc::Optional<int64_t> last_outlier_timestamp_ RTC_GUARDED_BY(crit_);
 
+  // Frame drops are reported per frame from the capture and encoder threads,
+  // so they are counted without |crit_| and copied into |stats_| when it's
+  // read.
+  std::atomic<uint32_t> frames_dropped_by_capturer_;
+  std::atomic<uint32_t> frames_dropped_by_encoder_queue_;
+  std::atomic<uint32_t> frames_dropped_by_rate_limiter_;
+  std::atomic<uint32_t> frames_dropped_by_encoder_;
+
   // Contains stats used for UMA histograms. These stats will be reset if
   // content type changes between real-time video and screenshare, since these
   // will be reported separately.
@@ -331,6 +331,21 @@ TEST_F(SendStatisticsProxyTest, OnEncoderReconfiguredChangePreferredBitrate) {
   EXPECT_EQ(kPreferredBps, stats.preferred_media_bitrate_bps);
 }
 
+TEST_F(SendStatisticsProxyTest, GetStatsReportsDroppedFrames) {
+  statistics_proxy_->OnFrameDroppedBySource();
+  statistics_proxy_->OnFrameDroppedInEncoderQueue();
+  statistics_proxy_->OnFrameDroppedInEncoderQueue();
+  statistics_proxy_->OnFrameDroppedByMediaOptimizations();
+  for (int i = 0; i < 3; ++i)
+    statistics_proxy_->OnFrameDroppedByEncoder();
+
+  VideoSendStream::Stats stats = statistics_proxy_->GetStats();
+  EXPECT_EQ(1u, stats.frames_dropped_by_capturer);
+  EXPECT_EQ(2u, stats.frames_dropped_by_encoder_queue);
+  EXPECT_EQ(1u, stats.frames_dropped_by_rate_limiter);
+  EXPECT_EQ(3u, stats.frames_dropped_by_encoder);
+}
+
 TEST_F(SendStatisticsProxyTest, OnSendEncodedImageIncreasesFramesEncoded) {
   EncodedImage encoded_image;
   CodecSpecificInfo codec_info;
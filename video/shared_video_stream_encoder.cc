@@ -0,0 +1,339 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/shared_video_stream_encoder.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "rtc_base/checks.h"
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/refcountedobject.h"
+#include "video/encoder_rtcp_feedback.h"
+#include "video/overuse_frame_detector.h"
+#include "video/send_statistics_proxy.h"
+#include "video/video_stream_encoder.h"
+
+namespace webrtc {
+
+class SharedVideoStreamEncoder::StreamEncoder
+    : public VideoStreamEncoderInterface {
+ public:
+  StreamEncoder(rtc::scoped_refptr<SharedVideoStreamEncoder> shared,
+                SendStatisticsProxy* stats_proxy)
+      : stats_proxy(stats_proxy), shared_(std::move(shared)) {
+    shared_->AddStream(this);
+  }
+  ~StreamEncoder() override { Stop(); }
+
+  void SetSource(
+      rtc::VideoSourceInterface<VideoFrame>* source,
+      const DegradationPreference& degradation_preference) override {
+    shared_->UpdateSource(this, source, degradation_preference);
+  }
+
+  void SetSink(EncoderSink* sink, bool rotation_applied) override {
+    shared_->SetSink(this, sink, rotation_applied);
+  }
+
+  void SetStartBitrate(int start_bitrate_bps) override {
+    if (shared_->IsFirstStream(this))
+      shared_->encoder_->SetStartBitrate(start_bitrate_bps);
+  }
+
+  void SendKeyFrame() override { shared_->RequestKeyFrame(); }
+
+  void OnBitrateUpdated(uint32_t bitrate_bps,
+                        uint8_t fraction_lost,
+                        int64_t round_trip_time_ms) override {
+    {
+      rtc::CritScope lock(&shared_->crit_);
+      this->bitrate_bps = bitrate_bps;
+      this->fraction_lost = fraction_lost;
+      rtt_ms = round_trip_time_ms;
+    }
+    shared_->UpdateBitrate();
+  }
+
+  void SetActiveLayers(const std::vector<bool>& active_layers) override {
+    {
+      rtc::CritScope lock(&shared_->crit_);
+      this->active_layers = active_layers;
+    }
+    shared_->UpdateActiveLayers();
+  }
+
+  void SetBitrateAllocationObserver(
+      VideoBitrateAllocationObserver* bitrate_observer) override {
+    shared_->SetBitrateAllocationObserver(this, bitrate_observer);
+  }
+
+  void ConfigureEncoder(VideoEncoderConfig config,
+                        size_t max_data_payload_length) override {
+    if (shared_->IsFirstStream(this)) {
+      shared_->encoder_->ConfigureEncoder(std::move(config),
+                                          max_data_payload_length);
+    }
+  }
+
+  void Stop() override {
+    if (stopped_)
+      return;
+    stopped_ = true;
+    shared_->RemoveStream(this);
+  }
+
+  void OnFrame(const VideoFrame& frame) override {
+    shared_->encoder_->OnFrame(frame);
+  }
+
+  // Guarded by the |crit_| of |shared_|.
+  SendStatisticsProxy* const stats_proxy;
+  EncoderSink* sink = nullptr;
+  VideoBitrateAllocationObserver* allocation_observer = nullptr;
+  rtc::VideoSourceInterface<VideoFrame>* source = nullptr;
+  uint32_t bitrate_bps = 0;
+  uint8_t fraction_lost = 0;
+  int64_t rtt_ms = 0;
+  std::vector<bool> active_layers;
+
+ private:
+  const rtc::scoped_refptr<SharedVideoStreamEncoder> shared_;
+  bool stopped_ = false;
+};
+
+rtc::scoped_refptr<SharedVideoStreamEncoder> SharedVideoStreamEncoder::Create(
+    int num_cpu_cores,
+    Clock* clock,
+    const VideoSendStream::Config& config,
+    VideoEncoderConfig::ContentType content_type) {
+  std::unique_ptr<SendStatisticsProxy> stats_proxy =
+      rtc::MakeUnique<SendStatisticsProxy>(clock, config, content_type);
+  std::unique_ptr<VideoStreamEncoderInterface> encoder =
+      rtc::MakeUnique<VideoStreamEncoder>(
+          num_cpu_cores, stats_proxy.get(), config.encoder_settings,
+          config.pre_encode_callback,
+          rtc::MakeUnique<OveruseFrameDetector>(stats_proxy.get()));
+  return new rtc::RefCountedObject<SharedVideoStreamEncoder>(
+      clock, std::move(stats_proxy), std::move(encoder));
+}
+
+SharedVideoStreamEncoder::SharedVideoStreamEncoder(
+    Clock* clock,
+    std::unique_ptr<SendStatisticsProxy> stats_proxy,
+    std::unique_ptr<VideoStreamEncoderInterface> encoder)
+    : clock_(clock),
+      stats_proxy_(std::move(stats_proxy)),
+      encoder_(std::move(encoder)) {
+  RTC_DCHECK(encoder_);
+}
+
+SharedVideoStreamEncoder::~SharedVideoStreamEncoder() {
+  bool stopped;
+  {
+    rtc::CritScope lock(&crit_);
+    RTC_DCHECK(streams_.empty());
+    stopped = stopped_;
+  }
+  // No stream was ever created.
+  if (!stopped)
+    encoder_->Stop();
+}
+
+std::unique_ptr<VideoStreamEncoderInterface>
+SharedVideoStreamEncoder::CreateStreamEncoder(
+    SendStatisticsProxy* stats_proxy) {
+  return rtc::MakeUnique<StreamEncoder>(this, stats_proxy);
+}
+
+bool SharedVideoStreamEncoder::HasStreams() {
+  rtc::CritScope lock(&crit_);
+  return !streams_.empty();
+}
+
+void SharedVideoStreamEncoder::AddStream(StreamEncoder* stream) {
+  rtc::CritScope lock(&crit_);
+  RTC_DCHECK(!stopped_) << "The encoder was stopped with its last stream.";
+  streams_.push_back(stream);
+}
+
+void SharedVideoStreamEncoder::RemoveStream(StreamEncoder* stream) {
+  bool stop_encoder;
+  {
+    rtc::CritScope lock(&crit_);
+    streams_.erase(std::remove(streams_.begin(), streams_.end(), stream),
+                   streams_.end());
+    stop_encoder = streams_.empty();
+    stopped_ = stop_encoder;
+  }
+  if (stop_encoder) {
+    encoder_->Stop();
+    return;
+  }
+  // The stream may have been what held the bitrate down or kept a layer on.
+  UpdateBitrate();
+  UpdateActiveLayers();
+}
+
+bool SharedVideoStreamEncoder::IsFirstStream(const StreamEncoder* stream) {
+  rtc::CritScope lock(&crit_);
+  return !streams_.empty() && streams_.front() == stream;
+}
+
+void SharedVideoStreamEncoder::SetSink(
+    StreamEncoder* stream,
+    VideoStreamEncoderInterface::EncoderSink* sink,
+    bool rotation_applied) {
+  bool set_encoder_sink;
+  {
+    rtc::CritScope lock(&crit_);
+    stream->sink = sink;
+    if (sink && has_configuration_) {
+      sink->OnEncoderConfigurationChanged(configured_streams_,
+                                          min_transmit_bitrate_bps_);
+    }
+    set_encoder_sink = !sink_set_;
+    sink_set_ = true;
+  }
+  if (set_encoder_sink)
+    encoder_->SetSink(this, rotation_applied);
+}
+
+void SharedVideoStreamEncoder::SetBitrateAllocationObserver(
+    StreamEncoder* stream,
+    VideoBitrateAllocationObserver* observer) {
+  bool set_encoder_observer;
+  {
+    rtc::CritScope lock(&crit_);
+    stream->allocation_observer = observer;
+    set_encoder_observer = observer && !allocation_observer_set_;
+    allocation_observer_set_ |= set_encoder_observer;
+  }
+  if (set_encoder_observer)
+    encoder_->SetBitrateAllocationObserver(this);
+}
+
+void SharedVideoStreamEncoder::UpdateSource(
+    StreamEncoder* stream,
+    rtc::VideoSourceInterface<VideoFrame>* source,
+    const DegradationPreference& degradation_preference) {
+  rtc::VideoSourceInterface<VideoFrame>* shared_source = source;
+  {
+    rtc::CritScope lock(&crit_);
+    stream->source = source;
+    // The source is only taken away once no stream has one.
+    for (const StreamEncoder* other : streams_) {
+      if (!shared_source)
+        shared_source = other->source;
+    }
+  }
+  encoder_->SetSource(shared_source, degradation_preference);
+}
+
+void SharedVideoStreamEncoder::RequestKeyFrame() {
+  {
+    rtc::CritScope lock(&crit_);
+    const int64_t now_ms = clock_->TimeInMilliseconds();
+    // The keyframe that was asked for last answers this request too.
+    if (last_keyframe_request_ms_ >= 0 &&
+        now_ms - last_keyframe_request_ms_ <
+            EncoderRtcpFeedback::kDefaultMinKeyFrameRequestIntervalMs) {
+      return;
+    }
+    last_keyframe_request_ms_ = now_ms;
+  }
+  encoder_->SendKeyFrame();
+}
+
+void SharedVideoStreamEncoder::UpdateBitrate() {
+  uint32_t bitrate_bps = 0;
+  uint8_t fraction_lost = 0;
+  int64_t rtt_ms = 0;
+  {
+    rtc::CritScope lock(&crit_);
+    if (stopped_)
+      return;
+    // The streams that are paused don't hold the others back.
+    for (const StreamEncoder* stream : streams_) {
+      if (stream->bitrate_bps == 0)
+        continue;
+      if (bitrate_bps == 0 || stream->bitrate_bps < bitrate_bps)
+        bitrate_bps = stream->bitrate_bps;
+      fraction_lost = std::max(fraction_lost, stream->fraction_lost);
+      rtt_ms = std::max(rtt_ms, stream->rtt_ms);
+    }
+  }
+  encoder_->OnBitrateUpdated(bitrate_bps, fraction_lost, rtt_ms);
+}
+
+void SharedVideoStreamEncoder::UpdateActiveLayers() {
+  std::vector<bool> active_layers;
+  {
+    rtc::CritScope lock(&crit_);
+    if (stopped_ || streams_.empty())
+      return;
+    // A layer is encoded if any stream sends it. The layers beyond the end of
+    // a stream's vector are sent.
+    active_layers = streams_.front()->active_layers;
+    for (const StreamEncoder* stream : streams_) {
+      if (stream->active_layers.size() < active_layers.size())
+        active_layers.resize(stream->active_layers.size());
+      for (size_t i = 0; i < active_layers.size(); ++i)
+        active_layers[i] = active_layers[i] || stream->active_layers[i];
+    }
+  }
+  encoder_->SetActiveLayers(active_layers);
+}
+
+EncodedImageCallback::Result SharedVideoStreamEncoder::OnEncodedImage(
+    const EncodedImage& encoded_image,
+    const CodecSpecificInfo* codec_specific_info,
+    const RTPFragmentationHeader* fragmentation) {
+  EncodedImageCallback::Result result(
+      EncodedImageCallback::Result::ERROR_SEND_FAILED);
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_) {
+    if (!stream->sink)
+      continue;
+    if (stream->stats_proxy)
+      stream->stats_proxy->OnSendEncodedImage(encoded_image,
+                                              codec_specific_info);
+    EncodedImageCallback::Result stream_result = stream->sink->OnEncodedImage(
+        encoded_image, codec_specific_info, fragmentation);
+    if (stream_result.error == EncodedImageCallback::Result::OK)
+      result = stream_result;
+  }
+  return result;
+}
+
+void SharedVideoStreamEncoder::OnEncoderConfigurationChanged(
+    std::vector<VideoStream> streams,
+    int min_transmit_bitrate_bps) {
+  rtc::CritScope lock(&crit_);
+  has_configuration_ = true;
+  configured_streams_ = streams;
+  min_transmit_bitrate_bps_ = min_transmit_bitrate_bps;
+  for (StreamEncoder* stream : streams_) {
+    if (stream->sink)
+      stream->sink->OnEncoderConfigurationChanged(streams,
+                                                  min_transmit_bitrate_bps);
+  }
+}
+
+void SharedVideoStreamEncoder::OnBitrateAllocationUpdated(
+    const VideoBitrateAllocation& allocation) {
+  rtc::CritScope lock(&crit_);
+  for (StreamEncoder* stream : streams_) {
+    if (stream->allocation_observer)
+      stream->allocation_observer->OnBitrateAllocationUpdated(allocation);
+  }
+}
+
+}  // namespace webrtc
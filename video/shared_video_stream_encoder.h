@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef VIDEO_SHARED_VIDEO_STREAM_ENCODER_H_
+#define VIDEO_SHARED_VIDEO_STREAM_ENCODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "api/video/video_stream_encoder_interface.h"
+#include "call/video_send_stream.h"
+#include "common_video/include/video_bitrate_allocator.h"
+#include "rtc_base/criticalsection.h"
+#include "rtc_base/refcount.h"
+#include "rtc_base/scoped_ref_ptr.h"
+#include "system_wrappers/include/clock.h"
+
+namespace webrtc {
+
+class SendStatisticsProxy;
+
+// Encodes the video of several send streams that send the same source at the
+// same resolution and bitrate, such as the receivers of an MCU's composed
+// layout that are in the same bitrate class, with one encoder. Each stream
+// gets a VideoStreamEncoderInterface of its own from CreateStreamEncoder(),
+// whose sink gets all the encoded frames, and packetizes them with its own
+// RTP modules and SSRCs. The encoder runs at the lowest of the streams'
+// bitrates, encodes the simulcast layers that any of the streams sends, and
+// answers keyframe requests from all of them with one keyframe. The first of
+// the streams configures the encoder and sets its start bitrate, the others'
+// configurations are ignored.
+class SharedVideoStreamEncoder
+    : public rtc::RefCountInterface,
+      private VideoStreamEncoderInterface::EncoderSink,
+      private VideoBitrateAllocationObserver {
+ public:
+  // Creates the VideoStreamEncoder for |config|, the config of the first of
+  // the streams. Its statistics, such as the input frame rate and the encode
+  // usage, are kept apart from those of the streams.
+  static rtc::scoped_refptr<SharedVideoStreamEncoder> Create(
+      int num_cpu_cores,
+      Clock* clock,
+      const VideoSendStream::Config& config,
+      VideoEncoderConfig::ContentType content_type);
+
+  SharedVideoStreamEncoder(
+      Clock* clock,
+      std::unique_ptr<SendStatisticsProxy> stats_proxy,
+      std::unique_ptr<VideoStreamEncoderInterface> encoder);
+
+  // The encoder for one more stream. Its sink stops getting frames when it is
+  // stopped, and the shared encoder is stopped with the last of them. Frames
+  // that are sent are reported to |stats_proxy|, unless it is null.
+  std::unique_ptr<VideoStreamEncoderInterface> CreateStreamEncoder(
+      SendStatisticsProxy* stats_proxy);
+  bool HasStreams();
+
+ protected:
+  ~SharedVideoStreamEncoder() override;
+
+ private:
+  class StreamEncoder;
+
+  // Called by the StreamEncoders, whose state is guarded by |crit_|.
+  void AddStream(StreamEncoder* stream);
+  // Stops the encoder if |stream| was the last one.
+  void RemoveStream(StreamEncoder* stream);
+  bool IsFirstStream(const StreamEncoder* stream);
+  void SetSink(StreamEncoder* stream,
+               VideoStreamEncoderInterface::EncoderSink* sink,
+               bool rotation_applied);
+  void SetBitrateAllocationObserver(StreamEncoder* stream,
+                                    VideoBitrateAllocationObserver* observer);
+  void UpdateSource(StreamEncoder* stream,
+                    rtc::VideoSourceInterface<VideoFrame>* source,
+                    const DegradationPreference& degradation_preference);
+  void RequestKeyFrame();
+  void UpdateBitrate();
+  void UpdateActiveLayers();
+
+  // Implements VideoStreamEncoderInterface::EncoderSink.
+  EncodedImageCallback::Result OnEncodedImage(
+      const EncodedImage& encoded_image,
+      const CodecSpecificInfo* codec_specific_info,
+      const RTPFragmentationHeader* fragmentation) override;
+  void OnEncoderConfigurationChanged(std::vector<VideoStream> streams,
+                                     int min_transmit_bitrate_bps) override;
+
+  // Implements VideoBitrateAllocationObserver.
+  void OnBitrateAllocationUpdated(
+      const VideoBitrateAllocation& allocation) override;
+
+  Clock* const clock_;
+  const std::unique_ptr<SendStatisticsProxy> stats_proxy_;
+  const std::unique_ptr<VideoStreamEncoderInterface> encoder_;
+
+  // Held while frames are delivered, so that a stream that is removed gets
+  // no frames once RemoveStream() has returned. It is never held while the
+  // encoder is called, since stopping the encoder waits for the frames.
+  rtc::CriticalSection crit_;
+  std::vector<StreamEncoder*> streams_ RTC_GUARDED_BY(crit_);
+  bool sink_set_ RTC_GUARDED_BY(crit_) = false;
+  bool allocation_observer_set_ RTC_GUARDED_BY(crit_) = false;
+  bool stopped_ RTC_GUARDED_BY(crit_) = false;
+  int64_t last_keyframe_request_ms_ RTC_GUARDED_BY(crit_) = -1;
+  // The last configuration, for the streams whose sink is set after it.
+  bool has_configuration_ RTC_GUARDED_BY(crit_) = false;
+  std::vector<VideoStream> configured_streams_ RTC_GUARDED_BY(crit_);
+  int min_transmit_bitrate_bps_ RTC_GUARDED_BY(crit_) = 0;
+};
+
+}  // namespace webrtc
+
+#endif  // VIDEO_SHARED_VIDEO_STREAM_ENCODER_H_
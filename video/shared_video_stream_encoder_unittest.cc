@@ -0,0 +1,156 @@
+/*
+ *  Copyright 2018 The WebRTC project authors. All Rights Reserved.
+ *
+ *  Use of this source code is governed by a BSD-style license
+ *  that can be found in the LICENSE file in the root of the source
+ *  tree. An additional intellectual property rights grant can be found
+ *  in the file PATENTS.  All contributing project authors may
+ *  be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "video/shared_video_stream_encoder.h"
+
+#include <memory>
+#include <vector>
+
+#include "rtc_base/ptr_util.h"
+#include "rtc_base/refcountedobject.h"
+#include "test/gmock.h"
+#include "test/gtest.h"
+#include "video/send_statistics_proxy.h"
+#include "video/test/mock_video_stream_encoder.h"
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::SaveArg;
+
+namespace webrtc {
+
+namespace {
+
+class MockEncoderSink : public VideoStreamEncoderInterface::EncoderSink {
+ public:
+  MOCK_METHOD3(OnEncodedImage,
+               Result(const EncodedImage&,
+                      const CodecSpecificInfo*,
+                      const RTPFragmentationHeader*));
+  MOCK_METHOD2(OnEncoderConfigurationChanged,
+               void(std::vector<VideoStream>, int));
+};
+
+class SharedVideoStreamEncoderTest : public ::testing::Test {
+ protected:
+  SharedVideoStreamEncoderTest() : clock_(123456) {
+    auto encoder = rtc::MakeUnique<NiceMock<MockVideoStreamEncoder>>();
+    encoder_ = encoder.get();
+    shared_ = new rtc::RefCountedObject<SharedVideoStreamEncoder>(
+        &clock_, nullptr, std::move(encoder));
+  }
+
+  SimulatedClock clock_;
+  NiceMock<MockVideoStreamEncoder>* encoder_;
+  rtc::scoped_refptr<SharedVideoStreamEncoder> shared_;
+};
+
+}  // namespace
+
+TEST_F(SharedVideoStreamEncoderTest, GivesEachStreamTheEncodedFrames) {
+  VideoStreamEncoderInterface::EncoderSink* encoder_sink = nullptr;
+  EXPECT_CALL(*encoder_, SetSink(_, false))
+      .WillOnce(SaveArg<0>(&encoder_sink));
+  std::unique_ptr<VideoStreamEncoderInterface> first =
+      shared_->CreateStreamEncoder(nullptr);
+  std::unique_ptr<VideoStreamEncoderInterface> second =
+      shared_->CreateStreamEncoder(nullptr);
+  MockEncoderSink first_sink;
+  MockEncoderSink second_sink;
+  first->SetSink(&first_sink, false);
+  second->SetSink(&second_sink, false);
+  ASSERT_TRUE(encoder_sink);
+
+  EncodedImage image;
+  CodecSpecificInfo codec_specific_info;
+  const EncodedImageCallback::Result kOk(EncodedImageCallback::Result::OK);
+  EXPECT_CALL(first_sink, OnEncodedImage(_, _, _)).WillOnce(Return(kOk));
+  EXPECT_CALL(second_sink, OnEncodedImage(_, _, _)).WillOnce(Return(kOk));
+  encoder_sink->OnEncodedImage(image, &codec_specific_info, nullptr);
+
+  // A stream that is stopped gets no more frames, and the encoder is stopped
+  // with the last one.
+  first->Stop();
+  EXPECT_CALL(first_sink, OnEncodedImage(_, _, _)).Times(0);
+  EXPECT_CALL(second_sink, OnEncodedImage(_, _, _)).WillOnce(Return(kOk));
+  encoder_sink->OnEncodedImage(image, &codec_specific_info, nullptr);
+
+  EXPECT_CALL(*encoder_, Stop());
+  second->Stop();
+}
+
+TEST_F(SharedVideoStreamEncoderTest, EncodesAtTheLowestBitrate) {
+  std::unique_ptr<VideoStreamEncoderInterface> first =
+      shared_->CreateStreamEncoder(nullptr);
+  std::unique_ptr<VideoStreamEncoderInterface> second =
+      shared_->CreateStreamEncoder(nullptr);
+  std::unique_ptr<VideoStreamEncoderInterface> paused =
+      shared_->CreateStreamEncoder(nullptr);
+
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(800000, 10, 50));
+  first->OnBitrateUpdated(800000, 10, 50);
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(500000, 20, 100));
+  second->OnBitrateUpdated(500000, 20, 100);
+  // A paused stream doesn't pause the others.
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(500000, 20, 100));
+  paused->OnBitrateUpdated(0, 0, 0);
+
+  EXPECT_CALL(*encoder_, OnBitrateUpdated(800000, 10, 50));
+  second->Stop();
+  testing::Mock::VerifyAndClearExpectations(encoder_);
+}
+
+TEST_F(SharedVideoStreamEncoderTest, CoalescesKeyFrameRequests) {
+  std::unique_ptr<VideoStreamEncoderInterface> first =
+      shared_->CreateStreamEncoder(nullptr);
+  std::unique_ptr<VideoStreamEncoderInterface> second =
+      shared_->CreateStreamEncoder(nullptr);
+
+  EXPECT_CALL(*encoder_, SendKeyFrame()).Times(1);
+  first->SendKeyFrame();
+  second->SendKeyFrame();
+
+  EXPECT_CALL(*encoder_, SendKeyFrame()).Times(1);
+  clock_.AdvanceTimeMilliseconds(300);
+  second->SendKeyFrame();
+}
+
+TEST_F(SharedVideoStreamEncoderTest, EncodesTheLayersThatAnyStreamSends) {
+  std::unique_ptr<VideoStreamEncoderInterface> first =
+      shared_->CreateStreamEncoder(nullptr);
+  std::unique_ptr<VideoStreamEncoderInterface> second =
+      shared_->CreateStreamEncoder(nullptr);
+
+  // Until the second stream sets its layers, it sends them all.
+  EXPECT_CALL(*encoder_, SetActiveLayers(std::vector<bool>()));
+  first->SetActiveLayers({true, false, false});
+  EXPECT_CALL(*encoder_,
+              SetActiveLayers(std::vector<bool>({true, true, false})));
+  second->SetActiveLayers({false, true, false});
+  testing::Mock::VerifyAndClearExpectations(encoder_);
+}
+
+TEST_F(SharedVideoStreamEncoderTest, OnlyTheFirstStreamConfiguresTheEncoder) {
+  std::unique_ptr<VideoStreamEncoderInterface> first =
+      shared_->CreateStreamEncoder(nullptr);
+  std::unique_ptr<VideoStreamEncoderInterface> second =
+      shared_->CreateStreamEncoder(nullptr);
+
+  EXPECT_CALL(*encoder_, MockedConfigureEncoder(_, 1000)).Times(1);
+  first->ConfigureEncoder(VideoEncoderConfig(), 1000);
+  second->ConfigureEncoder(VideoEncoderConfig(), 1000);
+
+  first->Stop();
+  EXPECT_CALL(*encoder_, MockedConfigureEncoder(_, 1200)).Times(1);
+  second->ConfigureEncoder(VideoEncoderConfig(), 1200);
+}
+
+}  // namespace webrtc
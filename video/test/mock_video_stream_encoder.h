@@ -24,6 +24,7 @@ class MockVideoStreamEncoder : public VideoStreamEncoderInterface {
   MOCK_METHOD1(SetStartBitrate, void(int));
   MOCK_METHOD0(SendKeyFrame, void());
   MOCK_METHOD3(OnBitrateUpdated, void(uint32_t, uint8_t, int64_t));
+  MOCK_METHOD1(SetActiveLayers, void(const std::vector<bool>&));
   MOCK_METHOD1(OnFrame, void(const VideoFrame&));
   MOCK_METHOD1(SetBitrateAllocationObserver,
                void(VideoBitrateAllocationObserver*));
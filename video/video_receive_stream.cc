@@ -32,6 +32,7 @@
 #include "modules/video_coding/timing.h"
 #include "modules/video_coding/utility/ivf_file_writer.h"
 #include "rtc_base/checks.h"
+#include "rtc_base/event.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
 #include "rtc_base/ptr_util.h"
@@ -44,6 +45,9 @@
 namespace webrtc {
 
 namespace {
+constexpr int kMaxWaitForFrameMs = 3000;
+constexpr int kMaxWaitForKeyFrameMs = 200;
+
 VideoCodec CreateDecoderVideoCodec(const VideoReceiveStream::Decoder& decoder) {
   VideoCodec codec;
   memset(&codec, 0, sizeof(codec));
@@ -85,7 +89,8 @@ VideoReceiveStream::VideoReceiveStream(
     PacketRouter* packet_router,
     VideoReceiveStream::Config config,
     ProcessThread* process_thread,
-    CallStats* call_stats)
+    CallStats* call_stats,
+    rtc::MemoryAccount* memory_account)
     : transport_adapter_(config.rtcp_send_transport),
       config_(std::move(config)),
       num_cpu_cores_(num_cpu_cores),
@@ -109,7 +114,8 @@ VideoReceiveStream::VideoReceiveStream(
                                  process_thread_,
                                  this,   // NackSender
                                  this,   // KeyFrameRequestSender
-                                 this),  // OnCompleteFrameCallback
+                                 this,   // OnCompleteFrameCallback
+                                 memory_account),
       rtp_stream_sync_(this) {
   RTC_LOG(LS_INFO) << "VideoReceiveStream: " << config_.ToString();
 
@@ -134,6 +140,7 @@ VideoReceiveStream::VideoReceiveStream(
   jitter_estimator_.reset(new VCMJitterEstimator(clock_));
   frame_buffer_.reset(new video_coding::FrameBuffer(
       clock_, jitter_estimator_.get(), timing_.get(), &stats_proxy_));
+  frame_buffer_->SetMaxDecodeFramerate(config_.max_decode_framerate);
 
   process_thread_->RegisterModule(&rtp_stream_sync_, RTC_FROM_HERE);
 
@@ -173,7 +180,7 @@ void VideoReceiveStream::SetSync(Syncable* audio_syncable) {
 
 void VideoReceiveStream::Start() {
   RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
-  if (decode_thread_.IsRunning())
+  if (decode_thread_.IsRunning() || decode_queue_)
     return;
 
   bool protected_by_fec = config_.rtp.protected_by_flexfec ||
@@ -224,7 +231,13 @@ void VideoReceiveStream::Start() {
   // Start the decode thread
   video_receiver_.DecoderThreadStarting();
   stats_proxy_.DecoderThreadStarting();
-  decode_thread_.Start();
+  if (config_.decode_on_task_queue) {
+    decode_queue_.reset(
+        new rtc::TaskQueue("DecodingQueue", rtc::TaskQueue::Priority::HIGH));
+    decode_queue_->PostTask([this] { StartNextDecode(); });
+  } else {
+    decode_thread_.Start();
+  }
   rtp_video_stream_receiver_.StartReceive();
 }
 
@@ -239,13 +252,22 @@ void VideoReceiveStream::Stop() {
   call_stats_->DeregisterStatsObserver(this);
   process_thread_->DeRegisterModule(&video_receiver_);
 
-  if (decode_thread_.IsRunning()) {
+  if (decode_thread_.IsRunning() || decode_queue_) {
     // TriggerDecoderShutdown will release any waiting decoder thread and make
     // it stop immediately, instead of waiting for a timeout. Needs to be called
     // before joining the decoder thread.
     video_receiver_.TriggerDecoderShutdown();
 
-    decode_thread_.Stop();
+    if (decode_queue_) {
+      // The stopped frame buffer ends the chain of decode tasks. Wait for the
+      // tasks already posted before destroying the queue.
+      rtc::Event decode_done(false, false);
+      decode_queue_->PostTask([&decode_done] { decode_done.Set(); });
+      decode_done.Wait(rtc::Event::kForever);
+      decode_queue_.reset();
+    } else {
+      decode_thread_.Stop();
+    }
     video_receiver_.DecoderThreadStopped();
     stats_proxy_.DecoderThreadStopped();
     // Deregister external decoders so they are no longer running during
@@ -265,6 +287,11 @@ VideoReceiveStream::Stats VideoReceiveStream::GetStats() const {
   return stats_proxy_.GetStats();
 }
 
+void VideoReceiveStream::SetRtcpMode(RtcpMode mode) {
+  RTC_DCHECK_CALLED_SEQUENTIALLY(&worker_sequence_checker_);
+  rtp_video_stream_receiver_.SetRtcpMode(mode);
+}
+
 void VideoReceiveStream::EnableEncodedFrameRecording(rtc::PlatformFile file,
                                                      size_t byte_limit) {
   {
@@ -417,10 +444,7 @@ void VideoReceiveStream::DecodeThreadFunction(void* ptr) {
 
 bool VideoReceiveStream::Decode() {
   TRACE_EVENT0("webrtc", "VideoReceiveStream::Decode");
-  static const int kMaxWaitForFrameMs = 3000;
-  static const int kMaxWaitForKeyFrameMs = 200;
-
-  int wait_ms = keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
+  const int wait_ms = MaxWaitForFrameMs();
   std::unique_ptr<video_coding::EncodedFrame> frame;
   // TODO(philipel): Call NextFrame with |keyframe_required| argument when
   //                 downstream project has been fixed.
@@ -431,6 +455,33 @@ bool VideoReceiveStream::Decode() {
     return false;
   }
 
+  HandleNextFrame(std::move(frame), res, wait_ms);
+  return true;
+}
+
+void VideoReceiveStream::StartNextDecode() {
+  RTC_DCHECK(decode_queue_->IsCurrent());
+  const int wait_ms = MaxWaitForFrameMs();
+  frame_buffer_->NextFrame(
+      wait_ms, false, decode_queue_.get(),
+      [this, wait_ms](std::unique_ptr<video_coding::EncodedFrame> frame,
+                      video_coding::FrameBuffer::ReturnReason res) {
+        if (res == video_coding::FrameBuffer::ReturnReason::kStopped)
+          return;
+        TRACE_EVENT0("webrtc", "VideoReceiveStream::Decode");
+        HandleNextFrame(std::move(frame), res, wait_ms);
+        StartNextDecode();
+      });
+}
+
+int VideoReceiveStream::MaxWaitForFrameMs() const {
+  return keyframe_required_ ? kMaxWaitForKeyFrameMs : kMaxWaitForFrameMs;
+}
+
+void VideoReceiveStream::HandleNextFrame(
+    std::unique_ptr<video_coding::EncodedFrame> frame,
+    video_coding::FrameBuffer::ReturnReason res,
+    int wait_ms) {
   if (frame) {
     int64_t now_ms = clock_->TimeInMilliseconds();
     RTC_DCHECK_EQ(res, video_coding::FrameBuffer::ReturnReason::kFrameFound);
@@ -477,7 +528,6 @@ bool VideoReceiveStream::Decode() {
       RequestKeyFrame();
     }
   }
-  return true;
 }
 }  // namespace internal
 }  // namespace webrtc
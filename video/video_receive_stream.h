@@ -22,6 +22,7 @@
 #include "modules/video_coding/frame_buffer2.h"
 #include "modules/video_coding/video_coding_impl.h"
 #include "rtc_base/sequenced_task_checker.h"
+#include "rtc_base/task_queue.h"
 #include "system_wrappers/include/clock.h"
 #include "video/receive_statistics_proxy.h"
 #include "video/rtp_streams_synchronizer.h"
@@ -57,7 +58,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
                      PacketRouter* packet_router,
                      VideoReceiveStream::Config config,
                      ProcessThread* process_thread,
-                     CallStats* call_stats);
+                     CallStats* call_stats,
+                     rtc::MemoryAccount* memory_account);
   ~VideoReceiveStream() override;
 
   const Config& config() const { return config_; }
@@ -73,6 +75,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
 
   webrtc::VideoReceiveStream::Stats GetStats() const override;
 
+  void SetRtcpMode(RtcpMode mode) override;
+
   // Takes ownership of the file, is responsible for closing it later.
   // Calling this method will close and finalize any current log.
   // Giving rtc::kInvalidPlatformFileValue disables logging.
@@ -115,6 +119,12 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
  private:
   static void DecodeThreadFunction(void* ptr);
   bool Decode();
+  // Asks |frame_buffer_| for the next frame to decode on |decode_queue_|.
+  void StartNextDecode();
+  int MaxWaitForFrameMs() const;
+  void HandleNextFrame(std::unique_ptr<video_coding::EncodedFrame> frame,
+                       video_coding::FrameBuffer::ReturnReason res,
+                       int wait_ms);
 
   rtc::SequencedTaskChecker worker_sequence_checker_;
   rtc::SequencedTaskChecker module_process_sequence_checker_;
@@ -126,6 +136,8 @@ class VideoReceiveStream : public webrtc::VideoReceiveStream,
   Clock* const clock_;
 
   rtc::PlatformThread decode_thread_;
+  // Used instead of |decode_thread_| with |config_.decode_on_task_queue|.
+  std::unique_ptr<rtc::TaskQueue> decode_queue_;
 
   CallStats* const call_stats_;
 
@@ -64,12 +64,14 @@ VideoSendStream::VideoSendStream(
     BitrateAllocator* bitrate_allocator,
     SendDelayStats* send_delay_stats,
     RtcEventLog* event_log,
+    rtc::MemoryAccount* memory_account,
     VideoSendStream::Config config,
     VideoEncoderConfig encoder_config,
     const std::map<uint32_t, RtpState>& suspended_ssrcs,
     const std::map<uint32_t, RtpPayloadState>& suspended_payload_states,
     std::unique_ptr<FecController> fec_controller,
-    RateLimiter* retransmission_limiter)
+    RateLimiter* retransmission_limiter,
+    rtc::scoped_refptr<SharedVideoStreamEncoder> shared_encoder)
     : worker_queue_(worker_queue),
       thread_sync_event_(false /* manual_reset */, false),
       stats_proxy_(Clock::GetRealTimeClock(),
@@ -79,22 +81,26 @@ VideoSendStream::VideoSendStream(
       content_type_(encoder_config.content_type) {
   RTC_DCHECK(config_.encoder_settings.encoder_factory);
 
-  video_stream_encoder_ = rtc::MakeUnique<VideoStreamEncoder>(
-      num_cpu_cores, &stats_proxy_,
-      config_.encoder_settings,
-      config_.pre_encode_callback,
-      rtc::MakeUnique<OveruseFrameDetector>(&stats_proxy_));
+  if (shared_encoder) {
+    video_stream_encoder_ = shared_encoder->CreateStreamEncoder(&stats_proxy_);
+  } else {
+    video_stream_encoder_ = rtc::MakeUnique<VideoStreamEncoder>(
+        num_cpu_cores, &stats_proxy_,
+        config_.encoder_settings,
+        config_.pre_encode_callback,
+        rtc::MakeUnique<OveruseFrameDetector>(&stats_proxy_));
+  }
   // TODO(srte): Initialization should not be done posted on a task queue.
   // Note that the posted task must not outlive this scope since the closure
   // references local variables.
   worker_queue_->PostTask(rtc::NewClosure(
       [this, call_stats, transport, bitrate_allocator, send_delay_stats,
-       event_log, &suspended_ssrcs, &encoder_config, &suspended_payload_states,
-       &fec_controller, retransmission_limiter]() {
+       event_log, memory_account, &suspended_ssrcs, &encoder_config,
+       &suspended_payload_states, &fec_controller, retransmission_limiter]() {
         send_stream_.reset(new VideoSendStreamImpl(
             &stats_proxy_, worker_queue_, call_stats, transport,
             bitrate_allocator, send_delay_stats, video_stream_encoder_.get(),
-            event_log, &config_, encoder_config.max_bitrate_bps,
+            event_log, memory_account, &config_, encoder_config.max_bitrate_bps,
             encoder_config.bitrate_priority, suspended_ssrcs,
             suspended_payload_states, encoder_config.content_type,
             std::move(fec_controller), retransmission_limiter));
@@ -172,6 +178,13 @@ void VideoSendStream::ReconfigureVideoEncoder(VideoEncoderConfig config) {
       config_.rtp.max_packet_size - CalculateMaxHeaderSize(config_.rtp));
 }
 
+void VideoSendStream::SetRtcpMode(RtcpMode mode) {
+  RTC_DCHECK_RUN_ON(&thread_checker_);
+  VideoSendStreamImpl* send_stream = send_stream_.get();
+  worker_queue_->PostTask(
+      [send_stream, mode] { send_stream->SetRtcpMode(mode); });
+}
+
 VideoSendStream::Stats VideoSendStream::GetStats() {
   // TODO(perkj, solenberg): Some test cases in EndToEndTest call GetStats from
   // a network thread. See comment in Call::GetStats().
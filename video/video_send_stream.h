@@ -22,10 +22,12 @@
 #include "common_video/libyuv/include/webrtc_libyuv.h"
 #include "rtc_base/criticalsection.h"
 #include "rtc_base/event.h"
+#include "rtc_base/memory_account.h"
 #include "rtc_base/task_queue.h"
 #include "video/send_delay_stats.h"
 #include "video/payload_router.h"
 #include "video/send_statistics_proxy.h"
+#include "video/shared_video_stream_encoder.h"
 #include "video/video_stream_encoder.h"
 
 namespace webrtc {
@@ -48,7 +50,8 @@ class VideoSendStreamImpl;
 // VideoSendStream implements webrtc::VideoSendStream.
 // Internally, it delegates all public methods to VideoSendStreamImpl and / or
 // VideoStreamEncoder. VideoSendStreamInternal is created and deleted on
-// |worker_queue|.
+// |worker_queue|. With a |shared_encoder|, the stream encodes with it instead
+// of a VideoStreamEncoder of its own.
 class VideoSendStream : public webrtc::VideoSendStream {
  public:
   VideoSendStream(
@@ -60,12 +63,14 @@ class VideoSendStream : public webrtc::VideoSendStream {
       BitrateAllocator* bitrate_allocator,
       SendDelayStats* send_delay_stats,
       RtcEventLog* event_log,
+      rtc::MemoryAccount* memory_account,
       VideoSendStream::Config config,
       VideoEncoderConfig encoder_config,
       const std::map<uint32_t, RtpState>& suspended_ssrcs,
       const std::map<uint32_t, RtpPayloadState>& suspended_payload_states,
       std::unique_ptr<FecController> fec_controller,
-      RateLimiter* retransmission_limiter);
+      RateLimiter* retransmission_limiter,
+      rtc::scoped_refptr<SharedVideoStreamEncoder> shared_encoder = nullptr);
 
   ~VideoSendStream() override;
 
@@ -82,6 +87,7 @@ class VideoSendStream : public webrtc::VideoSendStream {
                  const DegradationPreference& degradation_preference) override;
 
   void ReconfigureVideoEncoder(VideoEncoderConfig) override;
+  void SetRtcpMode(RtcpMode mode) override;
   Stats GetStats() override;
 
   typedef std::map<uint32_t, RtpState> RtpStateMap;
@@ -116,7 +122,7 @@ class VideoSendStream : public webrtc::VideoSendStream {
   const VideoSendStream::Config config_;
   const VideoEncoderConfig::ContentType content_type_;
   std::unique_ptr<VideoSendStreamImpl> send_stream_;
-  std::unique_ptr<VideoStreamEncoder> video_stream_encoder_;
+  std::unique_ptr<VideoStreamEncoderInterface> video_stream_encoder_;
 };
 
 }  // namespace internal
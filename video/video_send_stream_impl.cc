@@ -49,6 +49,7 @@ std::vector<RtpRtcp*> CreateRtpRtcpModules(
     SendStatisticsProxy* stats_proxy,
     SendDelayStats* send_delay_stats,
     RtcEventLog* event_log,
+    rtc::MemoryAccount* memory_account,
     RateLimiter* retransmission_rate_limiter,
     OverheadObserver* overhead_observer,
     RtpKeepAliveConfig keepalive_config) {
@@ -71,6 +72,8 @@ std::vector<RtpRtcp*> CreateRtpRtcpModules(
   configuration.send_side_delay_observer = stats_proxy;
   configuration.send_packet_observer = send_delay_stats;
   configuration.event_log = event_log;
+  configuration.memory_account = memory_account;
+  configuration.frame_encryptor = config.frame_encryptor.get();
   configuration.retransmission_rate_limiter = retransmission_rate_limiter;
   configuration.overhead_observer = overhead_observer;
   configuration.keepalive_config = keepalive_config;
@@ -287,6 +290,7 @@ VideoSendStreamImpl::VideoSendStreamImpl(
     SendDelayStats* send_delay_stats,
     VideoStreamEncoderInterface* video_stream_encoder,
     RtcEventLog* event_log,
+    rtc::MemoryAccount* memory_account,
     const VideoSendStream::Config* config,
     int initial_encoder_max_bitrate,
     double initial_encoder_bitrate_priority,
@@ -313,10 +317,12 @@ VideoSendStreamImpl::VideoSendStreamImpl(
       encoder_target_rate_bps_(0),
       encoder_bitrate_priority_(initial_encoder_bitrate_priority),
       has_packet_feedback_(false),
+      rtcp_mode_(config_->rtp.rtcp_mode),
       video_stream_encoder_(video_stream_encoder),
       encoder_feedback_(Clock::GetRealTimeClock(),
                         config_->rtp.ssrcs,
-                        video_stream_encoder),
+                        video_stream_encoder,
+                        config_->rtp.min_keyframe_request_interval_ms),
       bandwidth_observer_(transport->GetBandwidthObserver()),
       rtp_rtcp_modules_(CreateRtpRtcpModules(*config_,
                                              &encoder_feedback_,
@@ -327,6 +333,7 @@ VideoSendStreamImpl::VideoSendStreamImpl(
                                              stats_proxy_,
                                              send_delay_stats,
                                              event_log,
+                                             memory_account,
                                              retransmission_limiter,
                                              this,
                                              transport->keepalive_config())),
@@ -509,6 +516,8 @@ void VideoSendStreamImpl::UpdateActiveSimulcastLayers(
   RTC_LOG(LS_INFO) << "VideoSendStream::UpdateActiveSimulcastLayers";
   bool previously_active = payload_router_.IsActive();
   payload_router_.SetActiveModules(active_layers);
+  // Don't spend encode time on the layers that aren't sent.
+  video_stream_encoder_->SetActiveLayers(active_layers);
   if (!payload_router_.IsActive() && previously_active) {
     // Payload router switched from active to inactive.
     StopVideoSendStream();
@@ -691,8 +700,24 @@ EncodedImageCallback::Result VideoSendStreamImpl::OnEncodedImage(
 
   fec_controller_->UpdateWithEncodedData(encoded_image._length,
                                          encoded_image._frameType);
+  const bool has_playout_delay = config_->playout_delay.min_ms >= 0 ||
+                                 config_->playout_delay.max_ms >= 0;
+  EncodedImage image_with_playout_delay;
+  if (has_playout_delay) {
+    // A shallow copy, the payload isn't copied.
+    image_with_playout_delay = encoded_image;
+    if (config_->playout_delay.min_ms >= 0) {
+      image_with_playout_delay.playout_delay_.min_ms =
+          config_->playout_delay.min_ms;
+    }
+    if (config_->playout_delay.max_ms >= 0) {
+      image_with_playout_delay.playout_delay_.max_ms =
+          config_->playout_delay.max_ms;
+    }
+  }
   EncodedImageCallback::Result result = payload_router_.OnEncodedImage(
-      encoded_image, codec_specific_info, fragmentation);
+      has_playout_delay ? image_with_playout_delay : encoded_image,
+      codec_specific_info, fragmentation);
 
   RTC_DCHECK(codec_specific_info);
 
@@ -874,8 +899,19 @@ std::map<uint32_t, RtpPayloadState> VideoSendStreamImpl::GetRtpPayloadStates()
 void VideoSendStreamImpl::SignalNetworkState(NetworkState state) {
   RTC_DCHECK_RUN_ON(worker_queue_);
   for (RtpRtcp* rtp_rtcp : rtp_rtcp_modules_) {
-    rtp_rtcp->SetRTCPStatus(state == kNetworkUp ? config_->rtp.rtcp_mode
-                                                : RtcpMode::kOff);
+    rtp_rtcp->SetRTCPStatus(state == kNetworkUp ? rtcp_mode_ : RtcpMode::kOff);
+  }
+}
+
+void VideoSendStreamImpl::SetRtcpMode(RtcpMode mode) {
+  RTC_DCHECK_RUN_ON(worker_queue_);
+  RTC_DCHECK(mode != RtcpMode::kOff);
+  rtcp_mode_ = mode;
+  for (RtpRtcp* rtp_rtcp : rtp_rtcp_modules_) {
+    // RTCP is off while the network is down, SignalNetworkState() applies the
+    // new mode when it comes back up.
+    if (rtp_rtcp->RTCP() != RtcpMode::kOff)
+      rtp_rtcp->SetRTCPStatus(mode);
   }
 }
 
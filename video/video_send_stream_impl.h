@@ -56,6 +56,7 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
       SendDelayStats* send_delay_stats,
       VideoStreamEncoderInterface* video_stream_encoder,
       RtcEventLog* event_log,
+      rtc::MemoryAccount* memory_account,
       const VideoSendStream::Config* config,
       int initial_encoder_max_bitrate,
       double initial_encoder_bitrate_priority,
@@ -75,6 +76,7 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
   void DeRegisterProcessThread();
 
   void SignalNetworkState(NetworkState state);
+  void SetRtcpMode(RtcpMode mode);
   bool DeliverRtcp(const uint8_t* packet, size_t length);
   void UpdateActiveSimulcastLayers(const std::vector<bool> active_layers);
   void Start();
@@ -172,6 +174,8 @@ class VideoSendStreamImpl : public webrtc::BitrateAllocatorObserver,
   uint32_t encoder_target_rate_bps_;
   double encoder_bitrate_priority_;
   bool has_packet_feedback_;
+  // Starts out as |config_->rtp.rtcp_mode| and is updated by SetRtcpMode().
+  RtcpMode rtcp_mode_;
 
   VideoStreamEncoderInterface* const video_stream_encoder_;
   EncoderRtcpFeedback encoder_feedback_;
@@ -79,7 +79,7 @@ class VideoSendStreamImplTest : public ::testing::Test {
     return rtc::MakeUnique<VideoSendStreamImpl>(
         &stats_proxy_, &test_queue_, &call_stats_, &transport_controller_,
         &bitrate_allocator_, &send_delay_stats_, &video_stream_encoder_,
-        &event_log_, &config_, initial_encoder_max_bitrate,
+        &event_log_, nullptr, &config_, initial_encoder_max_bitrate,
         initial_encoder_bitrate_priority, suspended_ssrcs,
         suspended_payload_states, content_type,
         rtc::MakeUnique<FecControllerDefault>(&clock_),
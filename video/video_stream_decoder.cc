@@ -97,6 +97,10 @@ void VideoStreamDecoder::OnDecoderImplementationName(
   receive_stats_callback_->OnDecoderImplementationName(implementation_name);
 }
 
+void VideoStreamDecoder::OnDecoderNumberOfThreads(int number_of_threads) {
+  receive_stats_callback_->OnDecoderNumberOfThreads(number_of_threads);
+}
+
 void VideoStreamDecoder::OnReceiveRatesUpdated(uint32_t bit_rate,
                                                uint32_t frame_rate) {
   receive_stats_callback_->OnIncomingRate(frame_rate, bit_rate);
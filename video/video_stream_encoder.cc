@@ -16,6 +16,7 @@
 #include <utility>
 
 #include "api/video/i420_buffer.h"
+#include "api/video/nv12_buffer.h"
 #include "common_video/include/video_bitrate_allocator.h"
 #include "common_video/include/video_frame.h"
 #include "modules/video_coding/include/video_codec_initializer.h"
@@ -26,9 +27,11 @@
 #include "rtc_base/experiments/quality_scaling_experiment.h"
 #include "rtc_base/location.h"
 #include "rtc_base/logging.h"
+#include "rtc_base/ptr_util.h"
 #include "rtc_base/system/fallthrough.h"
 #include "rtc_base/timeutils.h"
 #include "rtc_base/trace_event.h"
+#include "system_wrappers/include/field_trial.h"
 #include "video/overuse_frame_detector.h"
 #include "video/send_statistics_proxy.h"
 
@@ -328,6 +331,10 @@ VideoStreamEncoder::VideoStreamEncoder(
       settings_(settings),
       video_sender_(Clock::GetRealTimeClock(), this),
       overuse_detector_(std::move(overuse_detector)),
+      complexity_ladder_(
+          field_trial::IsEnabled("WebRTC-CpuAdaptationEncoderComplexity")
+              ? new EncoderComplexityLadder()
+              : nullptr),
       stats_proxy_(stats_proxy),
       pre_encode_callback_(pre_encode_callback),
       max_framerate_(-1),
@@ -346,6 +353,7 @@ VideoStreamEncoder::VideoStreamEncoder(
       last_frame_log_ms_(clock_->TimeInMilliseconds()),
       captured_frame_count_(0),
       dropped_frame_count_(0),
+      media_opt_dropped_frame_count_(0),
       bitrate_observer_(nullptr),
       encoder_queue_("EncoderQueue") {
   RTC_DCHECK(stats_proxy);
@@ -502,10 +510,19 @@ void VideoStreamEncoder::ReconfigureEncoder() {
   crop_height_ = last_frame_info_->height - highest_stream_height;
 
   VideoCodec codec;
+  std::unique_ptr<VideoBitrateAllocator> rate_allocator;
   if (!VideoCodecInitializer::SetupCodec(
-          encoder_config_, streams, &codec, &rate_allocator_)) {
+          encoder_config_, streams, &codec, &rate_allocator)) {
     RTC_LOG(LS_ERROR) << "Failed to create encoder configuration.";
   }
+  rate_allocator_.reset();
+  if (rate_allocator) {
+    rate_allocator_ = rtc::MakeUnique<ActiveLayersBitrateAllocator>(
+        std::move(rate_allocator));
+    rate_allocator_->SetActiveLayers(active_layers_);
+  }
+  if (complexity_ladder_)
+    complexity_ladder_->ConfigureCodec(&codec);
 
   // Set min_bitrate_bps, max_bitrate_bps, and max padding bit rate for VP9.
   if (encoder_config_.codec_type == kVideoCodecVP9) {
@@ -706,10 +723,13 @@ void VideoStreamEncoder::OnFrame(const VideoFrame& video_frame) {
           RTC_LOG(LS_INFO) << "Number of frames: captured "
                            << captured_frame_count_
                            << ", dropped (due to encoder blocked) "
-                           << dropped_frame_count_ << ", interval_ms "
-                           << kFrameLogIntervalMs;
+                           << dropped_frame_count_
+                           << ", dropped (by media optimization) "
+                           << media_opt_dropped_frame_count_
+                           << ", interval_ms " << kFrameLogIntervalMs;
           captured_frame_count_ = 0;
           dropped_frame_count_ = 0;
+          media_opt_dropped_frame_count_ = 0;
         }
       });
 }
@@ -829,22 +849,49 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
   RTC_DCHECK_RUN_ON(&encoder_queue_);
   TraceFrameDropEnd();
 
+  overuse_detector_->FrameCaptured(video_frame, time_when_posted_us);
+
+  // Let the frame dropper decide before the frame is cropped, scaled or
+  // converted, so no time is spent preparing frames that are never encoded.
+  if (video_sender_.DropFrameBeforeEncode()) {
+    ++media_opt_dropped_frame_count_;
+    return;
+  }
+
   VideoFrame out_frame(video_frame);
   // Crop frame if needed.
   if (crop_width_ > 0 || crop_height_ > 0) {
     int cropped_width = video_frame.width() - crop_width_;
     int cropped_height = video_frame.height() - crop_height_;
-    rtc::scoped_refptr<I420Buffer> cropped_buffer =
-        I420Buffer::Create(cropped_width, cropped_height);
+    rtc::scoped_refptr<VideoFrameBuffer> cropped_buffer;
     // TODO(ilnik): Remove scaling if cropping is too big, as it should never
     // happen after SinkWants signaled correctly from ReconfigureEncoder.
-    if (crop_width_ < 4 && crop_height_ < 4) {
-      cropped_buffer->CropAndScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420(), crop_width_ / 2,
-          crop_height_ / 2, cropped_width, cropped_height);
+    if (video_frame.video_frame_buffer()->type() ==
+        VideoFrameBuffer::Type::kNV12) {
+      // Keep NV12 frames in NV12 rather than converting them to I420 here.
+      rtc::scoped_refptr<NV12Buffer> nv12_buffer =
+          NV12Buffer::Create(cropped_width, cropped_height);
+      const NV12BufferInterface& src =
+          *video_frame.video_frame_buffer()->GetNV12();
+      if (crop_width_ < 4 && crop_height_ < 4) {
+        nv12_buffer->CropAndScaleFrom(src, crop_width_ / 2, crop_height_ / 2,
+                                      cropped_width, cropped_height);
+      } else {
+        nv12_buffer->ScaleFrom(src);
+      }
+      cropped_buffer = nv12_buffer;
     } else {
-      cropped_buffer->ScaleFrom(
-          *video_frame.video_frame_buffer()->ToI420().get());
+      rtc::scoped_refptr<I420Buffer> i420_buffer =
+          I420Buffer::Create(cropped_width, cropped_height);
+      if (crop_width_ < 4 && crop_height_ < 4) {
+        i420_buffer->CropAndScaleFrom(
+            *video_frame.video_frame_buffer()->ToI420(), crop_width_ / 2,
+            crop_height_ / 2, cropped_width, cropped_height);
+      } else {
+        i420_buffer->ScaleFrom(
+            *video_frame.video_frame_buffer()->ToI420().get());
+      }
+      cropped_buffer = i420_buffer;
     }
     out_frame =
         VideoFrame(cropped_buffer, video_frame.timestamp(),
@@ -855,9 +902,7 @@ void VideoStreamEncoder::EncodeVideoFrame(const VideoFrame& video_frame,
   TRACE_EVENT_ASYNC_STEP0("webrtc", "Video", video_frame.render_time_ms(),
                           "Encode");
 
-  overuse_detector_->FrameCaptured(out_frame, time_when_posted_us);
-
-  video_sender_.AddVideoFrame(out_frame, nullptr);
+  video_sender_.EncodeFrame(out_frame, nullptr);
 }
 
 void VideoStreamEncoder::SendKeyFrame() {
@@ -956,6 +1001,8 @@ void VideoStreamEncoder::OnBitrateUpdated(uint32_t bitrate_bps,
   bool video_is_suspended = bitrate_bps == 0;
   bool video_suspension_changed = video_is_suspended != EncoderPaused();
   last_observed_bitrate_bps_ = bitrate_bps;
+  last_observed_fraction_lost_ = fraction_lost;
+  last_observed_rtt_ms_ = round_trip_time_ms;
 
   if (video_suspension_changed) {
     RTC_LOG(LS_INFO) << "Video suspend state changed to: "
@@ -971,6 +1018,30 @@ void VideoStreamEncoder::OnBitrateUpdated(uint32_t bitrate_bps,
   }
 }
 
+void VideoStreamEncoder::SetActiveLayers(
+    const std::vector<bool>& active_layers) {
+  if (!encoder_queue_.IsCurrent()) {
+    encoder_queue_.PostTask(
+        [this, active_layers] { SetActiveLayers(active_layers); });
+    return;
+  }
+  RTC_DCHECK_RUN_ON(&encoder_queue_);
+  if (active_layers == active_layers_)
+    return;
+  active_layers_ = active_layers;
+  if (!rate_allocator_)
+    return;
+  rate_allocator_->SetActiveLayers(active_layers_);
+  // The encoders stop or start encoding the layers as soon as they are told
+  // their new bitrates. The whole of the last estimate is allocated again,
+  // since the current allocation left out the layers that were paused.
+  if (last_observed_bitrate_bps_ > 0) {
+    video_sender_.SetChannelParameters(
+        last_observed_bitrate_bps_, last_observed_fraction_lost_,
+        last_observed_rtt_ms_, rate_allocator_.get(), bitrate_observer_);
+  }
+}
+
 bool VideoStreamEncoder::DropDueToSize(uint32_t pixel_count) const {
   if (initial_rampup_ < kMaxInitialFramedrop &&
       encoder_start_bitrate_bps_ > 0) {
@@ -1023,6 +1094,16 @@ void VideoStreamEncoder::AdaptDown(AdaptReason reason) {
       return;
   }
 
+  // Try cheaper encoder settings before the resolution or framerate.
+  if (reason == kCpu && complexity_ladder_ &&
+      complexity_ladder_->StepDown(
+          stats_proxy_->GetStats().encode_usage_percent)) {
+    pending_encoder_reconfiguration_ = true;
+    RTC_LOG(LS_INFO) << "Reduced encoder complexity, steps: "
+                     << complexity_ladder_->num_active_steps();
+    return;
+  }
+
   switch (degradation_preference_) {
     case DegradationPreference::BALANCED: {
       // Try scale down framerate, if lower.
@@ -1076,8 +1157,17 @@ void VideoStreamEncoder::AdaptUp(AdaptReason reason) {
 
   const AdaptCounter& adapt_counter = GetConstAdaptCounter();
   int num_downgrades = adapt_counter.TotalCount(reason);
-  if (num_downgrades == 0)
+  if (num_downgrades == 0) {
+    // The encoder complexity is restored last, in reverse order of AdaptDown.
+    if (reason == kCpu && complexity_ladder_ &&
+        complexity_ladder_->StepUp(
+            stats_proxy_->GetStats().encode_usage_percent)) {
+      pending_encoder_reconfiguration_ = true;
+      RTC_LOG(LS_INFO) << "Restored encoder complexity, steps: "
+                       << complexity_ladder_->num_active_steps();
+    }
     return;
+  }
   RTC_DCHECK_GT(num_downgrades, 0);
 
   AdaptationRequest adaptation_request = {
@@ -26,6 +26,7 @@
 #include "common_types.h"  // NOLINT(build/include)
 #include "common_video/include/video_bitrate_allocator.h"
 #include "modules/video_coding/include/video_coding_defines.h"
+#include "modules/video_coding/utility/active_layers_bitrate_allocator.h"
 #include "modules/video_coding/utility/quality_scaler.h"
 #include "modules/video_coding/video_coding_impl.h"
 #include "rtc_base/criticalsection.h"
@@ -33,6 +34,7 @@
 #include "rtc_base/sequenced_task_checker.h"
 #include "rtc_base/task_queue.h"
 #include "typedefs.h"  // NOLINT(build/include)
+#include "video/encoder_complexity_ladder.h"
 #include "video/overuse_frame_detector.h"
 
 namespace webrtc {
@@ -89,6 +91,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
                         uint8_t fraction_lost,
                         int64_t round_trip_time_ms) override;
 
+  void SetActiveLayers(const std::vector<bool>& active_layers) override;
+
  protected:
   // Used for testing. For example the |ScalingObserverInterface| methods must
   // be called on |encoder_queue_|.
@@ -207,6 +211,10 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   std::unique_ptr<QualityScaler> quality_scaler_
       RTC_GUARDED_BY(&encoder_queue_)
       RTC_PT_GUARDED_BY(&encoder_queue_);
+  // Cheaper encoder settings used for CPU adaptation before resolution or
+  // framerate is reduced. Null unless enabled by field trial.
+  const std::unique_ptr<EncoderComplexityLadder> complexity_ladder_
+      RTC_PT_GUARDED_BY(&encoder_queue_);
 
   SendStatisticsProxy* const stats_proxy_;
   rtc::VideoSinkInterface<VideoFrame>* const pre_encode_callback_;
@@ -217,9 +225,11 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   VideoEncoderConfig encoder_config_ RTC_GUARDED_BY(&encoder_queue_);
   std::unique_ptr<VideoEncoder> encoder_ RTC_GUARDED_BY(&encoder_queue_)
       RTC_PT_GUARDED_BY(&encoder_queue_);
-  std::unique_ptr<VideoBitrateAllocator> rate_allocator_
+  std::unique_ptr<ActiveLayersBitrateAllocator> rate_allocator_
       RTC_GUARDED_BY(&encoder_queue_)
       RTC_PT_GUARDED_BY(&encoder_queue_);
+  // The simulcast layers that aren't paused, see SetActiveLayers().
+  std::vector<bool> active_layers_ RTC_GUARDED_BY(&encoder_queue_);
   // The maximum frame rate of the current codec configuration, as determined
   // at the last ReconfigureEncoder() call.
   int max_framerate_ RTC_GUARDED_BY(&encoder_queue_);
@@ -237,6 +247,8 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
   uint32_t encoder_start_bitrate_bps_ RTC_GUARDED_BY(&encoder_queue_);
   size_t max_data_payload_length_ RTC_GUARDED_BY(&encoder_queue_);
   uint32_t last_observed_bitrate_bps_ RTC_GUARDED_BY(&encoder_queue_);
+  uint8_t last_observed_fraction_lost_ RTC_GUARDED_BY(&encoder_queue_) = 0;
+  int64_t last_observed_rtt_ms_ RTC_GUARDED_BY(&encoder_queue_) = 0;
   bool encoder_paused_and_dropped_frame_ RTC_GUARDED_BY(&encoder_queue_);
   Clock* const clock_;
   // Counters used for deciding if the video resolution or framerate is
@@ -273,7 +285,11 @@ class VideoStreamEncoder : public VideoStreamEncoderInterface,
 
   int64_t last_frame_log_ms_ RTC_GUARDED_BY(incoming_frame_race_checker_);
   int captured_frame_count_ RTC_GUARDED_BY(&encoder_queue_);
+  // Frames dropped before any cropping, scaling or conversion was spent on
+  // them, per cause: because a newer frame was already waiting, and by the
+  // media optimization frame dropper.
   int dropped_frame_count_ RTC_GUARDED_BY(&encoder_queue_);
+  int media_opt_dropped_frame_count_ RTC_GUARDED_BY(&encoder_queue_);
   rtc::Optional<VideoFrame> pending_frame_ RTC_GUARDED_BY(&encoder_queue_);
   int64_t pending_frame_post_time_us_ RTC_GUARDED_BY(&encoder_queue_);
 